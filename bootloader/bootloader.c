@@ -26,10 +26,25 @@
  *   6. Bootloader sends ACK + 4-byte calculated CRC
  *   7. Bootloader jumps to 0x0
  *
+ * A 'W' probe packet instead of 'R' selects the windowed block protocol
+ * (lib/block_upload/block_upload.h, as sent by fw_upload_fast).
+ *
+ * Built with BOOT_DUAL this is the UART half of the dual-mode boot ROM
+ * (firmware/sd_bootloader, make bootloader-dual): uart_boot_window() waits
+ * for the first command only for a while and returns if none came, and
+ * the SD bootloader boots from the card.
+ *
  * CRC32 is calculated over data only (not size bytes)
  */
 
 #include <stdint.h>
+#include "../lib/block_upload/block_upload.h"
+#include "../lib/crc32.h"             // CRC32_SMALL (Makefile): no table in RAM
+#include "../lib/uart_baud.h"
+#include "../lib/hw_loader.h"
+#ifdef BOOT_DUAL
+#include "../lib/perf_counters.h"
+#endif
 
 // MMIO Addresses
 #define UART_TX_DATA   (*(volatile uint32_t *)0x80000000)
@@ -47,6 +62,15 @@
 // External assembly function
 extern void jump_to_firmware(uint32_t addr);
 
+// UART rate at entry: an auto-baud handshake only lasts for the upload
+static uint32_t boot_baud;
+
+#ifdef BOOT_DUAL
+// Upload window: cycles left for the next command (0: wait for ever)
+static uint32_t window_start;
+static uint32_t window_cycles;
+#endif
+
 //=============================================================================
 // UART Functions
 //=============================================================================
@@ -61,51 +85,115 @@ static uint8_t uart_getc(void) {
     return UART_RX_DATA & 0xFF;
 }
 
-//=============================================================================
-// CRC32 Calculation (matches firmware_loader.v and fw_upload.c)
-//=============================================================================
-
-static uint32_t crc32_table[256];
+// A host is there: its next command gets a full window again
+static void window_restart(void) {
+#ifdef BOOT_DUAL
+    window_start = rdcycle();
+#endif
+}
 
-static void crc32_init(void) {
-    for (uint32_t i = 0; i < 256; i++) {
-        uint32_t crc = i;
-        for (int j = 0; j < 8; j++) {
-            crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320 : 0);
+// Next command byte, or -1 once the upload window has closed
+static int uart_command(void) {
+#ifdef BOOT_DUAL
+    while (!(UART_RX_STATUS & 1)) {
+        if (window_cycles != 0 && rdcycle() - window_start >= window_cycles) {
+            return -1;
         }
-        crc32_table[i] = crc;
     }
+#endif
+    return uart_getc();
+}
+
+// Firmware starts at the rate the bootloader started at
+static void boot_firmware(void) {
+    uart_baud_drain();
+    UART_BAUD_REG = boot_baud;
+    jump_to_firmware(FIRMWARE_BASE);
+}
+
+//=============================================================================
+// Block Protocol
+//=============================================================================
+
+static void block_progress(uint32_t received, uint32_t size) {
+    (void)size;
+    LED_CONTROL = ((received >> 10) & 1) ? 0x03 : 0x02;
 }
 
-// Calculate CRC32 incrementally (for on-the-fly calculation)
-static uint32_t crc32_update(uint32_t crc, uint8_t byte) {
-    return (crc >> 8) ^ crc32_table[(crc ^ byte) & 0xFF];
+// Returns only if the host aborts; the session is kept for a resume
+static void block_boot(uint8_t first) {
+    static const block_callbacks_t cb = { uart_putc, uart_getc, block_progress };
+    int32_t n;
+
+    LED_CONTROL = 0x02;
+
+    n = block_receive(&cb, (uint8_t *)FIRMWARE_BASE, MAX_FIRMWARE_SIZE, first);
+    if (n > 0) {
+        LED_CONTROL = 0x00;
+        boot_firmware();
+    }
+    if (n == -BLOCK_ERROR_CRC) {
+        LED_CONTROL = 0x00;  // Error - CRC mismatch
+        while (1);
+    }
+    LED_CONTROL = 0x01;
 }
 
 //=============================================================================
 // Main Bootloader - Implements firmware_loader.v protocol
 //=============================================================================
 
+#ifdef BOOT_DUAL
+// Returns if no upload started within window cycles (0: waits for ever)
+void uart_boot_window(uint32_t window) {
+#else
 void bootloader_main(void) {
+#endif
     uint8_t *firmware = (uint8_t *)FIRMWARE_BASE;
     uint32_t packet_size = 0;
     uint32_t bytes_received = 0;
     uint32_t expected_crc;
-    uint32_t calculated_crc = 0xFFFFFFFF;  // CRC32 initial value
+    uint32_t calculated_crc = 0;
     uint8_t ack_char = 'A';  // Starting ACK character
 
-    // Initialize CRC32 lookup table
-    crc32_init();
+    boot_baud = UART_BAUD_REG;
+
+    // The hardware loader wrote an image with the CPU held in reset
+    if (HW_LOADER_STATUS & HW_LOADER_LOADED) {
+        HW_LOADER_STATUS = HW_LOADER_LOADED;
+        boot_firmware();
+    }
 
     // LED pattern: LED1 on = waiting for upload
     LED_CONTROL = 0x01;
 
-    // Step 1: Wait for 'R' (Ready) command
+#ifdef BOOT_DUAL
+    window_cycles = window;
+#endif
+    window_restart();
+
+    // Step 1: Wait for 'R' (Ready) command, a block protocol probe, or an
+    // auto-baud request (the rate holds until the jump to the firmware)
     while (1) {
-        uint8_t cmd = uart_getc();
+        int cmd = uart_command();
+        if (cmd < 0) {
+            // Dual-mode ROM: no host, boot from SD at the entry rate
+            uart_baud_drain();
+            UART_BAUD_REG = boot_baud;
+            LED_CONTROL = 0x00;
+            return;
+        }
         if (cmd == 'R' || cmd == 'r') {
             break;
         }
+        if (cmd == BLOCK_PKT_PROBE) {
+            block_boot(cmd);
+            window_restart();
+        }
+        if (cmd == UART_BAUD_CMD) {
+            uart_baud_accept();
+            window_restart();
+        }
     }
 
     // Step 2: Send ACK 'A' for Ready
@@ -141,7 +229,7 @@ void bootloader_main(void) {
             firmware[bytes_received] = byte;
 
             // Update CRC32 incrementally
-            calculated_crc = crc32_update(calculated_crc, byte);
+            calculated_crc = crc32_update_byte(calculated_crc, byte);
 
             bytes_received++;
             chunk_bytes++;
@@ -160,9 +248,6 @@ void bootloader_main(void) {
         }
     }
 
-    // Finalize CRC32
-    calculated_crc = ~calculated_crc;
-
     // Step 6: Wait for 'C' (CRC command)
     uint8_t crc_cmd = uart_getc();
     if (crc_cmd != 'C') {
@@ -196,7 +281,7 @@ void bootloader_main(void) {
     LED_CONTROL = 0x00;
 
     // Step 10: Jump to firmware at 0x0
-    jump_to_firmware(FIRMWARE_BASE);
+    boot_firmware();
 
     // Should never return
     while (1);
@@ -23,8 +23,38 @@
  *   3. PC streams ALL data continuously (NO chunking, NO per-chunk ACKs!)
  *   4. PC sends 'C' + 4-byte CRC → Bootloader calculates CRC
  *   5. Bootloader sends 'C' + 4-byte calculated CRC
+ *      On a mismatch it adds 'E' + 2-byte dropped count + 2-byte framing
+ *      error count (little-endian, UART RX_STATUS counters) and halts
  *   6. Bootloader jumps to 0x0
  *
+ * Block Protocol (lib/block_upload/block_upload.h, fw_upload_fast probes for it):
+ *   A 'W' probe packet instead of 'R' switches to windowed 1 KB blocks with a
+ *   CRC32 each: bad blocks are NAKed and resent alone, and an interrupted
+ *   upload of the same image resumes where it stopped. Same 'E' report on
+ *   an image CRC mismatch.
+ *
+ * Compressed Protocol (lib/lz4_stream.h, fw_upload_fast -z):
+ *   'Z' instead of 'R', then compressed and image size; the LZ4 block is
+ *   decoded into 0x0 as it streams in and the CRC covers the decoded image.
+ *
+ * Sparse Protocol (lib/sparse_upload.h, fw_upload_fast with an ELF):
+ *   'S' instead of 'R', then the image size; the image is zeroed here and
+ *   only the non-zero parts of its load segments are sent, with their
+ *   offsets. The CRC covers the whole image.
+ *
+ * Delta Protocol (lib/delta_upload.h, fw_upload_fast -d):
+ *   'D' instead of 'R', then the image and block size; the bootloader sends
+ *   the sums of the blocks at 0x0 (the firmware SRAM kept over the reset)
+ *   and only moves and changed data come back. Same CRC over the image.
+ *
+ * Auto-Baud (lib/uart_baud.h, fw_upload_fast --max-baud):
+ *   'U' + rate before any of these raises the UART rate for the upload;
+ *   the rate the bootloader started at is restored before the jump.
+ *
+ * Hardware Loader (lib/hw_loader.h, Kconfig HW_LOADER, fw_upload_fast -H):
+ *   The FPGA takes the upload itself with the CPU in reset; the bootloader
+ *   then finds STATUS.LOADED set at start and jumps to the image at once.
+ *
  * IMPORTANT: This bootloader uses FAST streaming protocol that is ONLY
  * compatible with fw_upload_fast. It is NOT compatible with fw_upload.
  * Use the correct pairing:
@@ -35,6 +65,13 @@
  */
 
 #include <stdint.h>
+#include "../lib/crc32.h"
+#include "../lib/block_upload/block_upload.h"
+#include "../lib/lz4_stream.h"
+#include "../lib/sparse_upload.h"
+#include "../lib/delta_upload.h"
+#include "../lib/uart_baud.h"
+#include "../lib/hw_loader.h"
 
 // MMIO Addresses
 #define UART_TX_DATA   (*(volatile uint32_t *)0x80000000)
@@ -51,6 +88,9 @@
 // External assembly function
 extern void jump_to_firmware(uint32_t addr);
 
+// UART rate at entry: an auto-baud handshake only lasts for the upload
+static uint32_t boot_baud;
+
 //=============================================================================
 // UART Functions
 //=============================================================================
@@ -65,30 +105,212 @@ static uint8_t uart_getc(void) {
     return UART_RX_DATA & 0xFF;
 }
 
+// Firmware starts at the rate the bootloader started at
+static void boot_firmware(void) {
+    uart_baud_drain();
+    UART_BAUD_REG = boot_baud;
+    jump_to_firmware(FIRMWARE_BASE);
+}
+
+// Report what the UART lost: 'E' + dropped and framing error counts
+static void send_rx_report(void) {
+    uint32_t rx_status = UART_RX_STATUS;
+    uint32_t dropped = (rx_status >> 8) & 0xFFF;
+    uint32_t frames = (rx_status >> 20) & 0xFFF;
+
+    uart_putc('E');
+    uart_putc(dropped & 0xFF);
+    uart_putc(dropped >> 8);
+    uart_putc(frames & 0xFF);
+    uart_putc(frames >> 8);
+}
+
+static uint32_t uart_get32(void) {
+    uint32_t v = 0;
+
+    for (int i = 0; i < 4; i++) {
+        v |= ((uint32_t)uart_getc()) << (i * 8);
+    }
+    return v;
+}
+
 //=============================================================================
-// CRC32 Calculation (matches hexedit_fast.c and fw_upload_fast.c)
+// Compressed Protocol
 //=============================================================================
 
-static uint32_t crc32_table[256];
+// Returns only if the image size is refused
+static void lz4_boot(void) {
+    lz4_stream_t s = { uart_getc, 0, 0 };
+    uint32_t length, calculated_crc, expected_crc;
 
-static void crc32_init(void) {
-    for (uint32_t i = 0; i < 256; i++) {
-        uint32_t crc = i;
-        for (int j = 0; j < 8; j++) {
-            crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320 : 0);
-        }
-        crc32_table[i] = crc;
+    UART_RX_STATUS = 0;  // Restart the RX dropped/framing counters
+    uart_putc('A');
+
+    s.left = uart_get32();
+    length = uart_get32();
+    if (length == 0 || length > MAX_FIRMWARE_SIZE) {
+        uart_putc('N');
+        return;
+    }
+    uart_putc('B');
+    LED_CONTROL = 0x02;
+
+    // Decode as the bytes arrive; a corrupt block shows up in the CRC
+    lz4_stream_decode(&s, (uint8_t *)FIRMWARE_BASE, length);
+    calculated_crc = crc32_calc((const void *)FIRMWARE_BASE, length);
+
+    if (uart_getc() != 'C') {
+        LED_CONTROL = 0x00;  // Error
+        while (1);
+    }
+    expected_crc = uart_get32();
+
+    uart_putc('C');
+    uart_putc((calculated_crc >> 0) & 0xFF);
+    uart_putc((calculated_crc >> 8) & 0xFF);
+    uart_putc((calculated_crc >> 16) & 0xFF);
+    uart_putc((calculated_crc >> 24) & 0xFF);
+
+    if (calculated_crc != expected_crc) {
+        send_rx_report();
+        LED_CONTROL = 0x00;  // Error - CRC mismatch
+        while (1);
+    }
+
+    LED_CONTROL = 0x00;
+    boot_firmware();
+}
+
+//=============================================================================
+// Sparse Protocol
+//=============================================================================
+
+// Returns only if the image size is refused
+static void sparse_boot(void) {
+    uint32_t length, calculated_crc, expected_crc;
+    int error;
+
+    UART_RX_STATUS = 0;  // Restart the RX dropped/framing counters
+    uart_putc('A');
+
+    length = uart_get32();
+    if (length == 0 || length > MAX_FIRMWARE_SIZE) {
+        uart_putc('N');
+        return;
+    }
+    sparse_upload_zero((uint8_t *)FIRMWARE_BASE, length);
+    uart_putc('B');
+    LED_CONTROL = 0x02;
+
+    error = sparse_upload_segments(uart_getc, (uint8_t *)FIRMWARE_BASE, length);
+    calculated_crc = crc32_calc((const void *)FIRMWARE_BASE, length);
+
+    if (uart_getc() != 'C') {
+        LED_CONTROL = 0x00;  // Error
+        while (1);
+    }
+    expected_crc = uart_get32();
+
+    uart_putc('C');
+    uart_putc((calculated_crc >> 0) & 0xFF);
+    uart_putc((calculated_crc >> 8) & 0xFF);
+    uart_putc((calculated_crc >> 16) & 0xFF);
+    uart_putc((calculated_crc >> 24) & 0xFF);
+
+    if (error || calculated_crc != expected_crc) {
+        send_rx_report();
+        LED_CONTROL = 0x00;  // Error - CRC mismatch
+        while (1);
     }
+
+    LED_CONTROL = 0x00;
+    boot_firmware();
 }
 
+//=============================================================================
+// Delta Protocol
+//=============================================================================
+
+// Returns only if the image or block size is refused
+static void delta_boot(void) {
+    uint32_t length, block, calculated_crc, expected_crc;
+    int error;
+
+    UART_RX_STATUS = 0;  // Restart the RX dropped/framing counters
+    uart_putc('A');
+
+    length = uart_get32();
+    block = uart_get32();
+    if (length == 0 || length > MAX_FIRMWARE_SIZE || !delta_upload_block_ok(block)) {
+        uart_putc('N');
+        return;
+    }
+    uart_putc('B');
+    LED_CONTROL = 0x02;
+
+    delta_upload_sums(uart_putc, (const uint8_t *)FIRMWARE_BASE, length, block);
+    error = delta_upload_apply(uart_getc, uart_putc, (uint8_t *)FIRMWARE_BASE, length);
+    calculated_crc = crc32_calc((const void *)FIRMWARE_BASE, length);
+
+    if (uart_getc() != 'C') {
+        LED_CONTROL = 0x00;  // Error
+        while (1);
+    }
+    expected_crc = uart_get32();
+
+    uart_putc('C');
+    uart_putc((calculated_crc >> 0) & 0xFF);
+    uart_putc((calculated_crc >> 8) & 0xFF);
+    uart_putc((calculated_crc >> 16) & 0xFF);
+    uart_putc((calculated_crc >> 24) & 0xFF);
+
+    if (error || calculated_crc != expected_crc) {
+        send_rx_report();
+        LED_CONTROL = 0x00;  // Error - CRC mismatch
+        while (1);
+    }
+
+    LED_CONTROL = 0x00;
+    boot_firmware();
+}
+
+//=============================================================================
+// Block Protocol
+//=============================================================================
+
+static void block_progress(uint32_t received, uint32_t size) {
+    (void)size;
+    LED_CONTROL = ((received >> 10) & 1) ? 0x03 : 0x02;
+}
+
+// Returns only if the host aborts; the session is kept for a resume
+static void block_boot(uint8_t first) {
+    static const block_callbacks_t cb = { uart_putc, uart_getc, block_progress };
+    int32_t n;
+
+    UART_RX_STATUS = 0;  // Restart the RX dropped/framing counters
+    LED_CONTROL = 0x02;
+
+    n = block_receive(&cb, (uint8_t *)FIRMWARE_BASE, MAX_FIRMWARE_SIZE, first);
+    if (n > 0) {
+        LED_CONTROL = 0x00;
+        boot_firmware();
+    }
+    if (n == -BLOCK_ERROR_CRC) {
+        send_rx_report();
+        LED_CONTROL = 0x00;  // Error - CRC mismatch
+        while (1);
+    }
+    LED_CONTROL = 0x01;
+}
+
+//=============================================================================
+// CRC32 Calculation (matches hexedit_fast.c and fw_upload_fast.c)
+//=============================================================================
+
 // Calculate CRC32 of a memory block (post-receive)
 static uint32_t calculate_crc32(uint32_t start_addr, uint32_t end_addr) {
-    uint32_t crc = 0xFFFFFFFF;
-    for (uint32_t addr = start_addr; addr <= end_addr; addr++) {
-        uint8_t byte = *((uint8_t *)addr);
-        crc = (crc >> 8) ^ crc32_table[(crc ^ byte) & 0xFF];
-    }
-    return ~crc;
+    return crc32_calc((const void *)start_addr, end_addr - start_addr + 1);
 }
 
 //=============================================================================
@@ -102,21 +324,43 @@ void bootloader_main(void) {
     uint32_t expected_crc;
     uint32_t calculated_crc;
 
-    // Initialize CRC32 lookup table
-    crc32_init();
+    boot_baud = UART_BAUD_REG;
+
+    // The hardware loader wrote an image with the CPU held in reset
+    if (HW_LOADER_STATUS & HW_LOADER_LOADED) {
+        HW_LOADER_STATUS = HW_LOADER_LOADED;
+        boot_firmware();
+    }
 
     // LED pattern: LED1 on = waiting for upload
     LED_CONTROL = 0x01;
 
-    // Step 1: Wait for 'R' (Ready) command
+    // Step 1: Wait for 'R' (Ready) command, a block protocol probe, or an
+    // auto-baud request (the rate holds until the jump to the firmware)
     while (1) {
         uint8_t cmd = uart_getc();
         if (cmd == 'R' || cmd == 'r') {
             break;
         }
+        if (cmd == BLOCK_PKT_PROBE) {
+            block_boot(cmd);
+        }
+        if (cmd == UART_BAUD_CMD) {
+            uart_baud_accept();
+        }
+        if (cmd == LZ4_STREAM_CMD) {
+            lz4_boot();
+        }
+        if (cmd == SPARSE_UPLOAD_CMD) {
+            sparse_boot();
+        }
+        if (cmd == DELTA_UPLOAD_CMD) {
+            delta_boot();
+        }
     }
 
     // Step 2: Send ACK 'A' for Ready
+    UART_RX_STATUS = 0;  // Restart the RX dropped/framing counters
     uart_putc('A');
 
     // LED pattern: LED2 on = downloading
@@ -181,6 +425,9 @@ void bootloader_main(void) {
 
     // Step 10: Verify CRC match
     if (calculated_crc != expected_crc) {
+        // Report what the UART lost during the stream
+        send_rx_report();
+
         LED_CONTROL = 0x00;  // Error - CRC mismatch
         while (1);  // Halt on CRC error
     }
@@ -189,7 +436,7 @@ void bootloader_main(void) {
     LED_CONTROL = 0x00;
 
     // Step 11: Jump to firmware at 0x0
-    jump_to_firmware(FIRMWARE_BASE);
+    boot_firmware();
 
     // Should never return
     while (1);
@@ -10,6 +10,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include "../lib/perf_counters.h"
+#include "../lib/crc32.h"
+#include "../lib/pc_sampler.h"
 
 // UART direct access
 #define UART_RX_DATA   (*(volatile unsigned int*)0x80000008)
@@ -189,36 +192,53 @@ static void test_sorting(void) {
     free(arr);
 }
 
+// Machine-readable timing line for scripts/bench_profiles.sh and
+// scripts/perf_regress.sh
+static void perf_report(const char *name, uint32_t iters,
+                        const perf_sample_t *start, const perf_sample_t *end) {
+    uint32_t cycles = end->cycles - start->cycles;
+    printf("PERF %s iters=%lu cyc_per_iter=%lu\r\n", name,
+           (unsigned long)iters, (unsigned long)(cycles / iters));
+}
+
 //==============================================================================
 // CRC32 Checksum (Standard polynomial)
 //==============================================================================
 
-static unsigned int crc32_table[256];
+// Byte-at-a-time reference, table built at run time (the "algo_crc32"
+// baseline); lib/crc32.h is measured against it
+static unsigned int crc32_byte_table[256];
 
-static void crc32_init(void) {
+static void crc32_byte_init(void) {
     for (unsigned int i = 0; i < 256; i++) {
         unsigned int crc = i;
         for (int j = 0; j < 8; j++) {
             crc = (crc & 1) ? ((crc >> 1) ^ 0xEDB88320) : (crc >> 1);
         }
-        crc32_table[i] = crc;
+        crc32_byte_table[i] = crc;
     }
 }
 
-static unsigned int crc32(const unsigned char *data, size_t len) {
+static unsigned int crc32_bytewise(const unsigned char *data, size_t len) {
     unsigned int crc = 0xFFFFFFFF;
     for (size_t i = 0; i < len; i++) {
-        crc = (crc >> 8) ^ crc32_table[(crc ^ data[i]) & 0xFF];
+        crc = (crc >> 8) ^ crc32_byte_table[(crc ^ data[i]) & 0xFF];
     }
     return ~crc;
 }
 
+static void crc32_check(unsigned int crc) {
+    // Known good CRC for this seed/pattern (verified locally)
+    printf("CRC32: 0x%08X (expected 0xA9C0AAD0) %s\r\n", crc,
+           (crc == 0xA9C0AAD0) ? "PASS" : "FAIL");
+}
+
 static void test_crc32(void) {
     printf("\r\n=== CRC32 Checksum Test ===\r\n");
     printf("Computing CRC32 of large data block...\r\n");
     fflush(stdout);
 
-    crc32_init();
+    crc32_byte_init();
 
     // Allocate 100KB test data
     const size_t data_size = 100 * 1024;
@@ -238,13 +258,28 @@ static void test_crc32(void) {
     // Compute CRC32
     printf("Computing CRC32 of %u bytes...\r\n", (unsigned int)data_size);
     fflush(stdout);
-    unsigned int crc = crc32(data, data_size);
-
-    printf("CRC32: 0x%08X\r\n", crc);
-
-    // Known good CRC for this seed/pattern (verified locally)
-    printf("Expected: 0xA9C0AAD0\r\n");
-    printf("%s\r\n", (crc == 0xA9C0AAD0) ? "PASS" : "FAIL");
+    perf_sample_t t0, t1;
+    perf_sample(&t0);
+    unsigned int crc = crc32_bytewise(data, data_size);
+    perf_sample(&t1);
+    crc32_check(crc);
+    perf_report("algo_crc32", data_size, &t0, &t1);
+
+    // Slicing-by-4 (lib/crc32.c), the software path of crc32_calc()
+    perf_sample(&t0);
+    crc = crc32_update_sw(0, data, data_size);
+    perf_sample(&t1);
+    crc32_check(crc);
+    perf_report("algo_crc32_slice4", data_size, &t0, &t1);
+
+    // Accelerator, when the bitstream has one
+    if (crc32_hw_present()) {
+        perf_sample(&t0);
+        crc = crc32_calc(data, data_size);
+        perf_sample(&t1);
+        crc32_check(crc);
+        perf_report("algo_crc32_hw", data_size, &t0, &t1);
+    }
 
     free(data);
 }
@@ -316,6 +351,8 @@ static void test_matrix_multiply(void) {
 //==============================================================================
 
 static void test_combined_stress(void) {
+    perf_sample_t t0, t1;
+
     printf("\r\n=== Combined Algorithm Stress Test (30 seconds) ===\r\n");
     printf("Running multiple algorithms in sequence...\r\n");
     fflush(stdout);
@@ -325,6 +362,7 @@ static void test_combined_stress(void) {
     const int limit = 10000;
     unsigned char *sieve = malloc(limit + 1);
     if (sieve) {
+        perf_sample(&t0);
         memset(sieve, 1, limit + 1);
         for (int p = 2; p * p <= limit; p++) {
             if (sieve[p]) {
@@ -333,8 +371,10 @@ static void test_combined_stress(void) {
         }
         int count = 0;
         for (int i = 2; i <= limit; i++) if (sieve[i]) count++;
+        perf_sample(&t1);
         printf("   Found %d primes (expected 1229): %s\r\n", count,
                (count == 1229) ? "PASS" : "FAIL");
+        perf_report("algo_sieve", limit, &t0, &t1);
         free(sieve);
     }
 
@@ -342,32 +382,75 @@ static void test_combined_stress(void) {
     printf("\n2. Sorting 10,000 numbers...\r\n");
     int *arr = malloc(10000 * sizeof(int));
     if (arr) {
+        perf_sample(&t0);
         unsigned int seed = 42;
         for (int i = 0; i < 10000; i++) {
             seed = seed * 1664525 + 1013904223;
             arr[i] = seed % 10000;
         }
         quicksort(arr, 0, 9999);
+        perf_sample(&t1);
         int sorted = 1;
         for (int i = 1; i < 10000; i++) {
             if (arr[i] < arr[i-1]) { sorted = 0; break; }
         }
         printf("   %s\r\n", sorted ? "PASS" : "FAIL");
+        perf_report("algo_sort", 10000, &t0, &t1);
         free(arr);
     }
 
     // Math computations
     printf("\n3. Math computations (10,000 iterations)...\r\n");
     double sum = 0.0;
+    perf_sample(&t0);
     for (int i = 1; i <= 10000; i++) {
         double x = (double)i / 100.0;
         sum += sin(x) + cos(x) + sqrt(x) + log(x);
     }
+    perf_sample(&t1);
+    perf_report("algo_math", 10000, &t0, &t1);
     printf("   Sum = %.6f (computed)\r\n", sum);
 
     printf("\r\nCombined stress test complete!\r\n");
 }
 
+//==============================================================================
+// PC Sampler Profile of the Stress Test (Kconfig PC_SAMPLER)
+//==============================================================================
+
+// One timing run, then a sampled run with the interval stretched so the
+// FIFO covers all of it. The PCS lines are for tools/pcprof.
+static void profile_combined_stress(void) {
+    perf_sample_t t0, t1;
+    uint32_t depth = pc_sampler_depth();
+
+    if (!depth) {
+        printf("PC sampler not in this bitstream (Kconfig PC_SAMPLER)\r\n");
+        return;
+    }
+
+    printf("\r\n=== PC Sampler Profile: Combined Stress Test ===\r\n");
+    printf("Timing run...\r\n");
+    perf_sample(&t0);
+    test_combined_stress();
+    perf_sample(&t1);
+
+    // 1/16 headroom for run-to-run variation; odd against loop aliasing
+    uint32_t interval = ((t1.cycles - t0.cycles) / (depth - depth / 16)) | 1;
+    printf("\r\nSampled run, one sample per %lu cycles...\r\n", (unsigned long)interval);
+    pc_sampler_start(interval, 0);
+    test_combined_stress();
+    pc_sampler_stop();
+
+    uint32_t lost = PC_SAMPLER_STATUS & PC_SAMPLER_LOST;
+    printf("\r\nPCS begin interval=%lu samples=%lu\r\n",
+           (unsigned long)interval, (unsigned long)pc_sampler_count());
+    while (pc_sampler_count())
+        printf("PCS %08lx\r\n", (unsigned long)pc_sampler_pop());
+    printf("PCS end%s\r\n", lost ? " (FIFO full before the end of the run)" : "");
+    printf("Profile: tools/pcprof/pcprof firmware/algo_test.elf <capture>\r\n");
+}
+
 //==============================================================================
 // Main Menu
 //==============================================================================
@@ -384,6 +467,7 @@ static void show_menu(void) {
     printf("5. Matrix multiply (~5s)\r\n");
     printf("6. Combined stress test (~30s)\r\n");
     printf("7. Run all tests\r\n");
+    printf("p. Profile stress test (PC sampler)\r\n");
     printf("h. Show this menu\r\n");
     printf("q. Quit\r\n");
     printf("========================================\r\n");
@@ -457,6 +541,12 @@ int main(void) {
                 show_menu();
                 break;
 
+            case 'p':
+            case 'P':
+                profile_combined_stress();
+                show_menu();
+                break;
+
             case 'h':
             case 'H':
                 show_menu();
@@ -0,0 +1,144 @@
+/*
+ * Binary Logging Demo for PicoRV32 (lib/binlog)
+ *
+ * Prints what one log line costs the code that writes it, as text with
+ * busy-wait UART output and as a BLOG() record, then logs from a 1 kHz
+ * timer ISR and the main loop while the UART TX interrupt drains the
+ * ring. Decode the capture on the host:
+ *
+ *   make binlog-tool
+ *   tools/binlog/binlog_decode -d firmware/binlog_demo.elf capture.log
+ *
+ * The text lines come through the decoder as they are.
+ */
+
+#include <stdint.h>
+#include "../lib/irq.h"
+#include "../lib/timer.h"
+#include "../lib/perf_counters.h"
+#include "../lib/binlog/binlog.h"
+
+//==============================================================================
+// Hardware Registers
+//==============================================================================
+
+#define UART_TX_DATA   (*(volatile uint32_t*)0x80000000)
+#define UART_TX_STATUS (*(volatile uint32_t*)0x80000004)
+
+#define TICK_ARR        (1000 - 1)      // 1 kHz at 1 MHz
+#define TICK_LOG_MS     100             // One ISR record per 100 ticks
+#define BENCH_LINES     16
+
+//==============================================================================
+// Simple printf without newlib
+//==============================================================================
+
+static void uart_putc(char c) {
+    while (UART_TX_STATUS & 0x01);
+    UART_TX_DATA = c;
+}
+
+static void uart_puts(const char *s) {
+    while (*s) {
+        uart_putc(*s++);
+    }
+}
+
+static void uart_putdec(uint32_t val) {
+    char buf[12];
+    int i = 0;
+
+    do {
+        buf[i++] = '0' + (val % 10);
+        val /= 10;
+    } while (val > 0);
+    while (i > 0) {
+        uart_putc(buf[--i]);
+    }
+}
+
+static void uart_puthex(uint32_t val) {
+    for (int i = 28; i >= 0; i -= 4) {
+        uart_putc("0123456789abcdef"[(val >> i) & 0xF]);
+    }
+}
+
+//==============================================================================
+// Timer Tick
+//==============================================================================
+
+static volatile uint32_t ticks = 0;
+
+static void tick_isr(uint32_t source) {
+    uint32_t late = TICK_ARR - TIMER_CH_CNT(0);     // Microseconds since the reload
+
+    (void)source;
+    TIMER_CH_SR(0) = TIMER_CH_UIF;
+    if (++ticks % TICK_LOG_MS == 0) {
+        BLOG("tick %u: ISR entered %u us after the reload", ticks, late);
+    }
+}
+
+//==============================================================================
+// Main
+//==============================================================================
+
+int main(void) {
+    uint32_t t0, text_cycles, blog_cycles;
+    binlog_stats_t st;
+
+    uart_puts("\r\n");
+    uart_puts("========================================\r\n");
+    uart_puts("Binary Logging Demo (lib/binlog)\r\n");
+    uart_puts("========================================\r\n");
+
+    // The same line both ways, timed from the caller's side
+    t0 = rdcycle();
+    for (uint32_t i = 0; i < BENCH_LINES; i++) {
+        uart_puts("bench ");
+        uart_putdec(i);
+        uart_puts(" crc ");
+        uart_puthex(i * 0x9E3779B9u);
+        uart_puts("\r\n");
+    }
+    text_cycles = (rdcycle() - t0) / BENCH_LINES;
+
+    t0 = rdcycle();
+    for (uint32_t i = 0; i < BENCH_LINES; i++) {
+        BLOG("bench %u crc %08x", i, i * 0x9E3779B9u);
+    }
+    blog_cycles = (rdcycle() - t0) / BENCH_LINES;
+    binlog_flush();
+
+    uart_puts("Cycles per line: text ");
+    uart_putdec(text_cycles);
+    uart_puts(", BLOG ");
+    uart_putdec(blog_cycles);
+    uart_puts("\r\n");
+
+    irq_setmask(~0u);
+    irq_register(IRQ_TIMER, tick_isr, 8);
+    if (!binlog_irq_start(4)) {
+        uart_puts("No UART TX interrupt: draining from the main loop\r\n");
+    }
+
+    TIMER_CH_CR(0) = 0;
+    TIMER_CH_PSC(0) = TIMER_PSC_1MHZ;
+    TIMER_CH_ARR(0) = TICK_ARR;
+    TIMER_CH_SR(0) = TIMER_CH_UIF;
+    TIMER_CH_CR(0) = TIMER_CH_ENABLE;
+
+    irq_enable_all();
+
+    for (uint32_t sec = 1; ; sec++) {
+        while ((int32_t)(ticks - sec * 1000) < 0) {
+            binlog_drain();                     // Also safe next to the IRQ
+            irq_wait();
+        }
+        binlog_get_stats(&st);
+        BLOG("second %u: %u records, %u dropped, ring peak %u words",
+             sec, st.records, st.dropped, st.max_words);
+    }
+
+    return 0;
+}
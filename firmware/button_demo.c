@@ -13,8 +13,18 @@
  * Button Demo Firmware
  * Demonstrates button input reading via MMIO register 0x80000018
  * Features: Button-controlled LEDs, button state display, debouncing
+ *
+ * With the hardware debouncer (lib/button.h) the demo sleeps in waitirq
+ * until a button settles (IRQ[6], press and release) or a character
+ * arrives (IRQ[4]), and reads the debounced state and the latched press
+ * events. Without it, it polls BUTTON_INPUT as before.
  */
 
+#include <stdint.h>
+#include "../lib/irq.h"
+#include "../lib/uart_irq.h"
+#include "../lib/button.h"
+
 #define UART_TX_DATA   (*(volatile unsigned int *)0x80000000)
 #define UART_TX_STATUS (*(volatile unsigned int *)0x80000004)
 #define UART_RX_DATA   (*(volatile unsigned int *)0x80000008)
@@ -68,6 +78,18 @@ int button2_pressed(void) {
     return (BUTTON_INPUT & BUT2_MASK) ? 1 : 0;
 }
 
+// IRQ handlers (the start.S dispatcher acknowledges the source). The
+// events stay latched in BTN_EVENTS for the main loop; the RX level is
+// quieted until the loop sleeps again.
+static void on_button(uint32_t source) {
+    (void)source;
+}
+
+static void on_uart_rx(uint32_t source) {
+    (void)source;
+    uart_irq_disable(UART_IRQ_RX_ALL);
+}
+
 // Mode switching
 void switch_to_shell(void) {
     MODE_CONTROL = 0;  // 0 = Shell mode
@@ -101,6 +123,7 @@ int main(void) {
     unsigned int btn_prev = 0;  // Previous button state for edge detection
     unsigned int counter = 0;
     int mode = 0;  // 0=direct, 1=toggle, 2=count
+    int hw_debounce = button_debounce_present() && irqc_present();
 
     puts("\n");
     puts("=================================\n");
@@ -108,6 +131,8 @@ int main(void) {
     puts("=================================\n");
     puts("Hardware: BUT1(K11), BUT2(P13)\n");
     puts("MMIO: 0x80000018 [1:0]\n");
+    puts(hw_debounce ? "Debounce: hardware (0x80000270), IRQ wakeup\n"
+                     : "Debounce: none, polling\n");
     puts("\n");
     puts("Commands:\n");
     puts("  s - Switch to SHELL mode\n");
@@ -119,15 +144,36 @@ int main(void) {
     puts("Mode: Direct (BUT1->LED1, BUT2->LED2)\n");
     puts("> ");
 
+    if (hw_debounce) {
+        BTN_IRQ_EN = BTN_PRESS_ALL | BTN_RELEASE_ALL;
+        BTN_EVENTS = BTN_PRESS_ALL | BTN_RELEASE_ALL;
+        irq_register(IRQ_BUTTON, on_button, 8);
+        irq_register(IRQ_UART_RX, on_uart_rx, 4);
+        irq_enable_all();
+    }
+
     while (1) {
-        // Read current button state
-        unsigned int btn_now = read_buttons();
+        unsigned int btn_now, btn_press;
+
+        if (hw_debounce) {
+            // Sleep until a button settles or a character arrives
+            uart_irq_enable(UART_IRQ_RX_AVAIL);
+            irq_wait_until(BTN_EVENTS || getc_available(),
+                           (1u << IRQ_BUTTON) | (1u << IRQ_UART_RX));
 
-        // Detect button edges (press = 0->1 transition)
-        unsigned int btn_press = btn_now & ~btn_prev;
+            btn_now = BTN_STATE & BTN_STATE_MASK;
+            btn_press = button_take_events(BTN_PRESS_ALL);
+            button_take_events(BTN_RELEASE_ALL);
+        } else {
+            // Read current button state
+            btn_now = read_buttons();
 
-        // Update previous state
-        btn_prev = btn_now;
+            // Detect button edges (press = 0->1 transition)
+            btn_press = btn_now & ~btn_prev;
+
+            // Update previous state
+            btn_prev = btn_now;
+        }
 
         // Mode-specific behavior
         switch (mode) {
@@ -197,7 +243,7 @@ int main(void) {
                 puts("Mode: Counter (count button presses)\n");
             }
             else if (c == 'b' || c == 'B') {
-                unsigned int btn = read_buttons();
+                unsigned int btn = hw_debounce ? (BTN_STATE & BTN_STATE_MASK) : read_buttons();
                 puts("Button State: 0x");
                 print_hex8(btn);
                 puts(" (BUT1=");
@@ -214,7 +260,9 @@ int main(void) {
         }
 
         // Small delay to avoid polling too fast
-        delay(1000);
+        if (!hw_debounce) {
+            delay(1000);
+        }
     }
 
     return 0;
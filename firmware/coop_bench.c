@@ -0,0 +1,200 @@
+/*
+ * Cooperative Task Switch Benchmark for PicoRV32 (lib/coop)
+ *
+ * Measures what a lib/coop switch costs, in CPU cycles (rdcycle, needs
+ * CONFIG_ENABLE_COUNTERS in the bitstream), next to the FreeRTOS numbers
+ * from freertos_isr_bench:
+ *
+ * - Yield: two tasks of equal priority call coop_yield() in turn, so every
+ *   yield is one queue push/pop and one coop_switch(). Compare with
+ *   rtos_yield (taskYIELD() ping-pong, which waits for the next tick) and
+ *   rtos_switch (tick + two full context switches).
+ * - Wake: a priority 2 task waits on the software IRQ, the benchmark task
+ *   raises it and yields. Cycles from the trigger write to the waiter
+ *   running: IRQ entry and dispatch, the event handler, the yield and the
+ *   switch. Needs the interrupt controller.
+ *
+ * The 1 kHz tick keeps running and is included in both, as in the
+ * FreeRTOS benchmark. The PERF averages are what scripts/perf_regress.sh
+ * tracks.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include "../lib/coop/coop.h"
+#include "../lib/irq.h"
+#include "../lib/perf_counters.h"
+
+#define SOFT_IRQ_TRIGGER    (*(volatile uint32_t*)0x80000040)
+
+//==============================================================================
+// Benchmark Parameters
+//==============================================================================
+
+#define SAMPLES         1000    // Yields / wakes per measurement
+#define STACK_WORDS     512
+
+static coop_task_t bench, partner, waiter;
+static uint32_t bench_stack[STACK_WORDS * 2];
+static uint32_t partner_stack[STACK_WORDS];
+static uint32_t waiter_stack[STACK_WORDS];
+
+static volatile int partner_stop;
+static volatile uint32_t trigger_cycle;
+
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint32_t total;
+} Stats_t;
+
+static void stats_reset(Stats_t *s)
+{
+    s->count = 0;
+    s->min = 0xFFFFFFFF;
+    s->max = 0;
+    s->total = 0;
+}
+
+static void stats_add(Stats_t *s, uint32_t v)
+{
+    s->count++;
+    s->total += v;
+    if (v < s->min) s->min = v;
+    if (v > s->max) s->max = v;
+}
+
+static void print_stats(const char *name, const Stats_t *s)
+{
+    printf("  %-14s min %5lu  avg %5lu  max %5lu cycles\r\n", name,
+           (unsigned long)s->min,
+           (unsigned long)(s->total / s->count),
+           (unsigned long)s->max);
+}
+
+// Machine-readable average, same format as the other benchmarks
+static void perf_report(const char *name, const Stats_t *s)
+{
+    printf("PERF %s iters=%lu cyc_per_iter=%lu\r\n", name,
+           (unsigned long)s->count,
+           (unsigned long)(s->total / s->count));
+}
+
+//==============================================================================
+// Tasks
+//==============================================================================
+
+static void partner_task(void *arg)
+{
+    (void)arg;
+
+    while (!partner_stop) {
+        coop_yield();
+    }
+}
+
+static void waiter_task(void *arg)
+{
+    Stats_t *s = (Stats_t *)arg;
+    uint32_t now;
+
+    while (s->count < SAMPLES) {
+        if (coop_wait_irq(IRQ_SOFT, 100) == 0) {
+            printf("ERROR: software IRQ did not wake the waiter\r\n");
+            return;
+        }
+        now = rdcycle();
+        stats_add(s, now - trigger_cycle);
+    }
+}
+
+// Each yield switches to the partner and back: two switches
+static void measure_yield(Stats_t *s)
+{
+    uint32_t start, now;
+
+    stats_reset(s);
+    partner_stop = 0;
+    coop_task_create(&partner, "partner", partner_task, NULL, 1, partner_stack, STACK_WORDS);
+    coop_yield();           // Partner is at its loop
+
+    for (uint32_t i = 0; i < SAMPLES; i++) {
+        start = rdcycle();
+        coop_yield();
+        now = rdcycle();
+        stats_add(s, (now - start) / 2);
+    }
+
+    partner_stop = 1;
+    coop_yield();           // Partner returns
+}
+
+static void measure_wake(Stats_t *s)
+{
+    stats_reset(s);
+    coop_task_create(&waiter, "waiter", waiter_task, s, 2, waiter_stack, STACK_WORDS);
+    coop_yield();           // Higher priority: runs up to its first wait
+
+    while (s->count < SAMPLES && waiter.state == COOP_WAITING) {
+        trigger_cycle = rdcycle();
+        SOFT_IRQ_TRIGGER = 1;
+        coop_yield();
+    }
+}
+
+static void bench_task(void *arg)
+{
+    Stats_t yield, wake;
+    uint32_t run = 0;
+
+    (void)arg;
+
+    for (;;) {
+        // Let the previous report drain out of the UART
+        coop_sleep_ms(100);
+
+        measure_yield(&yield);
+        wake.count = 0;
+        if (irqc_present()) {
+            measure_wake(&wake);
+        }
+
+        printf("Run %lu (%u samples each, %lu switches so far):\r\n", (unsigned long)++run,
+               SAMPLES, (unsigned long)coop_switch_count());
+        perf_report("coop_yield", &yield);
+        if (wake.count) {
+            perf_report("coop_wake", &wake);
+        }
+        print_stats("Yield switch", &yield);
+        if (wake.count) {
+            print_stats("IRQ wake", &wake);
+        }
+        printf("  Stack left    %lu of %u bytes\r\n",
+               (unsigned long)coop_stack_free(&bench) * 4, STACK_WORDS * 2 * 4);
+
+        coop_sleep_ms(2000);
+    }
+}
+
+//==============================================================================
+// Main
+//==============================================================================
+
+int main(void)
+{
+    printf("\r\n");
+    printf("lib/coop task switch benchmark\r\n");
+    printf("Task control block: %u bytes, switch frame: 64 bytes\r\n",
+           (unsigned)sizeof(coop_task_t));
+    if (!irqc_present()) {
+        printf("No interrupt controller: IRQ wake test skipped\r\n");
+    }
+    printf("\r\n");
+
+    coop_init();
+    coop_task_create(&bench, "bench", bench_task, NULL, 1, bench_stack, STACK_WORDS * 2);
+    coop_start();
+
+    return 0;
+}
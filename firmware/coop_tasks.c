@@ -1,17 +1,23 @@
 /*
- * Simple Cooperative Multitasking Demo for PicoRV32
+ * Cooperative Multitasking Demo for PicoRV32 (lib/coop)
  *
- * No FreeRTOS - just manual task switching using timer interrupts.
- * This proves the concept works before tackling FreeRTOS complexity.
+ * No FreeRTOS: stackful tasks from lib/coop that switch only when they
+ * sleep, wait or yield.
  *
  * Architecture:
- * - 3 simple tasks that run cooperatively
- * - Timer interrupt triggers task switches every 100ms
- * - Each task prints a message and yields
- * - Round-robin scheduling
+ * - Task1 / Task2 blink LED0 / LED1 at different rates with coop_sleep_ms()
+ * - Echo waits on the UART RX interrupt (coop_wait_irq) and echoes keys
+ * - Status prints the tick, switch count and free stack every 5 seconds
+ * - The idle task sleeps in waitirq when nothing is ready
+ *
+ * No irq_handler() here: lib/coop registers its tick and event handlers
+ * with the start.S dispatcher (lib/irq.h).
  */
 
 #include <stdint.h>
+#include "../lib/coop/coop.h"
+#include "../lib/irq.h"
+#include "../lib/uart_irq.h"
 
 //==============================================================================
 // Hardware Registers
@@ -19,55 +25,26 @@
 
 #define UART_TX_DATA   (*(volatile uint32_t*)0x80000000)
 #define UART_TX_STATUS (*(volatile uint32_t*)0x80000004)
+#define UART_RX_DATA   (*(volatile uint32_t*)0x80000008)
+#define UART_RX_STATUS (*(volatile uint32_t*)0x8000000C)
 #define LED_CONTROL    (*(volatile uint32_t*)0x80000010)
 
-// Timer registers (from timer_clock.c - verified working)
-#define TIMER_BASE     0x80000020
-#define TIMER_CR       (*(volatile uint32_t*)(TIMER_BASE + 0x00))
-#define TIMER_SR       (*(volatile uint32_t*)(TIMER_BASE + 0x04))
-#define TIMER_PSC      (*(volatile uint32_t*)(TIMER_BASE + 0x08))
-#define TIMER_ARR      (*(volatile uint32_t*)(TIMER_BASE + 0x0C))
-#define TIMER_CNT      (*(volatile uint32_t*)(TIMER_BASE + 0x10))
-
-// Timer control bits
-#define TIMER_CR_ENABLE   (1 << 0)
-#define TIMER_CR_ONESHOT  (1 << 1)
-#define TIMER_SR_UIF      (1 << 0)
-
 //==============================================================================
-// Task Structure
+// Tasks
 //==============================================================================
 
-#define MAX_TASKS 3
-#define STACK_SIZE 512  // 512 words = 2KB per task
-
-typedef struct {
-    uint32_t *stack_ptr;     // Current stack pointer
-    uint32_t stack[STACK_SIZE];  // Task's private stack
-    const char *name;        // Task name for debugging
-    uint32_t run_count;      // How many times this task has run
-} Task_t;
-
-static Task_t tasks[MAX_TASKS];
-static int current_task = 0;
-static uint32_t tick_count = 0;
-
-//==============================================================================
-// PicoRV32 IRQ Control
-//==============================================================================
+#define STACK_WORDS 256  // 1KB per task
 
-static inline void irq_enable(void) {
-    uint32_t dummy;
-    __asm__ volatile (".insn r 0x0B, 6, 3, %0, %1, x0" : "=r"(dummy) : "r"(0));
-}
+static coop_task_t task1, task2, echo, status;
+static uint32_t task1_stack[STACK_WORDS];
+static uint32_t task2_stack[STACK_WORDS];
+static uint32_t echo_stack[STACK_WORDS];
+static uint32_t status_stack[STACK_WORDS];
 
-static inline void irq_disable(void) {
-    uint32_t dummy;
-    __asm__ volatile (".insn r 0x0B, 6, 3, %0, %1, x0" : "=r"(dummy) : "r"(~0));
-}
+static uint32_t echo_count = 0;
 
 //==============================================================================
-// Simple printf without newlib (for early debugging)
+// Simple printf without newlib
 //==============================================================================
 
 void uart_putc(char c) {
@@ -81,15 +58,6 @@ void uart_puts(const char *s) {
     }
 }
 
-void uart_puthex(uint32_t val) {
-    const char hex[] = "0123456789ABCDEF";
-    uart_putc('0');
-    uart_putc('x');
-    for (int i = 28; i >= 0; i -= 4) {
-        uart_putc(hex[(val >> i) & 0xF]);
-    }
-}
-
 void uart_putdec(uint32_t val) {
     if (val == 0) {
         uart_putc('0');
@@ -111,157 +79,71 @@ void uart_putdec(uint32_t val) {
 // Task Functions
 //==============================================================================
 
-void task1_func(void) {
-    // Run one iteration then return (cooperative yield)
-    uart_puts("[Task1] Running... count=");
-    uart_putdec(tasks[0].run_count);
-    uart_puts("\r\n");
-
-    // Toggle LED0
-    LED_CONTROL ^= 0x01;
-
-    // Busy wait (simulate work)
-    for (volatile int i = 0; i < 100000; i++);
+// arg = LED bit; the period comes from the bit so the two tasks drift
+static void blink_task(void *arg) {
+    uint32_t led = (uint32_t)arg;
+    uint32_t period_ms = (led == 0x01) ? 250 : 400;
 
-    tasks[0].run_count++;
-}
-
-void task2_func(void) {
-    // Run one iteration then return (cooperative yield)
-    uart_puts("[Task2] Running... count=");
-    uart_putdec(tasks[1].run_count);
-    uart_puts("\r\n");
-
-    // Toggle LED1
-    LED_CONTROL ^= 0x02;
-
-    // Busy wait (simulate work)
-    for (volatile int i = 0; i < 100000; i++);
-
-    tasks[1].run_count++;
-}
-
-void task3_func(void) {
-    // Run one iteration then return (cooperative yield)
-    uart_puts("[Task3] System status - Tick=");
-    uart_putdec(tick_count);
-    uart_puts("\r\n");
-
-    // Toggle LED2
-    LED_CONTROL ^= 0x04;
-
-    // Busy wait (simulate work)
-    for (volatile int i = 0; i < 100000; i++);
-
-    tasks[2].run_count++;
+    for (;;) {
+        LED_CONTROL ^= led;
+        coop_sleep_ms(period_ms);
+    }
 }
 
-//==============================================================================
-// Context Switching (Simple - No Assembly Required!)
-//==============================================================================
-
-// We don't actually switch contexts in the traditional sense
-// Instead, each task runs to completion of one iteration, then yields
-// The timer interrupt just switches which task's function gets called next
-
-//==============================================================================
-// Timer Interrupt Handler
-//==============================================================================
-
-void irq_handler(void) {
-    // Check if timer interrupt
-    if (TIMER_SR & TIMER_SR_UIF) {
-        // Clear interrupt flag
-        TIMER_SR = TIMER_SR_UIF;
-
-        // Increment tick
-        tick_count++;
+static void echo_task(void *arg) {
+    (void)arg;
+
+    for (;;) {
+        if (!(UART_RX_STATUS & 0x01)) {
+            if (irqc_present()) {
+                // Arm the device, then block until IRQ[4]; the handler
+                // disables the source at the controller, the device is ours
+                uart_irq_enable(UART_IRQ_RX_AVAIL);
+                coop_wait_irq(IRQ_UART_RX, COOP_FOREVER);
+                uart_irq_disable(UART_IRQ_RX_AVAIL);
+            } else {
+                coop_sleep_ms(10);  // No controller: poll
+            }
+        }
 
-        // Every 10 ticks (1 second at 100ms per tick), switch task
-        if (tick_count % 10 == 0) {
-            uart_puts("\r\n>>> Switching to next task <<<\r\n\r\n");
-            current_task = (current_task + 1) % MAX_TASKS;
+        while (UART_RX_STATUS & 0x01) {
+            char c = (char)UART_RX_DATA;
+            uart_puts("[Echo] '");
+            uart_putc((c >= 32 && c < 127) ? c : '?');
+            uart_puts("'\r\n");
+            echo_count++;
+            LED_CONTROL ^= 0x04;
         }
     }
 }
 
-//==============================================================================
-// Timer Initialization
-//==============================================================================
-
-void timer_init(void) {
-    // Stop timer
-    TIMER_CR = 0;
-
-    // Configure for 100ms tick (10 Hz)
-    // CPU clock = 50 MHz
-    // Prescaler = 49999 -> 50MHz / 50000 = 1 KHz
-    // Auto-reload = 99 -> 1KHz / 100 = 10 Hz (100ms period)
-    TIMER_PSC = 49999;
-    TIMER_ARR = 99;
-    TIMER_CNT = 0;
-
-    // Clear status
-    TIMER_SR = TIMER_SR_UIF;
-
-    // Enable timer (no interrupt enable bit - interrupts are always enabled when timer runs)
-    TIMER_CR = TIMER_CR_ENABLE;
-
-    uart_puts("Timer initialized: 100ms tick (10 Hz)\r\n");
-}
-
-//==============================================================================
-// Task Initialization
-//==============================================================================
-
-void tasks_init(void) {
-    // Initialize task 1
-    tasks[0].stack_ptr = &tasks[0].stack[STACK_SIZE - 1];
-    tasks[0].name = "Task1";
-    tasks[0].run_count = 0;
-
-    // Initialize task 2
-    tasks[1].stack_ptr = &tasks[1].stack[STACK_SIZE - 1];
-    tasks[1].name = "Task2";
-    tasks[1].run_count = 0;
-
-    // Initialize task 3
-    tasks[2].stack_ptr = &tasks[2].stack[STACK_SIZE - 1];
-    tasks[2].name = "Task3";
-    tasks[2].run_count = 0;
-
-    uart_puts("Tasks initialized\r\n");
+static void print_task(const coop_task_t *t) {
+    uart_puts("  ");
+    uart_puts(t->name);
+    uart_puts(": switched in ");
+    uart_putdec(t->switches);
+    uart_puts("x, ");
+    uart_putdec(coop_stack_free(t) * 4);
+    uart_puts(" bytes stack never used\r\n");
 }
 
-//==============================================================================
-// Main Scheduler Loop
-//==============================================================================
-
-void scheduler_run(void) {
-    uart_puts("\r\nStarting cooperative scheduler...\r\n");
-    uart_puts("Tasks switch every 10 ticks (1 second)\r\n");
-    uart_puts("Timer interrupt fires every 100ms\r\n\r\n");
-
-    // Enable interrupts
-    irq_enable();
-
-    // Main loop - run current task once per iteration
-    while (1) {
-        // Run the current task (it will return after one iteration)
-        switch (current_task) {
-            case 0:
-                task1_func();
-                break;
-            case 1:
-                task2_func();
-                break;
-            case 2:
-                task3_func();
-                break;
-        }
-
-        // Small delay between task iterations
-        for (volatile int i = 0; i < 10000; i++);
+static void status_task(void *arg) {
+    (void)arg;
+
+    for (;;) {
+        coop_sleep_ms(5000);
+
+        uart_puts("\r\n[Status] Tick=");
+        uart_putdec(coop_ticks());
+        uart_puts(" switches=");
+        uart_putdec(coop_switch_count());
+        uart_puts(" echoed=");
+        uart_putdec(echo_count);
+        uart_puts("\r\n");
+        print_task(&task1);
+        print_task(&task2);
+        print_task(&echo);
+        print_task(&status);
     }
 }
 
@@ -272,22 +154,24 @@ void scheduler_run(void) {
 int main(void) {
     uart_puts("\r\n");
     uart_puts("========================================\r\n");
-    uart_puts("Simple Cooperative Multitasking Demo\r\n");
+    uart_puts("Cooperative Multitasking Demo (lib/coop)\r\n");
     uart_puts("========================================\r\n");
     uart_puts("\r\n");
 
-    uart_puts("Initializing tasks...\r\n");
-    tasks_init();
+    if (!irqc_present()) {
+        uart_puts("No interrupt controller: echo task polls every 10 ms\r\n");
+    }
 
-    uart_puts("Initializing timer...\r\n");
-    timer_init();
+    coop_init();
+    coop_task_create(&task1, "Task1", blink_task, (void *)0x01, 1, task1_stack, STACK_WORDS);
+    coop_task_create(&task2, "Task2", blink_task, (void *)0x02, 1, task2_stack, STACK_WORDS);
+    coop_task_create(&echo, "Echo", echo_task, 0, 3, echo_stack, STACK_WORDS);
+    coop_task_create(&status, "Status", status_task, 0, 2, status_stack, STACK_WORDS);
 
-    uart_puts("\r\n");
-    scheduler_run();
+    uart_puts("LED0 250 ms, LED1 400 ms, keys are echoed, status every 5 s\r\n\r\n");
 
-    // Should never reach here
-    uart_puts("ERROR: Scheduler returned!\r\n");
-    while (1);
+    coop_start();
 
+    // Should never reach here
     return 0;
 }
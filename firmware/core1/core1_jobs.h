@@ -0,0 +1,33 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// core1_jobs.h - Job Descriptors Between Core 0 and the Core 1 Worker
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+//
+// Core 0 fills a core1_job_t in SRAM and sends its address through the
+// mailbox (lib/mailbox.h); core1_worker.c runs it, stores result and sends
+// the same address back. At start-up the worker sends CORE1_MSG_READY.
+//
+//==============================================================================
+
+#ifndef CORE1_JOBS_H
+#define CORE1_JOBS_H
+
+#include <stdint.h>
+
+#define CORE1_MSG_READY     0xC0DE0001      // Not a job address (odd)
+
+#define CORE1_OP_NOP        0               // Reply only (mailbox round trip)
+#define CORE1_OP_CRC32      1               // result = CRC32 of src[0..len)
+#define CORE1_OP_SUM        2               // result = sum of len / 4 words
+
+typedef struct {
+    uint32_t op;
+    uint32_t src;                           // SRAM address
+    uint32_t len;                           // Bytes
+    uint32_t result;
+} core1_job_t;
+
+#endif // CORE1_JOBS_H
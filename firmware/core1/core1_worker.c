@@ -0,0 +1,71 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// core1_worker.c - Core 1 Job Worker (Kconfig DUAL_CORE)
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+//
+// Runs on the second core (RV32I, no libc): waits for job addresses from
+// core 0 (core1_jobs.h), runs them and sends the address back. Polling the
+// mailbox and the CRC table in the local scratchpad stay off the shared
+// bus; only the job descriptor and the data come from SRAM.
+//
+//==============================================================================
+
+#include <stdint.h>
+#include "../../lib/mailbox.h"
+#include "core1_jobs.h"
+
+// Byte-wise CRC32 table (zlib polynomial, reflected), 1 KB of the 2 KB
+// scratchpad
+static uint32_t crc_table[256] __attribute__((section(".lspad")));
+
+static void crc_table_init(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++)
+            c = (c & 1) ? (c >> 1) ^ 0xEDB88320u : c >> 1;
+        crc_table[i] = c;
+    }
+}
+
+static uint32_t job_crc32(const uint8_t *p, uint32_t len) {
+    uint32_t crc = 0xFFFFFFFFu;
+
+    while (len--)
+        crc = crc_table[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+static uint32_t job_sum(const uint32_t *p, uint32_t len) {
+    uint32_t sum = 0;
+
+    for (uint32_t i = 0; i < len / 4; i++)
+        sum += p[i];
+    return sum;
+}
+
+int main(void) {
+    crc_table_init();
+    mailbox_send(CORE1_MSG_READY);
+
+    for (;;) {
+        uint32_t msg = mailbox_recv();
+        core1_job_t *job = (core1_job_t *)msg;
+
+        switch (job->op) {
+        case CORE1_OP_CRC32:
+            job->result = job_crc32((const uint8_t *)job->src, job->len);
+            break;
+        case CORE1_OP_SUM:
+            job->result = job_sum((const uint32_t *)job->src, job->len);
+            break;
+        default:
+            break;
+        }
+        mailbox_send(msg);
+    }
+
+    return 0;
+}
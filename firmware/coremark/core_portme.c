@@ -0,0 +1,92 @@
+//===============================================================================
+// CoreMark Port for PicoRV32 - Timing and Platform Hooks
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+
+#include <stddef.h>
+#include "coremark.h"
+#include "core_portme.h"
+#include "perf_counters.h"
+
+#ifndef ITERATIONS
+#define ITERATIONS          0           // Calibrate to >= 10 s
+#endif
+
+#define EE_TICKS_PER_SEC    PERF_CPU_HZ
+
+#if VALIDATION_RUN
+volatile ee_s32 seed1_volatile = 0x3415;
+volatile ee_s32 seed2_volatile = 0x3415;
+volatile ee_s32 seed3_volatile = 0x66;
+#endif
+#if PERFORMANCE_RUN
+volatile ee_s32 seed1_volatile = 0x0;
+volatile ee_s32 seed2_volatile = 0x0;
+volatile ee_s32 seed3_volatile = 0x66;
+#endif
+#if PROFILE_RUN
+volatile ee_s32 seed1_volatile = 0x8;
+volatile ee_s32 seed2_volatile = 0x8;
+volatile ee_s32 seed3_volatile = 0x8;
+#endif
+volatile ee_s32 seed4_volatile = ITERATIONS;
+volatile ee_s32 seed5_volatile = 0;
+
+ee_u32 default_num_contexts = 1;
+
+//===============================================================================
+// Timing: the last start_time() / stop_time() pair is the timed run
+//===============================================================================
+
+static perf_sample_t start_sample, stop_sample;
+
+void start_time(void) {
+    perf_sample(&start_sample);
+}
+
+void stop_time(void) {
+    perf_sample(&stop_sample);
+}
+
+CORE_TICKS get_time(void) {
+    return stop_sample.cycles - start_sample.cycles;
+}
+
+secs_ret time_in_secs(CORE_TICKS ticks) {
+    return (secs_ret)ticks / (secs_ret)EE_TICKS_PER_SEC;
+}
+
+//===============================================================================
+// Platform Hooks
+//===============================================================================
+
+void portable_init(core_portable *p, int *argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    if (sizeof(ee_ptr_int) != sizeof(ee_u8 *)) {
+        ee_printf("ERROR! Please define ee_ptr_int to a type that holds a pointer!\n");
+    }
+    if (sizeof(ee_u32) != 4) {
+        ee_printf("ERROR! Please define ee_u32 to a 32b unsigned type!\n");
+    }
+    p->portable_id = 1;
+}
+
+// p is results[0].port: the iteration count and the error count are in
+// the enclosing core_results
+void portable_fini(core_portable *p) {
+    const core_results *res = (const core_results *)((const char *)p -
+                                                     offsetof(core_results, port));
+    coremark_result_t r;
+
+    r.iterations = res->iterations * default_num_contexts;
+    r.cycles = stop_sample.cycles - start_sample.cycles;
+    r.instret = stop_sample.instret - start_sample.instret;
+    r.errors = res->err > 0 ? (uint32_t)res->err : 0;
+    p->portable_id = 0;
+
+    coremark_report(&r);
+}
@@ -0,0 +1,136 @@
+//===============================================================================
+// CoreMark Port for PicoRV32 - Configuration and Types
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// The EEMBC sources (core_main.c, core_list_join.c, core_matrix.c,
+// core_state.c, core_util.c, coremark.h) are fetched to downloads/coremark
+// by 'make coremark-download' and built unmodified; this directory is the
+// port, what the CoreMark run rules let a port define:
+//
+//   - time: the rdcycle counter (Kconfig ENABLE_COUNTERS), one tick per
+//     CPU cycle, so the 32-bit counter limits a run to ~85 s at 50 MHz
+//   - memory: MEM_STATIC, the 2000-byte data set in .bss
+//   - seeds: SEED_VOLATILE, ITERATIONS 0 by default, so core_main.c
+//     calibrates to a run of at least 10 s
+//   - output: newlib printf, doubles for the seconds and the score
+//
+// portable_fini() hands the iteration count and the timed cycles and
+// instructions to coremark_report() (coremark.c in firmware, main.c in the
+// overlay), which prints CoreMark/MHz = iterations * 1e6 / cycles.
+//
+//===============================================================================
+
+#ifndef CORE_PORTME_H
+#define CORE_PORTME_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+//===============================================================================
+// Features
+//===============================================================================
+
+#define HAS_FLOAT           1
+#define HAS_TIME_H          0
+#define USE_CLOCK           0
+#define HAS_STDIO           1
+#define HAS_PRINTF          1
+
+#ifndef COMPILER_VERSION
+#ifdef __GNUC__
+#define COMPILER_VERSION    "GCC"__VERSION__
+#else
+#define COMPILER_VERSION    "unknown"
+#endif
+#endif
+#ifndef COMPILER_FLAGS
+#define COMPILER_FLAGS      FLAGS_STR   // firmware/Makefile, overlay Makefile
+#endif
+#ifndef MEM_LOCATION
+#define MEM_LOCATION        "STATIC"
+#endif
+
+//===============================================================================
+// Types
+//===============================================================================
+
+typedef int16_t             ee_s16;
+typedef uint16_t            ee_u16;
+typedef int32_t             ee_s32;
+typedef double              ee_f32;
+typedef uint8_t             ee_u8;
+typedef uint32_t            ee_u32;
+typedef uintptr_t           ee_ptr_int;
+typedef size_t              ee_size_t;
+
+// 32-bit aligned pointer at or above x
+#define align_mem(x)        (void *)(4 + (((ee_ptr_int)(x) - 1) & ~3))
+
+typedef ee_u32              CORE_TICKS;
+
+//===============================================================================
+// Run Configuration
+//===============================================================================
+
+#ifndef SEED_METHOD
+#define SEED_METHOD         SEED_VOLATILE
+#endif
+
+#ifndef MEM_METHOD
+#define MEM_METHOD          MEM_STATIC
+#endif
+
+#ifndef MULTITHREAD
+#define MULTITHREAD         1
+#define USE_PTHREAD         0
+#define USE_FORK            0
+#define USE_SOCKET          0
+#endif
+
+#ifndef MAIN_HAS_NOARGC
+#define MAIN_HAS_NOARGC     1
+#endif
+
+#ifndef MAIN_HAS_NORETURN
+#define MAIN_HAS_NORETURN   0
+#endif
+
+#if !defined(PROFILE_RUN) && !defined(PERFORMANCE_RUN) && !defined(VALIDATION_RUN)
+#define PERFORMANCE_RUN     1
+#endif
+
+extern ee_u32 default_num_contexts;
+
+typedef struct CORE_PORTABLE_S {
+    ee_u8 portable_id;
+} core_portable;
+
+void portable_init(core_portable *p, int *argc, char *argv[]);
+void portable_fini(core_portable *p);
+
+//===============================================================================
+// Reporting (this port)
+//===============================================================================
+
+// Timed part of the run: what core_main.c measures between start_time()
+// and stop_time()
+typedef struct {
+    uint32_t iterations;
+    uint32_t cycles;
+    uint32_t instret;
+    uint32_t errors;                    // core_main.c's CRC / data type checks
+} coremark_result_t;
+
+// Called by portable_fini()
+void coremark_report(const coremark_result_t *r);
+
+// CoreMark/MHz x 1000 (2345 = 2.345)
+static inline uint32_t coremark_per_mhz_x1000(const coremark_result_t *r) {
+    if (r->cycles == 0) return 0;
+    return (uint32_t)((uint64_t)r->iterations * 1000000000ull / r->cycles);
+}
+
+#endif // CORE_PORTME_H
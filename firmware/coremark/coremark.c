@@ -0,0 +1,46 @@
+//===============================================================================
+// CoreMark Benchmark Firmware - Result Report
+// CoreMark/MHz of the core and memory configuration in the bitstream
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// main() is EEMBC's core_main.c (make fw-coremark fetches it); it runs at
+// start-up, prints its own report and calls this through portable_fini().
+// Lines for scripts/bench_profiles.sh:
+//
+//   PERF coremark iters=<iterations> cyc_per_iter=<cycles per iteration>
+//   SCORE CoreMark/MHz <n.nnn>
+//
+// SCORE only for a valid run (CRCs as expected, at least 10 s). Needs
+// Kconfig ENABLE_COUNTERS.
+//
+//===============================================================================
+
+#include <stdio.h>
+#include "core_portme.h"
+#include "perf_counters.h"
+
+void coremark_report(const coremark_result_t *r) {
+    uint32_t per_mhz = coremark_per_mhz_x1000(r);
+    uint32_t cpi = perf_cpi_x100(r->cycles, r->instret);
+    int valid = r->errors == 0 && r->cycles / PERF_CPU_HZ >= 10;
+
+    printf("\r\n");
+    printf("Cycles           : %lu (%lu per iteration)\r\n", (unsigned long)r->cycles,
+           (unsigned long)(r->iterations ? r->cycles / r->iterations : 0));
+    printf("Instructions     : %lu (CPI %lu.%02lu)\r\n", (unsigned long)r->instret,
+           (unsigned long)(cpi / 100), (unsigned long)(cpi % 100));
+    printf("CoreMark/MHz     : %lu.%03lu%s\r\n", (unsigned long)(per_mhz / 1000),
+           (unsigned long)(per_mhz % 1000), valid ? "" : " (not a valid run)");
+
+    printf("\r\nPERF coremark iters=%lu cyc_per_iter=%lu\r\n", (unsigned long)r->iterations,
+           (unsigned long)(r->iterations ? r->cycles / r->iterations : 0));
+    if (valid) {
+        printf("SCORE CoreMark/MHz %lu.%03lu\r\n", (unsigned long)(per_mhz / 1000),
+               (unsigned long)(per_mhz % 1000));
+    }
+    printf("Benchmark complete\r\n");
+    fflush(stdout);
+}
@@ -0,0 +1,130 @@
+//===============================================================================
+// Dhrystone 2.1 - Types, Globals and Port Interface
+// Reinhold P. Weicker's synthetic integer benchmark (ACM SIGPLAN Notices
+// 23(8), 1988), timed with the cycle counter
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// The benchmark code in dhry_1.c / dhry_2.c is version 2.1 with ANSI
+// prototypes: same statements, same split across two translation units (so
+// Proc_6..8 and Func_1..3 are not inlined into the loop), records in static
+// storage instead of malloc(). What changed is the driver: no scanf(), no
+// times(); dhrystone_run() takes the number of runs and returns rdcycle /
+// rdinstret deltas and whether the final values are the ones 2.1 lists as
+// "should be".
+//
+// Reporting convention: DMIPS is Dhrystones per second / 1757 (the VAX
+// 11/780 result), so
+//
+//   DMIPS/MHz = runs * 1e6 / cycles / 1757
+//
+// which is independent of the clock. Built at -O2 without LTO (firmware/
+// Makefile), the usual conditions for a quoted score.
+//
+// Used by firmware/dhrystone/dhrystone.c (make fw-dhrystone) and the
+// overlay_sdk/projects/dhrystone overlay.
+//
+//===============================================================================
+
+#ifndef DHRY_H
+#define DHRY_H
+
+#include <stdint.h>
+
+#define DHRY_VAX_DPS        1757        // Dhrystones/s of a VAX 11/780 = 1 MIPS
+
+// Enough for the 2 s minimum at 50 MHz on the fastest profile
+#ifndef DHRY_RUNS
+#define DHRY_RUNS           200000
+#endif
+
+//===============================================================================
+// Benchmark Types (Dhrystone 2.1)
+//===============================================================================
+
+typedef enum { Ident_1, Ident_2, Ident_3, Ident_4, Ident_5 } Enumeration;
+
+typedef int     One_Thirty;
+typedef int     One_Fifty;
+typedef char    Capital_Letter;
+typedef int     Boolean;
+typedef char    Str_30[31];
+typedef int     Arr_1_Dim[50];
+typedef int     Arr_2_Dim[50][50];
+
+typedef struct record {
+    struct record *Ptr_Comp;
+    Enumeration Discr;
+    union {
+        struct {
+            Enumeration Enum_Comp;
+            int Int_Comp;
+            char Str_Comp[31];
+        } var_1;
+        struct {
+            Enumeration E_Comp_2;
+            char Str_2_Comp[31];
+        } var_2;
+        struct {
+            char Ch_1_Comp;
+            char Ch_2_Comp;
+        } var_3;
+    } variant;
+} Rec_Type, *Rec_Pointer;
+
+#define true    1
+#define false   0
+
+// Globals (dhry_1.c)
+extern Rec_Pointer Ptr_Glob;
+extern Rec_Pointer Next_Ptr_Glob;
+extern int Int_Glob;
+extern Boolean Bool_Glob;
+extern char Ch_1_Glob;
+extern char Ch_2_Glob;
+extern int Arr_1_Glob[50];
+extern int Arr_2_Glob[50][50];
+
+// dhry_1.c
+void Proc_1(Rec_Pointer Ptr_Val_Par);
+void Proc_2(One_Fifty *Int_Par_Ref);
+void Proc_3(Rec_Pointer *Ptr_Ref_Par);
+void Proc_4(void);
+void Proc_5(void);
+
+// dhry_2.c
+void Proc_6(Enumeration Enum_Val_Par, Enumeration *Enum_Ref_Par);
+void Proc_7(One_Fifty Int_1_Par_Val, One_Fifty Int_2_Par_Val, One_Fifty *Int_Par_Ref);
+void Proc_8(Arr_1_Dim Arr_1_Par_Ref, Arr_2_Dim Arr_2_Par_Ref,
+            int Int_1_Par_Val, int Int_2_Par_Val);
+Enumeration Func_1(Capital_Letter Ch_1_Par_Val, Capital_Letter Ch_2_Par_Val);
+Boolean Func_2(Str_30 Str_1_Par_Ref, Str_30 Str_2_Par_Ref);
+Boolean Func_3(Enumeration Enum_Par_Val);
+
+//===============================================================================
+// Driver
+//===============================================================================
+
+typedef struct {
+    uint32_t runs;
+    uint32_t cycles;                    // Main loop only
+    uint32_t instret;
+    uint32_t errors;                    // Final values not as listed in 2.1
+} dhry_result_t;
+
+// Run the main loop runs times (the 32-bit counter wraps after ~85 s at
+// 50 MHz: keep runs * cycles per run below that)
+void dhrystone_run(uint32_t runs, dhry_result_t *r);
+
+// Print the result block (printf)
+void dhrystone_print(const dhry_result_t *r);
+
+// DMIPS/MHz x 1000 (516 = 0.516)
+static inline uint32_t dhry_dmips_per_mhz_x1000(const dhry_result_t *r) {
+    if (r->cycles == 0) return 0;
+    return (uint32_t)((uint64_t)r->runs * 1000000000ull / ((uint64_t)r->cycles * DHRY_VAX_DPS));
+}
+
+#endif // DHRY_H
@@ -0,0 +1,254 @@
+//===============================================================================
+// Dhrystone 2.1 - Main Loop, Proc_1..Proc_5 and the Driver
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// Benchmark: Reinhold P. Weicker, Dhrystone 2.1 (1988). Driver, timing and
+// reporting: see dhry.h.
+//
+//===============================================================================
+
+#include <stdio.h>
+#include <string.h>
+#include "dhry.h"
+#include "perf_counters.h"
+
+Rec_Pointer Ptr_Glob;
+Rec_Pointer Next_Ptr_Glob;
+int Int_Glob;
+Boolean Bool_Glob;
+char Ch_1_Glob;
+char Ch_2_Glob;
+int Arr_1_Glob[50];
+int Arr_2_Glob[50][50];
+
+static Rec_Type Glob_Rec;
+static Rec_Type Next_Glob_Rec;
+
+// Locals of the main loop, kept for the final value check
+static One_Fifty Int_1_Res, Int_2_Res, Int_3_Res;
+static Enumeration Enum_Res;
+static Str_30 Str_1_Res, Str_2_Res;
+
+//===============================================================================
+// Driver
+//===============================================================================
+
+static uint32_t dhry_check(uint32_t runs) {
+    uint32_t errors = 0;
+
+    errors += Int_Glob != 5;
+    errors += Bool_Glob != 1;
+    errors += Ch_1_Glob != 'A';
+    errors += Ch_2_Glob != 'B';
+    errors += Arr_1_Glob[8] != 7;
+    errors += Arr_2_Glob[8][7] != (int)runs + 10;
+    errors += Ptr_Glob->Discr != 0;
+    errors += Ptr_Glob->variant.var_1.Enum_Comp != 2;
+    errors += Ptr_Glob->variant.var_1.Int_Comp != 17;
+    errors += strcmp(Ptr_Glob->variant.var_1.Str_Comp, "DHRYSTONE PROGRAM, SOME STRING") != 0;
+    errors += Next_Ptr_Glob->Discr != 0;
+    errors += Next_Ptr_Glob->variant.var_1.Enum_Comp != 1;
+    errors += Next_Ptr_Glob->variant.var_1.Int_Comp != 18;
+    errors += strcmp(Next_Ptr_Glob->variant.var_1.Str_Comp, "DHRYSTONE PROGRAM, SOME STRING") != 0;
+    errors += Int_1_Res != 5;
+    errors += Int_2_Res != 13;
+    errors += Int_3_Res != 7;
+    errors += Enum_Res != 1;
+    errors += strcmp(Str_1_Res, "DHRYSTONE PROGRAM, 1'ST STRING") != 0;
+    errors += strcmp(Str_2_Res, "DHRYSTONE PROGRAM, 2'ND STRING") != 0;
+
+    return errors;
+}
+
+void dhrystone_run(uint32_t runs, dhry_result_t *r) {
+    One_Fifty Int_1_Loc;
+    One_Fifty Int_2_Loc;
+    One_Fifty Int_3_Loc;
+    char Ch_Index;
+    Enumeration Enum_Loc;
+    Str_30 Str_1_Loc;
+    Str_30 Str_2_Loc;
+    int Run_Index;
+    int Number_Of_Runs = (int)runs;
+    perf_sample_t start, end;
+
+    // Initializations
+    memset(Arr_1_Glob, 0, sizeof(Arr_1_Glob));
+    memset(Arr_2_Glob, 0, sizeof(Arr_2_Glob));
+    Int_Glob = 0;
+    Bool_Glob = false;
+    Ch_1_Glob = Ch_2_Glob = 0;
+
+    Next_Ptr_Glob = &Next_Glob_Rec;
+    Ptr_Glob = &Glob_Rec;
+
+    Ptr_Glob->Ptr_Comp = Next_Ptr_Glob;
+    Ptr_Glob->Discr = Ident_1;
+    Ptr_Glob->variant.var_1.Enum_Comp = Ident_3;
+    Ptr_Glob->variant.var_1.Int_Comp = 40;
+    strcpy(Ptr_Glob->variant.var_1.Str_Comp, "DHRYSTONE PROGRAM, SOME STRING");
+    strcpy(Str_1_Loc, "DHRYSTONE PROGRAM, 1'ST STRING");
+
+    Arr_2_Glob[8][7] = 10;
+
+    // Values the 2.1 driver leaves unset before the loop; the loop always
+    // assigns them
+    Int_1_Loc = Int_2_Loc = Int_3_Loc = 0;
+    Enum_Loc = Ident_1;
+    Str_2_Loc[0] = '\0';
+
+    perf_sample(&start);
+
+    for (Run_Index = 1; Run_Index <= Number_Of_Runs; ++Run_Index) {
+        Proc_5();
+        Proc_4();
+        // Ch_1_Glob == 'A', Ch_2_Glob == 'B', Bool_Glob == true
+        Int_1_Loc = 2;
+        Int_2_Loc = 3;
+        strcpy(Str_2_Loc, "DHRYSTONE PROGRAM, 2'ND STRING");
+        Enum_Loc = Ident_2;
+        Bool_Glob = !Func_2(Str_1_Loc, Str_2_Loc);
+        // Bool_Glob == 1
+        while (Int_1_Loc < Int_2_Loc) {     // Loop body executed once
+            Int_3_Loc = 5 * Int_1_Loc - Int_2_Loc;
+            // Int_3_Loc == 7
+            Proc_7(Int_1_Loc, Int_2_Loc, &Int_3_Loc);
+            // Int_3_Loc == 7
+            Int_1_Loc += 1;
+        }
+        // Int_1_Loc == 3, Int_2_Loc == 3, Int_3_Loc == 7
+        Proc_8(Arr_1_Glob, Arr_2_Glob, Int_1_Loc, Int_3_Loc);
+        // Int_Glob == 5
+        Proc_1(Ptr_Glob);
+        for (Ch_Index = 'A'; Ch_Index <= Ch_2_Glob; ++Ch_Index) {
+            // Loop body executed twice
+            if (Enum_Loc == Func_1(Ch_Index, 'C')) {
+                // Then, not executed
+                Proc_6(Ident_1, &Enum_Loc);
+                strcpy(Str_2_Loc, "DHRYSTONE PROGRAM, 3'RD STRING");
+                Int_2_Loc = Run_Index;
+                Int_Glob = Run_Index;
+            }
+        }
+        // Int_1_Loc == 3, Int_2_Loc == 3, Int_3_Loc == 7
+        Int_2_Loc = Int_2_Loc * Int_1_Loc;
+        Int_1_Loc = Int_2_Loc / Int_3_Loc;
+        Int_2_Loc = 7 * (Int_2_Loc - Int_3_Loc) - Int_1_Loc;
+        // Int_1_Loc == 1, Int_2_Loc == 13, Int_3_Loc == 7
+        Proc_2(&Int_1_Loc);
+        // Int_1_Loc == 5
+    }
+
+    perf_sample(&end);
+
+    Int_1_Res = Int_1_Loc;
+    Int_2_Res = Int_2_Loc;
+    Int_3_Res = Int_3_Loc;
+    Enum_Res = Enum_Loc;
+    strcpy(Str_1_Res, Str_1_Loc);
+    strcpy(Str_2_Res, Str_2_Loc);
+
+    r->runs = runs;
+    r->cycles = end.cycles - start.cycles;
+    r->instret = end.instret - start.instret;
+    r->errors = dhry_check(runs);
+}
+
+void dhrystone_print(const dhry_result_t *r) {
+    uint32_t per_mhz = dhry_dmips_per_mhz_x1000(r);
+    uint32_t mhz = (uint32_t)(PERF_CPU_HZ / 1000000UL);
+    uint32_t dps = r->cycles ? (uint32_t)((uint64_t)r->runs * PERF_CPU_HZ / r->cycles) : 0;
+    uint32_t cpi = perf_cpi_x100(r->cycles, r->instret);
+
+    printf("Dhrystone 2.1, %lu runs\r\n", (unsigned long)r->runs);
+    printf("  Cycles:              %lu (%lu per run)\r\n", (unsigned long)r->cycles,
+           (unsigned long)(r->runs ? r->cycles / r->runs : 0));
+    printf("  Instructions:        %lu (CPI %lu.%02lu)\r\n", (unsigned long)r->instret,
+           (unsigned long)(cpi / 100), (unsigned long)(cpi % 100));
+    printf("  Dhrystones/s:        %lu at %lu MHz\r\n", (unsigned long)dps,
+           (unsigned long)mhz);
+    printf("  DMIPS:               %lu.%03lu\r\n", (unsigned long)(per_mhz * mhz / 1000),
+           (unsigned long)(per_mhz * mhz % 1000));
+    printf("  DMIPS/MHz:           %lu.%03lu\r\n", (unsigned long)(per_mhz / 1000),
+           (unsigned long)(per_mhz % 1000));
+    if (r->cycles / (PERF_CPU_HZ / 1000UL) < 2000) {
+        printf("  Note: under 2 s measured, raise DHRY_RUNS for a quotable result\r\n");
+    }
+    if (r->errors) {
+        printf("  FAIL: %lu final values differ from Dhrystone 2.1\r\n",
+               (unsigned long)r->errors);
+    } else {
+        printf("  Final values match Dhrystone 2.1\r\n");
+    }
+}
+
+//===============================================================================
+// Proc_1 .. Proc_5 (Dhrystone 2.1)
+//===============================================================================
+
+void Proc_1(Rec_Pointer Ptr_Val_Par) {
+    Rec_Pointer Next_Record = Ptr_Val_Par->Ptr_Comp;
+    // == Ptr_Glob_Next; Local variable, initialized with Ptr_Val_Par->Ptr_Comp,
+    // corresponds to "rename" in Ada, "with" in Pascal
+
+    *Ptr_Val_Par->Ptr_Comp = *Ptr_Glob;
+    Ptr_Val_Par->variant.var_1.Int_Comp = 5;
+    Next_Record->variant.var_1.Int_Comp = Ptr_Val_Par->variant.var_1.Int_Comp;
+    Next_Record->Ptr_Comp = Ptr_Val_Par->Ptr_Comp;
+    Proc_3(&Next_Record->Ptr_Comp);
+    // Ptr_Val_Par->Ptr_Comp->Ptr_Comp == Ptr_Glob->Ptr_Comp
+    if (Next_Record->Discr == Ident_1) {
+        // Then, executed
+        Next_Record->variant.var_1.Int_Comp = 6;
+        Proc_6(Ptr_Val_Par->variant.var_1.Enum_Comp, &Next_Record->variant.var_1.Enum_Comp);
+        Next_Record->Ptr_Comp = Ptr_Glob->Ptr_Comp;
+        Proc_7(Next_Record->variant.var_1.Int_Comp, 10, &Next_Record->variant.var_1.Int_Comp);
+    } else {
+        // Not executed
+        *Ptr_Val_Par = *Ptr_Val_Par->Ptr_Comp;
+    }
+}
+
+void Proc_2(One_Fifty *Int_Par_Ref) {
+    // Executed once; *Int_Par_Ref == 1, becomes 4
+    One_Fifty Int_Loc;
+    Enumeration Enum_Loc = Ident_2;
+
+    Int_Loc = *Int_Par_Ref + 10;
+    do {
+        // Executed once
+        if (Ch_1_Glob == 'A') {
+            // Then, executed
+            Int_Loc -= 1;
+            *Int_Par_Ref = Int_Loc - Int_Glob;
+            Enum_Loc = Ident_1;
+        }
+    } while (Enum_Loc != Ident_1);      // True
+}
+
+void Proc_3(Rec_Pointer *Ptr_Ref_Par) {
+    // Executed once; Ptr_Ref_Par becomes Ptr_Glob
+    if (Ptr_Glob != 0) {
+        // Then, executed
+        *Ptr_Ref_Par = Ptr_Glob->Ptr_Comp;
+    }
+    Proc_7(10, Int_Glob, &Ptr_Glob->variant.var_1.Int_Comp);
+}
+
+void Proc_4(void) {
+    // Executed once
+    Boolean Bool_Loc;
+
+    Bool_Loc = Ch_1_Glob == 'A';
+    Bool_Glob = Bool_Loc | Bool_Glob;
+    Ch_2_Glob = 'B';
+}
+
+void Proc_5(void) {
+    // Executed once
+    Ch_1_Glob = 'A';
+    Bool_Glob = false;
+}
@@ -0,0 +1,144 @@
+//===============================================================================
+// Dhrystone 2.1 - Proc_6..Proc_8 and Func_1..Func_3
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// Benchmark: Reinhold P. Weicker, Dhrystone 2.1 (1988). A translation unit
+// of its own, as in the original distribution, so these are real calls
+// from the main loop in dhry_1.c.
+//
+//===============================================================================
+
+#include <string.h>
+#include "dhry.h"
+
+void Proc_6(Enumeration Enum_Val_Par, Enumeration *Enum_Ref_Par) {
+    // Executed once; Enum_Val_Par == Ident_3, Enum_Ref_Par becomes Ident_2
+    *Enum_Ref_Par = Enum_Val_Par;
+    if (!Func_3(Enum_Val_Par)) {
+        // Then, not executed
+        *Enum_Ref_Par = Ident_4;
+    }
+    switch (Enum_Val_Par) {
+    case Ident_1:
+        *Enum_Ref_Par = Ident_1;
+        break;
+    case Ident_2:
+        if (Int_Glob > 100) {
+            // Then
+            *Enum_Ref_Par = Ident_1;
+        } else {
+            *Enum_Ref_Par = Ident_4;
+        }
+        break;
+    case Ident_3:       // Executed
+        *Enum_Ref_Par = Ident_2;
+        break;
+    case Ident_4:
+        break;
+    case Ident_5:
+        *Enum_Ref_Par = Ident_3;
+        break;
+    }
+}
+
+void Proc_7(One_Fifty Int_1_Par_Val, One_Fifty Int_2_Par_Val, One_Fifty *Int_Par_Ref) {
+    // Executed three times
+    // first call:  Int_1_Par_Val == 2, Int_2_Par_Val == 3, Int_Par_Ref becomes 7
+    // second call: Int_1_Par_Val == 10, Int_2_Par_Val == 5, Int_Par_Ref becomes 17
+    // third call:  Int_1_Par_Val == 6, Int_2_Par_Val == 10, Int_Par_Ref becomes 18
+    One_Fifty Int_Loc;
+
+    Int_Loc = Int_1_Par_Val + 2;
+    *Int_Par_Ref = Int_2_Par_Val + Int_Loc;
+}
+
+void Proc_8(Arr_1_Dim Arr_1_Par_Ref, Arr_2_Dim Arr_2_Par_Ref,
+            int Int_1_Par_Val, int Int_2_Par_Val) {
+    // Executed once; Int_Par_Val_1 == 3, Int_Par_Val_2 == 7
+    One_Fifty Int_Index;
+    One_Fifty Int_Loc;
+
+    Int_Loc = Int_1_Par_Val + 5;
+    Arr_1_Par_Ref[Int_Loc] = Int_2_Par_Val;
+    Arr_1_Par_Ref[Int_Loc + 1] = Arr_1_Par_Ref[Int_Loc];
+    Arr_1_Par_Ref[Int_Loc + 30] = Int_Loc;
+    for (Int_Index = Int_Loc; Int_Index <= Int_Loc + 1; ++Int_Index) {
+        Arr_2_Par_Ref[Int_Loc][Int_Index] = Int_Loc;
+    }
+    Arr_2_Par_Ref[Int_Loc][Int_Loc - 1] += 1;
+    Arr_2_Par_Ref[Int_Loc + 20][Int_Loc] = Arr_1_Par_Ref[Int_Loc];
+    Int_Glob = 5;
+}
+
+Enumeration Func_1(Capital_Letter Ch_1_Par_Val, Capital_Letter Ch_2_Par_Val) {
+    // Executed three times
+    // first call:  Ch_1_Par_Val == 'H', Ch_2_Par_Val == 'R'
+    // second call: Ch_1_Par_Val == 'A', Ch_2_Par_Val == 'C'
+    // third call:  Ch_1_Par_Val == 'B', Ch_2_Par_Val == 'C'
+    Capital_Letter Ch_1_Loc;
+    Capital_Letter Ch_2_Loc;
+
+    Ch_1_Loc = Ch_1_Par_Val;
+    Ch_2_Loc = Ch_1_Loc;
+    if (Ch_2_Loc != Ch_2_Par_Val) {
+        // Then, executed
+        return Ident_1;
+    } else {
+        // Not executed
+        Ch_1_Glob = Ch_1_Loc;
+        return Ident_2;
+    }
+}
+
+Boolean Func_2(Str_30 Str_1_Par_Ref, Str_30 Str_2_Par_Ref) {
+    // Executed once
+    // Str_1_Par_Ref == "DHRYSTONE PROGRAM, 1'ST STRING"
+    // Str_2_Par_Ref == "DHRYSTONE PROGRAM, 2'ND STRING"
+    One_Thirty Int_Loc;
+    Capital_Letter Ch_Loc = 0;
+
+    Int_Loc = 2;
+    while (Int_Loc <= 2) {              // Loop body executed once
+        if (Func_1(Str_1_Par_Ref[Int_Loc], Str_2_Par_Ref[Int_Loc + 1]) == Ident_1) {
+            // Then, executed
+            Ch_Loc = 'A';
+            Int_Loc += 1;
+        }
+    }
+    if (Ch_Loc >= 'W' && Ch_Loc < 'Z') {
+        // Then, not executed
+        Int_Loc = 7;
+    }
+    if (Ch_Loc == 'R') {
+        // Then, not executed
+        return true;
+    } else {
+        // Executed
+        if (strcmp(Str_1_Par_Ref, Str_2_Par_Ref) > 0) {
+            // Then, not executed
+            Int_Loc += 7;
+            Int_Glob = Int_Loc;
+            return true;
+        } else {
+            // Executed
+            return false;
+        }
+    }
+}
+
+Boolean Func_3(Enumeration Enum_Par_Val) {
+    // Executed once; Enum_Par_Val == Ident_3
+    Enumeration Enum_Loc;
+
+    Enum_Loc = Enum_Par_Val;
+    if (Enum_Loc == Ident_3) {
+        // Then, executed
+        return true;
+    } else {
+        // Not executed
+        return false;
+    }
+}
@@ -0,0 +1,62 @@
+//===============================================================================
+// Dhrystone 2.1 Benchmark Firmware
+// DMIPS/MHz of the core and memory configuration in the bitstream
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// Runs DHRY_RUNS iterations at start-up (make fw-dhrystone, build with
+// DHRY_RUNS=<n> in CFLAGS for others), prints the result block and two
+// lines for scripts/bench_profiles.sh:
+//
+//   PERF dhrystone iters=<runs> cyc_per_iter=<cycles per run>
+//   SCORE DMIPS/MHz <n.nnn>
+//
+// then runs again on every key. Needs Kconfig ENABLE_COUNTERS.
+//
+//===============================================================================
+
+#include <stdio.h>
+#include <stdint.h>
+#include "dhry.h"
+
+// UART direct access for the key (no echo, no buffering)
+#define UART_RX_DATA   (*(volatile unsigned int*)0x80000008)
+#define UART_RX_STATUS (*(volatile unsigned int*)0x8000000C)
+
+static int getch(void) {
+    while (!(UART_RX_STATUS & 0x01));
+    return UART_RX_DATA & 0xFF;
+}
+
+int main(void) {
+    dhry_result_t r;
+    uint32_t per_mhz;
+
+    printf("\r\n\r\n");
+    printf("========================================\r\n");
+    printf("  Dhrystone 2.1\r\n");
+    printf("========================================\r\n");
+    printf("\r\n");
+
+    while (1) {
+        dhrystone_run(DHRY_RUNS, &r);
+        dhrystone_print(&r);
+
+        per_mhz = dhry_dmips_per_mhz_x1000(&r);
+        printf("\r\nPERF dhrystone iters=%lu cyc_per_iter=%lu\r\n",
+               (unsigned long)r.runs, (unsigned long)(r.cycles / r.runs));
+        if (r.errors == 0) {
+            printf("SCORE DMIPS/MHz %lu.%03lu\r\n", (unsigned long)(per_mhz / 1000),
+                   (unsigned long)(per_mhz % 1000));
+        }
+        printf("Benchmark complete\r\n");
+
+        printf("\r\nPress any key to run again...\r\n");
+        fflush(stdout);
+        getch();
+    }
+
+    return 0;
+}
@@ -0,0 +1,164 @@
+//===============================================================================
+// Dual-Core Demo (Kconfig DUAL_CORE)
+// Starts the second core, times the mailbox round trip and runs CRC32 jobs
+// on both cores at once
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// Core 1 runs firmware/core1/core1_worker.c, embedded here (core1_image.S)
+// and copied to CORE1_RESET_ADDR. Jobs are core1_job_t descriptors in SRAM,
+// their address the mailbox message.
+//
+//   round trip  NOP job: send, core 1 reads the descriptor, replies
+//   CRC32       core 0 alone over both buffers, then core 0 on one while
+//               core 1 does the other; both cores share the SRAM port, so
+//               the gain is below 2x
+//
+// Lines for scripts/perf_regress.sh:
+//
+//   PERF mailbox_rtt iters=<jobs> cyc_per_iter=<cycles per round trip>
+//   PERF dual_crc32 iters=<runs> cyc_per_iter=<cycles, both buffers>
+//
+//===============================================================================
+
+#include <stdio.h>
+#include <stdint.h>
+#include "../lib/mailbox.h"
+#include "../lib/crc32.h"
+#include "../lib/perf_counters.h"
+#include "core1/core1_jobs.h"
+
+extern const uint8_t core1_image[];
+extern const uint32_t core1_image_size;
+extern int heap_set_limit(void *limit);
+
+// UART direct access for the start key (no echo, no buffering)
+#define UART_RX_DATA   (*(volatile unsigned int*)0x80000008)
+#define UART_RX_STATUS (*(volatile unsigned int*)0x8000000C)
+
+#define RTT_JOBS       1000
+#define CRC_BYTES      32768
+#define CRC_RUNS       4
+
+static uint8_t buf_a[CRC_BYTES] __attribute__((aligned(4)));
+static uint8_t buf_b[CRC_BYTES] __attribute__((aligned(4)));
+static core1_job_t job __attribute__((aligned(16)));
+
+static int getch(void) {
+    while (!(UART_RX_STATUS & 0x01));
+    return UART_RX_DATA & 0xFF;
+}
+
+// Hand job to core 1 and wait for it to come back
+static void core1_run_job(void) {
+    mailbox_flush(&job, sizeof(job));
+    mailbox_send((uint32_t)&job);
+    while (mailbox_recv() != (uint32_t)&job);
+    mailbox_invalidate(&job, sizeof(job));
+}
+
+static void run_benchmark(void) {
+    uint32_t t0, rtt, single = 0, dual = 0;
+    uint32_t crc_a = 0, crc_b = 0, crc_c1 = 0;
+
+    // Mailbox round trip
+    job.op = CORE1_OP_NOP;
+    t0 = rdcycle();
+    for (int i = 0; i < RTT_JOBS; i++) {
+        core1_run_job();
+    }
+    rtt = (rdcycle() - t0) / RTT_JOBS;
+
+    // CRC32 over both buffers: core 0 alone, then split
+    for (int r = 0; r < CRC_RUNS; r++) {
+        t0 = rdcycle();
+        crc_a = crc32_update_sw(0, buf_a, CRC_BYTES);
+        crc_b = crc32_update_sw(0, buf_b, CRC_BYTES);
+        single += rdcycle() - t0;
+
+        job.op = CORE1_OP_CRC32;
+        job.src = (uint32_t)buf_b;
+        job.len = CRC_BYTES;
+        job.result = 0;
+        t0 = rdcycle();
+        mailbox_flush(&job, sizeof(job));
+        mailbox_send((uint32_t)&job);
+        crc_a = crc32_update_sw(0, buf_a, CRC_BYTES);
+        while (mailbox_recv() != (uint32_t)&job);
+        dual += rdcycle() - t0;
+        mailbox_invalidate(&job, sizeof(job));
+        crc_c1 = job.result;
+    }
+    single /= CRC_RUNS;
+    dual /= CRC_RUNS;
+
+    printf("\r\nMailbox round trip: %lu cycles (%d jobs)\r\n", (unsigned long)rtt, RTT_JOBS);
+    printf("CRC32 of 2 x %d bytes:\r\n", CRC_BYTES);
+    printf("  core 0 alone      %8lu cycles\r\n", (unsigned long)single);
+    printf("  core 0 + core 1   %8lu cycles (%lu.%02lux)\r\n", (unsigned long)dual,
+           (unsigned long)(single / dual), (unsigned long)(single % dual * 100 / dual));
+    printf("  core 1 CRC        %08lx %s\r\n", (unsigned long)crc_c1,
+           crc_c1 == crc_b ? "OK" : "MISMATCH");
+    (void)crc_a;
+
+    printf("\r\n");
+    printf("PERF mailbox_rtt iters=%d cyc_per_iter=%lu\r\n", RTT_JOBS, (unsigned long)rtt);
+    printf("PERF dual_crc32 iters=%d cyc_per_iter=%lu\r\n", CRC_RUNS, (unsigned long)dual);
+    printf("\r\nBenchmark complete\r\n");
+}
+
+int main(void) {
+    uint32_t msg, t0;
+
+    printf("\r\n\r\n");
+    printf("========================================\r\n");
+    printf("  Dual-Core Demo (mailbox, shared SRAM)\r\n");
+    printf("========================================\r\n");
+    printf("\r\n");
+
+    if (!mailbox_present()) {
+        printf("ERROR: no second core (Kconfig DUAL_CORE)\r\n");
+        while (1);
+    }
+
+    // Core 1's image window stays out of the heap
+    if (heap_set_limit((void *)CORE1_RESET_ADDR) != 0) {
+        printf("ERROR: heap already above 0x%08lx\r\n", (unsigned long)CORE1_RESET_ADDR);
+        while (1);
+    }
+
+    for (uint32_t i = 0; i < CRC_BYTES; i++) {
+        buf_a[i] = (uint8_t)(i * 7 + 3);
+        buf_b[i] = (uint8_t)(i * 13 + 5);
+    }
+    mailbox_flush(buf_b, CRC_BYTES);
+
+    printf("Core 1 image: %lu bytes at 0x%08lx\r\n", (unsigned long)core1_image_size,
+           (unsigned long)CORE1_RESET_ADDR);
+    if (!core1_start(core1_image, core1_image_size)) {
+        printf("ERROR: core 1 image larger than %u bytes\r\n", CORE1_IMAGE_MAX);
+        while (1);
+    }
+    t0 = rdcycle();
+    while (!mailbox_try_recv(&msg)) {
+        if (rdcycle() - t0 > SYS_CLK_HZ) {
+            printf("ERROR: core 1 did not start (linked for another CORE1_RESET_ADDR?)\r\n");
+            while (1);
+        }
+    }
+    printf("Core 1 %s\r\n", msg == CORE1_MSG_READY ? "ready" : "sent an unexpected word");
+    printf("Press any key to start...\r\n");
+
+    getch();
+
+    while (1) {
+        run_benchmark();
+        printf("\r\nPress any key to run again...\r\n");
+        fflush(stdout);
+        getch();
+    }
+
+    return 0;
+}
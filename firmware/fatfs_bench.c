@@ -0,0 +1,153 @@
+//===============================================================================
+// FatFS Read Benchmark
+// Sequential f_read of a 64 KB file through diskio and the SD SPI driver
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// Mounts the card, creates BENCH.BIN (64 KB pattern) if it is missing,
+// then times one open / read in 4 KB chunks / close of the whole file and
+// checks the data afterwards. Everything between the f_open and the f_close
+// is in the count: FAT lookups, the diskio cache (CONFIG_SD_CACHE) and
+// the CMD18 multi-block reads.
+//
+// A card without a FAT filesystem is only formatted after an explicit F
+// (scripts/perf_regress.sh sends it for its blank simulator image).
+//
+// PERF line for scripts/perf_regress.sh, one sector per iteration:
+//   PERF fatfs_read iters=128 cyc_per_iter=<cycles per 512 bytes>
+//
+//===============================================================================
+
+#include <stdio.h>
+#include <stdint.h>
+#include "ff.h"
+#include "../lib/perf_counters.h"
+
+// UART direct access for keys (no echo, no buffering)
+#define UART_RX_DATA   (*(volatile unsigned int*)0x80000008)
+#define UART_RX_STATUS (*(volatile unsigned int*)0x8000000C)
+
+static int getch(void) {
+    while (!(UART_RX_STATUS & 0x01));
+    return UART_RX_DATA & 0xFF;
+}
+
+#define FILE_NAME   "BENCH.BIN"
+#define FILE_SIZE   65536
+#define CHUNK       4096
+
+static FATFS fs;
+static FIL file;
+static uint8_t buf[FILE_SIZE] __attribute__((aligned(4)));
+static uint8_t work[CHUNK] __attribute__((aligned(4)));
+
+static uint8_t pattern(uint32_t i) {
+    return (uint8_t)(i * 7 + (i >> 9));
+}
+
+static FRESULT mount(void) {
+    FRESULT res = f_mount(&fs, "", 1);
+    if (res != FR_NO_FILESYSTEM)
+        return res;
+
+    printf("No FAT filesystem. Press F to format the card, any other key to stop\r\n");
+    if (getch() != 'F')
+        return res;
+
+    MKFS_PARM opt = { FM_ANY, 0, 0, 0, 0 };
+    printf("Formatting...\r\n");
+    res = f_mkfs("", &opt, work, sizeof(work));
+    if (res != FR_OK)
+        return res;
+    return f_mount(&fs, "", 1);
+}
+
+// BENCH.BIN with the expected size, written if missing
+static FRESULT prepare_file(void) {
+    FILINFO fno;
+    if (f_stat(FILE_NAME, &fno) == FR_OK && fno.fsize == FILE_SIZE)
+        return FR_OK;
+
+    printf("Writing %s (%u bytes)...\r\n", FILE_NAME, (unsigned)FILE_SIZE);
+    for (uint32_t i = 0; i < FILE_SIZE; i++)
+        buf[i] = pattern(i);
+
+    FRESULT res = f_open(&file, FILE_NAME, FA_WRITE | FA_CREATE_ALWAYS);
+    if (res != FR_OK)
+        return res;
+    UINT bw;
+    res = f_write(&file, buf, FILE_SIZE, &bw);
+    FRESULT res2 = f_close(&file);
+    if (res == FR_OK && bw != FILE_SIZE)
+        res = FR_DISK_ERR;
+    return res != FR_OK ? res : res2;
+}
+
+static void run_benchmark(void) {
+    perf_sample_t t0, t1;
+    UINT br, total = 0;
+
+    for (uint32_t i = 0; i < FILE_SIZE; i++)
+        buf[i] = 0;
+
+    perf_sample(&t0);
+    FRESULT res = f_open(&file, FILE_NAME, FA_READ);
+    if (res == FR_OK) {
+        while (total < FILE_SIZE) {
+            res = f_read(&file, buf + total, CHUNK, &br);
+            if (res != FR_OK || br == 0)
+                break;
+            total += br;
+        }
+        f_close(&file);
+    }
+    perf_sample(&t1);
+
+    if (res != FR_OK || total != FILE_SIZE) {
+        printf("FAIL: read %u of %u bytes (FatFS error %d)\r\n",
+               (unsigned)total, (unsigned)FILE_SIZE, (int)res);
+        return;
+    }
+
+    int errors = 0;
+    for (uint32_t i = 0; i < FILE_SIZE; i++)
+        if (buf[i] != pattern(i)) errors++;
+
+    uint32_t cycles = t1.cycles - t0.cycles;
+    uint32_t us = perf_cycles_to_us(cycles);
+    printf("Read %u bytes in %lu cycles (%lu us, %lu KB/s), CPI %lu.%02lu\r\n",
+           (unsigned)FILE_SIZE, (unsigned long)cycles, (unsigned long)us,
+           (unsigned long)(us ? (uint64_t)FILE_SIZE * 1000000 / 1024 / us : 0),
+           (unsigned long)(perf_cpi_x100(cycles, t1.instret - t0.instret) / 100),
+           (unsigned long)(perf_cpi_x100(cycles, t1.instret - t0.instret) % 100));
+    printf("Data check: %s\r\n", errors ? "FAIL" : "PASS");
+    printf("\r\nPERF fatfs_read iters=%u cyc_per_iter=%lu\r\n",
+           (unsigned)(FILE_SIZE / 512), (unsigned long)(cycles / (FILE_SIZE / 512)));
+}
+
+int main(void) {
+    printf("\r\n\r\n");
+    printf("========================================\r\n");
+    printf("  FatFS Read Benchmark\r\n");
+    printf("  %u KB file, %u byte f_read calls\r\n", (unsigned)(FILE_SIZE / 1024), (unsigned)CHUNK);
+    printf("========================================\r\n");
+    printf("\r\n");
+    printf("Press any key to start...\r\n");
+
+    getch();
+
+    FRESULT res = mount();
+    if (res == FR_OK)
+        res = prepare_file();
+    if (res != FR_OK) {
+        printf("FAIL: SD card / FatFS error %d\r\n", (int)res);
+    } else {
+        run_benchmark();
+    }
+
+    printf("\r\nBenchmark complete\r\n");
+    while (1);
+    return 0;
+}
@@ -7,7 +7,8 @@
  * Screen Layout (24x80):
  *   - Top-left (Task 1):     Counter demo
  *   - Top-right (Task 2):    Float demo
- *   - Bottom (Task 3):       System status
+ *   - Bottom (Task 3):       System status, and a top-style task view
+ *                            (CPU %, stack high-water mark, switches/s)
  *
  * Copyright (c) 2025 Michael Wolak
  * Email: mikewolak@gmail.com, mike@epromfoundry.com
@@ -18,6 +19,8 @@
 #include <stdint.h>
 #include <stdio.h>
 #include "../lib/incurses/curses.h"
+#include "../lib/freertos_port/freertos_trace.h"
+#include "../lib/mem_stats.h"
 
 //==============================================================================
 // Hardware Definitions
@@ -26,9 +29,13 @@
 #define LED_CONTROL    (*(volatile uint32_t*)0x80000010)
 #define UART_TX_DATA   (*(volatile uint32_t*)0x80000000)
 #define UART_TX_STATUS (*(volatile uint32_t*)0x80000004)
+#define UART_TX_WORD   (*(volatile uint32_t*)0x80000004)  // Write: queue all byte lanes
 #define UART_RX_DATA   (*(volatile uint32_t*)0x80000008)
 #define UART_RX_STATUS (*(volatile uint32_t*)0x8000000C)
 
+#define UART_TX_FIFO    (1u << 31)                  // TX FIFO and TX_WORD present
+#define UART_TX_FREE(s) (((s) >> 16) & 0xFFF)       // Free TX FIFO bytes
+
 //==============================================================================
 // UART Functions (required by incurses library)
 //==============================================================================
@@ -38,13 +45,44 @@ void uart_putc(char c) {
     UART_TX_DATA = c;
 }
 
+// Fill the TX FIFO up to its free space, four bytes per word store;
+// returns the number of bytes queued (incurses output ring)
+unsigned uart_write_some(const char *buf, unsigned len) {
+    uint32_t status = UART_TX_STATUS;
+
+    if (!(status & UART_TX_FIFO)) {
+        if (status & 1)
+            return 0;
+        UART_TX_DATA = *buf;    // Older bitstream: one byte at a time
+        return 1;
+    }
+
+    unsigned room = UART_TX_FREE(status);
+    if (room > len) room = len;
+    unsigned queued = room;
+
+    for (; room && ((uint32_t)buf & 3); room--) {
+        UART_TX_DATA = *buf++;
+    }
+    for (; room >= 4; room -= 4, buf += 4) {
+        UART_TX_WORD = *(const uint32_t *)buf;
+    }
+    for (; room; room--) {
+        UART_TX_DATA = *buf++;
+    }
+
+    return queued;
+}
+
 int uart_getc_available(void) {
     return UART_RX_STATUS & 1;
 }
 
+// Sleeps on the UART RX interrupt instead of spinning (freertos_irq.c)
 char uart_getc(void) {
-    while (!uart_getc_available());
-    return UART_RX_DATA & 0xFF;
+    char c;
+    while (uart_read_timeout(&c, 1, portMAX_DELAY) == 0);
+    return c;
 }
 
 //==============================================================================
@@ -65,6 +103,79 @@ static volatile uint32_t task1_count = 0;
 static volatile uint32_t task2_iteration = 0;
 static volatile float task2_value = 0.0f;
 
+//==============================================================================
+// Task View (bottom-right, sampled once a second)
+//==============================================================================
+
+#define TOP_MAX_TASKS       6
+#define TOP_SAMPLE_PERIOD   10      // Display refreshes (100ms) per sample
+
+typedef struct {
+    char     name[13];
+    uint32_t number;
+    uint32_t run_time;              // Totals at the last sample
+    uint32_t switch_ins;
+    uint32_t cpu_pct10;             // Rates over the last period
+    uint32_t switches_per_sec;
+    uint32_t stack_hwm;             // Words never used
+} TopRow_t;
+
+static TopRow_t top_rows[TOP_MAX_TASKS];
+static uint32_t top_count = 0;
+static uint32_t top_total_time = 0;
+static uint32_t top_total_switches = 0;
+static uint32_t top_switches_per_sec = 0;
+
+#if (configGENERATE_RUN_TIME_STATS == 1)
+static void top_sample(void)
+{
+    static TaskStatus_t status[TOP_MAX_TASKS];
+    TopRow_t rows[TOP_MAX_TASKS];
+    uint32_t total, elapsed, switches, n;
+
+    n = uxTaskGetSystemState(status, TOP_MAX_TASKS, &total);
+    switches = ulPortTraceSwitches();
+    elapsed = total - top_total_time;
+    if (elapsed == 0) elapsed = 1;
+
+    // Insertion sort by task number so rows stay put between samples
+    for (uint32_t i = 0; i < n; i++) {
+        TopRow_t row = {0};
+        uint32_t j;
+
+        snprintf(row.name, sizeof(row.name), "%s", status[i].pcTaskName);
+        row.number = status[i].xTaskNumber;
+        row.run_time = status[i].ulRunTimeCounter;
+        row.switch_ins = ulPortTraceSwitchIns(row.number);
+        row.stack_hwm = status[i].usStackHighWaterMark;
+
+        // Rates against the previous sample of the same task
+        for (j = 0; j < top_count; j++) {
+            if (top_rows[j].number == row.number) {
+                row.cpu_pct10 = (uint32_t)((uint64_t)(row.run_time - top_rows[j].run_time) * 1000 / elapsed);
+                row.switches_per_sec = (uint32_t)((uint64_t)(row.switch_ins - top_rows[j].switch_ins) *
+                                                  portRUN_TIME_COUNTER_HZ / elapsed);
+                break;
+            }
+        }
+
+        for (j = i; j > 0 && rows[j - 1].number > row.number; j--) {
+            rows[j] = rows[j - 1];
+        }
+        rows[j] = row;
+    }
+
+    top_switches_per_sec = (uint32_t)((uint64_t)(switches - top_total_switches) *
+                                      portRUN_TIME_COUNTER_HZ / elapsed);
+    top_total_time = total;
+    top_total_switches = switches;
+    for (uint32_t i = 0; i < n; i++) {
+        top_rows[i] = rows[i];
+    }
+    top_count = n;
+}
+#endif
+
 //==============================================================================
 // Task 1: Counter Display (Top-Left Quadrant)
 //==============================================================================
@@ -239,6 +350,15 @@ void update_display(void)
     printw("Min Free Heap:       %u bytes", (unsigned int)xPortGetMinimumEverFreeHeapSize());
     clrtoeol();
 
+    // newlib heap (printf, incurses) and the boot stack, outside heap_4
+    mem_stats_t mem;
+    mem_stats_get(&mem);
+    move(19, 2);
+    printw("malloc: %lu, peak %luK, stack %luK",
+           (unsigned long)mem.malloc_calls, (unsigned long)(mem.heap_peak / 1024),
+           (unsigned long)(mem.stack_peak / 1024));
+    clrtoeol();
+
     move(20, 2);
     printw("LED2: %s", (LED_CONTROL & 0x04) ? "ON " : "OFF");
     clrtoeol();
@@ -247,6 +367,32 @@ void update_display(void)
     printw("Update rate: 500ms");
     clrtoeol();
 
+    // Bottom-right: per-task view (drawn after the clrtoeol()s on the left)
+#if (configGENERATE_RUN_TIME_STATS == 1)
+    static uint32_t refreshes = 0;
+
+    if (refreshes++ % TOP_SAMPLE_PERIOD == 0) {
+        top_sample();
+    }
+
+    move(15, 42);
+    printw("%-12s %6s %5s %6s", "Task", "CPU%", "Stack", "Sw/s");
+    for (uint32_t i = 0; i < top_count; i++) {
+        move(16 + i, 42);
+        printw("%-12s %4lu.%lu %5lu %6lu", top_rows[i].name,
+               (unsigned long)(top_rows[i].cpu_pct10 / 10),
+               (unsigned long)(top_rows[i].cpu_pct10 % 10),
+               (unsigned long)top_rows[i].stack_hwm,
+               (unsigned long)top_rows[i].switches_per_sec);
+    }
+    move(22, 42);
+    printw("Context switches: %lu/s", (unsigned long)top_switches_per_sec);
+    clrtoeol();
+#else
+    move(15, 42);
+    addstr("Run-time stats disabled (Kconfig)");
+#endif
+
     // Status line
     move(23, 0);
     attron(A_REVERSE);
@@ -383,6 +529,6 @@ void vTask4_DisplayUpdate(void *pvParameters)
 
 void vApplicationIdleHook(void)
 {
-    // Do nothing - display updates in dedicated task
-    portNOP();
+    // Display updates in dedicated task; halt until the next interrupt
+    vPortIdleWait();
 }
@@ -285,5 +285,5 @@ int main(void) {
 
 void vApplicationIdleHook(void)
 {
-    __asm__ volatile ("nop");
+    vPortIdleWait();    // Halt until the next interrupt (portmacro.h)
 }
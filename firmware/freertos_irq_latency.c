@@ -0,0 +1,208 @@
+/*
+ * FreeRTOS Interrupt Latency / Jitter Benchmark for PicoRV32
+ *
+ * The FreeRTOS side of irq_latency_bench.c: timer channel 1 interrupts
+ * every LAT_PERIOD cycles and the sample is the cycles from the counter
+ * reload to the CNT load (irq_latency.h), in CPU cycles:
+ *
+ * - ISR, idle: the application ISR (pxPortApplicationIsr) reads CNT; the
+ *   CPU sleeps in the idle hook's waitirq, so this is the startFRT.S
+ *   irq_vec fast path plus the wakeup.
+ * - ISR, SRAM load: as above while a priority 1 task copies 16 KB buffers
+ *   through SRAM, so the interrupt lands behind SRAM traffic.
+ * - Task wake, idle / SRAM load: a priority 3 task blocked in
+ *   xPortIrqWait(IRQ_TIMERS) reads CNT once it runs - the ISR, the
+ *   notification and a full context switch.
+ *
+ * The 1 ms tick shares the CPU: an IRQ that arrives while the tick ISR
+ * runs waits for it (PicoRV32 does not nest interrupts), which is the
+ * tail of the ISR histograms. Lines for scripts/perf_regress.sh:
+ *
+ *   PERF rtos_irq_lat iters=<samples> cyc_per_iter=<average, ISR idle>
+ *   PERF rtos_irq_lat_sram iters=<samples> cyc_per_iter=<average, ISR SRAM>
+ *   PERF rtos_irq_wake iters=<samples> cyc_per_iter=<average, task wake idle>
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <FreeRTOS.h>
+#include <task.h>
+#include "../lib/irq.h"
+#include "irq_latency.h"
+
+//==============================================================================
+// Benchmark Parameters
+//==============================================================================
+
+#define COPY_BYTES      16384
+
+static uint8_t ucBufA[COPY_BYTES] __attribute__((aligned(4)));
+static uint8_t ucBufB[COPY_BYTES] __attribute__((aligned(4)));
+
+static lat_stats_t xStats;
+static volatile uint32_t ulDone;
+
+//==============================================================================
+// Application ISR (IRQs masked, called from the port's irq_handler)
+//==============================================================================
+
+__attribute__((section(".fastcode")))
+static void prvLatencyIsr(uint32_t ulIrqs)
+{
+    if (ulIrqs & (1u << IRQ_TIMERS)) {
+        uint32_t ulCnt = TIMER_CH_CNT(LAT_TIMER_CH);
+
+        TIMER_CH_SR(LAT_TIMER_CH) = TIMER_CH_UIF;
+        lat_record(&xStats, lat_cycles(ulCnt));
+        if (xStats.count >= LAT_SAMPLES) {
+            TIMER_CH_CR(LAT_TIMER_CH) = 0;
+            ulDone = 1;
+        }
+    }
+}
+
+//==============================================================================
+// Measurement
+//==============================================================================
+
+static void prvMeasureIsr(lat_stats_t *pxResult)
+{
+    lat_reset(&xStats);
+    ulDone = 0;
+    pxPortApplicationIsr = prvLatencyIsr;
+    lat_timer_start();
+
+    while (!ulDone) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+
+    lat_timer_stop();
+    pxPortApplicationIsr = NULL;
+    *pxResult = xStats;
+}
+
+static void prvMeasureWake(lat_stats_t *pxResult)
+{
+    lat_reset(pxResult);
+    lat_timer_start();
+
+    while (pxResult->count < LAT_SAMPLES) {
+        vPortIrqArm(IRQ_TIMERS);
+        if (xPortIrqWait(IRQ_TIMERS, pdMS_TO_TICKS(10)) == pdFALSE) {
+            break;                      // IRQ[7] masked in the controller
+        }
+        lat_record(pxResult, lat_cycles(TIMER_CH_CNT(LAT_TIMER_CH)));
+    }
+
+    lat_timer_stop();
+}
+
+//==============================================================================
+// Tasks
+//==============================================================================
+
+// Keeps SRAM busy whenever nothing else runs
+static void vLoadTask(void *pvParameters)
+{
+    (void)pvParameters;
+
+    for (;;) {
+        memcpy(ucBufB, ucBufA, COPY_BYTES);
+        memcpy(ucBufA, ucBufB, COPY_BYTES);
+    }
+}
+
+static void vBenchTask(void *pvParameters)
+{
+    static const char *const pcNames[4] = {
+        "ISR, idle", "ISR, SRAM load", "Wake, idle", "Wake, SRAM load"
+    };
+    static lat_stats_t xResults[4];
+    TaskHandle_t xLoad;
+    uint32_t ulRun = 0;
+
+    (void)pvParameters;
+
+    for (;;) {
+        // Let the previous report drain out of the UART
+        vTaskDelay(pdMS_TO_TICKS(100));
+
+        prvMeasureIsr(&xResults[0]);
+        prvMeasureWake(&xResults[2]);
+
+        xLoad = NULL;
+        xTaskCreate(vLoadTask, "Load", configMINIMAL_STACK_SIZE, NULL, 1, &xLoad);
+        prvMeasureIsr(&xResults[1]);
+        prvMeasureWake(&xResults[3]);
+        if (xLoad != NULL) {
+            vTaskDelete(xLoad);
+        }
+
+        printf("Run %lu (%u samples each, %lu cycle period, %lu Hz CPU):\r\n",
+               (unsigned long)++ulRun, LAT_SAMPLES, (unsigned long)LAT_PERIOD,
+               (unsigned long)configCPU_CLOCK_HZ);
+        lat_perf("rtos_irq_lat", &xResults[0]);
+        lat_perf("rtos_irq_lat_sram", &xResults[1]);
+        lat_perf("rtos_irq_wake", &xResults[2]);
+        for (int i = 0; i < 4; i++) {
+            lat_print(pcNames[i], &xResults[i]);
+        }
+        for (int i = 0; i < 4; i++) {
+            printf("\r\n  %s (cycles, samples):\r\n", pcNames[i]);
+            lat_histogram(&xResults[i]);
+        }
+        printf("\r\n");
+
+        vTaskDelay(pdMS_TO_TICKS(2000));
+    }
+}
+
+//==============================================================================
+// Main
+//==============================================================================
+
+int main(void)
+{
+    printf("\r\n");
+    printf("FreeRTOS interrupt latency benchmark\r\n");
+    printf("Tick rate: %lu Hz\r\n", (unsigned long)configTICK_RATE_HZ);
+    printf("\r\n");
+
+    if (!lat_timer_present()) {
+        printf("ERROR: no timer channel 1 (Kconfig TIMER_CHANNELS >= 2)\r\n");
+        for (;;) {
+            portNOP();
+        }
+    }
+
+    for (uint32_t i = 0; i < COPY_BYTES; i++) {
+        ucBufA[i] = (uint8_t)(i * 7 + 3);
+    }
+
+    if (xTaskCreate(vBenchTask, "Bench", configMINIMAL_STACK_SIZE * 3, NULL, 3, NULL) != pdPASS) {
+        printf("ERROR: Bench task creation failed\r\n");
+        for (;;) {
+            portNOP();
+        }
+    }
+
+    vTaskStartScheduler();
+
+    // Should never reach here
+    printf("ERROR: Scheduler returned to main!\r\n");
+    for (;;) {
+        portNOP();
+    }
+
+    return 0;
+}
+
+//==============================================================================
+// FreeRTOS Idle Hook (called when no tasks are ready)
+//==============================================================================
+
+void vApplicationIdleHook(void)
+{
+    vPortIdleWait();    // Halt until the next interrupt (portmacro.h)
+}
@@ -0,0 +1,228 @@
+/*
+ * FreeRTOS Tick ISR Benchmark for PicoRV32
+ *
+ * Measures what a timer tick costs a running task, in CPU cycles
+ * (rdcycle, needs CONFIG_ENABLE_COUNTERS in the bitstream):
+ *
+ * - Tick only: the benchmark task spins at priority 1 and nothing else is
+ *   ready, so every tick takes the fast path in startFRT.S irq_vec
+ *   (caller-saved registers only, no switch).
+ * - Tick + switch: a priority 2 task wakes on every tick and blocks again
+ *   at once, so every tick is a full context save, a switch to that task
+ *   and a switch back (two full saves/restores plus the kernel work).
+ * - Top priority: the same with the waker at configMAX_PRIORITIES - 1.
+ *   When it blocks, generic task selection walks down every empty ready
+ *   list to the benchmark task's; port-optimised selection (ready bitmap,
+ *   portmacro.h) costs the same at any priority. scripts/rtos_prio_sweep.sh
+ *   compares the two at several CONFIG_FREERTOS_MAX_PRIORITIES.
+ * - Yield: a second priority 1 task yields back at once; reported per
+ *   switch, to compare with coop_yield from coop_bench (lib/coop). This
+ *   port has no software-interrupt yield: portYIELD() spins until the
+ *   next tick switches, so each switch costs up to a tick period.
+ *
+ * The benchmark task reads the cycle counter back to back; a gap longer
+ * than GAP_THRESHOLD cycles is time spent outside the task. Run it on two
+ * builds to compare port changes; the PERF averages are what
+ * scripts/perf_regress.sh tracks.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <FreeRTOS.h>
+#include <task.h>
+#include "../lib/perf_counters.h"
+
+//==============================================================================
+// Benchmark Parameters
+//==============================================================================
+
+#define SAMPLES         1000    // Ticks per measurement
+#define GAP_THRESHOLD   100     // Cycles; the sampling loop itself is ~10
+
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint32_t total;
+} GapStats_t;
+
+//==============================================================================
+// Measurement
+//==============================================================================
+
+static void prvMeasureGaps(GapStats_t *pxStats)
+{
+    uint32_t last, now, gap;
+
+    pxStats->count = 0;
+    pxStats->min = 0xFFFFFFFF;
+    pxStats->max = 0;
+    pxStats->total = 0;
+
+    last = rdcycle();
+    while (pxStats->count < SAMPLES) {
+        now = rdcycle();
+        gap = now - last;
+        last = now;
+
+        if (gap > GAP_THRESHOLD) {
+            pxStats->count++;
+            pxStats->total += gap;
+            if (gap < pxStats->min) pxStats->min = gap;
+            if (gap > pxStats->max) pxStats->max = gap;
+        }
+    }
+}
+
+static void prvPrintGaps(const char *pcName, const GapStats_t *pxStats)
+{
+    printf("  %-14s min %5lu  avg %5lu  max %5lu cycles\r\n", pcName,
+           (unsigned long)pxStats->min,
+           (unsigned long)(pxStats->total / pxStats->count),
+           (unsigned long)pxStats->max);
+}
+
+// Machine-readable average, same format as the other benchmarks
+static void prvPerfReport(const char *pcName, const GapStats_t *pxStats)
+{
+    printf("PERF %s iters=%lu cyc_per_iter=%lu\r\n", pcName,
+           (unsigned long)pxStats->count,
+           (unsigned long)(pxStats->total / pxStats->count));
+}
+
+// Each taskYIELD() switches to the partner and back: two switches
+static void prvMeasureYield(GapStats_t *pxStats)
+{
+    uint32_t start, now, cycles;
+
+    pxStats->count = 0;
+    pxStats->min = 0xFFFFFFFF;
+    pxStats->max = 0;
+    pxStats->total = 0;
+
+    while (pxStats->count < SAMPLES) {
+        start = rdcycle();
+        taskYIELD();
+        now = rdcycle();
+        cycles = (now - start) / 2;
+
+        pxStats->count++;
+        pxStats->total += cycles;
+        if (cycles < pxStats->min) pxStats->min = cycles;
+        if (cycles > pxStats->max) pxStats->max = cycles;
+    }
+}
+
+//==============================================================================
+// Tasks
+//==============================================================================
+
+// Hands the CPU straight back to the benchmark task
+static void vYieldTask(void *pvParameters)
+{
+    (void)pvParameters;
+
+    for (;;) {
+        taskYIELD();
+    }
+}
+
+// Wakes on every tick, forcing a switch in and out
+static void vWakerTask(void *pvParameters)
+{
+    (void)pvParameters;
+
+    for (;;) {
+        vTaskDelay(1);
+    }
+}
+
+static void vBenchTask(void *pvParameters)
+{
+    GapStats_t xTick, xSwitch, xTop, xYield;
+    TaskHandle_t xWaker, xPartner;
+    uint32_t ulRun = 0;
+
+    (void)pvParameters;
+
+    for (;;) {
+        // Let the previous report drain out of the UART
+        vTaskDelay(pdMS_TO_TICKS(100));
+
+        prvMeasureGaps(&xTick);
+
+        xWaker = NULL;
+        xTaskCreate(vWakerTask, "Waker", configMINIMAL_STACK_SIZE, NULL, 2, &xWaker);
+        prvMeasureGaps(&xSwitch);
+        if (xWaker != NULL) {
+            vTaskDelete(xWaker);
+        }
+
+        xWaker = NULL;
+        xTaskCreate(vWakerTask, "Waker", configMINIMAL_STACK_SIZE, NULL, configMAX_PRIORITIES - 1, &xWaker);
+        prvMeasureGaps(&xTop);
+        if (xWaker != NULL) {
+            vTaskDelete(xWaker);
+        }
+
+        xPartner = NULL;
+        xTaskCreate(vYieldTask, "Yield", configMINIMAL_STACK_SIZE, NULL, 1, &xPartner);
+        prvMeasureYield(&xYield);
+        if (xPartner != NULL) {
+            vTaskDelete(xPartner);
+        }
+
+        printf("Run %lu (%u ticks each, %lu Hz CPU):\r\n", (unsigned long)++ulRun,
+               SAMPLES, (unsigned long)configCPU_CLOCK_HZ);
+        prvPerfReport("rtos_tick", &xTick);
+        prvPerfReport("rtos_switch", &xSwitch);
+        prvPerfReport("rtos_switch_top", &xTop);
+        prvPerfReport("rtos_yield", &xYield);
+        prvPrintGaps("Tick only", &xTick);
+        prvPrintGaps("Tick + switch", &xSwitch);
+        prvPrintGaps("Top priority", &xTop);
+        prvPrintGaps("Yield switch", &xYield);
+
+        vTaskDelay(pdMS_TO_TICKS(2000));
+    }
+}
+
+//==============================================================================
+// Main
+//==============================================================================
+
+int main(void)
+{
+    printf("\r\n");
+    printf("FreeRTOS tick ISR benchmark\r\n");
+    printf("Tick rate: %lu Hz\r\n", (unsigned long)configTICK_RATE_HZ);
+    printf("Priorities: %u, %s task selection\r\n", (unsigned)configMAX_PRIORITIES,
+           configUSE_PORT_OPTIMISED_TASK_SELECTION ? "port-optimised" : "generic");
+    printf("\r\n");
+
+    if (xTaskCreate(vBenchTask, "Bench", configMINIMAL_STACK_SIZE * 3, NULL, 1, NULL) != pdPASS) {
+        printf("ERROR: Bench task creation failed\r\n");
+        for (;;) {
+            portNOP();
+        }
+    }
+
+    vTaskStartScheduler();
+
+    // Should never reach here
+    printf("ERROR: Scheduler returned to main!\r\n");
+    for (;;) {
+        portNOP();
+    }
+
+    return 0;
+}
+
+//==============================================================================
+// FreeRTOS Idle Hook (called when no tasks are ready)
+//==============================================================================
+
+void vApplicationIdleHook(void)
+{
+    vPortIdleWait();    // Halt until the next interrupt (portmacro.h)
+}
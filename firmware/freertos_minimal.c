@@ -150,5 +150,5 @@ int main(void) {
 /* FreeRTOS Idle Hook (called when no tasks are ready) */
 void vApplicationIdleHook(void)
 {
-    __asm__ volatile ("nop");
+    vPortIdleWait();    // Halt until the next interrupt (portmacro.h)
 }
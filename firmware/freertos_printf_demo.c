@@ -109,14 +109,14 @@ void vTask3_SystemStatus(void *pvParameters) {
 // Main Application
 //==============================================================================
 
-// External function to initialize UART mutex for thread-safe printf
-extern void syscalls_init_uart_mutex(void);
+// Starts the task that drains printf() output to the UART (syscalls.c)
+extern void syscalls_init_log(void);
 
 int main(void) {
     BaseType_t xReturned;
 
-    // Initialize UART mutex for thread-safe printf in FreeRTOS
-    syscalls_init_uart_mutex();
+    // Buffer printf() output so tasks never wait on the UART
+    syscalls_init_log();
 
     // Print startup banner using printf()
     printf("\r\n");
@@ -223,5 +223,5 @@ int main(void) {
 
 void vApplicationIdleHook(void)
 {
-    portNOP();
+    vPortIdleWait();    // Halt until the next interrupt (portmacro.h)
 }
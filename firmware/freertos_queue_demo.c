@@ -15,6 +15,12 @@
  * - Only one task does I/O, others focus on data generation
  * - Queue naturally handles synchronization
  * - More scalable design pattern
+ *
+ * Before the demo starts, a benchmark moves the same bytes from one task
+ * to another through a queue of single bytes and through a stream buffer
+ * in chunks, and prints bytes/sec for each: a queue item costs a copy,
+ * a critical section and possibly a task switch per byte, a stream buffer
+ * one per chunk.
  */
 
 #include <stdint.h>
@@ -23,6 +29,8 @@
 #include <FreeRTOS.h>
 #include <task.h>
 #include <queue.h>
+#include <stream_buffer.h>
+#include "../lib/timer.h"
 
 //==============================================================================
 // Hardware Registers
@@ -182,6 +190,112 @@ void vTask3_StatusGenerator(void *pvParameters) {
     }
 }
 
+//==============================================================================
+// Benchmark: byte queue vs stream buffer
+//==============================================================================
+
+#define BENCH_BYTES         32768
+#define BENCH_QUEUE_LEN     64          // Items (bytes) in the queue
+#define BENCH_STREAM_SIZE   256         // Bytes in the stream buffer
+#define BENCH_CHUNK         64          // Bytes per stream send / receive
+
+static QueueHandle_t xBenchQueue = NULL;
+static StreamBufferHandle_t xBenchStream = NULL;
+static TaskHandle_t xBenchTask = NULL;
+static volatile uint32_t ulBenchSum;
+
+// Receivers: take BENCH_BYTES, sum them (so nothing is optimised away),
+// tell the benchmark task, then block for good
+static void vBenchQueueSink(void *pvParameters) {
+    (void)pvParameters;
+    uint32_t sum = 0;
+    uint8_t b;
+
+    for (uint32_t n = 0; n < BENCH_BYTES; n++) {
+        xQueueReceive(xBenchQueue, &b, portMAX_DELAY);
+        sum += b;
+    }
+    ulBenchSum = sum;
+    xTaskNotifyGive(xBenchTask);
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+static void vBenchStreamSink(void *pvParameters) {
+    (void)pvParameters;
+    uint32_t sum = 0;
+    uint8_t buf[BENCH_CHUNK];
+
+    for (uint32_t n = 0; n < BENCH_BYTES;) {
+        size_t got = xStreamBufferReceive(xBenchStream, buf, sizeof(buf), portMAX_DELAY);
+        for (size_t i = 0; i < got; i++) {
+            sum += buf[i];
+        }
+        n += got;
+    }
+    ulBenchSum = sum;
+    xTaskNotifyGive(xBenchTask);
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+static void vBenchReport(const char *name, uint32_t us, uint32_t expect) {
+    uint32_t bps = us ? (uint32_t)((uint64_t)BENCH_BYTES * 1000000u / us) : 0;
+
+    printf("  %-22s %6lu us  %8lu bytes/sec%s\r\n", name, (unsigned long)us,
+           (unsigned long)bps, ulBenchSum == expect ? "" : "  (DATA MISMATCH)");
+}
+
+// Runs once at the highest demo priority, before the generators start
+void vTask0_Bench(void *pvParameters) {
+    (void)pvParameters;
+    uint8_t buf[BENCH_CHUNK];
+    uint32_t expect = 0;
+    uint32_t t0;
+
+    for (uint32_t n = 0; n < BENCH_BYTES; n++) {
+        expect += (uint8_t)n;
+    }
+    for (uint32_t i = 0; i < BENCH_CHUNK; i++) {
+        buf[i] = (uint8_t)i;
+    }
+
+    xBenchQueue = xQueueCreate(BENCH_QUEUE_LEN, 1);
+    xBenchStream = xStreamBufferCreate(BENCH_STREAM_SIZE, 1);
+
+    printf("Queue vs stream buffer, %u bytes task to task:\r\n", (unsigned int)BENCH_BYTES);
+
+    if (xBenchQueue != NULL &&
+        xTaskCreate(vBenchQueueSink, "QSink", configMINIMAL_STACK_SIZE * 2,
+                    NULL, 3, NULL) == pdPASS) {
+        t0 = timebase_us32();
+        for (uint32_t n = 0; n < BENCH_BYTES; n++) {
+            uint8_t b = (uint8_t)n;
+            xQueueSend(xBenchQueue, &b, portMAX_DELAY);
+        }
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        vBenchReport("xQueueSend (1 byte)", timebase_us32() - t0, expect);
+    }
+
+    if (xBenchStream != NULL &&
+        xTaskCreate(vBenchStreamSink, "SSink", configMINIMAL_STACK_SIZE * 2,
+                    NULL, 3, NULL) == pdPASS) {
+        t0 = timebase_us32();
+        for (uint32_t n = 0; n < BENCH_BYTES; n += BENCH_CHUNK) {
+            xStreamBufferSend(xBenchStream, buf, BENCH_CHUNK, portMAX_DELAY);
+        }
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        vBenchReport("xStreamBufferSend (64)", timebase_us32() - t0, expect);
+    }
+    printf("\r\n");
+
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
 //==============================================================================
 // Task 4: Printer (ONLY task that calls printf)
 //==============================================================================
@@ -203,14 +317,14 @@ void vTask4_Printer(void *pvParameters) {
 // Main Application
 //==============================================================================
 
-// External function to initialize UART mutex for thread-safe printf
-extern void syscalls_init_uart_mutex(void);
+// Starts the task that drains printf() output to the UART (syscalls.c)
+extern void syscalls_init_log(void);
 
 int main(void) {
     BaseType_t xReturned;
 
-    // Initialize UART mutex for thread-safe printf in FreeRTOS
-    syscalls_init_uart_mutex();
+    // Buffer printf() output so tasks never wait on the UART
+    syscalls_init_log();
 
     // Print startup banner using printf()
     printf("\r\n");
@@ -252,6 +366,22 @@ int main(void) {
     printf("\r\n");
     printf("Creating tasks...\r\n");
 
+    // Create Task 0: Benchmark (priority 3 - runs to completion first)
+    xReturned = xTaskCreate(
+        vTask0_Bench,
+        "Bench",
+        configMINIMAL_STACK_SIZE * 3,  // Needs stack for printf
+        NULL,
+        3,
+        &xBenchTask                    // The sinks notify it when done
+    );
+
+    if (xReturned == pdPASS) {
+        printf("  [OK] Task0: Queue vs stream buffer benchmark created\r\n");
+    } else {
+        printf("  [FAIL] Task0: Benchmark creation failed\r\n");
+    }
+
     // Create Task 1: Counter Generator (priority 1)
     xReturned = xTaskCreate(
         vTask1_CounterGenerator,
@@ -343,5 +473,5 @@ int main(void) {
 
 void vApplicationIdleHook(void)
 {
-    portNOP();
+    vPortIdleWait();    // Halt until the next interrupt (portmacro.h)
 }
@@ -9,6 +9,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include "../lib/mem_stats.h"
+#include "../lib/perf_counters.h"
+#ifdef CONFIG_MALLOC_TLSF
+#include "../lib/tlsf/tlsf.h"
+#endif
 
 // UART direct access for menu (no echo, no buffering)
 #define UART_RX_DATA   (*(volatile unsigned int*)0x80000008)
@@ -192,6 +197,20 @@ static void test_heap_info(void) {
     printf("Heap end:       0x%08X\r\n", heap_end);
     printf("Heap size:      %u bytes (%u KB)\r\n", heap_size, heap_size / 1024);
     printf("Stack region:   0x00042000 - 0x00080000 (248 KB)\r\n");
+
+    mem_stats_t mem;
+    mem_stats_get(&mem);
+    printf("Heap peak:      %lu bytes (break %lu)\r\n",
+           (unsigned long)mem.heap_peak, (unsigned long)mem.heap_brk);
+    printf("In use / free:  %lu / %lu bytes, %lu free chunks\r\n",
+           (unsigned long)mem.heap_in_use, (unsigned long)mem.heap_free,
+           (unsigned long)mem.free_chunks);
+    printf("Calls:          %lu malloc (%lu failed, %lu bytes), %lu free, %lu realloc\r\n",
+           (unsigned long)mem.malloc_calls, (unsigned long)mem.malloc_fails,
+           (unsigned long)mem.malloc_bytes, (unsigned long)mem.free_calls,
+           (unsigned long)mem.realloc_calls);
+    printf("Stack peak:     %lu of %lu bytes\r\n",
+           (unsigned long)mem.stack_peak, (unsigned long)mem.stack_size);
 }
 
 static void test_single_allocation(void) {
@@ -612,6 +631,103 @@ static void test_throughput(void) {
     free(dst);
 }
 
+//==============================================================================
+// Allocation Latency
+// Cycles per malloc()/free() on a fragmented heap: a first-fit allocator
+// walks its free list, TLSF (Kconfig MALLOC_TLSF) takes bounded time
+//==============================================================================
+
+#define LAT_SLOTS   256
+#define LAT_OPS     4000
+
+typedef struct {
+    uint32_t n, min, max;
+    uint64_t sum;
+} lat_t;
+
+static void lat_add(lat_t *l, uint32_t cycles) {
+    if (l->n == 0 || cycles < l->min) l->min = cycles;
+    if (cycles > l->max) l->max = cycles;
+    l->sum += cycles;
+    l->n++;
+}
+
+static void lat_print(const char *name, const lat_t *l) {
+    if (!l->n) return;
+    printf("%-8s %5lu calls  min %6lu  avg %6lu  max %6lu cycles (max %lu us)\r\n",
+           name, (unsigned long)l->n, (unsigned long)l->min,
+           (unsigned long)(l->sum / l->n), (unsigned long)l->max,
+           (unsigned long)perf_cycles_to_us(l->max));
+}
+
+static void test_latency(void) {
+    static void *slot[LAT_SLOTS];
+    lat_t lm = {0}, lf = {0};
+    uint32_t seed = 12345;
+    uint32_t fails = 0;
+    mem_stats_t mem;
+
+    printf("\r\n");
+    printf("=== Allocation Latency Test ===\r\n");
+#ifdef CONFIG_MALLOC_TLSF
+    printf("Allocator: TLSF\r\n");
+#else
+    printf("Allocator: newlib malloc\r\n");
+#endif
+
+    // Fragment: fill the slots with mixed sizes, free every other one
+    for (int i = 0; i < LAT_SLOTS; i++) {
+        seed = seed * 1103515245 + 12345;
+        slot[i] = malloc(16 + ((seed >> 16) % 2048));
+    }
+    for (int i = 0; i < LAT_SLOTS; i += 2) {
+        free(slot[i]);
+        slot[i] = NULL;
+    }
+    mem_stats_get(&mem);
+    printf("Fragmented: %lu free chunks, %lu bytes free below the break\r\n",
+           (unsigned long)mem.free_chunks, (unsigned long)mem.heap_free);
+
+    // Random malloc/free mix on the fragmented heap
+    for (int op = 0; op < LAT_OPS; op++) {
+        seed = seed * 1103515245 + 12345;
+        int i = (seed >> 8) % LAT_SLOTS;
+        uint32_t t0, t1;
+
+        if (slot[i]) {
+            t0 = rdcycle();
+            free(slot[i]);
+            t1 = rdcycle();
+            lat_add(&lf, t1 - t0);
+            slot[i] = NULL;
+        } else {
+            size_t size = 16 + ((seed >> 16) % 2048);
+            t0 = rdcycle();
+            slot[i] = malloc(size);
+            t1 = rdcycle();
+            lat_add(&lm, t1 - t0);
+            if (!slot[i]) fails++;
+        }
+    }
+
+    mem_stats_get(&mem);
+    lat_print("malloc", &lm);
+    lat_print("free", &lf);
+    printf("Failed allocations: %lu, free chunks at end: %lu\r\n",
+           (unsigned long)fails, (unsigned long)mem.free_chunks);
+
+#ifdef CONFIG_MALLOC_TLSF
+    int errors = tlsf_check(tlsf_malloc_heap());
+#endif
+    for (int i = 0; i < LAT_SLOTS; i++) {
+        free(slot[i]);
+        slot[i] = NULL;
+    }
+#ifdef CONFIG_MALLOC_TLSF
+    printf("TLSF consistency: %s\r\n", errors ? "FAIL" : "PASS");
+#endif
+}
+
 //==============================================================================
 // Main Menu
 //==============================================================================
@@ -629,6 +745,7 @@ static void show_menu(void) {
     printf("6. Stress test (30 seconds)\r\n");
     printf("7. Throughput test (real-time)\r\n");
     printf("8. Run all tests\r\n");
+    printf("9. Allocation latency (worst case)\r\n");
     printf("h. Show this menu\r\n");
     printf("q. Quit\r\n");
     printf("========================================\r\n");
@@ -701,6 +818,7 @@ int main(void) {
                 test_memory_patterns();
                 test_stress_allocations();
                 test_throughput();
+                test_latency();
                 printf("\r\n");
                 printf("========================================\r\n");
                 printf("All heap tests complete!\r\n");
@@ -708,6 +826,11 @@ int main(void) {
                 show_menu();
                 break;
 
+            case '9':
+                test_latency();
+                show_menu();
+                break;
+
             case 'h':
             case 'H':
                 show_menu();
@@ -23,6 +23,7 @@
 #include <stdio.h>
 #include <ctype.h>
 #include "../lib/simple_upload/simple_upload.h"
+#include "../lib/crc32.h"
 #include "../lib/microrl/microrl.h"
 #include "../lib/incurses/curses.h"
 
@@ -395,33 +396,12 @@ void cmd_simple_upload(uint32_t addr) {
 }
 
 //==============================================================================
-// CRC32 Helper Functions (matches simple_upload.c polynomial)
+// CRC32 Helper Functions (lib/crc32.h)
 //==============================================================================
 
-static uint32_t crc32_table[256];
-static int crc32_initialized = 0;
-
-static void crc32_init(void) {
-    if (crc32_initialized) return;
-    for (int i = 0; i < 256; i++) {
-        uint32_t crc = i;
-        for (int j = 0; j < 8; j++) {
-            crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320 : 0);
-        }
-        crc32_table[i] = crc;
-    }
-    crc32_initialized = 1;
-}
-
-// Calculate CRC32 of a memory block
+// Calculate CRC32 of a memory block (end_addr inclusive)
 static uint32_t calculate_crc32(uint32_t start_addr, uint32_t end_addr) {
-    crc32_init();
-    uint32_t crc = 0xFFFFFFFF;
-    for (uint32_t addr = start_addr; addr <= end_addr; addr++) {
-        uint8_t byte = *((uint8_t *)addr);
-        crc = (crc >> 8) ^ crc32_table[(crc ^ byte) & 0xFF];
-    }
-    return ~crc;
+    return crc32_calc((const void *)start_addr, end_addr - start_addr + 1);
 }
 
 //==============================================================================
@@ -772,6 +752,11 @@ void cmd_visual(uint32_t start_addr) {
             addstr(status);
             for (int i = strlen(status); i < COLS; i++) addch(' ');
         }
+#ifdef INCURSES_STATS
+        // Terminal bytes of the previous frame (make INCURSES_STATS=1)
+        snprintf(status, sizeof(status), "%5lu B/frame", (unsigned long)incurses_frame_bytes());
+        mvaddstr(LINES - 1, COLS - (int)strlen(status), status);
+#endif
         standend();
 
         // Incremental highlight updates for shift+arrow selection (marking==1 only)
@@ -845,45 +830,17 @@ void cmd_visual(uint32_t start_addr) {
         // Get key - handle escape sequences for arrow keys
         int ch = getch();
 
-        // Handle escape sequences (arrow keys send ESC [ A/B/C/D)
-        // Shift+arrow keys send ESC [ 1 ; 2 A/B/C/D
-        if (ch == 27) {  // ESC
-            int ch2 = getch();
-            if (ch2 == '[') {
-                int ch3 = getch();
-                if (ch3 == '1') {
-                    // Could be shift+arrow: ESC [ 1 ; 2 A/B/C/D
-                    int ch4 = getch();
-                    if (ch4 == ';') {
-                        int ch5 = getch();
-                        if (ch5 == '2') {
-                            int ch6 = getch();
-                            // Shift+arrow keys
-                            switch (ch6) {
-                                case 'A': ch = 165; break;  // Shift+Up
-                                case 'B': ch = 166; break;  // Shift+Down
-                                case 'C': ch = 167; break;  // Shift+Right
-                                case 'D': ch = 168; break;  // Shift+Left
-                                default: ch = 27; break;
-                            }
-                        } else {
-                            ch = 27;  // Unknown sequence
-                        }
-                    } else {
-                        ch = 27;  // Unknown sequence
-                    }
-                } else {
-                    // Regular arrow keys: ESC [ A/B/C/D
-                    switch (ch3) {
-                        case 'A': ch = 65; break;  // Up arrow
-                        case 'B': ch = 66; break;  // Down arrow
-                        case 'C': ch = 67; break;  // Right arrow
-                        case 'D': ch = 68; break;  // Left arrow
-                        default: ch = 27; break;   // Unknown, treat as ESC
-                    }
-                }
-            }
-            // If not '[', fall through with ESC
+        // Keys come decoded (keypad mode); this editor's own codes are
+        // 65-68 for the arrows and 165-168 for Shift+arrows
+        switch (ch) {
+            case KEY_UP:     ch = 65; break;
+            case KEY_DOWN:   ch = 66; break;
+            case KEY_RIGHT:  ch = 67; break;
+            case KEY_LEFT:   ch = 68; break;
+            case KEY_SR:     ch = 165; break;
+            case KEY_SF:     ch = 166; break;
+            case KEY_SRIGHT: ch = 167; break;
+            case KEY_SLEFT:  ch = 168; break;
         }
 
         if (editing) {
@@ -1250,9 +1207,10 @@ void cmd_visual(uint32_t start_addr) {
                         } else if (top_addr >= 16) {
                             // Scroll up one row - redraw incrementally
                             top_addr -= 16;
-                            // Scroll screen content down by inserting line at top
-                            move(2, 0);
-                            insertln();
+                            // Scroll the data rows (2-22) down, leaving the status bar
+                            setscrreg(2, 22);
+                            scrl(-1);
+                            setscrreg(0, LINES - 1);
                             // Redraw the new top row with current selection state
                             uint32_t current_addr = top_addr + (cursor_y * 16) + (cursor_x * bytes_per_unit);
                             uint32_t range_start = (mark_start < current_addr) ? mark_start : current_addr;
@@ -1267,9 +1225,10 @@ void cmd_visual(uint32_t start_addr) {
                         } else {
                             // Scroll down one row - redraw incrementally
                             top_addr += 16;
-                            // Scroll screen content up by deleting top line
-                            move(2, 0);
-                            deleteln();
+                            // Scroll the data rows (2-22) up, leaving the status bar
+                            setscrreg(2, 22);
+                            scrl(1);
+                            setscrreg(0, LINES - 1);
                             // Redraw the new bottom row with current selection state
                             uint32_t current_addr = top_addr + (cursor_y * 16) + (cursor_x * bytes_per_unit);
                             uint32_t range_start = (mark_start < current_addr) ? mark_start : current_addr;
@@ -14,6 +14,7 @@
  * - Memory dump (hex and ASCII)
  * - Memory read/write
  * - Memory block copy/move
+ * - Memory search (find: byte patterns with ?? wildcards, findw: masked words)
  * - FAST Streaming Upload (NO chunking, NO per-chunk ACKs)
  * - 128KB receive limit, buffer at heap-140KB
  *
@@ -29,13 +30,21 @@
 #include <stdio.h>
 #include <ctype.h>
 #include "../lib/microrl/microrl.h"
+#include "../lib/microrl/microrl_cmd.h"
 #include "../lib/incurses/curses.h"
+#include "../lib/crc32.h"
+#include "../lib/profiler/profiler.h"
+#include "../lib/block_upload/block_upload.h"
 
 // Hardware addresses
 #define UART_TX_DATA   (*(volatile uint32_t *)0x80000000)
 #define UART_TX_STATUS (*(volatile uint32_t *)0x80000004)
 #define UART_RX_DATA   (*(volatile uint32_t *)0x80000008)
 #define UART_RX_STATUS (*(volatile uint32_t *)0x8000000C)
+#define UART_TX_WORD   (*(volatile uint32_t *)0x80000004)  // Write: queue all byte lanes
+
+#define UART_TX_FIFO    (1u << 31)                  // TX FIFO and TX_WORD present
+#define UART_TX_FREE(s) (((s) >> 16) & 0xFFF)       // Free TX FIFO bytes
 
 // Timer registers
 #define TIMER_BASE          0x80000020
@@ -49,6 +58,25 @@
 #define TIMER_CR_ONE_SHOT   (1 << 1)
 #define TIMER_SR_UIF        (1 << 0)
 
+// Performance monitoring unit (hdl/perf_monitor.v)
+#define PMU_BASE            0x80000080
+#define PMU_CTRL            (*(volatile uint32_t*)(PMU_BASE + 0x00))
+#define PMU_CYCLES          (*(volatile uint32_t*)(PMU_BASE + 0x04))
+#define PMU_SRAM_WAIT       (*(volatile uint32_t*)(PMU_BASE + 0x08))
+#define PMU_MMIO_WAIT       (*(volatile uint32_t*)(PMU_BASE + 0x0C))
+#define PMU_BOOT_WAIT       (*(volatile uint32_t*)(PMU_BASE + 0x10))
+#define PMU_FETCHES         (*(volatile uint32_t*)(PMU_BASE + 0x14))
+#define PMU_LOADS           (*(volatile uint32_t*)(PMU_BASE + 0x18))
+#define PMU_STORES          (*(volatile uint32_t*)(PMU_BASE + 0x1C))
+#define PMU_IC_HIT          (*(volatile uint32_t*)(PMU_BASE + 0x20))
+#define PMU_IC_MISS         (*(volatile uint32_t*)(PMU_BASE + 0x24))
+#define PMU_DC_HIT          (*(volatile uint32_t*)(PMU_BASE + 0x28))
+#define PMU_DC_MISS         (*(volatile uint32_t*)(PMU_BASE + 0x2C))
+#define PMU_SPAD            (*(volatile uint32_t*)(PMU_BASE + 0x30))
+
+#define PMU_CTRL_ENABLE     (1 << 0)
+#define PMU_CTRL_CLEAR      (1 << 1)
+
 // Clock state (updated by interrupt at 60 Hz)
 volatile uint32_t clock_frames = 0;   // Frame counter (0-59, increments at 60 Hz)
 volatile uint32_t clock_seconds = 0;  // Seconds counter (0-59)
@@ -94,13 +122,17 @@ static inline void irq_disable(void) {
 void timer_init(void);
 uint32_t get_time_ms(void);
 void execute_command(const char *cmd);
-static void crc32_init(void);
+void skip_whitespace(const char **str);
 static uint32_t calculate_crc32(uint32_t start_addr, uint32_t end_addr);
 
 // Global state for pagination
 static uint32_t last_dump_addr = 0;
 static uint32_t last_dump_len = 0x100;  // 256 bytes
 
+// Last successful 'up': 'run <addr>' at that address runs what it received
+static uint32_t last_upload_addr = 0;
+static uint32_t last_upload_len = 0;
+
 //==============================================================================
 // UART Functions
 //==============================================================================
@@ -110,6 +142,35 @@ void uart_putc(char c) {
     UART_TX_DATA = c;
 }
 
+// Fill the TX FIFO up to its free space, four bytes per word store;
+// returns the number of bytes queued (incurses output ring)
+unsigned uart_write_some(const char *buf, unsigned len) {
+    uint32_t status = UART_TX_STATUS;
+
+    if (!(status & UART_TX_FIFO)) {
+        if (status & 1)
+            return 0;
+        UART_TX_DATA = *buf;    // Older bitstream: one byte at a time
+        return 1;
+    }
+
+    unsigned room = UART_TX_FREE(status);
+    if (room > len) room = len;
+    unsigned queued = room;
+
+    for (; room && ((uint32_t)buf & 3); room--) {
+        UART_TX_DATA = *buf++;
+    }
+    for (; room >= 4; room -= 4, buf += 4) {
+        UART_TX_WORD = *(const uint32_t *)buf;
+    }
+    for (; room; room--) {
+        UART_TX_DATA = *buf++;
+    }
+
+    return queued;
+}
+
 void uart_puts(const char *s) {
     while (*s) {
         if (*s == '\n') uart_putc('\r');
@@ -182,6 +243,11 @@ void irq_handler(uint32_t irqs) {
 
         clock_updated = 1;  // Signal main loop
     }
+
+    // Timer channels 1-3 (IRQ[7]): sampling profiler
+    if (irqs & (1 << 7)) {
+        profiler_irq(7);
+    }
 }
 
 //==============================================================================
@@ -344,6 +410,357 @@ void cmd_fill(uint32_t addr, uint32_t len, uint8_t value) {
     uart_puts("\n");
 }
 
+//==============================================================================
+// Memory Search
+//==============================================================================
+
+#define FIND_MAX_PATTERN 32     // Bytes in a find pattern
+#define FIND_PER_LINE    6      // Match addresses per output line
+#define FIND_POLL_MASK   0x3FF  // Look for a key every 1024 steps
+
+static uint32_t find_count;     // Matches reported by the current search
+
+// Print a match address, FIND_PER_LINE to a line
+static void find_report(uint32_t addr) {
+    if (find_count && (find_count % FIND_PER_LINE) == 0) {
+        uart_puts("\n");
+    }
+    uart_puts("  ");
+    print_hex_word(addr);
+    find_count++;
+}
+
+// Any key stops a search
+static int find_stopped(uint32_t *steps) {
+    return (++*steps & FIND_POLL_MASK) == 0 && uart_getc_available();
+}
+
+static int find_match(uint32_t addr, const uint8_t *pat, const uint8_t *wild, int m) {
+    const uint8_t *p = (const uint8_t *)addr;
+
+    for (int i = 0; i < m; i++) {
+        if (!wild[i] && p[i] != pat[i]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Patterns under a word: find the first byte a word at a time (a zero byte
+// in word ^ pat[0]*0x01010101 flags the candidates), then compare.
+// Returns where the search stopped: last + 1, or earlier on a key.
+static uint32_t find_short(uint32_t pos, uint32_t last,
+                           const uint8_t *pat, const uint8_t *wild, int m) {
+    uint32_t spread = 0x01010101u * pat[0];
+    uint32_t steps = 0;
+
+    for (; pos <= last && (pos & 3); pos++) {
+        if (find_match(pos, pat, wild, m)) find_report(pos);
+    }
+    for (; pos <= last && last - pos >= 3; pos += 4) {
+        if (find_stopped(&steps)) {
+            return pos;
+        }
+        uint32_t x = *(const uint32_t *)pos ^ spread;
+        if (((x - 0x01010101u) & ~x & 0x80808080u) == 0) {
+            continue;
+        }
+        for (int i = 0; i < 4; i++) {
+            if (find_match(pos + i, pat, wild, m)) find_report(pos + i);
+        }
+    }
+    for (; pos <= last; pos++) {
+        if (find_match(pos, pat, wild, m)) find_report(pos);
+    }
+    return pos;
+}
+
+// Longer patterns: Boyer-Moore-Horspool. The byte under the pattern's last
+// position says how far the pattern can move; a "??" limits every shift to
+// its distance from the end.
+static uint32_t find_horspool(uint32_t pos, uint32_t last,
+                              const uint8_t *pat, const uint8_t *wild, int m) {
+    uint8_t shift[256];
+    int limit = m;
+    uint32_t steps = 0;
+
+    for (int i = 0; i < m - 1; i++) {
+        if (wild[i]) limit = m - 1 - i;
+    }
+    memset(shift, limit, sizeof(shift));
+    for (int i = 0; i < m - 1; i++) {
+        if (!wild[i] && m - 1 - i < shift[pat[i]]) {
+            shift[pat[i]] = m - 1 - i;
+        }
+    }
+
+    while (pos <= last) {
+        if (find_stopped(&steps)) {
+            return pos;
+        }
+        uint8_t c = ((const uint8_t *)pos)[m - 1];
+        if ((wild[m - 1] || c == pat[m - 1]) && find_match(pos, pat, wild, m)) {
+            find_report(pos);
+        }
+        if (last - pos < shift[c]) {
+            return last + 1;
+        }
+        pos += shift[c];
+    }
+    return pos;
+}
+
+// Parse a find pattern: hex bytes ("12 34", "deadbeef"), "??" for any byte,
+// "text" in double quotes. Returns the length, or -1.
+static int find_parse(const char *s, uint8_t *pat, uint8_t *wild) {
+    int m = 0;
+
+    while (1) {
+        skip_whitespace(&s);
+        if (*s == '\0') {
+            return m;
+        }
+        if (*s == '"') {
+            for (s++; *s && *s != '"'; s++) {
+                if (m == FIND_MAX_PATTERN) return -1;
+                pat[m] = *s;
+                wild[m++] = 0;
+            }
+            if (*s++ != '"') return -1;
+            continue;
+        }
+        while (*s && *s != ' ' && *s != '\t') {
+            if (m == FIND_MAX_PATTERN) return -1;
+            if (s[0] == '?' && s[1] == '?') {
+                pat[m] = 0;
+                wild[m++] = 1;
+            } else {
+                int hi = hex_to_val(s[0]);
+                int lo = hex_to_val(s[1]);
+                if (hi < 0 || lo < 0) return -1;
+                pat[m] = (hi << 4) | lo;
+                wild[m++] = 0;
+            }
+            s += 2;
+        }
+    }
+}
+
+static void find_summary(uint32_t stop, uint32_t end, uint32_t start_ms) {
+    char buf[80];
+
+    if (find_count) {
+        uart_puts("\n");
+    }
+    if (stop < end) {
+        snprintf(buf, sizeof(buf), "Stopped at 0x%08lX: %lu matches\n",
+                 (unsigned long)stop, (unsigned long)find_count);
+    } else {
+        snprintf(buf, sizeof(buf), "%lu matches (%lu ms)\n",
+                 (unsigned long)find_count, (unsigned long)(get_time_ms() - start_ms));
+    }
+    uart_puts(buf);
+}
+
+void cmd_find(uint32_t addr, uint32_t len, const char *pattern) {
+    uint8_t pat[FIND_MAX_PATTERN];
+    uint8_t wild[FIND_MAX_PATTERN];
+    int m = find_parse(pattern, pat, wild);
+
+    if (m <= 0) {
+        uart_puts("Pattern: hex bytes (12 34 or 1234), ?? = any byte, \"text\"; up to 32\n");
+        return;
+    }
+    if (len > 0xFFFFFFFFu - addr) {
+        len = 0xFFFFFFFFu - addr;
+    }
+    if (len < (uint32_t)m) {
+        uart_puts("Range shorter than the pattern\n");
+        return;
+    }
+
+    uint32_t end = addr + len;
+    uint32_t last = end - m;
+    uint32_t start_ms = get_time_ms();
+    uint32_t stop;
+
+    find_count = 0;
+    if (m < 4 && !wild[0]) {
+        stop = find_short(addr, last, pat, wild, m);
+    } else {
+        stop = find_horspool(addr, last, pat, wild, m);
+    }
+    find_summary(stop > last ? end : stop, end, start_ms);
+}
+
+// Aligned 32-bit words with (word & mask) == (value & mask), four words a
+// step
+void cmd_findw(uint32_t addr, uint32_t len, uint32_t value, uint32_t mask) {
+    if (len > 0xFFFFFFFFu - addr) {
+        len = 0xFFFFFFFFu - addr;
+    }
+
+    uint32_t end = addr + len;
+    uint32_t pos = (addr + 3) & ~3u;
+    uint32_t start_ms = get_time_ms();
+    uint32_t steps = 0;
+
+    value &= mask;
+    find_count = 0;
+    for (; pos < end && end - pos >= 16; pos += 16) {
+        if (find_stopped(&steps)) {
+            break;
+        }
+        const uint32_t *w = (const uint32_t *)pos;
+        if ((w[0] & mask) != value && (w[1] & mask) != value &&
+            (w[2] & mask) != value && (w[3] & mask) != value) {
+            continue;
+        }
+        for (int i = 0; i < 4; i++) {
+            if ((w[i] & mask) == value) find_report(pos + i * 4);
+        }
+    }
+    if (pos < end && end - pos >= 16) {
+        find_summary(pos, end, start_ms);
+        return;
+    }
+    for (; pos < end && end - pos >= 4; pos += 4) {
+        if ((*(const uint32_t *)pos & mask) == value) find_report(pos);
+    }
+    find_summary(end, end, start_ms);
+}
+
+//==============================================================================
+// Performance Monitor Commands
+//==============================================================================
+
+// "  label     count  (xx.x%)" - percentage of total, omitted if total is 0
+static void perf_print_line(const char *label, uint32_t count, uint32_t total) {
+    char buf[80];
+    if (total) {
+        uint32_t pct = (uint32_t)(((uint64_t)count * 1000) / total);
+        snprintf(buf, sizeof(buf), "  %-16s %10lu  (%3lu.%lu%%)\n", label,
+                 (unsigned long)count, (unsigned long)(pct / 10), (unsigned long)(pct % 10));
+    } else {
+        snprintf(buf, sizeof(buf), "  %-16s %10lu\n", label, (unsigned long)count);
+    }
+    uart_puts(buf);
+}
+
+void cmd_perf_report(void) {
+    // Freeze the counters so the report itself is not measured
+    uint32_t ctrl = PMU_CTRL;
+    PMU_CTRL = 0;
+
+    uint32_t cycles    = PMU_CYCLES;
+    uint32_t sram_wait = PMU_SRAM_WAIT;
+    uint32_t mmio_wait = PMU_MMIO_WAIT;
+    uint32_t boot_wait = PMU_BOOT_WAIT;
+    uint32_t fetches   = PMU_FETCHES;
+    uint32_t loads     = PMU_LOADS;
+    uint32_t stores    = PMU_STORES;
+    uint32_t ic_hit    = PMU_IC_HIT;
+    uint32_t ic_miss   = PMU_IC_MISS;
+    uint32_t dc_hit    = PMU_DC_HIT;
+    uint32_t dc_miss   = PMU_DC_MISS;
+    uint32_t spad      = PMU_SPAD;
+    uint32_t waits     = sram_wait + mmio_wait + boot_wait;
+    uint32_t accesses  = fetches + loads + stores;
+
+    uart_puts("\nCycle breakdown:\n");
+    perf_print_line("Total cycles", cycles, 0);
+    perf_print_line("SRAM wait", sram_wait, cycles);
+    perf_print_line("MMIO wait", mmio_wait, cycles);
+    perf_print_line("Boot ROM wait", boot_wait, cycles);
+    perf_print_line("Other", cycles > waits ? cycles - waits : 0, cycles);
+
+    uart_puts("Bus transactions:\n");
+    perf_print_line("Fetches", fetches, accesses);
+    perf_print_line("Loads", loads, accesses);
+    perf_print_line("Stores", stores, accesses);
+    perf_print_line("Scratchpad", spad, accesses);
+
+    if (ic_hit || ic_miss || dc_hit || dc_miss) {
+        uart_puts("Caches:\n");
+        perf_print_line("I-cache hits", ic_hit, ic_hit + ic_miss);
+        perf_print_line("I-cache misses", ic_miss, ic_hit + ic_miss);
+        perf_print_line("D-cache hits", dc_hit, dc_hit + dc_miss);
+        perf_print_line("D-cache misses", dc_miss, dc_hit + dc_miss);
+    }
+    uart_puts("\n");
+
+    PMU_CTRL = ctrl & PMU_CTRL_ENABLE;
+}
+
+// perf            - print counters
+// perf on | off   - start (clears counters) / stop counting
+// perf <command>  - clear, count while <command> runs, print breakdown
+void cmd_perf(const char *args) {
+    if (*args == '\0') {
+        cmd_perf_report();
+    } else if (strcmp(args, "on") == 0) {
+        PMU_CTRL = PMU_CTRL_CLEAR | PMU_CTRL_ENABLE;
+        uart_puts("PMU counting\n");
+    } else if (strcmp(args, "off") == 0) {
+        PMU_CTRL = 0;
+        uart_puts("PMU stopped\n");
+    } else {
+        PMU_CTRL = PMU_CTRL_CLEAR | PMU_CTRL_ENABLE;
+        execute_command(args);
+        PMU_CTRL = 0;
+        cmd_perf_report();
+    }
+}
+
+// prof              - sampling profiler status
+// prof start [hz]   - clear and sample the interrupted PC at hz (decimal,
+//                     default 1000)
+// prof stop         - stop sampling
+// prof dump         - histogram as PROF lines for scripts/prof_report.sh
+// prof <command>    - sample while <command> runs, then dump
+void cmd_prof(const char *args) {
+    char buf[16];
+
+    if (strncmp(args, "start", 5) == 0) {
+        args += 5;
+        skip_whitespace(&args);
+        uint32_t hz = 0;
+        while (*args >= '0' && *args <= '9') {
+            hz = hz * 10 + (uint32_t)(*args++ - '0');
+        }
+        if (hz == 0) hz = 1000;
+        if (profiler_start(hz) < 0) {
+            uart_puts("Profiler: no timer channel 2, or rate not 1-20000 Hz\n");
+            return;
+        }
+        snprintf(buf, sizeof(buf), "%lu", (unsigned long)hz);
+        uart_puts("Sampling at ");
+        uart_puts(buf);
+        uart_puts(" Hz\n");
+    } else if (strcmp(args, "stop") == 0) {
+        profiler_stop();
+        uart_puts("Profiler stopped\n");
+    } else if (strcmp(args, "dump") == 0) {
+        profiler_dump(uart_puts);
+    } else if (*args == '\0') {
+        uart_puts(profiler_running() ? "Profiler running, " : "Profiler stopped, ");
+        snprintf(buf, sizeof(buf), "%lu", (unsigned long)profiler_samples());
+        uart_puts(buf);
+        uart_puts(" samples, ");
+        snprintf(buf, sizeof(buf), "%lu", (unsigned long)profiler_bucket_bytes());
+        uart_puts(buf);
+        uart_puts(" byte buckets\n");
+    } else {
+        if (profiler_start(1000) < 0) {
+            uart_puts("Profiler: no timer channel 2\n");
+            return;
+        }
+        execute_command(args);
+        profiler_stop();
+        profiler_dump(uart_puts);
+    }
+}
+
 //==============================================================================
 // Simple Upload Protocol Commands
 //==============================================================================
@@ -381,8 +798,6 @@ void cmd_simple_upload(uint32_t addr) {
     uint32_t expected_crc;
     uint32_t calculated_crc;
 
-    // Initialize CRC32 lookup table
-    crc32_init();
 
     // Step 1: Wait for 'R' (Ready) command
     while (1) {
@@ -457,6 +872,8 @@ void cmd_simple_upload(uint32_t addr) {
     // Step 10: PROTOCOL COMPLETE - NOW we can display results
     uart_puts("\n");
     if (calculated_crc == expected_crc) {
+        last_upload_addr = addr;
+        last_upload_len = bytes_received;
         uart_puts("*** Upload SUCCESS ***\n");
         uart_puts("Received: ");
         print_dec(bytes_received);
@@ -479,33 +896,61 @@ void cmd_simple_upload(uint32_t addr) {
 }
 
 //==============================================================================
-// CRC32 Helper Functions (matches simple_upload.c polynomial)
+// Memory Download (block protocol sender, lib/block_upload/block_download.c)
 //==============================================================================
 
-static uint32_t crc32_table[256];
-static int crc32_initialized = 0;
+static uint32_t download_base;
 
-static void crc32_init(void) {
-    if (crc32_initialized) return;
-    for (int i = 0; i < 256; i++) {
-        uint32_t crc = i;
-        for (int j = 0; j < 8; j++) {
-            crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320 : 0);
-        }
-        crc32_table[i] = crc;
+static const uint8_t *download_read(uint32_t offset, uint32_t len) {
+    (void)len;
+    return (const uint8_t *)(download_base + offset);
+}
+
+void cmd_download(uint32_t addr, uint32_t len) {
+    const block_source_t src = {
+        .putc = simple_uart_putc,
+        .getc = simple_uart_getc,
+        .read = download_read,
+    };
+
+    if (len > BLOCK_DOWNLOAD_MAX_SIZE) {
+        len = BLOCK_DOWNLOAD_MAX_SIZE;
     }
-    crc32_initialized = 1;
+    download_base = addr;
+
+    uart_puts("\n");
+    uart_puts("=== Block Download (windowed, per-block CRC32) ===\n");
+    uart_puts("Sending 0x");
+    print_hex_word(len);
+    uart_puts(" bytes from 0x");
+    print_hex_word(addr);
+    uart_puts("\n");
+    uart_puts("Start fw_upload_fast -D <file> on your PC now (Ctrl-C cancels)...\n");
+
+    // Drain the UART before the host's first packet
+    while (UART_TX_STATUS & 1);
+    uart_flush_rx();
+
+    int32_t result = block_send(&src, len);
+
+    uart_puts("\n");
+    if (result < 0) {
+        uart_puts("*** Download CANCELLED ***\n");
+        return;
+    }
+    uart_puts("*** Download COMPLETE ***\n");
+    uart_puts("CRC32: 0x");
+    print_hex_word(calculate_crc32(addr, addr + len - 1));
+    uart_puts("\n");
 }
 
+//==============================================================================
+// CRC32 Helper Functions (lib/crc32.h, matches simple_upload.c polynomial)
+//==============================================================================
+
 // Calculate CRC32 of a memory block
 static uint32_t calculate_crc32(uint32_t start_addr, uint32_t end_addr) {
-    crc32_init();
-    uint32_t crc = 0xFFFFFFFF;
-    for (uint32_t addr = start_addr; addr <= end_addr; addr++) {
-        uint8_t byte = *((uint8_t *)addr);
-        crc = (crc >> 8) ^ crc32_table[(crc ^ byte) & 0xFF];
-    }
-    return ~crc;
+    return crc32_calc((const void *)start_addr, end_addr - start_addr + 1);
 }
 
 //==============================================================================
@@ -513,6 +958,7 @@ static uint32_t calculate_crc32(uint32_t start_addr, uint32_t end_addr) {
 //==============================================================================
 
 // Helper: Redraw a single memory unit at given address with optional highlighting
+// (attributes, e.g. A_REVERSE for the cursor and selection)
 static void redraw_unit(uint32_t addr, uint32_t top_addr, int view_mode, int highlight) {
     // Check if address is visible on screen
     if (addr < top_addr || addr >= top_addr + (21 * 16)) {
@@ -530,7 +976,7 @@ static void redraw_unit(uint32_t addr, uint32_t top_addr, int view_mode, int hig
 
     // Draw hex value
     move(row + 2, 10 + (col * hex_spacing));
-    if (highlight) attron(A_REVERSE);
+    if (highlight) attron(highlight);
 
     if (view_mode == 0) {
         uint8_t value = ((uint8_t *)addr)[0];
@@ -553,7 +999,7 @@ static void redraw_unit(uint32_t addr, uint32_t top_addr, int view_mode, int hig
 
     // Draw ASCII
     int hex_width = (max_cursor_x + 1) * hex_spacing;
-    if (highlight) attron(A_REVERSE);
+    if (highlight) attron(highlight);
     for (int i = 0; i < bytes_per_unit; i++) {
         uint8_t byte = ((uint8_t *)(addr + i))[0];
         char c = (byte >= 32 && byte < 127) ? byte : '.';
@@ -624,6 +1070,75 @@ static void redraw_row(uint32_t row_addr, uint32_t top_addr, int view_mode,
     }
 }
 
+//------------------------------------------------------------------------------
+// Live view ('L'): the visible page is read once per frame, a word at a
+// time, and compared with the previous frame; only the units that differ are
+// redrawn, underlined for LIVE_HOT_FRAMES frames. Frames are paced by the
+// clock, not by the keyboard or by how much changed.
+//------------------------------------------------------------------------------
+
+#define PAGE_BYTES      (21 * 16)   // Visible rows x 16 bytes
+#define LIVE_FRAME_MS   100         // 10 frames/s
+#define LIVE_HOT_FRAMES 10          // A change stays underlined for 1 s
+#define LIVE_NO_PAGE    1           // Never a top_addr (16-byte aligned)
+
+static uint32_t live_shadow[PAGE_BYTES / 4];    // Page as of the last frame
+static uint8_t live_hot[PAGE_BYTES];            // Frames left, by unit offset
+static uint32_t live_top = LIVE_NO_PAGE;        // Page live_shadow holds
+
+// One live frame: returns the number of units redrawn. The cursor unit keeps
+// its highlight (it is left alone while being edited), as does the
+// selection being marked (sel_start..sel_end when selecting).
+static int live_frame(uint32_t top_addr, int view_mode, uint32_t cursor_addr, int editing,
+                      uint32_t sel_start, uint32_t sel_end, int selecting) {
+    uint32_t page[PAGE_BYTES / 4];
+    const volatile uint32_t *src = (const volatile uint32_t *)top_addr;
+    int bytes_per_unit = (view_mode == 0) ? 1 : (view_mode == 1) ? 2 : 4;
+    int drawn = 0;
+
+    for (int i = 0; i < PAGE_BYTES / 4; i++) {
+        page[i] = src[i];
+    }
+
+    if (live_top != top_addr) {
+        // New page (or just redrawn): this frame is the reference
+        memcpy(live_shadow, page, sizeof(page));
+        memset(live_hot, 0, sizeof(live_hot));
+        live_top = top_addr;
+        return 0;
+    }
+
+    const uint8_t *now = (const uint8_t *)page;
+    const uint8_t *was = (const uint8_t *)live_shadow;
+    for (int off = 0; off < PAGE_BYTES; off += bytes_per_unit) {
+        if (memcmp(now + off, was + off, bytes_per_unit) != 0) {
+            live_hot[off] = LIVE_HOT_FRAMES;
+        } else if (live_hot[off] > 1) {
+            live_hot[off]--;
+            continue;
+        } else if (live_hot[off] == 1) {
+            live_hot[off] = 0;      // Cooled down: draw it plain again
+        } else {
+            continue;
+        }
+
+        uint32_t addr = top_addr + off;
+        if (addr == cursor_addr && editing) {
+            continue;
+        }
+
+        int attr = live_hot[off] ? A_UNDERLINE : A_NORMAL;
+        if (addr == cursor_addr || (selecting && addr >= sel_start && addr <= sel_end)) {
+            attr |= A_REVERSE;
+        }
+        redraw_unit(addr, top_addr, view_mode, attr);
+        drawn++;
+    }
+
+    memcpy(live_shadow, page, sizeof(page));
+    return drawn;
+}
+
 // Visual hex editor with curses interface
 void cmd_visual(uint32_t start_addr) {
     int cursor_x = 0;   // 0-15 (byte column) or 0-7 (word) or 0-3 (dword)
@@ -659,6 +1174,10 @@ void cmd_visual(uint32_t start_addr) {
     uint32_t old_mark_start = 0;  // Previous mark start for incremental updates
     uint32_t old_mark_end = 0;    // Previous mark end for incremental updates
 
+    // Live view state
+    int live = 0;                 // Poll the page and highlight changes
+    uint32_t live_last = 0;       // Time of the last live frame
+
     // Initialize curses
     initscr();
     noecho();
@@ -669,13 +1188,15 @@ void cmd_visual(uint32_t start_addr) {
         // Only do full redraw if needed (first time or page change)
         if (need_full_redraw) {
             clear();
+            live_top = LIVE_NO_PAGE;  // Highlights are gone, start over
 
             // Draw title bar with view mode
             move(0, 0);
             attron(A_REVERSE);
             const char *mode_str = (view_mode == 0) ? "BYTE" : (view_mode == 1) ? "WORD" : "DWORD";
             char title[81];
-            snprintf(title, sizeof(title), "Hex Editor [%s] - Arrows:nav Shift+Arrows:select Enter:edit W:mode G:goto M:mark Q:exit", mode_str);
+            snprintf(title, sizeof(title), "Hex Editor [%s%s] Shift:sel Enter:edit W:mode G:goto M:mark L:live Q:exit",
+                     mode_str, live ? " LIVE" : "");
             addstr(title);
             for (int i = strlen(title); i < COLS; i++) addch(' ');
             standend();
@@ -753,7 +1274,7 @@ void cmd_visual(uint32_t start_addr) {
             }
 
             // Use redraw_unit to properly handle highlighting state
-            redraw_unit(old_addr, top_addr, view_mode, should_highlight);
+            redraw_unit(old_addr, top_addr, view_mode, should_highlight ? A_REVERSE : A_NORMAL);
         }
 
         // Draw new cursor position (highlight)
@@ -856,6 +1377,11 @@ void cmd_visual(uint32_t start_addr) {
             addstr(status);
             for (int i = strlen(status); i < COLS; i++) addch(' ');
         }
+#ifdef INCURSES_STATS
+        // Terminal bytes of the previous frame (make INCURSES_STATS=1)
+        snprintf(status, sizeof(status), "%5lu B/frame", (unsigned long)incurses_frame_bytes());
+        mvaddstr(LINES - 1, COLS - (int)strlen(status), status);
+#endif
         standend();
 
         // Incremental highlight updates for shift+arrow selection (marking==1 only)
@@ -880,13 +1406,13 @@ void cmd_visual(uint32_t start_addr) {
                 // Highlight region that's newly selected
                 for (uint32_t addr = range_start; addr <= range_end; addr += bytes_per_unit) {
                     if (addr < old_start || addr > old_end) {
-                        redraw_unit(addr, top_addr, view_mode, 1);
+                        redraw_unit(addr, top_addr, view_mode, A_REVERSE);
                     }
                 }
             } else {
                 // First time marking - highlight entire range
                 for (uint32_t addr = range_start; addr <= range_end; addr += bytes_per_unit) {
-                    redraw_unit(addr, top_addr, view_mode, 1);
+                    redraw_unit(addr, top_addr, view_mode, A_REVERSE);
                 }
             }
 
@@ -907,67 +1433,65 @@ void cmd_visual(uint32_t start_addr) {
         }
 
         // Cursor management
+        int cur_row = LINES - 1;
+        int cur_col = 0;
         if (goto_mode) {
             // Show cursor at goto input position
             curs_set(1);
-            move(LINES - 1, 6 + goto_len);  // Position after "Goto: " prompt
+            cur_col = 6 + goto_len;  // Position after "Goto: " prompt
         } else if (searching) {
             // Show cursor at search input position
             curs_set(1);
-            move(LINES - 1, 8 + search_len);  // Position after "Search: " prompt
+            cur_col = 8 + search_len;  // Position after "Search: " prompt
         } else if (editing) {
             // Show cursor and position it at the edit location
             curs_set(1);
-            move(cursor_y + 2, 10 + (cursor_x * hex_spacing) + edit_nibble);
+            cur_row = cursor_y + 2;
+            cur_col = 10 + (cursor_x * hex_spacing) + edit_nibble;
         } else {
             // Hide cursor when navigating
             curs_set(0);
         }
+        move(cur_row, cur_col);
 
         refresh();
 
         // Get key - handle escape sequences for arrow keys
-        int ch = getch();
-
-        // Handle escape sequences (arrow keys send ESC [ A/B/C/D)
-        // Shift+arrow keys send ESC [ 1 ; 2 A/B/C/D
-        if (ch == 27) {  // ESC
-            int ch2 = getch();
-            if (ch2 == '[') {
-                int ch3 = getch();
-                if (ch3 == '1') {
-                    // Could be shift+arrow: ESC [ 1 ; 2 A/B/C/D
-                    int ch4 = getch();
-                    if (ch4 == ';') {
-                        int ch5 = getch();
-                        if (ch5 == '2') {
-                            int ch6 = getch();
-                            // Shift+arrow keys
-                            switch (ch6) {
-                                case 'A': ch = 165; break;  // Shift+Up
-                                case 'B': ch = 166; break;  // Shift+Down
-                                case 'C': ch = 167; break;  // Shift+Right
-                                case 'D': ch = 168; break;  // Shift+Left
-                                default: ch = 27; break;
-                            }
-                        } else {
-                            ch = 27;  // Unknown sequence
-                        }
-                    } else {
-                        ch = 27;  // Unknown sequence
-                    }
-                } else {
-                    // Regular arrow keys: ESC [ A/B/C/D
-                    switch (ch3) {
-                        case 'A': ch = 65; break;  // Up arrow
-                        case 'B': ch = 66; break;  // Down arrow
-                        case 'C': ch = 67; break;  // Right arrow
-                        case 'D': ch = 68; break;  // Left arrow
-                        default: ch = 27; break;   // Unknown, treat as ESC
-                    }
+        int ch;
+        if (live) {
+            // Live view: run frames on the clock until a key arrives
+            uint32_t sel_start = (mark_start < current_addr) ? mark_start : current_addr;
+            uint32_t sel_end = (mark_start < current_addr) ? current_addr : mark_start;
+
+            timeout(0);
+            while ((ch = getch()) == ERR) {
+                uint32_t now = get_time_ms();
+                if (now - live_last < LIVE_FRAME_MS) {
+                    continue;
+                }
+                live_last = now;
+                if (live_frame(top_addr, view_mode, current_addr, editing,
+                               sel_start, sel_end, marking == 1)) {
+                    move(cur_row, cur_col);
+                    refresh();
                 }
             }
-            // If not '[', fall through with ESC
+            timeout(-1);
+        } else {
+            ch = getch();
+        }
+
+        // Keys come decoded (keypad mode); this editor's own codes are
+        // 65-68 for the arrows and 165-168 for Shift+arrows
+        switch (ch) {
+            case KEY_UP:     ch = 65; break;
+            case KEY_DOWN:   ch = 66; break;
+            case KEY_RIGHT:  ch = 67; break;
+            case KEY_LEFT:   ch = 68; break;
+            case KEY_SR:     ch = 165; break;
+            case KEY_SF:     ch = 166; break;
+            case KEY_SRIGHT: ch = 167; break;
+            case KEY_SLEFT:  ch = 168; break;
         }
 
         if (editing) {
@@ -1238,7 +1762,14 @@ void cmd_visual(uint32_t start_addr) {
                         cursor_y--;
                     } else if (top_addr >= 16) {
                         top_addr -= 16;
-                        need_full_redraw = 1;
+                        // Scroll the data rows (2-22) down and draw only the new top row
+                        setscrreg(2, 22);
+                        scrl(-1);
+                        setscrreg(0, LINES - 1);
+                        redraw_row(top_addr, top_addr, view_mode, 0, 0, 0);
+                        // The cursor highlight moved down with its row
+                        old_cursor_x = cursor_x;
+                        old_cursor_y = 1;
                     }
                     break;
 
@@ -1250,7 +1781,14 @@ void cmd_visual(uint32_t start_addr) {
                         cursor_y++;
                     } else {
                         top_addr += 16;
-                        need_full_redraw = 1;
+                        // Scroll the data rows (2-22) up and draw only the new bottom row
+                        setscrreg(2, 22);
+                        scrl(1);
+                        setscrreg(0, LINES - 1);
+                        redraw_row(top_addr + (20 * 16), top_addr, view_mode, 0, 0, 0);
+                        // The cursor highlight moved up with its row
+                        old_cursor_x = cursor_x;
+                        old_cursor_y = 19;
                     }
                     break;
 
@@ -1294,6 +1832,12 @@ void cmd_visual(uint32_t start_addr) {
                     need_full_redraw = 1;
                     break;
 
+                case 'L':  // Toggle live view
+                    live = !live;
+                    live_last = get_time_ms();
+                    need_full_redraw = 1;  // Title shows LIVE
+                    break;
+
                 case '/':  // Start search
                     searching = 1;
                     search_len = 0;
@@ -1334,9 +1878,10 @@ void cmd_visual(uint32_t start_addr) {
                         } else if (top_addr >= 16) {
                             // Scroll up one row - redraw incrementally
                             top_addr -= 16;
-                            // Scroll screen content down by inserting line at top
-                            move(2, 0);
-                            insertln();
+                            // Scroll the data rows (2-22) down, leaving the status bar
+                            setscrreg(2, 22);
+                            scrl(-1);
+                            setscrreg(0, LINES - 1);
                             // Redraw the new top row with current selection state
                             uint32_t current_addr = top_addr + (cursor_y * 16) + (cursor_x * bytes_per_unit);
                             uint32_t range_start = (mark_start < current_addr) ? mark_start : current_addr;
@@ -1351,9 +1896,10 @@ void cmd_visual(uint32_t start_addr) {
                         } else {
                             // Scroll down one row - redraw incrementally
                             top_addr += 16;
-                            // Scroll screen content up by deleting top line
-                            move(2, 0);
-                            deleteln();
+                            // Scroll the data rows (2-22) up, leaving the status bar
+                            setscrreg(2, 22);
+                            scrl(1);
+                            setscrreg(0, LINES - 1);
                             // Redraw the new bottom row with current selection state
                             uint32_t current_addr = top_addr + (cursor_y * 16) + (cursor_x * bytes_per_unit);
                             uint32_t range_start = (mark_start < current_addr) ? mark_start : current_addr;
@@ -1408,35 +1954,6 @@ int microrl_output(microrl_t *mrl, const char *str) {
     return 0;
 }
 
-// Execute callback for microRL - rebuild command line and execute
-int microrl_execute(microrl_t *mrl, int argc, const char* const *argv) {
-    (void)mrl;  // Unused
-
-    if (argc == 0) {
-        return 0;  // Empty command
-    }
-
-    // Rebuild command line from argc/argv
-    char cmdline[128];
-    int pos = 0;
-
-    for (int i = 0; i < argc && pos < 127; i++) {
-        if (i > 0) {
-            cmdline[pos++] = ' ';  // Space between arguments
-        }
-        const char *arg = argv[i];
-        while (*arg && pos < 127) {
-            cmdline[pos++] = *arg++;
-        }
-    }
-    cmdline[pos] = '\0';
-
-    // Execute using existing parser
-    execute_command(cmdline);
-
-    return 0;
-}
-
 //==============================================================================
 // Command Parser Utilities
 //==============================================================================
@@ -1467,154 +1984,254 @@ void skip_whitespace(const char **str) {
     }
 }
 
+//==============================================================================
+// Commands (lib/microrl/microrl_cmd.c: hashed lookup, Tab completion, and
+// the same table for 'run' scripts)
+//==============================================================================
+
+static mrl_cmd_table_t shell;
+
+// Argument i in hex, def if it is not there
+static uint32_t arg_hex(int argc, const char *const *argv, int i, uint32_t def) {
+    return (i < argc) ? parse_hex(argv[i], NULL) : def;
+}
+
+// argv[first...] joined by spaces: the rest of the line for find / perf / prof
+static const char *join_args(int argc, const char *const *argv, int first) {
+    static char line[MRL_CMD_LINE_LEN + 1];
+    size_t pos = 0;
+
+    for (int i = first; i < argc; i++) {
+        const char *a = argv[i];
+
+        if (i > first && pos < MRL_CMD_LINE_LEN) {
+            line[pos++] = ' ';
+        }
+        while (*a && pos < MRL_CMD_LINE_LEN) {
+            line[pos++] = *a++;
+        }
+    }
+    line[pos] = '\0';
+
+    return line;
+}
+
+// A command line (perf / prof <command>)
 void execute_command(const char *cmd) {
-    skip_whitespace(&cmd);
+    char line[MRL_CMD_LINE_LEN + 1];
+
+    strncpy(line, cmd, MRL_CMD_LINE_LEN);
+    line[MRL_CMD_LINE_LEN] = '\0';
+    mrl_cmd_exec_line(&shell, line);
+}
+
+static int sh_dump(int argc, const char *const *argv) {
+    uint32_t len = arg_hex(argc, argv, 2, 0);
+
+    cmd_dump(arg_hex(argc, argv, 1, 0), len ? len : 256);  // Default 256 bytes
+    return 0;
+}
+
+static int sh_read(int argc, const char *const *argv) {
+    cmd_read(arg_hex(argc, argv, 1, 0));
+    return 0;
+}
+
+static int sh_write(int argc, const char *const *argv) {
+    cmd_write(arg_hex(argc, argv, 1, 0), (uint8_t)arg_hex(argc, argv, 2, 0));
+    return 0;
+}
+
+static int sh_copy(int argc, const char *const *argv) {
+    uint32_t len = arg_hex(argc, argv, 3, 0);
+
+    if (len == 0) {
+        uart_puts("Usage: c <src> <dst> <len>\n");
+        return 1;
+    }
+    cmd_copy(arg_hex(argc, argv, 1, 0), arg_hex(argc, argv, 2, 0), len);
+    return 0;
+}
 
-    if (*cmd == '\0') {
-        return;  // Empty command
+static int sh_fill(int argc, const char *const *argv) {
+    uint32_t len = arg_hex(argc, argv, 2, 0);
+
+    if (len == 0) {
+        uart_puts("Usage: f <addr> <len> <value>\n");
+        return 1;
     }
+    cmd_fill(arg_hex(argc, argv, 1, 0), len, (uint8_t)arg_hex(argc, argv, 3, 0));
+    return 0;
+}
 
-    char op = *cmd++;
-    skip_whitespace(&cmd);
+static int sh_find(int argc, const char *const *argv) {
+    uint32_t len = arg_hex(argc, argv, 2, 0);
 
-    switch (op) {
-        case 'd':  // Dump memory
-        case 'D': {
-            uint32_t addr = parse_hex(cmd, &cmd);
-            skip_whitespace(&cmd);
-            uint32_t len = parse_hex(cmd, &cmd);
-            if (len == 0) len = 256;  // Default 256 bytes
-            cmd_dump(addr, len);
-            break;
-        }
+    if (len == 0) {
+        uart_puts("Usage: find <addr> <len> <pattern>\n");
+        return 1;
+    }
+    cmd_find(arg_hex(argc, argv, 1, 0), len, join_args(argc, argv, 3));
+    return 0;
+}
 
-        case 'r':  // Read byte
-        case 'R': {
-            uint32_t addr = parse_hex(cmd, &cmd);
-            cmd_read(addr);
-            break;
-        }
+static int sh_findw(int argc, const char *const *argv) {
+    uint32_t len = arg_hex(argc, argv, 2, 0);
 
-        case 'w':  // Write byte
-        case 'W': {
-            uint32_t addr = parse_hex(cmd, &cmd);
-            skip_whitespace(&cmd);
-            uint8_t value = (uint8_t)parse_hex(cmd, &cmd);
-            cmd_write(addr, value);
-            break;
-        }
+    if (len == 0 || argc < 4) {
+        uart_puts("Usage: findw <addr> <len> <value> [mask]\n");
+        return 1;
+    }
+    cmd_findw(arg_hex(argc, argv, 1, 0), len, arg_hex(argc, argv, 3, 0),
+              arg_hex(argc, argv, 4, 0xFFFFFFFF));
+    return 0;
+}
 
-        case 'c':  // Copy memory
-        case 'C': {
-            uint32_t src = parse_hex(cmd, &cmd);
-            skip_whitespace(&cmd);
-            uint32_t dst = parse_hex(cmd, &cmd);
-            skip_whitespace(&cmd);
-            uint32_t len = parse_hex(cmd, &cmd);
-            if (len > 0) {
-                cmd_copy(src, dst, len);
-            } else {
-                uart_puts("Usage: c <src> <dst> <len>\n");
-            }
-            break;
-        }
+static int sh_up(int argc, const char *const *argv) {
+    cmd_simple_upload(arg_hex(argc, argv, 1, ZM_BUFFER_ADDR));  // Default: transfer buffer
+    return 0;
+}
 
-        case 'f':  // Fill memory
-        case 'F': {
-            uint32_t addr = parse_hex(cmd, &cmd);
-            skip_whitespace(&cmd);
-            uint32_t len = parse_hex(cmd, &cmd);
-            skip_whitespace(&cmd);
-            uint8_t value = (uint8_t)parse_hex(cmd, &cmd);
-            if (len > 0) {
-                cmd_fill(addr, len, value);
-            } else {
-                uart_puts("Usage: f <addr> <len> <value>\n");
-            }
-            break;
-        }
+static int sh_down(int argc, const char *const *argv) {
+    uint32_t len = arg_hex(argc, argv, 2, 0);
 
-        case 'u':  // Upload using bootloader protocol
-        case 'U': {
-            // Check if this is 'up' (upload from PC)
-            if (*cmd == 'p' || *cmd == 'P') {
-                cmd++;  // Skip 'p'/'P'
-                skip_whitespace(&cmd);
-                uint32_t addr = parse_hex(cmd, &cmd);
-                if (addr == 0 && *cmd == '\0') {
-                    addr = ZM_BUFFER_ADDR;  // Default to transfer buffer
-                }
-                cmd_simple_upload(addr);
-            } else {
-                uart_puts("Upload command:\n");
-                uart_puts("  up [addr]  - Upload file (bootloader protocol)\n");
-                uart_puts("               Default addr: 0x");
-                print_hex_word(ZM_BUFFER_ADDR);
-                uart_puts("\n");
-            }
-            break;
-        }
+    if (len == 0) {
+        uart_puts("Usage: down <addr> <len>\n");
+        return 1;
+    }
+    cmd_download(arg_hex(argc, argv, 1, 0), len);
+    return 0;
+}
 
-        case 't':  // Toggle clock display
-        case 'T': {
-            clock_enabled = !clock_enabled;
-            if (clock_enabled) {
-                uart_puts("Clock display enabled\n");
-            } else {
-                uart_puts("Clock display disabled\n");
-                // Clear the clock area
-                uart_puts("\033[s");         // Save cursor
-                uart_puts("\033[1;60H");     // Move to clock position
-                uart_puts("               ");  // Clear with spaces
-                uart_puts("\033[u");         // Restore cursor
-            }
-            break;
-        }
+static int sh_clock(int argc, const char *const *argv) {
+    (void)argc;
+    (void)argv;
+
+    clock_enabled = !clock_enabled;
+    if (clock_enabled) {
+        uart_puts("Clock display enabled\n");
+    } else {
+        uart_puts("Clock display disabled\n");
+        // Clear the clock area
+        uart_puts("\033[s");         // Save cursor
+        uart_puts("\033[1;60H");     // Move to clock position
+        uart_puts("               ");  // Clear with spaces
+        uart_puts("\033[u");         // Restore cursor
+    }
+    return 0;
+}
 
-        case 'v':  // Visual hex editor
-        case 'V': {
-            uint32_t addr = 0;
-            if (*cmd != '\0') {
-                addr = parse_hex(cmd, &cmd);
+static int sh_perf(int argc, const char *const *argv) {
+    cmd_perf(join_args(argc, argv, 1));
+    return 0;
+}
+
+static int sh_prof(int argc, const char *const *argv) {
+    cmd_prof(join_args(argc, argv, 1));
+    return 0;
+}
+
+static int sh_visual(int argc, const char *const *argv) {
+    cmd_visual(arg_hex(argc, argv, 1, 0));
+    // After exiting visual mode, clear screen and show prompt
+    uart_puts("\033[2J\033[H");  // Clear screen, home cursor
+    uart_puts("Exited visual mode\n");
+    return 0;
+}
+
+// run              - paste a script, Ctrl-D ends it (Ctrl-C cancels)
+// run <addr> [len] - script in memory; len defaults to the size of the
+//                    last 'up' to addr, or runs to a NUL byte
+static int sh_run(int argc, const char *const *argv) {
+    char *text = (char *)ZM_BUFFER_ADDR;
+    uint32_t len = 0;
+    uint32_t start_ms;
+    char buf[64];
+    int r;
+
+    if (argc < 2) {
+        uart_puts("Paste the script, then Ctrl-D (Ctrl-C cancels)\n");
+        while (len < ZM_MAX_RECEIVE) {
+            char c = uart_getc();
+
+            if (c == 0x04) break;
+            if (c == 0x03) {
+                uart_puts("*** Cancelled ***\n");
+                return 1;
             }
-            cmd_visual(addr);
-            // After exiting visual mode, clear screen and show prompt
-            uart_puts("\033[2J\033[H");  // Clear screen, home cursor
-            uart_puts("Exited visual mode\n");
-            break;
+            text[len++] = c;
         }
-
-        case 'h':  // Help
-        case 'H':
-        case '?': {
-            uart_puts("\n");
-            uart_puts("Commands:\n");
-            uart_puts("  d <addr> [len]           - Dump memory (hex+ASCII)\n");
-            uart_puts("  SPACE                    - Page to next 256 bytes\n");
-            uart_puts("  r <addr>                 - Read byte\n");
-            uart_puts("  w <addr> <value>         - Write byte\n");
-            uart_puts("  c <src> <dst> <len>      - Copy memory block\n");
-            uart_puts("  f <addr> <len> <val>     - Fill memory\n");
-            uart_puts("  v [addr]                 - Visual hex editor (curses)\n");
-            uart_puts("  t                        - Toggle clock display on/off\n");
-            uart_puts("  up [addr]                - Upload file (bootloader protocol)\n");
-            uart_puts("  h or ?                   - This help\n");
-            uart_puts("\n");
-            uart_puts("Addresses and values in hex (0x optional)\n");
-            uart_puts("Default dump: 256 bytes (0x100)\n");
-            uart_puts("Transfer buffer at: 0x");
-            print_hex_word(ZM_BUFFER_ADDR);
-            uart_puts(" (128KB max)\n");
-            uart_puts("\n");
-            break;
+    } else {
+        text = (char *)parse_hex(argv[1], NULL);
+        len = arg_hex(argc, argv, 2, 0);
+        if (len == 0) {
+            len = ((uint32_t)text == last_upload_addr && last_upload_len) ?
+                  last_upload_len : ZM_MAX_RECEIVE;
         }
+    }
 
-        default:
-            uart_puts("Unknown command. Type 'h' for help.\n");
-            break;
+    start_ms = get_time_ms();
+    r = mrl_cmd_run_text(&shell, text, len);
+    if (r < 0) {
+        snprintf(buf, sizeof(buf), "Script stopped at line %d\n", -r);
+    } else {
+        snprintf(buf, sizeof(buf), "Script: %d commands (%lu ms)\n", r,
+                 (unsigned long)(get_time_ms() - start_ms));
     }
+    uart_puts(buf);
+
+    return r < 0;
 }
 
+static int sh_help(int argc, const char *const *argv) {
+    (void)argc;
+    (void)argv;
+
+    uart_puts("\n");
+    uart_puts("Commands:\n");
+    mrl_cmd_help(&shell);
+    uart_puts("  SPACE                    - Page to next 256 bytes\n");
+    uart_puts("\n");
+    uart_puts("Addresses and values in hex (0x optional), Tab completes commands\n");
+    uart_puts("Default dump: 256 bytes (0x100)\n");
+    uart_puts("Transfer buffer at: 0x");
+    print_hex_word(ZM_BUFFER_ADDR);
+    uart_puts(" (128KB max)\n");
+    uart_puts("\n");
+    return 0;
+}
+
+static const mrl_cmd_t commands[] = {
+    { "d",     sh_dump,   "d <addr> [len]           - Dump memory (hex+ASCII)" },
+    { "r",     sh_read,   "r <addr>                 - Read byte" },
+    { "w",     sh_write,  "w <addr> <value>         - Write byte" },
+    { "c",     sh_copy,   "c <src> <dst> <len>      - Copy memory block" },
+    { "f",     sh_fill,   "f <addr> <len> <val>     - Fill memory" },
+    { "find",  sh_find,   "find <addr> <len> <pat>  - Find bytes (12 34, 1234, ?? any, \"text\")" },
+    { "findw", sh_findw,  "findw <addr> <len> <val> [mask] - Find aligned 32-bit words" },
+    { "v",     sh_visual, "v [addr]                 - Visual hex editor (curses)" },
+    { "t",     sh_clock,  "t                        - Toggle clock display on/off" },
+    { "up",    sh_up,     "up [addr]                - Upload file (bootloader protocol)" },
+    { "down",  sh_down,   "down <addr> <len>        - Send memory to PC (fw_upload_fast -D)" },
+    { "perf",  sh_perf,   "perf [on|off|<cmd>]      - PMU counters / profile a command" },
+    { "prof",  sh_prof,   "prof [start [hz]|stop|dump|<cmd>] - Sampling PC profiler" },
+    { "run",   sh_run,    "run [<addr> [len]]       - Run a script: pasted, or in memory ('up')" },
+    { "h",     sh_help,   "h or ?                   - This help" },
+
+    // Long names and the one-letter forms of the old parser
+    { "dump",   sh_dump,   NULL },
+    { "read",   sh_read,   NULL },
+    { "write",  sh_write,  NULL },
+    { "copy",   sh_copy,   NULL },
+    { "fill",   sh_fill,   NULL },
+    { "visual", sh_visual, NULL },
+    { "clock",  sh_clock,  NULL },
+    { "upload", sh_up,     NULL },
+    { "p",      sh_perf,   NULL },
+    { "help",   sh_help,   NULL },
+    { "?",      sh_help,   NULL },
+};
+
 //==============================================================================
 // Clock Display
 //==============================================================================
@@ -1653,8 +2270,10 @@ int main(void) {
     uart_puts("Enabling timer interrupts...\n");
     irq_enable();
 
-    // Initialize microRL
-    microrl_init(&mrl, microrl_output, microrl_execute);
+    // Initialize microRL on the command table
+    mrl_cmd_init(&shell, commands, MICRORL_ARRAYSIZE(commands), uart_puts);
+    microrl_init(&mrl, microrl_output, mrl_cmd_microrl_exec);
+    mrl_cmd_attach(&shell, &mrl);
     microrl_set_prompt(&mrl, "> ");
 
     uart_puts("\n");
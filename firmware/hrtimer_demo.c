@@ -0,0 +1,189 @@
+/*
+ * Timer Service Demo for PicoRV32 (lib/hrtimer)
+ *
+ * Four timers share one hardware channel (3) through lib/hrtimer:
+ *
+ *   fast    periodic, every 1 ms
+ *   odd     periodic, every 7.3 ms
+ *   led     periodic, every 250 ms: toggles LED1
+ *   shot    one-shot that restarts itself 100-1123 us out, from a
+ *           pseudo-random sequence
+ *
+ * Each timer keeps its worst lateness (deadline to callback). The main
+ * loop sleeps in waitirq until each 1 s report deadline and prints them
+ * next to the service totals; there is no periodic tick.
+ *
+ * No irq_handler() here: hrt_init() registers the service with the
+ * start.S dispatcher (lib/irq.h).
+ */
+
+#include <stdint.h>
+#include "../lib/irq.h"
+#include "../lib/hrtimer/hrtimer.h"
+
+//==============================================================================
+// Hardware Registers
+//==============================================================================
+
+#define UART_TX_DATA   (*(volatile uint32_t*)0x80000000)
+#define UART_TX_STATUS (*(volatile uint32_t*)0x80000004)
+#define LED_REG        (*(volatile uint32_t*)0x80000010)
+
+#define HRT_CH          3
+#define HRT_PRIO        8
+#define REPORT_MS       1000
+
+//==============================================================================
+// State
+//==============================================================================
+
+typedef struct {
+    hrt_timer_t t;
+    const char *name;
+    volatile uint32_t count;
+    volatile uint32_t max_late;
+} demo_timer_t;
+
+static demo_timer_t timers[4];
+static uint32_t shot_seed = 1;
+
+//==============================================================================
+// Simple printf without newlib
+//==============================================================================
+
+static void uart_putc(char c) {
+    while (UART_TX_STATUS & 0x01);
+    UART_TX_DATA = c;
+}
+
+static void uart_puts(const char *s) {
+    while (*s) {
+        uart_putc(*s++);
+    }
+}
+
+static void uart_putdec(uint32_t val) {
+    char buf[12];
+    int i = 0;
+
+    do {
+        buf[i++] = '0' + (val % 10);
+        val /= 10;
+    } while (val > 0);
+    while (i > 0) {
+        uart_putc(buf[--i]);
+    }
+}
+
+//==============================================================================
+// Callbacks (from the timer interrupt)
+//==============================================================================
+
+// Lateness of the deadline that just fired; periodic timers have moved on
+// by a period already
+static void note(demo_timer_t *d) {
+    hrt_deadline_t due = d->t.expires - (d->t.armed ? d->t.period_us : 0);
+    uint64_t now = hrt_now_us();
+    uint32_t late = (now > due) ? (uint32_t)(now - due) : 0;
+
+    d->count++;
+    if (late > d->max_late) {
+        d->max_late = late;
+    }
+}
+
+static void on_tick(void *arg) {
+    note(arg);
+}
+
+static void on_led(void *arg) {
+    note(arg);
+    LED_REG ^= 0x01;
+}
+
+static void on_shot(void *arg) {
+    demo_timer_t *d = arg;
+
+    note(d);
+    shot_seed = shot_seed * 1103515245u + 12345u;
+    hrt_timer_start(&d->t, 100 + ((shot_seed >> 16) & 0x3FF), 0);
+}
+
+//==============================================================================
+// Main
+//==============================================================================
+
+static void setup(demo_timer_t *d, const char *name, hrt_fn_t fn) {
+    d->name = name;
+    hrt_timer_init(&d->t, fn, d);
+}
+
+static void report(uint32_t second) {
+    hrt_stats_t st;
+
+    hrt_get_stats(&st);
+    uart_puts("t=");
+    uart_putdec(second);
+    uart_puts(" s:");
+    for (uint32_t i = 0; i < 4; i++) {
+        demo_timer_t *d = &timers[i];
+        uint32_t irq = irq_setmask(~0u);
+        uint32_t count = d->count, late = d->max_late;
+
+        d->count = 0;
+        d->max_late = 0;
+        irq_setmask(irq);
+
+        uart_puts(" ");
+        uart_puts(d->name);
+        uart_puts(" ");
+        uart_putdec(count);
+        uart_puts("/");
+        uart_putdec(late);
+        uart_puts("us");
+    }
+    uart_puts(" | fired ");
+    uart_putdec(st.fired);
+    uart_puts(" overruns ");
+    uart_putdec(st.overruns);
+    uart_puts(" late max ");
+    uart_putdec(st.max_late_us);
+    uart_puts(" us\r\n");
+}
+
+int main(void) {
+    hrt_deadline_t next;
+
+    uart_puts("\r\n");
+    uart_puts("========================================\r\n");
+    uart_puts("Timer Service Demo (lib/hrtimer)\r\n");
+    uart_puts("========================================\r\n");
+    uart_puts("Per timer: callbacks / worst lateness in the last second\r\n");
+    uart_puts("\r\n");
+
+    irq_setmask(~0u);
+    if (!hrt_init(HRT_CH, HRT_PRIO)) {
+        uart_puts("No timer channel 3 in this bitstream\r\n");
+        for (;;);
+    }
+
+    setup(&timers[0], "fast", on_tick);
+    setup(&timers[1], "odd", on_tick);
+    setup(&timers[2], "led", on_led);
+    setup(&timers[3], "shot", on_shot);
+    hrt_timer_start(&timers[0].t, 1000, 1000);
+    hrt_timer_start(&timers[1].t, 7300, 7300);
+    hrt_timer_start(&timers[2].t, 250000, 250000);
+    hrt_timer_start(&timers[3].t, 100, 0);
+
+    irq_enable_all();
+
+    next = hrt_deadline_ms(REPORT_MS);
+    for (uint32_t second = 1; ; second++) {
+        hrt_sleep_until(next, 0);
+        next += REPORT_MS * 1000;
+        report(second);
+    }
+
+    return 0;
+}
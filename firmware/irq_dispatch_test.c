@@ -0,0 +1,120 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// irq_dispatch_test.c - Interrupt controller / dispatch table test
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+// No irq_handler() here: the start.S dispatcher calls the handlers
+// registered with irq_register(). Timer ticks at 100 Hz, a software IRQ is
+// raised every second and a button press toggles LED2.
+//==============================================================================
+
+#include <stdint.h>
+#include "../lib/irq.h"
+
+#define MMIO_BASE           0x80000000
+#define UART_TX_DATA        (*(volatile uint32_t*)(MMIO_BASE + 0x00))
+#define UART_TX_STATUS      (*(volatile uint32_t*)(MMIO_BASE + 0x04))
+#define LED_CONTROL         (*(volatile uint32_t*)(MMIO_BASE + 0x10))
+#define SOFT_IRQ_TRIGGER    (*(volatile uint32_t*)(MMIO_BASE + 0x40))
+
+#define TIMER_BASE          0x80000020
+#define TIMER_CR            (*(volatile uint32_t*)(TIMER_BASE + 0x00))
+#define TIMER_SR            (*(volatile uint32_t*)(TIMER_BASE + 0x04))
+#define TIMER_PSC           (*(volatile uint32_t*)(TIMER_BASE + 0x08))
+#define TIMER_ARR           (*(volatile uint32_t*)(TIMER_BASE + 0x0C))
+
+#define TIMER_CR_ENABLE     (1 << 0)
+#define TIMER_SR_UIF        (1 << 0)
+
+#ifndef SYS_CLK_HZ
+#define SYS_CLK_HZ          50000000
+#endif
+
+static volatile uint32_t timer_ticks = 0;
+static volatile uint32_t soft_count = 0;
+static volatile uint32_t button_count = 0;
+
+static void uart_putc(char c) {
+    while (UART_TX_STATUS & 1);
+    UART_TX_DATA = c;
+}
+
+static void uart_puts(const char *s) {
+    while (*s) uart_putc(*s++);
+}
+
+static void uart_put_dec(uint32_t val) {
+    char buf[11];
+    int i = 0;
+    do {
+        buf[i++] = '0' + (val % 10);
+        val /= 10;
+    } while (val);
+    while (i) uart_putc(buf[--i]);
+}
+
+//==============================================================================
+// Handlers (run from the dispatcher with interrupts off)
+//==============================================================================
+
+static void on_timer(uint32_t source) {
+    (void)source;
+    TIMER_SR = TIMER_SR_UIF;
+    timer_ticks++;
+    LED_CONTROL = (LED_CONTROL & 0x2) | ((timer_ticks / 50) & 1);
+}
+
+static void on_soft(uint32_t source) {
+    (void)source;
+    soft_count++;
+}
+
+static void on_button(uint32_t source) {
+    (void)source;
+    button_count++;
+    LED_CONTROL ^= 0x2;
+}
+
+int main(void) {
+    uint32_t last_second = 0;
+
+    uart_puts("\r\nInterrupt dispatch test\r\n");
+    uart_puts(irqc_present() ? "Interrupt controller: present\r\n"
+                             : "Interrupt controller: not found (mask fallback)\r\n");
+
+    irq_register(IRQ_TIMER, on_timer, 4);
+    irq_register(IRQ_SOFT, on_soft, 8);
+    irq_register(IRQ_BUTTON, on_button, 12);
+
+    // SYS_CLK_HZ / 1 MHz prescaler, 10000 ticks = 100 Hz
+    TIMER_PSC = (SYS_CLK_HZ + 500000) / 1000000 - 1;
+    TIMER_ARR = 9999;
+    TIMER_CR = TIMER_CR_ENABLE;
+
+    irq_enable_all();
+
+    while (1) {
+        uint32_t second = timer_ticks / 100;
+        if (second != last_second) {
+            last_second = second;
+            SOFT_IRQ_TRIGGER = 1;
+
+            uart_puts("t=");
+            uart_put_dec(second);
+            uart_puts("s ticks=");
+            uart_put_dec(timer_ticks);
+            uart_puts(" soft=");
+            uart_put_dec(soft_count);
+            uart_puts(" button=");
+            uart_put_dec(button_count);
+            uart_puts("\r\n");
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,132 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// irq_latency.h - Interrupt latency statistics and histogram
+//
+// Shared by irq_latency_bench.c (bare metal) and freertos_irq_latency.c.
+// Timer channel 1 counts down one step per CPU cycle (PSC = 0) and raises
+// IRQ[7] on reaching 0, reloading ARR on the same edge, so a handler that
+// reads CNT as its first access sees ARR - latency:
+//
+//   latency = cycles from the reload to the CNT load in the handler
+//
+// which includes the CPU's IRQ entry, the entry code (start.S / startFRT.S
+// irq_vec) and the dispatch up to the load itself.
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+
+#ifndef IRQ_LATENCY_H
+#define IRQ_LATENCY_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "../lib/timer.h"
+
+#define LAT_TIMER_CH        1               // IRQ_TIMERS
+#define LAT_PERIOD          10007           // Cycles; odd, so the IRQ walks
+                                            // across the interrupted code
+#define LAT_SAMPLES         2000
+
+#define LAT_BIN_CYCLES      8               // Histogram bin width
+#define LAT_BINS            64              // 0-511 cycles, then overflow
+#define LAT_BAR_WIDTH       40
+
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint32_t total;
+    uint32_t bins[LAT_BINS + 1];            // [LAT_BINS] = overflow
+} lat_stats_t;
+
+static inline void lat_reset(lat_stats_t *s) {
+    s->count = 0;
+    s->min = 0xFFFFFFFF;
+    s->max = 0;
+    s->total = 0;
+    for (unsigned i = 0; i <= LAT_BINS; i++) {
+        s->bins[i] = 0;
+    }
+}
+
+// Cycles since the reload; call with CNT read first thing in the handler
+static inline uint32_t lat_cycles(uint32_t cnt) {
+    return (LAT_PERIOD - 1) - cnt;
+}
+
+static inline void lat_record(lat_stats_t *s, uint32_t cycles) {
+    uint32_t bin = cycles / LAT_BIN_CYCLES;
+
+    s->count++;
+    s->total += cycles;
+    if (cycles < s->min) s->min = cycles;
+    if (cycles > s->max) s->max = cycles;
+    s->bins[bin < LAT_BINS ? bin : LAT_BINS]++;
+}
+
+// Channel 1 built in (Kconfig TIMER_CHANNELS >= 2); missing channels read 0
+static inline int lat_timer_present(void) {
+    TIMER_CH_ARR(LAT_TIMER_CH) = LAT_PERIOD - 1;
+    return TIMER_CH_ARR(LAT_TIMER_CH) == LAT_PERIOD - 1;
+}
+
+// Periodic IRQ every LAT_PERIOD cycles; the caller registers the handler
+static inline void lat_timer_start(void) {
+    TIMER_CH_CR(LAT_TIMER_CH) = 0;
+    TIMER_CH_SR(LAT_TIMER_CH) = TIMER_CH_UIF | TIMER_CH_CCIF;
+    TIMER_CH_PSC(LAT_TIMER_CH) = 0;
+    TIMER_CH_ARR(LAT_TIMER_CH) = LAT_PERIOD - 1;
+    TIMER_CH_CR(LAT_TIMER_CH) = TIMER_CH_ENABLE;
+}
+
+static inline void lat_timer_stop(void) {
+    TIMER_CH_CR(LAT_TIMER_CH) = 0;
+    TIMER_CH_SR(LAT_TIMER_CH) = TIMER_CH_UIF | TIMER_CH_CCIF;
+}
+
+static void lat_print(const char *name, const lat_stats_t *s) {
+    if (s->count == 0) {
+        printf("  %-16s no samples\r\n", name);
+        return;
+    }
+    printf("  %-16s min %5lu  avg %5lu  max %5lu  jitter %5lu cycles\r\n", name,
+           (unsigned long)s->min, (unsigned long)(s->total / s->count),
+           (unsigned long)s->max, (unsigned long)(s->max - s->min));
+}
+
+// Non-empty range of bins, bars scaled to the fullest one
+static void lat_histogram(const lat_stats_t *s) {
+    unsigned first = LAT_BINS + 1, last = 0;
+    uint32_t peak = 0;
+
+    for (unsigned i = 0; i <= LAT_BINS; i++) {
+        if (s->bins[i]) {
+            if (first > LAT_BINS) first = i;
+            last = i;
+            if (s->bins[i] > peak) peak = s->bins[i];
+        }
+    }
+    if (peak == 0) return;
+
+    for (unsigned i = first; i <= last; i++) {
+        uint32_t bar = (uint32_t)(((uint64_t)s->bins[i] * LAT_BAR_WIDTH + peak - 1) / peak);
+
+        if (i == LAT_BINS) {
+            printf("    %4u+     %5lu ", LAT_BINS * LAT_BIN_CYCLES, (unsigned long)s->bins[i]);
+        } else {
+            printf("    %4u-%-4u %5lu ", i * LAT_BIN_CYCLES, (i + 1) * LAT_BIN_CYCLES - 1,
+                   (unsigned long)s->bins[i]);
+        }
+        while (bar--) putchar('#');
+        printf("\r\n");
+    }
+}
+
+// Machine-readable average, same format as the other benchmarks
+static void lat_perf(const char *name, const lat_stats_t *s) {
+    printf("PERF %s iters=%lu cyc_per_iter=%lu\r\n", name, (unsigned long)s->count,
+           (unsigned long)(s->count ? s->total / s->count : 0));
+}
+
+#endif // IRQ_LATENCY_H
@@ -0,0 +1,160 @@
+//===============================================================================
+// Interrupt Latency / Jitter Benchmark (bare metal)
+// Timer IRQ entry latency through the start.S dispatcher, min/avg/max and
+// a histogram, with the CPU idle, asleep and copying through SRAM
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// Timer channel 1 interrupts every LAT_PERIOD cycles (irq_latency.h); the
+// handler, registered with irq_register(), reads CNT first. Each sample is
+// the cycles from the counter reload to that load: CPU IRQ entry, start.S
+// irq_vec, the IRQC_CLAIM / table dispatch and the load itself.
+//
+// Scenarios, LAT_SAMPLES interrupts each:
+//   spin      main loop spinning on a flag (best case)
+//   waitirq   CPU halted in irq_wait() (wakeup from sleep)
+//   sram copy main loop copying 16 KB buffers through SRAM, so the
+//             interrupt lands behind SRAM loads, stores and cache fills
+//
+// freertos_irq_latency.c measures the same under the FreeRTOS port. Lines
+// for scripts/perf_regress.sh:
+//
+//   PERF irq_lat_spin iters=<samples> cyc_per_iter=<average cycles>
+//   PERF irq_lat_sram iters=<samples> cyc_per_iter=<average cycles>
+//
+//===============================================================================
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "../lib/irq.h"
+#include "irq_latency.h"
+
+// UART direct access for the start key (no echo, no buffering)
+#define UART_RX_DATA   (*(volatile unsigned int*)0x80000008)
+#define UART_RX_STATUS (*(volatile unsigned int*)0x8000000C)
+
+#define COPY_BYTES     16384
+
+static uint8_t buf_a[COPY_BYTES] __attribute__((aligned(4)));
+static uint8_t buf_b[COPY_BYTES] __attribute__((aligned(4)));
+
+static lat_stats_t stats;
+static volatile uint32_t done;
+
+static int getch(void) {
+    while (!(UART_RX_STATUS & 0x01));
+    return UART_RX_DATA & 0xFF;
+}
+
+//==============================================================================
+// Handler (dispatcher, interrupts off); in scratchpad next to the entry code
+//==============================================================================
+
+__attribute__((section(".fastcode")))
+static void on_timer(uint32_t source) {
+    uint32_t cnt = TIMER_CH_CNT(LAT_TIMER_CH);
+
+    (void)source;
+    TIMER_CH_SR(LAT_TIMER_CH) = TIMER_CH_UIF;
+    lat_record(&stats, lat_cycles(cnt));
+    if (stats.count >= LAT_SAMPLES) {
+        TIMER_CH_CR(LAT_TIMER_CH) = 0;
+        done = 1;
+    }
+}
+
+//==============================================================================
+// Scenarios
+//==============================================================================
+
+typedef enum { LOAD_SPIN, LOAD_WAITIRQ, LOAD_SRAM } load_t;
+
+static void measure(load_t load) {
+    lat_reset(&stats);
+    done = 0;
+    lat_timer_start();
+
+    while (!done) {
+        switch (load) {
+        case LOAD_SPIN:
+            break;
+        case LOAD_WAITIRQ:
+            irq_wait_until(done, 1u << IRQ_TIMERS);
+            break;
+        case LOAD_SRAM:
+            memcpy(buf_b, buf_a, COPY_BYTES);
+            memcpy(buf_a, buf_b, COPY_BYTES);
+            break;
+        }
+    }
+    lat_timer_stop();
+}
+
+static void run_benchmark(void) {
+    static const struct { const char *name; const char *perf; load_t load; } runs[] = {
+        { "spin",      "irq_lat_spin", LOAD_SPIN },
+        { "waitirq",   NULL,           LOAD_WAITIRQ },
+        { "sram copy", "irq_lat_sram", LOAD_SRAM },
+    };
+    static lat_stats_t results[3];
+
+    for (unsigned i = 0; i < 3; i++) {
+        measure(runs[i].load);
+        results[i] = stats;
+    }
+
+    printf("\r\nTimer IRQ to handler, %u samples, %lu cycle period:\r\n",
+           LAT_SAMPLES, (unsigned long)LAT_PERIOD);
+    for (unsigned i = 0; i < 3; i++) {
+        lat_print(runs[i].name, &results[i]);
+    }
+    for (unsigned i = 0; i < 3; i++) {
+        printf("\r\n  %s (cycles, samples):\r\n", runs[i].name);
+        lat_histogram(&results[i]);
+    }
+
+    printf("\r\n");
+    for (unsigned i = 0; i < 3; i++) {
+        if (runs[i].perf) {
+            lat_perf(runs[i].perf, &results[i]);
+        }
+    }
+    printf("\r\nBenchmark complete\r\n");
+}
+
+int main(void) {
+    printf("\r\n\r\n");
+    printf("========================================\r\n");
+    printf("  Interrupt Latency / Jitter Benchmark\r\n");
+    printf("  bare metal, start.S table dispatch\r\n");
+    printf("========================================\r\n");
+    printf("\r\n");
+    printf("CPU clock: %lu MHz, IRQ controller: %s\r\n",
+           (unsigned long)(SYS_CLK_HZ / 1000000), irqc_present() ? "yes" : "no");
+    if (!lat_timer_present()) {
+        printf("ERROR: no timer channel 1 (Kconfig TIMER_CHANNELS >= 2)\r\n");
+        while (1);
+    }
+    printf("Press any key to start...\r\n");
+
+    for (uint32_t i = 0; i < COPY_BYTES; i++) {
+        buf_a[i] = (uint8_t)(i * 7 + 3);
+    }
+
+    irq_register(IRQ_TIMERS, on_timer, 8);
+    irq_enable_all();
+
+    getch();
+
+    while (1) {
+        run_benchmark();
+        printf("\r\nPress any key to run again...\r\n");
+        fflush(stdout);
+        getch();
+    }
+
+    return 0;
+}
@@ -0,0 +1,251 @@
+/*
+ * FreeRTOS TCP Server for PicoRV32 (lwIP NO_SYS 0)
+ *
+ * lwIP in its own tcpip thread (port/sys_arch_freertos.c), applications
+ * as ordinary blocking tasks:
+ *
+ * - Echo, port 7777, BSD sockets: the listener task accepts and hands each
+ *   connection to a pool of ECHO_WORKERS tasks, so that many clients are
+ *   served at once, each with plain recv()/send()
+ * - Status, port 5002, netconn API: one line of counters per connection
+ * - slipif receives in its own thread, asleep on the UART RX interrupt
+ *   (port/sio.c sio_read) while no frame is coming in
+ *
+ * Test with:
+ *   nc 192.168.100.2 7777        (several at once)
+ *   nc 192.168.100.2 5002
+ *
+ * The UART carries SLIP once the scheduler starts: nothing is printed
+ * after that.
+ *
+ * Build: make freertos_tcp_server (USE_FREERTOS=1 USE_LWIP=1)
+ *
+ * Copyright (c) October 2025 Michael Wolak
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <FreeRTOS.h>
+#include <task.h>
+#include <queue.h>
+#include "lwip/tcpip.h"
+#include "lwip/netif.h"
+#include "lwip/api.h"
+#include "lwip/sockets.h"
+#include "lwip/ip_addr.h"
+#include "netif/slipif.h"
+
+//==============================================================================
+// Configuration
+//==============================================================================
+
+#define DEVICE_IP      "192.168.100.2"
+#define NETMASK        "255.255.255.0"
+#define GATEWAY_IP     "192.168.100.1"
+#define ECHO_PORT      7777
+#define STATUS_PORT    5002
+
+#define ECHO_WORKERS   3            // Connections served at once
+#define ECHO_BUF       512
+#define TASK_STACK     384          // Words
+#define APP_PRIO       1            // Below tcpip and slipif (lwipopts.h)
+
+#define LED_CONTROL    (*(volatile uint32_t*)0x80000010)
+
+//==============================================================================
+// State
+//==============================================================================
+
+static struct netif slip_netif;
+
+static QueueHandle_t echo_queue;    // Accepted sockets for the workers
+
+// Each counter has one writer: the listener or its worker
+static volatile uint32_t echo_conns = 0;
+static volatile uint32_t echo_refused = 0;  // Pool full
+static volatile uint32_t echo_bytes[ECHO_WORKERS];
+static volatile uint8_t echo_busy[ECHO_WORKERS];
+
+//==============================================================================
+// Echo Server (BSD sockets)
+//==============================================================================
+
+static char echo_bufs[ECHO_WORKERS][ECHO_BUF];     // One per worker
+
+static void echo_serve(int sock, uint32_t w)
+{
+    int n;
+
+    while ((n = recv(sock, echo_bufs[w], ECHO_BUF, 0)) > 0) {
+        if (send(sock, echo_bufs[w], (size_t)n, 0) != n) {
+            break;
+        }
+        echo_bytes[w] += (uint32_t)n;
+        LED_CONTROL ^= 0x02;
+    }
+}
+
+// arg = worker index
+static void echo_worker_task(void *arg)
+{
+    uint32_t w = (uint32_t)arg;
+    int sock;
+
+    for (;;) {
+        xQueueReceive(echo_queue, &sock, portMAX_DELAY);
+        echo_busy[w] = 1;
+        echo_serve(sock, w);
+        closesocket(sock);
+        echo_busy[w] = 0;
+    }
+}
+
+static void echo_listen_task(void *arg)
+{
+    struct sockaddr_in addr;
+    int listener, sock;
+
+    (void)arg;
+
+    listener = socket(AF_INET, SOCK_STREAM, 0);
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(ECHO_PORT);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (listener < 0 ||
+        bind(listener, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        listen(listener, ECHO_WORKERS) < 0) {
+        vTaskSuspend(NULL);
+    }
+
+    for (;;) {
+        sock = accept(listener, NULL, NULL);
+        if (sock < 0) {
+            continue;
+        }
+        echo_conns++;
+        if (xQueueSend(echo_queue, &sock, 0) != pdTRUE) {
+            echo_refused++;             // Every worker busy, backlog full
+            closesocket(sock);
+        }
+    }
+}
+
+//==============================================================================
+// Status Server (netconn)
+//==============================================================================
+
+static void status_task(void *arg)
+{
+    struct netconn *listener, *conn;
+    uint32_t bytes, busy;
+    char line[160];
+    int n;
+
+    (void)arg;
+
+    listener = netconn_new(NETCONN_TCP);
+    if (listener == NULL ||
+        netconn_bind(listener, IP_ADDR_ANY, STATUS_PORT) != ERR_OK ||
+        netconn_listen(listener) != ERR_OK) {
+        vTaskSuspend(NULL);
+    }
+
+    for (;;) {
+        if (netconn_accept(listener, &conn) != ERR_OK) {
+            continue;
+        }
+        bytes = 0;
+        busy = 0;
+        for (uint32_t w = 0; w < ECHO_WORKERS; w++) {
+            bytes += echo_bytes[w];
+            busy += echo_busy[w];
+        }
+        n = snprintf(line, sizeof(line),
+                     "up %lu s, echo: %lu connections (%lu active, %lu refused), %lu bytes, "
+                     "heap free %u bytes\r\n",
+                     (unsigned long)(sys_now() / 1000), (unsigned long)echo_conns,
+                     (unsigned long)busy, (unsigned long)echo_refused,
+                     (unsigned long)bytes, (unsigned)xPortGetFreeHeapSize());
+        netconn_write(conn, line, (size_t)n, NETCONN_COPY);
+        netconn_close(conn);
+        netconn_delete(conn);
+    }
+}
+
+//==============================================================================
+// Network Initialization
+//==============================================================================
+
+/* Runs in the tcpip thread once it is up */
+static void network_init(void *arg)
+{
+    ip4_addr_t ipaddr, netmask, gw;
+
+    (void)arg;
+
+    ip4addr_aton(DEVICE_IP, &ipaddr);
+    ip4addr_aton(NETMASK, &netmask);
+    ip4addr_aton(GATEWAY_IP, &gw);
+
+    /* slipif_init() starts the SLIP RX thread */
+    netif_add(&slip_netif, &ipaddr, &netmask, &gw, NULL, slipif_init, tcpip_input);
+    netif_set_default(&slip_netif);
+    netif_set_up(&slip_netif);
+    netif_set_link_up(&slip_netif);
+}
+
+//==============================================================================
+// Main
+//==============================================================================
+
+int main(void)
+{
+    BaseType_t ok;
+
+    printf("\r\n");
+    printf("FreeRTOS TCP server (lwIP, netconn + sockets)\r\n");
+    printf("  %s: echo on %u (%u at once), status on %u\r\n",
+           DEVICE_IP, ECHO_PORT, ECHO_WORKERS, STATUS_PORT);
+    printf("Attach SLIP now; nothing more is printed\r\n\r\n");
+
+    echo_queue = xQueueCreate(ECHO_WORKERS, sizeof(int));
+    ok = echo_queue != NULL;
+
+    for (uint32_t i = 0; ok && i < ECHO_WORKERS; i++) {
+        ok = xTaskCreate(echo_worker_task, "echo", TASK_STACK, (void *)i,
+                         APP_PRIO, NULL) == pdPASS;
+    }
+    ok = ok && xTaskCreate(echo_listen_task, "listen", TASK_STACK, NULL,
+                           APP_PRIO, NULL) == pdPASS;
+    ok = ok && xTaskCreate(status_task, "status", TASK_STACK, NULL,
+                           APP_PRIO, NULL) == pdPASS;
+    if (!ok) {
+        printf("ERROR: out of FreeRTOS heap (%u bytes free)\r\n",
+               (unsigned)xPortGetFreeHeapSize());
+        for (;;) {
+            portNOP();
+        }
+    }
+
+    /* Creates the tcpip thread; network_init runs in it */
+    tcpip_init(network_init, NULL);
+
+    vTaskStartScheduler();
+
+    for (;;) {
+        portNOP();
+    }
+
+    return 0;
+}
+
+//==============================================================================
+// FreeRTOS Idle Hook (called when no tasks are ready)
+//==============================================================================
+
+void vApplicationIdleHook(void)
+{
+    vPortIdleWait();    // Halt until the next interrupt (portmacro.h)
+}
@@ -6,18 +6,41 @@
  *
  * Test with: iperf -c 192.168.100.2 -t 10
  *
+ * iperf -r makes the board send as well (lwiperf's tradeoff client). That
+ * path is zero-copy already: lwiperf queues references to a const pattern
+ * (tcp_write without TCP_WRITE_FLAG_COPY) from its tcp_sent callback, so
+ * the payload never goes through the MEM_SIZE heap.
+ *
+ * Statistics over TCP (printf would corrupt SLIP):
+ *   nc 192.168.100.2 5002
+ * reports the finished iperf runs since the last report, and the CPU time
+ * the main loop was not asleep waiting for a frame, per byte:
+ *   rx N bytes in N ms (N Kbit/s), tx N bytes in N ms (N Kbit/s)
+ *   cpu N.NN cycles/byte busy over N bytes
+ *
  * Copyright (c) October 2025 Michael Wolak
  */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
 #include "lwip/init.h"
 #include "lwip/netif.h"
 #include "lwip/timeouts.h"
 #include "lwip/ip.h"
 #include "netif/slipif.h"
 #include "lwip/ip_addr.h"
+#include "lwip/tcp.h"
 #include "lwip/apps/lwiperf.h"
+#include "../../../lib/timer.h"
+
+/* slip_hw_netif.c: SLIP codec or slipif, frames received from the UART
+ * interrupt, event-driven main loop (replaces slipif_poll) */
+extern err_t slip_hw_netif_init(struct netif *netif);
+extern void slip_hw_start(struct netif *netif);
+extern void slip_hw_process(struct netif *netif);
+extern void slip_hw_wait_rx(void);
 
 //==============================================================================
 // Configuration
@@ -26,6 +49,24 @@
 #define DEVICE_IP      "192.168.100.2"
 #define NETMASK        "255.255.255.0"
 #define GATEWAY_IP     "192.168.100.1"
+#define STATS_PORT     5002
+
+#ifndef SYS_CLK_HZ
+#define SYS_CLK_HZ     50000000
+#endif
+
+#define CYCLES_PER_US  (SYS_CLK_HZ / 1000000)
+
+/* Finished runs since the last report: [0] received, [1] sent */
+static struct {
+    u32_t bytes;
+    u32_t ms;
+} runs[2];
+
+/* Main loop time asleep in slip_hw_wait_rx() (timebase microseconds) */
+static uint32_t idle_us = 0;
+static uint32_t stats_start_us = 0;
+static uint32_t stats_idle_us = 0;
 
 //==============================================================================
 // iperf Report Callback
@@ -37,18 +78,84 @@ static void lwiperf_report(void *arg, enum lwiperf_report_type report_type,
                           u32_t bytes_transferred, u32_t ms_duration,
                           u32_t bandwidth_kbitpsec)
 {
+    int dir;
+
     (void)arg;
-    (void)report_type;
     (void)local_addr;
     (void)local_port;
     (void)remote_addr;
     (void)remote_port;
-    (void)bytes_transferred;
-    (void)ms_duration;
     (void)bandwidth_kbitpsec;
 
-    /* NO printf - corrupts SLIP! */
-    /* Results will be shown by iperf client */
+    /* NO printf - corrupts SLIP! Collected for the stats port instead */
+    switch (report_type) {
+        case LWIPERF_TCP_DONE_SERVER: dir = 0; break;
+        case LWIPERF_TCP_DONE_CLIENT: dir = 1; break;
+        default: return;            /* Aborted runs are not counted */
+    }
+    runs[dir].bytes += bytes_transferred;
+    runs[dir].ms += ms_duration;
+}
+
+//==============================================================================
+// Statistics (port 5002)
+//==============================================================================
+
+static unsigned long kbit_per_sec(u32_t bytes, u32_t ms)
+{
+    return ms ? (unsigned long)((uint64_t)bytes * 8 / ms) : 0UL;
+}
+
+/* One report per connection, then close */
+static err_t stats_accept(void *arg, struct tcp_pcb *newpcb, err_t err)
+{
+    char line[192];
+    uint32_t now = timebase_us32();
+    uint32_t total = runs[0].bytes + runs[1].bytes;
+    uint64_t busy = (uint64_t)((now - stats_start_us) - (idle_us - stats_idle_us)) * CYCLES_PER_US;
+    int n;
+
+    (void)arg;
+
+    if (err != ERR_OK || newpcb == NULL) {
+        return ERR_VAL;
+    }
+
+    n = snprintf(line, sizeof(line),
+                 "rx %lu bytes in %lu ms (%lu Kbit/s), tx %lu bytes in %lu ms (%lu Kbit/s)\r\n"
+                 "cpu %lu.%02lu cycles/byte busy over %lu bytes\r\n",
+                 (unsigned long)runs[0].bytes, (unsigned long)runs[0].ms,
+                 kbit_per_sec(runs[0].bytes, runs[0].ms),
+                 (unsigned long)runs[1].bytes, (unsigned long)runs[1].ms,
+                 kbit_per_sec(runs[1].bytes, runs[1].ms),
+                 total ? (unsigned long)(busy / total) : 0UL,
+                 total ? (unsigned long)(busy * 100 / total % 100) : 0UL,
+                 (unsigned long)total);
+
+    memset(runs, 0, sizeof(runs));
+    stats_start_us = now;
+    stats_idle_us = idle_us;
+
+    tcp_write(newpcb, line, (u16_t)n, TCP_WRITE_FLAG_COPY);
+    tcp_output(newpcb);
+    tcp_close(newpcb);
+
+    return ERR_OK;
+}
+
+static void stats_server_init(void)
+{
+    struct tcp_pcb *pcb;
+
+    pcb = tcp_new();
+    if (pcb == NULL || tcp_bind(pcb, IP_ADDR_ANY, STATS_PORT) != ERR_OK) {
+        return;     /* iperf still works without it */
+    }
+
+    pcb = tcp_listen(pcb);
+    if (pcb != NULL) {
+        tcp_accept(pcb, stats_accept);
+    }
 }
 
 //==============================================================================
@@ -68,12 +175,14 @@ static void network_init(void) {
     ip4addr_aton(NETMASK, &netmask);
     ip4addr_aton(GATEWAY_IP, &gw);
 
-    netif_add(&slip_netif, &ipaddr, &netmask, &gw, NULL, slipif_init, ip_input);
+    netif_add(&slip_netif, &ipaddr, &netmask, &gw, NULL, slip_hw_netif_init, ip_input);
     netif_set_default(&slip_netif);
     netif_set_up(&slip_netif);
 
     /* Start iperf server on default port 5001 */
     lwiperf_start_tcp_server_default(lwiperf_report, NULL);
+    stats_server_init();
+    stats_start_us = timebase_us32();
 
     /* Server is ready - test with: iperf -c 192.168.100.2 -t 10 */
 }
@@ -87,10 +196,19 @@ int main(void) {
 
     /* NO printf - corrupts SLIP! */
 
-    /* Main loop: process lwIP timeouts and SLIP input */
+    /* Receive SLIP from the UART interrupt from here on */
+    slip_hw_start(&slip_netif);
+
+    /* Main loop: SLIP input and lwIP timeouts, asleep in between */
     while (1) {
+        uint32_t t0;
+
+        slip_hw_process(&slip_netif);
         sys_check_timeouts();
-        slipif_poll(&slip_netif);
+
+        t0 = timebase_us32();
+        slip_hw_wait_rx();
+        idle_us += timebase_us32() - t0;
     }
 
     return 0;
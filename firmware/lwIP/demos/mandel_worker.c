@@ -0,0 +1,456 @@
+//===============================================================================
+// Mandelbrot Tile Worker - lwIP Demo for PicoRV32
+//
+// One node of a distributed Mandelbrot renderer: tools/mandel_farm on the
+// host splits a frame into tiles, deals them out to several boards over
+// UDP and assembles the results. Every pixel goes through fix16_mandel(),
+// the kernel of mandelbrot_fixed's BRUTE mode, so a one-board frame is the
+// same work mandelbrot_fixed times with its 'b' key, plus the network.
+//
+// Work queue: tiles wait in a deque of MANDEL_QUEUE. The board takes the
+// next tile from the front and computes it a row per main loop pass, so
+// SLIP input keeps being handled; the host refills from the back and, when
+// another board has run dry, steals tiles that have not been started from
+// the back again (MANDEL_STEAL). A tile of a new frame flushes whatever
+// was left of the previous one.
+//
+// Protocol (UDP port 7790, all fields little-endian):
+//
+//   header   u32 magic "MDF1"; u16 seq; u8 op; u8 count
+//   TILE     count x { u16 tile; u16 frame; s32 x0, y0, dx, dy (Q16.16);
+//                      u16 w, h, max_iter, 0 }
+//            reply: TILE|0x80, count = tiles accepted (the first ones;
+//                   a full queue takes no more), then u8 queued, 3 x 0
+//   STEAL    count = most tiles to give up
+//            reply: STEAL|0x80, count tiles taken off the back of the
+//                   queue, each { u16 tile; u16 frame }
+//   INFO     reply: INFO|0x80, then u32 tiles, busy_us, uptime_ms,
+//                   u16 queue, max_pixels, u32 timebase_hz
+//   RESULT   board to host when a tile is done, count 1:
+//            { u16 tile, frame, w, h; u32 us, iterations; u8 queued, 3 x 0 }
+//            then w * h u16 iteration counts, row by row
+//
+// A tile sent again (lost ACK or RESULT) is not queued twice: while it is
+// waiting or running it is just acknowledged, after that it is computed
+// again. us is the time spent in fix16_mandel() for the tile.
+//
+// Each board needs its own SLIP link and subnet (point-to-point):
+//   make mandel_worker MANDEL_NODE=0     # 192.168.100.2, host 192.168.100.1
+//   make mandel_worker MANDEL_NODE=1     # 192.168.101.2, host 192.168.101.1
+//   sudo tools/slattach_1m/slattach_1m -p slip -s 1000000 -L /dev/ttyUSB1 &
+//   sudo ifconfig sl1 192.168.101.1 pointopoint 192.168.101.2 up
+//
+//   tools/mandel_farm/mandel_farm -s 192.168.100.2 192.168.101.2
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+/* lwIP core includes */
+#include "lwip/opt.h"
+#include "lwip/init.h"
+#include "lwip/netif.h"
+#include "lwip/timeouts.h"
+#include "lwip/ip_addr.h"
+#include "lwip/ip.h"
+#include "lwip/udp.h"
+#include "lwip/pbuf.h"
+
+/* lwIP SLIP interface */
+#include "netif/slipif.h"
+
+#include "fixmath.h"
+#include "../../../lib/timer.h"
+
+/* slip_hw_netif.c: SLIP codec or slipif, frames received from the UART
+ * interrupt, event-driven main loop (replaces slipif_poll) */
+extern err_t slip_hw_netif_init(struct netif *netif);
+extern void slip_hw_start(struct netif *netif);
+extern void slip_hw_process(struct netif *netif);
+extern void slip_hw_wait_rx(void);
+
+//==============================================================================
+// Configuration
+//==============================================================================
+
+#ifndef MANDEL_NODE
+#define MANDEL_NODE         0       /* Board 192.168.(100 + n).2 */
+#endif
+
+#define MANDEL_PORT         7790
+#define MANDEL_MAGIC        0x3146444Du     /* "MDF1" */
+#define MANDEL_QUEUE        8               /* Tiles waiting on the board */
+#define MANDEL_MAX_PIXELS   640             /* w * h: the RESULT fits one datagram */
+#define MANDEL_MAX_REQ      512
+
+#define MANDEL_HDR_LEN      8
+#define MANDEL_TILE_LEN     28
+#define MANDEL_RESULT_LEN   20
+
+/* Operations; replies have MANDEL_REPLY set */
+#define MANDEL_TILE         1
+#define MANDEL_STEAL        2
+#define MANDEL_INFO         3
+#define MANDEL_RESULT       4
+#define MANDEL_REPLY        0x80
+
+struct tile_job {
+    u16_t tile, frame;
+    fix16_t x0, y0, dx, dy;
+    u16_t w, h, max_iter;
+    ip_addr_t addr;                 /* Where the RESULT goes */
+    u16_t port;
+};
+
+/* Deque: run from the front (head), refilled and stolen from the back (tail) */
+static struct tile_job queue[MANDEL_QUEUE];
+static u32_t q_head = 0, q_tail = 0;
+static u16_t cur_frame;
+static int have_frame = 0;
+
+/* The tile being computed, one row per mandel_step() */
+static struct {
+    int active;
+    struct tile_job job;
+    struct pbuf *p;                 /* RESULT, filled in place */
+    u16_t row;
+    u32_t us;
+    u32_t iters;
+} run;
+
+static struct {
+    u32_t tiles;
+    u32_t busy_us;
+} stats;
+
+static struct udp_pcb *mandel_pcb;
+static u8_t req[MANDEL_MAX_REQ] __attribute__((aligned(4)));
+static u8_t reply[MANDEL_HDR_LEN + 4 * 255] __attribute__((aligned(4)));
+
+//==============================================================================
+// Little-endian fields
+//==============================================================================
+
+static u16_t get16(const u8_t *p)
+{
+    return (u16_t)(p[0] | (p[1] << 8));
+}
+
+static u32_t get32(const u8_t *p)
+{
+    return (u32_t)p[0] | ((u32_t)p[1] << 8) | ((u32_t)p[2] << 16) | ((u32_t)p[3] << 24);
+}
+
+static void put16(u8_t *p, u16_t v)
+{
+    p[0] = (u8_t)v;
+    p[1] = (u8_t)(v >> 8);
+}
+
+static void put32(u8_t *p, u32_t v)
+{
+    put16(p, (u16_t)v);
+    put16(p + 2, (u16_t)(v >> 16));
+}
+
+static void put_header(u8_t *p, u16_t seq, u8_t op, u8_t count)
+{
+    put32(p, MANDEL_MAGIC);
+    put16(p + 4, seq);
+    p[6] = op;
+    p[7] = count;
+}
+
+static void send_reply(const ip_addr_t *addr, u16_t port, u16_t len)
+{
+    struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, len, PBUF_RAM);
+
+    if (p != NULL) {
+        pbuf_take(p, reply, len);
+        udp_sendto(mandel_pcb, p, addr, port);
+        pbuf_free(p);
+    }
+}
+
+//==============================================================================
+// Work queue
+//==============================================================================
+
+static u32_t queued(void)
+{
+    return q_tail - q_head;
+}
+
+/* A tile of another frame: drop everything left of the old one */
+static void frame_switch(u16_t frame)
+{
+    if (have_frame && frame == cur_frame) {
+        return;
+    }
+    q_head = q_tail = 0;
+    if (run.active) {
+        pbuf_free(run.p);
+        run.active = 0;
+    }
+    cur_frame = frame;
+    have_frame = 1;
+}
+
+/* 1 if the tile is waiting or running already */
+static int tile_known(u16_t tile)
+{
+    u32_t i;
+
+    if (run.active && run.job.tile == tile) {
+        return 1;
+    }
+    for (i = q_head; i != q_tail; i++) {
+        if (queue[i % MANDEL_QUEUE].tile == tile) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void handle_tile(const u8_t *d, u8_t count, u16_t seq,
+                        const ip_addr_t *addr, u16_t port)
+{
+    u8_t accepted = 0;
+
+    for (; accepted < count; accepted++, d += MANDEL_TILE_LEN) {
+        struct tile_job *j;
+        u16_t tile = get16(d);
+        u16_t w = get16(d + 20), h = get16(d + 22);
+
+        if (w == 0 || h == 0 || (u32_t)w * h > MANDEL_MAX_PIXELS || get16(d + 24) == 0) {
+            break;                  /* Not a tile this board can send back */
+        }
+        frame_switch(get16(d + 2));
+        if (tile_known(tile)) {
+            continue;
+        }
+        if (queued() == MANDEL_QUEUE) {
+            break;
+        }
+
+        j = &queue[q_tail % MANDEL_QUEUE];
+        j->tile = tile;
+        j->frame = cur_frame;
+        j->x0 = (fix16_t)get32(d + 4);
+        j->y0 = (fix16_t)get32(d + 8);
+        j->dx = (fix16_t)get32(d + 12);
+        j->dy = (fix16_t)get32(d + 16);
+        j->w = w;
+        j->h = h;
+        j->max_iter = get16(d + 24);
+        ip_addr_copy(j->addr, *addr);
+        j->port = port;
+        q_tail++;
+    }
+
+    put_header(reply, seq, MANDEL_TILE | MANDEL_REPLY, accepted);
+    memset(reply + MANDEL_HDR_LEN, 0, 4);
+    reply[MANDEL_HDR_LEN] = (u8_t)queued();
+    send_reply(addr, port, MANDEL_HDR_LEN + 4);
+}
+
+/* Give up to count tiles that have not been started, from the back */
+static void handle_steal(u8_t count, u16_t seq, const ip_addr_t *addr, u16_t port)
+{
+    u8_t *out = reply + MANDEL_HDR_LEN;
+    u8_t n = 0;
+
+    while (n < count && queued() > 0) {
+        const struct tile_job *j = &queue[--q_tail % MANDEL_QUEUE];
+
+        put16(out, j->tile);
+        put16(out + 2, j->frame);
+        out += 4;
+        n++;
+    }
+
+    put_header(reply, seq, MANDEL_STEAL | MANDEL_REPLY, n);
+    send_reply(addr, port, MANDEL_HDR_LEN + 4 * n);
+}
+
+static void handle_info(u16_t seq, const ip_addr_t *addr, u16_t port)
+{
+    u8_t *out = reply + MANDEL_HDR_LEN;
+
+    put_header(reply, seq, MANDEL_INFO | MANDEL_REPLY, 0);
+    put32(out, stats.tiles);
+    put32(out + 4, stats.busy_us);
+    put32(out + 8, sys_now());
+    put16(out + 12, MANDEL_QUEUE);
+    put16(out + 14, MANDEL_MAX_PIXELS);
+    put32(out + 16, 1000000);
+    send_reply(addr, port, MANDEL_HDR_LEN + 20);
+}
+
+static void mandel_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p,
+                        const ip_addr_t *addr, u16_t port)
+{
+    u16_t len, seq;
+    u8_t op, count;
+
+    (void)arg;
+    (void)pcb;
+
+    if (p == NULL) {
+        return;
+    }
+    len = p->tot_len;
+    if (len < MANDEL_HDR_LEN || len > MANDEL_MAX_REQ) {
+        pbuf_free(p);
+        return;
+    }
+    pbuf_copy_partial(p, req, len, 0);
+    pbuf_free(p);
+
+    if (get32(req) != MANDEL_MAGIC) {
+        return;
+    }
+    seq = get16(req + 4);
+    op = req[6];
+    count = req[7];
+
+    switch (op) {
+        case MANDEL_TILE:
+            if (len >= MANDEL_HDR_LEN + count * MANDEL_TILE_LEN) {
+                handle_tile(req + MANDEL_HDR_LEN, count, seq, addr, port);
+            }
+            break;
+        case MANDEL_STEAL:
+            handle_steal(count, seq, addr, port);
+            break;
+        case MANDEL_INFO:
+            handle_info(seq, addr, port);
+            break;
+        default:
+            break;                  /* Replies and unknown operations */
+    }
+}
+
+//==============================================================================
+// Tile computation
+//==============================================================================
+
+/* One row of the running tile, starting the next one first; 0: nothing to do */
+static int mandel_step(void)
+{
+    const struct tile_job *j = &run.job;
+    fix16_t real, imag;
+    u8_t *out;
+    u32_t t0;
+    int col;
+
+    if (!run.active) {
+        if (queued() == 0) {
+            return 0;
+        }
+        run.job = queue[q_head % MANDEL_QUEUE];
+        run.p = pbuf_alloc(PBUF_TRANSPORT, MANDEL_HDR_LEN + MANDEL_RESULT_LEN +
+                           2 * j->w * j->h, PBUF_RAM);
+        if (run.p == NULL) {
+            return 0;               /* Heap busy: the tile stays queued */
+        }
+        q_head++;
+        run.row = 0;
+        run.us = 0;
+        run.iters = 0;
+        run.active = 1;
+    }
+
+    out = (u8_t *)run.p->payload + MANDEL_HDR_LEN + MANDEL_RESULT_LEN + 2 * run.row * j->w;
+    real = j->x0;
+    imag = j->y0 + run.row * j->dy;
+
+    t0 = timebase_us32();
+    for (col = 0; col < j->w; col++) {
+        int iter = fix16_mandel(real, imag, j->max_iter);
+
+        put16(out, (u16_t)iter);
+        out += 2;
+        run.iters += (u32_t)iter;
+        real += j->dx;
+    }
+    run.us += timebase_us32() - t0;
+
+    if (++run.row == j->h) {
+        u8_t *r = (u8_t *)run.p->payload;
+
+        put_header(r, 0, MANDEL_RESULT | MANDEL_REPLY, 1);
+        r += MANDEL_HDR_LEN;
+        put16(r, j->tile);
+        put16(r + 2, j->frame);
+        put16(r + 4, j->w);
+        put16(r + 6, j->h);
+        put32(r + 8, run.us);
+        put32(r + 12, run.iters);
+        memset(r + 16, 0, 4);
+        r[16] = (u8_t)queued();
+
+        udp_sendto(mandel_pcb, run.p, &j->addr, j->port);
+        pbuf_free(run.p);
+        run.active = 0;
+
+        stats.tiles++;
+        stats.busy_us += run.us;
+    }
+
+    return 1;
+}
+
+//==============================================================================
+// Network Initialization
+//==============================================================================
+
+static struct netif slip_netif;
+
+static void network_init(void)
+{
+    ip4_addr_t ipaddr, netmask, gw;
+
+    lwip_init();
+
+    IP4_ADDR(&ipaddr, 192, 168, 100 + MANDEL_NODE, 2);
+    IP4_ADDR(&netmask, 255, 255, 255, 0);
+    IP4_ADDR(&gw, 192, 168, 100 + MANDEL_NODE, 1);
+
+    netif_add(&slip_netif, &ipaddr, &netmask, &gw, NULL, slip_hw_netif_init, ip_input);
+    netif_set_default(&slip_netif);
+    netif_set_up(&slip_netif);
+
+    mandel_pcb = udp_new();
+    if (mandel_pcb == NULL || udp_bind(mandel_pcb, IP_ADDR_ANY, MANDEL_PORT) != ERR_OK) {
+        while (1) { }               /* Nothing to serve */
+    }
+    udp_recv(mandel_pcb, mandel_recv, NULL);
+}
+
+//==============================================================================
+// Main Loop
+//==============================================================================
+
+int main(void)
+{
+    network_init();
+
+    /* NO printf - the UART carries SLIP */
+    slip_hw_start(&slip_netif);
+
+    /* SLIP input and lwIP timeouts between rows; asleep only without work */
+    while (1) {
+        slip_hw_process(&slip_netif);
+        sys_check_timeouts();
+        if (!mandel_step()) {
+            slip_hw_wait_rx();
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,219 @@
+//===============================================================================
+// Overlay Upload Server over SLIP - lwIP Demo for PicoRV32
+//
+// Redeploy overlays over the network instead of the serial console
+//
+// Features:
+// - Overlay upload on port 8890 (lwIP/port/overlay_tcp.c): streamed into
+//   the overlay slot at 0x60000 with the hardware CRC32 as it arrives
+// - Optional save to /OVERLAYS on SD (build with OVERLAY_TCP_SD=1)
+// - Runs the uploaded overlay on request, then goes back to serving
+// - Hardware SLIP codec when the bitstream has one (slip_hw_netif.c)
+//
+// Linux Host Setup:
+//   sudo tools/slattach_1m/slattach_1m -p slip -s 1000000 -L /dev/ttyUSB0 &
+//   sudo ifconfig sl0 192.168.100.1 pointopoint 192.168.100.2 up
+//   tools/overlay_tcp_upload/overlay_tcp_upload 192.168.100.2 hexedit.bin -x
+//
+// The UART carries SLIP: while an overlay runs its console output goes to
+// the same wire, and the host SLIP driver drops it as garbage.
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+/* lwIP core includes */
+#include "lwip/opt.h"
+#include "lwip/init.h"
+#include "lwip/netif.h"
+#include "lwip/timeouts.h"
+#include "lwip/ip_addr.h"
+#include "lwip/sys.h"
+
+/* UART RX interrupt (SLIP receive, see slip_hw_isr) */
+#include "../../../lib/uart_irq.h"
+
+/* Overlay upload service */
+#include "overlay_tcp.h"
+
+#ifdef OVERLAY_TCP_SD
+#include "ff.h"
+#include "overlay_loader.h"
+#endif
+
+//==============================================================================
+// Configuration
+//==============================================================================
+
+#define DEVICE_IP       "192.168.100.2"    /* This device (PicoRV32) */
+#define GATEWAY_IP      "192.168.100.1"    /* Linux host */
+#define NETMASK         "255.255.255.0"
+
+//==============================================================================
+// Interrupts
+//==============================================================================
+
+#define TIMER_BASE      0x80000020
+#define TIMER_SR        (*(volatile uint32_t*)(TIMER_BASE + 0x04))
+#define TIMER_SR_UIF    (1 << 0)
+
+/* Extern function in sys_arch.c - increments ms_count */
+extern void sys_timer_tick(void);
+
+/* Extern functions in slip_hw_netif.c - hardware SLIP codec, or slipif
+ * with interrupt-driven receive on bitstreams without it */
+extern err_t slip_hw_netif_init(struct netif *netif);
+extern void slip_hw_start(struct netif *netif);
+extern void slip_hw_isr(void);
+extern void slip_hw_process(struct netif *netif);
+extern void slip_hw_wait_rx(void);
+
+void irq_handler(uint32_t irqs) {
+    /* Timer IRQ[0]: lwIP millisecond tick */
+    if (irqs & (1 << 0)) {
+        TIMER_SR = TIMER_SR_UIF;
+        sys_timer_tick();
+    }
+
+    /* UART RX / SLIP frame (IRQ[4]): move received frames into pbufs */
+    if (irqs & (1 << IRQ_UART_RX)) {
+        slip_hw_isr();
+    }
+}
+
+//==============================================================================
+// SD Card (optional)
+//==============================================================================
+
+#ifdef OVERLAY_TCP_SD
+static FATFS g_fs;
+static int sd_mounted = 0;
+
+/*
+ * Save hook: write the verified image to /OVERLAYS/<name>. SD access is not
+ * interrupt safe (see overlay_execute), so IRQs stay masked meanwhile; the
+ * SLIP codec keeps receiving and TCP retransmits whatever the UART drops.
+ */
+static int sd_save(const char *name, const void *data, u32_t len)
+{
+    char path[16 + OVERLAY_TCP_NAME_MAX];
+    FIL fil;
+    UINT bw = 0;
+    FRESULT fr;
+    SYS_ARCH_DECL_PROTECT(lev);
+
+    if (!sd_mounted || strchr(name, '/') != NULL) {
+        return -1;
+    }
+    snprintf(path, sizeof(path), OVERLAY_DIR "/%s", name);
+
+    SYS_ARCH_PROTECT(lev);
+    fr = f_mkdir(OVERLAY_DIR);
+    if (fr == FR_OK || fr == FR_EXIST) {
+        fr = f_open(&fil, path, FA_WRITE | FA_CREATE_ALWAYS);
+    }
+    if (fr == FR_OK) {
+        fr = f_write(&fil, data, len, &bw);
+        if (f_close(&fil) != FR_OK) {
+            fr = FR_DISK_ERR;
+        }
+    }
+    SYS_ARCH_UNPROTECT(lev);
+
+    return (fr == FR_OK && bw == len) ? 0 : -1;
+}
+
+static const struct overlay_tcp_hooks upload_hooks = { sd_save, NULL };
+#else
+static const struct overlay_tcp_hooks upload_hooks = { NULL, NULL };
+#endif
+
+//==============================================================================
+// Network Initialization
+//==============================================================================
+
+static struct netif slip_netif;
+
+static void network_init(void)
+{
+    ip4_addr_t ipaddr, netmask, gw;
+    err_t err;
+
+    lwip_init();
+
+    ip4addr_aton(DEVICE_IP, &ipaddr);
+    ip4addr_aton(NETMASK, &netmask);
+    ip4addr_aton(GATEWAY_IP, &gw);
+
+    printf("Network Configuration:\r\n");
+    printf("  IP address: %s\r\n", DEVICE_IP);
+    printf("  Netmask:    %s\r\n", NETMASK);
+    printf("  Gateway:    %s\r\n", GATEWAY_IP);
+    printf("\r\n");
+
+    netif_add(&slip_netif, &ipaddr, &netmask, &gw, NULL, slip_hw_netif_init, ip_input);
+    if (slip_netif.output == NULL) {
+        printf("ERROR: SLIP interface initialization failed!\r\n");
+        while (1);
+    }
+
+    netif_set_default(&slip_netif);
+    netif_set_up(&slip_netif);
+    netif_set_link_up(&slip_netif);
+
+    err = overlay_tcp_init(&upload_hooks, OVERLAY_TCP_PORT);
+    if (err != ERR_OK) {
+        printf("ERROR: overlay upload service failed: %d\r\n", err);
+        while (1);
+    }
+
+    printf("Overlay upload listening on port %d\r\n", OVERLAY_TCP_PORT);
+}
+
+//==============================================================================
+// Main Loop
+//==============================================================================
+
+int main(void)
+{
+    printf("\r\n");
+    printf("==========================================\r\n");
+    printf("PicoRV32 Overlay Upload Server (SLIP)\r\n");
+    printf("==========================================\r\n");
+    printf("\r\n");
+
+#ifdef OVERLAY_TCP_SD
+    /* Mount before SLIP owns the UART, so errors can still be printed */
+    if (f_mount(&g_fs, "", 1) == FR_OK) {
+        sd_mounted = 1;
+        printf("SD card mounted: uploads can be saved to %s\r\n", OVERLAY_DIR);
+    } else {
+        printf("No SD card: uploads go to RAM only\r\n");
+    }
+#endif
+
+    network_init();
+
+    printf("\r\n");
+    printf("Ready! Disconnect the terminal and start SLIP now.\r\n");
+    printf("\r\n");
+
+    /* Receive SLIP from the UART interrupt from here on */
+    slip_hw_start(&slip_netif);
+
+    while (1) {
+        slip_hw_process(&slip_netif);
+        sys_check_timeouts();
+
+        /* Runs the overlay once EXEC has been answered */
+        overlay_tcp_poll();
+
+        slip_hw_wait_rx();
+    }
+
+    return 0;
+}
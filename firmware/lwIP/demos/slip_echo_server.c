@@ -7,6 +7,10 @@
 // - lwIP stack in NO_SYS mode (bare metal, no RTOS)
 // - SLIP interface over UART (1000000 baud / 1 Mbaud)
 // - TCP echo server on port 7777
+// - Telnet console on port 23 (lwIP/port/net_console.c): printf() output
+//   and a microRL shell, since the UART carries SLIP
+// - Memory/stats service on UDP port 7780 (lwIP/port/mem_service.c):
+//   PMU, CPU, lwIP and echo counters for tools/memsvc
 // - ICMP (ping) support
 //
 // Linux Host Setup:
@@ -14,6 +18,8 @@
 //   sudo ifconfig sl0 192.168.100.1 pointopoint 192.168.100.2 up
 //   ping 192.168.100.2
 //   telnet 192.168.100.2 7777
+//   telnet 192.168.100.2 23          (console: help, stats, exit)
+//   tools/memsvc/memsvc 192.168.100.2 stat cpu stat pmu stat 3
 //
 // Copyright (c) October 2025 Michael Wolak
 // Email: mikewolak@gmail.com, mike@epromfoundry.com
@@ -30,13 +36,27 @@
 #include "lwip/timeouts.h"
 #include "lwip/ip_addr.h"
 #include "lwip/stats.h"
+#include "lwip/sys.h"
 
 /* lwIP SLIP interface */
 #include "netif/slipif.h"
 
+/* UART RX interrupt (SLIP receive, see slip_hw_isr) */
+#include "../../../lib/uart_irq.h"
+
+/* Stack work deferred out of the ISRs to the main loop */
+#include "../../../lib/softirq/softirq.h"
+
 /* lwIP TCP API */
 #include "lwip/tcp.h"
 
+/* Telnet console, stdout while SLIP owns the UART */
+#include "net_console.h"
+#include "slip_vj.h"
+
+/* Peek/poke and counters over UDP */
+#include "mem_service.h"
+
 //==============================================================================
 // Configuration
 //==============================================================================
@@ -47,6 +67,10 @@
 
 #define ECHO_PORT       7777                /* TCP echo server port */
 
+#ifndef MEMSVC_KEY
+#define MEMSVC_KEY      0                   /* memsvc write key, 0: read-only */
+#endif
+
 //==============================================================================
 // LED Control (for activity indication)
 //==============================================================================
@@ -71,6 +95,34 @@ static void led_set(uint8_t state) {
 /* Extern function in sys_arch.c - increments ms_count */
 extern void sys_timer_tick(void);
 
+/* Extern functions in slip_hw_netif.c - hardware SLIP codec, or slipif
+ * with interrupt-driven receive on bitstreams without it */
+extern err_t slip_hw_netif_init(struct netif *netif);
+extern void slip_hw_start(struct netif *netif);
+extern void slip_hw_isr(void);
+extern void slip_hw_process(struct netif *netif);
+
+/*
+ * Deferred work - the ISRs only queue it, the main loop runs it with
+ * interrupts on (SOFTIRQ_MODE_POLL: lwIP is NO_SYS, one context only)
+ */
+static struct netif slip_netif;
+
+static void rx_work_fn(void *arg)
+{
+    (void)arg;
+    slip_hw_process(&slip_netif);
+}
+
+static void timeout_work_fn(void *arg)
+{
+    (void)arg;
+    sys_check_timeouts();
+}
+
+static softirq_work_t rx_work = SOFTIRQ_WORK_INIT(rx_work_fn, NULL);
+static softirq_work_t timeout_work = SOFTIRQ_WORK_INIT(timeout_work_fn, NULL);
+
 /*
  * IRQ Handler - Called by start.S when interrupt occurs
  *
@@ -90,6 +142,16 @@ void irq_handler(uint32_t irqs) {
         /* Increment lwIP millisecond counter */
         /* This is like timer_clock.c incrementing 'frames' */
         sys_timer_tick();
+
+        /* lwIP timers, and a receive sweep for the polled path (no UART IRQ) */
+        softirq_raise(&timeout_work);
+        softirq_raise(&rx_work);
+    }
+
+    /* UART RX / SLIP frame (IRQ[4]): move received frames into pbufs */
+    if (irqs & (1 << IRQ_UART_RX)) {
+        slip_hw_isr();
+        softirq_raise(&rx_work);
     }
 }
 
@@ -103,6 +165,12 @@ struct echo_state {
     uint32_t bytes_sent;
 };
 
+/* All connections, for the console's stats command and memsvc */
+static struct {
+    uint32_t connections;
+    uint32_t bytes;
+} echo_stats;
+
 //==============================================================================
 // TCP Echo Server Callbacks
 //==============================================================================
@@ -149,6 +217,7 @@ static err_t echo_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t er
 
     /* Update received byte count */
     es->bytes_received += p->tot_len;
+    echo_stats.bytes += p->tot_len;
 
     /* Echo data back - write to TCP send buffer */
     ret_err = tcp_write(tpcb, p->payload, p->len, TCP_WRITE_FLAG_COPY);
@@ -203,6 +272,7 @@ static err_t echo_accept(void *arg, struct tcp_pcb *newpcb, err_t err)
     es->pcb = newpcb;
     es->bytes_received = 0;
     es->bytes_sent = 0;
+    echo_stats.connections++;
 
     /* Set up TCP callbacks */
     tcp_arg(newpcb, es);
@@ -248,10 +318,71 @@ static void echo_server_init(void)
 }
 
 //==============================================================================
-// Network Initialization
+// Console Commands (telnet 192.168.100.2 23)
 //==============================================================================
 
-static struct netif slip_netif;
+static int cmd_help(int argc, const char *const *argv);
+
+static int cmd_stats(int argc, const char *const *argv)
+{
+    const net_console_stats_t *nc = net_console_stats();
+
+    (void)argc;
+    (void)argv;
+    printf("Uptime:   %lu ms\r\n", (unsigned long)sys_now());
+    printf("Echo:     %lu connections, %lu bytes\r\n",
+           (unsigned long)echo_stats.connections, (unsigned long)echo_stats.bytes);
+    printf("Console:  %lu writes in %lu segments, %lu bytes out, %lu dropped\r\n",
+           (unsigned long)nc->writes, (unsigned long)nc->segments,
+           (unsigned long)nc->bytes_out, (unsigned long)nc->dropped);
+#if SLIP_VJ
+    {
+        const slip_vj_stats_t *vj = slip_vj_stats();
+
+        printf("CSLIP:    %s, %lu compressed out, %lu header bytes saved, %lu errors in\r\n",
+               slip_vj_active() ? "on" : "off", (unsigned long)vj->out_compressed,
+               (unsigned long)vj->out_saved, (unsigned long)vj->in_errors);
+    }
+#endif
+#if LWIP_STATS && TCP_STATS
+    printf("TCP:      %lu segments in, %lu out, %lu retransmitted, %lu dropped\r\n",
+           (unsigned long)lwip_stats.tcp.recv, (unsigned long)lwip_stats.tcp.xmit,
+           (unsigned long)lwip_stats.tcp.rexmit, (unsigned long)lwip_stats.tcp.drop);
+#endif
+    return 0;
+}
+
+static int cmd_exit(int argc, const char *const *argv)
+{
+    (void)argc;
+    (void)argv;
+    net_console_close();
+    return 0;
+}
+
+static const mrl_cmd_t console_cmds[] = {
+    { "help",  cmd_help,  "help                - This list" },
+    { "h",     cmd_help,  NULL },
+    { "stats", cmd_stats, "stats               - Uptime, echo, console, CSLIP and TCP counters" },
+    { "exit",  cmd_exit,  "exit                - Close the console (also Ctrl-D)" },
+};
+
+static int cmd_help(int argc, const char *const *argv)
+{
+    (void)argc;
+    (void)argv;
+    printf("Commands:\r\n");
+    for (unsigned int i = 0; i < MICRORL_ARRAYSIZE(console_cmds); i++) {
+        if (console_cmds[i].help) {
+            printf("  %s\r\n", console_cmds[i].help);
+        }
+    }
+    return 0;
+}
+
+//==============================================================================
+// Network Initialization
+//==============================================================================
 
 static void network_init(void)
 {
@@ -282,7 +413,7 @@ static void network_init(void)
 
     /* Add SLIP interface */
     printf("Adding SLIP interface...\r\n");
-    netif_add(&slip_netif, &ipaddr, &netmask, &gw, NULL, slipif_init, ip_input);
+    netif_add(&slip_netif, &ipaddr, &netmask, &gw, NULL, slip_hw_netif_init, ip_input);
 
     if (slip_netif.output == NULL) {
         printf("ERROR: SLIP interface initialization failed!\r\n");
@@ -302,6 +433,11 @@ static void network_init(void)
     /* Start echo server */
     printf("Starting TCP echo server...\r\n");
     echo_server_init();
+    if (memsvc_init(MEMSVC_PORT, MEMSVC_KEY) == ERR_OK) {
+        memsvc_register("echo", &echo_stats, sizeof(echo_stats), NULL);
+        printf("Memory service on UDP port %d (%s)\r\n", MEMSVC_PORT,
+               MEMSVC_KEY ? "read/write" : "read-only");
+    }
     printf("\r\n");
 
     printf("=========================================\r\n");
@@ -313,14 +449,16 @@ static void network_init(void)
     printf("  sudo ifconfig sl0 192.168.100.1 pointopoint 192.168.100.2 up\r\n");
     printf("  ping 192.168.100.2\r\n");
     printf("  telnet 192.168.100.2 7777\r\n");
+    printf("  telnet 192.168.100.2 23\r\n");
     printf("\r\n");
 }
 
 //==============================================================================
-// Statistics - Removed (would interfere with SLIP on UART)
+// Statistics - on the console (stats command)
 //==============================================================================
-// Note: All runtime printing is disabled because UART is 100% dedicated to
-// SLIP protocol after initialization. Startup messages are OK before SLIP starts.
+// Note: the UART is 100% dedicated to SLIP after initialization. printf()
+// output (Echo:, connection messages) goes to the telnet console instead,
+// held in its ring until a client connects.
 
 //==============================================================================
 // Main Loop
@@ -338,13 +476,26 @@ int main(void)
     /* Initialize networking */
     network_init();
 
+    /* Console on port 23: from here on stdout goes over the network */
+    if (net_console_init(console_cmds, MICRORL_ARRAYSIZE(console_cmds),
+                         NET_CONSOLE_PORT) != ERR_OK) {
+        printf("Console failed: printf() output goes to the SLIP UART\r\n");
+    }
+
+    /* Receive SLIP from the UART interrupt from here on */
+    softirq_init(SOFTIRQ_MODE_POLL);
+    slip_hw_start(&slip_netif);
+
     /* Main loop */
     while (1) {
-        /* Poll SLIP interface for incoming packets */
-        slipif_poll(&slip_netif);
-
-        /* Process lwIP timers (TCP retransmission, ARP, etc.) */
-        sys_check_timeouts();
+        /* Frames from the UART ISR up the stack, lwIP timers (TCP
+         * retransmission, ARP, etc.) after each tick */
+        softirq_poll();
+
+        /* Sleep until the next UART or timer interrupt; the queue is
+         * checked with IRQs masked, so a frame just received is not
+         * left waiting for the next tick */
+        softirq_wait();
     }
 
     return 0;
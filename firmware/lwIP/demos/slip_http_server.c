@@ -6,7 +6,8 @@
 // Features:
 // - lwIP stack in NO_SYS mode (bare metal, no RTOS)
 // - SLIP interface over UART (1000000 baud / 1 Mbaud)
-// - Basic HTTP server on port 80 (lwIP httpd app)
+// - HTTP server on port 80: zero-copy static files (port/static_httpd.c),
+//   or the lwIP httpd app with HTTP_ZERO_COPY=0
 // - ICMP (ping) support
 //
 // Linux Host Setup:
@@ -16,8 +17,11 @@
 //
 // Browse to: http://192.168.100.2/
 //
-// Note: This is a simplified version without CGI/SSI support. Those features
-//       require additional lwipopts.h configuration (LWIP_HTTPD_CGI, etc.)
+// Zero-copy mode (default): page bodies are const arrays sent by reference
+// (PBUF_ROM), /about.html precompressed (curl --compressed). Connections
+// are kept alive and pipelined requests answered in order; measure with
+// tools/http_bench (-k, -P 4). No CGI/SSI in either mode; those need
+// LWIP_HTTPD_CGI etc. in lwipopts.h.
 //
 // Copyright (c) October 2025 Michael Wolak
 // Email: mikewolak@gmail.com, mike@epromfoundry.com
@@ -39,8 +43,19 @@
 /* lwIP SLIP interface */
 #include "netif/slipif.h"
 
-/* lwIP HTTP server */
+/* UART RX interrupt (SLIP receive, see slip_hw_isr) */
+#include "../../../lib/uart_irq.h"
+
+/* HTTP server: zero-copy static files, or the lwIP httpd app */
+#ifndef HTTP_ZERO_COPY
+#define HTTP_ZERO_COPY  1
+#endif
+
+#if HTTP_ZERO_COPY
+#include "static_httpd.h"
+#else
 #include "lwip/apps/httpd.h"
+#endif
 
 //==============================================================================
 // Configuration
@@ -50,6 +65,54 @@
 #define GATEWAY_IP      "192.168.100.1"    /* Linux host */
 #define NETMASK         "255.255.255.0"
 
+//==============================================================================
+// Static Pages (zero-copy mode)
+//==============================================================================
+
+#if HTTP_ZERO_COPY
+static const u8_t index_html[] =
+    "<!DOCTYPE html>\r\n"
+    "<html><head><title>PicoRV32 lwIP</title></head>\r\n"
+    "<body>\r\n"
+    "<h1>PicoRV32 HTTP Server over SLIP</h1>\r\n"
+    "<p>lwIP " LWIP_VERSION_STRING " on an Olimex iCE40HX8K-EVB.</p>\r\n"
+    "<p><a href=\"/about.html\">About</a> (precompressed)</p>\r\n"
+    "</body></html>\r\n";
+
+/* about.html, gzip -9 -n */
+static const u8_t about_html_gz[] = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x3d, 0x50,
+    0xcb, 0x4e, 0xc3, 0x30, 0x10, 0xbc, 0xe7, 0x2b, 0x96, 0x9e, 0xe0, 0x90,
+    0x9a, 0x02, 0x07, 0x84, 0x8c, 0x25, 0x1a, 0x82, 0x8a, 0x10, 0x4a, 0x94,
+    0x96, 0x88, 0x9e, 0x2a, 0x27, 0xde, 0x24, 0x96, 0x12, 0xdb, 0xb2, 0x5d,
+    0x44, 0xf9, 0x7a, 0x1c, 0x57, 0xea, 0x65, 0x5f, 0x33, 0x3b, 0xfb, 0xa0,
+    0x57, 0xaf, 0x45, 0xb6, 0xdb, 0x97, 0x39, 0x0c, 0x7e, 0x1a, 0x59, 0x42,
+    0xa3, 0xa3, 0x03, 0x72, 0xc1, 0xa8, 0x97, 0x7e, 0x44, 0x56, 0xca, 0x56,
+    0x57, 0xf5, 0xfd, 0x1d, 0xa4, 0xf0, 0xd2, 0xe8, 0xa3, 0xa7, 0xe4, 0x5c,
+    0xa7, 0x24, 0xb2, 0x12, 0xda, 0x68, 0x71, 0x9a, 0x3b, 0x57, 0x2c, 0xe2,
+    0xe0, 0x07, 0xe9, 0xa0, 0xd1, 0xdc, 0x8a, 0x40, 0x59, 0x05, 0xc4, 0xb0,
+    0x62, 0x94, 0x13, 0xfe, 0x82, 0xcc, 0xf2, 0x87, 0xdb, 0xcd, 0xf7, 0xe3,
+    0x47, 0x9a, 0xd7, 0x6b, 0xb0, 0x47, 0xa5, 0xa4, 0xea, 0x81, 0xc3, 0x65,
+    0x44, 0xf5, 0xbe, 0xcd, 0xd2, 0x1a, 0x9c, 0xee, 0x3c, 0xb4, 0xda, 0xe2,
+    0x92, 0x12, 0x13, 0x05, 0x76, 0xb3, 0xa6, 0xe1, 0x3d, 0x42, 0xf0, 0xce,
+    0x07, 0x48, 0x40, 0xff, 0x27, 0x4d, 0xda, 0xea, 0xc9, 0x58, 0x74, 0x2e,
+    0xe4, 0x52, 0xc1, 0xd2, 0x6a, 0xc1, 0x3d, 0x07, 0xae, 0x04, 0x38, 0x54,
+    0x1e, 0x9a, 0x13, 0x58, 0xec, 0xd0, 0xa2, 0x6a, 0x31, 0xb9, 0x2e, 0xd7,
+    0x5f, 0x6f, 0x87, 0xaa, 0xf8, 0xbc, 0x79, 0x0a, 0x4b, 0x62, 0x60, 0xd8,
+    0x1f, 0xb4, 0xa0, 0x70, 0xb6, 0xad, 0x36, 0x12, 0x1d, 0x68, 0x1b, 0x74,
+    0xba, 0x91, 0xfb, 0x10, 0x4b, 0x7f, 0x99, 0x4f, 0x39, 0x0c, 0x41, 0xe8,
+    0x79, 0x41, 0x16, 0x6c, 0xa3, 0x27, 0xa4, 0x84, 0xb3, 0x33, 0x46, 0xe2,
+    0xf9, 0xe1, 0xd2, 0xf8, 0xbf, 0x7f, 0xf9, 0xa0, 0xc8, 0xea, 0x50, 0x01,
+    0x00, 0x00,
+};
+
+static const struct static_httpd_file http_files[] = {
+    { "/index.html", "text/html", 0, index_html, sizeof(index_html) - 1 },
+    { "/about.html", "text/html", STATIC_HTTPD_GZIP, about_html_gz, sizeof(about_html_gz) },
+    { NULL, NULL, 0, NULL, 0 }
+};
+#endif
+
 //==============================================================================
 // LED Control (for activity indication)
 //==============================================================================
@@ -74,6 +137,14 @@ static void led_set(uint8_t state) {
 /* Extern function in sys_arch.c - increments ms_count */
 extern void sys_timer_tick(void);
 
+/* Extern functions in slip_hw_netif.c - hardware SLIP codec, or slipif
+ * with interrupt-driven receive on bitstreams without it */
+extern err_t slip_hw_netif_init(struct netif *netif);
+extern void slip_hw_start(struct netif *netif);
+extern void slip_hw_isr(void);
+extern void slip_hw_process(struct netif *netif);
+extern void slip_hw_wait_rx(void);
+
 /*
  * IRQ Handler - Called by start.S when interrupt occurs
  *
@@ -94,6 +165,11 @@ void irq_handler(uint32_t irqs) {
         /* This is like slip_echo_server.c incrementing ms_count */
         sys_timer_tick();
     }
+
+    /* UART RX / SLIP frame (IRQ[4]): move received frames into pbufs */
+    if (irqs & (1 << IRQ_UART_RX)) {
+        slip_hw_isr();
+    }
 }
 
 //==============================================================================
@@ -137,7 +213,7 @@ int main(void)
 
     /* Add SLIP network interface */
     printf("Adding SLIP interface...\r\n");
-    netif_add(&slip_netif, &ipaddr, &netmask, &gw, NULL, slipif_init, ip_input);
+    netif_add(&slip_netif, &ipaddr, &netmask, &gw, NULL, slip_hw_netif_init, ip_input);
 
     /* Set as default interface and bring up */
     netif_set_default(&slip_netif);
@@ -151,13 +227,21 @@ int main(void)
 
     /* Initialize HTTP server (basic static pages only) */
     printf("Starting HTTP server...\r\n");
+#if HTTP_ZERO_COPY
+    static_httpd_init(http_files, 80);
+#else
     httpd_init();
+#endif
 
     printf("\r\n========================================\r\n");
     printf("HTTP Server Ready!\r\n");
     printf("========================================\r\n");
     printf("Browse to: http://192.168.100.2/\r\n");
+#if HTTP_ZERO_COPY
+    printf("(Zero-copy static pages, /about.html gzip)\r\n");
+#else
     printf("(Serves static content from makefsdata)\r\n");
+#endif
     printf("\r\n");
 
     //==========================================================================
@@ -168,6 +252,9 @@ int main(void)
     extern void sys_init_timing(void);
     sys_init_timing();
 
+    /* Receive SLIP from the UART interrupt */
+    slip_hw_start(&slip_netif);
+
     //==========================================================================
     // SLIP Protocol Active - UART Lockout!
     //==========================================================================
@@ -178,11 +265,14 @@ int main(void)
 
     /* Main loop - poll SLIP and process lwIP timers */
     while (1) {
-        /* Poll SLIP interface for incoming packets */
-        slipif_poll(&slip_netif);
+        /* Pass frames received by the UART ISR up the stack */
+        slip_hw_process(&slip_netif);
 
         /* Process lwIP timers (TCP retransmit, ARP, etc.) */
         sys_check_timeouts();
+
+        /* Sleep until the next UART or timer interrupt instead of spinning */
+        slip_hw_wait_rx();
     }
 
     return 0;
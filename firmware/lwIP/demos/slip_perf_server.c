@@ -9,11 +9,20 @@
 // - CRC32 validation (0xEDB88320 polynomial)
 // - Timeout handling
 // - Real-time statistics
+// - UDP streaming mode: sequence numbered datagrams, loss/reorder/duplicate
+//   accounting and timestamp echo for RTT (client paces the rate)
 //
 // Protocol:
-//   Port 8888
+//   TCP port 8888
 //   Message format: [Type:4][Length:4][Payload:N]
 //
+//   UDP port 8888
+//   Datagram format: [Type:4][Seq:4][Timestamp:4][Payload:N]
+//   UDP_RESET      ->  UDP_RESET (clears the stream counters)
+//   UDP_DATA       ->  UDP_ECHO, header only
+//   UDP_STATS_REQ  ->  UDP_STATS_RESP [received:4][bytes:4][highest seq:4]
+//                      [reordered:4][duplicates:4][UART dropped:4][UART framing:4]
+//
 // Linux Client Setup:
 //   sudo tools/slattach_1m/slattach_1m -p slip -s 1000000 -L /dev/ttyUSB0
 //   sudo ifconfig sl0 192.168.100.1 pointopoint 192.168.100.2 up
@@ -27,6 +36,7 @@
 #include <string.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include "../../../lib/crc32.h"
 
 /* lwIP core includes */
 #include "lwip/opt.h"
@@ -37,6 +47,14 @@
 #include "lwip/stats.h"
 #include "netif/slipif.h"
 #include "lwip/tcp.h"
+#include "lwip/udp.h"
+
+/* slip_hw_netif.c: SLIP codec or slipif, frames received from the UART
+ * interrupt, event-driven main loop (replaces slipif_poll) */
+extern err_t slip_hw_netif_init(struct netif *netif);
+extern void slip_hw_start(struct netif *netif);
+extern void slip_hw_process(struct netif *netif);
+extern void slip_hw_wait_rx(void);
 
 //==============================================================================
 // Configuration
@@ -49,6 +67,11 @@
 #define PERF_PORT       8888
 #define MAX_BUFFER_SIZE (32 * 1024)   // 32KB - conservative for current memory layout
 
+// UART RX error counters (hdl/uart_peripheral.v RX_STATUS, write clears)
+#define UART_RX_STATUS      (*(volatile uint32_t*)0x8000000C)
+#define UART_RX_DROPPED(s)  (((s) >> 8) & 0xFFF)
+#define UART_RX_FRAMES(s)   (((s) >> 20) & 0xFFF)
+
 //==============================================================================
 // Protocol Message Types
 //==============================================================================
@@ -63,33 +86,15 @@
 #define MSG_TEST_STOP   0x08
 #define MSG_ERROR       0xFF
 
-//==============================================================================
-// CRC32 Implementation (matches firmware/hexedit.c polynomial 0xEDB88320)
-//==============================================================================
-
-static uint32_t crc32_table[256];
-static int crc32_initialized = 0;
-
-static void crc32_init(void) {
-    if (crc32_initialized) return;
-    for (int i = 0; i < 256; i++) {
-        uint32_t crc = i;
-        for (int j = 0; j < 8; j++) {
-            crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320 : 0);
-        }
-        crc32_table[i] = crc;
-    }
-    crc32_initialized = 1;
-}
+/* UDP stream datagrams */
+#define UDP_DATA        0x10
+#define UDP_ECHO        0x11
+#define UDP_STATS_REQ   0x12
+#define UDP_STATS_RESP  0x13
+#define UDP_RESET       0x14
 
-static uint32_t calculate_crc32(const uint8_t *data, uint32_t length) {
-    crc32_init();
-    uint32_t crc = 0xFFFFFFFF;
-    for (uint32_t i = 0; i < length; i++) {
-        crc = (crc >> 8) ^ crc32_table[(crc ^ data[i]) & 0xFF];
-    }
-    return ~crc;
-}
+#define UDP_HEADER_LEN  12
+#define UDP_STATS_WORDS 7
 
 //==============================================================================
 // Performance Test State
@@ -114,10 +119,35 @@ struct perf_state {
     struct pbuf *pending;  /* Accumulated pbuf chain */
 };
 
+/* UDP stream accounting: bit i of window = seq (highest - i) seen */
+struct udp_stream_state {
+    uint8_t started;
+    uint32_t received;
+    uint32_t bytes;
+    uint32_t highest;
+    uint32_t window;
+    uint32_t reordered;
+    uint32_t duplicates;
+};
+
+static struct udp_stream_state g_udp;
+
 //==============================================================================
 // Helper Functions
 //==============================================================================
 
+static void put_u32(uint8_t *p, uint32_t v) {
+    p[0] = (v >> 24) & 0xFF;
+    p[1] = (v >> 16) & 0xFF;
+    p[2] = (v >> 8) & 0xFF;
+    p[3] = v & 0xFF;
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+           ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
 static err_t send_message(struct tcp_pcb *tpcb, uint32_t type, const void *payload, uint32_t length) {
     uint8_t header[8];
     err_t err;
@@ -265,6 +295,7 @@ static void handle_test_start(struct perf_state *ps, const uint8_t *payload) {
     ps->packets_rx = 0;
     ps->packets_tx = 0;
     ps->errors = 0;
+    UART_RX_STATUS = 0;  /* Restart the UART drop/framing counters */
 
     send_message(ps->pcb, MSG_TEST_ACK, NULL, 0);
 }
@@ -280,17 +311,41 @@ static void handle_data_crc(struct perf_state *ps, const uint8_t *payload) {
 static void handle_data_block(struct perf_state *ps, const uint8_t *payload, uint32_t length) {
     uint32_t calculated_crc;
     uint8_t response[4];
+    uint8_t error_payload[12];
+    uint32_t rx_status, dropped, frames;
     err_t err;
 
     ps->bytes_rx += length;
     ps->packets_rx++;
 
     /* Validate CRC */
-    calculated_crc = calculate_crc32(payload, length);
+    calculated_crc = crc32_calc(payload, length);
 
     if (calculated_crc != ps->expected_crc) {
         ps->errors++;
-        send_message(ps->pcb, MSG_ERROR, NULL, 0);
+
+        /* Error code 3 = CRC mismatch, plus UART bytes dropped (RX FIFO
+         * full) and framing errors since the test started */
+        rx_status = UART_RX_STATUS;
+        dropped = UART_RX_DROPPED(rx_status);
+        frames = UART_RX_FRAMES(rx_status);
+
+        error_payload[0] = 0;
+        error_payload[1] = 0;
+        error_payload[2] = 0;
+        error_payload[3] = 3;  /* Error code: 3 = CRC mismatch */
+
+        error_payload[4] = (dropped >> 24) & 0xFF;
+        error_payload[5] = (dropped >> 16) & 0xFF;
+        error_payload[6] = (dropped >> 8) & 0xFF;
+        error_payload[7] = dropped & 0xFF;
+
+        error_payload[8] = (frames >> 24) & 0xFF;
+        error_payload[9] = (frames >> 16) & 0xFF;
+        error_payload[10] = (frames >> 8) & 0xFF;
+        error_payload[11] = frames & 0xFF;
+
+        send_message(ps->pcb, MSG_ERROR, error_payload, 12);
         return;
     }
 
@@ -300,7 +355,7 @@ static void handle_data_block(struct perf_state *ps, const uint8_t *payload, uin
     }
 
     /* Calculate CRC of response */
-    calculated_crc = calculate_crc32(g_test_buffer, ps->block_size);
+    calculated_crc = crc32_calc(g_test_buffer, ps->block_size);
 
     /* Send CRC */
     response[0] = (calculated_crc >> 24) & 0xFF;
@@ -504,6 +559,102 @@ static err_t perf_accept(void *arg, struct tcp_pcb *newpcb, err_t err) {
     return ERR_OK;
 }
 
+//==============================================================================
+// UDP Stream
+//==============================================================================
+
+static void udp_stream_account(uint32_t seq, uint32_t length) {
+    struct udp_stream_state *us = &g_udp;
+    uint32_t behind;
+
+    if (!us->started) {
+        us->started = 1;
+        us->highest = seq;
+        us->window = 1;
+    } else if (seq > us->highest) {
+        behind = seq - us->highest;
+        us->window = (behind >= 32) ? 1 : ((us->window << behind) | 1);
+        us->highest = seq;
+    } else {
+        behind = us->highest - seq;
+        if (behind < 32 && (us->window & (1u << behind))) {
+            us->duplicates++;
+            return;
+        }
+        if (behind < 32) {
+            us->window |= 1u << behind;
+        }
+        us->reordered++;
+    }
+
+    us->received++;
+    us->bytes += length;
+}
+
+static void udp_reply(struct udp_pcb *pcb, const ip_addr_t *addr, u16_t port,
+                      uint32_t type, const uint8_t *header, const uint32_t *words, int count) {
+    struct pbuf *q;
+    uint8_t *out;
+
+    q = pbuf_alloc(PBUF_TRANSPORT, UDP_HEADER_LEN + 4 * count, PBUF_RAM);
+    if (q == NULL) {
+        return;
+    }
+
+    out = (uint8_t *)q->payload;
+    put_u32(out, type);
+    memcpy(out + 4, header + 4, 8);     /* Seq and timestamp echoed as sent */
+    for (int i = 0; i < count; i++) {
+        put_u32(out + UDP_HEADER_LEN + 4 * i, words[i]);
+    }
+
+    udp_sendto(pcb, q, addr, port);
+    pbuf_free(q);
+}
+
+static void udp_perf_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p,
+                          const ip_addr_t *addr, u16_t port) {
+    uint8_t header[UDP_HEADER_LEN];
+    uint32_t words[UDP_STATS_WORDS], rx_status;
+
+    (void)arg;
+
+    if (pbuf_copy_partial(p, header, UDP_HEADER_LEN, 0) != UDP_HEADER_LEN) {
+        pbuf_free(p);
+        return;
+    }
+
+    switch (get_u32(header)) {
+        case UDP_DATA:
+            udp_stream_account(get_u32(header + 4), p->tot_len);
+            udp_reply(pcb, addr, port, UDP_ECHO, header, NULL, 0);
+            break;
+
+        case UDP_RESET:
+            memset(&g_udp, 0, sizeof(g_udp));
+            UART_RX_STATUS = 0;
+            udp_reply(pcb, addr, port, UDP_RESET, header, NULL, 0);
+            break;
+
+        case UDP_STATS_REQ:
+            rx_status = UART_RX_STATUS;
+            words[0] = g_udp.received;
+            words[1] = g_udp.bytes;
+            words[2] = g_udp.highest;
+            words[3] = g_udp.reordered;
+            words[4] = g_udp.duplicates;
+            words[5] = UART_RX_DROPPED(rx_status);
+            words[6] = UART_RX_FRAMES(rx_status);
+            udp_reply(pcb, addr, port, UDP_STATS_RESP, header, words, UDP_STATS_WORDS);
+            break;
+
+        default:
+            break;
+    }
+
+    pbuf_free(p);
+}
+
 //==============================================================================
 // Network and Server Initialization
 //==============================================================================
@@ -533,7 +684,7 @@ static void network_init(void) {
     printf("  Max buffer: %d KB\r\n", MAX_BUFFER_SIZE / 1024);
     printf("\r\n");
 
-    netif_add(&slip_netif, &ipaddr, &netmask, &gw, NULL, slipif_init, ip_input);
+    netif_add(&slip_netif, &ipaddr, &netmask, &gw, NULL, slip_hw_netif_init, ip_input);
     netif_set_default(&slip_netif);
     netif_set_up(&slip_netif);
     netif_set_link_up(&slip_netif);
@@ -544,6 +695,7 @@ static void network_init(void) {
 
 static void perf_server_init(void) {
     struct tcp_pcb *pcb;
+    struct udp_pcb *udp;
 
     pcb = tcp_new();
     if (!pcb) {
@@ -565,7 +717,14 @@ static void perf_server_init(void) {
 
     tcp_accept(pcb, perf_accept);
 
-    printf("Performance test server listening on port %d\r\n", PERF_PORT);
+    udp = udp_new();
+    if (!udp || udp_bind(udp, IP_ADDR_ANY, PERF_PORT) != ERR_OK) {
+        printf("UDP bind failed!\r\n");
+    } else {
+        udp_recv(udp, udp_perf_recv, NULL);
+    }
+
+    printf("Performance test server listening on port %d (TCP and UDP)\r\n", PERF_PORT);
     printf("\r\n");
     printf("Waiting for client connection...\r\n");
     printf("\r\n");
@@ -600,7 +759,6 @@ int main(void) {
            (unsigned long)g_buffer_size, (unsigned long)(g_buffer_size / 1024));
     printf("\r\n");
 
-    crc32_init();
     network_init();
     perf_server_init();
 
@@ -608,9 +766,14 @@ int main(void) {
     printf("Disconnect terminal and start SLIP now.\r\n");
     printf("\r\n");
 
+    /* Receive SLIP from the UART interrupt from here on */
+    slip_hw_start(&slip_netif);
+
+    /* Main loop: SLIP input and lwIP timeouts, asleep in between */
     while (1) {
-        slipif_poll(&slip_netif);
+        slip_hw_process(&slip_netif);
         sys_check_timeouts();
+        slip_hw_wait_rx();
     }
 
     return 0;
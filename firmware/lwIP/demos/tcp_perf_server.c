@@ -6,11 +6,33 @@
  *
  * Test with: iperf -c 192.168.100.2 -p 5001 -t 10
  *
+ * Transmit: the board streams a fixed pattern to whoever connects until
+ * the peer closes,
+ *   timeout 10 nc 192.168.100.2 5003 > /dev/null    (zero-copy)
+ *   timeout 10 nc 192.168.100.2 5004 > /dev/null    (copying, to compare)
+ * Port 5003 queues references to the static pattern (tcp_write without
+ * TCP_WRITE_FLAG_COPY): each segment costs a PBUF_ROM from the pbuf pool and
+ * its header, the payload is never copied into the MEM_SIZE heap, and the
+ * next segment goes out from tcp_sent() as soon as an ACK frees room.
+ * Port 5004 copies every byte into the heap (TCP_WRITE_FLAG_COPY).
+ *
+ * Statistics (the UART carries SLIP, so they go out over TCP):
+ *   nc 192.168.100.2 5002
+ * reports since the last report:
+ *   rx N bytes, checksum N bytes in N calls (N by DMA), N cycles/KB
+ *   tx N bytes in N ms (N KB/s, zero-copy), tcp_write N cycles/KB
+ *   cpu N.NN cycles/byte busy over N bytes
+ * The checksum figure is the time spent in the Internet checksum
+ * (port/chksum.c), tcp_write the time spent queueing transmit data, and
+ * cpu the time the main loop was not asleep waiting for a frame, per byte
+ * received or sent: at 1 Mbaud that includes waiting for the UART.
+ *
  * Copyright (c) October 2025 Michael Wolak
  */
 
 #include <stdio.h>
 #include <string.h>
+#include <stdint.h>
 #include "lwip/init.h"
 #include "lwip/netif.h"
 #include "lwip/timeouts.h"
@@ -18,6 +40,14 @@
 #include "lwip/tcp.h"
 #include "netif/slipif.h"
 #include "lwip/ip_addr.h"
+#include "../../../lib/timer.h"
+
+/* slip_hw_netif.c: SLIP codec or slipif, frames received from the UART
+ * interrupt, event-driven main loop (replaces slipif_poll) */
+extern err_t slip_hw_netif_init(struct netif *netif);
+extern void slip_hw_start(struct netif *netif);
+extern void slip_hw_process(struct netif *netif);
+extern void slip_hw_wait_rx(void);
 
 //==============================================================================
 // Configuration
@@ -27,6 +57,41 @@
 #define NETMASK        "255.255.255.0"
 #define GATEWAY_IP     "192.168.100.1"
 #define PERF_PORT      5001
+#define STATS_PORT     5002
+#define TX_PORT        5003        /* Zero-copy transmit */
+#define TX_COPY_PORT   5004        /* Copying transmit */
+
+#ifndef SYS_CLK_HZ
+#define SYS_CLK_HZ     50000000
+#endif
+
+#define CYCLES_PER_US  (SYS_CLK_HZ / 1000000)
+
+static uint32_t perf_rx_bytes = 0;
+
+/* Main loop time asleep in slip_hw_wait_rx() (timebase microseconds) */
+static uint32_t idle_us = 0;
+static uint32_t stats_start_us = 0;
+static uint32_t stats_idle_us = 0;
+
+/* Transmit session: one at a time */
+static struct {
+    struct tcp_pcb *pcb;            /* NULL: none running */
+    u8_t copy;                      /* TCP_WRITE_FLAG_COPY or 0 */
+    u8_t last_copy;                 /* Mode of the bytes below */
+    u32_t queued;                   /* Bytes handed to tcp_write() */
+    u32_t acked;                    /* Bytes acknowledged (reported) */
+    u32_t start_us;
+    u32_t us;                       /* Session time of the acked bytes */
+    u32_t write_us;                 /* Time in tcp_write() */
+} tx;
+
+/*
+ * Transmit pattern: any TCP_MSS long window starting within the first 10
+ * bytes is the next part of the "0123456789..." stream, so a segment is a
+ * reference to &tx_pattern[queued % 10] (lwiperf sends the same way).
+ */
+static u8_t tx_pattern[TCP_MSS + 10];
 
 //==============================================================================
 // TCP Performance Server
@@ -43,6 +108,8 @@ static err_t perf_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t er
         return ERR_OK;
     }
 
+    perf_rx_bytes += p->tot_len;
+
     /* Receive data - just consume it for performance testing */
     /* Update receive window - lwIP will handle ACK automatically */
     tcp_recved(tpcb, p->tot_len);
@@ -53,6 +120,133 @@ static err_t perf_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t er
     return ERR_OK;
 }
 
+//==============================================================================
+// Transmit
+//==============================================================================
+
+/* Queue pattern until the send buffer or TCP_SND_QUEUELEN is full */
+static void tx_send(struct tcp_pcb *pcb)
+{
+    int queued = 0;
+
+    while (tcp_sndbuf(pcb) > 0 && tcp_sndqueuelen(pcb) < TCP_SND_QUEUELEN - 1) {
+        u16_t n = tcp_sndbuf(pcb);
+        u32_t t0;
+        err_t err;
+
+        if (n > TCP_MSS) n = TCP_MSS;
+
+        t0 = timebase_us32();
+        err = tcp_write(pcb, &tx_pattern[tx.queued % 10], n, tx.copy | TCP_WRITE_FLAG_MORE);
+        tx.write_us += timebase_us32() - t0;
+        if (err != ERR_OK) {
+            break;                  /* ERR_MEM: tcp_sent() / tcp_poll() come back */
+        }
+        tx.queued += n;
+        queued = 1;
+    }
+
+    if (queued) {
+        tcp_output(pcb);
+    }
+}
+
+static void tx_end(struct tcp_pcb *pcb)
+{
+    tx.us += timebase_us32() - tx.start_us;
+    tx.pcb = NULL;
+
+    if (pcb != NULL) {
+        tcp_arg(pcb, NULL);
+        tcp_recv(pcb, NULL);
+        tcp_sent(pcb, NULL);
+        tcp_poll(pcb, NULL, 0);
+        tcp_err(pcb, NULL);
+        if (tcp_close(pcb) != ERR_OK) {
+            tcp_abort(pcb);
+        }
+    }
+}
+
+static err_t tx_sent(void *arg, struct tcp_pcb *pcb, u16_t len)
+{
+    (void)arg;
+
+    tx.acked += len;
+    tx_send(pcb);
+    return ERR_OK;
+}
+
+static err_t tx_poll(void *arg, struct tcp_pcb *pcb)
+{
+    (void)arg;
+
+    tx_send(pcb);
+    return ERR_OK;
+}
+
+/* Anything from the peer is dropped; its FIN ends the session */
+static err_t tx_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
+{
+    (void)arg;
+    (void)err;
+
+    if (p == NULL) {
+        tx_end(pcb);
+        return ERR_OK;
+    }
+    tcp_recved(pcb, p->tot_len);
+    pbuf_free(p);
+    return ERR_OK;
+}
+
+static void tx_err(void *arg, err_t err)
+{
+    (void)arg;
+    (void)err;
+
+    tx_end(NULL);                   /* Reset by the peer: pcb already gone */
+}
+
+static err_t tx_accept(void *arg, struct tcp_pcb *newpcb, err_t err)
+{
+    if (err != ERR_OK || newpcb == NULL) {
+        return ERR_VAL;
+    }
+    if (tx.pcb != NULL) {
+        return ERR_MEM;             /* One session at a time */
+    }
+
+    tx.pcb = newpcb;
+    tx.copy = (u8_t)(uintptr_t)arg;
+    tx.last_copy = tx.copy;
+    tx.start_us = timebase_us32();
+
+    tcp_recv(newpcb, tx_recv);
+    tcp_sent(newpcb, tx_sent);
+    tcp_poll(newpcb, tx_poll, 2);
+    tcp_err(newpcb, tx_err);
+    tx_send(newpcb);
+
+    return ERR_OK;
+}
+
+static void tx_server_init(u16_t port, u8_t copy)
+{
+    struct tcp_pcb *pcb;
+
+    pcb = tcp_new();
+    if (pcb == NULL || tcp_bind(pcb, IP_ADDR_ANY, port) != ERR_OK) {
+        return;     /* Receive test still works without it */
+    }
+
+    pcb = tcp_listen(pcb);
+    if (pcb != NULL) {
+        tcp_arg(pcb, (void *)(uintptr_t)copy);
+        tcp_accept(pcb, tx_accept);
+    }
+}
+
 static err_t perf_accept(void *arg, struct tcp_pcb *newpcb, err_t err)
 {
     (void)arg;
@@ -68,6 +262,73 @@ static err_t perf_accept(void *arg, struct tcp_pcb *newpcb, err_t err)
     return ERR_OK;
 }
 
+/* One report per connection, then close */
+static err_t stats_accept(void *arg, struct tcp_pcb *newpcb, err_t err)
+{
+    char line[320];
+    uint32_t bytes = chksum_stats.bytes;
+    uint64_t cycles = (uint64_t)chksum_stats.us * CYCLES_PER_US;
+    uint32_t now = timebase_us32();
+    uint32_t total = perf_rx_bytes + tx.acked;
+    uint64_t busy, tx_us;
+    int n;
+
+    (void)arg;
+
+    if (err != ERR_OK || newpcb == NULL) {
+        return ERR_VAL;
+    }
+
+    /* A session still running counts up to now */
+    tx_us = tx.us + (tx.pcb != NULL ? now - tx.start_us : 0);
+    busy = (uint64_t)((now - stats_start_us) - (idle_us - stats_idle_us)) * CYCLES_PER_US;
+
+    n = snprintf(line, sizeof(line),
+                 "rx %lu bytes, checksum %lu bytes in %lu calls (%lu by DMA), %lu cycles/KB\r\n",
+                 (unsigned long)perf_rx_bytes, (unsigned long)bytes,
+                 (unsigned long)chksum_stats.calls, (unsigned long)chksum_stats.dma_bytes,
+                 bytes ? (unsigned long)(cycles * 1024 / bytes) : 0UL);
+    n += snprintf(line + n, sizeof(line) - n,
+                  "tx %lu bytes in %lu ms (%lu KB/s, %s), tcp_write %lu cycles/KB\r\n",
+                  (unsigned long)tx.acked, (unsigned long)(tx_us / 1000),
+                  tx_us ? (unsigned long)((uint64_t)tx.acked * 1000000 / 1024 / tx_us) : 0UL,
+                  tx.last_copy ? "copy" : "zero-copy",
+                  tx.queued ? (unsigned long)((uint64_t)tx.write_us * CYCLES_PER_US * 1024 / tx.queued) : 0UL);
+    n += snprintf(line + n, sizeof(line) - n,
+                  "cpu %lu.%02lu cycles/byte busy over %lu bytes\r\n",
+                  total ? (unsigned long)(busy / total) : 0UL,
+                  total ? (unsigned long)(busy * 100 / total % 100) : 0UL,
+                  (unsigned long)total);
+
+    perf_rx_bytes = 0;
+    memset(&chksum_stats, 0, sizeof(chksum_stats));
+    tx.queued = tx.acked = tx.us = tx.write_us = 0;
+    tx.start_us = now;
+    stats_start_us = now;
+    stats_idle_us = idle_us;
+
+    tcp_write(newpcb, line, (u16_t)n, TCP_WRITE_FLAG_COPY);
+    tcp_output(newpcb);
+    tcp_close(newpcb);
+
+    return ERR_OK;
+}
+
+static void stats_server_init(void)
+{
+    struct tcp_pcb *pcb;
+
+    pcb = tcp_new();
+    if (pcb == NULL || tcp_bind(pcb, IP_ADDR_ANY, STATS_PORT) != ERR_OK) {
+        return;     /* Perf server still works without it */
+    }
+
+    pcb = tcp_listen(pcb);
+    if (pcb != NULL) {
+        tcp_accept(pcb, stats_accept);
+    }
+}
+
 static void perf_server_init(void)
 {
     struct tcp_pcb *pcb;
@@ -108,12 +369,19 @@ static void network_init(void) {
     ip4addr_aton(NETMASK, &netmask);
     ip4addr_aton(GATEWAY_IP, &gw);
 
-    netif_add(&slip_netif, &ipaddr, &netmask, &gw, NULL, slipif_init, ip_input);
+    netif_add(&slip_netif, &ipaddr, &netmask, &gw, NULL, slip_hw_netif_init, ip_input);
     netif_set_default(&slip_netif);
     netif_set_up(&slip_netif);
 
-    /* Start performance server on port 5001 */
+    /* Start performance server on port 5001, statistics on 5002, transmit on 5003/5004 */
+    for (int i = 0; i < (int)sizeof(tx_pattern); i++) {
+        tx_pattern[i] = (u8_t)('0' + i % 10);
+    }
     perf_server_init();
+    stats_server_init();
+    tx_server_init(TX_PORT, 0);
+    tx_server_init(TX_COPY_PORT, TCP_WRITE_FLAG_COPY);
+    stats_start_us = timebase_us32();
 }
 
 //==============================================================================
@@ -123,10 +391,19 @@ static void network_init(void) {
 int main(void) {
     network_init();
 
-    /* Main loop: process lwIP timeouts and SLIP input */
+    /* Receive SLIP from the UART interrupt from here on */
+    slip_hw_start(&slip_netif);
+
+    /* Main loop: SLIP input and lwIP timeouts, asleep in between */
     while (1) {
+        uint32_t t0;
+
+        slip_hw_process(&slip_netif);
         sys_check_timeouts();
-        slipif_poll(&slip_netif);
+
+        t0 = timebase_us32();
+        slip_hw_wait_rx();
+        idle_us += timebase_us32() - t0;
     }
 
     return 0;
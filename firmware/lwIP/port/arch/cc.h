@@ -64,4 +64,23 @@ typedef u32_t       sys_prot_t;
  */
 #define BYTE_ORDER LITTLE_ENDIAN
 
+/*
+ * Checksum: memory DMA checksum mode for large buffers (chksum.c), the
+ * standard algorithm is still built as the fallback
+ */
+#define LWIP_CHKSUM             picorv32_chksum
+#define LWIP_CHKSUM_ALGORITHM   2
+
+u16_t picorv32_chksum(const void *dataptr, int len);
+
+/* Bytes and time spent in picorv32_chksum() since the last reset */
+struct chksum_stats {
+    u32_t calls;
+    u32_t bytes;
+    u32_t dma_bytes;        /* Summed by the DMA engine */
+    u32_t us;
+};
+
+extern struct chksum_stats chksum_stats;
+
 #endif /* LWIP_ARCH_CC_H */
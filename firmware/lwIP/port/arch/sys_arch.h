@@ -0,0 +1,31 @@
+/*
+ * lwIP OS Types for PicoRV32 on FreeRTOS (NO_SYS 0)
+ *
+ * Included by lwip/sys.h only when NO_SYS is 0; the functions are in
+ * sys_arch_freertos.c. Each object is its FreeRTOS handle, NULL while
+ * invalid.
+ *
+ * Copyright (c) October 2025 Michael Wolak
+ */
+
+#ifndef LWIP_ARCH_SYS_ARCH_H
+#define LWIP_ARCH_SYS_ARCH_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+
+typedef SemaphoreHandle_t   sys_sem_t;
+typedef SemaphoreHandle_t   sys_mutex_t;
+typedef QueueHandle_t       sys_mbox_t;
+typedef TaskHandle_t        sys_thread_t;
+
+#define sys_sem_valid(s)            (*(s) != NULL)
+#define sys_sem_set_invalid(s)      (*(s) = NULL)
+#define sys_mutex_valid(m)          (*(m) != NULL)
+#define sys_mutex_set_invalid(m)    (*(m) = NULL)
+#define sys_mbox_valid(mb)          (*(mb) != NULL)
+#define sys_mbox_set_invalid(mb)    (*(mb) = NULL)
+
+#endif /* LWIP_ARCH_SYS_ARCH_H */
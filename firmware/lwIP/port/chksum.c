@@ -0,0 +1,72 @@
+/*
+ * Internet checksum for lwIP on PicoRV32 (LWIP_CHKSUM, see arch/cc.h)
+ *
+ * Buffers of CHKSUM_DMA_MIN bytes or more are summed by the memory DMA
+ * engine in checksum mode (hdl/mem_dma.v, lib/dma.h dma_chksum()), which
+ * reads SRAM in bursts while the CPU waits on one status register. Only
+ * the word-aligned middle goes to the engine; the unaligned head and tail,
+ * short buffers, scratchpad data and bitstreams without the engine use
+ * lwIP's own lwip_standard_chksum() (LWIP_CHKSUM_ALGORITHM 2).
+ *
+ * The partial sums combine because the ones-complement sum does not care
+ * about order: a part that starts at an odd offset pairs its bytes the
+ * other way round, so its 16-bit sum is byte-swapped before adding.
+ *
+ * chksum_stats counts bytes and time spent here (timebase microseconds,
+ * always available unlike rdcycle) for the perf servers' statistics.
+ *
+ * Copyright (c) October 2025 Michael Wolak
+ */
+
+#include "lwip/opt.h"
+#include "lwip/def.h"
+#include <stdint.h>
+#include "../../../lib/dma.h"
+#include "../../../lib/timer.h"
+
+#ifndef CHKSUM_DMA_MIN
+#define CHKSUM_DMA_MIN  128     /* Below this the setup costs more than it saves */
+#endif
+
+/* inet_chksum.c, compiled because LWIP_CHKSUM_ALGORITHM is set */
+u16_t lwip_standard_chksum(const void *dataptr, int len);
+
+struct chksum_stats chksum_stats;
+
+static inline u32_t chksum_swap(u32_t sum)
+{
+    return ((sum & 0xFF) << 8) | ((sum >> 8) & 0xFF);
+}
+
+u16_t picorv32_chksum(const void *dataptr, int len)
+{
+    const u8_t *p = (const u8_t *)dataptr;
+    u32_t start = timebase_us32();
+    u32_t head, mid, sum;
+    u16_t result;
+
+    head = (0u - (u32_t)p) & 3;
+    mid = (len >= CHKSUM_DMA_MIN) ? ((u32_t)len - head) & ~3u : 0;
+    sum = 0;
+
+    if (mid && dma_chksum(p + head, mid, &sum)) {
+        u32_t part = dma_chksum_fold(sum);
+        u32_t tail = (u32_t)len - head - mid;
+
+        sum = lwip_standard_chksum(p, (int)head);
+        sum += (head & 1) ? chksum_swap(part) : part;
+        part = lwip_standard_chksum(p + head + mid, (int)tail);
+        sum += (head & 1) ? chksum_swap(part) : part;
+        result = dma_chksum_fold(sum);
+
+        chksum_stats.dma_bytes += mid;
+    } else {
+        result = lwip_standard_chksum(p, len);
+    }
+
+    chksum_stats.calls++;
+    chksum_stats.bytes += (u32_t)len;
+    chksum_stats.us += timebase_us32() - start;
+
+    return result;
+}
@@ -13,7 +13,19 @@ LWIP_INCLUDES = \
 	-I$(LWIP_PORT_DIR) \
 	-I$(LWIP_PORT_DIR)/arch
 
-# lwIP source files (NO_SYS mode - bare metal)
+# lwipopts profile: default (small buffers, debug on) or throughput
+# (lwipopts_throughput.h). Run 'make clean-lwip' after switching.
+LWIP_PROFILE ?= default
+ifeq ($(LWIP_PROFILE),throughput)
+LWIP_DEFINES = -DLWIP_PROFILE_THROUGHPUT
+LWIPOPTS_PROFILE_H = $(LWIP_PORT_DIR)/lwipopts_throughput.h
+else
+LWIP_DEFINES =
+LWIPOPTS_PROFILE_H = $(LWIP_PORT_DIR)/lwipopts.h
+endif
+
+# lwIP source files (NO_SYS mode - bare metal; with USE_FREERTOS=1 the
+# tcpip thread, netconn and socket API are added, see below)
 LWIP_CORE_SRCS = \
 	$(LWIP_DIR)/src/core/init.c \
 	$(LWIP_DIR)/src/core/def.c \
@@ -46,23 +58,75 @@ LWIP_IPV4_SRCS = \
 LWIP_NETIF_SRCS = \
 	$(LWIP_DIR)/src/netif/slipif.c
 
+ifeq ($(USE_FREERTOS),1)
+# NO_SYS 0: FreeRTOS sys_arch, slipif receives in its own thread
+LWIP_API_SRCS = \
+	$(LWIP_DIR)/src/api/api_lib.c \
+	$(LWIP_DIR)/src/api/api_msg.c \
+	$(LWIP_DIR)/src/api/err.c \
+	$(LWIP_DIR)/src/api/if_api.c \
+	$(LWIP_DIR)/src/api/netbuf.c \
+	$(LWIP_DIR)/src/api/netdb.c \
+	$(LWIP_DIR)/src/api/netifapi.c \
+	$(LWIP_DIR)/src/api/sockets.c \
+	$(LWIP_DIR)/src/api/tcpip.c
+
 LWIP_PORT_SRCS = \
+	$(LWIP_PORT_DIR)/chksum.c \
 	$(LWIP_PORT_DIR)/sio.c \
+	$(LWIP_PORT_DIR)/sys_arch_freertos.c
+
+# The raw-API apps below run from the NO_SYS main loop
+LWIP_APPS_SRCS =
+else
+LWIP_API_SRCS =
+
+LWIP_PORT_SRCS = \
+	$(LWIP_PORT_DIR)/chksum.c \
+	$(LWIP_PORT_DIR)/sio.c \
+	$(LWIP_PORT_DIR)/slip_hw_netif.c \
+	$(LWIP_PORT_DIR)/slip_vj.c \
 	$(LWIP_PORT_DIR)/sys_arch.c
 
 LWIP_APPS_SRCS = \
 	$(LWIP_DIR)/src/apps/lwiperf/lwiperf.c \
 	$(LWIP_DIR)/src/apps/http/httpd.c \
-	$(LWIP_DIR)/src/apps/http/fs.c
+	$(LWIP_DIR)/src/apps/http/fs.c \
+	$(LWIP_PORT_DIR)/static_httpd.c \
+	$(LWIP_PORT_DIR)/overlay_tcp.c \
+	$(LWIP_PORT_DIR)/mem_service.c
+endif
 
 # All lwIP sources
-LWIP_SRCS = $(LWIP_CORE_SRCS) $(LWIP_IPV4_SRCS) $(LWIP_NETIF_SRCS) $(LWIP_PORT_SRCS) $(LWIP_APPS_SRCS)
+LWIP_SRCS = $(LWIP_CORE_SRCS) $(LWIP_IPV4_SRCS) $(LWIP_NETIF_SRCS) $(LWIP_API_SRCS) $(LWIP_PORT_SRCS) $(LWIP_APPS_SRCS)
 
 # Object files
 LWIP_OBJS = $(LWIP_SRCS:.c=.o)
 
+# Both modes share the object files: a mode switch cleans them (as the
+# syscalls.o build mode in firmware/Makefile does)
+ifeq ($(USE_FREERTOS),1)
+LWIP_MODE = freertos
+else
+LWIP_MODE = nosys
+endif
+ifeq ($(wildcard $(LWIP_PORT_DIR)/.lwip_mode_$(LWIP_MODE)),)
+$(shell find $(LWIP_DIR) $(LWIP_PORT_DIR) -name "*.o" -type f -delete 2>/dev/null; \
+        rm -f $(LWIP_PORT_DIR)/.lwip_mode_*; touch $(LWIP_PORT_DIR)/.lwip_mode_$(LWIP_MODE))
+endif
+
 # Compiler flags for lwIP
-LWIP_CFLAGS = $(LWIP_INCLUDES)
+LWIP_CFLAGS = $(LWIP_INCLUDES) $(LWIP_DEFINES)
+
+# Telnet console (net_console.h): not in LWIP_OBJS, it needs microRL; a
+# demo that wants it adds this and the microRL sources to SOURCE_FILE
+NET_CONSOLE_SRC = $(LWIP_PORT_DIR)/net_console.c
+
+# Objects firmware/Makefile's lto profile (-Os) still builds at -O2: the
+# per-byte paths (checksum, SLIP framing, UART FIFO)
+LWIP_HOT_OBJS = $(LWIP_DIR)/src/core/inet_chksum.o $(LWIP_DIR)/src/netif/slipif.o \
+                $(LWIP_PORT_DIR)/sio.o
+OPT_HOT_OBJS += $(LWIP_HOT_OBJS)
 
 #===============================================================================
 # Build Rules
@@ -71,10 +135,10 @@ LWIP_CFLAGS = $(LWIP_INCLUDES)
 # Pattern rule for lwIP source compilation
 $(LWIP_DIR)/%.o: $(LWIP_DIR)/%.c
 	@echo "  CC (lwIP)  $<"
-	@$(CC) $(CFLAGS) $(LWIP_CFLAGS) -c $< -o $@
+	@$(CC) $(CFLAGS) $(FILE_CFLAGS) $(LWIP_CFLAGS) -c $< -o $@
 
 $(LWIP_PORT_DIR)/%.o: $(LWIP_PORT_DIR)/%.c
 	@echo "  CC (port)  $<"
-	@$(CC) $(CFLAGS) $(LWIP_CFLAGS) -c $< -o $@
+	@$(CC) $(CFLAGS) $(FILE_CFLAGS) $(LWIP_CFLAGS) -c $< -o $@
 
 # Clean lwIP objects - moved to main Makefile for better integration
@@ -4,35 +4,102 @@
  * NO_SYS = 1 (bare metal, no OS)
  * Uses SLIP interface over UART
  *
+ * With USE_FREERTOS (firmware/Makefile USE_FREERTOS=1 USE_LWIP=1):
+ * NO_SYS = 0, lwIP runs in its own tcpip thread (sys_arch_freertos.c),
+ * tasks use the netconn and socket APIs, slipif receives in a thread.
+ *
+ * Default profile: small buffers, debug output and statistics on.
+ * Build with LWIP_PROFILE=throughput to override the buffer, window and
+ * debug settings from lwipopts_throughput.h (values marked "profile").
+ *
  * Copyright (c) October 2025 Michael Wolak
  */
 
 #ifndef LWIP_LWIPOPTS_H
 #define LWIP_LWIPOPTS_H
 
+#ifdef LWIP_PROFILE_THROUGHPUT
+#include "lwipopts_throughput.h"
+#endif
+
 /*
  * NO_SYS==1: Bare metal (no OS/RTOS)
  * Must call sys_check_timeouts() periodically from main loop
  */
+#ifdef USE_FREERTOS
+#define NO_SYS                  0
+#else
 #define NO_SYS                  1
+#endif
 #define LWIP_TIMERS             1
 
 /*
  * Memory Configuration
- * Conservative settings for 512KB SRAM system
+ * Sizes come from the Kconfig "Networking (lwIP)" menu (CONFIG_LWIP_*,
+ * passed by firmware/Makefile); the fallbacks match its defaults
  */
 #define MEM_ALIGNMENT           4
+#ifndef MEM_SIZE                            /* profile */
+#ifdef CONFIG_LWIP_MEM_SIZE
+#define MEM_SIZE                CONFIG_LWIP_MEM_SIZE
+#else
 #define MEM_SIZE                (16*1024)   /* 16KB heap for lwIP */
+#endif
+#endif
 
+#ifndef MEMP_NUM_PBUF                       /* profile */
+#ifdef CONFIG_LWIP_MEMP_NUM_PBUF
+#define MEMP_NUM_PBUF           CONFIG_LWIP_MEMP_NUM_PBUF
+#else
 #define MEMP_NUM_PBUF           16          /* Protocol buffer pool */
+#endif
+#endif
+#ifdef CONFIG_LWIP_MEMP_NUM_UDP_PCB
+#define MEMP_NUM_UDP_PCB        CONFIG_LWIP_MEMP_NUM_UDP_PCB
+#else
 #define MEMP_NUM_UDP_PCB        4           /* UDP connections */
+#endif
+#ifdef CONFIG_LWIP_MEMP_NUM_TCP_PCB
+#define MEMP_NUM_TCP_PCB        CONFIG_LWIP_MEMP_NUM_TCP_PCB
+#else
 #define MEMP_NUM_TCP_PCB        8           /* TCP connections */
+#endif
 #define MEMP_NUM_TCP_PCB_LISTEN 4           /* TCP listen sockets */
+#ifndef MEMP_NUM_TCP_SEG                    /* profile */
+#ifdef CONFIG_LWIP_MEMP_NUM_TCP_SEG
+#define MEMP_NUM_TCP_SEG        CONFIG_LWIP_MEMP_NUM_TCP_SEG
+#else
 #define MEMP_NUM_TCP_SEG        16          /* TCP segments */
+#endif
+#endif
+#ifdef USE_FREERTOS
+#define MEMP_NUM_NETCONN        (MEMP_NUM_TCP_PCB + MEMP_NUM_TCP_PCB_LISTEN)
+#else
 #define MEMP_NUM_NETCONN        0           /* Not using netconn API */
+#endif
+#define MEMP_NUM_SYS_TIMEOUT    (LWIP_NUM_SYS_TIMEOUT_INTERNAL + 2) /* overlay_tcp EXEC, net_console */
 
+#ifndef PBUF_POOL_SIZE                      /* profile */
+#ifdef CONFIG_LWIP_PBUF_POOL_SIZE
+#define PBUF_POOL_SIZE          CONFIG_LWIP_PBUF_POOL_SIZE
+#define PBUF_POOL_BUFSIZE       CONFIG_LWIP_PBUF_POOL_BUFSIZE
+#else
 #define PBUF_POOL_SIZE          16          /* Packet buffer pool */
 #define PBUF_POOL_BUFSIZE       256         /* Size of each pbuf (low for SLIP) */
+#endif
+#endif
+
+#define LWIP_SUPPORT_CUSTOM_PBUF 1          /* mem_service.c static reply pbuf */
+
+/*
+ * Static pools and the lwIP heap each get their own input section,
+ * .bss.lwip.<name> (ram_heap, memp_memory_PBUF_POOL_base, ...), so the
+ * linker script can place one of them elsewhere: the Kconfig pbuf pool
+ * placement (scripts/gen_linker.sh). Unplaced ones still land in .bss.
+ */
+#define LWIP_DECLARE_MEMORY_ALIGNED(variable_name, size) \
+    u8_t variable_name[LWIP_MEM_ALIGN_BUFFER(size)] \
+    __attribute__((section(".bss.lwip." #variable_name)))
 
 /*
  * Protocol Features
@@ -49,9 +116,11 @@
 /*
  * TCP Configuration
  */
+#ifndef TCP_MSS                             /* profile */
 #define TCP_MSS                 536         /* Max segment size (conservative) */
 #define TCP_WND                 (2*TCP_MSS) /* TCP window (2 segments) */
 #define TCP_SND_BUF             (2*TCP_MSS) /* TCP send buffer */
+#endif
 #define TCP_SND_QUEUELEN        ((4 * (TCP_SND_BUF) + (TCP_MSS - 1)) / (TCP_MSS))
 #define TCP_LISTEN_BACKLOG      1           /* Enable listen backlog */
 #define LWIP_TCP_KEEPALIVE      1           /* Enable TCP keepalive */
@@ -66,25 +135,79 @@
  * SLIP Configuration
  */
 #define LWIP_HAVE_SLIPIF        1           /* Enable SLIP interface */
+#ifdef USE_FREERTOS
+#define SLIP_USE_RX_THREAD      1           /* sio_read() sleeps on the UART IRQ */
+#define SLIP_RX_FROM_ISR        0
+#define SLIP_RX_QUEUE           0
+#else
 #define SLIP_USE_RX_THREAD      0           /* NO_SYS, so no threads */
-#define SLIP_RX_FROM_ISR        0           /* Polling mode */
+#define SLIP_RX_FROM_ISR        1           /* Decode in the UART ISR (sio_rx_isr) */
+#define SLIP_RX_QUEUE           1           /* Queue whole frames for the main loop */
+#endif
+
+/*
+ * CSLIP: VJ header compression in slip_hw_netif.c (slip_vj.c, NO_SYS
+ * only). The adaptive mode answers slattach_1m -p cslip in kind and
+ * stays plain SLIP for -p slip.
+ */
+#define SLIP_VJ                 1
+#define SLIP_VJ_MODE            SLIP_VJ_AUTO
+
+/*
+ * The UART ISR allocates PBUF_POOL pbufs and queues frames, so pools and
+ * the SLIP RX queue need interrupt protection (sys_arch_protect)
+ */
+#define SYS_LIGHTWEIGHT_PROT    1
 
 /*
  * APIs
  */
+#ifdef USE_FREERTOS
+#include <sys/time.h>                       /* struct timeval from newlib */
+
+#define LWIP_NETCONN            1
+#define LWIP_SOCKET             1
+#define LWIP_COMPAT_SOCKETS     1           /* socket(), accept(), ... */
+#define LWIP_POSIX_SOCKETS_IO_NAMES 0       /* read()/write()/close() stay newlib's */
+#define LWIP_TIMEVAL_PRIVATE    0
+#define LWIP_ERRNO_STDINCLUDE   1           /* errno from newlib */
+#define LWIP_SOCKET_SELECT      0
+#define LWIP_SOCKET_POLL        0
+
+/*
+ * Threads (stack sizes in words, see sys_arch_freertos.c). The SLIP RX
+ * thread runs above tcpip so the UART FIFO is drained while TCP works.
+ */
+#define TCPIP_THREAD_NAME       "tcpip"
+#define TCPIP_THREAD_STACKSIZE  512
+#define TCPIP_THREAD_PRIO       (configMAX_PRIORITIES - 2)
+#define TCPIP_MBOX_SIZE         8
+#define SLIPIF_THREAD_NAME      "slipif"
+#define SLIPIF_THREAD_STACKSIZE 256
+#define SLIPIF_THREAD_PRIO      (configMAX_PRIORITIES - 1)
+#define DEFAULT_THREAD_STACKSIZE 384
+#define DEFAULT_ACCEPTMBOX_SIZE 4
+#define DEFAULT_TCP_RECVMBOX_SIZE 8
+#define DEFAULT_UDP_RECVMBOX_SIZE 4
+#else
 #define LWIP_NETCONN            0           /* Disable netconn API (not for NO_SYS) */
 #define LWIP_SOCKET             0           /* Disable BSD socket API (not for NO_SYS) */
+#endif
 
 /*
  * Statistics
  */
+#ifndef LWIP_STATS                          /* profile */
 #define LWIP_STATS              1           /* Enable statistics */
 #define LWIP_STATS_DISPLAY      1           /* Allow stats display */
+#endif
 
 /*
  * Debugging
  * Set to LWIP_DBG_ON to enable debug output
+ * (lwIP tests LWIP_DEBUG with #ifdef, so the profile leaves it undefined)
  */
+#ifndef LWIP_PROFILE_THROUGHPUT
 #define LWIP_DEBUG              1
 #define LWIP_DBG_MIN_LEVEL      LWIP_DBG_LEVEL_ALL
 #define LWIP_DBG_TYPES_ON       LWIP_DBG_ON
@@ -116,6 +239,7 @@
 #define TCPIP_DEBUG             LWIP_DBG_OFF
 #define SLIP_DEBUG              LWIP_DBG_ON
 #define DHCP_DEBUG              LWIP_DBG_OFF
+#endif /* !LWIP_PROFILE_THROUGHPUT */
 
 /*
  * Checksum Configuration
@@ -0,0 +1,47 @@
+/*
+ * lwIP Throughput Profile for PicoRV32 - TCP over 1 Mbaud SLIP
+ *
+ * Included by lwipopts.h when built with LWIP_PROFILE=throughput.
+ * Overrides only the values marked "profile" there; everything else
+ * (NO_SYS, SLIP receive from ISR, protocols) stays the same.
+ *
+ * A 1 Mbaud SLIP link moves ~100 KB/s, so a full-size 1500 byte packet
+ * takes ~15 ms on the wire. The default profile's 536 byte MSS spends 7%
+ * of every segment on headers, and its two-segment window leaves the
+ * sender idle while ACKs cross the link. Here the MSS fills the SLIP MTU
+ * and the window holds eight segments (one ~120 ms round trip of data),
+ * still below 64 KB, so window scaling stays off.
+ *
+ * The host side must match: sudo ifconfig sl0 mtu 1500
+ *
+ * Copyright (c) October 2025 Michael Wolak
+ */
+
+#ifndef LWIP_LWIPOPTS_THROUGHPUT_H
+#define LWIP_LWIPOPTS_THROUGHPUT_H
+
+/*
+ * TCP: MSS = 1500 byte SLIP MTU - 40 bytes IP/TCP headers
+ */
+#define TCP_MSS                 1460
+#define TCP_WND                 (8*TCP_MSS) /* 11680 bytes, no window scaling */
+#define TCP_SND_BUF             (8*TCP_MSS)
+#define LWIP_WND_SCALE          0
+
+/*
+ * Buffers: one pool pbuf holds a whole received packet, and the pool
+ * covers the receive window (lwIP checks PBUF_POOL_SIZE * payload >= TCP_WND)
+ */
+#define PBUF_POOL_SIZE          16
+#define PBUF_POOL_BUFSIZE       1536
+#define MEM_SIZE                (32*1024)   /* Send buffer segments (PBUF_RAM) */
+#define MEMP_NUM_PBUF           32
+#define MEMP_NUM_TCP_SEG        40          /* >= TCP_SND_QUEUELEN (33) */
+
+/*
+ * No debug output (the UART carries SLIP) and no statistics counters
+ */
+#define LWIP_STATS              0
+#define LWIP_STATS_DISPLAY      0
+
+#endif /* LWIP_LWIPOPTS_THROUGHPUT_H */
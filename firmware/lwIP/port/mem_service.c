@@ -0,0 +1,414 @@
+/*
+ * Memory peek/poke and stats service for lwIP (see mem_service.h)
+ *
+ * memsvc_recv() copies the request out of the pbuf chain, walks the
+ * operations and writes each result straight into the reply pbuf's
+ * payload. Nothing is allocated per request: the reply is one static
+ * custom pbuf, busy from pbuf_alloced_custom() until its free callback.
+ *
+ * Copyright (c) October 2025 Michael Wolak
+ */
+
+#include "lwip/opt.h"
+#include "lwip/udp.h"
+#include "lwip/pbuf.h"
+#include "lwip/sys.h"
+#include "lwip/stats.h"
+#include <stdint.h>
+#include <string.h>
+#include "mem_service.h"
+#include "../../../lib/perf_counters.h"
+
+#if !LWIP_SUPPORT_CUSTOM_PBUF
+#error "mem_service.c needs LWIP_SUPPORT_CUSTOM_PBUF (lwipopts.h)"
+#endif
+
+#define MEMSVC_HEADROOM         LWIP_MEM_ALIGN_SIZE(PBUF_LINK_ENCAPSULATION_HLEN + PBUF_LINK_HLEN + \
+                                                    PBUF_IP_HLEN + PBUF_TRANSPORT_HLEN)
+
+#define MEMSVC_PMU_BASE         0x80000080u
+#define MEMSVC_PMU_WORDS        16
+
+/* Linker symbols (scripts/gen_linker.sh) */
+extern uint8_t __fastram_end[];
+
+struct memsvc_object {
+    const char *name;                   /* NULL: slot free */
+    void *data;
+    u16_t len;
+    memsvc_update_fn update;
+};
+
+struct memsvc_region {
+    u32_t base;
+    u32_t len;                          /* 0: slot free */
+    u8_t flags;
+};
+
+/* The reply pbuf and its buffer: the headers go in front of the payload */
+static struct {
+    struct pbuf_custom pc;
+    u8_t mem[MEMSVC_HEADROOM + MEMSVC_MAX_REPLY];
+} reply;
+static volatile u8_t reply_busy;
+
+static u8_t req[MEMSVC_MAX_REQ] __attribute__((aligned(4)));
+static struct memsvc_object objects[MEMSVC_OBJECTS];
+static struct memsvc_region regions[MEMSVC_REGIONS];
+static struct udp_pcb *svc_pcb;
+static u32_t svc_key;
+
+static struct memsvc_cpu cpu_stats;
+static u32_t pmu_regs[MEMSVC_PMU_WORDS];
+
+/*
+ * Little-endian fields (the CPU is little-endian; buffers are not aligned)
+ */
+
+static u16_t get16(const u8_t *p)
+{
+    return (u16_t)(p[0] | (p[1] << 8));
+}
+
+static u32_t get32(const u8_t *p)
+{
+    return (u32_t)p[0] | ((u32_t)p[1] << 8) | ((u32_t)p[2] << 16) | ((u32_t)p[3] << 24);
+}
+
+static void put16(u8_t *p, u16_t v)
+{
+    p[0] = (u8_t)v;
+    p[1] = (u8_t)(v >> 8);
+}
+
+static void put32(u8_t *p, u32_t v)
+{
+    put16(p, (u16_t)v);
+    put16(p + 2, (u16_t)(v >> 16));
+}
+
+/*
+ * Built-in objects
+ */
+
+static void cpu_update(void *data)
+{
+    struct memsvc_cpu *c = (struct memsvc_cpu *)data;
+
+    c->cycles = rdcycle();
+    c->instret = rdinstret();
+    c->uptime_ms = sys_now();
+}
+
+static void pmu_update(void *data)
+{
+    volatile const u32_t *pmu = (volatile const u32_t *)MEMSVC_PMU_BASE;
+    u32_t *regs = (u32_t *)data;
+    int i;
+
+    for (i = 0; i < MEMSVC_PMU_WORDS; i++) {
+        regs[i] = pmu[i];
+    }
+}
+
+/*
+ * Memory access
+ */
+
+/* Region holding all of [addr, addr + len), NULL if none */
+static const struct memsvc_region *region_find(u32_t addr, u32_t len)
+{
+    int i;
+
+    for (i = 0; i < MEMSVC_REGIONS; i++) {
+        const struct memsvc_region *r = &regions[i];
+
+        if (r->len && addr >= r->base && len <= r->len && addr - r->base <= r->len - len) {
+            return r;
+        }
+    }
+
+    return NULL;
+}
+
+/* Word loads and stores where both sides allow, so MMIO sees 32-bit accesses */
+static void mem_copy(u8_t *dst, const u8_t *src, u32_t len)
+{
+    if ((((uintptr_t)dst | (uintptr_t)src) & 3) == 0) {
+        for (; len >= 4; len -= 4, dst += 4, src += 4) {
+            *(volatile u32_t *)dst = *(volatile const u32_t *)src;
+        }
+    }
+    for (; len; len--) {
+        *(volatile u8_t *)dst++ = *(volatile const u8_t *)src++;
+    }
+}
+
+static u8_t check_access(u32_t addr, u32_t len, u8_t need)
+{
+    const struct memsvc_region *r = region_find(addr, len);
+
+    if (r == NULL) {
+        return MEMSVC_E_RANGE;
+    }
+    if ((r->flags & need) != need) {
+        return MEMSVC_E_ACCESS;
+    }
+    if ((r->flags & MEMSVC_WORD) && ((addr | len) & 3)) {
+        return MEMSVC_E_RANGE;
+    }
+    return MEMSVC_OK;
+}
+
+/*
+ * Request handling
+ */
+
+/* Run the batch in req[0..len); returns the reply length */
+static u16_t memsvc_handle(u8_t *out, u16_t len)
+{
+    u16_t in_pos = MEMSVC_HDR_LEN, out_pos = MEMSVC_HDR_LEN;
+    u8_t count = req[7];
+    u8_t n;
+    int full = 0;
+
+    memcpy(out, req, 8);
+    out[6] = MEMSVC_F_REPLY;
+    put32(out + 8, 0);
+
+    for (n = 0; n < count; n++) {
+        u8_t op, id, status = MEMSVC_OK;
+        u16_t op_len, data_len = 0;
+        u32_t addr;
+        u8_t *res = out + out_pos;
+        u8_t *data = res + MEMSVC_OP_LEN;
+        u16_t room;
+
+        if (out_pos + MEMSVC_OP_LEN > MEMSVC_MAX_REPLY) {
+            break;                      /* Not even the result header fits */
+        }
+        room = MEMSVC_MAX_REPLY - out_pos - MEMSVC_OP_LEN;
+
+        if (in_pos + MEMSVC_OP_LEN > len) {
+            break;                      /* Truncated: the reply count says how many ran */
+        }
+        op = req[in_pos];
+        id = req[in_pos + 1];
+        op_len = get16(req + in_pos + 2);
+        addr = get32(req + in_pos + 4);
+        in_pos += MEMSVC_OP_LEN;
+
+        switch (op) {
+        case MEMSVC_READ:
+            if (full || op_len > room) {
+                status = MEMSVC_E_FULL;
+            } else if ((status = check_access(addr, op_len, MEMSVC_R)) == MEMSVC_OK) {
+                mem_copy(data, (const u8_t *)(uintptr_t)addr, op_len);
+                data_len = op_len;
+            }
+            break;
+
+        case MEMSVC_WRITE:
+            if (in_pos + op_len > len) {
+                status = MEMSVC_E_INVAL;
+                in_pos = len;
+                break;
+            }
+            if (full) {
+                status = MEMSVC_E_FULL;
+            } else if (svc_key == 0 || get32(req + 8) != svc_key) {
+                status = MEMSVC_E_ACCESS;
+            } else if ((status = check_access(addr, op_len, MEMSVC_W)) == MEMSVC_OK) {
+                mem_copy((u8_t *)(uintptr_t)addr, req + in_pos, op_len);
+            }
+            in_pos += (op_len + 3) & ~3u;
+            break;
+
+        case MEMSVC_STAT:
+            if (id >= MEMSVC_OBJECTS || objects[id].name == NULL) {
+                status = MEMSVC_E_NOENT;
+            } else if (full || objects[id].len > room) {
+                status = MEMSVC_E_FULL;
+            } else {
+                if (objects[id].update != NULL) {
+                    objects[id].update(objects[id].data);
+                }
+                memcpy(data, objects[id].data, objects[id].len);
+                data_len = objects[id].len;
+                addr = (u32_t)(uintptr_t)objects[id].data;
+            }
+            break;
+
+        case MEMSVC_LIST:
+        {
+            u8_t i;
+
+            for (i = 0; i < MEMSVC_OBJECTS; i++) {
+                u8_t *e = data + data_len;
+
+                if (objects[i].name == NULL) {
+                    continue;
+                }
+                if (full || data_len + 4 + MEMSVC_NAME_LEN > room) {
+                    status = MEMSVC_E_FULL;
+                    data_len = 0;
+                    break;
+                }
+                e[0] = i;
+                e[1] = 0;
+                put16(e + 2, objects[i].len);
+                memset(e + 4, 0, MEMSVC_NAME_LEN);
+                strncpy((char *)e + 4, objects[i].name, MEMSVC_NAME_LEN - 1);
+                data_len += 4 + MEMSVC_NAME_LEN;
+            }
+            break;
+        }
+
+        default:
+            status = MEMSVC_E_INVAL;
+            in_pos = len;               /* Cannot find the next operation */
+            break;
+        }
+
+        /* Results are not reordered: once one does not fit, none after it is run */
+        if (status == MEMSVC_E_FULL) {
+            full = 1;
+        }
+
+        res[0] = op;
+        res[1] = status;
+        put16(res + 2, data_len);
+        put32(res + 4, addr);
+        if (data_len & 3) {
+            memset(data + data_len, 0, 4 - (data_len & 3));
+        }
+        out_pos += MEMSVC_OP_LEN + ((data_len + 3) & ~3u);
+    }
+
+    out[7] = n;
+    return out_pos;
+}
+
+static void memsvc_reply_free(struct pbuf *p)
+{
+    (void)p;
+    reply_busy = 0;
+}
+
+static void memsvc_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p,
+                        const ip_addr_t *addr, u16_t port)
+{
+    struct pbuf *r;
+    u16_t len, out_len;
+
+    (void)arg;
+
+    if (p == NULL) {
+        return;
+    }
+    len = p->tot_len;
+    if (len < MEMSVC_HDR_LEN || len > MEMSVC_MAX_REQ || reply_busy) {
+        pbuf_free(p);
+        cpu_stats.dropped++;
+        return;
+    }
+    pbuf_copy_partial(p, req, len, 0);
+    pbuf_free(p);
+
+    if (get32(req) != MEMSVC_MAGIC || (req[6] & MEMSVC_F_REPLY)) {
+        cpu_stats.dropped++;
+        return;
+    }
+
+    /* The payload starts at mem + MEMSVC_HEADROOM, whatever length is asked */
+    out_len = memsvc_handle(reply.mem + MEMSVC_HEADROOM, len);
+
+    reply_busy = 1;
+    reply.pc.custom_free_function = memsvc_reply_free;
+    r = pbuf_alloced_custom(PBUF_TRANSPORT, out_len, PBUF_RAM, &reply.pc,
+                            reply.mem, sizeof(reply.mem));
+    if (r == NULL) {
+        reply_busy = 0;
+        cpu_stats.dropped++;
+        return;
+    }
+
+    udp_sendto(pcb, r, addr, port);
+    pbuf_free(r);
+    cpu_stats.requests++;
+}
+
+/*
+ * Public interface
+ */
+
+int memsvc_register(const char *name, void *data, u16_t len, memsvc_update_fn update)
+{
+    int i;
+
+    if (len > MEMSVC_MAX_REPLY - MEMSVC_HDR_LEN - MEMSVC_OP_LEN) {
+        return -1;
+    }
+    for (i = 0; i < MEMSVC_OBJECTS; i++) {
+        if (objects[i].name == NULL) {
+            objects[i].data = data;
+            objects[i].len = len;
+            objects[i].update = update;
+            objects[i].name = name;
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+int memsvc_add_region(u32_t base, u32_t len, u8_t flags)
+{
+    int i;
+
+    for (i = 0; i < MEMSVC_REGIONS; i++) {
+        if (regions[i].len == 0) {
+            regions[i].base = base;
+            regions[i].flags = flags;
+            regions[i].len = len;
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+err_t memsvc_init(u16_t port, u32_t key)
+{
+    err_t err;
+
+    svc_key = key;
+
+    /* Ids MEMSVC_OBJ_CPU, _PMU, _LWIP in this order */
+    if (objects[0].name == NULL) {
+        memsvc_register("cpu", &cpu_stats, sizeof(cpu_stats), cpu_update);
+        memsvc_register("pmu", pmu_regs, sizeof(pmu_regs), pmu_update);
+#if LWIP_STATS
+        memsvc_register("lwip", &lwip_stats, sizeof(lwip_stats), NULL);
+#endif
+        memsvc_add_region(0x00000000u, 0x00080000u, MEMSVC_R | MEMSVC_W);
+        memsvc_add_region(0x00080000u, (u32_t)(uintptr_t)__fastram_end - 0x00080000u,
+                          MEMSVC_R | MEMSVC_W);
+        memsvc_add_region(MEMSVC_PMU_BASE, MEMSVC_PMU_WORDS * 4, MEMSVC_R | MEMSVC_W | MEMSVC_WORD);
+    }
+
+    svc_pcb = udp_new();
+    if (svc_pcb == NULL) {
+        return ERR_MEM;
+    }
+
+    err = udp_bind(svc_pcb, IP_ADDR_ANY, port);
+    if (err != ERR_OK) {
+        udp_remove(svc_pcb);
+        svc_pcb = NULL;
+        return err;
+    }
+
+    udp_recv(svc_pcb, memsvc_recv, NULL);
+    return ERR_OK;
+}
@@ -0,0 +1,120 @@
+/*
+ * Memory peek/poke and stats service for lwIP (raw UDP API)
+ *
+ * One datagram carries a batch of operations, and the reply has the
+ * results in the same order, so a host can collect a board's counters and
+ * buffers in one round trip (tools/memsvc queries many boards at once):
+ *
+ *   READ  addr len      bytes from memory (word loads when aligned)
+ *   WRITE addr len data bytes to memory (needs the write key)
+ *   STAT  id            a registered object: PMU counters, lwIP stats,
+ *                       anything the firmware adds with memsvc_register()
+ *   LIST                the object table: id, size and name of each
+ *
+ * Addresses are checked against a region table: SRAM and the scratchpad
+ * read/write, the PMU (0x80000080) as the only MMIO block, since reading
+ * other peripherals can pop FIFOs. memsvc_add_region() adds more.
+ *
+ * Requests are copied into a static buffer and the reply is built in a
+ * static custom pbuf (LWIP_SUPPORT_CUSTOM_PBUF) with room for the UDP and
+ * IP headers, so a request takes nothing from the lwIP heap or pools; the
+ * netif sends the reply before udp_sendto() returns. A request that arrives
+ * while the reply buffer is still held is dropped.
+ *
+ *   memsvc_init(MEMSVC_PORT, 0x5EC12E7u);  // Write key, 0: read-only
+ *   memsvc_register("echo", &echo_stats, sizeof(echo_stats), NULL);
+ *
+ * Wire format, all fields little-endian:
+ *
+ *   request  hdr { u32 magic; u16 seq; u8 flags; u8 count; u32 key; }
+ *            count x op { u8 op; u8 id; u16 len; u32 addr; }
+ *                   WRITE: then len data bytes, padded to 4
+ *   reply    hdr (flags MEMSVC_F_REPLY, key 0)
+ *            count x op { u8 op; u8 status; u16 len; u32 addr; }
+ *                   then len data bytes, padded to 4
+ *
+ * Once the reply is full the remaining operations return MEMSVC_E_FULL
+ * with no data; the host sends them again in the next batch.
+ *
+ * Copyright (c) October 2025 Michael Wolak
+ */
+
+#ifndef MEM_SERVICE_H
+#define MEM_SERVICE_H
+
+#include "lwip/opt.h"
+#include "lwip/err.h"
+
+#define MEMSVC_PORT             7780
+
+#ifndef MEMSVC_MAX_REQ
+#define MEMSVC_MAX_REQ          512     /* Request bytes (larger ones are dropped) */
+#endif
+
+#ifndef MEMSVC_MAX_REPLY
+#define MEMSVC_MAX_REPLY        1024    /* Reply bytes, at most MTU - 28 */
+#endif
+
+#ifndef MEMSVC_OBJECTS
+#define MEMSVC_OBJECTS          8       /* STAT objects, built-in ones included */
+#endif
+
+#ifndef MEMSVC_REGIONS
+#define MEMSVC_REGIONS          6       /* Address regions, built-in ones included */
+#endif
+
+#define MEMSVC_MAGIC            0x3156534Du    /* "MSV1" */
+#define MEMSVC_F_REPLY          0x01
+
+#define MEMSVC_HDR_LEN          12
+#define MEMSVC_OP_LEN           8
+#define MEMSVC_NAME_LEN         12      /* LIST entry: u8 id; u8 0; u16 len; name */
+
+/* Operations */
+#define MEMSVC_READ             1
+#define MEMSVC_WRITE            2
+#define MEMSVC_STAT             3
+#define MEMSVC_LIST             4
+
+/* Per-operation status */
+#define MEMSVC_OK               0
+#define MEMSVC_E_RANGE          1       /* Address range not in the region table */
+#define MEMSVC_E_ACCESS         2       /* Write: region read-only or wrong key */
+#define MEMSVC_E_NOENT          3       /* STAT: no such object */
+#define MEMSVC_E_FULL           4       /* No room left in the reply */
+#define MEMSVC_E_INVAL          5       /* Unknown operation, truncated request */
+
+/* Region flags */
+#define MEMSVC_R                0x01
+#define MEMSVC_W                0x02
+#define MEMSVC_WORD             0x04    /* Aligned 32-bit accesses only (MMIO) */
+
+/* Built-in objects */
+#define MEMSVC_OBJ_CPU          0       /* struct memsvc_cpu */
+#define MEMSVC_OBJ_PMU          1       /* The 16 PMU registers (hdl/perf_monitor.v) */
+#define MEMSVC_OBJ_LWIP         2       /* struct stats_ (LWIP_STATS) */
+
+struct memsvc_cpu {
+    u32_t cycles;                       /* rdcycle (CONFIG_ENABLE_COUNTERS) */
+    u32_t instret;
+    u32_t uptime_ms;                    /* sys_now() */
+    u32_t requests;                     /* Requests answered */
+    u32_t dropped;                      /* Bad, oversized or while busy */
+};
+
+/*
+ * Refresh before a STAT reply (NULL: the object is copied as it is). Runs
+ * in the lwIP context, so it must not block.
+ */
+typedef void (*memsvc_update_fn)(void *data);
+
+/* Bind the UDP port; key 0 refuses every WRITE */
+err_t memsvc_init(u16_t port, u32_t key);
+
+/* Add a STAT object; returns its id, or -1 when the table is full */
+int memsvc_register(const char *name, void *data, u16_t len, memsvc_update_fn update);
+
+/* Allow another address range (flags MEMSVC_R/W/WORD); -1 when full */
+int memsvc_add_region(u32_t base, u32_t len, u8_t flags);
+
+#endif /* MEM_SERVICE_H */
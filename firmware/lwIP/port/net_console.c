@@ -0,0 +1,384 @@
+/*
+ * Network console for lwIP (see net_console.h)
+ *
+ * Output: net_console_write() only copies into the ring and decides when
+ * to send. A full MSS goes out at once; anything less arms a one-shot
+ * sys_timeout() that sends whatever has gathered by then. The ring is
+ * handed to tcp_write() in contiguous pieces (two at the wrap), and one
+ * tcp_output() follows. tcp_sent() continues when the send buffer was
+ * the limit.
+ *
+ * Input: a minimal telnet NVT. The console offers WILL ECHO and WILL SGA,
+ * so the client sends characters as they are typed and leaves echoing to
+ * microRL. Other options are refused, subnegotiations skipped, and CR NUL
+ * and CR LF arrive as one CR. Ctrl-D closes the connection.
+ *
+ * Copyright (c) October 2025 Michael Wolak
+ */
+
+#include "lwip/opt.h"
+#include "lwip/tcp.h"
+#include "lwip/timeouts.h"
+#include <string.h>
+#include "net_console.h"
+#include "../../../lib/syscalls_fs.h"
+
+#if (NET_CONSOLE_BUF & (NET_CONSOLE_BUF - 1)) != 0
+#error "NET_CONSOLE_BUF must be a power of 2"
+#endif
+#define NC_MASK                 (NET_CONSOLE_BUF - 1)
+
+/* Telnet (RFC 854, 857, 858) */
+#define TN_SE                   240
+#define TN_SB                   250
+#define TN_WILL                 251
+#define TN_WONT                 252
+#define TN_DO                   253
+#define TN_DONT                 254
+#define TN_IAC                  255
+#define TN_OPT_ECHO             1
+#define TN_OPT_SGA              3
+
+#define NC_CTRL_D               0x04
+
+enum nc_rx_state {
+    NC_RX_DATA,
+    NC_RX_CR,                           /* After CR: drop a following LF or NUL */
+    NC_RX_IAC,
+    NC_RX_OPT,                          /* After WILL/WONT/DO/DONT */
+    NC_RX_SB,
+    NC_RX_SB_IAC
+};
+
+static struct {
+    struct tcp_pcb *pcb;                /* Client, NULL if none */
+    u32_t head;                         /* Free-running ring indexes */
+    u32_t tail;
+    char last;                          /* For the LF -> CR LF rule */
+    u8_t timer_armed;
+    u8_t sending;                       /* nc_send() running: queue only */
+    u8_t in_recv;                       /* Running commands from nc_recv() */
+    u8_t closing;                       /* Ctrl-D or "exit" there: close after the input */
+    u8_t rx_state;
+    u8_t rx_verb;
+    microrl_t mrl;
+    mrl_cmd_table_t shell;
+    net_console_stats_t stats;
+} nc;
+
+static char nc_ring[NET_CONSOLE_BUF];
+
+static void nc_put(char c)
+{
+    if (nc.head - nc.tail == NET_CONSOLE_BUF) {
+        if (nc.pcb != NULL) {
+            nc.stats.dropped++;
+            return;
+        }
+        nc.tail++;                      /* Backlog: keep the newest */
+    }
+    nc_ring[nc.head++ & NC_MASK] = c;
+}
+
+static void nc_send(void)
+{
+    struct tcp_pcb *pcb = nc.pcb;
+    int queued = 0;
+
+    if (pcb == NULL || nc.sending) {
+        return;
+    }
+    nc.sending = 1;
+
+    while (nc.head != nc.tail) {
+        u32_t pending = nc.head - nc.tail;
+        u32_t off = nc.tail & NC_MASK;
+        u32_t n = LWIP_MIN(pending, NET_CONSOLE_BUF - off);
+
+        n = LWIP_MIN(n, tcp_sndbuf(pcb));
+        if (n == 0 || tcp_sndqueuelen(pcb) >= TCP_SND_QUEUELEN) {
+            break;
+        }
+        if (tcp_write(pcb, &nc_ring[off], (u16_t)n,
+                      TCP_WRITE_FLAG_COPY | (n < pending ? TCP_WRITE_FLAG_MORE : 0)) != ERR_OK) {
+            break;
+        }
+        nc.tail += n;
+        nc.stats.bytes_out += n;
+        queued = 1;
+    }
+
+    if (queued) {
+        nc.stats.segments++;
+        tcp_output(pcb);
+    }
+    nc.sending = 0;
+}
+
+static void nc_flush_timeout(void *arg)
+{
+    (void)arg;
+    nc.timer_armed = 0;
+    nc_send();
+}
+
+/* A full segment now, a partial one when the coalescing timer runs out */
+static void nc_kick(void)
+{
+    if (nc.pcb == NULL || nc.head == nc.tail) {
+        return;
+    }
+    if (nc.head - nc.tail >= tcp_mss(nc.pcb)) {
+        nc_send();
+    }
+    if (nc.head != nc.tail && !nc.timer_armed) {
+        nc.timer_armed = 1;
+        sys_timeout(NET_CONSOLE_COALESCE_MS, nc_flush_timeout, NULL);
+    }
+}
+
+void net_console_write(const char *ptr, int len)
+{
+    nc.stats.writes++;
+    for (int i = 0; i < len; i++) {
+        char c = ptr[i];
+
+        if (c == '\n' && nc.last != '\r') {
+            nc_put('\r');
+        }
+        nc_put(c);
+        nc.last = c;
+    }
+    nc_kick();
+}
+
+void net_console_puts(const char *s)
+{
+    net_console_write(s, (int)strlen(s));
+}
+
+static int nc_microrl_out(microrl_t *mrl, const char *str)
+{
+    (void)mrl;
+    net_console_puts(str);
+    return 0;
+}
+
+static void nc_telnet_cmd(u8_t verb, u8_t opt)
+{
+    nc_put((char)TN_IAC);
+    nc_put((char)verb);
+    nc_put((char)opt);
+}
+
+static void nc_detach(struct tcp_pcb *pcb)
+{
+    tcp_arg(pcb, NULL);
+    tcp_recv(pcb, NULL);
+    tcp_sent(pcb, NULL);
+    tcp_err(pcb, NULL);
+    nc.pcb = NULL;
+}
+
+/* 1 if the pcb had to be aborted */
+static int nc_close_pcb(struct tcp_pcb *pcb)
+{
+    nc_send();
+    nc_detach(pcb);
+    if (tcp_close(pcb) != ERR_OK) {
+        tcp_abort(pcb);
+        return 1;
+    }
+    return 0;
+}
+
+void net_console_close(void)
+{
+    /* From a command: the receive callback closes once the line is done */
+    if (nc.in_recv) {
+        nc.closing = 1;
+    } else if (nc.pcb != NULL) {
+        nc_close_pcb(nc.pcb);
+    }
+}
+
+int net_console_connected(void)
+{
+    return nc.pcb != NULL;
+}
+
+const net_console_stats_t *net_console_stats(void)
+{
+    return &nc.stats;
+}
+
+static void nc_err(void *arg, err_t err)
+{
+    (void)arg;
+    (void)err;
+    nc.pcb = NULL;                      /* Already freed by lwIP */
+}
+
+static err_t nc_sent(void *arg, struct tcp_pcb *pcb, u16_t len)
+{
+    (void)arg;
+    (void)pcb;
+    (void)len;
+    nc_send();
+    return ERR_OK;
+}
+
+static void nc_rx_byte(u8_t c)
+{
+    switch (nc.rx_state) {
+    case NC_RX_CR:
+        nc.rx_state = NC_RX_DATA;
+        if (c == '\n' || c == '\0') {
+            break;
+        }
+        /* fall through */
+    case NC_RX_DATA:
+        if (c == TN_IAC) {
+            nc.rx_state = NC_RX_IAC;
+        } else if (c == NC_CTRL_D) {
+            nc.closing = 1;
+        } else {
+            if (c == '\r') {
+                nc.rx_state = NC_RX_CR;
+            }
+            microrl_processing_input(&nc.mrl, &c, 1);
+        }
+        break;
+    case NC_RX_IAC:
+        if (c == TN_IAC) {
+            nc.rx_state = NC_RX_DATA;
+            microrl_processing_input(&nc.mrl, &c, 1);
+        } else if (c >= TN_WILL) {
+            nc.rx_verb = c;
+            nc.rx_state = NC_RX_OPT;
+        } else {
+            nc.rx_state = (c == TN_SB) ? NC_RX_SB : NC_RX_DATA;
+        }
+        break;
+    case NC_RX_OPT:
+        /* Refuse what was not offered; answering WONT/DONT could loop */
+        if (nc.rx_verb == TN_DO && c != TN_OPT_ECHO && c != TN_OPT_SGA) {
+            nc_telnet_cmd(TN_WONT, c);
+        } else if (nc.rx_verb == TN_WILL && c != TN_OPT_SGA) {
+            nc_telnet_cmd(TN_DONT, c);
+        }
+        nc.rx_state = NC_RX_DATA;
+        break;
+    case NC_RX_SB:
+        if (c == TN_IAC) {
+            nc.rx_state = NC_RX_SB_IAC;
+        }
+        break;
+    case NC_RX_SB_IAC:
+        nc.rx_state = (c == TN_SE) ? NC_RX_DATA : NC_RX_SB;
+        break;
+    }
+}
+
+static err_t nc_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
+{
+    (void)arg;
+
+    if (p == NULL) {
+        return nc_close_pcb(pcb) ? ERR_ABRT : ERR_OK;
+    }
+    if (err != ERR_OK) {
+        pbuf_free(p);
+        return err;
+    }
+
+    /* Window first: closing with unacknowledged input would send RST */
+    tcp_recved(pcb, p->tot_len);
+    nc.stats.bytes_in += p->tot_len;
+
+    nc.in_recv = 1;
+    for (struct pbuf *q = p; q != NULL && !nc.closing; q = q->next) {
+        const u8_t *b = (const u8_t *)q->payload;
+
+        for (u16_t i = 0; i < q->len && !nc.closing; i++) {
+            nc_rx_byte(b[i]);
+        }
+    }
+    pbuf_free(p);
+    nc.in_recv = 0;
+
+    if (nc.closing) {
+        return nc_close_pcb(pcb) ? ERR_ABRT : ERR_OK;
+    }
+    nc_kick();
+    return ERR_OK;
+}
+
+static err_t nc_accept(void *arg, struct tcp_pcb *newpcb, err_t err)
+{
+    /* Character mode: the console echoes, no go-aheads either way */
+    static const u8_t negotiate[] = {
+        TN_IAC, TN_WILL, TN_OPT_ECHO,
+        TN_IAC, TN_WILL, TN_OPT_SGA,
+        TN_IAC, TN_DO, TN_OPT_SGA
+    };
+
+    (void)arg;
+
+    if (err != ERR_OK || newpcb == NULL) {
+        return ERR_VAL;
+    }
+    if (nc.pcb != NULL) {
+        tcp_abort(newpcb);              /* One console at a time */
+        return ERR_ABRT;
+    }
+
+    nc.pcb = newpcb;
+    nc.closing = 0;
+    nc.rx_state = NC_RX_DATA;
+    nc.stats.connects++;
+
+    /* The coalescing timer groups output, Nagle would only add an RTT */
+    tcp_nagle_disable(newpcb);
+    tcp_arg(newpcb, NULL);
+    tcp_recv(newpcb, nc_recv);
+    tcp_sent(newpcb, nc_sent);
+    tcp_err(newpcb, nc_err);
+
+    /* Negotiation, the backlog (making room in the ring), a fresh prompt */
+    tcp_write(newpcb, negotiate, sizeof(negotiate), TCP_WRITE_FLAG_COPY);
+    nc_send();
+    microrl_init(&nc.mrl, nc_microrl_out, mrl_cmd_microrl_exec);
+    mrl_cmd_attach(&nc.shell, &nc.mrl);
+    nc_kick();
+
+    return ERR_OK;
+}
+
+err_t net_console_init(const mrl_cmd_t *cmds, int count, u16_t port)
+{
+    struct tcp_pcb *pcb;
+    err_t err;
+
+    if (mrl_cmd_init(&nc.shell, cmds, count, net_console_puts) != 0) {
+        return ERR_ARG;
+    }
+
+    pcb = tcp_new();
+    if (pcb == NULL) {
+        return ERR_MEM;
+    }
+    err = tcp_bind(pcb, IP_ADDR_ANY, port);
+    if (err != ERR_OK) {
+        tcp_close(pcb);
+        return err;
+    }
+    pcb = tcp_listen(pcb);
+    if (pcb == NULL) {
+        return ERR_MEM;
+    }
+    tcp_accept(pcb, nc_accept);
+
+    syscalls_set_stdout(net_console_write, NET_CONSOLE_UART_TOO);
+    return ERR_OK;
+}
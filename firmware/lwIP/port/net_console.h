@@ -0,0 +1,86 @@
+/*
+ * Network console for lwIP (NO_SYS, raw TCP API): telnet to a microRL shell
+ *
+ * The UART carries SLIP once the stack runs, so printf() and the shell
+ * need another way out. net_console_init() takes stdout and stderr over
+ * (syscalls_set_stdout(), lib/syscalls_fs.h) and listens for one telnet
+ * client, whose keystrokes go to a microRL prompt on the firmware's
+ * command table (lib/microrl/microrl_cmd.h).
+ *
+ * Output is collected in a ring and sent in as few segments as it takes:
+ * at once when a full MSS is waiting, otherwise when NET_CONSOLE_COALESCE_MS
+ * has passed since the first unsent byte. A burst of printf() calls costs
+ * one segment instead of one each. With Nagle off the delay is bounded by
+ * the timer, not by the peer's delayed ACK. Without a client the ring
+ * keeps the latest output, which the next client receives on connect.
+ * When the ring fills while a client is connected, new output is dropped
+ * and counted, so printf() never waits for the network.
+ *
+ *   static const mrl_cmd_t cmds[] = {
+ *       { "stats", cmd_stats, "stats               - lwIP counters" },
+ *       { "exit",  cmd_exit,  "exit                - Close the console" },
+ *   };
+ *
+ *   lwip_init(); netif_add(...);
+ *   net_console_init(cmds, MICRORL_ARRAYSIZE(cmds), NET_CONSOLE_PORT);
+ *   ...
+ *   telnet 192.168.100.2 23
+ *
+ * printf() from interrupt handlers is not supported while the console
+ * owns stdout: the output path calls into lwIP.
+ *
+ * Copyright (c) October 2025 Michael Wolak
+ */
+
+#ifndef NET_CONSOLE_H
+#define NET_CONSOLE_H
+
+#include "lwip/opt.h"
+#include "lwip/err.h"
+#include "microrl_cmd.h"
+
+#ifndef NET_CONSOLE_PORT
+#define NET_CONSOLE_PORT        23
+#endif
+
+/* Output ring, bytes (power of 2); also the backlog a new client gets */
+#ifndef NET_CONSOLE_BUF
+#define NET_CONSOLE_BUF         2048
+#endif
+
+/* Longest a partial segment waits for more output */
+#ifndef NET_CONSOLE_COALESCE_MS
+#define NET_CONSOLE_COALESCE_MS 20
+#endif
+
+/* 1: stdout also goes to the UART (a console UART, not the SLIP one) */
+#ifndef NET_CONSOLE_UART_TOO
+#define NET_CONSOLE_UART_TOO    0
+#endif
+
+typedef struct {
+    u32_t connects;
+    u32_t writes;               /* printf()/shell output calls */
+    u32_t segments;             /* tcp_output() calls that had data */
+    u32_t bytes_out;
+    u32_t dropped;              /* Bytes lost to a full ring with a client on */
+    u32_t bytes_in;
+} net_console_stats_t;
+
+/*
+ * Listen on port and take stdout over. The command table is used as
+ * mrl_cmd_init() builds it; its messages go to the console.
+ */
+err_t net_console_init(const mrl_cmd_t *cmds, int count, u16_t port);
+
+/* Queue output (the syscalls_set_stdout() hook); '\n' is sent as CR LF */
+void net_console_write(const char *ptr, int len);
+void net_console_puts(const char *s);
+
+/* Send what is queued and drop the client (for an "exit" command) */
+void net_console_close(void);
+
+int net_console_connected(void);
+const net_console_stats_t *net_console_stats(void);
+
+#endif /* NET_CONSOLE_H */
@@ -0,0 +1,571 @@
+/*
+ * Overlay upload over TCP for lwIP (see overlay_tcp.h for the protocol)
+ *
+ * The receive side is a small state machine fed straight from the pbuf
+ * chain: message headers and short control payloads are collected in the
+ * connection state, DATA payload is copied into the slot (dma_memcpy()
+ * for the aligned bulk) and run through crc32_update() segment by segment.
+ * By END the CRC of the whole image is already known.
+ *
+ * In the lwIP firmware the slot (OVERLAY_BASE up to the stack region) is
+ * the top of the malloc() heap, so overlay_tcp_init() caps the heap below
+ * it with heap_set_limit() (lib/syscalls.c). A pbuf pool region placed in
+ * the slot by Kconfig shortens it. If the heap has already grown into
+ * the slot, uploads are refused with OVERLAY_TCP_ERR_SLOT.
+ *
+ * Copyright (c) October 2025 Michael Wolak
+ */
+
+#include "lwip/opt.h"
+#include "lwip/def.h"
+#include "lwip/tcp.h"
+#include "lwip/sys.h"
+#include "lwip/timeouts.h"
+#include <stdint.h>
+#include <string.h>
+#include "overlay_tcp.h"
+#include "../../overlay_sdk/common/memory_config.h"
+#include "../../../lib/crc32.h"
+#include "../../../lib/dma.h"
+#include "../../../lib/slip_codec.h"
+
+#define OVERLAY_TCP_MSG_MAX     (12 + OVERLAY_TCP_NAME_MAX)
+#define OVERLAY_TCP_EXEC_DELAY  200     /* ms for the ACK and FIN to leave */
+#define OVERLAY_TCP_STACK_SIZE  256     /* Launcher stack (the overlay brings its own) */
+
+/* timer0 (sys_arch.c tick) */
+#define OVL_TIMER_BASE      0x80000020
+#define OVL_TIMER_CR        (*(volatile uint32_t*)(OVL_TIMER_BASE + 0x00))
+#define OVL_TIMER_SR        (*(volatile uint32_t*)(OVL_TIMER_BASE + 0x04))
+#define OVL_TIMER_PSC       (*(volatile uint32_t*)(OVL_TIMER_BASE + 0x08))
+#define OVL_TIMER_ARR       (*(volatile uint32_t*)(OVL_TIMER_BASE + 0x0C))
+
+#define OVL_ICACHE_INV      (1 << 0)    /* CACHE_CTRL: invalidate all, reads busy */
+
+/* lib/syscalls.c */
+extern int heap_set_limit(void *limit);
+
+/* Linker script (scripts/gen_linker.sh) */
+extern char __stack_region;
+extern char __lwip_pool_start, __lwip_pool_end;     /* Both 0 unless in SRAM */
+
+enum ovl_rx_state {
+    OVL_RX_HEADER,                      /* Collecting the 8-byte header */
+    OVL_RX_MSG,                         /* Control payload into msg[] */
+    OVL_RX_DATA,                        /* DATA payload into the slot */
+    OVL_RX_SKIP                         /* Rejected payload, discarded */
+};
+
+struct ovl_conn {
+    struct tcp_pcb *pcb;
+    enum ovl_rx_state state;
+    u8_t hdr[8];
+    u32_t hdr_len;
+    u32_t type;
+    u32_t remain;                       /* Payload bytes still to come */
+    u8_t msg[OVERLAY_TCP_MSG_MAX];
+    u32_t msg_len;
+};
+
+struct ovl_upload {
+    u8_t active;                        /* START accepted, END not yet seen */
+    u8_t verified;                      /* Image complete and CRC good */
+    u32_t size;
+    u32_t expected_crc;
+    u32_t flags;
+    u32_t received;
+    u32_t crc;
+    char name[OVERLAY_TCP_NAME_MAX];
+};
+
+static const struct overlay_tcp_hooks *ovl_hooks = NULL;
+static struct ovl_conn ovl_conn;
+static struct ovl_upload ovl_up;
+static u32_t ovl_max = 0;               /* Slot size, 0 if not reserved */
+static u8_t ovl_exec_pending = 0;
+static u32_t ovl_exec_at = 0;
+
+static u32_t ovl_stack[OVERLAY_TCP_STACK_SIZE / 4] __attribute__((aligned(16)));
+
+/*
+ * Messages
+ */
+
+static inline u32_t ovl_get32(const u8_t *p)
+{
+    return ((u32_t)p[0] << 24) | ((u32_t)p[1] << 16) | ((u32_t)p[2] << 8) | p[3];
+}
+
+static inline void ovl_put32(u8_t *p, u32_t v)
+{
+    p[0] = (u8_t)(v >> 24);
+    p[1] = (u8_t)(v >> 16);
+    p[2] = (u8_t)(v >> 8);
+    p[3] = (u8_t)v;
+}
+
+/* Replies are at most 20 bytes: one copied write, sent right away */
+static void ovl_send(u32_t type, u32_t a, u32_t b, u32_t c, u32_t words)
+{
+    u8_t buf[8 + 12];
+
+    if (ovl_conn.pcb == NULL) {
+        return;
+    }
+
+    ovl_put32(buf, type);
+    ovl_put32(buf + 4, words * 4);
+    ovl_put32(buf + 8, a);
+    ovl_put32(buf + 12, b);
+    ovl_put32(buf + 16, c);
+
+    if (tcp_write(ovl_conn.pcb, buf, (u16_t)(8 + words * 4), TCP_WRITE_FLAG_COPY) == ERR_OK) {
+        tcp_output(ovl_conn.pcb);
+    }
+}
+
+static void ovl_error(u32_t code, u32_t a, u32_t b)
+{
+    ovl_send(OVERLAY_TCP_ERROR, code, a, b, 3);
+}
+
+static void ovl_start(const u8_t *p, u32_t len)
+{
+    u32_t size, name_len;
+
+    ovl_up.active = 0;
+    ovl_up.verified = 0;
+    ovl_exec_pending = 0;
+
+    if (len < 12) {
+        ovl_error(OVERLAY_TCP_ERR_MSG, OVERLAY_TCP_START, len);
+        return;
+    }
+    if (ovl_max == 0) {
+        ovl_error(OVERLAY_TCP_ERR_SLOT, OVERLAY_BASE, 0);
+        return;
+    }
+
+    size = ovl_get32(p);
+    if (size == 0 || size > ovl_max) {
+        ovl_error(OVERLAY_TCP_ERR_SIZE, size, ovl_max);
+        return;
+    }
+
+    ovl_up.size = size;
+    ovl_up.expected_crc = ovl_get32(p + 4);
+    ovl_up.flags = ovl_get32(p + 8);
+    ovl_up.received = 0;
+    ovl_up.crc = 0;
+
+    name_len = len - 12;
+    if (name_len > OVERLAY_TCP_NAME_MAX - 1) {
+        name_len = OVERLAY_TCP_NAME_MAX - 1;
+    }
+    memcpy(ovl_up.name, p + 12, name_len);
+    ovl_up.name[name_len] = '\0';
+
+    ovl_up.active = 1;
+    ovl_send(OVERLAY_TCP_ACK, 0, 0, 0, 0);
+}
+
+static void ovl_end(void)
+{
+    u32_t saved = 0;
+
+    if (!ovl_up.active) {
+        ovl_error(OVERLAY_TCP_ERR_STATE, OVERLAY_TCP_END, 0);
+        return;
+    }
+    ovl_up.active = 0;
+
+    if (ovl_up.received != ovl_up.size) {
+        ovl_error(OVERLAY_TCP_ERR_SHORT, ovl_up.received, ovl_up.size);
+        return;
+    }
+    if (ovl_up.crc != ovl_up.expected_crc) {
+        ovl_error(OVERLAY_TCP_ERR_CRC, ovl_up.crc, ovl_up.expected_crc);
+        return;
+    }
+
+    ovl_up.verified = 1;
+
+    if (ovl_up.flags & OVERLAY_TCP_SAVE) {
+        if (ovl_hooks == NULL || ovl_hooks->save == NULL || ovl_up.name[0] == '\0' ||
+            ovl_hooks->save(ovl_up.name, (const void *)OVERLAY_BASE, ovl_up.size) != 0) {
+            ovl_error(OVERLAY_TCP_ERR_SAVE, ovl_up.crc, ovl_up.size);
+            return;
+        }
+        saved = 1;
+    }
+
+    ovl_send(OVERLAY_TCP_DONE, ovl_up.crc, ovl_up.size, saved, 3);
+}
+
+/* Nothing to do: the timeout only wakes an event loop sleeping in
+ * slip_hw_wait_rx(), for overlay_tcp_poll() to see the delay is up */
+static void ovl_exec_wake(void *arg)
+{
+    (void)arg;
+}
+
+static void ovl_exec(void)
+{
+    if (!ovl_up.verified) {
+        ovl_error(OVERLAY_TCP_ERR_STATE, OVERLAY_TCP_EXEC, 0);
+        return;
+    }
+
+    ovl_send(OVERLAY_TCP_ACK, 0, 0, 0, 0);
+
+    /* Let the ACK and the FIN go out before the CPU leaves lwIP */
+    ovl_exec_pending = 1;
+    ovl_exec_at = sys_now() + OVERLAY_TCP_EXEC_DELAY;
+    sys_untimeout(ovl_exec_wake, NULL);
+    sys_timeout(OVERLAY_TCP_EXEC_DELAY, ovl_exec_wake, NULL);
+}
+
+static void ovl_dispatch(void)
+{
+    switch (ovl_conn.type) {
+        case OVERLAY_TCP_CAPS_REQ:
+            ovl_send(OVERLAY_TCP_CAPS_RESP, OVERLAY_BASE, ovl_max,
+                     ((ovl_hooks && ovl_hooks->save) ? OVERLAY_TCP_CAN_SAVE : 0) |
+                     OVERLAY_TCP_CAN_EXEC, 3);
+            break;
+
+        case OVERLAY_TCP_START:
+            ovl_start(ovl_conn.msg, ovl_conn.msg_len);
+            break;
+
+        case OVERLAY_TCP_END:
+            ovl_end();
+            break;
+
+        case OVERLAY_TCP_EXEC:
+            ovl_exec();
+            break;
+
+        default:
+            ovl_error(OVERLAY_TCP_ERR_MSG, ovl_conn.type, ovl_conn.msg_len);
+            break;
+    }
+}
+
+/* Header complete: decide where the payload goes */
+static void ovl_header(void)
+{
+    ovl_conn.type = ovl_get32(ovl_conn.hdr);
+    ovl_conn.remain = ovl_get32(ovl_conn.hdr + 4);
+    ovl_conn.hdr_len = 0;
+    ovl_conn.msg_len = 0;
+
+    if (ovl_conn.type == OVERLAY_TCP_DATA) {
+        if (!ovl_up.active) {
+            ovl_error(OVERLAY_TCP_ERR_STATE, OVERLAY_TCP_DATA, ovl_conn.remain);
+            ovl_conn.state = OVL_RX_SKIP;
+        } else if (ovl_conn.remain > ovl_up.size - ovl_up.received) {
+            ovl_error(OVERLAY_TCP_ERR_SIZE, ovl_up.received + ovl_conn.remain, ovl_up.size);
+            ovl_up.active = 0;
+            ovl_conn.state = OVL_RX_SKIP;
+        } else {
+            ovl_conn.state = OVL_RX_DATA;
+        }
+    } else if (ovl_conn.remain > OVERLAY_TCP_MSG_MAX) {
+        ovl_error(OVERLAY_TCP_ERR_MSG, ovl_conn.type, ovl_conn.remain);
+        ovl_conn.state = OVL_RX_SKIP;
+    } else {
+        ovl_conn.state = OVL_RX_MSG;
+    }
+
+    if (ovl_conn.remain == 0) {
+        if (ovl_conn.state == OVL_RX_MSG) {
+            ovl_dispatch();
+        }
+        ovl_conn.state = OVL_RX_HEADER;
+    }
+}
+
+static void ovl_consume(const u8_t *p, u32_t len)
+{
+    while (len) {
+        u32_t n;
+
+        switch (ovl_conn.state) {
+            case OVL_RX_HEADER:
+                n = LWIP_MIN(len, 8 - ovl_conn.hdr_len);
+                memcpy(ovl_conn.hdr + ovl_conn.hdr_len, p, n);
+                ovl_conn.hdr_len += n;
+                if (ovl_conn.hdr_len == 8) {
+                    ovl_header();
+                }
+                break;
+
+            case OVL_RX_MSG:
+                n = LWIP_MIN(len, ovl_conn.remain);
+                memcpy(ovl_conn.msg + ovl_conn.msg_len, p, n);
+                ovl_conn.msg_len += n;
+                ovl_conn.remain -= n;
+                if (ovl_conn.remain == 0) {
+                    ovl_dispatch();
+                    ovl_conn.state = OVL_RX_HEADER;
+                }
+                break;
+
+            case OVL_RX_DATA:
+                n = LWIP_MIN(len, ovl_conn.remain);
+                dma_memcpy((u8_t *)OVERLAY_BASE + ovl_up.received, p, n);
+                ovl_up.crc = crc32_update(ovl_up.crc, p, n);
+                ovl_up.received += n;
+                ovl_conn.remain -= n;
+                if (ovl_conn.remain == 0) {
+                    ovl_conn.state = OVL_RX_HEADER;
+                }
+                break;
+
+            default:    /* OVL_RX_SKIP */
+                n = LWIP_MIN(len, ovl_conn.remain);
+                ovl_conn.remain -= n;
+                if (ovl_conn.remain == 0) {
+                    ovl_conn.state = OVL_RX_HEADER;
+                }
+                break;
+        }
+
+        p += n;
+        len -= n;
+    }
+}
+
+/*
+ * TCP callbacks
+ */
+
+/* Returns what the recv callback must return */
+static err_t ovl_close(struct tcp_pcb *tpcb)
+{
+    err_t err = ERR_OK;
+
+    tcp_arg(tpcb, NULL);
+    tcp_recv(tpcb, NULL);
+    tcp_err(tpcb, NULL);
+    if (tcp_close(tpcb) != ERR_OK) {
+        tcp_abort(tpcb);
+        err = ERR_ABRT;
+    }
+    ovl_conn.pcb = NULL;
+    ovl_up.active = 0;
+
+    return err;
+}
+
+static err_t ovl_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err)
+{
+    struct pbuf *q;
+
+    (void)arg;
+
+    if (p == NULL) {
+        return ovl_close(tpcb);
+    }
+
+    if (err != ERR_OK) {
+        pbuf_free(p);
+        return err;
+    }
+
+    for (q = p; q != NULL; q = q->next) {
+        ovl_consume((const u8_t *)q->payload, q->len);
+    }
+
+    tcp_recved(tpcb, p->tot_len);
+    pbuf_free(p);
+
+    /* EXEC answered: close now, the overlay runs from overlay_tcp_poll() */
+    if (ovl_exec_pending) {
+        return ovl_close(tpcb);
+    }
+
+    return ERR_OK;
+}
+
+static void ovl_err(void *arg, err_t err)
+{
+    (void)arg;
+    (void)err;
+
+    /* pcb already freed by lwIP */
+    ovl_conn.pcb = NULL;
+    ovl_up.active = 0;
+}
+
+static err_t ovl_accept(void *arg, struct tcp_pcb *newpcb, err_t err)
+{
+    (void)arg;
+
+    if (err != ERR_OK || newpcb == NULL) {
+        return ERR_VAL;
+    }
+
+    if (ovl_conn.pcb != NULL || ovl_exec_pending) {
+        tcp_abort(newpcb);
+        return ERR_ABRT;
+    }
+
+    memset(&ovl_conn, 0, sizeof(ovl_conn));
+    ovl_conn.pcb = newpcb;
+    ovl_conn.state = OVL_RX_HEADER;
+
+    tcp_arg(newpcb, NULL);
+    tcp_recv(newpcb, ovl_recv);
+    tcp_err(newpcb, ovl_err);
+
+    return ERR_OK;
+}
+
+/*
+ * Execution
+ */
+
+void overlay_tcp_execute(u32_t entry)
+{
+    uint32_t mask, cr, psc, arr, slip = 0;
+    uint32_t top = (uint32_t)&ovl_stack[OVERLAY_TCP_STACK_SIZE / 4];
+
+    /* The overlay masks IRQs itself; keep ours off until it is back */
+    __asm__ volatile (".insn r 0x0B, 6, 3, %0, %1, x0" : "=r"(mask) : "r"(~0u));
+
+    cr = OVL_TIMER_CR;
+    psc = OVL_TIMER_PSC;
+    arr = OVL_TIMER_ARR;
+    OVL_TIMER_CR = 0;
+
+    /* Give the UART back to the overlay's console */
+    if (slip_codec_present()) {
+        slip = SLIP_CTRL & (SLIP_CTRL_RX_EN | SLIP_CTRL_IRQ_EN);
+        SLIP_CTRL = 0;
+    }
+
+    /* Written through the D-cache (and by DMA): make it visible to fetch */
+    dma_dcache_op(CACHE_DCACHE_CLEAN, OVERLAY_BASE, ovl_max);
+    CACHE_CTRL = OVL_ICACHE_INV;
+    while (CACHE_CTRL & OVL_ICACHE_INV);
+
+    /*
+     * Call entry on ovl_stack. The overlay keeps our sp/ra at 0x7FC00 and
+     * runs on its own stack at 0x7A000, but its start code reloads gp and
+     * fp and _exit() skips the epilogues, so gp and s0-s11 are kept on
+     * ovl_stack too rather than trusted to the calling convention.
+     */
+    __asm__ volatile (
+        "mv   t0, sp        \n"
+        "addi sp, %1, -64   \n"
+        "sw   t0,  0(sp)    \n"
+        "sw   gp,  4(sp)    \n"
+        "sw   s0,  8(sp)    \n"
+        "sw   s1, 12(sp)    \n"
+        "sw   s2, 16(sp)    \n"
+        "sw   s3, 20(sp)    \n"
+        "sw   s4, 24(sp)    \n"
+        "sw   s5, 28(sp)    \n"
+        "sw   s6, 32(sp)    \n"
+        "sw   s7, 36(sp)    \n"
+        "sw   s8, 40(sp)    \n"
+        "sw   s9, 44(sp)    \n"
+        "sw   s10, 48(sp)   \n"
+        "sw   s11, 52(sp)   \n"
+        "jalr ra, %0, 0     \n"
+        "lw   gp,  4(sp)    \n"
+        "lw   s0,  8(sp)    \n"
+        "lw   s1, 12(sp)    \n"
+        "lw   s2, 16(sp)    \n"
+        "lw   s3, 20(sp)    \n"
+        "lw   s4, 24(sp)    \n"
+        "lw   s5, 28(sp)    \n"
+        "lw   s6, 32(sp)    \n"
+        "lw   s7, 36(sp)    \n"
+        "lw   s8, 40(sp)    \n"
+        "lw   s9, 44(sp)    \n"
+        "lw   s10, 48(sp)   \n"
+        "lw   s11, 52(sp)   \n"
+        "lw   sp,  0(sp)    \n"
+        :
+        : "r"(entry), "r"(top)
+        : "ra", "t0", "t1", "t2", "t3", "t4", "t5", "t6",
+          "a0", "a1", "a2", "a3", "a4", "a5", "a6", "a7", "memory");
+
+    /* Put the tick and the SLIP receiver back the way they were */
+    OVL_TIMER_CR = 0;
+    OVL_TIMER_SR = 0x01;
+    OVL_TIMER_PSC = psc;
+    OVL_TIMER_ARR = arr;
+    OVL_TIMER_CR = cr;
+
+    if (slip) {
+        SLIP_CTRL = slip;
+    }
+
+    __asm__ volatile (".insn r 0x0B, 6, 3, %0, %1, x0" : "=r"(cr) : "r"(mask));
+}
+
+void overlay_tcp_poll(void)
+{
+    if (!ovl_exec_pending || (s32_t)(sys_now() - ovl_exec_at) < 0) {
+        return;
+    }
+
+    ovl_exec_pending = 0;
+    ovl_up.verified = 0;                /* Overlays may use their image as data */
+
+    if (ovl_hooks && ovl_hooks->execute) {
+        ovl_hooks->execute(OVERLAY_BASE);
+    } else {
+        overlay_tcp_execute(OVERLAY_BASE);
+    }
+}
+
+/*
+ * overlay_tcp_init - Reserve the overlay slot and listen on port
+ */
+err_t overlay_tcp_init(const struct overlay_tcp_hooks *hooks, u16_t port)
+{
+    struct tcp_pcb *pcb;
+    u32_t top = (u32_t)&__stack_region;
+    u32_t pool_start = (u32_t)&__lwip_pool_start;
+    u32_t pool_end = (u32_t)&__lwip_pool_end;
+    err_t err;
+
+    ovl_hooks = hooks;
+
+    /* The slot ends where the linker script puts the stack region */
+    if (top > OVERLAY_END) {
+        top = OVERLAY_END;
+    }
+
+    /* ...or where a pbuf pool region inside it starts */
+    if (pool_end > OVERLAY_BASE && pool_start < top) {
+        top = pool_start;
+    }
+    ovl_max = (top > OVERLAY_BASE && heap_set_limit((void *)OVERLAY_BASE) == 0)
+              ? top - OVERLAY_BASE : 0;
+
+    pcb = tcp_new();
+    if (pcb == NULL) {
+        return ERR_MEM;
+    }
+
+    err = tcp_bind(pcb, IP_ADDR_ANY, port);
+    if (err != ERR_OK) {
+        tcp_close(pcb);
+        return err;
+    }
+
+    pcb = tcp_listen(pcb);
+    if (pcb == NULL) {
+        return ERR_MEM;
+    }
+
+    tcp_accept(pcb, ovl_accept);
+
+    return ERR_OK;
+}
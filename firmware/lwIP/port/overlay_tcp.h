@@ -0,0 +1,105 @@
+/*
+ * Overlay upload over TCP for lwIP (NO_SYS, raw TCP API)
+ *
+ * Receives an overlay binary straight into the overlay slot at OVERLAY_BASE
+ * (overlay_sdk/common/memory_config.h) as the segments arrive: payload is
+ * copied out of each pbuf into place and fed to the hardware CRC32
+ * (lib/crc32.h) on the way, so nothing is buffered and the upload runs at
+ * whatever the link delivers. The finished image can be saved (to
+ * /OVERLAYS on SD, through a hook) and run.
+ *
+ * Framing is the one slip_perf_server.c uses, [Type:4][Length:4][Payload],
+ * big-endian, with the same message numbers where the meaning carries over:
+ *
+ *   CAPS_REQ   ->  CAPS_RESP [base:4][max size:4][features:4]
+ *   START [size:4][crc32:4][flags:4][name...]  ->  ACK | ERROR
+ *   DATA  [bytes]  (any number of messages, appended in order)
+ *   END        ->  DONE [crc32:4][size:4][saved:4] | ERROR
+ *   EXEC       ->  ACK, connection closed, then the overlay runs
+ *
+ *   ERROR [code:4][value:4][value:4]
+ *
+ * One upload at a time: a second connection is refused while one is open.
+ * tools/overlay_tcp_upload is the host side.
+ *
+ *   static int sd_save(const char *name, const void *data, u32_t len) {
+ *       char path[80];
+ *       FIL fil;
+ *       UINT bw;
+ *       snprintf(path, sizeof(path), OVERLAY_DIR "/%s", name);
+ *       if (overlay_ensure_directory() != FR_OK ||
+ *           f_open(&fil, path, FA_WRITE | FA_CREATE_ALWAYS) != FR_OK) return -1;
+ *       FRESULT fr = f_write(&fil, data, len, &bw);
+ *       return (f_close(&fil) == FR_OK && fr == FR_OK && bw == len) ? 0 : -1;
+ *   }
+ *   static const struct overlay_tcp_hooks hooks = { sd_save, NULL };
+ *
+ *   overlay_tcp_init(&hooks, OVERLAY_TCP_PORT);   // Before the first malloc() is best
+ *   main loop:  overlay_tcp_poll();                // Runs the overlay after EXEC
+ *
+ * Copyright (c) October 2025 Michael Wolak
+ */
+
+#ifndef OVERLAY_TCP_H
+#define OVERLAY_TCP_H
+
+#include "lwip/opt.h"
+
+#ifndef OVERLAY_TCP_PORT
+#define OVERLAY_TCP_PORT        8890
+#endif
+
+/* Message types (slip_perf_server.c MSG_* numbers) */
+#define OVERLAY_TCP_CAPS_REQ    0x01
+#define OVERLAY_TCP_CAPS_RESP   0x02
+#define OVERLAY_TCP_START       0x03
+#define OVERLAY_TCP_ACK         0x04
+#define OVERLAY_TCP_DATA        0x06
+#define OVERLAY_TCP_DONE        0x07
+#define OVERLAY_TCP_END         0x08
+#define OVERLAY_TCP_EXEC        0x09
+#define OVERLAY_TCP_ERROR       0xFF
+
+/* START flags */
+#define OVERLAY_TCP_SAVE        (1 << 0)    /* Save to SD after the CRC checks */
+
+/* CAPS_RESP features */
+#define OVERLAY_TCP_CAN_SAVE    (1 << 0)
+#define OVERLAY_TCP_CAN_EXEC    (1 << 1)
+
+/* ERROR codes */
+#define OVERLAY_TCP_ERR_SIZE    1   /* Larger than the slot: size, max */
+#define OVERLAY_TCP_ERR_STATE   2   /* DATA/END without START, EXEC before DONE */
+#define OVERLAY_TCP_ERR_CRC     3   /* CRC mismatch: calculated, expected */
+#define OVERLAY_TCP_ERR_MSG     4   /* Unknown or oversized message: type, length */
+#define OVERLAY_TCP_ERR_SAVE    5   /* Save hook failed */
+#define OVERLAY_TCP_ERR_SHORT   6   /* END before all bytes: received, size */
+#define OVERLAY_TCP_ERR_SLOT    7   /* Heap already reaches the slot */
+
+#define OVERLAY_TCP_NAME_MAX    64
+
+/*
+ * Board hooks, either may be NULL. save() stores the verified image and
+ * returns 0 on success; without it SAVE requests fail. execute() replaces
+ * the built-in launcher (overlay_tcp_execute).
+ */
+struct overlay_tcp_hooks {
+    int (*save)(const char *name, const void *data, u32_t len);
+    void (*execute)(u32_t entry);
+};
+
+/* Reserve the slot (caps the malloc() heap below it) and start listening */
+err_t overlay_tcp_init(const struct overlay_tcp_hooks *hooks, u16_t port);
+
+/* Main loop: run an overlay once EXEC has been answered */
+void overlay_tcp_poll(void);
+
+/*
+ * Run the image at entry and return to the caller: IRQs masked, timer0 and
+ * the SLIP codec stopped while it runs and restored afterwards. The call
+ * runs on a private stack, because the overlay's stack and heap
+ * (0x78000-0x80000) share SRAM with the top of this firmware's stack.
+ */
+void overlay_tcp_execute(u32_t entry);
+
+#endif /* OVERLAY_TCP_H */
@@ -2,7 +2,23 @@
  * Serial I/O Layer for lwIP SLIP on PicoRV32
  *
  * Provides sio_* functions needed by slipif.c
- * Maps to PicoRV32 UART at 0x80000000
+ * Maps to PicoRV32 UART0 at 0x80000000 (SIO_UART_BASE). With the console
+ * UART (Kconfig CONSOLE_UART) printf goes there instead (lib/syscalls.c),
+ * so debug output never lands inside a frame.
+ *
+ * Receive (SLIP_RX_FROM_ISR): sio_rx_isr() drains the RX FIFO from the
+ * UART interrupt into slipif_received_bytes(), which decodes the SLIP
+ * framing straight into PBUF_POOL pbufs and queues whole frames. The main
+ * loop calls sio_rx_process() to pass queued frames to netif->input, so
+ * bytes are never lost while the application is busy. Without
+ * sio_rx_start() (or on bitstreams without UART interrupts)
+ * sio_rx_process() drains the FIFO itself, i.e. the old polling mode.
+ *
+ * On FreeRTOS (NO_SYS 0, sys_arch_freertos.c) slipif's RX thread calls
+ * sio_read() instead, which reads the port's UART RX stream buffer
+ * (freertos_uart.c): the ISR fills it a FIFO watermark at a time and the
+ * thread wakes once per burst, not per byte. Without UART interrupts it
+ * polls the FIFO every tick.
  *
  * Copyright (c) October 2025 Michael Wolak
  */
@@ -10,21 +26,52 @@
 #include "lwip/opt.h"
 #include "lwip/sys.h"
 #include "lwip/sio.h"
+#include "netif/slipif.h"
 #include <stdint.h>
+#include "../../../lib/uart_irq.h"
+#include "../../../lib/uart_baud.h"
+#include "../../../lib/uart_port.h"
+#if !NO_SYS
+#include "FreeRTOS.h"
+#include "task.h"
+#include "freertos_uart.h"
+
+#define SIO_STREAM_SIZE     2048    /* RX stream buffer: two full frames */
+#define SIO_STREAM_TRIGGER  32      /* Bytes that wake the RX thread */
+#endif
+
+/*
+ * Auto-baud window in sio_open(): slattach_1m -n can raise the UART rate
+ * before SLIP starts (lib/uart_baud.h). 0 skips it.
+ */
+#ifndef SIO_BAUD_LISTEN_MS
+#define SIO_BAUD_LISTEN_MS 1000
+#endif
+
+/*
+ * SLIP UART (lib/uart_port.h). The RX interrupt, the FreeRTOS RX stream
+ * and auto-baud are UART0's; on another instance SLIP polls its FIFO.
+ */
+#ifndef SIO_UART_BASE
+#define SIO_UART_BASE  UART0_BASE
+#endif
+#define SIO_ON_UART0   (SIO_UART_BASE == UART0_BASE)
 
 /*
  * UART Register Definitions
- * Base: 0x80000000 (MMIO)
  */
-#define UART_TX_DATA   (*(volatile uint32_t*)0x80000000)
-#define UART_TX_STATUS (*(volatile uint32_t*)0x80000004)
-#define UART_RX_DATA   (*(volatile uint32_t*)0x80000008)
-#define UART_RX_STATUS (*(volatile uint32_t*)0x8000000C)
+#define UART_TX_DATA   UART_PORT_TX_DATA(SIO_UART_BASE)
+#define UART_TX_STATUS UART_PORT_TX_STATUS(SIO_UART_BASE)
+#define UART_TX_WORD   UART_PORT_TX_WORD(SIO_UART_BASE)   /* Write: queue all byte lanes */
+#define UART_RX_DATA   UART_PORT_RX_DATA(SIO_UART_BASE)
+#define UART_RX_STATUS UART_PORT_RX_STATUS(SIO_UART_BASE)
 
 /*
  * Status bits
  */
-#define UART_TX_BUSY   (1 << 0)  /* TX busy (wait while high) */
+#define UART_TX_BUSY   (1 << 0)  /* TX FIFO full (wait while high) */
+#define UART_TX_FIFO   (1u << 31) /* TX FIFO and TX_WORD present */
+#define UART_TX_FREE(s) (((s) >> 16) & 0xFFF)  /* Free TX FIFO bytes */
 #define UART_RX_AVAIL  (1 << 0)  /* RX data available (high = data ready) */
 
 /*
@@ -55,10 +102,23 @@ static inline uint8_t uart_getc_block(void) {
  */
 sio_fd_t sio_open(u8_t devnum)
 {
-    (void)devnum;  /* Ignore - we only have UART0 */
+    (void)devnum;  /* Ignore - SLIP has one UART, SIO_UART_BASE */
 
     /* UART already initialized by bootloader/startup code */
 
+#if SIO_BAUD_LISTEN_MS > 0
+    if (SIO_ON_UART0) {
+        uart_baud_listen(SIO_BAUD_LISTEN_MS);
+    }
+#endif
+
+#if !NO_SYS
+    /* TX stays direct: slipif sends a byte at a time through sio_send() */
+    if (SIO_ON_UART0) {
+        xPortUartStreamStart(SIO_STREAM_SIZE, SIO_STREAM_TRIGGER, 0);
+    }
+#endif
+
     /* Return dummy non-NULL handle */
     return (sio_fd_t)1;
 }
@@ -75,23 +135,158 @@ void sio_send(u8_t c, sio_fd_t fd)
 }
 
 /*
- * sio_recv - Receive single byte (blocking)
+ * sio_read - Receive len bytes (blocking)
  *
- * Used by SLIP RX thread (not used in NO_SYS mode)
- * Blocks until data is available
+ * Used by the SLIP RX thread (SLIP_USE_RX_THREAD, FreeRTOS only): other
+ * tasks run while nothing has arrived. Without the RX stream (bitstreams
+ * without UART interrupts) it wakes every tick to re-check the FIFO.
  */
 u32_t sio_read(sio_fd_t fd, u8_t *data, u32_t len)
 {
     (void)fd;
+#if !NO_SYS
+    u32_t got = 0;
+
+    while (got < len) {
+        if (SIO_ON_UART0 && xPortUartStreamRxActive()) {
+            got += xPortUartStreamRead(data + got, len - got, portMAX_DELAY);
+        } else if (SIO_ON_UART0) {
+            got += uart_read_timeout((char *)data + got, len - got, 1);
+        } else {
+            got += sio_tryread(fd, data + got, len - got);
+            if (got < len) {
+                vTaskDelay(1);
+            }
+        }
+    }
+#else
     u32_t i;
 
     for (i = 0; i < len; i++) {
         data[i] = uart_getc_block();
     }
+#endif
 
     return len;
 }
 
+#if SLIP_RX_FROM_ISR
+/*
+ * Interrupt-driven receive (NO_SYS)
+ */
+#define SIO_RX_CHUNK    64      /* slipif_received_bytes() takes a u8_t length */
+#define SIO_RX_WM       32      /* RX FIFO level that raises IRQ[4] */
+
+static struct netif *sio_rx_netif = NULL;
+static int sio_rx_irq = 0;      /* RX interrupt armed (bitstream has it) */
+static volatile int sio_rx_event = 0;   /* ISR ran since the last sio_wait_rx() */
+
+/* sys_arch.c: timer wakeup for the next lwIP timeout */
+extern int sys_sleep_arm(int polled);
+
+/* Read up to SIO_RX_CHUNK bytes at a time and feed them to the decoder */
+static void sio_rx_drain(struct netif *netif)
+{
+    u8_t buf[SIO_RX_CHUNK];
+    u8_t n;
+
+    do {
+        n = 0;
+        while (n < SIO_RX_CHUNK && (UART_RX_STATUS & UART_RX_AVAIL)) {
+            buf[n++] = UART_RX_DATA & 0xFF;
+        }
+        if (n) {
+            slipif_received_bytes(netif, buf, n);
+        }
+    } while (n == SIO_RX_CHUNK);
+}
+
+/*
+ * sio_rx_start - Receive SLIP frames from the UART RX interrupt
+ *
+ * Call after netif_add(); irq_handler() must then call sio_rx_isr() on
+ * IRQ[4]. IRQ[4] fires at SIO_RX_WM bytes, or when the line goes idle with
+ * fewer waiting (the end of a frame).
+ */
+void sio_rx_start(struct netif *netif)
+{
+    sio_rx_netif = netif;
+    if (!SIO_ON_UART0) {
+        return;     /* Its IRQ is not IRQ[4]: keep polling */
+    }
+
+    UART_IRQ_LEVEL = UART_IRQ_LEVELS(SIO_RX_WM, (UART_IRQ_LEVEL >> 16) & 0xFFFF);
+    uart_irq_ack();
+    uart_irq_enable(UART_IRQ_RX_WM | UART_IRQ_RX_IDLE);
+
+    /* Unmapped MMIO reads 0: no UART interrupts, keep polling */
+    sio_rx_irq = (UART_IRQ_EN & UART_IRQ_RX_WM) != 0;
+}
+
+/*
+ * sio_rx_isr - UART RX interrupt (IRQ[4])
+ *
+ * Empties the FIFO, which drops the level interrupt. The idle flag is
+ * cleared first, so bytes arriving during the drain raise it again.
+ */
+void sio_rx_isr(void)
+{
+    uart_irq_ack();
+    if (sio_rx_netif != NULL) {
+        sio_rx_drain(sio_rx_netif);
+        sio_rx_event = 1;
+    } else {
+        uart_irq_disable(UART_IRQ_RX_ALL);
+    }
+}
+
+/*
+ * sio_rx_process - Pass received frames up the stack (main loop)
+ *
+ * Replaces slipif_poll(). In polling mode the FIFO is decoded here, with
+ * interrupts masked like the ISR path so the frame queue stays consistent.
+ */
+void sio_rx_process(struct netif *netif)
+{
+    if (!sio_rx_irq) {
+        SYS_ARCH_DECL_PROTECT(lev);
+
+        SYS_ARCH_PROTECT(lev);
+        sio_rx_drain(netif);
+        SYS_ARCH_UNPROTECT(lev);
+    }
+    slipif_process_rxqueue(netif);
+}
+
+/*
+ * sio_wait_rx - Sleep until UART RX data arrives or an lwIP timeout is due
+ *
+ * For NO_SYS main loops: returns at once if the ISR has run since the
+ * last call (or, polling, if data is waiting), otherwise halts in waitirq
+ * until the UART RX interrupt (IRQ[4]) or the timer set by
+ * sys_sleep_arm(). The check is made with IRQs masked, so bytes the ISR
+ * takes just before the sleep are not left waiting. Polling, the loop
+ * wakes every millisecond to drain the FIFO.
+ */
+void sio_wait_rx(void)
+{
+    SYS_ARCH_DECL_PROTECT(lev);
+    int ready;
+
+    SYS_ARCH_PROTECT(lev);
+    if (sio_rx_irq) {
+        ready = sio_rx_event;
+    } else {
+        ready = (UART_RX_STATUS & UART_RX_AVAIL) != 0;
+    }
+    if (!ready && sys_sleep_arm(!sio_rx_irq)) {
+        picorv32_waitirq();
+    }
+    sio_rx_event = 0;
+    SYS_ARCH_UNPROTECT(lev);    /* The pending IRQ is taken here */
+}
+#endif /* SLIP_RX_FROM_ISR */
+
 /*
  * sio_tryread - Non-blocking read
  *
@@ -123,10 +318,31 @@ u32_t sio_tryread(sio_fd_t fd, u8_t *data, u32_t len)
 u32_t sio_write(sio_fd_t fd, const u8_t *data, u32_t len)
 {
     (void)fd;
-    u32_t i;
+    u32_t left = len;
 
-    for (i = 0; i < len; i++) {
-        uart_putc(data[i]);
+    while (left) {
+        uint32_t status = UART_TX_STATUS;
+
+        if (!(status & UART_TX_FIFO)) {
+            uart_putc(*data++);  /* Older bitstream: one byte at a time */
+            left--;
+            continue;
+        }
+
+        /* Fill the TX FIFO up to its free space, four bytes per word store */
+        uint32_t room = UART_TX_FREE(status);
+        if (room > left) room = left;
+        left -= room;
+
+        for (; room && ((uint32_t)data & 3); room--) {
+            UART_TX_DATA = *data++;
+        }
+        for (; room >= 4; room -= 4, data += 4) {
+            UART_TX_WORD = *(const uint32_t *)data;
+        }
+        for (; room; room--) {
+            UART_TX_DATA = *data++;
+        }
     }
 
     return len;
@@ -0,0 +1,305 @@
+/*
+ * lwIP SLIP netif driver for the hardware SLIP codec on PicoRV32
+ *
+ * On bitstreams built with Kconfig SLIP_CODEC the codec at 0x800001C0
+ * (lib/slip_codec.h) does the framing: received frames arrive de-escaped
+ * with their length known up front, so slip_hw_isr() allocates one pbuf
+ * chain of the right size and fills it four bytes per load, and output
+ * stores whole words that the codec escapes on the way to the UART. The
+ * CPU never looks at SLIP bytes.
+ *
+ * Without the codec slip_hw_netif_init() hands over to slipif_init() and
+ * the other calls fall through to the sio.c receive path, so one binary
+ * runs on both bitstreams:
+ *
+ *   netif_add(&netif, &ip, &mask, &gw, NULL, slip_hw_netif_init, ip_input);
+ *   slip_hw_start(&netif);                 // After netif_set_up()
+ *
+ *   irq_handler:  if (irqs & (1 << 4)) slip_hw_isr();
+ *   main loop:    slip_hw_process(&netif); sys_check_timeouts(); slip_hw_wait_rx();
+ *
+ * Both paths get VJ header compression (slip_vj.c, lwipopts.h SLIP_VJ)
+ * between the netif and the framing.
+ *
+ * The main loop is event driven: slip_hw_wait_rx() sleeps in waitirq
+ * until a frame arrives or the next lwIP timeout is due (sys_sleep_arm),
+ * instead of polling. Without an irq_handler() of its own the firmware
+ * gets slip_hw_isr() from the start.S dispatcher (lib/irq.h).
+ *
+ * Copyright (c) October 2025 Michael Wolak
+ */
+
+#include "lwip/opt.h"
+#include "lwip/sys.h"
+#include "lwip/pbuf.h"
+#include "lwip/netif.h"
+#include "lwip/stats.h"
+#include "lwip/snmp.h"
+#include "netif/slipif.h"
+#include <stdint.h>
+#include "slip_vj.h"
+#include "../../../lib/slip_codec.h"
+#include "../../../lib/uart_irq.h"
+#include "../../../lib/irq.h"
+
+#define SLIP_HW_MTU         1500
+#define SLIP_HW_QUEUE       8       /* Frames between the ISR and the main loop */
+
+/* sio.c receive path, used without the codec */
+extern void sio_rx_start(struct netif *netif);
+extern void sio_rx_isr(void);
+extern void sio_rx_process(struct netif *netif);
+extern void sio_wait_rx(void);
+
+/* sys_arch.c: timer wakeup for the next lwIP timeout */
+extern int sys_sleep_arm(int polled);
+
+static int slip_hw = 0;             /* Codec found by slip_hw_netif_init() */
+static int slip_hw_irq = 0;         /* Frame IRQ armed (slip_hw_start) */
+
+/*
+ * Received frames, filled by the ISR and emptied by slip_hw_process().
+ * Single producer / single consumer: head is only written by the ISR,
+ * tail only by the main loop, so no locking is needed.
+ */
+static struct pbuf *volatile slip_hw_queue[SLIP_HW_QUEUE];
+static volatile uint32_t slip_hw_head = 0;
+static volatile uint32_t slip_hw_tail = 0;
+
+/*
+ * Frame output
+ */
+
+/* Queue len bytes for escaping: word stores where the buffer allows */
+static void slip_hw_send(const u8_t *data, u16_t len)
+{
+    for (; len && ((uint32_t)data & 3); len--) {
+        SLIP_TX_BYTE = *data++;
+    }
+    for (; len >= 4; len -= 4, data += 4) {
+        SLIP_TX_WORD = *(const uint32_t *)data;
+    }
+    for (; len; len--) {
+        SLIP_TX_BYTE = *data++;
+    }
+}
+
+static err_t slip_hw_output(struct netif *netif, struct pbuf *p, const ip4_addr_t *ipaddr)
+{
+    struct pbuf *q;
+
+    (void)ipaddr;
+
+    for (q = p; q != NULL; q = q->next) {
+        slip_hw_send((const u8_t *)q->payload, q->len);
+    }
+    SLIP_TX_END = 0;
+
+    MIB2_STATS_NETIF_ADD(netif, ifoutoctets, p->tot_len);
+    MIB2_STATS_NETIF_INC(netif, ifoutucastpkts);
+    LINK_STATS_INC(link.xmit);
+    (void)netif;
+
+    return ERR_OK;
+}
+
+/*
+ * Frame input
+ */
+
+/* Read the current frame (len bytes) into a pbuf chain, NULL if none free */
+static struct pbuf *slip_hw_read_frame(u16_t len)
+{
+    struct pbuf *p, *q;
+
+    p = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
+    if (p == NULL) {
+        return NULL;
+    }
+
+    for (q = p; q != NULL; q = q->next) {
+        u8_t *dst = (u8_t *)q->payload;
+        u16_t n = q->len;
+
+        if (((uint32_t)dst & 3) == 0) {
+            for (; n >= 4; n -= 4, dst += 4) {
+                *(uint32_t *)dst = SLIP_RX_WORD;
+            }
+        }
+        for (; n; n--) {
+            *dst++ = (u8_t)SLIP_RX_DATA;
+        }
+    }
+
+    return p;
+}
+
+/*
+ * slip_hw_isr - UART RX / SLIP frame interrupt (IRQ[4])
+ *
+ * Moves every complete frame out of the codec, which drops the level
+ * interrupt. A frame that finds no pbuf or a full queue is discarded, as
+ * slipif does when PBUF_POOL runs out.
+ */
+void slip_hw_isr(void)
+{
+    uint32_t len;
+
+    if (!slip_hw) {
+        sio_rx_isr();
+        return;
+    }
+
+    while ((len = SLIP_RX_LEN) & SLIP_RX_VALID) {
+        uint32_t next = (slip_hw_head + 1) % SLIP_HW_QUEUE;
+        struct pbuf *p = NULL;
+
+        len &= SLIP_RX_LEN_MASK;
+        if (next != slip_hw_tail && len <= SLIP_HW_MTU) {
+            p = slip_hw_read_frame((u16_t)len);
+        }
+
+        if (p == NULL) {
+            SLIP_RX_LEN = 0;        /* Discard */
+            LINK_STATS_INC(link.memerr);
+            LINK_STATS_INC(link.drop);
+            continue;
+        }
+
+        slip_hw_queue[slip_hw_head] = p;
+        slip_hw_head = next;
+    }
+}
+
+/* The same from the lib/irq.h dispatch table */
+static void slip_hw_irq_entry(uint32_t source)
+{
+    (void)source;
+    slip_hw_isr();
+}
+
+/*
+ * Driver interface
+ */
+
+/*
+ * slip_hw_netif_init - netif_add() init function
+ *
+ * Uses the codec when the bitstream has one, slipif otherwise.
+ */
+err_t slip_hw_netif_init(struct netif *netif)
+{
+    if (!slip_codec_present()) {
+        err_t err;
+
+        slip_hw = 0;
+        err = slipif_init(netif);
+#if SLIP_VJ
+        if (err == ERR_OK) {
+            slip_vj_attach(netif, SLIP_VJ_MODE);
+        }
+#endif
+        return err;
+    }
+
+    slip_hw = 1;
+    SLIP_CTRL = 0;                  /* Flush anything from before now */
+    SLIP_STATUS = 0;
+
+    netif->name[0] = 's';
+    netif->name[1] = 'l';
+    netif->output = slip_hw_output;
+    netif->mtu = SLIP_HW_MTU;
+    netif->flags = 0;
+    netif->state = NULL;
+
+    MIB2_INIT_NETIF(netif, snmp_ifType_slip, SLIP_HW_MTU * 8);
+
+#if SLIP_VJ
+    slip_vj_attach(netif, SLIP_VJ_MODE);
+#endif
+    return ERR_OK;
+}
+
+/*
+ * slip_hw_start - Start receiving (interrupt driven when possible)
+ *
+ * From here on the UART RX carries SLIP only: the codec takes every byte.
+ * An irq_handler() of the firmware's own must call slip_hw_isr() on IRQ[4].
+ */
+void slip_hw_start(struct netif *netif)
+{
+    irq_register(IRQ_UART_RX, slip_hw_irq_entry, 12);
+
+    if (!slip_hw) {
+        sio_rx_start(netif);
+        return;
+    }
+
+    SLIP_CTRL = SLIP_CTRL_RX_EN | SLIP_CTRL_IRQ_EN;
+    slip_hw_irq = 1;
+}
+
+/*
+ * slip_hw_process - Pass received frames up the stack (main loop)
+ */
+void slip_hw_process(struct netif *netif)
+{
+    if (!slip_hw) {
+        sio_rx_process(netif);
+        return;
+    }
+
+    if (!slip_hw_irq) {
+        SYS_ARCH_DECL_PROTECT(lev);
+
+        SYS_ARCH_PROTECT(lev);
+        slip_hw_isr();
+        SYS_ARCH_UNPROTECT(lev);
+    }
+
+    while (slip_hw_tail != slip_hw_head) {
+        struct pbuf *p = slip_hw_queue[slip_hw_tail];
+
+        slip_hw_tail = (slip_hw_tail + 1) % SLIP_HW_QUEUE;
+
+        MIB2_STATS_NETIF_ADD(netif, ifinoctets, p->tot_len);
+        MIB2_STATS_NETIF_INC(netif, ifinucastpkts);
+        LINK_STATS_INC(link.recv);
+
+        if (netif->input(p, netif) != ERR_OK) {
+            pbuf_free(p);
+        }
+    }
+}
+
+/*
+ * slip_hw_wait_rx - Sleep until a frame arrives or an lwIP timeout is due
+ *
+ * The queue is checked with IRQs masked and waitirq returns for a masked
+ * IRQ too, so a frame the ISR queues just before the sleep is not left
+ * waiting for the timer (see sio_wait_rx for the codec-less path).
+ */
+void slip_hw_wait_rx(void)
+{
+    SYS_ARCH_DECL_PROTECT(lev);
+
+    if (!slip_hw) {
+        sio_wait_rx();
+        return;
+    }
+
+    SYS_ARCH_PROTECT(lev);
+    if (slip_hw_tail == slip_hw_head && sys_sleep_arm(!slip_hw_irq)) {
+        picorv32_waitirq();
+    }
+    SYS_ARCH_UNPROTECT(lev);    /* The pending IRQ is taken here */
+}
+
+/*
+ * slip_hw_dropped - Frames the codec dropped (buffer or length queue full)
+ */
+u32_t slip_hw_dropped(void)
+{
+    return slip_hw ? SLIP_STATUS_DROPPED(SLIP_STATUS) : 0;
+}
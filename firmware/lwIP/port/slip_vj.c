@@ -0,0 +1,543 @@
+/*
+ * Van Jacobson TCP/IP header compression (RFC 1144, CSLIP) for the SLIP netif
+ *
+ * At 1 Mbaud every byte costs 10 us on the wire, and an echo or an ACK
+ * with 40 bytes of IP and TCP headers spends most of its time on them.
+ * CSLIP keeps the last header of each TCP connection at both ends and
+ * sends only what changed: usually 3-7 bytes instead of 40. The frame
+ * type is in the high bits of the first byte, as Linux's slhc expects:
+ *
+ *   0100xxxx   TYPE_IP               plain IP (not TCP, SYN/FIN/RST, ...)
+ *   0111xxxx   UNCOMPRESSED_TCP      full header, protocol byte = slot id
+ *   1xxxxxxx   COMPRESSED_TCP        change mask, [slot], TCP checksum, deltas
+ *
+ * slip_vj_attach() wraps netif->input and netif->output, so the same code
+ * sits on the hardware codec (slip_hw_netif.c) and on slipif. Received
+ * compressed frames are rebuilt into one PBUF_RAM pbuf; compressed output
+ * is copied into one too, since TCP keeps the original for retransmission.
+ * At 10 us per byte on the wire the copies cost nothing that counts.
+ *
+ * Linux sends TCP timestamps by default, and a changing option forces
+ * UNCOMPRESSED_TCP every time: for compression from the host side too,
+ * sysctl net.ipv4.tcp_timestamps=0. lwIP sends no timestamps.
+ *
+ * Copyright (c) October 2025 Michael Wolak
+ */
+
+#include "lwip/opt.h"
+#include "lwip/pbuf.h"
+#include "lwip/netif.h"
+#include "lwip/inet_chksum.h"
+#include <string.h>
+#include "slip_vj.h"
+
+#if SLIP_VJ
+
+#define VJ_TX_SLOTS         8       /* Connections we compress at once */
+#define VJ_RX_SLOTS         16      /* Slot ids the peer may use (slhc default) */
+#define VJ_HDR_MAX          120     /* IP + TCP header with all options */
+#define VJ_CHDR_MAX         19      /* Mask, slot, checksum, 5 deltas */
+
+/* Frame types (first byte) */
+#define TYPE_IP             0x40
+#define TYPE_UNCOMPRESSED   0x70
+#define TYPE_COMPRESSED     0x80
+
+/* Change mask */
+#define NEW_U               0x01
+#define NEW_W               0x02
+#define NEW_A               0x04
+#define NEW_S               0x08
+#define NEW_P               0x10    /* TCP PSH */
+#define NEW_I               0x20
+#define NEW_C               0x40
+#define SPECIAL_I           (NEW_S | NEW_W | NEW_U)         /* Echoed interactive data */
+#define SPECIAL_D           (NEW_S | NEW_A | NEW_W | NEW_U) /* One-way data */
+#define SPECIALS_MASK       (NEW_S | NEW_A | NEW_W | NEW_U)
+
+/* TCP flags */
+#define TH_FIN              0x01
+#define TH_SYN              0x02
+#define TH_RST              0x04
+#define TH_PSH              0x08
+#define TH_ACK              0x10
+#define TH_URG              0x20
+
+typedef struct {
+    u8_t hdr[VJ_HDR_MAX];           /* Last IP + TCP header of the connection */
+    u8_t hlen;                      /* 0: slot unused */
+} vj_slot_t;
+
+static vj_slot_t vj_tx[VJ_TX_SLOTS];
+static u8_t vj_tx_lru[VJ_TX_SLOTS]; /* Slot ids, most recently used first */
+static u8_t vj_tx_last = 0xFF;      /* Slot of the last compressed frame sent */
+
+static vj_slot_t vj_rx[VJ_RX_SLOTS];
+static u8_t vj_rx_last;
+static u8_t vj_rx_toss = 1;         /* Until the peer names a slot */
+
+static int vj_mode = SLIP_VJ_AUTO;
+static int vj_active = 0;
+static slip_vj_stats_t vj_stats;
+
+static netif_input_fn vj_next_input;
+static netif_output_fn vj_next_output;
+
+static u16_t get16(const u8_t *p) { return (u16_t)((p[0] << 8) | p[1]); }
+static u32_t get32(const u8_t *p) { return ((u32_t)get16(p) << 16) | get16(p + 2); }
+static void put16(u8_t *p, u16_t v) { p[0] = (u8_t)(v >> 8); p[1] = (u8_t)v; }
+static void put32(u8_t *p, u32_t v) { put16(p, (u16_t)(v >> 16)); put16(p + 2, (u16_t)v); }
+
+/* Delta: 1-255 in one byte, anything else as 0 and two bytes */
+static u8_t *vj_encode(u8_t *cp, u16_t n)
+{
+    if (n >= 256 || n == 0) {
+        *cp++ = 0;
+        put16(cp, n);
+        return cp + 2;
+    }
+    *cp++ = (u8_t)n;
+    return cp;
+}
+
+static int vj_decode(const u8_t **cp, const u8_t *end, u16_t *n)
+{
+    const u8_t *p = *cp;
+
+    if (p >= end) {
+        return 0;
+    }
+    if (*p) {
+        *n = *p++;
+    } else {
+        if (end - p < 3) {
+            return 0;
+        }
+        *n = get16(p + 1);
+        p += 3;
+    }
+    *cp = p;
+    return 1;
+}
+
+/* Header length of an IPv4 TCP packet in h (tot bytes), 0 if not one */
+static u16_t vj_tcp_hlen(const u8_t *h, u16_t tot)
+{
+    u16_t iphl = (u16_t)((h[0] & 0x0F) * 4);
+    u16_t hl;
+
+    if (tot < 40 || (h[0] >> 4) != 4 || iphl < 20 || tot < iphl + 20) {
+        return 0;
+    }
+    hl = (u16_t)(iphl + (h[iphl + 12] >> 4) * 4);
+    if ((h[iphl + 12] >> 4) < 5 || tot < hl) {
+        return 0;
+    }
+    return hl;
+}
+
+/*
+ * Compression (RFC 1144 sl_compress_tcp, as Linux slhc_compress)
+ *
+ * h holds the first VJ_HDR_MAX bytes of a tot-byte packet. Returns the
+ * length of the header to send in place of the first *skip bytes, or 0
+ * to send the packet unchanged.
+ */
+static u16_t vj_compress(const u8_t *h, u16_t tot, u8_t *out, u16_t *skip)
+{
+    u8_t deltas[15], *cp = deltas, *o;
+    const u8_t *th, *oth;
+    vj_slot_t *cs = NULL;
+    u16_t hl, iphl, d;
+    u32_t delta_s = 0, delta_a = 0;
+    u8_t changes = 0, id = 0, i;
+
+    if (h[9] != 6 || (get16(h + 6) & 0x3FFF) || (hl = vj_tcp_hlen(h, tot)) == 0) {
+        return 0;                       /* Not TCP, or a fragment */
+    }
+    iphl = (u16_t)((h[0] & 0x0F) * 4);
+    th = h + iphl;
+    if ((th[13] & (TH_SYN | TH_FIN | TH_RST | TH_ACK)) != TH_ACK) {
+        return 0;                       /* Connection setup and teardown */
+    }
+
+    /* Connection: addresses and ports; the least recently used otherwise */
+    for (i = 0; i < VJ_TX_SLOTS; i++) {
+        vj_slot_t *s = &vj_tx[vj_tx_lru[i]];
+
+        if (s->hlen && memcmp(s->hdr + 12, h + 12, 8) == 0 &&
+            memcmp(s->hdr + ((s->hdr[0] & 0x0F) * 4), th, 4) == 0) {
+            cs = s;
+            break;
+        }
+    }
+    if (i == VJ_TX_SLOTS) {
+        i = VJ_TX_SLOTS - 1;
+    }
+    id = vj_tx_lru[i];
+    memmove(&vj_tx_lru[1], &vj_tx_lru[0], i);
+    vj_tx_lru[0] = id;
+    if (cs == NULL) {
+        cs = &vj_tx[id];
+        goto uncompressed;
+    }
+    oth = cs->hdr + iphl;
+
+    /* Anything that is not a delta: send the whole header */
+    if (cs->hlen != hl || h[0] != cs->hdr[0] || h[1] != cs->hdr[1] ||
+        (h[6] & 0x40) != (cs->hdr[6] & 0x40) || h[8] != cs->hdr[8] ||
+        th[12] != oth[12] ||
+        memcmp(h + 20, cs->hdr + 20, iphl - 20) != 0 ||
+        memcmp(th + 20, oth + 20, hl - iphl - 20) != 0) {
+        goto uncompressed;
+    }
+
+    if (th[13] & TH_URG) {
+        cp = vj_encode(cp, get16(th + 18));
+        changes |= NEW_U;
+    } else if (get16(th + 18) != get16(oth + 18)) {
+        goto uncompressed;
+    }
+    if ((d = (u16_t)(get16(th + 14) - get16(oth + 14))) != 0) {
+        cp = vj_encode(cp, d);
+        changes |= NEW_W;
+    }
+    if ((delta_a = get32(th + 8) - get32(oth + 8)) != 0) {
+        if (delta_a > 0xFFFF) {
+            goto uncompressed;
+        }
+        cp = vj_encode(cp, (u16_t)delta_a);
+        changes |= NEW_A;
+    }
+    if ((delta_s = get32(th + 4) - get32(oth + 4)) != 0) {
+        if (delta_s > 0xFFFF) {
+            goto uncompressed;
+        }
+        cp = vj_encode(cp, (u16_t)delta_s);
+        changes |= NEW_S;
+    }
+
+    /* The last packet's data length implied by the special encodings */
+    d = (u16_t)(get16(cs->hdr + 2) - hl);
+    switch (changes) {
+    case 0:
+        /* Data after a bare ACK is new; anything else repeats a packet the
+         * peer may have missed, so it goes out in full */
+        if (tot != get16(cs->hdr + 2) && d == 0) {
+            break;
+        }
+        goto uncompressed;
+    case SPECIAL_I:
+    case SPECIAL_D:
+        goto uncompressed;              /* Would read as the special case */
+    case NEW_S | NEW_A:
+        if (delta_s == delta_a && delta_s == d) {
+            changes = SPECIAL_I;
+            cp = deltas;
+        }
+        break;
+    case NEW_S:
+        if (delta_s == d) {
+            changes = SPECIAL_D;
+            cp = deltas;
+        }
+        break;
+    }
+
+    if ((d = (u16_t)(get16(h + 4) - get16(cs->hdr + 4))) != 1) {
+        cp = vj_encode(cp, d);
+        changes |= NEW_I;
+    }
+    if (th[13] & TH_PSH) {
+        changes |= NEW_P;
+    }
+
+    memcpy(cs->hdr, h, hl);
+    o = out;
+    if (vj_tx_last != id) {
+        *o++ = TYPE_COMPRESSED | NEW_C | changes;
+        *o++ = id;
+        vj_tx_last = id;
+    } else {
+        *o++ = TYPE_COMPRESSED | changes;
+    }
+    *o++ = th[16];                      /* TCP checksum as sent */
+    *o++ = th[17];
+    memcpy(o, deltas, (size_t)(cp - deltas));
+    o += cp - deltas;
+
+    *skip = hl;
+    vj_stats.out_compressed++;
+    vj_stats.out_saved += hl - (u32_t)(o - out);
+    return (u16_t)(o - out);
+
+uncompressed:
+    memcpy(cs->hdr, h, hl);
+    cs->hlen = (u8_t)hl;
+    vj_tx_last = id;
+    memcpy(out, h, hl);
+    out[0] = (u8_t)(TYPE_UNCOMPRESSED | (h[0] & 0x0F));
+    out[9] = id;                        /* IP checksum stays the sender's */
+
+    *skip = hl;
+    vj_stats.out_uncompressed++;
+    return hl;
+}
+
+/*
+ * Decompression (RFC 1144 sl_uncompress_tcp, as Linux slhc_uncompress)
+ */
+
+static void vj_toss(void)
+{
+    vj_rx_toss = 1;
+    vj_stats.in_errors++;
+}
+
+/* UNCOMPRESSED_TCP: restore the protocol byte, remember the header */
+static int vj_remember(u8_t *h, u16_t tot)
+{
+    u16_t hl;
+    u8_t id = h[9];
+
+    h[0] = (u8_t)(TYPE_IP | (h[0] & 0x0F));
+    h[9] = 6;
+    if (id >= VJ_RX_SLOTS || (hl = vj_tcp_hlen(h, tot)) == 0 ||
+        inet_chksum(h, (u16_t)((h[0] & 0x0F) * 4)) != 0) {
+        vj_toss();
+        return 0;
+    }
+
+    memcpy(vj_rx[id].hdr, h, hl);
+    vj_rx[id].hlen = (u8_t)hl;
+    vj_rx_last = id;
+    vj_rx_toss = 0;
+    vj_stats.in_uncompressed++;
+    return 1;
+}
+
+/*
+ * COMPRESSED_TCP: c holds the first n bytes of a tot-byte frame. Rebuilds
+ * the slot's header for this packet; returns the compressed header length
+ * (0: drop the frame) with the slot in *slot.
+ */
+static u16_t vj_uncompress(const u8_t *c, u16_t n, u16_t tot, vj_slot_t **slot)
+{
+    const u8_t *cp = c, *end = c + n;
+    u8_t changes = *cp++;
+    vj_slot_t *cs;
+    u8_t *th;
+    u16_t hl, iphl, v, len;
+
+    if (changes & NEW_C) {
+        if (cp >= end || *cp >= VJ_RX_SLOTS || vj_rx[*cp].hlen == 0) {
+            vj_toss();
+            return 0;
+        }
+        vj_rx_last = *cp++;
+        vj_rx_toss = 0;
+    } else if (vj_rx_toss) {
+        vj_stats.in_tossed++;
+        return 0;
+    }
+
+    cs = &vj_rx[vj_rx_last];
+    hl = cs->hlen;
+    iphl = (u16_t)((cs->hdr[0] & 0x0F) * 4);
+    th = cs->hdr + iphl;
+    if (end - cp < 2) {
+        vj_toss();
+        return 0;
+    }
+    th[16] = *cp++;
+    th[17] = *cp++;
+    th[13] = (u8_t)((changes & NEW_P) ? (th[13] | TH_PSH) : (th[13] & ~TH_PSH));
+
+    len = (u16_t)(get16(cs->hdr + 2) - hl);  /* Last packet's data */
+    switch (changes & SPECIALS_MASK) {
+    case SPECIAL_I:
+        put32(th + 8, get32(th + 8) + len);
+        put32(th + 4, get32(th + 4) + len);
+        break;
+    case SPECIAL_D:
+        put32(th + 4, get32(th + 4) + len);
+        break;
+    default:
+        if (changes & NEW_U) {
+            if (!vj_decode(&cp, end, &v)) goto bad;
+            th[13] |= TH_URG;
+            put16(th + 18, v);
+        } else {
+            th[13] &= ~TH_URG;
+        }
+        if (changes & NEW_W) {
+            if (!vj_decode(&cp, end, &v)) goto bad;
+            put16(th + 14, (u16_t)(get16(th + 14) + v));
+        }
+        if (changes & NEW_A) {
+            if (!vj_decode(&cp, end, &v)) goto bad;
+            put32(th + 8, get32(th + 8) + v);
+        }
+        if (changes & NEW_S) {
+            if (!vj_decode(&cp, end, &v)) goto bad;
+            put32(th + 4, get32(th + 4) + v);
+        }
+        break;
+    }
+    if (changes & NEW_I) {
+        if (!vj_decode(&cp, end, &v)) goto bad;
+    } else {
+        v = 1;
+    }
+    put16(cs->hdr + 4, (u16_t)(get16(cs->hdr + 4) + v));
+
+    /* New length and IP checksum (the TCP checksum came with the frame) */
+    len = (u16_t)(tot - (cp - c));
+    put16(cs->hdr + 2, (u16_t)(hl + len));
+    cs->hdr[10] = 0;
+    cs->hdr[11] = 0;
+    v = inet_chksum(cs->hdr, iphl);
+    memcpy(cs->hdr + 10, &v, 2);        /* Already in network order */
+
+    *slot = cs;
+    vj_stats.in_compressed++;
+    return (u16_t)(cp - c);
+
+bad:
+    vj_toss();
+    return 0;
+}
+
+/*
+ * netif hooks
+ */
+
+static err_t slip_vj_input(struct pbuf *p, struct netif *inp)
+{
+    u8_t h[VJ_HDR_MAX];
+    u8_t type = pbuf_get_at(p, 0);
+    u16_t n;
+
+    if ((type & 0xF0) == TYPE_IP) {
+        return vj_next_input(p, inp);
+    }
+    if (vj_mode == SLIP_VJ_OFF) {
+        pbuf_free(p);                   /* Not IPv4, as plain SLIP sees it */
+        return ERR_OK;
+    }
+    if (vj_mode == SLIP_VJ_AUTO) {
+        vj_active = 1;                  /* The peer speaks CSLIP */
+    }
+
+    if (type & TYPE_COMPRESSED) {
+        vj_slot_t *cs;
+        struct pbuf *q;
+
+        n = pbuf_copy_partial(p, h, VJ_CHDR_MAX, 0);
+        if ((n = vj_uncompress(h, n, p->tot_len, &cs)) == 0) {
+            pbuf_free(p);
+            return ERR_OK;
+        }
+
+        /* Rebuilt header and the data in one pbuf: applications read
+         * small segments straight from the first payload */
+        q = pbuf_alloc(PBUF_RAW, (u16_t)(cs->hlen + p->tot_len - n), PBUF_RAM);
+        if (q == NULL) {
+            vj_rx_toss = 1;             /* The slot moved on without us */
+            pbuf_free(p);
+            return ERR_OK;
+        }
+        memcpy(q->payload, cs->hdr, cs->hlen);
+        pbuf_copy_partial(p, (u8_t *)q->payload + cs->hlen, p->tot_len - n, n);
+        pbuf_free(p);
+        return vj_next_input(q, inp);
+    }
+
+    if (type >= TYPE_UNCOMPRESSED) {
+        pbuf_copy_partial(p, h, VJ_HDR_MAX, 0);
+        if (!vj_remember(h, p->tot_len)) {
+            pbuf_free(p);
+            return ERR_OK;
+        }
+        pbuf_put_at(p, 0, h[0]);
+        pbuf_put_at(p, 9, h[9]);
+        return vj_next_input(p, inp);
+    }
+
+    vj_stats.in_errors++;               /* 0x50 / 0x60: no such type */
+    pbuf_free(p);
+    return ERR_OK;
+}
+
+static err_t slip_vj_output(struct netif *netif, struct pbuf *p, const ip4_addr_t *ipaddr)
+{
+    u8_t h[VJ_HDR_MAX];
+    struct pbuf *q;
+    u16_t hlen, skip;
+    err_t err;
+
+    if (!vj_active || p->tot_len < 40) {
+        vj_stats.out_ip++;
+        return vj_next_output(netif, p, ipaddr);
+    }
+
+    /* Room first: once the slot has this header the frame must go out */
+    q = pbuf_alloc(PBUF_RAW, p->tot_len, PBUF_RAM);
+    if (q == NULL) {
+        return ERR_MEM;
+    }
+
+    pbuf_copy_partial(p, h, VJ_HDR_MAX, 0);
+    hlen = vj_compress(h, p->tot_len, (u8_t *)q->payload, &skip);
+    if (hlen == 0) {
+        pbuf_free(q);
+        vj_stats.out_ip++;
+        return vj_next_output(netif, p, ipaddr);
+    }
+
+    pbuf_copy_partial(p, (u8_t *)q->payload + hlen, p->tot_len - skip, skip);
+    pbuf_realloc(q, (u16_t)(hlen + p->tot_len - skip));
+    err = vj_next_output(netif, q, ipaddr);
+    pbuf_free(q);
+    return err;
+}
+
+void slip_vj_attach(struct netif *netif, int mode)
+{
+    u8_t i;
+
+    for (i = 0; i < VJ_TX_SLOTS; i++) {
+        vj_tx_lru[i] = i;
+        vj_tx[i].hlen = 0;
+    }
+    for (i = 0; i < VJ_RX_SLOTS; i++) {
+        vj_rx[i].hlen = 0;
+    }
+    vj_tx_last = 0xFF;
+    vj_rx_toss = 1;
+    memset(&vj_stats, 0, sizeof(vj_stats));
+
+    vj_next_input = netif->input;
+    vj_next_output = netif->output;
+    netif->input = slip_vj_input;
+    netif->output = slip_vj_output;
+    slip_vj_set_mode(mode);
+}
+
+void slip_vj_set_mode(int mode)
+{
+    vj_mode = mode;
+    vj_active = (mode == SLIP_VJ_ON);
+}
+
+int slip_vj_active(void)
+{
+    return vj_active;
+}
+
+const slip_vj_stats_t *slip_vj_stats(void)
+{
+    return &vj_stats;
+}
+
+#endif /* SLIP_VJ */
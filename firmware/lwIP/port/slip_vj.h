@@ -0,0 +1,50 @@
+/*
+ * Van Jacobson TCP/IP header compression (RFC 1144, CSLIP) for the SLIP netif
+ *
+ * Copyright (c) October 2025 Michael Wolak
+ */
+
+#ifndef SLIP_VJ_H
+#define SLIP_VJ_H
+
+#include "lwip/opt.h"
+#include "lwip/netif.h"
+
+#ifndef SLIP_VJ
+#define SLIP_VJ                 1
+#endif
+
+/*
+ * SLIP_VJ_AUTO (default) decompresses whatever arrives and starts
+ * compressing once the peer has sent a CSLIP frame, as Linux's adaptive
+ * mode does, so the same firmware talks to slattach_1m -p slip and
+ * -p cslip. SLIP_VJ_ON compresses from the first packet.
+ */
+#define SLIP_VJ_OFF             0
+#define SLIP_VJ_AUTO            1
+#define SLIP_VJ_ON              2
+
+typedef struct {
+    u32_t out_ip;               /* Sent unchanged (not TCP, SYN/FIN/RST, ...) */
+    u32_t out_uncompressed;     /* Sent as UNCOMPRESSED_TCP (slot refresh) */
+    u32_t out_compressed;       /* Sent as COMPRESSED_TCP */
+    u32_t out_saved;            /* Header bytes not sent */
+    u32_t in_uncompressed;
+    u32_t in_compressed;
+    u32_t in_errors;            /* Bad CSLIP frames */
+    u32_t in_tossed;            /* Compressed frames dropped until the next NEW_C */
+} slip_vj_stats_t;
+
+/*
+ * slip_vj_attach - Put the compressor between the netif and SLIP
+ *
+ * Call from the netif init function once output is set: netif->input
+ * and netif->output are wrapped, the previous ones do the rest.
+ */
+void slip_vj_attach(struct netif *netif, int mode);
+
+void slip_vj_set_mode(int mode);
+int slip_vj_active(void);       /* Compressing (SLIP_VJ_ON, or AUTO after CSLIP from the peer) */
+const slip_vj_stats_t *slip_vj_stats(void);
+
+#endif /* SLIP_VJ_H */
@@ -0,0 +1,594 @@
+/*
+ * Zero-copy static file HTTP server for lwIP (see static_httpd.h)
+ *
+ * Request handling: received pbufs are chained until the blank line that
+ * ends the request header (at most STATIC_HTTPD_MAX_REQ bytes), then the
+ * request line and headers are read straight out of the chain. Once a
+ * request is answered its bytes are freed from the head of the chain,
+ * which leaves the next pipelined request at offset 0; requests are taken
+ * one at a time, in order, while no response is running.
+ *
+ * Flow control: received bytes are acknowledged to TCP (tcp_recved) while
+ * the chain holds at most STATIC_HTTPD_MAX_REQ bytes. Beyond that they are
+ * held back until a request is consumed, so a client that pipelines
+ * faster than the board answers sees the window close, and a connection
+ * never keeps more than STATIC_HTTPD_MAX_REQ + TCP_WND bytes of pbufs.
+ *
+ * Sending: static_httpd_send() queues as much body as the send buffer and
+ * TCP_SND_QUEUELEN allow, and runs again from tcp_sent() and tcp_poll()
+ * until the body is out. Then a keep-alive connection goes on with the
+ * next request and any other is closed (lwIP sends what is still queued,
+ * then FIN). ROM bodies are queued by reference, so the only copies are
+ * the response header and streamed chunks.
+ *
+ * Copyright (c) October 2025 Michael Wolak
+ */
+
+#include "lwip/opt.h"
+#include "lwip/tcp.h"
+#include "lwip/pbuf.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include "static_httpd.h"
+
+#define STATIC_HTTPD_MAX_REQ    1024    /* Buffered request bytes (400 if one is longer) */
+#define STATIC_HTTPD_POLL       4       /* tcp_poll interval (x 500 ms) */
+#define STATIC_HTTPD_TIMEOUT    8       /* Polls without send progress before abort (16 s) */
+#define STATIC_HTTPD_HDR_MAX    256     /* Response header, send buffer needed to start one */
+
+#if STATIC_HTTPD_CONNS >= MEMP_NUM_TCP_PCB
+#error "STATIC_HTTPD_CONNS must leave TCP pcbs for closing connections (MEMP_NUM_TCP_PCB)"
+#endif
+
+struct static_httpd_conn {
+    struct tcp_pcb *pcb;                /* NULL: slot free */
+    struct pbuf *req;                   /* Request header received so far */
+    const u8_t *data;                   /* ROM body, or NULL when streamed */
+    void *stream;                       /* Stream handle */
+    u32_t left;                         /* Body bytes not yet queued */
+    u16_t chunk_off;                    /* Streamed chunk: next byte to queue */
+    u16_t chunk_len;
+    u16_t held;                         /* Received bytes not yet passed to tcp_recved() */
+    u8_t idle;                          /* Polls without progress */
+    u8_t keep;                          /* Keep the connection after this response */
+    u8_t served;                        /* Responses started on this connection */
+    u8_t eof;                           /* Peer closed: answer what is buffered, then close */
+    u8_t chunk[STATIC_HTTPD_CHUNK];
+};
+
+static struct static_httpd_conn conns[STATIC_HTTPD_CONNS];
+static const struct static_httpd_file *rom_files = NULL;
+static const struct static_httpd_stream *stream_ops = NULL;
+
+static const u8_t body_404[] = "<html><body><h1>404 Not Found</h1></body></html>\r\n";
+
+/*
+ * Connection slots
+ */
+
+static struct static_httpd_conn *conn_alloc(struct tcp_pcb *pcb)
+{
+    int i;
+
+    for (i = 0; i < STATIC_HTTPD_CONNS; i++) {
+        if (conns[i].pcb == NULL) {
+            memset(&conns[i], 0, offsetof(struct static_httpd_conn, chunk));
+            conns[i].pcb = pcb;
+            return &conns[i];
+        }
+    }
+
+    return NULL;
+}
+
+static void conn_free(struct static_httpd_conn *hs)
+{
+    if (hs->req != NULL) {
+        pbuf_free(hs->req);
+    }
+    if (hs->stream != NULL && stream_ops != NULL) {
+        stream_ops->close(hs->stream);
+    }
+    hs->req = NULL;
+    hs->stream = NULL;
+    hs->pcb = NULL;
+}
+
+static int responding(const struct static_httpd_conn *hs)
+{
+    return hs->data != NULL || hs->stream != NULL;
+}
+
+/* Body fully queued on a keep-alive connection: ready for the next request */
+static void response_done(struct static_httpd_conn *hs)
+{
+    if (hs->stream != NULL) {
+        stream_ops->close(hs->stream);
+    }
+    hs->data = NULL;
+    hs->stream = NULL;
+    hs->chunk_off = hs->chunk_len = 0;
+    tcp_output(hs->pcb);                /* The header may sit behind TCP_WRITE_FLAG_MORE */
+}
+
+/* tcp_close() only fails when out of memory: try again every poll */
+static err_t close_retry(void *arg, struct tcp_pcb *pcb)
+{
+    (void)arg;
+
+    tcp_close(pcb);
+    return ERR_OK;
+}
+
+static void conn_close(struct static_httpd_conn *hs)
+{
+    struct tcp_pcb *pcb = hs->pcb;
+
+    tcp_arg(pcb, NULL);
+    tcp_recv(pcb, NULL);
+    tcp_sent(pcb, NULL);
+    tcp_poll(pcb, NULL, 0);
+    tcp_err(pcb, NULL);
+    conn_free(hs);
+
+    if (tcp_close(pcb) != ERR_OK) {
+        tcp_poll(pcb, close_retry, 1);
+    }
+}
+
+/* All slots busy: close the keep-alive connection that has idled longest */
+static int conn_reclaim(void)
+{
+    struct static_httpd_conn *old = NULL;
+    int i;
+
+    for (i = 0; i < STATIC_HTTPD_CONNS; i++) {
+        struct static_httpd_conn *hs = &conns[i];
+
+        if (hs->pcb != NULL && hs->served && !responding(hs) && hs->req == NULL &&
+            (old == NULL || hs->idle > old->idle)) {
+            old = hs;
+        }
+    }
+
+    if (old == NULL) {
+        return 0;
+    }
+    conn_close(old);
+    return 1;
+}
+
+/*
+ * Body output
+ */
+
+/*
+ * Queue body data; returns 0 when the connection was closed. A finished
+ * keep-alive response leaves the connection idle (responding() false).
+ */
+static int static_httpd_send(struct static_httpd_conn *hs)
+{
+    struct tcp_pcb *pcb = hs->pcb;
+    int queued = 0;
+
+    while (hs->left || hs->chunk_off < hs->chunk_len) {
+        u16_t room = tcp_sndbuf(pcb);
+        u16_t n;
+        err_t err;
+
+        if (room == 0 || tcp_sndqueuelen(pcb) >= TCP_SND_QUEUELEN - 1) {
+            break;
+        }
+
+        if (hs->data != NULL) {
+            /* ROM: queue a reference, no copy */
+            n = (hs->left > room) ? room : (u16_t)hs->left;
+            if (n > TCP_MSS) n = TCP_MSS;
+            err = tcp_write(pcb, hs->data, n, (hs->left > n) ? TCP_WRITE_FLAG_MORE : 0);
+            if (err != ERR_OK) {
+                break;
+            }
+            hs->data += n;
+            hs->left -= n;
+        } else {
+            /* Streamed: refill the chunk once it has all been queued */
+            if (hs->chunk_off == hs->chunk_len) {
+                u32_t want = (hs->left > STATIC_HTTPD_CHUNK) ? STATIC_HTTPD_CHUNK : hs->left;
+                int got = stream_ops->read(hs->stream, hs->chunk, want);
+
+                if (got <= 0) {
+                    conn_close(hs);     /* File shrank or read error */
+                    return 0;
+                }
+                hs->chunk_off = 0;
+                hs->chunk_len = (u16_t)got;
+                hs->left -= (u32_t)got;
+            }
+
+            n = hs->chunk_len - hs->chunk_off;
+            if (n > room) n = room;
+            err = tcp_write(pcb, hs->chunk + hs->chunk_off, n, TCP_WRITE_FLAG_COPY |
+                            ((hs->left || hs->chunk_off + n < hs->chunk_len) ? TCP_WRITE_FLAG_MORE : 0));
+            if (err != ERR_OK) {
+                break;                  /* Retried from tcp_sent / tcp_poll */
+            }
+            hs->chunk_off += n;
+        }
+        queued = 1;
+    }
+
+    if (queued) {
+        hs->idle = 0;
+        tcp_output(pcb);
+    }
+
+    if (hs->left == 0 && hs->chunk_off == hs->chunk_len) {
+        if (!hs->keep) {
+            conn_close(hs);
+            return 0;
+        }
+        response_done(hs);
+    }
+
+    return 1;
+}
+
+/*
+ * Request handling
+ */
+
+static const char *type_from_path(const char *path)
+{
+    const char *ext = strrchr(path, '.');
+
+    if (ext == NULL) return "application/octet-stream";
+    if (!strcmp(ext, ".html") || !strcmp(ext, ".htm")) return "text/html";
+    if (!strcmp(ext, ".css")) return "text/css";
+    if (!strcmp(ext, ".js")) return "application/javascript";
+    if (!strcmp(ext, ".txt")) return "text/plain";
+    if (!strcmp(ext, ".json")) return "application/json";
+    if (!strcmp(ext, ".png")) return "image/png";
+    if (!strcmp(ext, ".ico")) return "image/x-icon";
+    return "application/octet-stream";
+}
+
+/* 1 if header name (with the colon) is in this request and lists token, any case */
+static int header_lists(struct pbuf *req, u16_t hdr_end, const char *name, const char *token)
+{
+    char value[64];
+    u16_t pos = pbuf_memfind(req, name, (u16_t)strlen(name), 0);
+    u16_t tlen = (u16_t)strlen(token);
+    u16_t eol, n, i;
+
+    if (pos == 0xFFFF || pos > hdr_end) {
+        return 0;
+    }
+    pos += (u16_t)strlen(name);
+    eol = pbuf_memfind(req, "\r\n", 2, pos);
+    n = eol - pos;
+    if (n > sizeof(value)) n = sizeof(value);
+    n = pbuf_copy_partial(req, value, n, pos);
+
+    for (i = 0; i + tlen <= n; i++) {
+        if (!strncasecmp(value + i, token, tlen)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static err_t send_header(struct static_httpd_conn *hs, const char *status,
+                         const char *type, u8_t flags, u32_t len)
+{
+    char hdr[STATIC_HTTPD_HDR_MAX];
+    int n;
+
+    n = snprintf(hdr, sizeof(hdr),
+                 "HTTP/1.1 %s\r\n"
+                 "Server: lwIP/PicoRV32\r\n"
+                 "Content-Type: %s\r\n"
+                 "Content-Length: %lu\r\n"
+                 "%s",
+                 status, type, (unsigned long)len,
+                 (flags & STATIC_HTTPD_GZIP) ? "Content-Encoding: gzip\r\n" : "");
+    if (hs->keep) {
+        n += snprintf(hdr + n, sizeof(hdr) - n,
+                      "Connection: keep-alive\r\n"
+                      "Keep-Alive: timeout=%d, max=%d\r\n\r\n",
+                      STATIC_HTTPD_KEEPALIVE * STATIC_HTTPD_POLL / 2,
+                      STATIC_HTTPD_KEEPALIVE_MAX - hs->served);
+    } else {
+        n += snprintf(hdr + n, sizeof(hdr) - n, "Connection: close\r\n\r\n");
+    }
+
+    return tcp_write(hs->pcb, hdr, (u16_t)n, TCP_WRITE_FLAG_COPY | TCP_WRITE_FLAG_MORE);
+}
+
+/* Whole request header received: pick the file and start the response */
+static void handle_request(struct static_httpd_conn *hs, u16_t hdr_end)
+{
+    const struct static_httpd_file *f;
+    char line[96];
+    char *path, *end;
+    const char *type = NULL;
+    u8_t flags = 0;
+    u32_t len = 0;
+    int head, http11;
+    u16_t n;
+
+    n = pbuf_copy_partial(hs->req, line, sizeof(line) - 1, 0);
+    line[n] = '\0';
+    end = strstr(line, "\r\n");
+    if (end != NULL) *end = '\0';
+
+    /* HTTP/1.1 keeps the connection unless told otherwise, 1.0 only if asked */
+    http11 = strstr(line, " HTTP/1.1") != NULL;
+    hs->keep = ++hs->served < STATIC_HTTPD_KEEPALIVE_MAX &&
+               (http11 ? !header_lists(hs->req, hdr_end, "Connection:", "close")
+                       : header_lists(hs->req, hdr_end, "Connection:", "keep-alive"));
+
+    head = !strncmp(line, "HEAD ", 5);
+    if (!head && strncmp(line, "GET ", 4)) {
+        hs->keep = 0;                   /* A body may follow: not worth parsing */
+        send_header(hs, "501 Not Implemented", "text/plain", 0, 0);
+        hs->left = 0;
+        static_httpd_send(hs);
+        return;
+    }
+
+    path = line + (head ? 5 : 4);
+    end = strchr(path, ' ');
+    if (end != NULL) *end = '\0';
+    end = strchr(path, '?');
+    if (end != NULL) *end = '\0';
+    if (!strcmp(path, "/")) {
+        path = "/index.html";
+    }
+
+    /* ROM table first, then the stream */
+    for (f = rom_files; f != NULL && f->path != NULL; f++) {
+        if (!strcmp(f->path, path)) {
+            break;
+        }
+    }
+
+    if (f != NULL && f->path != NULL) {
+        hs->data = f->data;
+        type = f->type;
+        flags = f->flags;
+        len = f->len;
+    } else if (stream_ops != NULL &&
+               (hs->stream = stream_ops->open(path, &len, &type, &flags)) != NULL) {
+        hs->data = NULL;
+        hs->chunk_off = hs->chunk_len = 0;
+    } else {
+        hs->data = body_404;
+        send_header(hs, "404 Not Found", "text/html", 0, sizeof(body_404) - 1);
+        hs->left = head ? 0 : sizeof(body_404) - 1;
+        static_httpd_send(hs);
+        return;
+    }
+
+    if ((flags & STATIC_HTTPD_GZIP) && !header_lists(hs->req, hdr_end, "Accept-Encoding:", "gzip")) {
+        send_header(hs, "406 Not Acceptable", "text/plain", 0, 0);
+        hs->left = 0;
+        static_httpd_send(hs);
+        return;
+    }
+
+    if (type == NULL) {
+        type = type_from_path(path);
+    }
+    if (send_header(hs, "200 OK", type, flags, len) != ERR_OK) {
+        conn_close(hs);
+        return;
+    }
+
+    hs->left = head ? 0 : len;
+    static_httpd_send(hs);
+}
+
+/* Answer the complete requests at the head of the chain, in order */
+static void process_requests(struct static_httpd_conn *hs)
+{
+    u16_t hdr_end;
+
+    while (hs->pcb != NULL && !responding(hs)) {
+        hdr_end = (hs->req != NULL) ? pbuf_memfind(hs->req, "\r\n\r\n", 4, 0) : 0xFFFF;
+
+        if (hdr_end == 0xFFFF) {
+            if (hs->req != NULL && hs->req->tot_len > STATIC_HTTPD_MAX_REQ) {
+                hs->keep = 0;
+                send_header(hs, "400 Bad Request", "text/plain", 0, 0);
+                static_httpd_send(hs);
+            } else if (hs->eof) {
+                conn_close(hs);         /* Everything the peer sent is answered */
+            }
+            return;
+        }
+
+        /* Start a response only with room for its header: tcp_sent() comes back */
+        if (tcp_sndbuf(hs->pcb) < STATIC_HTTPD_HDR_MAX ||
+            tcp_sndqueuelen(hs->pcb) >= TCP_SND_QUEUELEN - 1) {
+            return;
+        }
+
+        handle_request(hs, hdr_end);
+        if (hs->pcb == NULL) {
+            return;                     /* Closed, request freed with it */
+        }
+
+        /* The body needs no request: drop it, the next one is now at offset 0 */
+        hs->req = pbuf_free_header(hs->req, hdr_end + 4);
+        if (hs->held) {
+            tcp_recved(hs->pcb, hs->held);
+            hs->held = 0;
+        }
+    }
+}
+
+/*
+ * TCP callbacks
+ */
+
+static err_t static_httpd_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
+{
+    struct static_httpd_conn *hs = (struct static_httpd_conn *)arg;
+
+    if (p == NULL) {
+        hs->eof = 1;                    /* Peer closed: pipelined requests still get answers */
+        if (!responding(hs)) {
+            process_requests(hs);
+        }
+        return ERR_OK;
+    }
+    if (err != ERR_OK) {
+        pbuf_free(p);
+        return err;
+    }
+
+    hs->idle = 0;
+    if (hs->req == NULL) {
+        hs->req = p;
+    } else {
+        pbuf_cat(hs->req, p);
+    }
+
+    /* Past the buffer bound the window stays closed until a request is consumed */
+    if (hs->req->tot_len <= STATIC_HTTPD_MAX_REQ) {
+        tcp_recved(pcb, p->tot_len);
+    } else {
+        hs->held += p->tot_len;
+    }
+
+    if (!responding(hs)) {
+        process_requests(hs);
+    }
+
+    return ERR_OK;
+}
+
+static err_t static_httpd_sent(void *arg, struct tcp_pcb *pcb, u16_t len)
+{
+    struct static_httpd_conn *hs = (struct static_httpd_conn *)arg;
+
+    (void)pcb;
+    (void)len;
+
+    if (responding(hs) && !static_httpd_send(hs)) {
+        return ERR_OK;
+    }
+    if (!responding(hs)) {
+        process_requests(hs);           /* Next pipelined request */
+    }
+    return ERR_OK;
+}
+
+static err_t static_httpd_poll(void *arg, struct tcp_pcb *pcb)
+{
+    struct static_httpd_conn *hs = (struct static_httpd_conn *)arg;
+
+    if (hs == NULL) {
+        tcp_abort(pcb);
+        return ERR_ABRT;
+    }
+
+    hs->idle++;
+    if (!responding(hs)) {
+        process_requests(hs);
+        if (hs->pcb != NULL && !responding(hs) && hs->idle > STATIC_HTTPD_KEEPALIVE) {
+            conn_close(hs);             /* Idle keep-alive, or a request that never ended */
+        }
+        return ERR_OK;
+    }
+
+    if (hs->idle > STATIC_HTTPD_TIMEOUT) {
+        conn_free(hs);
+        tcp_arg(pcb, NULL);
+        tcp_abort(pcb);
+        return ERR_ABRT;
+    }
+
+    /* Retry after ERR_MEM */
+    if (static_httpd_send(hs) && !responding(hs)) {
+        process_requests(hs);
+    }
+    return ERR_OK;
+}
+
+static void static_httpd_err(void *arg, err_t err)
+{
+    struct static_httpd_conn *hs = (struct static_httpd_conn *)arg;
+
+    (void)err;
+
+    if (hs != NULL) {
+        conn_free(hs);                  /* pcb is already gone */
+    }
+}
+
+static err_t static_httpd_accept(void *arg, struct tcp_pcb *pcb, err_t err)
+{
+    struct static_httpd_conn *hs;
+
+    (void)arg;
+
+    if (err != ERR_OK || pcb == NULL) {
+        return ERR_VAL;
+    }
+
+    hs = conn_alloc(pcb);
+    if (hs == NULL && conn_reclaim()) {
+        hs = conn_alloc(pcb);
+    }
+    if (hs == NULL) {
+        return ERR_MEM;                 /* All slots busy: lwIP drops it */
+    }
+
+    tcp_setprio(pcb, TCP_PRIO_MIN);
+    tcp_arg(pcb, hs);
+    tcp_recv(pcb, static_httpd_recv);
+    tcp_sent(pcb, static_httpd_sent);
+    tcp_err(pcb, static_httpd_err);
+    tcp_poll(pcb, static_httpd_poll, STATIC_HTTPD_POLL);
+
+    return ERR_OK;
+}
+
+/*
+ * Public interface
+ */
+
+err_t static_httpd_init(const struct static_httpd_file *files, u16_t port)
+{
+    struct tcp_pcb *pcb;
+    err_t err;
+
+    rom_files = files;
+
+    pcb = tcp_new();
+    if (pcb == NULL) {
+        return ERR_MEM;
+    }
+
+    err = tcp_bind(pcb, IP_ADDR_ANY, port);
+    if (err != ERR_OK) {
+        tcp_close(pcb);
+        return err;
+    }
+
+    pcb = tcp_listen(pcb);
+    if (pcb == NULL) {
+        return ERR_MEM;
+    }
+
+    tcp_accept(pcb, static_httpd_accept);
+    return ERR_OK;
+}
+
+void static_httpd_set_stream(const struct static_httpd_stream *stream)
+{
+    stream_ops = stream;
+}
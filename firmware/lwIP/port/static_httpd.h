@@ -0,0 +1,105 @@
+/*
+ * Zero-copy static file HTTP server for lwIP (NO_SYS, raw TCP API)
+ *
+ * Serves two kinds of files without allocating or copying whole bodies:
+ *
+ * - ROM files: bodies linked into .rodata are queued with tcp_write()
+ *   without TCP_WRITE_FLAG_COPY, so lwIP sends PBUF_ROM references to the
+ *   flash/SRAM image. Precompressed bodies (STATIC_HTTPD_GZIP) go out with
+ *   Content-Encoding: gzip to clients that accept it.
+ * - Streamed files: when no ROM file matches, the stream callbacks (FatFS
+ *   or any other store) are asked; the body is read STATIC_HTTPD_CHUNK
+ *   bytes at a time as tcp_sent() frees send buffer, so file size is not
+ *   limited by MEM_SIZE or the pbuf pool.
+ *
+ * Connection state lives in a static table (STATIC_HTTPD_CONNS): serving
+ * a page never calls mem_malloc(). Only GET and HEAD.
+ *
+ * Keep-alive: responses are HTTP/1.1 and the connection stays open for the
+ * next request (HTTP/1.1 without Connection: close, or HTTP/1.0 with
+ * Connection: keep-alive), up to STATIC_HTTPD_KEEPALIVE_MAX requests and
+ * STATIC_HTTPD_KEEPALIVE idle polls. Pipelined requests are answered in
+ * order, one response at a time. Reusing a connection saves the handshake
+ * and the TIME_WAIT pcb a close leaves behind; a new connection that finds
+ * every slot taken closes the keep-alive connection idle longest, so
+ * STATIC_HTTPD_CONNS stays below MEMP_NUM_TCP_PCB.
+ *
+ *   static const u8_t index_html[] = "<html>...</html>";
+ *   static const struct static_httpd_file files[] = {
+ *       { "/index.html", "text/html", 0, index_html, sizeof(index_html) - 1 },
+ *       { NULL, NULL, 0, NULL, 0 }
+ *   };
+ *   static_httpd_init(files, 80);
+ *
+ * FatFS streaming (one FIL per connection slot):
+ *
+ *   static FIL web_fil[STATIC_HTTPD_CONNS];
+ *   static void *sd_open(const char *path, u32_t *len, const char **type, u8_t *flags) {
+ *       for (int i = 0; i < STATIC_HTTPD_CONNS; i++)
+ *           if (web_fil[i].obj.fs == NULL && f_open(&web_fil[i], path, FA_READ) == FR_OK) {
+ *               *len = f_size(&web_fil[i]);
+ *               return &web_fil[i];
+ *           }
+ *       return NULL;
+ *   }
+ *   static int sd_read(void *h, u8_t *buf, u32_t len) {
+ *       UINT br;
+ *       return f_read((FIL *)h, buf, len, &br) == FR_OK ? (int)br : -1;
+ *   }
+ *   static void sd_close(void *h) { f_close((FIL *)h); }
+ *   static const struct static_httpd_stream sd_stream = { sd_open, sd_read, sd_close };
+ *   static_httpd_set_stream(&sd_stream);
+ *
+ * Copyright (c) October 2025 Michael Wolak
+ */
+
+#ifndef STATIC_HTTPD_H
+#define STATIC_HTTPD_H
+
+#include "lwip/opt.h"
+
+#ifndef STATIC_HTTPD_CONNS
+#define STATIC_HTTPD_CONNS      4       /* Simultaneous connections */
+#endif
+
+#ifndef STATIC_HTTPD_CHUNK
+#define STATIC_HTTPD_CHUNK      512     /* Streamed read size (per connection) */
+#endif
+
+#ifndef STATIC_HTTPD_KEEPALIVE
+#define STATIC_HTTPD_KEEPALIVE  3       /* Idle polls (2 s each) before an idle close */
+#endif
+
+#ifndef STATIC_HTTPD_KEEPALIVE_MAX
+#define STATIC_HTTPD_KEEPALIVE_MAX 100  /* Requests per connection, at most 255 */
+#endif
+
+/* File flags */
+#define STATIC_HTTPD_GZIP       0x01    /* Body is gzip: Content-Encoding: gzip */
+
+struct static_httpd_file {
+    const char *path;                   /* "/index.html"; NULL ends the table */
+    const char *type;                   /* Content-Type */
+    u8_t flags;
+    const u8_t *data;                   /* Stays valid while being sent */
+    u32_t len;
+};
+
+/*
+ * Streamed files. open() returns a handle (NULL: not found) and fills in
+ * the length; type defaults from the file extension and flags to 0 when
+ * left alone. read() returns the bytes read (0 at the end, <0 on error).
+ */
+struct static_httpd_stream {
+    void *(*open)(const char *path, u32_t *len, const char **type, u8_t *flags);
+    int (*read)(void *handle, u8_t *buf, u32_t len);
+    void (*close)(void *handle);
+};
+
+/* Start listening; files is a NULL-terminated table (may be NULL) */
+err_t static_httpd_init(const struct static_httpd_file *files, u16_t port);
+
+/* Fall back to stream for paths not in the ROM table (NULL: none) */
+void static_httpd_set_stream(const struct static_httpd_stream *stream);
+
+#endif /* STATIC_HTTPD_H */
@@ -9,7 +9,12 @@
 
 #include "lwip/opt.h"
 #include "lwip/sys.h"
+#include "lwip/timeouts.h"
 #include <stdint.h>
+#include "../../../lib/irq.h"
+#include "../../../lib/timer.h"
+#include "../../../lib/atomic.h"
+#include "../../../lib/hrtimer/hrtimer.h"
 
 /*
  * Timer Peripheral Registers
@@ -23,6 +28,15 @@
 #define TIMER_CNT       (*(volatile uint32_t*)(TIMER_BASE + 0x10))
 
 #define TIMER_CR_ENABLE (1 << 0)
+#define TIMER_CR_ONE_SHOT (1 << 1)
+#define TIMER_SR_UIF    (1 << 0)
+
+/* Longest event loop sleep with no lwIP timeout pending (sys_sleep_arm) */
+#ifndef SYS_SLEEP_MAX_MS
+#define SYS_SLEEP_MAX_MS 1000
+#endif
+
+static void sys_tick_isr(uint32_t source);
 
 /* PicoRV32 IRQ enable inline function */
 static inline void irq_enable(void) {
@@ -33,20 +47,27 @@ static inline void irq_enable(void) {
 /*
  * Initialize timer for 1 KHz tick (1 ms resolution)
  *
- * System clock: 50 MHz
- * Prescaler: 49 (divide by 50) → 1 MHz
+ * System clock: SYS_CLK_HZ (Kconfig, 50 MHz default)
+ * Prescaler: SYS_CLK_HZ / 1 MHz - 1 (49 at 50 MHz) → 1 MHz
  * Auto-reload: 999 (count 0-999) → 1 KHz tick
  *
  * IMPORTANT: Matches timer_clock.c initialization sequence
  */
+#ifndef SYS_CLK_HZ
+#define SYS_CLK_HZ 50000000
+#endif
+
 void sys_init_timing(void)
 {
     TIMER_CR = 0;               /* Disable timer */
     TIMER_SR = 0x01;            /* Clear any pending interrupt (UIF bit) */
-    TIMER_PSC = 49;             /* Prescaler: 50MHz / 50 = 1MHz */
+    TIMER_PSC = (SYS_CLK_HZ + 500000) / 1000000 - 1;   /* Prescaler: -> 1MHz */
     TIMER_ARR = 999;            /* Auto-reload: 1MHz / 1000 = 1KHz (1ms) */
     /* NOTE: Do NOT write to TIMER_CNT - it's read-only and causes lockup */
 
+    /* Demos without their own irq_handler() use the start.S dispatcher */
+    irq_register(IRQ_TIMER, sys_tick_isr, 8);
+
     irq_enable();               /* Enable interrupts globally */
     TIMER_CR = TIMER_CR_ENABLE; /* Start timer */
 }
@@ -60,12 +81,16 @@ static volatile u32_t ms_count = 0;
 /*
  * sys_now - Get current time in milliseconds
  *
- * INTERRUPT-DRIVEN: Returns millisecond counter incremented by IRQ handler
- * Does NOT read TIMER_CNT register (which causes lockup)
- * Matches timer_clock.c pattern
+ * Uses the hardware timebase through lib/hrtimer when the bitstream has
+ * it, so lwIP time keeps running with the tick IRQ masked and agrees with
+ * the deadlines of the rest of the firmware.
+ * Otherwise falls back to the counter incremented by the timer IRQ handler
+ * (matches timer_clock.c pattern)
  */
 u32_t sys_now(void)
 {
+    if (timebase_present())
+        return hrt_now_ms();
     return ms_count;
 }
 
@@ -80,6 +105,52 @@ void sys_timer_tick(void)
     ms_count++;
 }
 
+/* The same from the lib/irq.h dispatch table */
+static void sys_tick_isr(uint32_t source)
+{
+    (void)source;
+    TIMER_SR = TIMER_SR_UIF;
+    sys_timer_tick();
+}
+
+/*
+ * sys_sleep_arm - Set the timer to wake the event loop for the next
+ * lwIP timeout (slip_hw_wait_rx)
+ *
+ * With the timebase sys_now() does not need the tick, so channel 0
+ * becomes a one-shot that fires when the next timeout is due (at most
+ * SYS_SLEEP_MAX_MS from now) and an idle loop sleeps through the
+ * milliseconds in between. Without it the 1 ms tick keeps counting
+ * sys_now() and wakes the loop every millisecond. polled: the receive
+ * path has no interrupt, wake within 1 ms anyway. Returns 0 if a timeout
+ * is due already, so the caller must not sleep.
+ */
+int sys_sleep_arm(int polled)
+{
+    u32_t ms = sys_timeouts_sleeptime();
+
+    if (ms == 0) {
+        return 0;
+    }
+    if (!timebase_present()) {
+        return 1;
+    }
+
+    /* sys_now() rounds down, so this never wakes before the timeout */
+    if (ms > SYS_SLEEP_MAX_MS) {
+        ms = SYS_SLEEP_MAX_MS;
+    }
+    if (polled) {
+        ms = 1;
+    }
+    TIMER_CR = 0;
+    TIMER_SR = TIMER_SR_UIF;
+    TIMER_ARR = ms * 1000 - 1;
+    TIMER_CR = TIMER_CR_ENABLE | TIMER_CR_ONE_SHOT;
+
+    return 1;
+}
+
 /*
  * sys_init - Initialize sys layer
  *
@@ -94,33 +165,18 @@ void sys_init(void)
  * Critical Section Protection (NO_SYS mode)
  *
  * In NO_SYS mode, these provide thread-safety by disabling interrupts
- * Uses PicoRV32 custom 'maskirq' instruction
+ * (lib/atomic.h masked sections: maskirq, and a compiler barrier so the
+ * protected loads and stores stay inside)
  */
 
 /* Disable all interrupts and return previous interrupt state */
 sys_prot_t sys_arch_protect(void)
 {
-    sys_prot_t old_mask;
-
-    /* Read current interrupt mask and then disable all interrupts */
-    __asm__ volatile (
-        ".insn r 0x0B, 6, 3, %0, %1, x0"  /* maskirq rd, rs1 */
-        : "=r"(old_mask)                   /* output: old mask */
-        : "r"(~0u)                          /* input: new mask (disable all) */
-    );
-
-    return old_mask;
+    return atomic_irq_save();
 }
 
 /* Restore previous interrupt state */
 void sys_arch_unprotect(sys_prot_t pval)
 {
-    uint32_t dummy;
-
-    /* Restore previous interrupt mask */
-    __asm__ volatile (
-        ".insn r 0x0B, 6, 3, %0, %1, x0"  /* maskirq rd, rs1 */
-        : "=r"(dummy)                      /* output: discarded */
-        : "r"(pval)                        /* input: mask to restore */
-    );
+    atomic_irq_restore(pval);
 }
@@ -0,0 +1,237 @@
+/*
+ * System Architecture Layer for lwIP on FreeRTOS (NO_SYS 0)
+ *
+ * Semaphores, mutexes, mailboxes and threads for the tcpip thread, the
+ * netconn / socket API and slipif's RX thread, on the FreeRTOS kernel
+ * objects. Built instead of sys_arch.c when firmware/Makefile has
+ * USE_FREERTOS=1 USE_LWIP=1; the FreeRTOS tick (freertos_irq.c) is the
+ * time base, so nothing here owns a timer.
+ *
+ * Thread stack sizes (TCPIP_THREAD_STACKSIZE, ...) are in words, as for
+ * xTaskCreate(). Timeouts are in milliseconds, 0 = wait forever.
+ *
+ * Copyright (c) October 2025 Michael Wolak
+ */
+
+#include "lwip/opt.h"
+#include "lwip/sys.h"
+#include "lwip/err.h"
+#include <stdint.h>
+#include "../../../lib/timer.h"
+#include "../../../lib/atomic.h"
+#include "../../../lib/hrtimer/hrtimer.h"
+
+/* Milliseconds to ticks for a lwIP timeout (0 = forever), at least 1 */
+static TickType_t sys_ms_to_ticks(u32_t timeout)
+{
+    TickType_t ticks;
+
+    if (timeout == 0) {
+        return portMAX_DELAY;
+    }
+    ticks = pdMS_TO_TICKS(timeout);
+    return ticks ? ticks : 1;
+}
+
+/* Milliseconds since start, for the arch_*_wait return values */
+static u32_t sys_elapsed_ms(TickType_t start)
+{
+    return (u32_t)((xTaskGetTickCount() - start) * portTICK_PERIOD_MS);
+}
+
+/*
+ * sys_init - Called by tcpip_init() / lwip_init(); the kernel does it all
+ */
+void sys_init(void)
+{
+}
+
+/*
+ * sys_now - Milliseconds, from the timebase (lib/hrtimer) when the
+ * bitstream has it
+ */
+u32_t sys_now(void)
+{
+    if (timebase_present())
+        return hrt_now_ms();
+    return (u32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS);
+}
+
+/*
+ * Critical Section Protection (SYS_LIGHTWEIGHT_PROT)
+ *
+ * lib/atomic.h masked sections as in NO_SYS mode: work from tasks and
+ * ISRs alike, and memp / pbuf sections make no kernel calls, so the port's
+ * nesting count is not needed
+ */
+sys_prot_t sys_arch_protect(void)
+{
+    return atomic_irq_save();
+}
+
+void sys_arch_unprotect(sys_prot_t pval)
+{
+    atomic_irq_restore(pval);
+}
+
+/*
+ * Mutexes (LWIP_TCPIP_CORE_LOCKING, protected memory pools)
+ */
+err_t sys_mutex_new(sys_mutex_t *mutex)
+{
+    *mutex = xSemaphoreCreateMutex();
+    if (*mutex == NULL) {
+        SYS_STATS_INC(mutex.err);
+        return ERR_MEM;
+    }
+    SYS_STATS_INC_USED(mutex);
+    return ERR_OK;
+}
+
+void sys_mutex_lock(sys_mutex_t *mutex)
+{
+    xSemaphoreTake(*mutex, portMAX_DELAY);
+}
+
+void sys_mutex_unlock(sys_mutex_t *mutex)
+{
+    xSemaphoreGive(*mutex);
+}
+
+void sys_mutex_free(sys_mutex_t *mutex)
+{
+    SYS_STATS_DEC(mutex.used);
+    vSemaphoreDelete(*mutex);
+    *mutex = NULL;
+}
+
+/*
+ * Semaphores (binary, as lwIP uses them: count 0 or 1)
+ */
+err_t sys_sem_new(sys_sem_t *sem, u8_t count)
+{
+    *sem = xSemaphoreCreateBinary();
+    if (*sem == NULL) {
+        SYS_STATS_INC(sem.err);
+        return ERR_MEM;
+    }
+    if (count) {
+        xSemaphoreGive(*sem);
+    }
+    SYS_STATS_INC_USED(sem);
+    return ERR_OK;
+}
+
+void sys_sem_signal(sys_sem_t *sem)
+{
+    xSemaphoreGive(*sem);
+}
+
+u32_t sys_arch_sem_wait(sys_sem_t *sem, u32_t timeout)
+{
+    TickType_t start = xTaskGetTickCount();
+
+    if (xSemaphoreTake(*sem, sys_ms_to_ticks(timeout)) != pdTRUE) {
+        return SYS_ARCH_TIMEOUT;
+    }
+    return sys_elapsed_ms(start);
+}
+
+void sys_sem_free(sys_sem_t *sem)
+{
+    SYS_STATS_DEC(sem.used);
+    vSemaphoreDelete(*sem);
+    *sem = NULL;
+}
+
+/*
+ * Mailboxes: queues of message pointers
+ */
+err_t sys_mbox_new(sys_mbox_t *mbox, int size)
+{
+    *mbox = xQueueCreate((UBaseType_t)size, sizeof(void *));
+    if (*mbox == NULL) {
+        SYS_STATS_INC(mbox.err);
+        return ERR_MEM;
+    }
+    SYS_STATS_INC_USED(mbox);
+    return ERR_OK;
+}
+
+void sys_mbox_post(sys_mbox_t *mbox, void *msg)
+{
+    xQueueSendToBack(*mbox, &msg, portMAX_DELAY);
+}
+
+err_t sys_mbox_trypost(sys_mbox_t *mbox, void *msg)
+{
+    if (xQueueSendToBack(*mbox, &msg, 0) != pdTRUE) {
+        SYS_STATS_INC(mbox.err);
+        return ERR_MEM;
+    }
+    return ERR_OK;
+}
+
+err_t sys_mbox_trypost_fromisr(sys_mbox_t *mbox, void *msg)
+{
+    BaseType_t woken = pdFALSE;
+
+    if (xQueueSendToBackFromISR(*mbox, &msg, &woken) != pdTRUE) {
+        SYS_STATS_INC(mbox.err);
+        return ERR_MEM;
+    }
+    portYIELD_FROM_ISR(woken);
+    return ERR_OK;
+}
+
+u32_t sys_arch_mbox_fetch(sys_mbox_t *mbox, void **msg, u32_t timeout)
+{
+    TickType_t start = xTaskGetTickCount();
+    void *dummy;
+
+    if (msg == NULL) {
+        msg = &dummy;
+    }
+    if (xQueueReceive(*mbox, msg, sys_ms_to_ticks(timeout)) != pdTRUE) {
+        *msg = NULL;
+        return SYS_ARCH_TIMEOUT;
+    }
+    return sys_elapsed_ms(start);
+}
+
+u32_t sys_arch_mbox_tryfetch(sys_mbox_t *mbox, void **msg)
+{
+    void *dummy;
+
+    if (msg == NULL) {
+        msg = &dummy;
+    }
+    if (xQueueReceive(*mbox, msg, 0) != pdTRUE) {
+        *msg = NULL;
+        return SYS_MBOX_EMPTY;
+    }
+    return 0;
+}
+
+void sys_mbox_free(sys_mbox_t *mbox)
+{
+    SYS_STATS_DEC(mbox.used);
+    vQueueDelete(*mbox);
+    *mbox = NULL;
+}
+
+/*
+ * Threads: FreeRTOS tasks that never return
+ */
+sys_thread_t sys_thread_new(const char *name, lwip_thread_fn thread, void *arg,
+                            int stacksize, int prio)
+{
+    TaskHandle_t handle = NULL;
+
+    if (xTaskCreate(thread, name, (configSTACK_DEPTH_TYPE)stacksize, arg,
+                    (UBaseType_t)prio, &handle) != pdPASS) {
+        LWIP_PLATFORM_DIAG(("sys_thread_new: no memory for %s\n", name));
+        return NULL;
+    }
+    return handle;
+}
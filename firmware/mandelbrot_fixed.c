@@ -5,14 +5,20 @@
 // Controls:
 //   R: Reset to default view
 //   +/-: Adjust max iterations
+//   M: Next render mode (BRUTE / REJECT / TRACE)
+//   b: Time every render mode on the current view (B is the down arrow)
+//   Arrows: Pan, Z/X: Zoom in/out (only new cells are computed and sent)
 //   Q: Quit
 //==============================================================================
 
 #include <stdio.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include <curses.h>
 #include "timer_ms.h"
+#include "fixmath.h"
+#include "../lib/perf_counters.h"
 
 //==============================================================================
 // Hardware UART (required by incurses)
@@ -144,11 +150,15 @@ static const char* PALETTE[] = {
 // Mandelbrot State - ALL FIXED-POINT
 //==============================================================================
 typedef struct {
-    int32_t min_real, max_real;  // Fixed-point coordinates
-    int32_t min_imag, max_imag;
+    fix16_t min_real, max_real;  // Fixed-point coordinates (Q16.16)
+    fix16_t min_imag, max_imag;
     int max_iter;
     uint32_t last_calc_time_ms;
+    uint32_t last_calc_cycles;   // rdcycle delta for the calculation
+    uint32_t last_calc_instret;  // rdinstret delta for the calculation
     uint32_t last_total_iters;  // Total iterations in last render
+    uint32_t last_new_cells;    // Cells computed by it (the rest were kept)
+    int mode;                   // MODE_BRUTE, MODE_REJECT, MODE_TRACE
     int screen_rows, screen_cols;  // Track current screen size
 } mandelbrot_state;
 
@@ -156,21 +166,12 @@ static mandelbrot_state state;
 
 // Render buffer - stores the rendered ASCII characters
 // Max terminal size we support: 200x150
+// 0 = not computed yet: pan and zoom keep the cells still valid and only
+// the others are iterated
 static char render_buffer[200][150];
 
-//==============================================================================
-// Fixed-point Mandelbrot (faster than floating point)
-//==============================================================================
-#define FIXED_SHIFT 16
-#define FIXED_ONE (1 << FIXED_SHIFT)
-
-static inline int32_t double_to_fixed(double d) {
-    return (int32_t)(d * FIXED_ONE);
-}
-
-static inline int32_t fixed_mul(int32_t a, int32_t b) {
-    return (int32_t)(((int64_t)a * (int64_t)b) >> FIXED_SHIFT);
-}
+// What the terminal shows, so only changed cells are sent
+static char shown_buffer[200][150];
 
 //==============================================================================
 // Map iteration count to character
@@ -193,76 +194,427 @@ static const char* iter_to_char(int iter, int max_iter) {
 }
 
 //==============================================================================
-// Draw the Mandelbrot Set - PURE FIXED-POINT (NO FLOAT!)
+// Render modes
+//   BRUTE:  every pixel iterated to escape or max_iter (the core benchmark)
+//   REJECT: points in the main cardioid or the period-2 bulb are not
+//           iterated at all, and an orbit that comes back to an earlier
+//           point (periodicity, exact in fixed point) stops there. Same
+//           picture as BRUTE.
+//   TRACE:  REJECT plus boundary tracing (Mariani-Silver): a rectangle
+//           whose border is all one character is filled without
+//           iterating its inside, otherwise it is split in two. Detail
+//           smaller than a rectangle whose border misses it is lost.
+//==============================================================================
+enum { MODE_BRUTE, MODE_REJECT, MODE_TRACE, MODE_COUNT };
+static const char *MODE_NAMES[MODE_COUNT] = { "BRUTE", "REJECT", "TRACE" };
+
+typedef struct {
+    bool valid;                  // Measured at the current view and max_iter
+    uint32_t time_ms;
+    uint32_t total_iters;
+} mode_stats;
+
+static mode_stats stats[MODE_COUNT];
+
+typedef struct {
+    fix16_t real_step, imag_step;
+    int rows, cols;              // Clipped to render_buffer
+    uint32_t total_iters;
+    uint32_t new_cells;
+} render_ctx;
+
+// Iterate one point with cardioid/bulb rejection and periodicity checking;
+// returns max_iter for points inside the set
+static int iterate_reject(fix16_t real, fix16_t imag, uint32_t *total_iters) {
+    // Tests in Q32 (squares kept whole), rounded towards "outside": near
+    // the cusp at 1/4 Q16 squares of the tiny y and q would be 0
+    int64_t y2 = (int64_t)imag * imag;
+
+    // Main cardioid: q * (q + x - 1/4) <= y^2 / 4, q = (x - 1/4)^2 + y^2
+    int64_t xq = (int64_t)(real - FIX16_ONE / 4) << FIX16_SHIFT;
+    int64_t q = (int64_t)(real - FIX16_ONE / 4) * (real - FIX16_ONE / 4) + y2;
+    int64_t q16 = (q + FIX16_ONE - 1) >> FIX16_SHIFT;
+    int64_t s16 = (q + xq + FIX16_ONE - 1) >> FIX16_SHIFT;
+    if (q16 * s16 <= y2 / 4) {
+        return state.max_iter;
+    }
+
+    // Period-2 bulb: (x + 1)^2 + y^2 <= 1/16
+    int64_t x1 = real + FIX16_ONE;
+    if (x1 * x1 + y2 <= ((int64_t)1 << (2 * FIX16_SHIFT)) / 16) {
+        return state.max_iter;
+    }
+
+    fix16_t zr = 0, zi = 0, zr2 = 0, zi2 = 0;
+    fix16_t saved_r = 0, saved_i = 0;   // Orbit point to compare against
+    int check = 8;                      // Save again at iteration 8, 16, 32...
+    int iter = 0;
+    fix16_t escape_radius_sq = 4 * FIX16_ONE;
+
+    while (iter < state.max_iter && (zr2 + zi2) < escape_radius_sq) {
+        zi = fix16_mul(zr, zi);
+        zi += zi;  // 2 * zr * zi
+        zi += imag;
+
+        zr = zr2 - zi2 + real;
+
+        zr2 = fix16_mul(zr, zr);
+        zi2 = fix16_mul(zi, zi);
+
+        iter++;
+
+        if (zr == saved_r && zi == saved_i) {
+            *total_iters += iter;
+            return state.max_iter;      // In a cycle: never escapes
+        }
+        if (iter == check) {
+            saved_r = zr;
+            saved_i = zi;
+            check += check;
+        }
+    }
+
+    *total_iters += iter;
+    return iter;
+}
+
+// Character at (row, col), computed on first use (0 = not yet)
+static char trace_pixel(render_ctx *ctx, int row, int col) {
+    char *p = &render_buffer[row][col];
+    if (*p == 0) {
+        int iter = iterate_reject(state.min_real + col * ctx->real_step,
+                                  state.min_imag + row * ctx->imag_step,
+                                  &ctx->total_iters);
+        *p = iter_to_char(iter, state.max_iter)[0];
+        ctx->new_cells++;
+    }
+    return *p;
+}
+
+// Rectangle (r0, c0) - (r1, c1), edges included
+static void trace_rect(render_ctx *ctx, int r0, int c0, int r1, int c1) {
+    char ch = trace_pixel(ctx, r0, c0);
+    bool same = true;
+
+    for (int col = c0; col <= c1; col++) {
+        same &= trace_pixel(ctx, r0, col) == ch;
+        same &= trace_pixel(ctx, r1, col) == ch;
+    }
+    for (int row = r0 + 1; row < r1; row++) {
+        same &= trace_pixel(ctx, row, c0) == ch;
+        same &= trace_pixel(ctx, row, c1) == ch;
+    }
+
+    if (r1 - r0 < 2 || c1 - c0 < 2) {
+        return;                         // No inside left
+    }
+
+    // Cells kept from the last frame can prove the inside is not flat
+    for (int row = r0 + 1; same && row < r1; row++) {
+        for (int col = c0 + 1; col < c1; col++) {
+            char known = render_buffer[row][col];
+            same &= known == 0 || known == ch;
+        }
+    }
+
+    if (same) {
+        for (int row = r0 + 1; row < r1; row++) {
+            for (int col = c0 + 1; col < c1; col++) {
+                if (render_buffer[row][col] == 0) {
+                    render_buffer[row][col] = ch;
+                }
+            }
+        }
+    } else if (c1 - c0 >= r1 - r0) {
+        int mid = (c0 + c1) / 2;
+        trace_rect(ctx, r0, c0, r1, mid);
+        trace_rect(ctx, r0, mid, r1, c1);
+    } else {
+        int mid = (r0 + r1) / 2;
+        trace_rect(ctx, r0, c0, mid, c1);
+        trace_rect(ctx, mid, c0, r1, c1);
+    }
+}
+
+// Visible part of the view in render_buffer
+static int view_rows(void) {
+    return SCREEN_HEIGHT < 200 ? SCREEN_HEIGHT : 200;
+}
+
+static int view_cols(void) {
+    return SCREEN_WIDTH < 150 ? SCREEN_WIDTH : 150;
+}
+
+// Forget every computed cell (new view, max_iter or screen size)
+static void clear_cells(void) {
+    for (int row = 0; row < 200; row++) {
+        for (int col = 0; col < 150; col++) {
+            render_buffer[row][col] = 0;
+        }
+    }
+}
+
+// Round the steps down to a multiple of 1 << ZOOM_ALIGN and make max follow
+// min by whole steps, so that many zooms in a row still land on old cells
+#define ZOOM_ALIGN 4
+
+static void snap_view(void) {
+    int32_t mask = ~((1 << ZOOM_ALIGN) - 1);
+    fix16_t real_step = (state.max_real - state.min_real) / SCREEN_WIDTH;
+    fix16_t imag_step = (state.max_imag - state.min_imag) / SCREEN_HEIGHT;
+
+    if (real_step > ~mask && imag_step > ~mask) {   // Not zoomed in too far
+        real_step &= mask;
+        imag_step &= mask;
+    }
+
+    state.max_real = state.min_real + SCREEN_WIDTH * real_step;
+    state.max_imag = state.min_imag + SCREEN_HEIGHT * imag_step;
+}
+
+//==============================================================================
+// Compute the Mandelbrot Set into render_buffer - PURE FIXED-POINT (NO FLOAT!)
+// Only cells still 0 are computed; full = all of them (a benchmark frame)
 // Timing excludes UART display time
 //==============================================================================
-static void draw_mandelbrot(WINDOW *win) {
-    uint32_t total_iters = 0;
+static void render(int mode, bool full) {
+    render_ctx ctx;
 
     // Calculate step size in fixed-point (pure integer division)
-    int32_t real_step = (state.max_real - state.min_real) / SCREEN_WIDTH;
-    int32_t imag_step = (state.max_imag - state.min_imag) / SCREEN_HEIGHT;
+    ctx.real_step = (state.max_real - state.min_real) / SCREEN_WIDTH;
+    ctx.imag_step = (state.max_imag - state.min_imag) / SCREEN_HEIGHT;
+    ctx.rows = view_rows();
+    ctx.cols = view_cols();
+    ctx.total_iters = 0;
+    ctx.new_cells = 0;
+
+    if (full) {
+        clear_cells();
+    }
 
     // TIMING START - Only measure calculation, not UART display!
-    uint32_t start_time = get_millis();
+    perf_sample_t perf_start, perf_end;
+    perf_sample(&perf_start);
 
-    int32_t imag = state.min_imag;
+    if (mode == MODE_TRACE) {
+        trace_rect(&ctx, 0, 0, ctx.rows - 1, ctx.cols - 1);
+    } else {
+        fix16_t imag = state.min_imag;
 
-    for (int row = 0; row < SCREEN_HEIGHT; row++) {
-        int32_t real = state.min_real;
+        for (int row = 0; row < ctx.rows; row++) {
+            fix16_t real = state.min_real;
 
-        for (int col = 0; col < SCREEN_WIDTH; col++) {
-            // No floating point - real and imag are already fixed-point!
-            int32_t zr = 0;
-            int32_t zi = 0;
-            int32_t zr2 = 0;
-            int32_t zi2 = 0;
+            for (int col = 0; col < ctx.cols; col++) {
+                int iter;
 
-            int iter = 0;
-            int32_t escape_radius_sq = 4 << FIXED_SHIFT;
+                if (render_buffer[row][col] != 0) {
+                    real += ctx.real_step;  // Kept from the last frame
+                    continue;
+                }
 
-            while (iter < state.max_iter && (zr2 + zi2) < escape_radius_sq) {
-                zi = fixed_mul(zr, zi);
-                zi += zi;  // 2 * zr * zi
-                zi += imag;
+                if (mode == MODE_REJECT) {
+                    iter = iterate_reject(real, imag, &ctx.total_iters);
+                } else {
+                    // No floating point - real and imag are already fixed-point!
+                    // Orbit in registers (lib/fixmath/fixmath_rv32.S)
+                    iter = fix16_mandel(real, imag, state.max_iter);
+                    ctx.total_iters += iter;
+                }
 
-                zr = zr2 - zi2 + real;
+                const char* ch = iter_to_char(iter, state.max_iter);
 
-                zr2 = fixed_mul(zr, zr);
-                zi2 = fixed_mul(zi, zi);
+                render_buffer[row][col] = ch[0];
+                ctx.new_cells++;
 
-                iter++;
+                real += ctx.real_step;  // Just integer add!
             }
 
-            total_iters += iter;
-            const char* ch = iter_to_char(iter, state.max_iter);
+            imag += ctx.imag_step;  // Just integer add!
+        }
+    }
 
-            // Store in render buffer (not timed)
-            if (row < 200 && col < 150) {
-                render_buffer[row][col] = ch[0];
+    // TIMING END - Stop before UART display
+    perf_sample(&perf_end);
+    state.last_calc_cycles = perf_end.cycles - perf_start.cycles;
+    state.last_calc_instret = perf_end.instret - perf_start.instret;
+    state.last_calc_time_ms = state.last_calc_cycles / (PERF_CPU_HZ / 1000);
+    state.last_total_iters = ctx.total_iters;
+    state.last_new_cells = ctx.new_cells;
+
+    if (full) {
+        stats[mode].valid = true;
+        stats[mode].time_ms = state.last_calc_time_ms;
+        stats[mode].total_iters = ctx.total_iters;
+    }
+}
+
+// Timings at another view or max_iter no longer compare
+static void invalidate_stats(void) {
+    for (int m = 0; m < MODE_COUNT; m++) {
+        stats[m].valid = false;
+    }
+}
+
+//==============================================================================
+// Draw the Mandelbrot Set in the current mode
+//==============================================================================
+// The terminal was cleared (wclear)
+static void forget_shown(void) {
+    for (int row = 0; row < 200; row++) {
+        for (int col = 0; col < 150; col++) {
+            shown_buffer[row][col] = ' ';
+        }
+    }
+}
+
+// Now display to screen (not timed): only the cells that changed. Cells
+// next to each other need no cursor move, incurses leaves it out
+static void show_cells(WINDOW *win) {
+    for (int row = 0; row < view_rows(); row++) {
+        for (int col = 0; col < view_cols(); col++) {
+            char ch = render_buffer[row][col];
+            if (ch != shown_buffer[row][col]) {
+                wmove(win, row, col);
+                waddch(win, ch);
+                shown_buffer[row][col] = ch;
             }
+        }
+    }
+
+    wrefresh(win);
+}
+
+static void draw_mandelbrot(WINDOW *win) {
+    render(state.mode, true);
+    show_cells(win);
+}
 
-            real += real_step;  // Just integer add!
+// Compute the cells pan or zoom left unknown, send what changed
+static void update_mandelbrot(WINDOW *win) {
+    render(state.mode, false);
+    show_cells(win);
+}
+
+// Render the view in every mode, the current one last (it is displayed)
+static void bench_modes(WINDOW *win) {
+    for (int m = 0; m < MODE_COUNT; m++) {
+        if (m != state.mode) {
+            render(m, true);
+        }
+    }
+    draw_mandelbrot(win);
+}
+
+//==============================================================================
+// Pan and zoom, keeping the cells that are still on the grid
+//==============================================================================
+#define PAN_COLS (SCREEN_WIDTH / 8)
+#define PAN_ROWS (SCREEN_HEIGHT / 4)
+
+// Move the view by whole cells; what stays in view is shifted, the strip
+// that comes in is left to compute
+static void pan_view(int drow, int dcol) {
+    fix16_t real_step = (state.max_real - state.min_real) / SCREEN_WIDTH;
+    fix16_t imag_step = (state.max_imag - state.min_imag) / SCREEN_HEIGHT;
+    int rows = view_rows(), cols = view_cols();
+
+    state.min_real += dcol * real_step;
+    state.max_real += dcol * real_step;
+    state.min_imag += drow * imag_step;
+    state.max_imag += drow * imag_step;
+    invalidate_stats();
+
+    for (int i = 0; i < rows; i++) {
+        int row = drow > 0 ? i : rows - 1 - i;  // Sources not yet overwritten
+        int src = row + drow;
+        char *dst = render_buffer[row];
+
+        if (src < 0 || src >= rows) {
+            memset(dst, 0, cols);
+        } else if (dcol >= 0) {
+            int keep = dcol < cols ? cols - dcol : 0;
+            memmove(dst, render_buffer[src] + dcol, keep);
+            memset(dst + keep, 0, cols - keep);
+        } else {
+            int keep = -dcol < cols ? cols + dcol : 0;
+            memmove(dst - dcol, render_buffer[src], keep);
+            memset(dst, 0, cols - keep);
         }
+    }
+}
+
+// Kept cells between zoom steps: every other row and column
+static char zoom_buffer[100][75];
+
+// Zoom 2x about the centre. The grid halves (in) or doubles (out) its
+// step, so a quarter of the cells land on points already computed
+static void zoom_view(bool in) {
+    fix16_t real_step = (state.max_real - state.min_real) / SCREEN_WIDTH;
+    fix16_t imag_step = (state.max_imag - state.min_imag) / SCREEN_HEIGHT;
+    int rows = view_rows(), cols = view_cols();
+    int w = SCREEN_WIDTH, h = SCREEN_HEIGHT;
 
-        imag += imag_step;  // Just integer add!
+    if (in ? (real_step < 2 || imag_step < 2)
+           : ((int64_t)real_step * 2 * w > 8 * FIX16_ONE)) {
+        return;                         // Q16.16 resolution / range limit
     }
+    // Reuse needs the new grid points to fall exactly on old ones
+    bool aligned = !in || ((real_step | imag_step) & 1) == 0;
+    invalidate_stats();
+
+    if (in) {
+        state.min_real += (w / 4) * real_step;
+        state.min_imag += (h / 4) * imag_step;
+        real_step /= 2;
+        imag_step /= 2;
+    } else {
+        state.min_real -= (w / 2) * real_step;
+        state.min_imag -= (h / 2) * imag_step;
+        real_step *= 2;
+        imag_step *= 2;
+    }
+    state.max_real = state.min_real + w * real_step;
+    state.max_imag = state.min_imag + h * imag_step;
 
-    // TIMING END - Stop before UART display
-    state.last_calc_time_ms = get_millis() - start_time;
-    state.last_total_iters = total_iters;
-
-    // Now display to screen (not timed)
-    for (int row = 0; row < SCREEN_HEIGHT; row++) {
-        wmove(win, row, 0);
-        for (int col = 0; col < SCREEN_WIDTH; col++) {
-            if (row < 200 && col < 150) {
-                waddch(win, render_buffer[row][col]);
+    if (!aligned) {
+        clear_cells();
+        return;
+    }
+
+    // New cell (2i, 2j) is old (h/4 + i, w/4 + j) zooming in; new (i, j)
+    // is old (2i - h/2, 2j - w/2) zooming out. Collect, clear, place
+    int n_rows = 0, n_cols = 0;
+    for (int i = 0; i < 100; i++) {
+        for (int j = 0; j < 75; j++) {
+            int new_r = in ? 2 * i : h / 4 + i, new_c = in ? 2 * j : w / 4 + j;
+            int old_r = in ? h / 4 + i : 2 * new_r - h / 2;
+            int old_c = in ? w / 4 + j : 2 * new_c - w / 2;
+            bool ok = new_r < rows && new_c < cols &&
+                      old_r >= 0 && old_r < rows && old_c >= 0 && old_c < cols;
+            zoom_buffer[i][j] = ok ? render_buffer[old_r][old_c] : 0;
+            if (ok) {
+                n_rows = i + 1 > n_rows ? i + 1 : n_rows;
+                n_cols = j + 1 > n_cols ? j + 1 : n_cols;
             }
         }
     }
 
-    wrefresh(win);
+    clear_cells();
+    for (int i = 0; i < n_rows; i++) {
+        for (int j = 0; j < n_cols; j++) {
+            int new_r = in ? 2 * i : h / 4 + i, new_c = in ? 2 * j : w / 4 + j;
+            if (new_r < rows && new_c < cols) {
+                render_buffer[new_r][new_c] = zoom_buffer[i][j];
+            }
+        }
+    }
+}
+
+// Arrow keys come decoded (keypad mode, KEY_UP..KEY_LEFT); a lone ESC is
+// dropped
+static int read_key(void) {
+    int ch = getch();
+    return ch == 27 ? ERR : ch;
 }
 
 //==============================================================================
@@ -271,13 +623,15 @@ static void draw_mandelbrot(WINDOW *win) {
 static bool check_terminal_resize(void) {
     int old_rows = g_term_rows;
     int old_cols = g_term_cols;
+    bool ok = query_terminal_size();
 
-    if (query_terminal_size()) {
-        if (g_term_rows != old_rows || g_term_cols != old_cols) {
-            return true;  // Size changed
-        }
-    }
-    return false;
+    // The query moved the cursor behind incurses' back: put both at home,
+    // or the next move could be left out as redundant
+    printf("\033[H");
+    fflush(stdout);
+    move(0, 0);
+
+    return ok && (g_term_rows != old_rows || g_term_cols != old_cols);
 }
 
 //==============================================================================
@@ -286,10 +640,12 @@ static bool check_terminal_resize(void) {
 static void reset_view(void) {
     // Standard Mandelbrot view: real=[-2.5, 1.0], imag=[-1.0, 1.0]
     // Convert to fixed-point: value * (1 << 16)
-    state.min_real = double_to_fixed(-2.5);   // -2.5 << 16
-    state.max_real = double_to_fixed(1.0);    //  1.0 << 16
-    state.min_imag = double_to_fixed(-1.0);   // -1.0 << 16
-    state.max_imag = double_to_fixed(1.0);    //  1.0 << 16
+    state.min_real = fix16_from_double(-2.5);   // -2.5 << 16
+    state.max_real = fix16_from_double(1.0);    //  1.0 << 16
+    state.min_imag = fix16_from_double(-1.0);   // -1.0 << 16
+    state.max_imag = fix16_from_double(1.0);    //  1.0 << 16
+    snap_view();
+    invalidate_stats();
 }
 
 //==============================================================================
@@ -305,13 +661,22 @@ static void draw_info_bar(void) {
         mips = (double)state.last_total_iters / (double)state.last_calc_time_ms / 1000.0;
     }
 
-    printw("OPTIMIZED FIXED-POINT | Display: %dx%d | Iter: %d | Time: %lums | %.2fM iter/s",
-           g_term_cols, g_term_rows, state.max_iter,
-           (unsigned long)state.last_calc_time_ms, mips);
+    uint32_t cpi = perf_cpi_x100(state.last_calc_cycles, state.last_calc_instret);
+    printw("OPTIMIZED FIXED-POINT %s | Display: %dx%d | Iter: %d | Time: %lums | %.2fM iter/s | CPI: %lu.%02lu",
+           MODE_NAMES[state.mode], g_term_cols, g_term_rows, state.max_iter,
+           (unsigned long)state.last_calc_time_ms, mips,
+           (unsigned long)(cpi / 100), (unsigned long)(cpi % 100));
 
     move(SCREEN_HEIGHT + 1, 0);
     clrtoeol();
-    printw("R:Reset +/-:Iter Q:Quit | No arrows/zoom - pure performance test!");
+    printw("Arrows:Pan Z/X:Zoom R:Reset +/-:Iter M:Mode b:Bench Q:Quit | New:%lu |",
+           (unsigned long)state.last_new_cells);
+    for (int m = 0; m < MODE_COUNT; m++) {
+        if (stats[m].valid) {
+            printw(" %s %lums/%luk", MODE_NAMES[m], (unsigned long)stats[m].time_ms,
+                   (unsigned long)(stats[m].total_iters / 1000));
+        }
+    }
 
     refresh();
 }
@@ -354,7 +719,11 @@ int main(int argc, char **argv) {
     reset_view();
     state.max_iter = MAX_ITER_DEFAULT;
     state.last_calc_time_ms = 0;
+    state.last_calc_cycles = 0;
+    state.last_calc_instret = 0;
     state.last_total_iters = 0;
+    state.last_new_cells = 0;
+    state.mode = MODE_BRUTE;
     state.screen_rows = g_term_rows;
     state.screen_cols = g_term_cols;
 
@@ -363,12 +732,15 @@ int main(int argc, char **argv) {
 
     printf("Drawing initial view (OPTIMIZED FIXED-POINT)...\r\n");
 
-    // Draw initial mandelbrot
+    // Draw initial mandelbrot over the messages above
+    wclear(mandel_win);
+    forget_shown();
     draw_mandelbrot(mandel_win);
     draw_info_bar();
 
     bool running = true;
-    bool needs_redraw = false;
+    bool needs_redraw = false;   // Everything is recomputed
+    bool needs_update = false;   // Only the cells pan/zoom left unknown
     int loop_counter = 0;
 
     // Main loop
@@ -382,10 +754,13 @@ int main(int argc, char **argv) {
                 if (state.screen_rows != g_term_rows || state.screen_cols != g_term_cols) {
                     state.screen_rows = g_term_rows;
                     state.screen_cols = g_term_cols;
+                    snap_view();
+                    invalidate_stats();
 
                     // Recreate window with new size
                     delwin(mandel_win);
                     wclear(stdscr);
+                    forget_shown();
                     mandel_win = newwin(SCREEN_HEIGHT, SCREEN_WIDTH, 0, 0);
 
                     needs_redraw = true;
@@ -393,7 +768,7 @@ int main(int argc, char **argv) {
             }
         }
 
-        int ch = getch();
+        int ch = read_key();
 
         if (ch != ERR) {
             switch (ch) {
@@ -410,6 +785,53 @@ int main(int argc, char **argv) {
                     needs_redraw = true;
                     break;
 
+                // Next render mode
+                case 'm':
+                case 'M':
+                    state.mode = (state.mode + 1) % MODE_COUNT;
+                    needs_redraw = true;
+                    break;
+
+                // Time every mode on this view
+                case 'b':
+                    bench_modes(mandel_win);
+                    draw_info_bar();
+                    break;
+
+                // Pan by an eighth of the width / a quarter of the height
+                case KEY_LEFT:
+                    pan_view(0, -PAN_COLS);
+                    needs_update = true;
+                    break;
+
+                case KEY_RIGHT:
+                    pan_view(0, PAN_COLS);
+                    needs_update = true;
+                    break;
+
+                case KEY_UP:
+                    pan_view(-PAN_ROWS, 0);
+                    needs_update = true;
+                    break;
+
+                case KEY_DOWN:
+                    pan_view(PAN_ROWS, 0);
+                    needs_update = true;
+                    break;
+
+                // Zoom 2x about the centre
+                case 'z':
+                case 'Z':
+                    zoom_view(true);
+                    needs_update = true;
+                    break;
+
+                case 'x':
+                case 'X':
+                    zoom_view(false);
+                    needs_update = true;
+                    break;
+
                 // Adjust max iterations
                 case '+':
                 case '=':
@@ -419,6 +841,7 @@ int main(int argc, char **argv) {
                                         state.max_iter + 128;
                         if (state.max_iter > MAX_ITER_MAX)
                             state.max_iter = MAX_ITER_MAX;
+                        invalidate_stats();
                         needs_redraw = true;
                     }
                     break;
@@ -431,6 +854,7 @@ int main(int argc, char **argv) {
                                         state.max_iter - 128;
                         if (state.max_iter < 32)
                             state.max_iter = 32;
+                        invalidate_stats();
                         needs_redraw = true;
                     }
                     break;
@@ -438,11 +862,14 @@ int main(int argc, char **argv) {
 
             // Redraw if needed
             if (needs_redraw) {
-                wclear(mandel_win);
                 draw_mandelbrot(mandel_win);
                 draw_info_bar();
                 needs_redraw = false;
+            } else if (needs_update) {
+                update_mandelbrot(mandel_win);
+                draw_info_bar();
             }
+            needs_update = false;
         }
 
         // Small delay to reduce CPU usage
@@ -456,6 +883,21 @@ int main(int argc, char **argv) {
     printf("\r\n\r\nMandelbrot Explorer (OPTIMIZED FIXED-POINT) exited.\r\n");
     printf("Max iterations: %d\r\n", state.max_iter);
     printf("Last calculation time: %lu ms\r\n", (unsigned long)state.last_calc_time_ms);
+    for (int m = 0; m < MODE_COUNT; m++) {
+        if (stats[m].valid) {
+            printf("  %-6s %6lu ms %10lu iterations\r\n", MODE_NAMES[m],
+                   (unsigned long)stats[m].time_ms, (unsigned long)stats[m].total_iters);
+        }
+    }
+    printf("Last calculation: %lu cycles, %lu instructions, CPI %lu.%02lu\r\n",
+           (unsigned long)state.last_calc_cycles, (unsigned long)state.last_calc_instret,
+           (unsigned long)(perf_cpi_x100(state.last_calc_cycles, state.last_calc_instret) / 100),
+           (unsigned long)(perf_cpi_x100(state.last_calc_cycles, state.last_calc_instret) % 100));
+    // Machine-readable line for scripts/bench_profiles.sh
+    printf("PERF mandelbrot_fixed iters=%lu cyc_per_iter=%lu\r\n",
+           (unsigned long)state.last_total_iters,
+           (unsigned long)(state.last_total_iters ?
+                           state.last_calc_cycles / state.last_total_iters : 0));
     printf("Performance: %.2f M iter/s\r\n",
            (double)state.last_total_iters / (double)state.last_calc_time_ms / 1000.0);
 
@@ -2,9 +2,12 @@
 // Mandelbrot Set - FLOATING-POINT VERSION
 //==============================================================================
 // Uses floating-point for coordinate calculations (software emulated on PicoRV32)
+// The escape-time loop runs in Q16.16 or in single precision: soft-float, or
+// the PCPI FPU (lib/pcpi_fpu.h) when the bitstream has it
 // Controls:
 //   R: Reset to default view
 //   +/-: Adjust max iterations
+//   F: Switch kernel (Q16.16 / float)
 //   Q: Quit
 //==============================================================================
 
@@ -13,6 +16,8 @@
 #include <stdbool.h>
 #include <curses.h>
 #include "timer_ms.h"
+#include "../lib/perf_counters.h"
+#include "../lib/pcpi_fpu.h"
 
 //==============================================================================
 // Hardware UART (required by incurses)
@@ -148,12 +153,33 @@ typedef struct {
     double min_imag, max_imag;
     int max_iter;
     uint32_t last_calc_time_ms;
+    uint32_t last_calc_cycles;   // rdcycle delta for the calculation
+    uint32_t last_calc_instret;  // rdinstret delta for the calculation
     uint32_t last_total_iters;  // Total iterations in last render
     int screen_rows, screen_cols;  // Track current screen size
+    int kernel;                 // KERNEL_FIXED / KERNEL_FLOAT
+    bool fpu;                   // PCPI FPU in the bitstream
 } mandelbrot_state;
 
 static mandelbrot_state state;
 
+// Escape-time kernels, and the last full render with each
+typedef enum {
+    KERNEL_FIXED,               // Q16.16 integer multiply
+    KERNEL_FLOAT,               // Single precision: PCPI FPU or soft-float
+    KERNEL_COUNT
+} kernel_t;
+
+static const char *KERNEL_NAMES[KERNEL_COUNT] = { "q16", "f32" };
+
+typedef struct {
+    bool valid;
+    uint32_t cycles;
+    uint32_t total_iters;
+} kernel_stats_t;
+
+static kernel_stats_t stats[KERNEL_COUNT];
+
 // Render buffer - stores the rendered ASCII characters
 // Max terminal size we support: 200x150
 static char render_buffer[200][150];
@@ -198,6 +224,63 @@ static int mandelbrot_iterations(double cx, double cy, int max_iter) {
     return iter;
 }
 
+//==============================================================================
+// Single-precision Mandelbrot, same recurrence as the fixed-point loop
+//==============================================================================
+
+// libgcc soft-float: a call per add, multiply and compare
+static int mandelbrot_iterations_soft(float cr, float ci, int max_iter) {
+    float zr = 0.0f, zi = 0.0f;
+    float zr2 = 0.0f, zi2 = 0.0f;
+
+    int iter = 0;
+    while (iter < max_iter && (zr2 + zi2) < 4.0f) {
+        zi = zr * zi;
+        zi += zi;
+        zi += ci;
+
+        zr = zr2 - zi2 + cr;
+
+        zr2 = zr * zr;
+        zi2 = zi * zi;
+
+        iter++;
+    }
+
+    return iter;
+}
+
+// PCPI FPU: one instruction per add and multiply, |z|^2 < 4 as an integer
+// compare (both sides are non-negative)
+static int mandelbrot_iterations_pcpi(float cr, float ci, int max_iter) {
+    float zr = 0.0f, zi = 0.0f;
+    float zr2 = 0.0f, zi2 = 0.0f;
+
+    int iter = 0;
+    while (iter < max_iter && pcpi_fless_pos(pcpi_fadd(zr2, zi2), 4.0f)) {
+        zi = pcpi_fmul(zr, zi);
+        zi = pcpi_fadd(zi, zi);
+        zi = pcpi_fadd(zi, ci);
+
+        zr = pcpi_fadd(pcpi_fsub(zr2, zi2), cr);
+
+        zr2 = pcpi_fmul(zr, zr);
+        zi2 = pcpi_fmul(zi, zi);
+
+        iter++;
+    }
+
+    return iter;
+}
+
+static int kernel_iterations(double cx, double cy, int max_iter) {
+    if (state.kernel == KERNEL_FIXED)
+        return mandelbrot_iterations(cx, cy, max_iter);
+    if (state.fpu)
+        return mandelbrot_iterations_pcpi((float)cx, (float)cy, max_iter);
+    return mandelbrot_iterations_soft((float)cx, (float)cy, max_iter);
+}
+
 //==============================================================================
 // Map iteration count to character
 //==============================================================================
@@ -229,14 +312,15 @@ static void draw_mandelbrot(WINDOW *win) {
     double imag_step = (state.max_imag - state.min_imag) / SCREEN_HEIGHT;
 
     // TIMING START - Only measure calculation, not UART display!
-    uint32_t start_time = get_millis();
+    perf_sample_t perf_start, perf_end;
+    perf_sample(&perf_start);
 
     for (int row = 0; row < SCREEN_HEIGHT; row++) {
         for (int col = 0; col < SCREEN_WIDTH; col++) {
             double real = state.min_real + col * real_step;
             double imag = state.min_imag + row * imag_step;
 
-            int iter = mandelbrot_iterations(real, imag, state.max_iter);
+            int iter = kernel_iterations(real, imag, state.max_iter);
             total_iters += iter;
             const char* ch = iter_to_char(iter, state.max_iter);
 
@@ -248,8 +332,14 @@ static void draw_mandelbrot(WINDOW *win) {
     }
 
     // TIMING END - Stop before UART display
-    state.last_calc_time_ms = get_millis() - start_time;
+    perf_sample(&perf_end);
+    state.last_calc_cycles = perf_end.cycles - perf_start.cycles;
+    state.last_calc_instret = perf_end.instret - perf_start.instret;
+    state.last_calc_time_ms = state.last_calc_cycles / (PERF_CPU_HZ / 1000);
     state.last_total_iters = total_iters;
+    stats[state.kernel].valid = true;
+    stats[state.kernel].cycles = state.last_calc_cycles;
+    stats[state.kernel].total_iters = total_iters;
 
     // Now display to screen (not timed)
     for (int row = 0; row < SCREEN_HEIGHT; row++) {
@@ -302,13 +392,17 @@ static void draw_info_bar(void) {
         mips = (double)state.last_total_iters / (double)state.last_calc_time_ms / 1000.0;
     }
 
-    printw("FLOATING-POINT | Display: %dx%d | Iter: %d | Time: %lums | %.2fM iter/s",
-           g_term_cols, g_term_rows, state.max_iter,
-           (unsigned long)state.last_calc_time_ms, mips);
+    uint32_t cpi = perf_cpi_x100(state.last_calc_cycles, state.last_calc_instret);
+    const char *kernel = state.kernel == KERNEL_FIXED ? "Q16.16" :
+                         state.fpu ? "F32 PCPI FPU" : "F32 soft-float";
+    printw("%s | Display: %dx%d | Iter: %d | Time: %lums | %.2fM iter/s | CPI: %lu.%02lu",
+           kernel, g_term_cols, g_term_rows, state.max_iter,
+           (unsigned long)state.last_calc_time_ms, mips,
+           (unsigned long)(cpi / 100), (unsigned long)(cpi % 100));
 
     move(SCREEN_HEIGHT + 1, 0);
     clrtoeol();
-    printw("R:Reset +/-:Iter Q:Quit | Performance benchmark");
+    printw("R:Reset +/-:Iter F:Kernel Q:Quit | Performance benchmark");
 
     refresh();
 }
@@ -351,9 +445,13 @@ int main(int argc, char **argv) {
     reset_view();
     state.max_iter = MAX_ITER_DEFAULT;
     state.last_calc_time_ms = 0;
+    state.last_calc_cycles = 0;
+    state.last_calc_instret = 0;
     state.last_total_iters = 0;
     state.screen_rows = g_term_rows;
     state.screen_cols = g_term_cols;
+    state.fpu = pcpi_fpu_present();
+    state.kernel = state.fpu ? KERNEL_FLOAT : KERNEL_FIXED;
 
     // Create main window
     WINDOW *mandel_win = newwin(SCREEN_HEIGHT, SCREEN_WIDTH, 0, 0);
@@ -400,6 +498,13 @@ int main(int argc, char **argv) {
                     running = false;
                     break;
 
+                // Switch escape-time kernel
+                case 'f':
+                case 'F':
+                    state.kernel = (state.kernel + 1) % KERNEL_COUNT;
+                    needs_redraw = true;
+                    break;
+
                 // Reset view
                 case 'r':
                 case 'R':
@@ -453,6 +558,20 @@ int main(int argc, char **argv) {
     printf("\r\n\r\nMandelbrot Explorer (FLOATING-POINT) exited.\r\n");
     printf("Max iterations: %d\r\n", state.max_iter);
     printf("Last calculation time: %lu ms\r\n", (unsigned long)state.last_calc_time_ms);
+    printf("Float kernel: %s\r\n", state.fpu ? "PCPI FPU" : "soft-float");
+    // Machine-readable lines for scripts/bench_profiles.sh
+    for (int k = 0; k < KERNEL_COUNT; k++) {
+        if (stats[k].valid) {
+            printf("PERF mandelbrot_%s iters=%lu cyc_per_iter=%lu\r\n", KERNEL_NAMES[k],
+                   (unsigned long)stats[k].total_iters,
+                   (unsigned long)(stats[k].total_iters ?
+                                   stats[k].cycles / stats[k].total_iters : 0));
+        }
+    }
+    printf("Last calculation: %lu cycles, %lu instructions, CPI %lu.%02lu\r\n",
+           (unsigned long)state.last_calc_cycles, (unsigned long)state.last_calc_instret,
+           (unsigned long)(perf_cpi_x100(state.last_calc_cycles, state.last_calc_instret) / 100),
+           (unsigned long)(perf_cpi_x100(state.last_calc_cycles, state.last_calc_instret) % 100));
     printf("Performance: %.2f M iter/s\r\n",
            (double)state.last_total_iters / (double)state.last_calc_time_ms / 1000.0);
 
@@ -0,0 +1,310 @@
+//===============================================================================
+// Soft-Float vs Fixed-Point Math Kernel Benchmark
+// The same kernels in float, double (newlib soft-float) and Q16.16, timed with
+// the cycle counter, so number formats can be picked on data
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// Kernels: dot product, FIR filter, matrix multiply (algo_test's, smaller),
+// sqrt and sin. Each prints cycles per operation (one multiply-accumulate,
+// or one sqrt/sin call) and the largest error against the double result.
+// The Q16.16 column is lib/fixmath (fix16_dot, fix16_sqrt, fix16_sin).
+//
+// One PERF line per kernel and format for scripts/bench_profiles.sh:
+//   PERF dot_q16 iters=<ops> cyc_per_iter=<n>
+// It runs this on every build profile, which gives the sequential vs
+// ENABLE_FAST_MUL comparison (the CPU cannot change its multiplier).
+//
+//===============================================================================
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+#include "fixmath.h"
+#include "../lib/perf_counters.h"
+
+// UART direct access for the start key (no echo, no buffering)
+#define UART_RX_DATA   (*(volatile unsigned int*)0x80000008)
+#define UART_RX_STATUS (*(volatile unsigned int*)0x8000000C)
+
+static int getch(void) {
+    while (!(UART_RX_STATUS & 0x01));
+    return UART_RX_DATA & 0xFF;
+}
+
+//==============================================================================
+// Test data
+//==============================================================================
+
+#define VEC_N   256     // Dot product length, FIR output samples
+#define FIR_TAPS 16
+#define MAT_N   24      // 24^3 = 13824 MACs (algo_test: 50x50 doubles)
+#define FN_N    256     // sqrt/sin calls
+
+static double  vec_a_d[VEC_N + FIR_TAPS], vec_b_d[VEC_N];
+static float   vec_a_f[VEC_N + FIR_TAPS], vec_b_f[VEC_N];
+static fix16_t vec_a_q[VEC_N + FIR_TAPS], vec_b_q[VEC_N];
+
+static double  taps_d[FIR_TAPS];
+static float   taps_f[FIR_TAPS];
+static fix16_t taps_q[FIR_TAPS];
+
+static double  mat_a_d[MAT_N * MAT_N], mat_b_d[MAT_N * MAT_N], mat_c_d[MAT_N * MAT_N];
+static float   mat_a_f[MAT_N * MAT_N], mat_b_f[MAT_N * MAT_N], mat_c_f[MAT_N * MAT_N];
+static fix16_t mat_a_q[MAT_N * MAT_N], mat_b_q[MAT_N * MAT_N], mat_c_q[MAT_N * MAT_N];
+
+static double  out_d[VEC_N];    // Kernel results, double = reference
+static float   out_f[VEC_N];
+static fix16_t out_q[VEC_N];
+
+static uint32_t rand_state = 12345;
+
+// Deterministic value in [-1, 1)
+static double rand_unit(void) {
+    rand_state = rand_state * 1103515245 + 12345;
+    return (double)(int32_t)rand_state / 2147483648.0;
+}
+
+static void init_data(void) {
+    for (int i = 0; i < VEC_N + FIR_TAPS; i++) {
+        vec_a_d[i] = rand_unit();
+        vec_a_f[i] = (float)vec_a_d[i];
+        vec_a_q[i] = fix16_from_double(vec_a_d[i]);
+    }
+    for (int i = 0; i < VEC_N; i++) {
+        vec_b_d[i] = rand_unit();
+        vec_b_f[i] = (float)vec_b_d[i];
+        vec_b_q[i] = fix16_from_double(vec_b_d[i]);
+    }
+    for (int i = 0; i < FIR_TAPS; i++) {
+        taps_d[i] = rand_unit() / FIR_TAPS;
+        taps_f[i] = (float)taps_d[i];
+        taps_q[i] = fix16_from_double(taps_d[i]);
+    }
+    // algo_test's pattern: 1..10, products summed stay < 32768 for Q16.16
+    for (int i = 0; i < MAT_N * MAT_N; i++) {
+        mat_a_d[i] = (double)((i % 10) + 1);
+        mat_b_d[i] = (double)(((i * 7) % 10) + 1);
+        mat_a_f[i] = (float)mat_a_d[i];
+        mat_b_f[i] = (float)mat_b_d[i];
+        mat_a_q[i] = fix16_from_double(mat_a_d[i]);
+        mat_b_q[i] = fix16_from_double(mat_b_d[i]);
+    }
+}
+
+//==============================================================================
+// Kernels - one function per kernel and format, results in out_* / mat_c_*
+//==============================================================================
+
+static void dot_d(void) {
+    double sum = 0.0;
+    for (int i = 0; i < VEC_N; i++) sum += vec_a_d[i] * vec_b_d[i];
+    out_d[0] = sum;
+}
+
+static void dot_f(void) {
+    float sum = 0.0f;
+    for (int i = 0; i < VEC_N; i++) sum += vec_a_f[i] * vec_b_f[i];
+    out_f[0] = sum;
+}
+
+static void dot_q(void) {
+    out_q[0] = fix16_dot(vec_a_q, vec_b_q, VEC_N);
+}
+
+static void fir_d(void) {
+    for (int n = 0; n < VEC_N; n++) {
+        double acc = 0.0;
+        for (int k = 0; k < FIR_TAPS; k++) acc += taps_d[k] * vec_a_d[n + k];
+        out_d[n] = acc;
+    }
+}
+
+static void fir_f(void) {
+    for (int n = 0; n < VEC_N; n++) {
+        float acc = 0.0f;
+        for (int k = 0; k < FIR_TAPS; k++) acc += taps_f[k] * vec_a_f[n + k];
+        out_f[n] = acc;
+    }
+}
+
+static void fir_q(void) {
+    for (int n = 0; n < VEC_N; n++) {
+        out_q[n] = fix16_dot(taps_q, &vec_a_q[n], FIR_TAPS);
+    }
+}
+
+static void matmul_d(void) {
+    for (int i = 0; i < MAT_N; i++) {
+        for (int j = 0; j < MAT_N; j++) {
+            double sum = 0.0;
+            for (int k = 0; k < MAT_N; k++) sum += mat_a_d[i * MAT_N + k] * mat_b_d[k * MAT_N + j];
+            mat_c_d[i * MAT_N + j] = sum;
+        }
+    }
+}
+
+static void matmul_f(void) {
+    for (int i = 0; i < MAT_N; i++) {
+        for (int j = 0; j < MAT_N; j++) {
+            float sum = 0.0f;
+            for (int k = 0; k < MAT_N; k++) sum += mat_a_f[i * MAT_N + k] * mat_b_f[k * MAT_N + j];
+            mat_c_f[i * MAT_N + j] = sum;
+        }
+    }
+}
+
+// Column of b is strided, so no fix16_dot here
+static void matmul_q(void) {
+    for (int i = 0; i < MAT_N; i++) {
+        for (int j = 0; j < MAT_N; j++) {
+            int64_t sum = 0;
+            for (int k = 0; k < MAT_N; k++) sum += (int64_t)mat_a_q[i * MAT_N + k] * mat_b_q[k * MAT_N + j];
+            mat_c_q[i * MAT_N + j] = (fix16_t)(sum >> FIX16_SHIFT);
+        }
+    }
+}
+
+// sqrt over (0, 256), sin over (-8, 8): both from vec_a
+static void sqrt_d(void) {
+    for (int i = 0; i < FN_N; i++) out_d[i] = sqrt(fabs(vec_a_d[i]) * 256.0);
+}
+
+static void sqrt_f(void) {
+    for (int i = 0; i < FN_N; i++) out_f[i] = sqrtf(fabsf(vec_a_f[i]) * 256.0f);
+}
+
+static void sqrt_q(void) {
+    for (int i = 0; i < FN_N; i++) {
+        out_q[i] = fix16_sqrt(fix16_abs(vec_a_q[i]) << 8);
+    }
+}
+
+static void sin_d(void) {
+    for (int i = 0; i < FN_N; i++) out_d[i] = sin(vec_a_d[i] * 8.0);
+}
+
+static void sin_f(void) {
+    for (int i = 0; i < FN_N; i++) out_f[i] = sinf(vec_a_f[i] * 8.0f);
+}
+
+static void sin_q(void) {
+    for (int i = 0; i < FN_N; i++) out_q[i] = fix16_sin(vec_a_q[i] << 3);
+}
+
+//==============================================================================
+// Runner
+//==============================================================================
+
+typedef struct {
+    const char *name;
+    uint32_t ops;               // MACs or calls per run
+    void (*run_d)(void);
+    void (*run_f)(void);
+    void (*run_q)(void);
+    int outputs;                // Results in out_* (0 = the mat_c_* matrix)
+} kernel_t;
+
+static const kernel_t kernels[] = {
+    { "dot",    VEC_N,                 dot_d,    dot_f,    dot_q,    1 },
+    { "fir",    VEC_N * FIR_TAPS,      fir_d,    fir_f,    fir_q,    VEC_N },
+    { "matmul", MAT_N * MAT_N * MAT_N, matmul_d, matmul_f, matmul_q, 0 },
+    { "sqrt",   FN_N,                  sqrt_d,   sqrt_f,   sqrt_q,   FN_N },
+    { "sin",    FN_N,                  sin_d,    sin_f,    sin_q,    FN_N },
+};
+
+#define NUM_KERNELS (sizeof(kernels) / sizeof(kernels[0]))
+
+// Second run is timed, so instruction fetch of the first does not count
+static uint32_t time_kernel(void (*fn)(void)) {
+    fn();
+    uint32_t start = rdcycle();
+    fn();
+    return rdcycle() - start;
+}
+
+// Largest |float - double| and |Q16.16 - double| over the kernel's results
+static void kernel_errors(const kernel_t *k, double *err_f, double *err_q) {
+    int n = k->outputs ? k->outputs : MAT_N * MAT_N;
+
+    *err_f = 0.0;
+    *err_q = 0.0;
+    for (int i = 0; i < n; i++) {
+        double ref = k->outputs ? out_d[i] : mat_c_d[i];
+        double f = k->outputs ? (double)out_f[i] : (double)mat_c_f[i];
+        double q = fix16_to_double(k->outputs ? out_q[i] : mat_c_q[i]);
+        if (fabs(f - ref) > *err_f) *err_f = fabs(f - ref);
+        if (fabs(q - ref) > *err_q) *err_q = fabs(q - ref);
+    }
+}
+
+// MUL latency: 16 dependent MULs against 16 dependent ADDs
+static uint32_t mul_cycles(void) {
+    uint32_t x = 3, t0, t1, t2;
+
+    t0 = rdcycle();
+    for (int i = 0; i < 16; i++) __asm__ volatile ("add %0, %0, %0" : "+r"(x));
+    t1 = rdcycle();
+    for (int i = 0; i < 16; i++) __asm__ volatile ("mul %0, %0, %0" : "+r"(x));
+    t2 = rdcycle();
+
+    return ((t2 - t1) - (t1 - t0)) / 16 + 1;
+}
+
+static void run_benchmark(void) {
+    uint32_t mul = mul_cycles();
+
+    printf("\r\nMUL: ~%lu cycles (%s multiplier)\r\n", (unsigned long)mul,
+           mul < 10 ? "pipelined, ENABLE_FAST_MUL" : "sequential");
+    printf("\r\n");
+    printf("%-8s %6s | %9s %9s %9s | %10s %10s\r\n",
+           "Kernel", "Ops", "float", "double", "Q16.16", "float err", "Q16 err");
+    printf("%-8s %6s | %29s | %21s\r\n", "", "", "cycles per op", "max |x - double|");
+    printf("----------------+-------------------------------+----------------------\r\n");
+
+    for (unsigned i = 0; i < NUM_KERNELS; i++) {
+        const kernel_t *k = &kernels[i];
+        uint32_t cyc_d = time_kernel(k->run_d) / k->ops;
+        uint32_t cyc_f = time_kernel(k->run_f) / k->ops;
+        uint32_t cyc_q = time_kernel(k->run_q) / k->ops;
+        double err_f, err_q;
+
+        kernel_errors(k, &err_f, &err_q);
+        printf("%-8s %6lu | %9lu %9lu %9lu | %10.2e %10.2e\r\n",
+               k->name, (unsigned long)k->ops, (unsigned long)cyc_f,
+               (unsigned long)cyc_d, (unsigned long)cyc_q, err_f, err_q);
+        printf("PERF %s_f32 iters=%lu cyc_per_iter=%lu\r\n",
+               k->name, (unsigned long)k->ops, (unsigned long)cyc_f);
+        printf("PERF %s_f64 iters=%lu cyc_per_iter=%lu\r\n",
+               k->name, (unsigned long)k->ops, (unsigned long)cyc_d);
+        printf("PERF %s_q16 iters=%lu cyc_per_iter=%lu\r\n",
+               k->name, (unsigned long)k->ops, (unsigned long)cyc_q);
+        fflush(stdout);
+    }
+
+    printf("\r\nBenchmark complete\r\n");
+}
+
+int main(void) {
+    printf("\r\n\r\n");
+    printf("========================================\r\n");
+    printf("  Math Kernel Benchmark\r\n");
+    printf("  float / double (soft-float) / Q16.16\r\n");
+    printf("========================================\r\n");
+    printf("\r\n");
+    printf("Press any key to start...\r\n");
+
+    getch();
+    init_data();
+
+    while (1) {
+        run_benchmark();
+        printf("\r\nPress any key to run again...\r\n");
+        fflush(stdout);
+        getch();
+    }
+
+    return 0;
+}
@@ -9,6 +9,7 @@
 #include <stdio.h>
 #include <math.h>
 #include <float.h>
+#include "../lib/perf_counters.h"
 
 // UART direct access for menu (no echo, no buffering)
 #define UART_RX_DATA   (*(volatile unsigned int*)0x80000008)
@@ -165,6 +166,7 @@ static void test_stress_computation(void) {
 
     unsigned int iterations = 100000;
     double sum = 0.0;
+    uint64_t start = rdcycle64();
 
     for (unsigned int i = 1; i <= iterations; i++) {
         double x = (double)i / 1000.0;
@@ -179,7 +181,11 @@ static void test_stress_computation(void) {
         }
     }
 
+    uint64_t cycles = rdcycle64() - start;
+
     printf("\r\nCompleted %u iterations\r\n", iterations);
+    printf("PERF math_stress iters=%u cyc_per_iter=%lu\r\n",
+           iterations, (unsigned long)(cycles / iterations));
     printf("Final sum: %.10f\r\n", sum);
     printf("PASS (no crashes)\r\n");
 }
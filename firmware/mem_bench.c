@@ -0,0 +1,369 @@
+//===============================================================================
+// Memory Bandwidth and Latency Benchmark
+// Read / write / copy bandwidth and dependent-load latency per access width
+// in SRAM, the BRAM scratchpad and the boot ROM, and SRAM load latency by stride
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// Table 1, per region and access width (byte, half, word), each pass timed
+// on its second run:
+//   read    MB/s, loads summed over the region
+//   write   MB/s, a store to every element
+//   copy    MB/s, element by element; counts the bytes read and the bytes
+//           written, as STREAM does
+//   load    cycles per dependent load: every address needs the value of
+//           the load before it, less the same loop without the load
+//
+// Regions:
+//   SRAM 1K    small enough for any cache (times the D-cache when present)
+//   SRAM 64K   larger than any cache
+//   SPAD       512 B of the scratchpad (.fastbss), copy within it
+//   BOOTROM    the 8 KB boot ROM at 0x40000, read only (copy into SRAM)
+//
+// Table 2: word load latency walking 64 KB of SRAM at strides of 4 B to
+// 4 KB, with the D-cache hit rate from the PMU when the bitstream has a
+// D-cache.
+//
+// Table 3: cycles per load of polled MMIO status registers (UART, SPI,
+// LED), the same loop without the load taken off.
+//
+// PERF lines for scripts/perf_regress.sh and scripts/bench_profiles.sh,
+// cycles per KB of the SRAM 64K word passes and cycles per dependent load:
+//   PERF sram_read_w iters=64 cyc_per_iter=<cycles per KB>
+//   PERF sram_lat_16 iters=4096 cyc_per_iter=<cycles per load at stride 16>
+//   PERF mmio_uart_status iters=4096 cyc_per_iter=<cycles per status load>
+//
+//===============================================================================
+
+#include <stdio.h>
+#include <stdint.h>
+#include "../lib/perf_counters.h"
+
+// UART direct access for the start key (no echo, no buffering)
+#define UART_RX_DATA   (*(volatile unsigned int*)0x80000008)
+#define UART_RX_STATUS (*(volatile unsigned int*)0x8000000C)
+
+// Performance monitor (hdl/perf_monitor.v)
+#define PMU_BASE            0x80000080
+#define PMU_CTRL            (*(volatile uint32_t*)(PMU_BASE + 0x00))
+#define PMU_DC_HIT          (*(volatile uint32_t*)(PMU_BASE + 0x28))
+#define PMU_DC_MISS         (*(volatile uint32_t*)(PMU_BASE + 0x2C))
+#define PMU_CTRL_ENABLE     (1 << 0)
+#define PMU_CTRL_CLEAR      (1 << 1)
+
+// Polled status registers
+#define UART_TX_STATUS_ADDR 0x80000004
+#define SPI_STATUS_ADDR     0x80000058
+#define LED_CONTROL_ADDR    0x80000010
+
+#define BOOTROM_BASE        0x00040000      // hdl/mem_controller.v BOOT_BASE
+#define BOOTROM_SIZE        8192
+
+static int getch(void) {
+    while (!(UART_RX_STATUS & 0x01));
+    return UART_RX_DATA & 0xFF;
+}
+
+#define SRAM_SIZE   65536
+#define SPAD_SIZE   512
+#define CHASE_STEPS 4096
+
+static uint8_t buf_src[SRAM_SIZE] __attribute__((aligned(4)));
+static uint8_t buf_dst[SRAM_SIZE] __attribute__((aligned(4)));
+static uint8_t buf_spad[SPAD_SIZE] __attribute__((aligned(4), section(".fastbss")));
+
+static volatile uint32_t sink;
+
+//==============================================================================
+// Kernels, one set per access width; addresses and counts of elements
+//==============================================================================
+
+// Keep GCC from turning the loops into memcpy/memset calls
+#define NO_LIBCALL __attribute__((noinline, optimize("no-tree-loop-distribute-patterns")))
+
+// Dependent walk: the next offset adds (z - v), zero, but only known once
+// the load has returned, so no load can start before the previous one ends
+#define DEFINE_KERNELS(T, w)                                                    \
+NO_LIBCALL static uint32_t read_##w(uint32_t addr, uint32_t n) {                \
+    const T *p = (const T *)addr;                                               \
+    uint32_t sum = 0;                                                           \
+    while (n--) sum += *p++;                                                    \
+    return sum;                                                                 \
+}                                                                               \
+NO_LIBCALL static void write_##w(uint32_t addr, uint32_t n) {                   \
+    T *p = (T *)addr;                                                           \
+    while (n--) *p++ = (T)n;                                                    \
+}                                                                               \
+NO_LIBCALL static void copy_##w(uint32_t dst, uint32_t src, uint32_t n) {       \
+    T *d = (T *)dst;                                                            \
+    const T *s = (const T *)src;                                                \
+    while (n--) *d++ = *s++;                                                    \
+}                                                                               \
+NO_LIBCALL static uint32_t chase_##w(uint32_t base, uint32_t mask,             \
+                                      uint32_t stride, uint32_t steps) {        \
+    uint32_t off = 0;                                                           \
+    while (steps--) {                                                           \
+        uint32_t v = *(const volatile T *)(base + off);                         \
+        uint32_t z = v;                                                         \
+        __asm__ volatile ("" : "+r"(z));                                        \
+        off = (off + stride + z - v) & mask;                                    \
+    }                                                                           \
+    return off;                                                                 \
+}
+
+DEFINE_KERNELS(uint8_t, b)
+DEFINE_KERNELS(uint16_t, h)
+DEFINE_KERNELS(uint32_t, w)
+
+// The walk without its load: what chase_*() costs besides the load
+NO_LIBCALL static uint32_t chase_none(uint32_t base, uint32_t mask,
+                                      uint32_t stride, uint32_t steps) {
+    uint32_t off = 0;
+    (void)base;
+    while (steps--) {
+        uint32_t v = off;
+        uint32_t z = v;
+        __asm__ volatile ("" : "+r"(z));
+        off = (off + stride + z - v) & mask;
+    }
+    return off;
+}
+
+// Back-to-back loads of one register, as a polling loop does
+NO_LIBCALL static uint32_t poll_reg(uint32_t addr, uint32_t n) {
+    uint32_t sum = 0;
+    while (n--) sum += *(const volatile uint32_t *)addr;
+    return sum;
+}
+
+NO_LIBCALL static uint32_t poll_none(uint32_t addr, uint32_t n) {
+    uint32_t sum = 0;
+    while (n--) {
+        uint32_t v = addr;
+        __asm__ volatile ("" : "+r"(v));
+        sum += v;
+    }
+    return sum;
+}
+
+typedef struct {
+    const char *name;
+    uint32_t bytes;
+    uint32_t (*read)(uint32_t addr, uint32_t n);
+    void (*write)(uint32_t addr, uint32_t n);
+    void (*copy)(uint32_t dst, uint32_t src, uint32_t n);
+    uint32_t (*chase)(uint32_t base, uint32_t mask, uint32_t stride, uint32_t steps);
+} width_t;
+
+static const width_t widths[] = {
+    { "byte", 1, read_b, write_b, copy_b, chase_b },
+    { "half", 2, read_h, write_h, copy_h, chase_h },
+    { "word", 4, read_w, write_w, copy_w, chase_w },
+};
+
+#define NUM_WIDTHS (sizeof(widths) / sizeof(widths[0]))
+
+typedef struct {
+    const char *name;
+    uint32_t base;
+    uint32_t size;          // Power of 2 (the walk wraps with a mask)
+    int writable;
+    uint32_t copy_dst;      // Copies size bytes here (SPAD: size / 2)
+    uint32_t copy_bytes;
+} region_t;
+
+// Second call is timed, so instruction fetch of the first does not count
+#define TIMED(cycles, call) do {            \
+        call;                               \
+        uint32_t t0_ = rdcycle();           \
+        call;                               \
+        (cycles) = rdcycle() - t0_;         \
+    } while (0)
+
+//==============================================================================
+// Output
+//==============================================================================
+
+// bytes in cycles as MB/s with one decimal ("-" for no measurement)
+static void print_mbps(uint32_t bytes, uint32_t cycles) {
+    if (cycles == 0) {
+        printf(" %7s", "-");
+        return;
+    }
+    uint32_t x10 = (uint32_t)(((uint64_t)bytes * PERF_CPU_HZ * 10) / cycles / 1000000);
+    printf(" %5lu.%lu", (unsigned long)(x10 / 10), (unsigned long)(x10 % 10));
+}
+
+static void print_x10(uint32_t cycles, uint32_t n) {
+    uint32_t x10 = (uint32_t)(((uint64_t)cycles * 10) / n);
+    printf(" %5lu.%lu", (unsigned long)(x10 / 10), (unsigned long)(x10 % 10));
+}
+
+// Dependent-load cycles per load; the loop without loads is taken off
+static uint32_t load_latency(const width_t *w, uint32_t base, uint32_t mask, uint32_t stride) {
+    uint32_t with_load, without;
+
+    TIMED(with_load, sink = w->chase(base, mask, stride, CHASE_STEPS));
+    TIMED(without, sink = chase_none(base, mask, stride, CHASE_STEPS));
+    return with_load > without ? with_load - without : 0;
+}
+
+//==============================================================================
+// Benchmark
+//==============================================================================
+
+static void run_regions(uint32_t perf[4]) {
+    const region_t regions[] = {
+        { "SRAM 1K",  (uint32_t)buf_src,  1024,         1, (uint32_t)buf_dst, 1024 },
+        { "SRAM 64K", (uint32_t)buf_src,  SRAM_SIZE,    1, (uint32_t)buf_dst, SRAM_SIZE },
+        { "SPAD",     (uint32_t)buf_spad, SPAD_SIZE,    1, (uint32_t)buf_spad + SPAD_SIZE / 2,
+                                                           SPAD_SIZE / 2 },
+        { "BOOTROM",  BOOTROM_BASE,       BOOTROM_SIZE, 0, (uint32_t)buf_dst, BOOTROM_SIZE },
+    };
+
+    printf("\r\n%-9s %6s %-5s %7s %7s %7s %7s\r\n",
+           "Region", "Bytes", "Width", "Read", "Write", "Copy", "Load");
+    printf("%-9s %6s %-5s %7s %7s %7s %7s\r\n", "", "", "", "MB/s", "MB/s", "MB/s", "cycles");
+    printf("---------------------------------------------------------\r\n");
+
+    for (unsigned r = 0; r < sizeof(regions) / sizeof(regions[0]); r++) {
+        const region_t *rg = &regions[r];
+
+        for (unsigned i = 0; i < NUM_WIDTHS; i++) {
+            const width_t *w = &widths[i];
+            uint32_t n = rg->size / w->bytes;
+            uint32_t rd, wr = 0, cp;
+
+            TIMED(rd, sink = w->read(rg->base, n));
+            if (rg->writable) {
+                TIMED(wr, w->write(rg->base, n));
+            }
+            TIMED(cp, w->copy(rg->copy_dst, rg->base, rg->copy_bytes / w->bytes));
+            uint32_t lat = load_latency(w, rg->base, rg->size - 1, w->bytes);
+
+            printf("%-9s %6lu %-5s", i == 0 ? rg->name : "",
+                   (unsigned long)rg->size, w->name);
+            print_mbps(rg->size, rd);
+            print_mbps(rg->size, wr);
+            print_mbps(rg->copy_bytes * 2, cp);
+            print_x10(lat, CHASE_STEPS);
+            printf("\r\n");
+            fflush(stdout);
+
+            if (rg->size == SRAM_SIZE && w->bytes == 4) {
+                perf[0] = rd / (SRAM_SIZE / 1024);
+                perf[1] = wr / (SRAM_SIZE / 1024);
+                perf[2] = cp / (SRAM_SIZE / 1024);
+            }
+        }
+    }
+}
+
+static void run_strides(uint32_t perf[4]) {
+    static const uint32_t strides[] = { 4, 16, 64, 256, 1024, 4096 };
+    const width_t *w = &widths[NUM_WIDTHS - 1];
+
+    printf("\r\nSRAM word loads, 64 KB walk\r\n");
+    printf("%-7s %7s %8s\r\n", "Stride", "cycles", "D$ hit");
+    printf("------------------------\r\n");
+
+    for (unsigned i = 0; i < sizeof(strides) / sizeof(strides[0]); i++) {
+        uint32_t lat;
+
+        PMU_CTRL = PMU_CTRL_CLEAR;
+        PMU_CTRL = PMU_CTRL_ENABLE;
+        lat = load_latency(w, (uint32_t)buf_src, SRAM_SIZE - 1, strides[i]);
+        PMU_CTRL = 0;
+
+        uint32_t hit = PMU_DC_HIT, miss = PMU_DC_MISS;
+
+        printf("%-7lu", (unsigned long)strides[i]);
+        print_x10(lat, CHASE_STEPS);
+        if (hit + miss) {
+            uint32_t pct = (uint32_t)(((uint64_t)hit * 1000) / (hit + miss));
+            printf("   %3lu.%lu%%", (unsigned long)(pct / 10), (unsigned long)(pct % 10));
+        } else {
+            printf(" %8s", "-");        // No D-cache (or no PMU)
+        }
+        printf("\r\n");
+
+        if (strides[i] == 16) {
+            perf[3] = lat / CHASE_STEPS;
+        }
+    }
+}
+
+static uint32_t run_mmio(void) {
+    static const struct { const char *name; uint32_t addr; } regs[] = {
+        { "UART TX_STATUS", UART_TX_STATUS_ADDR },
+        { "SPI_STATUS",     SPI_STATUS_ADDR },
+        { "LED_CONTROL",    LED_CONTROL_ADDR },
+    };
+    uint32_t uart = 0;
+
+    printf("\r\nMMIO status loads\r\n");
+    printf("%-15s %7s\r\n", "Register", "cycles");
+    printf("-----------------------\r\n");
+
+    for (unsigned i = 0; i < sizeof(regs) / sizeof(regs[0]); i++) {
+        uint32_t with_load, without;
+
+        TIMED(with_load, sink = poll_reg(regs[i].addr, CHASE_STEPS));
+        TIMED(without, sink = poll_none(regs[i].addr, CHASE_STEPS));
+        uint32_t lat = with_load > without ? with_load - without : 0;
+
+        printf("%-15s", regs[i].name);
+        print_x10(lat, CHASE_STEPS);
+        printf("\r\n");
+
+        if (i == 0) {
+            uart = lat / CHASE_STEPS;
+        }
+    }
+    return uart;
+}
+
+static void run_benchmark(void) {
+    uint32_t perf[5] = { 0 };
+
+    for (uint32_t i = 0; i < SRAM_SIZE; i++) {
+        buf_src[i] = (uint8_t)(i * 7 + 3);
+    }
+
+    run_regions(perf);
+    run_strides(perf);
+    perf[4] = run_mmio();
+
+    printf("\r\n");
+    printf("PERF sram_read_w iters=64 cyc_per_iter=%lu\r\n", (unsigned long)perf[0]);
+    printf("PERF sram_write_w iters=64 cyc_per_iter=%lu\r\n", (unsigned long)perf[1]);
+    printf("PERF sram_copy_w iters=64 cyc_per_iter=%lu\r\n", (unsigned long)perf[2]);
+    printf("PERF sram_lat_16 iters=%d cyc_per_iter=%lu\r\n", CHASE_STEPS, (unsigned long)perf[3]);
+    printf("PERF mmio_uart_status iters=%d cyc_per_iter=%lu\r\n", CHASE_STEPS, (unsigned long)perf[4]);
+
+    printf("\r\nBenchmark complete\r\n");
+}
+
+int main(void) {
+    printf("\r\n\r\n");
+    printf("========================================\r\n");
+    printf("  Memory Bandwidth / Latency Benchmark\r\n");
+    printf("  SRAM / scratchpad / boot ROM\r\n");
+    printf("========================================\r\n");
+    printf("\r\n");
+    printf("CPU clock: %lu MHz\r\n", (unsigned long)(PERF_CPU_HZ / 1000000));
+    printf("Press any key to start...\r\n");
+
+    getch();
+
+    while (1) {
+        run_benchmark();
+        printf("\r\nPress any key to run again...\r\n");
+        fflush(stdout);
+        getch();
+    }
+
+    return 0;
+}
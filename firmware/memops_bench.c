@@ -0,0 +1,212 @@
+//===============================================================================
+// memcpy / memmove / memset / strlen Benchmark
+// lib/memops word routines against a byte loop and the DMA engine, 4 B - 64 KB
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// Columns are cycles per byte (x.xx) for one call, timed on its second run:
+//   memcpy   both pointers word aligned
+//   unalign  dst + 1, src + 2 (the funnel-shift path)
+//   memmove  overlapping, dst = src + 4 (backward copy)
+//   memset   word aligned
+//   strlen   string of that length
+//   bytes    C byte loop, the same copy newlib's generic code does
+//   dma      lib/dma.h dma_memcpy (64 B and up, where it uses the engine)
+//
+// PERF lines for scripts/bench_profiles.sh at 64 B and 4 KB, one call per
+// iteration:
+//   PERF memcpy_4k iters=4096 cyc_per_iter=<cycles per call>
+//
+//===============================================================================
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "../lib/perf_counters.h"
+#include "../lib/dma.h"
+
+// UART direct access for the start key (no echo, no buffering)
+#define UART_RX_DATA   (*(volatile unsigned int*)0x80000008)
+#define UART_RX_STATUS (*(volatile unsigned int*)0x8000000C)
+
+static int getch(void) {
+    while (!(UART_RX_STATUS & 0x01));
+    return UART_RX_DATA & 0xFF;
+}
+
+#define MAX_SIZE    65536
+
+static uint8_t buf_src[MAX_SIZE + 16] __attribute__((aligned(4)));
+static uint8_t buf_dst[MAX_SIZE + 16] __attribute__((aligned(4)));
+
+static const uint32_t sizes[] = { 4, 16, 64, 256, 1024, 4096, 16384, 65536 };
+
+#define NUM_SIZES (sizeof(sizes) / sizeof(sizes[0]))
+
+//==============================================================================
+// Operations under test (one call each)
+//==============================================================================
+
+// Keep GCC from turning byte loops back into memcpy/memset calls
+#define NO_LIBCALL __attribute__((noinline, optimize("no-tree-loop-distribute-patterns")))
+
+NO_LIBCALL static void byte_copy(uint8_t *d, const uint8_t *s, uint32_t n) {
+    while (n--) *d++ = *s++;
+}
+
+typedef enum { OP_MEMCPY, OP_UNALIGN, OP_MEMMOVE, OP_MEMSET, OP_STRLEN, OP_BYTES, OP_DMA, OP_COUNT } op_t;
+
+static const char *OP_NAMES[OP_COUNT] = {
+    "memcpy", "unalign", "memmove", "memset", "strlen", "bytes", "dma"
+};
+
+static volatile uint32_t sink;
+
+static void run_op(op_t op, uint32_t n) {
+    switch (op) {
+        case OP_MEMCPY:  memcpy(buf_dst, buf_src, n); break;
+        case OP_UNALIGN: memcpy(buf_dst + 1, buf_src + 2, n); break;
+        case OP_MEMMOVE: memmove(buf_src + 4, buf_src, n); break;
+        case OP_MEMSET:  memset(buf_dst, 0x5A, n); break;
+        case OP_STRLEN:  sink = strlen((const char *)buf_dst); break;
+        case OP_BYTES:   byte_copy(buf_dst, buf_src, n); break;
+        case OP_DMA:     dma_memcpy(buf_dst, buf_src, n); break;
+        default: break;
+    }
+}
+
+// Second call is timed, so instruction fetch of the first does not count
+static uint32_t time_op(op_t op, uint32_t n) {
+    if (op == OP_STRLEN) {
+        memset(buf_dst, 'x', n);
+        buf_dst[n] = '\0';
+    }
+    run_op(op, n);
+    uint32_t start = rdcycle();
+    run_op(op, n);
+    return rdcycle() - start;
+}
+
+static void print_per_byte(uint32_t cycles, uint32_t n) {
+    uint32_t x100 = (uint32_t)(((uint64_t)cycles * 100) / n);
+    printf(" %5lu.%02lu", (unsigned long)(x100 / 100), (unsigned long)(x100 % 100));
+}
+
+//==============================================================================
+// Check the results once, so a fast but wrong routine cannot hide
+//==============================================================================
+#define CHECK_LEN 160
+
+// memmove(dst + d, dst + s, n) against a byte-by-byte reference; also
+// memcpy when the ranges do not overlap. Returns the bytes that differ.
+NO_LIBCALL static int check_move(uint32_t d, uint32_t s, uint32_t n, int use_memcpy) {
+    static uint8_t ref[CHECK_LEN], tmp[CHECK_LEN];
+    int errors = 0;
+
+    for (uint32_t i = 0; i < CHECK_LEN; i++)
+        buf_dst[i] = ref[i] = (uint8_t)(i * 13 + 1);
+    for (uint32_t i = 0; i < n; i++) tmp[i] = ref[s + i];
+    for (uint32_t i = 0; i < n; i++) ref[d + i] = tmp[i];
+
+    if (use_memcpy)
+        memcpy(buf_dst + d, buf_dst + s, n);
+    else
+        memmove(buf_dst + d, buf_dst + s, n);
+
+    for (uint32_t i = 0; i < CHECK_LEN; i++)
+        if (buf_dst[i] != ref[i]) errors++;
+    return errors;
+}
+
+NO_LIBCALL static int check_fill(uint32_t d, uint32_t n) {
+    int errors = 0;
+
+    for (uint32_t i = 0; i < CHECK_LEN; i++) buf_dst[i] = 0;
+    memset(buf_dst + d, 0xA5, n);
+    for (uint32_t i = 0; i < CHECK_LEN; i++)
+        if (buf_dst[i] != ((i >= d && i < d + n) ? 0xA5 : 0)) errors++;
+
+    for (uint32_t i = 0; i < CHECK_LEN; i++) buf_dst[i] = 'x';
+    buf_dst[d + n] = '\0';
+    if (strlen((const char *)buf_dst + d) != n) errors++;
+    return errors;
+}
+
+static int verify(void) {
+    int errors = 0;
+
+    for (uint32_t n = 0; n < 70; n++) {
+        for (uint32_t a = 0; a < 4; a++) {
+            for (uint32_t b = 0; b < 4; b++) {
+                errors += check_move(a, 80 + b, n, 1);      // Disjoint
+                errors += check_move(a + 1, b + 4, n, 0);   // Overlap, dst below
+                errors += check_move(b + 4, a + 1, n, 0);   // Overlap, dst above
+            }
+            errors += check_fill(a, n);
+        }
+    }
+
+    for (uint32_t i = 0; i < sizeof(buf_src); i++)
+        buf_src[i] = (uint8_t)(i * 7 + 3);
+    return errors;
+}
+
+static void run_benchmark(void) {
+    uint32_t perf_cycles[OP_COUNT][2] = {{0}};
+
+    printf("\r\n%-6s", "Bytes");
+    for (int op = 0; op < OP_COUNT; op++) printf(" %8s", OP_NAMES[op]);
+    printf("\r\n%-6s %62s\r\n", "", "cycles per byte");
+    printf("------------------------------------------------------------------------\r\n");
+
+    for (unsigned i = 0; i < NUM_SIZES; i++) {
+        uint32_t n = sizes[i];
+
+        printf("%-6lu", (unsigned long)n);
+        for (int op = 0; op < OP_COUNT; op++) {
+            uint32_t cyc = time_op((op_t)op, n);
+            if (n == 64) perf_cycles[op][0] = cyc;
+            if (n == 4096) perf_cycles[op][1] = cyc;
+            print_per_byte(cyc, n);
+        }
+        printf("\r\n");
+        fflush(stdout);
+    }
+
+    printf("\r\n");
+    for (int op = 0; op < OP_COUNT; op++) {
+        printf("PERF %s_64 iters=64 cyc_per_iter=%lu\r\n",
+               OP_NAMES[op], (unsigned long)perf_cycles[op][0]);
+        printf("PERF %s_4k iters=4096 cyc_per_iter=%lu\r\n",
+               OP_NAMES[op], (unsigned long)perf_cycles[op][1]);
+    }
+
+    printf("\r\nBenchmark complete\r\n");
+}
+
+int main(void) {
+    printf("\r\n\r\n");
+    printf("========================================\r\n");
+    printf("  Memory Routine Benchmark\r\n");
+    printf("  memcpy / memmove / memset / strlen\r\n");
+    printf("========================================\r\n");
+    printf("\r\n");
+    printf("Press any key to start...\r\n");
+
+    getch();
+
+    int errors = verify();
+    printf("\r\nVerify: %s (%d errors)\r\n", errors ? "FAIL" : "PASS", errors);
+    printf("DMA engine: %s\r\n", dma_present() ? "present" : "not built (dma = memmove)");
+
+    while (1) {
+        run_benchmark();
+        printf("\r\nPress any key to run again...\r\n");
+        fflush(stdout);
+        getch();
+    }
+
+    return 0;
+}
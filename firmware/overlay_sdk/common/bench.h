@@ -0,0 +1,114 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// bench.h - Cycle-Counter Timing for Benchmark Overlays
+//
+// Times code with the rdcycle / rdinstret counters (the bitstream needs
+// Kconfig ENABLE_COUNTERS, without them both instructions trap) and prints
+// each result as one line in the format of the firmware benchmarks
+// (scripts/perf_regress.sh), which scripts/overlay_bench.sh collects:
+//
+//   PERF <project>_<name> iters=<n> cyc_per_iter=<n>
+//   BENCH <project>_<name> cycles=<n> instret=<n> cpi_x100=<n>
+//
+// Define BENCH_PROJECT before the include (the template does). Usage:
+//
+//   bench_t b;
+//   bench_start(&b);
+//   for (uint32_t i = 0; i < n; i++) work();
+//   bench_report(&b, "work", n);
+//
+// or best of BENCH_RUNS calls of a kernel that runs n iterations:
+//
+//   bench_run("work", work_kernel, n);
+//
+// The 32-bit cycle counter wraps after ~85 s at 50 MHz: keep each timed
+// run well below that.
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+
+#ifndef OVERLAY_BENCH_H
+#define OVERLAY_BENCH_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#ifndef BENCH_PROJECT
+#define BENCH_PROJECT       "overlay"
+#endif
+
+#ifndef BENCH_RUNS
+#define BENCH_RUNS          3           // bench_run(): best of
+#endif
+
+typedef struct {
+    uint32_t cycles;
+    uint32_t instret;
+} bench_t;
+
+// CSRRS rd, cycle / instret, x0 (same encoding as lib/perf_counters.h)
+static inline uint32_t bench_rdcycle(void) {
+    uint32_t v;
+    __asm__ volatile (".insn i 0x73, 2, %0, x0, -1024" : "=r"(v));
+    return v;
+}
+
+static inline uint32_t bench_rdinstret(void) {
+    uint32_t v;
+    __asm__ volatile (".insn i 0x73, 2, %0, x0, -1022" : "=r"(v));
+    return v;
+}
+
+static inline void bench_start(bench_t *b) {
+    b->instret = bench_rdinstret();
+    b->cycles = bench_rdcycle();
+}
+
+// Cycles and instructions since bench_start()
+static inline void bench_stop(const bench_t *b, uint32_t *cycles, uint32_t *instret) {
+    uint32_t c = bench_rdcycle();
+    uint32_t i = bench_rdinstret();
+
+    *cycles = c - b->cycles;
+    *instret = i - b->instret;
+}
+
+// The two result lines for iters iterations that took cycles / instret
+static inline void bench_result(const char *name, uint32_t iters, uint32_t cycles,
+                                uint32_t instret) {
+    uint32_t cpi_x100 = instret ? (uint32_t)((uint64_t)cycles * 100 / instret) : 0;
+
+    printf("PERF %s_%s iters=%lu cyc_per_iter=%lu\r\n", BENCH_PROJECT, name,
+           (unsigned long)iters, (unsigned long)(iters ? cycles / iters : cycles));
+    printf("BENCH %s_%s cycles=%lu instret=%lu cpi_x100=%lu\r\n", BENCH_PROJECT, name,
+           (unsigned long)cycles, (unsigned long)instret, (unsigned long)cpi_x100);
+}
+
+static inline void bench_report(const bench_t *b, const char *name, uint32_t iters) {
+    uint32_t cycles, instret;
+
+    bench_stop(b, &cycles, &instret);
+    bench_result(name, iters, cycles, instret);
+}
+
+// Best (fewest cycles) of BENCH_RUNS calls of kernel(iters)
+static inline void bench_run(const char *name, void (*kernel)(uint32_t iters), uint32_t iters) {
+    uint32_t best = 0xFFFFFFFF, best_instret = 0;
+
+    for (int r = 0; r < BENCH_RUNS; r++) {
+        uint32_t cycles, instret;
+        bench_t b;
+
+        bench_start(&b);
+        kernel(iters);
+        bench_stop(&b, &cycles, &instret);
+        if (cycles < best) {
+            best = cycles;
+            best_instret = instret;
+        }
+    }
+    bench_result(name, iters, best, best_instret);
+}
+
+#endif // OVERLAY_BENCH_H
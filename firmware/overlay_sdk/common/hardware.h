@@ -104,7 +104,7 @@
 //==============================================================================
 // SPI Master Peripheral (0x80000050)
 //
-// Non-FIFO version - gate-efficient design
+// Byte registers at 0x80000050, burst/FIFO registers at 0x800000C0
 // Supports 8 power-of-2 clock dividers from 50 MHz to 390 kHz
 // Manual chip select control
 // CPOL=0, CPHA=0 (mode 0) - configurable if needed
@@ -117,6 +117,25 @@
 #define SPI_STATUS      (*(volatile uint32_t*)(SPI_BASE + 0x08))
 #define SPI_CS          (*(volatile uint32_t*)(SPI_BASE + 0x0C))
 
+// Burst mode: word FIFOs (Kconfig SPI_FIFO_DEPTH words each)
+// SPI_FIFO_DATA write queues 4 TX bytes (bits [7:0] first), read pops one
+// RX word and stalls until it has arrived. SPI_RX_REPEAT=N clocks out N
+// 0xFF bytes and packs the received bytes into the RX FIFO.
+#define SPI_FIFO_BASE   0x800000C0
+
+#define SPI_FIFO_DATA   (*(volatile uint32_t*)(SPI_FIFO_BASE + 0x00))
+#define SPI_FIFO_CTRL   (*(volatile uint32_t*)(SPI_FIFO_BASE + 0x04))
+#define SPI_FIFO_STAT   (*(volatile uint32_t*)(SPI_FIFO_BASE + 0x08))
+#define SPI_RX_REPEAT   (*(volatile uint32_t*)(SPI_FIFO_BASE + 0x0C))
+
+// SPI_FIFO_CTRL bits
+#define SPI_FIFO_CAPTURE (1 << 0)  // Also store MISO bytes of TX FIFO words
+#define SPI_FIFO_FLUSH   (1 << 1)  // Drop queued TX/RX data (self-clearing)
+
+// SPI_FIFO_STAT fields (words)
+#define SPI_FIFO_TX_LEVEL(s)  ((s) & 0x3FF)
+#define SPI_FIFO_RX_LEVEL(s)  (((s) >> 16) & 0x3FF)
+
 // SPI status bits
 #define SPI_STATUS_BUSY (1 << 0)  // Transfer in progress
 #define SPI_STATUS_DONE (1 << 1)  // Transfer complete
@@ -131,4 +150,11 @@
 #define SPI_CLK_781KHZ  (6 << 2)  // /64 = 781 kHz
 #define SPI_CLK_390KHZ  (7 << 2)  // /128 = 390 kHz
 
+// Any divider: SCK half period = n + 1 clocks, SCK = SYSTEM_CLOCK_HZ / (2 * (n + 1))
+#define SPI_CLK_DIV(n)          ((1 << 5) | (((n) & 0xFF) << 8))
+// MISO sample point d clocks after the SCK edge (mode 0, d <= n); OR into the speed
+#define SPI_SAMPLE_DELAY(d)     (((d) & 0x0F) << 16)
+#define SPI_CTRL_DIV_GET(c)     (((c) >> 8) & 0xFF)
+#define SPI_CTRL_DELAY_GET(c)   (((c) >> 16) & 0x0F)
+
 #endif // HARDWARE_H
@@ -16,13 +16,24 @@
 #include "io.h"
 #include "hardware.h"
 
+#ifdef OVERLAY_USE_SERVICES
+#include "overlay_services.h"
+#endif
+
 //==============================================================================
 // UART Functions (required by incurses library)
 //==============================================================================
 
+// With OVERLAY_USE_SERVICES the console goes through the SD card manager's
+// service table (overlay_services.h) instead of the UART registers
+
 void uart_putc(char c) {
+#ifdef OVERLAY_USE_SERVICES
+    overlay_services()->uart_putc(c);
+#else
     while (UART_TX_STATUS & UART_TX_BUSY);
     UART_TX_DATA = c;
+#endif
 }
 
 // Standard C library putchar (for bare-metal overlays)
@@ -39,6 +50,37 @@ void exit(int status) {
     return;
 }
 
+#ifdef OVERLAY_USE_SERVICES
+
+void uart_puts(const char *s) {
+    overlay_services()->uart_puts(s);
+}
+
+int uart_getc_available(void) {
+    return overlay_services()->uart_getc_available();
+}
+
+char uart_getc(void) {
+    return overlay_services()->uart_getc();
+}
+
+// The manager's printf, so newlib's vfprintf is not linked in
+int vprintf(const char *fmt, va_list ap) {
+    return overlay_services()->vprintf(fmt, ap);
+}
+
+int printf(const char *fmt, ...) {
+    va_list ap;
+    int n;
+
+    va_start(ap, fmt);
+    n = overlay_services()->vprintf(fmt, ap);
+    va_end(ap);
+    return n;
+}
+
+#else
+
 void uart_puts(const char *s) {
     while (*s) {
         uart_putc(*s++);
@@ -54,6 +96,8 @@ char uart_getc(void) {
     return UART_RX_DATA & 0xFF;
 }
 
+#endif // OVERLAY_USE_SERVICES
+
 //==============================================================================
 // Timer Functions
 //==============================================================================
@@ -169,12 +213,66 @@ void spi_set_speed(uint32_t speed) {
     SPI_CTRL = speed;
 }
 
+uint32_t spi_sck_hz(uint32_t speed) {
+    // SCK toggles once per divider period
+    uint32_t half_period = (speed & SPI_CLK_DIV(0)) ? SPI_CTRL_DIV_GET(speed) + 1
+                                                    : 1u << ((speed >> 2) & 7);
+    return SYSTEM_CLOCK_HZ / (2 * half_period);
+}
+
 uint8_t spi_transfer(uint8_t data) {
     SPI_DATA = data;
     while (SPI_STATUS & SPI_STATUS_BUSY);
     return SPI_DATA & 0xFF;
 }
 
+void spi_read_block(uint8_t *buf, uint32_t len) {
+    // Clock out len 0xFF bytes; each SPI_FIFO_DATA read waits for 4 of them
+    SPI_FIFO_CTRL = SPI_FIFO_FLUSH;
+    SPI_RX_REPEAT = len;
+
+    if (((uint32_t)buf & 3) == 0) {
+        uint32_t *wp = (uint32_t *)buf;
+        for (; len >= 4; len -= 4) {
+            *wp++ = SPI_FIFO_DATA;
+        }
+        buf = (uint8_t *)wp;
+    } else {
+        for (; len >= 4; len -= 4) {
+            uint32_t w = SPI_FIFO_DATA;
+            buf[0] = w;
+            buf[1] = w >> 8;
+            buf[2] = w >> 16;
+            buf[3] = w >> 24;
+            buf += 4;
+        }
+    }
+
+    if (len) {
+        uint32_t w = SPI_FIFO_DATA;  // Partial last word, low bytes valid
+        while (len--) {
+            *buf++ = w;
+            w >>= 8;
+        }
+    }
+}
+
+void spi_write_block(const uint8_t *buf, uint32_t len) {
+    SPI_FIFO_CTRL = 0;  // Discard MISO while sending
+
+    for (; len >= 4; len -= 4) {
+        SPI_FIFO_DATA = (uint32_t)buf[0] | ((uint32_t)buf[1] << 8) |
+                        ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+        buf += 4;
+    }
+
+    // Byte writes are only accepted once the FIFO has drained
+    while (SPI_STATUS & SPI_STATUS_BUSY);
+    while (len--) {
+        spi_transfer(*buf++);
+    }
+}
+
 void spi_cs_assert(void) {
     SPI_CS = 0;
 }
@@ -256,23 +354,17 @@ int _isatty(int file) {
 }
 
 // Heap management (sbrk) - for malloc/free support
-// Uses overlay heap addresses from memory_config.h
-#include "memory_config.h"
-
-static char *heap_ptr = (char *)OVERLAY_HEAP_BASE;
+// The break is the bottom end of the overlay arena (overlay_arena.h), below
+// the scratch buffers and the caller's save area
+#include "overlay_arena.h"
 
 void *_sbrk(int incr) {
-    char *prev_heap = heap_ptr;
-    char *new_heap = heap_ptr + incr;
+    void *prev_heap = arena_sbrk(incr);
 
-    // Check for heap overflow
-    if (new_heap >= (char *)OVERLAY_HEAP_END) {
+    if (prev_heap == (void *)-1) {
         errno = ENOMEM;  // Out of memory
-        return (void *)-1;
     }
-
-    heap_ptr = new_heap;
-    return (void *)prev_heap;
+    return prev_heap;
 }
 
 // Get process ID (not really meaningful in bare metal)
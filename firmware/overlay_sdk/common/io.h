@@ -62,7 +62,10 @@ uint8_t button_wait_release(uint8_t button);
 
 void spi_init(uint32_t speed);
 void spi_set_speed(uint32_t speed);
+uint32_t spi_sck_hz(uint32_t speed);
 uint8_t spi_transfer(uint8_t data);
+void spi_read_block(uint8_t *buf, uint32_t len);
+void spi_write_block(const uint8_t *buf, uint32_t len);
 void spi_cs_assert(void);
 void spi_cs_deassert(void);
 
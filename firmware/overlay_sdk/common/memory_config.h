@@ -52,6 +52,7 @@
 
 // Heap starts after bootloader, stack grows down from 0x5F000
 // 4KB safety gap (0x5F000-0x60000) between stack and overlay
+// Measured peaks for sizing: lib/mem_stats.h (SD manager status bar)
 #define MAIN_HEAP_BASE          BOOTLOADER_END  // 0x42000
 #define MAIN_HEAP_END           0x0005F000      // Before stack top
 #define MAIN_HEAP_SIZE          (MAIN_HEAP_END - MAIN_HEAP_BASE)
@@ -59,6 +60,17 @@
 #define MAIN_STACK_TOP          0x0005F000      // Stack grows down, 4KB gap before overlay
 #define OVERLAY_SAFETY_GAP      (4 * 1024)      // 4KB gap between stack and overlay
 
+//==============================================================================
+// RAM Disk (Kconfig SD_RAMDISK, FatFS volume "1:")
+//==============================================================================
+
+// Top of the main firmware heap: below the overlay region, so staged files
+// survive overlay runs and resets (not power cycles). The SD card manager
+// lowers its heap limit to RAMDISK_BASE when it mounts the volume.
+#define RAMDISK_SIZE            (64 * 1024)     // 128 sectors, the FatFS minimum
+#define RAMDISK_END             MAIN_HEAP_END
+#define RAMDISK_BASE            (RAMDISK_END - RAMDISK_SIZE)    // 0x4F000
+
 //==============================================================================
 // Overlay Execution Region - AFTER all main firmware memory
 //==============================================================================
@@ -84,6 +96,18 @@
 #define OVERLAY_HEAP_END        SRAM_END
 #define OVERLAY_HEAP_SIZE       (OVERLAY_HEAP_END - OVERLAY_HEAP_BASE)
 
+// Caller's sp/ra while an overlay runs (overlay_start.S), in the last KB of
+// the heap: the overlay arena (overlay_arena.h) and _sbrk() stop below it
+#define OVERLAY_SAVE_AREA       0x0007FC00
+#define OVERLAY_ARENA_BASE      OVERLAY_HEAP_BASE
+#define OVERLAY_ARENA_END       OVERLAY_SAVE_AREA
+
+// Scratchpad BRAM (1-cycle access, .fastcode/.fastdata in overlay_linker.ld)
+#define SCRATCHPAD_BASE         0x00080000
+#define OVERLAY_FAST_BASE       SCRATCHPAD_BASE // Overlay share, firmware owns the rest
+#define OVERLAY_FAST_SIZE       (1 * 1024)
+#define OVERLAY_FAST_END        (OVERLAY_FAST_BASE + OVERLAY_FAST_SIZE)
+
 //==============================================================================
 // Memory Map Summary
 //==============================================================================
@@ -95,11 +119,13 @@
   0x0001E640 - 0x0003E63F| 128 KB  | Upload buffer (temporary)
   0x00040000 - 0x00041FFF|   8 KB  | Bootloader (BRAM/ROM)
   0x00042000 - 0x0005EFFF| 116 KB  | Main firmware heap
+  0x0004F000 - 0x0005EFFF|  64 KB  |   RAM disk "1:" (SD_RAMDISK, top of heap)
   0x0005F000 - Stack top (grows down)
   0x0005F000 - 0x0005FFFF|   4 KB  | SAFETY GAP (stack/overlay separation)
   0x00060000 - 0x00077FFF|  96 KB  | Overlay code/data/bss
   0x00078000 - 0x00079FFF|   8 KB  | Overlay stack (grows down)
   0x0007A000 - 0x0007FFFF|  24 KB  | Overlay heap (grows up)
+  0x00080000 - 0x000803FF|   1 KB  | Overlay .fastcode/.fastdata (scratchpad BRAM)
 
   Visual Layout:
 
@@ -144,6 +170,14 @@
 #error "ERROR: Overlay heap extends beyond SRAM!"
 #endif
 
+// Ensure the RAM disk stays inside the main heap and holds a FAT volume
+#if (RAMDISK_BASE < MAIN_HEAP_BASE || RAMDISK_END > MAIN_HEAP_END)
+#error "ERROR: RAM disk outside the main firmware heap!"
+#endif
+#if (RAMDISK_SIZE < 128 * 512)
+#error "ERROR: RAM disk below 128 sectors (f_mkfs minimum)!"
+#endif
+
 // Ensure we have at least some heap space
 #if (OVERLAY_HEAP_SIZE < (4 * 1024))
 #error "ERROR: Overlay heap is less than 4KB!"
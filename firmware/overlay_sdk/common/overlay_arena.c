@@ -0,0 +1,105 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// overlay_arena.c - Overlay Heap Arena
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+
+#include "overlay_arena.h"
+#include "memory_config.h"
+#include <string.h>
+
+#define ARENA_BASE  ((uintptr_t)OVERLAY_ARENA_BASE)
+#define ARENA_END   ((uintptr_t)OVERLAY_ARENA_END)
+
+// In .bss: zero on every start (overlay_start.S clears it), set on first use
+static uintptr_t brk_ptr;       // newlib's break, grows up
+static uintptr_t top;           // Lowest scratch byte, grows down
+
+static inline void arena_init(void) {
+    if (!top) {
+        brk_ptr = ARENA_BASE;
+        top = ARENA_END;
+    }
+}
+
+void *arena_alloc_aligned(size_t size, size_t align) {
+    arena_init();
+
+    if (align < 8) {
+        align = 8;
+    }
+    if ((align & (align - 1)) || size > top - brk_ptr) {
+        return NULL;
+    }
+
+    uintptr_t p = (top - size) & ~(uintptr_t)(align - 1);
+    if (p < brk_ptr) {
+        return NULL;
+    }
+    top = p;
+    return (void *)p;
+}
+
+void *arena_alloc(size_t size) {
+    return arena_alloc_aligned(size, 8);
+}
+
+void *arena_calloc(size_t n, size_t size) {
+    size_t bytes = n * size;
+
+    if (size && bytes / size != n) {
+        return NULL;
+    }
+
+    void *p = arena_alloc_aligned(bytes, 8);
+    if (p) {
+        memset(p, 0, bytes);
+    }
+    return p;
+}
+
+arena_mark_t arena_mark(void) {
+    arena_init();
+    return top;
+}
+
+void arena_release(arena_mark_t mark) {
+    arena_init();
+    if (mark >= top && mark <= ARENA_END) {
+        top = mark;
+    }
+}
+
+void arena_reset(void) {
+    brk_ptr = ARENA_BASE;
+    top = ARENA_END;
+}
+
+size_t arena_available(void) {
+    arena_init();
+    return top - brk_ptr;
+}
+
+size_t arena_heap_used(void) {
+    arena_init();
+    return brk_ptr - ARENA_BASE;
+}
+
+size_t arena_scratch_used(void) {
+    arena_init();
+    return ARENA_END - top;
+}
+
+void *arena_sbrk(int incr) {
+    arena_init();
+
+    uintptr_t prev = brk_ptr;
+    if (incr > 0 ? (size_t)incr > top - brk_ptr
+                 : (size_t)-(intptr_t)incr > brk_ptr - ARENA_BASE) {
+        return (void *)-1;
+    }
+    brk_ptr += incr;
+    return (void *)prev;
+}
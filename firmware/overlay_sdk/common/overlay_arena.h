@@ -0,0 +1,65 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// overlay_arena.h - Overlay Heap Arena
+//
+// The overlay heap (OVERLAY_ARENA_BASE..OVERLAY_ARENA_END, memory_config.h)
+// is one arena with two ends:
+//
+//   - newlib's break grows up from the bottom: io.c's _sbrk() is
+//     arena_sbrk(), so malloc() and everything newlib allocates come
+//     from here
+//   - scratch buffers grow down from the top: arena_alloc() is a pointer
+//     decrement, there is no per-buffer free
+//
+// A mark taken with arena_mark() drops every scratch buffer allocated
+// after it in one step:
+//
+//   arena_mark_t m = arena_mark();
+//   uint8_t *line = arena_alloc(4096);
+//   ... use line ...
+//   arena_release(m);
+//
+// _exit() (overlay_start.S) calls arena_reset(), so whatever the overlay
+// left behind (malloc'd or scratch) is gone when it returns to the SD card
+// manager, and a resident overlay's next run starts on an empty heap.
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+
+#ifndef OVERLAY_ARENA_H
+#define OVERLAY_ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uintptr_t arena_mark_t;
+
+// Scratch buffer, 8-byte aligned. NULL when it would reach the break.
+void *arena_alloc(size_t size);
+
+// Scratch buffer aligned to align (a power of 2)
+void *arena_alloc_aligned(size_t size, size_t align);
+
+// Zeroed scratch buffer for n elements of size bytes
+void *arena_calloc(size_t n, size_t size);
+
+// Current scratch top / drop every scratch buffer allocated after mark
+arena_mark_t arena_mark(void);
+void arena_release(arena_mark_t mark);
+
+// Empty both ends. Leaves newlib's malloc pointing at freed memory: only
+// on the way out (_exit) or before the first malloc().
+void arena_reset(void);
+
+// Bytes between the break and the scratch top
+size_t arena_available(void);
+
+// Bytes below the break (newlib) and above the scratch top
+size_t arena_heap_used(void);
+size_t arena_scratch_used(void);
+
+// _sbrk() backing: moves the break, (void *)-1 if it would reach scratch
+void *arena_sbrk(int incr);
+
+#endif // OVERLAY_ARENA_H
@@ -0,0 +1,78 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// overlay_ff.h - FatFS File Calls for Overlays (OVERLAY_USE_SERVICES)
+//
+// The FatFS names and return codes, served by the SD card manager's copy
+// of FatFS through the service table (overlay_services.h), so an overlay
+// can read and write files on the mounted card without linking FatFS:
+//
+//   FIL f;
+//   UINT br;
+//   if (f_open(&f, "/DATA/IMAGE.RAW", FA_READ) == FR_OK) {
+//       f_read(&f, buf, sizeof(buf), &br);
+//       f_close(&f);
+//   }
+//
+// FIL only holds the manager's handle: at most OVERLAY_SERVICES_FILES
+// files are open at once. Implemented in overlay_shared.c.
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+
+#ifndef OVERLAY_FF_H
+#define OVERLAY_FF_H
+
+#include <stdint.h>
+#include "overlay_services.h"
+
+typedef unsigned int UINT;
+typedef unsigned char BYTE;
+typedef uint32_t FSIZE_t;
+
+// Same values as FatFS R0.15 (sd_fatfs/fatfs/source/ff.h)
+typedef enum {
+    FR_OK = 0,
+    FR_DISK_ERR,
+    FR_INT_ERR,
+    FR_NOT_READY,
+    FR_NO_FILE,
+    FR_NO_PATH,
+    FR_INVALID_NAME,
+    FR_DENIED,
+    FR_EXIST,
+    FR_INVALID_OBJECT,
+    FR_WRITE_PROTECTED,
+    FR_INVALID_DRIVE,
+    FR_NOT_ENABLED,
+    FR_NO_FILESYSTEM,
+    FR_MKFS_ABORTED,
+    FR_TIMEOUT,
+    FR_LOCKED,
+    FR_NOT_ENOUGH_CORE,
+    FR_TOO_MANY_OPEN_FILES,
+    FR_INVALID_PARAMETER
+} FRESULT;
+
+#define FA_READ             0x01
+#define FA_WRITE            0x02
+#define FA_OPEN_EXISTING    0x00
+#define FA_CREATE_NEW       0x04
+#define FA_CREATE_ALWAYS    0x08
+#define FA_OPEN_ALWAYS      0x10
+#define FA_OPEN_APPEND      0x30
+
+typedef struct {
+    int fd;                             // Service table handle, -1 if closed
+} FIL;
+
+FRESULT f_open(FIL *fp, const char *path, BYTE mode);
+FRESULT f_read(FIL *fp, void *buff, UINT btr, UINT *br);
+FRESULT f_write(FIL *fp, const void *buff, UINT btw, UINT *bw);
+FRESULT f_lseek(FIL *fp, FSIZE_t ofs);
+FRESULT f_close(FIL *fp);
+FRESULT f_unlink(const char *path);
+
+#define f_size(fp)          (overlay_services()->file_size((fp)->fd))
+
+#endif // OVERLAY_FF_H
@@ -0,0 +1,62 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// overlay_format.h - Relocatable Overlay Container (.ovl)
+//
+// Written by tools/ovlpack from the overlay ELF (Makefile.overlay, %.ovl)
+// and read by the SD card manager's loader (sd_fatfs/overlay_loader.c).
+// Unlike the flat .bin, only the non-zero parts of the image are stored and
+// the words holding absolute addresses are listed, so the loader can put
+// the overlay at any word-aligned address:
+//
+//   ovl_header_t
+//   ovl_segment_t[segments]    Stored runs of the image, in offset order
+//   segment data               Each padded to a multiple of 4 bytes
+//   uint32_t[relocs]           Offsets of words to add (load - link_base) to
+//
+// Everything in [0, mem_size) not covered by a segment is zero filled by
+// the loader: .bss and the zero runs of .text/.data alike. crc32 covers
+// the file from the segment table to the end; header_crc the header.
+//
+// Below data_offset the image is never written once loaded (.text,
+// .rodata). [data_offset, flat_size) is what running the overlay may
+// change (.data, .got, initialized pointers); a resident overlay
+// (sd_fatfs/overlay_resident.h) keeps a copy of it to start each run from.
+//
+// Code is PC-relative (-fPIC); the relocations are the GOT entries and the
+// pointers in initialized data (R_RISCV_32) that point into the image.
+// References to the fixed stack, heap, scratchpad and MMIO stay as linked.
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+
+#ifndef OVERLAY_FORMAT_H
+#define OVERLAY_FORMAT_H
+
+#include <stdint.h>
+
+#define OVL_MAGIC           0x314C564F  // "OVL1"
+#define OVL_VERSION         2
+
+#define OVL_MAX_SEGMENTS    32          // The loader reads the table at once
+
+typedef struct {
+    uint32_t magic;         // OVL_MAGIC
+    uint32_t version;       // OVL_VERSION
+    uint32_t link_base;     // Address the ELF was linked at (0x60000)
+    uint32_t mem_size;      // Bytes from the load address, .bss included
+    uint32_t entry;         // Entry point, offset from the load address
+    uint32_t segments;      // Entries in the segment table
+    uint32_t relocs;        // Entries in the relocation table
+    uint32_t flat_size;     // Size of the equivalent objcopy -O binary image
+    uint32_t data_offset;   // First writable byte (flat_size if none)
+    uint32_t crc32;         // CRC32 (lib/crc32.h) of the rest of the file
+    uint32_t header_crc;    // CRC32 of the fields above
+} ovl_header_t;
+
+typedef struct {
+    uint32_t offset;        // From the load address, multiple of 4
+    uint32_t size;          // Bytes stored (padded to 4 in the file)
+} ovl_segment_t;
+
+#endif // OVERLAY_FORMAT_H
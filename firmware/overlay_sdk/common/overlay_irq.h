@@ -0,0 +1,74 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// overlay_irq.h - Interrupt Handlers for Overlays
+//
+// The SD card manager's IRQ entry (sd_fatfs/crash_dump.c) calls the
+// handlers an overlay registers here straight from the startup code's
+// vector table, one per source, before any of its own dispatch. Sources
+// the overlay has not taken still reach the manager, so registering the
+// SPI or UART interrupt loses nothing on the other lines.
+//
+//   static void on_tick(uint32_t source) {
+//       TIMER_SR = TIMER_SR_UIF;           // Clear the source, as ever
+//       ticks++;
+//   }
+//
+//   overlay_irq_register(OVERLAY_IRQ_TIMER, on_tick);
+//   ...
+//   overlay_irq_unregister(OVERLAY_IRQ_TIMER);  // Or just return
+//
+// Handlers run in the interrupt with a0 = the source number, may not use
+// the service table, and must clear their source before returning. The
+// manager reads every page of a lazily loaded overlay when one registers,
+// enables the source in the interrupt controller and turns it off again
+// when the overlay returns, with all its handlers removed.
+//
+// OVERLAY_IRQ_SOFT needs the interrupt controller, which tells a software
+// interrupt from EBREAK on the shared IRQ 1. Timer channels 1-3 and the
+// watchdog (IRQ 7) stay with the manager. Under a manager older than
+// services version 4 only the timer can be registered, through the
+// overlay_timer_irq_handler pointer at 0x2A000 the manager calls instead.
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+
+#ifndef OVERLAY_IRQ_H
+#define OVERLAY_IRQ_H
+
+#include <stdint.h>
+#include "overlay_services.h"
+
+// Source numbers (lib/irq.h)
+#define OVERLAY_IRQ_TIMER       0
+#define OVERLAY_IRQ_SOFT        1
+#define OVERLAY_IRQ_SPI         2
+#define OVERLAY_IRQ_MEM_DMA     3
+#define OVERLAY_IRQ_UART_RX     4
+#define OVERLAY_IRQ_UART_TX     5
+#define OVERLAY_IRQ_BUTTON      6
+
+#define OVERLAY_IRQ_LEGACY_HOOK 0x0002A000  // overlay_timer_irq_handler
+
+typedef void (*overlay_irq_handler_t)(uint32_t source);
+
+// 0 once the handler is in place; -1 if the manager cannot give the source
+static inline int overlay_irq_register(uint32_t source, overlay_irq_handler_t handler) {
+    const overlay_services_t *svc = overlay_services();
+
+    if (svc->magic == OVERLAY_SERVICES_MAGIC && svc->version >= 4) {
+        return svc->irq_register(source, handler);
+    }
+    if (source != OVERLAY_IRQ_TIMER) {
+        return -1;
+    }
+    // Called without arguments there: source is not reliable
+    *(void (* volatile *)(void))OVERLAY_IRQ_LEGACY_HOOK = (void (*)(void))handler;
+    return 0;
+}
+
+static inline void overlay_irq_unregister(uint32_t source) {
+    overlay_irq_register(source, 0);
+}
+
+#endif // OVERLAY_IRQ_H
@@ -0,0 +1,113 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// overlay_services.h - SD Card Manager Service Table for Overlays
+//
+// The SD card manager (sd_fatfs/overlay_services.c) exports its console,
+// FatFS and timer code through a table of function pointers in its
+// .overlay_comm section, right after overlay_timer_irq_handler (0x2A000).
+// Overlays call through it instead of linking their own copies: no UART
+// driver, no newlib printf/vfprintf, and file access to the SD card the
+// manager has mounted.
+//
+// Build with OVERLAY_USE_SERVICES = 1 in the project Makefile and the
+// names overlays already use resolve to stubs that call through the table
+// (common/io.c, common/overlay_shared.c): uart_*, printf, snprintf and
+// friends, malloc/calloc/realloc/free, timer_get_ticks, and f_open /
+// f_read / f_write / f_lseek / f_close from overlay_ff.h. newlib is still
+// linked for string and math functions only. The table can also be used
+// directly:
+//
+//   const overlay_services_t *svc = overlay_services();
+//   int fd = svc->file_open("/DATA/LOG.TXT", OVL_FA_READ);
+//   if (fd >= 0) {
+//       n = svc->file_read(fd, buf, sizeof(buf));
+//       svc->file_close(fd);
+//   }
+//
+// Memory from malloc() comes from the manager's heap and whatever the
+// overlay has not freed when it returns is freed then, like its files.
+//
+// Entries are only ever added at the end; version counts them. Calls run
+// on the overlay's stack with interrupts masked around SD card access, and
+// return negative FatFS FRESULT codes on error.
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+
+#ifndef OVERLAY_SERVICES_H
+#define OVERLAY_SERVICES_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+
+#define OVERLAY_SERVICES_ADDR   0x0002A004  // .overlay_comm + 4
+#define OVERLAY_SERVICES_MAGIC  0x4356534F  // "OSVC"
+#define OVERLAY_SERVICES_VERSION 4
+
+#define OVERLAY_SERVICES_FILES  4           // Files open at once
+
+// file_open() modes (same values as FatFS FA_*)
+#define OVL_FA_READ             0x01
+#define OVL_FA_WRITE            0x02
+#define OVL_FA_CREATE_ALWAYS    0x08
+#define OVL_FA_OPEN_ALWAYS      0x10
+#define OVL_FA_OPEN_APPEND      0x30
+
+typedef struct {
+    uint32_t magic;                         // OVERLAY_SERVICES_MAGIC
+    uint32_t version;                       // OVERLAY_SERVICES_VERSION
+    uint32_t cpu_hz;                        // System clock
+
+    // Console (UART; named after io.h, putc/getc are macros in <stdio.h>)
+    void (*uart_putc)(char c);
+    void (*uart_puts)(const char *s);       // No newline added
+    void (*uart_write)(const char *buf, uint32_t len);
+    int  (*uart_getc_available)(void);
+    char (*uart_getc)(void);                // Blocking
+    int  (*vprintf)(const char *fmt, va_list ap);
+
+    // Files on the mounted SD card (FatFS paths; "1:/..." is the RAM disk)
+    int  (*file_open)(const char *path, uint32_t mode);     // Handle or -FRESULT
+    int  (*file_read)(int fd, void *buf, uint32_t len);     // Bytes or -FRESULT
+    int  (*file_write)(int fd, const void *buf, uint32_t len);
+    int  (*file_seek)(int fd, uint32_t offset);
+    uint32_t (*file_size)(int fd);
+    int  (*file_close)(int fd);
+    int  (*file_unlink)(const char *path);
+
+    // Time (cycle counter based: the overlay keeps the timer to itself)
+    uint32_t (*millis)(void);               // Since power-up
+    void (*delay_ms)(uint32_t ms);
+
+    // Version 2: shared C library
+    void *(*malloc)(size_t size);           // 8-byte aligned, manager's heap
+    void  (*free)(void *ptr);
+    void *(*calloc)(size_t n, size_t size);
+    void *(*realloc)(void *ptr, size_t size);
+    int   (*vsnprintf)(char *buf, size_t size, const char *fmt, va_list ap);
+    uint32_t (*timer_get_ticks)(void);      // TIMER_COUNTER
+
+    // Version 3: file copy between volumes ("0:" SD card, "1:" RAM disk
+    // with Kconfig SD_RAMDISK), in multi-block bursts (sd_fatfs/ramdisk.h)
+    int  (*file_copy)(const char *src, const char *dst);    // Bytes or -FRESULT
+
+    // Version 4: interrupt handlers (common/overlay_irq.h). Sources 0-6;
+    // the handler is called straight from the IRQ entry with the source
+    // number, NULL removes it. 0, or -1 for a source that cannot be taken.
+    // All are removed when the overlay returns.
+    int  (*irq_register)(uint32_t source, void (*handler)(uint32_t source));
+} overlay_services_t;
+
+static inline const overlay_services_t *overlay_services(void) {
+    return (const overlay_services_t *)OVERLAY_SERVICES_ADDR;
+}
+
+// 0 when the overlay runs under a manager without the table (or an older one)
+static inline int overlay_services_present(void) {
+    const overlay_services_t *svc = overlay_services();
+    return svc->magic == OVERLAY_SERVICES_MAGIC && svc->version >= OVERLAY_SERVICES_VERSION;
+}
+
+#endif // OVERLAY_SERVICES_H
@@ -0,0 +1,139 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// overlay_shared.c - C Library and FatFS Stubs for OVERLAY_USE_SERVICES
+//
+// Linked ahead of newlib (Makefile.overlay) so these names resolve here
+// and newlib's malloc and vfprintf are never pulled in: each stub is a
+// load from the service table and a jump into the SD card manager's copy.
+// The reentrant _malloc_r family is covered too, for the newlib functions
+// that allocate internally (strdup, fopen): everything ends up on the one
+// heap, and free() works on any of it.
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+
+#include <stddef.h>
+#include <stdarg.h>
+#include <limits.h>
+#include "overlay_services.h"
+#include "overlay_ff.h"
+
+struct _reent;
+
+//==============================================================================
+// Heap
+//==============================================================================
+
+void *malloc(size_t size) {
+    return overlay_services()->malloc(size);
+}
+
+void free(void *ptr) {
+    overlay_services()->free(ptr);
+}
+
+void *calloc(size_t n, size_t size) {
+    return overlay_services()->calloc(n, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    return overlay_services()->realloc(ptr, size);
+}
+
+void *_malloc_r(struct _reent *r, size_t size) {
+    (void)r;
+    return overlay_services()->malloc(size);
+}
+
+void _free_r(struct _reent *r, void *ptr) {
+    (void)r;
+    overlay_services()->free(ptr);
+}
+
+void *_calloc_r(struct _reent *r, size_t n, size_t size) {
+    (void)r;
+    return overlay_services()->calloc(n, size);
+}
+
+void *_realloc_r(struct _reent *r, void *ptr, size_t size) {
+    (void)r;
+    return overlay_services()->realloc(ptr, size);
+}
+
+//==============================================================================
+// Formatted Output (printf/vprintf are in io.c)
+//==============================================================================
+
+int vsnprintf(char *buf, size_t size, const char *fmt, va_list ap) {
+    return overlay_services()->vsnprintf(buf, size, fmt, ap);
+}
+
+int snprintf(char *buf, size_t size, const char *fmt, ...) {
+    va_list ap;
+    int n;
+
+    va_start(ap, fmt);
+    n = overlay_services()->vsnprintf(buf, size, fmt, ap);
+    va_end(ap);
+    return n;
+}
+
+int vsprintf(char *buf, const char *fmt, va_list ap) {
+    return overlay_services()->vsnprintf(buf, INT_MAX, fmt, ap);
+}
+
+int sprintf(char *buf, const char *fmt, ...) {
+    va_list ap;
+    int n;
+
+    va_start(ap, fmt);
+    n = overlay_services()->vsnprintf(buf, INT_MAX, fmt, ap);
+    va_end(ap);
+    return n;
+}
+
+//==============================================================================
+// FatFS (overlay_ff.h)
+//==============================================================================
+
+// Service calls return a byte count or handle, or a negative FRESULT
+static FRESULT ff_result(int r) {
+    return r < 0 ? (FRESULT)-r : FR_OK;
+}
+
+FRESULT f_open(FIL *fp, const char *path, BYTE mode) {
+    int fd = overlay_services()->file_open(path, mode);
+
+    fp->fd = fd < 0 ? -1 : fd;
+    return ff_result(fd);
+}
+
+FRESULT f_read(FIL *fp, void *buff, UINT btr, UINT *br) {
+    int n = overlay_services()->file_read(fp->fd, buff, btr);
+
+    *br = n < 0 ? 0 : (UINT)n;
+    return ff_result(n);
+}
+
+FRESULT f_write(FIL *fp, const void *buff, UINT btw, UINT *bw) {
+    int n = overlay_services()->file_write(fp->fd, buff, btw);
+
+    *bw = n < 0 ? 0 : (UINT)n;
+    return ff_result(n);
+}
+
+FRESULT f_lseek(FIL *fp, FSIZE_t ofs) {
+    return ff_result(overlay_services()->file_seek(fp->fd, ofs));
+}
+
+FRESULT f_close(FIL *fp) {
+    FRESULT fr = ff_result(overlay_services()->file_close(fp->fd));
+
+    fp->fd = -1;
+    return fr;
+}
+
+FRESULT f_unlink(const char *path) {
+    return ff_result(overlay_services()->file_unlink(path));
+}
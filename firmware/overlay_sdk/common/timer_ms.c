@@ -63,11 +63,13 @@ void timer_ms_init(void) {
 }
 
 //==============================================================================
-// Timer interrupt handler (called from firmware's irq_handler)
+// Timer interrupt handler (registered with overlay_irq_register())
 // Mark as "used" to prevent linker from stripping it out
 //==============================================================================
-void timer_ms_irq_handler(void) __attribute__((used));
-void timer_ms_irq_handler(void) {
+void timer_ms_irq_handler(uint32_t source) __attribute__((used));
+void timer_ms_irq_handler(uint32_t source) {
+    (void)source;
+
     // Clear interrupt flag
     TIMER_SR = TIMER_SR_UIF;
 
@@ -23,6 +23,6 @@ uint32_t get_millis(void);
 void sleep_milli(int milliseconds);
 
 // Called by IRQ handler - do not call directly
-void timer_ms_irq_handler(void);
+void timer_ms_irq_handler(uint32_t source);
 
 #endif // TIMER_MS_H
@@ -0,0 +1,95 @@
+//==============================================================================
+// Overlay Project: bench_core
+// main.c - Benchmark overlay: cycle counts as PERF lines
+//
+// Each kernel runs BENCH_RUNS times and the best run is reported
+// (common/bench.h). 'make bench' in the SDK uploads the overlay, collects
+// its lines and adds them to build/overlay_bench/report.md. Replace the
+// example kernels with the code to measure; keep the output to PERF /
+// BENCH lines and plain text.
+//
+// Copyright (c) October 2025
+//==============================================================================
+
+#define BENCH_PROJECT "bench_core"
+
+#include "hardware.h"
+#include "io.h"
+#include "bench.h"
+#include <stdio.h>
+#include <string.h>
+
+//==============================================================================
+// Kernels: each runs iters iterations of what it measures
+//==============================================================================
+
+#define BUF_WORDS   4096                // 16 KB
+
+static uint32_t src[BUF_WORDS];
+static uint32_t dst[BUF_WORDS];
+static volatile uint32_t sink;          // Results go here: not optimized away
+
+// Loop overhead alone
+static void k_loop(uint32_t iters) {
+    for (volatile uint32_t i = 0; i < iters; i++);
+}
+
+// Dependent multiply chain
+static void k_mul(uint32_t iters) {
+    uint32_t x = sink | 3;
+
+    for (uint32_t i = 0; i < iters; i++) {
+        x = x * 0x9E3779B1u + i;
+    }
+    sink = x;
+}
+
+// Dependent divide chain
+static void k_div(uint32_t iters) {
+    uint32_t x = 0xFFFFFFFF;
+
+    for (uint32_t i = 0; i < iters; i++) {
+        x = x / 3 + 0x80000000u;
+    }
+    sink = x;
+}
+
+// 1 KB memcpy (one iteration = one call)
+static void k_memcpy_1k(uint32_t iters) {
+    for (uint32_t i = 0; i < iters; i++) {
+        memcpy(dst, src, 1024);
+    }
+    sink = dst[0];
+}
+
+// SRAM word reads (one iteration = one word)
+static void k_sram_read(uint32_t iters) {
+    uint32_t sum = 0;
+
+    for (uint32_t i = 0; i < iters; i++) {
+        sum += src[i & (BUF_WORDS - 1)];
+    }
+    sink = sum;
+}
+
+//==============================================================================
+// Main Entry Point
+//==============================================================================
+
+int main(void) {
+    for (uint32_t i = 0; i < BUF_WORDS; i++) {
+        src[i] = i * 0x01010101u;
+    }
+
+    printf("\r\nbench_core: best of %d runs\r\n", BENCH_RUNS);
+
+    bench_run("loop", k_loop, 10000);
+    bench_run("mul", k_mul, 10000);
+    bench_run("div", k_div, 1000);
+    bench_run("memcpy_1k", k_memcpy_1k, 100);
+    bench_run("sram_read", k_sram_read, 16384);
+
+    // Out before the manager takes the UART back
+    fflush(stdout);
+    return 0;
+}
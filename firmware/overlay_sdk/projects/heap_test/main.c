@@ -11,6 +11,10 @@
 // - Overlay SDK build system (PIC)
 // - Clean exit back to SD Card Manager
 //
+// Tests 5 and 6 print their cycle counts as PERF / BENCH lines
+// (common/bench.h); scripts/overlay_bench.sh runs them with these keys:
+// BENCH_KEYS: \x2056q
+//
 // Copyright (c) October 2025 Michael Wolak
 // Email: mikewolak@gmail.com, mike@epromfoundry.com
 //===============================================================================
@@ -18,6 +22,10 @@
 #include "hardware.h"
 #include "io.h"
 #include "memory_config.h"
+#include "overlay_arena.h"
+#include "overlay_irq.h"
+#define BENCH_PROJECT "heap_test"
+#include "bench.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -59,10 +67,12 @@ static volatile uint32_t new_second = 0;  // Flag: new second ready to display
 //==============================================================================
 // Timer Interrupt Handler
 //
-// Registered at 0x2A000 with firmware's IRQ dispatcher
-// Called at 1 Hz for throughput measurement
+// Registered with overlay_irq_register(), called from the firmware's IRQ
+// entry at 1 Hz for throughput measurement
 //==============================================================================
-void timer_irq_handler(void) {
+void timer_irq_handler(uint32_t source) {
+    (void)source;
+
     // CRITICAL: Clear the interrupt source FIRST
     TIMER_SR = TIMER_SR_UIF;
 
@@ -94,9 +104,10 @@ static inline void irq_enable(void) {
     __asm__ volatile (".insn r 0x0B, 6, 3, %0, %1, x0" : "=r"(dummy) : "r"(0));
 }
 
+// IRQ 1 stays on: lazily loaded code pages fault in through it
 static inline void irq_disable(void) {
     uint32_t dummy;
-    __asm__ volatile (".insn r 0x0B, 6, 3, %0, %1, x0" : "=r"(dummy) : "r"(0xFFFFFFFF));
+    __asm__ volatile (".insn r 0x0B, 6, 3, %0, %1, x0" : "=r"(dummy) : "r"(0xFFFFFFFD));
 }
 
 //==============================================================================
@@ -401,12 +412,16 @@ static void test_memory_patterns(void) {
     printf("Testing entire allocated region with 5 patterns...\r\n");
     fflush(stdout);
 
+    bench_t b;
+    bench_start(&b);
+
     int all_pass = 1;
     all_pass &= test_pattern_walking_ones(ptr, test_size);
     all_pass &= test_pattern_walking_zeros(ptr, test_size);
     all_pass &= test_pattern_checkerboard(ptr, test_size);
     all_pass &= test_pattern_address_in_address(ptr, test_size);
     all_pass &= test_pattern_random(ptr, test_size);
+    bench_report(&b, "patterns", test_size);     // Cycles per byte, all 5
 
     free(ptr);
     printf("\r\n");
@@ -425,7 +440,9 @@ static void test_stress_allocations(void) {
     uint32_t iterations = 5000;
     uint32_t seed = 0x12345678;
     int failures = 0;
+    bench_t b;
 
+    bench_start(&b);
     for (uint32_t i = 0; i < iterations; i++) {
         // Pseudo-random size (50 - 500 bytes) - scaled down from 100-2000
         seed = seed * 1664525 + 1013904223;
@@ -458,6 +475,8 @@ static void test_stress_allocations(void) {
         }
     }
 
+    bench_report(&b, "stress", iterations);
+
     printf("\r\n");
     printf("Completed %lu iterations\r\n", (unsigned long)iterations);
     printf("Failures: %d\r\n", failures);
@@ -632,9 +651,8 @@ static void test_throughput(void) {
     memset(src, 0xAA, buf_size);
 
     // CRITICAL: Register our timer interrupt handler with the firmware
-    printf("Registering timer IRQ handler at 0x2A000...\r\n");
-    void (**overlay_timer_irq_handler_ptr)(void) = (void (**)(void))0x2A000;
-    *overlay_timer_irq_handler_ptr = timer_irq_handler;
+    printf("Registering timer IRQ handler...\r\n");
+    overlay_irq_register(OVERLAY_IRQ_TIMER, timer_irq_handler);
 
     // Setup timer for 1 Hz interrupts
     heap_timer_config(49, 999999);
@@ -665,7 +683,7 @@ static void test_throughput(void) {
 
     // Unregister our timer interrupt handler
     printf("Unregistering timer IRQ handler...\r\n");
-    *overlay_timer_irq_handler_ptr = 0;
+    overlay_irq_unregister(OVERLAY_IRQ_TIMER);
 
     // Drain UART buffer of any keypresses during tests
     while (UART_RX_STATUS & 0x01) {
@@ -681,6 +699,62 @@ static void test_throughput(void) {
     free(dst);
 }
 
+//==============================================================================
+// Arena Test
+// Scratch buffers from the top of the overlay heap next to malloc()
+//==============================================================================
+
+static void test_arena(void) {
+    printf("\r\n");
+    printf("=== Arena Scratch Test ===\r\n");
+
+    size_t avail = arena_available();
+    printf("Break: %lu bytes used, scratch: %lu, free between: %lu\r\n",
+           (unsigned long)arena_heap_used(), (unsigned long)arena_scratch_used(),
+           (unsigned long)avail);
+
+    arena_mark_t m = arena_mark();
+    uint8_t *buf[3];
+    int ok = 1;
+
+    for (int i = 0; i < 3; i++) {
+        buf[i] = arena_alloc_aligned(1024 * (i + 1), 64);
+        if (!buf[i] || ((uintptr_t)buf[i] & 63)) {
+            printf("FAIL: arena_alloc %d\r\n", i);
+            arena_release(m);
+            return;
+        }
+        memset(buf[i], 0xA0 + i, 1024 * (i + 1));
+    }
+
+    // newlib's heap grows from the other end meanwhile
+    void *p = malloc(2048);
+    if (p) {
+        memset(p, 0x55, 2048);
+    }
+
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 1024 * (i + 1); j++) {
+            if (buf[i][j] != (uint8_t)(0xA0 + i)) {
+                printf("FAIL: scratch %d corrupted at %d\r\n", i, j);
+                ok = 0;
+                break;
+            }
+        }
+    }
+
+    if (arena_alloc(arena_available() + 1)) {
+        printf("FAIL: allocation past the break\r\n");
+        ok = 0;
+    }
+
+    printf("3 buffers (6 KB) held: %lu bytes free\r\n", (unsigned long)arena_available());
+    arena_release(m);
+    free(p);
+    printf("Released:             %lu bytes free\r\n", (unsigned long)arena_available());
+    printf("%s\r\n", ok ? "PASS" : "FAIL");
+}
+
 //==============================================================================
 // Main Menu
 //==============================================================================
@@ -698,6 +772,7 @@ static void show_menu(void) {
     printf("6. Stress test (10 seconds)\r\n");
     printf("7. Throughput test (real-time)\r\n");
     printf("8. Run all tests\r\n");
+    printf("9. Arena scratch test\r\n");
     printf("h. Show this menu\r\n");
     printf("q. Quit (return to SD Card Manager)\r\n");
     printf("========================================\r\n");
@@ -775,6 +850,7 @@ int main(void) {
                 test_memory_patterns();
                 test_stress_allocations();
                 test_throughput();
+                test_arena();
                 printf("\r\n");
                 printf("========================================\r\n");
                 printf("All heap tests complete!\r\n");
@@ -782,6 +858,11 @@ int main(void) {
                 show_menu();
                 break;
 
+            case '9':
+                test_arena();
+                show_menu();
+                break;
+
             case 'h':
             case 'H':
                 show_menu();
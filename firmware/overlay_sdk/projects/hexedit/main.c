@@ -35,7 +35,11 @@
 // Hardware addresses provided by hardware.h
 // Timer macros provided by hardware.h
 
-// No clock/interrupt support in overlay mode
+// No clock/interrupt support in overlay mode; live view reads the free-running
+// timebase (lib/timer.h), which needs neither
+#define TIMEBASE_MS       (*(volatile uint32_t *)0x80000158)
+#define TIMEBASE_INFO     (*(volatile uint32_t *)0x8000015C)
+#define TIMEBASE_PRESENT  (1u << 31)
 
 // Overlay memory layout (from memory_config.h)
 // Code/Data: 0x60000 - 0x78000 (96KB)
@@ -105,6 +109,7 @@ static uint32_t calculate_crc32(uint32_t start_addr, uint32_t end_addr) {
 //==============================================================================
 
 // Helper: Redraw a single memory unit at given address with optional highlighting
+// (attributes, e.g. A_REVERSE for the cursor and selection)
 static void redraw_unit(uint32_t addr, uint32_t top_addr, int view_mode, int highlight) {
     // Check if address is visible on screen
     if (addr < top_addr || addr >= top_addr + (21 * 16)) {
@@ -122,7 +127,7 @@ static void redraw_unit(uint32_t addr, uint32_t top_addr, int view_mode, int hig
 
     // Draw hex value
     move(row + 2, 10 + (col * hex_spacing));
-    if (highlight) attron(A_REVERSE);
+    if (highlight) attron(highlight);
 
     if (view_mode == 0) {
         uint8_t value = ((uint8_t *)addr)[0];
@@ -145,7 +150,7 @@ static void redraw_unit(uint32_t addr, uint32_t top_addr, int view_mode, int hig
 
     // Draw ASCII
     int hex_width = (max_cursor_x + 1) * hex_spacing;
-    if (highlight) attron(A_REVERSE);
+    if (highlight) attron(highlight);
     for (int i = 0; i < bytes_per_unit; i++) {
         uint8_t byte = ((uint8_t *)(addr + i))[0];
         char c = (byte >= 32 && byte < 127) ? byte : '.';
@@ -216,6 +221,85 @@ static void redraw_row(uint32_t row_addr, uint32_t top_addr, int view_mode,
     }
 }
 
+//------------------------------------------------------------------------------
+// Live view ('L'): the visible page is read once per frame, a word at a
+// time, and compared with the previous frame; only the units that differ are
+// redrawn, underlined for LIVE_HOT_FRAMES frames. Frames are paced by the
+// clock, not by the keyboard or by how much changed.
+//------------------------------------------------------------------------------
+
+#define PAGE_BYTES      (21 * 16)   // Visible rows x 16 bytes
+#define LIVE_FRAME_MS   100         // 10 frames/s
+#define LIVE_HOT_FRAMES 10          // A change stays underlined for 1 s
+#define LIVE_NO_PAGE    1           // Never a top_addr (16-byte aligned)
+
+static uint32_t live_shadow[PAGE_BYTES / 4];    // Page as of the last frame
+static uint8_t live_hot[PAGE_BYTES];            // Frames left, by unit offset
+static uint32_t live_top = LIVE_NO_PAGE;        // Page live_shadow holds
+
+// Milliseconds for live view pacing; without a timebase every poll is a frame
+static uint32_t live_clock(void) {
+    static uint32_t polls = 0;
+
+    if (TIMEBASE_INFO & TIMEBASE_PRESENT) {
+        return TIMEBASE_MS;
+    }
+    return polls += LIVE_FRAME_MS;
+}
+
+// One live frame: returns the number of units redrawn. The cursor unit keeps
+// its highlight (it is left alone while being edited), as does the
+// selection being marked (sel_start..sel_end when selecting).
+static int live_frame(uint32_t top_addr, int view_mode, uint32_t cursor_addr, int editing,
+                      uint32_t sel_start, uint32_t sel_end, int selecting) {
+    uint32_t page[PAGE_BYTES / 4];
+    const volatile uint32_t *src = (const volatile uint32_t *)top_addr;
+    int bytes_per_unit = (view_mode == 0) ? 1 : (view_mode == 1) ? 2 : 4;
+    int drawn = 0;
+
+    for (int i = 0; i < PAGE_BYTES / 4; i++) {
+        page[i] = src[i];
+    }
+
+    if (live_top != top_addr) {
+        // New page (or just redrawn): this frame is the reference
+        memcpy(live_shadow, page, sizeof(page));
+        memset(live_hot, 0, sizeof(live_hot));
+        live_top = top_addr;
+        return 0;
+    }
+
+    const uint8_t *now = (const uint8_t *)page;
+    const uint8_t *was = (const uint8_t *)live_shadow;
+    for (int off = 0; off < PAGE_BYTES; off += bytes_per_unit) {
+        if (memcmp(now + off, was + off, bytes_per_unit) != 0) {
+            live_hot[off] = LIVE_HOT_FRAMES;
+        } else if (live_hot[off] > 1) {
+            live_hot[off]--;
+            continue;
+        } else if (live_hot[off] == 1) {
+            live_hot[off] = 0;      // Cooled down: draw it plain again
+        } else {
+            continue;
+        }
+
+        uint32_t addr = top_addr + off;
+        if (addr == cursor_addr && editing) {
+            continue;
+        }
+
+        int attr = live_hot[off] ? A_UNDERLINE : A_NORMAL;
+        if (addr == cursor_addr || (selecting && addr >= sel_start && addr <= sel_end)) {
+            attr |= A_REVERSE;
+        }
+        redraw_unit(addr, top_addr, view_mode, attr);
+        drawn++;
+    }
+
+    memcpy(live_shadow, page, sizeof(page));
+    return drawn;
+}
+
 // Visual hex editor with curses interface
 void cmd_visual(uint32_t start_addr) {
     int cursor_x = 0;   // 0-15 (byte column) or 0-7 (word) or 0-3 (dword)
@@ -251,6 +335,10 @@ void cmd_visual(uint32_t start_addr) {
     uint32_t old_mark_start = 0;  // Previous mark start for incremental updates
     uint32_t old_mark_end = 0;    // Previous mark end for incremental updates
 
+    // Live view state
+    int live = 0;                 // Poll the page and highlight changes
+    uint32_t live_last = 0;       // Time of the last live frame
+
     // Initialize curses
     initscr();
     noecho();
@@ -261,13 +349,15 @@ void cmd_visual(uint32_t start_addr) {
         // Only do full redraw if needed (first time or page change)
         if (need_full_redraw) {
             clear();
+            live_top = LIVE_NO_PAGE;  // Highlights are gone, start over
 
             // Draw title bar with view mode
             move(0, 0);
             attron(A_REVERSE);
             const char *mode_str = (view_mode == 0) ? "BYTE" : (view_mode == 1) ? "WORD" : "DWORD";
             char title[81];
-            snprintf(title, sizeof(title), "Hex Editor [%s] - Arrows:nav Shift+Arrows:select Enter:edit W:mode G:goto M:mark Q:exit", mode_str);
+            snprintf(title, sizeof(title), "Hex Editor [%s%s] Shift:sel Enter:edit W:mode G:goto M:mark L:live Q:exit",
+                     mode_str, live ? " LIVE" : "");
             addstr(title);
             for (int i = strlen(title); i < COLS; i++) addch(' ');
             standend();
@@ -345,7 +435,7 @@ void cmd_visual(uint32_t start_addr) {
             }
 
             // Use redraw_unit to properly handle highlighting state
-            redraw_unit(old_addr, top_addr, view_mode, should_highlight);
+            redraw_unit(old_addr, top_addr, view_mode, should_highlight ? A_REVERSE : A_NORMAL);
         }
 
         // Draw new cursor position (highlight)
@@ -472,13 +562,13 @@ void cmd_visual(uint32_t start_addr) {
                 // Highlight region that's newly selected
                 for (uint32_t addr = range_start; addr <= range_end; addr += bytes_per_unit) {
                     if (addr < old_start || addr > old_end) {
-                        redraw_unit(addr, top_addr, view_mode, 1);
+                        redraw_unit(addr, top_addr, view_mode, A_REVERSE);
                     }
                 }
             } else {
                 // First time marking - highlight entire range
                 for (uint32_t addr = range_start; addr <= range_end; addr += bytes_per_unit) {
-                    redraw_unit(addr, top_addr, view_mode, 1);
+                    redraw_unit(addr, top_addr, view_mode, A_REVERSE);
                 }
             }
 
@@ -499,67 +589,65 @@ void cmd_visual(uint32_t start_addr) {
         }
 
         // Cursor management
+        int cur_row = LINES - 1;
+        int cur_col = 0;
         if (goto_mode) {
             // Show cursor at goto input position
             curs_set(1);
-            move(LINES - 1, 6 + goto_len);  // Position after "Goto: " prompt
+            cur_col = 6 + goto_len;  // Position after "Goto: " prompt
         } else if (searching) {
             // Show cursor at search input position
             curs_set(1);
-            move(LINES - 1, 8 + search_len);  // Position after "Search: " prompt
+            cur_col = 8 + search_len;  // Position after "Search: " prompt
         } else if (editing) {
             // Show cursor and position it at the edit location
             curs_set(1);
-            move(cursor_y + 2, 10 + (cursor_x * hex_spacing) + edit_nibble);
+            cur_row = cursor_y + 2;
+            cur_col = 10 + (cursor_x * hex_spacing) + edit_nibble;
         } else {
             // Hide cursor when navigating
             curs_set(0);
         }
+        move(cur_row, cur_col);
 
         refresh();
 
         // Get key - handle escape sequences for arrow keys
-        int ch = getch();
-
-        // Handle escape sequences (arrow keys send ESC [ A/B/C/D)
-        // Shift+arrow keys send ESC [ 1 ; 2 A/B/C/D
-        if (ch == 27) {  // ESC
-            int ch2 = getch();
-            if (ch2 == '[') {
-                int ch3 = getch();
-                if (ch3 == '1') {
-                    // Could be shift+arrow: ESC [ 1 ; 2 A/B/C/D
-                    int ch4 = getch();
-                    if (ch4 == ';') {
-                        int ch5 = getch();
-                        if (ch5 == '2') {
-                            int ch6 = getch();
-                            // Shift+arrow keys
-                            switch (ch6) {
-                                case 'A': ch = 165; break;  // Shift+Up
-                                case 'B': ch = 166; break;  // Shift+Down
-                                case 'C': ch = 167; break;  // Shift+Right
-                                case 'D': ch = 168; break;  // Shift+Left
-                                default: ch = 27; break;
-                            }
-                        } else {
-                            ch = 27;  // Unknown sequence
-                        }
-                    } else {
-                        ch = 27;  // Unknown sequence
-                    }
-                } else {
-                    // Regular arrow keys: ESC [ A/B/C/D
-                    switch (ch3) {
-                        case 'A': ch = 65; break;  // Up arrow
-                        case 'B': ch = 66; break;  // Down arrow
-                        case 'C': ch = 67; break;  // Right arrow
-                        case 'D': ch = 68; break;  // Left arrow
-                        default: ch = 27; break;   // Unknown, treat as ESC
-                    }
+        int ch;
+        if (live) {
+            // Live view: run frames on the clock until a key arrives
+            uint32_t sel_start = (mark_start < current_addr) ? mark_start : current_addr;
+            uint32_t sel_end = (mark_start < current_addr) ? current_addr : mark_start;
+
+            timeout(0);
+            while ((ch = getch()) == ERR) {
+                uint32_t now = live_clock();
+                if (now - live_last < LIVE_FRAME_MS) {
+                    continue;
+                }
+                live_last = now;
+                if (live_frame(top_addr, view_mode, current_addr, editing,
+                               sel_start, sel_end, marking == 1)) {
+                    move(cur_row, cur_col);
+                    refresh();
                 }
             }
-            // If not '[', fall through with ESC
+            timeout(-1);
+        } else {
+            ch = getch();
+        }
+
+        // Keys come decoded (keypad mode); this editor's own codes are
+        // 65-68 for the arrows and 165-168 for Shift+arrows
+        switch (ch) {
+            case KEY_UP:     ch = 65; break;
+            case KEY_DOWN:   ch = 66; break;
+            case KEY_RIGHT:  ch = 67; break;
+            case KEY_LEFT:   ch = 68; break;
+            case KEY_SR:     ch = 165; break;
+            case KEY_SF:     ch = 166; break;
+            case KEY_SRIGHT: ch = 167; break;
+            case KEY_SLEFT:  ch = 168; break;
         }
 
         if (editing) {
@@ -830,7 +918,14 @@ void cmd_visual(uint32_t start_addr) {
                         cursor_y--;
                     } else if (top_addr >= 16) {
                         top_addr -= 16;
-                        need_full_redraw = 1;
+                        // Scroll the data rows (2-22) down and draw only the new top row
+                        setscrreg(2, 22);
+                        scrl(-1);
+                        setscrreg(0, LINES - 1);
+                        redraw_row(top_addr, top_addr, view_mode, 0, 0, 0);
+                        // The cursor highlight moved down with its row
+                        old_cursor_x = cursor_x;
+                        old_cursor_y = 1;
                     }
                     break;
 
@@ -842,7 +937,14 @@ void cmd_visual(uint32_t start_addr) {
                         cursor_y++;
                     } else {
                         top_addr += 16;
-                        need_full_redraw = 1;
+                        // Scroll the data rows (2-22) up and draw only the new bottom row
+                        setscrreg(2, 22);
+                        scrl(1);
+                        setscrreg(0, LINES - 1);
+                        redraw_row(top_addr + (20 * 16), top_addr, view_mode, 0, 0, 0);
+                        // The cursor highlight moved up with its row
+                        old_cursor_x = cursor_x;
+                        old_cursor_y = 19;
                     }
                     break;
 
@@ -886,6 +988,12 @@ void cmd_visual(uint32_t start_addr) {
                     need_full_redraw = 1;
                     break;
 
+                case 'L':  // Toggle live view
+                    live = !live;
+                    live_last = live_clock();
+                    need_full_redraw = 1;  // Title shows LIVE
+                    break;
+
                 case '/':  // Start search
                     searching = 1;
                     search_len = 0;
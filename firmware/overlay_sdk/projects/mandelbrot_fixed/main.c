@@ -5,9 +5,18 @@
 // Controls:
 //   R: Reset to default view
 //   +/-: Adjust max iterations
+//   M: Next render mode (BRUTE / REJECT / TRACE)
+//   B: Time every render mode on the current view
 //   Q: Quit
+//
+// On exit each timed mode is also printed as PERF / BENCH lines
+// (common/bench.h) for scripts/overlay_bench.sh, which drives it with the
+// keys below (terminal size reply, B, Q, any key).
+// BENCH_KEYS: \e[24;80Rbq\x20
 //==============================================================================
 
+#define BENCH_PROJECT "mandelbrot_fixed"
+
 #include <stdio.h>
 #include <stdint.h>
 #include <stdbool.h>
@@ -15,6 +24,8 @@
 #include "hardware.h"
 #include "io.h"
 #include "timer_ms.h"
+#include "overlay_irq.h"
+#include "bench.h"
 
 //==============================================================================
 // VT100 Terminal Size Detection
@@ -120,6 +131,7 @@ typedef struct {
     int max_iter;
     uint32_t last_calc_time_ms;
     uint32_t last_total_iters;  // Total iterations in last render
+    int mode;                   // MODE_BRUTE, MODE_REJECT, MODE_TRACE
     int screen_rows, screen_cols;  // Track current screen size
 } mandelbrot_state;
 
@@ -164,64 +176,238 @@ static const char* iter_to_char(int iter, int max_iter) {
 }
 
 //==============================================================================
-// Draw the Mandelbrot Set - PURE FIXED-POINT (NO FLOAT!)
+// Render modes
+//   BRUTE:  every pixel iterated to escape or max_iter (the core benchmark)
+//   REJECT: points in the main cardioid or the period-2 bulb are not
+//           iterated at all, and an orbit that comes back to an earlier
+//           point (periodicity, exact in fixed point) stops there. Same
+//           picture as BRUTE.
+//   TRACE:  REJECT plus boundary tracing (Mariani-Silver): a rectangle
+//           whose border is all one character is filled without
+//           iterating its inside, otherwise it is split in two. Detail
+//           smaller than a rectangle whose border misses it is lost.
+//==============================================================================
+enum { MODE_BRUTE, MODE_REJECT, MODE_TRACE, MODE_COUNT };
+static const char *MODE_NAMES[MODE_COUNT] = { "BRUTE", "REJECT", "TRACE" };
+static const char *BENCH_NAMES[MODE_COUNT] = { "brute", "reject", "trace" };
+
+typedef struct {
+    bool valid;                  // Measured at the current view and max_iter
+    uint32_t time_ms;
+    uint32_t total_iters;
+    uint32_t cycles;             // rdcycle / rdinstret over the same span
+    uint32_t instret;
+} mode_stats;
+
+static mode_stats stats[MODE_COUNT];
+
+typedef struct {
+    int32_t real_step, imag_step;
+    int rows, cols;              // Clipped to render_buffer
+    uint32_t total_iters;
+} render_ctx;
+
+// Iterate one point with cardioid/bulb rejection and periodicity checking;
+// returns max_iter for points inside the set
+static int iterate_reject(int32_t real, int32_t imag, uint32_t *total_iters) {
+    // Tests in Q32 (squares kept whole), rounded towards "outside": near
+    // the cusp at 1/4 Q16 squares of the tiny y and q would be 0
+    int64_t y2 = (int64_t)imag * imag;
+
+    // Main cardioid: q * (q + x - 1/4) <= y^2 / 4, q = (x - 1/4)^2 + y^2
+    int64_t xq = (int64_t)(real - FIXED_ONE / 4) << FIXED_SHIFT;
+    int64_t q = (int64_t)(real - FIXED_ONE / 4) * (real - FIXED_ONE / 4) + y2;
+    int64_t q16 = (q + FIXED_ONE - 1) >> FIXED_SHIFT;
+    int64_t s16 = (q + xq + FIXED_ONE - 1) >> FIXED_SHIFT;
+    if (q16 * s16 <= y2 / 4) {
+        return state.max_iter;
+    }
+
+    // Period-2 bulb: (x + 1)^2 + y^2 <= 1/16
+    int64_t x1 = real + FIXED_ONE;
+    if (x1 * x1 + y2 <= ((int64_t)1 << (2 * FIXED_SHIFT)) / 16) {
+        return state.max_iter;
+    }
+
+    int32_t zr = 0, zi = 0, zr2 = 0, zi2 = 0;
+    int32_t saved_r = 0, saved_i = 0;   // Orbit point to compare against
+    int check = 8;                      // Save again at iteration 8, 16, 32...
+    int iter = 0;
+    int32_t escape_radius_sq = 4 << FIXED_SHIFT;
+
+    while (iter < state.max_iter && (zr2 + zi2) < escape_radius_sq) {
+        zi = fixed_mul(zr, zi);
+        zi += zi;  // 2 * zr * zi
+        zi += imag;
+
+        zr = zr2 - zi2 + real;
+
+        zr2 = fixed_mul(zr, zr);
+        zi2 = fixed_mul(zi, zi);
+
+        iter++;
+
+        if (zr == saved_r && zi == saved_i) {
+            *total_iters += iter;
+            return state.max_iter;      // In a cycle: never escapes
+        }
+        if (iter == check) {
+            saved_r = zr;
+            saved_i = zi;
+            check += check;
+        }
+    }
+
+    *total_iters += iter;
+    return iter;
+}
+
+// Character at (row, col), computed on first use (0 = not yet)
+static char trace_pixel(render_ctx *ctx, int row, int col) {
+    char *p = &render_buffer[row][col];
+    if (*p == 0) {
+        int iter = iterate_reject(state.min_real + col * ctx->real_step,
+                                  state.min_imag + row * ctx->imag_step,
+                                  &ctx->total_iters);
+        *p = iter_to_char(iter, state.max_iter)[0];
+    }
+    return *p;
+}
+
+// Rectangle (r0, c0) - (r1, c1), edges included
+static void trace_rect(render_ctx *ctx, int r0, int c0, int r1, int c1) {
+    char ch = trace_pixel(ctx, r0, c0);
+    bool same = true;
+
+    for (int col = c0; col <= c1; col++) {
+        same &= trace_pixel(ctx, r0, col) == ch;
+        same &= trace_pixel(ctx, r1, col) == ch;
+    }
+    for (int row = r0 + 1; row < r1; row++) {
+        same &= trace_pixel(ctx, row, c0) == ch;
+        same &= trace_pixel(ctx, row, c1) == ch;
+    }
+
+    if (r1 - r0 < 2 || c1 - c0 < 2) {
+        return;                         // No inside left
+    }
+
+    if (same) {
+        for (int row = r0 + 1; row < r1; row++) {
+            for (int col = c0 + 1; col < c1; col++) {
+                render_buffer[row][col] = ch;
+            }
+        }
+    } else if (c1 - c0 >= r1 - r0) {
+        int mid = (c0 + c1) / 2;
+        trace_rect(ctx, r0, c0, r1, mid);
+        trace_rect(ctx, r0, mid, r1, c1);
+    } else {
+        int mid = (r0 + r1) / 2;
+        trace_rect(ctx, r0, c0, mid, c1);
+        trace_rect(ctx, mid, c0, r1, c1);
+    }
+}
+
+//==============================================================================
+// Compute the Mandelbrot Set into render_buffer - PURE FIXED-POINT (NO FLOAT!)
 // Timing excludes UART display time
 //==============================================================================
-static void draw_mandelbrot(WINDOW *win) {
-    uint32_t total_iters = 0;
+static void render(int mode) {
+    render_ctx ctx;
 
     // Calculate step size in fixed-point (pure integer division)
-    int32_t real_step = (state.max_real - state.min_real) / SCREEN_WIDTH;
-    int32_t imag_step = (state.max_imag - state.min_imag) / SCREEN_HEIGHT;
+    ctx.real_step = (state.max_real - state.min_real) / SCREEN_WIDTH;
+    ctx.imag_step = (state.max_imag - state.min_imag) / SCREEN_HEIGHT;
+    ctx.rows = SCREEN_HEIGHT < 200 ? SCREEN_HEIGHT : 200;
+    ctx.cols = SCREEN_WIDTH < 150 ? SCREEN_WIDTH : 150;
+    ctx.total_iters = 0;
 
     // TIMING START - Only measure calculation, not UART display!
     uint32_t start_time = get_millis();
+    bench_t b;
+    bench_start(&b);
 
-    int32_t imag = state.min_imag;
+    if (mode == MODE_TRACE) {
+        for (int row = 0; row < ctx.rows; row++) {
+            for (int col = 0; col < ctx.cols; col++) {
+                render_buffer[row][col] = 0;
+            }
+        }
+        trace_rect(&ctx, 0, 0, ctx.rows - 1, ctx.cols - 1);
+    } else {
+        int32_t imag = state.min_imag;
 
-    for (int row = 0; row < SCREEN_HEIGHT; row++) {
-        int32_t real = state.min_real;
+        for (int row = 0; row < SCREEN_HEIGHT; row++) {
+            int32_t real = state.min_real;
 
-        for (int col = 0; col < SCREEN_WIDTH; col++) {
-            // No floating point - real and imag are already fixed-point!
-            int32_t zr = 0;
-            int32_t zi = 0;
-            int32_t zr2 = 0;
-            int32_t zi2 = 0;
+            for (int col = 0; col < SCREEN_WIDTH; col++) {
+                int iter;
 
-            int iter = 0;
-            int32_t escape_radius_sq = 4 << FIXED_SHIFT;
+                if (mode == MODE_REJECT) {
+                    iter = iterate_reject(real, imag, &ctx.total_iters);
+                } else {
+                    // No floating point - real and imag are already fixed-point!
+                    int32_t zr = 0;
+                    int32_t zi = 0;
+                    int32_t zr2 = 0;
+                    int32_t zi2 = 0;
 
-            while (iter < state.max_iter && (zr2 + zi2) < escape_radius_sq) {
-                zi = fixed_mul(zr, zi);
-                zi += zi;  // 2 * zr * zi
-                zi += imag;
+                    iter = 0;
+                    int32_t escape_radius_sq = 4 << FIXED_SHIFT;
 
-                zr = zr2 - zi2 + real;
+                    while (iter < state.max_iter && (zr2 + zi2) < escape_radius_sq) {
+                        zi = fixed_mul(zr, zi);
+                        zi += zi;  // 2 * zr * zi
+                        zi += imag;
 
-                zr2 = fixed_mul(zr, zr);
-                zi2 = fixed_mul(zi, zi);
+                        zr = zr2 - zi2 + real;
 
-                iter++;
-            }
+                        zr2 = fixed_mul(zr, zr);
+                        zi2 = fixed_mul(zi, zi);
 
-            total_iters += iter;
-            const char* ch = iter_to_char(iter, state.max_iter);
+                        iter++;
+                    }
 
-            // Store in render buffer (not timed)
-            if (row < 200 && col < 150) {
-                render_buffer[row][col] = ch[0];
+                    ctx.total_iters += iter;
+                }
+
+                const char* ch = iter_to_char(iter, state.max_iter);
+
+                // Store in render buffer (not timed)
+                if (row < 200 && col < 150) {
+                    render_buffer[row][col] = ch[0];
+                }
+
+                real += ctx.real_step;  // Just integer add!
             }
 
-            real += real_step;  // Just integer add!
+            imag += ctx.imag_step;  // Just integer add!
         }
-
-        imag += imag_step;  // Just integer add!
     }
 
     // TIMING END - Stop before UART display
+    bench_stop(&b, &stats[mode].cycles, &stats[mode].instret);
     state.last_calc_time_ms = get_millis() - start_time;
-    state.last_total_iters = total_iters;
+    state.last_total_iters = ctx.total_iters;
+
+    stats[mode].valid = true;
+    stats[mode].time_ms = state.last_calc_time_ms;
+    stats[mode].total_iters = ctx.total_iters;
+}
+
+// Timings at another view or max_iter no longer compare
+static void invalidate_stats(void) {
+    for (int m = 0; m < MODE_COUNT; m++) {
+        stats[m].valid = false;
+    }
+}
+
+//==============================================================================
+// Draw the Mandelbrot Set in the current mode
+//==============================================================================
+static void draw_mandelbrot(WINDOW *win) {
+    render(state.mode);
 
     // Now display to screen (not timed)
     for (int row = 0; row < SCREEN_HEIGHT; row++) {
@@ -236,6 +422,16 @@ static void draw_mandelbrot(WINDOW *win) {
     wrefresh(win);
 }
 
+// Render the view in every mode, the current one last (it is displayed)
+static void bench_modes(WINDOW *win) {
+    for (int m = 0; m < MODE_COUNT; m++) {
+        if (m != state.mode) {
+            render(m);
+        }
+    }
+    draw_mandelbrot(win);
+}
+
 //==============================================================================
 // Check for terminal resize
 //==============================================================================
@@ -261,6 +457,7 @@ static void reset_view(void) {
     state.max_real = double_to_fixed(1.0);    //  1.0 << 16
     state.min_imag = double_to_fixed(-1.0);   // -1.0 << 16
     state.max_imag = double_to_fixed(1.0);    //  1.0 << 16
+    invalidate_stats();
 }
 
 //==============================================================================
@@ -276,13 +473,19 @@ static void draw_info_bar(void) {
         mips = (double)state.last_total_iters / (double)state.last_calc_time_ms / 1000.0;
     }
 
-    printw("OPTIMIZED FIXED-POINT | Display: %dx%d | Iter: %d | Time: %lums | %.2fM iter/s",
-           g_term_cols, g_term_rows, state.max_iter,
+    printw("OPTIMIZED FIXED-POINT %s | Display: %dx%d | Iter: %d | Time: %lums | %.2fM iter/s",
+           MODE_NAMES[state.mode], g_term_cols, g_term_rows, state.max_iter,
            (unsigned long)state.last_calc_time_ms, mips);
 
     move(SCREEN_HEIGHT + 1, 0);
     clrtoeol();
-    printw("R:Reset +/-:Iter Q:Quit | No arrows/zoom - pure performance test!");
+    printw("R:Reset +/-:Iter M:Mode B:Bench Q:Quit |");
+    for (int m = 0; m < MODE_COUNT; m++) {
+        if (stats[m].valid) {
+            printw(" %s %lums/%luk", MODE_NAMES[m], (unsigned long)stats[m].time_ms,
+                   (unsigned long)(stats[m].total_iters / 1000));
+        }
+    }
 
     refresh();
 }
@@ -299,12 +502,10 @@ int main(int argc, char **argv) {
     printf("Initializing...\r\n");
 
     // Register our timer interrupt handler with the firmware
-    // The firmware's IRQ handler will call this function pointer
-    // Address 0x2A000 is the fixed location of overlay_timer_irq_handler in firmware
-    volatile void (**overlay_timer_irq_handler_ptr)(void) = (void (**)(void))0x2A000;
-    *overlay_timer_irq_handler_ptr = timer_ms_irq_handler;
+    // The firmware's IRQ entry calls it for every timer interrupt
+    overlay_irq_register(OVERLAY_IRQ_TIMER, timer_ms_irq_handler);
 
-    printf("Timer handler registered at 0x2A000\r\n");
+    printf("Timer handler registered\r\n");
 
     // Initialize timer (needed for query_terminal_size timeout)
     timer_ms_init();
@@ -336,6 +537,7 @@ int main(int argc, char **argv) {
     state.max_iter = MAX_ITER_DEFAULT;
     state.last_calc_time_ms = 0;
     state.last_total_iters = 0;
+    state.mode = MODE_BRUTE;
     state.screen_rows = g_term_rows;
     state.screen_cols = g_term_cols;
 
@@ -391,6 +593,21 @@ int main(int argc, char **argv) {
                     needs_redraw = true;
                     break;
 
+                // Next render mode
+                case 'm':
+                case 'M':
+                    state.mode = (state.mode + 1) % MODE_COUNT;
+                    needs_redraw = true;
+                    break;
+
+                // Time every mode on this view
+                case 'b':
+                case 'B':
+                    wclear(mandel_win);
+                    bench_modes(mandel_win);
+                    draw_info_bar();
+                    break;
+
                 // Adjust max iterations
                 case '+':
                 case '=':
@@ -400,6 +617,7 @@ int main(int argc, char **argv) {
                                         state.max_iter + 128;
                         if (state.max_iter > MAX_ITER_MAX)
                             state.max_iter = MAX_ITER_MAX;
+                        invalidate_stats();
                         needs_redraw = true;
                     }
                     break;
@@ -412,6 +630,7 @@ int main(int argc, char **argv) {
                                         state.max_iter - 128;
                         if (state.max_iter < 32)
                             state.max_iter = 32;
+                        invalidate_stats();
                         needs_redraw = true;
                     }
                     break;
@@ -437,11 +656,23 @@ int main(int argc, char **argv) {
     printf("\r\n\r\nMandelbrot Explorer (OPTIMIZED FIXED-POINT) exited.\r\n");
     printf("Max iterations: %d\r\n", state.max_iter);
     printf("Last calculation time: %lu ms\r\n", (unsigned long)state.last_calc_time_ms);
+    for (int m = 0; m < MODE_COUNT; m++) {
+        if (stats[m].valid) {
+            printf("  %-6s %6lu ms %10lu iterations\r\n", MODE_NAMES[m],
+                   (unsigned long)stats[m].time_ms, (unsigned long)stats[m].total_iters);
+        }
+    }
     printf("Performance: %.2f M iter/s\r\n",
            (double)state.last_total_iters / (double)state.last_calc_time_ms / 1000.0);
+    for (int m = 0; m < MODE_COUNT; m++) {
+        if (stats[m].valid) {
+            bench_result(BENCH_NAMES[m], stats[m].total_iters, stats[m].cycles,
+                         stats[m].instret);
+        }
+    }
 
     // Unregister our timer interrupt handler
-    *overlay_timer_irq_handler_ptr = 0;
+    overlay_irq_unregister(OVERLAY_IRQ_TIMER);
 
     printf("\r\nPress any key to return to menu...\r\n");
 
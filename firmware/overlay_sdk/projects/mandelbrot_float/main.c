@@ -15,6 +15,7 @@
 #include "hardware.h"
 #include "io.h"
 #include "timer_ms.h"
+#include "overlay_irq.h"
 
 //==============================================================================
 // VT100 Terminal Size Detection
@@ -296,10 +297,8 @@ int main(int argc, char **argv) {
     printf("Initializing...\r\n");
 
     // Register our timer interrupt handler with the firmware
-    // The firmware's IRQ handler will call this function pointer
-    // Address 0x2A000 is the fixed location of overlay_timer_irq_handler in firmware
-    volatile void (**overlay_timer_irq_handler_ptr)(void) = (void (**)(void))0x2A000;
-    *overlay_timer_irq_handler_ptr = timer_ms_irq_handler;
+    // The firmware's IRQ entry calls it for every timer interrupt
+    overlay_irq_register(OVERLAY_IRQ_TIMER, timer_ms_irq_handler);
 
     // Initialize timer (needed for query_terminal_size timeout)
     timer_ms_init();
@@ -432,7 +431,7 @@ int main(int argc, char **argv) {
            (double)state.last_total_iters / (double)state.last_calc_time_ms / 1000.0);
 
     // Unregister our timer interrupt handler
-    *overlay_timer_irq_handler_ptr = 0;
+    overlay_irq_unregister(OVERLAY_IRQ_TIMER);
 
     printf("\r\nPress any key to return to menu...\r\n");
 
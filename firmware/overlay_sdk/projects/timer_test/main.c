@@ -11,6 +11,7 @@
 
 #include "hardware.h"
 #include "io.h"
+#include "overlay_irq.h"
 #include <stdio.h>
 
 //==============================================================================
@@ -62,11 +63,13 @@ volatile uint32_t hours = 0;    // Hours counter (0-23)
 //==============================================================================
 // Timer Interrupt Handler
 //
-// This is called via overlay_timer_irq_handler pointer at 0x2A000
-// which is registered by main() before starting the timer.
+// Called from the firmware's IRQ entry once main() has registered it
+// with overlay_irq_register(), before starting the timer.
 //==============================================================================
 
-void timer_irq_handler(void) {
+void timer_irq_handler(uint32_t source) {
+    (void)source;
+
     // CRITICAL: Clear the interrupt source FIRST
     timer_clock_clear_irq();
 
@@ -147,10 +150,8 @@ int main(void) {
     printf("\r\n");
 
     // CRITICAL: Register our timer interrupt handler with the firmware
-    // The firmware's IRQ handler will call this function pointer at 0x2A000
-    printf("Registering timer IRQ handler at 0x2A000...\r\n");
-    void (**overlay_timer_irq_handler_ptr)(void) = (void (**)(void))0x2A000;
-    *overlay_timer_irq_handler_ptr = timer_irq_handler;
+    printf("Registering timer IRQ handler...\r\n");
+    overlay_irq_register(OVERLAY_IRQ_TIMER, timer_irq_handler);
 
     printf("Configuring timer for 60 Hz interrupts...\r\n");
 
@@ -211,7 +212,7 @@ int main(void) {
 
     // Unregister our timer interrupt handler
     printf("Unregistering timer IRQ handler...\r\n");
-    *overlay_timer_irq_handler_ptr = 0;
+    overlay_irq_unregister(OVERLAY_IRQ_TIMER);
 
     printf("\r\n");
     printf("Timer test complete!\r\n");
@@ -9,6 +9,8 @@
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
+#include "../lib/fmt/fmt.h"
+#include "../lib/perf_counters.h"
 
 // UART direct access for menu (no echo, no buffering)
 #define UART_RX_DATA   (*(volatile unsigned int*)0x80000008)
@@ -229,6 +231,75 @@ static void test_comparison(void) {
     printf("Both go through UART to terminal\r\n");
 }
 
+//==============================================================================
+// newlib vs lib/fmt
+//==============================================================================
+
+#define BENCH_ITERS 200
+
+// _snprintf_r / _printf_r are newlib's own even with CONFIG_PRINTF_FMT
+// (only printf, snprintf, ... are wrapped)
+#define BENCH(name, ...) do {                                               \
+    char a[64], b[64];                                                      \
+    uint32_t t0, t_newlib, t_fmt;                                           \
+    t0 = rdcycle();                                                         \
+    for (int i = 0; i < BENCH_ITERS; i++)                                   \
+        _snprintf_r(_REENT, a, sizeof(a), __VA_ARGS__);                     \
+    t_newlib = (rdcycle() - t0) / BENCH_ITERS;                              \
+    t0 = rdcycle();                                                         \
+    for (int i = 0; i < BENCH_ITERS; i++)                                   \
+        fmt_snprintf(b, sizeof(b), __VA_ARGS__);                            \
+    t_fmt = (rdcycle() - t0) / BENCH_ITERS;                                 \
+    fmt_printf("  %-10s %7lu %7lu  %2lu.%lux  %s\r\n", name,                 \
+               (unsigned long)t_newlib, (unsigned long)t_fmt,               \
+               (unsigned long)(t_newlib / t_fmt),                           \
+               (unsigned long)(t_newlib * 10 / t_fmt % 10),                 \
+               strcmp(a, b) ? "DIFFERS" : "same");                          \
+    if (strcmp(a, b))                                                       \
+        fmt_printf("    newlib \"%s\"\r\n    fmt    \"%s\"\r\n", a, b);    \
+} while (0)
+
+static void test_benchmark(void) {
+    println("");
+    println("=== newlib snprintf() vs lib/fmt fmt_snprintf() ===");
+#ifdef CONFIG_PRINTF_FMT
+    println("(CONFIG_PRINTF_FMT: printf() itself is lib/fmt)");
+#endif
+    fmt_printf("Cycles per call, %d calls each\r\n", BENCH_ITERS);
+    fmt_printf("  %-10s %7s %7s  %5s\r\n", "format", "newlib", "fmt", "speed");
+
+    BENCH("%d", "%d", -123456);
+    BENCH("%u", "%u", 4000000000u);
+    BENCH("%08X", "%08X", 0xDEADBEEFu);
+    BENCH("%s", "%s", "Hello, World!");
+    BENCH("mixed", "%s=%d 0x%04x %c|%-6u|", "addr", 42, 0xBEEF, 'Z', 7u);
+    BENCH("%lld", "%lld", -1234567890123LL);
+    BENCH("%#08o", "%#08o", 8u);
+#ifdef CONFIG_FMT_FLOAT
+    BENCH("%.3f", "%.3f", 3.14159);
+    BENCH("%e", "%e", 1234.5678);
+    BENCH("%.2f", "%.2f", 0.045);
+    BENCH("%.40f", "%.40f", 1.5);
+    BENCH("%f 1e20", "%f", 1e20);
+#endif
+
+    // UART: the same 16 lines through newlib stdio and straight to the FIFO
+    uint32_t t0 = rdcycle();
+    for (int i = 0; i < 16; i++)
+        _printf_r(_REENT, "  newlib line %2d: 0x%08X %6d\r\n", i, 0x1000u * i, -i * 1000);
+    fflush(stdout);
+    uint32_t t_newlib = rdcycle() - t0;
+
+    t0 = rdcycle();
+    for (int i = 0; i < 16; i++)
+        fmt_printf("  fmt    line %2d: 0x%08X %6d\r\n", i, 0x1000u * i, -i * 1000);
+    uint32_t t_fmt = rdcycle() - t0;
+
+    fmt_printf("UART, 16 lines: newlib %lu cycles, fmt %lu cycles\r\n",
+               (unsigned long)t_newlib, (unsigned long)t_fmt);
+    println("(UART bound once the TX FIFO is full)");
+}
+
 //==============================================================================
 // Main Menu
 //==============================================================================
@@ -247,6 +318,7 @@ static void show_menu(void) {
     println("7. println() vs printf() comparison");
     println("8. Run all printf tests");
     println("9. Run all scanf tests");
+    println("b. newlib printf vs lib/fmt benchmark");
     println("h. Show this menu");
     println("q. Quit");
     println("========================================");
@@ -335,6 +407,12 @@ int main(void) {
                 show_menu();
                 break;
 
+            case 'b':
+            case 'B':
+                test_benchmark();
+                show_menu();
+                break;
+
             case 'h':
             case 'H':
                 show_menu();
@@ -0,0 +1,104 @@
+//==============================================================================
+// SD Boot Image Header
+//
+// Shared by the SD bootloader (reads it) and the SD card manager's
+// bootloader upload (writes it). Layout of the raw boot partition:
+//
+//   Sector 0:          MBR
+//   Sector 1:          slot A boot_header_t (rest of the sector zero)
+//   Sectors 2-504:     slot A image, stored_length bytes, last sector zero padded
+//   Sector 505:        slot B boot_header_t
+//   Sectors 506-1008:  slot B image
+//   Sectors 1009-1024: settings (config_store.h)
+//
+// The slot whose valid header has the newer image_version boots; if its
+// image fails to load or its CRC32 does not match, the bootloader goes
+// straight on to the other slot, whose header it read at the same time.
+// An upload writes the slot not booted from, with the next image_version,
+// and its header last: a failed update leaves the running image in place.
+//
+// A BOOT_COMP_LZ4 image is stored as one raw LZ4 block (no frame) and
+// decompressed by the bootloader straight to load_addr as its sectors
+// arrive; a match may reach back anywhere in the output, so no window
+// buffer is needed. length and crc32 are of the decompressed image.
+//
+// Cards written before the header existed have the image itself at
+// sector 1; with neither slot valid the bootloader falls back to loading
+// the legacy 375 sectors from there. A version 1 header (no image_version,
+// header_crc one word earlier) is slot A's, with image_version 0.
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+
+#ifndef BOOT_HEADER_H
+#define BOOT_HEADER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../../lib/crc32.h"
+
+#define BOOT_HEADER_MAGIC       0x544F4F42  // "BOOT"
+#define BOOT_HEADER_VERSION     2
+
+#define BOOT_HEADER_SECTOR      1           // Slot A
+#define BOOT_IMAGE_SECTOR       2
+#define BOOT_PARTITION_END      1024        // Last sector of the boot partition
+#define BOOT_IMAGE_END          1008        // Last image sector, settings after it
+
+#define BOOT_SLOTS              2
+#define BOOT_SLOT_SECTORS       ((BOOT_IMAGE_END - BOOT_HEADER_SECTOR + 1) / BOOT_SLOTS)
+#define BOOT_SLOT_HEADER(s)     (BOOT_HEADER_SECTOR + (s) * BOOT_SLOT_SECTORS)
+#define BOOT_SLOT_IMAGE(s)      (BOOT_SLOT_HEADER(s) + 1)
+#define BOOT_IMAGE_MAX          ((BOOT_SLOT_SECTORS - 1) * 512)     // Per slot
+
+// Images must end below the boot ROM and its SRAM at 0x40000
+#define BOOT_LOAD_LIMIT         0x00040000
+
+#define BOOT_COMP_NONE          0
+#define BOOT_COMP_LZ4           1           // LZ4 block format
+
+// .bin.lz4 files from tools/lz4boot, uploaded through the compressed
+// bootloader upload: this magic, length, crc32 (as in the header), then
+// the LZ4 block
+#define BOOT_LZ4_FILE_MAGIC     0x42345A4C  // "LZ4B"
+#define BOOT_LZ4_FILE_HEADER    12
+
+typedef struct {
+    uint32_t magic;         // BOOT_HEADER_MAGIC
+    uint32_t version;       // BOOT_HEADER_VERSION
+    uint32_t length;        // Image bytes once loaded
+    uint32_t load_addr;     // Where the image is copied
+    uint32_t entry;         // Jump target
+    uint32_t crc32;         // CRC32 (lib/crc32.h) of the image
+    uint32_t spi_ctrl;      // SPI_CTRL speed the card was written at (0: 12.5 MHz)
+    uint32_t stored_length; // Bytes on the card from BOOT_IMAGE_SECTOR
+    uint32_t compression;   // BOOT_COMP_*
+    uint32_t image_version; // Raised by each upload; the newer slot boots
+    uint32_t header_crc;    // CRC32 of the fields above
+} boot_header_t;
+
+// 1 if hdr is an intact header for slot (fields are not range checked)
+static inline int boot_header_valid(const boot_header_t *hdr, uint32_t slot) {
+    if (hdr->magic != BOOT_HEADER_MAGIC) {
+        return 0;
+    }
+    if (hdr->version == 1) {
+        // Before the slots: header_crc where image_version is now
+        return slot == 0 &&
+               crc32_calc(hdr, offsetof(boot_header_t, image_version)) == hdr->image_version;
+    }
+    return hdr->version == BOOT_HEADER_VERSION &&
+           crc32_calc(hdr, sizeof(*hdr) - 4) == hdr->header_crc;
+}
+
+static inline uint32_t boot_header_image_version(const boot_header_t *hdr) {
+    return hdr->version == 1 ? 0 : hdr->image_version;
+}
+
+// 1 if image_version a is newer than b (the counter may wrap)
+static inline int boot_version_newer(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) > 0;
+}
+
+#endif // BOOT_HEADER_H
@@ -0,0 +1,100 @@
+//==============================================================================
+// SD Configuration Store
+//
+// Settings that survive a reset, in raw sectors at the end of the boot
+// partition (boot_header.h). Shared by the SD bootloader (reads them) and
+// the SD card manager (sd_fatfs/config_sd.c, reads and writes them):
+//
+//   Sectors 1009-1024:  CFG_STORE_SLOTS slots, one cfg_snapshot_t each
+//
+// The store is a log of whole snapshots. A commit writes every setting as
+// one snapshot, with the next seq, into the slot after the newest one:
+// the slots wear evenly, and a write cut short by a reset only spoils its
+// own slot (bad CRC) while the previous snapshot stays as it was. Loading
+// is one CMD18 over all slots; the newest is the valid snapshot with the
+// highest seq. An erased or never written card has no valid slot, so
+// every setting reads as absent.
+//
+// Keys are four-character codes, values 32 bits.
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+
+#ifndef CONFIG_STORE_H
+#define CONFIG_STORE_H
+
+#include <stdint.h>
+#include "boot_header.h"
+#include "../../lib/crc32.h"
+
+#define CFG_STORE_MAGIC         0x47464E43  // "CNFG"
+#define CFG_STORE_VERSION       1
+
+#define CFG_STORE_SECTOR        (BOOT_IMAGE_END + 1)        // First slot
+#define CFG_STORE_SLOTS         (BOOT_PARTITION_END - BOOT_IMAGE_END)
+#define CFG_STORE_MAX_ENTRIES   62          // Fills the sector
+
+#define CFG_KEY(a, b, c, d)     ((uint32_t)(a) | ((uint32_t)(b) << 8) | \
+                                 ((uint32_t)(c) << 16) | ((uint32_t)(d) << 24))
+
+// SPI_CTRL speed for the card (SD card manager speed menu / auto-tune).
+// The bootloader loads the image at this speed, ahead of the header's.
+#define CFG_KEY_SPI_CTRL        CFG_KEY('S', 'P', 'I', 'C')
+// 1 when CFG_KEY_SPI_CTRL came from an auto-tune run on this card
+#define CFG_KEY_SPI_TUNED       CFG_KEY('S', 'P', 'I', 'T')
+
+// The card the settings belong to (SD card manager, sd_card_info_t): raw
+// CID as four little-endian words, type and capacity. A warm start checks
+// them against the card before trusting the rest.
+#define CFG_KEY_CARD_CID(n)     CFG_KEY('C', 'I', 'D', '0' + (n))
+#define CFG_KEY_CARD_TYPE       CFG_KEY('C', 'T', 'Y', 'P')
+#define CFG_KEY_CARD_SECTORS    CFG_KEY('C', 'S', 'E', 'C')
+// Milliseconds a full init (CMD0 ... ACMD41 at 390 kHz) took on this card,
+// for the time a warm start saves
+#define CFG_KEY_CARD_INIT_MS    CFG_KEY('C', 'I', 'N', 'I')
+
+// Free clusters of the FAT volume at its last clean unmount (SD card
+// manager, free_count.c), and a tag of that volume (CRC32 of its serial
+// number, size and exFAT flags). The tag is cleared by the mount that
+// takes the count, so a card pulled while mounted is scanned again.
+#define CFG_KEY_FREE_CLUSTERS   CFG_KEY('F', 'R', 'E', 'C')
+#define CFG_KEY_FREE_TAG        CFG_KEY('F', 'R', 'E', 'T')
+
+typedef struct {
+    uint32_t key;
+    uint32_t value;
+} cfg_entry_t;
+
+typedef struct {
+    uint32_t magic;         // CFG_STORE_MAGIC
+    uint16_t version;       // CFG_STORE_VERSION
+    uint16_t count;         // Entries used
+    uint32_t seq;           // Commits so far, this one included
+    cfg_entry_t entry[CFG_STORE_MAX_ENTRIES];
+    uint32_t crc;           // CRC32 of everything above
+} cfg_snapshot_t;
+
+// 1 if s holds a complete snapshot
+static inline int cfg_snapshot_valid(const cfg_snapshot_t *s) {
+    return s->magic == CFG_STORE_MAGIC && s->version == CFG_STORE_VERSION &&
+           s->count <= CFG_STORE_MAX_ENTRIES &&
+           crc32_calc(s, sizeof(*s) - 4) == s->crc;
+}
+
+// 1 if seq a is newer than b (the counter may wrap)
+static inline int cfg_seq_newer(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) > 0;
+}
+
+// Entry for key, or 0 if the snapshot has none
+static inline const cfg_entry_t *cfg_snapshot_find(const cfg_snapshot_t *s, uint32_t key) {
+    for (uint32_t i = 0; i < s->count; i++) {
+        if (s->entry[i].key == key) {
+            return &s->entry[i];
+        }
+    }
+    return 0;
+}
+
+#endif // CONFIG_STORE_H
@@ -1,12 +1,23 @@
 //==============================================================================
 // SD Card Bootloader for PicoRV32
 //
-// Reads bootloader from SD card sectors 1-376 (192 KB) and loads to RAM at 0x0
-// Then jumps to 0x0 to execute the loaded bootloader.
+// Reads the boot headers of both image slots (boot_header.h), streams the
+// image of the newer valid one in with one CMD18, and checks its CRC32 a
+// sector at a time as it arrives, so the result is known when the last
+// sector is in. A slot that fails is followed straight away by the other
+// one, then both once more at 12.5 MHz. Cards with neither header get the
+// legacy load: 375 sectors from sector 1 to 0x0. A SPI speed saved in the settings store (config_store.h) by the
+// SD card manager is used for the load. Prints the boot time since reset
+// for cold-boot measurements.
 //
 // This replaces the UART bootloader in the HDL bitstream, enabling SD card boot
 // without requiring a host PC connection.
 //
+// Built with BOOT_DUAL (make bootloader-dual) the ROM also holds the UART
+// bootloader (bootloader/bootloader.c): an upload that starts within
+// BOOT_UART_WINDOW_MS of reset, or at any time while BUT1 is held at reset
+// or the card does not boot, goes to SRAM over the UART instead.
+//
 // Copyright (c) October 2025 Michael Wolak
 // Email: mikewolak@gmail.com, mike@epromfoundry.com
 //==============================================================================
@@ -27,6 +38,9 @@
 #define UART_TXRDY  (1 << 0)
 #define UART_RXRDY  (1 << 1)
 
+#define BUTTON_REG  (*(volatile uint32_t*)0x80000018)
+#define BUTTON_BUT1 (1 << 0)        // 1 while pressed
+
 //==============================================================================
 // UART Functions (for status output)
 //==============================================================================
@@ -78,42 +92,392 @@ static void uart_putdec(uint32_t val) {
 
 // Include minimal SD/SPI driver (no FatFS dependency)
 #include "sd_spi_minimal.h"
+#include "boot_header.h"
+#include "config_store.h"
+#include "../../lib/crc32.h"
+#include "../../lib/perf_counters.h"
 
 //==============================================================================
 // Memory Configuration
 //==============================================================================
 
-#define BOOT_LOAD_ADDR      0x00000000  // Load bootloader to RAM start
-#define BOOT_START_SECTOR   1           // Start reading from sector 1 (after MBR)
-#define BOOT_SECTOR_COUNT   375         // Read 375 sectors = 192000 bytes (~192 KB)
+#define BOOT_LOAD_ADDR      0x00000000  // Legacy: load bootloader to RAM start
+#define BOOT_START_SECTOR   1           // Legacy: start reading from sector 1 (after MBR)
+#define BOOT_SECTOR_COUNT   375         // Legacy: 375 sectors = 192000 bytes (~192 KB)
 #define SECTOR_SIZE         512
+#define CHUNK_SIZE          64          // Sectors (32 KB) per progress dot
+
+#ifdef BOOT_DUAL
+#ifndef CONFIG_BOOT_UART_WINDOW_MS
+#define CONFIG_BOOT_UART_WINDOW_MS  300
+#endif
+#define BOOT_UART_WINDOW    (CONFIG_BOOT_UART_WINDOW_MS * (PERF_CPU_HZ / 1000))
+
+// bootloader/bootloader.c: returns if no upload starts within window
+// cycles, boots the upload otherwise (0: waits for ever)
+void uart_boot_window(uint32_t window);
+#endif
+
+typedef struct {
+    uint32_t slot;
+    uint32_t image_version;
+    uint32_t start_sector;
+    uint32_t sectors;       // Sectors on the card
+    uint32_t length;        // Bytes once loaded
+    uint32_t stored;        // Bytes on the card
+    uint32_t compression;   // BOOT_COMP_*
+    uint32_t load_addr;
+    uint32_t entry;
+    uint32_t crc32;
+    uint32_t spi_ctrl;
+    int      verify;        // CRC32 known (header present)
+} boot_plan_t;
+
+// Header, then the LZ4 input sector
+static uint8_t header_sector[SECTOR_SIZE] __attribute__((aligned(4)));
+
+static uint32_t cycles_to_ms(uint32_t cycles) {
+    return cycles / (PERF_CPU_HZ / 1000);
+}
+
+//==============================================================================
+// Boot Header
+//==============================================================================
+
+// The legacy layout: no header, no CRC
+static void boot_plan_legacy(boot_plan_t *plan) {
+    plan->slot = 0;
+    plan->image_version = 0;
+    plan->start_sector = BOOT_START_SECTOR;
+    plan->sectors = BOOT_SECTOR_COUNT;
+    plan->length = BOOT_SECTOR_COUNT * SECTOR_SIZE;
+    plan->stored = plan->length;
+    plan->compression = BOOT_COMP_NONE;
+    plan->load_addr = BOOT_LOAD_ADDR;
+    plan->entry = BOOT_LOAD_ADDR;
+    plan->crc32 = 0;
+    plan->spi_ctrl = SD_SPI_CLK_12MHZ;
+    plan->verify = 0;
+}
+
+// Fill plan from the header of slot; 0 if it has no valid one
+static int boot_plan(boot_plan_t *plan, uint32_t slot) {
+    const boot_header_t *hdr = (const boot_header_t *)header_sector;
+
+    if (sd_read_sectors(header_sector, BOOT_SLOT_HEADER(slot), 1) != 0 ||
+        !boot_header_valid(hdr, slot)) {
+        return 0;
+    }
+
+    uint32_t sectors = (hdr->stored_length + SECTOR_SIZE - 1) / SECTOR_SIZE;
+
+    // Uncompressed images are loaded by whole sectors, LZ4 ones byte exact
+    uint32_t load_end = hdr->load_addr + (hdr->compression == BOOT_COMP_NONE ?
+                                          sectors * SECTOR_SIZE : hdr->length);
+
+    if (hdr->stored_length == 0 || hdr->stored_length > BOOT_IMAGE_MAX ||
+        hdr->compression > BOOT_COMP_LZ4 ||
+        (hdr->compression == BOOT_COMP_NONE && hdr->length != hdr->stored_length) ||
+        load_end > BOOT_LOAD_LIMIT || load_end < hdr->load_addr) {
+        return 0;
+    }
+
+    plan->slot = slot;
+    plan->image_version = boot_header_image_version(hdr);
+    plan->start_sector = BOOT_SLOT_IMAGE(slot);
+    plan->sectors = sectors;
+    plan->length = hdr->length;
+    plan->stored = hdr->stored_length;
+    plan->compression = hdr->compression;
+    plan->load_addr = hdr->load_addr;
+    plan->entry = hdr->entry;
+    plan->crc32 = hdr->crc32;
+    if (hdr->spi_ctrl != 0) {
+        plan->spi_ctrl = hdr->spi_ctrl;
+    } else {
+        plan->spi_ctrl = SD_SPI_CLK_12MHZ;
+    }
+    plan->verify = 1;
+    return 1;
+}
+
+//==============================================================================
+// Settings Store
+//==============================================================================
+
+// SPI_CTRL from the newest settings snapshot, 0 if there is none, and in
+// *init_ms the card's full init time (0 if not recorded). One CMD18 over
+// the slots, each checked as it arrives in header_sector.
+static uint32_t cfg_spi_ctrl(uint32_t *init_ms) {
+    const cfg_snapshot_t *s = (const cfg_snapshot_t *)header_sector;
+    uint32_t newest = 0;
+    uint32_t spi_ctrl = 0;
+    int found = 0;
+
+    *init_ms = 0;
+    if (sd_stream_start(CFG_STORE_SECTOR) != 0) {
+        return 0;
+    }
+    for (uint32_t i = 0; i < CFG_STORE_SLOTS; i++) {
+        if (sd_stream_read(header_sector) != 0) {
+            break;
+        }
+        if (cfg_snapshot_valid(s) && (!found || cfg_seq_newer(s->seq, newest))) {
+            const cfg_entry_t *e = cfg_snapshot_find(s, CFG_KEY_SPI_CTRL);
+            found = 1;
+            newest = s->seq;
+            spi_ctrl = e ? e->value : 0;
+            e = cfg_snapshot_find(s, CFG_KEY_CARD_INIT_MS);
+            *init_ms = e ? e->value : 0;
+        }
+    }
+    sd_stream_stop();
+
+    return spi_ctrl;
+}
+
+//==============================================================================
+// Streamed Load
+//==============================================================================
+
+// Input: one CMD18 stream over the stored sectors, a sector at a time in
+// header_sector (the header is no longer needed by then) for LZ4 images,
+// straight to the load address otherwise. The CRC32 of the output is
+// taken as it grows, a sector or more at a time (hardware CRC when the
+// bitstream has it), while the card sends the next sector.
+static uint32_t stream_left;    // Stored bytes not yet taken
+static uint32_t stream_pos;     // Next byte in header_sector
+static uint32_t stream_sectors; // Sectors read, for the progress dots
+static int      stream_error;
+static uint32_t stream_crc;
+
+static uint8_t stream_getc(void) {
+    if (stream_left == 0) {
+        stream_error = -11;     // Block ends early
+        return 0;
+    }
+    if (stream_pos == SECTOR_SIZE) {
+        int result = sd_stream_read(header_sector);
+        if (result != 0) {
+            stream_error = result;
+            stream_left = 0;
+            return 0;
+        }
+        stream_pos = 0;
+        if ((++stream_sectors % CHUNK_SIZE) == 0) {
+            uart_putc('.');
+        }
+    }
+    stream_left--;
+    return header_sector[stream_pos++];
+}
+
+// LZ4 length: 4-bit field, continued by bytes while they are 255
+static uint32_t lz4_length(uint32_t n) {
+    if (n == 15) {
+        uint8_t b;
+        do {
+            b = stream_getc();
+            n += b;
+        } while (b == 255);
+    }
+    return n;
+}
+
+// Decode one LZ4 block of length bytes to dst. Matches copy from the
+// output already in SRAM, so the only buffer is the input sector.
+static int lz4_decode(uint8_t *dst, uint32_t length) {
+    uint8_t *out = dst;
+    uint8_t *end = dst + length;
+    uint8_t *crc_pos = dst;     // Output not yet in stream_crc
+
+    while (!stream_error) {
+        uint8_t token = stream_getc();
+
+        // Literals
+        uint32_t n = lz4_length(token >> 4);
+        if (n > (uint32_t)(end - out)) {
+            return -11;
+        }
+        while (n--) {
+            *out++ = stream_getc();
+        }
+
+        // The last sequence has no match
+        if (out == end) {
+            break;
+        }
+
+        // Match: 16-bit offset back into the output, length + 4
+        uint32_t offset = stream_getc();
+        offset |= (uint32_t)stream_getc() << 8;
+        n = lz4_length(token & 15) + 4;
+        if (offset == 0 || offset > (uint32_t)(out - dst) ||
+            n > (uint32_t)(end - out)) {
+            return -11;
+        }
+        const uint8_t *src = out - offset;
+        while (n--) {
+            *out++ = *src++;
+        }
+
+        if (out - crc_pos >= SECTOR_SIZE) {
+            stream_crc = crc32_update(stream_crc, crc_pos, out - crc_pos);
+            crc_pos = out;
+        }
+    }
+
+    stream_crc = crc32_update(stream_crc, crc_pos, out - crc_pos);
+    return stream_error;
+}
+
+// Uncompressed image: each sector to its place, then into the CRC
+static int stream_raw(const boot_plan_t *plan) {
+    for (uint32_t i = 0; i < plan->sectors; i++) {
+        uint8_t *sector = (uint8_t *)plan->load_addr + i * SECTOR_SIZE;
+        int result = sd_stream_read(sector);
+        if (result != 0) {
+            uart_puts("\nERROR: SD read failed at sector ");
+            uart_putdec(plan->start_sector + i);
+            uart_puts(" (code -");
+            uart_putdec(-result);
+            uart_puts(")\n");
+            return result;
+        }
+        if (plan->verify) {
+            // Not the zero padding of the last sector
+            uint32_t n = (stream_left < SECTOR_SIZE) ? stream_left : SECTOR_SIZE;
+            stream_crc = crc32_update(stream_crc, sector, n);
+            stream_left -= n;
+        }
+        if (((i + 1) % CHUNK_SIZE) == 0) {
+            uart_putc('.');
+        }
+    }
+    return 0;
+}
+
+// One CMD18 over the slot's sectors; 0 if read (and CRC) OK
+static int boot_load(const boot_plan_t *plan) {
+    int result;
+
+    sd_set_clock(plan->spi_ctrl);
+
+    uart_puts("Loading to RAM");
+    result = sd_stream_start(plan->start_sector);
+    if (result != 0) {
+        uart_puts("\nERROR: SD read failed (code -");
+        uart_putdec(-result);
+        uart_puts(")\n");
+        return result;
+    }
+
+    stream_left = plan->stored;
+    stream_pos = SECTOR_SIZE;
+    stream_sectors = 0;
+    stream_error = 0;
+    stream_crc = 0;
+
+    if (plan->compression == BOOT_COMP_LZ4) {
+        result = lz4_decode((uint8_t *)plan->load_addr, plan->length);
+        if (result != 0) {
+            uart_puts("\nERROR: LZ4 load failed (code -");
+            uart_putdec(-result);
+            uart_puts(")\n");
+        }
+    } else {
+        result = stream_raw(plan);
+    }
+    sd_stream_stop();
+    if (result != 0) {
+        return result;
+    }
+    uart_puts("\n");
+
+    if (plan->verify && stream_crc != plan->crc32) {
+        uart_puts("ERROR: CRC32 0x");
+        uart_puthex(stream_crc, 8);
+        uart_puts(", expected 0x");
+        uart_puthex(plan->crc32, 8);
+        uart_puts("\n");
+        return -10;
+    }
+
+    return 0;
+}
 
 //==============================================================================
 // Main Bootloader
 //==============================================================================
 
+static void print_plan(const boot_plan_t *plan) {
+    uart_puts("  Slot ");
+    uart_putc('A' + plan->slot);
+    if (plan->verify) {
+        uart_puts(" v");
+        uart_putdec(plan->image_version);
+    } else {
+        uart_puts(" (legacy)");
+    }
+    uart_puts(": ");
+    uart_putdec(plan->length);
+    if (plan->compression == BOOT_COMP_LZ4) {
+        uart_puts(" bytes from ");
+        uart_putdec(plan->stored);
+        uart_puts(" LZ4");
+    }
+    uart_puts(" bytes, sectors ");
+    uart_putdec(plan->start_sector);
+    uart_puts("-");
+    uart_putdec(plan->start_sector + plan->sectors - 1);
+    uart_puts(" -> 0x");
+    uart_puthex(plan->load_addr, 8);
+    uart_puts(", entry 0x");
+    uart_puthex(plan->entry, 8);
+    uart_puts("\n");
+}
+
 void main(void) {
-    uint8_t *load_addr = (uint8_t *)BOOT_LOAD_ADDR;
+    boot_plan_t slots[BOOT_SLOTS];
+    boot_plan_t *order[BOOT_SLOTS];
+    boot_plan_t *plan = 0;
+    uint32_t count = 0;
+    uint32_t t_init, t_load;
+    uint32_t spi_ctrl, full_init_ms;
+    int warm;
     int result;
 
     // LED: Solid during boot
     LED_REG = 0x01;
 
+#ifdef BOOT_DUAL
+    // Before the banner: an uploader reading its replies would get it
+    uart_boot_window((BUTTON_REG & BUTTON_BUT1) ? 0 : BOOT_UART_WINDOW);
+    LED_REG = 0x01;
+#endif
+
     // Print banner
     uart_puts("\n");
     uart_puts("========================================\n");
-    uart_puts("PicoRV32 SD Card Bootloader v1.0\n");
+#ifdef BOOT_DUAL
+    uart_puts("PicoRV32 SD Card Bootloader v1.1 (UART + SD)\n");
+#else
+    uart_puts("PicoRV32 SD Card Bootloader v1.1\n");
+#endif
     uart_puts("========================================\n");
-    uart_puts("Loading bootloader from SD card...\n");
-    uart_puts("\n");
 
-    // Initialize SD card
+    // Initialize SD card; after a reset that left it powered it is still up
     uart_puts("Initializing SD card...\n");
-    result = sd_init();
+    warm = sd_init_warm() == 0;
+    result = warm ? 0 : sd_init();
     if (result != 0) {
         uart_puts("ERROR: SD card init failed (code ");
         uart_putdec(result);
         uart_puts(")\n");
+#ifdef BOOT_DUAL
+        uart_puts("Waiting for a UART upload\n");
+        uart_boot_window(0);
+#endif
         uart_puts("Cannot boot without SD card!\n");
         LED_REG = 0x00;
         while (1) {
@@ -122,83 +486,99 @@ void main(void) {
             LED_REG ^= 0x01;
         }
     }
-    uart_puts("  Status: OK\n");
-    uart_puts("\n");
-
-    // Read bootloader from SD card
-    uart_puts("Reading bootloader from SD card...\n");
-    uart_puts("  Start sector: ");
-    uart_putdec(BOOT_START_SECTOR);
-    uart_puts("\n");
-    uart_puts("  Sector count: ");
-    uart_putdec(BOOT_SECTOR_COUNT);
-    uart_puts(" (");
-    uart_putdec(BOOT_SECTOR_COUNT * SECTOR_SIZE);
-    uart_puts(" bytes)\n");
-    uart_puts("  Load address: 0x");
-    uart_puthex(BOOT_LOAD_ADDR, 8);
-    uart_puts("\n");
-    uart_puts("\n");
-
-    uart_puts("Loading to RAM");
-
-    // Read sectors in chunks for progress indication
-    #define CHUNK_SIZE 64  // Read 64 sectors at a time (32 KB)
-    uint32_t sectors_read = 0;
+    t_init = rdcycle();
 
-    while (sectors_read < BOOT_SECTOR_COUNT) {
-        uint32_t chunk = BOOT_SECTOR_COUNT - sectors_read;
-        if (chunk > CHUNK_SIZE) chunk = CHUNK_SIZE;
-
-        result = sd_read_sectors(load_addr + (sectors_read * SECTOR_SIZE),
-                                BOOT_START_SECTOR + sectors_read,
-                                chunk);
-
-        if (result != 0) {
-            uart_puts("\n");
-            uart_puts("ERROR: SD read failed at sector ");
-            uart_putdec(BOOT_START_SECTOR + sectors_read);
-            uart_puts(" (code ");
-            uart_putdec(result);
-            uart_puts(")\n");
-            LED_REG = 0x00;
-            while (1);
+    // Both headers up front: a fallback goes straight to the other image
+    for (uint32_t s = 0; s < BOOT_SLOTS; s++) {
+        if (boot_plan(&slots[s], s)) {
+            order[count++] = &slots[s];
         }
+    }
+    if (count == 2 && boot_version_newer(order[1]->image_version, order[0]->image_version)) {
+        order[1] = &slots[0];
+        order[0] = &slots[1];
+    }
+    if (count == 0) {
+        uart_puts("  No valid boot header: legacy 375-sector load\n");
+        boot_plan_legacy(&slots[0]);
+        order[count++] = &slots[0];
+    }
 
-        sectors_read += chunk;
-
-        // Show progress
-        uart_putc('.');
-        if ((sectors_read % (CHUNK_SIZE * 4)) == 0) {
-            uart_putc(' ');
-            uart_putdec((sectors_read * 100) / BOOT_SECTOR_COUNT);
-            uart_putc('%');
+    // Tuned on this card by the SD card manager: ahead of the header's speed
+    spi_ctrl = cfg_spi_ctrl(&full_init_ms);
+    if (spi_ctrl != 0) {
+        sd_high_speed();
+        for (uint32_t i = 0; i < count; i++) {
+            order[i]->spi_ctrl = spi_ctrl;
         }
+        uart_puts("  SPI speed from settings: SPI_CTRL 0x");
+        uart_puthex(spi_ctrl, 8);
+        uart_puts("\n");
     }
 
-    uart_puts("\n");
-    uart_puts("\n");
-    uart_puts("========================================\n");
-    uart_puts("Boot Complete!\n");
-    uart_puts("========================================\n");
-    uart_puts("Loaded: ");
-    uart_putdec(BOOT_SECTOR_COUNT * SECTOR_SIZE);
-    uart_puts(" bytes to 0x");
-    uart_puthex(BOOT_LOAD_ADDR, 8);
-    uart_puts("\n");
+    // Newest slot, then the other; at the saved or written speed and, for
+    // the slots that were faster, once more at 12.5 MHz
+    result = -1;
+    for (uint32_t pass = 0; pass < 2 && result != 0; pass++) {
+        for (uint32_t i = 0; i < count && result != 0; i++) {
+            plan = order[i];
+            if (pass) {
+                if (plan->spi_ctrl == SD_SPI_CLK_12MHZ) {
+                    continue;
+                }
+                uart_puts("Retrying at 12.5 MHz\n");
+                plan->spi_ctrl = SD_SPI_CLK_12MHZ;
+            } else if (i > 0) {
+                uart_puts("Falling back to the other slot\n");
+            }
+            print_plan(plan);
+            result = boot_load(plan);
+        }
+    }
+    if (result != 0) {
+#ifdef BOOT_DUAL
+        uart_puts("Waiting for a UART upload\n");
+        uart_boot_window(0);
+#endif
+        LED_REG = 0x00;
+        while (1);
+    }
+    t_load = rdcycle();
+
+    // Cycle counter runs from reset: total is the cold-boot time
+    uart_puts("Boot Complete: init ");
+    uart_putdec(cycles_to_ms(t_init));
+    uart_puts(" ms");
+    if (warm) {
+        // Against the full init the SD card manager timed on this card
+        uart_puts(" (warm start");
+        if (full_init_ms > cycles_to_ms(t_init)) {
+            uart_puts(", ");
+            uart_putdec(full_init_ms - cycles_to_ms(t_init));
+            uart_puts(" ms saved");
+        }
+        uart_puts(")");
+    }
+    uart_puts(", load ");
+    uart_putdec(cycles_to_ms(t_load - t_init));
+    uart_puts(" ms");
+    if (plan->verify) {
+        uart_puts(" (CRC OK)");
+    }
+    uart_puts(", total ");
+    uart_putdec(cycles_to_ms(t_load));
+    uart_puts(" ms\n");
     uart_puts("Jumping to bootloader...\n");
-    uart_puts("\n");
 
-    // Brief delay for UART to flush
-    for (volatile int i = 0; i < 100000; i++);
+    // Let the last character leave the UART
+    while (UART_STATUS & UART_TXRDY);
 
     // LED: Off before jumping
     LED_REG = 0x00;
 
-    // Jump to loaded bootloader at 0x0
-    // This is effectively a restart since we loaded code at address 0
+    // Jump to the loaded image (at 0x0 this is effectively a restart)
     typedef void (*entry_func_t)(void);
-    entry_func_t entry = (entry_func_t)BOOT_LOAD_ADDR;
+    entry_func_t entry = (entry_func_t)plan->entry;
     entry();
 
     // Should never get here
@@ -2,13 +2,15 @@
 // Minimal SD Card SPI Driver for Bootloader
 //
 // Stripped-down version with only what's needed to initialize SD card
-// and read sectors. No write support, no FatFS, minimal error handling.
+// and read sectors (CMD17, or one CMD18 stream for several). No write
+// support, no FatFS, minimal error handling.
 //
 // Copyright (c) October 2025 Michael Wolak
 // Email: mikewolak@gmail.com, mike@epromfoundry.com
 //==============================================================================
 
 #include "sd_spi_minimal.h"
+#include "../../lib/perf_counters.h"
 #include <stdint.h>
 
 //==============================================================================
@@ -21,6 +23,13 @@
 #define SPI_STATUS      (*(volatile uint32_t*)(SPI_BASE + 0x08))
 #define SPI_CS_REG      (*(volatile uint32_t*)(SPI_BASE + 0x0C))
 
+// Burst mode (RX FIFO, packed 4 bytes per word, first byte in [7:0])
+#define SPI_FIFO_BASE   0x800000C0
+#define SPI_FIFO_DATA   (*(volatile uint32_t*)(SPI_FIFO_BASE + 0x00))
+#define SPI_FIFO_CTRL   (*(volatile uint32_t*)(SPI_FIFO_BASE + 0x04))
+#define SPI_RX_REPEAT   (*(volatile uint32_t*)(SPI_FIFO_BASE + 0x0C))
+#define SPI_FIFO_FLUSH  (1 << 1)
+
 // SPI Status bits
 #define SPI_STATUS_BUSY (1 << 0)  // Transfer in progress
 
@@ -33,15 +42,27 @@
 //==============================================================================
 
 #define CMD0    0   // GO_IDLE_STATE
+#define CMD6    6   // SWITCH_FUNC
 #define CMD8    8   // SEND_IF_COND
+#define CMD12   12  // STOP_TRANSMISSION
 #define CMD17   17  // READ_SINGLE_BLOCK
+#define CMD18   18  // READ_MULTIPLE_BLOCK
 #define CMD55   55  // APP_CMD
 #define CMD58   58  // READ_OCR
+#define CMD59   59  // CRC_ON_OFF
 #define ACMD41  41  // SD_SEND_OP_COND
 
 // R1 Response bits
 #define R1_IDLE_STATE   0x01
 
+// Time limits on the cycle counter (SD spec: read access 100 ms, busy
+// 500 ms, ACMD41 1 s), whatever the SPI clock
+#define SD_READ_TIMEOUT_MS      100
+#define SD_BUSY_TIMEOUT_MS      500
+#define SD_INIT_TIMEOUT_MS      1000
+
+#define SD_MS_CYCLES(ms)        ((uint32_t)(ms) * (uint32_t)(PERF_CPU_HZ / 1000))
+
 //==============================================================================
 // Static Variables
 //==============================================================================
@@ -71,6 +92,22 @@ static uint8_t spi_transfer(uint8_t data) {
     return (uint8_t)(SPI_DATA & 0xFF);
 }
 
+// Clock 0xFF until MISO stops idling high (a token) or ms pass; 0xFF on timeout
+static uint8_t spi_wait_byte(uint32_t ms) {
+    uint32_t start = rdcycle();
+    uint8_t b;
+
+    while ((b = spi_transfer(0xFF)) == 0xFF && rdcycle() - start <= SD_MS_CYCLES(ms));
+    return b;
+}
+
+// Clock 0xFF until the card releases MISO (busy over) or ms pass
+static void spi_wait_ready(uint32_t ms) {
+    uint32_t start = rdcycle();
+
+    while (spi_transfer(0xFF) != 0xFF && rdcycle() - start <= SD_MS_CYCLES(ms));
+}
+
 //==============================================================================
 // SD Card Command Functions
 //==============================================================================
@@ -82,6 +119,10 @@ static uint8_t sd_send_cmd(uint8_t cmd, uint32_t arg) {
     // Special CRC for CMD0 and CMD8
     if (cmd == CMD0) crc = 0x95;
     if (cmd == CMD8) crc = 0x87;
+    // ...and for the warm probe, sent before CRC checking is known to be off
+    if (cmd == CMD12) crc = 0x61;
+    if (cmd == CMD58) crc = 0xFD;
+    if (cmd == CMD59) crc = 0x91;
 
     // Send command packet
     spi_transfer(0x40 | cmd);
@@ -91,6 +132,11 @@ static uint8_t sd_send_cmd(uint8_t cmd, uint32_t arg) {
     spi_transfer(arg & 0xFF);
     spi_transfer(crc);
 
+    // CMD12 is followed by a stuff byte before R1
+    if (cmd == CMD12) {
+        spi_transfer(0xFF);
+    }
+
     // Wait for response (R1), max 10 attempts
     for (int i = 0; i < 10; i++) {
         r1 = spi_transfer(0xFF);
@@ -113,7 +159,7 @@ static uint8_t sd_send_acmd(uint8_t cmd, uint32_t arg) {
 
 int sd_init(void) {
     uint8_t r1;
-    int retry;
+    uint32_t start;
 
     // Reset card type
     s_is_sdhc = 0;
@@ -149,11 +195,10 @@ int sd_init(void) {
         // Check if card accepted voltage range
         if (ocr[2] == 0x01 && ocr[3] == 0xAA) {
             // Initialize with ACMD41 with HCS bit
-            retry = 0;
+            start = rdcycle();
             do {
                 r1 = sd_send_acmd(ACMD41, 0x40000000);
-                retry++;
-                if (retry > 1000) {
+                if (r1 != 0x00 && rdcycle() - start > SD_MS_CYCLES(SD_INIT_TIMEOUT_MS)) {
                     spi_cs_deassert();
                     return -2;  // Timeout
                 }
@@ -172,11 +217,10 @@ int sd_init(void) {
         }
     } else {
         // SDv1 or MMC card
-        retry = 0;
+        start = rdcycle();
         do {
             r1 = sd_send_acmd(ACMD41, 0);
-            retry++;
-            if (retry > 1000) {
+            if (r1 != 0x00 && rdcycle() - start > SD_MS_CYCLES(SD_INIT_TIMEOUT_MS)) {
                 spi_cs_deassert();
                 return -3;  // Card type not supported
             }
@@ -194,54 +238,147 @@ int sd_init(void) {
     return 0;  // Success
 }
 
+int sd_init_warm(void) {
+    uint8_t ocr[4];
+    uint8_t r1;
+
+    // An initialized card takes the data clock at once
+    spi_set_speed(SPI_CLK_12MHZ);
+
+    spi_cs_deassert();
+    spi_transfer(0xFF);
+    spi_cs_assert();
+
+    // End a CMD18 that the reset cut short, wait out its busy, then CRC
+    // checking off in case the last user of the card turned it on
+    sd_send_cmd(CMD12, 0);
+    spi_wait_ready(SD_BUSY_TIMEOUT_MS);
+    sd_send_cmd(CMD59, 0);
+
+    // Initialized: out of idle state, OCR power-up bit set; CCS is the type
+    r1 = sd_send_cmd(CMD58, 0);
+    for (int i = 0; i < 4; i++) {
+        ocr[i] = spi_transfer(0xFF);
+    }
+    spi_cs_deassert();
+
+    if (r1 != 0x00 || !(ocr[0] & 0x80)) {
+        return -1;  // Not initialized: sd_init()
+    }
+    s_is_sdhc = (ocr[0] & 0x40) ? 1 : 0;
+
+    return 0;
+}
+
+// CMD6 mode 1, group 1 function 1 (high speed); the 64-byte status that
+// follows is dropped. Cards without CMD6 answer "illegal command".
+void sd_high_speed(void) {
+    spi_cs_assert();
+    if (sd_send_cmd(CMD6, 0x80FFFFF1) == 0x00 && spi_wait_byte(SD_READ_TIMEOUT_MS) == 0xFE) {
+        for (int i = 0; i < 64 + 2; i++) {
+            spi_transfer(0xFF);     // Status, CRC16
+        }
+    }
+    spi_cs_deassert();
+    spi_transfer(0xFF);             // 8 clocks: the switch takes effect
+}
+
 //==============================================================================
 // SD Card Data Transfer
 //==============================================================================
 
-int sd_read_sectors(uint8_t *buffer, uint32_t sector, uint32_t count) {
-    uint8_t r1;
+void sd_set_clock(uint32_t spi_ctrl) {
+    spi_set_speed(spi_ctrl);
+}
 
-    // Read sectors one at a time
-    for (uint32_t i = 0; i < count; i++) {
-        uint32_t addr = sector + i;
+// One data packet: start token, 512 bytes through the RX FIFO, CRC16 (ignored)
+static int sd_rx_block(uint8_t *p) {
+    // Wait for data token (0xFE); error token or none
+    if (spi_wait_byte(SD_READ_TIMEOUT_MS) != 0xFE) {
+        return -2;  // Timeout waiting for data
+    }
 
-        // For SDSC cards, sector address is byte address
-        if (!s_is_sdhc) {
-            addr <<= 9;  // Convert to byte address
-        }
+    // Read 512 bytes: clock out 512 fill bytes, then pop 128 words
+    // (each read stalls until its 4 bytes have arrived)
+    SPI_FIFO_CTRL = SPI_FIFO_FLUSH;
+    SPI_RX_REPEAT = 512;
+    for (uint16_t j = 0; j < 512; j += 4) {
+        uint32_t w = SPI_FIFO_DATA;
+        p[j]     = w;
+        p[j + 1] = w >> 8;
+        p[j + 2] = w >> 16;
+        p[j + 3] = w >> 24;
+    }
 
-        spi_cs_assert();
+    // Read CRC (2 bytes) - ignored
+    spi_transfer(0xFF);
+    spi_transfer(0xFF);
 
-        // Send CMD17 (READ_SINGLE_BLOCK)
-        r1 = sd_send_cmd(CMD17, addr);
-        if (r1 != 0x00) {
-            spi_cs_deassert();
-            return -1;  // Read command failed
-        }
+    return 0;
+}
 
-        // Wait for data token (0xFE)
-        uint16_t timeout = 0xFFFF;
-        while (spi_transfer(0xFF) != 0xFE) {
-            if (--timeout == 0) {
-                spi_cs_deassert();
-                return -2;  // Timeout waiting for data
-            }
-        }
+int sd_stream_start(uint32_t sector) {
+    // For SDSC cards, sector address is byte address
+    if (!s_is_sdhc) {
+        sector <<= 9;  // Convert to byte address
+    }
+
+    spi_cs_assert();
+
+    if (sd_send_cmd(CMD18, sector) != 0x00) {
+        spi_cs_deassert();
+        return -1;  // Read command failed
+    }
+
+    return 0;
+}
+
+int sd_stream_read(uint8_t *buffer) {
+    return sd_rx_block(buffer);
+}
 
-        // Read 512 bytes
-        for (uint16_t j = 0; j < 512; j++) {
-            buffer[i * 512 + j] = spi_transfer(0xFF);
+void sd_stream_stop(void) {
+    // STOP_TRANSMISSION, then wait out the busy signal
+    sd_send_cmd(CMD12, 0);
+    spi_wait_ready(SD_BUSY_TIMEOUT_MS);
+
+    spi_cs_deassert();
+}
+
+int sd_read_sectors(uint8_t *buffer, uint32_t sector, uint32_t count) {
+    uint8_t r1;
+    int result = 0;
+
+    // More than one sector: one CMD18 stream, which saves the command and
+    // access latency of every sector after the first
+    if (count > 1) {
+        result = sd_stream_start(sector);
+        for (uint32_t i = 0; i < count && result == 0; i++) {
+            result = sd_stream_read(&buffer[i * 512]);
+        }
+        if (result != -1) {
+            sd_stream_stop();
         }
+        return result;
+    }
 
-        // Read CRC (2 bytes) - ignored
-        spi_transfer(0xFF);
-        spi_transfer(0xFF);
+    // For SDSC cards, sector address is byte address
+    if (!s_is_sdhc) {
+        sector <<= 9;  // Convert to byte address
+    }
 
-        spi_cs_deassert();
+    spi_cs_assert();
 
-        // Small delay between sectors
-        for (volatile int d = 0; d < 100; d++);
+    // Send CMD17 (READ_SINGLE_BLOCK)
+    r1 = sd_send_cmd(CMD17, sector);
+    if (r1 != 0x00) {
+        spi_cs_deassert();
+        return -1;  // Read command failed
     }
 
-    return 0;  // Success
+    result = sd_rx_block(buffer);
+
+    spi_cs_deassert();
+
+    return result;
 }
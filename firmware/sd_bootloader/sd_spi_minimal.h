@@ -18,7 +18,19 @@
 // Returns: 0 on success, negative error code on failure
 int sd_init(void);
 
-// Read multiple sectors from SD card
+// Take over a card that is still initialized (the reset did not power it
+// down): no CMD0 / ACMD41 at 390 kHz, only OCR at 12.5 MHz
+// Returns: 0 on success, negative if sd_init() is needed
+int sd_init_warm(void);
+
+// Switch the card to high speed (CMD6), as the SD card manager does: a
+// speed it saved may be above the 25 MHz default-speed limit
+void sd_high_speed(void);
+
+// SPI_CTRL speed values (the full speed encoding is in sd_fatfs/hardware.h)
+#define SD_SPI_CLK_12MHZ    (2 << 2)    // /4 = 12.5 MHz, default after sd_init()
+
+// Read multiple sectors from SD card (one CMD18 when count > 1)
 // Parameters:
 //   buffer - Buffer to read data into (must be at least count * 512 bytes)
 //   sector - Starting sector number
@@ -26,4 +38,15 @@ int sd_init(void);
 // Returns: 0 on success, negative error code on failure
 int sd_read_sectors(uint8_t *buffer, uint32_t sector, uint32_t count);
 
+// Streamed read: one CMD18 from sector, then one sector per
+// sd_stream_read() for as long as the caller wants, ended by
+// sd_stream_stop() (CMD12). Returns: 0 on success, negative on failure;
+// after a failed sd_stream_start() do not call sd_stream_stop().
+int sd_stream_start(uint32_t sector);
+int sd_stream_read(uint8_t *buffer);
+void sd_stream_stop(void);
+
+// Set the SPI clock (SPI_CTRL value, e.g. boot_header_t.spi_ctrl)
+void sd_set_clock(uint32_t spi_ctrl);
+
 #endif // SD_SPI_MINIMAL_H
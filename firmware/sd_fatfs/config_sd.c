@@ -0,0 +1,186 @@
+//==============================================================================
+// Settings Store on SD - Implementation
+//
+// One slot is written per commit, round robin from the newest, so with
+// CFG_STORE_SLOTS slots each sector takes 1/CFG_STORE_SLOTS of the writes.
+// A slot is only trusted when its CRC matches: a commit cut short by a
+// reset leaves the previous snapshot the newest valid one.
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+
+#include "config_sd.h"
+#include "sd_spi.h"
+#include <stdlib.h>
+#include <string.h>
+
+static cfg_snapshot_t s_cfg __attribute__((aligned(4)));   // Settings in RAM
+static uint8_t s_verify[512] __attribute__((aligned(4)));
+static int s_slot = -1;             // Slot of the newest snapshot (-1: none)
+static uint32_t s_seq;              // Its seq
+
+static void config_sd_reset(void) {
+    memset(&s_cfg, 0, sizeof(s_cfg));
+    s_slot = -1;
+    s_seq = 0;
+}
+
+//==============================================================================
+// Load
+//==============================================================================
+
+uint8_t config_sd_load(void) {
+    cfg_snapshot_t *slots;
+    uint8_t result;
+
+    config_sd_reset();
+
+    slots = malloc(CFG_STORE_SLOTS * sizeof(cfg_snapshot_t));
+    if (slots == NULL) {
+        return SD_ERROR_READ;
+    }
+
+    result = sd_read_blocks(CFG_STORE_SECTOR, (uint8_t *)slots, CFG_STORE_SLOTS);
+    if (result == SD_OK) {
+        for (int i = 0; i < CFG_STORE_SLOTS; i++) {
+            if (cfg_snapshot_valid(&slots[i]) &&
+                (s_slot < 0 || cfg_seq_newer(slots[i].seq, s_seq))) {
+                s_slot = i;
+                s_seq = slots[i].seq;
+            }
+        }
+        if (s_slot >= 0) {
+            s_cfg = slots[s_slot];
+        }
+    }
+
+    free(slots);
+    return result;
+}
+
+//==============================================================================
+// Settings in RAM
+//==============================================================================
+
+int config_sd_get(uint32_t key, uint32_t *value) {
+    const cfg_entry_t *e = cfg_snapshot_find(&s_cfg, key);
+
+    if (e == NULL) {
+        return 0;
+    }
+    *value = e->value;
+    return 1;
+}
+
+int config_sd_set(uint32_t key, uint32_t value) {
+    cfg_entry_t *e = (cfg_entry_t *)cfg_snapshot_find(&s_cfg, key);
+
+    if (e == NULL) {
+        if (s_cfg.count == CFG_STORE_MAX_ENTRIES) {
+            return 0;
+        }
+        e = &s_cfg.entry[s_cfg.count++];
+        e->key = key;
+    }
+    e->value = value;
+    return 1;
+}
+
+int config_sd_get_card(sd_card_info_t *info, uint32_t *init_ms) {
+    uint32_t w, type;
+
+    for (int i = 0; i < 4; i++) {
+        if (!config_sd_get(CFG_KEY_CARD_CID(i), &w)) {
+            return 0;
+        }
+        memcpy(&info->cid[i * 4], &w, 4);
+    }
+    if (!config_sd_get(CFG_KEY_CARD_TYPE, &type) ||
+        !config_sd_get(CFG_KEY_CARD_SECTORS, &info->sector_count)) {
+        return 0;
+    }
+    info->type = (sd_card_type_t)type;
+    if (!config_sd_get(CFG_KEY_CARD_INIT_MS, init_ms)) {
+        *init_ms = 0;
+    }
+    return 1;
+}
+
+int config_sd_set_card(const sd_card_info_t *info, uint32_t init_ms) {
+    uint32_t w;
+    int ok = 1;
+
+    for (int i = 0; i < 4; i++) {
+        memcpy(&w, &info->cid[i * 4], 4);
+        ok &= config_sd_set(CFG_KEY_CARD_CID(i), w);
+    }
+    ok &= config_sd_set(CFG_KEY_CARD_TYPE, (uint32_t)info->type);
+    ok &= config_sd_set(CFG_KEY_CARD_SECTORS, info->sector_count);
+    ok &= config_sd_set(CFG_KEY_CARD_INIT_MS, init_ms);
+    return ok;
+}
+
+//==============================================================================
+// Commit
+//==============================================================================
+
+// The slots may only be written when no file system partition covers them:
+// the card was formatted with the boot partition (type 0xDA), or its
+// partitions start after it. Uses s_verify.
+static uint8_t config_sd_check_mbr(void) {
+    uint8_t result = sd_read_blocks(0, s_verify, 1);
+
+    if (result != SD_OK) {
+        return result;
+    }
+    if (s_verify[510] != 0x55 || s_verify[511] != 0xAA) {
+        return SD_OK;               // No MBR: a bare card, nothing to hit
+    }
+    for (int i = 0; i < 4; i++) {
+        const uint8_t *p = &s_verify[446 + i * 16];
+        uint32_t start = p[8] | (p[9] << 8) | (p[10] << 16) | ((uint32_t)p[11] << 24);
+
+        if (p[4] != 0 && p[4] != 0xDA && start <= BOOT_PARTITION_END) {
+            return SD_ERROR_WRITE;
+        }
+    }
+    return SD_OK;
+}
+
+uint8_t config_sd_commit(void) {
+    int slot = (s_slot + 1) % CFG_STORE_SLOTS;
+    uint8_t result;
+
+    result = config_sd_check_mbr();
+    if (result != SD_OK) {
+        return result;
+    }
+
+    s_cfg.magic = CFG_STORE_MAGIC;
+    s_cfg.version = CFG_STORE_VERSION;
+    s_cfg.seq = s_seq + 1;
+    if (s_cfg.seq == 0) {
+        s_cfg.seq = 1;              // 0 reads as "no snapshot"
+    }
+    s_cfg.crc = crc32_calc(&s_cfg, sizeof(s_cfg) - 4);
+
+    result = sd_write_blocks(CFG_STORE_SECTOR + slot, (const uint8_t *)&s_cfg, 1);
+    if (result == SD_OK) {
+        result = sd_read_blocks(CFG_STORE_SECTOR + slot, s_verify, 1);
+    }
+    if (result == SD_OK && memcmp(s_verify, &s_cfg, sizeof(s_cfg)) != 0) {
+        result = SD_ERROR_WRITE;
+    }
+
+    // Only a snapshot that is on the card moves the log on
+    if (result == SD_OK) {
+        s_slot = slot;
+        s_seq = s_cfg.seq;
+    }
+    return result;
+}
+
+uint32_t config_sd_seq(void) {
+    return s_slot < 0 ? 0 : s_seq;
+}
@@ -0,0 +1,46 @@
+//==============================================================================
+// Settings Store on SD - SD Card Manager Side
+//
+// Reads and writes the raw settings slots of ../sd_bootloader/config_store.h
+// (end of the boot partition, outside FatFS). config_sd_load() reads all
+// slots at once; config_sd_get() / config_sd_set() work on the copy in RAM;
+// config_sd_commit() writes it to the card as the next snapshot. Raw SD
+// commands only, like crash_sd.c: the diskio sector cache never holds the
+// slots.
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+
+#ifndef CONFIG_SD_H
+#define CONFIG_SD_H
+
+#include <stdint.h>
+#include "sd_spi.h"
+#include "../sd_bootloader/config_store.h"
+
+// Load the newest snapshot of the initialized card (one CMD18 over the
+// slots). Returns SD_OK, also when the card has none (all settings absent),
+// or an sd_spi.h error.
+uint8_t config_sd_load(void);
+
+// 1 and *value if key is set
+int config_sd_get(uint32_t key, uint32_t *value);
+
+// Set key in RAM (config_sd_commit() saves it). 0 if the snapshot is full.
+int config_sd_set(uint32_t key, uint32_t value);
+
+// Write the settings as a new snapshot in the slot after the newest one and
+// read it back. Returns SD_OK or an sd_spi.h error; on an error the previous
+// snapshot is still the one loaded at boot.
+uint8_t config_sd_commit(void);
+
+// Seq of the newest snapshot on the card, 0 if none
+uint32_t config_sd_seq(void);
+
+// The card record (CFG_KEY_CARD_*): 1 and *info, *init_ms (0: not
+// measured) if there is one
+int config_sd_get_card(sd_card_info_t *info, uint32_t *init_ms);
+int config_sd_set_card(const sd_card_info_t *info, uint32_t init_ms);
+
+#endif // CONFIG_SD_H
@@ -3,47 +3,178 @@
 //==============================================================================
 
 #include "crash_dump.h"
+#include "crash_sd.h"
 #include "hardware.h"
 #include <stdio.h>
+#include "../../lib/watchdog.h"
+#include "../../lib/block_upload/block_upload.h"
 
-// Global crash context - filled by assembly IRQ wrapper in start.S
+// Global crash context - s0-s11/gp/tp stored by irq_handler below, the
+// rest by crash_watchdog_irq() from the irq_vec_fast frame
 crash_context_t g_crash_context;
 
-static volatile uint32_t watchdog_enabled = 0;
-
 //==============================================================================
 // Watchdog Control
 //==============================================================================
 
+// The watchdog is its own peripheral (lib/watchdog.h), so overlays keep
+// every timer channel for their own tick or benchmark timing. The
+// pre-timeout comes CRASH_WDT_GRACE_US before the reset: if the IRQ cannot
+// be taken (interrupts masked, CPU stuck in a handler) the CPU is reset
+// and WDT_CAUSE reports it.
 void crash_watchdog_enable(uint32_t timeout_ms) {
-    // Configure timer for one-shot interrupt
-    TIMER_CTRL = 0;  // Disable first
-    TIMER_COMPARE = TIMER_MS_TO_TICKS(timeout_ms);
-    TIMER_STATUS = TIMER_SR_UIF;  // Clear any pending interrupt
-    TIMER_CTRL = TIMER_ENABLE | TIMER_IRQ_ENABLE | TIMER_ONE_SHOT;
+    if (!watchdog_present()) {
+        printf("Watchdog not in this bitstream\r\n");
+        return;
+    }
 
-    watchdog_enabled = 1;
+    watchdog_start(timeout_ms * 1000 + CRASH_WDT_GRACE_US, CRASH_WDT_GRACE_US,
+                   WDT_PRE_IRQ | WDT_RESET);
 
     printf("Watchdog enabled: %lu ms timeout\r\n", (unsigned long)timeout_ms);
 }
 
 void crash_watchdog_disable(void) {
-    TIMER_CTRL = 0;  // Disable timer
-    TIMER_STATUS = TIMER_SR_UIF;  // Clear interrupt
-    watchdog_enabled = 0;
+    watchdog_stop();
 
     printf("Watchdog disabled\r\n");
 }
 
 void crash_watchdog_pet(void) {
-    if (watchdog_enabled) {
-        // Restart timer
-        TIMER_CTRL = 0;  // Disable
-        TIMER_STATUS = TIMER_SR_UIF;  // Clear flag
-        TIMER_CTRL = TIMER_ENABLE | TIMER_IRQ_ENABLE | TIMER_ONE_SHOT;
+    // Ignored by the hardware while disabled
+    watchdog_kick();
+}
+
+// IRQ entry (start.S calls irq_handler after saving ra, a0-a7 and t0-t6):
+// while the pre-timeout is pending, store the registers the C handlers
+// would overwrite before anything else runs. Sources an overlay registered
+// (overlay_irq_mask, overlay_services.c) go straight to their entries in
+// irq_vector_table, lowest first, with a0 = the source; IRQ 1 only if the
+// controller latched a software interrupt, otherwise it is a trap. The
+// bits left continue in app_irq_handler(irqs, frame) with a1 = the
+// irq_vec_fast frame. Offsets are those of crash_context_t.
+__asm__(
+    ".section .fastcode, \"ax\"\n"
+    ".global irq_handler\n"
+    "irq_handler:\n"
+    "    li   t0, 0x80000210\n"            // WDT_STATUS
+    "    lw   t0, 0(t0)\n"
+    "    andi t0, t0, 1\n"                 // WDT_STATUS_PRE
+    "    beqz t0, 1f\n"
+    "    la   t0, g_crash_context\n"
+    "    sw   gp,   8(t0)\n"
+    "    sw   tp,  12(t0)\n"
+    "    sw   s0,  28(t0)\n"
+    "    sw   s1,  32(t0)\n"
+    "    sw   s2,  68(t0)\n"
+    "    sw   s3,  72(t0)\n"
+    "    sw   s4,  76(t0)\n"
+    "    sw   s5,  80(t0)\n"
+    "    sw   s6,  84(t0)\n"
+    "    sw   s7,  88(t0)\n"
+    "    sw   s8,  92(t0)\n"
+    "    sw   s9,  96(t0)\n"
+    "    sw   s10, 100(t0)\n"
+    "    sw   s11, 104(t0)\n"
+    "1:  la   t0, overlay_irq_mask\n"
+    "    lw   t0, 0(t0)\n"
+    "    and  t0, t0, a0\n"
+    "    bnez t0, 2f\n"
+    "    mv   a1, sp\n"
+    "    tail app_irq_handler\n"
+    "2:  addi sp, sp, -16\n"
+    "    sw   ra, 0(sp)\n"
+    "    sw   s0, 4(sp)\n"
+    "    sw   s1, 8(sp)\n"
+    "    sw   s2, 12(sp)\n"
+    "    mv   s1, t0\n"                   // Overlay sources
+    "    li   t1, 0x80000144\n"            // IRQC_PENDING
+    "    andi t2, s1, 2\n"
+    "    beqz t2, 3f\n"
+    "    lw   t2, 0(t1)\n"
+    "    andi t2, t2, 2\n"
+    "    bnez t2, 3f\n"
+    "    andi s1, s1, -3\n"               // Trap, not a software interrupt
+    "3:  sw   s1, 0(t1)\n"                 // Acknowledge the latched bits
+    "    xor  s0, a0, s1\n"               // Left for app_irq_handler
+    "    li   s2, 0\n"
+    "4:  beqz s1, 6f\n"
+    "    srl  t0, s1, s2\n"
+    "    andi t0, t0, 1\n"
+    "    beqz t0, 5f\n"
+    "    la   t1, irq_vector_table\n"
+    "    slli t2, s2, 2\n"
+    "    add  t1, t1, t2\n"
+    "    lw   t1, 0(t1)\n"
+    "    mv   a0, s2\n"
+    "    jalr t1\n"
+    "    li   t0, 1\n"
+    "    sll  t0, t0, s2\n"
+    "    xor  s1, s1, t0\n"
+    "5:  addi s2, s2, 1\n"
+    "    j    4b\n"
+    "6:  mv   a0, s0\n"
+    "    lw   ra, 0(sp)\n"
+    "    lw   s0, 4(sp)\n"
+    "    lw   s1, 8(sp)\n"
+    "    lw   s2, 12(sp)\n"
+    "    addi sp, sp, 16\n"
+    "    beqz a0, 7f\n"
+    "    mv   a1, sp\n"
+    "    tail app_irq_handler\n"
+    "7:  ret\n"
+    ".text\n"
+);
+
+void crash_report_sd(uint8_t result) {
+    if (result == 0) {
+        printf("\r\nCrash dump written to " CRASH_SD_PATH "\r\n");
+    } else {
+        printf("\r\nCrash dump not written to SD (error %u)\r\n", (unsigned)result);
     }
 }
 
+void crash_capture(crash_context_t *ctx, uint32_t irqs, const uint32_t *frame) {
+    // irq_vec_fast frame: ra, a0-a7, t0-t6; the interrupted sp is above it
+    ctx->ra = frame[0];
+    ctx->a0 = frame[1];  ctx->a1 = frame[2];
+    ctx->a2 = frame[3];  ctx->a3 = frame[4];
+    ctx->a4 = frame[5];  ctx->a5 = frame[6];
+    ctx->a6 = frame[7];  ctx->a7 = frame[8];
+    ctx->t0 = frame[9];  ctx->t1 = frame[10]; ctx->t2 = frame[11];
+    ctx->t3 = frame[12]; ctx->t4 = frame[13];
+    ctx->t5 = frame[14]; ctx->t6 = frame[15];
+    ctx->sp = (uint32_t)frame + 64;
+
+    // Interrupted PC in q0 (bit 0 set after a compressed instruction)
+    uint32_t q0;
+    __asm__ volatile (".insn r 0x0B, 4, 0, %0, x0, x0" : "=r"(q0));  // getq q0
+    ctx->pc = q0 & ~1u;
+    ctx->irq_mask = irqs;
+}
+
+void crash_watchdog_irq(uint32_t irqs, const uint32_t *frame) {
+    crash_context_t *ctx = &g_crash_context;
+
+    if (!(WDT_STATUS & WDT_STATUS_PRE))
+        return;
+
+    // Stop the countdown: the dump and the download take longer than the grace
+    watchdog_stop();
+
+    crash_capture(ctx, irqs, frame);
+
+    // SD first: it is kept when nobody watches the UART
+    LED_REG = 0x03;
+    crash_report_sd(crash_sd_write(ctx, CRASH_CAUSE_WATCHDOG, CRASH_SD_SAVED_REGS));
+    crash_dump_context(ctx);
+    crash_dump_memory((ctx->pc & ~15u) - 32, 64);
+    crash_dump_stack(ctx->sp, 16);
+
+    // Halt with both LEDs on, SRAM available to fw_upload_fast -D
+    crash_serve_memory(CRASH_SRAM_BASE, CRASH_SRAM_SIZE);
+}
+
 //==============================================================================
 // Crash Dump Functions
 //==============================================================================
@@ -156,3 +287,42 @@ void crash_dump_stack(uint32_t sp, uint32_t depth) {
     }
     printf("\r\n");
 }
+
+//==============================================================================
+// Memory Download after a Crash
+//==============================================================================
+
+static uint32_t serve_base;
+
+static void serve_putc(uint8_t c) {
+    while (UART_TX_STATUS & UART_TX_BUSY);
+    UART_TX_DATA = c;
+}
+
+static uint8_t serve_getc(void) {
+    while (!(UART_RX_STATUS & UART_RX_READY));
+    return UART_RX_DATA & 0xFF;
+}
+
+static const uint8_t *serve_read(uint32_t offset, uint32_t len) {
+    (void)len;
+    return (const uint8_t *)(serve_base + offset);
+}
+
+void crash_serve_memory(uint32_t addr, uint32_t size) {
+    const block_source_t src = {
+        .putc = serve_putc,
+        .getc = serve_getc,
+        .read = serve_read,
+    };
+
+    serve_base = addr;
+    printf("Pull 0x%08lX - 0x%08lX with: fw_upload_fast -D crash.bin\r\n",
+           (unsigned long)addr, (unsigned long)(addr + size - 1));
+    fflush(stdout);
+
+    // Serve again after each download or Ctrl-C: as many pulls as wanted
+    while (1) {
+        block_send(&src, size);
+    }
+}
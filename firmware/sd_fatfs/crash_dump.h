@@ -2,7 +2,8 @@
 // Crash Dump Module - Debug Overlay Crashes
 //
 // Provides crash detection and register dump for debugging overlay hangs.
-// Uses timer watchdog to detect when overlay stops making progress.
+// Uses the hardware watchdog (lib/watchdog.h) to detect when an overlay
+// stops making progress.
 //
 // Copyright (c) October 2025 Michael Wolak
 // Email: mikewolak@gmail.com, mike@epromfoundry.com
@@ -18,7 +19,7 @@
 //==============================================================================
 
 typedef struct {
-    // Saved registers from IRQ vector
+    // Registers at the pre-timeout IRQ (irq_vec_fast frame + irq_handler)
     uint32_t ra;   // Return address
     uint32_t sp;   // Stack pointer
     uint32_t gp;   // Global pointer
@@ -51,26 +52,48 @@ typedef struct {
     uint32_t t5;
     uint32_t t6;
 
-    // PC is stored in q2 by PicoRV32
-    uint32_t pc;   // Program counter (from q2)
+    // PicoRV32 keeps the interrupted PC in q0
+    uint32_t pc;   // Program counter (from q0)
 
     // IRQ info
     uint32_t irq_mask;  // From q1
 } crash_context_t;
 
+// Context of the last crash (crash_dump.c)
+extern crash_context_t g_crash_context;
+
 //==============================================================================
 // Function Prototypes
 //==============================================================================
 
+// Pre-timeout to CPU reset: time to take the IRQ and stop the countdown
+#define CRASH_WDT_GRACE_US 100000
+
 // Enable watchdog with timeout (in milliseconds)
 void crash_watchdog_enable(uint32_t timeout_ms);
 
 // Disable watchdog
 void crash_watchdog_disable(void);
 
-// Pet the watchdog (reset timer)
+// Pet the watchdog (restart the countdown); overlays can also call
+// watchdog_kick() from lib/watchdog.h directly
 void crash_watchdog_pet(void);
 
+// Fill ctx from the irq_vec_fast frame, q0 and irqs (s0-s11/gp/tp are
+// only stored by irq_handler on a watchdog pre-timeout)
+void crash_capture(crash_context_t *ctx, uint32_t irqs, const uint32_t *frame);
+
+// Print the crash_sd_write() result
+void crash_report_sd(uint8_t result);
+
+// IRQ[7] work: on a watchdog pre-timeout dump the context and serve SRAM
+// (no return); otherwise returns at once. frame = irq_vec_fast frame.
+void crash_watchdog_irq(uint32_t irqs, const uint32_t *frame);
+
+// Provided by the firmware: crash_dump.c defines irq_handler, which saves
+// the callee-saved registers on a pre-timeout and then calls this
+void app_irq_handler(uint32_t irqs, const uint32_t *frame);
+
 // Dump crash context to UART
 void crash_dump_context(const crash_context_t *ctx);
 
@@ -80,4 +103,10 @@ void crash_dump_memory(uint32_t addr, uint32_t size);
 // Dump stack trace
 void crash_dump_stack(uint32_t sp, uint32_t depth);
 
+// Halt, serving a memory range to the host over the block protocol
+// (lib/block_upload, fw_upload_fast -D crash.bin). Never returns.
+#define CRASH_SRAM_BASE 0x00000000
+#define CRASH_SRAM_SIZE 0x00080000  // All 512 KB
+void crash_serve_memory(uint32_t addr, uint32_t size);
+
 #endif // CRASH_DUMP_H
@@ -0,0 +1,208 @@
+//==============================================================================
+// Crash Dump to SD - Implementation
+//
+// Like log_writer.c, the file is allocated in one piece by f_expand(), so
+// sector N of the file is first + N. Unlike it, the crash path does not go
+// through disk_write() either: the diskio sector cache may hold the state
+// that crashed, and a dump has to reach the card anyway.
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+
+#include "crash_sd.h"
+#include "sd_spi.h"
+#include "io.h"
+#include <stddef.h>
+#include <string.h>
+#include "../../lib/crc32.h"
+#include "../../lib/timer.h"
+#include "../../lib/watchdog.h"
+
+#define CRASH_SD_SECTORS    (CRASH_SD_SIZE / 512)
+
+// Memory the dump may read without side effects: SRAM and scratchpad
+#define CRASH_RAM_END       0x00081000
+
+static uint32_t s_sector;           // First sector of the file (0: none)
+static uint32_t s_seq;
+
+static crash_sd_region_t s_extra[CRASH_SD_MAX_REGIONS];
+static uint32_t s_num_extra;
+
+// Header sector and the per-sector pointers of the gather write
+static uint8_t s_head_buf[512] __attribute__((aligned(4)));
+static const uint8_t *s_sg[CRASH_SD_SECTORS];
+
+//==============================================================================
+// File Setup (FatFS)
+//==============================================================================
+
+FRESULT crash_sd_prepare(const char *path) {
+    const crash_sd_header_t *old = (const crash_sd_header_t *)s_head_buf;
+    DWORD clmt[8];
+    FATFS *fs;
+    FIL fil;
+    UINT n;
+    int reuse = 0;
+    FRESULT fr;
+
+    s_sector = 0;
+    s_seq = 0;
+
+    fr = f_open(&fil, path, FA_OPEN_ALWAYS | FA_READ | FA_WRITE);
+    if (fr != FR_OK) {
+        return fr;
+    }
+
+    // Keep a file that is already one run of the right size: the link map
+    // of a contiguous file is a single fragment (size, count, cluster, 0)
+    if (f_size(&fil) == CRASH_SD_SIZE) {
+        fil.cltbl = clmt;
+        clmt[0] = sizeof(clmt) / sizeof(clmt[0]);
+        reuse = f_lseek(&fil, CREATE_LINKMAP) == FR_OK && clmt[0] == 4;
+        fil.cltbl = NULL;
+    }
+
+    if (reuse) {
+        // Continue the sequence of the dump already there
+        fr = f_lseek(&fil, 0);
+        if (fr == FR_OK) {
+            fr = f_read(&fil, s_head_buf, 512, &n);
+        }
+        if (fr == FR_OK && n == 512 && old->magic == CRASH_SD_MAGIC) {
+            s_seq = old->seq;
+        }
+    } else {
+        // f_expand() needs an empty file
+        fr = f_lseek(&fil, 0);
+        if (fr == FR_OK) {
+            fr = f_truncate(&fil);
+        }
+        if (fr == FR_OK) {
+            fr = f_expand(&fil, CRASH_SD_SIZE, 1);
+        }
+        // The clusters hold old data: no stale magic in the header sector
+        if (fr == FR_OK) {
+            memset(s_head_buf, 0, sizeof(s_head_buf));
+            fr = f_write(&fil, s_head_buf, 512, &n);
+        }
+    }
+
+    if (fr == FR_OK) {
+        fs = fil.obj.fs;
+        s_sector = fs->database + (LBA_t)fs->csize * (fil.obj.sclust - 2);
+    }
+    if (f_close(&fil) != FR_OK && fr == FR_OK) {
+        fr = FR_DISK_ERR;
+    }
+    if (fr != FR_OK) {
+        s_sector = 0;
+    }
+
+    return fr;
+}
+
+void crash_sd_release(void) {
+    s_sector = 0;
+}
+
+void crash_sd_add_region(uint32_t addr, uint32_t size) {
+    if (s_num_extra < CRASH_SD_MAX_REGIONS) {
+        s_extra[s_num_extra].addr = addr;
+        s_extra[s_num_extra].size = size;
+        s_num_extra++;
+    }
+}
+
+void crash_sd_clear_regions(void) {
+    s_num_extra = 0;
+}
+
+//==============================================================================
+// Crash Path (raw SD only)
+//==============================================================================
+
+// Append [addr, addr + size) as whole sectors, clipped to readable memory
+// and to the room left in the file; n = sectors used so far
+static void crash_sd_region(crash_sd_header_t *h, uint32_t *n, uint32_t addr, uint32_t size) {
+    uint32_t end = addr + size;
+    crash_sd_region_t *r;
+
+    if (h->num_regions >= CRASH_SD_MAX_REGIONS || size == 0 || addr >= CRASH_RAM_END) {
+        return;
+    }
+    if (end > CRASH_RAM_END || end < addr) {
+        end = CRASH_RAM_END;
+    }
+    addr &= ~511u;
+    end = (end + 511) & ~511u;
+    if ((end - addr) / 512 > CRASH_SD_SECTORS - *n) {
+        end = addr + (CRASH_SD_SECTORS - *n) * 512;
+    }
+    if (end == addr) {
+        return;
+    }
+
+    r = &h->region[h->num_regions++];
+    r->addr = addr;
+    r->size = end - addr;
+    r->offset = *n * 512;
+    r->crc = crc32_calc((const void *)addr, r->size);
+
+    for (uint32_t a = addr; a < end; a += 512) {
+        s_sg[(*n)++] = (const uint8_t *)a;
+    }
+}
+
+uint8_t crash_sd_write(const crash_context_t *ctx, uint32_t cause, uint32_t flags) {
+    crash_sd_header_t *h = (crash_sd_header_t *)s_head_buf;
+    uint32_t n = 1;
+    uint8_t r;
+
+    if (s_sector == 0) {
+        return SD_ERROR_WRITE;
+    }
+
+    memset(s_head_buf, 0, sizeof(s_head_buf));
+    h->magic = CRASH_SD_MAGIC;
+    h->version = CRASH_SD_VERSION;
+    h->header_size = sizeof(crash_sd_header_t);
+    h->seq = ++s_seq;
+    h->cause = cause;
+    h->flags = flags;
+    h->time_ms = TIMEBASE_MS;
+    h->wdt_cause = WDT_CAUSE;
+    h->pc = ctx->pc;
+    h->irq_mask = ctx->irq_mask;
+
+    h->x[1] = ctx->ra;   h->x[2] = ctx->sp;   h->x[3] = ctx->gp;   h->x[4] = ctx->tp;
+    h->x[5] = ctx->t0;   h->x[6] = ctx->t1;   h->x[7] = ctx->t2;
+    h->x[8] = ctx->s0;   h->x[9] = ctx->s1;
+    h->x[10] = ctx->a0;  h->x[11] = ctx->a1;  h->x[12] = ctx->a2;  h->x[13] = ctx->a3;
+    h->x[14] = ctx->a4;  h->x[15] = ctx->a5;  h->x[16] = ctx->a6;  h->x[17] = ctx->a7;
+    h->x[18] = ctx->s2;  h->x[19] = ctx->s3;  h->x[20] = ctx->s4;  h->x[21] = ctx->s5;
+    h->x[22] = ctx->s6;  h->x[23] = ctx->s7;  h->x[24] = ctx->s8;  h->x[25] = ctx->s9;
+    h->x[26] = ctx->s10; h->x[27] = ctx->s11;
+    h->x[28] = ctx->t3;  h->x[29] = ctx->t4;  h->x[30] = ctx->t5;  h->x[31] = ctx->t6;
+
+    s_sg[0] = s_head_buf;
+    crash_sd_region(h, &n, ctx->pc > CRASH_SD_CODE_BYTES / 2 ? ctx->pc - CRASH_SD_CODE_BYTES / 2 : 0,
+                    CRASH_SD_CODE_BYTES);
+    crash_sd_region(h, &n, ctx->sp, CRASH_SD_STACK_BYTES);
+    for (uint32_t i = 0; i < s_num_extra; i++) {
+        crash_sd_region(h, &n, s_extra[i].addr, s_extra[i].size);
+    }
+    h->header_crc = crc32_calc(h, offsetof(crash_sd_header_t, header_crc));
+
+    // Interrupts are off here: poll the DMA instead of sleeping on IRQ[2]
+    spi_dma_sleep(0);
+
+    r = sd_write_blocks_sg(s_sector, s_sg, n);
+    if (r != SD_OK && sd_init() == SD_OK) {
+        // The crash may have cut a transfer short: start the card over
+        r = sd_write_blocks_sg(s_sector, s_sg, n);
+    }
+
+    return r;
+}
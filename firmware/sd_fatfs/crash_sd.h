@@ -0,0 +1,84 @@
+//==============================================================================
+// Crash Dump to SD - Binary Dump File for tools/crashdecode
+//
+// crash_sd_prepare() sets up CRASH.DMP through FatFS while the file system
+// is known good (before an overlay runs): a contiguous, preallocated file
+// whose first sector is remembered. At the crash, crash_sd_write() sends
+// the registers, the code around the PC, the stack and any regions added
+// with crash_sd_add_region() as one gather CMD25 (sd_write_blocks_sg())
+// straight from memory. FatFS, diskio and the sector cache are not used,
+// so the dump still lands when their state is what crashed.
+//
+// File layout (little endian): sector 0 is crash_sd_header_t, then each
+// region's data at header.region[i].offset, whole sectors. The previous
+// dump stays in the file until the next crash overwrites it.
+//
+//   tools/crashdecode/crashdecode firmware/sd_card_manager.elf CRASH.DMP
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+
+#ifndef CRASH_SD_H
+#define CRASH_SD_H
+
+#include <stdint.h>
+#include "ff.h"
+#include "crash_dump.h"
+
+#define CRASH_SD_PATH           "CRASH.DMP"
+#define CRASH_SD_SIZE           (64 * 1024)     // Header + region data
+#define CRASH_SD_MAGIC          0x44435652      // "RVCD"
+#define CRASH_SD_VERSION        1
+#define CRASH_SD_MAX_REGIONS    8
+#define CRASH_SD_CODE_BYTES     1024            // Around the PC
+#define CRASH_SD_STACK_BYTES    4096            // From the SP up
+
+// Causes
+#define CRASH_CAUSE_WATCHDOG    1               // Watchdog pre-timeout
+#define CRASH_CAUSE_TRAP        2               // Illegal instruction / EBREAK (IRQ[1])
+
+// Flags
+#define CRASH_SD_SAVED_REGS     (1 << 0)        // s0-s11, gp, tp captured (else 0)
+
+typedef struct {
+    uint32_t addr;
+    uint32_t size;                  // Bytes (whole sectors)
+    uint32_t offset;                // Position in the file
+    uint32_t crc;                   // CRC32 of the data as written
+} crash_sd_region_t;
+
+typedef struct {
+    uint32_t magic;                 // CRASH_SD_MAGIC
+    uint16_t version;               // CRASH_SD_VERSION
+    uint16_t header_size;           // sizeof(crash_sd_header_t)
+    uint32_t seq;                   // Dumps written to this file, this one included
+    uint32_t cause;                 // CRASH_CAUSE_*
+    uint32_t flags;                 // CRASH_SD_*
+    uint32_t time_ms;               // Timebase milliseconds at the crash
+    uint32_t wdt_cause;             // WDT_CAUSE register (lib/watchdog.h)
+    uint32_t pc;
+    uint32_t irq_mask;
+    uint32_t x[32];                 // x0-x31 (x0 = 0)
+    uint32_t num_regions;
+    crash_sd_region_t region[CRASH_SD_MAX_REGIONS];
+    uint32_t header_crc;            // CRC32 of everything above
+} crash_sd_header_t;
+
+// Create or reuse path as the dump file (FatFS mounted). An existing file of
+// CRASH_SD_SIZE in one piece is kept, with its last dump.
+FRESULT crash_sd_prepare(const char *path);
+
+// Forget the file (before FatFS may move or delete it)
+void crash_sd_release(void);
+
+// Save a memory range too (SRAM or scratchpad; extended to whole sectors)
+void crash_sd_add_region(uint32_t addr, uint32_t size);
+void crash_sd_clear_regions(void);
+
+// Write the dump. Raw SD commands only; re-initializes the card once if the
+// first attempt fails. Returns SD_OK (0) or an sd_spi.h error; SD_ERROR_WRITE
+// without a prepared file.
+uint8_t crash_sd_write(const crash_context_t *ctx, uint32_t cause, uint32_t flags);
+
+#endif // CRASH_SD_H
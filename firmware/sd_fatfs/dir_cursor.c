@@ -0,0 +1,461 @@
+//==============================================================================
+// Directory Cursor - Implementation
+//
+// Entries are stored in f_readdir() order, so entry n (after "..") is the
+// n-th item of the directory and its name can be found again from the DIR
+// copy before it. Name order is worked out once per scan: the first
+// DIR_CURSOR_KEY bytes sort most names; entries that still tie are told
+// apart by their next DIR_CURSOR_KEY bytes, read in one more pass over the
+// directory for all of them, until no ties are left. The result is kept as
+// each entry's rank, so both sort orders are rebuilt without card access.
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+
+#include "dir_cursor.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DIR_CURSOR_GROW     256         // Entries added per realloc()
+
+typedef struct {
+    uint32_t gen;                       // Listing scan the name is from (0: free)
+    uint32_t used;                      // LRU stamp
+    uint16_t pos;                       // Entry number in the directory
+    char     name[FF_LFN_BUF + 1];
+} dir_name_t;
+
+static dir_listing_t s_listings[DIR_CURSOR_CACHED];
+static dir_name_t s_names[DIR_CURSOR_NAMES];
+static uint32_t s_gen = 0;              // Scans so far
+static uint32_t s_clock = 0;            // LRU stamps
+
+typedef int (*entry_cmp_t)(const dir_entry_t *a, const dir_entry_t *b);
+
+//==============================================================================
+// Listings
+//==============================================================================
+
+static void listing_free(dir_listing_t *l) {
+    free(l->entry);
+    free(l->order);
+    free(l->mark);
+    memset(l, 0, sizeof(*l));
+}
+
+// Still the mount it was read from (the DIR copies hold the FATFS pointer)
+static int listing_valid(const dir_listing_t *l) {
+    const FATFS *fs = l->mark ? l->mark[0].obj.fs : NULL;
+
+    return l->gen != 0 && fs != NULL && fs->fs_type != 0 && fs->id == l->fs_id;
+}
+
+// Room for need items of size bytes in *p, growing by DIR_CURSOR_GROW
+static int grow(void **p, uint32_t *cap, uint32_t need, size_t size) {
+    void *n;
+
+    if (need <= *cap) {
+        return 1;
+    }
+    n = realloc(*p, (*cap + DIR_CURSOR_GROW) * size);
+    if (n == NULL) {
+        return 0;
+    }
+    *p = n;
+    *cap += DIR_CURSOR_GROW;
+    return 1;
+}
+
+// Up to DIR_CURSOR_KEY name bytes from offset, zero padded
+static void set_key(dir_entry_t *e, const char *name, uint32_t offset) {
+    size_t len = strlen(name);
+
+    strncpy(e->key, offset < len ? name + offset : "", DIR_CURSOR_KEY);
+}
+
+static FRESULT scan(dir_listing_t *l, const char *path) {
+    DIR dir;
+    FILINFO fno;
+    FRESULT fr;
+    uint32_t cap = 0, mark_cap = 0;
+    uint32_t pos = 0;
+
+    fr = f_opendir(&dir, path);
+    if (fr != FR_OK) {
+        return fr;
+    }
+
+    strncpy(l->path, path, sizeof(l->path) - 1);
+    l->fs_id = dir.obj.id;
+
+    // ".." first in a subdirectory
+    if (strcmp(path, "/") != 0) {
+        if (!grow((void **)&l->entry, &cap, 1, sizeof(dir_entry_t))) {
+            fr = FR_NOT_ENOUGH_CORE;
+            goto done;
+        }
+        memset(&l->entry[0], 0, sizeof(dir_entry_t));
+        l->entry[0].pos = DIR_CURSOR_UP;
+        l->entry[0].attrib = AM_DIR;
+        l->entry[0].is_dir = 1;
+        memcpy(l->entry[0].key, "..", 2);
+        l->count = 1;
+    }
+
+    for (;;) {
+        if (pos % DIR_CURSOR_STEP == 0) {
+            if (!grow((void **)&l->mark, &mark_cap, pos / DIR_CURSOR_STEP + 1, sizeof(DIR))) {
+                fr = FR_NOT_ENOUGH_CORE;
+                break;
+            }
+            l->mark[pos / DIR_CURSOR_STEP] = dir;
+        }
+
+        fr = f_readdir(&dir, &fno);
+        if (fr != FR_OK || fno.fname[0] == 0) {
+            break;
+        }
+        if (pos == DIR_CURSOR_MAX ||
+            !grow((void **)&l->entry, &cap, l->count + 1, sizeof(dir_entry_t))) {
+            l->truncated = 1;   // Listed as far as there is room
+            break;
+        }
+
+        dir_entry_t *e = &l->entry[l->count++];
+        e->size = (uint32_t)fno.fsize;
+        e->date = fno.fdate;
+        e->time = fno.ftime;
+        e->pos = (uint16_t)pos++;
+        e->rank = 0;
+        e->attrib = fno.fattrib;
+        e->is_dir = (fno.fattrib & AM_DIR) ? 1 : 0;
+        set_key(e, fno.fname, 0);
+        if (!e->is_dir) {
+            l->total += e->size;
+        }
+    }
+
+done:
+    f_closedir(&dir);
+    if (fr == FR_OK && l->count > 0) {
+        l->order = malloc(l->count * sizeof(uint16_t));
+        if (l->order == NULL) {
+            fr = FR_NOT_ENOUGH_CORE;
+        }
+    }
+    return fr;
+}
+
+//==============================================================================
+// Sorting
+//==============================================================================
+
+static uint32_t first_sorted(const dir_listing_t *l) {
+    return (l->count > 0 && l->entry[0].pos == DIR_CURSOR_UP) ? 1 : 0;
+}
+
+static int cmp_key(const dir_entry_t *a, const dir_entry_t *b) {
+    if (a->is_dir != b->is_dir) {
+        return a->is_dir ? -1 : 1;
+    }
+    return memcmp(a->key, b->key, DIR_CURSOR_KEY);     // As strcmp() on the bytes
+}
+
+static int cmp_time(const dir_entry_t *a, const dir_entry_t *b) {
+    if (a->is_dir != b->is_dir) {
+        return a->is_dir ? -1 : 1;
+    }
+    if (a->date != b->date) {
+        return (a->date < b->date) ? -1 : 1;
+    }
+    if (a->time != b->time) {
+        return (a->time < b->time) ? -1 : 1;
+    }
+    return (a->rank < b->rank) ? -1 : (a->rank > b->rank);
+}
+
+// Rows lo .. hi - 1 of o. Middle pivot and recursion on the smaller side:
+// already sorted directories (files created in name order) stay fast and
+// the stack stays shallow.
+static void sort_rows(const dir_entry_t *e, uint16_t *o, int32_t lo, int32_t hi, entry_cmp_t cmp) {
+    while (hi - lo > 1) {
+        const dir_entry_t *pivot = &e[o[lo + (hi - lo) / 2]];
+        int32_t i = lo, j = hi - 1;
+
+        while (i <= j) {
+            while (cmp(&e[o[i]], pivot) < 0) i++;
+            while (cmp(&e[o[j]], pivot) > 0) j--;
+            if (i <= j) {
+                uint16_t t = o[i];
+                o[i++] = o[j];
+                o[j--] = t;
+            }
+        }
+
+        if (j + 1 - lo < hi - i) {
+            sort_rows(e, o, lo, j + 1, cmp);
+            lo = i;
+        } else {
+            sort_rows(e, o, i, hi, cmp);
+            hi = j + 1;
+        }
+    }
+}
+
+// Runs of rows that tie on their keys within the run they tied in last
+// round (rank, 0: none). Each row's rank becomes its new run; returns the
+// number of rows in a run.
+static uint32_t mark_ties(dir_listing_t *l, uint32_t first) {
+    dir_entry_t *prev = NULL;
+    uint16_t prev_run = 0;
+    uint16_t runs = 0;
+    uint32_t tied = 0;
+    int prev_tied = 0;
+
+    for (uint32_t i = first; i < l->count; i++) {
+        dir_entry_t *e = &l->entry[l->order[i]];
+        uint16_t run = e->rank;
+        // Equal keys without a zero byte: the names may go on differently
+        int tie = prev != NULL && run != 0 && run == prev_run &&
+                  e->key[DIR_CURSOR_KEY - 1] != 0 && cmp_key(prev, e) == 0;
+
+        if (tie) {
+            if (!prev_tied) {
+                prev->rank = ++runs;
+                tied++;
+            }
+            e->rank = runs;
+            tied++;
+        } else {
+            e->rank = 0;
+        }
+        prev = e;
+        prev_run = run;
+        prev_tied = tie;
+    }
+    return tied;
+}
+
+// Keys of the rows in a run from name offset depth * DIR_CURSOR_KEY, in one
+// pass over the directory
+static FRESULT load_keys(dir_listing_t *l, uint32_t depth) {
+    uint32_t first = first_sorted(l);
+    DIR dir = l->mark[0];
+    FILINFO fno;
+    FRESULT fr;
+
+    for (uint32_t i = first; i < l->count; i++) {
+        fr = f_readdir(&dir, &fno);
+        if (fr != FR_OK) {
+            return fr;
+        }
+        if (fno.fname[0] == 0) {
+            return FR_INT_ERR;  // Shorter than at the scan
+        }
+        if (l->entry[i].rank != 0) {
+            set_key(&l->entry[i], fno.fname, depth * DIR_CURSOR_KEY);
+        }
+    }
+    return FR_OK;
+}
+
+static FRESULT sort_names(dir_listing_t *l) {
+    uint32_t first = first_sorted(l);
+    FRESULT fr;
+
+    for (uint32_t i = 0; i < l->count; i++) {
+        l->order[i] = (uint16_t)i;
+        l->entry[i].rank = 1;   // One run: everything may tie
+    }
+    sort_rows(l->entry, l->order, first, l->count, cmp_key);
+
+    for (uint32_t depth = 1; depth * DIR_CURSOR_KEY < FF_LFN_BUF; depth++) {
+        if (mark_ties(l, first) == 0) {
+            break;
+        }
+        fr = load_keys(l, depth);
+        if (fr != FR_OK) {
+            return fr;
+        }
+        // Each run is consecutive rows with one rank
+        for (uint32_t i = first; i < l->count; ) {
+            uint16_t run = l->entry[l->order[i]].rank;
+            uint32_t j = i + 1;
+
+            if (run != 0) {
+                while (j < l->count && l->entry[l->order[j]].rank == run) {
+                    j++;
+                }
+                sort_rows(l->entry, l->order, i, j, cmp_key);
+            }
+            i = j;
+        }
+    }
+
+    for (uint32_t i = 0; i < l->count; i++) {
+        l->entry[l->order[i]].rank = (uint16_t)i;
+    }
+    return FR_OK;
+}
+
+void dir_cursor_sort(dir_listing_t *l, int by_time) {
+    uint32_t first = first_sorted(l);
+
+    l->by_time = by_time ? 1 : 0;
+    for (uint32_t i = 0; i < l->count; i++) {
+        l->order[l->entry[i].rank] = (uint16_t)i;   // Name order
+    }
+    if (by_time) {
+        sort_rows(l->entry, l->order, first, l->count, cmp_time);
+    }
+}
+
+//==============================================================================
+// Open / Invalidate
+//==============================================================================
+
+FRESULT dir_cursor_open(dir_listing_t **listing, const char *path) {
+    dir_listing_t *l = NULL;
+    FRESULT fr;
+
+    for (int i = 0; i < DIR_CURSOR_CACHED; i++) {
+        dir_listing_t *c = &s_listings[i];
+        if (c->gen != 0 && strcmp(c->path, path) == 0) {
+            if (listing_valid(c)) {
+                c->used = ++s_clock;
+                *listing = c;
+                return FR_OK;
+            }
+            listing_free(c);
+        }
+    }
+
+    // Free slot, else the least recently used listing
+    for (int i = 0; i < DIR_CURSOR_CACHED; i++) {
+        dir_listing_t *c = &s_listings[i];
+        if (l == NULL || c->gen == 0 || (l->gen != 0 && c->used < l->used)) {
+            l = c;
+        }
+    }
+    listing_free(l);
+
+    fr = scan(l, path);
+    if (fr == FR_OK && l->count > 0) {
+        fr = sort_names(l);
+    }
+    if (fr != FR_OK) {
+        listing_free(l);
+        return fr;
+    }
+    l->gen = ++s_gen;
+    l->used = ++s_clock;
+    *listing = l;
+    return FR_OK;
+}
+
+void dir_cursor_invalidate(const char *path) {
+    for (int i = 0; i < DIR_CURSOR_CACHED; i++) {
+        if (s_listings[i].gen != 0 && (path == NULL || strcmp(s_listings[i].path, path) == 0)) {
+            listing_free(&s_listings[i]);
+        }
+    }
+}
+
+//==============================================================================
+// Rows and Names
+//==============================================================================
+
+const dir_entry_t *dir_cursor_entry(const dir_listing_t *l, uint32_t row) {
+    return &l->entry[l->order[row]];
+}
+
+static dir_name_t *name_find(uint32_t gen, uint16_t pos) {
+    for (int i = 0; i < DIR_CURSOR_NAMES; i++) {
+        if (s_names[i].gen == gen && s_names[i].pos == pos) {
+            s_names[i].used = ++s_clock;
+            return &s_names[i];
+        }
+    }
+    return NULL;
+}
+
+static void name_store(uint32_t gen, uint16_t pos, const char *name) {
+    dir_name_t *n = &s_names[0];
+
+    for (int i = 1; i < DIR_CURSOR_NAMES && n->gen != 0; i++) {
+        if (s_names[i].gen == 0 || s_names[i].used < n->used) {
+            n = &s_names[i];
+        }
+    }
+    n->gen = gen;
+    n->pos = pos;
+    n->used = ++s_clock;
+    strncpy(n->name, name, sizeof(n->name) - 1);
+    n->name[sizeof(n->name) - 1] = '\0';
+}
+
+void dir_cursor_prefetch(dir_listing_t *l, uint32_t first, uint32_t n) {
+    uint16_t want[DIR_CURSOR_NAMES];
+    uint32_t k = 0;
+    int32_t at = -1;            // Entry the next f_readdir() returns (-1: none)
+    DIR dir;
+    FILINFO fno;
+
+    if (!listing_valid(l)) {
+        return;
+    }
+
+    for (uint32_t row = first; row < first + n && row < l->count && k < DIR_CURSOR_NAMES; row++) {
+        uint16_t pos = dir_cursor_entry(l, row)->pos;
+        if (pos != DIR_CURSOR_UP && name_find(l->gen, pos) == NULL) {
+            // In directory order, for one forward walk
+            uint32_t j = k++;
+            while (j > 0 && want[j - 1] > pos) {
+                want[j] = want[j - 1];
+                j--;
+            }
+            want[j] = pos;
+        }
+    }
+
+    for (uint32_t i = 0; i < k; i++) {
+        int32_t p = want[i];
+        int32_t base = p - p % DIR_CURSOR_STEP;
+
+        // From the checkpoint when that is closer than reading on
+        if (at < 0 || at > p || base > at) {
+            dir = l->mark[p / DIR_CURSOR_STEP];
+            at = base;
+        }
+        while (at <= p) {
+            if (f_readdir(&dir, &fno) != FR_OK || fno.fname[0] == 0) {
+                return;
+            }
+            at++;
+        }
+        name_store(l->gen, (uint16_t)p, fno.fname);
+    }
+}
+
+void dir_cursor_name(dir_listing_t *l, uint32_t row, char *buf, size_t len) {
+    const dir_entry_t *e;
+    const dir_name_t *n;
+
+    if (row >= l->count) {
+        snprintf(buf, len, "?");
+        return;
+    }
+    e = dir_cursor_entry(l, row);
+    if (e->pos == DIR_CURSOR_UP) {
+        snprintf(buf, len, "..");
+        return;
+    }
+    n = name_find(l->gen, e->pos);
+    if (n == NULL) {
+        dir_cursor_prefetch(l, row, 1);
+        n = name_find(l->gen, e->pos);
+    }
+    snprintf(buf, len, "%s", n ? n->name : "?");
+}
@@ -0,0 +1,91 @@
+//==============================================================================
+// Directory Cursor - Paged Listings of Large Directories
+//
+// A listing holds one compact record per entry (size, date, attributes and
+// the first name bytes, not the name) and a sorted index over them; names
+// are read back from the card only for the rows on screen. The scan keeps
+// a copy of the DIR object every DIR_CURSOR_STEP entries, so re-reading
+// a name costs at most DIR_CURSOR_STEP f_readdir() calls (sectors mostly
+// from the disk cache). The last DIR_CURSOR_CACHED listings stay in RAM:
+// going back to a directory does not scan it again.
+//
+// Usage:
+//   dir_listing_t *l;
+//   dir_cursor_open(&l, "/LOGS");
+//   dir_cursor_prefetch(l, top, rows);          // Names of the visible rows
+//   dir_cursor_name(l, row, name, sizeof(name));
+//   dir_cursor_invalidate("/LOGS");             // After changing it
+//
+// Row 0 of a subdirectory is "..". A listing stays valid until its
+// directory is invalidated or DIR_CURSOR_CACHED other directories are
+// opened; a remount invalidates all of them.
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+
+#ifndef DIR_CURSOR_H
+#define DIR_CURSOR_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "ff.h"
+
+#define DIR_CURSOR_MAX      8192        // Entries per listing, more are cut off
+#define DIR_CURSOR_STEP     32          // Entries per DIR checkpoint
+#define DIR_CURSOR_CACHED   4           // Listings kept
+#define DIR_CURSOR_NAMES    32          // Names kept (more than a screen)
+#define DIR_CURSOR_KEY      12          // Name bytes in each entry, for sorting
+
+#define DIR_CURSOR_UP       0xFFFF      // pos of the ".." entry
+
+typedef struct {
+    uint32_t size;                      // File size in bytes
+    uint16_t date;                      // FAT date
+    uint16_t time;                      // FAT time
+    uint16_t pos;                       // Entry number in f_readdir() order
+    uint16_t rank;                      // Place in name order
+    uint8_t  attrib;                    // File attributes
+    uint8_t  is_dir;                    // 1 if directory, 0 if file
+    char     key[DIR_CURSOR_KEY];       // First name bytes, zero padded
+} dir_entry_t;
+
+typedef struct {
+    char         path[256];             // As the file browser's current_path
+    uint32_t     count;                 // Rows, ".." included
+    uint8_t      truncated;             // Directory has more than DIR_CURSOR_MAX
+    uint8_t      by_time;               // Sorted by time (else by name)
+    uint32_t     row;                   // Selection, kept for the caller
+    uint32_t     top;                   // First visible row, kept for the caller
+    uint32_t     total;                 // Bytes in the files
+    dir_entry_t *entry;                 // Rows, directory order
+    uint16_t    *order;                 // Entry of each row, sorted
+    DIR         *mark;                  // DIR before entry n * DIR_CURSOR_STEP
+    WORD         fs_id;                 // Mount the listing was read from
+    uint32_t     gen;                   // Scan number, for the name cache
+    uint32_t     used;                  // LRU stamp
+} dir_listing_t;
+
+// Listing of path, from the cache or scanned now (one pass over the
+// directory, plus one more per DIR_CURSOR_KEY name bytes that sorting
+// needs to tell names apart). FR_NOT_ENOUGH_CORE: no heap for it.
+FRESULT dir_cursor_open(dir_listing_t **listing, const char *path);
+
+// Drop the cached listing of path (entries added, renamed or deleted), or
+// all of them with NULL
+void dir_cursor_invalidate(const char *path);
+
+// Sort by name or by time (oldest first), directories first; no card access
+void dir_cursor_sort(dir_listing_t *l, int by_time);
+
+// Entry shown in row
+const dir_entry_t *dir_cursor_entry(const dir_listing_t *l, uint32_t row);
+
+// Read the names of rows first .. first + n - 1 that are not cached yet,
+// in one walk over the directory (n up to DIR_CURSOR_NAMES)
+void dir_cursor_prefetch(dir_listing_t *l, uint32_t first, uint32_t n);
+
+// Full name of row into buf ("?" if it cannot be read)
+void dir_cursor_name(dir_listing_t *l, uint32_t row, char *buf, size_t len);
+
+#endif // DIR_CURSOR_H
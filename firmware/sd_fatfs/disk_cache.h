@@ -0,0 +1,39 @@
+//==============================================================================
+// diskio Sector Cache - Statistics and Control
+//
+// N-way LRU cache of 512-byte sectors inside diskio.c (Kconfig "Storage
+// (SD/FatFS)", CONFIG_SD_CACHE). Without the cache these calls are no-ops
+// and the statistics stay zero.
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+
+#ifndef DISK_CACHE_H
+#define DISK_CACHE_H
+
+#include <stdint.h>
+
+typedef struct {
+    uint32_t hits;          // Sectors served from the cache
+    uint32_t misses;        // Sectors requested that had to be read
+    uint32_t readahead;     // Extra sectors fetched ahead of a sequential read
+    uint32_t bypass;        // Sectors of large transfers that skipped the cache
+    uint32_t writebacks;    // Dirty sectors written to the card
+} disk_cache_stats_t;
+
+// Configured geometry (0 sectors when the cache is compiled out)
+uint32_t disk_cache_sectors(void);
+uint32_t disk_cache_ways(void);
+
+void disk_cache_get_stats(disk_cache_stats_t *stats);
+void disk_cache_reset_stats(void);
+
+// Write all dirty sectors to the card (what CTRL_SYNC does); 0 on success
+int disk_cache_flush(void);
+
+// Drop every cached sector, dirty or not. Call after writing the card
+// behind diskio's back, or flush first to keep pending writes.
+void disk_cache_invalidate(void);
+
+#endif // DISK_CACHE_H
@@ -5,6 +5,12 @@
 #include "ff.h"
 #include "diskio.h"
 #include "sd_spi.h"
+#include "disk_cache.h"
+#include <string.h>
+#ifdef CONFIG_SD_RAMDISK
+#include "ramdisk.h"
+#include "../overlay_sdk/common/memory_config.h"
+#endif
 
 //==============================================================================
 // Multi-Partition Configuration
@@ -31,14 +37,404 @@
 // Note: This means cards MUST have an MBR. For simple cards without partitions,
 //       the intelligent mount code in sd_card_manager.c will handle mounting.
 PARTITION VolToPart[] = {
-    {0, 2}    // Logical drive 0 → Physical drive 0, partition 2 (filesystem)
+    {0, 2},   // Logical drive 0 → Physical drive 0, partition 2 (filesystem)
+#ifdef CONFIG_SD_RAMDISK
+    {RAMDISK_PDRV, 0}   // Logical drive 1 → RAM disk, no partition table
+#endif
 };
 
+//==============================================================================
+// Sector Cache (CONFIG_SD_CACHE)
+//==============================================================================
+
+// Set-associative, LRU within a set. Sector s lives in one of the ways of
+// set (s % sets), so a run of up to 'sets' consecutive sectors never
+// competes with itself and can be filled by one CMD18 into the cache lines.
+//
+// Reads: hits are copied out; each run of misses is one multi-block read,
+// extended by the read-ahead when it continues the previous request.
+// Writes: single sectors (FatFS's FAT, directory and partial data sectors)
+// are allocated in the cache and marked dirty; CTRL_SYNC (f_sync, f_close,
+// f_mkfs) writes them back in sector order, one CMD25 per run.
+// Multi-sector writes and reads larger than 'sets' go straight to the card
+// so bulk file data doesn't evict the metadata.
+
+#ifdef CONFIG_SD_CACHE
+
+#ifndef CONFIG_SD_CACHE_SECTORS
+#define CONFIG_SD_CACHE_SECTORS     32
+#endif
+#ifndef CONFIG_SD_CACHE_WAYS
+#define CONFIG_SD_CACHE_WAYS        4
+#endif
+#ifndef CONFIG_SD_CACHE_READAHEAD
+#define CONFIG_SD_CACHE_READAHEAD   4
+#endif
+
+#define CACHE_LINES     CONFIG_SD_CACHE_SECTORS
+#define CACHE_WAYS      CONFIG_SD_CACHE_WAYS
+#define CACHE_SETS      (CACHE_LINES / CACHE_WAYS)
+
+#if CACHE_LINES % CACHE_WAYS != 0
+#error "CONFIG_SD_CACHE_SECTORS must be a multiple of CONFIG_SD_CACHE_WAYS"
+#endif
+
+#ifdef CONFIG_SD_CACHE_SCRATCHPAD
+#define CACHE_SECTION   __attribute__((section(".fastbss"), aligned(4)))
+#else
+#define CACHE_SECTION   __attribute__((aligned(4)))
+#endif
+
+typedef struct {
+    LBA_t    sector;
+    uint32_t lru;           // cache_clock at last use
+    uint8_t  valid;
+    uint8_t  dirty;
+} cache_tag_t;
+
+static uint8_t cache_data[CACHE_LINES][512] CACHE_SECTION;
+static cache_tag_t cache_tag[CACHE_LINES];
+static uint32_t cache_clock;
+static LBA_t next_sequential;       // Sector after the previous read
+static disk_cache_stats_t cache_stats;
+
+static void cache_touch(int line) {
+    cache_tag[line].lru = ++cache_clock;
+}
+
+// Line holding sector, or -1
+static int cache_lookup(LBA_t sector) {
+    int base = (int)(sector % CACHE_SETS) * CACHE_WAYS;
+
+    for (int way = 0; way < CACHE_WAYS; way++) {
+        if (cache_tag[base + way].valid && cache_tag[base + way].sector == sector) {
+            return base + way;
+        }
+    }
+    return -1;
+}
+
+// Free (invalid) line for sector: an empty way, else the least recently
+// used one, written back first if dirty. -1 if the write-back failed.
+static int cache_victim(LBA_t sector) {
+    int base = (int)(sector % CACHE_SETS) * CACHE_WAYS;
+    int line = base;
+
+    for (int way = 0; way < CACHE_WAYS; way++) {
+        if (!cache_tag[base + way].valid) {
+            return base + way;
+        }
+        if (cache_tag[base + way].lru < cache_tag[line].lru) {
+            line = base + way;
+        }
+    }
+
+    if (cache_tag[line].dirty) {
+        if (sd_write_block(cache_tag[line].sector, cache_data[line]) != SD_OK) {
+            return -1;
+        }
+        cache_stats.writebacks++;
+    }
+    cache_tag[line].valid = 0;
+    cache_tag[line].dirty = 0;
+    return line;
+}
+
+// Read count (<= CACHE_SETS) consecutive sectors into free lines
+static DRESULT cache_fill(LBA_t sector, UINT count, int *lines) {
+    uint8_t *bufs[CACHE_SETS];
+
+    for (UINT i = 0; i < count; i++) {
+        lines[i] = cache_victim(sector + i);
+        if (lines[i] < 0) {
+            return RES_ERROR;
+        }
+        bufs[i] = cache_data[lines[i]];
+    }
+
+    if (sd_read_blocks_sg(sector, bufs, count) != SD_OK) {
+        return RES_ERROR;
+    }
+
+    for (UINT i = 0; i < count; i++) {
+        cache_tag[lines[i]].sector = sector + i;
+        cache_tag[lines[i]].valid = 1;
+        cache_touch(lines[i]);
+    }
+    return RES_OK;
+}
+
+static DRESULT cache_read(BYTE *buff, LBA_t sector, UINT count) {
+    int lines[CACHE_SETS];
+    LBA_t end = sd_get_sector_count();
+    int sequential = (sector == next_sequential);
+
+    next_sequential = sector + count;
+
+    if (count > CACHE_SETS) {
+        if (sd_read_blocks(sector, buff, count) != SD_OK) {
+            return RES_ERROR;
+        }
+        // Pending writes are newer than the card
+        for (UINT i = 0; i < count; i++) {
+            int line = cache_lookup(sector + i);
+            if (line >= 0 && cache_tag[line].dirty) {
+                memcpy(buff + i * 512, cache_data[line], 512);
+            }
+        }
+        cache_stats.bypass += count;
+        return RES_OK;
+    }
+
+    for (UINT i = 0; i < count; ) {
+        int line = cache_lookup(sector + i);
+        UINT run, ahead = 0;
+
+        if (line >= 0) {
+            memcpy(buff + i * 512, cache_data[line], 512);
+            cache_touch(line);
+            cache_stats.hits++;
+            i++;
+            continue;
+        }
+
+        run = 1;
+        while (i + run < count && cache_lookup(sector + i + run) < 0) {
+            run++;
+        }
+
+        // Sequential reader: fetch the next sectors in the same CMD18
+        if (sequential && i + run == count) {
+            while (ahead < CONFIG_SD_CACHE_READAHEAD && run + ahead < CACHE_SETS &&
+                   (end == 0 || sector + count + ahead < end) &&
+                   cache_lookup(sector + count + ahead) < 0) {
+                ahead++;
+            }
+        }
+
+        if (cache_fill(sector + i, run + ahead, lines) != RES_OK) {
+            return RES_ERROR;
+        }
+        for (UINT j = 0; j < run; j++) {
+            memcpy(buff + (i + j) * 512, cache_data[lines[j]], 512);
+        }
+        cache_stats.misses += run;
+        cache_stats.readahead += ahead;
+        i += run;
+    }
+
+    return RES_OK;
+}
+
+#if FF_FS_READONLY == 0
+
+static DRESULT cache_write(const BYTE *buff, LBA_t sector, UINT count) {
+    // Streaming data (f_write of whole sectors, log_writer): one CMD25
+    if (count > 1) {
+        if (sd_write_blocks(sector, buff, count) != SD_OK) {
+            return RES_ERROR;
+        }
+        // Cached copies now match the card
+        for (UINT i = 0; i < count; i++) {
+            int line = cache_lookup(sector + i);
+            if (line >= 0) {
+                memcpy(cache_data[line], buff + i * 512, 512);
+                cache_tag[line].dirty = 0;
+            }
+        }
+        cache_stats.bypass += count;
+        return RES_OK;
+    }
+
+    int line = cache_lookup(sector);
+
+    if (line < 0) {
+        line = cache_victim(sector);
+        if (line < 0) {
+            return RES_ERROR;
+        }
+        cache_tag[line].sector = sector;
+        cache_tag[line].valid = 1;
+    }
+    memcpy(cache_data[line], buff, 512);
+    cache_tag[line].dirty = 1;
+    cache_touch(line);
+
+    return RES_OK;
+}
+
+#endif
+
+int disk_cache_flush(void) {
+    int dirty[CACHE_LINES];
+    const uint8_t *bufs[CACHE_SETS];
+    int n = 0;
+
+    // Dirty lines in sector order (insertion sort, the list is short)
+    for (int line = 0; line < CACHE_LINES; line++) {
+        if (cache_tag[line].valid && cache_tag[line].dirty) {
+            int j = n++;
+            while (j > 0 && cache_tag[dirty[j - 1]].sector > cache_tag[line].sector) {
+                dirty[j] = dirty[j - 1];
+                j--;
+            }
+            dirty[j] = line;
+        }
+    }
+
+    // One CMD25 per run of consecutive sectors (a run is at most CACHE_SETS,
+    // consecutive sectors are in different sets)
+    for (int i = 0; i < n; ) {
+        int run = 1;
+
+        bufs[0] = cache_data[dirty[i]];
+        while (i + run < n && run < CACHE_SETS &&
+               cache_tag[dirty[i + run]].sector == cache_tag[dirty[i]].sector + run) {
+            bufs[run] = cache_data[dirty[i + run]];
+            run++;
+        }
+
+        if (sd_write_blocks_sg(cache_tag[dirty[i]].sector, bufs, run) != SD_OK) {
+            return -1;
+        }
+        for (int j = 0; j < run; j++) {
+            cache_tag[dirty[i + j]].dirty = 0;
+        }
+        cache_stats.writebacks += run;
+        i += run;
+    }
+
+    return 0;
+}
+
+void disk_cache_invalidate(void) {
+    memset(cache_tag, 0, sizeof(cache_tag));
+    next_sequential = (LBA_t)-1;
+}
+
+// Drop sectors first..last (freed by TRIM), pending writes included
+static void cache_discard(LBA_t first, LBA_t last) {
+    for (int line = 0; line < CACHE_LINES; line++) {
+        if (cache_tag[line].valid && cache_tag[line].sector >= first &&
+            cache_tag[line].sector <= last) {
+            cache_tag[line].valid = 0;
+            cache_tag[line].dirty = 0;
+        }
+    }
+}
+
+uint32_t disk_cache_sectors(void) {
+    return CACHE_LINES;
+}
+
+uint32_t disk_cache_ways(void) {
+    return CACHE_WAYS;
+}
+
+void disk_cache_get_stats(disk_cache_stats_t *stats) {
+    *stats = cache_stats;
+}
+
+void disk_cache_reset_stats(void) {
+    memset(&cache_stats, 0, sizeof(cache_stats));
+}
+
+#else
+
+int disk_cache_flush(void) {
+    return 0;
+}
+
+void disk_cache_invalidate(void) {
+}
+
+uint32_t disk_cache_sectors(void) {
+    return 0;
+}
+
+uint32_t disk_cache_ways(void) {
+    return 0;
+}
+
+void disk_cache_get_stats(disk_cache_stats_t *stats) {
+    memset(stats, 0, sizeof(*stats));
+}
+
+void disk_cache_reset_stats(void) {
+}
+
+#endif // CONFIG_SD_CACHE
+
+//==============================================================================
+// RAM Disk (CONFIG_SD_RAMDISK)
+//==============================================================================
+
+// Physical drive 1: RAMDISK_SIZE bytes of SRAM at RAMDISK_BASE
+// (overlay_sdk/common/memory_config.h), sector N at RAMDISK_BASE + N * 512.
+// Initializing it lowers the heap limit to RAMDISK_BASE; it fails if the
+// heap has already grown into the region.
+
+#ifdef CONFIG_SD_RAMDISK
+
+#define RAM_SECTORS     (RAMDISK_SIZE / 512)
+
+extern int heap_set_limit(void *limit);
+
+static uint8_t ram_ready;
+
+static uint8_t *ram_sector(LBA_t sector) {
+    return (uint8_t *)RAMDISK_BASE + sector * 512;
+}
+
+static DRESULT ram_check(LBA_t sector, UINT count) {
+    if (!ram_ready) {
+        return RES_NOTRDY;
+    }
+    if (count == 0 || sector >= RAM_SECTORS || count > RAM_SECTORS - sector) {
+        return RES_PARERR;
+    }
+    return RES_OK;
+}
+
+static DRESULT ram_ioctl(BYTE cmd, void *buff) {
+    if (!ram_ready) {
+        return RES_NOTRDY;
+    }
+
+    switch (cmd) {
+        case CTRL_SYNC:
+        case CTRL_TRIM:
+            return RES_OK;
+
+        case GET_SECTOR_COUNT:
+            *(LBA_t*)buff = RAM_SECTORS;
+            return RES_OK;
+
+        case GET_SECTOR_SIZE:
+            *(WORD*)buff = 512;
+            return RES_OK;
+
+        case GET_BLOCK_SIZE:
+            *(DWORD*)buff = 1;
+            return RES_OK;
+
+        default:
+            return RES_PARERR;
+    }
+}
+
+#endif // CONFIG_SD_RAMDISK
+
 //==============================================================================
 // Disk Status
 //==============================================================================
 
 DSTATUS disk_status(BYTE pdrv) {
+#ifdef CONFIG_SD_RAMDISK
+    if (pdrv == RAMDISK_PDRV) {
+        return ram_ready ? 0 : STA_NOINIT;
+    }
+#endif
     if (pdrv != 0) {
         return STA_NOINIT;
     }
@@ -56,16 +452,36 @@ DSTATUS disk_status(BYTE pdrv) {
 //==============================================================================
 
 DSTATUS disk_initialize(BYTE pdrv) {
+#ifdef CONFIG_SD_RAMDISK
+    if (pdrv == RAMDISK_PDRV) {
+        // Contents are kept: whatever was staged before a reset is still there
+        if (!ram_ready && heap_set_limit((void *)RAMDISK_BASE) == 0) {
+            ram_ready = 1;
+        }
+        return ram_ready ? 0 : STA_NOINIT;
+    }
+#endif
     if (pdrv != 0) {
         return STA_NOINIT;
     }
 
     // Check if card is already initialized
     if (sd_get_card_type() != CARD_TYPE_UNKNOWN) {
+        // Remount: write out what's pending, start clean
+        disk_cache_flush();
+        disk_cache_invalidate();
         return 0;  // Already initialized, OK
     }
 
-    // Initialize card if not already done
+    // Initialize card if not already done (cached sectors belong to the old card)
+    disk_cache_invalidate();
+
+    // The hot-plug poller brings a new card up in the background: no
+    // blocking init here, a missing card fails at once
+    if (sd_hotplug_active()) {
+        return STA_NOINIT;
+    }
+
     uint8_t result = sd_init();
     if (result != SD_OK) {
         return STA_NOINIT;
@@ -84,6 +500,15 @@ DRESULT disk_read(
     LBA_t sector,   // Start sector number (LBA)
     UINT count      // Number of sectors to read
 ) {
+#ifdef CONFIG_SD_RAMDISK
+    if (pdrv == RAMDISK_PDRV) {
+        DRESULT res = ram_check(sector, count);
+        if (res == RES_OK) {
+            memcpy(buff, ram_sector(sector), count * 512);
+        }
+        return res;
+    }
+#endif
     if (pdrv != 0 || count == 0) {
         return RES_PARERR;
     }
@@ -92,14 +517,16 @@ DRESULT disk_read(
         return RES_NOTRDY;
     }
 
-    for (UINT i = 0; i < count; i++) {
-        uint8_t result = sd_read_block(sector + i, buff + (i * 512));
-        if (result != SD_OK) {
-            return RES_ERROR;
-        }
+#ifdef CONFIG_SD_CACHE
+    return cache_read(buff, sector, count);
+#else
+    // Multi-sector requests go out as one CMD18 stream
+    if (sd_read_blocks(sector, buff, count) != SD_OK) {
+        return RES_ERROR;
     }
 
     return RES_OK;
+#endif
 }
 
 //==============================================================================
@@ -114,6 +541,15 @@ DRESULT disk_write(
     LBA_t sector,       // Start sector number (LBA)
     UINT count          // Number of sectors to write
 ) {
+#ifdef CONFIG_SD_RAMDISK
+    if (pdrv == RAMDISK_PDRV) {
+        DRESULT res = ram_check(sector, count);
+        if (res == RES_OK) {
+            memcpy(ram_sector(sector), buff, count * 512);
+        }
+        return res;
+    }
+#endif
     if (pdrv != 0 || count == 0) {
         return RES_PARERR;
     }
@@ -122,14 +558,16 @@ DRESULT disk_write(
         return RES_NOTRDY;
     }
 
-    for (UINT i = 0; i < count; i++) {
-        uint8_t result = sd_write_block(sector + i, buff + (i * 512));
-        if (result != SD_OK) {
-            return RES_ERROR;
-        }
+#ifdef CONFIG_SD_CACHE
+    return cache_write(buff, sector, count);
+#else
+    // Multi-sector requests go out as one CMD25 stream
+    if (sd_write_blocks(sector, buff, count) != SD_OK) {
+        return RES_ERROR;
     }
 
     return RES_OK;
+#endif
 }
 
 #endif
@@ -143,6 +581,11 @@ DRESULT disk_ioctl(
     BYTE cmd,       // Control code
     void *buff      // Buffer to send/receive data
 ) {
+#ifdef CONFIG_SD_RAMDISK
+    if (pdrv == RAMDISK_PDRV) {
+        return ram_ioctl(cmd, buff);
+    }
+#endif
     if (pdrv != 0) {
         return RES_PARERR;
     }
@@ -153,8 +596,8 @@ DRESULT disk_ioctl(
 
     switch (cmd) {
         case CTRL_SYNC:
-            // No cache, operation completes immediately
-            return RES_OK;
+            // Write back dirty cached sectors (no-op without the cache)
+            return disk_cache_flush() == 0 ? RES_OK : RES_ERROR;
 
         case GET_SECTOR_COUNT:
             *(LBA_t*)buff = sd_get_sector_count();
@@ -168,6 +611,16 @@ DRESULT disk_ioctl(
             *(DWORD*)buff = 1;  // Erase block size in sectors
             return RES_OK;
 
+        case CTRL_TRIM: {
+            // Freed clusters (f_unlink, f_truncate) and f_mkfs's whole
+            // volume: erased so later writes find clean flash
+            const LBA_t *range = (const LBA_t*)buff;
+#ifdef CONFIG_SD_CACHE
+            cache_discard(range[0], range[1]);
+#endif
+            return sd_erase_blocks(range[0], range[1]) == SD_OK ? RES_OK : RES_ERROR;
+        }
+
         default:
             return RES_PARERR;
     }
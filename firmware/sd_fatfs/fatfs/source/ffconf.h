@@ -31,10 +31,10 @@
 #define FF_USE_MKFS		1
 /* This option switches f_mkfs() function. (0:Disable or 1:Enable) */
 
-#define FF_USE_FASTSEEK	0
+#define FF_USE_FASTSEEK	1
 /* This option switches fast seek function. (0:Disable or 1:Enable) */
 
-#define FF_USE_EXPAND	0
+#define FF_USE_EXPAND	1
 /* This option switches f_expand function. (0:Disable or 1:Enable) */
 
 #define FF_USE_CHMOD	0
@@ -101,8 +101,16 @@
 /     0 - Include all code pages above and configured by f_setcp()
 */
 
+#ifdef CONFIG_SD_FATFS_COMPACT
+/* Compact build (Kconfig "Compact FatFS build"): static working buffer, names up
+/  to CONFIG_SD_FATFS_MAX_LFN characters. Longer names read back as their 8.3
+/  alias and cannot be created. */
+#define FF_USE_LFN		1
+#define FF_MAX_LFN		CONFIG_SD_FATFS_MAX_LFN
+#else
 #define FF_USE_LFN		2
 #define FF_MAX_LFN		255
+#endif
 /* The FF_USE_LFN switches the support for LFN (long file name).
 /
 /   0: Disable LFN. FF_MAX_LFN has no effect.
@@ -131,7 +139,7 @@
 /  Also behavior of string I/O functions will be affected by this option.
 /  When LFN is not enabled, this option has no effect. */
 
-#define FF_LFN_BUF		255
+#define FF_LFN_BUF		FF_MAX_LFN
 #define FF_SFN_BUF		12
 /* This set of options defines size of file name members in the FILINFO structure
 /  which is used to read out directory items. These values should be sufficient for
@@ -150,7 +158,12 @@
 / Drive/Volume Configurations
 /----------------------------------------------------------------------------*/
 
+#ifdef CONFIG_SD_RAMDISK
+/* Volume 1: RAM disk in SRAM (Kconfig "RAM disk volume", sd_fatfs/ramdisk.c) */
+#define FF_VOLUMES		2
+#else
 #define FF_VOLUMES		1
+#endif
 /* Number of volumes (logical drives) to be used. (1-10) */
 
 #define FF_STR_VOLUME_ID	0
@@ -183,7 +196,11 @@
 /  for variable sector size mode and disk_ioctl() function needs to implement
 /  GET_SECTOR_SIZE command. */
 
+#if defined(CONFIG_SD_FATFS_COMPACT) && !defined(CONFIG_SD_FATFS_EXFAT)
+#define FF_LBA64		0
+#else
 #define FF_LBA64		1
+#endif
 /* This option switches support for 64-bit LBA. (0:Disable or 1:Enable)
 /  To enable the 64-bit LBA, also exFAT needs to be enabled. (FF_FS_EXFAT == 1) */
 
@@ -191,7 +208,7 @@
 /* Minimum number of sectors to switch GPT as partitioning format in f_mkfs and
 /  f_fdisk function. 0x100000000 max. This option has no effect when FF_LBA64 == 0. */
 
-#define FF_USE_TRIM		0
+#define FF_USE_TRIM		1
 /* This option switches ATA-TRIM function. (0:Disable or 1:Enable)
 /  To enable Trim function, also CTRL_TRIM command should be implemented to the
 /  disk_ioctl() function. */
@@ -206,7 +223,11 @@
 /  Instead of private sector buffer eliminated from the file object, common sector
 /  buffer in the filesystem object (FATFS) is used for the file data transfer. */
 
+#if defined(CONFIG_SD_FATFS_COMPACT) && !defined(CONFIG_SD_FATFS_EXFAT)
+#define FF_FS_EXFAT		0
+#else
 #define FF_FS_EXFAT		1
+#endif
 /* This option switches support for exFAT filesystem. (0:Disable or 1:Enable)
 /  To enable exFAT, also LFN needs to be enabled. (FF_USE_LFN >= 1)
 /  Note that enabling exFAT discards ANSI C (C89) compatibility. */
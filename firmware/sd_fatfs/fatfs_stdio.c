@@ -0,0 +1,212 @@
+//==============================================================================
+// FatFS Files behind open()/fopen()
+//
+// lib/syscalls.c passes each descriptor >= SYSCALLS_FD_FIRST here as a
+// handle into a static FIL pool. Reads and writes go straight to
+// f_read()/f_write() with the caller's buffer: newlib's stdio buffer
+// (st_blksize from fstat) or the whole request for large fread()/fwrite().
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+
+#include "fatfs_stdio.h"
+#include "../../lib/syscalls_fs.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+static FIL files[FATFS_STDIO_FILES];
+static uint8_t in_use[FATFS_STDIO_FILES];
+
+// FRESULT -> errno
+static const uint8_t fr_errno[] = {
+    [FR_OK]                  = 0,
+    [FR_DISK_ERR]            = EIO,
+    [FR_INT_ERR]             = EIO,
+    [FR_NOT_READY]           = EIO,
+    [FR_NO_FILE]             = ENOENT,
+    [FR_NO_PATH]             = ENOENT,
+    [FR_INVALID_NAME]        = EINVAL,
+    [FR_DENIED]              = EACCES,
+    [FR_EXIST]               = EEXIST,
+    [FR_INVALID_OBJECT]      = EBADF,
+    [FR_WRITE_PROTECTED]     = EROFS,
+    [FR_INVALID_DRIVE]       = ENXIO,
+    [FR_NOT_ENABLED]         = ENODEV,
+    [FR_NO_FILESYSTEM]       = ENODEV,
+    [FR_MKFS_ABORTED]        = EIO,
+    [FR_TIMEOUT]             = EBUSY,
+    [FR_LOCKED]              = EBUSY,
+    [FR_NOT_ENOUGH_CORE]     = ENOMEM,
+    [FR_TOO_MANY_OPEN_FILES] = EMFILE,
+    [FR_INVALID_PARAMETER]   = EINVAL,
+};
+
+static int fail(FRESULT fr) {
+    errno = fr < sizeof(fr_errno) ? fr_errno[fr] : EIO;
+    return -1;
+}
+
+static FIL *handle_fil(int handle) {
+    if (handle < 0 || handle >= FATFS_STDIO_FILES || !in_use[handle]) {
+        errno = EBADF;
+        return NULL;
+    }
+    return &files[handle];
+}
+
+//==============================================================================
+// Backend
+//==============================================================================
+
+static int fs_open(const char *path, int flags, int mode) {
+    BYTE fa = 0;
+    FRESULT fr;
+    int h;
+
+    (void)mode;     // FAT has no permissions
+
+    for (h = 0; h < FATFS_STDIO_FILES && in_use[h]; h++) {
+    }
+    if (h == FATFS_STDIO_FILES) {
+        errno = EMFILE;
+        return -1;
+    }
+
+    switch (flags & O_ACCMODE) {
+    case O_RDONLY: fa = FA_READ; break;
+    case O_WRONLY: fa = FA_WRITE; break;
+    default:       fa = FA_READ | FA_WRITE; break;
+    }
+
+    if ((flags & (O_CREAT | O_EXCL)) == (O_CREAT | O_EXCL)) {
+        fa |= FA_CREATE_NEW;
+    } else if ((flags & (O_CREAT | O_TRUNC)) == (O_CREAT | O_TRUNC)) {
+        fa |= FA_CREATE_ALWAYS;
+    } else if (flags & O_APPEND) {
+        fa |= (flags & O_CREAT) ? FA_OPEN_APPEND : FA_OPEN_EXISTING;
+    } else if (flags & O_CREAT) {
+        fa |= FA_OPEN_ALWAYS;
+    }
+
+    fr = f_open(&files[h], path, fa);
+    if (fr == FR_OK && (flags & O_TRUNC) && !(flags & O_CREAT)) {
+        fr = f_truncate(&files[h]);
+        if (fr != FR_OK) {
+            f_close(&files[h]);
+        }
+    }
+    if (fr == FR_OK && (flags & O_APPEND) && !(flags & O_CREAT)) {
+        fr = f_lseek(&files[h], f_size(&files[h]));
+        if (fr != FR_OK) {
+            f_close(&files[h]);
+        }
+    }
+    if (fr != FR_OK) {
+        return fail(fr);
+    }
+
+    in_use[h] = 1;
+    return h;
+}
+
+static int fs_close(int handle) {
+    FIL *fp = handle_fil(handle);
+    if (!fp) {
+        return -1;
+    }
+
+    in_use[handle] = 0;
+    FRESULT fr = f_close(fp);
+    return fr == FR_OK ? 0 : fail(fr);
+}
+
+static int fs_read(int handle, void *buf, int len) {
+    FIL *fp = handle_fil(handle);
+    UINT br;
+
+    if (!fp) {
+        return -1;
+    }
+
+    FRESULT fr = f_read(fp, buf, len, &br);
+    return fr == FR_OK ? (int)br : fail(fr);
+}
+
+static int fs_write(int handle, const void *buf, int len) {
+    FIL *fp = handle_fil(handle);
+    UINT bw;
+
+    if (!fp) {
+        return -1;
+    }
+
+    FRESULT fr = f_write(fp, buf, len, &bw);
+    if (fr != FR_OK) {
+        return fail(fr);
+    }
+    if (bw == 0 && len > 0) {
+        errno = ENOSPC;     // Volume full
+        return -1;
+    }
+    return bw;
+}
+
+static int fs_lseek(int handle, int offset, int whence) {
+    FIL *fp = handle_fil(handle);
+    FSIZE_t base;
+
+    if (!fp) {
+        return -1;
+    }
+
+    switch (whence) {
+    case SEEK_SET: base = 0; break;
+    case SEEK_CUR: base = f_tell(fp); break;
+    case SEEK_END: base = f_size(fp); break;
+    default:
+        errno = EINVAL;
+        return -1;
+    }
+    if (offset < 0 && (FSIZE_t)-offset > base) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    // Past the end extends the file in write mode (FatFS), like POSIX holes
+    FRESULT fr = f_lseek(fp, base + offset);
+    return fr == FR_OK ? (int)f_tell(fp) : fail(fr);
+}
+
+static int fs_size(int handle) {
+    FIL *fp = handle_fil(handle);
+
+    return fp ? (int)f_size(fp) : -1;
+}
+
+static const syscalls_fs_t fatfs_stdio = {
+    .open  = fs_open,
+    .close = fs_close,
+    .read  = fs_read,
+    .write = fs_write,
+    .lseek = fs_lseek,
+    .size  = fs_size,
+};
+
+//==============================================================================
+// Public API
+//==============================================================================
+
+void fatfs_stdio_init(void) {
+    syscalls_set_fs(&fatfs_stdio);
+}
+
+FIL *fatfs_stdio_fil(int fd) {
+    int handle = fd - SYSCALLS_FD_FIRST;
+
+    if (handle < 0 || handle >= FATFS_STDIO_FILES || !in_use[handle]) {
+        return NULL;
+    }
+    return &files[handle];
+}
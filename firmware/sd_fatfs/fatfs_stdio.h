@@ -0,0 +1,34 @@
+//==============================================================================
+// FatFS Files behind open()/fopen() (lib/syscalls_fs.h backend)
+//
+// Usage:
+//   static FATFS fs;
+//   fatfs_stdio_init();
+//   f_mount(&fs, "", 1);
+//   FILE *f = fopen("LOG.TXT", "a");
+//   fprintf(f, "boot %lu\n", count);
+//   fclose(f);
+//
+// Up to FATFS_STDIO_FILES files are open at once (static FIL pool, no
+// malloc). fopen() modes map to FatFS as "r" FA_READ, "w" FA_CREATE_ALWAYS,
+// "a" FA_OPEN_APPEND, "+" adds the other direction; O_EXCL is
+// FA_CREATE_NEW. FatFS errors come back as errno values.
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+
+#ifndef FATFS_STDIO_H
+#define FATFS_STDIO_H
+
+#include "ff.h"
+
+#define FATFS_STDIO_FILES   4
+
+// Install the backend (syscalls_set_fs()); mount the volume separately
+void fatfs_stdio_init(void);
+
+// FIL behind a descriptor from open() / fileno(), NULL if there is none
+FIL *fatfs_stdio_fil(int fd);
+
+#endif // FATFS_STDIO_H
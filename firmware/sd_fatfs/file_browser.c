@@ -10,17 +10,24 @@
 // - Sort by name or time
 // - CRC32 checksum calculation
 // - Total directory size display
+// - Directories of any size: listings through dir_cursor.c, names read for
+//   the visible rows only, the last few directories kept in RAM
 //
 // Copyright (c) October 2025 Michael Wolak
 // Email: mikewolak@gmail.com, mike@epromfoundry.com
 //==============================================================================
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
 #include "../../lib/incurses/curses.h"
+#include "../../lib/crc32.h"
+#include "../../lib/perf_counters.h"
 #include "ff.h"
 #include "file_browser.h"
+#include "dir_cursor.h"
+#include "overlay_loader.h"
 #include "hardware.h"
 
 //==============================================================================
@@ -28,211 +35,133 @@
 //==============================================================================
 
 extern uint8_t g_card_mounted;
+void format_bytes_per_sec(uint32_t bytes_per_sec, char *buf, int buf_size);
 
 //==============================================================================
-// Arrow Key Helper - Detects ESC [ A/B sequences from arrow keys
+// CRC32 Functions (lib/crc32.h)
 //==============================================================================
 
-static int get_key_with_arrows(void) {
-    int ch = getch();
+#define CRC_CHUNK       (32 * 1024)     // Bytes per read, whole sectors
+#define CRC_CHUNK_MIN   4096            // When the heap has no CRC_CHUNK
 
-    if (ch == 27) {  // ESC - could be arrow key sequence or just ESC
-        // Check if this is an arrow key (ESC [ X) or just ESC
-        timeout(10);  // Brief timeout to check for following characters
-        int ch2 = getch();
-        if (ch2 == '[') {
-            int ch3 = getch();
-            timeout(-1);
-            if (ch3 == 'A') return KEY_UP;       // Up arrow
-            else if (ch3 == 'B') return KEY_DOWN;  // Down arrow
-            else if (ch3 == 'C') return KEY_RIGHT; // Right arrow
-            else if (ch3 == 'D') return KEY_LEFT;  // Left arrow
-            else return 27;  // Unknown escape sequence, return ESC
-        } else {
-            timeout(-1);
-            return 27;  // Just ESC key
-        }
-    }
-    return ch;
-}
-
-//==============================================================================
-// CRC32 Functions (adapted from overlay_upload.c)
-//==============================================================================
-
-static uint32_t crc32_table[256];
-static uint8_t crc32_initialized = 0;
+typedef struct {
+    uint32_t crc;
+    uint32_t bytes;
+    uint64_t read_cycles;               // In overlay_file_read()
+    uint64_t crc_cycles;                // In crc32_update()
+    FRESULT fr;
+} file_crc_t;
+
+// CRC32 of a file: large reads through the fast-seek path (one multi-block
+// read per fragment, straight into the buffer, no FatFS window copy), then
+// the CRC accelerator over the buffer. Progress goes to row progress_row.
+static void calculate_file_crc32(const char *filename, int progress_row, file_crc_t *r) {
+    overlay_file_t file;
+    uint32_t chunk = CRC_CHUNK;
+    uint32_t size, t0, t1, t2;
+    uint8_t *buffer;
+    UINT br;
 
-static void crc32_init(void) {
-    if (crc32_initialized) return;
+    memset(r, 0, sizeof(*r));
 
-    for (uint32_t i = 0; i < 256; i++) {
-        uint32_t crc = i;
-        for (int j = 0; j < 8; j++) {
-            if (crc & 1) {
-                crc = (crc >> 1) ^ 0xEDB88320;
-            } else {
-                crc = crc >> 1;
-            }
+    buffer = malloc(chunk);
+    if (buffer == NULL) {
+        chunk = CRC_CHUNK_MIN;
+        buffer = malloc(chunk);
+        if (buffer == NULL) {
+            r->fr = FR_NOT_ENOUGH_CORE;
+            return;
         }
-        crc32_table[i] = crc;
     }
-    crc32_initialized = 1;
-}
 
-static uint32_t calculate_file_crc32(const char *filename) {
-    FIL file;
-    FRESULT fr = f_open(&file, filename, FA_READ);
-    if (fr != FR_OK) {
-        return 0;
+    r->fr = overlay_file_open(&file, filename);
+    if (r->fr != FR_OK) {
+        free(buffer);
+        return;
     }
-
-    uint32_t crc = 0xFFFFFFFF;
-    uint8_t buffer[512];
-    UINT br;
+    size = (uint32_t)f_size(&file.fil);
 
     while (1) {
-        fr = f_read(&file, buffer, sizeof(buffer), &br);
-        if (fr != FR_OK || br == 0) break;
-
-        for (UINT i = 0; i < br; i++) {
-            crc = (crc >> 8) ^ crc32_table[(crc ^ buffer[i]) & 0xFF];
+        t0 = rdcycle();
+        r->fr = overlay_file_read(&file, buffer, chunk, &br);
+        t1 = rdcycle();
+        if (r->fr != FR_OK || br == 0) break;
+
+        r->crc = crc32_update(r->crc, buffer, br);
+        t2 = rdcycle();
+
+        r->read_cycles += t1 - t0;
+        r->crc_cycles += t2 - t1;
+        r->bytes += br;
+
+        // Every 1 MB: large images take a while
+        if (progress_row >= 0 && (r->bytes % (1024 * 1024) < chunk || r->bytes == size)) {
+            char buf[48];
+            snprintf(buf, sizeof(buf), "%lu / %lu KB",
+                     (unsigned long)(r->bytes / 1024), (unsigned long)(size / 1024));
+            move(progress_row, 0);
+            addstr(buf);
+            clrtoeol();
+            refresh();
         }
     }
 
-    f_close(&file);
-    return ~crc;
+    overlay_file_close(&file);
+    free(buffer);
+}
+
+// "12.3 ms, 1.5 MB/s" for bytes in cycles
+static void format_rate(uint32_t bytes, uint64_t cycles, char *buf, int buf_size) {
+    uint64_t us = cycles / (PERF_CPU_HZ / 1000000UL);
+    char rate[24];
+
+    format_bytes_per_sec(us ? (uint32_t)((uint64_t)bytes * 1000000 / us) : 0, rate, sizeof(rate));
+    snprintf(buf, buf_size, "%lu.%01lu ms, %s",
+             (unsigned long)(us / 1000), (unsigned long)(us % 1000 / 100), rate);
 }
 
 //==============================================================================
 // File List Management
 //==============================================================================
 
-#define MAX_FILES 64  // Reduced to fit long filenames in BSS
-
-static FileEntry file_list[MAX_FILES];
+// Listing of current_path (dir_cursor.c): compact entries, names read for
+// the rows on screen only, the last few directories kept
+static dir_listing_t *listing = NULL;
 static int num_files = 0;
 static int sort_by_time = 0;  // 0 = sort by name, 1 = sort by time
 static char current_path[256] = "/";
 
-// Compare functions for sorting
-static int compare_by_name(const void *a, const void *b) {
-    const FileEntry *fa = (const FileEntry *)a;
-    const FileEntry *fb = (const FileEntry *)b;
-
-    // Directories first
-    if (fa->is_dir && !fb->is_dir) return -1;
-    if (!fa->is_dir && fb->is_dir) return 1;
-
-    // Then by name
-    return strcmp(fa->name, fb->name);
-}
-
-static int compare_by_time(const void *a, const void *b) {
-    const FileEntry *fa = (const FileEntry *)a;
-    const FileEntry *fb = (const FileEntry *)b;
-
-    // Directories first
-    if (fa->is_dir && !fb->is_dir) return -1;
-    if (!fa->is_dir && fb->is_dir) return 1;
-
-    // Then by time (oldest first, newest last)
-    if (fa->date != fb->date) {
-        return (fa->date < fb->date) ? -1 : 1;
-    }
-    return (fa->time < fb->time) ? -1 : 1;
-}
-
-// Simplified qsort implementation for embedded systems
-static void swap_entries(FileEntry *a, FileEntry *b) {
-    FileEntry temp = *a;
-    *a = *b;
-    *b = temp;
-}
-
-static void quicksort(FileEntry *arr, int low, int high, int (*cmp)(const void*, const void*)) {
-    if (low < high) {
-        FileEntry pivot = arr[high];
-        int i = low - 1;
-
-        for (int j = low; j < high; j++) {
-            if (cmp(&arr[j], &pivot) < 0) {
-                i++;
-                swap_entries(&arr[i], &arr[j]);
-            }
-        }
-        swap_entries(&arr[i + 1], &arr[high]);
-        int pi = i + 1;
-
-        quicksort(arr, low, pi - 1, cmp);
-        quicksort(arr, pi + 1, high, cmp);
-    }
-}
-
-static void sort_file_list(void) {
-    if (num_files > 1) {
-        if (sort_by_time) {
-            quicksort(file_list, 0, num_files - 1, compare_by_time);
-        } else {
-            quicksort(file_list, 0, num_files - 1, compare_by_name);
-        }
-    }
-}
-
 //==============================================================================
 // Directory Scanning
 //==============================================================================
 
+// From the cache when the directory was listed before
 static int scan_directory(const char *path) {
-    DIR dir;
-    FILINFO fno;
-    FRESULT fr;
+    FRESULT fr = dir_cursor_open(&listing, path);
 
     num_files = 0;
-
-    fr = f_opendir(&dir, path);
     if (fr != FR_OK) {
+        listing = NULL;
         return -1;
     }
-
-    // Add ".." entry if not at root
-    if (strcmp(path, "/") != 0) {
-        FileEntry *entry = &file_list[num_files];
-        strcpy(entry->name, "..");
-        entry->size = 0;
-        entry->date = 0;
-        entry->time = 0;
-        entry->attrib = AM_DIR;
-        entry->is_dir = 1;
-        num_files++;
+    if (listing->by_time != sort_by_time) {
+        dir_cursor_sort(listing, sort_by_time);
     }
+    num_files = (int)listing->count;
 
-    while (num_files < MAX_FILES) {
-        fr = f_readdir(&dir, &fno);
-        if (fr != FR_OK || fno.fname[0] == 0) break;
-
-        // Skip "." entry (current dir - not useful in list)
-        if (strcmp(fno.fname, ".") == 0) continue;
-
-        // Store file info
-        FileEntry *entry = &file_list[num_files];
-        strncpy(entry->name, fno.fname, sizeof(entry->name) - 1);
-        entry->name[sizeof(entry->name) - 1] = '\0';
-        entry->size = (uint32_t)fno.fsize;
-        entry->date = fno.fdate;
-        entry->time = fno.ftime;
-        entry->attrib = fno.fattrib;
-        entry->is_dir = (fno.fattrib & AM_DIR) ? 1 : 0;
-
-        num_files++;
-    }
-
-    f_closedir(&dir);
+    return num_files;
+}
 
-    // Sort the list
-    sort_file_list();
+// After a change to the directory
+static int rescan_directory(const char *path) {
+    dir_cursor_invalidate(path);
+    return scan_directory(path);
+}
 
-    return num_files;
+// Name of the entry in row into buf
+static const dir_entry_t *get_entry(int row, char *name, size_t len) {
+    dir_cursor_name(listing, (uint32_t)row, name, len);
+    return dir_cursor_entry(listing, (uint32_t)row);
 }
 
 //==============================================================================
@@ -267,15 +196,9 @@ static void format_datetime(uint16_t date, uint16_t time, char *buf, int buf_siz
              year, month, day, hour, min, sec);
 }
 
-// Calculate total directory size
+// Total directory size (summed by the scan)
 static uint32_t calculate_dir_size(void) {
-    uint32_t total = 0;
-    for (int i = 0; i < num_files; i++) {
-        if (!file_list[i].is_dir) {
-            total += file_list[i].size;
-        }
-    }
-    return total;
+    return listing ? listing->total : 0;
 }
 
 //==============================================================================
@@ -287,10 +210,16 @@ static void draw_header(void) {
     attron(A_REVERSE);
     addstr("=== FILE BROWSER ===");
     for (int i = 20; i < COLS; i++) addch(' ');
+
+    char buf[128];
+#ifdef INCURSES_STATS
+    // Terminal bytes of the previous frame (make INCURSES_STATS=1)
+    snprintf(buf, sizeof(buf), "%5lu B/frame", (unsigned long)incurses_frame_bytes());
+    mvaddstr(0, COLS - (int)strlen(buf), buf);
+#endif
     standend();
 
     move(1, 0);
-    char buf[128];
     snprintf(buf, sizeof(buf), "Path: %s", current_path);
     addstr(buf);
     clrtoeol();
@@ -299,8 +228,9 @@ static void draw_header(void) {
     uint32_t dir_size = calculate_dir_size();
     char size_buf[32];
     format_size(dir_size, size_buf, sizeof(size_buf));
-    snprintf(buf, sizeof(buf), "Files: %d | Total: %s | Sort: %s",
-             num_files, size_buf, sort_by_time ? "TIME" : "NAME");
+    snprintf(buf, sizeof(buf), "Files: %d%s | Total: %s | Sort: %s",
+             num_files, (listing && listing->truncated) ? "+" : "",
+             size_buf, sort_by_time ? "TIME" : "NAME");
     addstr(buf);
     clrtoeol();
 }
@@ -317,6 +247,11 @@ static void draw_file_list(int selected, int scroll_offset) {
     int display_rows = LINES - 5;  // Header(3) + Footer(2)
     int start_row = 3;
 
+    // Names of all the rows on screen in one walk over the directory
+    if (num_files > 0) {
+        dir_cursor_prefetch(listing, (uint32_t)scroll_offset, (uint32_t)display_rows);
+    }
+
     for (int i = 0; i < display_rows; i++) {
         int file_idx = scroll_offset + i;
         move(start_row + i, 0);
@@ -324,7 +259,8 @@ static void draw_file_list(int selected, int scroll_offset) {
 
         if (file_idx >= num_files) continue;
 
-        FileEntry *entry = &file_list[file_idx];
+        char name[FF_LFN_BUF + 1];
+        const dir_entry_t *entry = get_entry(file_idx, name, sizeof(name));
 
         // Highlight selected
         if (file_idx == selected) {
@@ -346,7 +282,7 @@ static void draw_file_list(int selected, int scroll_offset) {
 
         snprintf(line, sizeof(line), "%c %-12s %12s  %s",
                  entry->is_dir ? 'D' : 'F',
-                 entry->name,
+                 name,
                  size_buf,
                  date_buf);
 
@@ -358,13 +294,24 @@ static void draw_file_list(int selected, int scroll_offset) {
     }
 }
 
+// Scroll the list rows on the terminal itself: the redraw that follows
+// then only sends the row that came in (and the moved highlight)
+static void scroll_file_list(int n) {
+    setscrreg(3, LINES - 3);
+    scrl(n);
+    setscrreg(0, LINES - 1);
+}
+
 //==============================================================================
 // Action Functions
 //==============================================================================
 
 static void show_crc32(int selected) {
     if (selected < 0 || selected >= num_files) return;
-    if (file_list[selected].is_dir) return;
+    char name[FF_LFN_BUF + 1];
+    const dir_entry_t *entry = get_entry(selected, name, sizeof(name));
+
+    if (entry->is_dir) return;
 
     // Following help.c pattern - clear and show popup
     clear();
@@ -375,7 +322,7 @@ static void show_crc32(int selected) {
 
     move(2, 0);
     char buf[128];
-    snprintf(buf, sizeof(buf), "File: %s", file_list[selected].name);
+    snprintf(buf, sizeof(buf), "File: %s", name);
     addstr(buf);
 
     move(3, 0);
@@ -385,13 +332,13 @@ static void show_crc32(int selected) {
     // Build full path
     char fullpath[512];
     if (strcmp(current_path, "/") == 0) {
-        snprintf(fullpath, sizeof(fullpath), "/%s", file_list[selected].name);
+        snprintf(fullpath, sizeof(fullpath), "/%s", name);
     } else {
-        snprintf(fullpath, sizeof(fullpath), "%s/%s", current_path, file_list[selected].name);
+        snprintf(fullpath, sizeof(fullpath), "%s/%s", current_path, name);
     }
 
-    crc32_init();
-    uint32_t crc = calculate_file_crc32(fullpath);
+    file_crc_t r;
+    calculate_file_crc32(fullpath, 4, &r);
 
     // Clear the entire screen and redraw to ensure clean display
     clear();
@@ -401,24 +348,46 @@ static void show_crc32(int selected) {
     standend();
 
     move(2, 0);
-    snprintf(buf, sizeof(buf), "File: %s", file_list[selected].name);
+    snprintf(buf, sizeof(buf), "File: %s", name);
     addstr(buf);
 
     // Show CRC32 result with highlighting
     move(4, 0);
-    attron(A_REVERSE);
-    snprintf(buf, sizeof(buf), "CRC32: 0x%08lX", (unsigned long)crc);
-    addstr(buf);
-    standend();
+    if (r.fr != FR_OK) {
+        snprintf(buf, sizeof(buf), "✗ Error after %lu bytes: FRESULT=%d",
+                 (unsigned long)r.bytes, r.fr);
+        addstr(buf);
+    } else {
+        attron(A_REVERSE);
+        snprintf(buf, sizeof(buf), "CRC32: 0x%08lX", (unsigned long)r.crc);
+        addstr(buf);
+        standend();
+    }
 
     // Show file size
     move(5, 0);
     char size_buf[32];
-    format_size(file_list[selected].size, size_buf, sizeof(size_buf));
+    format_size(entry->size, size_buf, sizeof(size_buf));
     snprintf(buf, sizeof(buf), "Size: %s", size_buf);
     addstr(buf);
 
+    // Where the time went: a slow card shows in the read rate
+    char rate_buf[48];
+    format_rate(r.bytes, r.read_cycles + r.crc_cycles, rate_buf, sizeof(rate_buf));
     move(7, 0);
+    snprintf(buf, sizeof(buf), "Total: %s", rate_buf);
+    addstr(buf);
+    format_rate(r.bytes, r.read_cycles, rate_buf, sizeof(rate_buf));
+    move(8, 0);
+    snprintf(buf, sizeof(buf), "  Read: %s", rate_buf);
+    addstr(buf);
+    format_rate(r.bytes, r.crc_cycles, rate_buf, sizeof(rate_buf));
+    move(9, 0);
+    snprintf(buf, sizeof(buf), "  CRC:  %s (%s)", rate_buf,
+             crc32_hw_present() ? "accelerator" : "software");
+    addstr(buf);
+
+    move(11, 0);
     addstr("Press any key to continue...");
     refresh();
 
@@ -434,10 +403,11 @@ static void show_crc32(int selected) {
 static void delete_file(int selected) {
     if (selected < 0 || selected >= num_files) return;
 
-    FileEntry *entry = &file_list[selected];
+    char name[FF_LFN_BUF + 1];
+    const dir_entry_t *entry = get_entry(selected, name, sizeof(name));
 
     // Don't allow deletion of ".." entry
-    if (strcmp(entry->name, "..") == 0) {
+    if (strcmp(name, "..") == 0) {
         return;
     }
 
@@ -450,7 +420,7 @@ static void delete_file(int selected) {
 
     move(2, 0);
     char buf[128];
-    snprintf(buf, sizeof(buf), "Delete: %s", entry->name);
+    snprintf(buf, sizeof(buf), "Delete: %s", name);
     addstr(buf);
 
     move(3, 0);
@@ -482,9 +452,9 @@ static void delete_file(int selected) {
         // Build full path
         char fullpath[512];
         if (strcmp(current_path, "/") == 0) {
-            snprintf(fullpath, sizeof(fullpath), "/%s", entry->name);
+            snprintf(fullpath, sizeof(fullpath), "/%s", name);
         } else {
-            snprintf(fullpath, sizeof(fullpath), "%s/%s", current_path, entry->name);
+            snprintf(fullpath, sizeof(fullpath), "%s/%s", current_path, name);
         }
 
         FRESULT fr = f_unlink(fullpath);
@@ -512,7 +482,7 @@ static void delete_file(int selected) {
         }
 
         // Rescan directory
-        scan_directory(current_path);
+        rescan_directory(current_path);
     } else {
         // User cancelled - don't rescan
         return;
@@ -596,16 +566,17 @@ static void create_directory(void) {
     }
 
     // Rescan directory
-    scan_directory(current_path);
+    rescan_directory(current_path);
 }
 
 static void rename_file(int selected) {
     if (selected < 0 || selected >= num_files) return;
 
-    FileEntry *entry = &file_list[selected];
+    char name[FF_LFN_BUF + 1];
+    const dir_entry_t *entry = get_entry(selected, name, sizeof(name));
 
     // Don't allow renaming of ".." entry
-    if (strcmp(entry->name, "..") == 0) {
+    if (strcmp(name, "..") == 0) {
         return;
     }
 
@@ -617,7 +588,7 @@ static void rename_file(int selected) {
 
     move(2, 0);
     char buf[128];
-    snprintf(buf, sizeof(buf), "Current name: %s", entry->name);
+    snprintf(buf, sizeof(buf), "Current name: %s", name);
     addstr(buf);
 
     move(3, 0);
@@ -670,10 +641,10 @@ static void rename_file(int selected) {
     char old_path[512];
     char new_path[512];
     if (strcmp(current_path, "/") == 0) {
-        snprintf(old_path, sizeof(old_path), "/%s", entry->name);
+        snprintf(old_path, sizeof(old_path), "/%s", name);
         snprintf(new_path, sizeof(new_path), "/%s", new_name);
     } else {
-        snprintf(old_path, sizeof(old_path), "%s/%s", current_path, entry->name);
+        snprintf(old_path, sizeof(old_path), "%s/%s", current_path, name);
         snprintf(new_path, sizeof(new_path), "%s/%s", current_path, new_name);
     }
 
@@ -703,7 +674,7 @@ static void rename_file(int selected) {
     }
 
     // Rescan directory
-    scan_directory(current_path);
+    rescan_directory(current_path);
 }
 
 // Parse hex string to uint32_t (from spi_test.c pattern)
@@ -728,7 +699,10 @@ static uint32_t parse_hex_address(const char *input) {
 
 static void load_to_address(int selected) {
     if (selected < 0 || selected >= num_files) return;
-    if (file_list[selected].is_dir) return;
+    char name[FF_LFN_BUF + 1];
+    const dir_entry_t *entry = get_entry(selected, name, sizeof(name));
+
+    if (entry->is_dir) return;
 
     // Following help.c pattern - clear and show prompt
     clear();
@@ -739,12 +713,12 @@ static void load_to_address(int selected) {
 
     move(2, 0);
     char buf[128];
-    snprintf(buf, sizeof(buf), "File: %s", file_list[selected].name);
+    snprintf(buf, sizeof(buf), "File: %s", name);
     addstr(buf);
 
     move(3, 0);
     char size_buf[32];
-    format_size(file_list[selected].size, size_buf, sizeof(size_buf));
+    format_size(entry->size, size_buf, sizeof(size_buf));
     snprintf(buf, sizeof(buf), "Size: %s", size_buf);
     addstr(buf);
 
@@ -823,14 +797,14 @@ static void load_to_address(int selected) {
     // Build full path
     char fullpath[512];
     if (strcmp(current_path, "/") == 0) {
-        snprintf(fullpath, sizeof(fullpath), "/%s", file_list[selected].name);
+        snprintf(fullpath, sizeof(fullpath), "/%s", name);
     } else {
-        snprintf(fullpath, sizeof(fullpath), "%s/%s", current_path, file_list[selected].name);
+        snprintf(fullpath, sizeof(fullpath), "%s/%s", current_path, name);
     }
 
-    // Open file
-    FIL file;
-    FRESULT fr = f_open(&file, fullpath, FA_READ);
+    // Open file (cluster link map built once, see overlay_file_open)
+    overlay_file_t file;
+    FRESULT fr = overlay_file_open(&file, fullpath);
     if (fr != FR_OK) {
         move(11, 0);
         snprintf(buf, sizeof(buf), "✗ Error opening file: FRESULT=%d", fr);
@@ -854,23 +828,12 @@ static void load_to_address(int selected) {
     addstr("Loading...");
     refresh();
 
-    uint8_t *dest = (uint8_t *)address;
-    uint8_t buffer[512];
-    UINT br;
-    uint32_t total_bytes = 0;
+    // Straight to the destination, whole sectors without a bounce buffer
+    UINT br = 0;
+    fr = overlay_file_read(&file, (void *)address, (UINT)f_size(&file.fil), &br);
+    uint32_t total_bytes = br;
 
-    while (1) {
-        fr = f_read(&file, buffer, sizeof(buffer), &br);
-        if (fr != FR_OK || br == 0) break;
-
-        // Copy to memory
-        for (UINT i = 0; i < br; i++) {
-            dest[total_bytes + i] = buffer[i];
-        }
-        total_bytes += br;
-    }
-
-    f_close(&file);
+    overlay_file_close(&file);
 
     move(11, 0);
     clrtoeol();
@@ -900,10 +863,13 @@ static void load_to_address(int selected) {
 
 static void enter_directory(int selected) {
     if (selected < 0 || selected >= num_files) return;
-    if (!file_list[selected].is_dir) return;
+    char name[FF_LFN_BUF + 1];
+    const dir_entry_t *entry = get_entry(selected, name, sizeof(name));
+
+    if (!entry->is_dir) return;
 
     // Handle ".." (parent directory)
-    if (strcmp(file_list[selected].name, "..") == 0) {
+    if (strcmp(name, "..") == 0) {
         // Go up one level
         char *last_slash = strrchr(current_path, '/');
         if (last_slash && last_slash != current_path) {
@@ -914,10 +880,10 @@ static void enter_directory(int selected) {
     } else {
         // Enter subdirectory
         if (strcmp(current_path, "/") == 0) {
-            snprintf(current_path, sizeof(current_path), "/%s", file_list[selected].name);
+            snprintf(current_path, sizeof(current_path), "/%s", name);
         } else {
             char temp[256];
-            snprintf(temp, sizeof(temp), "%s/%s", current_path, file_list[selected].name);
+            snprintf(temp, sizeof(temp), "%s/%s", current_path, name);
             strncpy(current_path, temp, sizeof(current_path) - 1);
         }
     }
@@ -952,8 +918,9 @@ void show_file_browser(void) {
         return;
     }
 
-    // Initialize CRC32
-    crc32_init();
+
+    // Other menus may have changed the card since the last visit
+    dir_cursor_invalidate(NULL);
 
     // Scan initial directory
     if (scan_directory(current_path) < 0) {
@@ -989,7 +956,7 @@ void show_file_browser(void) {
 
         // Ensure proper input mode (subfunctions may change it)
         timeout(-1);
-        int ch = get_key_with_arrows();  // Use helper to detect arrow keys
+        int ch = getch();  // Arrow keys come decoded (keypad mode)
 
         // Handle input
         if (ch == 27) {  // ESC - exit
@@ -999,6 +966,7 @@ void show_file_browser(void) {
                 selected++;
                 if (selected >= scroll_offset + display_rows) {
                     scroll_offset++;
+                    scroll_file_list(1);
                 }
                 need_redraw = 1;
             }
@@ -1007,17 +975,29 @@ void show_file_browser(void) {
                 selected--;
                 if (selected < scroll_offset) {
                     scroll_offset--;
+                    scroll_file_list(-1);
                 }
                 need_redraw = 1;
             }
         } else if (ch == '\n' || ch == '\r') {  // Enter - open directory
+            // Where we were, for coming back to this directory
+            if (listing) {
+                listing->row = (uint32_t)selected;
+                listing->top = (uint32_t)scroll_offset;
+            }
             enter_directory(selected);
             selected = 0;
             scroll_offset = 0;
+            if (listing && (int)listing->row < num_files) {
+                selected = (int)listing->row;
+                scroll_offset = (int)listing->top;
+            }
             need_redraw = 1;
         } else if (ch == 't' || ch == 'T') {  // Toggle sort
             sort_by_time = !sort_by_time;
-            sort_file_list();
+            if (listing) {
+                dir_cursor_sort(listing, sort_by_time);
+            }
             need_redraw = 1;
         } else if (ch == 'c' || ch == 'C') {  // CRC32
             show_crc32(selected);
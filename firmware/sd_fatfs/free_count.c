@@ -0,0 +1,205 @@
+//==============================================================================
+// Free Cluster Count - Implementation
+//
+// The saved count is only taken for the volume it was saved from: its tag
+// is a CRC32 of the serial number, position and size of the volume and,
+// on exFAT, of the VolumeFlags and PercentInUse fields that another
+// machine updates when it writes to the card. The scan reads the FAT or
+// the allocation bitmap FREE_COUNT_SECTORS at a time with disk_read()
+// (one CMD18, coherent with the diskio cache), with the sector FatFS holds
+// in its window, which may not be written back yet, taken from there.
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+
+#include "free_count.h"
+#include "diskio.h"
+#include "config_sd.h"
+#include "../../lib/crc32.h"
+#include <stdlib.h>
+#include <string.h>
+
+static int free_count_valid(const FATFS *fs) {
+    return fs->fs_type != 0 && fs->free_clst <= fs->n_fatent - 2;
+}
+
+//==============================================================================
+// Volume Tag
+//==============================================================================
+
+static uint32_t le32(const BYTE *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// 0 if the boot sector cannot be read
+static uint32_t free_count_tag(FATFS *fs) {
+    BYTE bs[512] __attribute__((aligned(4)));
+    uint32_t tag[5];
+    uint32_t crc;
+
+    if (disk_read(fs->pdrv, bs, fs->volbase, 1) != RES_OK) {
+        return 0;
+    }
+
+    memset(tag, 0, sizeof(tag));
+    switch (fs->fs_type) {
+#if FF_FS_EXFAT
+    case FS_EXFAT:
+        tag[0] = le32(bs + 100);                // VolumeSerialNumber
+        tag[3] = bs[106] | (bs[107] << 8) | (bs[112] << 16);
+        break;
+#endif
+    case FS_FAT32:
+        tag[0] = le32(bs + 67);                 // BS_VolID
+        break;
+    default:
+        tag[0] = le32(bs + 39);
+        break;
+    }
+    tag[1] = (uint32_t)fs->volbase;
+    tag[2] = fs->n_fatent;
+    tag[4] = fs->fs_type;
+
+    crc = crc32_calc(tag, sizeof(tag));
+    return crc ? crc : 1;                       // 0 stands for "none"
+}
+
+//==============================================================================
+// Scan
+//==============================================================================
+
+static uint32_t popcount32(uint32_t v) {
+    v = v - ((v >> 1) & 0x55555555);
+    v = (v & 0x33333333) + ((v >> 2) & 0x33333333);
+    v = (v + (v >> 4)) & 0x0F0F0F0F;
+    v += v >> 8;
+    v += v >> 16;
+    return v & 0x3F;
+}
+
+// Free entries among the first n (n <= 32 bitmap bits, or up to 2 FAT16
+// entries / 1 FAT32 entry) of word w
+static uint32_t free_in_word(BYTE fs_type, uint32_t w, uint32_t n) {
+    switch (fs_type) {
+#if FF_FS_EXFAT
+    case FS_EXFAT:
+        if (n < 32) {
+            w |= ~((1u << n) - 1);              // Bits past the last cluster
+        }
+        return w == 0 ? 32 : 32 - popcount32(w);
+#endif
+    case FS_FAT16:
+        return ((w & 0xFFFF) == 0) + (n > 1 && (w >> 16) == 0);
+    default:
+        return (w & 0x0FFFFFFF) == 0;
+    }
+}
+
+static FRESULT free_count_scan(FATFS *fs, DWORD *nfree) {
+    uint32_t *buf;
+    uint32_t left, per_word, count = 0;
+    LBA_t base, sectors;
+    FRESULT res = FR_OK;
+
+#if FF_FS_EXFAT
+    if (fs->fs_type == FS_EXFAT) {
+        base = fs->bitbase;
+        left = fs->n_fatent - 2;                // Bits, one per cluster
+        per_word = 32;
+    } else
+#endif
+    {
+        base = fs->fatbase;
+        left = fs->n_fatent;                    // Entries 0 and 1 are never 0
+        per_word = fs->fs_type == FS_FAT16 ? 2 : 1;
+    }
+    sectors = (left + per_word * 128 - 1) / (per_word * 128);
+
+    buf = malloc(FREE_COUNT_SECTORS * 512);
+    if (buf == NULL) {
+        return FR_NOT_ENOUGH_CORE;
+    }
+
+    for (LBA_t sect = 0; sect < sectors && res == FR_OK; ) {
+        UINT n = sectors - sect < FREE_COUNT_SECTORS ? sectors - sect : FREE_COUNT_SECTORS;
+
+        if (disk_read(fs->pdrv, (BYTE *)buf, base + sect, n) != RES_OK) {
+            res = FR_DISK_ERR;
+            break;
+        }
+        if ((fs->wflag & 1) && fs->winsect >= base + sect && fs->winsect < base + sect + n) {
+            memcpy((BYTE *)buf + (fs->winsect - base - sect) * 512, fs->win, 512);
+        }
+
+        for (uint32_t i = 0; i < n * 128 && left; i++) {
+            uint32_t take = left < per_word ? left : per_word;
+
+            count += free_in_word(fs->fs_type, buf[i], take);
+            left -= take;
+        }
+        sect += n;
+    }
+
+    free(buf);
+    if (res == FR_OK) {
+        *nfree = count;
+    }
+    return res;
+}
+
+//==============================================================================
+// Public
+//==============================================================================
+
+void free_count_restore(FATFS *fs) {
+    uint32_t tag, clusters;
+
+    if (fs->fs_type == 0 || !config_sd_get(CFG_KEY_FREE_TAG, &tag) || tag == 0) {
+        return;
+    }
+
+    if (!free_count_valid(fs) && tag == free_count_tag(fs) &&
+        config_sd_get(CFG_KEY_FREE_CLUSTERS, &clusters) &&
+        clusters != 0 && clusters <= fs->n_fatent - 2) {
+        fs->free_clst = clusters;
+    }
+
+    // Taken, or for another volume: the next mount counts again unless
+    // this one is unmounted cleanly
+    config_sd_set(CFG_KEY_FREE_TAG, 0);
+    config_sd_commit();
+}
+
+FRESULT free_count_get(FATFS *fs, const TCHAR *path, DWORD *nclst) {
+    FATFS *mounted;
+    DWORD nfree;
+
+    // FAT12 volumes are a few sectors of FAT: FatFS's own count will do
+    if (fs->fs_type != 0 && fs->fs_type != FS_FAT12 && !free_count_valid(fs)) {
+        FRESULT res = free_count_scan(fs, &nfree);
+
+        if (res == FR_OK) {
+            fs->free_clst = nfree;
+            fs->fsi_flag |= 1;                  // FAT32: FSINFO is to be updated
+        } else if (res != FR_NOT_ENOUGH_CORE) {
+            return res;
+        }
+    }
+    return f_getfree(path, nclst, &mounted);
+}
+
+void free_count_save(FATFS *fs) {
+    uint32_t tag;
+
+    if (!free_count_valid(fs) || fs->free_clst == 0) {
+        return;
+    }
+
+    tag = free_count_tag(fs);
+    if (tag != 0 &&
+        config_sd_set(CFG_KEY_FREE_CLUSTERS, fs->free_clst) &&
+        config_sd_set(CFG_KEY_FREE_TAG, tag)) {
+        config_sd_commit();
+    }
+}
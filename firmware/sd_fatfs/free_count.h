@@ -0,0 +1,42 @@
+//==============================================================================
+// Free Cluster Count - Kept Over an Unmount, Counted Fast When Not
+//
+// FatFS counts the free clusters on the first f_getfree() after a mount,
+// one FAT entry or bitmap bit at a time through its one-sector window. A
+// FAT32 volume keeps the count in FSINFO; an exFAT one has nowhere to keep
+// it, so every mount of a 64 GB card meant reading 2 MB of bitmap a bit at
+// a time. The SD card manager now saves the count in the settings store
+// (config_sd.h) before it unmounts, and takes it back on the next mount of
+// the same volume. Without one, the count is made from multi-sector reads,
+// a 32-bit word at a time.
+//
+// Usage:
+//   f_mount(&g_fs, path, 1);  free_count_restore(&g_fs);
+//   free_count_get(&g_fs, path, &nclst);    // Instead of f_getfree()
+//   free_count_save(&g_fs);   f_mount(NULL, path, 0);
+//
+// A mount takes the saved count once (it is cleared on the card), so a
+// card pulled while mounted, or written by another machine, is counted
+// again. The settings store must be loaded (config_sd_load()) first.
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+
+#ifndef FREE_COUNT_H
+#define FREE_COUNT_H
+
+#include "ff.h"
+
+#define FREE_COUNT_SECTORS  16          // Sectors per read of the FAT or bitmap
+
+// Just mounted: use the count saved for this volume, if there is one
+void free_count_restore(FATFS *fs);
+
+// f_getfree() of path, mounted on fs, with the fast count when FatFS has none
+FRESULT free_count_get(FATFS *fs, const TCHAR *path, DWORD *nclst);
+
+// About to unmount: save the count, if FatFS has one
+void free_count_save(FATFS *fs);
+
+#endif // FREE_COUNT_H
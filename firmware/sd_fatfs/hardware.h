@@ -9,6 +9,7 @@
 //   - LEDs: 2 user LEDs
 //   - Buttons: 2 user buttons
 //   - SPI Master: For SD card interface
+//   - Cache Control: I-cache invalidate, D-cache clean/invalidate
 //
 // Copyright (c) October 2025 Michael Wolak
 // Email: mikewolak@gmail.com, mike@epromfoundry.com
@@ -23,7 +24,11 @@
 // System Configuration
 //==============================================================================
 
+#ifdef SYS_CLK_HZ
+#define SYSTEM_CLOCK_HZ     SYS_CLK_HZ  // Kconfig system clock (firmware/Makefile)
+#else
 #define SYSTEM_CLOCK_HZ     50000000    // 50 MHz system clock
+#endif
 
 //==============================================================================
 // UART Peripheral (0x80000000)
@@ -36,12 +41,20 @@
 
 #define UART_TX_DATA    (*(volatile uint32_t*)(UART_BASE + 0x00))
 #define UART_TX_STATUS  (*(volatile uint32_t*)(UART_BASE + 0x04))
+#define UART_TX_WORD    (*(volatile uint32_t*)(UART_BASE + 0x04))  // Write: queue all byte lanes
 #define UART_RX_DATA    (*(volatile uint32_t*)(UART_BASE + 0x08))
 #define UART_RX_STATUS  (*(volatile uint32_t*)(UART_BASE + 0x0C))
 
 // UART status bits
-#define UART_TX_BUSY    (1 << 0)  // TX busy (wait before sending)
+#define UART_TX_BUSY    (1 << 0)  // TX FIFO full (wait before sending)
+#define UART_TX_ACTIVE  (1 << 1)  // Bytes queued or a character on the wire
+#define UART_TX_FIFO    (1u << 31) // TX FIFO and TX_WORD present
+#define UART_TX_FREE(s) (((s) >> 16) & 0xFFF)  // Free TX FIFO bytes
 #define UART_RX_READY   (1 << 0)  // RX data available
+#define UART_RX_OVERFLOW (1 << 1) // Bytes dropped (RX FIFO full) since last clear
+#define UART_RX_FRAMING (1 << 2)  // Framing errors since last clear
+#define UART_RX_DROPPED(s) (((s) >> 8) & 0xFFF)  // Dropped byte count (saturates)
+#define UART_RX_FRAMES(s) (((s) >> 20) & 0xFFF)  // Framing error count (saturates)
 
 //==============================================================================
 // Timer Peripheral (0x80000020)
@@ -91,6 +104,8 @@
 // Two user buttons on the board
 // Read 1 when button pressed, 0 when released
 // Note: Check if pull-up or pull-down - may need inversion
+// Raw synchronised inputs: debounced state and press/release events are
+// at 0x80000270 (lib/button.h)
 //==============================================================================
 
 #define BUTTON_BASE     0x80000018
@@ -104,7 +119,7 @@
 //==============================================================================
 // SPI Master Peripheral (0x80000050)
 //
-// Non-FIFO version - gate-efficient design
+// Byte registers at 0x80000050, burst/FIFO registers at 0x800000C0
 // Supports 8 power-of-2 clock dividers from 50 MHz to 390 kHz
 // Manual chip select control
 // CPOL=0, CPHA=0 (mode 0) - configurable if needed
@@ -117,6 +132,56 @@
 #define SPI_STATUS      (*(volatile uint32_t*)(SPI_BASE + 0x08))
 #define SPI_CS          (*(volatile uint32_t*)(SPI_BASE + 0x0C))
 
+// Burst mode: word FIFOs (Kconfig SPI_FIFO_DEPTH words each)
+// SPI_FIFO_DATA write queues 4 TX bytes (bits [7:0] first), read pops one
+// RX word and stalls until it has arrived. SPI_RX_REPEAT=N clocks out N
+// 0xFF bytes and packs the received bytes into the RX FIFO.
+#define SPI_FIFO_BASE   0x800000C0
+
+#define SPI_FIFO_DATA   (*(volatile uint32_t*)(SPI_FIFO_BASE + 0x00))
+#define SPI_FIFO_CTRL   (*(volatile uint32_t*)(SPI_FIFO_BASE + 0x04))
+#define SPI_FIFO_STAT   (*(volatile uint32_t*)(SPI_FIFO_BASE + 0x08))
+#define SPI_RX_REPEAT   (*(volatile uint32_t*)(SPI_FIFO_BASE + 0x0C))
+
+// SPI_FIFO_CTRL bits
+#define SPI_FIFO_CAPTURE (1 << 0)  // Also store MISO bytes of TX FIFO words
+#define SPI_FIFO_FLUSH   (1 << 1)  // Drop queued TX/RX data (self-clearing)
+
+// SPI_FIFO_STAT fields (words)
+#define SPI_FIFO_TX_LEVEL(s)  ((s) & 0x3FF)
+#define SPI_FIFO_RX_LEVEL(s)  (((s) >> 16) & 0x3FF)
+
+// SPI DMA: moves words between the SPI FIFOs and SRAM (word-aligned SRAM
+// buffers, length a multiple of 4). Bypasses the D-cache - see the cache
+// helpers below. Completion also pulses IRQ[2] when SPI_DMA_IRQ_EN is set.
+#define SPI_DMA_BASE    0x800000D0
+
+#define SPI_DMA_ADDR    (*(volatile uint32_t*)(SPI_DMA_BASE + 0x00))
+#define SPI_DMA_LEN     (*(volatile uint32_t*)(SPI_DMA_BASE + 0x04))
+#define SPI_DMA_CTRL    (*(volatile uint32_t*)(SPI_DMA_BASE + 0x08))
+
+// SPI_DMA_CTRL bits
+#define SPI_DMA_START   (1 << 0)  // Write: start, Read: busy
+#define SPI_DMA_TX      (1 << 1)  // Direction: 0 = SPI -> SRAM, 1 = SRAM -> SPI
+#define SPI_DMA_IRQ_EN  (1 << 2)  // Pulse IRQ[2] on completion
+#define SPI_DMA_DONE    (1 << 3)  // Read: last transfer finished
+
+// SPI CRC (Kconfig SPI_HW_CRC): CRC16-CCITT over MISO and MOSI bytes and
+// CRC7 over MOSI bytes, updated as each byte completes while enabled.
+// For a received SD block, clear after the start token: the CRC16 over
+// data + CRC bytes is 0 when the block is good.
+#define SPI_CRC_BASE    0x800000E0
+
+#define SPI_CRC_CTRL    (*(volatile uint32_t*)(SPI_CRC_BASE + 0x00))
+#define SPI_CRC16_RX    (*(volatile uint32_t*)(SPI_CRC_BASE + 0x04))
+#define SPI_CRC16_TX    (*(volatile uint32_t*)(SPI_CRC_BASE + 0x08))
+#define SPI_CRC7        (*(volatile uint32_t*)(SPI_CRC_BASE + 0x0C))  // {CRC7, 1}: command end byte
+
+// SPI_CRC_CTRL bits
+#define SPI_CRC_ENABLE  (1 << 0)   // Accumulate
+#define SPI_CRC_CLEAR   (1 << 1)   // Reset all CRCs to 0 (self-clearing)
+#define SPI_CRC_PRESENT (1u << 31) // Read: hardware built with SPI_HW_CRC
+
 // SPI status bits
 #define SPI_STATUS_BUSY (1 << 0)  // Transfer in progress
 #define SPI_STATUS_DONE (1 << 1)  // Transfer complete
@@ -131,4 +196,65 @@
 #define SPI_CLK_781KHZ  (6 << 2)  // /64 = 781 kHz
 #define SPI_CLK_390KHZ  (7 << 2)  // /128 = 390 kHz
 
+// Any divider: SCK half period = n + 1 clocks, SCK = SYSTEM_CLOCK_HZ / (2 * (n + 1))
+#define SPI_CLK_DIV(n)          ((1 << 5) | (((n) & 0xFF) << 8))
+// MISO sample point d clocks after the SCK edge (mode 0, d <= n); OR into the speed
+#define SPI_SAMPLE_DELAY(d)     (((d) & 0x0F) << 16)
+#define SPI_CTRL_DIV_GET(c)     (((c) >> 8) & 0xFF)
+#define SPI_CTRL_DELAY_GET(c)   (((c) >> 16) & 0x0F)
+
+//==============================================================================
+// Cache Control (0x80000060)
+//
+// Instruction and data cache maintenance (both caches are optional -
+// Kconfig ICACHE / DCACHE). Writes are harmless when a cache is not built in.
+//
+// CPU stores keep both caches coherent with each other on their own. Use
+// these only around other SRAM masters (DMA) or before running new code:
+//   - dcache_clean_range()      before a device reads SRAM
+//   - dcache_invalidate_range() before the CPU reads what a device wrote
+//     (dirty lines are written back first, nothing is lost)
+//==============================================================================
+
+#define CACHE_BASE      0x80000060
+
+#define CACHE_CTRL      (*(volatile uint32_t*)(CACHE_BASE + 0x00))
+#define CACHE_INFO      (*(volatile uint32_t*)(CACHE_BASE + 0x04))
+#define CACHE_DADDR     (*(volatile uint32_t*)(CACHE_BASE + 0x08))
+#define CACHE_DLEN      (*(volatile uint32_t*)(CACHE_BASE + 0x0C))
+
+// Cache control bits
+#define CACHE_ICACHE_INV    (1 << 0)  // Write: I-cache invalidate all, Read: busy
+#define CACHE_DCACHE_CLEAN  (1 << 1)  // Write: D-cache clean range, Read: busy
+#define CACHE_DCACHE_INV    (1 << 2)  // Write: D-cache invalidate range
+
+// Cache info fields
+#define CACHE_INFO_ICACHE_BYTES(info)   ((info) & 0xFFFF)          // 0 = no I-cache
+#define CACHE_INFO_DCACHE_BYTES(info)   (((info) >> 16) & 0xFFFF)  // 0 = no D-cache
+
+static inline void icache_invalidate(void) {
+    CACHE_CTRL = CACHE_ICACHE_INV;
+    while (CACHE_CTRL & CACHE_ICACHE_INV);  // Wait for invalidate to finish
+}
+
+static inline void dcache_clean_range(uint32_t addr, uint32_t len) {
+    CACHE_DADDR = addr;
+    CACHE_DLEN = len;
+    CACHE_CTRL = CACHE_DCACHE_CLEAN;
+    while (CACHE_CTRL & CACHE_DCACHE_CLEAN);  // Wait for write-back to finish
+}
+
+static inline void dcache_invalidate_range(uint32_t addr, uint32_t len) {
+    CACHE_DADDR = addr;
+    CACHE_DLEN = len;
+    CACHE_CTRL = CACHE_DCACHE_INV;
+    while (CACHE_CTRL & CACHE_DCACHE_CLEAN);  // Busy bit covers both operations
+}
+
+// Make freshly written code visible to instruction fetch
+static inline void cache_sync_code(uint32_t addr, uint32_t len) {
+    dcache_clean_range(addr, len);
+    icache_invalidate();
+}
+
 #endif // HARDWARE_H
@@ -15,6 +15,40 @@
 
 #include "io.h"
 #include "hardware.h"
+#include <string.h>
+
+#include "../../lib/irq.h"
+#include "../../lib/button.h"
+#include "../../lib/timer.h"
+#include "../../lib/uart_irq.h"
+#include "../../lib/trace/trace.h"
+#include "../../lib/hrtimer/hrtimer.h"
+
+#ifdef USE_FREERTOS
+#include <FreeRTOS.h>
+#endif
+
+// Blocking waits halt in waitirq until their wake source fires. SPI, DMA,
+// UART RX, button and timer channel IRQs are unmasked between checks, for
+// app_irq_handler() (sd_card_manager.c) to take: it quiets the UART RX
+// level and passes over the pulses. Without that, the pulse left pending
+// by the last SD transfer (PicoRV32 keeps a masked IRQ pending) would end
+// every wait at once. The timer tick and traps keep the caller's mask.
+// Under FreeRTOS the port blocks the task instead (spi_dma_wait) and
+// these poll.
+#define IO_WAKE         ((1u << IRQ_SPI) | (1u << IRQ_MEM_DMA) | (1u << IRQ_UART_RX) | \
+                         (1u << IRQ_BUTTON) | (1u << IRQ_TIMERS))
+
+#ifdef USE_FREERTOS
+#define IO_WAIT_UNTIL(cond)     while (!(cond))
+#else
+#define IO_WAIT_UNTIL(cond)     irq_wait_until(cond, IO_WAKE)
+#endif
+
+// Delays: lib/hrtimer on channel 1 (IRQ[7]), which stops the channel
+// again when no timer is armed: free while no overlay runs
+#define IO_DELAY_CH     1
+#define IO_DELAY_PRIO   8
 
 //==============================================================================
 // UART Functions (required by incurses library)
@@ -26,20 +60,110 @@ void uart_putc(char c) {
 }
 
 void uart_puts(const char *s) {
-    while (*s) {
-        uart_putc(*s++);
+    uart_write(s, strlen(s));
+}
+
+// Fill the TX FIFO up to its free space, four bytes per word store;
+// returns the number of bytes queued (0 if the FIFO is full)
+unsigned uart_write_some(const char *buf, unsigned len) {
+    uint32_t status = UART_TX_STATUS;
+
+    if (!(status & UART_TX_FIFO)) {
+        if (status & UART_TX_BUSY)
+            return 0;
+        UART_TX_DATA = *buf;    // Older bitstream: one byte at a time
+        return 1;
+    }
+
+    unsigned room = UART_TX_FREE(status);
+    if (room > len) room = len;
+    unsigned queued = room;
+
+    for (; room && ((uint32_t)buf & 3); room--) {
+        UART_TX_DATA = *buf++;
     }
+    for (; room >= 4; room -= 4, buf += 4) {
+        UART_TX_WORD = *(const uint32_t *)buf;
+    }
+    for (; room; room--) {
+        UART_TX_DATA = *buf++;
+    }
+
+    return queued;
+}
+
+void uart_write(const char *buf, uint32_t len) {
+    while (len) {
+        unsigned queued = uart_write_some(buf, len);
+        buf += queued;
+        len -= queued;
+    }
+}
+
+// Wait until every queued character has left the UART
+void uart_flush(void) {
+    while (UART_TX_STATUS & (UART_TX_ACTIVE | UART_TX_BUSY));
 }
 
 int uart_getc_available(void) {
     return UART_RX_STATUS & UART_RX_READY;
 }
 
+// Arm the RX IRQ (the handler disarms it) and check for data
+static int uart_rx_armed(void) {
+    uart_irq_enable(UART_IRQ_RX_AVAIL);
+    return uart_getc_available();
+}
+
+// Sleeps on the RX IRQ; bitstreams without the UART IRQ block read
+// UART_IRQ_EN as 0 and poll
 char uart_getc(void) {
-    while (!uart_getc_available());
+    if (!uart_getc_available()) {
+        uart_irq_enable(UART_IRQ_RX_AVAIL);
+        if (UART_IRQ_EN & UART_IRQ_RX_AVAIL) {
+            IO_WAIT_UNTIL(uart_rx_armed());
+            uart_irq_disable(UART_IRQ_RX_AVAIL);
+        } else {
+            while (!uart_getc_available());
+        }
+    }
     return UART_RX_DATA & 0xFF;
 }
 
+static void io_hrt_start(void);
+
+static void io_wake(void *arg) {
+    *(volatile uint32_t *)arg = 1;
+}
+
+// incurses waits for input here: asleep on the RX IRQ and, for a timed
+// wait, a timer service one-shot (at most 1 s; incurses waits again).
+// Without the UART IRQ block or the timer channel it returns at once
+// and incurses polls.
+void incurses_wait_input(int timeout_ms) {
+    volatile uint32_t done = 0;
+    hrt_timer_t t;
+
+    uart_irq_enable(UART_IRQ_RX_AVAIL);
+    if (!(UART_IRQ_EN & UART_IRQ_RX_AVAIL)) {
+        return;
+    }
+    if (timeout_ms >= 0) {
+        io_hrt_start();
+        if (!hrt_running()) {
+            uart_irq_disable(UART_IRQ_RX_AVAIL);
+            return;
+        }
+        hrt_timer_init(&t, io_wake, (void *)&done);
+        hrt_timer_start(&t, timeout_ms > 1000 ? 1000000 : (uint32_t)timeout_ms * 1000, 0);
+    }
+    IO_WAIT_UNTIL(done || uart_rx_armed());
+    uart_irq_disable(UART_IRQ_RX_AVAIL);
+    if (timeout_ms >= 0) {
+        hrt_timer_cancel(&t);
+    }
+}
+
 //==============================================================================
 // Timer Functions
 //==============================================================================
@@ -50,25 +174,39 @@ void timer_init(void) {
 }
 
 void timer_delay_ms(uint32_t ms) {
-    TIMER_CTRL = 0;  // Disable timer
-    TIMER_COMPARE = TIMER_MS_TO_TICKS(ms);
-    TIMER_CTRL = TIMER_ENABLE | TIMER_ONE_SHOT;  // Start one-shot timer
+    // 1 s steps keep us in range
+    for (; ms > 1000; ms -= 1000) {
+        timer_delay_us(1000000);
+    }
+    timer_delay_us(ms * 1000);
+}
 
-    // Wait for timer to expire
-    while (TIMER_CTRL & TIMER_ENABLE);
+// Timer service for the delays, started on first use. Channel 0 is left
+// alone: it is the 1 Hz benchmark tick. Not under FreeRTOS: its
+// irq_handler() does not serve IRQ[7].
+static void io_hrt_start(void) {
+#ifndef USE_FREERTOS
+    static uint8_t tried = 0;
 
-    TIMER_STATUS = TIMER_SR_UIF;  // Clear flag
+    if (!tried) {
+        tried = 1;
+        hrt_init(IO_DELAY_CH, IO_DELAY_PRIO);
+    }
+#endif
 }
 
+// Sleeps on a timer service one-shot. Bitstreams without the channel,
+// and FreeRTOS, poll the clock.
 void timer_delay_us(uint32_t us) {
-    TIMER_CTRL = 0;  // Disable timer
-    TIMER_COMPARE = TIMER_US_TO_TICKS(us);
-    TIMER_CTRL = TIMER_ENABLE | TIMER_ONE_SHOT;  // Start one-shot timer
-
-    // Wait for timer to expire
-    while (TIMER_CTRL & TIMER_ENABLE);
-
-    TIMER_STATUS = TIMER_SR_UIF;  // Clear flag
+    io_hrt_start();
+    if (us == 0)
+        return;
+
+#ifdef USE_FREERTOS
+    hrt_sleep_until(hrt_deadline_us(us), 0);
+#else
+    hrt_sleep_until(hrt_deadline_us(us), IO_WAKE);
+#endif
 }
 
 uint32_t timer_get_ticks(void) {
@@ -119,12 +257,49 @@ uint8_t button_read_all(void) {
     return BUTTON_REG & 0x03;  // Only 2 buttons
 }
 
+// Sleep until one of the debounced events ev (lib/button.h) is latched,
+// then clear it. Unmasks only ev on IRQ[6] for the wait.
+static void button_wait_event(uint32_t ev) {
+    uint32_t irq_en = BTN_IRQ_EN;
+
+    if (irqc_present()) {
+        BTN_IRQ_EN = irq_en | ev;
+        IRQC_PENDING = 1u << IRQ_BUTTON;
+        irq_source_enable(IRQ_BUTTON);
+        IO_WAIT_UNTIL(BTN_EVENTS & ev);
+        irq_source_disable(IRQ_BUTTON);
+        BTN_IRQ_EN = irq_en;
+    } else {
+        while (!(BTN_EVENTS & ev));
+    }
+    BTN_EVENTS = ev;
+}
+
 uint8_t button_wait_press(uint8_t button) {
+    // Hardware debounce: the events are cleared before the state is read,
+    // so a release or press in between is not lost
+    if (button_debounce_present()) {
+        BTN_EVENTS = BTN_PRESS(button) | BTN_RELEASE(button);
+        if (BTN_STATE & (1u << button)) {
+            button_wait_event(BTN_RELEASE(button));
+        }
+        button_wait_event(BTN_PRESS(button));
+        return 1;
+    }
+
     // Wait for button to be released (if already pressed)
     while (button_read(button));
 
-    // Wait for button to be pressed
-    while (!button_read(button));
+    // Wait for button to be pressed: sleeps on the press IRQ, which the
+    // interrupt controller keeps off outside this wait
+    if (irqc_present()) {
+        IRQC_PENDING = 1u << IRQ_BUTTON;
+        irq_source_enable(IRQ_BUTTON);
+        IO_WAIT_UNTIL(button_read(button));
+        irq_source_disable(IRQ_BUTTON);
+    } else {
+        while (!button_read(button));
+    }
 
     // Simple debounce delay
     timer_delay_ms(20);
@@ -133,6 +308,14 @@ uint8_t button_wait_press(uint8_t button) {
 }
 
 uint8_t button_wait_release(uint8_t button) {
+    if (button_debounce_present()) {
+        BTN_EVENTS = BTN_RELEASE(button);
+        if (BTN_STATE & (1u << button)) {
+            button_wait_event(BTN_RELEASE(button));
+        }
+        return 1;
+    }
+
     // Wait for button to be released
     while (button_read(button));
 
@@ -155,12 +338,159 @@ void spi_set_speed(uint32_t speed) {
     SPI_CTRL = speed;
 }
 
+uint32_t spi_sck_hz(uint32_t speed) {
+    // SCK toggles once per divider period
+    uint32_t half_period = (speed & SPI_CLK_DIV(0)) ? SPI_CTRL_DIV_GET(speed) + 1
+                                                    : 1u << ((speed >> 2) & 7);
+    return SYSTEM_CLOCK_HZ / (2 * half_period);
+}
+
 uint8_t spi_transfer(uint8_t data) {
     SPI_DATA = data;
     while (SPI_STATUS & SPI_STATUS_BUSY);
     return SPI_DATA & 0xFF;
 }
 
+void spi_read_block(uint8_t *buf, uint32_t len) {
+    // Clock out len 0xFF bytes; each SPI_FIFO_DATA read waits for 4 of them
+    TRACE_EVENT(TRACE_EV_SPI_BEGIN, TRACE_SPI_READ, len);
+    SPI_FIFO_CTRL = SPI_FIFO_FLUSH;
+    SPI_RX_REPEAT = len;
+
+    if (((uint32_t)buf & 3) == 0) {
+        uint32_t *wp = (uint32_t *)buf;
+        for (; len >= 4; len -= 4) {
+            *wp++ = SPI_FIFO_DATA;
+        }
+        buf = (uint8_t *)wp;
+    } else {
+        for (; len >= 4; len -= 4) {
+            uint32_t w = SPI_FIFO_DATA;
+            buf[0] = w;
+            buf[1] = w >> 8;
+            buf[2] = w >> 16;
+            buf[3] = w >> 24;
+            buf += 4;
+        }
+    }
+
+    if (len) {
+        uint32_t w = SPI_FIFO_DATA;  // Partial last word, low bytes valid
+        while (len--) {
+            *buf++ = w;
+            w >>= 8;
+        }
+    }
+    TRACE_EVENT(TRACE_EV_SPI_END, TRACE_SPI_READ, 0);
+}
+
+void spi_write_block(const uint8_t *buf, uint32_t len) {
+    TRACE_EVENT(TRACE_EV_SPI_BEGIN, TRACE_SPI_WRITE, len);
+    SPI_FIFO_CTRL = 0;  // Discard MISO while sending
+
+    for (; len >= 4; len -= 4) {
+        SPI_FIFO_DATA = (uint32_t)buf[0] | ((uint32_t)buf[1] << 8) |
+                        ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+        buf += 4;
+    }
+
+    // Byte writes are only accepted once the FIFO has drained
+    while (SPI_STATUS & SPI_STATUS_BUSY);
+    while (len--) {
+        spi_transfer(*buf++);
+    }
+    TRACE_EVENT(TRACE_EV_SPI_END, TRACE_SPI_WRITE, 0);
+}
+
+int spi_dma_capable(const void *buf, uint32_t len) {
+    // SRAM only (0x00000000-0x0007FFFF), word aligned
+    return (((uint32_t)buf | len) & 3) == 0 && (uint32_t)buf + len <= 0x00080000;
+}
+
+// SPI_DMA_IRQ_EN when spi_dma_wait() should sleep instead of polling
+static uint32_t s_dma_irq = 0;
+
+void spi_dma_sleep(int on) {
+    s_dma_irq = on ? SPI_DMA_IRQ_EN : 0;
+}
+
+void spi_dma_read_start(uint8_t *buf, uint32_t len) {
+    // Write back and drop cached lines first: the DMA writes SRAM behind
+    // the D-cache and the CPU must not see stale data afterwards
+    dcache_invalidate_range((uint32_t)buf, len);
+
+    TRACE_EVENT(TRACE_EV_SPI_BEGIN, TRACE_SPI_READ, len);
+    SPI_FIFO_CTRL = SPI_FIFO_FLUSH;
+    SPI_DMA_ADDR = (uint32_t)buf;
+    SPI_DMA_LEN = len;
+#ifdef USE_FREERTOS
+    if (s_dma_irq) vPortIrqArm(IRQ_SPI);   // Before the start: completion may be quick
+#endif
+    SPI_DMA_CTRL = SPI_DMA_START | s_dma_irq;
+}
+
+void spi_dma_write_start(const uint8_t *buf, uint32_t len) {
+    // The DMA reads SRAM, so dirty lines must reach it first
+    dcache_clean_range((uint32_t)buf, len);
+
+    TRACE_EVENT(TRACE_EV_SPI_BEGIN, TRACE_SPI_WRITE, len);
+    SPI_FIFO_CTRL = 0;  // Discard MISO while sending
+    SPI_DMA_ADDR = (uint32_t)buf;
+    SPI_DMA_LEN = len;
+#ifdef USE_FREERTOS
+    if (s_dma_irq) vPortIrqArm(IRQ_SPI);
+#endif
+    SPI_DMA_CTRL = SPI_DMA_START | SPI_DMA_TX | s_dma_irq;
+}
+
+// In sleep mode a FreeRTOS task blocks on IRQ[2] (other tasks run), bare
+// metal halts in waitirq. Every SPI transfer also pulses IRQ[2], so the
+// busy bit is re-checked after each wakeup.
+void spi_dma_wait(void) {
+    if (!s_dma_irq) {
+        while (SPI_DMA_CTRL & SPI_DMA_START);
+        TRACE_EVENT(TRACE_EV_SPI_END, 0, 0);
+        return;
+    }
+
+    while (SPI_DMA_CTRL & SPI_DMA_START) {
+#ifdef USE_FREERTOS
+        xPortIrqWait(IRQ_SPI, 1);   // 1 tick: bitstreams without the IRQ poll
+        vPortIrqArm(IRQ_SPI);       // For the next round (busy re-checked first)
+#else
+        irq_wait();
+#endif
+    }
+#ifdef USE_FREERTOS
+    xPortIrqWait(IRQ_SPI, 0);       // Disarm
+#endif
+    TRACE_EVENT(TRACE_EV_SPI_END, 0, 0);
+}
+
+int spi_dma_busy(void) {
+    return (SPI_DMA_CTRL & SPI_DMA_START) != 0;
+}
+
+int spi_crc_present(void) {
+    return (SPI_CRC_CTRL & SPI_CRC_PRESENT) != 0;
+}
+
+void spi_crc_start(void) {
+    SPI_CRC_CTRL = SPI_CRC_CLEAR | SPI_CRC_ENABLE;
+}
+
+uint16_t spi_crc16_rx(void) {
+    return SPI_CRC16_RX & 0xFFFF;
+}
+
+uint16_t spi_crc16_tx(void) {
+    return SPI_CRC16_TX & 0xFFFF;
+}
+
+uint8_t spi_crc7_byte(void) {
+    return SPI_CRC7 & 0xFF;
+}
+
 void spi_cs_assert(void) {
     SPI_CS = 0;
 }
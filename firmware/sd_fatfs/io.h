@@ -17,8 +17,12 @@
 
 void uart_putc(char c);
 void uart_puts(const char *s);
+void uart_write(const char *buf, uint32_t len);
+unsigned uart_write_some(const char *buf, unsigned len);   // Non-blocking
+void uart_flush(void);
 int uart_getc_available(void);
 char uart_getc(void);
+void incurses_wait_input(int timeout_ms);   // incurses getch() waits (RX IRQ)
 
 //==============================================================================
 // Timer Functions
@@ -55,7 +59,21 @@ uint8_t button_wait_release(uint8_t button);
 
 void spi_init(uint32_t speed);
 void spi_set_speed(uint32_t speed);
+uint32_t spi_sck_hz(uint32_t speed);
 uint8_t spi_transfer(uint8_t data);
+void spi_read_block(uint8_t *buf, uint32_t len);
+void spi_write_block(const uint8_t *buf, uint32_t len);
+int spi_dma_capable(const void *buf, uint32_t len);
+void spi_dma_read_start(uint8_t *buf, uint32_t len);
+void spi_dma_write_start(const uint8_t *buf, uint32_t len);
+void spi_dma_wait(void);
+int spi_dma_busy(void);             // Transfer still running (no wait)
+void spi_dma_sleep(int on);         // spi_dma_wait() sleeps on the completion IRQ
+int spi_crc_present(void);
+void spi_crc_start(void);           // Clear and enable the hardware CRCs
+uint16_t spi_crc16_rx(void);
+uint16_t spi_crc16_tx(void);
+uint8_t spi_crc7_byte(void);        // CRC7 of the bytes sent since start, as {CRC7, 1}
 void spi_cs_assert(void);
 void spi_cs_deassert(void);
 
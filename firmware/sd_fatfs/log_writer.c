@@ -0,0 +1,166 @@
+//==============================================================================
+// Streaming Log Writer - Preallocated Contiguous Files on SD
+//
+// The file's clusters are allocated in one piece by f_expand(), so sector
+// N of the file is simply start + N and the data is written with
+// disk_write() (one CMD25 per ring half) without FatFS in the path. Only
+// log_writer_close() goes back through FatFS to trim the file.
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+
+#include "log_writer.h"
+#include "diskio.h"
+#include <string.h>
+
+//==============================================================================
+// Card Writes
+//==============================================================================
+
+// Write len bytes (whole sectors, last one padded by the caller) at the
+// current end of the file
+static void log_write_sectors(log_writer_t *lw, const uint8_t *buf, uint32_t len) {
+    UINT count = (len + 511) / 512;
+
+    if (lw->error != FR_OK) {
+        return;
+    }
+
+    if (disk_write(lw->fil.obj.fs->pdrv, buf, lw->sector + lw->committed / 512, count) != RES_OK) {
+        lw->error = FR_DISK_ERR;
+    }
+}
+
+//==============================================================================
+// Public API
+//==============================================================================
+
+FRESULT log_writer_open(log_writer_t *lw, const char *path, FSIZE_t size,
+                        uint8_t *ring, uint32_t ring_size) {
+    uint32_t half_size = (ring_size / 2) & ~511u;
+    FATFS *fs;
+    FRESULT fr;
+
+    memset(lw, 0, sizeof(*lw));
+    if (half_size == 0 || size == 0) {
+        return FR_INVALID_PARAMETER;
+    }
+
+    fr = f_open(&lw->fil, path, FA_CREATE_ALWAYS | FA_WRITE);
+    if (fr != FR_OK) {
+        return fr;
+    }
+
+    // Contiguous clusters allocated now (FR_DENIED if no free run is big
+    // enough); the FAT is not touched again until close
+    fr = f_expand(&lw->fil, size, 1);
+    if (fr == FR_OK) {
+        // Directory entry with the full size on the card, in case the
+        // capture is cut short
+        fr = f_sync(&lw->fil);
+    }
+    if (fr != FR_OK) {
+        f_close(&lw->fil);
+        f_unlink(path);
+        return fr;
+    }
+
+    fs = lw->fil.obj.fs;
+    lw->sector = fs->database + (LBA_t)fs->csize * (lw->fil.obj.sclust - 2);
+    lw->capacity = size;
+    lw->half[0] = ring;
+    lw->half[1] = ring + half_size;
+    lw->half_size = half_size;
+
+    return FR_OK;
+}
+
+uint32_t log_writer_put(log_writer_t *lw, const void *data, uint32_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+    uint32_t room = lw->capacity - lw->accepted;
+    uint32_t done = 0;
+
+    if (len > room) {
+        lw->dropped += len - room;
+        len = room;
+    }
+
+    while (done < len) {
+        uint32_t n;
+
+        // Hand a full half to log_writer_poll() once the other one is free
+        if (lw->fill == lw->half_size) {
+            if (lw->pending) {
+                break;
+            }
+            lw->active ^= 1;
+            lw->fill = 0;
+            lw->pending = 1;
+        }
+
+        n = lw->half_size - lw->fill;
+        if (n > len - done) {
+            n = len - done;
+        }
+        memcpy(lw->half[lw->active] + lw->fill, p + done, n);
+        lw->fill += n;
+        done += n;
+
+        if (lw->fill == lw->half_size && !lw->pending) {
+            lw->active ^= 1;
+            lw->fill = 0;
+            lw->pending = 1;
+        }
+    }
+
+    lw->accepted += done;
+    lw->dropped += len - done;
+    return done;
+}
+
+FRESULT log_writer_poll(log_writer_t *lw) {
+    if (lw->pending) {
+        log_write_sectors(lw, lw->half[lw->active ^ 1], lw->half_size);
+        lw->committed += lw->half_size;
+        lw->pending = 0;
+    }
+
+    return lw->error;
+}
+
+FRESULT log_writer_close(log_writer_t *lw) {
+    uint32_t fill;
+    FRESULT fr;
+
+    log_writer_poll(lw);
+
+    // The active half can be full only if it was waiting for the other one
+    if (lw->fill == lw->half_size) {
+        lw->active ^= 1;
+        lw->fill = 0;
+        lw->pending = 1;
+        log_writer_poll(lw);
+    }
+
+    fill = lw->fill;
+    if (fill > 0) {
+        uint32_t padded = (fill + 511) & ~511u;
+
+        memset(lw->half[lw->active] + fill, 0, padded - fill);
+        log_write_sectors(lw, lw->half[lw->active], padded);
+        lw->committed += fill;
+        lw->fill = 0;
+    }
+
+    // Give back the preallocated clusters past the data
+    fr = f_lseek(&lw->fil, lw->accepted);
+    if (fr == FR_OK) {
+        fr = f_truncate(&lw->fil);
+    }
+    if (f_close(&lw->fil) != FR_OK && fr == FR_OK) {
+        fr = FR_DISK_ERR;
+    }
+
+    return lw->error != FR_OK ? lw->error : fr;
+}
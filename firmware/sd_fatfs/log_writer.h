@@ -0,0 +1,63 @@
+//==============================================================================
+// Streaming Log Writer - Preallocated Contiguous Files on SD
+//
+// For captures that must keep up with a data stream (UART, SLIP, ADC):
+// the file is preallocated contiguously with f_expand() at open, so writes
+// never touch the FAT. Data goes into a RAM ring split in two halves; when
+// one half is full it is written with one multi-block CMD25 while the
+// producer keeps filling the other.
+//
+// Usage:
+//   static uint8_t ring[2 * 8192] __attribute__((aligned(4)));
+//   log_writer_open(&lw, "UART.LOG", 4 * 1024 * 1024, ring, sizeof(ring));
+//   ISR:        log_writer_put(&lw, &byte, 1);
+//   main loop:  log_writer_poll(&lw);
+//   log_writer_close(&lw);   // writes the rest, trims the file
+//
+// log_writer_put() may run in one interrupt handler (a single producer)
+// while the main loop calls log_writer_poll(); no locking is needed.
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+
+#ifndef LOG_WRITER_H
+#define LOG_WRITER_H
+
+#include <stdint.h>
+#include "ff.h"
+
+typedef struct {
+    FIL      fil;
+    LBA_t    sector;                // First sector of the contiguous file
+    uint32_t capacity;              // Preallocated bytes
+    uint32_t committed;             // Bytes written to the card
+    uint8_t *half[2];               // Ring halves
+    uint32_t half_size;             // Bytes per half (multiple of 512)
+    volatile uint32_t accepted;     // Bytes taken by log_writer_put()
+    volatile uint32_t fill;         // Bytes in the half being filled
+    volatile uint32_t dropped;      // Bytes lost: both halves full or file full
+    volatile uint8_t  active;       // Half being filled
+    volatile uint8_t  pending;      // Other half full, waiting for log_writer_poll()
+    FRESULT  error;                 // First write error (later writes are skipped)
+} log_writer_t;
+
+// Create path (replacing it), preallocate size bytes contiguously and use
+// ring (ring_size / 2 per half, rounded down to sectors, at least 512).
+// FR_DENIED: no contiguous free space of that size.
+FRESULT log_writer_open(log_writer_t *lw, const char *path, FSIZE_t size,
+                        uint8_t *ring, uint32_t ring_size);
+
+// Append data; returns the bytes accepted (less than len when the ring or
+// the file is full, counted in lw->dropped). Interrupt safe, single producer.
+uint32_t log_writer_put(log_writer_t *lw, const void *data, uint32_t len);
+
+// Write a full half if there is one (one CMD25). Call often enough that a
+// half is written before the producer fills the other.
+FRESULT log_writer_poll(log_writer_t *lw);
+
+// Write what's left, trim the file to the bytes accepted and close it.
+// Stop the producer first.
+FRESULT log_writer_close(log_writer_t *lw);
+
+#endif // LOG_WRITER_H
@@ -9,40 +9,239 @@
 
 #include "overlay_loader.h"
 #include "crash_dump.h"
+#include "crash_sd.h"
 #include "hardware.h"
+#include "io.h"
 #include <stdio.h>
 #include <string.h>
+#include "../../lib/crc32.h"
+#include "../../lib/perf_counters.h"
+#include "../../lib/mem_stats.h"
+#include "../../lib/irq.h"
+#include "diskio.h"
+#include "disk_cache.h"
+#include "sd_async.h"
+#include "sd_spi.h"
+#include "../overlay_sdk/common/overlay_format.h"
+#include <stddef.h>
 
 //==============================================================================
 // CRC32 Calculation (matches bootloader_fast.c and overlay_upload.c)
 //==============================================================================
 
-static uint32_t crc32_table[256];
-static uint8_t crc32_initialized = 0;
+// Calculate CRC32 of a memory block (hardware accelerator when present)
+uint32_t overlay_calculate_crc32(uint32_t start_addr, uint32_t end_addr) {
+    return crc32_calc((const void *)start_addr, end_addr - start_addr + 1);
+}
+
+//==============================================================================
+// Fast-Seek File Access
+//==============================================================================
+
+FRESULT overlay_file_open(overlay_file_t *of, const char *path) {
+    FRESULT fr;
+
+    of->fast = 0;
+    fr = f_open(&of->fil, path, FA_READ);
+    if (fr != FR_OK) {
+        return fr;
+    }
+
+    // Build the link map once: fragment list [count, start cluster]...
+    of->fil.cltbl = of->clmt;
+    of->clmt[0] = OVERLAY_CLMT_SIZE;
+    fr = f_lseek(&of->fil, CREATE_LINKMAP);
+    if (fr == FR_OK) {
+        of->fast = 1;
+    } else if (fr == FR_NOT_ENOUGH_CORE) {
+        of->fil.cltbl = NULL;               // Too fragmented: follow the FAT
+        fr = FR_OK;
+    } else {
+        f_close(&of->fil);
+    }
+
+    return fr;
+}
+
+// Sectors from the file pointer to the end of its fragment, and the LBA of
+// the first. The pointer must be sector aligned
+static UINT fast_span(overlay_file_t *of, LBA_t *sect) {
+    FATFS *fs = of->fil.obj.fs;
+    DWORD sector = (DWORD)(of->fil.fptr / FF_MAX_SS);
+    DWORD cl = sector / fs->csize;
+    DWORD csect = sector % fs->csize;
+    const DWORD *tbl = of->clmt + 1;
+
+    while (tbl[0] != 0 && cl >= tbl[0]) {
+        cl -= tbl[0];
+        tbl += 2;
+    }
+    if (tbl[0] == 0) {
+        return 0;                           // Past the map: not expected
+    }
+
+    *sect = fs->database + (LBA_t)(tbl[1] + cl - 2) * fs->csize + csect;
+    return (UINT)((tbl[0] - cl) * fs->csize - csect);
+}
+
+// Where the last overlay_load() spent its time (cycles), for the
+// overlay_execute() screen
+static struct {
+    uint32_t total;
+    uint32_t read;              // File reads, CRC taken during them included
+    uint32_t crc;               // All CRC32 work
+    uint32_t crc_overlap;       // Of which while the card was still sending
+    uint32_t bytes;
+    uint8_t  valid;             // Set by overlay_load(), cleared once shown
+} s_load_time;
+
+static uint32_t timed_crc(uint32_t crc, const void *data, uint32_t len, int overlap) {
+    uint32_t t = rdcycle();
+
+    crc = crc32_update(crc, data, len);
+    t = rdcycle() - t;
+    s_load_time.crc += t;
+    if (overlap) {
+        s_load_time.crc_overlap += t;
+    }
+    return crc;
+}
 
-static void crc32_init(void) {
-    if (crc32_initialized) return;
+#define CYCLES_MS(c)    ((unsigned long)((c) / (uint32_t)(PERF_CPU_HZ / 1000)))
 
-    for (uint32_t i = 0; i < 256; i++) {
-        uint32_t crc = i;
-        for (int j = 0; j < 8; j++) {
-            crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320 : 0);
+static void load_time_done(uint32_t t0, uint32_t bytes) {
+    s_load_time.total = rdcycle() - t0;
+    s_load_time.bytes = bytes;
+    s_load_time.valid = 1;
+    printf("Load time: %lu ms\r\n", CYCLES_MS(s_load_time.total));
+}
+
+// count sectors from the card into dst through the request queue, the
+// CRC of each sector taken as soon as it is in while the rest of the
+// stream keeps coming (DMA)
+static FRESULT read_sectors_crc(uint8_t *dst, LBA_t sect, UINT count, uint32_t *crc) {
+    sd_async_req_t req = { .sector = (uint32_t)sect, .buffer = dst, .count = count };
+    uint32_t checked = 0;
+
+    // Pending writes first: the queue reads the card behind the cache
+    if (disk_cache_flush() != 0 || sd_async_submit(&req) != SD_OK) {
+        return FR_DISK_ERR;
+    }
+
+    while (!sd_async_done(&req) || checked < req.completed) {
+        sd_async_poll();
+        if (checked < req.completed) {
+            *crc = timed_crc(*crc, dst + checked * FF_MAX_SS, FF_MAX_SS, !sd_async_done(&req));
+            checked++;
         }
-        crc32_table[i] = crc;
     }
-    crc32_initialized = 1;
+
+    return (req.result == SD_OK) ? FR_OK : FR_DISK_ERR;
 }
 
-// Calculate CRC32 of a memory block
-uint32_t overlay_calculate_crc32(uint32_t start_addr, uint32_t end_addr) {
-    crc32_init();
+// overlay_file_read(), with the CRC32 of the data continued in *crc when
+// crc is set
+static FRESULT file_read(overlay_file_t *of, void *dest, UINT btr, UINT *br, uint32_t *crc) {
+    FIL *fp = &of->fil;
+    uint8_t *dst = (uint8_t *)dest;
+    FSIZE_t remain = f_size(fp) - fp->fptr;
+    FRESULT fr = FR_OK;
+    UINT n, got, count;
+    LBA_t sect;
 
-    uint32_t crc = 0xFFFFFFFF;
-    for (uint32_t addr = start_addr; addr <= end_addr; addr++) {
-        uint8_t byte = *((uint8_t *)addr);
-        crc = (crc >> 8) ^ crc32_table[(crc ^ byte) & 0xFF];
+    if (!of->fast) {
+        fr = f_read(fp, dest, btr, br);
+        if (crc) {
+            *crc = timed_crc(*crc, dest, *br, 0);
+        }
+        return fr;
     }
-    return ~crc;
+
+    *br = 0;
+    if (btr > remain) {
+        btr = (UINT)remain;
+    }
+
+    // Head up to the next sector boundary through the sector window
+    n = (UINT)((FF_MAX_SS - fp->fptr % FF_MAX_SS) % FF_MAX_SS);
+    if (n > btr) {
+        n = btr;
+    }
+    if (n > 0) {
+        fr = f_read(fp, dst, n, &got);
+        *br += got;
+        if (crc) {
+            *crc = timed_crc(*crc, dst, got, 0);
+        }
+        if (fr != FR_OK || got != n) {
+            return fr;
+        }
+        dst += n;
+        btr -= n;
+    }
+
+    // Whole sectors straight into dest, one multi-block read per fragment
+    while (btr >= FF_MAX_SS) {
+        count = fast_span(of, &sect);
+        if (count == 0) {
+            return FR_INT_ERR;
+        }
+        if (count > btr / FF_MAX_SS) {
+            count = btr / FF_MAX_SS;
+        }
+
+        if (crc && fp->obj.fs->pdrv == 0) {
+            // SD card: checked while the fragment streams in
+            fr = read_sectors_crc(dst, sect, count, crc);
+            if (fr != FR_OK) {
+                return fr;
+            }
+        } else {
+            if (disk_read(fp->obj.fs->pdrv, dst, sect, count) != RES_OK) {
+                return FR_DISK_ERR;
+            }
+            if (crc) {
+                *crc = timed_crc(*crc, dst, count * FF_MAX_SS, 0);
+            }
+        }
+
+        // Cheap with the link map: no FAT access, aligned so no sector load
+        n = count * FF_MAX_SS;
+        fr = f_lseek(fp, fp->fptr + n);
+        if (fr != FR_OK) {
+            return fr;
+        }
+        *br += n;
+        dst += n;
+        btr -= n;
+    }
+
+    // Tail
+    if (btr > 0) {
+        fr = f_read(fp, dst, btr, &got);
+        *br += got;
+        if (crc) {
+            *crc = timed_crc(*crc, dst, got, 0);
+        }
+    }
+
+    return fr;
+}
+
+FRESULT overlay_file_read(overlay_file_t *of, void *dest, UINT btr, UINT *br) {
+    return overlay_file_read_crc(of, dest, btr, br, NULL);
+}
+
+FRESULT overlay_file_read_crc(overlay_file_t *of, void *dest, UINT btr, UINT *br, uint32_t *crc) {
+    uint32_t t = rdcycle();
+    FRESULT fr = file_read(of, dest, btr, br, crc);
+
+    s_load_time.read += rdcycle() - t;
+    return fr;
+}
+
+FRESULT overlay_file_close(overlay_file_t *of) {
+    return f_close(&of->fil);
 }
 
 //==============================================================================
@@ -63,7 +262,7 @@ FRESULT overlay_browse(overlay_list_t *list) {
         return fr;
     }
 
-    // Scan directory for .BIN files
+    // Scan directory for .BIN and .OVL files
     while (1) {
         fr = f_readdir(&dir, &fno);
         if (fr != FR_OK || fno.fname[0] == 0) {
@@ -79,7 +278,9 @@ FRESULT overlay_browse(overlay_list_t *list) {
         if (len < 4) continue;
 
         if (strcmp(&fno.fname[len - 4], ".BIN") == 0 ||
-            strcmp(&fno.fname[len - 4], ".bin") == 0) {
+            strcmp(&fno.fname[len - 4], ".bin") == 0 ||
+            strcmp(&fno.fname[len - 4], ".OVL") == 0 ||
+            strcmp(&fno.fname[len - 4], ".ovl") == 0) {
 
             // Add to list (if space available)
             if (list->count < 16) {
@@ -108,34 +309,502 @@ FRESULT overlay_browse(overlay_list_t *list) {
     return FR_OK;
 }
 
+//==============================================================================
+// Image Cache
+//==============================================================================
+
+// fdate/ftime of the overlay, so a replaced file does not match
+static uint32_t file_stamp(const char *path) {
+    FILINFO fno;
+
+    if (f_stat(path, &fno) != FR_OK) {
+        return 0;
+    }
+    return ((uint32_t)fno.fdate << 16) | fno.ftime;
+}
+
+// Code size from the descriptor overlay_start.S puts after the entry jump;
+// 0 for overlays built without it
+static uint32_t descriptor_code_size(const uint8_t *image, uint32_t size) {
+    const uint32_t *w = (const uint32_t *)image;
+
+    if (size < 12 || w[1] != OVERLAY_DESC_MAGIC || w[2] > size) {
+        return 0;
+    }
+    return w[2];
+}
+
+// The flat image last loaded into the execution slot, next to the service
+// table in .overlay_comm: what overlay_load() checks before reading the
+// same file again
+overlay_cache_t overlay_image_cache __attribute__((section(".overlay_comm.cache"), used));
+
+void overlay_cache_invalidate(void) {
+    overlay_image_cache.magic = 0;
+}
+
+static void cache_record(const char *path, uint32_t stamp, const uint8_t *image,
+                         uint32_t size, uint32_t crc) {
+    overlay_cache_t *c = &overlay_image_cache;
+
+    strncpy(c->path, path, sizeof(c->path) - 1);
+    c->path[sizeof(c->path) - 1] = '\0';
+    c->size = size;
+    c->stamp = stamp;
+    c->code_size = descriptor_code_size(image, size);
+    c->code_crc = crc32_calc(image, c->code_size);
+    c->crc32 = crc;
+    c->magic = OVERLAY_CACHE_MAGIC;
+}
+
+// Is the file's image still in SRAM? Unchanged code with data the last run
+// wrote to: only the bytes after the code are read again. 1 if the image
+// is whole (CRC32 as recorded), 0 if it has to be loaded.
+static int cache_reuse(overlay_file_t *of, const char *path, uint8_t *image, uint32_t size) {
+    const overlay_cache_t *c = &overlay_image_cache;
+    uint32_t crc, tail;
+    UINT br;
+
+    if (c->magic != OVERLAY_CACHE_MAGIC || c->size != size ||
+        strncmp(c->path, path, sizeof(c->path)) != 0 || c->stamp != file_stamp(path)) {
+        return 0;
+    }
+
+    if (timed_crc(0, image, size, 0) == c->crc32) {
+        printf("Image still in SRAM (CRC32 0x%08lX): not read again\r\n",
+               (unsigned long)c->crc32);
+        return 1;
+    }
+    if (c->code_size == 0 || c->code_size == size ||
+        timed_crc(0, image, c->code_size, 0) != c->code_crc) {
+        return 0;
+    }
+
+    // Only the data changed since the load: read it again
+    tail = size - c->code_size;
+    crc = c->code_crc;
+    if (f_lseek(&of->fil, c->code_size) != FR_OK ||
+        overlay_file_read_crc(of, image + c->code_size, tail, &br, &crc) != FR_OK ||
+        br != tail || crc != c->crc32) {
+        return 0;
+    }
+    printf("Code still in SRAM: %lu bytes of data read again\r\n", (unsigned long)tail);
+    return 1;
+}
+
+//==============================================================================
+// Lazy Page Loading
+//==============================================================================
+
+#ifdef CONFIG_OVERLAY_LAZY_LOAD
+
+#define PAGE_SECTORS        (OVERLAY_PAGE_SIZE / FF_MAX_SS)
+
+// Faults this soon after the jump mark a page hot: read up front next time
+#define HOT_WINDOW_MS       500
+
+static struct {
+    overlay_pgt_t pgt;                  // Page table of the loaded overlay
+    LBA_t lba[OVERLAY_MAX_PAGES];       // First sector of each lazy page
+    BYTE pdrv;
+    uint32_t base;
+    uint32_t pages;
+    volatile uint32_t missing;          // Lazy pages still zero filled
+    volatile uint32_t touched;          // Pages faulted in during the window
+    uint32_t demand;                    // Pages loaded by a fault
+    uint32_t start;                     // rdcycle() at the jump
+    uint8_t window;                     // Still in the startup window
+    uint8_t running;                    // Jumped to with pages missing
+    char pgt_path[64];
+} s_lazy;
+
+static uint32_t popcount32(uint32_t m) {
+    uint32_t n = 0;
+
+    for (; m; m &= m - 1) {
+        n++;
+    }
+    return n;
+}
+
+static uint32_t page_bytes(uint32_t size, uint32_t page) {
+    uint32_t off = page * OVERLAY_PAGE_SIZE;
+    return size - off < OVERLAY_PAGE_SIZE ? size - off : OVERLAY_PAGE_SIZE;
+}
+
+static uint32_t pgt_table_crc(const overlay_pgt_t *pgt) {
+    return crc32_calc(pgt, offsetof(overlay_pgt_t, table_crc));
+}
+
+// NAME.BIN -> NAME.PGT
+static void pgt_path(char *path, size_t len, const char *filename) {
+    const char *dot = strrchr(filename, '.');
+    int n = dot ? (int)(dot - filename) : (int)strlen(filename);
+
+    snprintf(path, len, "%s/%.*s.PGT", OVERLAY_DIR, n, filename);
+}
+
+static void pgt_build(overlay_pgt_t *pgt, const uint8_t *image, uint32_t size,
+                      uint32_t code_size, uint32_t stamp) {
+    uint32_t pages = (size + OVERLAY_PAGE_SIZE - 1) / OVERLAY_PAGE_SIZE;
+
+    memset(pgt, 0, sizeof(*pgt));
+    pgt->magic = OVERLAY_PGT_MAGIC;
+    pgt->size = size;
+    pgt->stamp = stamp;
+    pgt->code_size = code_size;
+    for (uint32_t i = 0; i < pages; i++) {
+        pgt->crc[i] = crc32_calc(image + i * OVERLAY_PAGE_SIZE, page_bytes(size, i));
+    }
+}
+
+static FRESULT pgt_save(const char *path, overlay_pgt_t *pgt) {
+    FIL fil;
+    UINT bw;
+    FRESULT fr;
+
+    pgt->table_crc = pgt_table_crc(pgt);
+    fr = f_open(&fil, path, FA_WRITE | FA_CREATE_ALWAYS);
+    if (fr != FR_OK) {
+        return fr;
+    }
+    fr = f_write(&fil, pgt, sizeof(*pgt), &bw);
+    if (fr == FR_OK && bw != sizeof(*pgt)) {
+        fr = FR_DISK_ERR;
+    }
+    if (f_close(&fil) != FR_OK && fr == FR_OK) {
+        fr = FR_DISK_ERR;
+    }
+    return fr;
+}
+
+static int pgt_read(const char *path, overlay_pgt_t *pgt) {
+    FIL fil;
+    UINT br;
+    int ok;
+
+    if (f_open(&fil, path, FA_READ) != FR_OK) {
+        return 0;
+    }
+    ok = f_read(&fil, pgt, sizeof(*pgt), &br) == FR_OK && br == sizeof(*pgt) &&
+         pgt->magic == OVERLAY_PGT_MAGIC && pgt->table_crc == pgt_table_crc(pgt);
+    f_close(&fil);
+    return ok;
+}
+
+// Read lazy page i by LBA, check it, write it back for instruction fetch.
+// Safe in interrupt context: no FatFS, only disk_read(), and the CRC
+// accelerator's running value is put back for the interrupted code
+static int lazy_read_page(uint32_t page) {
+    uint8_t *dst = (uint8_t *)(s_lazy.base + page * OVERLAY_PAGE_SIZE);
+    uint32_t bit = 1u << page;
+    int hw = crc32_hw_present();
+    uint32_t saved = hw ? CRC32_ACCEL_VALUE : 0;
+    int ok = 0;
+
+    for (int attempt = 0; attempt < 2 && !ok; attempt++) {
+        ok = disk_read(s_lazy.pdrv, dst, s_lazy.lba[page], PAGE_SECTORS) == RES_OK &&
+             crc32_calc(dst, OVERLAY_PAGE_SIZE) == s_lazy.pgt.crc[page];
+    }
+    if (hw) {
+        CRC32_ACCEL_VALUE = saved;
+    }
+
+    if (!ok) {
+        memset(dst, 0, OVERLAY_PAGE_SIZE);  // Keep it trapping
+        return 0;
+    }
+
+    cache_sync_code((uint32_t)dst, OVERLAY_PAGE_SIZE);
+    s_lazy.missing &= ~bit;
+    return 1;
+}
+
+// With compressed instructions a 32-bit instruction can start in the last
+// halfword of a page; its upper half must not come from a zero page
+static int lazy_read_page_and_tail(uint32_t page) {
+    if (!lazy_read_page(page)) {
+        return 0;
+    }
+#ifdef __riscv_compressed
+    while (page + 1 < s_lazy.pages && (s_lazy.missing & (1u << (page + 1)))) {
+        const uint16_t *last = (const uint16_t *)(s_lazy.base + (page + 1) * OVERLAY_PAGE_SIZE) - 1;
+        if ((*last & 3) != 3 || !lazy_read_page(++page)) {
+            break;
+        }
+    }
+#endif
+    return 1;
+}
+
+// Read the pages overlay_load() can load lazily: whole pages of code after
+// page 0, not hot, each in one contiguous run of sectors. 0 if the file
+// can't be loaded lazily (no fast seek)
+static uint32_t lazy_plan(overlay_file_t *of, uint32_t code_size) {
+    uint32_t lazy = 0;
+
+    if (!of->fast) {
+        return 0;
+    }
+
+    for (uint32_t i = 1; (i + 1) * OVERLAY_PAGE_SIZE <= code_size; i++) {
+        LBA_t sect;
+
+        if (s_lazy.pgt.hot & (1u << i)) {
+            continue;
+        }
+        if (f_lseek(&of->fil, (FSIZE_t)i * OVERLAY_PAGE_SIZE) != FR_OK ||
+            fast_span(of, &sect) < PAGE_SECTORS) {
+            continue;                       // Crosses a fragment: read it now
+        }
+        s_lazy.lba[i] = sect;
+        lazy |= 1u << i;
+    }
+
+    return lazy;
+}
+
+// Load the rest of a file whose page 0 is at load_ptr: lazy pages zero
+// filled, the others read and checked against the page table. 0 if a page
+// does not match (stale table)
+static int lazy_load_rest(overlay_file_t *of, uint8_t *load_ptr, uint32_t size, uint32_t lazy) {
+    UINT br;
+
+    for (uint32_t i = 1; i < s_lazy.pages; i++) {
+        uint8_t *dst = load_ptr + i * OVERLAY_PAGE_SIZE;
+        uint32_t n = page_bytes(size, i);
+
+        if (lazy & (1u << i)) {
+            memset(dst, 0, n);
+            continue;
+        }
+        if (f_lseek(&of->fil, (FSIZE_t)i * OVERLAY_PAGE_SIZE) != FR_OK ||
+            overlay_file_read(of, dst, n, &br) != FR_OK || br != n ||
+            crc32_calc(dst, n) != s_lazy.pgt.crc[i]) {
+            return 0;
+        }
+    }
+
+    s_lazy.missing = lazy;
+
+    // Loaded pages whose last instruction runs into a lazy one
+#ifdef __riscv_compressed
+    for (uint32_t i = 0; i + 1 < s_lazy.pages; i++) {
+        if (!(s_lazy.missing & (1u << i)) && (s_lazy.missing & (1u << (i + 1)))) {
+            const uint16_t *last = (const uint16_t *)(load_ptr + (i + 1) * OVERLAY_PAGE_SIZE) - 1;
+            if ((*last & 3) == 3 && !lazy_read_page_and_tail(i + 1)) {
+                return 0;
+            }
+        }
+    }
+#endif
+
+    return 1;
+}
+
+int overlay_page_fault(uint32_t pc) {
+    uint32_t page;
+
+    if (!s_lazy.missing || pc < s_lazy.base ||
+        pc >= s_lazy.base + s_lazy.pages * OVERLAY_PAGE_SIZE) {
+        return 0;
+    }
+
+    page = (pc - s_lazy.base) / OVERLAY_PAGE_SIZE;
+    if (!(s_lazy.missing & (1u << page))) {
+        return 0;                           // A real illegal instruction
+    }
+
+    if (s_lazy.window &&
+        rdcycle() - s_lazy.start >= HOT_WINDOW_MS * (uint32_t)(PERF_CPU_HZ / 1000)) {
+        s_lazy.window = 0;
+    }
+    if (s_lazy.window) {
+        s_lazy.touched |= 1u << page;
+    }
+
+    s_lazy.demand++;
+    return lazy_read_page_and_tail(page);
+}
+
+void overlay_page_in_all(void) {
+    for (uint32_t i = 1; s_lazy.missing && i < s_lazy.pages; i++) {
+        if (s_lazy.missing & (1u << i)) {
+            lazy_read_page(i);
+        }
+    }
+}
+
+FRESULT overlay_write_page_table(const char *filename, const uint8_t *image, uint32_t size) {
+    overlay_pgt_t pgt;
+    char path[64];
+    char pgt_file[64];
+    uint32_t code_size = descriptor_code_size(image, size);
+
+    pgt_path(pgt_file, sizeof(pgt_file), filename);
+    if (code_size < 2 * OVERLAY_PAGE_SIZE || size > OVERLAY_EXEC_SIZE) {
+        f_unlink(pgt_file);                 // Nothing to load lazily
+        return FR_OK;
+    }
+
+    snprintf(path, sizeof(path), "%s/%s", OVERLAY_DIR, filename);
+    pgt_build(&pgt, image, size, code_size, file_stamp(path));
+    return pgt_save(pgt_file, &pgt);
+}
+
+#else
+
+int overlay_page_fault(uint32_t pc) {
+    (void)pc;
+    return 0;
+}
+
+void overlay_page_in_all(void) {
+}
+
+FRESULT overlay_write_page_table(const char *filename, const uint8_t *image, uint32_t size) {
+    (void)filename;
+    (void)image;
+    (void)size;
+    return FR_OK;
+}
+
+#endif // CONFIG_OVERLAY_LAZY_LOAD
+
+//==============================================================================
+// Relocatable Container (.ovl)
+//==============================================================================
+
+#define RELOC_CHUNK         64          // Relocation entries read at a time
+
+// Load the container whose header is hdr (file positioned after it) to
+// load_addr: segments read straight into place, the rest of mem_size zero
+// filled, then every listed word moved by load_addr - link_base
+static FRESULT overlay_load_container(overlay_file_t *of, const ovl_header_t *hdr,
+                                      uint32_t load_addr) {
+    ovl_segment_t segs[OVL_MAX_SEGMENTS];
+    uint32_t relocs[RELOC_CHUNK];
+    uint8_t *dst = (uint8_t *)load_addr;
+    uint32_t delta = load_addr - hdr->link_base;
+    uint32_t crc, filled = 0, stored = 0;
+    UINT n, br;
+    FRESULT fr;
+
+    if (hdr->version != OVL_VERSION ||
+        hdr->header_crc != crc32_calc(hdr, offsetof(ovl_header_t, header_crc))) {
+        printf("Error: Bad overlay container header\r\n");
+        return FR_INT_ERR;
+    }
+    if (hdr->mem_size < 4 || hdr->mem_size > OVERLAY_EXEC_SIZE || hdr->entry >= hdr->mem_size ||
+        hdr->flat_size > hdr->mem_size || hdr->data_offset > hdr->flat_size ||
+        hdr->segments > OVL_MAX_SEGMENTS || (load_addr & 3)) {
+        printf("Error: Container needs %lu bytes at a word address (max %lu)\r\n",
+               (unsigned long)hdr->mem_size, (unsigned long)OVERLAY_EXEC_SIZE);
+        return FR_INVALID_PARAMETER;
+    }
+
+    n = hdr->segments * sizeof(ovl_segment_t);
+    fr = overlay_file_read(of, segs, n, &br);
+    if (fr != FR_OK || br != n) {
+        return fr != FR_OK ? fr : FR_INT_ERR;
+    }
+    crc = timed_crc(0, segs, n, 0);
+
+    // Segments in offset order; the gaps between them (and .bss) are zeros
+    for (uint32_t i = 0; i < hdr->segments; i++) {
+        const ovl_segment_t *sg = &segs[i];
+
+        if (sg->offset < filled || sg->size > hdr->mem_size - sg->offset) {
+            printf("Error: Bad segment %lu\r\n", (unsigned long)i);
+            return FR_INT_ERR;
+        }
+        memset(dst + filled, 0, sg->offset - filled);
+        fr = overlay_file_read_crc(of, dst + sg->offset, sg->size, &br, &crc);
+        if (fr != FR_OK || br != sg->size) {
+            return fr != FR_OK ? fr : FR_INT_ERR;
+        }
+        filled = sg->offset + sg->size;
+        stored += sg->size;
+    }
+    memset(dst + filled, 0, hdr->mem_size - filled);
+
+    for (uint32_t done = 0; done < hdr->relocs; done += n / 4) {
+        n = (hdr->relocs - done < RELOC_CHUNK ? hdr->relocs - done : RELOC_CHUNK) * 4;
+        fr = overlay_file_read(of, relocs, n, &br);
+        if (fr != FR_OK || br != n) {
+            return fr != FR_OK ? fr : FR_INT_ERR;
+        }
+        crc = timed_crc(crc, relocs, n, 0);
+
+        for (uint32_t i = 0; i < n / 4; i++) {
+            if (relocs[i] > hdr->mem_size - 4 || (relocs[i] & 3)) {
+                printf("Error: Bad relocation 0x%08lX\r\n", (unsigned long)relocs[i]);
+                return FR_INT_ERR;
+            }
+            *(uint32_t *)(dst + relocs[i]) += delta;
+        }
+    }
+
+    if (crc != hdr->crc32) {
+        printf("Error: Container CRC mismatch (0x%08lX, expected 0x%08lX)\r\n",
+               (unsigned long)crc, (unsigned long)hdr->crc32);
+        return FR_INT_ERR;
+    }
+
+    // Anywhere other than the execution slot, overlay_execute() won't
+    if (load_addr != OVERLAY_EXEC_BASE) {
+        cache_sync_code(load_addr, hdr->mem_size);
+    }
+
+    printf("Container: %lu segments, %lu relocations, %lu bytes zero filled\r\n",
+           (unsigned long)hdr->segments, (unsigned long)hdr->relocs,
+           (unsigned long)(hdr->mem_size - stored));
+    return FR_OK;
+}
+
 //==============================================================================
 // Load Overlay from SD Card to RAM
 //==============================================================================
 
+static void fill_info(overlay_info_t *info, const char *filename, uint32_t size,
+                      uint32_t crc, uint32_t load_addr, uint32_t entry_point) {
+    if (info) {
+        strncpy(info->filename, filename, MAX_OVERLAY_NAME - 1);
+        info->filename[MAX_OVERLAY_NAME - 1] = '\0';
+        info->size = size;
+        info->crc32 = crc;
+        info->load_addr = load_addr;
+        info->entry_point = entry_point;
+    }
+}
+
 FRESULT overlay_load(const char *filename, uint32_t load_addr, overlay_info_t *info) {
-    FIL file;
+    overlay_file_t file;
     FRESULT fr;
     UINT bytes_read;
     char path[64];
+    uint32_t t0 = rdcycle();
+
+    memset(&s_load_time, 0, sizeof(s_load_time));
 
     // Build full path
     snprintf(path, sizeof(path), "%s/%s", OVERLAY_DIR, filename);
 
     // Open file
-    fr = f_open(&file, path, FA_READ);
+    fr = overlay_file_open(&file, path);
     if (fr != FR_OK) {
         printf("Error: Cannot open %s (error %d)\r\n", path, fr);
         return fr;
     }
 
     // Get file size
-    uint32_t file_size = f_size(&file);
+    uint32_t file_size = f_size(&file.fil);
 
     // Validate size
     if (file_size == 0 || file_size > OVERLAY_EXEC_SIZE) {
         printf("Error: Invalid overlay size %lu bytes (max %lu)\r\n",
                (unsigned long)file_size, (unsigned long)OVERLAY_EXEC_SIZE);
-        f_close(&file);
+        overlay_file_close(&file);
         return FR_INVALID_PARAMETER;
     }
 
@@ -145,34 +814,133 @@ FRESULT overlay_load(const char *filename, uint32_t load_addr, overlay_info_t *i
            (unsigned long)(file_size / 1024));
     printf("Load address: 0x%08lX\r\n", (unsigned long)load_addr);
 
-    // Read entire file to RAM
     uint8_t *load_ptr = (uint8_t *)load_addr;
-    fr = f_read(&file, load_ptr, file_size, &bytes_read);
+    uint8_t loaded = 0;
 
-    if (fr != FR_OK || bytes_read != file_size) {
-        printf("Error: Read failed (error %d, read %u/%lu bytes)\r\n",
-               fr, bytes_read, (unsigned long)file_size);
-        f_close(&file);
-        return fr;
+    // Relocatable container (tools/ovlpack): any word-aligned load_addr
+    ovl_header_t hdr;
+    fr = f_read(&file.fil, &hdr, sizeof(hdr), &bytes_read);
+    if (fr == FR_OK && bytes_read == sizeof(hdr) && hdr.magic == OVL_MAGIC) {
+#ifdef CONFIG_OVERLAY_LAZY_LOAD
+        s_lazy.missing = 0;                 // No pages left from a flat load
+#endif
+        overlay_cache_invalidate();
+        fr = overlay_load_container(&file, &hdr, load_addr);
+        overlay_file_close(&file);
+        if (fr != FR_OK) {
+            return fr;
+        }
+
+        load_time_done(t0, hdr.mem_size);
+        fill_info(info, filename, hdr.mem_size, hdr.crc32, load_addr, load_addr + hdr.entry);
+        printf("✓ Overlay loaded successfully\r\n");
+        return FR_OK;
     }
+    f_lseek(&file.fil, 0);
 
-    f_close(&file);
+    // Flat image linked at OVERLAY_EXEC_BASE. Same file as last time in
+    // the execution slot: what is still there need not be read.
+    if (load_addr == OVERLAY_EXEC_BASE &&
+        cache_reuse(&file, path, load_ptr, file_size)) {
+        overlay_file_close(&file);
+#ifdef CONFIG_OVERLAY_LAZY_LOAD
+        s_lazy.missing = 0;
+#endif
+        load_time_done(t0, file_size);
+        fill_info(info, filename, file_size, overlay_image_cache.crc32, load_addr, load_addr);
+        printf("✓ Overlay loaded successfully\r\n");
+        return FR_OK;
+    }
+    overlay_cache_invalidate();
+    f_lseek(&file.fil, 0);
 
-    // Calculate CRC32 of loaded overlay
-    uint32_t crc = overlay_calculate_crc32(load_addr, load_addr + file_size - 1);
+#ifdef CONFIG_OVERLAY_LAZY_LOAD
+    // Page 0 first: the descriptor says how much of the image is code
+    uint32_t first = page_bytes(file_size, 0);
+    uint32_t code_size = 0;
+    uint8_t have_pgt = 0;
 
-    printf("CRC32: 0x%08lX\r\n", (unsigned long)crc);
+    memset(&s_lazy, 0, sizeof(s_lazy));
+    s_lazy.base = load_addr;
+    s_lazy.pages = (file_size + OVERLAY_PAGE_SIZE - 1) / OVERLAY_PAGE_SIZE;
+    s_lazy.pdrv = file.fil.obj.fs->pdrv;
+    pgt_path(s_lazy.pgt_path, sizeof(s_lazy.pgt_path), filename);
 
-    // Populate overlay info
-    if (info) {
-        strncpy(info->filename, filename, MAX_OVERLAY_NAME - 1);
-        info->filename[MAX_OVERLAY_NAME - 1] = '\0';
-        info->size = file_size;
-        info->crc32 = crc;
-        info->load_addr = load_addr;
-        info->entry_point = load_addr;  // Entry point is at start of overlay
+    fr = overlay_file_read(&file, load_ptr, first, &bytes_read);
+    if (fr == FR_OK && bytes_read == first) {
+        code_size = descriptor_code_size(load_ptr, file_size);
+    }
+    if (code_size >= 2 * OVERLAY_PAGE_SIZE && load_addr == OVERLAY_EXEC_BASE) {
+        have_pgt = pgt_read(s_lazy.pgt_path, &s_lazy.pgt) &&
+                   s_lazy.pgt.size == file_size &&
+                   s_lazy.pgt.stamp == file_stamp(path) &&
+                   s_lazy.pgt.code_size == code_size &&
+                   s_lazy.pgt.crc[0] == crc32_calc(load_ptr, first);
+    }
+
+    if (have_pgt) {
+        uint32_t lazy = lazy_plan(&file, code_size);
+
+        loaded = lazy_load_rest(&file, load_ptr, file_size, lazy);
+        if (!loaded) {
+            s_lazy.missing = 0;             // Stale table: read it all below
+        } else if (s_lazy.missing) {
+            printf("Lazy load: %lu of %lu pages on first use\r\n",
+                   (unsigned long)popcount32(s_lazy.missing), (unsigned long)s_lazy.pages);
+        }
+    }
+    f_lseek(&file.fil, 0);
+#endif
+
+    uint32_t crc = 0;
+    uint8_t have_crc = 0;
+
+    if (!loaded) {
+        // Read entire file to RAM (straight from the card for whole sectors,
+        // CRC32 taken as they stream in)
+        fr = overlay_file_read_crc(&file, load_ptr, file_size, &bytes_read, &crc);
+
+        if (fr != FR_OK || bytes_read != file_size) {
+            printf("Error: Read failed (error %d, read %u/%lu bytes)\r\n",
+                   fr, bytes_read, (unsigned long)file_size);
+            overlay_file_close(&file);
+            return fr;
+        }
+        have_crc = 1;
     }
 
+    overlay_file_close(&file);
+
+#ifdef CONFIG_OVERLAY_LAZY_LOAD
+    // First load of an overlay with a descriptor: page table for next time
+    if (!loaded && code_size >= 2 * OVERLAY_PAGE_SIZE && load_addr == OVERLAY_EXEC_BASE) {
+        pgt_build(&s_lazy.pgt, load_ptr, file_size, code_size, file_stamp(path));
+        if (pgt_save(s_lazy.pgt_path, &s_lazy.pgt) == FR_OK) {
+            printf("Page table saved: next load is lazy\r\n");
+        }
+    }
+#endif
+
+    // CRC32 of the loaded overlay, unless the read took it (0 while pages
+    // are missing: each is checked against the page table as it comes in)
+#ifdef CONFIG_OVERLAY_LAZY_LOAD
+    if (!s_lazy.missing)
+#endif
+    {
+        if (!have_crc) {
+            crc = timed_crc(0, (const void *)load_addr, file_size, 0);
+        }
+        printf("CRC32: 0x%08lX\r\n", (unsigned long)crc);
+        if (load_addr == OVERLAY_EXEC_BASE) {
+            cache_record(path, file_stamp(path), load_ptr, file_size, crc);
+        }
+    }
+
+    load_time_done(t0, file_size);
+
+    // Entry point is at start of overlay
+    fill_info(info, filename, file_size, crc, load_addr, load_addr);
+
     printf("✓ Overlay loaded successfully\r\n");
     return FR_OK;
 }
@@ -208,19 +976,39 @@ void overlay_execute(uint32_t entry_point) {
     // Function pointer to overlay entry point
     typedef void (*overlay_func_t)(void);
     overlay_func_t overlay_entry = (overlay_func_t)entry_point;
+    // Sources the overlay's irq_register() calls enable are turned off
+    // again when it returns
+    uint32_t irqc_enable = irqc_present() ? IRQC_ENABLE : 0;
 
     printf("\r\n");
     printf("========================================\r\n");
     printf("Jumping to overlay at 0x%08lX...\r\n", (unsigned long)entry_point);
+    if (s_load_time.valid) {
+        // The CRC taken while sectors streamed in cost no load time
+        printf("Loaded %lu KB in %lu ms: read %lu ms, CRC32 %lu ms (%lu ms during the read)\r\n",
+               (unsigned long)(s_load_time.bytes / 1024), CYCLES_MS(s_load_time.total),
+               CYCLES_MS(s_load_time.read), CYCLES_MS(s_load_time.crc),
+               CYCLES_MS(s_load_time.crc_overlap));
+        s_load_time.valid = 0;
+    }
     printf("========================================\r\n");
     printf("\r\n");
 
-    // Small delay for printf to flush
-    for (volatile int i = 0; i < 100000; i++);
+    // Let the banner leave the UART before interrupts and the overlay start
+    fflush(stdout);
+    uart_flush();
+
+    // Watchdog only with Kconfig OVERLAY_WATCHDOG_MS: long-running overlays
+    // (e.g. Mandelbrot) do not kick it. It has its own counter, so every
+    // timer channel stays free for the overlay.
+#ifdef CONFIG_OVERLAY_WATCHDOG_MS
+    crash_watchdog_enable(CONFIG_OVERLAY_WATCHDOG_MS);
+#endif
 
-    // NOTE: Watchdog is NOT enabled here because overlays may need to use the
-    // timer hardware for their own purposes (e.g., Mandelbrot performance timing).
-    // The watchdog and overlay timer cannot coexist on the same hardware timer.
+    // Dump file for a crash, set up while FatFS is still trustworthy
+    if (crash_sd_prepare(CRASH_SD_PATH) != FR_OK) {
+        printf("No crash dump file (" CRASH_SD_PATH ")\r\n");
+    }
 
     // Enable ALL interrupts so overlays can use timer interrupts if needed
     // PicoRV32 maskirq: mask=0 enables all, mask=0xFFFFFFFF disables all
@@ -228,9 +1016,18 @@ void overlay_execute(uint32_t entry_point) {
     __asm__ volatile (".insn r 0x0B, 6, 3, %0, %1, x0" : "=r"(dummy) : "r"(0));
 
     printf("Interrupts enabled, calling overlay...\r\n");
+    fflush(stdout);
+    uart_flush();
+
+    // Write back the loaded image and drop stale instruction cache lines
+    cache_sync_code(OVERLAY_EXEC_BASE, OVERLAY_EXEC_SIZE);
 
-    // Small delay for printf to flush
-    for (volatile int i = 0; i < 100000; i++);
+#ifdef CONFIG_OVERLAY_LAZY_LOAD
+    // Start the window in which faulted pages count as startup pages
+    s_lazy.start = rdcycle();
+    s_lazy.running = s_lazy.missing != 0;
+    s_lazy.window = s_lazy.running;
+#endif
 
     // Jump to overlay!
     // The overlay is expected to:
@@ -250,6 +1047,37 @@ void overlay_execute(uint32_t entry_point) {
     // CRITICAL: Disable interrupts again before returning to SD card manager
     // SD card operations are NOT interrupt-safe and require interrupts disabled
     __asm__ volatile (".insn r 0x0B, 6, 3, %0, %1, x0" : "=r"(dummy) : "r"(~0));
+    if (irqc_present()) {
+        IRQC_ENABLE = irqc_enable;
+    }
+
+#ifdef CONFIG_OVERLAY_WATCHDOG_MS
+    crash_watchdog_disable();
+#endif
+    crash_sd_release();
+
+    // The overlay's heap and stack overwrite the stack paint
+    mem_stack_repaint();
+
+    overlay_services_reset();
+
+#ifdef CONFIG_OVERLAY_LAZY_LOAD
+    // Pages needed at startup are read up front next time
+    if (s_lazy.running) {
+        uint32_t hot = s_lazy.pgt.hot | s_lazy.touched;
+
+        printf("\r\nLazy load: %lu faulted in, %lu never loaded (of %lu pages)\r\n",
+               (unsigned long)s_lazy.demand, (unsigned long)popcount32(s_lazy.missing),
+               (unsigned long)s_lazy.pages);
+        if (hot != s_lazy.pgt.hot) {
+            s_lazy.pgt.hot = hot;
+            pgt_save(s_lazy.pgt_path, &s_lazy.pgt);
+        }
+    }
+    s_lazy.missing = 0;
+    s_lazy.window = 0;
+    s_lazy.running = 0;
+#endif
 
     // If we get here, overlay returned successfully
     printf("\r\n");
@@ -53,6 +53,89 @@ typedef struct {
     uint8_t count;                 // Number of overlays found
 } overlay_list_t;
 
+//==============================================================================
+// Fast-Seek File Access
+//==============================================================================
+
+// Cluster link map (CLMT) size in DWORDs: 1 + 2 per fragment, so up to
+// 31 fragments. More fragmented files still load, walking the FAT
+#define OVERLAY_CLMT_SIZE   64
+
+// A file opened with its cluster link map built once at open: seeks and
+// reads never touch the FAT, and sector-aligned spans are read straight
+// into the destination, one multi-block read per contiguous fragment
+typedef struct {
+    FIL fil;
+    DWORD clmt[OVERLAY_CLMT_SIZE];
+    uint8_t fast;                      // 1 when the link map is in use
+} overlay_file_t;
+
+//==============================================================================
+// Image Cache
+//==============================================================================
+//
+// overlay_load() records the flat image it put in the execution slot in
+// .overlay_comm (after the service table). Loading the same file again
+// (same path, size and date) checks SRAM first with the hardware CRC32:
+// an image the run left intact is used as it is, and one whose code is
+// intact but whose data the run wrote to has only the bytes after its
+// code (descriptor code size) read again. Anything else loads in full.
+
+#define OVERLAY_CACHE_MAGIC 0x4843564F  // "OVCH"
+
+typedef struct {
+    uint32_t magic;                     // OVERLAY_CACHE_MAGIC while valid
+    char     path[64];                  // "/OVERLAYS/NAME.BIN"
+    uint32_t size;                      // File and image size
+    uint32_t stamp;                     // File fdate << 16 | ftime
+    uint32_t code_size;                 // From the descriptor (0: none)
+    uint32_t code_crc;                  // CRC32 of the first code_size bytes
+    uint32_t crc32;                     // CRC32 of the image as loaded
+} overlay_cache_t;
+
+extern overlay_cache_t overlay_image_cache;
+
+//==============================================================================
+// Lazy Page Loading (Kconfig "Storage (SD/FatFS)", CONFIG_OVERLAY_LAZY_LOAD)
+//==============================================================================
+//
+// Overlays built with the SDK start with a descriptor (overlay_start.S):
+//
+//   +0  j _start_body
+//   +4  OVERLAY_DESC_MAGIC
+//   +8  size of .text
+//
+// The image is split in 4 KB pages with a CRC32 each, kept next to the
+// overlay in NAME.PGT (written at upload, or on the first load). Page 0,
+// data, rodata and any page recorded as used at startup are read before
+// the jump; the other whole pages of code are left zero filled. Zero is
+// an illegal instruction, so the first fetch from such a page traps into
+// irq_handler(), which reads the page by LBA (no FatFS), checks its CRC
+// and restarts the instruction. The first overlay timer interrupt reads
+// everything still missing, so handlers never fault. Pages faulted in
+// within the first 500 ms are marked hot in NAME.PGT and read up front
+// on the next load.
+//
+// Only code pages are lazy: a data access can't trap. Files without a
+// descriptor, or too fragmented for fast seek, load in full as before.
+
+#define OVERLAY_PAGE_SIZE   4096
+#define OVERLAY_MAX_PAGES   (OVERLAY_EXEC_SIZE / OVERLAY_PAGE_SIZE)
+
+#define OVERLAY_DESC_MAGIC  0x504C564F  // "OVLP"
+#define OVERLAY_PGT_MAGIC   0x5447504F  // "OPGT"
+
+// NAME.PGT layout
+typedef struct {
+    uint32_t magic;                     // OVERLAY_PGT_MAGIC
+    uint32_t size;                      // Overlay file size
+    uint32_t stamp;                     // Overlay fdate << 16 | ftime
+    uint32_t code_size;                 // From the descriptor
+    uint32_t hot;                       // Pages used at startup (bit per page)
+    uint32_t crc[OVERLAY_MAX_PAGES];    // CRC32 of each page (last one partial)
+    uint32_t table_crc;                 // CRC32 of the fields above
+} overlay_pgt_t;
+
 //==============================================================================
 // API Functions
 //==============================================================================
@@ -70,7 +153,11 @@ typedef struct {
 FRESULT overlay_browse(overlay_list_t *list);
 
 // Load overlay from SD card to RAM
-// Reads overlay binary from SD card and copies to execution address
+// Reads overlay binary from SD card and copies to execution address.
+// A relocatable container (.ovl, overlay_sdk/common/overlay_format.h) may
+// go to any word-aligned load_addr: .bss is zero filled, not read, and the
+// entry point is taken from its header. A flat .bin must be loaded at the
+// address it was linked for (OVERLAY_EXEC_BASE)
 //
 // Parameters:
 //   filename  - Name of overlay file (e.g., "HEXEDIT.BIN")
@@ -83,6 +170,47 @@ FRESULT overlay_browse(overlay_list_t *list);
 //
 FRESULT overlay_load(const char *filename, uint32_t load_addr, overlay_info_t *info);
 
+// Open a file for reading with fast seek
+// Builds the cluster link map; falls back to plain FatFS access (fast = 0)
+// when the file has more fragments than OVERLAY_CLMT_SIZE allows
+//
+// Parameters:
+//   of   - File object to initialize
+//   path - Full path of the file
+//
+// Returns:
+//   FR_OK on success
+//   FatFS error code on failure
+//
+FRESULT overlay_file_open(overlay_file_t *of, const char *path);
+
+// Read from a file opened with overlay_file_open()
+// Like f_read(), but whole sectors bypass the FatFS sector window and go
+// to dest in one disk_read() per contiguous run of clusters
+//
+// Parameters:
+//   of   - Open file
+//   dest - Destination address
+//   btr  - Bytes to read
+//   br   - Bytes actually read (short at end of file)
+//
+// Returns:
+//   FR_OK on success
+//   FatFS error code on failure
+//
+FRESULT overlay_file_read(overlay_file_t *of, void *dest, UINT btr, UINT *br);
+
+// overlay_file_read() that also continues *crc (CRC32, 0 to start) over
+// the bytes read. Whole sectors from the SD card go through the
+// asynchronous queue (sd_async.h), each checked while the next streams in.
+FRESULT overlay_file_read_crc(overlay_file_t *of, void *dest, UINT btr, UINT *br, uint32_t *crc);
+
+// Close a file opened with overlay_file_open()
+FRESULT overlay_file_close(overlay_file_t *of);
+
+// Forget the cached image, for code that writes the execution slot
+void overlay_cache_invalidate(void);
+
 // Verify overlay CRC32
 // Calculates CRC32 of overlay in RAM and compares with expected value
 //
@@ -109,6 +237,35 @@ uint8_t overlay_verify_crc(uint32_t addr, uint32_t size, uint32_t expected_crc);
 //
 void overlay_execute(uint32_t entry_point);
 
+// Close the files the overlay left open through the service table
+// (overlay_services.c, overlay_sdk/common/overlay_services.h) and remove
+// its interrupt handlers. Called by overlay_execute() when the overlay
+// returns
+void overlay_services_reset(void);
+
+// Illegal instruction/EBREAK at pc (from irq_handler(), IRQ 1)
+// Reads the page if pc is in one overlay_load() left out
+//
+// Returns:
+//   1 if the page is now loaded: restart the instruction at pc
+//   0 if it is a real fault (always without CONFIG_OVERLAY_LAZY_LOAD)
+//
+int overlay_page_fault(uint32_t pc);
+
+// Read every page still missing (interrupt safe). Called before the
+// overlay's timer handler, which must not fault inside the interrupt
+void overlay_page_in_all(void);
+
+// Write NAME.PGT for an image just saved as /OVERLAYS/filename, or remove
+// a stale one if the image can't be loaded lazily. Does nothing without
+// CONFIG_OVERLAY_LAZY_LOAD
+//
+// Returns:
+//   FR_OK on success
+//   FatFS error code on failure
+//
+FRESULT overlay_write_page_table(const char *filename, const uint8_t *image, uint32_t size);
+
 // Calculate CRC32 of memory region (for verification)
 // Uses same algorithm as bootloader_fast.c and fw_upload_fast
 //
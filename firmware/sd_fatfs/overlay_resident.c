@@ -0,0 +1,214 @@
+//==============================================================================
+// Resident Overlays - Several Relocatable Overlays Kept in SRAM
+//
+// Placement is first fit over the overlay execution region, in
+// OVERLAY_RESIDENT_ALIGN steps; each resident takes its image (.bss
+// included) followed by the copy of its writable bytes.
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+
+#include "overlay_resident.h"
+#include <stdio.h>
+#include <string.h>
+#include "../../lib/crc32.h"
+#include "../../lib/perf_counters.h"
+#include "../overlay_sdk/common/overlay_format.h"
+
+static overlay_resident_t s_res[OVERLAY_RESIDENT_MAX];
+static uint32_t s_seq;
+
+//==============================================================================
+// Placement
+//==============================================================================
+
+static uint32_t resident_crc(const overlay_resident_t *r) {
+    uint32_t crc = crc32_calc((const void *)r->base, r->data_offset);
+
+    return crc32_update(crc, (const void *)(r->base + r->mem_size), r->data_size);
+}
+
+static int overlaps(uint32_t base, uint32_t span) {
+    for (int i = 0; i < OVERLAY_RESIDENT_MAX; i++) {
+        const overlay_resident_t *r = &s_res[i];
+        if (r->used && base < r->base + r->span && r->base < base + span) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Lowest free address for span bytes: the region start or the end of a
+// resident; 0 if there is no such gap
+static uint32_t find_gap(uint32_t span) {
+    uint32_t best = 0;
+
+    for (int i = -1; i < OVERLAY_RESIDENT_MAX; i++) {
+        uint32_t base;
+
+        if (i < 0) {
+            base = OVERLAY_EXEC_BASE;
+        } else if (s_res[i].used) {
+            base = s_res[i].base + s_res[i].span;
+        } else {
+            continue;
+        }
+        if (base + span <= OVERLAY_EXEC_BASE + OVERLAY_EXEC_SIZE && !overlaps(base, span) &&
+            (!best || base < best)) {
+            best = base;
+        }
+    }
+    return best;
+}
+
+static int least_recent(void) {
+    int lru = -1;
+
+    for (int i = 0; i < OVERLAY_RESIDENT_MAX; i++) {
+        if (s_res[i].used && (lru < 0 || s_res[i].last_run < s_res[lru].last_run)) {
+            lru = i;
+        }
+    }
+    return lru;
+}
+
+//==============================================================================
+// Public API
+//==============================================================================
+
+int overlay_resident_find(const char *filename) {
+    for (int i = 0; i < OVERLAY_RESIDENT_MAX; i++) {
+        if (s_res[i].used && strcmp(s_res[i].filename, filename) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+const overlay_resident_t *overlay_resident_get(int slot) {
+    if (slot < 0 || slot >= OVERLAY_RESIDENT_MAX || !s_res[slot].used) {
+        return 0;
+    }
+    return &s_res[slot];
+}
+
+void overlay_resident_evict(int slot) {
+    if (overlay_resident_get(slot)) {
+        printf("Resident overlay %s dropped\r\n", s_res[slot].filename);
+        s_res[slot].used = 0;
+    }
+}
+
+void overlay_resident_clear(void) {
+    memset(s_res, 0, sizeof(s_res));
+}
+
+FRESULT overlay_resident_load(const char *filename, int *slot) {
+    overlay_resident_t *r;
+    overlay_info_t info;
+    ovl_header_t hdr;
+    char path[64];
+    FIL fil;
+    UINT br;
+    FRESULT fr;
+    uint32_t span, base;
+    int free_slot = -1;
+
+    *slot = overlay_resident_find(filename);
+    if (*slot >= 0) {
+        return FR_OK;
+    }
+
+    // Size from the container header before anything is placed
+    snprintf(path, sizeof(path), "%s/%s", OVERLAY_DIR, filename);
+    fr = f_open(&fil, path, FA_READ);
+    if (fr != FR_OK) {
+        printf("Error: Cannot open %s (error %d)\r\n", path, fr);
+        return fr;
+    }
+    fr = f_read(&fil, &hdr, sizeof(hdr), &br);
+    f_close(&fil);
+    if (fr != FR_OK) {
+        return fr;
+    }
+    if (br != sizeof(hdr) || hdr.magic != OVL_MAGIC || hdr.version != OVL_VERSION ||
+        hdr.data_offset > hdr.flat_size || hdr.flat_size > hdr.mem_size) {
+        printf("Error: %s is not a relocatable overlay (.ovl)\r\n", filename);
+        return FR_INVALID_PARAMETER;
+    }
+
+    span = ((hdr.mem_size + 3) & ~3u) + (hdr.flat_size - hdr.data_offset);
+    span = (span + OVERLAY_RESIDENT_ALIGN - 1) & ~(uint32_t)(OVERLAY_RESIDENT_ALIGN - 1);
+    if (span > OVERLAY_EXEC_SIZE) {
+        printf("Error: %s needs %lu bytes resident (max %lu)\r\n", filename,
+               (unsigned long)span, (unsigned long)OVERLAY_EXEC_SIZE);
+        return FR_INVALID_PARAMETER;
+    }
+
+    // Make room: a free slot and a gap, dropping the least recently run
+    for (int i = 0; i < OVERLAY_RESIDENT_MAX && free_slot < 0; i++) {
+        if (!s_res[i].used) {
+            free_slot = i;
+        }
+    }
+    if (free_slot < 0) {
+        free_slot = least_recent();
+        overlay_resident_evict(free_slot);
+    }
+    while ((base = find_gap(span)) == 0) {
+        overlay_resident_evict(least_recent());
+    }
+
+    fr = overlay_load(filename, base, &info);
+    if (fr != FR_OK) {
+        return fr;
+    }
+
+    r = &s_res[free_slot];
+    memset(r, 0, sizeof(*r));
+    strncpy(r->filename, filename, MAX_OVERLAY_NAME - 1);
+    r->base = base;
+    r->mem_size = (hdr.mem_size + 3) & ~3u;
+    r->span = span;
+    r->entry = info.entry_point;
+    r->data_offset = hdr.data_offset;
+    r->data_size = hdr.flat_size - hdr.data_offset;
+    memcpy((void *)(base + r->mem_size), (const void *)(base + r->data_offset), r->data_size);
+    r->crc = resident_crc(r);
+    r->last_run = ++s_seq;
+    r->used = 1;
+
+    printf("Resident at 0x%08lX-0x%08lX (%lu writable bytes kept)\r\n",
+           (unsigned long)base, (unsigned long)(base + span - 1), (unsigned long)r->data_size);
+    *slot = free_slot;
+    return FR_OK;
+}
+
+FRESULT overlay_resident_run(int slot) {
+    overlay_resident_t *r = (overlay_resident_t *)overlay_resident_get(slot);
+    uint32_t t0 = rdcycle();
+
+    if (!r) {
+        return FR_INVALID_PARAMETER;
+    }
+
+    if (resident_crc(r) != r->crc) {
+        printf("Error: Resident overlay %s was overwritten\r\n", r->filename);
+        overlay_resident_evict(slot);
+        return FR_INT_ERR;
+    }
+
+    // Same writable data as straight after the load
+    if (r->runs) {
+        memcpy((void *)(r->base + r->data_offset), (const void *)(r->base + r->mem_size),
+               r->data_size);
+    }
+    r->runs++;
+    r->last_run = ++s_seq;
+
+    printf("Resident overlay %s, run %lu: ready in %lu us\r\n", r->filename,
+           (unsigned long)r->runs, (unsigned long)perf_cycles_to_us(rdcycle() - t0));
+    overlay_execute(r->entry);
+    return FR_OK;
+}
@@ -0,0 +1,73 @@
+//==============================================================================
+// Resident Overlays - Several Relocatable Overlays Kept in SRAM
+//
+// Relocatable containers (.ovl, overlay_sdk/common/overlay_format.h) are
+// loaded side by side into the overlay execution region instead of all at
+// OVERLAY_EXEC_BASE, and stay there after they return. Running one again
+// is a CRC check and a copy of its writable data, with no SD card access:
+//
+//   int slot;
+//   if (overlay_resident_load("HEXEDIT.OVL", &slot) == FR_OK) {
+//       overlay_resident_run(slot);        // SD read on the first load only
+//   }
+//
+// Each resident keeps a copy of its writable bytes (.data, .got, from the
+// container's data_offset) as loaded, and every run starts from it, as
+// after a fresh load; .bss is cleared by overlay_start.S as always. The
+// fixed stack and heap (0x78000-0x80000) and the timer IRQ hook are
+// shared, which is fine as only one overlay runs at a time.
+//
+// When a new overlay does not fit, the least recently run ones are
+// dropped. Anything else written into the region (flat .bin overlays, the
+// upload buffers) must call overlay_resident_clear(); a resident whose
+// code no longer matches its CRC is dropped instead of run regardless.
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+
+#ifndef OVERLAY_RESIDENT_H
+#define OVERLAY_RESIDENT_H
+
+#include <stdint.h>
+#include "ff.h"
+#include "overlay_loader.h"
+
+#define OVERLAY_RESIDENT_MAX    6           // Overlays kept at once
+#define OVERLAY_RESIDENT_ALIGN  64          // Placement granularity (bytes)
+
+typedef struct {
+    char     filename[MAX_OVERLAY_NAME];    // Name in OVERLAY_DIR
+    uint32_t base;                          // Load address
+    uint32_t mem_size;                      // Image with .bss
+    uint32_t span;                          // Region used: image + data copy
+    uint32_t entry;                         // Entry point
+    uint32_t data_offset;                   // Writable bytes from here...
+    uint32_t data_size;                     // ...restored from base + mem_size
+    uint32_t crc;                           // Code below data_offset, then the copy
+    uint32_t runs;
+    uint32_t last_run;                      // Sequence number, for eviction
+    uint8_t  used;
+} overlay_resident_t;
+
+// Load filename (a .ovl) into a free part of the region, dropping the
+// least recently run residents if needed; already resident, it is not
+// read again. Returns the slot through slot.
+FRESULT overlay_resident_load(const char *filename, int *slot);
+
+// Check, reset and run the overlay in slot (through overlay_execute()).
+// FR_INT_ERR if its code was overwritten: the slot is dropped.
+FRESULT overlay_resident_run(int slot);
+
+// Slot of filename, or -1 if not resident
+int overlay_resident_find(const char *filename);
+
+// Slot contents, or 0 if the slot is free
+const overlay_resident_t *overlay_resident_get(int slot);
+
+void overlay_resident_evict(int slot);
+
+// Forget every resident: call before anything else is put in the region
+void overlay_resident_clear(void);
+
+#endif // OVERLAY_RESIDENT_H
@@ -0,0 +1,366 @@
+//==============================================================================
+// Overlay Service Table - Console, FatFS, Heap and Timer Calls for Overlays
+//
+// The table (overlay_sdk/common/overlay_services.h) sits in .overlay_comm
+// right after overlay_timer_irq_handler, so overlays find it at the fixed
+// address OVERLAY_SERVICES_ADDR without linking against this firmware.
+// irq_register() fills the irq_vector_table of start.S, which this
+// firmware's own irq_handler leaves unused otherwise.
+// The functions run on the overlay's stack and return to it; none of them
+// use gp (the firmware linker script defines no __global_pointer$), so the
+// overlay's gp is left alone.
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+
+#include "overlay_loader.h"
+#include "ramdisk.h"
+#include "io.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <malloc.h>
+#include "../../lib/perf_counters.h"
+#include "../../lib/irq.h"
+#include "../overlay_sdk/common/overlay_services.h"
+
+//==============================================================================
+// Interrupts
+//==============================================================================
+
+// SD card access is not interrupt safe: the overlay's timer handler stays
+// masked for the duration of a file call
+static inline uint32_t svc_irq_mask(uint32_t mask) {
+    uint32_t old;
+    __asm__ volatile (".insn r 0x0B, 6, 3, %0, %1, x0" : "=r"(old) : "r"(mask) : "memory");
+    return old;
+}
+
+// Sources an overlay has registered: irq_handler (crash_dump.c) calls their
+// irq_vector_table entries (start.S) itself and passes only the other bits
+// on to app_irq_handler(). IRQ 7 (timer channels, watchdog) stays resident.
+volatile uint32_t overlay_irq_mask __attribute__((section(".fastdata"))) = 0;
+
+#define OVERLAY_IRQ_SOURCES     0x7Fu
+
+static int svc_irq_register(uint32_t source, void (*handler)(uint32_t source)) {
+    uint32_t bit = 1u << source;
+    uint32_t mask;
+
+    if (source >= IRQ_NUM_SOURCES || !(bit & OVERLAY_IRQ_SOURCES)) {
+        return -1;
+    }
+    // IRQ 1 is also EBREAK/illegal instruction: only the controller's
+    // pending bit tells a software interrupt from a trap
+    if (source == IRQ_SOFT && !irqc_present()) {
+        return -1;
+    }
+
+    mask = svc_irq_mask(~0);
+    if (handler) {
+        // The handler must not fault inside the interrupt
+        overlay_page_in_all();
+        if (irqc_present()) {
+            IRQC_PENDING = bit;             // Drop events from before now
+            irq_source_enable(source);
+        }
+        irq_vector_table[source] = handler;
+        overlay_irq_mask |= bit;
+    } else {
+        overlay_irq_mask &= ~bit;
+        irq_vector_table[source] = 0;
+    }
+    svc_irq_mask(mask);
+    return 0;
+}
+
+//==============================================================================
+// Files
+//==============================================================================
+
+static FIL s_files[OVERLAY_SERVICES_FILES];
+static uint8_t s_file_open[OVERLAY_SERVICES_FILES];
+
+static FIL *svc_fil(int fd) {
+    if (fd < 0 || fd >= OVERLAY_SERVICES_FILES || !s_file_open[fd]) {
+        return 0;
+    }
+    return &s_files[fd];
+}
+
+static int svc_file_open(const char *path, uint32_t mode) {
+    uint32_t mask;
+    FRESULT fr;
+    int fd;
+
+    for (fd = 0; fd < OVERLAY_SERVICES_FILES && s_file_open[fd]; fd++);
+    if (fd == OVERLAY_SERVICES_FILES) {
+        return -FR_TOO_MANY_OPEN_FILES;
+    }
+
+    mask = svc_irq_mask(~0);
+    fr = f_open(&s_files[fd], path, (BYTE)mode);
+    svc_irq_mask(mask);
+    if (fr != FR_OK) {
+        return -(int)fr;
+    }
+
+    s_file_open[fd] = 1;
+    return fd;
+}
+
+static int svc_file_read(int fd, void *buf, uint32_t len) {
+    FIL *fp = svc_fil(fd);
+    uint32_t mask;
+    FRESULT fr;
+    UINT br;
+
+    if (!fp) {
+        return -FR_INVALID_OBJECT;
+    }
+    mask = svc_irq_mask(~0);
+    fr = f_read(fp, buf, len, &br);
+    svc_irq_mask(mask);
+    return fr == FR_OK ? (int)br : -(int)fr;
+}
+
+static int svc_file_write(int fd, const void *buf, uint32_t len) {
+    FIL *fp = svc_fil(fd);
+    uint32_t mask;
+    FRESULT fr;
+    UINT bw;
+
+    if (!fp) {
+        return -FR_INVALID_OBJECT;
+    }
+    mask = svc_irq_mask(~0);
+    fr = f_write(fp, buf, len, &bw);
+    svc_irq_mask(mask);
+    return fr == FR_OK ? (int)bw : -(int)fr;
+}
+
+static int svc_file_seek(int fd, uint32_t offset) {
+    FIL *fp = svc_fil(fd);
+    uint32_t mask;
+    FRESULT fr;
+
+    if (!fp) {
+        return -FR_INVALID_OBJECT;
+    }
+    mask = svc_irq_mask(~0);
+    fr = f_lseek(fp, offset);
+    svc_irq_mask(mask);
+    return -(int)fr;
+}
+
+static uint32_t svc_file_size(int fd) {
+    FIL *fp = svc_fil(fd);
+
+    return fp ? (uint32_t)f_size(fp) : 0;
+}
+
+static int svc_file_close(int fd) {
+    FIL *fp = svc_fil(fd);
+    uint32_t mask;
+    FRESULT fr;
+
+    if (!fp) {
+        return -FR_INVALID_OBJECT;
+    }
+    mask = svc_irq_mask(~0);
+    fr = f_close(fp);
+    svc_irq_mask(mask);
+    s_file_open[fd] = 0;
+    return -(int)fr;
+}
+
+static int svc_file_unlink(const char *path) {
+    uint32_t mask = svc_irq_mask(~0);
+    FRESULT fr = f_unlink(path);
+
+    svc_irq_mask(mask);
+    return -(int)fr;
+}
+
+static int svc_file_copy(const char *src, const char *dst) {
+    uint32_t mask = svc_irq_mask(~0);
+    FSIZE_t copied;
+    FRESULT fr = ramdisk_copy(src, dst, &copied);
+
+    svc_irq_mask(mask);
+    return fr == FR_OK ? (int)copied : -(int)fr;
+}
+
+//==============================================================================
+// Heap
+//==============================================================================
+
+// Every block handed to an overlay is on this list, so what it leaks can
+// be freed when it returns
+typedef struct svc_block {
+    struct svc_block *next;
+    struct svc_block *prev;
+} svc_block_t;                              // 8 bytes: malloc()'s alignment kept
+
+static svc_block_t s_blocks = { &s_blocks, &s_blocks };
+
+static void *svc_malloc(size_t size) {
+    svc_block_t *b;
+
+    if (size > OVERLAY_EXEC_SIZE) {
+        return 0;
+    }
+    b = malloc(sizeof(*b) + size);
+    if (!b) {
+        return 0;
+    }
+    // The firmware heap is allowed up to the stack; the overlay region
+    // above OVERLAY_EXEC_BASE must stay untouched while an overlay runs
+    if ((uint32_t)(b + 1) + size > OVERLAY_EXEC_BASE) {
+        free(b);
+        return 0;
+    }
+
+    b->next = s_blocks.next;
+    b->prev = &s_blocks;
+    s_blocks.next->prev = b;
+    s_blocks.next = b;
+    return b + 1;
+}
+
+static void svc_free(void *ptr) {
+    svc_block_t *b;
+
+    if (!ptr) {
+        return;
+    }
+    b = (svc_block_t *)ptr - 1;
+    b->prev->next = b->next;
+    b->next->prev = b->prev;
+    free(b);
+}
+
+static void *svc_calloc(size_t n, size_t size) {
+    void *p;
+
+    if (size && n > OVERLAY_EXEC_SIZE / size) {
+        return 0;
+    }
+    p = svc_malloc(n * size);
+    if (p) {
+        memset(p, 0, n * size);
+    }
+    return p;
+}
+
+static void *svc_realloc(void *ptr, size_t size) {
+    size_t old;
+    void *p;
+
+    if (!ptr) {
+        return svc_malloc(size);
+    }
+    if (!size) {
+        svc_free(ptr);
+        return 0;
+    }
+
+    old = malloc_usable_size((svc_block_t *)ptr - 1) - sizeof(svc_block_t);
+    if (size <= old) {
+        return ptr;
+    }
+    p = svc_malloc(size);
+    if (p) {
+        memcpy(p, ptr, old);
+        svc_free(ptr);
+    }
+    return p;
+}
+
+void overlay_services_reset(void) {
+    uint32_t leaked = 0;
+
+    // Interrupts are masked again by now
+    overlay_irq_mask = 0;
+    for (int i = 0; i < IRQ_NUM_SOURCES; i++) {
+        irq_vector_table[i] = 0;
+    }
+
+    for (int fd = 0; fd < OVERLAY_SERVICES_FILES; fd++) {
+        if (s_file_open[fd]) {
+            printf("Closing file %d left open by the overlay\r\n", fd);
+            f_close(&s_files[fd]);
+            s_file_open[fd] = 0;
+        }
+    }
+
+    while (s_blocks.next != &s_blocks) {
+        svc_free(s_blocks.next + 1);
+        leaked++;
+    }
+    if (leaked) {
+        printf("Freed %lu blocks left allocated by the overlay\r\n", (unsigned long)leaked);
+    }
+}
+
+//==============================================================================
+// Console and Time
+//==============================================================================
+
+// Flushed each call: the overlay mixes it with direct uart_putc() output
+static int svc_vprintf(const char *fmt, va_list ap) {
+    int n = vprintf(fmt, ap);
+
+    fflush(stdout);
+    return n;
+}
+
+static uint32_t svc_millis(void) {
+    return (uint32_t)(rdcycle64() / (PERF_CPU_HZ / 1000));
+}
+
+static void svc_delay_ms(uint32_t ms) {
+    uint64_t end = rdcycle64() + (uint64_t)ms * (PERF_CPU_HZ / 1000);
+
+    while (rdcycle64() < end);
+}
+
+//==============================================================================
+// Table
+//==============================================================================
+
+const overlay_services_t overlay_services_table __attribute__((section(".overlay_comm.services"), used)) = {
+    .magic               = OVERLAY_SERVICES_MAGIC,
+    .version             = OVERLAY_SERVICES_VERSION,
+    .cpu_hz              = PERF_CPU_HZ,
+
+    .uart_putc           = uart_putc,
+    .uart_puts           = uart_puts,
+    .uart_write          = uart_write,
+    .uart_getc_available = uart_getc_available,
+    .uart_getc           = uart_getc,
+    .vprintf             = svc_vprintf,
+
+    .file_open           = svc_file_open,
+    .file_read           = svc_file_read,
+    .file_write          = svc_file_write,
+    .file_seek           = svc_file_seek,
+    .file_size           = svc_file_size,
+    .file_close          = svc_file_close,
+    .file_unlink         = svc_file_unlink,
+
+    .millis              = svc_millis,
+    .delay_ms            = svc_delay_ms,
+
+    .malloc              = svc_malloc,
+    .free                = svc_free,
+    .calloc              = svc_calloc,
+    .realloc             = svc_realloc,
+    .vsnprintf           = vsnprintf,
+    .timer_get_ticks     = timer_get_ticks,
+
+    .file_copy           = svc_file_copy,
+
+    .irq_register        = svc_irq_register,
+};
@@ -8,45 +8,36 @@
 //==============================================================================
 
 #include "overlay_upload.h"
+#include "overlay_loader.h"
+#include "overlay_resident.h"
 #include "hardware.h"
 #include "io.h"
 #include "crash_dump.h"
+#include "crash_sd.h"
 #include "diskio.h"
+#include "disk_cache.h"
+#include "sd_spi.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include "../../lib/crc32.h"
+#include "../../lib/dma.h"
+#include "../../lib/mem_stats.h"
+#include "../sd_bootloader/boot_header.h"
 
-// uzlib for gzip decompression
-#include "uzlib.h"
+#include "../../lib/perf_counters.h"
+#include "../../lib/inflate/inflate.h"
+#include "../../lib/delta_upload.h"
+
+extern uint8_t g_card_mounted;      // sd_card_manager.c
 
 //==============================================================================
 // CRC32 Calculation (matches bootloader_fast.c and fw_upload_fast)
 //==============================================================================
 
-static uint32_t crc32_table[256];
-static uint8_t crc32_initialized = 0;
-
-static void crc32_init(void) {
-    if (crc32_initialized) return;
-
-    for (uint32_t i = 0; i < 256; i++) {
-        uint32_t crc = i;
-        for (int j = 0; j < 8; j++) {
-            crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320 : 0);
-        }
-        crc32_table[i] = crc;
-    }
-    crc32_initialized = 1;
-}
-
 // Calculate CRC32 of a buffer (post-receive)
 static uint32_t calculate_crc32(uint8_t *buffer, uint32_t size) {
-    uint32_t crc = 0xFFFFFFFF;
-    for (uint32_t i = 0; i < size; i++) {
-        uint8_t byte = buffer[i];
-        crc = (crc >> 8) ^ crc32_table[(crc ^ byte) & 0xFF];
-    }
-    return ~crc;
+    return crc32_calc(buffer, size);
 }
 
 //==============================================================================
@@ -63,6 +54,67 @@ static inline uint8_t uart_getc_raw(void) {
     return UART_RX_DATA & 0xFF;
 }
 
+static uint32_t uart_get32_raw(void) {
+    return delta_upload_get32(uart_getc_raw);
+}
+
+//==============================================================================
+// Delta Upload (lib/delta_upload.h, fw_upload_fast -d)
+//==============================================================================
+
+// After 'D': only the changes against the overlay still in the slot come
+// across. Prints nothing until the protocol is complete.
+static FRESULT overlay_receive_delta(uint8_t *buffer, uint32_t *size) {
+    uint32_t length, block, expected_crc, calculated_crc;
+    int error;
+
+    uart_putc_raw('A');
+    LED_REG = 0x02;
+
+    length = uart_get32_raw();
+    block = uart_get32_raw();
+    if (length == 0 || length > MAX_OVERLAY_SIZE || !delta_upload_block_ok(block)) {
+        uart_putc_raw('N');
+        printf("Error: Invalid delta upload (%lu bytes, %lu byte blocks)\r\n",
+               (unsigned long)length, (unsigned long)block);
+        LED_REG = 0x00;
+        return FR_INVALID_PARAMETER;
+    }
+    uart_putc_raw('B');
+
+    delta_upload_sums(uart_putc_raw, buffer, length, block);
+    error = delta_upload_apply(uart_getc_raw, uart_putc_raw, buffer, length);
+    calculated_crc = calculate_crc32(buffer, length);
+
+    if (uart_getc_raw() != 'C') {
+        printf("Error: Protocol error - Expected 'C' after the delta\r\n");
+        LED_REG = 0x00;
+        return FR_INVALID_PARAMETER;
+    }
+    expected_crc = uart_get32_raw();
+
+    uart_putc_raw('C');
+    uart_putc_raw((calculated_crc >> 0) & 0xFF);
+    uart_putc_raw((calculated_crc >> 8) & 0xFF);
+    uart_putc_raw((calculated_crc >> 16) & 0xFF);
+    uart_putc_raw((calculated_crc >> 24) & 0xFF);
+
+    printf("\r\n");
+    if (error || calculated_crc != expected_crc) {
+        printf("*** DELTA UPLOAD FAILED%s ***\r\n", error ? " (bad op)" : "");
+        printf("Expected:   0x%08lX\r\n", (unsigned long)expected_crc);
+        printf("Calculated: 0x%08lX\r\n", (unsigned long)calculated_crc);
+        LED_REG = 0x00;
+        return FR_INT_ERR;
+    }
+
+    printf("*** Delta upload SUCCESS ***\r\n");
+    printf("Image: %lu bytes\r\n", (unsigned long)length);
+    printf("CRC32: 0x%08lX\r\n", (unsigned long)calculated_crc);
+    *size = length;
+    return FR_OK;
+}
+
 //==============================================================================
 // Ensure /OVERLAYS Directory Exists
 //==============================================================================
@@ -97,6 +149,8 @@ FRESULT overlay_ensure_directory(void) {
 
 FRESULT overlay_upload(const char *filename) {
     uint8_t *buffer = (uint8_t *)UPLOAD_BUFFER_BASE;
+    overlay_resident_clear();   // The buffer is the resident overlays' region
+    overlay_cache_invalidate();
     uint32_t packet_size = 0;
     uint32_t bytes_received = 0;
     uint32_t expected_crc;
@@ -105,8 +159,6 @@ FRESULT overlay_upload(const char *filename) {
     FIL file;
     UINT bytes_written;
 
-    // Initialize CRC32 lookup table
-    crc32_init();
 
     // Ensure /OVERLAYS directory exists
     fr = overlay_ensure_directory();
@@ -255,6 +307,11 @@ FRESULT overlay_upload(const char *filename) {
         return fr;
     }
 
+    // Page CRCs for lazy loading (the old NAME.PGT no longer matches)
+    if (overlay_write_page_table(filename, buffer, packet_size) != FR_OK) {
+        printf("Warning: Cannot write page table, first load reads it all\r\n");
+    }
+
     // Success! Turn off LEDs
     LED_REG = 0x00;
 
@@ -272,13 +329,13 @@ FRESULT overlay_upload(const char *filename) {
 
 FRESULT overlay_upload_and_execute(void) {
     uint8_t *buffer = (uint8_t *)UPLOAD_BUFFER_BASE;
+    overlay_resident_clear();
+    overlay_cache_invalidate();
     uint32_t packet_size = 0;
     uint32_t bytes_received = 0;
     uint32_t expected_crc;
     uint32_t calculated_crc;
 
-    // Initialize CRC32 lookup table
-    crc32_init();
 
     printf("Upload and Execute Mode - Direct RAM execution\r\n");
     printf("Protocol: FAST streaming\r\n");
@@ -289,13 +346,21 @@ FRESULT overlay_upload_and_execute(void) {
     // Turn on LED to indicate waiting for upload
     LED_REG = 0x01;
 
-    // Step 1: Wait for 'R' (Ready) command
+    // Step 1: Wait for 'R' (Ready) command, or 'D' for a delta upload
+    // against the overlay still in the slot from the last run
     printf("Step 1: Waiting for 'R' command...\r\n");
     while (1) {
         uint8_t cmd = uart_getc_raw();
         if (cmd == 'R' || cmd == 'r') {
             break;
         }
+        if (cmd == DELTA_UPLOAD_CMD) {
+            FRESULT fr = overlay_receive_delta(buffer, &packet_size);
+            if (fr != FR_OK) {
+                return fr;
+            }
+            goto loaded;
+        }
     }
 
     // Step 2: Send ACK 'A' for Ready
@@ -384,6 +449,7 @@ FRESULT overlay_upload_and_execute(void) {
     printf("Received: %lu bytes\r\n", (unsigned long)packet_size);
     printf("CRC32: 0x%08lX\r\n", (unsigned long)calculated_crc);
 
+loaded:
     // Turn off LEDs
     LED_REG = 0x00;
 
@@ -395,12 +461,21 @@ FRESULT overlay_upload_and_execute(void) {
     printf("========================================\r\n");
     printf("\r\n");
 
-    // Small delay for printf to flush
-    for (volatile int i = 0; i < 100000; i++);
+    // Let the banner leave the UART before interrupts and the overlay start
+    fflush(stdout);
+    uart_flush();
+
+    // Watchdog only with Kconfig OVERLAY_WATCHDOG_MS: long-running overlays
+    // (e.g. Mandelbrot) do not kick it. It has its own counter, so every
+    // timer channel stays free for the overlay.
+#ifdef CONFIG_OVERLAY_WATCHDOG_MS
+    crash_watchdog_enable(CONFIG_OVERLAY_WATCHDOG_MS);
+#endif
 
-    // NOTE: Watchdog is NOT enabled here because overlays may need to use the
-    // timer hardware for their own purposes (e.g., Mandelbrot performance timing).
-    // The watchdog and overlay timer cannot coexist on the same hardware timer.
+    // Dump file for a crash, set up while FatFS is still trustworthy
+    if (g_card_mounted && crash_sd_prepare(CRASH_SD_PATH) != FR_OK) {
+        printf("No crash dump file (" CRASH_SD_PATH ")\r\n");
+    }
 
     // Enable ALL interrupts so overlays can use timer interrupts if needed
     // PicoRV32 maskirq: mask=0 enables all, mask=0xFFFFFFFF disables all
@@ -415,9 +490,11 @@ FRESULT overlay_upload_and_execute(void) {
     }
 
     printf("Interrupts enabled, calling overlay at 0x60000...\r\n");
+    fflush(stdout);
+    uart_flush();
 
-    // Small delay for printf to flush
-    for (volatile int i = 0; i < 100000; i++);
+    // Write back the loaded image and drop stale instruction cache lines
+    cache_sync_code(0x00060000, MAX_OVERLAY_SIZE);
 
     // Jump to overlay entry point
     typedef void (*overlay_func_t)(void);
@@ -435,6 +512,14 @@ FRESULT overlay_upload_and_execute(void) {
     // SD card operations are NOT interrupt-safe and require interrupts disabled
     __asm__ volatile (".insn r 0x0B, 6, 3, %0, %1, x0" : "=r"(dummy) : "r"(~0));
 
+#ifdef CONFIG_OVERLAY_WATCHDOG_MS
+    crash_watchdog_disable();
+#endif
+    crash_sd_release();
+
+    // The overlay's heap and stack overwrite the stack paint
+    mem_stack_repaint();
+
     printf("\r\n");
     printf("========================================\r\n");
     printf("Overlay returned successfully\r\n");
@@ -444,9 +529,88 @@ FRESULT overlay_upload_and_execute(void) {
     return FR_OK;
 }
 
+//==============================================================================
+// Boot Slots (boot_header.h, read by the SD bootloader)
+//==============================================================================
+
+// Largest image the SD bootloader will load to 0x0
+#define BOOT_IMAGE_LIMIT ((BOOT_IMAGE_MAX < BOOT_LOAD_LIMIT) ? BOOT_IMAGE_MAX : BOOT_LOAD_LIMIT)
+
+// The slot an upload writes: never the one the card boots now
+static struct {
+    int slot;
+    int header;                 // Header sector
+    int image;                  // First image sector
+    uint32_t image_version;     // The new image's
+} s_boot;
+
+// Pick the slot without the newest valid header (slot B if neither has
+// one: a legacy image from sector 1 stays bootable) and the next version
+static void boot_slot_select(void) {
+    uint8_t sector_buf[512] __attribute__((aligned(4)));
+    const boot_header_t *hdr = (const boot_header_t *)sector_buf;
+    int active = -1;
+    uint32_t newest = 0;
+
+    for (int slot = 0; slot < BOOT_SLOTS; slot++) {
+        if (disk_read(0, sector_buf, BOOT_SLOT_HEADER(slot), 1) != RES_OK ||
+            !boot_header_valid(hdr, slot)) {
+            continue;
+        }
+        if (active < 0 || boot_version_newer(boot_header_image_version(hdr), newest)) {
+            active = slot;
+            newest = boot_header_image_version(hdr);
+        }
+    }
+
+    s_boot.slot = (active == 1) ? 0 : 1;
+    s_boot.header = BOOT_SLOT_HEADER(s_boot.slot);
+    s_boot.image = BOOT_SLOT_IMAGE(s_boot.slot);
+    s_boot.image_version = newest + 1;
+
+    if (active >= 0) {
+        printf("Installing to slot %c as v%lu; slot %c (v%lu) boots until it is verified\r\n",
+               'A' + s_boot.slot, (unsigned long)s_boot.image_version,
+               'A' + active, (unsigned long)newest);
+    } else {
+        printf("Installing to slot %c as v%lu\r\n",
+               'A' + s_boot.slot, (unsigned long)s_boot.image_version);
+    }
+}
+
+// Write the slot header for an image of length bytes (stored bytes at
+// s_boot.image, compressed per compression), read at the current SPI
+// speed. length 0 writes an empty sector, so an image half-written by a
+// failed upload is never booted as valid.
+static DRESULT write_boot_header(uint32_t length, uint32_t crc,
+                                 uint32_t stored, uint32_t compression) {
+    uint8_t sector_buf[512] __attribute__((aligned(4)));
+    boot_header_t *hdr = (boot_header_t *)sector_buf;
+
+    memset(sector_buf, 0, sizeof(sector_buf));
+    if (length > 0) {
+        hdr->magic = BOOT_HEADER_MAGIC;
+        hdr->version = BOOT_HEADER_VERSION;
+        hdr->length = length;
+        hdr->load_addr = 0x00000000;
+        hdr->entry = 0x00000000;
+        hdr->crc32 = crc;
+        hdr->spi_ctrl = sd_get_speed();
+        hdr->stored_length = stored;
+        hdr->compression = compression;
+        hdr->image_version = s_boot.image_version;
+        hdr->header_crc = crc32_calc(hdr, sizeof(*hdr) - 4);
+    }
+
+    if (disk_write(0, sector_buf, s_boot.header, 1) != RES_OK) {
+        return RES_ERROR;
+    }
+    return disk_ioctl(0, CTRL_SYNC, NULL);
+}
+
 //==============================================================================
 // Upload Bootloader to Raw Partition - FAST Streaming Protocol
-// Writes directly to sectors 1-1024 (512KB bootloader partition)
+// Writes the image and then its header to the boot slot not in use
 //==============================================================================
 
 FRESULT bootloader_upload_to_partition(void) {
@@ -459,15 +623,15 @@ FRESULT bootloader_upload_to_partition(void) {
 
     // Use fixed-size buffer at 0x60000 (overlay region, not used during bootloader upload)
     uint8_t *buffer = (uint8_t *)UPLOAD_BUFFER_BASE;  // 0x60000 = 96KB available
+    overlay_resident_clear();
+    overlay_cache_invalidate();
 
     FRESULT result = FR_OK;  // Track return value for cleanup
 
-    // Initialize CRC32 lookup table
-    crc32_init();
 
     printf("Waiting for bootloader upload from fw_upload_fast...\r\n");
     printf("Protocol: FAST streaming with ring buffer\r\n");
-    printf("Target: Raw sectors 1-1024 (bootloader partition)\r\n");
+    printf("Target: Raw sectors 1-1008 (bootloader partition, the boot slot not in use)\r\n");
 
     // Turn on LED to indicate waiting for upload
     LED_REG = 0x01;
@@ -513,8 +677,9 @@ FRESULT bootloader_upload_to_partition(void) {
         goto cleanup;
     }
 
-    if (packet_size > (1024 * 512)) {
-        printf("Error: Size exceeds bootloader partition (max 512 KB)\r\n");
+    if (packet_size > BOOT_IMAGE_LIMIT) {
+        printf("Error: Size exceeds a boot slot (max %lu KB)\r\n",
+               (unsigned long)(BOOT_IMAGE_LIMIT / 1024));
         LED_REG = 0x00;
         result = FR_INVALID_PARAMETER;
         goto cleanup;
@@ -582,24 +747,34 @@ FRESULT bootloader_upload_to_partition(void) {
     printf("✓ CRC Match - Data integrity verified\r\n");
     printf("\r\n");
 
-    // Step 8: Write to raw sectors 1-1024
+    // Step 8: Write to the boot slot not in use
     printf("========================================\r\n");
     printf("Writing to Bootloader Partition...\r\n");
     printf("========================================\r\n");
+    boot_slot_select();
 
     // Calculate number of sectors needed (round up)
     uint32_t num_sectors = (packet_size + 511) / 512;
-    printf("Writing %lu sectors (sectors 1-%lu)...\r\n",
+    printf("Writing %lu sectors (sectors %d-%lu)...\r\n",
            (unsigned long)num_sectors,
-           (unsigned long)num_sectors);
+           s_boot.image,
+           (unsigned long)(s_boot.image + num_sectors - 1));
 
     // LED pattern: Both LEDs on = writing
     LED_REG = 0x03;
 
-    // Write sectors one at a time (starting at sector 1, not 0!)
+    // Clear the old header first; the new one goes in after the verify
+    if (write_boot_header(0, 0, 0, BOOT_COMP_NONE) != RES_OK) {
+        printf("✗ Write FAILED at sector %d (boot header)\r\n", s_boot.header);
+        LED_REG = 0x00;
+        result = FR_DISK_ERR;
+        goto cleanup;
+    }
+
+    // Write sectors one at a time (starting at sector 2, after the header)
     for (uint32_t i = 0; i < num_sectors; i++) {
         // Prepare sector buffer (might be partial for last sector)
-        uint8_t sector_buf[512];
+        uint8_t sector_buf[512] __attribute__((aligned(4)));
         uint32_t offset = i * 512;
         uint32_t bytes_to_copy = 512;
 
@@ -609,14 +784,14 @@ FRESULT bootloader_upload_to_partition(void) {
             memset(sector_buf, 0, 512);
         }
 
-        memcpy(sector_buf, buffer + offset, bytes_to_copy);
+        dma_memcpy(sector_buf, buffer + offset, bytes_to_copy);
 
-        // Write sector (sector numbers start at 1 for bootloader partition)
-        disk_res = disk_write(0, sector_buf, 1 + i, 1);
+        // Write sector (image starts at sector 2 of the bootloader partition)
+        disk_res = disk_write(0, sector_buf, s_boot.image + i, 1);
 
         if (disk_res != RES_OK) {
             printf("✗ Write FAILED at sector %lu (disk error: %d)\r\n",
-                   (unsigned long)(1 + i), disk_res);
+                   (unsigned long)(s_boot.image + i), disk_res);
             LED_REG = 0x00;
             result = FR_DISK_ERR;
             goto cleanup;
@@ -635,6 +810,16 @@ FRESULT bootloader_upload_to_partition(void) {
     printf("✓ Write Complete - %lu sectors written\r\n", (unsigned long)num_sectors);
     printf("\r\n");
 
+    // Write back the diskio sector cache and drop it, so the read-back
+    // below comes from the card
+    if (disk_ioctl(0, CTRL_SYNC, NULL) != RES_OK) {
+        printf("✗ Sync FAILED (disk error)\r\n");
+        LED_REG = 0x00;
+        result = FR_DISK_ERR;
+        goto cleanup;
+    }
+    disk_cache_invalidate();
+
     // Step 9: CRITICAL - Verify written data by reading back and checking CRC
     printf("========================================\r\n");
     printf("Verifying Written Data...\r\n");
@@ -648,14 +833,14 @@ FRESULT bootloader_upload_to_partition(void) {
     printf("Reading back %lu sectors...\r\n", (unsigned long)num_sectors);
 
     for (uint32_t i = 0; i < num_sectors; i++) {
-        uint8_t sector_buf[512];
+        uint8_t sector_buf[512] __attribute__((aligned(4)));
 
         // Read sector
-        disk_res = disk_read(0, sector_buf, 1 + i, 1);
+        disk_res = disk_read(0, sector_buf, s_boot.image + i, 1);
 
         if (disk_res != RES_OK) {
             printf("✗ Read FAILED at sector %lu (disk error: %d)\r\n",
-                   (unsigned long)(1 + i), disk_res);
+                   (unsigned long)(s_boot.image + i), disk_res);
             LED_REG = 0x00;
             result = FR_DISK_ERR;
             goto cleanup;
@@ -674,7 +859,7 @@ FRESULT bootloader_upload_to_partition(void) {
             bytes_to_copy = packet_size - offset;
         }
 
-        memcpy(buffer + offset, sector_buf, bytes_to_copy);
+        dma_memcpy(buffer + offset, sector_buf, bytes_to_copy);
 
         // Show progress every 64 sectors
         if ((i & 0x3F) == 0 || i == num_sectors - 1) {
@@ -709,6 +894,14 @@ FRESULT bootloader_upload_to_partition(void) {
         goto cleanup;
     }
 
+    // Image verified: point the SD bootloader at it
+    if (write_boot_header(packet_size, calculated_crc, packet_size, BOOT_COMP_NONE) != RES_OK) {
+        printf("✗ Write FAILED at sector %d (boot header)\r\n", s_boot.header);
+        LED_REG = 0x00;
+        result = FR_DISK_ERR;
+        goto cleanup;
+    }
+
     // SUCCESS!
     printf("\r\n");
     printf("========================================\r\n");
@@ -718,9 +911,11 @@ FRESULT bootloader_upload_to_partition(void) {
     printf("Size: %lu bytes (%lu KB)\r\n",
            (unsigned long)packet_size,
            (unsigned long)(packet_size / 1024));
-    printf("Sectors: 1-%lu (%lu sectors total)\r\n",
+    printf("Sectors: %d-%lu (%lu sectors total, header in sector %d)\r\n",
+           s_boot.image,
+           (unsigned long)(s_boot.image + num_sectors - 1),
            (unsigned long)num_sectors,
-           (unsigned long)num_sectors);
+           s_boot.header);
     printf("CRC32: 0x%08lX (verified)\r\n", (unsigned long)verify_crc);
     printf("Data integrity: 100%% confirmed\r\n");
     printf("========================================\r\n");
@@ -739,8 +934,220 @@ cleanup:
     return result;
 }
 
+//==============================================================================
+// LZ4 Boot Images (.bin.lz4 from tools/lz4boot)
+//==============================================================================
+
+static uint32_t get_le32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Length field continuation bytes; 0 if the block ends first
+static int lz4_skip_length(const uint8_t **ip, const uint8_t *in_end, uint32_t *n) {
+    uint8_t b;
+
+    do {
+        if (*ip >= in_end) {
+            return 0;
+        }
+        b = *(*ip)++;
+        *n += b;
+    } while (b == 255);
+    return 1;
+}
+
+// Walk an LZ4 block without output: 1 if it decodes to exactly length
+// bytes with every match inside the output, which is what the SD
+// bootloader checks while it loads
+static int lz4_check_block(const uint8_t *ip, uint32_t in_len, uint32_t length) {
+    const uint8_t *in_end = ip + in_len;
+    uint32_t out = 0;
+
+    while (ip < in_end) {
+        uint8_t token = *ip++;
+        uint32_t n = token >> 4;
+
+        if (n == 15 && !lz4_skip_length(&ip, in_end, &n)) {
+            return 0;
+        }
+        if (n > length - out || n > (uint32_t)(in_end - ip)) {
+            return 0;
+        }
+        ip += n;
+        out += n;
+
+        if (out == length) {
+            return ip == in_end;
+        }
+
+        if (in_end - ip < 2) {
+            return 0;
+        }
+        uint32_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        n = token & 15;
+        if (n == 15 && !lz4_skip_length(&ip, in_end, &n)) {
+            return 0;
+        }
+        n += 4;
+        if (offset == 0 || offset > out || n > length - out) {
+            return 0;
+        }
+        out += n;
+    }
+    return 0;
+}
+
+// Store a received .bin.lz4 file as is: the block to the slot's image
+// sectors, then a BOOT_COMP_LZ4 header. The SD bootloader decompresses it while loading.
+static FRESULT install_lz4_image(uint8_t *file, uint32_t file_size) {
+    uint32_t length = get_le32(file + 4);
+    uint32_t image_crc = get_le32(file + 8);
+    uint32_t stored = file_size - BOOT_LZ4_FILE_HEADER;
+    uint32_t num_sectors = (stored + 511) / 512;
+    uint32_t verify_crc;
+    uint8_t sector_buf[512] __attribute__((aligned(4)));
+    uint8_t *block = file;
+
+    printf("LZ4 boot image: %lu bytes from %lu compressed, CRC32 0x%08lX\r\n",
+           (unsigned long)length, (unsigned long)stored, (unsigned long)image_crc);
+
+    if (length == 0 || length > BOOT_LOAD_LIMIT || stored > BOOT_IMAGE_MAX ||
+        !lz4_check_block(file + BOOT_LZ4_FILE_HEADER, stored, length)) {
+        printf("✗ Invalid LZ4 image (max %lu KB loaded)\r\n",
+               (unsigned long)(BOOT_LOAD_LIMIT / 1024));
+        return FR_INVALID_PARAMETER;
+    }
+
+    // Block to the start of the (word aligned) buffer for multi-sector writes
+    memmove(block, file + BOOT_LZ4_FILE_HEADER, stored);
+
+    printf("Writing %lu sectors (sectors %d-%lu)...\r\n",
+           (unsigned long)num_sectors,
+           s_boot.image,
+           (unsigned long)(s_boot.image + num_sectors - 1));
+    LED_REG = 0x03;
+
+    // Clear the old header first; the new one goes in after the verify
+    if (write_boot_header(0, 0, 0, BOOT_COMP_NONE) != RES_OK ||
+        (stored / 512 > 0 &&
+         disk_write(0, block, s_boot.image, stored / 512) != RES_OK)) {
+        printf("✗ Write FAILED\r\n");
+        return FR_DISK_ERR;
+    }
+    if (stored % 512) {
+        memset(sector_buf, 0, sizeof(sector_buf));
+        memcpy(sector_buf, block + (stored & ~511u), stored % 512);
+        if (disk_write(0, sector_buf, s_boot.image + stored / 512, 1) != RES_OK) {
+            printf("✗ Write FAILED at sector %lu\r\n",
+                   (unsigned long)(s_boot.image + stored / 512));
+            return FR_DISK_ERR;
+        }
+    }
+
+    // Read back from the card, not the sector cache
+    if (disk_ioctl(0, CTRL_SYNC, NULL) != RES_OK) {
+        printf("✗ Sync FAILED (disk error)\r\n");
+        return FR_DISK_ERR;
+    }
+    disk_cache_invalidate();
+
+    LED_REG = 0x01;
+    verify_crc = 0;
+    for (uint32_t i = 0; i < num_sectors; i++) {
+        uint32_t bytes = stored - i * 512;
+
+        if (disk_read(0, sector_buf, s_boot.image + i, 1) != RES_OK) {
+            printf("✗ Read FAILED at sector %lu\r\n",
+                   (unsigned long)(s_boot.image + i));
+            return FR_DISK_ERR;
+        }
+        verify_crc = crc32_update(verify_crc, sector_buf, bytes < 512 ? bytes : 512);
+    }
+
+    printf("Stored CRC:   0x%08lX\r\n", (unsigned long)calculate_crc32(block, stored));
+    printf("Verified CRC: 0x%08lX\r\n", (unsigned long)verify_crc);
+    if (verify_crc != calculate_crc32(block, stored)) {
+        printf("✗✗✗ CRC MISMATCH after write! ✗✗✗\r\n");
+        return FR_INT_ERR;
+    }
+
+    // Image verified: point the SD bootloader at it
+    if (write_boot_header(length, image_crc, stored, BOOT_COMP_LZ4) != RES_OK) {
+        printf("✗ Write FAILED at sector %d (boot header)\r\n", s_boot.header);
+        return FR_DISK_ERR;
+    }
+
+    printf("\r\n");
+    printf("========================================\r\n");
+    printf("✓✓✓ SUCCESS ✓✓✓\r\n");
+    printf("========================================\r\n");
+    printf("LZ4 bootloader installed: %lu KB in %lu sectors (%lu uncompressed)\r\n",
+           (unsigned long)(length / 1024),
+           (unsigned long)num_sectors,
+           (unsigned long)((length + 511) / 512));
+    printf("The SD bootloader checks CRC32 0x%08lX after decompressing\r\n",
+           (unsigned long)image_crc);
+    printf("========================================\r\n");
+    printf("Reset the system to boot the new bootloader\r\n");
+
+    LED_REG = 0x00;
+    return FR_OK;
+}
+
+//==============================================================================
+// Inflate Output: Windows to the Bootloader Partition
+//==============================================================================
+
+typedef struct {
+    uint32_t sector;            // Next sector to write
+    uint32_t total;             // Bytes written
+    uint32_t crc;               // CRC32 of the image so far
+    uint32_t write_cycles;      // Spent here, not inflating
+} inflate_sink_t;
+
+// A full window is one 64-sector write; the last one ends in a zero-padded
+// sector
+static int inflate_to_partition(void *ctx, const uint8_t *buf, uint32_t len) {
+    inflate_sink_t *s = (inflate_sink_t *)ctx;
+    uint8_t sector_buf[512] __attribute__((aligned(4)));
+    uint32_t t = rdcycle();
+    DRESULT res = RES_OK;
+
+    if (s->total + len > BOOT_IMAGE_LIMIT) {
+        printf("✗ Image larger than %lu KB (bootloader partition / load limit)\r\n",
+               (unsigned long)(BOOT_IMAGE_LIMIT / 1024));
+        return -1;
+    }
+    s->crc = crc32_update(s->crc, buf, len);
+
+    if (len / 512 > 0) {
+        res = disk_write(0, buf, s->sector, len / 512);
+    }
+    if (res == RES_OK && len % 512) {
+        memset(sector_buf, 0, sizeof(sector_buf));
+        memcpy(sector_buf, buf + (len & ~511u), len % 512);
+        res = disk_write(0, sector_buf, s->sector + len / 512, 1);
+    }
+    if (res != RES_OK) {
+        printf("✗ Write FAILED at sector %lu (disk error: %d)\r\n",
+               (unsigned long)s->sector, res);
+        return -1;
+    }
+    s->sector += (len + 511) / 512;
+    s->total += len;
+    s->write_cycles += rdcycle() - t;
+
+    printf("  Wrote %lu sectors (%lu KB decompressed)\r\n",
+           (unsigned long)(s->sector - s_boot.image),
+           (unsigned long)(s->total / 1024));
+    LED_REG ^= 0x03;  // Blink LEDs
+    return 0;
+}
+
 //==============================================================================
 // Upload GZIP-COMPRESSED Bootloader to Raw SD Card Partition
+// (or an LZ4 image, which is stored compressed)
 //==============================================================================
 
 FRESULT bootloader_upload_compressed_to_partition(void) {
@@ -748,18 +1155,20 @@ FRESULT bootloader_upload_compressed_to_partition(void) {
     uint32_t bytes_received = 0;
     uint32_t calculated_crc;
     uint32_t expected_crc;
+    uint32_t image_crc = 0;     // CRC32 of the decompressed image, for the boot header
     DRESULT disk_res;
 
     // Use fixed-size buffer at 0x60000 (overlay region) for COMPRESSED data
     uint8_t *compressed_buffer = (uint8_t *)UPLOAD_BUFFER_BASE;  // 96KB max compressed
+    overlay_resident_clear();
+    overlay_cache_invalidate();
 
-    // Output buffer for decompressed sectors (32KB - enough for 64 sectors at a time)
-    static uint8_t decompress_buffer[32768];  // Stack allocation
+    // Inflate window: 32KB of history, written out 64 sectors at a time
+    static uint8_t decompress_buffer[32768] __attribute__((aligned(4)));
+    static inflate_t inf;
 
     FRESULT result = FR_OK;  // Track return value for cleanup
 
-    // Initialize CRC32 lookup table
-    crc32_init();
 
     printf("\r\n========================================\r\n");
     printf("Compressed Bootloader Upload (GZIP)\r\n");
@@ -849,130 +1258,112 @@ FRESULT bootloader_upload_compressed_to_partition(void) {
 
     printf("✓ CRC Match - compressed data verified\r\n");
     printf("\r\n");
+    boot_slot_select();
 
-    // Step 11: Decompress and write to SD card sectors 1-1024
+    // LZ4 image: stored compressed, decompressed at boot
+    if (packet_size > BOOT_LZ4_FILE_HEADER &&
+        get_le32(compressed_buffer) == BOOT_LZ4_FILE_MAGIC) {
+        result = install_lz4_image(compressed_buffer, packet_size);
+        if (result != FR_OK) {
+            LED_REG = 0x00;
+        }
+        goto cleanup;
+    }
+
+    // Step 11: Decompress and write to the boot slot's sectors
     printf("========================================\r\n");
     printf("Decompressing to SD Card...\r\n");
     printf("========================================\r\n");
 
-    // Initialize uzlib
-    uzlib_init();
-
-    // Set up decompressor with 32KB dictionary for sliding window
-    // This allows decompression > 32KB by maintaining LZ77 history
-    struct uzlib_uncomp d;
-    uzlib_uncompress_init(&d, decompress_buffer, sizeof(decompress_buffer));
-
-    d.source = compressed_buffer;
-    d.source_limit = compressed_buffer + packet_size;
-    d.source_read_cb = NULL;
-
-    // Parse gzip header
-    int res = uzlib_gzip_parse_header(&d);
-    if (res != TINF_OK) {
-        printf("✗ Error parsing gzip header: %d\r\n", res);
+    // Anything but gzip leaves the installed bootloader alone
+    if (packet_size < 18 || compressed_buffer[0] != 0x1F || compressed_buffer[1] != 0x8B) {
+        printf("✗ Not a gzip or LZ4 boot image\r\n");
         LED_REG = 0x00;
-        result = FR_INT_ERR;
+        result = FR_INVALID_PARAMETER;
         goto cleanup;
     }
 
-    printf("✓ Gzip header parsed\r\n");
-
-    // Decompress and write sectors
-    uint32_t sector_num = 1;  // Start at sector 1 (after MBR)
-    uint32_t total_decompressed = 0;
-
-    d.dest_start = decompress_buffer;
-    d.dest = decompress_buffer;
-
-    while (1) {
-        // Decompress one chunk (32KB)
-        d.dest_limit = decompress_buffer + sizeof(decompress_buffer);
-        res = uzlib_uncompress_chksum(&d);
-
-        uint32_t chunk_size = d.dest - decompress_buffer;
-
-        if (chunk_size > 0) {
-            // Write decompressed data to SD card
-            uint32_t num_sectors = (chunk_size + 511) / 512;
-
-            for (uint32_t i = 0; i < num_sectors; i++) {
-                uint8_t sector_buf[512];
-                uint32_t offset = i * 512;
-                uint32_t bytes_to_copy = 512;
-
-                if (offset + bytes_to_copy > chunk_size) {
-                    bytes_to_copy = chunk_size - offset;
-                    memset(sector_buf, 0, 512);  // Pad last sector with zeros
-                }
-
-                memcpy(sector_buf, decompress_buffer + offset, bytes_to_copy);
-
-                // Write sector
-                disk_res = disk_write(0, sector_buf, sector_num, 1);
-                if (disk_res != RES_OK) {
-                    printf("✗ Write FAILED at sector %lu (disk error: %d)\r\n",
-                           (unsigned long)sector_num, disk_res);
-                    LED_REG = 0x00;
-                    result = FR_DISK_ERR;
-                    goto cleanup;
-                }
-
-                sector_num++;
-
-                // Show progress every 64 sectors
-                if ((sector_num & 0x3F) == 0) {
-                    printf("  Wrote %lu sectors (%lu KB decompressed)\r\n",
-                           (unsigned long)(sector_num - 1),
-                           (unsigned long)((sector_num - 1) / 2));
-                    LED_REG ^= 0x03;  // Blink LEDs
-                }
-            }
+    // Clear the old header first; the new one goes in after the verify
+    if (write_boot_header(0, 0, 0, BOOT_COMP_NONE) != RES_OK) {
+        printf("✗ Write FAILED at sector %d (boot header)\r\n", s_boot.header);
+        LED_REG = 0x00;
+        result = FR_DISK_ERR;
+        goto cleanup;
+    }
 
-            total_decompressed += chunk_size;
+    // Decompress and write sectors, a 32KB window at a time
+    inflate_sink_t sink = { s_boot.image, 0, 0, 0 };
+    uint32_t t0 = rdcycle();
 
-            // Reset output pointer for next chunk (dest_start must remain constant!)
-            d.dest = decompress_buffer;
-        }
+    inflate_init(&inf, decompress_buffer, sizeof(decompress_buffer),
+                 inflate_to_partition, &sink);
+    int res = inflate_gzip(&inf, compressed_buffer, packet_size);
+    uint32_t inflate_cycles = rdcycle() - t0 - sink.write_cycles;
 
-        if (res == TINF_DONE) {
-            break;  // Decompression complete
-        } else if (res != TINF_OK) {
+    if (res != INFLATE_OK) {
+        if (res != INFLATE_ERR_FLUSH) {     // The sink has said why
             printf("✗ Decompression error: %d\r\n", res);
-            LED_REG = 0x00;
-            result = FR_INT_ERR;
-            goto cleanup;
         }
+        LED_REG = 0x00;
+        result = (res == INFLATE_ERR_FLUSH) ? FR_DISK_ERR : FR_INT_ERR;
+        goto cleanup;
+    }
+    if (sink.crc != inf.gzip_crc) {
+        printf("✗ gzip CRC mismatch: 0x%08lX, trailer 0x%08lX\r\n",
+               (unsigned long)sink.crc, (unsigned long)inf.gzip_crc);
+        LED_REG = 0x00;
+        result = FR_INT_ERR;
+        goto cleanup;
     }
 
+    uint32_t sector_num = sink.sector;
+    uint32_t total_decompressed = sink.total;
+    image_crc = sink.crc;
+
     printf("✓ Decompression Complete\r\n");
     printf("  Total decompressed: %lu bytes (%lu KB)\r\n",
            (unsigned long)total_decompressed,
            (unsigned long)(total_decompressed / 1024));
-    printf("  Sectors written: %lu (sectors 1-%lu)\r\n",
-           (unsigned long)(sector_num - 1),
+    printf("  Sectors written: %lu (sectors %d-%lu)\r\n",
+           (unsigned long)(sector_num - s_boot.image),
+           s_boot.image,
            (unsigned long)(sector_num - 1));
     printf("  Compression ratio: %.1f%%\r\n",
            100.0 - (100.0 * packet_size / total_decompressed));
+    printf("  Inflate: %lu KB/s (%lu ms), card writes %lu ms\r\n",
+           (unsigned long)(inflate_cycles ?
+               (uint64_t)total_decompressed * PERF_CPU_HZ / inflate_cycles / 1024 : 0),
+           (unsigned long)(inflate_cycles / (PERF_CPU_HZ / 1000)),
+           (unsigned long)(sink.write_cycles / (PERF_CPU_HZ / 1000)));
     printf("\r\n");
 
+    // Write back the diskio sector cache and drop it, so the read-back
+    // below comes from the card
+    if (disk_ioctl(0, CTRL_SYNC, NULL) != RES_OK) {
+        printf("✗ Sync FAILED (disk error)\r\n");
+        LED_REG = 0x00;
+        result = FR_DISK_ERR;
+        goto cleanup;
+    }
+    disk_cache_invalidate();
+
     // Verify written data by reading back and calculating CRC
     printf("========================================\r\n");
     printf("Verifying Written Data...\r\n");
     printf("========================================\r\n");
 
-    uint32_t num_sectors_written = sector_num - 1;
-    uint32_t verify_crc = 0xFFFFFFFF;
+    uint32_t num_sectors_written = sector_num - s_boot.image;
+    uint32_t verify_crc = 0;
     uint8_t verify_buffer[512];
 
     printf("Reading back %lu sectors...\r\n", (unsigned long)num_sectors_written);
 
     for (uint32_t i = 0; i < num_sectors_written; i++) {
         // Read sector
-        disk_res = disk_read(0, verify_buffer, i + 1, 1);
+        disk_res = disk_read(0, verify_buffer, s_boot.image + i, 1);
         if (disk_res != RES_OK) {
             printf("✗ Read FAILED at sector %lu (disk error: %d)\r\n",
-                   (unsigned long)(i + 1), disk_res);
+                   (unsigned long)(s_boot.image + i), disk_res);
             LED_REG = 0x00;
             result = FR_DISK_ERR;
             goto cleanup;
@@ -989,9 +1380,7 @@ FRESULT bootloader_upload_compressed_to_partition(void) {
             }
         }
 
-        for (uint32_t j = 0; j < bytes_to_crc; j++) {
-            verify_crc = (verify_crc >> 8) ^ crc32_table[(verify_crc ^ verify_buffer[j]) & 0xFF];
-        }
+        verify_crc = crc32_update(verify_crc, verify_buffer, bytes_to_crc);
 
         // Show progress every 64 sectors
         if ((i & 0x3F) == 0x3F || i == num_sectors_written - 1) {
@@ -1003,18 +1392,32 @@ FRESULT bootloader_upload_compressed_to_partition(void) {
         }
     }
 
-    verify_crc ^= 0xFFFFFFFF;  // Finalize CRC
-
     printf("✓ Read Complete\r\n");
     printf("\r\n");
 
-    // Calculate CRC of decompressed data (we need to decompress again for comparison)
-    // Actually, we can't easily get the original decompressed CRC since we wrote it
-    // sector-by-sector. Instead, just report the verify CRC.
-    printf("Decompressed data CRC32: 0x%08lX\r\n", (unsigned long)verify_crc);
-    printf("Data integrity: Verified\r\n");
+    // Compare with the CRC taken while decompressing
+    printf("Decompressed CRC: 0x%08lX\r\n", (unsigned long)image_crc);
+    printf("Verified CRC:     0x%08lX\r\n", (unsigned long)verify_crc);
+    if (verify_crc != image_crc) {
+        printf("\r\n");
+        printf("✗✗✗ CRITICAL ERROR ✗✗✗\r\n");
+        printf("CRC MISMATCH after write!\r\n");
+        printf("Bootloader partition data is CORRUPTED!\r\n");
+        LED_REG = 0x00;
+        result = FR_INT_ERR;
+        goto cleanup;
+    }
     printf("\r\n");
 
+    // Image verified: point the SD bootloader at it
+    if (write_boot_header(total_decompressed, image_crc,
+                          total_decompressed, BOOT_COMP_NONE) != RES_OK) {
+        printf("✗ Write FAILED at sector %d (boot header)\r\n", s_boot.header);
+        LED_REG = 0x00;
+        result = FR_DISK_ERR;
+        goto cleanup;
+    }
+
     printf("========================================\r\n");
     printf("✓✓✓ SUCCESS ✓✓✓\r\n");
     printf("========================================\r\n");
@@ -1022,9 +1425,11 @@ FRESULT bootloader_upload_compressed_to_partition(void) {
     printf("Size: %lu bytes (%lu KB decompressed)\r\n",
            (unsigned long)total_decompressed,
            (unsigned long)(total_decompressed / 1024));
-    printf("Sectors: 1-%lu (%lu sectors total)\r\n",
+    printf("Sectors: %d-%lu (%lu sectors total, header in sector %d)\r\n",
+           s_boot.image,
+           (unsigned long)(s_boot.image + num_sectors_written - 1),
            (unsigned long)num_sectors_written,
-           (unsigned long)num_sectors_written);
+           s_boot.header);
     printf("CRC32: 0x%08lX (verified)\r\n", (unsigned long)verify_crc);
     printf("Data integrity: 100%% confirmed\r\n");
     printf("========================================\r\n");
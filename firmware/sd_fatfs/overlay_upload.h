@@ -120,11 +120,15 @@ FRESULT overlay_upload_and_execute(void);
 //
 // This function uploads bootloader code to the same UPLOAD_BUFFER_BASE
 // memory location as overlays, but instead of saving to a file, it
-// writes the data directly to raw sectors 1-1024 (512KB bootloader partition).
+// writes the data directly to the boot slot (../sd_bootloader/boot_header.h)
+// the card does not boot from: the image and, once it reads back clean, a
+// boot_header_t with its length, CRC32, the next image_version and the
+// current SPI speed for the SD bootloader. The other slot is left alone,
+// so a failed update still boots the previous image.
 //
 FRESULT bootloader_upload_to_partition(void);
 
-// Upload GZIP-COMPRESSED bootloader via UART, decompress, and write to raw sectors 1-1024
+// Upload GZIP-COMPRESSED bootloader via UART, decompress, and write to the free boot slot
 // Protocol: FAST streaming (same as overlay upload) but data is gzip compressed
 //
 // Returns:
@@ -134,9 +138,13 @@ FRESULT bootloader_upload_to_partition(void);
 // This function:
 //   1. Uploads gzip-compressed bootloader to buffer at 0x60000 (96KB max compressed)
 //   2. Verifies CRC32 of compressed data
-//   3. Decompresses data sector-by-sector directly to SD card sectors 1-1024
+//   3. Decompresses data sector-by-sector directly to the boot slot not in use
 //   4. Can decompress up to 512KB uncompressed data (full bootloader partition)
 //
+// A .bin.lz4 file (tools/lz4boot, magic BOOT_LZ4_FILE_MAGIC) is checked and
+// stored compressed instead, with a BOOT_COMP_LZ4 boot header; the SD
+// bootloader decompresses it into SRAM while reading the card.
+//
 // Compression allows uploading large bootloaders (e.g. 161KB -> ~90KB compressed)
 // that wouldn't fit in the 96KB buffer uncompressed.
 //
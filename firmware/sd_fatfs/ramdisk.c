@@ -0,0 +1,276 @@
+//==============================================================================
+// RAM Disk - FatFS Volume "1:" in SRAM, Burst Copies to and from the SD Card
+//
+// The sectors themselves are served by diskio.c (physical drive 1). Here:
+// mounting and formatting the volume, and file copies that use the fact
+// that a RAM disk sector is just memory: a contiguous destination is
+// written or read in whole runs with no buffer in between.
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+
+#include "ramdisk.h"
+#include "diskio.h"
+#include "../overlay_sdk/common/memory_config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef CONFIG_SD_RAMDISK
+static FATFS s_ramfs;
+#endif
+static uint8_t s_mounted;
+
+//==============================================================================
+// Mount
+//==============================================================================
+
+FRESULT ramdisk_mount(int format) {
+#ifdef CONFIG_SD_RAMDISK
+    // FAT12, one sector per cluster: 123 clusters of data
+    static const MKFS_PARM opt = { FM_FAT | FM_SFD, 1, 1, RAMDISK_ROOT_ENTRIES, 512 };
+    BYTE work[FF_MAX_SS];
+    FRESULT fr = FR_NO_FILESYSTEM;
+
+    if (s_mounted && !format) {
+        return FR_OK;
+    }
+    ramdisk_unmount();
+
+    if (!format) {
+        fr = f_mount(&s_ramfs, RAMDISK_DRIVE, 1);
+    }
+    if (fr == FR_NO_FILESYSTEM) {
+        fr = f_mkfs(RAMDISK_DRIVE, &opt, work, sizeof(work));
+        if (fr == FR_OK) {
+            fr = f_mount(&s_ramfs, RAMDISK_DRIVE, 1);
+        }
+        if (fr == FR_OK) {
+            f_setlabel(RAMDISK_DRIVE RAMDISK_LABEL);
+        }
+    }
+    if (fr != FR_OK) {
+        f_mount(NULL, RAMDISK_DRIVE, 0);
+        return fr;
+    }
+
+    s_mounted = 1;
+    return FR_OK;
+#else
+    (void)format;
+    return FR_NOT_READY;
+#endif
+}
+
+void ramdisk_unmount(void) {
+    if (s_mounted) {
+        f_mount(NULL, RAMDISK_DRIVE, 0);
+        s_mounted = 0;
+    }
+}
+
+int ramdisk_mounted(void) {
+    return s_mounted;
+}
+
+//==============================================================================
+// Copies
+//==============================================================================
+
+// Bounce buffer, FatFS allocating the destination as it goes. Whole
+// chunks of whole sectors still reach the card as multi-block transfers.
+static FRESULT copy_buffered(FIL *in, FIL *out) {
+    BYTE *buf = malloc(RAMDISK_COPY_CHUNK);
+    FRESULT fr;
+    UINT br, bw;
+
+    if (!buf) {
+        return FR_NOT_ENOUGH_CORE;
+    }
+
+    do {
+        fr = f_read(in, buf, RAMDISK_COPY_CHUNK, &br);
+        if (fr == FR_OK && br > 0) {
+            fr = f_write(out, buf, br, &bw);
+            if (fr == FR_OK && bw != br) {
+                fr = FR_DENIED;     // Volume full
+            }
+        }
+    } while (fr == FR_OK && br == RAMDISK_COPY_CHUNK);
+
+    free(buf);
+    return fr;
+}
+
+#ifdef CONFIG_SD_RAMDISK
+
+// Runs of the source file the cluster link map can describe (fragments)
+#define COPY_RUNS       16
+
+// First sector of a file allocated with f_expand()
+static LBA_t file_sector(FIL *fp) {
+    FATFS *fs = fp->obj.fs;
+
+    return fs->database + (LBA_t)fs->csize * (fp->obj.sclust - 2);
+}
+
+// Source on the RAM disk: one disk_write() per fragment, from SRAM into the
+// contiguous destination. FR_NOT_ENOUGH_CORE: more than COPY_RUNS fragments.
+static FRESULT copy_from_ram(FIL *in, FIL *out, FSIZE_t size) {
+    DWORD clmt[1 + 2 * COPY_RUNS + 1];
+    FATFS *rfs = in->obj.fs;
+    LBA_t sector = file_sector(out);
+    UINT left = (UINT)((size + 511) / 512);
+    FRESULT fr;
+
+    // Cluster link map: (run length, first cluster) pairs, 0 terminated
+    clmt[0] = sizeof(clmt) / sizeof(clmt[0]);
+    in->cltbl = clmt;
+    fr = f_lseek(in, CREATE_LINKMAP);
+    in->cltbl = 0;
+    if (fr != FR_OK) {
+        return fr;
+    }
+
+    for (const DWORD *run = clmt + 1; run[0] != 0 && left > 0; run += 2) {
+        LBA_t first = rfs->database + (LBA_t)rfs->csize * (run[1] - 2);
+        UINT count = run[0] * rfs->csize;
+
+        if (count > left) {
+            count = left;
+        }
+        if (disk_write(out->obj.fs->pdrv, (const BYTE *)RAMDISK_BASE + first * 512,
+                       sector, count) != RES_OK) {
+            return FR_DISK_ERR;
+        }
+        sector += count;
+        left -= count;
+    }
+
+    return left == 0 ? FR_OK : FR_INT_ERR;
+}
+
+// Destination on the RAM disk: the whole file read straight into its sectors
+static FRESULT copy_to_ram(FIL *in, FIL *out, FSIZE_t size) {
+    UINT br;
+    FRESULT fr = f_read(in, (BYTE *)RAMDISK_BASE + file_sector(out) * 512, (UINT)size, &br);
+
+    if (fr == FR_OK && br != size) {
+        fr = FR_DISK_ERR;
+    }
+    return fr;
+}
+
+#endif // CONFIG_SD_RAMDISK
+
+// Copy without a buffer when the RAM disk is one end and the destination
+// can be allocated in one piece. FR_DENIED: not possible, use the buffer.
+static FRESULT copy_direct(FIL *in, FIL *out, FSIZE_t size) {
+#ifdef CONFIG_SD_RAMDISK
+    int from_ram = in->obj.fs->pdrv == RAMDISK_PDRV;
+    int to_ram = out->obj.fs->pdrv == RAMDISK_PDRV;
+    FRESULT fr;
+
+    if (!from_ram && !to_ram) {
+        return FR_DENIED;
+    }
+
+    // FR_DENIED if no free run is big enough
+    fr = f_expand(out, size, 1);
+    if (fr != FR_OK) {
+        return fr;
+    }
+
+    if (from_ram) {
+        // Too fragmented: the buffered copy fills the allocated file
+        fr = copy_from_ram(in, out, size);
+        return fr == FR_NOT_ENOUGH_CORE ? FR_DENIED : fr;
+    }
+    return copy_to_ram(in, out, size);
+#else
+    (void)in;
+    (void)out;
+    (void)size;
+    return FR_DENIED;
+#endif
+}
+
+FRESULT ramdisk_copy(const char *src, const char *dst, FSIZE_t *copied) {
+    FIL in, out;
+    FSIZE_t size;
+    FRESULT fr, fr_close;
+
+    *copied = 0;
+
+    fr = f_open(&in, src, FA_READ);
+    if (fr != FR_OK) {
+        return fr;
+    }
+    fr = f_open(&out, dst, FA_WRITE | FA_CREATE_ALWAYS);
+    if (fr != FR_OK) {
+        f_close(&in);
+        return fr;
+    }
+
+    size = f_size(&in);
+    if (size > 0) {
+        fr = copy_direct(&in, &out, size);
+        if (fr == FR_DENIED) {
+            fr = copy_buffered(&in, &out);
+        }
+    }
+
+    f_close(&in);
+    fr_close = f_close(&out);
+    if (fr == FR_OK) {
+        fr = fr_close;
+    }
+
+    if (fr != FR_OK) {
+        f_unlink(dst);
+        return fr;
+    }
+    *copied = size;
+    return FR_OK;
+}
+
+FRESULT ramdisk_save(const char *dst_dir, uint32_t *files) {
+    char src[FF_MAX_LFN + 8];
+    char dst[FF_MAX_LFN + 64];
+    FILINFO fno;
+    FSIZE_t copied;
+    DIR dir;
+    FRESULT fr;
+
+    *files = 0;
+    if (!s_mounted) {
+        return FR_NOT_READY;
+    }
+
+    fr = f_mkdir(dst_dir);
+    if (fr != FR_OK && fr != FR_EXIST) {
+        return fr;
+    }
+
+    fr = f_opendir(&dir, RAMDISK_DRIVE "/");
+    if (fr != FR_OK) {
+        return fr;
+    }
+
+    while ((fr = f_readdir(&dir, &fno)) == FR_OK && fno.fname[0] != 0) {
+        if (fno.fattrib & AM_DIR) {
+            continue;
+        }
+        snprintf(src, sizeof(src), RAMDISK_DRIVE "/%s", fno.fname);
+        snprintf(dst, sizeof(dst), "%s/%s", dst_dir, fno.fname);
+        fr = ramdisk_copy(src, dst, &copied);
+        if (fr != FR_OK) {
+            break;
+        }
+        (*files)++;
+    }
+
+    f_closedir(&dir);
+    return fr;
+}
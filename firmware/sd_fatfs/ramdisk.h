@@ -0,0 +1,51 @@
+//==============================================================================
+// RAM Disk - FatFS Volume "1:" in SRAM, Burst Copies to and from the SD Card
+//
+// With Kconfig SD_RAMDISK, RAMDISK_SIZE bytes at RAMDISK_BASE
+// (overlay_sdk/common/memory_config.h) are a second FatFS volume. Tools
+// stage files, unpack images and keep temporary files there at memory
+// speed, then copy the results to the card:
+//
+//   ramdisk_mount(0);                               // Formats if empty
+//   f_open(&f, "1:/IMAGE.RAW", FA_WRITE | FA_CREATE_ALWAYS);
+//   ...
+//   ramdisk_copy("1:/IMAGE.RAW", "0:/DATA/IMAGE.RAW", &bytes);
+//
+// ramdisk_copy() allocates the destination contiguously (f_expand) and
+// moves the data without a bounce buffer: from the RAM disk, one CMD25
+// straight out of SRAM per fragment of the source; to the RAM disk, one
+// f_read() into its sectors. Copies that cannot (either end fragmented or
+// no RAM disk involved) go through a RAMDISK_COPY_CHUNK buffer.
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+
+#ifndef RAMDISK_H
+#define RAMDISK_H
+
+#include <stdint.h>
+#include "ff.h"
+
+#define RAMDISK_PDRV            1           // Physical drive (diskio.c)
+#define RAMDISK_DRIVE           "1:"
+#define RAMDISK_LABEL           "RAMDISK"
+#define RAMDISK_ROOT_ENTRIES    64          // FAT12 root directory (4 sectors)
+#define RAMDISK_COPY_CHUNK      (16 * 1024) // Bounce buffer (malloc) for other copies
+
+// Mount "1:". A volume already in SRAM (from before an overlay run or a
+// reset) is kept unless format is set; none, or format: f_mkfs, FAT12 with
+// 512-byte clusters. FR_NOT_READY: no RAM disk in this build, or the heap
+// already reaches into the region.
+FRESULT ramdisk_mount(int format);
+void ramdisk_unmount(void);
+int ramdisk_mounted(void);
+
+// Copy file src to dst (replaced), on any volumes. copied: bytes (may be 0)
+FRESULT ramdisk_copy(const char *src, const char *dst, FSIZE_t *copied);
+
+// Copy every file in the RAM disk's root directory into dst_dir (created
+// if missing); files: number copied (may be 0)
+FRESULT ramdisk_save(const char *dst_dir, uint32_t *files);
+
+#endif // RAMDISK_H
@@ -0,0 +1,145 @@
+//==============================================================================
+// Asynchronous SD I/O - Request Queue with Completion Callbacks
+//
+// A FIFO of requests; the head one owns the card. Each poll moves it one
+// step along open -> (start sector -> DMA -> end sector) x count -> close,
+// as far as it can go without waiting: a missing data token or a card
+// still busy programming ends the poll, and so does a running DMA.
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+
+#include "sd_async.h"
+#include "sd_spi.h"
+#include "io.h"
+#include <stddef.h>
+
+// Steps of the head request
+#define PH_OPEN     0       // Stream not open yet
+#define PH_START    1       // Waiting for the token / end of busy
+#define PH_DMA      2       // Sector transfer running
+#define PH_CLOSE    3       // CMD12 / stop token
+
+static sd_async_req_t *s_head;      // Active request (queue head)
+static sd_async_req_t *s_tail;
+static uint8_t s_phase = PH_OPEN;
+static uint8_t s_result;            // First error of the active request
+
+//==============================================================================
+// Queue
+//==============================================================================
+
+uint8_t sd_async_submit(sd_async_req_t *req) {
+    if (req->count == 0 || req->state == SD_ASYNC_QUEUED || req->state == SD_ASYNC_ACTIVE) {
+        return SD_ERROR_NOT_READY;
+    }
+
+    req->completed = 0;
+    req->result = SD_OK;
+    req->next = NULL;
+    req->state = SD_ASYNC_QUEUED;
+
+    if (s_tail) {
+        s_tail->next = req;
+    } else {
+        s_head = req;
+    }
+    s_tail = req;
+    return SD_OK;
+}
+
+// Head request done: off the queue first, so the callback may submit
+static void req_complete(sd_async_req_t *req, uint8_t result) {
+    s_head = req->next;
+    if (!s_head) {
+        s_tail = NULL;
+    }
+    s_phase = PH_OPEN;
+
+    req->next = NULL;
+    req->result = result;
+    req->state = SD_ASYNC_DONE;
+    if (req->done) {
+        req->done(req, result);
+    }
+}
+
+//==============================================================================
+// Service
+//==============================================================================
+
+int sd_async_poll(void) {
+    sd_async_req_t *req;
+    uint8_t r;
+
+    while ((req = s_head) != NULL) {
+        switch (s_phase) {
+        case PH_OPEN:
+            r = sd_stream_open(req->sector, req->count, req->write);
+            if (r != SD_OK) {
+                req_complete(req, r);       // Nothing to close
+                break;
+            }
+            req->state = SD_ASYNC_ACTIVE;
+            s_result = SD_OK;
+            s_phase = PH_START;
+            break;
+
+        case PH_START:
+            r = sd_stream_start(req->buffer + req->completed * 512);
+            if (r == SD_ERROR_NOT_READY) {
+                return 1;
+            }
+            if (r != SD_OK) {
+                s_result = r;
+                s_phase = PH_CLOSE;
+                break;
+            }
+            s_phase = PH_DMA;
+            break;
+
+        case PH_DMA:
+            if (sd_stream_busy()) {
+                return 1;
+            }
+            r = sd_stream_end();
+            if (r != SD_OK) {
+                s_result = r;
+                s_phase = PH_CLOSE;
+                break;
+            }
+            req->completed++;
+            s_phase = (req->completed < req->count) ? PH_START : PH_CLOSE;
+            break;
+
+        default:    // PH_CLOSE
+            r = sd_stream_close();
+            if (r == SD_ERROR_NOT_READY) {
+                return 1;
+            }
+            req_complete(req, (s_result != SD_OK) ? s_result : r);
+            break;
+        }
+    }
+
+    return 0;
+}
+
+uint8_t sd_async_wait(sd_async_req_t *req) {
+    // DMAs started from here raise the completion IRQ that the wait sleeps on
+    spi_dma_sleep(1);
+    while (req->state != SD_ASYNC_DONE) {
+        sd_async_poll();
+        if (req->state != SD_ASYNC_DONE && sd_stream_busy()) {
+            spi_dma_wait();
+        }
+    }
+    spi_dma_sleep(0);
+
+    return req->result;
+}
+
+void sd_async_drain(void) {
+    while (sd_async_poll());
+}
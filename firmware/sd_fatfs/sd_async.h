@@ -0,0 +1,81 @@
+//==============================================================================
+// Asynchronous SD I/O - Request Queue with Completion Callbacks
+//
+// Sector-range reads and writes that run while the caller works: each
+// request is one CMD18 / CMD25 stream whose sectors move by SPI DMA, and
+// sd_async_poll() (main loop, idle hook, or the busy loop of a task)
+// starts the next sector whenever the last one is in. Requests run in
+// submission order, one stream at a time.
+//
+// Usage (read the next chunk while checking the one before):
+//   sd_async_req_t req = { .sector = lba, .buffer = buf, .count = 64 };
+//   sd_async_submit(&req);
+//   while (!sd_async_done(&req)) {
+//       sd_async_poll();
+//       ... work on what req.completed says is in buf ...
+//   }
+//
+// sd_async_wait() sleeps on the SPI DMA completion IRQ between polls
+// (waitirq, or a FreeRTOS IRQ wait), so a task blocked on a request leaves
+// the CPU to others. The callback runs inside sd_async_poll(); from there
+// a FreeRTOS task can be notified (xTaskNotifyGive) instead of waiting.
+//
+// The queue works below diskio and its sector cache: the synchronous
+// sd_* calls and disk_read() / disk_write() must not run while a request
+// is active (sd_async_drain() first), and sectors written here that the
+// cache may hold need disk_cache_invalidate(). Word-aligned SRAM buffers
+// go by DMA; others are copied by the CPU, one sector per poll.
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//==============================================================================
+
+#ifndef SD_ASYNC_H
+#define SD_ASYNC_H
+
+#include <stdint.h>
+
+typedef struct sd_async_req sd_async_req_t;
+
+// Request finished: result is an sd_error_t (SD_OK)
+typedef void (*sd_async_cb_t)(sd_async_req_t *req, uint8_t result);
+
+struct sd_async_req {
+    uint32_t sector;                // First sector
+    uint8_t *buffer;                // count * 512 bytes (writes: the data)
+    uint32_t count;
+    uint8_t  write;                 // 1: CMD25, 0: CMD18
+    sd_async_cb_t done;             // Optional
+    void    *arg;                   // For the callback
+
+    // Set by the queue
+    volatile uint32_t completed;    // Sectors transferred so far
+    volatile uint8_t  state;        // SD_ASYNC_*
+    uint8_t  result;                // sd_error_t once SD_ASYNC_DONE
+    sd_async_req_t *next;
+};
+
+// Request states
+#define SD_ASYNC_IDLE       0       // Not submitted (or reused)
+#define SD_ASYNC_QUEUED     1
+#define SD_ASYNC_ACTIVE     2       // Its stream is open
+#define SD_ASYNC_DONE       3
+
+// Queue req (filled in up to arg). SD_OK, or SD_ERROR_NOT_READY if it is
+// already queued or has no sectors.
+uint8_t sd_async_submit(sd_async_req_t *req);
+
+// Move the queue on; never waits for the card. 1 while requests remain.
+int sd_async_poll(void);
+
+static inline int sd_async_done(const sd_async_req_t *req) {
+    return req->state == SD_ASYNC_DONE;
+}
+
+// Poll until req is done, sleeping between polls; its result
+uint8_t sd_async_wait(sd_async_req_t *req);
+
+// Poll until no request is left (before synchronous SD access)
+void sd_async_drain(void);
+
+#endif // SD_ASYNC_H
@@ -12,16 +12,34 @@
 #include <stdint.h>
 #include <string.h>
 #include "../../lib/incurses/curses.h"
+#include "../../lib/perf_counters.h"
+#include "../../lib/timer.h"
+#include "../../lib/uart_irq.h"
+#include "../../lib/mem_stats.h"
+#include "../../lib/trace/trace.h"
+#include "../../lib/hrtimer/hrtimer.h"
 #include "ff.h"
 #include "diskio.h"
+#include "disk_cache.h"
 #include "sd_spi.h"
 #include "hardware.h"
 #include "io.h"
 #include "help.h"
 #include "overlay_upload.h"
 #include "overlay_loader.h"
+#include "overlay_resident.h"
 #include "file_browser.h"
 #include "crash_dump.h"
+#include "crash_sd.h"
+#include "config_sd.h"
+#include "log_writer.h"
+#include "free_count.h"
+#include "ramdisk.h"
+#include "../../lib/spi_flash.h"
+#include "../../lib/spi_port.h"
+#ifdef PGO_GENERATE
+#include "../../lib/pgo/pgo.h"
+#endif
 
 //==============================================================================
 // Timer Functions (copied from spi_test.c)
@@ -97,70 +115,83 @@ volatile uint8_t timer_tick_flag = 0;
 // Function pointer for overlay timer interrupt handler
 // Overlays can set this to their timer handler function
 // Placed at fixed address 0x2A000 (via linker.ld .overlay_comm section) so overlays can find it
+// Deprecated: overlays built against services version 4 register through
+// irq_register() (overlay_sdk/common/overlay_irq.h) and are called from
+// irq_handler itself, without this dispatch
 volatile void (*overlay_timer_irq_handler)(void) __attribute__((section(".overlay_comm"))) = 0;
 
-// External crash context (filled by assembly IRQ wrapper in start.S)
-extern crash_context_t g_crash_context;
-
 // IRQ control functions (from spi_test.c)
 static inline void irq_setmask(uint32_t mask) {
     uint32_t dummy;
     __asm__ volatile (".insn r 0x0B, 6, 3, %0, %1, x0" : "=r"(dummy) : "r"(mask));
 }
 
-// Interrupt handler (called from start.S)
-// This overrides the weak irq_handler symbol
-void irq_handler(uint32_t irqs) {
-    if (irqs & (1 << 0)) {  // Timer interrupt (IRQ[0])
-        // Check if this is a watchdog timeout (one-shot mode)
-        if (TIMER_CR & (1 << 2)) {  // TIMER_ONE_SHOT bit set
-            // This is a watchdog timeout - overlay hung!
-            TIMER_SR = TIMER_SR_UIF;  // Clear interrupt
-            TIMER_CR = 0;             // Disable timer
-
-            // Read PC from q2
-            uint32_t pc;
-            __asm__ volatile (".insn r 0x0B, 4, 0, %0, x2, x0" : "=r"(pc));
-
-            // 3 fast blinks to show watchdog triggered
-            for (int i = 0; i < 3; i++) {
-                LED_REG = 0x03;  // Both on
-                for (volatile int j = 0; j < 500000; j++);
-                LED_REG = 0x00;  // Both off
-                for (volatile int j = 0; j < 500000; j++);
-            }
+// Interrupt handler, called from irq_handler in crash_dump.c (which
+// overrides the weak start.S symbol) with the irq_vec_fast frame and the
+// sources no overlay has registered
+void app_irq_handler(uint32_t irqs, const uint32_t *frame) {
+    TRACE_ISR_ENTER_MASK(irqs);
+
+    if (irqs & (1 << 1)) {  // EBREAK/ECALL/illegal instruction (IRQ[1])
+        // Return address in q0; bit 0 set after a compressed instruction
+        uint32_t q0;
+        __asm__ volatile (".insn r 0x0B, 4, 0, %0, x0, x0" : "=r"(q0));  // getq q0
+        uint32_t pc = (q0 & 1) ? q0 - 3 : q0 - 4;
+
+        if (overlay_page_fault(pc)) {
+            // Page of a lazily loaded overlay read: run the instruction again
+            __asm__ volatile (".insn r 0x0B, 2, 1, x0, %0, x0" : : "r"(pc));  // setq q0
+        } else {
+            crash_context_t *ctx = &g_crash_context;
 
-            // Toggle LEDs back and forth 100 times (clearly visible)
-            for (int i = 0; i < 100; i++) {
-                LED_REG = 0x01;  // LED1 only
-                for (volatile int j = 0; j < 500000; j++);
-                LED_REG = 0x02;  // LED2 only
-                for (volatile int j = 0; j < 500000; j++);
-            }
+            crash_capture(ctx, irqs, frame);
+            ctx->pc = pc;
+            crash_report_sd(crash_sd_write(ctx, CRASH_CAUSE_TRAP, 0));
 
-            // Halt with both LEDs on
-            while (1) {
-                LED_REG = 0x03;  // Both LEDs on = done
-            }
-        } else {
-            // This is a normal continuous timer tick
-            timer_clear_irq_bench();
+            printf("\r\n*** Illegal instruction/EBREAK at 0x%08lX ***\r\n", (unsigned long)pc);
+            crash_dump_memory((pc & ~15u) - 32, 64);
 
-            // Call overlay timer handler if one is registered
-            if (overlay_timer_irq_handler) {
-                overlay_timer_irq_handler();
-            }
+            // Halt with LED1 on, SRAM available to fw_upload_fast -D
+            LED_REG = 0x01;
+            crash_serve_memory(CRASH_SRAM_BASE, CRASH_SRAM_SIZE);
+        }
+    }
 
-            // Update bytes_per_second (average over last second)
-            bytes_per_second = bytes_transferred_this_second;
+    if (irqs & (1 << 7)) {  // Timer channels 1-3, watchdog pre-timeout (IRQ[7])
+        // io.c delays (lib/hrtimer, channel 1), if one is armed
+        hrt_irq();
+        // Overlay hung: dump registers and serve SRAM (no return if so)
+        crash_watchdog_irq(irqs, frame);
+    }
 
-            // Reset for next measurement period
-            bytes_transferred_this_second = 0;
+    if (irqs & (1 << IRQ_UART_RX)) {  // RX data (IRQ[4]), armed by uart_getc() (io.c)
+        // A level: disarm, uart_getc() reads the byte. The other sources
+        // io.c unmasks while it sleeps need nothing here.
+        uart_irq_disable(UART_IRQ_RX_ALL);
+    }
 
-            // Set flag to notify main loop
-            timer_tick_flag = 1;
+    if (irqs & (1 << 0)) {  // Timer interrupt (IRQ[0])
+        // Normal continuous timer tick
+        timer_clear_irq_bench();
+
+        // Call overlay timer handler if one is registered. Its code must
+        // not fault inside the interrupt: read any pages still missing
+        if (overlay_timer_irq_handler) {
+            overlay_page_in_all();
+            overlay_timer_irq_handler();
         }
+
+        // Update bytes_per_second (average over last second)
+        bytes_per_second = bytes_transferred_this_second;
+
+        // Reset for next measurement period
+        bytes_transferred_this_second = 0;
+
+        // Set flag to notify main loop
+        timer_tick_flag = 1;
     }
+
+    TRACE_ISR_EXIT_MASK();
 }
 
 //==============================================================================
@@ -185,6 +216,51 @@ void format_bytes_per_sec(uint32_t bytes_per_sec, char *buf, int buf_size) {
     }
 }
 
+// Print elapsed time and CPI for one benchmark phase (rdcycle/rdinstret)
+static void show_bench_perf(int row, const perf_sample_t *start, const perf_sample_t *end) {
+    uint32_t cycles = end->cycles - start->cycles;
+    uint32_t instret = end->instret - start->instret;
+    uint32_t us = perf_cycles_to_us(cycles);
+    uint32_t cpi = perf_cpi_x100(cycles, instret);
+    char buf[80];
+
+    snprintf(buf, sizeof(buf), "Cycles: %lu (%lu.%03lu ms)  Instret: %lu  CPI: %lu.%02lu",
+             (unsigned long)cycles, (unsigned long)(us / 1000), (unsigned long)(us % 1000),
+             (unsigned long)instret, (unsigned long)(cpi / 100), (unsigned long)(cpi % 100));
+    move(row, 0);
+    addstr(buf);
+    clrtoeol();
+}
+
+// diskio sector cache counters since disk_cache_reset_stats()
+static void show_cache_stats(int row) {
+    disk_cache_stats_t st;
+    uint32_t lookups;
+    char buf[80];
+
+    move(row, 0);
+    if (disk_cache_sectors() == 0) {
+        addstr("Sector cache: disabled (CONFIG_SD_CACHE)");
+        clrtoeol();
+        return;
+    }
+
+    disk_cache_get_stats(&st);
+    lookups = st.hits + st.misses;
+    snprintf(buf, sizeof(buf), "Sector cache (%lu x 512B, %lu-way): %lu hits / %lu lookups (%lu%%)",
+             (unsigned long)disk_cache_sectors(), (unsigned long)disk_cache_ways(),
+             (unsigned long)st.hits, (unsigned long)lookups,
+             (unsigned long)(lookups ? (uint32_t)((uint64_t)st.hits * 100 / lookups) : 0));
+    addstr(buf);
+    clrtoeol();
+
+    move(row + 1, 0);
+    snprintf(buf, sizeof(buf), "  Read-ahead: %lu  Bypassed: %lu  Written back: %lu sectors",
+             (unsigned long)st.readahead, (unsigned long)st.bypass, (unsigned long)st.writebacks);
+    addstr(buf);
+    clrtoeol();
+}
+
 //==============================================================================
 // FatFS Required Functions
 //==============================================================================
@@ -219,8 +295,11 @@ DWORD get_fattime(void) {
 #define MENU_CREATE_FILE    10
 #define MENU_BENCHMARK      11
 #define MENU_SPI_SPEED      12
-#define MENU_EJECT_CARD     13
-#define NUM_MENU_OPTIONS    14
+#define MENU_PROGRAM_FLASH  13
+#define MENU_RAMDISK        14
+#define MENU_SPI_STREAM     15
+#define MENU_EJECT_CARD     16
+#define NUM_MENU_OPTIONS    17
 
 //==============================================================================
 // Global State
@@ -230,43 +309,28 @@ static FATFS g_fs;              // FatFS filesystem object
 uint8_t g_card_mounted = 0;  // Global - used by file_browser.c
 static uint8_t g_card_detected = 0;
 static uint32_t g_spi_speed = SPI_CLK_12MHZ;  // Default: 12.5 MHz
-
-static const char *spi_speed_names[] = {
-    "50.0 MHz", "25.0 MHz", "12.5 MHz", "6.25 MHz",
-    "3.125 MHz", "1.562 MHz", "781 kHz", "390 kHz"
-};
+static uint32_t g_init_ms = 0;          // Last card init
+static uint32_t g_full_init_ms = 0;     // Full init on this card (settings), 0 if unknown
 
 static const uint32_t spi_speeds[] = {
     SPI_CLK_50MHZ, SPI_CLK_25MHZ, SPI_CLK_12MHZ, SPI_CLK_6MHZ,
     SPI_CLK_3MHZ, SPI_CLK_1MHZ, SPI_CLK_781KHZ, SPI_CLK_390KHZ
 };
 
-//==============================================================================
-// Arrow Key Helper - Detects ESC [ A/B sequences from arrow keys
-//==============================================================================
+#define NUM_SPI_SPEEDS      8
+#define SPI_TUNE_MAX_DIV    16          // Slowest divider tried (half period clocks)
+#define SPI_TUNE_READS      4           // CRC-checked reads per setting
 
-int get_key_with_arrows(void) {
-    int ch = getch();
+// Actual SCK rate of a SPI_CTRL speed value, e.g. "12.50 MHz" / "390 kHz"
+static void format_spi_speed(char *buf, size_t len, uint32_t speed) {
+    uint32_t hz = spi_sck_hz(speed);
 
-    if (ch == 27) {  // ESC - could be arrow key sequence or just ESC
-        // Check if this is an arrow key (ESC [ X) or just ESC
-        timeout(10);  // Brief timeout to check for following characters
-        int ch2 = getch();
-        if (ch2 == '[') {
-            int ch3 = getch();
-            timeout(-1);
-            if (ch3 == 'A') return KEY_UP;       // Up arrow
-            else if (ch3 == 'B') return KEY_DOWN;  // Down arrow
-            else if (ch3 == 'C') return KEY_RIGHT; // Right arrow
-            else if (ch3 == 'D') return KEY_LEFT;  // Left arrow
-            else return 27;  // Unknown escape sequence, return ESC
-        } else {
-            timeout(-1);
-            return 27;  // Just ESC key
-        }
+    if (hz >= 1000000) {
+        snprintf(buf, len, "%lu.%02lu MHz", (unsigned long)(hz / 1000000),
+                 (unsigned long)((hz % 1000000) / 10000));
+    } else {
+        snprintf(buf, len, "%lu kHz", (unsigned long)(hz / 1000));
     }
-
-    return ch;  // Normal character
 }
 
 //==============================================================================
@@ -278,11 +342,18 @@ void draw_status_bar(void) {
     attron(A_REVERSE);
 
     char status[128];
+    char speed[16];
+    mem_stats_t mem;
+    format_spi_speed(speed, sizeof(speed), g_spi_speed);
+    mem_stats_get(&mem);
     snprintf(status, sizeof(status),
-             " Card: %s | Mounted: %s | Speed: %s ",
+             " Card: %s | Mounted: %s | Speed: %s | Heap %lu/%luK | Stk %luK ",
              g_card_detected ? "DETECTED" : "NOT FOUND",
              g_card_mounted ? "YES" : "NO",
-             spi_speed_names[g_spi_speed >> 2]);
+             speed,
+             (unsigned long)(mem.heap_peak / 1024),
+             (unsigned long)(mem.heap_size / 1024),
+             (unsigned long)(mem.stack_peak / 1024));
 
     addstr(status);
 
@@ -294,6 +365,130 @@ void draw_status_bar(void) {
     standend();
 }
 
+//==============================================================================
+// Saved Settings (config_sd.c)
+//==============================================================================
+
+// Initialize the card, skipping the slow part when it is still up
+static uint8_t card_init(void) {
+    uint32_t t0 = rdcycle();
+    uint8_t result = sd_init_fast();
+
+    g_init_ms = (rdcycle() - t0) / (uint32_t)(PERF_CPU_HZ / 1000);
+    return result;
+}
+
+// Take the SPI speed saved on the card just initialized, if there is one,
+// instead of the default or one tuned for another card. The settings are
+// only trusted when the card record matches (CID, type, capacity); the
+// record is written on the first full init of a card.
+static void load_card_settings(void) {
+    sd_card_info_t info;
+    uint32_t speed, init_ms;
+    int known, recorded;
+
+    g_full_init_ms = 0;
+    if (config_sd_load() != SD_OK) {
+        sd_set_speed(g_spi_speed);
+        return;
+    }
+
+    recorded = config_sd_get_card(&info, &init_ms);
+    known = recorded && sd_match_card_info(&info);
+    if (known) {
+        g_full_init_ms = init_ms;
+    }
+    if (recorded && !known) {
+        g_spi_speed = SPI_CLK_12MHZ;
+    } else if (config_sd_get(CFG_KEY_SPI_CTRL, &speed) && speed != 0 &&
+               spi_sck_hz(speed) <= sd_get_max_hz()) {
+        g_spi_speed = speed;        // Tuned in high speed: the card must be again
+    }
+    sd_set_speed(g_spi_speed);  // sd_init() leaves the card at its default speed
+
+    // New card, or its full init not timed yet: record it. Settings made on
+    // another card (an image copy) are dropped.
+    if (!known || (init_ms == 0 && !sd_init_was_warm())) {
+        if (recorded && !known) {
+            config_sd_set(CFG_KEY_SPI_CTRL, 0);
+            config_sd_set(CFG_KEY_SPI_TUNED, 0);
+        }
+        g_full_init_ms = sd_init_was_warm() ? 0 : g_init_ms;
+        sd_get_card_info(&info);
+        config_sd_set_card(&info, g_full_init_ms);
+        config_sd_commit();
+    }
+}
+
+// Save g_spi_speed on the card for the next power-up and the SD bootloader;
+// 1 if it was written
+static int save_spi_speed(int tuned) {
+    if (!g_card_detected) {
+        return 0;
+    }
+    config_sd_set(CFG_KEY_SPI_CTRL, g_spi_speed);
+    config_sd_set(CFG_KEY_SPI_TUNED, (uint32_t)tuned);
+    return config_sd_commit() == SD_OK;
+}
+
+// "12 ms" or "1 ms (warm start, 180 ms saved)"
+static void format_init_time(char *buf, size_t len) {
+    if (!sd_init_was_warm()) {
+        snprintf(buf, len, "%lu ms", (unsigned long)g_init_ms);
+    } else if (g_full_init_ms > g_init_ms) {
+        snprintf(buf, len, "%lu ms (warm start, %lu ms saved)",
+                 (unsigned long)g_init_ms, (unsigned long)(g_full_init_ms - g_init_ms));
+    } else {
+        snprintf(buf, len, "%lu ms (warm start)", (unsigned long)g_init_ms);
+    }
+}
+
+// MBR partition 1 is the bootloader (type 0xDA, sectors 1-1024): the
+// filesystem is partition 2
+static int card_has_boot_partition(const uint8_t *mbr) {
+    const uint8_t *part0 = &mbr[446];
+    uint32_t lba_start = part0[8] | (part0[9] << 8) | (part0[10] << 16) | ((uint32_t)part0[11] << 24);
+    uint32_t lba_size = part0[12] | (part0[13] << 8) | (part0[14] << 16) | ((uint32_t)part0[15] << 24);
+
+    return mbr[510] == 0x55 && mbr[511] == 0xAA &&
+           part0[4] == 0xDA && lba_start == 1 && lba_size == 1024;
+}
+
+//==============================================================================
+// Hot-Plug (sd_hotplug_poll() while the main menu waits for a key)
+//==============================================================================
+
+// Card pulled: its volume goes with it. Card inserted (already initialized
+// by the poller): saved settings and mount, as Detect Card without the screen.
+static void card_hotplug(void) {
+    uint8_t mbr[512];
+
+    switch (sd_hotplug_poll()) {
+    case SD_HOTPLUG_REMOVED:
+        if (g_card_mounted) {
+            f_mount(NULL, "", 0);
+            g_card_mounted = 0;
+        }
+        disk_cache_invalidate();    // Dirty sectors have nowhere to go
+        g_card_detected = 0;
+        break;
+
+    case SD_HOTPLUG_INSERTED:
+        g_card_detected = 1;
+        g_init_ms = 0;              // Spread over the polls: not timed
+        load_card_settings();
+        if (sd_read_block(0, mbr) == SD_OK &&
+            f_mount(&g_fs, card_has_boot_partition(mbr) ? "0:2" : "", 1) == FR_OK) {
+            g_card_mounted = 1;
+            free_count_restore(&g_fs);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
 //==============================================================================
 // Detect Card
 //==============================================================================
@@ -309,11 +504,13 @@ void menu_detect_card(void) {
     addstr("Initializing SD card...");
     refresh();
 
-    uint8_t result = sd_init();
+    uint8_t result = card_init();
+    sd_hotplug_start();
 
     move(4, 0);
     if (result == SD_OK) {
         g_card_detected = 1;
+        load_card_settings();
         attron(A_REVERSE);
         addstr("✓ SD Card detected successfully!");
         standend();
@@ -335,6 +532,12 @@ void menu_detect_card(void) {
                  (unsigned long)size_mb, (unsigned long)sectors);
         addstr(buf);
 
+        move(8, 0);
+        char init_time[48];
+        format_init_time(init_time, sizeof(init_time));
+        snprintf(buf, sizeof(buf), "Init: %s", init_time);
+        addstr(buf);
+
         // Try to mount filesystem
         move(9, 0);
         addstr("Mounting filesystem...");
@@ -374,14 +577,8 @@ void menu_detect_card(void) {
 
         // Check for MBR signature
         if (test_block[510] == 0x55 && test_block[511] == 0xAA) {
-            // Check first partition entry (offset 446)
-            BYTE *part0 = &test_block[446];
-            BYTE ptype = part0[4];
-            uint32_t lba_start = part0[8] | (part0[9] << 8) | (part0[10] << 16) | (part0[11] << 24);
-            uint32_t lba_size = part0[12] | (part0[13] << 8) | (part0[14] << 16) | (part0[15] << 24);
-
-            // If partition 1 is bootloader (Type 0xDA, sectors 1-1024), mount partition 2
-            if (ptype == 0xDA && lba_start == 1 && lba_size == 1024) {
+            // If partition 1 is bootloader, mount partition 2
+            if (card_has_boot_partition(test_block)) {
                 has_bootloader_partition = 1;
                 mount_path = "0:2";  // Mount filesystem partition
                 move(12, 0);
@@ -409,6 +606,7 @@ void menu_detect_card(void) {
         move(15, 0);
         if (fr == FR_OK) {
             g_card_mounted = 1;
+            free_count_restore(&g_fs);
             addstr("✓ Filesystem mounted successfully");
 
             // Get volume label
@@ -422,9 +620,9 @@ void menu_detect_card(void) {
             }
 
             // Get free space
-            FATFS *fs;
+            FATFS *fs = &g_fs;
             DWORD fre_clust;
-            fr = f_getfree(mount_path, &fre_clust, &fs);
+            fr = free_count_get(fs, mount_path, &fre_clust);
             if (fr == FR_OK) {
                 move(17, 0);
                 DWORD total_sect = (fs->n_fatent - 2) * fs->csize;
@@ -534,10 +732,19 @@ void menu_card_info(void) {
     if (csd_result == SD_OK) {
         char buf[80];
         move(11, 2);
-        snprintf(buf, sizeof(buf), "Max Transfer Rate: %d MB/s", csd.tran_speed);
+        snprintf(buf, sizeof(buf), "Bus Speed: %s, %lu MHz max (TRAN_SPEED 0x%02X)",
+                 sd_high_speed() ? "high speed (CMD6)" : "default",
+                 (unsigned long)(sd_get_max_hz() / 1000000), csd.tran_speed);
         addstr(buf);
 
+        char speed[16];
+        format_spi_speed(speed, sizeof(speed), g_spi_speed);
         move(12, 2);
+        snprintf(buf, sizeof(buf), "SPI Clock: %s (%lu%% of the card's rating)", speed,
+                 (unsigned long)((uint64_t)spi_sck_hz(g_spi_speed) * 100 / sd_get_max_hz()));
+        addstr(buf);
+
+        move(13, 2);
         snprintf(buf, sizeof(buf), "Write Protect: %s", csd.wp ? "YES" : "NO");
         addstr(buf);
     } else {
@@ -750,9 +957,9 @@ void menu_partition_info(void) {
         move(row++, 0);
         addstr("Filesystem Information:");
 
-        FATFS *fs;
+        FATFS *fs = &g_fs;
         DWORD fre_clust;
-        FRESULT res = f_getfree("0:", &fre_clust, &fs);
+        FRESULT res = free_count_get(fs, "0:", &fre_clust);
 
         if (res == FR_OK) {
             // If we have an MBR, read the Volume Boot Record from the first partition
@@ -880,6 +1087,12 @@ void menu_partition_info(void) {
 // Format Card - Advanced Menu
 //==============================================================================
 
+// f_mkfs() writes the FATs, the exFAT bitmap and the root directory in
+// runs of its work area, one CMD25 each, so the area comes from the upload
+// buffer (nothing runs there while the menu does) rather than a 4 KB
+// static. It stops short of the firmware stack at 0x74000.
+#define FORMAT_WORK_SIZE    (64 * 1024)
+
 void menu_format_card(void) {
     // Flush any pending input before starting
     timeout(0);
@@ -890,18 +1103,28 @@ void menu_format_card(void) {
     const char* fs_types[] = {
         "FAT (auto-detect FAT12/16/32)",
         "FAT32 (recommended for <32GB)",
+#if FF_FS_EXFAT
         "exFAT (for >32GB cards)"
+#endif
     };
+#if FF_FS_EXFAT
     const BYTE fs_opts[] = {FM_FAT | FM_SFD, FM_FAT32 | FM_SFD, FM_EXFAT | FM_SFD};
+#else
+    const BYTE fs_opts[] = {FM_FAT | FM_SFD, FM_FAT32 | FM_SFD};
+#endif
+    const int fs_count = sizeof(fs_opts) / sizeof(fs_opts[0]);
 
     const char* part_types[] = {
         "No partition table (simple format)",
         "MBR partition table (recommended)",
         "MBR with bootloader partition (512KB + FS)",
+#if FF_LBA64
         "GPT partition table (exFAT only)"
+#endif
     };
+    const int part_count = sizeof(part_types) / sizeof(part_types[0]);
 
-    int selected_fs = 2;  // Default: exFAT
+    int selected_fs = fs_count - 1;  // Default: exFAT (FAT32 without it)
     int selected_part = 0;  // Default: No partition table (super floppy)
     int au_size = 0;  // Auto allocation unit
     int current_menu = 0;  // 0=fs type, 1=partition type, 2=confirm
@@ -946,7 +1169,7 @@ void menu_format_card(void) {
             addstr("[ Filesystem Type ]");
             if (current_menu == 0) standend();
 
-            for (int i = 0; i < 3; i++) {
+            for (int i = 0; i < fs_count; i++) {
                 move(5 + i, 2);
                 if (current_menu == 0 && i == selected_fs) {
                     addstr("> ");
@@ -966,7 +1189,7 @@ void menu_format_card(void) {
             addstr("[ Partition Table ]");
             if (current_menu == 1) standend();
 
-            for (int i = 0; i < 4; i++) {
+            for (int i = 0; i < part_count; i++) {
                 move(10 + i, 2);
                 if (current_menu == 1 && i == selected_part) {
                     addstr("> ");
@@ -1002,8 +1225,8 @@ void menu_format_card(void) {
         int ch;
 
         if (current_menu < 2) {
-            // Navigation mode - use arrow key helper
-            ch = get_key_with_arrows();
+            // Navigation mode - arrow keys come decoded (keypad mode)
+            ch = getch();
         } else {
             // Confirmation mode - wait for real key (matches delete_file pattern)
             while (1) {
@@ -1030,10 +1253,10 @@ void menu_format_card(void) {
                     need_redraw = 1;
                 }
             } else if (ch == KEY_DOWN || ch == 'j' || ch == 'J') {  // DOWN (arrow or j/J)
-                if (current_menu == 0 && selected_fs < 2) {
+                if (current_menu == 0 && selected_fs < fs_count - 1) {
                     selected_fs++;
                     need_redraw = 1;
-                } else if (current_menu == 1 && selected_part < 3) {  // Changed to 3 for 4 options (0-3)
+                } else if (current_menu == 1 && selected_part < part_count - 1) {
                     selected_part++;
                     need_redraw = 1;
                 }
@@ -1099,8 +1322,13 @@ void menu_format_card(void) {
     }
     // Note: selected_part == 1 (MBR) and selected_part == 2 (MBR+bootloader) handled below
 
-    // Work area for f_mkfs (needs to be large enough)
-    static BYTE work[4096];
+    // Work area for f_mkfs: the upload buffer, so resident overlays go
+    BYTE *work = (BYTE *)UPLOAD_BUFFER_BASE;
+    uint64_t format_start;
+    uint32_t format_ms = 0;
+
+    overlay_resident_clear();
+    overlay_cache_invalidate();
 
     // Special handling for bootloader partition scheme (selected_part == 2)
     FRESULT fr = FR_OK;
@@ -1260,7 +1488,9 @@ void menu_format_card(void) {
 
         // Format partition 2 by specifying "0:2" (drive 0, partition 2)
         // FatFS will read the MBR we created with f_fdisk() and format ONLY partition 2
-        fr = f_mkfs("0:2", &fmt_opt, work, sizeof(work));
+        format_start = rdcycle64();
+        fr = f_mkfs("0:2", &fmt_opt, work, FORMAT_WORK_SIZE);
+        format_ms = (uint32_t)((rdcycle64() - format_start) / (PERF_CPU_HZ / 1000));
 
         if (fr != FR_OK) {
             move(27, 0);
@@ -1271,7 +1501,9 @@ void menu_format_card(void) {
         }
 
         move(27, 0);
-        addstr("  ✓ Filesystem formatted successfully");
+        snprintf(buf, sizeof(buf), "  ✓ Filesystem formatted successfully in %lu.%02lu s",
+                 (unsigned long)(format_ms / 1000), (unsigned long)(format_ms % 1000 / 10));
+        addstr(buf);
         refresh();
 
         // POST-FORMAT VALIDATION
@@ -1365,7 +1597,9 @@ void menu_format_card(void) {
     refresh();
 
     // Call f_mkfs - this will take time
-    fr = f_mkfs("", &fmt_opt, work, sizeof(work));
+    format_start = rdcycle64();
+    fr = f_mkfs("", &fmt_opt, work, FORMAT_WORK_SIZE);
+    format_ms = (uint32_t)((rdcycle64() - format_start) / (PERF_CPU_HZ / 1000));
 
     } // End else block for standard formatting
 
@@ -1373,7 +1607,9 @@ void menu_format_card(void) {
     move(7, 8);
     clrtoeol();
     if (fr == FR_OK) {
-        addstr("Complete!           ");
+        snprintf(buf, sizeof(buf), "Complete! (%lu.%02lu s)",
+                 (unsigned long)(format_ms / 1000), (unsigned long)(format_ms % 1000 / 10));
+        addstr(buf);
 
         // Draw full progress bar
         move(6, 2);
@@ -1399,6 +1635,7 @@ void menu_format_card(void) {
         }
         if (fr == FR_OK) {
             g_card_mounted = 1;
+            free_count_restore(&g_fs);
             move(11, 0);
             addstr("✓ Filesystem mounted successfully");
         } else {
@@ -1432,10 +1669,116 @@ format_error:  // Jump target for bootloader partition format errors
 // SPI Speed Configuration
 //==============================================================================
 
+// Find the fastest SCK setting that reads sector 0 back with a good CRC.
+// For each divider (fastest first) every MISO sample delay is tried; the
+// middle of the passing delay window gives the most margin against skew.
+// Returns 0 if no setting passed (or the reference read failed).
+static uint32_t spi_autotune(void) {
+    static uint8_t ref[512] __attribute__((aligned(4)));
+    static uint8_t buf[512] __attribute__((aligned(4)));
+    char line[64];
+    char speed[16];
+    uint32_t best = 0;
+
+    // Reference copy at the known-good default speed
+    sd_set_speed(SPI_CLK_12MHZ);
+    if (sd_read_block_verified(0, ref) != SD_OK) {
+        return 0;
+    }
+
+    for (uint32_t div = 0; div < SPI_TUNE_MAX_DIV && best == 0; div++) {
+        if (spi_sck_hz(SPI_CLK_DIV(div)) > sd_get_max_hz()) {
+            continue;
+        }
+
+        format_spi_speed(speed, sizeof(speed), SPI_CLK_DIV(div));
+        move(7, 0);
+        clrtoeol();
+        snprintf(line, sizeof(line), "Trying %s (divider %lu)...", speed, (unsigned long)div);
+        addstr(line);
+        refresh();
+
+        int first = -1, last = -1;
+        for (uint32_t d = 0; d <= div && d < 16; d++) {
+            int pass = 1;
+
+            sd_set_speed(SPI_CLK_DIV(div) | SPI_SAMPLE_DELAY(d));
+            for (int i = 0; i < SPI_TUNE_READS && pass; i++) {
+                if (sd_read_block_verified(0, buf) != SD_OK || memcmp(buf, ref, sizeof(ref)) != 0) {
+                    pass = 0;
+                }
+            }
+
+            if (pass) {
+                if (first < 0) first = d;
+                last = d;
+            } else if (first >= 0) {
+                break;  // End of the passing window
+            }
+        }
+
+        if (first >= 0) {
+            best = SPI_CLK_DIV(div) | SPI_SAMPLE_DELAY((first + last) / 2);
+        }
+    }
+
+    return best;
+}
+
+static void menu_spi_autotune(void) {
+    char line[64];
+    char speed[16];
+
+    clear();
+    move(0, 0);
+    attron(A_REVERSE);
+    addstr("=== SPI Speed Auto-Tune ===");
+    standend();
+
+    move(2, 0);
+    if (!g_card_detected) {
+        addstr("No card detected - run card detection first.");
+    } else {
+        addstr("Reading sector 0 with CRC16 verification at each setting...");
+        refresh();
+
+        uint32_t best = spi_autotune();
+
+        move(9, 0);
+        if (best) {
+            g_spi_speed = best;
+            format_spi_speed(speed, sizeof(speed), best);
+            snprintf(line, sizeof(line), "✓ Fastest reliable: %s (divider %lu, sample delay %lu)",
+                     speed, (unsigned long)SPI_CTRL_DIV_GET(best),
+                     (unsigned long)SPI_CTRL_DELAY_GET(best));
+            addstr(line);
+            sd_set_speed(g_spi_speed);
+            move(10, 0);
+            addstr(save_spi_speed(1) ? "  Saved on the card (used at power-up and by the SD bootloader)"
+                                     : "  Not saved (no boot partition, or the write failed)");
+        } else {
+            addstr("✗ No setting passed - keeping the previous speed");
+        }
+        sd_set_speed(g_spi_speed);
+    }
+
+    move(LINES - 3, 0);
+    addstr("Press any key to return...");
+    refresh();
+    timeout(-1);
+    while (getch() == ERR);
+}
+
 void menu_spi_speed(void) {
-    int selected = g_spi_speed >> 2;  // Convert speed to index
+    int selected = NUM_SPI_SPEEDS;  // Auto-tune entry unless a preset is active
     int need_redraw = 1;
 
+    for (int i = 0; i < NUM_SPI_SPEEDS; i++) {
+        if (spi_speeds[i] == g_spi_speed) {
+            selected = i;
+        }
+    }
+
     while (1) {
         if (need_redraw) {
             clear();
@@ -1449,7 +1792,7 @@ void menu_spi_speed(void) {
             move(3, 0);
             addstr("(Higher speeds may not work with all cards)");
 
-            for (int i = 0; i < 8; i++) {
+            for (int i = 0; i <= NUM_SPI_SPEEDS; i++) {
                 move(5 + i, 0);
                 if (i == selected) {
                     addstr(" > ");
@@ -1458,7 +1801,13 @@ void menu_spi_speed(void) {
                     addstr("   ");
                 }
                 char buf[64];
-                snprintf(buf, sizeof(buf), "  %s  ", spi_speed_names[i]);
+                char speed[16];
+                if (i < NUM_SPI_SPEEDS) {
+                    format_spi_speed(speed, sizeof(speed), spi_speeds[i]);
+                    snprintf(buf, sizeof(buf), "  %s  ", speed);
+                } else {
+                    snprintf(buf, sizeof(buf), "  Auto-tune (fastest reliable)  ");
+                }
                 addstr(buf);
                 if (i == selected) {
                     standend();
@@ -1472,13 +1821,18 @@ void menu_spi_speed(void) {
         }
 
         timeout(-1);
-        int ch = get_key_with_arrows();  // Use helper to detect arrow keys
+        int ch = getch();  // Arrow keys come decoded (keypad mode)
 
         if (ch == 27) {  // ESC
             break;
         } else if (ch == '\n' || ch == '\r') {
-            g_spi_speed = spi_speeds[selected];
-            sd_set_speed(g_spi_speed);
+            if (selected == NUM_SPI_SPEEDS) {
+                menu_spi_autotune();
+            } else {
+                g_spi_speed = spi_speeds[selected];
+                sd_set_speed(g_spi_speed);
+                save_spi_speed(0);
+            }
             break;
         } else if (ch == KEY_UP || ch == 'k' || ch == 'K') {  // UP (arrow or k/K)
             if (selected > 0) {
@@ -1486,7 +1840,7 @@ void menu_spi_speed(void) {
                 need_redraw = 1;
             }
         } else if (ch == KEY_DOWN || ch == 'j' || ch == 'J') {  // DOWN (arrow or j/J)
-            if (selected < 7) {
+            if (selected < NUM_SPI_SPEEDS) {
                 selected++;
                 need_redraw = 1;
             }
@@ -1510,6 +1864,7 @@ void menu_eject_card(void) {
     refresh();
 
     if (g_card_mounted) {
+        free_count_save(&g_fs);
         f_mount(NULL, "", 0);
         g_card_mounted = 0;
     }
@@ -1518,6 +1873,7 @@ void menu_eject_card(void) {
     addstr("✓ Card ejected safely");
 
     g_card_detected = 0;
+    sd_hotplug_eject();     // Next event: a card inserted after this one is out
 
     move(5, 0);
     addstr("You can now safely remove the SD card.");
@@ -1831,10 +2187,10 @@ void menu_upload_bootloader_compressed(void) {
 
     move(14, 0);
     attron(A_REVERSE);
-    addstr("IMPORTANT: Upload the .bin.gz file, NOT the .bin file!");
+    addstr("IMPORTANT: Upload the .bin.gz or .bin.lz4 file, NOT the .bin file!");
     standend();
     move(15, 0);
-    addstr("The firmware will decompress it automatically.");
+    addstr(".gz is decompressed now; .lz4 is stored and decompressed at boot.");
 
     move(17, 0);
     addstr("Ready to receive compressed bootloader...");
@@ -1865,7 +2221,7 @@ void menu_upload_bootloader_compressed(void) {
     move(2, 0);
     if (fr == FR_OK) {
         attron(A_REVERSE);
-        addstr("✓✓✓ SUCCESS! Compressed bootloader decompressed and installed.");
+        addstr("✓✓✓ SUCCESS! Compressed bootloader installed.");
         standend();
 
         move(4, 0);
@@ -1873,7 +2229,7 @@ void menu_upload_bootloader_compressed(void) {
         move(5, 0);
         addstr("Compressed CRC32 verification: PASSED");
         move(6, 0);
-        addstr("Decompression: SUCCESSFUL");
+        addstr("Read-back verification: PASSED");
     } else {
         attron(A_REVERSE);
         addstr("✗✗✗ FAILED! Compressed bootloader upload error.");
@@ -2126,6 +2482,14 @@ void menu_upload_and_execute(void) {
 // Browse and Run Overlays
 //==============================================================================
 
+// Relocatable containers stay resident (overlay_resident.h); flat images
+// go to OVERLAY_EXEC_BASE as before
+static int is_container_name(const char *name) {
+    size_t len = strlen(name);
+
+    return len >= 4 && (strcmp(&name[len - 4], ".OVL") == 0 || strcmp(&name[len - 4], ".ovl") == 0);
+}
+
 void menu_browse_overlays(void) {
     overlay_list_t list;
     FRESULT fr;
@@ -2214,9 +2578,16 @@ void menu_browse_overlays(void) {
                 }
 
                 overlay_info_t *info = &list.overlays[i];
-                snprintf(buf, sizeof(buf), "  %-20s  %6lu bytes  ",
-                         info->filename,
-                         (unsigned long)info->size);
+                int slot = overlay_resident_find(info->filename);
+                if (slot >= 0) {
+                    snprintf(buf, sizeof(buf), "  %-20s  %6lu bytes  resident @ 0x%05lX  ",
+                             info->filename, (unsigned long)info->size,
+                             (unsigned long)overlay_resident_get(slot)->base);
+                } else {
+                    snprintf(buf, sizeof(buf), "  %-20s  %6lu bytes  ",
+                             info->filename,
+                             (unsigned long)info->size);
+                }
                 addstr(buf);
 
                 if (i == selected) {
@@ -2225,13 +2596,13 @@ void menu_browse_overlays(void) {
             }
 
             move(LINES - 3, 0);
-            addstr("UP/DOWN: Navigate | ENTER: Load & Run | ESC: Back");
+            addstr("UP/DOWN: Navigate | ENTER: Load & Run | X: Drop resident | ESC: Back");
             refresh();
             need_redraw = 0;
         }
 
         timeout(-1);
-        int ch = get_key_with_arrows();  // Use helper to detect arrow keys
+        int ch = getch();  // Arrow keys come decoded (keypad mode)
 
         if (ch == 27) {  // ESC
             break;
@@ -2248,15 +2619,27 @@ void menu_browse_overlays(void) {
 
             // Load overlay to execution address
             overlay_info_t loaded_info;
-            fr = overlay_load(info->filename, OVERLAY_EXEC_BASE, &loaded_info);
+            int slot = -1;
+            if (is_container_name(info->filename)) {
+                // Read only if not already resident
+                fr = overlay_resident_load(info->filename, &slot);
+                if (fr == FR_OK) {
+                    fr = overlay_resident_run(slot);
+                }
+            } else {
+                overlay_resident_clear();
+                fr = overlay_load(info->filename, OVERLAY_EXEC_BASE, &loaded_info);
+            }
 
             if (fr != FR_OK) {
                 printf("\r\nError: Failed to load overlay (error %d)\r\n", fr);
                 printf("Press any key to return to menu...\r\n");
                 getch();
             } else {
-                // Execute overlay
-                overlay_execute(loaded_info.entry_point);
+                // Execute overlay (a resident one has run already)
+                if (slot < 0) {
+                    overlay_execute(loaded_info.entry_point);
+                }
 
                 // Overlay returned
                 printf("\r\nPress any key to return to menu...\r\n");
@@ -2267,6 +2650,12 @@ void menu_browse_overlays(void) {
             refresh();
             need_redraw = 1;
 
+        } else if (ch == 'x' || ch == 'X') {  // Drop the selected resident overlay
+            int slot = overlay_resident_find(list.overlays[selected].filename);
+            if (slot >= 0) {
+                overlay_resident_evict(slot);
+                need_redraw = 1;
+            }
         } else if (ch == KEY_UP || ch == 'k' || ch == 'K') {  // UP (arrow or k/K)
             if (selected > 0) {
                 selected--;
@@ -2326,11 +2715,14 @@ void menu_create_test_file(void) {
     refresh();
 
     move(6, 0);
-    addstr("Creating file...");
+    addstr("Preallocating contiguous file...");
     refresh();
 
-    FIL file;
-    FRESULT fr = f_open(&file, filename, FA_CREATE_ALWAYS | FA_WRITE);
+    // Streamed like a capture: contiguous file, CMD25 per ring half
+    static uint8_t ring[2 * 4096] __attribute__((aligned(4)));
+    uint32_t total_bytes = size_kb * 1024;
+    log_writer_t lw;
+    FRESULT fr = log_writer_open(&lw, filename, total_bytes, ring, sizeof(ring));
     if (fr != FR_OK) {
         move(7, 0);
         snprintf(buf, sizeof(buf), "Error: Cannot create file (FRESULT=%d)", fr);
@@ -2345,7 +2737,6 @@ void menu_create_test_file(void) {
 
     // Write test pattern
     uint8_t buffer[512];
-    uint32_t total_bytes = size_kb * 1024;
     uint32_t written = 0;
 
     move(7, 0);
@@ -2360,10 +2751,10 @@ void menu_create_test_file(void) {
             buffer[i] = (written + i) & 0xFF;
         }
 
-        UINT bw;
-        fr = f_write(&file, buffer, 512, &bw);
-        if (fr != FR_OK || bw != 512) {
-            f_close(&file);
+        uint32_t bw = log_writer_put(&lw, buffer, 512);
+        fr = log_writer_poll(&lw);
+        if (fr != FR_OK) {
+            log_writer_close(&lw);
             move(9, 0);
             snprintf(buf, sizeof(buf), "Error: Write failed (FRESULT=%d)", fr);
             addstr(buf);
@@ -2393,7 +2784,18 @@ void menu_create_test_file(void) {
         }
     }
 
-    f_close(&file);
+    fr = log_writer_close(&lw);
+    if (fr != FR_OK) {
+        move(9, 0);
+        snprintf(buf, sizeof(buf), "Error: Close failed (FRESULT=%d)", fr);
+        addstr(buf);
+        move(LINES - 3, 0);
+        addstr("Press any key to return to menu...");
+        refresh();
+        timeout(-1);
+        while (getch() == ERR);
+        return;
+    }
 
     move(9, 0);
     attron(A_REVERSE);
@@ -2418,6 +2820,208 @@ void menu_create_test_file(void) {
 // Read/Write Benchmark
 //==============================================================================
 
+// Benchmark transfer size per f_write/f_read. FatFS passes whole sectors of a
+// multi-sector request straight to disk_write/disk_read, so 8KB chunks use
+// 16-sector CMD25/CMD18 streams instead of one command per sector.
+#define BENCH_CHUNK_SIZE    8192
+
+// Card-level 4K test: raw CMD18/CMD25 into the sectors of a contiguous
+// scratch file, so the FatFS path and the sector cache are out of the way
+#define IOPS_FILE           "IOPS.TMP"
+#define IOPS_AREA_SECTORS   2048        // 1 MB test area
+#define IOPS_IO_SECTORS     8           // 4 KB per operation
+#define IOPS_MAX_OPS        64
+#define IOPS_MIN_OPS        4
+#define IOPS_TIME_US        500000      // Per test, once IOPS_MIN_OPS are done
+
+typedef struct {
+    uint32_t ops;
+    uint32_t errors;
+    uint32_t total_us;
+    uint32_t max_us;
+} iops_result_t;
+
+// Sequential or random 4K reads or writes within the test area
+static void iops_run(uint32_t base, int write, int random, uint8_t *buf, iops_result_t *r) {
+    uint32_t seed = 0x2545F491;
+    uint32_t offset = 0;
+
+    memset(r, 0, sizeof(*r));
+
+    while (r->ops < IOPS_MAX_OPS && (r->ops < IOPS_MIN_OPS || r->total_us < IOPS_TIME_US)) {
+        uint32_t t0, us;
+        uint8_t res;
+
+        if (random) {
+            seed = seed * 1103515245 + 12345;
+            offset = ((seed >> 8) % (IOPS_AREA_SECTORS / IOPS_IO_SECTORS)) * IOPS_IO_SECTORS;
+        }
+
+        t0 = rdcycle();
+        res = write ? sd_write_blocks(base + offset, buf, IOPS_IO_SECTORS)
+                    : sd_read_blocks(base + offset, buf, IOPS_IO_SECTORS);
+        us = perf_cycles_to_us(rdcycle() - t0);
+
+        if (res != SD_OK) {
+            r->errors++;
+        }
+        r->ops++;
+        r->total_us += us;
+        if (us > r->max_us) {
+            r->max_us = us;
+        }
+
+        if (!random) {
+            offset = (offset + IOPS_IO_SECTORS) % IOPS_AREA_SECTORS;
+        }
+    }
+}
+
+// "IOPS avg/max" (latency in microseconds), 16 columns
+static void iops_format(char *buf, size_t len, const iops_result_t *r) {
+    if (r->ops == 0) {
+        snprintf(buf, len, "%-16s", "  -");
+    } else if (r->errors) {
+        snprintf(buf, len, "%-16s", "  errors");
+    } else {
+        uint32_t avg = r->total_us / r->ops;
+        snprintf(buf, len, "%3lu %5lu/%-6lu",
+                 (unsigned long)(r->total_us ? (uint64_t)r->ops * 1000000 / r->total_us : 0),
+                 (unsigned long)avg, (unsigned long)r->max_us);
+    }
+}
+
+// Second benchmark page: 4K IOPS and latency at each SPI clock
+static void menu_benchmark_iops(uint8_t *buf) {
+    FIL file;
+    FRESULT fr;
+    char line[96];
+    char speed[16];
+    char cell[4][20];
+    uint32_t base;
+
+    clear();
+    move(0, 0);
+    attron(A_REVERSE);
+    addstr("=== SD Card Benchmark: 4K IOPS ===");
+    standend();
+    move(2, 0);
+    addstr("Raw 4 KB CMD18/CMD25 in a 1 MB contiguous scratch file, per SPI clock.");
+    move(3, 0);
+    addstr("Each cell: IOPS, then average/maximum latency in us. '-': writes skipped");
+    move(4, 0);
+    addstr("after read errors at that clock.");
+    refresh();
+
+    // Contiguous scratch area: sector N of the file is base + N
+    fr = f_open(&file, IOPS_FILE, FA_CREATE_ALWAYS | FA_WRITE);
+    if (fr == FR_OK) {
+        fr = f_expand(&file, (FSIZE_t)IOPS_AREA_SECTORS * 512, 1);
+        if (fr != FR_OK) {
+            f_close(&file);
+            f_unlink(IOPS_FILE);
+        }
+    }
+    if (fr != FR_OK) {
+        move(5, 0);
+        snprintf(line, sizeof(line), "Error: Cannot allocate %s (FRESULT=%d)", IOPS_FILE, fr);
+        addstr(line);
+        return;
+    }
+    base = file.obj.fs->database + (uint32_t)file.obj.fs->csize * (file.obj.sclust - 2);
+
+    // Raw writes below: nothing of the area may stay in the sector cache
+    disk_cache_flush();
+    disk_cache_invalidate();
+
+    move(5, 0);
+    snprintf(line, sizeof(line), "%-9s %-16s %-16s %-16s %-16s",
+             "SPI clock", "Seq read", "Seq write", "Rnd read", "Rnd write");
+    addstr(line);
+    refresh();
+
+    for (int i = 0; i < NUM_SPI_SPEEDS; i++) {
+        iops_result_t res[4];
+
+        format_spi_speed(speed, sizeof(speed), spi_speeds[i]);
+        move(6 + i, 0);
+        snprintf(line, sizeof(line), "%-9s running...", speed);
+        addstr(line);
+        clrtoeol();
+        refresh();
+
+        memset(res, 0, sizeof(res));
+        if (spi_sck_hz(spi_speeds[i]) <= sd_get_max_hz()) {
+            sd_set_speed(spi_speeds[i]);
+            iops_run(base, 0, 0, buf, &res[0]);
+            iops_run(base, 0, 1, buf, &res[2]);
+
+            // Writes only where reads are clean: a garbled command at a
+            // marginal clock could land outside the scratch area
+            if (res[0].errors == 0 && res[2].errors == 0) {
+                iops_run(base, 1, 0, buf, &res[1]);
+                iops_run(base, 1, 1, buf, &res[3]);
+            }
+        }
+
+        for (int t = 0; t < 4; t++) {
+            iops_format(cell[t], sizeof(cell[t]), &res[t]);
+        }
+        move(6 + i, 0);
+        if (spi_sck_hz(spi_speeds[i]) > sd_get_max_hz()) {
+            snprintf(line, sizeof(line), "%-9s skipped (above the card's %lu MHz limit)", speed,
+                     (unsigned long)(sd_get_max_hz() / 1000000));
+        } else {
+            snprintf(line, sizeof(line), "%-9s %s %s %s %s", speed, cell[0], cell[1], cell[2], cell[3]);
+        }
+        addstr(line);
+        clrtoeol();
+        refresh();
+    }
+
+    sd_set_speed(g_spi_speed);
+
+    f_close(&file);
+    f_unlink(IOPS_FILE);    // TRIM: the test area is erased again
+
+    format_spi_speed(speed, sizeof(speed), g_spi_speed);
+    move(15, 0);
+    snprintf(line, sizeof(line), "SPI clock restored to %s. Card erase (TRIM): %s", speed,
+             sd_can_erase() ? "supported" : "not supported");
+    addstr(line);
+}
+
+#ifdef TRACE_ENABLE
+// trace_dump() sink: the open TRACE.BIN
+static int trace_write_file(const void *buf, uint32_t len, void *ctx) {
+    UINT bw;
+
+    return f_write((FIL *)ctx, buf, len, &bw) != FR_OK || bw != len;
+}
+
+// The benchmark's events, for tools/trace2json
+static void trace_save_sd(void) {
+    FIL file;
+    char buf[64];
+    int n = -1;
+
+    if (f_open(&file, "TRACE.BIN", FA_WRITE | FA_CREATE_ALWAYS) == FR_OK) {
+        n = trace_dump(trace_write_file, &file);
+        if (f_close(&file) != FR_OK) {
+            n = -1;
+        }
+    }
+
+    move(27, 0);
+    if (n >= 0) {
+        snprintf(buf, sizeof(buf), "Trace: %d events saved to TRACE.BIN", n);
+    } else {
+        snprintf(buf, sizeof(buf), "Trace: could not write TRACE.BIN");
+    }
+    addstr(buf);
+}
+#endif
+
 void menu_benchmark(void) {
     // EXACT pattern from help.c
     flushinp();
@@ -2464,9 +3068,12 @@ void menu_benchmark(void) {
     addstr("This will create a temporary 1 MB test file to measure read/write speed.");
     refresh();
 
+    // Cache counters cover this run only
+    disk_cache_reset_stats();
+
     const char *test_filename = "BENCH.TMP";
     const uint32_t test_size = 1024 * 1024;  // 1 MB
-    const uint32_t block_size = 512;
+    const uint32_t block_size = BENCH_CHUNK_SIZE;  // Multi-sector f_read/f_write → CMD18/CMD25
     const uint32_t num_blocks = test_size / block_size;
 
     // Write benchmark
@@ -2493,8 +3100,8 @@ void menu_benchmark(void) {
         return;
     }
 
-    uint8_t buffer[512];
-    for (int i = 0; i < 512; i++) {
+    static uint8_t buffer[BENCH_CHUNK_SIZE] __attribute__((aligned(4)));
+    for (uint32_t i = 0; i < block_size; i++) {
         buffer[i] = i & 0xFF;
     }
 
@@ -2508,6 +3115,9 @@ void menu_benchmark(void) {
 
     uint32_t write_errors = 0;
     uint8_t last_tick_flag = 0;
+    perf_sample_t perf_start, perf_end;
+
+    perf_sample(&perf_start);
 
     for (uint32_t i = 0; i < num_blocks; i++) {
         UINT bw;
@@ -2540,7 +3150,7 @@ void menu_benchmark(void) {
 
             move(9, 0);
             char blk[64];
-            snprintf(blk, sizeof(blk), "Blocks written: %lu / %lu",
+            snprintf(blk, sizeof(blk), "Chunks written: %lu / %lu",
                      (unsigned long)(i + 1), (unsigned long)num_blocks);
             addstr(blk);
             clrtoeol();
@@ -2555,8 +3165,8 @@ void menu_benchmark(void) {
             refresh();
         }
 
-        // Also update progress bar every 16 blocks (every ~8KB) for smoother updates
-        if ((i & 0x0F) == 0 || i == num_blocks - 1) {
+        // Also update progress bar every 2 chunks (every ~16KB) for smoother updates
+        if ((i & 0x01) == 0 || i == num_blocks - 1) {
             int percent = (i * 100) / num_blocks;
             int bars = (i * 48) / num_blocks;  // 48 character wide bar
 
@@ -2575,7 +3185,7 @@ void menu_benchmark(void) {
             // Show current block count
             move(9, 0);
             char blk[64];
-            snprintf(blk, sizeof(blk), "Blocks written: %lu / %lu",
+            snprintf(blk, sizeof(blk), "Chunks written: %lu / %lu",
                      (unsigned long)(i + 1), (unsigned long)num_blocks);
             addstr(blk);
             clrtoeol();
@@ -2593,6 +3203,7 @@ void menu_benchmark(void) {
     }
 
     f_close(&file);
+    perf_sample(&perf_end);
 
     move(8, 0);
     if (write_errors == 0) {
@@ -2608,9 +3219,10 @@ void menu_benchmark(void) {
         snprintf(buf, sizeof(buf), "Final Speed: %s", final_speed);
         addstr(buf);
         move(13, 0);
-        snprintf(buf, sizeof(buf), "Total: %lu bytes in %lu blocks",
+        snprintf(buf, sizeof(buf), "Total: %lu bytes in %lu x 8KB chunks",
                  (unsigned long)test_size, (unsigned long)num_blocks);
         addstr(buf);
+        show_bench_perf(14, &perf_start, &perf_end);
     } else {
         char buf[64];
         snprintf(buf, sizeof(buf), "✗ Write errors: %lu", (unsigned long)write_errors);
@@ -2654,6 +3266,7 @@ void menu_benchmark(void) {
     last_tick_flag = timer_tick_flag;  // Reset flag tracker
 
     uint32_t read_errors = 0;
+    perf_sample(&perf_start);
     for (uint32_t i = 0; i < num_blocks; i++) {
         UINT br;
         fr = f_read(&file, buffer, block_size, &br);
@@ -2685,7 +3298,7 @@ void menu_benchmark(void) {
 
             move(19, 0);
             char blk[64];
-            snprintf(blk, sizeof(blk), "Blocks read: %lu / %lu",
+            snprintf(blk, sizeof(blk), "Chunks read: %lu / %lu",
                      (unsigned long)(i + 1), (unsigned long)num_blocks);
             addstr(blk);
             clrtoeol();
@@ -2700,8 +3313,8 @@ void menu_benchmark(void) {
             refresh();
         }
 
-        // Also update progress bar every 16 blocks (every ~8KB) for smoother updates
-        if ((i & 0x0F) == 0 || i == num_blocks - 1) {
+        // Also update progress bar every 2 chunks (every ~16KB) for smoother updates
+        if ((i & 0x01) == 0 || i == num_blocks - 1) {
             int percent = (i * 100) / num_blocks;
             int bars = (i * 48) / num_blocks;  // 48 character wide bar
 
@@ -2720,7 +3333,7 @@ void menu_benchmark(void) {
             // Show current block count
             move(19, 0);
             char blk[64];
-            snprintf(blk, sizeof(blk), "Blocks read: %lu / %lu",
+            snprintf(blk, sizeof(blk), "Chunks read: %lu / %lu",
                      (unsigned long)(i + 1), (unsigned long)num_blocks);
             addstr(blk);
             clrtoeol();
@@ -2738,6 +3351,7 @@ void menu_benchmark(void) {
     }
 
     f_close(&file);
+    perf_sample(&perf_end);
 
     move(18, 0);
     if (read_errors == 0) {
@@ -2753,9 +3367,10 @@ void menu_benchmark(void) {
         snprintf(buf, sizeof(buf), "Final Speed: %s", final_speed);
         addstr(buf);
         move(23, 0);
-        snprintf(buf, sizeof(buf), "Total: %lu bytes in %lu blocks",
+        snprintf(buf, sizeof(buf), "Total: %lu bytes in %lu x 8KB chunks",
                  (unsigned long)test_size, (unsigned long)num_blocks);
         addstr(buf);
+        show_bench_perf(24, &perf_start, &perf_end);
     } else {
         char buf[64];
         snprintf(buf, sizeof(buf), "✗ Read errors: %lu", (unsigned long)read_errors);
@@ -2781,6 +3396,23 @@ void menu_benchmark(void) {
         addstr("Note: Could not delete test file (manual cleanup may be needed)");
     }
 
+#ifdef TRACE_ENABLE
+    trace_save_sd();
+#endif
+    show_cache_stats(28);
+
+    move(LINES - 3, 0);
+    addstr("Press I for the card-level 4K IOPS test, any other key to return...");
+    refresh();
+    timeout(-1);
+    int ch;
+    while ((ch = getch()) == ERR);
+    if (ch != 'i' && ch != 'I') {
+        return;
+    }
+
+    menu_benchmark_iops(buffer);
+
     move(LINES - 3, 0);
     addstr("Press any key to return...");
     refresh();
@@ -2788,6 +3420,412 @@ void menu_benchmark(void) {
     while (getch() == ERR);
 }
 
+//==============================================================================
+// Program SPI Flash (Kconfig FLASH_XIP)
+//==============================================================================
+
+#define FLASH_IMAGE_FILE "FLASH.BIN"
+
+// Press any key, back to the menu
+static void flash_wait_key(void) {
+    move(LINES - 3, 0);
+    addstr("Press any key to return to menu...");
+    refresh();
+    timeout(-1);
+    while (getch() == ERR);
+}
+
+// /FLASH.BIN to the configuration flash from SPI_FLASH_DATA_OFFSET up (the
+// .xip section of a FLASH_XIP build, 'make <target>.xip.bin', or any data),
+// then read back through the XIP window. The bitstream below is left alone.
+void menu_program_flash(void) {
+    static uint8_t buffer[SPI_FLASH_SECTOR_SIZE] __attribute__((aligned(4)));
+    char buf[80];
+    FIL file;
+    FRESULT fr;
+    UINT br;
+
+    clear();
+    move(0, 0);
+    attron(A_REVERSE);
+    addstr("=== Program SPI Flash ===");
+    standend();
+    move(2, 0);
+
+    if (!spi_flash_present()) {
+        addstr("Error: no SPI flash controller in this bitstream (Kconfig FLASH_XIP)");
+        flash_wait_key();
+        return;
+    }
+    if (!g_card_mounted) {
+        addstr("Error: SD card not mounted!");
+        move(4, 0);
+        addstr("Please detect and mount card first (Menu option 1).");
+        flash_wait_key();
+        return;
+    }
+
+    spi_flash_begin();
+    spi_flash_cmd(SPI_FLASH_CMD_WAKE);
+    uint32_t id = spi_flash_jedec_id();
+    spi_flash_end();
+
+    // Capacity byte is log2 of the size on every common part
+    uint32_t cap = id & 0xFF;
+    uint32_t flash_size = (cap >= 0x11 && cap <= 0x18) ? (1u << cap) : 0;
+    snprintf(buf, sizeof(buf), "JEDEC ID: %06lX (%lu KB), %s reads",
+             (unsigned long)id, (unsigned long)(flash_size / 1024),
+             (SPI_FLASH_CTRL & SPI_FLASH_DUAL) ? "dual-output" : "fast");
+    addstr(buf);
+    if (flash_size <= SPI_FLASH_DATA_OFFSET) {
+        move(4, 0);
+        addstr("Error: no flash answering, or too small for a data area");
+        flash_wait_key();
+        return;
+    }
+
+    fr = f_open(&file, FLASH_IMAGE_FILE, FA_READ);
+    if (fr != FR_OK) {
+        move(4, 0);
+        snprintf(buf, sizeof(buf), "Error: cannot open /%s (%s)", FLASH_IMAGE_FILE,
+                 fresult_to_string(fr));
+        addstr(buf);
+        flash_wait_key();
+        return;
+    }
+
+    uint32_t size = f_size(&file);
+    uint32_t room = flash_size - SPI_FLASH_DATA_OFFSET;
+    move(3, 0);
+    snprintf(buf, sizeof(buf), "/%s: %lu bytes -> flash 0x%06lX (read at 0x%08lX)",
+             FLASH_IMAGE_FILE, (unsigned long)size,
+             (unsigned long)SPI_FLASH_DATA_OFFSET,
+             (unsigned long)(SPI_FLASH_XIP_BASE + SPI_FLASH_DATA_OFFSET));
+    addstr(buf);
+    if (size == 0 || size > room) {
+        move(5, 0);
+        snprintf(buf, sizeof(buf), "Error: the data area holds 1 to %lu bytes",
+                 (unsigned long)room);
+        addstr(buf);
+        f_close(&file);
+        flash_wait_key();
+        return;
+    }
+
+    move(5, 0);
+    addstr("Press Y to erase and program, any other key to cancel");
+    refresh();
+    timeout(-1);
+    int ch;
+    while ((ch = getch()) == ERR);
+    if (ch != 'y' && ch != 'Y') {
+        f_close(&file);
+        return;
+    }
+
+    // One sector at a time: erase, program, verify through the window
+    uint32_t done = 0;
+    uint32_t bad = 0;
+    while (done < size && fr == FR_OK) {
+        uint32_t n = size - done;
+        if (n > SPI_FLASH_SECTOR_SIZE) n = SPI_FLASH_SECTOR_SIZE;
+        fr = f_read(&file, buffer, n, &br);
+        if (fr != FR_OK || br != n) {
+            if (fr == FR_OK) fr = FR_DISK_ERR;
+            break;
+        }
+
+        uint32_t offset = SPI_FLASH_DATA_OFFSET + done;
+        spi_flash_begin();
+        spi_flash_erase_sector(offset);
+        spi_flash_program(offset, buffer, n);
+        spi_flash_end();
+
+        const volatile uint8_t *xip = spi_flash_xip_addr(offset);
+        for (uint32_t i = 0; i < n; i++) {
+            if (xip[i] != buffer[i]) bad++;
+        }
+
+        done += n;
+        move(7, 0);
+        snprintf(buf, sizeof(buf), "Programmed %lu / %lu bytes, %lu verify errors",
+                 (unsigned long)done, (unsigned long)size, (unsigned long)bad);
+        addstr(buf);
+        clrtoeol();
+        refresh();
+    }
+    f_close(&file);
+
+    move(9, 0);
+    if (fr != FR_OK) {
+        snprintf(buf, sizeof(buf), "Error: reading /%s failed (%s)", FLASH_IMAGE_FILE,
+                 fresult_to_string(fr));
+        addstr(buf);
+    } else if (bad != 0) {
+        addstr("Error: read back through the XIP window does not match");
+    } else {
+        addstr("✓ Flash programmed and verified");
+    }
+    flash_wait_key();
+}
+
+//==============================================================================
+// SPI1 Stream Capture (Kconfig SPI1_STREAM)
+//==============================================================================
+
+#define STREAM_FILE         "ADC.BIN"
+#define STREAM_FILE_SIZE    (4u * 1024 * 1024)
+#define STREAM_TIMER        2           // Timer channel (free in the manager)
+#define STREAM_RATE_HZ      10000
+#define STREAM_FRAME        2           // Bytes per sample (12-bit ADCs: MCP3201, ADC121S)
+#define STREAM_RING_WORDS   1024        // Two 2 KB halves, 51 ms each at 10 kHz
+
+// An SPI ADC on SPI1 sampled at STREAM_RATE_HZ into /ADC.BIN. The timer
+// channel starts every frame and the DMA engine fills the ring, so the
+// CPU only moves a ring half into the log writer every 51 ms. One word
+// per sample, the frame bytes in wire order from bits [7:0].
+void menu_spi_stream(void) {
+    static uint32_t ring[STREAM_RING_WORDS] __attribute__((aligned(4)));
+    static uint8_t lw_ring[2 * 8192] __attribute__((aligned(4)));
+    const uint32_t half_words = STREAM_RING_WORDS / 2;
+    char buf[80];
+    log_writer_t lw;
+    FRESULT fr;
+
+    clear();
+    move(0, 0);
+    attron(A_REVERSE);
+    addstr("=== SPI1 Stream Capture ===");
+    standend();
+    move(2, 0);
+
+    if (!spi_port_stream_present(SPI1_DMA)) {
+        addstr("Error: no SPI1 stream mode in this bitstream (Kconfig SPI1_STREAM)");
+        flash_wait_key();
+        return;
+    }
+    if (!g_card_mounted) {
+        addstr("Error: SD card not mounted!");
+        move(4, 0);
+        addstr("Please detect and mount card first (Menu option 1).");
+        flash_wait_key();
+        return;
+    }
+
+    snprintf(buf, sizeof(buf), "%u Hz, %u-byte frames on SPI1 (timer channel %u) -> /%s",
+             STREAM_RATE_HZ, STREAM_FRAME, STREAM_TIMER, STREAM_FILE);
+    addstr(buf);
+    refresh();
+
+    fr = log_writer_open(&lw, STREAM_FILE, STREAM_FILE_SIZE, lw_ring, sizeof(lw_ring));
+    if (fr != FR_OK) {
+        move(4, 0);
+        snprintf(buf, sizeof(buf), "Error: cannot create /%s (%s)", STREAM_FILE,
+                 fresult_to_string(fr));
+        addstr(buf);
+        flash_wait_key();
+        return;
+    }
+
+    // 1.56 MHz SCK, mode 0; the engine drives CS for each frame
+    SPI_PORT_CTRL(SPI1_REGS) = SPI_PORT_CLK_DIV(15);
+    TIMER_CH_CR(STREAM_TIMER) = 0;
+    TIMER_CH_SR(STREAM_TIMER) = TIMER_CH_UIF | TIMER_CH_CCIF;
+    TIMER_CH_PSC(STREAM_TIMER) = TIMER_PSC_1MHZ;
+    TIMER_CH_ARR(STREAM_TIMER) = 1000000 / STREAM_RATE_HZ - 1;
+    // Write back and drop the ring's lines (zeroed BSS, maybe dirty) so
+    // neither an eviction nor the per-half invalidate clobbers samples
+    dcache_invalidate_range((uint32_t)ring, sizeof(ring));
+    spi_port_stream_start(SPI1_FIFO, SPI1_DMA, ring, sizeof(ring), STREAM_FRAME, STREAM_TIMER, 0);
+    TIMER_CH_CR(STREAM_TIMER) = TIMER_CH_ENABLE;
+
+    move(LINES - 3, 0);
+    addstr("Capturing - press any key to stop");
+    refresh();
+    timeout(0);
+
+    uint32_t t0 = timebase_ms(), last = t0;
+    uint32_t overruns = 0;
+    unsigned next = 0;                  // Ring half the engine is filling
+    while (fr == FR_OK && lw.accepted < STREAM_FILE_SIZE) {
+        uint32_t f = spi_port_stream_take(SPI1_DMA);
+        if (f & SPI_PORT_ST_OVERRUN) overruns++;
+        for (unsigned i = 0; i < 2; i++) {
+            if (!(f & (next ? SPI_PORT_ST_FULL : SPI_PORT_ST_HALF))) continue;
+            uint32_t *half = ring + next * half_words;
+            dcache_invalidate_range((uint32_t)half, half_words * 4);
+            log_writer_put(&lw, half, half_words * 4);
+            next ^= 1;
+        }
+        fr = log_writer_poll(&lw);
+
+        uint32_t now = timebase_ms();
+        if (now - last >= 250) {
+            last = now;
+            uint32_t samples = lw.accepted / 4;
+            move(4, 0);
+            snprintf(buf, sizeof(buf), "Samples: %lu (%lu/s), %lu KB on the card",
+                     (unsigned long)samples,
+                     (unsigned long)(now > t0 ? samples * 1000 / (now - t0) : 0),
+                     (unsigned long)(lw.committed / 1024));
+            addstr(buf);
+            clrtoeol();
+            move(5, 0);
+            snprintf(buf, sizeof(buf), "Missed triggers: %lu, ring overruns: %lu, dropped bytes: %lu",
+                     (unsigned long)SPI_PORT_ST_MISSED(SPI_PORT_DMA_STREAM(SPI1_DMA)),
+                     (unsigned long)overruns, (unsigned long)lw.dropped);
+            addstr(buf);
+            clrtoeol();
+            refresh();
+            if (getch() != ERR) break;
+        }
+    }
+
+    // Stop, then keep the samples of the half in progress
+    TIMER_CH_CR(STREAM_TIMER) = 0;
+    spi_port_stream_stop(SPI1_DMA);
+    uint32_t f = spi_port_stream_take(SPI1_DMA);
+    if (f & (next ? SPI_PORT_ST_FULL : SPI_PORT_ST_HALF)) {
+        uint32_t *half = ring + next * half_words;
+        dcache_invalidate_range((uint32_t)half, half_words * 4);
+        log_writer_put(&lw, half, half_words * 4);
+        next ^= 1;
+    }
+    uint32_t pos = (SPI_PORT_DMA_ADDR(SPI1_DMA) - (uint32_t)ring) / 4;
+    if (pos > next * half_words) {
+        uint32_t *part = ring + next * half_words;
+        uint32_t n = (pos - next * half_words) * 4;
+        dcache_invalidate_range((uint32_t)part, n);
+        log_writer_put(&lw, part, n);
+    }
+    FRESULT cfr = log_writer_close(&lw);
+    if (fr == FR_OK) fr = cfr;
+
+    move(7, 0);
+    if (fr != FR_OK) {
+        snprintf(buf, sizeof(buf), "Error: writing /%s failed (%s)", STREAM_FILE,
+                 fresult_to_string(fr));
+    } else {
+        snprintf(buf, sizeof(buf), "✓ %lu samples in /%s",
+                 (unsigned long)(lw.accepted / 4), STREAM_FILE);
+    }
+    addstr(buf);
+    timeout(-1);
+    flash_wait_key();
+}
+
+//==============================================================================
+// RAM Disk (Kconfig SD_RAMDISK)
+//==============================================================================
+
+#define RAMDISK_SAVE_DIR "0:/RAMDISK"
+
+// Files on "1:", copied to the card with S, reformatted with F
+void menu_ramdisk(void) {
+    char buf[80];
+    FILINFO fno;
+    FATFS *fs;
+    DWORD fre;
+    DIR dir;
+    int row;
+
+    while (1) {
+        clear();
+        move(0, 0);
+        attron(A_REVERSE);
+        addstr("=== RAM Disk (1:) ===");
+        standend();
+        move(2, 0);
+
+        if (!ramdisk_mounted() && ramdisk_mount(0) != FR_OK) {
+            addstr("Error: no RAM disk (Kconfig SD_RAMDISK), or the heap reaches into it");
+            flash_wait_key();
+            return;
+        }
+
+        if (f_getfree(RAMDISK_DRIVE, &fre, &fs) == FR_OK) {
+            snprintf(buf, sizeof(buf), "%lu KB free of %lu KB (contents kept over resets)",
+                     (unsigned long)(fre * fs->csize / 2),
+                     (unsigned long)((fs->n_fatent - 2) * fs->csize / 2));
+            addstr(buf);
+        }
+
+        row = 4;
+        if (f_opendir(&dir, RAMDISK_DRIVE "/") == FR_OK) {
+            while (row < LINES - 6 && f_readdir(&dir, &fno) == FR_OK && fno.fname[0]) {
+                move(row++, 2);
+                snprintf(buf, sizeof(buf), "%-40.40s %10lu%s", fno.fname,
+                         (unsigned long)fno.fsize, (fno.fattrib & AM_DIR) ? " <DIR>" : "");
+                addstr(buf);
+            }
+            f_closedir(&dir);
+        }
+        if (row == 4) {
+            move(row, 2);
+            addstr("(empty)");
+        }
+
+        move(LINES - 4, 0);
+        addstr("S: save files to " RAMDISK_SAVE_DIR "   F: format   other: back");
+        refresh();
+
+        timeout(-1);
+        int ch;
+        while ((ch = getch()) == ERR);
+
+        if (ch == 's' || ch == 'S') {
+            uint32_t files;
+            uint32_t t0 = rdcycle();
+            FRESULT fr = g_card_mounted ? ramdisk_save(RAMDISK_SAVE_DIR, &files) : FR_NOT_READY;
+
+            move(LINES - 4, 0);
+            clrtoeol();
+            if (fr == FR_OK) {
+                snprintf(buf, sizeof(buf), "✓ %lu files to %s in %lu ms", (unsigned long)files,
+                         RAMDISK_SAVE_DIR, (unsigned long)((rdcycle() - t0) / (uint32_t)(PERF_CPU_HZ / 1000)));
+            } else {
+                snprintf(buf, sizeof(buf), "Error: %s (%s)", g_card_mounted ?
+                         "save failed" : "SD card not mounted", fresult_to_string(fr));
+            }
+            addstr(buf);
+            flash_wait_key();
+        } else if (ch == 'f' || ch == 'F') {
+            ramdisk_mount(1);
+        } else {
+            return;
+        }
+    }
+}
+
+#ifdef PGO_GENERATE
+//==============================================================================
+// Profile Dump (PGO=gen builds, scripts/pgo.sh)
+//==============================================================================
+
+static void pgo_file_write(const char *text, unsigned len, void *arg) {
+    UINT bw;
+    f_write((FIL *)arg, text, len, &bw);
+}
+
+// Counters so far to /PGO.TXT (card mounted) and to the UART
+static void pgo_save(void) {
+    FIL fil;
+
+    clear();
+    move(0, 0);
+    addstr("Profile dump: ");
+    if (g_card_mounted && f_open(&fil, "/PGO.TXT", FA_WRITE | FA_CREATE_ALWAYS) == FR_OK) {
+        pgo_dump(pgo_file_write, &fil);
+        f_close(&fil);
+        addstr("/PGO.TXT, ");
+    }
+    addstr("UART");
+    refresh();
+
+    pgo_dump_uart();
+}
+#endif
+
 //==============================================================================
 // Main Menu
 //==============================================================================
@@ -2812,6 +3850,20 @@ int main(void) {
     // Initialize SPI
     sd_spi_init();
 
+    // A card that is already in is detected now, at its saved SPI speed
+    // (still initialized when the SD bootloader loaded us: no full init)
+    if (card_init() == SD_OK) {
+        g_card_detected = 1;
+        load_card_settings();
+    }
+
+    // RAM disk volume (Kconfig SD_RAMDISK), keeping files staged before
+    // a reset or an overlay run
+    ramdisk_mount(0);
+
+    // Card removal and insertion from here on (polled while idle below)
+    sd_hotplug_start();
+
     while (1) {
         if (need_full_redraw || old_selected != selected_menu) {
             clear();
@@ -2842,6 +3894,9 @@ int main(void) {
                 "Create Test File",
                 "Read/Write Benchmark",
                 "SPI Speed Configuration",
+                "Program SPI Flash (/FLASH.BIN)",
+                "RAM Disk (1:)",
+                "SPI1 Stream Capture (/ADC.BIN)",
                 "Eject Card"
             };
 
@@ -2881,20 +3936,33 @@ int main(void) {
         draw_status_bar();
         refresh();
 
-        // Handle input (EXACT pattern from spi_test.c)
-        timeout(-1);
+        // Handle input (EXACT pattern from spi_test.c), polling the card
+        // slot while no key comes
+        timeout(sd_hotplug_busy() ? 1 : SD_HOTPLUG_POLL_MS);
         int ch = getch();
+        if (ch == ERR) {
+            card_hotplug();
+            continue;
+        }
 
         if (ch == 'q' || ch == 'Q') {
+#ifdef PGO_GENERATE
+            pgo_save();
+#endif
             break;
+#ifdef PGO_GENERATE
+        } else if (ch == 'p' || ch == 'P') {  // PROFILE DUMP
+            pgo_save();
+            need_full_redraw = 1;
+#endif
         } else if (ch == 'h' || ch == 'H') {  // HELP
             show_help();
             need_full_redraw = 1;
-        } else if (ch == 65 || ch == 'k') {  // UP
+        } else if (ch == KEY_UP || ch == 'k') {  // UP
             if (selected_menu > 0) {
                 selected_menu--;
             }
-        } else if (ch == 66 || ch == 'j') {  // DOWN
+        } else if (ch == KEY_DOWN || ch == 'j') {  // DOWN
             if (selected_menu < NUM_MENU_OPTIONS - 1) {
                 selected_menu++;
             }
@@ -2940,6 +4008,15 @@ int main(void) {
                 case MENU_SPI_SPEED:
                     menu_spi_speed();
                     break;
+                case MENU_PROGRAM_FLASH:
+                    menu_program_flash();
+                    break;
+                case MENU_RAMDISK:
+                    menu_ramdisk();
+                    break;
+                case MENU_SPI_STREAM:
+                    menu_spi_stream();
+                    break;
                 case MENU_EJECT_CARD:
                     menu_eject_card();
                     break;
@@ -2950,6 +4027,7 @@ int main(void) {
 
     // Cleanup
     if (g_card_mounted) {
+        free_count_save(&g_fs);
         f_mount(NULL, "", 0);
     }
 
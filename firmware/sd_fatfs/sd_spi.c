@@ -4,14 +4,49 @@
 
 #include "sd_spi.h"
 #include "io.h"
+#include "../../lib/hrtimer/hrtimer.h"
 #include <string.h>
 
+#ifdef USE_FREERTOS
+#include <FreeRTOS.h>
+#include <task.h>
+#endif
+
+//==============================================================================
+// Timeouts
+//==============================================================================
+// Waits end on a deadline (lib/hrtimer), not on a count of polls, so the
+// limits hold at any SPI clock or transfer path. Spec limits (SD Physical Layer
+// 4.6.2): read access 100 ms, write busy 250 ms (SDXC: 500 ms), ACMD41
+// initialization 1 s. R1 waits stay byte counts: NCR is clocks, not time.
+
+#define SD_READ_TIMEOUT_MS      100     // Data / register token
+#define SD_WRITE_TIMEOUT_MS     500     // Busy after a write, CMD12, stop token
+#define SD_INIT_TIMEOUT_MS      1000    // ACMD41 until the card leaves idle
+#define SD_WAIT_SPIN_MS         1       // Polled flat out before yielding
+
 //==============================================================================
 // Static Variables
 //==============================================================================
 
 static sd_card_type_t s_card_type = CARD_TYPE_UNKNOWN;
 static uint32_t s_sector_count = 0;
+static uint8_t s_crc_mode = 0;      // CMD59 CRC checking on (needs SPI hardware CRC)
+static uint8_t s_can_erase = 0;     // CSD CCC class 5 (CMD32/CMD33/CMD38)
+static uint32_t s_spi_speed = SPI_CLK_390KHZ;   // Last speed set after init
+static uint8_t s_warm = 0;          // Last init took over an initialized card
+static uint8_t s_high_speed = 0;    // CMD6 switched the card to high speed
+static uint32_t s_max_hz = 25000000;    // SCK limit from TRAN_SPEED
+static uint8_t s_cid[16];           // Raw CID of the initialized card
+
+// The card stopped answering: sd_get_card_type() goes back to unknown, so
+// the data calls (and diskio) fail at once instead of waiting out every
+// token timeout until a re-init
+static uint8_t sd_card_gone(uint8_t error) {
+    s_card_type = CARD_TYPE_UNKNOWN;
+    s_sector_count = 0;
+    return error;
+}
 
 //==============================================================================
 // SD Card Command Functions
@@ -24,6 +59,15 @@ static uint8_t sd_send_cmd(uint8_t cmd, uint32_t arg) {
     // Special CRC for CMD0 and CMD8
     if (cmd == CMD0) crc = 0x95;
     if (cmd == CMD8) crc = 0x87;
+    // ...and for the warm probe, sent before CRC checking is known to be off
+    if (cmd == CMD12 && arg == 0) crc = 0x61;
+    if (cmd == CMD58) crc = 0xFD;
+    if (cmd == CMD59 && arg == 0) crc = 0x91;
+
+    // In CRC mode every command carries the CRC7 computed while it shifts out
+    if (s_crc_mode) {
+        spi_crc_start();
+    }
 
     // Send command packet
     spi_transfer(0x40 | cmd);
@@ -31,8 +75,16 @@ static uint8_t sd_send_cmd(uint8_t cmd, uint32_t arg) {
     spi_transfer((arg >> 16) & 0xFF);
     spi_transfer((arg >> 8) & 0xFF);
     spi_transfer(arg & 0xFF);
+    if (s_crc_mode) {
+        crc = spi_crc7_byte();
+    }
     spi_transfer(crc);
 
+    // CMD12 is followed by a stuff byte before R1
+    if (cmd == CMD12) {
+        spi_transfer(0xFF);
+    }
+
     // Wait for response (R1), max 10 attempts
     for (int i = 0; i < 10; i++) {
         r1 = spi_transfer(0xFF);
@@ -49,6 +101,128 @@ static uint8_t sd_send_acmd(uint8_t cmd, uint32_t arg) {
     return sd_send_cmd(cmd, arg);
 }
 
+static uint8_t sd_wait_ready(void);
+static uint8_t sd_wait_token(void);
+
+// 1 once the deadline of an ms timeout has passed. Waits longer than
+// SD_WAIT_SPIN_MS hand the CPU over between polls under FreeRTOS (a tick
+// each, or a yield to equal priorities without vTaskDelay), so a slow
+// card does not keep other tasks from running.
+static int sd_wait_over(hrt_deadline_t deadline, uint32_t ms) {
+    uint32_t left = hrt_remaining_us(deadline);
+
+    if (left == 0) {
+        return 1;
+    }
+#ifdef USE_FREERTOS
+    if (ms > SD_WAIT_SPIN_MS && left < (ms - SD_WAIT_SPIN_MS) * 1000 &&
+        xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+#if INCLUDE_vTaskDelay
+        vTaskDelay(1);
+#else
+        taskYIELD();
+#endif
+    }
+#else
+    (void)ms;
+#endif
+    return 0;
+}
+
+// CRC7 (x^7 + x^3 + 1), as in a command or in bits [7:1] of a CID / CSD
+static uint8_t sd_crc7(const uint8_t *data, uint32_t len) {
+    uint8_t crc = 0;
+
+    while (len--) {
+        crc ^= *data++;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x12) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc >> 1;
+}
+
+// CMD9 / CMD10 (a 16-byte register) and CMD6 (64-byte status): len bytes
+static uint8_t sd_read_reg_block(uint8_t cmd, uint32_t arg, uint8_t *buffer, uint32_t len) {
+    spi_cs_assert();
+
+    if (sd_send_cmd(cmd, arg) != 0x00) {
+        spi_cs_deassert();
+        return SD_ERROR_READ;
+    }
+
+    // Wait for data token (0xFE)
+    uint8_t result = sd_wait_token();
+    if (result != SD_OK) {
+        spi_cs_deassert();
+        return result;
+    }
+
+    for (uint32_t i = 0; i < len; i++) {
+        buffer[i] = spi_transfer(0xFF);
+    }
+
+    // Read CRC (2 bytes) - ignored, the register has its own CRC7
+    spi_transfer(0xFF);
+    spi_transfer(0xFF);
+
+    spi_cs_deassert();
+
+    return SD_OK;
+}
+
+static uint8_t sd_read_register(uint8_t cmd, uint8_t *buffer) {
+    return sd_read_reg_block(cmd, 0, buffer, 16);
+}
+
+// TRAN_SPEED (CSD bits 103:96): time value x 100 kbit/s .. 100 Mbit/s
+static uint32_t sd_tran_speed_hz(uint8_t tran_speed) {
+    static const uint8_t value_x10[16] = {
+        0, 10, 12, 13, 15, 20, 25, 30, 35, 40, 45, 50, 55, 60, 70, 80
+    };
+    uint32_t hz = 10000;            // Unit 0 (100 kbit/s) over the x10 value
+
+    for (uint8_t unit = tran_speed & 0x07; unit > 0 && unit < 4; unit--) {
+        hz *= 10;
+    }
+    return hz * value_x10[(tran_speed >> 3) & 0x0F];
+}
+
+// CMD6 (SD Physical Layer 4.3.10): ask whether group 1 offers function 1
+// (high speed), then switch to it. In the 64-byte status bits 415:400 are
+// the functions group 1 supports, bits 379:376 the one now selected. The
+// switch takes effect 8 clocks after the status; the CSD then shows the
+// new TRAN_SPEED. Cards before SD 1.10 lack command class 10.
+static void sd_switch_high_speed(void) {
+    uint8_t status[64];
+    sd_csd_t csd;
+    uint32_t hz;
+
+    s_high_speed = 0;
+    s_max_hz = 25000000;
+    if (sd_read_csd(&csd) != SD_OK) {
+        return;
+    }
+    if ((csd.ccc & (1 << 10)) &&
+        sd_read_reg_block(CMD6, 0x00FFFFF1, status, sizeof(status)) == SD_OK &&
+        (status[13] & 0x02) &&
+        sd_read_reg_block(CMD6, 0x80FFFFF1, status, sizeof(status)) == SD_OK &&
+        (status[16] & 0x0F) == 1) {
+        spi_transfer(0xFF);
+        s_high_speed = 1;
+        if (sd_read_csd(&csd) != SD_OK) {
+            return;
+        }
+    }
+
+    // 25 MHz (0x32) or 50 MHz (0x5A) in SPI mode; anything else is not trusted
+    hz = sd_tran_speed_hz(csd.tran_speed);
+    s_max_hz = (hz != 0 && hz <= 50000000) ? hz : 25000000;
+    if (!s_high_speed && s_max_hz > 25000000) {
+        s_max_hz = 25000000;
+    }
+}
+
 //==============================================================================
 // Initialization
 //==============================================================================
@@ -59,13 +233,28 @@ void sd_spi_init(void) {
     spi_cs_deassert();
 }
 
-uint8_t sd_init(void) {
+// Full initialization in three parts so the hot-plug poller can spread the
+// ACMD41 loop over its polls: sd_init_begin() resets the card (CMD0) and
+// asks for its version (CMD8), each sd_init_step() is one ACMD41
+// (SD_ERROR_NOT_READY while the card is still idle), sd_init_end() sets
+// up CRC mode and data speed and reads CSD and CID.
+#define SD_INIT_V1          0       // No CMD8 answer: SD v1 / MMC
+#define SD_INIT_V2          1       // CMD8 echoed: ACMD41 with HCS
+#define SD_INIT_V2_NOVOLT   2       // CMD8 answered, voltage range refused
+
+static uint8_t s_init_kind;
+static hrt_deadline_t s_init_deadline;  // First ACMD41 + SD_INIT_TIMEOUT_MS
+
+static uint8_t sd_init_begin(void) {
     uint8_t r1;
-    int retry;
 
-    // Reset card type
+    // Reset card type (CMD0 also turns card CRC checking off)
     s_card_type = CARD_TYPE_UNKNOWN;
     s_sector_count = 0;
+    s_crc_mode = 0;
+    s_warm = 0;
+    s_high_speed = 0;               // CMD0 drops the card to default speed
+    s_max_hz = 25000000;
 
     // Set slow speed for initialization
     spi_set_speed(SPI_CLK_390KHZ);
@@ -87,6 +276,8 @@ uint8_t sd_init(void) {
     }
 
     // CMD8: Check voltage range (SDv2 cards)
+    s_init_kind = SD_INIT_V1;
+    s_init_deadline = hrt_deadline_ms(SD_INIT_TIMEOUT_MS);
     r1 = sd_send_cmd(CMD8, 0x1AA);
     if (r1 == R1_IDLE_STATE) {
         // SDv2 card
@@ -96,54 +287,66 @@ uint8_t sd_init(void) {
         }
 
         // Check if card accepted voltage range
-        if (ocr[2] == 0x01 && ocr[3] == 0xAA) {
-            // Initialize with ACMD41 with HCS bit
-            retry = 0;
-            do {
-                r1 = sd_send_acmd(ACMD41, 0x40000000);
-                retry++;
-                if (retry > 1000) {
-                    spi_cs_deassert();
-                    return SD_ERROR_TIMEOUT;
-                }
-            } while (r1 != 0x00);
-
-            // Read OCR to check CCS bit
-            if (sd_send_cmd(CMD58, 0) == 0) {
-                for (int i = 0; i < 4; i++) {
-                    ocr[i] = spi_transfer(0xFF);
-                }
-                // Check CCS bit (bit 30 of OCR)
-                if (ocr[0] & 0x40) {
-                    s_card_type = CARD_TYPE_SDHC;
-                } else {
-                    s_card_type = CARD_TYPE_SD2;
-                }
+        s_init_kind = (ocr[2] == 0x01 && ocr[3] == 0xAA) ? SD_INIT_V2 : SD_INIT_V2_NOVOLT;
+    }
+
+    return SD_OK;
+}
+
+static uint8_t sd_init_step(void) {
+    uint8_t r1;
+
+    if (s_init_kind == SD_INIT_V2_NOVOLT) {
+        return SD_OK;
+    }
+
+    // ACMD41, with the HCS bit for SDv2
+    r1 = sd_send_acmd(ACMD41, (s_init_kind == SD_INIT_V2) ? 0x40000000 : 0);
+    if (r1 == 0x00) {
+        return SD_OK;
+    }
+    if (sd_wait_over(s_init_deadline, SD_INIT_TIMEOUT_MS)) {
+        spi_cs_deassert();
+        return (s_init_kind == SD_INIT_V2) ? SD_ERROR_TIMEOUT : SD_ERROR_CARD_TYPE;
+    }
+    return SD_ERROR_NOT_READY;
+}
+
+static uint8_t sd_init_end(void) {
+    if (s_init_kind == SD_INIT_V2) {
+        uint8_t ocr[4];
+
+        // Read OCR to check CCS bit
+        if (sd_send_cmd(CMD58, 0) == 0) {
+            for (int i = 0; i < 4; i++) {
+                ocr[i] = spi_transfer(0xFF);
             }
-        }
-    } else {
-        // SDv1 or MMC card
-        retry = 0;
-        do {
-            r1 = sd_send_acmd(ACMD41, 0);
-            retry++;
-            if (retry > 1000) {
-                spi_cs_deassert();
-                return SD_ERROR_CARD_TYPE;
+            // Check CCS bit (bit 30 of OCR)
+            if (ocr[0] & 0x40) {
+                s_card_type = CARD_TYPE_SDHC;
+            } else {
+                s_card_type = CARD_TYPE_SD2;
             }
-        } while (r1 != 0x00);
-
+        }
+    } else if (s_init_kind == SD_INIT_V1) {
         s_card_type = CARD_TYPE_SD1;
 
         // Set block length to 512 bytes for SDv1
         sd_send_cmd(CMD16, 512);
     }
 
+    // CRC_ON_OFF: have the card check command and write-data CRCs, now that
+    // the SPI master can generate and check them without CPU cost
+    if (spi_crc_present() && sd_send_cmd(CMD59, 1) == 0x00) {
+        s_crc_mode = 1;
+    }
+
     // Deassert CS
     spi_cs_deassert();
 
     // Increase speed to 12.5 MHz for data transfers
     spi_set_speed(SPI_CLK_12MHZ);
+    s_spi_speed = SPI_CLK_12MHZ;
 
     // Read CSD to get card capacity
     sd_csd_t csd;
@@ -151,15 +354,136 @@ uint8_t sd_init(void) {
         return SD_ERROR_READ;
     }
 
+    // Card identity, for sd_get_card_info()
+    if (sd_read_register(CMD10, s_cid) != SD_OK) {
+        return SD_ERROR_READ;
+    }
+
+    // High speed where supported; sd_set_speed() callers check sd_get_max_hz()
+    sd_switch_high_speed();
+
+    return SD_OK;
+}
+
+uint8_t sd_init(void) {
+    uint8_t result = sd_init_begin();
+
+    if (result != SD_OK) {
+        return result;
+    }
+    while ((result = sd_init_step()) == SD_ERROR_NOT_READY);
+    if (result != SD_OK) {
+        return result;
+    }
+    return sd_init_end();
+}
+
+// Take over a card that is already initialized; SD_OK, or an error with the
+// card to be reset by sd_init()
+static uint8_t sd_init_warm(void) {
+    uint8_t ocr[4];
+    uint8_t r1;
+
+    s_card_type = CARD_TYPE_UNKNOWN;
+    s_sector_count = 0;
+    s_crc_mode = 0;
+
+    // Straight to data speed: an initialized card takes any clock up to 25 MHz
+    spi_set_speed(SPI_CLK_12MHZ);
+    s_spi_speed = SPI_CLK_12MHZ;
+
+    spi_cs_deassert();
+    for (int i = 0; i < 2; i++) {
+        spi_transfer(0xFF);
+    }
+    spi_cs_assert();
+
+    // End a CMD18 that a reset cut short (an idle card answers "illegal
+    // command"), then CRC checking off in case the last user turned it on
+    sd_send_cmd(CMD12, 0);
+    sd_wait_ready();
+    sd_send_cmd(CMD59, 0);
+
+    // Initialized: out of idle state, OCR power-up bit set; CCS is the type
+    r1 = sd_send_cmd(CMD58, 0);
+    for (int i = 0; i < 4; i++) {
+        ocr[i] = spi_transfer(0xFF);
+    }
+    if (r1 != 0x00 || !(ocr[0] & 0x80)) {
+        spi_cs_deassert();
+        return SD_ERROR_INIT;
+    }
+    s_card_type = (ocr[0] & 0x40) ? CARD_TYPE_SDHC : CARD_TYPE_SD2;
+
+    if (spi_crc_present() && sd_send_cmd(CMD59, 1) == 0x00) {
+        s_crc_mode = 1;
+    }
+    spi_cs_deassert();
+
+    // A CID with a good CRC7 and the CSD: the card really is in transfer state
+    sd_csd_t csd;
+    if (sd_read_register(CMD10, s_cid) != SD_OK ||
+        sd_crc7(s_cid, 15) != (s_cid[15] >> 1) ||
+        sd_read_csd(&csd) != SD_OK) {
+        s_card_type = CARD_TYPE_UNKNOWN;
+        return SD_ERROR_INIT;
+    }
+
+    // Switching again is harmless: the last user may not have
+    sd_switch_high_speed();
+
     return SD_OK;
 }
 
+uint8_t sd_init_fast(void) {
+    if (sd_init_warm() == SD_OK) {
+        s_warm = 1;
+        return SD_OK;
+    }
+    return sd_init();
+}
+
+uint8_t sd_init_was_warm(void) {
+    return s_warm;
+}
+
+void sd_get_card_info(sd_card_info_t *info) {
+    memcpy(info->cid, s_cid, sizeof(info->cid));
+    info->type = s_card_type;
+    info->sector_count = s_sector_count;
+}
+
+uint8_t sd_match_card_info(const sd_card_info_t *info) {
+    if (s_card_type == CARD_TYPE_UNKNOWN ||
+        memcmp(info->cid, s_cid, sizeof(s_cid)) != 0 ||
+        info->sector_count != s_sector_count ||
+        (info->type == CARD_TYPE_SDHC) != (s_card_type == CARD_TYPE_SDHC)) {
+        return 0;
+    }
+    // OCR cannot tell SD v1 from a v2 SDSC card: the full init could
+    s_card_type = info->type;
+    return 1;
+}
+
 //==============================================================================
 // Configuration
 //==============================================================================
 
 void sd_set_speed(uint32_t speed) {
     spi_set_speed(speed);
+    s_spi_speed = speed;
+}
+
+uint32_t sd_get_speed(void) {
+    return s_spi_speed;
+}
+
+uint8_t sd_high_speed(void) {
+    return s_high_speed;
+}
+
+uint32_t sd_get_max_hz(void) {
+    return s_max_hz;
 }
 
 //==============================================================================
@@ -170,44 +494,25 @@ sd_card_type_t sd_get_card_type(void) {
     return s_card_type;
 }
 
+uint8_t sd_crc_enabled(void) {
+    return s_crc_mode;
+}
+
 uint32_t sd_get_sector_count(void) {
     // TODO: Read from CSD register
     return s_sector_count;
 }
 
 uint8_t sd_read_cid(sd_cid_t *cid) {
-    uint8_t r1;
     uint8_t buffer[16];
-
-    spi_cs_assert();
+    uint8_t r;
 
     // Send CMD10 (SEND_CID)
-    r1 = sd_send_cmd(CMD10, 0);
-    if (r1 != 0x00) {
-        spi_cs_deassert();
-        return SD_ERROR_READ;
-    }
-
-    // Wait for data token (0xFE)
-    uint16_t timeout = 0xFFFF;
-    while (spi_transfer(0xFF) != 0xFE) {
-        if (--timeout == 0) {
-            spi_cs_deassert();
-            return SD_ERROR_TIMEOUT;
-        }
+    r = sd_read_register(CMD10, buffer);
+    if (r != SD_OK) {
+        return r;
     }
 
-    // Read 16 bytes of CID data
-    for (uint8_t i = 0; i < 16; i++) {
-        buffer[i] = spi_transfer(0xFF);
-    }
-
-    // Read CRC (2 bytes) - ignored
-    spi_transfer(0xFF);
-    spi_transfer(0xFF);
-
-    spi_cs_deassert();
-
     // Parse CID register
     cid->mid = buffer[0];
     cid->oid[0] = buffer[1];
@@ -227,38 +532,15 @@ uint8_t sd_read_cid(sd_cid_t *cid) {
 }
 
 uint8_t sd_read_csd(sd_csd_t *csd) {
-    uint8_t r1;
     uint8_t buffer[16];
-
-    spi_cs_assert();
+    uint8_t r;
 
     // Send CMD9 (SEND_CSD)
-    r1 = sd_send_cmd(CMD9, 0);
-    if (r1 != 0x00) {
-        spi_cs_deassert();
-        return SD_ERROR_READ;
-    }
-
-    // Wait for data token (0xFE)
-    uint16_t timeout = 0xFFFF;
-    while (spi_transfer(0xFF) != 0xFE) {
-        if (--timeout == 0) {
-            spi_cs_deassert();
-            return SD_ERROR_TIMEOUT;
-        }
-    }
-
-    // Read 16 bytes of CSD data
-    for (uint8_t i = 0; i < 16; i++) {
-        buffer[i] = spi_transfer(0xFF);
+    r = sd_read_register(CMD9, buffer);
+    if (r != SD_OK) {
+        return r;
     }
 
-    // Read CRC (2 bytes) - ignored
-    spi_transfer(0xFF);
-    spi_transfer(0xFF);
-
-    spi_cs_deassert();
-
     // Parse CSD register - differs between CSD v1.0 and v2.0
     uint8_t csd_version = (buffer[0] >> 6) & 0x03;
 
@@ -286,6 +568,8 @@ uint8_t sd_read_csd(sd_csd_t *csd) {
 
     // Parse other CSD fields
     csd->tran_speed = buffer[3];
+    csd->ccc = ((uint16_t)buffer[4] << 4) | (buffer[5] >> 4);
+    s_can_erase = (csd->ccc & (1 << 5)) ? 1 : 0;
     csd->wp = (buffer[14] & 0x30) ? 1 : 0;
 
     return SD_OK;
@@ -295,8 +579,123 @@ uint8_t sd_read_csd(sd_csd_t *csd) {
 // Data Transfer
 //==============================================================================
 
-uint8_t sd_read_block(uint32_t sector, uint8_t *buffer) {
+// CRC16-CCITT (x^16 + x^12 + x^5 + 1) over a data block, as sent by the card
+static uint16_t sd_crc16(const uint8_t *data, uint32_t len) {
+    uint16_t crc = 0;
+
+    while (len--) {
+        crc ^= (uint16_t)*data++ << 8;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// Wait up to ms while the card holds MISO low (programming / busy)
+static uint8_t sd_wait_ready_ms(uint32_t ms) {
+    hrt_deadline_t deadline = hrt_deadline_ms(ms);
+
+    while (spi_transfer(0xFF) != 0xFF) {
+        if (sd_wait_over(deadline, ms)) {
+            return SD_ERROR_TIMEOUT;
+        }
+    }
+    return SD_OK;
+}
+
+// Busy after a write or a stop
+static uint8_t sd_wait_ready(void) {
+    return sd_wait_ready_ms(SD_WRITE_TIMEOUT_MS);
+}
+
+// Start token (0xFE) of a data packet. Anything else but 0xFF is an error
+// token: SD_ERROR_READ straight away.
+static uint8_t sd_wait_token(void) {
+    hrt_deadline_t deadline = hrt_deadline_ms(SD_READ_TIMEOUT_MS);
+    uint8_t token;
+
+    while ((token = spi_transfer(0xFF)) == 0xFF) {
+        if (sd_wait_over(deadline, SD_READ_TIMEOUT_MS)) {
+            return SD_ERROR_TIMEOUT;
+        }
+    }
+    return (token == 0xFE) ? SD_OK : SD_ERROR_READ;
+}
+
+// Receive one data packet: start token, 512 bytes, CRC16 (MSB first).
+// In CRC mode the hardware CRC over data + CRC must come out 0.
+static uint8_t sd_rx_data_block(uint8_t *buffer, uint16_t *crc) {
+    // Wait for data token (0xFE)
+    uint8_t result = sd_wait_token();
+    if (result != SD_OK) {
+        return result;
+    }
+
+    if (s_crc_mode) {
+        spi_crc_start();
+    }
+
+    // Read 512 bytes: DMA straight into SRAM, or SPI burst reads for
+    // buffers the DMA cannot reach (unaligned / scratchpad)
+    if (spi_dma_capable(buffer, 512)) {
+        spi_dma_read_start(buffer, 512);
+        spi_dma_wait();
+    } else {
+        spi_read_block(buffer, 512);
+    }
+
+    *crc = (uint16_t)spi_transfer(0xFF) << 8;
+    *crc |= spi_transfer(0xFF);
+
+    if (s_crc_mode && spi_crc16_rx() != 0) {
+        return SD_ERROR_CRC;
+    }
+
+    return SD_OK;
+}
+
+// Send one data packet (token 0xFE single / 0xFC multi-block), check the
+// data response and wait for programming to finish
+static uint8_t sd_tx_data_block(uint8_t token, const uint8_t *buffer) {
+    uint16_t crc = 0xFFFF;
+
+    spi_transfer(token);
+    if (s_crc_mode) {
+        spi_crc_start();
+    }
+
+    // Write 512 bytes (DMA from SRAM, or SPI burst writes)
+    if (spi_dma_capable(buffer, 512)) {
+        spi_dma_write_start(buffer, 512);
+        spi_dma_wait();
+    } else {
+        spi_write_block(buffer, 512);
+    }
+
+    // CRC16 of the data (dummy unless the card checks it)
+    if (s_crc_mode) {
+        crc = spi_crc16_tx();
+    }
+    spi_transfer(crc >> 8);
+    spi_transfer(crc & 0xFF);
+
+    // Read data response (0x05 accepted, 0x0B CRC error, 0x0D write error)
+    uint8_t resp = spi_transfer(0xFF);
+    if ((resp & 0x1F) != 0x05) {
+        return ((resp & 0x1F) == 0x0B) ? SD_ERROR_CRC : SD_ERROR_WRITE;
+    }
+
+    return sd_wait_ready();
+}
+
+static uint8_t sd_read_data(uint32_t sector, uint8_t *buffer, uint16_t *crc) {
     uint8_t r1;
+    uint8_t result;
+
+    if (s_card_type == CARD_TYPE_UNKNOWN) {
+        return SD_ERROR_NOT_READY;
+    }
 
     // For SDSC cards, sector address is byte address
     if (s_card_type != CARD_TYPE_SDHC) {
@@ -309,34 +708,41 @@ uint8_t sd_read_block(uint32_t sector, uint8_t *buffer) {
     r1 = sd_send_cmd(CMD17, sector);
     if (r1 != 0x00) {
         spi_cs_deassert();
-        return SD_ERROR_READ;
+        return (r1 == 0xFF) ? sd_card_gone(SD_ERROR_READ) : SD_ERROR_READ;
     }
 
-    // Wait for data token (0xFE)
-    uint16_t timeout = 0xFFFF;
-    while (spi_transfer(0xFF) != 0xFE) {
-        if (--timeout == 0) {
-            spi_cs_deassert();
-            return SD_ERROR_TIMEOUT;
-        }
-    }
+    result = sd_rx_data_block(buffer, crc);
 
-    // Read 512 bytes
-    for (uint16_t i = 0; i < 512; i++) {
-        buffer[i] = spi_transfer(0xFF);
-    }
+    spi_cs_deassert();
 
-    // Read CRC (2 bytes) - ignored for now
-    spi_transfer(0xFF);
-    spi_transfer(0xFF);
+    return (result == SD_ERROR_TIMEOUT) ? sd_card_gone(result) : result;
+}
 
-    spi_cs_deassert();
+uint8_t sd_read_block(uint32_t sector, uint8_t *buffer) {
+    uint16_t crc;
 
-    return SD_OK;
+    // CRC checked in CRC mode only (software CRC16 costs more than the transfer)
+    return sd_read_data(sector, buffer, &crc);
+}
+
+uint8_t sd_read_block_verified(uint32_t sector, uint8_t *buffer) {
+    uint16_t crc;
+    uint8_t result = sd_read_data(sector, buffer, &crc);
+
+    // Already checked in hardware in CRC mode
+    if (result != SD_OK || s_crc_mode) {
+        return result;
+    }
+    return (sd_crc16(buffer, 512) == crc) ? SD_OK : SD_ERROR_CRC;
 }
 
 uint8_t sd_write_block(uint32_t sector, const uint8_t *buffer) {
     uint8_t r1;
+    uint8_t result;
+
+    if (s_card_type == CARD_TYPE_UNKNOWN) {
+        return SD_ERROR_NOT_READY;
+    }
 
     // For SDSC cards, sector address is byte address
     if (s_card_type != CARD_TYPE_SDHC) {
@@ -349,42 +755,491 @@ uint8_t sd_write_block(uint32_t sector, const uint8_t *buffer) {
     r1 = sd_send_cmd(CMD24, sector);
     if (r1 != 0x00) {
         spi_cs_deassert();
-        return SD_ERROR_WRITE;
+        return (r1 == 0xFF) ? sd_card_gone(SD_ERROR_WRITE) : SD_ERROR_WRITE;
     }
 
-    // Send data token
-    spi_transfer(0xFE);
+    result = sd_tx_data_block(0xFE, buffer);
+
+    spi_cs_deassert();
+
+    return result;
+}
+
+// Multi-block read: one CMD18, a data packet per sector, then CMD12.
+// Saves the command, access latency and CS cycle of every sector after the first.
+// One CMD18 stream into buffer (contiguous) or buffers[i] (one per sector)
+static uint8_t sd_read_multi(uint32_t sector, uint8_t *buffer, uint8_t *const *buffers, uint32_t count) {
+    uint8_t r1;
+    uint8_t result = SD_OK;
+    uint16_t crc;
 
-    // Write 512 bytes
-    for (uint16_t i = 0; i < 512; i++) {
-        spi_transfer(buffer[i]);
+    if (s_card_type == CARD_TYPE_UNKNOWN) {
+        return SD_ERROR_NOT_READY;
     }
 
-    // Send dummy CRC
-    spi_transfer(0xFF);
+    // For SDSC cards, sector address is byte address
+    if (s_card_type != CARD_TYPE_SDHC) {
+        sector <<= 9;  // Convert to byte address
+    }
+
+    spi_cs_assert();
+
+    // Send CMD18 (READ_MULTIPLE_BLOCK)
+    r1 = sd_send_cmd(CMD18, sector);
+    if (r1 != 0x00) {
+        spi_cs_deassert();
+        return (r1 == 0xFF) ? sd_card_gone(SD_ERROR_READ) : SD_ERROR_READ;
+    }
+
+    for (uint32_t i = 0; i < count && result == SD_OK; i++) {
+        result = sd_rx_data_block(buffers ? buffers[i] : buffer + (i * 512), &crc);
+    }
+    if (result == SD_ERROR_TIMEOUT) {
+        spi_cs_deassert();
+        return sd_card_gone(result);
+    }
+
+    // STOP_TRANSMISSION ends the stream (also after an error)
+    sd_send_cmd(CMD12, 0);
+    if (sd_wait_ready() != SD_OK && result == SD_OK) {
+        result = SD_ERROR_TIMEOUT;
+    }
+
+    spi_cs_deassert();
+
+    return result;
+}
+
+uint8_t sd_read_blocks(uint32_t sector, uint8_t *buffer, uint32_t count) {
+    if (count == 1) {
+        return sd_read_block(sector, buffer);
+    }
+
+    return sd_read_multi(sector, buffer, NULL, count);
+}
+
+// Scatter read: consecutive sectors, each into its own 512-byte buffer
+// (diskio sector cache lines), still one CMD18
+uint8_t sd_read_blocks_sg(uint32_t sector, uint8_t *const *buffers, uint32_t count) {
+    if (count == 1) {
+        return sd_read_block(sector, buffers[0]);
+    }
+
+    return sd_read_multi(sector, NULL, buffers, count);
+}
+
+// sd_read_blocks() with the CPU released during each sector's DMA: a
+// FreeRTOS task blocks on the SPI DMA completion IRQ so other tasks run,
+// bare metal halts in waitirq. Costs an interrupt per sector, so the
+// polling version stays the faster one when nothing else needs the CPU.
+uint8_t sd_read_blocks_async(uint32_t sector, uint8_t *buffer, uint32_t count) {
+    uint8_t result;
+
+    spi_dma_sleep(1);
+    result = sd_read_blocks(sector, buffer, count);
+    spi_dma_sleep(0);
+
+    return result;
+}
+
+// Multi-block write: ACMD23 pre-erase, one CMD25, a 0xFC packet per sector,
+// then the 0xFD stop token. Data from buffer (contiguous) or buffers[i].
+static uint8_t sd_write_multi(uint32_t sector, const uint8_t *buffer,
+                              const uint8_t *const *buffers, uint32_t count) {
+    uint8_t r1;
+    uint8_t result = SD_OK;
+
+    if (s_card_type == CARD_TYPE_UNKNOWN) {
+        return SD_ERROR_NOT_READY;
+    }
+
+    // For SDSC cards, sector address is byte address
+    if (s_card_type != CARD_TYPE_SDHC) {
+        sector <<= 9;  // Convert to byte address
+    }
+
+    spi_cs_assert();
+
+    // SET_WR_BLK_ERASE_COUNT lets the card erase ahead (a hint; failure is harmless)
+    sd_send_acmd(ACMD23, count);
+
+    // Send CMD25 (WRITE_MULTIPLE_BLOCK)
+    r1 = sd_send_cmd(CMD25, sector);
+    if (r1 != 0x00) {
+        spi_cs_deassert();
+        return (r1 == 0xFF) ? sd_card_gone(SD_ERROR_WRITE) : SD_ERROR_WRITE;
+    }
+
+    for (uint32_t i = 0; i < count && result == SD_OK; i++) {
+        result = sd_tx_data_block(0xFC, buffers ? buffers[i] : buffer + (i * 512));
+    }
+
+    // Stop token, then wait for the card to finish programming
+    spi_transfer(0xFD);
     spi_transfer(0xFF);
+    if (sd_wait_ready() != SD_OK && result == SD_OK) {
+        result = SD_ERROR_TIMEOUT;
+    }
+
+    spi_cs_deassert();
+
+    return result;
+}
+
+uint8_t sd_write_blocks(uint32_t sector, const uint8_t *buffer, uint32_t count) {
+    if (count == 1) {
+        return sd_write_block(sector, buffer);
+    }
+
+    return sd_write_multi(sector, buffer, NULL, count);
+}
+
+// Gather write: consecutive sectors from separate 512-byte buffers
+uint8_t sd_write_blocks_sg(uint32_t sector, const uint8_t *const *buffers, uint32_t count) {
+    if (count == 1) {
+        return sd_write_block(sector, buffers[0]);
+    }
+
+    return sd_write_multi(sector, NULL, buffers, count);
+}
+
+// Erase: CMD32/CMD33 set the first and last sector, CMD38 erases and
+// holds busy until done. Large ranges go in chunks so each busy period
+// stays within the timeout.
+#define SD_ERASE_CHUNK          65536   // Sectors per CMD38 (32 MB)
+#define SD_ERASE_TIMEOUT_MS     5000    // Busy time allowed per chunk
+
+uint8_t sd_erase_blocks(uint32_t first, uint32_t last) {
+    uint8_t result;
+
+    if (last < first || last >= s_sector_count) {
+        return SD_ERROR_ERASE;
+    }
+
+    // Cards without the erase class: nothing to do, TRIM is only a hint
+    if (!s_can_erase) {
+        return SD_OK;
+    }
+
+    while (1) {
+        uint32_t end = (last - first >= SD_ERASE_CHUNK) ? first + SD_ERASE_CHUNK - 1 : last;
+        uint32_t start_addr = first, end_addr = end;
+
+        // For SDSC cards, sector address is byte address
+        if (s_card_type != CARD_TYPE_SDHC) {
+            start_addr <<= 9;
+            end_addr <<= 9;
+        }
+
+        spi_cs_assert();
 
-    // Read data response
+        if (sd_send_cmd(CMD32, start_addr) != 0x00 ||
+            sd_send_cmd(CMD33, end_addr) != 0x00 ||
+            sd_send_cmd(CMD38, 0) != 0x00) {
+            spi_cs_deassert();
+            return SD_ERROR_ERASE;
+        }
+
+        result = sd_wait_ready_ms(SD_ERASE_TIMEOUT_MS);
+
+        spi_cs_deassert();
+
+        if (result != SD_OK || end == last) {
+            return result;
+        }
+        first = end + 1;
+    }
+}
+
+uint8_t sd_can_erase(void) {
+    return s_can_erase;
+}
+
+//==============================================================================
+// Non-Blocking Streams
+//==============================================================================
+// The waits of sd_read_multi() / sd_write_multi() turned into calls that
+// return SD_ERROR_NOT_READY instead, so sd_async.c can leave a transfer
+// running and come back: a few polls for the token (read) or the end of
+// busy (write), then the sector's DMA is started and left to run.
+
+#define SD_STREAM_POLLS     16      // Bytes clocked per start / close call
+
+static uint8_t s_stream_write;      // Open stream is a CMD25
+static uint8_t s_stream_stop;       // Stop token sent, waiting out busy
+static hrt_deadline_t s_stream_deadline;    // End of the current wait
+
+// The next wait: data token (read) or the card's busy (write)
+static void sd_stream_wait_from_now(void) {
+    s_stream_deadline = hrt_deadline_ms(s_stream_write ? SD_WRITE_TIMEOUT_MS
+                                                       : SD_READ_TIMEOUT_MS);
+}
+
+uint8_t sd_stream_open(uint32_t sector, uint32_t count, uint8_t write) {
+    uint8_t r1;
+
+    if (s_card_type == CARD_TYPE_UNKNOWN) {
+        return SD_ERROR_NOT_READY;
+    }
+
+    // For SDSC cards, sector address is byte address
+    if (s_card_type != CARD_TYPE_SDHC) {
+        sector <<= 9;
+    }
+
+    spi_cs_assert();
+    if (write) {
+        sd_send_acmd(ACMD23, count);    // Pre-erase hint
+    }
+    r1 = sd_send_cmd(write ? CMD25 : CMD18, sector);
+    if (r1 != 0x00) {
+        spi_cs_deassert();
+        return (r1 == 0xFF) ? sd_card_gone(write ? SD_ERROR_WRITE : SD_ERROR_READ)
+                            : (write ? SD_ERROR_WRITE : SD_ERROR_READ);
+    }
+
+    s_stream_write = write;
+    s_stream_stop = 0;
+    sd_stream_wait_from_now();
+    return SD_OK;
+}
+
+uint8_t sd_stream_start(uint8_t *buffer) {
+    uint8_t b = 0xFF;
+    int i;
+
+    if (!s_stream_write) {
+        // Data token
+        for (i = 0; i < SD_STREAM_POLLS && (b = spi_transfer(0xFF)) == 0xFF; i++);
+        if (b == 0xFF) {
+            if (hrt_expired(s_stream_deadline)) {
+                spi_cs_deassert();
+                return sd_card_gone(SD_ERROR_TIMEOUT);
+            }
+            return SD_ERROR_NOT_READY;
+        }
+        if (b != 0xFE) {
+            return SD_ERROR_READ;
+        }
+        if (s_crc_mode) {
+            spi_crc_start();
+        }
+        if (spi_dma_capable(buffer, 512)) {
+            spi_dma_read_start(buffer, 512);
+        } else {
+            spi_read_block(buffer, 512);
+        }
+        return SD_OK;
+    }
+
+    // Previous sector programmed (MISO released)
+    for (i = 0; i < SD_STREAM_POLLS && (b = spi_transfer(0xFF)) != 0xFF; i++);
+    if (b != 0xFF) {
+        if (hrt_expired(s_stream_deadline)) {
+            return SD_ERROR_TIMEOUT;
+        }
+        return SD_ERROR_NOT_READY;
+    }
+    spi_transfer(0xFC);
+    if (s_crc_mode) {
+        spi_crc_start();
+    }
+    if (spi_dma_capable(buffer, 512)) {
+        spi_dma_write_start(buffer, 512);
+    } else {
+        spi_write_block(buffer, 512);
+    }
+    return SD_OK;
+}
+
+uint8_t sd_stream_busy(void) {
+    return spi_dma_busy() ? 1 : 0;
+}
+
+uint8_t sd_stream_end(void) {
+    uint16_t crc = 0xFFFF;
+
+    sd_stream_wait_from_now();
+
+    if (!s_stream_write) {
+        spi_transfer(0xFF);             // CRC16, checked in hardware in CRC mode
+        spi_transfer(0xFF);
+        return (s_crc_mode && spi_crc16_rx() != 0) ? SD_ERROR_CRC : SD_OK;
+    }
+
+    if (s_crc_mode) {
+        crc = spi_crc16_tx();
+    }
+    spi_transfer(crc >> 8);
+    spi_transfer(crc & 0xFF);
+
+    // Data response (0x05 accepted, 0x0B CRC error, 0x0D write error)
     uint8_t resp = spi_transfer(0xFF);
     if ((resp & 0x1F) != 0x05) {
+        return ((resp & 0x1F) == 0x0B) ? SD_ERROR_CRC : SD_ERROR_WRITE;
+    }
+    return SD_OK;
+}
+
+uint8_t sd_stream_close(void) {
+    uint8_t b = 0x00;
+    int i;
+
+    // Card gone mid-stream (sd_card_gone()): nothing to stop
+    if (s_card_type == CARD_TYPE_UNKNOWN) {
         spi_cs_deassert();
-        return SD_ERROR_WRITE;
+        return SD_ERROR_TIMEOUT;
     }
 
-    // Wait for card to finish writing (busy)
-    uint16_t timeout = 0xFFFF;
-    while (spi_transfer(0xFF) == 0x00) {
-        if (--timeout == 0) {
-            spi_cs_deassert();
-            return SD_ERROR_TIMEOUT;
+    if (!s_stream_write) {
+        // STOP_TRANSMISSION; its busy is short
+        sd_send_cmd(CMD12, 0);
+        b = sd_wait_ready();
+        spi_cs_deassert();
+        return b;
+    }
+
+    if (!s_stream_stop) {
+        // Last sector programmed, then the stop token
+        for (i = 0; i < SD_STREAM_POLLS && (b = spi_transfer(0xFF)) != 0xFF; i++);
+        if (b != 0xFF) {
+            if (!hrt_expired(s_stream_deadline)) {
+                return SD_ERROR_NOT_READY;
+            }
         }
+        spi_transfer(0xFD);
+        spi_transfer(0xFF);
+        s_stream_stop = 1;
+        sd_stream_wait_from_now();
     }
 
+    for (i = 0; i < SD_STREAM_POLLS && (b = spi_transfer(0xFF)) != 0xFF; i++);
+    if (b != 0xFF) {
+        if (!hrt_expired(s_stream_deadline)) {
+            return SD_ERROR_NOT_READY;
+        }
+        spi_cs_deassert();
+        return SD_ERROR_TIMEOUT;
+    }
     spi_cs_deassert();
-
     return SD_OK;
 }
 
+//==============================================================================
+// Hot-Plug Detection
+//==============================================================================
+// The slot's card-detect switch does not reach the FPGA, so presence is
+// polled. An initialized card is asked for its OCR: CMD58 rather than
+// CMD13, because with the card gone and MISO floating low an all-zero
+// "no errors" R2 looks like a card, while the OCR power-up bit reads 0.
+// An empty slot gets a CMD0 now and then; a card that answers is brought
+// up one ACMD41 slice per poll, so nothing waits for the whole init.
+
+#define SD_HOTPLUG_RETRY_MS     2000    // After a card failed to initialize
+#define SD_HOTPLUG_SLICE_MS     5       // Initialization per sd_hotplug_poll()
+
+typedef enum {
+    HP_OFF = 0,         // Not started
+    HP_ONLINE,          // Card initialized: presence checks
+    HP_EJECTED,         // Unmounted for removal: quiet until the card is out
+    HP_OFFLINE,         // No card: CMD0 probes
+    HP_INIT             // New card: ACMD41 slices
+} sd_hotplug_state_t;
+
+static sd_hotplug_state_t s_hp_state = HP_OFF;
+static hrt_deadline_t s_hp_next;    // Next check
+
+static uint8_t sd_card_present(void) {
+    uint8_t r1, ocr0;
+
+    spi_cs_assert();
+    r1 = sd_send_cmd(CMD58, 0);
+    ocr0 = spi_transfer(0xFF);
+    for (int i = 0; i < 3; i++) {
+        spi_transfer(0xFF);
+    }
+    spi_cs_deassert();
+
+    return r1 == 0x00 && (ocr0 & 0x80);
+}
+
+static void sd_hotplug_set(sd_hotplug_state_t state, uint32_t wait_ms) {
+    s_hp_state = state;
+    s_hp_next = hrt_deadline_ms(wait_ms);
+}
+
+void sd_hotplug_start(void) {
+    sd_hotplug_set((s_card_type != CARD_TYPE_UNKNOWN) ? HP_ONLINE : HP_OFFLINE,
+                   SD_HOTPLUG_POLL_MS);
+}
+
+void sd_hotplug_eject(void) {
+    if (s_hp_state != HP_OFF) {
+        sd_hotplug_set((s_card_type != CARD_TYPE_UNKNOWN) ? HP_EJECTED : HP_OFFLINE,
+                       SD_HOTPLUG_POLL_MS);
+    }
+}
+
+uint8_t sd_hotplug_active(void) {
+    return s_hp_state != HP_OFF;
+}
+
+uint8_t sd_hotplug_busy(void) {
+    return s_hp_state == HP_INIT;
+}
+
+sd_hotplug_event_t sd_hotplug_poll(void) {
+    hrt_deadline_t slice;
+    sd_hotplug_event_t event;
+    uint8_t result;
+
+    if (s_hp_state == HP_OFF || (s_hp_state != HP_INIT && !hrt_expired(s_hp_next))) {
+        return SD_HOTPLUG_NONE;
+    }
+
+    switch (s_hp_state) {
+    case HP_ONLINE:
+    case HP_EJECTED:
+        // Lost by a data call, or no OCR: out of the slot
+        if (s_card_type != CARD_TYPE_UNKNOWN && sd_card_present()) {
+            sd_hotplug_set(s_hp_state, SD_HOTPLUG_POLL_MS);
+            return SD_HOTPLUG_NONE;
+        }
+        event = (s_hp_state == HP_ONLINE) ? SD_HOTPLUG_REMOVED : SD_HOTPLUG_NONE;
+        sd_card_gone(0);
+        sd_hotplug_set(HP_OFFLINE, SD_HOTPLUG_POLL_MS);
+        return event;
+
+    case HP_OFFLINE:
+        if (sd_init_begin() == SD_OK) {
+            sd_hotplug_set(HP_INIT, 0);
+        } else {
+            sd_hotplug_set(HP_OFFLINE, SD_HOTPLUG_POLL_MS);
+        }
+        return SD_HOTPLUG_NONE;
+
+    default:    // HP_INIT
+        slice = hrt_deadline_ms(SD_HOTPLUG_SLICE_MS);
+        do {
+            result = sd_init_step();
+        } while (result == SD_ERROR_NOT_READY && !hrt_expired(slice));
+        if (result == SD_ERROR_NOT_READY) {
+            return SD_HOTPLUG_NONE;
+        }
+        if (result == SD_OK) {
+            result = sd_init_end();
+        }
+        if (result != SD_OK) {
+            // A card that will not come up: try again less often
+            sd_card_gone(0);
+            sd_hotplug_set(HP_OFFLINE, SD_HOTPLUG_RETRY_MS);
+            return SD_HOTPLUG_NONE;
+        }
+        sd_hotplug_set(HP_ONLINE, SD_HOTPLUG_POLL_MS);
+        return SD_HOTPLUG_INSERTED;
+    }
+}
+
 //==============================================================================
 // Utility
 //==============================================================================
@@ -399,6 +1254,7 @@ const char* sd_get_error_string(uint8_t error) {
         case SD_ERROR_CRC:       return "CRC error";
         case SD_ERROR_NOT_READY: return "Card not ready";
         case SD_ERROR_CARD_TYPE: return "Unknown card type";
+        case SD_ERROR_ERASE:     return "Erase error";
         default:                 return "Unknown error";
     }
 }
@@ -15,6 +15,7 @@
 
 #define CMD0    0   // GO_IDLE_STATE
 #define CMD1    1   // SEND_OP_COND (MMC)
+#define CMD6    6   // SWITCH_FUNC
 #define CMD8    8   // SEND_IF_COND
 #define CMD9    9   // SEND_CSD
 #define CMD10   10  // SEND_CID
@@ -30,6 +31,7 @@
 #define CMD38   38  // ERASE
 #define CMD55   55  // APP_CMD
 #define CMD58   58  // READ_OCR
+#define CMD59   59  // CRC_ON_OFF
 #define ACMD13  13  // SD_STATUS (SDC)
 #define ACMD23  23  // SET_WR_BLK_ERASE_COUNT (SDC)
 #define ACMD41  41  // SD_SEND_OP_COND (SDC)
@@ -69,7 +71,8 @@ typedef enum {
     SD_ERROR_WRITE,
     SD_ERROR_CRC,
     SD_ERROR_NOT_READY,
-    SD_ERROR_CARD_TYPE
+    SD_ERROR_CARD_TYPE,
+    SD_ERROR_ERASE
 } sd_error_t;
 
 //==============================================================================
@@ -97,6 +100,13 @@ typedef struct {
     uint8_t  wp;        // Write protect
 } sd_csd_t;
 
+// What identifies an initialized card (sd_get_card_info(), config store)
+typedef struct {
+    uint8_t  cid[16];   // Raw CID register
+    sd_card_type_t type;
+    uint32_t sector_count;
+} sd_card_info_t;
+
 //==============================================================================
 // Function Prototypes
 //==============================================================================
@@ -104,19 +114,76 @@ typedef struct {
 // Initialization
 void sd_spi_init(void);
 uint8_t sd_init(void);
+// sd_init() unless the card is still initialized (SD bootloader, or a reset
+// that left it powered): then no CMD0 / ACMD41 at 390 kHz, only OCR, CID
+// and CSD at 12.5 MHz. sd_init_was_warm() tells which one ran.
+uint8_t sd_init_fast(void);
+uint8_t sd_init_was_warm(void);
+// Card identity for a cache; 1 if info is the card in the slot, and then
+// its type (which a warm start cannot tell between SD v1 and v2) is taken
+void sd_get_card_info(sd_card_info_t *info);
+uint8_t sd_match_card_info(const sd_card_info_t *info);
 
 // Configuration
 void sd_set_speed(uint32_t speed);
+uint32_t sd_get_speed(void);     // SPI_CTRL value of the last sd_set_speed()
 
 // Card Information
 sd_card_type_t sd_get_card_type(void);
 uint32_t sd_get_sector_count(void);
 uint8_t sd_read_cid(sd_cid_t *cid);
 uint8_t sd_read_csd(sd_csd_t *csd);
+uint8_t sd_crc_enabled(void);   // Card in CMD59 CRC mode (hardware CRC present)
+// Every init switches cards with command class 10 to high speed (CMD6);
+// the fastest SCK allowed follows from the CSD TRAN_SPEED read after it
+uint8_t sd_high_speed(void);     // Card in high-speed mode
+uint32_t sd_get_max_hz(void);    // 25 MHz, 50 MHz in high speed
 
 // Data Transfer
 uint8_t sd_read_block(uint32_t sector, uint8_t *buffer);
+uint8_t sd_read_block_verified(uint32_t sector, uint8_t *buffer);  // Checks the data CRC16
 uint8_t sd_write_block(uint32_t sector, const uint8_t *buffer);
+uint8_t sd_read_blocks(uint32_t sector, uint8_t *buffer, uint32_t count);         // CMD18
+uint8_t sd_read_blocks_async(uint32_t sector, uint8_t *buffer, uint32_t count);   // Sleeps during DMA
+uint8_t sd_write_blocks(uint32_t sector, const uint8_t *buffer, uint32_t count);  // CMD25
+uint8_t sd_read_blocks_sg(uint32_t sector, uint8_t *const *buffers, uint32_t count);          // CMD18, per-sector buffers
+uint8_t sd_write_blocks_sg(uint32_t sector, const uint8_t *const *buffers, uint32_t count);   // CMD25, per-sector buffers
+
+// Non-blocking multi-block stream for the request queue (sd_async.c): one
+// CMD18 / CMD25 open at a time, a sector per start / end pair with its DMA
+// running in between. SD_ERROR_NOT_READY: the card is not there yet (no
+// data token, or still busy programming), call again. Sector buffers that
+// the DMA cannot reach are moved by the CPU inside sd_stream_start().
+uint8_t sd_stream_open(uint32_t sector, uint32_t count, uint8_t write);
+uint8_t sd_stream_start(uint8_t *buffer);   // Writes: the data to send
+uint8_t sd_stream_busy(void);               // Sector DMA still running
+uint8_t sd_stream_end(void);                // Sector done: CRC / data response
+uint8_t sd_stream_close(void);              // CMD12 / stop token (NOT_READY while busy)
+
+// Erase (TRIM): sectors first..last inclusive, CMD32/CMD33/CMD38
+uint8_t sd_erase_blocks(uint32_t first, uint32_t last);
+uint8_t sd_can_erase(void);     // CSD command class 5; without it erases are skipped
+
+// Hot-plug (the slot's card-detect switch is not wired: polled over SPI).
+// Call sd_hotplug_poll() from an idle loop, at least every
+// SD_HOTPLUG_POLL_MS and as often as possible while sd_hotplug_busy():
+// card presence is checked every SD_HOTPLUG_POLL_MS, a new card is
+// initialized a few ms per call. REMOVED: the card is already unknown to
+// the driver (data calls fail at once); INSERTED: initialized at 12.5 MHz,
+// ready to mount. A card that a data call found gone is reported too.
+typedef enum {
+    SD_HOTPLUG_NONE = 0,
+    SD_HOTPLUG_REMOVED,
+    SD_HOTPLUG_INSERTED
+} sd_hotplug_event_t;
+
+#define SD_HOTPLUG_POLL_MS      250
+
+void sd_hotplug_start(void);    // From the current state (initialized or not); also after sd_init()
+void sd_hotplug_eject(void);    // Volume unmounted for removal: no events until the card is out
+uint8_t sd_hotplug_active(void);    // Started: sd_init() is left to the poller (diskio)
+uint8_t sd_hotplug_busy(void);      // Initializing a card: poll again soon
+sd_hotplug_event_t sd_hotplug_poll(void);
 
 // Utility
 const char* sd_get_error_string(uint8_t error);
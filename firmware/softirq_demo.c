@@ -0,0 +1,244 @@
+/*
+ * Deferred Work Demo for PicoRV32 (lib/softirq)
+ *
+ * A 1 kHz tick starts a job every 10 ms: a software CRC32 of 2 KB, about
+ * 40k cycles. A second timer (channel 1, counting CPU cycles) interrupts
+ * every 2 ms and measures its own latency: cycles from the reload to its
+ * handler. The job runs three ways, 2 s each:
+ *
+ *   inline  in the tick ISR: the probe waits for the whole job
+ *   irq     as 256-byte steps from the soft IRQ (SOFTIRQ_MODE_IRQ):
+ *           the probe waits for one step at most
+ *   poll    the same steps from the main loop (SOFTIRQ_MODE_POLL) with
+ *           interrupts on: the probe preempts the job
+ *
+ * No irq_handler() here: the handlers are registered with the start.S
+ * dispatcher (lib/irq.h), so the soft IRQ is dispatched after the timers.
+ */
+
+#include <stdint.h>
+#include "../lib/irq.h"
+#include "../lib/timer.h"
+#include "../lib/crc32.h"
+#include "../lib/softirq/softirq.h"
+
+//==============================================================================
+// Hardware Registers
+//==============================================================================
+
+#define UART_TX_DATA   (*(volatile uint32_t*)0x80000000)
+#define UART_TX_STATUS (*(volatile uint32_t*)0x80000004)
+
+#define PROBE_CH        1
+#define PROBE_ARR       (SYS_CLK_HZ / 500 - 1)  // 2 ms in CPU cycles
+
+#define JOB_BYTES       2048
+#define JOB_STEP        256
+#define JOB_PERIOD_MS   10
+#define RUN_MS          2000
+
+#define MODE_INLINE     2               // Next to SOFTIRQ_MODE_IRQ / _POLL
+
+//==============================================================================
+// State
+//==============================================================================
+
+static uint8_t job_data[JOB_BYTES];
+
+static volatile uint32_t ticks = 0;
+static volatile uint32_t mode = MODE_INLINE;
+
+static uint32_t job_offset;
+static uint32_t job_crc;
+static volatile uint32_t job_busy = 0;
+static volatile uint32_t jobs_done = 0;
+static volatile uint32_t jobs_late = 0;     // Started while one still ran
+
+static volatile uint32_t probe_count = 0;
+static volatile uint32_t probe_max = 0;
+static volatile uint32_t probe_total = 0;
+
+//==============================================================================
+// Simple printf without newlib
+//==============================================================================
+
+static void uart_putc(char c) {
+    while (UART_TX_STATUS & 0x01);
+    UART_TX_DATA = c;
+}
+
+static void uart_puts(const char *s) {
+    while (*s) {
+        uart_putc(*s++);
+    }
+}
+
+static void uart_putdec(uint32_t val) {
+    char buf[12];
+    int i = 0;
+
+    do {
+        buf[i++] = '0' + (val % 10);
+        val /= 10;
+    } while (val > 0);
+    while (i > 0) {
+        uart_putc(buf[--i]);
+    }
+}
+
+//==============================================================================
+// The Job
+//==============================================================================
+
+// One step; re-raises itself until the buffer is done
+static void job_step(void *arg);
+static softirq_work_t job_work = SOFTIRQ_WORK_INIT(job_step, 0);
+
+static void job_step(void *arg) {
+    (void)arg;
+
+    job_crc = crc32_update_sw(job_crc, job_data + job_offset, JOB_STEP);
+    job_offset += JOB_STEP;
+    if (job_offset < JOB_BYTES) {
+        softirq_raise(&job_work);
+    } else {
+        jobs_done++;
+        job_busy = 0;
+    }
+}
+
+static void job_start(void) {
+    if (mode == MODE_INLINE) {
+        job_crc = crc32_update_sw(0, job_data, JOB_BYTES);
+        jobs_done++;
+        return;
+    }
+    if (job_busy) {
+        jobs_late++;            // Previous one not finished: let it run on
+        return;
+    }
+    job_busy = 1;
+    job_offset = 0;
+    job_crc = 0;
+    softirq_raise(&job_work);
+}
+
+//==============================================================================
+// Interrupt Handlers
+//==============================================================================
+
+static void tick_isr(uint32_t source) {
+    (void)source;
+    TIMER_CH_SR(0) = TIMER_CH_UIF;
+    if (++ticks % JOB_PERIOD_MS == 0) {
+        job_start();
+    }
+}
+
+static void probe_isr(uint32_t source) {
+    uint32_t latency = PROBE_ARR - TIMER_CH_CNT(PROBE_CH);
+
+    (void)source;
+    if (TIMER_CH_SR(PROBE_CH) & TIMER_CH_UIF) {
+        TIMER_CH_SR(PROBE_CH) = TIMER_CH_UIF;
+        probe_count++;
+        probe_total += latency;
+        if (latency > probe_max) {
+            probe_max = latency;
+        }
+    }
+}
+
+//==============================================================================
+// Main
+//==============================================================================
+
+static void run_mode(uint32_t m, const char *name) {
+    softirq_stats_t st;
+    uint32_t end;
+    uint32_t old = irq_setmask(~0u);
+
+    mode = m;
+    if (m != MODE_INLINE) {
+        softirq_init(m);
+    }
+    probe_count = 0;
+    probe_max = 0;
+    probe_total = 0;
+    jobs_done = 0;
+    jobs_late = 0;
+    end = ticks + RUN_MS;
+    irq_setmask(old);
+
+    while ((int32_t)(ticks - end) < 0) {
+        if (m == SOFTIRQ_MODE_POLL) {
+            softirq_poll();
+        }
+        softirq_wait();
+    }
+
+    mode = MODE_INLINE;         // Quiet while printing
+    softirq_get_stats(&st);
+
+    uart_puts("  ");
+    uart_puts(name);
+    uart_puts(": probe latency max ");
+    uart_putdec(probe_max);
+    uart_puts(" avg ");
+    uart_putdec(probe_count ? probe_total / probe_count : 0);
+    uart_puts(" cycles (");
+    uart_putdec(probe_count);
+    uart_puts(" probes), jobs ");
+    uart_putdec(jobs_done);
+    uart_puts(", late ");
+    uart_putdec(jobs_late);
+    uart_puts(", queue max ");
+    uart_putdec(st.max_depth);
+    uart_puts("\r\n");
+}
+
+int main(void) {
+    for (uint32_t i = 0; i < JOB_BYTES; i++) {
+        job_data[i] = (uint8_t)(i * 7);
+    }
+
+    uart_puts("\r\n");
+    uart_puts("========================================\r\n");
+    uart_puts("Deferred Work Demo (lib/softirq)\r\n");
+    uart_puts("========================================\r\n");
+    uart_puts("Job: CRC32 of 2 KB every 10 ms; probe IRQ every 2 ms\r\n");
+    if (!irqc_present()) {
+        uart_puts("No interrupt controller: soft IRQ dispatched by IRQ number\r\n");
+    }
+    uart_puts("\r\n");
+
+    irq_setmask(~0u);
+    irq_register(IRQ_TIMER, tick_isr, 8);
+    irq_register(IRQ_TIMERS, probe_isr, 15);
+
+    TIMER_CH_CR(0) = 0;
+    TIMER_CH_PSC(0) = TIMER_PSC_1MHZ;
+    TIMER_CH_ARR(0) = 1000 - 1;                 // 1 kHz
+    TIMER_CH_SR(0) = TIMER_CH_UIF;
+    TIMER_CH_CR(0) = TIMER_CH_ENABLE;
+
+    TIMER_CH_CR(PROBE_CH) = 0;
+    TIMER_CH_PSC(PROBE_CH) = 0;                 // CPU cycles
+    TIMER_CH_ARR(PROBE_CH) = PROBE_ARR;
+    TIMER_CH_SR(PROBE_CH) = TIMER_CH_UIF;
+    TIMER_CH_CR(PROBE_CH) = TIMER_CH_ENABLE;
+
+    irq_enable_all();
+
+    for (uint32_t run = 1; ; run++) {
+        uart_puts("Run ");
+        uart_putdec(run);
+        uart_puts(":\r\n");
+        run_mode(MODE_INLINE, "inline");
+        run_mode(SOFTIRQ_MODE_IRQ, "irq   ");
+        run_mode(SOFTIRQ_MODE_POLL, "poll  ");
+        uart_puts("\r\n");
+    }
+
+    return 0;
+}
@@ -935,26 +935,8 @@ void show_manual_config_menu(void) {
         timeout(-1);
         int ch = getch();
 
-        if (ch == 27) {  // ESC or arrow key
-            // Check if this is an arrow key (ESC [ X) or just ESC
-            timeout(10);  // Brief timeout to check for following characters
-            int ch2 = getch();
-            if (ch2 == '[') {
-                int ch3 = getch();
-                timeout(-1);
-                if (ch3 == 'A') ch = KEY_UP;
-                else if (ch3 == 'B') ch = KEY_DOWN;
-                else if (ch3 == 'C') ch = KEY_RIGHT;
-                else if (ch3 == 'D') ch = KEY_LEFT;
-                else {
-                    break;  // Unknown escape sequence, treat as ESC
-                }
-            } else {
-                timeout(-1);
-                // Either just ESC or ESC + some other character
-                // In either case, treat as ESC and cancel
-                break;
-            }
+        if (ch == 27) {  // ESC - cancel (arrow keys come decoded, keypad mode)
+            break;
         }
 
         if (ch == '\n' || ch == '\r') {  // Enter - accept
@@ -1868,11 +1850,11 @@ int main(void) {
             }
             need_full_redraw = 1;  // Redraw to update mode display
         }
-        else if (ch == 65 || ch == 'k') {  // Up
+        else if (ch == KEY_UP || ch == 'k') {  // Up
             selected_test--;
             if (selected_test < TEST_LOOPBACK) selected_test = TEST_SPI_TERMINAL;
         }
-        else if (ch == 66 || ch == 'j') {  // Down
+        else if (ch == KEY_DOWN || ch == 'j') {  // Down
             selected_test++;
             if (selected_test > TEST_SPI_TERMINAL) selected_test = TEST_LOOPBACK;
         }
@@ -1937,7 +1919,7 @@ int main(void) {
             }
             // Manual transfer and SPI terminal have no editable menu params
         }
-        else if (ch == 67 || ch == 'l' || ch == KEY_RIGHT) {  // Right arrow - cycle transfer size forward
+        else if (ch == 'l' || ch == KEY_RIGHT) {  // Right arrow - cycle transfer size forward
             if (selected_test == TEST_LOOPBACK) {
                 // Cycle loopback transfer size: 2 -> 4 -> 8 -> ... -> 8192 -> 2
                 if (config.loopback_bytes < 8192) {
@@ -1957,7 +1939,7 @@ int main(void) {
                 need_param_update = 1;
             }
         }
-        else if (ch == 68 || ch == 'h' || ch == KEY_LEFT) {  // Left arrow - cycle transfer size backward
+        else if (ch == 'h' || ch == KEY_LEFT) {  // Left arrow - cycle transfer size backward
             if (selected_test == TEST_LOOPBACK) {
                 // Cycle loopback transfer size: 2 <- 4 <- 8 <- ... <- 8192 <- 2
                 if (config.loopback_bytes > 2) {
@@ -0,0 +1,317 @@
+//===============================================================================
+// Full-SRAM Burn-in Test
+// All 512 KB of SRAM, firmware region included, tested from the BRAM
+// scratchpad with word-wide patterns and the memory DMA fill engine
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// The memory_test_* programs and heap_test only reach the SRAM they do not
+// run from, and their instruction fetches share the SRAM port with the data
+// under test. Here main() only prints the banner: the test itself is in
+// .fastcode, its stack, error log and strings in .fastbss / .fastdata, so
+// after the jump nothing is fetched from SRAM and every word of it can be
+// overwritten, this program's own image included. Interrupts stay masked
+// (their handlers live in SRAM).
+//
+// Each pass, six patterns over 0x00000000-0x0007FFFF:
+//   fill     0x00000000, 0xFFFFFFFF, 0xAAAAAAAA, 0x55555555, written by the
+//            DMA fill engine at bus speed (CPU stores without the engine)
+//   address  each word holds its address XOR a per-pass seed, then the
+//            inverse: finds address lines that alias and stuck bits
+// and all of it is read back a word at a time, four loads per check. The
+// D-cache is cleaned and invalidated around each pattern, so every read
+// comes from SRAM. CPU loads of 0x40000-0x41FFF return the boot ROM, not
+// the SRAM under it: the DMA engine copies those 8 KB next to it, where
+// they are checked (without the engine they are written but not read).
+//
+// Per pass: KB tested (written and read back), time, MB/s, errors so far
+// and the OR of all failing bits, then the first BURNIN_LOG mismatches
+// (address, expected, read). Passes repeat until a key is pressed, which
+// jumps to the boot ROM for the next upload; the firmware is gone by then.
+//
+//===============================================================================
+
+#include <stdio.h>
+#include <stdint.h>
+#include "../lib/irq.h"
+#include "../lib/dma.h"             // MEM_DMA_* and CACHE_* registers
+#include "../lib/perf_counters.h"   // PERF_CPU_HZ
+
+// UART direct access: the scratchpad code cannot call into SRAM
+#define UART_TX_DATA    (*(volatile uint32_t*)0x80000000)
+#define UART_TX_STATUS  (*(volatile uint32_t*)0x80000004)
+#define UART_RX_DATA    (*(volatile uint32_t*)0x80000008)
+#define UART_RX_STATUS  (*(volatile uint32_t*)0x8000000C)
+
+#define SRAM_SIZE       0x00080000
+#define BOOTROM_BASE    0x00040000      // hdl/mem_controller.v BOOT_BASE: loads read the ROM
+#define BOOTROM_SIZE    8192
+#define SHADOW_COPY     (BOOTROM_BASE + BOOTROM_SIZE)   // The SRAM under the ROM, copied
+
+#define BURNIN_PATTERNS 6               // Per pass
+#define BURNIN_LOG      8               // Mismatches kept
+#define BURNIN_STACK    64              // Words
+
+// SRAM starts at address 0: the asm hides the address from GCC, which
+// would otherwise treat stores through it as null pointer dereferences
+#define SRAM_PTR(a)     ({ uint32_t a_ = (a); __asm__ ("" : "+r"(a_)); (volatile uint32_t *)a_; })
+
+#define FAST            __attribute__((section(".fastcode")))
+#define FASTDATA        __attribute__((section(".fastdata")))
+#define FASTBSS         __attribute__((section(".fastbss")))
+
+typedef struct {
+    uint32_t addr;
+    uint32_t expect;
+    uint32_t got;
+} burnin_error_t;
+
+static burnin_error_t err_log[BURNIN_LOG] FASTBSS;
+static uint32_t err_count FASTBSS;
+static uint32_t err_bits FASTBSS;
+static uint32_t use_dma FASTBSS;
+static uint32_t burnin_stack[BURNIN_STACK] FASTBSS __attribute__((aligned(16)));
+
+// String literals would be in .rodata, in SRAM
+static char s_pass[] FASTDATA = "pass ";
+static char s_tested[] FASTDATA = ": tested ";
+static char s_kb_in[] FASTDATA = " KB in ";
+static char s_ms[] FASTDATA = " ms, ";
+static char s_mbs[] FASTDATA = " MB/s, errors ";
+static char s_bits[] FASTDATA = " (bits 0x";
+static char s_addr[] FASTDATA = "  0x";
+static char s_want[] FASTDATA = ": wrote 0x";
+static char s_read[] FASTDATA = ", read 0x";
+static char s_bootrom[] FASTDATA = "Key pressed: jumping to the boot ROM\r\n";
+static char s_crlf[] FASTDATA = "\r\n";
+
+//==============================================================================
+// Scratchpad Helpers (no calls into SRAM, no .rodata)
+//==============================================================================
+
+FAST static void spad_putc(char c) {
+    while (UART_TX_STATUS & 1);
+    UART_TX_DATA = c;
+}
+
+FAST static void spad_puts(const char *s) {
+    while (*s) {
+        spad_putc(*s++);
+    }
+}
+
+FAST static void spad_putdec(uint32_t v) {
+    char digits[10];
+    int n = 0;
+
+    do {
+        digits[n++] = '0' + v % 10;
+        v /= 10;
+    } while (v);
+    while (n) {
+        spad_putc(digits[--n]);
+    }
+}
+
+FAST static void spad_puthex(uint32_t v) {
+    for (int shift = 28; shift >= 0; shift -= 4) {
+        uint32_t nibble = (v >> shift) & 0xF;
+        spad_putc(nibble < 10 ? '0' + nibble : 'A' + nibble - 10);
+    }
+}
+
+FAST static uint32_t spad_rdcycle(void) {
+    uint32_t c;
+    __asm__ volatile ("rdcycle %0" : "=r"(c));
+    return c;
+}
+
+FAST static void spad_dcache(uint32_t op) {
+    CACHE_DADDR = 0;
+    CACHE_DLEN = SRAM_SIZE;
+    CACHE_CTRL = op;
+    while (CACHE_CTRL & CACHE_DCACHE_CLEAN);
+}
+
+FAST static void spad_dma(uint32_t ctrl, uint32_t src, uint32_t dst, uint32_t len, uint32_t fill) {
+    MEM_DMA_FILL = fill;
+    MEM_DMA_SRC = src;
+    MEM_DMA_DST = dst;
+    MEM_DMA_LEN = len;
+    MEM_DMA_CTRL = MEM_DMA_START | ctrl;
+    while (MEM_DMA_CTRL & MEM_DMA_START);
+}
+
+//==============================================================================
+// Write and Check
+//==============================================================================
+
+FAST __attribute__((noinline)) static void record(uint32_t addr, uint32_t expect, uint32_t got) {
+    if (err_count < BURNIN_LOG) {
+        err_log[err_count].addr = addr;
+        err_log[err_count].expect = expect;
+        err_log[err_count].got = got;
+    }
+    err_count++;
+    err_bits |= expect ^ got;
+}
+
+// Word at address a holds (a & mask) ^ x: mask 0 for a fill, ~0 for the
+// address patterns. The words at base stand for those from addr up (both
+// 16-byte aligned, so addr + 4 is addr ^ 4 and so on).
+FAST static void check(uint32_t base, uint32_t end, uint32_t addr, uint32_t mask, uint32_t x) {
+    volatile uint32_t *p = SRAM_PTR(base);
+    volatile uint32_t *stop = SRAM_PTR(end);
+
+    for (; p < stop; p += 4, addr += 16) {
+        uint32_t w0 = p[0], w1 = p[1], w2 = p[2], w3 = p[3];
+        uint32_t e0 = (addr & mask) ^ x;
+
+        if ((w0 ^ e0) | (w1 ^ e0 ^ (4 & mask)) |
+            (w2 ^ e0 ^ (8 & mask)) | (w3 ^ e0 ^ (12 & mask))) {
+            for (int i = 0; i < 4; i++) {
+                uint32_t want = ((addr + i * 4) & mask) ^ x;
+                uint32_t got = p[i];
+                if (got != want) {
+                    record(addr + i * 4, want, got);
+                }
+            }
+        }
+    }
+}
+
+FAST static void check_all(uint32_t mask, uint32_t x) {
+    check(0, BOOTROM_BASE, 0, mask, x);
+    check(SHADOW_COPY, SRAM_SIZE, SHADOW_COPY, mask, x);
+
+    // The SRAM under the boot ROM, through a DMA copy over the checked
+    // words after it (only the engine can read it)
+    if (!use_dma) {
+        return;
+    }
+    spad_dma(0, BOOTROM_BASE, SHADOW_COPY, BOOTROM_SIZE, 0);
+    spad_dcache(CACHE_DCACHE_INV);
+    check(SHADOW_COPY, SHADOW_COPY + BOOTROM_SIZE, BOOTROM_BASE, mask, x);
+}
+
+FAST static void pattern_fill(uint32_t value) {
+    if (use_dma) {
+        spad_dma(MEM_DMA_FILL_MODE, 0, 0, SRAM_SIZE, value);
+    } else {
+        for (volatile uint32_t *p = SRAM_PTR(0); p < SRAM_PTR(SRAM_SIZE); p += 4) {
+            p[0] = value;
+            p[1] = value;
+            p[2] = value;
+            p[3] = value;
+        }
+        spad_dcache(CACHE_DCACHE_CLEAN);
+    }
+    spad_dcache(CACHE_DCACHE_INV);
+    check_all(0, value);
+}
+
+FAST static void pattern_address(uint32_t x) {
+    for (uint32_t a = 0; a < SRAM_SIZE; a += 16) {
+        volatile uint32_t *p = SRAM_PTR(a);
+        p[0] = a ^ x;
+        p[1] = (a + 4) ^ x;
+        p[2] = (a + 8) ^ x;
+        p[3] = (a + 12) ^ x;
+    }
+    spad_dcache(CACHE_DCACHE_CLEAN);
+    spad_dcache(CACHE_DCACHE_INV);
+    check_all(~0u, x);
+}
+
+//==============================================================================
+// Passes
+//==============================================================================
+
+FAST __attribute__((noreturn)) static void burnin_main(void) {
+    spad_dcache(CACHE_DCACHE_INV);      // Dirty lines of main() must not land later
+
+    for (uint32_t pass = 1; ; pass++) {
+        uint32_t logged = err_count < BURNIN_LOG ? err_count : BURNIN_LOG;
+        uint32_t seed = pass * 0x9E3779B9;
+        uint32_t t0 = spad_rdcycle();
+
+        pattern_fill(0x00000000);
+        pattern_fill(0xFFFFFFFF);
+        pattern_fill(0xAAAAAAAA);
+        pattern_fill(0x55555555);
+        pattern_address(seed);
+        pattern_address(~seed);
+
+        uint32_t ms = (spad_rdcycle() - t0) / (uint32_t)(PERF_CPU_HZ / 1000);
+        uint32_t kb = BURNIN_PATTERNS * (SRAM_SIZE / 1024);
+        uint32_t mbs10 = (kb * 1000 / (ms ? ms : 1)) * 10 / 1024;
+
+        spad_puts(s_pass);
+        spad_putdec(pass);
+        spad_puts(s_tested);
+        spad_putdec(kb);
+        spad_puts(s_kb_in);
+        spad_putdec(ms);
+        spad_puts(s_ms);
+        spad_putdec(mbs10 / 10);
+        spad_putc('.');
+        spad_putdec(mbs10 % 10);
+        spad_puts(s_mbs);
+        spad_putdec(err_count);
+        if (err_count) {
+            spad_puts(s_bits);
+            spad_puthex(err_bits);
+            spad_putc(')');
+        }
+        spad_puts(s_crlf);
+
+        for (; logged < err_count && logged < BURNIN_LOG; logged++) {
+            spad_puts(s_addr);
+            spad_puthex(err_log[logged].addr);
+            spad_puts(s_want);
+            spad_puthex(err_log[logged].expect);
+            spad_puts(s_read);
+            spad_puthex(err_log[logged].got);
+            spad_puts(s_crlf);
+        }
+
+        if (UART_RX_STATUS & 0x01) {
+            (void)UART_RX_DATA;
+            spad_puts(s_bootrom);
+            ((void (*)(void))BOOTROM_BASE)();
+        }
+    }
+}
+
+// Move the stack into the scratchpad and never come back to SRAM
+FAST __attribute__((noreturn)) static void burnin_start(void) {
+    __asm__ volatile ("mv sp, %0\n\tjr %1"
+                      : : "r"(burnin_stack + BURNIN_STACK), "r"(burnin_main));
+    __builtin_unreachable();
+}
+
+//==============================================================================
+// Main (SRAM: banner and start key only)
+//==============================================================================
+
+static int getch(void) {
+    while (!(UART_RX_STATUS & 0x01));
+    return UART_RX_DATA & 0xFF;
+}
+
+int main(void) {
+    printf("\r\n=== Full-SRAM Burn-in Test ===\r\n");
+    printf("0x00000000-0x%08lX, %d patterns per pass, run from the scratchpad\r\n",
+           (unsigned long)(SRAM_SIZE - 1), BURNIN_PATTERNS);
+    use_dma = dma_present();
+    printf("Fills: %s\r\n", use_dma ? "DMA engine" : "CPU stores (no DMA engine in this bitstream)");
+    printf("\r\nThis overwrites all of SRAM, this program included. A key during\r\n");
+    printf("the test returns to the boot ROM; upload the next firmware from there.\r\n");
+    printf("Press any key to start...\r\n");
+    getch();
+
+    irq_setmask(~0u);                   // Handlers are in SRAM
+    burnin_start();
+}
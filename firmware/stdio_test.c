@@ -1,6 +1,7 @@
 //===============================================================================
 // Standard I/O Test - printf/scanf via UART
-// Tests syscalls implementation with C standard library
+// Tests syscalls implementation with C standard library: UART and SD card
+// (fopen through sd_fatfs/fatfs_stdio.c) throughput, non-blocking stdin
 //
 // Copyright (c) October 2025 Michael Wolak
 // Email: mikewolak@gmail.com, mike@epromfoundry.com
@@ -8,6 +9,115 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "ff.h"
+#include "fatfs_stdio.h"
+#include "../lib/perf_counters.h"
+
+#define SD_FILE     "STDIO.BIN"
+#define SD_SIZE     (64 * 1024)
+#define CHUNK       4096
+
+static FATFS fs;
+static char buf[CHUNK] __attribute__((aligned(4)));
+
+static void report(const char *what, uint32_t bytes, uint32_t cycles) {
+    uint32_t us = (uint32_t)((uint64_t)cycles * 1000000 / PERF_CPU_HZ);
+    uint32_t kbs = us ? (uint32_t)((uint64_t)bytes * 1000000 / 1024 / us) : 0;
+
+    printf("  %-24s %6lu bytes %8lu us %6lu KB/s\n\r", what,
+           (unsigned long)bytes, (unsigned long)us, (unsigned long)kbs);
+}
+
+static void test_uart_throughput(void) {
+    uint32_t t0, t1;
+
+    for (int i = 0; i < CHUNK; i++)
+        buf[i] = (i % 64 == 63) ? '\n' : ' ' + i % 64;
+
+    printf("UART throughput (fwrite to stdout, %d bytes):\n\r", CHUNK);
+    fflush(stdout);
+    t0 = rdcycle();
+    fwrite(buf, 1, CHUNK, stdout);
+    fflush(stdout);
+    t1 = rdcycle();
+    printf("\n\r");
+    report("UART fwrite", CHUNK, t1 - t0);
+    printf("\n\r");
+}
+
+static void test_sd_throughput(void) {
+    FILE *f;
+    uint32_t t0, t1, n = 0, bad = 0;
+
+    printf("SD card throughput (fopen/fwrite/fread, %s):\n\r", SD_FILE);
+    fatfs_stdio_init();
+    FRESULT fr = f_mount(&fs, "", 1);
+    if (fr != FR_OK) {
+        printf("  No card or FAT filesystem (f_mount %d), skipped\n\r\n\r", fr);
+        return;
+    }
+
+    f = fopen(SD_FILE, "wb");
+    if (!f) {
+        printf("  fopen(\"%s\", \"wb\") failed, errno %d\n\r\n\r", SD_FILE, errno);
+        return;
+    }
+    t0 = rdcycle();
+    for (uint32_t off = 0; off < SD_SIZE; off += CHUNK) {
+        for (int i = 0; i < CHUNK; i += 4)
+            *(uint32_t *)&buf[i] = off + i;
+        n += fwrite(buf, 1, CHUNK, f);
+    }
+    fclose(f);
+    t1 = rdcycle();
+    report("fwrite 4 KB + fclose", n, t1 - t0);
+
+    f = fopen(SD_FILE, "rb");
+    n = 0;
+    t0 = rdcycle();
+    if (f) {
+        size_t got;
+        while ((got = fread(buf, 1, CHUNK, f)) > 0) {
+            for (size_t i = 0; i + 4 <= got; i += 4)
+                bad += *(uint32_t *)&buf[i] != n + i;
+            n += got;
+        }
+    }
+    t1 = rdcycle();
+    report("fread 4 KB", n, t1 - t0);
+
+    // Byte at a time through the stdio buffer
+    n = 0;
+    if (f) {
+        rewind(f);
+        t0 = rdcycle();
+        while (n < CHUNK * 4 && fgetc(f) != EOF)
+            n++;
+        t1 = rdcycle();
+        report("fgetc", n, t1 - t0);
+        fclose(f);
+    }
+
+    printf("  Data check: %s\n\r\n\r", (bad || n == 0) ? "FAILED" : "OK");
+    f_unlink(SD_FILE);
+}
+
+static void test_nonblocking(void) {
+    char c;
+    int n;
+
+    printf("Non-blocking stdin (fcntl O_NONBLOCK):\n\r");
+    fcntl(0, F_SETFL, O_NONBLOCK);
+    while (read(0, &c, 1) == 1)
+        ;                               // Drop pending input
+    n = read(0, &c, 1);
+    printf("  read() with no key: %d, errno %s\n\r\n\r", n,
+           (n < 0 && errno == EAGAIN) ? "EAGAIN (OK)" : "unexpected");
+    fcntl(0, F_SETFL, 0);
+}
 
 int main(void) {
     char name[32];
@@ -26,6 +136,10 @@ int main(void) {
     printf("  Character: %c\n\r", 'A');
     printf("\n\r");
 
+    test_uart_throughput();
+    test_sd_throughput();
+    test_nonblocking();
+
     // Test scanf
     printf("Enter your name: ");
     scanf("%s", name);
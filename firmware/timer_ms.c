@@ -33,12 +33,19 @@ static inline void irq_enable(void) {
 // Global millisecond counter (wraps every ~49 days)
 volatile uint32_t millis_counter = 0;
 
+#ifndef SYS_CLK_HZ
+#define SYS_CLK_HZ 50000000
+#endif
+
+// Rounded so non-integer-MHz clocks (65.97 MHz) stay within 0.1%
+#define TIMER_PSC_1MHZ  ((SYS_CLK_HZ + 500000) / 1000000 - 1)
+
 //==============================================================================
 // Initialize millisecond timer
 //
 // Configures timer for 1 kHz (1ms period) interrupts
-// System clock: 50 MHz
-// Prescaler: 49 (divide by 50) → 1 MHz tick rate
+// System clock: SYS_CLK_HZ (Kconfig, 50 MHz default)
+// Prescaler: SYS_CLK_HZ / 1 MHz (49 at 50 MHz) → 1 MHz tick rate
 // Auto-reload: 999 → 1,000,000 / 1000 = 1000 Hz = 1ms period
 //==============================================================================
 void timer_ms_init(void) {
@@ -49,7 +56,7 @@ void timer_ms_init(void) {
     TIMER_SR = TIMER_SR_UIF;
 
     // Configure for 1 kHz (1ms)
-    TIMER_PSC = 49;   // Prescaler: 50 MHz / 50 = 1 MHz
+    TIMER_PSC = TIMER_PSC_1MHZ;   // Prescaler: SYS_CLK_HZ / (PSC+1) = 1 MHz
     TIMER_ARR = 999;  // Auto-reload: 1 MHz / 1000 = 1 kHz
 
     // Reset counter
@@ -0,0 +1,110 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// atomic_unit.v - Atomic Read-Modify-Write Words (MMIO)
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+// PURPOSE: PicoRV32 is built without the A extension. This block holds
+//          eight 32-bit words whose read-modify-write operations complete
+//          inside one bus transaction, so an interrupt or a FreeRTOS task
+//          switch can never land between the read and the write: locks,
+//          counters and event bits shared by ISRs and tasks need no IRQ
+//          masking (lib/atomic.h).
+//
+// The operation is chosen by the address window, the word by addr[4:2]:
+// loads that modify return the value from before the change, stores that
+// modify combine wdata with the word. Every access is answered in its own
+// cycle, like crc32_accel.v. Operations that need two operands (compare-
+// and-swap) cannot be made atomic this way without a CPU change; lib/
+// atomic.h does those with a short IRQ mask.
+//==============================================================================
+
+module atomic_unit (
+    input wire clk,
+    input wire resetn,
+
+    // MMIO Interface
+    input wire        mmio_valid,
+    input wire        mmio_write,
+    input wire [31:0] mmio_addr,
+    input wire [31:0] mmio_wdata,
+    input wire [ 3:0] mmio_wstrb,
+    output reg [31:0] mmio_rdata,
+    output wire       mmio_ready
+);
+
+    // =========================================================================
+    // Register Map
+    // Base: 0x80000300, word n at +4n in every window (n = 0-7)
+    // =========================================================================
+    // +0x00: WORD  (RW) - R: value             W: value = wdata
+    // +0x20: TAS   (RW) - R: old, value = 1    W: value = wdata (0 releases)
+    // +0x40: INC   (R)  - R: old, value + 1
+    // +0x60: DEC   (R)  - R: old, value - 1
+    // +0x80: ADD   (RW) - R: value             W: value + wdata
+    // +0xA0: BITS  (RW) - R: old, value = 0    W: value | wdata
+    // +0xC0: CLR   (RW) - R: value             W: value & ~wdata
+    // +0xE0: ID    (R)  - [31]=present, [7:0]=number of words
+    // Byte and halfword stores are ignored: every operation is on the word.
+    // =========================================================================
+
+    localparam OP_WORD = 3'd0;
+    localparam OP_TAS  = 3'd1;
+    localparam OP_INC  = 3'd2;
+    localparam OP_DEC  = 3'd3;
+    localparam OP_ADD  = 3'd4;
+    localparam OP_BITS = 3'd5;
+    localparam OP_CLR  = 3'd6;
+    localparam OP_ID   = 3'd7;
+
+    localparam WORDS = 8;
+
+    // MMIO ready - combinational response (same cycle)
+    assign mmio_ready = mmio_valid;
+
+    reg [31:0] word [0:WORDS-1];
+
+    wire [2:0]  op  = mmio_addr[7:5];
+    wire [2:0]  sel = mmio_addr[4:2];
+    wire [31:0] cur = word[sel];
+
+    integer i;
+
+    // mmio_valid is a one-cycle strobe (mem_controller.v): one change per access
+    always @(posedge clk or negedge resetn) begin
+        if (!resetn) begin
+            for (i = 0; i < WORDS; i = i + 1)
+                word[i] <= 32'h0;
+        end else if (mmio_valid && mmio_write) begin
+            if (mmio_wstrb == 4'hF) begin
+                case (op)
+                    OP_WORD, OP_TAS: word[sel] <= mmio_wdata;
+                    OP_ADD:          word[sel] <= cur + mmio_wdata;
+                    OP_BITS:         word[sel] <= cur | mmio_wdata;
+                    OP_CLR:          word[sel] <= cur & ~mmio_wdata;
+                    default: ;
+                endcase
+            end
+        end else if (mmio_valid) begin
+            case (op)
+                OP_TAS:  word[sel] <= 32'h1;
+                OP_INC:  word[sel] <= cur + 32'h1;
+                OP_DEC:  word[sel] <= cur - 32'h1;
+                OP_BITS: word[sel] <= 32'h0;
+                default: ;
+            endcase
+        end
+    end
+
+    always @(*) begin
+        if (op == OP_ID)
+            mmio_rdata = 32'h80000000 | WORDS;
+        else
+            mmio_rdata = cur;
+    end
+
+endmodule
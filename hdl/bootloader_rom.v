@@ -46,9 +46,15 @@ module bootloader_rom (
     // The Makefile creates a symlink bootloader.hex.selected -> chosen bootloader
     // Yosys supports $readmemh for BRAM initialization
     initial begin
+`ifdef BOOTROM_SEED
+        // make bootrom-base: random contents icebram can find and replace
+        // (scripts/bootrom_swap.sh)
+        $readmemh("build/bootrom_seed.hex", memory);
+`else
         // Load selected bootloader for both simulation and synthesis
         // The symlink bootloader.hex.selected points to the active bootloader
         $readmemh("bootloader/bootloader.hex.selected", memory);
+`endif
         `ifdef SIMULATION
             $display("[BOOTROM] Loaded bootloader.hex.selected for simulation");
         `endif
@@ -0,0 +1,135 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// button_debounce.v - Debounced BUT1/BUT2 with Press/Release Events
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+// PURPOSE: Debounce the two user buttons in hardware and latch their edges,
+//          so the UI sleeps on IRQ[6] instead of polling BUTTON_INPUT and
+//          timing its own debounce (lib/button.h).
+//
+// Each button has its own window counter, clocked by a shared 1 us tick.
+// The debounced state follows the synchronised input only once the input
+// has differed from it for DEBOUNCE microseconds without a break: a bounce
+// restarts the count, so the state changes exactly DEBOUNCE us after the
+// contacts settle. Each change sets its press or release bit in EVENTS and,
+// if that bit is enabled in IRQ_EN, pulses irq for one clock (the interrupt
+// controller latches it). After reset only the presses interrupt, as the
+// raw edge detector this replaces did.
+//==============================================================================
+
+module button_debounce #(
+    parameter CLK_HZ = 50_000_000
+) (
+    input wire clk,
+    input wire resetn,
+
+    // MMIO Interface
+    input wire        mmio_valid,
+    input wire        mmio_write,
+    input wire [31:0] mmio_addr,
+    input wire [31:0] mmio_wdata,
+    input wire [ 3:0] mmio_wstrb,
+    output reg [31:0] mmio_rdata,
+    output wire       mmio_ready,
+
+    input wire  [1:0] buttons,      // Synchronised, active high
+    output wire       irq           // One clock per new enabled event
+);
+
+    // =========================================================================
+    // Register Map
+    // Base: 0x80000270
+    // =========================================================================
+    // +0x00: STATE    (R)  - [1:0]=debounced BUT2/BUT1, [9:8]=raw BUT2/BUT1,
+    //                        [31]=present
+    // +0x04: EVENTS   (R)  - [1:0]=BUT2/BUT1 pressed, [3:2]=BUT2/BUT1 released
+    //                 (W)  - Write 1 to clear
+    // +0x08: IRQ_EN   (RW) - [3:0]=EVENTS bits that pulse irq (reset 0x3)
+    // +0x0C: DEBOUNCE (RW) - [15:0]=window in microseconds (reset 10000);
+    //                        0 follows the input on the next tick
+    // =========================================================================
+
+    localparam ADDR_STATE    = 2'h0;
+    localparam ADDR_EVENTS   = 2'h1;
+    localparam ADDR_IRQ_EN   = 2'h2;
+    localparam ADDR_DEBOUNCE = 2'h3;
+
+    reg  [1:0] state;
+    reg  [3:0] events;
+    reg  [3:0] irq_en;
+    reg [15:0] window;
+    reg [15:0] count [0:1];
+    reg        irq_pulse;
+
+    reg [26:0] phase;               // Fractional microsecond (units of 1/CLK_HZ s)
+
+    wire [27:0] phase_next = phase + 28'd1_000_000;
+    wire        us_tick    = (phase_next >= CLK_HZ);
+
+    wire [1:0] reg_sel = mmio_addr[3:2];
+    wire       wr      = mmio_valid && mmio_write && (mmio_wstrb == 4'hF);
+
+    // A button whose input has differed from its state for the full window
+    wire [1:0] settle;
+    assign settle[0] = (buttons[0] != state[0]) && us_tick && (count[0] >= window);
+    assign settle[1] = (buttons[1] != state[1]) && us_tick && (count[1] >= window);
+
+    wire [3:0] new_events = {settle & state, settle & ~state};
+
+    // MMIO ready - combinational response (same cycle)
+    assign mmio_ready = mmio_valid;
+
+    assign irq = irq_pulse;
+
+    integer i;
+
+    always @(posedge clk) begin
+        if (!resetn) begin
+            state <= 2'b00;
+            events <= 4'h0;
+            irq_en <= 4'h3;
+            window <= 16'd10000;
+            count[0] <= 16'd0;
+            count[1] <= 16'd0;
+            irq_pulse <= 1'b0;
+            phase <= 27'h0;
+        end else begin
+            phase <= us_tick ? phase_next - CLK_HZ : phase_next[26:0];
+
+            for (i = 0; i < 2; i = i + 1) begin
+                if (buttons[i] == state[i] || settle[i])
+                    count[i] <= 16'd0;
+                else if (us_tick && count[i] != 16'hFFFF)
+                    count[i] <= count[i] + 1'b1;
+            end
+            state <= state ^ settle;
+
+            irq_pulse <= |(new_events & ~events & irq_en);
+
+            if (wr && reg_sel == ADDR_EVENTS)
+                events <= (events & ~mmio_wdata[3:0]) | new_events;
+            else
+                events <= events | new_events;
+            if (wr && reg_sel == ADDR_IRQ_EN)
+                irq_en <= mmio_wdata[3:0];
+            if (wr && reg_sel == ADDR_DEBOUNCE)
+                window <= mmio_wdata[15:0];
+        end
+    end
+
+    always @(*) begin
+        case (reg_sel)
+            ADDR_STATE:    mmio_rdata = {1'b1, 21'h0, buttons, 6'h0, state};
+            ADDR_EVENTS:   mmio_rdata = {28'h0, events};
+            ADDR_IRQ_EN:   mmio_rdata = {28'h0, irq_en};
+            ADDR_DEBOUNCE: mmio_rdata = {16'h0, window};
+            default:       mmio_rdata = 32'h0;
+        endcase
+    end
+
+endmodule
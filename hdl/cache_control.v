@@ -0,0 +1,105 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// cache_control.v - Cache Maintenance MMIO Registers
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+
+module cache_control #(
+    parameter ICACHE_BYTES = 0,         // 0 = no instruction cache present
+    parameter DCACHE_BYTES = 0          // 0 = no data cache present
+) (
+    input wire clk,
+    input wire resetn,
+
+    // MMIO Interface
+    input wire        mmio_valid,
+    input wire        mmio_write,
+    input wire [31:0] mmio_addr,
+    input wire [31:0] mmio_wdata,
+    input wire [ 3:0] mmio_wstrb,
+    output reg [31:0] mmio_rdata,
+    output wire       mmio_ready,
+
+    // Instruction cache
+    output reg        icache_flush,     // Single-cycle pulse
+    input wire        icache_busy,
+
+    // Data cache range maintenance
+    output reg        dcache_op_start,  // Single-cycle pulse
+    output reg        dcache_op_clean,
+    output reg        dcache_op_inval,
+    output reg [31:0] dcache_op_addr,
+    output reg [31:0] dcache_op_len,
+    input wire        dcache_busy
+);
+
+    // =========================================================================
+    // Register Map
+    // Base: 0x80000060
+    // =========================================================================
+    // +0x00: CTRL   (W) - [0]=I-cache invalidate all
+    //                     [1]=D-cache clean range (write back dirty lines)
+    //                     [2]=D-cache invalidate range (write back + drop)
+    //               (R) - [0]=I-cache busy, [1]=D-cache busy
+    // +0x04: INFO   (R) - [15:0]=I-cache bytes, [31:16]=D-cache bytes
+    // +0x08: DADDR  (RW)- D-cache range start address
+    // +0x0C: DLEN   (RW)- D-cache range length in bytes
+    // =========================================================================
+
+    localparam ADDR_CTRL  = 4'h0;
+    localparam ADDR_INFO  = 4'h4;
+    localparam ADDR_DADDR = 4'h8;
+    localparam ADDR_DLEN  = 4'hC;
+
+    localparam [15:0] ICACHE_SIZE = ICACHE_BYTES;
+    localparam [15:0] DCACHE_SIZE = DCACHE_BYTES;
+
+    // MMIO ready - combinational response (same cycle)
+    assign mmio_ready = mmio_valid;
+
+    always @(posedge clk) begin
+        if (!resetn) begin
+            icache_flush <= 1'b0;
+            dcache_op_start <= 1'b0;
+            dcache_op_clean <= 1'b0;
+            dcache_op_inval <= 1'b0;
+            dcache_op_addr <= 32'h0;
+            dcache_op_len <= 32'h0;
+        end else begin
+            icache_flush <= 1'b0;     // Single-cycle pulses
+            dcache_op_start <= 1'b0;
+
+            if (mmio_valid && mmio_write) begin
+                case (mmio_addr[3:0])
+                    ADDR_CTRL: begin
+                        if (mmio_wstrb[0]) begin
+                            icache_flush <= mmio_wdata[0];
+                            dcache_op_clean <= mmio_wdata[1];
+                            dcache_op_inval <= mmio_wdata[2];
+                            dcache_op_start <= mmio_wdata[1] | mmio_wdata[2];
+                        end
+                    end
+                    ADDR_DADDR: dcache_op_addr <= mmio_wdata;
+                    ADDR_DLEN:  dcache_op_len <= mmio_wdata;
+                    default: ;
+                endcase
+            end
+        end
+    end
+
+    always @(*) begin
+        case (mmio_addr[3:0])
+            ADDR_CTRL:  mmio_rdata = {30'h0, dcache_busy, icache_busy};
+            ADDR_INFO:  mmio_rdata = {DCACHE_SIZE, ICACHE_SIZE};
+            ADDR_DADDR: mmio_rdata = dcache_op_addr;
+            ADDR_DLEN:  mmio_rdata = dcache_op_len;
+            default:    mmio_rdata = 32'h0;
+        endcase
+    end
+
+endmodule
@@ -1,14 +1,14 @@
-//==============================================================================
-// Olimex iCE40HX8K-EVB RISC-V Platform
-// circular_buffer.v - Circular Buffer for UART FIFOs
-//
-// Copyright (c) October 2025 Michael Wolak
-// Email: mikewolak@gmail.com, mike@epromfoundry.com
-//
-// NOT FOR COMMERCIAL USE
-// Educational and research purposes only
-//==============================================================================
-
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// circular_buffer.v - Circular Buffer for UART FIFOs
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+
 module circular_buffer #(
     parameter DATA_WIDTH = 8,
     parameter ADDR_BITS = 3
@@ -21,13 +21,14 @@ module circular_buffer #(
     output wire full,
     input wire rd_en,
     output wire [DATA_WIDTH-1:0] rd_data,
-    output wire empty
+    output wire empty,
+    output wire [ADDR_BITS:0] level     // Entries stored
 );
 
     localparam DEPTH = 1 << ADDR_BITS;
     localparam COUNT_BITS = ADDR_BITS + 1;
 
-    reg [DATA_WIDTH-1:0] memory [0:DEPTH-1];
+    (* ram_style = "block" *) reg [DATA_WIDTH-1:0] memory [0:DEPTH-1];
     reg [ADDR_BITS-1:0] wr_ptr;
     reg [ADDR_BITS-1:0] rd_ptr;
     reg [COUNT_BITS-1:0] count;
@@ -35,22 +36,31 @@ module circular_buffer #(
 
     assign full = (count == DEPTH);
     assign empty = (count == 0);
+    assign level = count;
     assign rd_data = rd_data_reg;  // Drive from register instead of combinational
 
+    wire do_wr = wr_en & ~full;
+    wire do_rd = rd_en & ~empty;
+
+    // Storage kept out of the reset logic so it maps to EBR
+    always @(posedge clk) begin
+        if (do_wr)
+            memory[wr_ptr] <= wr_data;
+
+        // Always keep rd_data_reg updated with current read pointer location
+        // This ensures data is ready when rd_en asserts (one cycle after
+        // rd_ptr moves or the first byte is written)
+        rd_data_reg <= memory[rd_ptr];
+    end
+
     always @(posedge clk) begin
         if (!reset_n || clear) begin
             wr_ptr <= 0;
             rd_ptr <= 0;
             count <= 0;
-            rd_data_reg <= 0;
         end else begin
-            // Always keep rd_data_reg updated with current read pointer location
-            // This ensures data is ready when rd_en asserts
-            rd_data_reg <= memory[rd_ptr];
-
-            case ({wr_en & ~full, rd_en & ~empty})
+            case ({do_wr, do_rd})
                 2'b10: begin // Write only
-                    memory[wr_ptr] <= wr_data;
                     wr_ptr <= wr_ptr + 1;
                     count <= count + 1;
                 end
@@ -59,7 +69,6 @@ module circular_buffer #(
                     count <= count - 1;
                 end
                 2'b11: begin // Read and write
-                    memory[wr_ptr] <= wr_data;
                     wr_ptr <= wr_ptr + 1;
                     rd_ptr <= rd_ptr + 1;
                 end
@@ -70,4 +79,4 @@ module circular_buffer #(
         end
     end
 
-endmodule
+endmodule
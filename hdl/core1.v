@@ -0,0 +1,170 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// core1.v - Second PicoRV32 Core with Local Scratchpad (Kconfig DUAL_CORE)
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+// PURPOSE: A small RV32I core for offloaded work next to the main CPU. It
+//          is held in reset until core 0 sets the mailbox run bit, then
+//          starts at RESET_ADDR in SRAM, where core 0 has copied its image
+//          (firmware/core1/). No MUL/DIV, caches, counters or RV32C: the
+//          core is the smallest PicoRV32 that runs C.
+//
+// Memory map as core 1 sees it:
+//   0x00000000 - 0x0007FFFF : SRAM, shared, through mem_controller's c1 port
+//   0x00080000 - 0x00081FFF : Local scratchpad (SPAD_BYTES, aliased in the
+//                             window): stack and hot data, private to core 1
+//   0x80000260 - 0x8000026F : Mailbox port 1 (local)
+//   0x80000000 - 0x800003FF : Other MMIO, shared, through mem_controller
+//
+// The scratchpad and the mailbox answer without the shared bus, so core 1
+// running out of its scratchpad, or polling the mailbox, costs core 0
+// nothing. SRAM and MMIO accesses take turns with core 0 and DMA in
+// mem_controller.
+//==============================================================================
+
+`default_nettype none
+
+module core1 #(
+    parameter RESET_ADDR = 32'h00060000,
+    parameter SPAD_BYTES = 2048
+) (
+    input wire clk,
+    input wire resetn,                  // Low while the mailbox run bit is 0
+
+    input wire irq_mailbox,             // IRQ[0]: message for core 1
+
+    // Mailbox port 1
+    output wire        mbox_valid,
+    output wire        mbox_write,
+    output wire [31:0] mbox_addr,
+    output wire [31:0] mbox_wdata,
+    output wire [ 3:0] mbox_wstrb,
+    input wire  [31:0] mbox_rdata,
+    input wire         mbox_ready,
+
+    // Shared bus: mem_controller c1 port (SRAM, MMIO)
+    output wire        c1_valid,
+    input wire         c1_ready,
+    output wire [31:0] c1_addr,
+    output wire [31:0] c1_wdata,
+    output wire [ 3:0] c1_wstrb,
+    input wire  [31:0] c1_rdata
+);
+
+    wire        mem_valid;
+    wire        mem_ready;
+    wire [31:0] mem_addr;
+    wire [31:0] mem_wdata;
+    wire [ 3:0] mem_wstrb;
+    wire [31:0] mem_rdata;
+
+    picorv32 #(
+        .ENABLE_COUNTERS(0),
+        .ENABLE_COUNTERS64(0),
+        .ENABLE_REGS_16_31(1),
+        .ENABLE_REGS_DUALPORT(0),       // One regfile EBR pair
+        .LATCHED_MEM_RDATA(0),
+        .TWO_STAGE_SHIFT(1),
+        .BARREL_SHIFTER(0),
+        .TWO_CYCLE_COMPARE(0),
+        .TWO_CYCLE_ALU(0),
+        .COMPRESSED_ISA(0),
+        .CATCH_MISALIGN(0),
+        .CATCH_ILLINSN(0),
+        .ENABLE_PCPI(0),
+        .ENABLE_MUL(0),
+        .ENABLE_FAST_MUL(0),
+        .ENABLE_DIV(0),
+        .ENABLE_IRQ(1),
+        .ENABLE_IRQ_QREGS(1),
+        .ENABLE_IRQ_TIMER(0),
+        .ENABLE_TRACE(0),
+        .REGS_INIT_ZERO(1),
+        .MASKED_IRQ(32'hfffffffe),      // Only IRQ[0] exists
+        .LATCHED_IRQ(32'hffffffff),
+        .PROGADDR_RESET(RESET_ADDR),
+        .PROGADDR_IRQ(RESET_ADDR + 32'h10),  // Same layout as start.S
+        .STACKADDR(32'h00080000 + SPAD_BYTES)
+    ) cpu (
+        .clk(clk),
+        .resetn(resetn),
+        .trap(),
+
+        .mem_valid(mem_valid),
+        .mem_instr(),
+        .mem_ready(mem_ready),
+        .mem_addr(mem_addr),
+        .mem_wdata(mem_wdata),
+        .mem_wstrb(mem_wstrb),
+        .mem_rdata(mem_rdata),
+
+        .mem_la_read(),
+        .mem_la_write(),
+        .mem_la_addr(),
+        .mem_la_wdata(),
+        .mem_la_wstrb(),
+
+        .pcpi_valid(),
+        .pcpi_insn(),
+        .pcpi_rs1(),
+        .pcpi_rs2(),
+        .pcpi_wr(1'b0),
+        .pcpi_rd(32'h0),
+        .pcpi_wait(1'b0),
+        .pcpi_ready(1'b0),
+
+        .irq({31'h0, irq_mailbox}),
+        .eoi()
+    );
+
+    // Local address decode
+    wire is_spad = (mem_addr[31:13] == 19'h00040);      // 0x00080000-0x00081FFF
+    wire is_mbox = (mem_addr[31:4] == 28'h8000026);     // 0x80000260-0x8000026F
+
+    // Scratchpad: address sampled and store written on the accepting edge,
+    // answered from the BRAM output one cycle later (as mem_controller's
+    // STATE_SPAD)
+    reg  spad_ack;
+    wire spad_accept = mem_valid && is_spad && !spad_ack;
+    wire [31:0] spad_rdata;
+
+    always @(posedge clk) begin
+        spad_ack <= resetn && spad_accept;
+    end
+
+    scratchpad_ram #(
+        .BYTES(SPAD_BYTES)
+    ) spad_ram (
+        .clk(clk),
+        .addr(mem_addr[12:0]),
+        .we(spad_accept ? mem_wstrb : 4'h0),
+        .wdata(mem_wdata),
+        .rdata(spad_rdata)
+    );
+
+    // Mailbox: answers in the same cycle; PicoRV32 drops mem_valid after
+    // ready, so the strobe lasts one cycle
+    assign mbox_valid = mem_valid && is_mbox;
+    assign mbox_write = |mem_wstrb;
+    assign mbox_addr  = mem_addr;
+    assign mbox_wdata = mem_wdata;
+    assign mbox_wstrb = mem_wstrb;
+
+    // Everything else: shared bus
+    assign c1_valid = mem_valid && !is_spad && !is_mbox;
+    assign c1_addr  = mem_addr;
+    assign c1_wdata = mem_wdata;
+    assign c1_wstrb = mem_wstrb;
+
+    assign mem_ready = spad_ack || (mbox_valid && mbox_ready) || c1_ready;
+    assign mem_rdata = is_spad ? spad_rdata :
+                       is_mbox ? mbox_rdata : c1_rdata;
+
+endmodule
+
+`default_nettype wire
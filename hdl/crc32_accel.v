@@ -0,0 +1,95 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// crc32_accel.v - CRC32 (IEEE 802.3) MMIO Accelerator
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+// PURPOSE: Same CRC as crc32_gen.v (polynomial 0xEDB88320 reflected, init and
+//          final XOR 0xFFFFFFFF) for firmware: one store per data word
+//          instead of a table lookup per byte (lib/crc32.h).
+//
+// CRC32_DATA stores update the CRC with every enabled byte lane, lane 0
+// first, so a word store covers four bytes in memory order and sb/sh stores
+// handle unaligned heads and tails. The update completes in the store cycle.
+//==============================================================================
+
+module crc32_accel (
+    input wire clk,
+    input wire resetn,
+
+    // MMIO Interface
+    input wire        mmio_valid,
+    input wire        mmio_write,
+    input wire [31:0] mmio_addr,
+    input wire [31:0] mmio_wdata,
+    input wire [ 3:0] mmio_wstrb,
+    output reg [31:0] mmio_rdata,
+    output wire       mmio_ready
+);
+
+    // =========================================================================
+    // Register Map
+    // Base: 0x800000F0
+    // =========================================================================
+    // +0x00: CTRL  (W)  - [0]=init (CRC state = 0xFFFFFFFF, result reads 0)
+    //              (R)  - [31]=present
+    // +0x04: DATA  (W)  - Feed the enabled byte lanes (lane 0 first)
+    // +0x08: VALUE (RW) - R: CRC of the bytes fed so far
+    //                     W: continue from a previous CRC (zlib crc32() style)
+    // =========================================================================
+
+    localparam ADDR_CTRL  = 2'h0;
+    localparam ADDR_DATA  = 2'h1;
+    localparam ADDR_VALUE = 2'h2;
+
+    // MMIO ready - combinational response (same cycle)
+    assign mmio_ready = mmio_valid;
+
+    reg [31:0] crc_state;
+
+    // Reflected CRC32 over one byte, LSB first
+    function [31:0] crc32_byte;
+        input [31:0] crc;
+        input [7:0]  data;
+        integer i;
+        begin
+            crc32_byte = crc ^ {24'h0, data};
+            for (i = 0; i < 8; i = i + 1)
+                crc32_byte = {1'b0, crc32_byte[31:1]} ^
+                             (crc32_byte[0] ? 32'hEDB88320 : 32'h0);
+        end
+    endfunction
+
+    wire [31:0] crc_l0 = mmio_wstrb[0] ? crc32_byte(crc_state, mmio_wdata[ 7: 0]) : crc_state;
+    wire [31:0] crc_l1 = mmio_wstrb[1] ? crc32_byte(crc_l0,    mmio_wdata[15: 8]) : crc_l0;
+    wire [31:0] crc_l2 = mmio_wstrb[2] ? crc32_byte(crc_l1,    mmio_wdata[23:16]) : crc_l1;
+    wire [31:0] crc_l3 = mmio_wstrb[3] ? crc32_byte(crc_l2,    mmio_wdata[31:24]) : crc_l2;
+
+    wire [1:0] reg_sel = mmio_addr[3:2];
+
+    always @(posedge clk or negedge resetn) begin
+        if (!resetn) begin
+            crc_state <= 32'hFFFFFFFF;
+        end else if (mmio_valid && mmio_write) begin
+            case (reg_sel)
+                ADDR_CTRL:  if (mmio_wstrb[0] && mmio_wdata[0]) crc_state <= 32'hFFFFFFFF;
+                ADDR_DATA:  crc_state <= crc_l3;
+                ADDR_VALUE: if (mmio_wstrb == 4'hF) crc_state <= ~mmio_wdata;
+                default: ;
+            endcase
+        end
+    end
+
+    always @(*) begin
+        case (reg_sel)
+            ADDR_CTRL:  mmio_rdata = 32'h80000000;
+            ADDR_VALUE: mmio_rdata = ~crc_state;
+            default:    mmio_rdata = 32'h0;
+        endcase
+    end
+
+endmodule
@@ -13,12 +13,26 @@ module crc32_gen (
     input wire clk,           // Clock
     input wire clr_crc,       // Clear/reset CRC
     input wire [31:0] din,    // 32-bit data input
-    input wire calc,          // Calculate enable
+    input wire calc,          // Calculate enable (din, byte 0 first)
+    input wire calc_byte,     // Calculate over din[7:0] only
     output wire [31:0] crc    // 32-bit CRC output
 );
 
     reg [31:0] crc_reg;
     wire [31:0] m;
+
+    // Reflected CRC32 over one byte, LSB first (as crc32_accel.v)
+    function [31:0] crc32_byte;
+        input [31:0] crc;
+        input [7:0]  data;
+        integer i;
+        begin
+            crc32_byte = crc ^ {24'h0, data};
+            for (i = 0; i < 8; i = i + 1)
+                crc32_byte = {1'b0, crc32_byte[31:1]} ^
+                             (crc32_byte[0] ? 32'hEDB88320 : 32'h0);
+        end
+    endfunction
     
     // XOR input data with current CRC register
     assign m = din ^ crc_reg;
@@ -63,6 +77,9 @@ module crc32_gen (
             crc_reg[29] <= m[29] ^ m[30] ^ m[31] ^ m[23] ^ m[24] ^ m[25] ^ m[22] ^ m[17] ^ m[18] ^ m[13] ^ m[14] ^ m[15] ^ m[7] ^ m[5] ^ m[1] ^ m[0];
             crc_reg[30] <= m[30] ^ m[31] ^ m[24] ^ m[25] ^ m[22] ^ m[20] ^ m[18] ^ m[19] ^ m[14] ^ m[15] ^ m[7] ^ m[4] ^ m[3];
             crc_reg[31] <= m[31] ^ m[25] ^ m[22] ^ m[21] ^ m[19] ^ m[15] ^ m[7] ^ m[6] ^ m[5] ^ m[3] ^ m[2] ^ m[1] ^ m[0];
+        end else if (calc_byte) begin
+            // Odd lengths: a byte at a time, e.g. as it arrives from the UART
+            crc_reg <= crc32_byte(crc_reg, din[7:0]);
         end
     end
     
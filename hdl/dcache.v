@@ -0,0 +1,450 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// dcache.v - Direct-Mapped Write-Back Data Cache for SRAM
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+// PURPOSE: Sits between the I-cache (or PicoRV32) and mem_controller.
+//          Data loads and stores to external SRAM are cached in BRAM with
+//          write-back / write-allocate policy. Byte and halfword stores that
+//          hit merge into the line through per-byte-lane arrays, so they no
+//          longer cost an SRAM read-modify-write.
+//
+// Timing:
+//   Hit:   mem_ready one cycle after mem_valid (loads and stores)
+//   Miss:  write back the victim line if dirty, fill the line with one
+//          sequential SRAM burst, then replay the lookup (hit)
+//
+// Instruction fetches:
+//   Looked up but never allocated - a hit returns the (possibly dirty)
+//   cached copy, a miss reads SRAM directly. This keeps code written by
+//   CPU stores coherent with the I-cache without any software cleaning.
+//   I-cache line bursts (cpu_mem_burst) are streamed from the data array
+//   on a hit (one word per cycle) or forwarded to SRAM as a burst.
+//
+// Maintenance (driven by cache_control.v):
+//   op_start with op_clean / op_inval over [op_addr, op_addr + op_len).
+//   Invalidate always writes dirty lines back first, so it never loses
+//   data outside the requested range; ranges covering the whole cache
+//   walk every line instead of matching tags.
+//==============================================================================
+
+module dcache #(
+    parameter CACHE_BYTES = 2048,       // Total data capacity (power of two)
+    parameter LINE_BYTES  = 16          // Bytes per line (power of two, >= 8)
+) (
+    input wire clk,
+    input wire resetn,
+
+    // Upstream (I-cache / PicoRV32)
+    input wire        cpu_mem_valid,
+    input wire        cpu_mem_instr,
+    output reg        cpu_mem_ready,
+    input wire [31:0] cpu_mem_addr,
+    input wire [31:0] cpu_mem_wdata,
+    input wire [ 3:0] cpu_mem_wstrb,
+    input wire [ 3:0] cpu_mem_burst,    // Line-aligned instruction burst
+    output reg [31:0] cpu_mem_rdata,
+
+    // mem_controller side
+    output reg        mem_valid,
+    output reg        mem_instr,
+    input wire        mem_ready,
+    output reg [31:0] mem_addr,
+    output reg [31:0] mem_wdata,
+    output reg [ 3:0] mem_wstrb,
+    output reg [ 3:0] mem_burst,
+    input wire [31:0] mem_rdata,
+
+    // Maintenance
+    input wire        op_start,         // Pulse: latch op_* and run
+    input wire        op_clean,         // Write back dirty lines
+    input wire        op_inval,         // Write back, then invalidate
+    input wire [31:0] op_addr,          // Range start (byte address)
+    input wire [31:0] op_len,           // Range length in bytes
+    output wire       op_busy,
+
+    // Statistics
+    output wire       stat_hit,         // Pulse: access served from cache
+    output wire       stat_miss         // Pulse: access missed
+);
+
+    //==========================================================================
+    // Geometry
+    //==========================================================================
+    localparam LINES       = CACHE_BYTES / LINE_BYTES;
+    localparam LINE_WORDS  = LINE_BYTES / 4;
+    localparam OFFS_BITS   = $clog2(LINE_BYTES);
+    localparam WORD_BITS   = $clog2(LINE_WORDS);
+    localparam INDEX_BITS  = $clog2(LINES);
+    localparam TAG_BITS    = 19 - OFFS_BITS - INDEX_BITS;  // 512 KB SRAM space
+    localparam LADDR_BITS  = 19 - OFFS_BITS;               // Line address width
+
+    // Boot ROM lives inside the SRAM decode window and is read-only BRAM
+    localparam BOOT_BASE = 32'h00040000;
+    localparam BOOT_END  = 32'h00041FFF;
+
+    // State Machine
+    localparam S_IDLE     = 4'h0;
+    localparam S_LOOKUP   = 4'h1;
+    localparam S_WB       = 4'h2;
+    localparam S_FILL     = 4'h3;
+    localparam S_PASS     = 4'h4;
+    localparam S_CLEAR    = 4'h5;
+    localparam S_OP_READ  = 4'h6;
+    localparam S_OP_CHECK = 4'h7;
+    localparam S_OP_NEXT  = 4'h8;
+    localparam S_BURST    = 4'h9;
+
+    reg [3:0] state;
+
+    //==========================================================================
+    // Address Fields
+    //==========================================================================
+    wire [TAG_BITS-1:0]   cpu_tag   = cpu_mem_addr[18:OFFS_BITS+INDEX_BITS];
+    wire [INDEX_BITS-1:0] cpu_index = cpu_mem_addr[OFFS_BITS+INDEX_BITS-1:OFFS_BITS];
+    wire [WORD_BITS-1:0]  cpu_word  = cpu_mem_addr[OFFS_BITS-1:2];
+
+    wire addr_is_sram = (cpu_mem_addr[31:19] == 13'h0);
+    wire addr_is_boot = (cpu_mem_addr >= BOOT_BASE) && (cpu_mem_addr <= BOOT_END);
+    wire cpu_is_write = |cpu_mem_wstrb;
+    wire cacheable    = addr_is_sram && !addr_is_boot;
+    wire allocate     = cacheable && !cpu_mem_instr;
+
+    //==========================================================================
+    // BRAM Arrays - one array per byte lane so stores merge without RMW
+    //==========================================================================
+    reg [7:0]          data_mem0 [0:LINES*LINE_WORDS-1];
+    reg [7:0]          data_mem1 [0:LINES*LINE_WORDS-1];
+    reg [7:0]          data_mem2 [0:LINES*LINE_WORDS-1];
+    reg [7:0]          data_mem3 [0:LINES*LINE_WORDS-1];
+    reg [TAG_BITS+1:0] tag_mem   [0:LINES-1];        // {valid, dirty, tag}
+
+    reg [31:0]         data_q;
+    reg [TAG_BITS+1:0] tag_q;
+
+    reg [INDEX_BITS+WORD_BITS-1:0] data_raddr;
+    reg [INDEX_BITS-1:0]           tag_raddr;
+    reg [ 3:0]                     data_we;
+    reg [INDEX_BITS+WORD_BITS-1:0] data_waddr;
+    reg [31:0]                     data_wdata;
+    reg                            tag_we;
+    reg [INDEX_BITS-1:0]           tag_waddr;
+    reg [TAG_BITS+1:0]             tag_wdata;
+
+    always @(posedge clk) begin
+        if (data_we[0]) data_mem0[data_waddr] <= data_wdata[ 7: 0];
+        if (data_we[1]) data_mem1[data_waddr] <= data_wdata[15: 8];
+        if (data_we[2]) data_mem2[data_waddr] <= data_wdata[23:16];
+        if (data_we[3]) data_mem3[data_waddr] <= data_wdata[31:24];
+        data_q <= {data_mem3[data_raddr], data_mem2[data_raddr],
+                   data_mem1[data_raddr], data_mem0[data_raddr]};
+    end
+
+    always @(posedge clk) begin
+        if (tag_we)
+            tag_mem[tag_waddr] <= tag_wdata;
+        tag_q <= tag_mem[tag_raddr];
+    end
+
+    wire                q_valid = tag_q[TAG_BITS+1];
+    wire                q_dirty = tag_q[TAG_BITS];
+    wire [TAG_BITS-1:0] q_tag   = tag_q[TAG_BITS-1:0];
+    wire                tag_hit = q_valid && (q_tag == cpu_tag);
+
+    //==========================================================================
+    // Miss / Write-Back / Maintenance Bookkeeping
+    //==========================================================================
+    reg [TAG_BITS-1:0]   line_tag;      // Line being filled
+    reg [INDEX_BITS-1:0] line_index;    // Line being filled / written back
+    reg [TAG_BITS-1:0]   wb_tag;        // Victim tag being written back
+    reg [WORD_BITS-1:0]  xfer_word;     // Word currently transferred
+    reg                  wb_data_ok;    // data_q holds the word at xfer_word
+    reg                  wb_to_op;      // Write-back belongs to a maintenance op
+    reg [3:0]            burst_left;    // Burst words still owed upstream
+    reg [WORD_BITS-1:0]  burst_word;    // Word data_q holds in S_BURST
+
+    reg                  op_pending;
+    reg                  op_do_inval;
+    reg                  op_all;        // Walk all lines, ignore tags
+    reg [LADDR_BITS-1:0] op_line;       // Current line address
+    reg [LADDR_BITS-1:0] op_last;       // Last line address (inclusive)
+    reg                  op_match;
+    reg [TAG_BITS-1:0]   op_match_tag;
+    reg [INDEX_BITS-1:0] clear_index;
+
+    wire [INDEX_BITS-1:0] op_index = op_line[INDEX_BITS-1:0];
+    wire [TAG_BITS-1:0]   op_tag   = op_line[LADDR_BITS-1:INDEX_BITS];
+
+    // Range decode at acceptance time
+    wire [31:0]           req_end     = op_addr + op_len - 1'b1;
+    wire [LADDR_BITS-1:0] req_first   = op_addr[18:OFFS_BITS];
+    wire [LADDR_BITS-1:0] req_last    = req_end[18:OFFS_BITS];
+    wire [31:0]           req_lines   = (req_end[31:OFFS_BITS] - op_addr[31:OFFS_BITS]);
+    wire                  req_all     = (req_lines >= LINES - 1);
+
+    wire xfer_last = (xfer_word == LINE_WORDS - 1);
+
+    assign op_busy   = op_pending || (state == S_OP_READ) || (state == S_OP_CHECK) ||
+                       (state == S_OP_NEXT) || (state == S_WB && wb_to_op);
+    assign stat_hit  = (state == S_LOOKUP) && tag_hit;
+    assign stat_miss = (state == S_LOOKUP) && !tag_hit;
+
+    //==========================================================================
+    // Combinational Bus Routing and Array Ports
+    //==========================================================================
+    always @(*) begin
+        mem_valid     = 1'b0;
+        mem_instr     = cpu_mem_instr;
+        mem_addr      = cpu_mem_addr;
+        mem_wdata     = cpu_mem_wdata;
+        mem_wstrb     = cpu_mem_wstrb;
+        mem_burst     = 4'h0;
+        cpu_mem_ready = 1'b0;
+        cpu_mem_rdata = mem_rdata;
+
+        data_raddr = {cpu_index, cpu_word};
+        tag_raddr  = cpu_index;
+        data_we    = 4'h0;
+        data_waddr = {cpu_index, cpu_word};
+        data_wdata = cpu_mem_wdata;
+        tag_we     = 1'b0;
+        tag_waddr  = cpu_index;
+        tag_wdata  = {TAG_BITS+2{1'b0}};
+
+        case (state)
+            S_IDLE: begin
+                mem_valid = cpu_mem_valid && !cacheable && !op_pending;
+            end
+
+            S_PASS: begin
+                mem_valid     = cpu_mem_valid;
+                mem_burst     = cpu_mem_burst;
+                cpu_mem_ready = mem_ready;
+            end
+
+            S_LOOKUP: begin
+                cpu_mem_rdata = data_q;
+                if (tag_hit) begin
+                    cpu_mem_ready = 1'b1;
+                    if (cpu_is_write) begin
+                        // Store hit: merge bytes, mark line dirty
+                        data_we   = cpu_mem_wstrb;
+                        tag_we    = !q_dirty;
+                        tag_wdata = {1'b1, 1'b1, cpu_tag};
+                    end
+                end
+                // Prepare the next word: victim word 0 for a write-back,
+                // or the second word of an instruction burst hit
+                data_raddr = (tag_hit && cpu_mem_burst != 4'h0) ?
+                             {cpu_index, cpu_word + 1'b1} :
+                             {cpu_index, {WORD_BITS{1'b0}}};
+            end
+
+            S_BURST: begin
+                cpu_mem_ready = 1'b1;
+                cpu_mem_rdata = data_q;
+                data_raddr    = {cpu_index, burst_word + 1'b1};
+            end
+
+            S_WB: begin
+                data_raddr = {line_index, xfer_word};
+                mem_valid  = wb_data_ok;
+                mem_instr  = 1'b0;
+                mem_addr   = {13'h0, wb_tag, line_index, xfer_word, 2'b00};
+                mem_wdata  = data_q;
+                mem_wstrb  = 4'hF;
+            end
+
+            S_FILL: begin
+                mem_valid  = 1'b1;
+                mem_instr  = 1'b0;
+                mem_addr   = {13'h0, line_tag, line_index, {WORD_BITS{1'b0}}, 2'b00};
+                mem_wdata  = 32'h0;
+                mem_wstrb  = 4'h0;
+                mem_burst  = LINE_WORDS - 1;
+
+                data_we    = {4{mem_ready}};
+                data_waddr = {line_index, xfer_word};
+                data_wdata = mem_rdata;
+                if (mem_ready && xfer_last) begin
+                    tag_we    = 1'b1;
+                    tag_waddr = line_index;
+                    tag_wdata = {1'b1, 1'b0, line_tag};
+                end
+            end
+
+            S_CLEAR: begin
+                tag_we    = 1'b1;
+                tag_waddr = clear_index;
+            end
+
+            S_OP_READ, S_OP_CHECK: begin
+                tag_raddr  = op_index;
+                data_raddr = {op_index, {WORD_BITS{1'b0}}};
+            end
+
+            S_OP_NEXT: begin
+                if (op_match) begin
+                    tag_we    = 1'b1;
+                    tag_waddr = op_index;
+                    tag_wdata = op_do_inval ? {TAG_BITS+2{1'b0}} : {1'b1, 1'b0, op_match_tag};
+                end
+            end
+
+            default: ;
+        endcase
+    end
+
+    //==========================================================================
+    // Control State Machine
+    //==========================================================================
+    always @(posedge clk) begin
+        if (!resetn) begin
+            state <= S_CLEAR;               // Invalidate everything out of reset
+            clear_index <= 0;
+            line_tag <= 0;
+            line_index <= 0;
+            wb_tag <= 0;
+            xfer_word <= 0;
+            wb_data_ok <= 1'b0;
+            wb_to_op <= 1'b0;
+            burst_left <= 4'h0;
+            burst_word <= 0;
+            op_pending <= 1'b0;
+            op_do_inval <= 1'b0;
+            op_all <= 1'b0;
+            op_line <= 0;
+            op_last <= 0;
+            op_match <= 1'b0;
+            op_match_tag <= 0;
+        end else begin
+            // Latch maintenance requests (ignore empty ranges)
+            if (op_start && (op_clean || op_inval) && (op_len != 32'h0)) begin
+                op_pending <= 1'b1;
+                op_do_inval <= op_inval;
+                op_all <= req_all;
+                op_line <= req_all ? {LADDR_BITS{1'b0}} : req_first;
+                op_last <= req_all ? (LINES - 1) : req_last;
+            end
+
+            case (state)
+                S_IDLE: begin
+                    if (op_pending) begin
+                        op_pending <= 1'b0;
+                        state <= S_OP_READ;
+                    end else if (cpu_mem_valid) begin
+                        burst_left <= cpu_mem_burst;
+                        if (cacheable)
+                            state <= S_LOOKUP;
+                        else
+                            state <= S_PASS;
+                    end
+                end
+
+                S_PASS: begin
+                    if (mem_ready) begin
+                        burst_left <= burst_left - 1'b1;
+                        if (burst_left == 4'h0)
+                            state <= S_IDLE;
+                    end
+                end
+
+                S_LOOKUP: begin
+                    if (tag_hit && burst_left != 4'h0) begin
+                        // Instruction burst hit: stream the rest of the line
+                        burst_word <= cpu_word + 1'b1;
+                        burst_left <= burst_left - 1'b1;
+                        state <= S_BURST;
+                    end else if (tag_hit) begin
+                        state <= S_IDLE;
+                    end else if (!allocate) begin
+                        // Instruction fetch miss: read SRAM, don't allocate
+                        state <= S_PASS;
+                    end else begin
+                        line_tag <= cpu_tag;
+                        line_index <= cpu_index;
+                        xfer_word <= 0;
+                        if (q_valid && q_dirty) begin
+                            wb_tag <= q_tag;
+                            wb_data_ok <= 1'b1;     // Word 0 read this cycle
+                            wb_to_op <= 1'b0;
+                            state <= S_WB;
+                        end else begin
+                            state <= S_FILL;
+                        end
+                    end
+                end
+
+                S_BURST: begin
+                    burst_word <= burst_word + 1'b1;
+                    burst_left <= burst_left - 1'b1;
+                    if (burst_left == 4'h0)
+                        state <= S_IDLE;
+                end
+
+                S_WB: begin
+                    if (mem_ready) begin
+                        xfer_word <= xfer_word + 1'b1;
+                        wb_data_ok <= 1'b0;
+                        if (xfer_last)
+                            state <= wb_to_op ? S_OP_NEXT : S_FILL;
+                    end else begin
+                        wb_data_ok <= 1'b1;
+                    end
+                end
+
+                S_FILL: begin
+                    if (mem_ready) begin
+                        xfer_word <= xfer_word + 1'b1;
+                        if (xfer_last)
+                            state <= S_IDLE;        // Replay the lookup
+                    end
+                end
+
+                S_CLEAR: begin
+                    clear_index <= clear_index + 1'b1;
+                    if (clear_index == LINES - 1)
+                        state <= S_IDLE;
+                end
+
+                S_OP_READ: begin
+                    state <= S_OP_CHECK;            // tag_q valid next cycle
+                end
+
+                S_OP_CHECK: begin
+                    op_match <= q_valid && (op_all || (q_tag == op_tag));
+                    op_match_tag <= q_tag;
+                    if (q_valid && q_dirty && (op_all || (q_tag == op_tag))) begin
+                        wb_tag <= q_tag;
+                        line_index <= op_index;
+                        xfer_word <= 0;
+                        wb_data_ok <= 1'b1;         // Word 0 read this cycle
+                        wb_to_op <= 1'b1;
+                        state <= S_WB;
+                    end else begin
+                        state <= S_OP_NEXT;
+                    end
+                end
+
+                S_OP_NEXT: begin
+                    op_match <= 1'b0;
+                    wb_to_op <= 1'b0;
+                    if (op_line == op_last) begin
+                        state <= S_IDLE;
+                    end else begin
+                        op_line <= op_line + 1'b1;
+                        state <= S_OP_READ;
+                    end
+                end
+
+                default: state <= S_IDLE;
+            endcase
+        end
+    end
+
+endmodule
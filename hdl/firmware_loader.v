@@ -1,6 +1,6 @@
 //==============================================================================
 // Olimex iCE40HX8K-EVB RISC-V Platform
-// firmware_loader.v - Firmware Upload Protocol Handler
+// firmware_loader.v - Hardware Firmware Loader (UART -> SRAM, CPU in reset)
 //
 // Copyright (c) October 2025 Michael Wolak
 // Email: mikewolak@gmail.com, mike@epromfoundry.com
@@ -8,504 +8,848 @@
 // NOT FOR COMMERCIAL USE
 // Educational and research purposes only
 //==============================================================================
+// PURPOSE: Reflash SRAM over the UART without any code running. The block
+//          upload protocol (lib/block_upload/block_upload.h) is handled in
+//          hardware: windowed 1 KB blocks, per-block CRC32 from crc32_gen
+//          as the bytes arrive, NAK/resend and resume.
+//
+// The loader watches the UART while the CPU runs. A hold packet ('H', arg
+// BLOCK_HOLD_MAGIC) makes it hold the CPU in reset, take over the RX FIFO,
+// the TX FIFO, the UART rate and the SRAM adapter, and answer like the
+// bootloaders' block receiver ('w' to the hold and to probes). The host
+// can then raise the rate with the lib/uart_baud.h handshake: no divider
+// arithmetic here, the rates fw_upload_fast and slattach_1m try are
+// precomputed for CLK_HZ.
+//
+// Received blocks go straight into place as aligned halfword writes. On
+// finish the image is read back from SRAM through the same CRC, so 'C'
+// reports what the CPU will actually fetch. If it matches, the CPU is
+// released, STATUS.LOADED is set and the bootloader jumps to the image at
+// once. An abort, or HOLD_IDLE_MS without a byte, releases the CPU with
+// the session kept: the next hold resumes it.
+//==============================================================================
 
-module firmware_loader (
+module firmware_loader #(
+    parameter CLK_HZ = 50000000,
+    parameter MAX_SIZE = 262144         // Bytes, as the bootloaders' MAX_FIRMWARE_SIZE
+) (
     input wire clk,
-    input wire resetn,
-    
-    // Shell control
-    input wire start,
-    output reg busy,
-    output reg done,
-    output reg error,
-    output reg [7:0] nak_reason,
-    
-    // Circular Buffer Interface
-    input wire [7:0] buffer_rd_data,
-    output reg buffer_rd_en,
-    input wire buffer_empty,
-    
-    // UART TX Interface
-    output reg [7:0] uart_tx_data,
-    output reg uart_tx_valid,
-    input wire uart_tx_ready,
-    
-    // 16-bit SRAM Interface (matches sram_proc)
-    output reg sram_valid,
-    input wire sram_ready,
-    output reg sram_we,
-    output reg [18:0] sram_addr_16,
-    output reg [15:0] sram_wdata_16,
-    input wire [15:0] sram_rdata_16,
-    
-    // CPU Control
-    output reg cpu_reset
+    input wire resetn,                  // Global reset: the loader outlives CPU resets
+
+    // MMIO Interface (status for the bootloader)
+    input wire        mmio_valid,
+    input wire        mmio_write,
+    input wire [31:0] mmio_addr,
+    input wire [31:0] mmio_wdata,
+    input wire [ 3:0] mmio_wstrb,
+    output reg [31:0] mmio_rdata,
+    output wire       mmio_ready,
+
+    // UART RX: every received byte (hold detection), and the RX FIFO
+    input wire [7:0]  rx_data,
+    input wire        rx_strobe,
+    input wire [7:0]  rx_fifo_data,
+    output reg        rx_fifo_rd_en,
+    input wire        rx_fifo_empty,
+    output reg        rx_fifo_clear,
+
+    // UART TX FIFO
+    output wire [7:0] tx_data,
+    output wire       tx_valid,
+    input wire        tx_full,
+    input wire        tx_idle,          // FIFO empty and last character sent
+
+    // UART rate: the peripheral's, or the loader's while it holds the CPU
+    input wire [23:0] baud_div_in,
+    input wire [ 4:0] os_rate_in,
+    output wire [23:0] baud_div,
+    output wire [ 4:0] os_rate,
+
+    // SRAM (sram_controller start/busy/done port)
+    output reg        sram_start,
+    output reg [31:0] sram_addr,
+    output reg [31:0] sram_wdata,
+    output reg [ 3:0] sram_wstrb,
+    input wire        sram_busy,
+    input wire        sram_done,
+    input wire [31:0] sram_rdata,
+
+    // High while the loader owns the UART and SRAM: CPU held in reset
+    output reg        active
 );
 
-    // NAK reason codes
-    localparam NAK_SIZE_TOO_LARGE = 8'h01;
-    localparam NAK_SIZE_ZERO = 8'h02;
-    localparam NAK_CRC_MISMATCH = 8'h03;
-    localparam NAK_SRAM_ERROR = 8'h04;
-    localparam NAK_TIMEOUT = 8'hFF;
-    
-    localparam MAX_SRAM_SIZE = 32'h00080000;
-    localparam TIMEOUT_CYCLES = 32'd50_000_000;
-    
+    // =========================================================================
+    // Register Map
+    // Base: 0x800001E0
+    // =========================================================================
+    // +0x00: STATUS (R)  - [31]=present, [0]=loaded
+    //               (W)  - [0]=1 clears loaded
+    // +0x04: SIZE   (R)  - Bytes of the image loaded
+    // +0x08: CRC    (R)  - Its CRC32
+    // =========================================================================
+
+    localparam ADDR_STATUS = 2'h0;
+    localparam ADDR_SIZE   = 2'h1;
+    localparam ADDR_CRC    = 2'h2;
+
+    // Protocol (lib/block_upload/block_upload.h, lib/uart_baud.h)
+    localparam [ 7:0] VERSION    = 8'd1;
+    localparam [15:0] BLOCK_SIZE = 16'd1024;
+    localparam [ 7:0] WINDOW     = 8'd8;
+    localparam [15:0] HOLD_MAGIC = 16'hC3A5;
+
+    localparam PKT_PROBE    = 8'h57;    // 'W'
+    localparam PKT_SESSION  = 8'h53;    // 'S'
+    localparam PKT_DATA     = 8'h44;    // 'D'
+    localparam PKT_FINISH   = 8'h46;    // 'F'
+    localparam PKT_ABORT    = 8'h58;    // 'X'
+    localparam PKT_HOLD     = 8'h48;    // 'H'
+    localparam RSP_INFO     = 8'h77;    // 'w'
+    localparam RSP_RESUME   = 8'h41;    // 'A'
+    localparam RSP_REJECT   = 8'h4A;    // 'J'
+    localparam RSP_ACK      = 8'h4B;    // 'K'
+    localparam RSP_NAK      = 8'h4E;    // 'N'
+    localparam RSP_DONE     = 8'h43;    // 'C'
+
+    localparam BAUD_CMD     = 8'h55;    // 'U'
+    localparam BAUD_ACK     = 8'h75;    // 'u'
+    localparam BAUD_NAK     = 8'h6E;    // 'n'
+    localparam BAUD_COMMIT  = 8'h4B;    // 'K'
+
+    localparam MAX_BLOCKS   = MAX_SIZE / BLOCK_SIZE;
+    localparam MAP_BITS     = $clog2(MAX_BLOCKS);
+
+    // Timeouts in milliseconds
+    localparam MS_CYCLES    = CLK_HZ / 1000;
+    localparam SETTLE_MS    = 10;       // UART_BAUD_SETTLE_MS / 2, as uart_baud_accept()
+    localparam TIMEOUT_MS   = 200;      // UART_BAUD_TIMEOUT_MS
+    localparam HOLD_IDLE_MS = 10000;    // Host gone: let the CPU run
+
+    // BAUD register value {os, div} for a rate, as uart_baud_value(): most
+    // oversampling that leaves two clocks per tick, 0 if unreachable
+    function [28:0] baud_value;
+        input integer rate;
+        integer os, div;
+        begin
+            baud_value = 29'h0;
+            for (os = 16; os >= 4; os = os / 2) begin
+                div = ((CLK_HZ / 1000) * 256) / ((rate / 1000) * os);
+                if (baud_value == 29'h0 && rate <= CLK_HZ / os && div >= 512)
+                    baud_value = {os[4:0], div[23:0]};
+            end
+        end
+    endfunction
+
+    localparam [28:0] BAUD_4M   = baud_value(4000000);
+    localparam [28:0] BAUD_3M   = baud_value(3000000);
+    localparam [28:0] BAUD_2M   = baud_value(2000000);
+    localparam [28:0] BAUD_1M5  = baud_value(1500000);
+    localparam [28:0] BAUD_1M   = baud_value(1000000);
+
+    // uart_baud_pattern()
+    function [7:0] baud_pattern;
+        input [3:0] i;
+        begin
+            case (i)
+                4'd0:  baud_pattern = 8'h55;
+                4'd1:  baud_pattern = 8'hAA;
+                4'd2:  baud_pattern = 8'h00;
+                4'd3:  baud_pattern = 8'hFF;
+                4'd4:  baud_pattern = 8'h0F;
+                4'd5:  baud_pattern = 8'hF0;
+                4'd6:  baud_pattern = 8'h01;
+                4'd7:  baud_pattern = 8'h80;
+                4'd8:  baud_pattern = 8'hFE;
+                4'd9:  baud_pattern = 8'h7F;
+                4'd10: baud_pattern = 8'h33;
+                4'd11: baud_pattern = 8'hCC;
+                4'd12: baud_pattern = 8'h5A;
+                4'd13: baud_pattern = 8'hA5;
+                4'd14: baud_pattern = 8'hC3;
+                default: baud_pattern = 8'h3C;
+            endcase
+        end
+    endfunction
+
     // States
-    localparam STATE_IDLE = 4'h0;
-    localparam STATE_WAIT_READY = 4'h1;
-    localparam STATE_RECV_SIZE = 4'h2;
-    localparam STATE_CHECK_SIZE = 4'h3;
-    localparam STATE_RECV_DATA = 4'h4;
-    localparam STATE_PREPARE_WRITE = 4'h5;
-    localparam STATE_STORE_WORD = 4'h6;
-    localparam STATE_RECV_CRC_CMD = 4'h7;
-    localparam STATE_RECV_CRC = 4'h8;
-    localparam STATE_VERIFY_CRC = 4'h9;
-    localparam STATE_SEND_RESP = 4'hA;
-    localparam STATE_SEND_CRC = 4'hB;
-    localparam STATE_WAIT_TX_DONE = 4'hC;
-    localparam STATE_COMPLETE = 4'hD;
-    localparam STATE_ERROR = 4'hE;
-    
-    reg [3:0] state = STATE_IDLE;
-    reg [3:0] next_state = STATE_IDLE;
-    reg [31:0] packet_size = 32'h0;
-    reg [31:0] bytes_received = 32'h0;
-    reg [31:0] word_addr = 32'h0;
-    reg [15:0] data_word = 16'h0;
-    reg byte_in_word = 1'b0;  // 0 = need low byte, 1 = have low byte
-    
-    // CRC calculation (matching quick_test pattern)
-    reg [31:0] crc_din;  // Combinational word to CRC
-    reg [23:0] crc_current_word;  // First 3 bytes of current word
-    reg [1:0] crc_word_pos;  // 0-3 for position in word
-    reg crc_calc_pulse;
+    localparam S_IDLE         = 5'd0;   // CPU running: watch for the hold packet
+    localparam S_HOLD         = 5'd1;   // Wait for the SRAM adapter, answer the hold
+    localparam S_HUNT         = 5'd2;   // Shift bytes until a valid header
+    localparam S_WORD         = 5'd3;   // Four bytes (LE) into word, then ret_state
+    localparam S_TRAILER      = 5'd4;   // Act on W/H/F/X after their trailer
+    localparam S_SESSION      = 5'd5;   // Session payload
+    localparam S_SESSION_CHK  = 5'd6;
+    localparam S_CLEAR        = 5'd7;   // New image: clear the received map
+    localparam S_SCAN         = 5'd8;   // First missing block
+    localparam S_SCAN_WAIT    = 5'd9;
+    localparam S_SCAN_TEST    = 5'd10;
+    localparam S_DATA_WAIT    = 5'd11;  // Block already stored?
+    localparam S_DATA_MAP     = 5'd12;
+    localparam S_DATA         = 5'd13;  // Payload bytes
+    localparam S_DATA_WRITE   = 5'd14;
+    localparam S_DATA_CHK     = 5'd15;
+    localparam S_VERIFY       = 5'd16;  // Read the image back through the CRC
+    localparam S_VERIFY_WAIT  = 5'd17;
+    localparam S_VERIFY_TAIL  = 5'd18;
+    localparam S_VERIFY_DONE  = 5'd19;
+    localparam S_RELEASE      = 5'd20;  // Last reply sent, then let the CPU run
+    localparam S_BAUD_REQ     = 5'd21;  // Auto-baud handshake
+    localparam S_BAUD_DRAIN   = 5'd22;
+    localparam S_BAUD_SETTLE  = 5'd23;
+    localparam S_BAUD_TEST    = 5'd24;
+    localparam S_BAUD_ECHO    = 5'd25;
+    localparam S_BAUD_COMMIT  = 5'd26;
+    localparam S_BAUD_FAIL    = 5'd27;
+
+    reg [4:0]  state;
+    reg [4:0]  ret_state;
+
+    // Loaded image, for the bootloader
+    reg        loaded;
+    reg [31:0] image_size;
+    reg [31:0] image_crc;
+
+    // Session (kept across holds for resume)
+    reg [31:0] s_size;
+    reg [31:0] s_crc;
+    reg [MAP_BITS:0] s_blocks;
+
+    // UART rate while active
+    reg [28:0] baud_reg;
+    reg [28:0] baud_old;
+    reg [28:0] baud_new;
+
+    // Hold packet detector: 'H', magic, len 0, check, zero CRC trailer
+    reg [3:0]  hold_match;
+
+    function [7:0] hold_byte;
+        input [3:0] i;
+        begin
+            case (i)
+                4'd0: hold_byte = PKT_HOLD;
+                4'd1: hold_byte = HOLD_MAGIC[7:0];
+                4'd2: hold_byte = HOLD_MAGIC[15:8];
+                4'd5: hold_byte = ~(PKT_HOLD ^ HOLD_MAGIC[7:0] ^ HOLD_MAGIC[15:8]);
+                default: hold_byte = 8'h00;
+            endcase
+        end
+    endfunction
+
+    // RX byte from the FIFO, held in rx_byte until the state machine takes it
+    reg        rx_pending;
+    reg        rx_full;
+    reg [7:0]  rx_byte;
+
+    // TX reply, sent LSB byte first
+    reg [127:0] tx_buf;
+    reg [4:0]  tx_count;
+
+    assign tx_valid = active && tx_count != 5'd0 && !tx_full;
+    assign tx_data  = tx_buf[7:0];
+
+    assign baud_div = active ? baud_reg[23:0]  : baud_div_in;
+    assign os_rate  = active ? baud_reg[28:24] : os_rate_in;
+
+    // Header window, bytes shifted in from the top: [7:0] is the oldest
+    reg [47:0] hdr;
+    reg [2:0]  hdr_count;
+
+    wire [7:0]  pkt_type = hdr[7:0];
+    wire [15:0] pkt_arg  = hdr[23:8];
+    wire [15:0] pkt_len  = hdr[39:24];
+    wire hdr_check_ok = (hdr[47:40] == ~(hdr[7:0] ^ hdr[15:8] ^ hdr[23:16] ^
+                                         hdr[31:24] ^ hdr[39:32]));
+
+    // Payload length of the last block
+    wire [9:0]  tail_len = s_size[9:0];
+    wire        data_ok  = (pkt_arg < s_blocks) &&
+                           (pkt_len == ((pkt_arg == s_blocks - 1'b1 && tail_len != 10'd0) ?
+                                        {6'h0, tail_len} : BLOCK_SIZE));
+
+    reg hdr_valid;
+    always @(*) begin
+        case (pkt_type)
+            PKT_PROBE, PKT_FINISH, PKT_ABORT: hdr_valid = (pkt_len == 16'd0);
+            PKT_HOLD:    hdr_valid = (pkt_len == 16'd0) && (pkt_arg == HOLD_MAGIC);
+            PKT_SESSION: hdr_valid = (pkt_len == 16'd8);
+            PKT_DATA:    hdr_valid = data_ok;
+            BAUD_CMD:    hdr_valid = 1'b1;      // 'U' + rate + check: same shape
+            default:     hdr_valid = 1'b0;
+        endcase
+    end
+
+    wire [31:0] baud_rate = hdr[39:8];
+    wire [28:0] baud_lookup = (baud_rate == 32'd4000000) ? BAUD_4M :
+                              (baud_rate == 32'd3000000) ? BAUD_3M :
+                              (baud_rate == 32'd2000000) ? BAUD_2M :
+                              (baud_rate == 32'd1500000) ? BAUD_1M5 :
+                              (baud_rate == 32'd1000000) ? BAUD_1M : 29'h0;
+
+    // Received-block map (one EBR)
+    reg        map_mem [0:MAX_BLOCKS-1];
+    reg [MAP_BITS-1:0] map_addr;
+    reg        map_we;
+    reg        map_wbit;
+    reg        map_q;
+
+    always @(posedge clk) begin
+        if (map_we)
+            map_mem[map_addr] <= map_wbit;
+        map_q <= map_mem[map_addr];
+    end
+
+    // CRC32 over the payload bytes (per block) or the image read back
+    reg        crc_clr;
+    reg        crc_calc;
+    reg        crc_calc_byte;
+    reg [31:0] crc_din;
     wire [31:0] crc_result;
 
-    reg [1:0] size_byte_count;
-    reg [1:0] crc_rx_byte_count;
-    reg [1:0] crc_tx_byte_count;
-    reg [31:0] expected_crc;
-    reg [6:0] chunk_byte_count;  // 7 bits to hold 0-64
-    reg [7:0] response_char;
-    reg send_response;
-    reg [31:0] timeout_counter;
-    reg [4:0] ack_counter;  // Rotating ACK counter (0-25 for A-Z)
-
-    reg buffer_read_state;
-    reg buffer_data_valid;
-    reg [7:0] current_rx_byte;
-    
-    wire timeout_active = (state == STATE_WAIT_READY) ||
-                          (state == STATE_RECV_SIZE) ||
-                          (state == STATE_RECV_DATA) ||
-                          (state == STATE_RECV_CRC_CMD) ||
-                          (state == STATE_RECV_CRC);
-    
-    // CRC32 module instantiation (matching quick_test)
     crc32_gen crc32_inst (
         .clk(clk),
-        .clr_crc(state == STATE_IDLE || state == STATE_WAIT_READY),
-        .din(crc_din),  // Use combinational word
-        .calc(crc_calc_pulse),
+        .clr_crc(crc_clr),
+        .din(crc_din),
+        .calc(crc_calc),
+        .calc_byte(crc_calc_byte),
         .crc(crc_result)
     );
-    
-    always @(posedge clk) begin
-        if (!resetn || !busy || !timeout_active) begin
-            timeout_counter <= 32'd0;
-        end else if (buffer_data_valid) begin
-            timeout_counter <= 32'd0;
-        end else if (timeout_counter < TIMEOUT_CYCLES) begin
-            timeout_counter <= timeout_counter + 1;
-        end
-    end
-    
-    wire timeout_expired = (timeout_counter >= TIMEOUT_CYCLES);
-    
-    // States that need buffer reading
-    wire buffer_read_active = (state == STATE_WAIT_READY) ||
-                               (state == STATE_RECV_SIZE) ||
-                               (state == STATE_RECV_DATA) ||
-                               (state == STATE_RECV_CRC_CMD) ||
-                               (state == STATE_RECV_CRC);
-
-    // Buffer reader
+
+    // Millisecond timer
+    reg [$clog2(MS_CYCLES)-1:0] ms_div;
+    reg        ms_tick;
+    reg [13:0] wait_ms;                 // Handshake timeouts
+    reg [13:0] idle_ms;                 // Since the last received byte
+
     always @(posedge clk) begin
         if (!resetn) begin
-            buffer_rd_en <= 1'b0;
-            buffer_read_state <= 1'b0;
-            buffer_data_valid <= 1'b0;
-            current_rx_byte <= 8'h00;
+            ms_div <= 0;
+            ms_tick <= 1'b0;
+        end else if (ms_div == MS_CYCLES - 1) begin
+            ms_div <= 0;
+            ms_tick <= 1'b1;
         end else begin
-            buffer_rd_en <= 1'b0;
-            buffer_data_valid <= 1'b0;
-
-            if (busy) begin
-                case (buffer_read_state)
-                    1'b0: begin
-                        // Only START a new read if in a reading state
-                        if (buffer_read_active && !buffer_empty) begin
-                            buffer_rd_en <= 1'b1;
-                            buffer_read_state <= 1'b1;
-                        end
-                    end
-                    1'b1: begin
-                        // Always COMPLETE a read in progress, even if buffer_read_active goes FALSE
-                        current_rx_byte <= buffer_rd_data;
-                        buffer_data_valid <= 1'b1;
-                        buffer_read_state <= 1'b0;
-                        // synthesis translate_off
-                        $display("[BUF] Read byte: 0x%02x", buffer_rd_data);
-                        // synthesis translate_on
-                    end
-                endcase
-            end
+            ms_div <= ms_div + 1'b1;
+            ms_tick <= 1'b0;
         end
     end
-    
-    // Main state machine
+
+    // Working registers
+    reg [31:0] word;
+    reg [1:0]  word_count;
+    reg [3:0]  count;                   // Session payload / pattern bytes
+    reg [MAP_BITS:0] block;             // Clear / scan index
+    reg [15:0] data_index;
+    reg [10:0] data_pos;
+    reg [10:0] data_len;
+    reg        data_stored;             // Block was already received
+    reg [7:0]  data_lo;                 // Even byte of the next halfword
+    reg [31:0] verify_addr;
+    reg [31:0] verify_left;
+    reg [31:0] verify_word;
+
+    assign mmio_ready = mmio_valid;
+
+    always @(*) begin
+        case (mmio_addr[3:2])
+            ADDR_STATUS: mmio_rdata = {1'b1, 30'h0, loaded};
+            ADDR_SIZE:   mmio_rdata = image_size;
+            ADDR_CRC:    mmio_rdata = image_crc;
+            default:     mmio_rdata = 32'h0;
+        endcase
+    end
+
+    // Reply helpers
+    task reply16;
+        input [7:0] code;
+        input [15:0] value;
+        begin
+            tx_buf <= {104'h0, value, code};
+            tx_count <= 5'd3;
+        end
+    endtask
+
+    task reply32;
+        input [7:0] code;
+        input [31:0] value;
+        begin
+            tx_buf <= {88'h0, value, code};
+            tx_count <= 5'd5;
+        end
+    endtask
+
+    task reply_info;
+        begin
+            tx_buf <= {88'h0, WINDOW, BLOCK_SIZE, VERSION, RSP_INFO};
+            tx_count <= 5'd5;
+        end
+    endtask
+
+    integer i;
+
     always @(posedge clk) begin
         if (!resetn) begin
-            state <= STATE_IDLE;
-            next_state <= STATE_IDLE;
-            busy <= 1'b0;
-            done <= 1'b0;
-            error <= 1'b0;
-            nak_reason <= 8'h00;
-            cpu_reset <= 1'b1;
-            uart_tx_valid <= 1'b0;
-            sram_valid <= 1'b0;
-            sram_we <= 1'b0;
-            sram_addr_16 <= 19'h0;
-            sram_wdata_16 <= 16'h0;
-            packet_size <= 32'h0;
-            bytes_received <= 32'h0;
-            word_addr <= 32'h0;
-            chunk_byte_count <= 7'd0;
-            send_response <= 1'b0;
-            byte_in_word <= 1'b0;
-            data_word <= 16'h0;
-            crc_word_pos <= 2'h0;
-            crc_calc_pulse <= 1'b0;
-            crc_current_word <= 24'h0;
+            state <= S_IDLE;
+            ret_state <= S_IDLE;
+            active <= 1'b0;
+            loaded <= 1'b0;
+            image_size <= 32'h0;
+            image_crc <= 32'h0;
+            s_size <= 32'h0;
+            s_crc <= 32'h0;
+            s_blocks <= 0;
+            baud_reg <= 29'h0;
+            baud_old <= 29'h0;
+            baud_new <= 29'h0;
+            hold_match <= 4'h0;
+            rx_pending <= 1'b0;
+            rx_full <= 1'b0;
+            rx_byte <= 8'h0;
+            rx_fifo_rd_en <= 1'b0;
+            rx_fifo_clear <= 1'b0;
+            tx_buf <= 128'h0;
+            tx_count <= 5'd0;
+            hdr_count <= 3'd0;
+            hdr <= 48'h0;
+            map_addr <= 0;
+            map_we <= 1'b0;
+            map_wbit <= 1'b0;
+            crc_clr <= 1'b1;
+            crc_calc <= 1'b0;
+            crc_calc_byte <= 1'b0;
             crc_din <= 32'h0;
-            ack_counter <= 5'd0;
+            wait_ms <= 14'd0;
+            idle_ms <= 14'd0;
+            sram_start <= 1'b0;
+            sram_addr <= 32'h0;
+            sram_wdata <= 32'h0;
+            sram_wstrb <= 4'h0;
+            word <= 32'h0;
+            word_count <= 2'd0;
+            count <= 4'd0;
+            block <= 0;
+            data_index <= 16'h0;
+            data_pos <= 11'd0;
+            data_len <= 11'd0;
+            data_stored <= 1'b0;
+            data_lo <= 8'h0;
+            verify_addr <= 32'h0;
+            verify_left <= 32'h0;
+            verify_word <= 32'h0;
         end else begin
-            done <= 1'b0;
-            crc_calc_pulse <= 1'b0;  // Pulse signal, clear each cycle
-            
-            if (uart_tx_valid && uart_tx_ready) begin
-                uart_tx_valid <= 1'b0;
-            end
-            
-            if (!uart_tx_valid && uart_tx_ready && send_response) begin
-                uart_tx_data <= response_char;
-                uart_tx_valid <= 1'b1;
-                send_response <= 1'b0;
+            rx_fifo_rd_en <= 1'b0;
+            rx_fifo_clear <= 1'b0;
+            map_we <= 1'b0;
+            crc_clr <= 1'b0;
+            crc_calc <= 1'b0;
+            crc_calc_byte <= 1'b0;
+
+            if (mmio_valid && mmio_write && mmio_addr[3:2] == ADDR_STATUS &&
+                mmio_wstrb[0] && mmio_wdata[0])
+                loaded <= 1'b0;
+
+            // RX FIFO reader: rd_data is the head one cycle after the pop
+            if (!active) begin
+                rx_pending <= 1'b0;
+                rx_full <= 1'b0;
+            end else if (rx_pending) begin
+                rx_byte <= rx_fifo_data;
+                rx_full <= 1'b1;
+                rx_pending <= 1'b0;
+            end else if (!rx_full && !rx_fifo_empty && !rx_fifo_rd_en && !rx_fifo_clear) begin
+                rx_fifo_rd_en <= 1'b1;
+                rx_pending <= 1'b1;
             end
-            
-            if (timeout_expired && busy && state != STATE_COMPLETE && state != STATE_SEND_RESP && state != STATE_ERROR) begin
-                response_char <= 8'h4E;
-                send_response <= 1'b1;
-                nak_reason <= NAK_TIMEOUT;
-                next_state <= STATE_ERROR;
-                state <= STATE_SEND_RESP;
+
+            if (tx_valid) begin
+                tx_buf <= {8'h0, tx_buf[127:8]};
+                tx_count <= tx_count - 1'b1;
             end
-            
+
+            // The adapter has taken the request once it is busy
+            if (sram_start && sram_busy)
+                sram_start <= 1'b0;
+
+            if (ms_tick && wait_ms != 14'd0)
+                wait_ms <= wait_ms - 1'b1;
+            if (!active || rx_pending)
+                idle_ms <= 14'd0;
+            else if (ms_tick)
+                idle_ms <= idle_ms + 1'b1;
+
+            // Host gone mid-packet: let the CPU run, keep the session
+            if (idle_ms == HOLD_IDLE_MS && state != S_RELEASE)
+                state <= S_RELEASE;
+
             case (state)
-                STATE_IDLE: begin
-                    busy <= 1'b0;
-                    done <= 1'b0;
-                    error <= 1'b0;
-                    cpu_reset <= 1'b1;
-                    sram_valid <= 1'b0;
-                    sram_we <= 1'b0;
-                    ack_counter <= 5'd0;  // Reset ACK counter to start at 'A'
-
-                    if (start) begin
-                        nak_reason <= 8'h00;
-                        busy <= 1'b1;
-                        packet_size <= 32'h0;
-                        bytes_received <= 32'h0;
-                        word_addr <= 32'h0;
-                        byte_in_word <= 1'b0;
-                        crc_word_pos <= 2'h0;
-                        state <= STATE_WAIT_READY;
+                S_IDLE: begin
+                    if (rx_strobe) begin
+                        if (rx_data == hold_byte(hold_match)) begin
+                            hold_match <= hold_match + 1'b1;
+                            if (hold_match == 4'd9) begin
+                                // Take the UART at the rate the host is using
+                                active <= 1'b1;
+                                baud_reg <= {os_rate_in, baud_div_in};
+                                hold_match <= 4'h0;
+                                state <= S_HOLD;
+                            end
+                        end else begin
+                            hold_match <= (rx_data == PKT_HOLD) ? 4'h1 : 4'h0;
+                        end
                     end
                 end
-                
-                STATE_WAIT_READY: begin
-                    if (buffer_data_valid && current_rx_byte == 8'h52) begin
-                        response_char <= 8'h41 + ack_counter;  // Rotating ACK
-                        ack_counter <= (ack_counter == 5'd25) ? 5'd0 : ack_counter + 1;
-                        send_response <= 1'b1;
-                        size_byte_count <= 2'h0;
-                        state <= STATE_RECV_SIZE;
+
+                S_HOLD: begin
+                    // A CPU access may still be finishing in the adapter
+                    if (!sram_busy && tx_count == 5'd0) begin
+                        rx_fifo_clear <= 1'b1;  // Drop what the CPU left unread
+                        rx_full <= 1'b0;
+                        rx_pending <= 1'b0;
+                        reply_info();
+                        hdr_count <= 3'd0;
+                        state <= S_HUNT;
                     end
                 end
-                
-                STATE_RECV_SIZE: begin
-                    if (buffer_data_valid) begin
-                        case (size_byte_count)
-                            2'h0: packet_size[7:0] <= current_rx_byte;
-                            2'h1: packet_size[15:8] <= current_rx_byte;
-                            2'h2: packet_size[23:16] <= current_rx_byte;
-                            2'h3: begin
-                                packet_size[31:24] <= current_rx_byte;
-                                state <= STATE_CHECK_SIZE;
+
+                S_HUNT: begin
+                    if (hdr_count == 3'd6 && hdr_valid && hdr_check_ok) begin
+                        hdr_count <= 3'd0;
+                        word_count <= 2'd0;
+                        crc_clr <= 1'b1;
+                        case (pkt_type)
+                            PKT_SESSION: begin
+                                count <= 4'd0;
+                                state <= S_SESSION;
+                            end
+                            PKT_DATA: begin
+                                data_index <= pkt_arg;
+                                data_len <= pkt_len[10:0];
+                                data_pos <= 11'd0;
+                                map_addr <= pkt_arg[MAP_BITS-1:0];
+                                state <= S_DATA_WAIT;
+                            end
+                            BAUD_CMD: begin
+                                baud_new <= baud_lookup;
+                                state <= S_BAUD_REQ;
+                            end
+                            default: begin
+                                ret_state <= S_TRAILER;
+                                state <= S_WORD;
                             end
                         endcase
-                        if (size_byte_count < 2'h3) begin
-                            size_byte_count <= size_byte_count + 1;
-                        end
+                    end else if (rx_full) begin
+                        rx_full <= 1'b0;
+                        hdr <= {rx_byte, hdr[47:8]};
+                        if (hdr_count != 3'd6)
+                            hdr_count <= hdr_count + 1'b1;
                     end
                 end
-                
-                STATE_CHECK_SIZE: begin
-                    if (packet_size > MAX_SRAM_SIZE) begin
-                        response_char <= 8'h4E;
-                        send_response <= 1'b1;
-                        nak_reason <= NAK_SIZE_TOO_LARGE;
-                        state <= STATE_ERROR;
-                    end else if (packet_size == 0) begin
-                        response_char <= 8'h4E;
-                        send_response <= 1'b1;
-                        nak_reason <= NAK_SIZE_ZERO;
-                        state <= STATE_ERROR;
-                    end else begin
-                        response_char <= 8'h41 + ack_counter;  // Rotating ACK
-                        ack_counter <= (ack_counter == 5'd25) ? 5'd0 : ack_counter + 1;
-                        send_response <= 1'b1;
-                        chunk_byte_count <= 7'd0;
-                        state <= STATE_RECV_DATA;
+
+                S_WORD: begin
+                    if (rx_full) begin
+                        rx_full <= 1'b0;
+                        word <= {rx_byte, word[31:8]};
+                        word_count <= word_count + 1'b1;
+                        if (word_count == 2'd3)
+                            state <= ret_state;
                     end
                 end
-                
-                STATE_RECV_DATA: begin
-                    if (buffer_data_valid) begin
-                        // Build 32-bit CRC word (matching quick_test pattern)
-                        case (crc_word_pos)
-                            2'd0: begin
-                                crc_current_word[7:0] <= current_rx_byte;
-                                // synthesis translate_off
-                                $display("[FW] CRC byte 0: 0x%02x, pos 0->1", current_rx_byte);
-                                // synthesis translate_on
-                                crc_word_pos <= 2'd1;
-                            end
-                            2'd1: begin
-                                crc_current_word[15:8] <= current_rx_byte;
-                                // synthesis translate_off
-                                $display("[FW] CRC byte 1: 0x%02x, pos 1->2", current_rx_byte);
-                                // synthesis translate_on
-                                crc_word_pos <= 2'd2;
-                            end
-                            2'd2: begin
-                                crc_current_word[23:16] <= current_rx_byte;
-                                // synthesis translate_off
-                                $display("[FW] CRC byte 2: 0x%02x, pos 2->3", current_rx_byte);
-                                // synthesis translate_on
-                                crc_word_pos <= 2'd3;
-                            end
-                            2'd3: begin
-                                // Send complete 32-bit word to CRC (like quick_test!)
-                                crc_din <= {current_rx_byte, crc_current_word[23:0]};
-                                crc_calc_pulse <= 1'b1;
-                                // synthesis translate_off
-                                $display("[FW] CRC word: 0x%08x (bytes: 0x%02x 0x%02x 0x%02x 0x%02x)",
-                                         {current_rx_byte, crc_current_word[23:0]},
-                                         crc_current_word[7:0], crc_current_word[15:8], crc_current_word[23:16], current_rx_byte);
-                                // synthesis translate_on
-                                crc_word_pos <= 2'd0;
+
+                S_TRAILER: begin
+                    if (tx_count == 5'd0) begin
+                        state <= S_HUNT;
+                        case (pkt_type)
+                            PKT_PROBE, PKT_HOLD: reply_info();
+                            PKT_FINISH: begin
+                                if (s_blocks != 0) begin
+                                    block <= 0;
+                                    ret_state <= S_VERIFY;
+                                    state <= S_SCAN;
+                                end
                             end
+                            PKT_ABORT: state <= S_RELEASE;
+                            default: ;
                         endcase
+                    end
+                end
+
+                S_SESSION: begin
+                    if (rx_full) begin
+                        rx_full <= 1'b0;
+                        crc_din <= {24'h0, rx_byte};
+                        crc_calc_byte <= 1'b1;
+                        verify_word <= {rx_byte, verify_word[31:8]};
+                        if (count == 4'd3)
+                            verify_addr <= {rx_byte, verify_word[31:8]};   // size
+                        count <= count + 1'b1;
+                        if (count == 4'd7) begin
+                            ret_state <= S_SESSION_CHK;
+                            state <= S_WORD;
+                        end
+                    end
+                end
 
-                        // Collect byte for SRAM write
-                        if (!byte_in_word) begin
-                            data_word[7:0] <= current_rx_byte;
-                            byte_in_word <= 1'b1;
+                S_SESSION_CHK: begin
+                    // verify_addr = size, verify_word = image CRC
+                    if (word != crc_result) begin
+                        state <= S_HUNT;        // Host times out and sends it again
+                    end else if (tx_count == 5'd0) begin
+                        if (verify_addr == 32'h0 || verify_addr > MAX_SIZE) begin
+                            reply32(RSP_REJECT, MAX_SIZE);
+                            state <= S_HUNT;
+                        end else if (verify_addr != s_size || verify_word != s_crc) begin
+                            // Same image again keeps what arrived last time
+                            s_size <= verify_addr;
+                            s_crc <= verify_word;
+                            s_blocks <= (verify_addr + 32'd1023) >> 10;
+                            block <= 0;
+                            state <= S_CLEAR;
                         end else begin
-                            data_word[15:8] <= current_rx_byte;
-                            byte_in_word <= 1'b0;
+                            block <= 0;
+                            ret_state <= S_HUNT;
+                            state <= S_SCAN;
                         end
+                    end
+                end
+
+                S_CLEAR: begin
+                    map_addr <= block[MAP_BITS-1:0];
+                    map_wbit <= 1'b0;
+                    map_we <= 1'b1;
+                    block <= block + 1'b1;
+                    if (block == s_blocks - 1'b1) begin
+                        block <= 0;
+                        ret_state <= S_HUNT;
+                        state <= S_SCAN;
+                    end
+                end
+
+                // First block not received: 'A' offset after a session,
+                // 'N' index (or the image check) after a finish
+                S_SCAN: begin
+                    map_addr <= block[MAP_BITS-1:0];
+                    state <= S_SCAN_WAIT;
+                end
 
-                        bytes_received <= bytes_received + 1;
-                        chunk_byte_count <= chunk_byte_count + 1;
+                S_SCAN_WAIT: state <= S_SCAN_TEST;
 
-                        // Check if we need to write to SRAM (write when we just completed a word)
-                        // byte_in_word == 1 means we're on the 2nd byte, which completes a word
-                        // bytes_received >= 1 means we have byte 0, and are currently receiving byte 1
-                        if ((byte_in_word == 1'b1 && bytes_received >= 1) || bytes_received >= packet_size) begin
-                            // Pad last byte if odd packet size
-                            if (byte_in_word == 0 && bytes_received >= packet_size) begin
-                                data_word[15:8] <= 8'h00;
-                            end
-                            state <= STATE_PREPARE_WRITE;
+                S_SCAN_TEST: begin
+                    if (block != s_blocks && map_q) begin
+                        block <= block + 1'b1;
+                        state <= S_SCAN;
+                    end else if (tx_count == 5'd0) begin
+                        if (ret_state == S_HUNT) begin
+                            reply32(RSP_RESUME, {block, 10'h0});
+                            state <= S_HUNT;
+                        end else if (block != s_blocks) begin
+                            reply16(RSP_NAK, block);
+                            state <= S_HUNT;
+                        end else begin
+                            crc_clr <= 1'b1;
+                            verify_addr <= 32'h0;
+                            verify_left <= s_size;
+                            state <= S_VERIFY;
                         end
+                    end
+                end
 
-                        // Handle final partial CRC word at end of packet
-                        if (bytes_received >= packet_size && crc_word_pos != 2'h0) begin
-                            // Pad remaining bytes with zeros and calculate
-                            case (crc_word_pos)
-                                2'd1: crc_din <= {24'h000000, crc_current_word[7:0]};
-                                2'd2: crc_din <= {16'h0000, crc_current_word[15:0]};
-                                2'd3: crc_din <= {8'h00, crc_current_word[23:0]};
-                            endcase
-                            crc_calc_pulse <= 1'b1;
+                // map_q is valid two cycles after map_addr is set
+                S_DATA_WAIT: state <= S_DATA_MAP;
+
+                S_DATA_MAP: begin
+                    data_stored <= map_q;
+                    state <= S_DATA;
+                end
+
+                S_DATA: begin
+                    if (data_pos == data_len) begin
+                        ret_state <= S_DATA_CHK;
+                        state <= S_WORD;
+                    end else if (rx_full) begin
+                        rx_full <= 1'b0;
+                        crc_din <= {24'h0, rx_byte};
+                        crc_calc_byte <= 1'b1;
+                        data_pos <= data_pos + 1'b1;
+
+                        // Straight into place as halfwords: a bad block is
+                        // simply overwritten on resend
+                        sram_addr <= {6'h0, data_index, data_pos[9:2], 2'b00};
+                        if (!data_pos[0])
+                            data_lo <= rx_byte;
+                        if (!data_stored && data_pos[0]) begin
+                            sram_wdata <= {2{rx_byte, data_lo}};
+                            sram_wstrb <= data_pos[1] ? 4'b1100 : 4'b0011;
+                            sram_start <= 1'b1;
+                            state <= S_DATA_WRITE;
+                        end else if (!data_stored && data_pos + 1'b1 == data_len) begin
+                            sram_wdata <= {4{rx_byte}};
+                            sram_wstrb <= data_pos[1] ? 4'b0100 : 4'b0001;
+                            sram_start <= 1'b1;
+                            state <= S_DATA_WRITE;
                         end
                     end
                 end
 
-                STATE_PREPARE_WRITE: begin
-                    // Wait one cycle for data_word to settle after non-blocking assignment
-                    state <= STATE_STORE_WORD;
+                S_DATA_WRITE: begin
+                    if (sram_done)
+                        state <= S_DATA;
                 end
 
-                STATE_STORE_WORD: begin
-                    if (!sram_valid) begin
-                        sram_addr_16 <= word_addr[18:0];
-                        sram_wdata_16 <= data_word;
-                        sram_we <= 1'b1;
-                        sram_valid <= 1'b1;
-                        // synthesis translate_off
-                        $display("[FW] STORE_WORD: Writing to sram_addr_16=0x%05x (word_addr=0x%08x) data=0x%04x", word_addr[18:0], word_addr, data_word);
-                        // synthesis translate_on
-                    end else if (sram_ready) begin
-                        sram_valid <= 1'b0;
-                        sram_we <= 1'b0;
-                        word_addr <= word_addr + 1;
-
-                        if (bytes_received >= packet_size) begin
-                            // synthesis translate_off
-                            $display("[FW] STORE_WORD: bytes_received=%d >= packet_size=%d, sending ACK, going to CRC_CMD", bytes_received, packet_size);
-                            // synthesis translate_on
-                            response_char <= 8'h41 + ack_counter;  // Rotating ACK
-                            ack_counter <= (ack_counter == 5'd25) ? 5'd0 : ack_counter + 1;
-                            send_response <= 1'b1;
-                            next_state <= STATE_RECV_CRC_CMD;
-                            state <= STATE_SEND_RESP;
-                        end else if (chunk_byte_count >= 7'd64) begin
-                            // synthesis translate_off
-                            $display("[FW] STORE_WORD: chunk_byte_count=%d >= 64, sending chunk ACK", chunk_byte_count);
-                            // synthesis translate_on
-                            response_char <= 8'h41 + ack_counter;  // Rotating ACK
-                            ack_counter <= (ack_counter == 5'd25) ? 5'd0 : ack_counter + 1;
-                            send_response <= 1'b1;
-                            chunk_byte_count <= 7'd0;
-                            next_state <= STATE_RECV_DATA;
-                            state <= STATE_SEND_RESP;
+                S_DATA_CHK: begin
+                    if (tx_count == 5'd0) begin
+                        if (word != crc_result) begin
+                            reply16(RSP_NAK, data_index);
                         end else begin
-                            // synthesis translate_off
-                            $display("[FW] STORE_WORD: bytes=%d, chunk=%d, continuing to RECV_DATA", bytes_received, chunk_byte_count);
-                            // synthesis translate_on
-                            state <= STATE_RECV_DATA;
+                            map_addr <= data_index[MAP_BITS-1:0];
+                            map_wbit <= 1'b1;
+                            map_we <= 1'b1;
+                            reply16(RSP_ACK, data_index);
                         end
+                        state <= S_HUNT;
                     end
                 end
-                
-                STATE_RECV_CRC_CMD: begin
-                    if (buffer_data_valid && current_rx_byte == 8'h43) begin
-                        crc_rx_byte_count <= 2'h0;
-                        state <= STATE_RECV_CRC;
+
+                S_VERIFY: begin
+                    if (verify_left == 32'h0) begin
+                        state <= S_VERIFY_DONE;
+                    end else if (!sram_busy && !sram_start) begin
+                        sram_addr <= verify_addr;
+                        sram_wstrb <= 4'h0;
+                        sram_start <= 1'b1;
+                        state <= S_VERIFY_WAIT;
                     end
                 end
-                
-                STATE_RECV_CRC: begin
-                    if (buffer_data_valid) begin
-                        case (crc_rx_byte_count)
-                            2'h0: expected_crc[7:0] <= current_rx_byte;
-                            2'h1: expected_crc[15:8] <= current_rx_byte;
-                            2'h2: expected_crc[23:16] <= current_rx_byte;
-                            2'h3: begin
-                                expected_crc[31:24] <= current_rx_byte;
-                                state <= STATE_VERIFY_CRC;
-                            end
-                        endcase
-                        if (crc_rx_byte_count < 2'h3) begin
-                            crc_rx_byte_count <= crc_rx_byte_count + 1;
+
+                S_VERIFY_WAIT: begin
+                    if (sram_done) begin
+                        verify_addr <= verify_addr + 4;
+                        if (verify_left >= 4) begin
+                            crc_din <= sram_rdata;
+                            crc_calc <= 1'b1;
+                            verify_left <= verify_left - 4;
+                            state <= S_VERIFY;
+                        end else begin
+                            verify_word <= sram_rdata;
+                            state <= S_VERIFY_TAIL;
                         end
                     end
                 end
-                
-                STATE_VERIFY_CRC: begin
-                    // synthesis translate_off
-                    $display("[FW] CRC Verify: calculated=0x%08x, expected=0x%08x", crc_result, expected_crc);
-                    // synthesis translate_on
-                    if (crc_result == expected_crc) begin
-                        // synthesis translate_off
-                        $display("[FW] CRC Match! Sending ACK");
-                        // synthesis translate_on
-                        response_char <= 8'h41 + ack_counter;  // Rotating ACK
-                        ack_counter <= (ack_counter == 5'd25) ? 5'd0 : ack_counter + 1;
-                        send_response <= 1'b1;
-                        next_state <= STATE_COMPLETE;
-                    end else begin
-                        // synthesis translate_off
-                        $display("[FW] CRC Mismatch! Sending NAK");
-                        // synthesis translate_on
-                        response_char <= 8'h4E;  // NAK
-                        send_response <= 1'b1;
-                        nak_reason <= NAK_CRC_MISMATCH;
-                        next_state <= STATE_ERROR;
-                    end
-                    crc_tx_byte_count <= 2'h0;
-                    state <= STATE_SEND_RESP;
+
+                S_VERIFY_TAIL: begin
+                    crc_din <= {24'h0, verify_word[7:0]};
+                    crc_calc_byte <= 1'b1;
+                    verify_word <= {8'h0, verify_word[31:8]};
+                    verify_left <= verify_left - 1'b1;
+                    if (verify_left == 32'h1)
+                        state <= S_VERIFY;
                 end
-                
-                STATE_SEND_RESP: begin
-                    if (!send_response && !uart_tx_valid) begin
-                        // After sending ACK/NAK from CRC verification, send the CRC bytes
-                        if (next_state == STATE_COMPLETE || next_state == STATE_ERROR) begin
-                            state <= STATE_SEND_CRC;
+
+                S_VERIFY_DONE: begin
+                    // The last CRC update has landed by now
+                    if (tx_count == 5'd0) begin
+                        reply32(RSP_DONE, crc_result);
+                        s_size <= 32'h0;
+                        s_crc <= 32'h0;
+                        s_blocks <= 0;
+                        if (crc_result == s_crc) begin
+                            loaded <= 1'b1;
+                            image_size <= s_size;
+                            image_crc <= s_crc;
+                            state <= S_RELEASE;
                         end else begin
-                            state <= next_state;
+                            state <= S_HUNT;    // Stay held: the host may try again
                         end
                     end
                 end
 
-                STATE_SEND_CRC: begin
-                    if (!uart_tx_valid && uart_tx_ready) begin
-                        if (crc_tx_byte_count < 2'h3) begin
-                            // Send bytes 0-2
-                            case (crc_tx_byte_count)
-                                2'h0: uart_tx_data <= crc_result[7:0];
-                                2'h1: uart_tx_data <= crc_result[15:8];
-                                2'h2: uart_tx_data <= crc_result[23:16];
-                            endcase
-                            uart_tx_valid <= 1'b1;
-                            crc_tx_byte_count <= crc_tx_byte_count + 1;
+                S_RELEASE: begin
+                    if (tx_count == 5'd0 && tx_idle && !sram_start && !sram_busy) begin
+                        active <= 1'b0;
+                        state <= S_IDLE;
+                    end
+                end
+
+                S_BAUD_REQ: begin
+                    if (tx_count == 5'd0) begin
+                        if (baud_new == 29'h0) begin
+                            tx_buf <= {120'h0, BAUD_NAK};
+                            tx_count <= 5'd1;
+                            state <= S_HUNT;
                         end else begin
-                            // Send final byte (byte 3)
-                            uart_tx_data <= crc_result[31:24];
-                            uart_tx_valid <= 1'b1;
-                            crc_tx_byte_count <= 2'h0;  // Reset for next upload
-                            state <= STATE_WAIT_TX_DONE;  // Wait for TX to complete
+                            reply32(BAUD_ACK, baud_rate);
+                            state <= S_BAUD_DRAIN;
                         end
                     end
                 end
 
-                STATE_WAIT_TX_DONE: begin
-                    // Wait for UART to finish sending the last byte
-                    if (!uart_tx_valid) begin
-                        state <= next_state;  // Now safe to go to COMPLETE or ERROR
+                S_BAUD_DRAIN: begin
+                    // Switch once 'u' + rate is on the wire
+                    if (tx_count == 5'd0 && tx_idle) begin
+                        baud_old <= baud_reg;
+                        baud_reg <= baud_new;
+                        wait_ms <= SETTLE_MS;
+                        state <= S_BAUD_SETTLE;
                     end
                 end
-                
-                STATE_COMPLETE: begin
-                    cpu_reset <= 1'b0;
-                    done <= 1'b1;
-                    busy <= 1'b0;
-                    state <= STATE_IDLE;
+
+                S_BAUD_SETTLE: begin
+                    // Drop whatever arrived while the host was switching
+                    if (wait_ms == 14'd0) begin
+                        rx_fifo_clear <= 1'b1;
+                        rx_full <= 1'b0;
+                        rx_pending <= 1'b0;
+                        count <= 4'd0;
+                        wait_ms <= TIMEOUT_MS;
+                        state <= S_BAUD_TEST;
+                    end
                 end
-                
-                STATE_ERROR: begin
-                    error <= 1'b1;
-                    busy <= 1'b0;
-                    cpu_reset <= 1'b1;
-                    state <= STATE_IDLE;
+
+                S_BAUD_TEST: begin
+                    if (rx_full) begin
+                        rx_full <= 1'b0;
+                        wait_ms <= TIMEOUT_MS;
+                        count <= count + 1'b1;
+                        if (rx_byte != baud_pattern(count))
+                            state <= S_BAUD_FAIL;
+                        else if (count == 4'd15)
+                            state <= S_BAUD_ECHO;
+                    end else if (wait_ms == 14'd0) begin
+                        state <= S_BAUD_FAIL;
+                    end
                 end
+
+                S_BAUD_ECHO: begin
+                    if (tx_count == 5'd0) begin
+                        for (i = 0; i < 16; i = i + 1)
+                            tx_buf[i * 8 +: 8] <= baud_pattern(i);
+                        tx_count <= 5'd16;
+                        wait_ms <= TIMEOUT_MS;
+                        state <= S_BAUD_COMMIT;
+                    end
+                end
+
+                S_BAUD_COMMIT: begin
+                    if (rx_full && tx_count == 5'd0) begin
+                        rx_full <= 1'b0;
+                        if (rx_byte == BAUD_COMMIT) begin
+                            tx_buf <= {120'h0, BAUD_COMMIT};
+                            tx_count <= 5'd1;
+                            state <= S_HUNT;
+                        end else begin
+                            state <= S_BAUD_FAIL;
+                        end
+                    end else if (wait_ms == 14'd0) begin
+                        state <= S_BAUD_FAIL;
+                    end
+                end
+
+                S_BAUD_FAIL: begin
+                    if (tx_count == 5'd0 && tx_idle) begin
+                        baud_reg <= baud_old;
+                        state <= S_HUNT;
+                    end
+                end
+
+                default: state <= S_IDLE;
             endcase
         end
     end
@@ -0,0 +1,283 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// icache.v - Direct-Mapped Instruction Cache for SRAM Fetches
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+// PURPOSE: Sits between PicoRV32 and mem_controller. Instruction fetches from
+//          external SRAM are served from BRAM; everything else (data, boot
+//          ROM, MMIO) passes straight through to mem_controller.
+//
+// Timing:
+//   Hit:  mem_ready one cycle after mem_valid (BRAM read + tag compare)
+//   Miss: line fill as one sequential SRAM burst (mem_burst) from the start
+//         of the line. The CPU is released as soon as its word arrives; the
+//         rest of the line is filled before the next request is accepted.
+//
+// Coherency:
+//   - SRAM stores from the CPU snoop the tag array and invalidate a hit line
+//   - flush input invalidates the whole cache (cache_control MMIO register)
+//   - the whole cache is invalidated after reset
+//==============================================================================
+
+module icache #(
+    parameter CACHE_BYTES = 2048,       // Total data capacity (power of two)
+    parameter LINE_BYTES  = 16          // Bytes per line (power of two, >= 8)
+) (
+    input wire clk,
+    input wire resetn,
+
+    // PicoRV32 side
+    input wire        cpu_mem_valid,
+    input wire        cpu_mem_instr,
+    output reg        cpu_mem_ready,
+    input wire [31:0] cpu_mem_addr,
+    input wire [31:0] cpu_mem_wdata,
+    input wire [ 3:0] cpu_mem_wstrb,
+    output reg [31:0] cpu_mem_rdata,
+
+    // mem_controller side
+    output reg        mem_valid,
+    output reg        mem_instr,
+    input wire        mem_ready,
+    output reg [31:0] mem_addr,
+    output reg [31:0] mem_wdata,
+    output reg [ 3:0] mem_wstrb,
+    output reg [ 3:0] mem_burst,
+    input wire [31:0] mem_rdata,
+
+    // Control / status
+    input wire        flush,            // Invalidate all lines (pulse)
+    output wire       flush_busy,       // Invalidation in progress
+    output wire       stat_hit,         // Pulse: fetch served from cache
+    output wire       stat_miss         // Pulse: fetch caused a line fill
+);
+
+    //==========================================================================
+    // Geometry
+    //==========================================================================
+    localparam LINES       = CACHE_BYTES / LINE_BYTES;
+    localparam LINE_WORDS  = LINE_BYTES / 4;
+    localparam OFFS_BITS   = $clog2(LINE_BYTES);
+    localparam WORD_BITS   = $clog2(LINE_WORDS);
+    localparam INDEX_BITS  = $clog2(LINES);
+    localparam TAG_BITS    = 19 - OFFS_BITS - INDEX_BITS;  // 512 KB SRAM space
+
+    // Boot ROM lives inside the SRAM decode window and is already BRAM
+    localparam BOOT_BASE = 32'h00040000;
+    localparam BOOT_END  = 32'h00041FFF;
+
+    // State Machine
+    localparam S_IDLE   = 3'h0;
+    localparam S_LOOKUP = 3'h1;
+    localparam S_FILL   = 3'h2;
+    localparam S_PASS   = 3'h3;
+    localparam S_FLUSH  = 3'h4;
+
+    reg [2:0] state;
+
+    //==========================================================================
+    // Address Fields
+    //==========================================================================
+    wire [TAG_BITS-1:0]   cpu_tag   = cpu_mem_addr[18:OFFS_BITS+INDEX_BITS];
+    wire [INDEX_BITS-1:0] cpu_index = cpu_mem_addr[OFFS_BITS+INDEX_BITS-1:OFFS_BITS];
+    wire [WORD_BITS-1:0]  cpu_word  = cpu_mem_addr[OFFS_BITS-1:2];
+
+    wire addr_is_sram = (cpu_mem_addr[31:19] == 13'h0);
+    wire addr_is_boot = (cpu_mem_addr >= BOOT_BASE) && (cpu_mem_addr <= BOOT_END);
+    wire cacheable    = cpu_mem_instr && !(|cpu_mem_wstrb) && addr_is_sram && !addr_is_boot;
+    wire sram_store   = (|cpu_mem_wstrb) && addr_is_sram && !addr_is_boot;
+
+    //==========================================================================
+    // BRAM Arrays (simple dual port, read address always follows the CPU)
+    //==========================================================================
+    reg [31:0]         data_mem [0:LINES*LINE_WORDS-1];
+    reg [TAG_BITS:0]   tag_mem  [0:LINES-1];          // {valid, tag}
+
+    reg [31:0]         data_q;
+    reg [TAG_BITS:0]   tag_q;
+
+    reg                          data_we;
+    reg [INDEX_BITS+WORD_BITS-1:0] data_waddr;
+    reg                          tag_we;
+    reg [INDEX_BITS-1:0]         tag_waddr;
+    reg [TAG_BITS:0]             tag_wdata;
+
+    always @(posedge clk) begin
+        if (data_we)
+            data_mem[data_waddr] <= mem_rdata;
+        data_q <= data_mem[{cpu_index, cpu_word}];
+    end
+
+    always @(posedge clk) begin
+        if (tag_we)
+            tag_mem[tag_waddr] <= tag_wdata;
+        tag_q <= tag_mem[cpu_index];
+    end
+
+    wire tag_hit = tag_q[TAG_BITS] && (tag_q[TAG_BITS-1:0] == cpu_tag);
+
+    //==========================================================================
+    // Line Fill / Flush Bookkeeping
+    //==========================================================================
+    reg [TAG_BITS-1:0]   fill_tag;
+    reg [INDEX_BITS-1:0] fill_index;
+    reg [WORD_BITS-1:0]  fill_word;     // Next word the burst delivers
+    reg [WORD_BITS-1:0]  crit_word;     // Word the CPU is waiting for
+    reg [INDEX_BITS-1:0] flush_index;
+    reg                  flush_pending;
+    reg                  snoop_pending;
+
+    wire fill_last = (fill_word == LINE_WORDS - 1);
+
+    assign flush_busy = (state == S_FLUSH) || flush_pending;
+    assign stat_hit   = (state == S_LOOKUP) && tag_hit;
+    assign stat_miss  = (state == S_LOOKUP) && !tag_hit;
+
+    //==========================================================================
+    // Combinational Bus Routing
+    //==========================================================================
+    always @(*) begin
+        // Pass-through by default
+        mem_valid     = 1'b0;
+        mem_instr     = cpu_mem_instr;
+        mem_addr      = cpu_mem_addr;
+        mem_wdata     = cpu_mem_wdata;
+        mem_wstrb     = cpu_mem_wstrb;
+        mem_burst     = 4'h0;
+        cpu_mem_ready = 1'b0;
+        cpu_mem_rdata = mem_rdata;
+
+        // Array write ports
+        data_we    = 1'b0;
+        data_waddr = {fill_index, fill_word};
+        tag_we     = 1'b0;
+        tag_waddr  = cpu_index;
+        tag_wdata  = {1'b0, {TAG_BITS{1'b0}}};
+
+        case (state)
+            S_IDLE: begin
+                mem_valid = cpu_mem_valid && !cacheable && !flush_pending;
+            end
+
+            S_PASS: begin
+                mem_valid     = cpu_mem_valid;
+                cpu_mem_ready = mem_ready;
+
+                // Store snoop: tag_q now holds the entry for cpu_index
+                if (snoop_pending && tag_hit)
+                    tag_we = 1'b1;
+            end
+
+            S_LOOKUP: begin
+                cpu_mem_ready = tag_hit;
+                cpu_mem_rdata = data_q;
+            end
+
+            S_FILL: begin
+                mem_valid = 1'b1;
+                mem_instr = 1'b1;
+                mem_addr  = {13'h0, fill_tag, fill_index, {WORD_BITS{1'b0}}, 2'b00};
+                mem_wdata = 32'h0;
+                mem_wstrb = 4'h0;
+                mem_burst = LINE_WORDS - 1;
+
+                // Release the CPU as soon as its word arrives
+                cpu_mem_ready = mem_ready && (fill_word == crit_word);
+
+                data_we = mem_ready;
+                if (mem_ready && fill_last) begin
+                    tag_we    = 1'b1;
+                    tag_waddr = fill_index;
+                    tag_wdata = {1'b1, fill_tag};
+                end
+            end
+
+            S_FLUSH: begin
+                tag_we    = 1'b1;
+                tag_waddr = flush_index;
+            end
+
+            default: ;
+        endcase
+    end
+
+    //==========================================================================
+    // Control State Machine
+    //==========================================================================
+    always @(posedge clk) begin
+        if (!resetn) begin
+            state <= S_FLUSH;               // Invalidate everything out of reset
+            flush_index <= 0;
+            flush_pending <= 1'b0;
+            snoop_pending <= 1'b0;
+            fill_tag <= 0;
+            fill_index <= 0;
+            fill_word <= 0;
+            crit_word <= 0;
+        end else begin
+            if (flush)
+                flush_pending <= 1'b1;
+
+            case (state)
+                S_IDLE: begin
+                    if (flush_pending) begin
+                        flush_pending <= 1'b0;
+                        flush_index <= 0;
+                        state <= S_FLUSH;
+                    end else if (cpu_mem_valid) begin
+                        if (cacheable) begin
+                            state <= S_LOOKUP;
+                        end else begin
+                            snoop_pending <= sram_store;
+                            state <= S_PASS;
+                        end
+                    end
+                end
+
+                S_PASS: begin
+                    snoop_pending <= 1'b0;
+                    if (mem_ready)
+                        state <= S_IDLE;
+                end
+
+                S_LOOKUP: begin
+                    if (tag_hit) begin
+                        state <= S_IDLE;
+                    end else begin
+                        fill_tag <= cpu_tag;
+                        fill_index <= cpu_index;
+                        fill_word <= 0;
+                        crit_word <= cpu_word;
+                        state <= S_FILL;
+
+                        // synthesis translate_off
+                        // $display("[ICACHE] miss: addr=0x%08x line=%0d", cpu_mem_addr, cpu_index);
+                        // synthesis translate_on
+                    end
+                end
+
+                S_FILL: begin
+                    if (mem_ready) begin
+                        fill_word <= fill_word + 1'b1;
+                        if (fill_last)
+                            state <= S_IDLE;
+                    end
+                end
+
+                S_FLUSH: begin
+                    flush_index <= flush_index + 1'b1;
+                    if (flush_index == LINES - 1)
+                        state <= S_IDLE;
+                end
+
+                default: state <= S_IDLE;
+            endcase
+        end
+    end
+
+endmodule
@@ -9,6 +9,170 @@
 // Educational and research purposes only
 //==============================================================================
 
+// Kconfig-generated feature switches (scripts/gen_config_vh.sh)
+// Simulation builds pass the equivalent +define+ options instead
+`ifndef SIMULATION
+`include "build/generated/config.vh"
+`endif
+
+`ifndef ICACHE_SIZE
+`define ICACHE_SIZE 2048
+`endif
+
+`ifndef DCACHE_SIZE
+`define DCACHE_SIZE 2048
+`endif
+
+`ifndef SCRATCHPAD_SIZE
+`define SCRATCHPAD_SIZE 4096
+`endif
+
+`ifndef SPI_FIFO_DEPTH
+`define SPI_FIFO_DEPTH 128
+`endif
+
+`ifndef UART_RX_BUF_SIZE
+`define UART_RX_BUF_SIZE 512
+`endif
+
+`ifndef TIMER_CHANNELS
+`define TIMER_CHANNELS 3
+`endif
+
+`ifndef SLIP_CODEC_BUF_SIZE
+`define SLIP_CODEC_BUF_SIZE 2048
+`endif
+
+`ifndef PC_SAMPLER_DEPTH
+`define PC_SAMPLER_DEPTH 512
+`endif
+
+// SPI CRC16/CRC7 accumulators (Kconfig SPI_HW_CRC)
+`ifdef SPI_HW_CRC
+`define SPI_HW_CRC_EN 1
+`else
+`define SPI_HW_CRC_EN 0
+`endif
+
+// Timer-triggered stream mode in the SPI1 DMA engine (Kconfig SPI1_STREAM)
+`ifdef SPI1_STREAM
+`define SPI1_STREAM_EN 1
+`else
+`define SPI1_STREAM_EN 0
+`endif
+
+// SRAM timing profile (Kconfig SRAM_TIMING_*): 0 = 2-cycle, 1 = 1-cycle, 2 = burst
+`ifndef SRAM_TIMING
+`define SRAM_TIMING 0
+`endif
+
+// SRAM write-combining buffer for byte/halfword stores (Kconfig SRAM_WRITE_COMBINE)
+`ifdef SRAM_WRITE_COMBINE
+`define SRAM_WRITE_COMBINE_EN 1
+`else
+`define SRAM_WRITE_COMBINE_EN 0
+`endif
+
+// System clock (Kconfig SYS_CLK_*): EXTCLK / 2 unless SYS_CLK_PLL is defined
+`ifndef SYS_CLK_HZ
+`define SYS_CLK_HZ 50000000
+`endif
+
+// rdcycle/rdinstret counters (Kconfig ENABLE_COUNTERS / ENABLE_COUNTERS64)
+`ifdef ENABLE_COUNTERS
+`define CPU_COUNTERS 1
+`else
+`define CPU_COUNTERS 0
+`endif
+
+`ifdef ENABLE_COUNTERS64
+`define CPU_COUNTERS64 1
+`else
+`define CPU_COUNTERS64 0
+`endif
+
+// ISA / datapath options (Kconfig COMPRESSED_ISA, ENABLE_MUL, ENABLE_FAST_MUL,
+// ENABLE_DIV, BARREL_SHIFTER, TWO_STAGE_SHIFT, REGS_DUALPORT - see configs/profiles/)
+`ifdef COMPRESSED_ISA
+`define CPU_COMPRESSED_ISA 1
+`else
+`define CPU_COMPRESSED_ISA 0
+`endif
+
+`ifdef ENABLE_MUL
+`define CPU_ENABLE_MUL 1
+`else
+`define CPU_ENABLE_MUL 0
+`endif
+
+`ifdef ENABLE_FAST_MUL
+`define CPU_ENABLE_FAST_MUL 1
+`else
+`define CPU_ENABLE_FAST_MUL 0
+`endif
+
+`ifdef ENABLE_DIV
+`define CPU_ENABLE_DIV 1
+`else
+`define CPU_ENABLE_DIV 0
+`endif
+
+`ifdef BARREL_SHIFTER
+`define CPU_BARREL_SHIFTER 1
+`else
+`define CPU_BARREL_SHIFTER 0
+`endif
+
+`ifdef TWO_STAGE_SHIFT
+`define CPU_TWO_STAGE_SHIFT 1
+`else
+`define CPU_TWO_STAGE_SHIFT 0
+`endif
+
+`ifdef REGS_DUALPORT
+`define CPU_REGS_DUALPORT 1
+`else
+`define CPU_REGS_DUALPORT 0
+`endif
+
+// Single-precision FADD/FSUB/FMUL on the PCPI port (Kconfig PCPI_FPU)
+`ifdef PCPI_FPU
+`define CPU_PCPI_FPU 1
+`else
+`define CPU_PCPI_FPU 0
+`endif
+
+// EBREAK, ECALL and illegal instructions raise IRQ[1] (Kconfig CATCH_ILLINSN)
+`ifdef CATCH_ILLINSN
+`define CPU_CATCH_ILLINSN 1
+`else
+`define CPU_CATCH_ILLINSN 0
+`endif
+
+// Execute in place from the configuration flash (Kconfig FLASH_XIP)
+`ifdef FLASH_XIP
+`define MEM_FLASH_XIP 1
+`else
+`define MEM_FLASH_XIP 0
+`endif
+
+`ifdef FLASH_XIP_DUAL
+`define FLASH_XIP_DUAL_EN 1
+`else
+`define FLASH_XIP_DUAL_EN 0
+`endif
+
+// Second core on its own mem_controller port, mailbox (Kconfig DUAL_CORE)
+`ifdef DUAL_CORE
+`define MEM_DUAL_CORE 1
+`else
+`define MEM_DUAL_CORE 0
+`endif
+
+`ifndef CORE1_RESET_ADDR
+`define CORE1_RESET_ADDR 32'h00060000
+`endif
+
 module ice40_picorv32_top (
     // Clock and Reset
     input wire EXTCLK,          // 100MHz external clock (J3)
@@ -23,12 +187,28 @@ module ice40_picorv32_top (
     input wire UART_RX,         // UART Receive (E4)
     output wire UART_TX,        // UART Transmit (B2)
 
+    // Console UART (Kconfig CONSOLE_UART; idle high without it)
+    input wire UART1_RX,        // Console Receive (F4)
+    output wire UART1_TX,       // Console Transmit (D2)
+
     // SPI Interface
     output wire SPI_SCK,        // SPI Clock (F5)
     output wire SPI_MOSI,       // SPI Master Out Slave In (B1)
     input wire SPI_MISO,        // SPI Master In Slave Out (C1)
     output wire SPI_CS,         // SPI Chip Select (C2)
 
+    // Second SPI bus (Kconfig SPI1_MASTER; idle without it)
+    output wire SPI1_SCK,       // SPI1 Clock (G5)
+    output wire SPI1_MOSI,      // SPI1 Master Out Slave In (D1)
+    input wire SPI1_MISO,       // SPI1 Master In Slave Out (G4)
+    output wire SPI1_CS,        // SPI1 Chip Select (E3)
+
+    // Configuration SPI Flash (user I/O after configuration)
+    output wire FLASH_SCK,      // Flash clock (R11)
+    output wire FLASH_CS_N,     // Flash chip select (R12)
+    inout wire FLASH_IO0,       // Flash DI / dual-read IO0 (P12)
+    input wire FLASH_IO1,       // Flash DO (P11)
+
     // SRAM Interface (K6R4016V1D-TC10)
     output wire [17:0] SA,      // SRAM Address bus
     inout wire [15:0] SD,       // SRAM Data bus
@@ -38,24 +218,53 @@ module ice40_picorv32_top (
 );
 
     // Clock and reset management
+`ifdef SYS_CLK_PLL
+    // SB_PLL40_CORE: 100 MHz crystal -> `SYS_CLK_HZ Hz system clock
+    // (DIVR/DIVF/DIVQ/FILTER_RANGE from scripts/gen_config_vh.sh)
+    wire clk;
+    wire pll_lock;
+
+    SB_PLL40_CORE #(
+        .FEEDBACK_PATH("SIMPLE"),
+        .PLLOUT_SELECT("GENCLK"),
+        .DIVR(`PLL_DIVR),
+        .DIVF(`PLL_DIVF),
+        .DIVQ(`PLL_DIVQ),
+        .FILTER_RANGE(`PLL_FILTER_RANGE)
+    ) sys_pll (
+        .REFERENCECLK(EXTCLK),
+        .PLLOUTGLOBAL(clk),
+        .LOCK(pll_lock),
+        .RESETB(1'b1),
+        .BYPASS(1'b0)
+    );
+`else
     // Divide 100 MHz crystal by 2 to get 50 MHz system clock (meets timing at 67.84 MHz max)
     reg clk_div = 0;
     always @(posedge EXTCLK) begin
         clk_div <= ~clk_div;
     end
     wire clk = clk_div;
+    wire pll_lock = 1'b1;
+`endif
 
+    // Reset is held until the clock is stable and then for 255 cycles
     reg [7:0] reset_counter = 0;
     wire global_resetn = &reset_counter;
 
     always @(posedge clk) begin
-        if (!global_resetn)
+        if (!pll_lock)
+            reset_counter <= 0;
+        else if (!global_resetn)
             reset_counter <= reset_counter + 1;
     end
 
-    // CPU reset tied to global reset
+    // CPU reset: global reset, the hardware loader holding the CPU while
+    // it writes SRAM (Kconfig HW_LOADER), or a watchdog expiry
     // Bootloader ROM is BRAM initialized at synthesis time, so no boot delay needed
-    wire cpu_resetn = global_resetn;
+    wire loader_active;
+    wire wdt_cpu_reset;
+    wire cpu_resetn = global_resetn && !loader_active && !wdt_cpu_reset;
 
     // Button synchronizers (2-stage, using global reset, not cpu reset)
     // Active-low buttons inverted to active-high (1 = pressed)
@@ -91,21 +300,63 @@ module ice40_picorv32_top (
     wire [7:0] mmio_uart_tx_data;
     wire mmio_uart_tx_valid;
 
-    // UART TX direct from MMIO (no multiplexing needed)
-    wire [7:0] uart_tx_data_mux = mmio_uart_tx_data;
-    wire uart_tx_valid_mux = mmio_uart_tx_valid;
+    // SLIP codec (Kconfig SLIP_CODEC): escaped TX bytes share the TX FIFO,
+    // and while slip_rx_active RX bytes go to its frame buffer instead
+    wire [7:0] slip_tx_data;
+    wire slip_tx_valid;
+    wire slip_rx_active;
+    wire slip_irq;
+
+    // Hardware loader (Kconfig HW_LOADER): while loader_active it reads the
+    // RX FIFO, pushes replies into the TX FIFO and sets the UART rate
+    wire [7:0] loader_tx_data;
+    wire loader_tx_valid;
+    wire loader_rx_rd_en;
+    wire loader_rx_clear;
+
+    // UART TX FIFO: MMIO stores push, the UART core drains it
+    localparam UART_TX_FIFO_BITS = 9;   // 512 bytes (one EBR)
+
+    wire [7:0] uart_txq_rd_data;
+    wire uart_txq_full, uart_txq_empty;
+    wire [UART_TX_FIFO_BITS:0] uart_txq_level;
+    reg  uart_txq_settled;              // Head byte valid (read lags a cycle)
+    wire uart_txq_start = uart_txq_settled && !uart_txq_empty && !uart_tx_busy;
+
+    always @(posedge clk) begin
+        if (!global_resetn)
+            uart_txq_settled <= 1'b0;
+        else
+            uart_txq_settled <= !uart_txq_empty && !uart_txq_start;
+    end
+
+    wire [7:0] uart_tx_data_mux = uart_txq_rd_data;
+    wire uart_tx_valid_mux = uart_txq_start;
+
+    // UART Core (baud rate set at run time by uart_peripheral's BAUD register)
+    // Fractional divider in 16.8 clocks per oversampling tick, so the reset
+    // rate is exact at any system clock; firmware and the bootloaders raise
+    // it after the lib/uart_baud.h handshake
+    localparam UART_BAUD_RATE  = 1_000_000;     // 1 Mbaud for FAST streaming
+    localparam UART_BIT_CYCLES = `SYS_CLK_HZ / UART_BAUD_RATE;
+    localparam UART_OS_RATE    = 16;
+    localparam UART_BAUD_DIV   = ((`SYS_CLK_HZ / 1000) * 256) /
+                                 ((UART_BAUD_RATE / 1000) * UART_OS_RATE);
+
+    wire [23:0] uart_baud_div;
+    wire [ 4:0] uart_os_rate;
+    wire [23:0] uart_core_baud_div;     // uart_baud_div unless the loader holds the CPU
+    wire [ 4:0] uart_core_os_rate;
 
-    // UART Core (50 MHz clock after divide-by-2)
     uart #(
-        .CLK_FREQ(50_000_000),
-        .BAUD_RATE(1_000_000),  // 1 Mbaud for FAST streaming
-        .OS_RATE(16),
         .D_WIDTH(8),
         .PARITY(0),
         .PARITY_EO(1'b0)
     ) uart_core (
         .clk(clk),
         .reset_n(global_resetn),
+        .baud_div(uart_core_baud_div),
+        .os_rate(uart_core_os_rate),
         .tx_ena(uart_tx_valid_mux),
         .tx_data(uart_tx_data_mux),
         .rx(UART_RX),
@@ -120,32 +371,55 @@ module ice40_picorv32_top (
     // Circular Buffer for UART RX
     // UART RX Circular Buffer
     // Buffer shared between bootloader and application UART access
+    localparam UART_RX_FIFO_BITS = $clog2(`UART_RX_BUF_SIZE);   // Kconfig UART_RX_BUF_SIZE
+
     wire mmio_buffer_rd_en;
     wire [7:0] buffer_rd_data;
     wire buffer_full, buffer_empty;
-    wire buffer_wr_en = uart_rx_data_valid && !buffer_full;
-    wire buffer_rd_en = mmio_buffer_rd_en;
+    wire [UART_RX_FIFO_BITS:0] buffer_level;
+    wire buffer_wr_en = uart_rx_data_valid && !buffer_full && !slip_rx_active;
+    wire buffer_rd_en = loader_active ? loader_rx_rd_en : mmio_buffer_rd_en;
+
+    // Dropped bytes (buffer full) and bad stop bits, counted in RX_STATUS
+    wire uart_rx_overflow = uart_rx_data_valid && buffer_full && !slip_rx_active;
+    wire uart_rx_frame_error = uart_rx_data_valid && uart_rx_error;
 
     circular_buffer #(
         .DATA_WIDTH(8),
-        .ADDR_BITS(8)  // 256 bytes buffer (increased from 64)
+        .ADDR_BITS(UART_RX_FIFO_BITS)  // 256 bytes - 4 KB (EBR)
     ) uart_circular_buffer (
         .clk(clk),
         .reset_n(global_resetn),
-        .clear(1'b0),  // No buffer clear needed without shell
+        .clear(loader_rx_clear),  // Hardware loader drops what the CPU left unread
         .wr_en(buffer_wr_en),
         .wr_data(uart_rx_data),
         .full(buffer_full),
         .rd_en(buffer_rd_en),
         .rd_data(buffer_rd_data),
-        .empty(buffer_empty)
+        .empty(buffer_empty),
+        .level(buffer_level)
     );
 
-    // SRAM 16-bit driver interface
-    // No shell anymore - only firmware loader and CPU
-    // NOTE: Using unified SRAM controller (optimized, 4-7 cycle access)
-    // Old 3-layer design removed: sram_driver_new + sram_proc_new
-    // (can revert to v0.12-baseline-tests tag if needed)
+    // UART TX Circular Buffer
+    circular_buffer #(
+        .DATA_WIDTH(8),
+        .ADDR_BITS(UART_TX_FIFO_BITS)
+    ) uart_tx_buffer (
+        .clk(clk),
+        .reset_n(global_resetn),
+        .clear(1'b0),
+        .wr_en(mmio_uart_tx_valid || slip_tx_valid || loader_tx_valid),
+        .wr_data(loader_tx_valid ? loader_tx_data :
+                 slip_tx_valid ? slip_tx_data : mmio_uart_tx_data),
+        .full(uart_txq_full),
+        .rd_en(uart_txq_start),
+        .rd_data(uart_txq_rd_data),
+        .empty(uart_txq_empty),
+        .level(uart_txq_level)
+    );
+
+    // SRAM 16-bit interface: sram_controller, shared by the hardware
+    // loader and the CPU (mem_controller)
 
     // ========================================
     // PicoRV32 CPU + Memory-Mapped I/O
@@ -160,30 +434,58 @@ module ice40_picorv32_top (
     wire [ 3:0] cpu_mem_wstrb;
     wire [31:0] cpu_mem_rdata;
 
+    // PicoRV32 Look-Ahead Interface (one cycle ahead of mem_valid)
+    wire        cpu_mem_la_read;
+    wire        cpu_mem_la_write;
+    wire [31:0] cpu_mem_la_addr;
+    wire [31:0] cpu_mem_la_wdata;
+    wire [ 3:0] cpu_mem_la_wstrb;
+
     // Interrupt signals from peripherals
     wire timer_irq;     // IRQ[0]: Timer periodic tick (100 Hz)
     reg soft_irq;       // IRQ[1]: Software interrupt / trap / FreeRTOS yield
-    wire spi_irq;       // IRQ[2]: SPI transfer complete
+    wire spi_irq;       // IRQ[2]: SPI transfer complete / SPI DMA done
+    wire mem_dma_irq;   // IRQ[3]: Memory DMA copy/fill done
+    wire uart_rx_irq;   // IRQ[4]: UART RX available / watermark / idle, SLIP frame
+    wire uart_rx_irq_core;
+    wire uart_tx_irq;   // IRQ[5]: UART TX FIFO at low watermark
+    wire button_irq;    // IRQ[6]: BUT1/BUT2 debounced press/release (off after reset)
+    wire but_press_edge; // Raw BUT1/BUT2 press edge (timer capture input)
+    wire timers_irq;    // IRQ[7]: Timer channels 1-3, watchdog pre-timeout
+    wire uart1_irq;     // IRQ[8]: Console UART RX / TX (CPU only, no controller source)
+    wire mailbox_irq;   // IRQ[9]: Message from core 1 (CPU only, Kconfig DUAL_CORE)
+    wire spi1_irq;      // IRQ[10]: SPI1 transfer complete / DMA done (CPU only, Kconfig SPI1_MASTER)
+    wire [7:0] cpu_irq; // Sources gated by the interrupt controller ENABLE
 
-    // PicoRV32 CPU Core - RV32I (32 regs) with MUL/DIV, barrel shifter, and interrupts
+    // PicoRV32 CPU Core - RV32I (32 regs) with interrupts; MUL/DIV, shifter and RV32C
+    // come from the Kconfig build profile (make bitstream-speed / bitstream-area)
     // Boots from bootloader at 0x40000, which then jumps to firmware at 0x0
+    wire        pcpi_valid;
+    wire [31:0] pcpi_insn;
+    wire [31:0] pcpi_rs1;
+    wire [31:0] pcpi_rs2;
+    wire        pcpi_wr;
+    wire [31:0] pcpi_rd;
+    wire        pcpi_wait;
+    wire        pcpi_ready;
+
     picorv32 #(
-        .ENABLE_COUNTERS(0),
-        .ENABLE_COUNTERS64(0),
+        .ENABLE_COUNTERS(`CPU_COUNTERS),        // rdcycle/rdinstret (lib/perf_counters.h)
+        .ENABLE_COUNTERS64(`CPU_COUNTERS64),    // rdcycleh/rdinstreth
         .ENABLE_REGS_16_31(1),          // RV32I: full 32 registers (x0-x31)
-        .ENABLE_REGS_DUALPORT(0),
+        .ENABLE_REGS_DUALPORT(`CPU_REGS_DUALPORT),  // rs1 and rs2 in one cycle (2x regfile EBR)
         .LATCHED_MEM_RDATA(0),
-        .TWO_STAGE_SHIFT(0),            // Disable slow shifter when using barrel shifter
-        .BARREL_SHIFTER(1),             // Fast single-cycle shifts
+        .TWO_STAGE_SHIFT(`CPU_TWO_STAGE_SHIFT),  // 4-then-1 bit/cycle shifts without barrel
+        .BARREL_SHIFTER(`CPU_BARREL_SHIFTER),    // Fast single-cycle shifts
         .TWO_CYCLE_COMPARE(0),
         .TWO_CYCLE_ALU(0),
-        .COMPRESSED_ISA(0),
+        .COMPRESSED_ISA(`CPU_COMPRESSED_ISA),    // RV32C decoder
         .CATCH_MISALIGN(0),
-        .CATCH_ILLINSN(0),
-        .ENABLE_PCPI(0),
-        .ENABLE_MUL(1),                 // Enable multiply instructions
-        .ENABLE_FAST_MUL(0),
-        .ENABLE_DIV(1),                 // Enable divide instructions
+        .CATCH_ILLINSN(`CPU_CATCH_ILLINSN),
+        .ENABLE_PCPI(`CPU_PCPI_FPU),             // External co-processor (pcpi_fpu.v)
+        .ENABLE_MUL(`CPU_ENABLE_MUL),            // Sequential shift-add multiplier
+        .ENABLE_FAST_MUL(`CPU_ENABLE_FAST_MUL),  // Pipelined multiplier (replaces the above)
+        .ENABLE_DIV(`CPU_ENABLE_DIV),            // Enable divide instructions
         .ENABLE_IRQ(1),                 // Enable interrupt support
         .ENABLE_IRQ_QREGS(1),           // Enable IRQ shadow registers (q0-q3)
         .ENABLE_IRQ_TIMER(1),           // Enable IRQ timer register
@@ -213,25 +515,46 @@ module ice40_picorv32_top (
         .mem_wstrb(cpu_mem_wstrb),
         .mem_rdata(cpu_mem_rdata),
 
-        .mem_la_read(),
-        .mem_la_write(),
-        .mem_la_addr(),
-        .mem_la_wdata(),
-        .mem_la_wstrb(),
-
-        .pcpi_valid(),
-        .pcpi_insn(),
-        .pcpi_rs1(),
-        .pcpi_rs2(),
-        .pcpi_wr(1'b0),
-        .pcpi_rd(32'h0),
-        .pcpi_wait(1'b0),
-        .pcpi_ready(1'b0),
-
-        .irq({29'h0, spi_irq, soft_irq, timer_irq}),  // IRQ[2]=SPI, IRQ[1]=software, IRQ[0]=timer
+        .mem_la_read(cpu_mem_la_read),
+        .mem_la_write(cpu_mem_la_write),
+        .mem_la_addr(cpu_mem_la_addr),
+        .mem_la_wdata(cpu_mem_la_wdata),
+        .mem_la_wstrb(cpu_mem_la_wstrb),
+
+        .pcpi_valid(pcpi_valid),
+        .pcpi_insn(pcpi_insn),
+        .pcpi_rs1(pcpi_rs1),
+        .pcpi_rs2(pcpi_rs2),
+        .pcpi_wr(pcpi_wr),
+        .pcpi_rd(pcpi_rd),
+        .pcpi_wait(pcpi_wait),
+        .pcpi_ready(pcpi_ready),
+
+        .irq({21'h0, spi1_irq, mailbox_irq, uart1_irq, cpu_irq}),  // IRQ[10]=SPI1, IRQ[9]=mailbox, IRQ[8]=console UART, IRQ[7]=timers 1-3, IRQ[6]=button, IRQ[5:4]=UART TX/RX, IRQ[3]=mem DMA, IRQ[2]=SPI, IRQ[1]=software, IRQ[0]=timer
         .eoi()  // EOI not used
     );
 
+    // PCPI FPU (Kconfig PCPI_FPU): custom-1 FADD/FSUB/FMUL, lib/pcpi_fpu.h
+`ifdef PCPI_FPU
+    pcpi_fpu fpu (
+        .clk(clk),
+        .resetn(cpu_resetn),
+        .pcpi_valid(pcpi_valid),
+        .pcpi_insn(pcpi_insn),
+        .pcpi_rs1(pcpi_rs1),
+        .pcpi_rs2(pcpi_rs2),
+        .pcpi_wr(pcpi_wr),
+        .pcpi_rd(pcpi_rd),
+        .pcpi_wait(pcpi_wait),
+        .pcpi_ready(pcpi_ready)
+    );
+`else
+    assign pcpi_wr    = 1'b0;
+    assign pcpi_rd    = 32'h0;
+    assign pcpi_wait  = 1'b0;
+    assign pcpi_ready = 1'b0;
+`endif
+
     // Bootloader ROM signals
     wire        boot_enable;
     wire [12:0] boot_addr;
@@ -247,6 +570,29 @@ module ice40_picorv32_top (
         .rdata(boot_rdata)
     );
 
+    // Scratchpad RAM signals
+    wire [12:0] spad_addr;
+    wire [ 3:0] spad_we;
+    wire [31:0] spad_wdata;
+    wire [31:0] spad_rdata;
+
+    // Scratchpad RAM - BRAM at 0x80000 for .fastcode / .fastdata
+    scratchpad_ram #(
+        .BYTES(`SCRATCHPAD_SIZE)
+    ) spad_ram (
+        .clk(clk),
+        .addr(spad_addr),
+        .we(spad_we),
+        .wdata(spad_wdata),
+        .rdata(spad_rdata)
+    );
+
+    // SPI flash read port (spi_flash_xip, Kconfig FLASH_XIP)
+    wire        flash_start;
+    wire [23:0] flash_addr;
+    wire        flash_done;
+    wire [31:0] flash_rdata;
+
     // Memory Controller signals
     wire        mem_ctrl_sram_start;
     wire        mem_ctrl_sram_busy;
@@ -255,6 +601,7 @@ module ice40_picorv32_top (
     wire [31:0] mem_ctrl_sram_addr;
     wire [31:0] mem_ctrl_sram_wdata;
     wire [ 3:0] mem_ctrl_sram_wstrb;
+    wire [ 3:0] mem_ctrl_sram_burst;
     wire [31:0] mem_ctrl_sram_rdata;
 
     // MMIO signals
@@ -266,12 +613,71 @@ module ice40_picorv32_top (
     wire [31:0] mmio_rdata;
     wire        mmio_ready;
 
-    // Memory Controller - Routes CPU to SRAM, Bootloader ROM, or MMIO
-    mem_controller mem_ctrl (
+    // DMA master port into mem_controller (mem_dma, with spi_dma behind it)
+    wire        dma_mem_valid;
+    wire        dma_mem_ready;
+    wire [31:0] dma_mem_addr;
+    wire [31:0] dma_mem_wdata;
+    wire [ 3:0] dma_mem_wstrb;
+    wire [ 3:0] dma_mem_burst;
+    wire [31:0] dma_mem_rdata;
+
+    // Second core's port into mem_controller (core1, Kconfig DUAL_CORE)
+    wire        c1_mem_valid;
+    wire        c1_mem_ready;
+    wire [31:0] c1_mem_addr;
+    wire [31:0] c1_mem_wdata;
+    wire [ 3:0] c1_mem_wstrb;
+    wire [31:0] c1_mem_rdata;
+
+    // SPI DMA master port into mem_dma (spi_up_*: after the SPI0/SPI1 arbiter)
+    wire        spi_up_valid;
+    wire        spi_up_ready;
+    wire [31:0] spi_up_addr;
+    wire [31:0] spi_up_wdata;
+    wire [ 3:0] spi_up_wstrb;
+    wire [31:0] spi_up_rdata;
+    wire        spi_dma_mem_valid;
+    wire        spi_dma_mem_ready;
+    wire [31:0] spi_dma_mem_addr;
+    wire [31:0] spi_dma_mem_wdata;
+    wire [ 3:0] spi_dma_mem_wstrb;
+    wire [31:0] spi_dma_mem_rdata;
+
+    // Performance Monitor taps from mem_controller
+    wire        mem_stat_sram_wait;
+    wire        mem_stat_mmio_wait;
+    wire        mem_stat_boot_wait;
+    wire        mem_stat_spad;
+
+    //==========================================================================
+    // Instruction Cache (optional, Kconfig ICACHE)
+    //==========================================================================
+    // Bus between the I-cache and the data cache
+    wire        ic_mem_valid;
+    wire        ic_mem_instr;
+    wire        ic_mem_ready;
+    wire [31:0] ic_mem_addr;
+    wire [31:0] ic_mem_wdata;
+    wire [ 3:0] ic_mem_wstrb;
+    wire [ 3:0] ic_mem_burst;
+    wire [31:0] ic_mem_rdata;
+
+    wire        icache_flush;
+    wire        icache_busy;
+    wire        icache_stat_hit;
+    wire        icache_stat_miss;
+
+`ifdef ENABLE_ICACHE
+    localparam ICACHE_BYTES = `ICACHE_SIZE;
+
+    icache #(
+        .CACHE_BYTES(ICACHE_BYTES),
+        .LINE_BYTES(16)
+    ) icache_inst (
         .clk(clk),
         .resetn(cpu_resetn),
 
-        // PicoRV32 Interface
         .cpu_mem_valid(cpu_mem_valid),
         .cpu_mem_instr(cpu_mem_instr),
         .cpu_mem_ready(cpu_mem_ready),
@@ -280,12 +686,189 @@ module ice40_picorv32_top (
         .cpu_mem_wstrb(cpu_mem_wstrb),
         .cpu_mem_rdata(cpu_mem_rdata),
 
+        .mem_valid(ic_mem_valid),
+        .mem_instr(ic_mem_instr),
+        .mem_ready(ic_mem_ready),
+        .mem_addr(ic_mem_addr),
+        .mem_wdata(ic_mem_wdata),
+        .mem_wstrb(ic_mem_wstrb),
+        .mem_burst(ic_mem_burst),
+        .mem_rdata(ic_mem_rdata),
+
+        .flush(icache_flush),
+        .flush_busy(icache_busy),
+        .stat_hit(icache_stat_hit),
+        .stat_miss(icache_stat_miss)
+    );
+`else
+    localparam ICACHE_BYTES = 0;
+
+    // No I-cache: CPU bus goes straight to the data cache
+    assign ic_mem_valid = cpu_mem_valid;
+    assign ic_mem_instr = cpu_mem_instr;
+    assign ic_mem_addr  = cpu_mem_addr;
+    assign ic_mem_wdata = cpu_mem_wdata;
+    assign ic_mem_wstrb = cpu_mem_wstrb;
+    assign ic_mem_burst = 4'h0;
+    assign cpu_mem_ready  = ic_mem_ready;
+    assign cpu_mem_rdata  = ic_mem_rdata;
+    assign icache_busy    = 1'b0;
+    assign icache_stat_hit  = 1'b0;
+    assign icache_stat_miss = 1'b0;
+`endif
+
+    //==========================================================================
+    // Data Cache (optional, Kconfig DCACHE)
+    //==========================================================================
+    // Bus between the data cache and the memory controller
+    wire        ctrl_mem_valid;
+    wire        ctrl_mem_instr;
+    wire        ctrl_mem_ready;
+    wire [31:0] ctrl_mem_addr;
+    wire [31:0] ctrl_mem_wdata;
+    wire [ 3:0] ctrl_mem_wstrb;
+    wire [ 3:0] ctrl_mem_burst;
+    wire [31:0] ctrl_mem_rdata;
+
+    wire        dcache_op_start;
+    wire        dcache_op_clean;
+    wire        dcache_op_inval;
+    wire [31:0] dcache_op_addr;
+    wire [31:0] dcache_op_len;
+    wire        dcache_busy;
+    wire        dcache_stat_hit;
+    wire        dcache_stat_miss;
+
+`ifdef ENABLE_DCACHE
+    localparam DCACHE_BYTES = `DCACHE_SIZE;
+
+    dcache #(
+        .CACHE_BYTES(DCACHE_BYTES),
+        .LINE_BYTES(16)
+    ) dcache_inst (
+        .clk(clk),
+        .resetn(cpu_resetn),
+
+        .cpu_mem_valid(ic_mem_valid),
+        .cpu_mem_instr(ic_mem_instr),
+        .cpu_mem_ready(ic_mem_ready),
+        .cpu_mem_addr(ic_mem_addr),
+        .cpu_mem_wdata(ic_mem_wdata),
+        .cpu_mem_wstrb(ic_mem_wstrb),
+        .cpu_mem_burst(ic_mem_burst),
+        .cpu_mem_rdata(ic_mem_rdata),
+
+        .mem_valid(ctrl_mem_valid),
+        .mem_instr(ctrl_mem_instr),
+        .mem_ready(ctrl_mem_ready),
+        .mem_addr(ctrl_mem_addr),
+        .mem_wdata(ctrl_mem_wdata),
+        .mem_wstrb(ctrl_mem_wstrb),
+        .mem_burst(ctrl_mem_burst),
+        .mem_rdata(ctrl_mem_rdata),
+
+        .op_start(dcache_op_start),
+        .op_clean(dcache_op_clean),
+        .op_inval(dcache_op_inval),
+        .op_addr(dcache_op_addr),
+        .op_len(dcache_op_len),
+        .op_busy(dcache_busy),
+        .stat_hit(dcache_stat_hit),
+        .stat_miss(dcache_stat_miss)
+    );
+`else
+    localparam DCACHE_BYTES = 0;
+
+    // No D-cache: straight to the memory controller
+    assign ctrl_mem_valid = ic_mem_valid;
+    assign ctrl_mem_instr = ic_mem_instr;
+    assign ctrl_mem_addr  = ic_mem_addr;
+    assign ctrl_mem_wdata = ic_mem_wdata;
+    assign ctrl_mem_wstrb = ic_mem_wstrb;
+    assign ctrl_mem_burst = ic_mem_burst;
+    assign ic_mem_ready   = ctrl_mem_ready;
+    assign ic_mem_rdata   = ctrl_mem_rdata;
+    assign dcache_busy    = 1'b0;
+    assign dcache_stat_hit  = 1'b0;
+    assign dcache_stat_miss = 1'b0;
+`endif
+
+    // Look-ahead only applies when the CPU talks to mem_controller directly;
+    // with a cache in between the mem_la_* outputs describe the wrong bus.
+`ifdef ENABLE_MEM_LOOKAHEAD
+`ifdef ENABLE_ICACHE
+    localparam MEM_LOOKAHEAD = 0;
+`elsif ENABLE_DCACHE
+    localparam MEM_LOOKAHEAD = 0;
+`else
+    localparam MEM_LOOKAHEAD = 1;
+`endif
+`else
+    localparam MEM_LOOKAHEAD = 0;
+`endif
+
+    // Memory Controller - Routes CPU to SRAM, Bootloader ROM, Scratchpad,
+    // SPI flash or MMIO
+    mem_controller #(
+        .LOOKAHEAD(MEM_LOOKAHEAD),
+        .FLASH_XIP(`MEM_FLASH_XIP),
+        .DUAL_CORE(`MEM_DUAL_CORE)
+    ) mem_ctrl (
+        .clk(clk),
+        .resetn(cpu_resetn),
+
+        // PicoRV32 Interface (through I/D caches when enabled)
+        .cpu_mem_valid(ctrl_mem_valid),
+        .cpu_mem_instr(ctrl_mem_instr),
+        .cpu_mem_ready(ctrl_mem_ready),
+        .cpu_mem_addr(ctrl_mem_addr),
+        .cpu_mem_wdata(ctrl_mem_wdata),
+        .cpu_mem_wstrb(ctrl_mem_wstrb),
+        .cpu_mem_burst(ctrl_mem_burst),
+        .cpu_mem_rdata(ctrl_mem_rdata),
+
+        // PicoRV32 Look-Ahead (ignored unless LOOKAHEAD=1)
+        .cpu_la_read(cpu_mem_la_read),
+        .cpu_la_write(cpu_mem_la_write),
+        .cpu_la_addr(cpu_mem_la_addr),
+        .cpu_la_wdata(cpu_mem_la_wdata),
+        .cpu_la_wstrb(cpu_mem_la_wstrb),
+
+        // DMA master (mem_dma + spi_dma, SRAM only)
+        .dma_valid(dma_mem_valid),
+        .dma_ready(dma_mem_ready),
+        .dma_addr(dma_mem_addr),
+        .dma_wdata(dma_mem_wdata),
+        .dma_wstrb(dma_mem_wstrb),
+        .dma_burst(dma_mem_burst),
+        .dma_rdata(dma_mem_rdata),
+
+        // Second core (SRAM and MMIO; ignored unless DUAL_CORE=1)
+        .c1_valid(c1_mem_valid),
+        .c1_ready(c1_mem_ready),
+        .c1_addr(c1_mem_addr),
+        .c1_wdata(c1_mem_wdata),
+        .c1_wstrb(c1_mem_wstrb),
+        .c1_rdata(c1_mem_rdata),
+
         // Bootloader ROM Interface (read-only)
         .boot_enable(boot_enable),
         .boot_addr(boot_addr),
         .boot_rdata(boot_rdata),
 
-        // SRAM Interface (via sram_proc_new)
+        // Scratchpad RAM Interface
+        .spad_addr(spad_addr),
+        .spad_we(spad_we),
+        .spad_wdata(spad_wdata),
+        .spad_rdata(spad_rdata),
+
+        // SPI Flash Read Interface
+        .flash_start(flash_start),
+        .flash_addr(flash_addr),
+        .flash_done(flash_done),
+        .flash_rdata(flash_rdata),
+
+        // SRAM Interface (via sram_controller)
         .sram_start(mem_ctrl_sram_start),
         .sram_busy(mem_ctrl_sram_busy),
         .sram_done(mem_ctrl_sram_done),
@@ -293,6 +876,7 @@ module ice40_picorv32_top (
         .sram_addr(mem_ctrl_sram_addr),
         .sram_wdata(mem_ctrl_sram_wdata),
         .sram_wstrb(mem_ctrl_sram_wstrb),
+        .sram_burst(mem_ctrl_sram_burst),
         .sram_rdata(mem_ctrl_sram_rdata),
 
         // MMIO Interface
@@ -302,18 +886,36 @@ module ice40_picorv32_top (
         .mmio_wdata(mmio_wdata),
         .mmio_wstrb(mmio_wstrb),
         .mmio_rdata(mmio_rdata),
-        .mmio_ready(mmio_ready)
+        .mmio_ready(mmio_ready),
+
+        // Performance Monitor
+        .stat_sram_wait(mem_stat_sram_wait),
+        .stat_mmio_wait(mem_stat_mmio_wait),
+        .stat_boot_wait(mem_stat_boot_wait),
+        .stat_spad(mem_stat_spad)
     );
 
-    // Unified SRAM Controller (via adapter for mem_controller compatibility)
-    sram_unified_adapter sram_unified (
+    // Hardware loader SRAM port: takes the controller while loader_active
+    wire        loader_sram_start;
+    wire [31:0] loader_sram_addr;
+    wire [31:0] loader_sram_wdata;
+    wire [ 3:0] loader_sram_wstrb;
+
+    // SRAM Controller, timing profile from Kconfig (SRAM_TIMING)
+    // On the global reset: it finishes a CPU access the loader interrupts,
+    // and bytes still in its write-combining buffer survive a CPU reset
+    sram_controller #(
+        .TIMING(`SRAM_TIMING),
+        .WRITE_COMBINE(`SRAM_WRITE_COMBINE_EN)
+    ) sram_ctrl (
         .clk(clk),
-        .resetn(cpu_resetn),
-        .start(mem_ctrl_sram_start),
+        .resetn(global_resetn),
+        .start(loader_active ? loader_sram_start : mem_ctrl_sram_start),
         .cmd(mem_ctrl_sram_cmd),
-        .addr_in(mem_ctrl_sram_addr),
-        .data_in(mem_ctrl_sram_wdata),
-        .mem_wstrb(mem_ctrl_sram_wstrb),
+        .addr_in(loader_active ? loader_sram_addr : mem_ctrl_sram_addr),
+        .data_in(loader_active ? loader_sram_wdata : mem_ctrl_sram_wdata),
+        .mem_wstrb(loader_active ? loader_sram_wstrb : mem_ctrl_sram_wstrb),
+        .burst(loader_active ? 4'h0 : mem_ctrl_sram_burst),
         .busy(mem_ctrl_sram_busy),
         .done(mem_ctrl_sram_done),
         .result(mem_ctrl_sram_rdata),
@@ -331,50 +933,70 @@ module ice40_picorv32_top (
     localparam ADDR_BUTTON_INPUT = 32'h80000018;
     localparam ADDR_SOFT_IRQ_W   = 32'h80000040;
 
-    wire addr_is_uart     = (mmio_addr[31:4] == 28'h8000000);  // 0x80000000-0x8000000F
+    wire addr_is_uart     = (mmio_addr[31:4] == 28'h8000000) ||  // 0x80000000-0x8000000F
+                            (mmio_addr[31:4] == 28'h8000012) ||  // 0x80000120-0x8000012F (IRQ)
+                            (mmio_addr[31:4] == 28'h8000013);    // 0x80000130-0x8000013F (baud)
+    wire addr_is_uart1    = (mmio_addr[31:4] == 28'h8000023) ||  // 0x80000230-0x8000023F
+                            (mmio_addr[31:5] == 27'h4000012);    // 0x80000240-0x8000025F (IRQ, baud)
     wire addr_is_simple   = (mmio_addr == ADDR_LED_CONTROL) ||
                             (mmio_addr == ADDR_BUTTON_INPUT) ||
                             (mmio_addr == ADDR_SOFT_IRQ_W);
-    wire addr_is_timer    = (mmio_addr[31:4] == 28'h8000002);  // 0x80000020-0x8000002F
-    wire addr_is_spi      = (mmio_addr[31:4] == 28'h8000005);  // 0x80000050-0x8000005F
+    wire addr_is_timer    = (mmio_addr[31:5] == 27'h4000001);  // 0x80000020-0x8000003F
+    wire addr_is_timers   = (mmio_addr[31:5] >= 27'h400000B) &&  // 0x80000160-0x800001BF
+                            (mmio_addr[31:5] <= 27'h400000D);    // (channels 1-3)
+    wire addr_is_timebase = (mmio_addr[31:4] == 28'h8000015);  // 0x80000150-0x8000015F
+    wire addr_is_spi      = (mmio_addr[31:4] == 28'h8000005) ||  // 0x80000050-0x8000005F
+                            (mmio_addr[31:4] == 28'h800000C) ||  // 0x800000C0-0x800000CF (FIFO)
+                            (mmio_addr[31:4] == 28'h800000E);    // 0x800000E0-0x800000EF (CRC)
+    wire addr_is_cache    = (mmio_addr[31:4] == 28'h8000006);  // 0x80000060-0x8000006F
+    wire addr_is_spi_dma  = (mmio_addr[31:4] == 28'h800000D);  // 0x800000D0-0x800000DF
+    wire addr_is_pmu      = (mmio_addr[31:6] == 26'h2000002);  // 0x80000080-0x800000BF
+    wire addr_is_crc32    = (mmio_addr[31:4] == 28'h800000F);  // 0x800000F0-0x800000FF
+    wire addr_is_mem_dma  = (mmio_addr[31:5] == 27'h4000008);  // 0x80000100-0x8000011F
+    wire addr_is_irqc     = (mmio_addr[31:4] == 28'h8000014);  // 0x80000140-0x8000014F
+    wire addr_is_slip     = (mmio_addr[31:5] == 27'h400000E);  // 0x800001C0-0x800001DF
+    wire addr_is_loader   = (mmio_addr[31:4] == 28'h800001E);  // 0x800001E0-0x800001EF
+    wire addr_is_pcs      = (mmio_addr[31:4] == 28'h800001F);  // 0x800001F0-0x800001FF
+    wire addr_is_wdt      = (mmio_addr[31:5] == 27'h4000010);  // 0x80000200-0x8000021F
+    wire addr_is_flash    = (mmio_addr[31:4] == 28'h8000022);  // 0x80000220-0x8000022F
+    wire addr_is_mailbox  = (mmio_addr[31:4] == 28'h8000026);  // 0x80000260-0x8000026F
+    wire addr_is_button   = (mmio_addr[31:4] == 28'h8000027);  // 0x80000270-0x8000027F
+    wire addr_is_spi1     = (mmio_addr[31:4] == 28'h8000028) ||  // 0x80000280-0x8000028F
+                            (mmio_addr[31:4] == 28'h8000029) ||  // 0x80000290-0x8000029F (FIFO)
+                            (mmio_addr[31:4] == 28'h800002B);    // 0x800002B0-0x800002BF (CRC)
+    wire addr_is_spi1_dma = (mmio_addr[31:4] == 28'h800002A);  // 0x800002A0-0x800002AF
+    wire addr_is_atomic   = (mmio_addr[31:8] == 24'h800003);   // 0x80000300-0x800003FF
 
     //==========================================================================
     // Simple I/O Peripheral (LED, Button, Soft IRQ)
     //==========================================================================
+    // Registers only: combinational ready and read data (same cycle),
+    // stores take effect on the clock edge
     reg [1:0]  led_reg;
     reg [31:0] simple_io_rdata;
-    reg        simple_io_ready;
+    wire       simple_io_ready = mmio_valid;
+
+    always @(*) begin
+        case (mmio_addr)
+            ADDR_LED_CONTROL:  simple_io_rdata = {30'h0, led_reg};
+            ADDR_BUTTON_INPUT: simple_io_rdata = {30'h0, but2_sync2, but1_sync2};
+            default:           simple_io_rdata = 32'h0;
+        endcase
+    end
 
     always @(posedge clk) begin
         if (!cpu_resetn) begin
             led_reg <= 2'b00;
-            simple_io_ready <= 1'b0;
             soft_irq <= 1'b0;
         end else begin
-            simple_io_ready <= 1'b0;
             soft_irq <= 1'b0;  // Single-cycle pulse
 
-            if (mmio_valid && addr_is_simple && !simple_io_ready) begin
-                if (mmio_write) begin
-                    case (mmio_addr)
-                        ADDR_LED_CONTROL: begin
-                            if (mmio_wstrb[0]) led_reg <= mmio_wdata[1:0];
-                            simple_io_ready <= 1'b1;
-                        end
-                        ADDR_SOFT_IRQ_W: begin
-                            soft_irq <= 1'b1;
-                            simple_io_ready <= 1'b1;
-                        end
-                        default: simple_io_ready <= 1'b1;
-                    endcase
-                end else begin
-                    case (mmio_addr)
-                        ADDR_LED_CONTROL:  simple_io_rdata <= {30'h0, led_reg};
-                        ADDR_BUTTON_INPUT: simple_io_rdata <= {30'h0, but2_sync2, but1_sync2};
-                        default:           simple_io_rdata <= 32'h0;
-                    endcase
-                    simple_io_ready <= 1'b1;
-                end
+            if (mmio_valid && addr_is_simple && mmio_write) begin
+                case (mmio_addr)
+                    ADDR_LED_CONTROL: if (mmio_wstrb[0]) led_reg <= mmio_wdata[1:0];
+                    ADDR_SOFT_IRQ_W:  soft_irq <= 1'b1;
+                    default: ;
+                endcase
             end
         end
     end
@@ -388,7 +1010,14 @@ module ice40_picorv32_top (
     wire [31:0] uart_rdata;
     wire        uart_ready;
 
-    uart_peripheral uart_periph (
+    uart_peripheral #(
+        .TX_FIFO_BITS(UART_TX_FIFO_BITS),
+        .RX_FIFO_BITS(UART_RX_FIFO_BITS),
+        .IDLE_CYCLES(UART_BIT_CYCLES * 20), // Two character times
+        .CLK_HZ(`SYS_CLK_HZ),
+        .BAUD_DIV(UART_BAUD_DIV),
+        .OS_RATE(UART_OS_RATE)
+    ) uart_periph (
         .clk(clk),
         .resetn(cpu_resetn),
         .mmio_valid(mmio_valid && addr_is_uart),
@@ -400,12 +1029,67 @@ module ice40_picorv32_top (
         .mmio_ready(uart_ready),
         .uart_tx_data(mmio_uart_tx_data),
         .uart_tx_valid(mmio_uart_tx_valid),
+        .uart_tx_full(uart_txq_full),
+        .uart_tx_level(uart_txq_level),
         .uart_tx_busy(uart_tx_busy),
+        .uart_baud_div(uart_baud_div),
+        .uart_os_rate(uart_os_rate),
         .uart_rx_data(buffer_rd_data),
         .uart_rx_rd_en(mmio_buffer_rd_en),
-        .uart_rx_empty(buffer_empty)
+        .uart_rx_empty(buffer_empty),
+        .uart_rx_level(buffer_level),
+        .uart_rx_strobe(uart_rx_data_valid),
+        .uart_rx_overflow(uart_rx_overflow),
+        .uart_rx_frame_error(uart_rx_frame_error),
+        .irq_rx(uart_rx_irq_core),
+        .irq_tx(uart_tx_irq)
+    );
+
+    //==========================================================================
+    // Console UART (Kconfig CONSOLE_UART): its own pins, FIFOs and registers,
+    // so stdio stays off the SLIP / upload link. Its interrupts drive CPU
+    // IRQ[8] directly: the controller has eight sources, and the console
+    // is polled unless firmware with its own irq_handler() enables them.
+    //==========================================================================
+    wire [31:0] uart1_rdata;
+    wire        uart1_ready;
+
+`ifdef CONSOLE_UART
+    wire uart1_irq_rx, uart1_irq_tx;
+
+    uart_port #(
+        .BASE(32'h80000230),
+        .CTRL_BASE(32'h80000240),
+        .TX_FIFO_BITS(9),                   // One EBR each way
+        .RX_FIFO_BITS(9),
+        .IDLE_CYCLES(UART_BIT_CYCLES * 20),
+        .CLK_HZ(`SYS_CLK_HZ),
+        .BAUD_DIV(UART_BAUD_DIV),
+        .OS_RATE(UART_OS_RATE)
+    ) uart1_port (
+        .clk(clk),
+        .resetn(cpu_resetn),
+        .mmio_valid(mmio_valid && addr_is_uart1),
+        .mmio_write(mmio_write),
+        .mmio_addr(mmio_addr),
+        .mmio_wdata(mmio_wdata),
+        .mmio_wstrb(mmio_wstrb),
+        .mmio_rdata(uart1_rdata),
+        .mmio_ready(uart1_ready),
+        .rx(UART1_RX),
+        .tx(UART1_TX),
+        .irq_rx(uart1_irq_rx),
+        .irq_tx(uart1_irq_tx)
     );
 
+    assign uart1_irq = uart1_irq_rx || uart1_irq_tx;
+`else
+    assign uart1_rdata = 32'h0;
+    assign uart1_ready = mmio_valid;
+    assign uart1_irq = 1'b0;
+    assign UART1_TX = 1'b1;
+`endif
+
     //==========================================================================
     // Timer Peripheral
     //==========================================================================
@@ -422,27 +1106,627 @@ module ice40_picorv32_top (
         .mmio_wstrb(mmio_wstrb),
         .mmio_rdata(timer_rdata),
         .mmio_ready(timer_ready),
-        .timer_irq(timer_irq)
+        .capture_in(but_press_edge),
+        .timer_irq(timer_irq),
+        .update_out()
     );
 
+    // Channels 1-3 (Kconfig TIMER_CHANNELS); absent channels read 0
+    localparam TIMER_CHANNELS = `TIMER_CHANNELS;
+
+    wire [95:0] timers_ch_rdata;                        // Channel n at [32n-1:32n-32]
+    wire [ 3:1] timers_ch_irq;
+    wire [ 3:1] timers_ch_update;                       // Update events (SPI1 stream triggers)
+    wire [ 1:0] timers_sel = mmio_addr[6:5] - 2'd2;     // 0x160 -> 1, 0x180 -> 2, 0x1A0 -> 3
+
+    genvar tch;
+    generate
+        for (tch = 1; tch <= 3; tch = tch + 1) begin : timer_ch
+            if (tch < TIMER_CHANNELS) begin : present
+                timer_peripheral timer_n (
+                    .clk(clk),
+                    .resetn(cpu_resetn),
+                    .mmio_valid(mmio_valid && addr_is_timers && timers_sel == tch),
+                    .mmio_write(mmio_write),
+                    .mmio_addr(mmio_addr),
+                    .mmio_wdata(mmio_wdata),
+                    .mmio_wstrb(mmio_wstrb),
+                    .mmio_rdata(timers_ch_rdata[32*tch-1 -: 32]),
+                    .mmio_ready(),
+                    .capture_in(but_press_edge),
+                    .timer_irq(timers_ch_irq[tch]),
+                    .update_out(timers_ch_update[tch])
+                );
+            end else begin : absent
+                assign timers_ch_rdata[32*tch-1 -: 32] = 32'h0;
+                assign timers_ch_irq[tch] = 1'b0;
+                assign timers_ch_update[tch] = 1'b0;
+            end
+        end
+    endgenerate
+
+    wire [31:0] timers_rdata = (timers_sel == 2'd1) ? timers_ch_rdata[31:0] :
+                               (timers_sel == 2'd2) ? timers_ch_rdata[63:32] :
+                               (timers_sel == 2'd3) ? timers_ch_rdata[95:64] : 32'h0;
+    wire        timers_ready = mmio_valid;
+    wire wdt_irq;
+    assign timers_irq = |timers_ch_irq || wdt_irq;
+
     //==========================================================================
-    // MMIO Multiplexer (4-way: simple_io, uart, timer, spi)
+    // Timebase (64-bit microseconds / 32-bit milliseconds since reset)
+    //==========================================================================
+    wire [31:0] timebase_rdata;
+    wire        timebase_ready;
+
+    timebase #(
+        .CLK_HZ(`SYS_CLK_HZ)
+    ) timebase_inst (
+        .clk(clk),
+        .resetn(cpu_resetn),
+        .mmio_valid(mmio_valid && addr_is_timebase),
+        .mmio_write(mmio_write),
+        .mmio_addr(mmio_addr),
+        .mmio_wdata(mmio_wdata),
+        .mmio_wstrb(mmio_wstrb),
+        .mmio_rdata(timebase_rdata),
+        .mmio_ready(timebase_ready)
+    );
+
+    //==========================================================================
+    // Watchdog (own counter; pre-timeout on IRQ[7], expiry resets the CPU)
+    // Kconfig PERIPHERAL_WATCHDOG=n leaves it out; its registers read 0
+    //==========================================================================
+    // Global reset only, so the reset cause survives the CPU reset it causes
+    wire [31:0] wdt_rdata;
+    wire        wdt_ready;
+
+`ifndef NO_WATCHDOG
+    watchdog #(
+        .CLK_HZ(`SYS_CLK_HZ)
+    ) wdt_inst (
+        .clk(clk),
+        .resetn(global_resetn),
+        .mmio_valid(mmio_valid && addr_is_wdt),
+        .mmio_write(mmio_write),
+        .mmio_addr(mmio_addr),
+        .mmio_wdata(mmio_wdata),
+        .mmio_wstrb(mmio_wstrb),
+        .mmio_rdata(wdt_rdata),
+        .mmio_ready(wdt_ready),
+        .loader_hold(loader_active),
+        .irq(wdt_irq),
+        .cpu_reset(wdt_cpu_reset)
+    );
+`else
+    assign wdt_rdata = 32'h0;
+    assign wdt_ready = mmio_valid;
+    assign wdt_irq = 1'b0;
+    assign wdt_cpu_reset = 1'b0;
+`endif
+
+    //==========================================================================
+    // SPI Flash XIP (Kconfig FLASH_XIP); absent, its registers read 0
+    //==========================================================================
+    // Read window 0x01000000 (mem_controller), register mode for erase and
+    // program; the pins are the FPGA's configuration SPI port
+    wire [31:0] flash_mmio_rdata;
+    wire        flash_mmio_ready;
+
+`ifdef FLASH_XIP
+    spi_flash_xip #(
+        .DUAL(`FLASH_XIP_DUAL_EN)
+    ) flash_xip (
+        .clk(clk),
+        .resetn(cpu_resetn),
+        .rd_start(flash_start),
+        .rd_addr(flash_addr),
+        .rd_done(flash_done),
+        .rd_rdata(flash_rdata),
+        .mmio_valid(mmio_valid && addr_is_flash),
+        .mmio_write(mmio_write),
+        .mmio_addr(mmio_addr),
+        .mmio_wdata(mmio_wdata),
+        .mmio_wstrb(mmio_wstrb),
+        .mmio_rdata(flash_mmio_rdata),
+        .mmio_ready(flash_mmio_ready),
+        .flash_sck(FLASH_SCK),
+        .flash_cs_n(FLASH_CS_N),
+        .flash_io0(FLASH_IO0),
+        .flash_io1(FLASH_IO1)
+    );
+`else
+    assign flash_done = 1'b0;           // Window not decoded
+    assign flash_rdata = 32'h0;
+    assign flash_mmio_rdata = 32'h0;
+    assign flash_mmio_ready = mmio_valid;
+    assign FLASH_SCK = 1'b0;
+    assign FLASH_CS_N = 1'b1;
+    assign FLASH_IO0 = 1'bz;
+`endif
+
+    //==========================================================================
+    // SLIP Codec (Kconfig SLIP_CODEC); absent, its registers read 0
+    //==========================================================================
+    wire [31:0] slip_rdata;
+    wire        slip_ready;
+
+`ifdef SLIP_CODEC
+    slip_codec #(
+        .BUF_BITS($clog2(`SLIP_CODEC_BUF_SIZE))
+    ) slip_inst (
+        .clk(clk),
+        .resetn(cpu_resetn),
+        .mmio_valid(mmio_valid && addr_is_slip),
+        .mmio_write(mmio_write),
+        .mmio_addr(mmio_addr),
+        .mmio_wdata(mmio_wdata),
+        .mmio_wstrb(mmio_wstrb),
+        .mmio_rdata(slip_rdata),
+        .mmio_ready(slip_ready),
+        .rx_data(uart_rx_data),
+        .rx_strobe(uart_rx_data_valid),
+        .rx_active(slip_rx_active),
+        .tx_data(slip_tx_data),
+        .tx_valid(slip_tx_valid),
+        .tx_full(uart_txq_full),
+        .irq(slip_irq)
+    );
+`else
+    assign slip_rdata = 32'h0;
+    assign slip_ready = mmio_valid;
+    assign slip_tx_data = 8'h0;
+    assign slip_tx_valid = 1'b0;
+    assign slip_rx_active = 1'b0;
+    assign slip_irq = 1'b0;
+`endif
+
+    assign uart_rx_irq = uart_rx_irq_core || slip_irq;
+
+    //==========================================================================
+    // Hardware Loader (Kconfig HW_LOADER); absent, its registers read 0
+    //==========================================================================
+    // Block upload protocol in hardware: after a hold packet it keeps the
+    // CPU in reset and writes the image to SRAM (tools/uploader -H)
+    wire [31:0] loader_rdata;
+    wire        loader_ready;
+
+`ifdef HW_LOADER
+    firmware_loader #(
+        .CLK_HZ(`SYS_CLK_HZ)
+    ) loader_inst (
+        .clk(clk),
+        .resetn(global_resetn),
+        .mmio_valid(mmio_valid && addr_is_loader),
+        .mmio_write(mmio_write),
+        .mmio_addr(mmio_addr),
+        .mmio_wdata(mmio_wdata),
+        .mmio_wstrb(mmio_wstrb),
+        .mmio_rdata(loader_rdata),
+        .mmio_ready(loader_ready),
+        .rx_data(uart_rx_data),
+        .rx_strobe(uart_rx_data_valid),
+        .rx_fifo_data(buffer_rd_data),
+        .rx_fifo_rd_en(loader_rx_rd_en),
+        .rx_fifo_empty(buffer_empty),
+        .rx_fifo_clear(loader_rx_clear),
+        .tx_data(loader_tx_data),
+        .tx_valid(loader_tx_valid),
+        .tx_full(uart_txq_full),
+        .tx_idle(uart_txq_empty && !uart_tx_busy),
+        .baud_div_in(uart_baud_div),
+        .os_rate_in(uart_os_rate),
+        .baud_div(uart_core_baud_div),
+        .os_rate(uart_core_os_rate),
+        .sram_start(loader_sram_start),
+        .sram_addr(loader_sram_addr),
+        .sram_wdata(loader_sram_wdata),
+        .sram_wstrb(loader_sram_wstrb),
+        .sram_busy(mem_ctrl_sram_busy),
+        .sram_done(mem_ctrl_sram_done),
+        .sram_rdata(mem_ctrl_sram_rdata),
+        .active(loader_active)
+    );
+`else
+    assign loader_rdata = 32'h0;
+    assign loader_ready = mmio_valid;
+    assign loader_tx_data = 8'h0;
+    assign loader_tx_valid = 1'b0;
+    assign loader_rx_rd_en = 1'b0;
+    assign loader_rx_clear = 1'b0;
+    assign uart_core_baud_div = uart_baud_div;
+    assign uart_core_os_rate = uart_os_rate;
+    assign loader_sram_start = 1'b0;
+    assign loader_sram_addr = 32'h0;
+    assign loader_sram_wdata = 32'h0;
+    assign loader_sram_wstrb = 4'h0;
+    assign loader_active = 1'b0;
+`endif
+
+    //==========================================================================
+    // Cache Control (I-cache invalidate, D-cache clean/invalidate range)
+    //==========================================================================
+    wire [31:0] cache_rdata;
+    wire        cache_ready;
+
+    cache_control #(
+        .ICACHE_BYTES(ICACHE_BYTES),
+        .DCACHE_BYTES(DCACHE_BYTES)
+    ) cache_ctrl (
+        .clk(clk),
+        .resetn(cpu_resetn),
+        .mmio_valid(mmio_valid && addr_is_cache),
+        .mmio_write(mmio_write),
+        .mmio_addr(mmio_addr),
+        .mmio_wdata(mmio_wdata),
+        .mmio_wstrb(mmio_wstrb),
+        .mmio_rdata(cache_rdata),
+        .mmio_ready(cache_ready),
+        .icache_flush(icache_flush),
+        .icache_busy(icache_busy),
+        .dcache_op_start(dcache_op_start),
+        .dcache_op_clean(dcache_op_clean),
+        .dcache_op_inval(dcache_op_inval),
+        .dcache_op_addr(dcache_op_addr),
+        .dcache_op_len(dcache_op_len),
+        .dcache_busy(dcache_busy)
+    );
+
+    //==========================================================================
+    // Performance Monitoring Unit (memory-stall accounting)
+    // Kconfig PERIPHERAL_PMU=n leaves the counters out (they read 0) but
+    // keeps CPU_INFO, which lib/pcpi_fpu.h probes
+    //==========================================================================
+    wire [31:0] pmu_rdata;
+    wire        pmu_ready;
+    localparam [31:0] PMU_CPU_INFO = {26'h0, `CPU_CATCH_ILLINSN == 1, `CPU_PCPI_FPU == 1,
+                                      `CPU_COMPRESSED_ISA == 1, `CPU_ENABLE_DIV == 1,
+                                      `CPU_ENABLE_FAST_MUL == 1, `CPU_ENABLE_MUL == 1};
+
+`ifndef NO_PMU
+    perf_monitor #(
+        .CPU_INFO(PMU_CPU_INFO)
+    ) pmu (
+        .clk(clk),
+        .resetn(cpu_resetn),
+        .mmio_valid(mmio_valid && addr_is_pmu),
+        .mmio_write(mmio_write),
+        .mmio_addr(mmio_addr),
+        .mmio_wdata(mmio_wdata),
+        .mmio_wstrb(mmio_wstrb),
+        .mmio_rdata(pmu_rdata),
+        .mmio_ready(pmu_ready),
+        .cpu_mem_valid(cpu_mem_valid),
+        .cpu_mem_ready(cpu_mem_ready),
+        .cpu_mem_instr(cpu_mem_instr),
+        .cpu_mem_wstrb(cpu_mem_wstrb),
+        .stat_sram_wait(mem_stat_sram_wait),
+        .stat_mmio_wait(mem_stat_mmio_wait),
+        .stat_boot_wait(mem_stat_boot_wait),
+        .stat_spad(mem_stat_spad),
+        .stat_ic_hit(icache_stat_hit),
+        .stat_ic_miss(icache_stat_miss),
+        .stat_dc_hit(dcache_stat_hit),
+        .stat_dc_miss(dcache_stat_miss)
+    );
+`else
+    assign pmu_rdata = (mmio_addr[5:2] == 4'hF) ? PMU_CPU_INFO : 32'h0;
+    assign pmu_ready = mmio_valid;
+`endif
+
+    //==========================================================================
+    // PC Sampler (Kconfig PC_SAMPLER); absent, its registers read 0
+    //==========================================================================
+    // Fetch address every INTERVAL cycles into a BRAM FIFO (tools/pcprof)
+    wire [31:0] pcs_rdata;
+    wire        pcs_ready;
+
+`ifdef PC_SAMPLER
+    pc_sampler #(
+        .DEPTH(`PC_SAMPLER_DEPTH)
+    ) pcs_inst (
+        .clk(clk),
+        .resetn(cpu_resetn),
+        .mmio_valid(mmio_valid && addr_is_pcs),
+        .mmio_write(mmio_write),
+        .mmio_addr(mmio_addr),
+        .mmio_wdata(mmio_wdata),
+        .mmio_wstrb(mmio_wstrb),
+        .mmio_rdata(pcs_rdata),
+        .mmio_ready(pcs_ready),
+        .cpu_mem_valid(cpu_mem_valid),
+        .cpu_mem_ready(cpu_mem_ready),
+        .cpu_mem_instr(cpu_mem_instr),
+        .cpu_mem_addr(cpu_mem_addr)
+    );
+`else
+    assign pcs_rdata = 32'h0;
+    assign pcs_ready = mmio_valid;
+`endif
+
+    //==========================================================================
+    // CRC32 Accelerator (lib/crc32.h, Kconfig PERIPHERAL_CRC32)
+    //==========================================================================
+    wire [31:0] crc32_rdata;
+    wire        crc32_ready;
+
+`ifndef NO_CRC32_ACCEL
+    crc32_accel crc32_accel_inst (
+        .clk(clk),
+        .resetn(cpu_resetn),
+        .mmio_valid(mmio_valid && addr_is_crc32),
+        .mmio_write(mmio_write),
+        .mmio_addr(mmio_addr),
+        .mmio_wdata(mmio_wdata),
+        .mmio_wstrb(mmio_wstrb),
+        .mmio_rdata(crc32_rdata),
+        .mmio_ready(crc32_ready)
+    );
+`else
+    // Absent: CTRL reads 0, crc32_hw_present() is false, software CRC
+    assign crc32_rdata = 32'h0;
+    assign crc32_ready = mmio_valid;
+`endif
+
+    //==========================================================================
+    // Atomic Words (lib/atomic.h, Kconfig ATOMIC_UNIT)
+    //==========================================================================
+    wire [31:0] atomic_rdata;
+    wire        atomic_ready;
+
+`ifdef ATOMIC_UNIT
+    atomic_unit atomic_inst (
+        .clk(clk),
+        .resetn(cpu_resetn),
+        .mmio_valid(mmio_valid && addr_is_atomic),
+        .mmio_write(mmio_write),
+        .mmio_addr(mmio_addr),
+        .mmio_wdata(mmio_wdata),
+        .mmio_wstrb(mmio_wstrb),
+        .mmio_rdata(atomic_rdata),
+        .mmio_ready(atomic_ready)
+    );
+`else
+    assign atomic_rdata = 32'h0;
+    assign atomic_ready = mmio_valid;
+`endif
+
+    //==========================================================================
+    // Second Core and Mailbox (core1.v, lib/mailbox.h, Kconfig DUAL_CORE)
+    //==========================================================================
+    wire [31:0] mailbox_rdata;
+    wire        mailbox_ready;
+
+`ifdef DUAL_CORE
+    wire        core1_run;
+    wire        core1_irq;
+    wire        mbox1_valid;
+    wire        mbox1_write;
+    wire [31:0] mbox1_addr;
+    wire [31:0] mbox1_wdata;
+    wire [ 3:0] mbox1_wstrb;
+    wire [31:0] mbox1_rdata;
+    wire        mbox1_ready;
+
+    mailbox mailbox_inst (
+        .clk(clk),
+        .resetn(cpu_resetn),
+        .mmio0_valid(mmio_valid && addr_is_mailbox),
+        .mmio0_write(mmio_write),
+        .mmio0_addr(mmio_addr),
+        .mmio0_wdata(mmio_wdata),
+        .mmio0_wstrb(mmio_wstrb),
+        .mmio0_rdata(mailbox_rdata),
+        .mmio0_ready(mailbox_ready),
+        .mmio1_valid(mbox1_valid),
+        .mmio1_write(mbox1_write),
+        .mmio1_addr(mbox1_addr),
+        .mmio1_wdata(mbox1_wdata),
+        .mmio1_wstrb(mbox1_wstrb),
+        .mmio1_rdata(mbox1_rdata),
+        .mmio1_ready(mbox1_ready),
+        .core1_run(core1_run),
+        .irq0(mailbox_irq),
+        .irq1(core1_irq)
+    );
+
+    // RV32I, 2 KB local scratchpad (4 EBR); out of reset once core 0 has
+    // copied its image to CORE1_RESET_ADDR and set the run bit
+    core1 #(
+        .RESET_ADDR(`CORE1_RESET_ADDR),
+        .SPAD_BYTES(2048)
+    ) core1_inst (
+        .clk(clk),
+        .resetn(cpu_resetn && core1_run),
+        .irq_mailbox(core1_irq),
+        .mbox_valid(mbox1_valid),
+        .mbox_write(mbox1_write),
+        .mbox_addr(mbox1_addr),
+        .mbox_wdata(mbox1_wdata),
+        .mbox_wstrb(mbox1_wstrb),
+        .mbox_rdata(mbox1_rdata),
+        .mbox_ready(mbox1_ready),
+        .c1_valid(c1_mem_valid),
+        .c1_ready(c1_mem_ready),
+        .c1_addr(c1_mem_addr),
+        .c1_wdata(c1_mem_wdata),
+        .c1_wstrb(c1_mem_wstrb),
+        .c1_rdata(c1_mem_rdata)
+    );
+`else
+    assign mailbox_rdata = 32'h0;
+    assign mailbox_ready = mmio_valid;
+    assign mailbox_irq   = 1'b0;
+    assign c1_mem_valid  = 1'b0;
+    assign c1_mem_addr   = 32'h0;
+    assign c1_mem_wdata  = 32'h0;
+    assign c1_mem_wstrb  = 4'h0;
+`endif
+
+    //==========================================================================
+    // Memory DMA (SRAM copy/fill; owns the mem_controller DMA port)
+    //==========================================================================
+    wire [31:0] mem_dma_rdata;
+    wire        mem_dma_ready;
+
+    mem_dma mem_dma_inst (
+        .clk(clk),
+        .resetn(cpu_resetn),
+        .mmio_valid(mmio_valid && addr_is_mem_dma),
+        .mmio_write(mmio_write),
+        .mmio_addr(mmio_addr),
+        .mmio_wdata(mmio_wdata),
+        .mmio_wstrb(mmio_wstrb),
+        .mmio_rdata(mem_dma_rdata),
+        .mmio_ready(mem_dma_ready),
+        .up_valid(spi_up_valid),
+        .up_ready(spi_up_ready),
+        .up_addr(spi_up_addr),
+        .up_wdata(spi_up_wdata),
+        .up_wstrb(spi_up_wstrb),
+        .up_rdata(spi_up_rdata),
+        .mem_valid(dma_mem_valid),
+        .mem_ready(dma_mem_ready),
+        .mem_addr(dma_mem_addr),
+        .mem_wdata(dma_mem_wdata),
+        .mem_wstrb(dma_mem_wstrb),
+        .mem_burst(dma_mem_burst),
+        .mem_rdata(dma_mem_rdata),
+        .irq(mem_dma_irq)
+    );
+
+    //==========================================================================
+    // Interrupt Controller (lib/irq.h dispatch table)
+    //==========================================================================
+    wire [31:0] irqc_rdata;
+    wire        irqc_ready;
+
+    // Raw press edge (either button, after the synchronizer): the timer
+    // capture input, so CCR keeps the moment of the first contact
+    reg but_pressed_d;
+    wire but_pressed = but1_sync2 || but2_sync2;
+
+    always @(posedge clk) begin
+        if (!cpu_resetn)
+            but_pressed_d <= 1'b0;
+        else
+            but_pressed_d <= but_pressed;
+    end
+
+    assign but_press_edge = but_pressed && !but_pressed_d;
+
+    // Debounced press/release events (lib/button.h): IRQ[6]
+    wire [31:0] button_rdata;
+    wire        button_ready;
+
+    button_debounce #(
+        .CLK_HZ(`SYS_CLK_HZ)
+    ) button_inst (
+        .clk(clk),
+        .resetn(cpu_resetn),
+        .mmio_valid(mmio_valid && addr_is_button),
+        .mmio_write(mmio_write),
+        .mmio_addr(mmio_addr),
+        .mmio_wdata(mmio_wdata),
+        .mmio_wstrb(mmio_wstrb),
+        .mmio_rdata(button_rdata),
+        .mmio_ready(button_ready),
+        .buttons({but2_sync2, but1_sync2}),
+        .irq(button_irq)
+    );
+
+    irq_controller irqc_inst (
+        .clk(clk),
+        .resetn(cpu_resetn),
+        .mmio_valid(mmio_valid && addr_is_irqc),
+        .mmio_write(mmio_write),
+        .mmio_addr(mmio_addr),
+        .mmio_wdata(mmio_wdata),
+        .mmio_wstrb(mmio_wstrb),
+        .mmio_rdata(irqc_rdata),
+        .mmio_ready(irqc_ready),
+        .irq_src({timers_irq, button_irq, uart_tx_irq, uart_rx_irq, mem_dma_irq, spi_irq, soft_irq, timer_irq}),
+        .irq_out(cpu_irq)
+    );
+
+    //==========================================================================
+    // MMIO Multiplexer (simple_io, uart, console uart, timer, timers 1-3, timebase, spi, spi_dma, cache, pmu, crc32, mem_dma, irqc, slip, loader, pc sampler, watchdog, button, spi1)
     //==========================================================================
     wire [31:0] spi_rdata;
     wire        spi_ready;
+    wire [31:0] spi_dma_rdata;
+    wire        spi_dma_ready;
+    wire [31:0] spi1_rdata;
+    wire        spi1_ready;
 
-    assign mmio_rdata = addr_is_simple ? simple_io_rdata :
-                        addr_is_uart   ? uart_rdata :
-                        addr_is_timer  ? timer_rdata :
-                        addr_is_spi    ? spi_rdata : 32'h0;
+    assign mmio_rdata = addr_is_simple  ? simple_io_rdata :
+                        addr_is_uart    ? uart_rdata :
+                        addr_is_uart1   ? uart1_rdata :
+                        addr_is_timer   ? timer_rdata :
+                        addr_is_timers  ? timers_rdata :
+                        addr_is_timebase ? timebase_rdata :
+                        addr_is_spi     ? spi_rdata :
+                        addr_is_spi_dma ? spi_dma_rdata :
+                        addr_is_cache   ? cache_rdata :
+                        addr_is_pmu     ? pmu_rdata :
+                        addr_is_crc32   ? crc32_rdata :
+                        addr_is_mem_dma ? mem_dma_rdata :
+                        addr_is_irqc    ? irqc_rdata :
+                        addr_is_slip    ? slip_rdata :
+                        addr_is_loader  ? loader_rdata :
+                        addr_is_pcs     ? pcs_rdata :
+                        addr_is_wdt     ? wdt_rdata :
+                        addr_is_flash   ? flash_mmio_rdata :
+                        addr_is_atomic  ? atomic_rdata :
+                        addr_is_mailbox ? mailbox_rdata :
+                        addr_is_button  ? button_rdata :
+                        addr_is_spi1 || addr_is_spi1_dma ? spi1_rdata : 32'h0;
 
-    assign mmio_ready = addr_is_simple ? simple_io_ready :
-                        addr_is_uart   ? uart_ready :
-                        addr_is_timer  ? timer_ready :
-                        addr_is_spi    ? spi_ready : 1'b0;
+    assign mmio_ready = addr_is_simple  ? simple_io_ready :
+                        addr_is_uart    ? uart_ready :
+                        addr_is_uart1   ? uart1_ready :
+                        addr_is_timer   ? timer_ready :
+                        addr_is_timers  ? timers_ready :
+                        addr_is_timebase ? timebase_ready :
+                        addr_is_spi     ? spi_ready :
+                        addr_is_spi_dma ? spi_dma_ready :
+                        addr_is_cache   ? cache_ready :
+                        addr_is_pmu     ? pmu_ready :
+                        addr_is_crc32   ? crc32_ready :
+                        addr_is_mem_dma ? mem_dma_ready :
+                        addr_is_irqc    ? irqc_ready :
+                        addr_is_slip    ? slip_ready :
+                        addr_is_loader  ? loader_ready :
+                        addr_is_pcs     ? pcs_ready :
+                        addr_is_wdt     ? wdt_ready :
+                        addr_is_flash   ? flash_mmio_ready :
+                        addr_is_atomic  ? atomic_ready :
+                        addr_is_mailbox ? mailbox_ready :
+                        addr_is_button  ? button_ready :
+                        addr_is_spi1 || addr_is_spi1_dma ? spi1_ready :
+                        mmio_valid;     // Unmapped: reads 0, no wait
+
+    // SPI Master <-> DMA side port
+    wire        spi_dma_rx_pop;
+    wire [31:0] spi_dma_rx_data;
+    wire        spi_dma_rx_empty;
+    wire        spi_dma_tx_push;
+    wire [31:0] spi_dma_tx_data;
+    wire        spi_dma_tx_full;
+    wire        spi_dma_rep_load;
+    wire [15:0] spi_dma_rep_value;
+    wire        spi_dma_spi_busy;
+    wire        spi_dma_cs_ctl;
+    wire        spi_dma_cs;
+    wire        spi_xfer_irq;
+    wire        spi_dma_irq;
+
+    assign spi_irq = spi_xfer_irq || spi_dma_irq;
 
     // SPI Master Peripheral Instance (at top level for better optimization)
-    spi_master spi (
+    spi_master #(
+        .FIFO_DEPTH(`SPI_FIFO_DEPTH),
+        .HW_CRC(`SPI_HW_CRC_EN)
+    ) spi (
         .clk(clk),
         .resetn(cpu_resetn),
         .mmio_valid(mmio_valid && addr_is_spi),
@@ -456,7 +1740,199 @@ module ice40_picorv32_top (
         .spi_mosi(SPI_MOSI),
         .spi_miso(SPI_MISO),
         .spi_cs(SPI_CS),
-        .spi_irq(spi_irq)
+        .spi_irq(spi_xfer_irq),
+        .dma_rx_pop(spi_dma_rx_pop),
+        .dma_rx_data(spi_dma_rx_data),
+        .dma_rx_empty(spi_dma_rx_empty),
+        .dma_tx_push(spi_dma_tx_push),
+        .dma_tx_data(spi_dma_tx_data),
+        .dma_tx_full(spi_dma_tx_full),
+        .dma_rep_load(spi_dma_rep_load),
+        .dma_rep_value(spi_dma_rep_value),
+        .dma_spi_busy(spi_dma_spi_busy),
+        .dma_cs_ctl(spi_dma_cs_ctl),
+        .dma_cs(spi_dma_cs)
+    );
+
+    // SPI DMA Engine (SPI FIFOs <-> SRAM through the mem_controller DMA port)
+    spi_dma spi_dma_inst (
+        .clk(clk),
+        .resetn(cpu_resetn),
+        .mmio_valid(mmio_valid && addr_is_spi_dma),
+        .mmio_write(mmio_write),
+        .mmio_addr(mmio_addr),
+        .mmio_wdata(mmio_wdata),
+        .mmio_wstrb(mmio_wstrb),
+        .mmio_rdata(spi_dma_rdata),
+        .mmio_ready(spi_dma_ready),
+        .mem_valid(spi_dma_mem_valid),
+        .mem_ready(spi_dma_mem_ready),
+        .mem_addr(spi_dma_mem_addr),
+        .mem_wdata(spi_dma_mem_wdata),
+        .mem_wstrb(spi_dma_mem_wstrb),
+        .mem_rdata(spi_dma_mem_rdata),
+        .spi_rx_pop(spi_dma_rx_pop),
+        .spi_rx_data(spi_dma_rx_data),
+        .spi_rx_empty(spi_dma_rx_empty),
+        .spi_tx_push(spi_dma_tx_push),
+        .spi_tx_data(spi_dma_tx_data),
+        .spi_tx_full(spi_dma_tx_full),
+        .spi_rep_load(spi_dma_rep_load),
+        .spi_rep_value(spi_dma_rep_value),
+        .spi_busy(spi_dma_spi_busy),
+        .spi_cs_ctl(spi_dma_cs_ctl),
+        .spi_cs(spi_dma_cs),
+        .trigger(3'b000),
+        .irq(spi_dma_irq)
     );
 
+    //==========================================================================
+    // Second SPI bus (Kconfig SPI1_MASTER): the same master and DMA engine on
+    // their own pins at 0x80000280, so a sensor or ADC streams while SD
+    // transfers run on SPI0. Its interrupts drive CPU IRQ[10] directly, as
+    // the console UART's do. Both DMA engines share the mem_dma pass-through
+    // port: a request keeps the port until it completes, and when both are
+    // waiting the engine that did not have the last grant goes first.
+    //==========================================================================
+`ifdef SPI1_MASTER
+    wire [31:0] spi1_reg_rdata, spi1_dma_rdata;
+    wire        spi1_reg_ready, spi1_dma_ready;
+    wire        spi1_dma_rx_pop;
+    wire [31:0] spi1_dma_rx_data;
+    wire        spi1_dma_rx_empty;
+    wire        spi1_dma_tx_push;
+    wire [31:0] spi1_dma_tx_data;
+    wire        spi1_dma_tx_full;
+    wire        spi1_dma_rep_load;
+    wire [15:0] spi1_dma_rep_value;
+    wire        spi1_dma_spi_busy;
+    wire        spi1_dma_cs_ctl;
+    wire        spi1_dma_cs;
+    wire        spi1_xfer_irq;
+    wire        spi1_dma_irq;
+    wire        spi1_dma_mem_valid;
+    wire        spi1_dma_mem_ready;
+    wire [31:0] spi1_dma_mem_addr;
+    wire [31:0] spi1_dma_mem_wdata;
+    wire [ 3:0] spi1_dma_mem_wstrb;
+
+    assign spi1_rdata = addr_is_spi1 ? spi1_reg_rdata : spi1_dma_rdata;
+    assign spi1_ready = addr_is_spi1 ? spi1_reg_ready : spi1_dma_ready;
+    assign spi1_irq   = spi1_xfer_irq || spi1_dma_irq;
+
+    spi_master #(
+        .FIFO_DEPTH(`SPI_FIFO_DEPTH),
+        .HW_CRC(`SPI_HW_CRC_EN),
+        .BASE(32'h80000280),
+        .FIFO_BASE(32'h80000290),
+        .CRC_BASE(32'h800002B0)
+    ) spi1 (
+        .clk(clk),
+        .resetn(cpu_resetn),
+        .mmio_valid(mmio_valid && addr_is_spi1),
+        .mmio_write(mmio_write),
+        .mmio_addr(mmio_addr),
+        .mmio_wdata(mmio_wdata),
+        .mmio_wstrb(mmio_wstrb),
+        .mmio_rdata(spi1_reg_rdata),
+        .mmio_ready(spi1_reg_ready),
+        .spi_sck(SPI1_SCK),
+        .spi_mosi(SPI1_MOSI),
+        .spi_miso(SPI1_MISO),
+        .spi_cs(SPI1_CS),
+        .spi_irq(spi1_xfer_irq),
+        .dma_rx_pop(spi1_dma_rx_pop),
+        .dma_rx_data(spi1_dma_rx_data),
+        .dma_rx_empty(spi1_dma_rx_empty),
+        .dma_tx_push(spi1_dma_tx_push),
+        .dma_tx_data(spi1_dma_tx_data),
+        .dma_tx_full(spi1_dma_tx_full),
+        .dma_rep_load(spi1_dma_rep_load),
+        .dma_rep_value(spi1_dma_rep_value),
+        .dma_spi_busy(spi1_dma_spi_busy),
+        .dma_cs_ctl(spi1_dma_cs_ctl),
+        .dma_cs(spi1_dma_cs)
+    );
+
+    // Stream mode (Kconfig SPI1_STREAM): timer channel 1-3 update events
+    // clock ADC frames into an SRAM ring with no CPU work per sample
+    spi_dma #(
+        .STREAM(`SPI1_STREAM_EN)
+    ) spi1_dma_inst (
+        .clk(clk),
+        .resetn(cpu_resetn),
+        .mmio_valid(mmio_valid && addr_is_spi1_dma),
+        .mmio_write(mmio_write),
+        .mmio_addr(mmio_addr),
+        .mmio_wdata(mmio_wdata),
+        .mmio_wstrb(mmio_wstrb),
+        .mmio_rdata(spi1_dma_rdata),
+        .mmio_ready(spi1_dma_ready),
+        .mem_valid(spi1_dma_mem_valid),
+        .mem_ready(spi1_dma_mem_ready),
+        .mem_addr(spi1_dma_mem_addr),
+        .mem_wdata(spi1_dma_mem_wdata),
+        .mem_wstrb(spi1_dma_mem_wstrb),
+        .mem_rdata(spi_up_rdata),
+        .spi_rx_pop(spi1_dma_rx_pop),
+        .spi_rx_data(spi1_dma_rx_data),
+        .spi_rx_empty(spi1_dma_rx_empty),
+        .spi_tx_push(spi1_dma_tx_push),
+        .spi_tx_data(spi1_dma_tx_data),
+        .spi_tx_full(spi1_dma_tx_full),
+        .spi_rep_load(spi1_dma_rep_load),
+        .spi_rep_value(spi1_dma_rep_value),
+        .spi_busy(spi1_dma_spi_busy),
+        .spi_cs_ctl(spi1_dma_cs_ctl),
+        .spi_cs(spi1_dma_cs),
+        .trigger(timers_ch_update),
+        .irq(spi1_dma_irq)
+    );
+
+    // SPI0/SPI1 DMA arbiter: no added latency when the port is free
+    reg  spi_up_lock;       // A request is in flight
+    reg  spi_up_owner;      // ... from SPI1
+    reg  spi_up_last;       // SPI1 had the last grant
+    wire spi_up_sel1 = spi_up_lock ? spi_up_owner :
+                       spi1_dma_mem_valid && (!spi_dma_mem_valid || !spi_up_last);
+
+    assign spi_up_valid = spi_up_sel1 ? spi1_dma_mem_valid : spi_dma_mem_valid;
+    assign spi_up_addr  = spi_up_sel1 ? spi1_dma_mem_addr  : spi_dma_mem_addr;
+    assign spi_up_wdata = spi_up_sel1 ? spi1_dma_mem_wdata : spi_dma_mem_wdata;
+    assign spi_up_wstrb = spi_up_sel1 ? spi1_dma_mem_wstrb : spi_dma_mem_wstrb;
+    assign spi_dma_mem_ready  = spi_up_ready && !spi_up_sel1;
+    assign spi1_dma_mem_ready = spi_up_ready && spi_up_sel1;
+    assign spi_dma_mem_rdata  = spi_up_rdata;
+
+    always @(posedge clk) begin
+        if (!cpu_resetn) begin
+            spi_up_lock  <= 1'b0;
+            spi_up_owner <= 1'b0;
+            spi_up_last  <= 1'b0;
+        end else if (spi_up_valid) begin
+            if (spi_up_ready) begin
+                spi_up_lock <= 1'b0;
+                spi_up_last <= spi_up_sel1;
+            end else begin
+                spi_up_lock  <= 1'b1;
+                spi_up_owner <= spi_up_sel1;
+            end
+        end
+    end
+`else
+    assign spi1_rdata = 32'h0;
+    assign spi1_ready = mmio_valid;
+    assign spi1_irq   = 1'b0;
+    assign SPI1_SCK   = 1'b0;
+    assign SPI1_MOSI  = 1'b1;
+    assign SPI1_CS    = 1'b1;
+
+    assign spi_up_valid = spi_dma_mem_valid;
+    assign spi_up_addr  = spi_dma_mem_addr;
+    assign spi_up_wdata = spi_dma_mem_wdata;
+    assign spi_up_wstrb = spi_dma_mem_wstrb;
+    assign spi_dma_mem_ready = spi_up_ready;
+    assign spi_dma_mem_rdata = spi_up_rdata;
+`endif
+
 endmodule
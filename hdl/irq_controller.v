@@ -0,0 +1,143 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// irq_controller.v - Interrupt Controller (enable / pending / priority)
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+// PURPOSE: One place to enable, prioritise and identify interrupt sources,
+//          so the startup code can dispatch through a table (lib/irq.h)
+//          instead of every irq_handler bit-testing the PicoRV32 IRQ mask.
+//
+// Sources keep their PicoRV32 IRQ numbers: irq_out[n] = src[n] & ENABLE[n]
+// drives CPU IRQ[n]. After reset every source except the button is enabled,
+// so firmware with its own irq_handler sees exactly the old IRQ lines.
+//
+// PENDING latches enabled pulse sources until acknowledged; LEVEL_MASK sources
+// (UART) read their live level instead. CLAIM returns the highest priority
+// pending enabled source (ties go to the lower number); writing the source
+// number back to CLAIM acknowledges it. PicoRV32 does not nest interrupts,
+// so priority orders dispatch within one IRQ entry, it does not preempt.
+//==============================================================================
+
+module irq_controller #(
+    parameter [7:0] ENABLE_RESET = 8'hBF,   // All but the button
+    parameter [7:0] LEVEL_MASK   = 8'h30    // UART RX/TX
+) (
+    input wire clk,
+    input wire resetn,
+
+    // MMIO Interface
+    input wire        mmio_valid,
+    input wire        mmio_write,
+    input wire [31:0] mmio_addr,
+    input wire [31:0] mmio_wdata,
+    input wire [ 3:0] mmio_wstrb,
+    output reg [31:0] mmio_rdata,
+    output wire       mmio_ready,
+
+    // Interrupt sources and gated outputs to the CPU
+    input wire  [7:0] irq_src,
+    output wire [7:0] irq_out
+);
+
+    // =========================================================================
+    // Register Map
+    // Base: 0x80000140
+    // =========================================================================
+    // +0x00: ENABLE   (RW) - [n]=source n reaches CPU IRQ[n] and CLAIM
+    // +0x04: PENDING  (R)  - [n]=source n pending (levels read live)
+    //                 (W)  - Write 1 to clear latched bits
+    // +0x08: PRIORITY (RW) - [4n+3:4n]=source n priority (15 = highest)
+    // +0x0C: CLAIM    (R)  - [31]=valid, [30]=present, [11:8]=priority,
+    //                        [2:0]=highest priority pending enabled source
+    //                 (W)  - [2:0]=acknowledge source (clear its pending bit)
+    // =========================================================================
+
+    localparam ADDR_ENABLE   = 2'h0;
+    localparam ADDR_PENDING  = 2'h1;
+    localparam ADDR_PRIORITY = 2'h2;
+    localparam ADDR_CLAIM    = 2'h3;
+
+    reg [ 7:0] enable;
+    reg [ 7:0] latched;
+    reg [31:0] prio;
+
+    wire [7:0] pending = (latched & ~LEVEL_MASK) | (irq_src & LEVEL_MASK);
+    wire [7:0] active  = pending & enable;
+
+    assign irq_out = irq_src & enable;
+
+    // Highest priority active source, lowest number on ties (registered)
+    reg       claim_valid;
+    reg [2:0] claim_id;
+    reg [3:0] claim_prio;
+
+    reg       best_valid;
+    reg [2:0] best_id;
+    reg [3:0] best_prio;
+    integer   i;
+
+    always @(*) begin
+        best_valid = 1'b0;
+        best_id = 3'd0;
+        best_prio = 4'd0;
+        for (i = 7; i >= 0; i = i - 1) begin
+            if (active[i] && (!best_valid || prio[4*i +: 4] >= best_prio)) begin
+                best_valid = 1'b1;
+                best_id = i;
+                best_prio = prio[4*i +: 4];
+            end
+        end
+    end
+
+    wire [1:0] reg_sel = mmio_addr[3:2];
+    wire       ack     = mmio_valid && mmio_write && (reg_sel == ADDR_CLAIM) && mmio_wstrb[0];
+    wire [7:0] ack_mask = ack ? (8'h01 << mmio_wdata[2:0]) : 8'h00;
+    wire [7:0] w1c_mask = (mmio_valid && mmio_write && reg_sel == ADDR_PENDING && mmio_wstrb[0]) ?
+                          mmio_wdata[7:0] : 8'h00;
+
+    // MMIO ready - combinational response (same cycle)
+    assign mmio_ready = mmio_valid;
+
+    always @(posedge clk) begin
+        if (!resetn) begin
+            enable <= ENABLE_RESET;
+            latched <= 8'h00;
+            prio <= 32'h0;
+            claim_valid <= 1'b0;
+            claim_id <= 3'd0;
+            claim_prio <= 4'd0;
+        end else begin
+            // Clear on acknowledge, then latch this cycle's enabled events
+            latched <= (latched & ~ack_mask & ~w1c_mask) | (irq_src & enable);
+
+            // The claim just acknowledged is no longer offered
+            claim_valid <= best_valid && !(ack && mmio_wdata[2:0] == best_id);
+            claim_id <= best_id;
+            claim_prio <= best_prio;
+
+            if (mmio_valid && mmio_write) begin
+                case (reg_sel)
+                    ADDR_ENABLE:   if (mmio_wstrb[0]) enable <= mmio_wdata[7:0];
+                    ADDR_PRIORITY: if (mmio_wstrb == 4'hF) prio <= mmio_wdata;
+                    default: ;
+                endcase
+            end
+        end
+    end
+
+    always @(*) begin
+        case (reg_sel)
+            ADDR_ENABLE:   mmio_rdata = {24'h0, enable};
+            ADDR_PENDING:  mmio_rdata = {24'h0, pending};
+            ADDR_PRIORITY: mmio_rdata = prio;
+            ADDR_CLAIM:    mmio_rdata = {claim_valid, 1'b1, 18'h0, claim_prio, 5'h0, claim_id};
+            default:       mmio_rdata = 32'h0;
+        endcase
+    end
+
+endmodule
@@ -0,0 +1,152 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// mailbox.v - Inter-Core Mailbox and Core 1 Run Control (Kconfig DUAL_CORE)
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+// PURPOSE: One 32-bit message slot in each direction between core 0 and
+//          core 1 (core1.v), with a full flag, an interrupt per core and
+//          the run bit that lets core 1 out of reset. Both cores see the
+//          block at 0x80000260 with the same layout: core 0 through the
+//          shared MMIO bus, core 1 on its own port (core1.v decodes it
+//          locally), so polling the mailbox never takes the shared bus.
+//
+// A slot is written by one core and read by the other: TX fills it, the
+// peer's RX read empties it. TX into a full slot is dropped - the sender
+// checks TX_FULL first (lib/mailbox.h). Larger messages live in SRAM and
+// the word sent is their address.
+//==============================================================================
+
+module mailbox (
+    input wire clk,
+    input wire resetn,
+
+    // Port 0: core 0, shared MMIO bus
+    input wire        mmio0_valid,
+    input wire        mmio0_write,
+    input wire [31:0] mmio0_addr,
+    input wire [31:0] mmio0_wdata,
+    input wire [ 3:0] mmio0_wstrb,
+    output reg [31:0] mmio0_rdata,
+    output wire       mmio0_ready,
+
+    // Port 1: core 1, local bus
+    input wire        mmio1_valid,
+    input wire        mmio1_write,
+    input wire [31:0] mmio1_addr,
+    input wire [31:0] mmio1_wdata,
+    input wire [ 3:0] mmio1_wstrb,
+    output reg [31:0] mmio1_rdata,
+    output wire       mmio1_ready,
+
+    output wire       core1_run,        // Low: core 1 held in reset
+    output wire       irq0,             // Core 0 IRQ[9]: message for core 0
+    output wire       irq1              // Core 1 IRQ[0]: message for core 1
+);
+
+    // =========================================================================
+    // Register Map
+    // Base: 0x80000260 for both cores, each sees its own side
+    // =========================================================================
+    // +0x00: STATUS (R)  - [0]=RX_FULL (message waiting), [1]=TX_FULL (the
+    //                      peer has not read the last one), [8]=core id,
+    //                      [16]=core 1 running, [31]=present
+    // +0x04: TX     (W)  - Send a word (dropped while TX_FULL)
+    // +0x08: RX     (R)  - Receive: the waiting word, clears RX_FULL
+    // +0x0C: CTRL   (RW) - [0]=IRQ on RX_FULL; core 0 only: [8]=core 1 run
+    //                      (0 holds core 1 in reset and empties its slot)
+    // =========================================================================
+
+    localparam REG_STATUS = 4'h0;
+    localparam REG_TX     = 4'h4;
+    localparam REG_RX     = 4'h8;
+    localparam REG_CTRL   = 4'hC;
+
+    reg [31:0] msg01;           // Core 0 -> core 1
+    reg [31:0] msg10;           // Core 1 -> core 0
+    reg full01, full10;
+    reg irq_en0, irq_en1;
+    reg run;
+
+    assign core1_run = run;
+    assign irq0 = full10 && irq_en0;
+    assign irq1 = full01 && irq_en1;
+
+    // MMIO ready - combinational response (same cycle)
+    assign mmio0_ready = mmio0_valid;
+    assign mmio1_ready = mmio1_valid;
+
+    wire [3:0] reg0 = mmio0_addr[3:0];
+    wire [3:0] reg1 = mmio1_addr[3:0];
+
+    // mmio_valid is a one-cycle strobe on both ports: one change per access
+    wire tx0 = mmio0_valid && mmio0_write && reg0 == REG_TX && mmio0_wstrb == 4'hF;
+    wire tx1 = mmio1_valid && mmio1_write && reg1 == REG_TX && mmio1_wstrb == 4'hF;
+    wire rx0 = mmio0_valid && !mmio0_write && reg0 == REG_RX;
+    wire rx1 = mmio1_valid && !mmio1_write && reg1 == REG_RX;
+
+    always @(posedge clk or negedge resetn) begin
+        if (!resetn) begin
+            msg01 <= 32'h0;
+            msg10 <= 32'h0;
+            full01 <= 1'b0;
+            full10 <= 1'b0;
+            irq_en0 <= 1'b0;
+            irq_en1 <= 1'b0;
+            run <= 1'b0;
+        end else begin
+            // Core 0 -> core 1; a message posted before the run bit is
+            // there for core 1 when it starts
+            if (rx1)
+                full01 <= 1'b0;
+            if (tx0 && !full01) begin
+                msg01 <= mmio0_wdata;
+                full01 <= 1'b1;
+            end
+
+            // Core 1 -> core 0
+            if (rx0)
+                full10 <= 1'b0;
+            if (tx1 && !full10) begin
+                msg10 <= mmio1_wdata;
+                full10 <= 1'b1;
+            end
+
+            if (mmio0_valid && mmio0_write && reg0 == REG_CTRL) begin
+                if (mmio0_wstrb[0]) irq_en0 <= mmio0_wdata[0];
+                if (mmio0_wstrb[1]) run <= mmio0_wdata[8];
+            end
+            if (mmio1_valid && mmio1_write && reg1 == REG_CTRL && mmio1_wstrb[0])
+                irq_en1 <= mmio1_wdata[0];
+
+            // Core 1 in reset: nothing of its side survives
+            if (!run) begin
+                full10 <= 1'b0;
+                irq_en1 <= 1'b0;
+            end
+        end
+    end
+
+    always @(*) begin
+        case (reg0)
+            REG_STATUS: mmio0_rdata = {1'b1, 14'h0, run, 7'h0, 1'b0, 6'h0, full01, full10};
+            REG_RX:     mmio0_rdata = msg10;
+            REG_CTRL:   mmio0_rdata = {23'h0, run, 7'h0, irq_en0};
+            default:    mmio0_rdata = 32'h0;
+        endcase
+    end
+
+    always @(*) begin
+        case (reg1)
+            REG_STATUS: mmio1_rdata = {1'b1, 14'h0, run, 7'h0, 1'b1, 6'h0, full10, full01};
+            REG_RX:     mmio1_rdata = msg01;
+            REG_CTRL:   mmio1_rdata = {31'h0, irq_en1};
+            default:    mmio1_rdata = 32'h0;
+        endcase
+    end
+
+endmodule
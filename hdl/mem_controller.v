@@ -9,25 +9,66 @@
 // Educational and research purposes only
 //==============================================================================
 
-module mem_controller (
+module mem_controller #(
+    parameter LOOKAHEAD = 0,            // Start accesses from PicoRV32 mem_la_* outputs
+    parameter FLASH_XIP = 0,            // Decode the SPI flash window (spi_flash_xip.v)
+    parameter DUAL_CORE = 0             // Serve the second core's port (core1.v)
+) (
     input wire clk,
     input wire resetn,
 
     // PicoRV32 Memory Interface
     input wire        cpu_mem_valid,
     input wire        cpu_mem_instr,
-    output reg        cpu_mem_ready,
+    output wire       cpu_mem_ready,
     input wire [31:0] cpu_mem_addr,
     input wire [31:0] cpu_mem_wdata,
     input wire [ 3:0] cpu_mem_wstrb,
-    output reg [31:0] cpu_mem_rdata,
+    input wire [ 3:0] cpu_mem_burst,    // Extra sequential SRAM read words (caches)
+    output wire [31:0] cpu_mem_rdata,   // One ready pulse per word in a burst
+
+    // PicoRV32 Look-Ahead Interface (used when LOOKAHEAD=1)
+    input wire        cpu_la_read,
+    input wire        cpu_la_write,
+    input wire [31:0] cpu_la_addr,
+    input wire [31:0] cpu_la_wdata,
+    input wire [ 3:0] cpu_la_wstrb,
+
+    // DMA Master Interface (mem_dma.v, passing spi_dma.v through) - SRAM only
+    input wire        dma_valid,
+    output wire       dma_ready,        // One ready pulse per word in a burst
+    input wire [31:0] dma_addr,
+    input wire [31:0] dma_wdata,
+    input wire [ 3:0] dma_wstrb,
+    input wire [ 3:0] dma_burst,        // Extra sequential read words
+    output wire [31:0] dma_rdata,
+
+    // Second Core Interface (core1.v, used when DUAL_CORE=1) - no bursts
+    input wire        c1_valid,
+    output wire       c1_ready,
+    input wire [31:0] c1_addr,
+    input wire [31:0] c1_wdata,
+    input wire [ 3:0] c1_wstrb,
+    output wire [31:0] c1_rdata,
 
     // Bootloader ROM Interface (read-only)
     output reg        boot_enable,
     output reg [12:0] boot_addr,
     input wire [31:0] boot_rdata,
 
-    // SRAM Interface (via sram_proc_new)
+    // Scratchpad RAM Interface (read/write BRAM)
+    output wire [12:0] spad_addr,
+    output wire [ 3:0] spad_we,
+    output wire [31:0] spad_wdata,
+    input wire [31:0]  spad_rdata,
+
+    // SPI Flash Read Interface (read-only, spi_flash_xip)
+    output reg        flash_start,
+    output reg [23:0] flash_addr,
+    input wire        flash_done,
+    input wire [31:0] flash_rdata,
+
+    // SRAM Interface (via sram_controller)
     output reg        sram_start,
     input wire        sram_busy,
     input wire        sram_done,
@@ -35,6 +76,7 @@ module mem_controller (
     output reg [31:0] sram_addr,
     output reg [31:0] sram_wdata,
     output reg [ 3:0] sram_wstrb,
+    output reg [ 3:0] sram_burst,
     input wire [31:0] sram_rdata,
 
     // MMIO Interface
@@ -44,7 +86,13 @@ module mem_controller (
     output reg [31:0] mmio_wdata,
     output reg [ 3:0] mmio_wstrb,
     input wire [31:0] mmio_rdata,
-    input wire        mmio_ready
+    input wire        mmio_ready,
+
+    // Performance Monitor
+    output wire       stat_sram_wait,   // Level: in STATE_SRAM_WAIT
+    output wire       stat_mmio_wait,   // Level: in STATE_MMIO_WAIT
+    output wire       stat_boot_wait,   // Level: in STATE_BOOT_WAIT/BOOT_WAIT2
+    output wire       stat_spad         // Pulse: scratchpad access answered
 );
 
     // Memory Map
@@ -52,42 +100,121 @@ module mem_controller (
     localparam SRAM_END  = 32'h0007FFFF;  // 512 KB
     localparam BOOT_BASE = 32'h00040000;  // Bootloader ROM (after 256KB code)
     localparam BOOT_END  = 32'h00041FFF;  // 8 KB
+    localparam SPAD_BASE = 32'h00080000;  // Scratchpad RAM (directly above SRAM)
+    localparam SPAD_END  = 32'h00081FFF;  // 8 KB window
+    localparam FLASH_BASE = 32'h01000000; // SPI flash, execute in place
+    localparam FLASH_END  = 32'h01FFFFFF; // 16 MB window (24-bit flash address)
     localparam MMIO_BASE = 32'h80000000;
-    localparam MMIO_END  = 32'h800000FF;
+    localparam MMIO_END  = 32'h800003FF;
 
     // SRAM Commands
     localparam CMD_READ  = 8'h01;
     localparam CMD_WRITE = 8'h02;
 
     // State Machine
-    localparam STATE_IDLE       = 3'h0;
-    localparam STATE_SRAM_WAIT  = 3'h1;
-    localparam STATE_MMIO_WAIT  = 3'h2;
-    localparam STATE_BOOT_WAIT  = 3'h3;
-    localparam STATE_BOOT_WAIT2 = 3'h4;
-    localparam STATE_DONE       = 3'h5;
-
-    reg [2:0] state;
+    localparam STATE_IDLE       = 4'h0;
+    localparam STATE_SRAM_WAIT  = 4'h1;
+    localparam STATE_MMIO_WAIT  = 4'h2;
+    localparam STATE_BOOT_WAIT  = 4'h3;
+    localparam STATE_BOOT_WAIT2 = 4'h4;
+    localparam STATE_DONE       = 4'h5;
+    localparam STATE_SPAD       = 4'h6;
+    localparam STATE_DMA_WAIT   = 4'h7;
+    localparam STATE_FLASH_WAIT = 4'h8;
+
+    reg [3:0] state;
     reg [31:0] saved_addr;
     reg saved_is_write;
+    reg [3:0] burst_left;       // Burst words still to forward after the next
+    reg cpu_ready_q;            // Registered ready/rdata (SRAM, boot ROM, MMIO)
+    reg [31:0] cpu_rdata_q;     // Both cores' responses, owner_c1 says whose
+    reg owner_c1;               // Transaction in progress is core 1's
+    reg dma_ready_q;
+    reg [31:0] dma_rdata_q;
+    reg dma_turn;               // DMA wins the next tie (set after a CPU access)
+    reg c1_turn;                // Core 1 wins the next tie with core 0
+
+    // Request Select
+    // With LOOKAHEAD, PicoRV32 announces the next access on mem_la_* one cycle
+    // before it raises mem_valid, so the access starts (and is decoded) a cycle
+    // early. The look-ahead strobe can also arrive in the cycle where the
+    // previous transaction's ready is still high, which gives a direct
+    // IDLE-to-IDLE turnaround without waiting for ready to drop.
+    wire        la_req    = LOOKAHEAD && (cpu_la_read || cpu_la_write);
+    wire        req_valid = la_req || (cpu_mem_valid && !cpu_mem_ready);
+    wire [31:0] req_addr  = la_req ? cpu_la_addr : cpu_mem_addr;
+    wire [31:0] req_wdata = la_req ? cpu_la_wdata : cpu_mem_wdata;
+    wire [ 3:0] req_wstrb = la_req ? (cpu_la_wstrb & {4{cpu_la_write}}) : cpu_mem_wstrb;
+    wire [ 3:0] req_burst = la_req ? 4'h0 : cpu_mem_burst;
+
+    // Arbitration
+    // One transaction at a time; while both masters are requesting they
+    // alternate, so neither the CPU nor a running DMA transfer starves.
+    // With DUAL_CORE the two cores form one side: DMA alternates with
+    // whichever core goes next, and the cores alternate between themselves.
+    wire c1_ready_w = cpu_ready_q && owner_c1;
+    wire c1_req    = DUAL_CORE && c1_valid && !c1_ready_w;
+    wire dma_req   = dma_valid && !dma_ready_q;
+    wire dma_grant = dma_req && (!(req_valid || c1_req) || dma_turn);
+    wire c1_grant  = c1_req && !dma_grant && (!req_valid || c1_turn);
+    wire cpu_grant = req_valid && !dma_grant && !c1_grant;
+
+    assign dma_ready = dma_ready_q;
+    assign dma_rdata = dma_rdata_q;
+    assign c1_ready  = c1_ready_w;
+    assign c1_rdata  = cpu_rdata_q;
+
+    // Granted core's request: core 1 goes through the same decode and
+    // states as core 0 (its scratchpad is local to core1.v)
+    wire [31:0] acc_addr  = c1_grant ? c1_addr  : req_addr;
+    wire [31:0] acc_wdata = c1_grant ? c1_wdata : req_wdata;
+    wire [ 3:0] acc_wstrb = c1_grant ? c1_wstrb : req_wstrb;
+    wire [ 3:0] acc_burst = c1_grant ? 4'h0     : req_burst;
 
     // Address Decode
-    wire addr_is_sram = (cpu_mem_addr >= SRAM_BASE) && (cpu_mem_addr <= SRAM_END);
-    wire addr_is_boot = (cpu_mem_addr >= BOOT_BASE) && (cpu_mem_addr <= BOOT_END);
-    wire addr_is_mmio = (cpu_mem_addr >= MMIO_BASE) && (cpu_mem_addr <= MMIO_END);
+    wire addr_is_sram = (acc_addr >= SRAM_BASE) && (acc_addr <= SRAM_END);
+    wire addr_is_boot = (acc_addr >= BOOT_BASE) && (acc_addr <= BOOT_END);
+    wire addr_is_mmio = (acc_addr >= MMIO_BASE) && (acc_addr <= MMIO_END);
+    wire addr_is_spad = (acc_addr >= SPAD_BASE) && (acc_addr <= SPAD_END);
+    wire addr_is_flash = FLASH_XIP && (acc_addr >= FLASH_BASE) && (acc_addr <= FLASH_END);
+
+    // Scratchpad
+    // The BRAM samples the request address every cycle and stores are written
+    // on the accepting edge, so STATE_SPAD can answer straight from the BRAM
+    // output: ready comes one cycle after mem_valid instead of going through
+    // the registered response path.
+    wire spad_accept = (state == STATE_IDLE) && cpu_grant && addr_is_spad;
+    wire spad_ready  = (state == STATE_SPAD);
+
+    assign spad_addr  = req_addr[12:0];
+    assign spad_we    = spad_accept ? req_wstrb : 4'h0;
+    assign spad_wdata = req_wdata;
+
+    assign cpu_mem_ready = (cpu_ready_q && !owner_c1) || spad_ready;
+    assign cpu_mem_rdata = spad_ready ? spad_rdata : cpu_rdata_q;
+
+    // Performance Monitor taps
+    assign stat_sram_wait = (state == STATE_SRAM_WAIT);
+    assign stat_mmio_wait = (state == STATE_MMIO_WAIT);
+    assign stat_boot_wait = (state == STATE_BOOT_WAIT) || (state == STATE_BOOT_WAIT2);
+    assign stat_spad      = spad_ready;
 
     always @(posedge clk) begin
         if (!resetn) begin
             state <= STATE_IDLE;
-            cpu_mem_ready <= 1'b0;
-            cpu_mem_rdata <= 32'h0;
+            cpu_ready_q <= 1'b0;
+            cpu_rdata_q <= 32'h0;
             boot_enable <= 1'b0;
             boot_addr <= 13'h0;
+            flash_start <= 1'b0;
+            flash_addr <= 24'h0;
             sram_start <= 1'b0;
             sram_cmd <= 8'h0;
             sram_addr <= 32'h0;
             sram_wdata <= 32'h0;
             sram_wstrb <= 4'h0;
+            sram_burst <= 4'h0;
+            burst_left <= 4'h0;
             mmio_valid <= 1'b0;
             mmio_write <= 1'b0;
             mmio_addr <= 32'h0;
@@ -95,66 +222,101 @@ module mem_controller (
             mmio_wstrb <= 4'h0;
             saved_addr <= 32'h0;
             saved_is_write <= 1'b0;
+            dma_ready_q <= 1'b0;
+            dma_rdata_q <= 32'h0;
+            dma_turn <= 1'b0;
+            c1_turn <= 1'b0;
+            owner_c1 <= 1'b0;
         end else begin
             // Default: clear control signals
-            cpu_mem_ready <= 1'b0;
+            cpu_ready_q <= 1'b0;
+            dma_ready_q <= 1'b0;
             boot_enable <= 1'b0;
+            flash_start <= 1'b0;
             sram_start <= 1'b0;
             mmio_valid <= 1'b0;
 
             case (state)
                 STATE_IDLE: begin
-                    if (cpu_mem_valid && !cpu_mem_ready) begin
-                        saved_addr <= cpu_mem_addr;
-                        saved_is_write <= |cpu_mem_wstrb;
+                    if (dma_grant) begin
+                        // DMA word to/from SRAM
+                        sram_cmd <= |dma_wstrb ? CMD_WRITE : CMD_READ;
+                        sram_addr <= {13'h0, dma_addr[18:0]};
+                        sram_wdata <= dma_wdata;
+                        sram_wstrb <= dma_wstrb;
+                        sram_burst <= |dma_wstrb ? 4'h0 : dma_burst;
+                        burst_left <= |dma_wstrb ? 4'h0 : dma_burst;
+                        sram_start <= 1'b1;
+                        dma_turn <= 1'b0;
+                        state <= STATE_DMA_WAIT;
 
-                        if (addr_is_boot && !(|cpu_mem_wstrb)) begin
+                    end else if (cpu_grant || c1_grant) begin
+                        dma_turn <= 1'b1;
+                        c1_turn <= cpu_grant;
+                        owner_c1 <= c1_grant;
+                        saved_addr <= acc_addr;
+                        saved_is_write <= |acc_wstrb;
+
+                        if (addr_is_boot && !(|acc_wstrb)) begin
                             // Route to Bootloader ROM (read-only)
                             boot_enable <= 1'b1;
-                            boot_addr <= cpu_mem_addr[12:0];  // 8KB address space
+                            boot_addr <= acc_addr[12:0];  // 8KB address space
                             state <= STATE_BOOT_WAIT;
 
                             // synthesis translate_off
-                            // $display("[MEM_CTRL] BOOT ROM read: addr=0x%08x", cpu_mem_addr);
+                            // $display("[MEM_CTRL] BOOT ROM read: addr=0x%08x", req_addr);
                             // synthesis translate_on
 
                         end else if (addr_is_sram) begin
                             // Route to SRAM
-                            sram_cmd <= |cpu_mem_wstrb ? CMD_WRITE : CMD_READ;
-                            sram_addr <= cpu_mem_addr;
-                            sram_wdata <= cpu_mem_wdata;
-                            sram_wstrb <= cpu_mem_wstrb;
+                            sram_cmd <= |acc_wstrb ? CMD_WRITE : CMD_READ;
+                            sram_addr <= acc_addr;
+                            sram_wdata <= acc_wdata;
+                            sram_wstrb <= acc_wstrb;
+                            sram_burst <= |acc_wstrb ? 4'h0 : acc_burst;
+                            burst_left <= |acc_wstrb ? 4'h0 : acc_burst;
                             sram_start <= 1'b1;
                             state <= STATE_SRAM_WAIT;
 
                             // synthesis translate_off
                             // $display("[MEM_CTRL] SRAM access: addr=0x%08x %s data=0x%08x wstrb=0x%01x",
-                            //          cpu_mem_addr, |cpu_mem_wstrb ? "WRITE" : "READ",
-                            //          cpu_mem_wdata, cpu_mem_wstrb);
+                            //          req_addr, |req_wstrb ? "WRITE" : "READ",
+                            //          req_wdata, req_wstrb);
                             // synthesis translate_on
 
+                        end else if (addr_is_spad && cpu_grant) begin
+                            // Route to Scratchpad RAM (store already written)
+                            state <= STATE_SPAD;
+
+                        end else if (addr_is_flash && !(|acc_wstrb)) begin
+                            // Route to SPI flash (read-only; stores fall
+                            // through to the invalid address case)
+                            flash_start <= 1'b1;
+                            flash_addr <= acc_addr[23:0];
+                            state <= STATE_FLASH_WAIT;
+
                         end else if (addr_is_mmio) begin
                             // Route to MMIO
                             mmio_valid <= 1'b1;
-                            mmio_write <= |cpu_mem_wstrb;
-                            mmio_addr <= cpu_mem_addr;
-                            mmio_wdata <= cpu_mem_wdata;
-                            mmio_wstrb <= cpu_mem_wstrb;
+                            mmio_write <= |acc_wstrb;
+                            mmio_addr <= acc_addr;
+                            mmio_wdata <= acc_wdata;
+                            mmio_wstrb <= acc_wstrb;
                             state <= STATE_MMIO_WAIT;
 
                             // synthesis translate_off
                             // $display("[MEM_CTRL] MMIO access: addr=0x%08x %s data=0x%08x",
-                            //          cpu_mem_addr, |cpu_mem_wstrb ? "WRITE" : "READ",
-                            //          cpu_mem_wdata);
+                            //          req_addr, |req_wstrb ? "WRITE" : "READ",
+                            //          req_wdata);
                             // synthesis translate_on
 
                         end else begin
                             // Invalid address - return 0 immediately
-                            cpu_mem_rdata <= 32'h0;
-                            cpu_mem_ready <= 1'b1;
+                            cpu_rdata_q <= 32'h0;
+                            cpu_ready_q <= 1'b1;
 
                             // synthesis translate_off
-                            // $display("[MEM_CTRL] Invalid address: 0x%08x", cpu_mem_addr);
+                            // $display("[MEM_CTRL] Invalid address: 0x%08x", req_addr);
                             // synthesis translate_on
                         end
                     end
@@ -167,8 +329,8 @@ module mem_controller (
 
                 STATE_BOOT_WAIT2: begin
                     // Bootloader ROM: data is now available after 2-cycle latency
-                    cpu_mem_rdata <= boot_rdata;
-                    cpu_mem_ready <= 1'b1;
+                    cpu_rdata_q <= boot_rdata;
+                    cpu_ready_q <= 1'b1;
                     state <= STATE_IDLE;
 
                     // synthesis translate_off
@@ -176,10 +338,30 @@ module mem_controller (
                     // synthesis translate_on
                 end
 
+                STATE_SPAD: begin
+                    // Scratchpad answers combinationally from spad_rdata
+                    state <= STATE_IDLE;
+                end
+
+                STATE_FLASH_WAIT: begin
+                    // Line buffer hit in a few cycles, a miss takes the
+                    // flash command and the word on the wire
+                    if (flash_done) begin
+                        cpu_rdata_q <= flash_rdata;
+                        cpu_ready_q <= 1'b1;
+                        state <= STATE_IDLE;
+                    end
+                end
+
                 STATE_SRAM_WAIT: begin
-                    if (sram_done) begin
-                        cpu_mem_rdata <= sram_rdata;
-                        cpu_mem_ready <= 1'b1;
+                    if (sram_done && burst_left != 4'h0) begin
+                        // Burst word - forward and keep waiting
+                        cpu_rdata_q <= sram_rdata;
+                        cpu_ready_q <= 1'b1;
+                        burst_left <= burst_left - 1'b1;
+                    end else if (sram_done) begin
+                        cpu_rdata_q <= sram_rdata;
+                        cpu_ready_q <= 1'b1;
                         state <= STATE_IDLE;
 
                         // synthesis translate_off
@@ -190,10 +372,22 @@ module mem_controller (
                     end
                 end
 
+                STATE_DMA_WAIT: begin
+                    if (sram_done && burst_left != 4'h0) begin
+                        dma_rdata_q <= sram_rdata;
+                        dma_ready_q <= 1'b1;
+                        burst_left <= burst_left - 1'b1;
+                    end else if (sram_done) begin
+                        dma_rdata_q <= sram_rdata;
+                        dma_ready_q <= 1'b1;
+                        state <= STATE_IDLE;
+                    end
+                end
+
                 STATE_MMIO_WAIT: begin
                     if (mmio_ready) begin
-                        cpu_mem_rdata <= mmio_rdata;
-                        cpu_mem_ready <= 1'b1;
+                        cpu_rdata_q <= mmio_rdata;
+                        cpu_ready_q <= 1'b1;
                         state <= STATE_IDLE;
 
                         // synthesis translate_off
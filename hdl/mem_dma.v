@@ -0,0 +1,290 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// mem_dma.v - SRAM-to-SRAM Copy / Fill DMA Engine
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+// PURPOSE: memcpy/memset without the CPU (lib/dma.h dma_memcpy_async()).
+//
+// Copy reads BURST words with one SRAM read burst, then writes them back
+// one word per request; fill writes the FILL pattern. Both work on whole
+// words (word-aligned SRAM addresses, LEN a multiple of 4) and go forward,
+// so overlapping copies are only safe with DST < SRC.
+//
+// Checksum mode only reads: every word from SRC adds its two halfwords to
+// SUM with end-around carry, the ones-complement sum of RFC 1071 in the
+// byte order lwIP expects (lib/dma.h dma_chksum(), used as LWIP_CHKSUM).
+//
+// The engine also owns the mem_controller DMA port: spi_dma.v's master
+// port passes through (up_*) and wins between transactions, so SD
+// transfers keep their FIFO timing while a long copy runs.
+//
+// DMA bypasses the caches: clean SRC and invalidate DST in the D-cache
+// first (done by lib/dma.h). Completion sets CTRL.DONE and, with
+// CTRL.IRQ_EN, pulses irq (IRQ[3]).
+//==============================================================================
+
+module mem_dma (
+    input wire clk,
+    input wire resetn,
+
+    // MMIO Interface
+    input wire        mmio_valid,
+    input wire        mmio_write,
+    input wire [31:0] mmio_addr,
+    input wire [31:0] mmio_wdata,
+    input wire [ 3:0] mmio_wstrb,
+    output reg [31:0] mmio_rdata,
+    output wire       mmio_ready,
+
+    // Upstream master (spi_dma.v), single-word requests
+    input wire        up_valid,
+    output wire       up_ready,
+    input wire [31:0] up_addr,
+    input wire [31:0] up_wdata,
+    input wire [ 3:0] up_wstrb,
+    output wire [31:0] up_rdata,
+
+    // mem_controller DMA port
+    output wire       mem_valid,
+    input wire        mem_ready,        // One pulse per word (bursts too)
+    output wire [31:0] mem_addr,
+    output wire [31:0] mem_wdata,
+    output wire [ 3:0] mem_wstrb,
+    output wire [ 3:0] mem_burst,       // Extra sequential read words
+    input wire [31:0] mem_rdata,
+
+    output reg        irq               // Single-cycle pulse on completion
+);
+
+    // =========================================================================
+    // Register Map
+    // Base: 0x80000100
+    // =========================================================================
+    // +0x00: SRC   (RW) - Source SRAM address (word aligned); advances
+    // +0x04: DST   (RW) - Destination SRAM address (word aligned); advances
+    // +0x08: LEN   (RW) - Byte count (multiple of 4, max 1MB-4); counts down
+    // +0x0C: CTRL  (W)  - [0]=start, [1]=fill (write FILL to DST), [2]=IRQ enable,
+    //                     [3]=checksum (read SRC into SUM, no writes)
+    //              (R)  - [0]=busy, [1]=fill, [2]=IRQ enable, [3]=done, [4]=checksum
+    // +0x10: FILL  (RW) - Fill pattern word
+    // +0x14: SUM   (RW) - Ones-complement accumulator (write the seed, usually 0;
+    //                     fold to 16 bits after reading)
+    // =========================================================================
+
+    localparam ADDR_SRC  = 3'h0;
+    localparam ADDR_DST  = 3'h1;
+    localparam ADDR_LEN  = 3'h2;
+    localparam ADDR_CTRL = 3'h3;
+    localparam ADDR_FILL = 3'h4;
+    localparam ADDR_SUM  = 3'h5;
+
+    localparam BURST = 4;               // Words per read burst (copy buffer)
+
+    // State Machine
+    localparam S_IDLE       = 3'h0;
+    localparam S_READ       = 3'h1;     // Issue read burst
+    localparam S_READ_WAIT  = 3'h2;     // Collect burst words
+    localparam S_WRITE      = 3'h3;     // Issue word write
+    localparam S_WRITE_WAIT = 3'h4;
+
+    reg [2:0]  state;
+    reg [31:0] src;
+    reg [31:0] dst;
+    reg [19:0] len;
+    reg [31:0] fill;
+    reg        fill_mode;
+    reg        sum_mode;
+    reg [31:0] sum;
+    reg        irq_en;
+    reg        done;
+
+    reg [31:0] buffer [0:BURST-1];
+    reg [1:0]  idx;                     // Word within the current burst
+    reg [1:0]  last;                    // Index of the last word in the burst
+
+    wire [2:0] reg_sel    = mmio_addr[4:2];
+    wire       start      = mmio_valid && mmio_write && (reg_sel == ADDR_CTRL) &&
+                            mmio_wstrb[0] && mmio_wdata[0] && (state == S_IDLE);
+
+    // Words left after the current one
+    wire [17:0] words_left = len[19:2] - 1'b1;
+    wire [1:0]  burst_last = (len[19:2] >= BURST) ? BURST - 1 : len[3:2] - 1'b1;
+
+    // Checksum: both halfwords of the incoming word, carries folded back in
+    wire [16:0] sum_halves = {1'b0, mem_rdata[15:0]} + {1'b0, mem_rdata[31:16]};
+    wire [32:0] sum_add    = {1'b0, sum} + {16'h0, sum_halves};
+    wire [31:0] sum_next   = sum_add[31:0] + {31'h0, sum_add[32]};
+    wire [19:0] burst_bytes = {16'h0, last, 2'b00} + 20'd4;
+
+    // MMIO ready - combinational response (same cycle)
+    assign mmio_ready = mmio_valid;
+
+    always @(*) begin
+        case (reg_sel)
+            ADDR_SRC:  mmio_rdata = src;
+            ADDR_DST:  mmio_rdata = dst;
+            ADDR_LEN:  mmio_rdata = {12'h0, len};
+            ADDR_CTRL: mmio_rdata = {27'h0, sum_mode, done, irq_en, fill_mode, state != S_IDLE};
+            ADDR_FILL: mmio_rdata = fill;
+            ADDR_SUM:  mmio_rdata = sum;
+            default:   mmio_rdata = 32'h0;
+        endcase
+    end
+
+    // =========================================================================
+    // DMA Port Sharing
+    // spi_dma goes first; once this engine's request is on the port it keeps
+    // it until the last word of the transaction.
+    // =========================================================================
+    reg        own_valid;
+    reg [31:0] own_addr;
+    reg [31:0] own_wdata;
+    reg [ 3:0] own_wstrb;
+    reg [ 3:0] own_burst;
+    reg        own_lock;
+
+    wire sel_own = own_lock || (own_valid && !up_valid);
+
+    assign mem_valid = sel_own ? own_valid : up_valid;
+    assign mem_addr  = sel_own ? own_addr  : up_addr;
+    assign mem_wdata = sel_own ? own_wdata : up_wdata;
+    assign mem_wstrb = sel_own ? own_wstrb : up_wstrb;
+    assign mem_burst = sel_own ? own_burst : 4'h0;
+
+    assign up_ready  = mem_ready && !sel_own;
+    assign up_rdata  = mem_rdata;
+
+    wire own_ready = mem_ready && sel_own;
+
+    always @(posedge clk or negedge resetn) begin
+        if (!resetn) begin
+            state <= S_IDLE;
+            src <= 32'h0;
+            dst <= 32'h0;
+            len <= 20'h0;
+            fill <= 32'h0;
+            fill_mode <= 1'b0;
+            sum_mode <= 1'b0;
+            sum <= 32'h0;
+            irq_en <= 1'b0;
+            done <= 1'b0;
+            irq <= 1'b0;
+            idx <= 2'd0;
+            last <= 2'd0;
+            own_valid <= 1'b0;
+            own_addr <= 32'h0;
+            own_wdata <= 32'h0;
+            own_wstrb <= 4'h0;
+            own_burst <= 4'h0;
+            own_lock <= 1'b0;
+        end else begin
+            irq <= 1'b0;
+
+            if (own_valid && !up_valid)
+                own_lock <= 1'b1;
+
+            // Register writes (ignored while a transfer runs)
+            if (mmio_valid && mmio_write && state == S_IDLE) begin
+                case (reg_sel)
+                    ADDR_SRC:  src <= {mmio_wdata[31:2], 2'b00};
+                    ADDR_DST:  dst <= {mmio_wdata[31:2], 2'b00};
+                    ADDR_LEN:  len <= {mmio_wdata[19:2], 2'b00};
+                    ADDR_CTRL: if (mmio_wstrb[0]) begin
+                        fill_mode <= mmio_wdata[1];
+                        irq_en <= mmio_wdata[2];
+                        sum_mode <= mmio_wdata[3];
+                    end
+                    ADDR_FILL: fill <= mmio_wdata;
+                    ADDR_SUM:  sum <= mmio_wdata;
+                    default: ;
+                endcase
+            end
+
+            case (state)
+                S_IDLE: begin
+                    if (start) begin
+                        done <= 1'b0;
+                        if (len == 20'h0) begin
+                            done <= 1'b1;
+                            irq <= mmio_wdata[2];
+                        end else begin
+                            state <= (mmio_wdata[1] && !mmio_wdata[3]) ? S_WRITE : S_READ;
+                        end
+                    end
+                end
+
+                S_READ: begin
+                    own_valid <= 1'b1;
+                    own_addr <= src;
+                    own_wstrb <= 4'h0;
+                    own_burst <= {2'b00, burst_last};
+                    idx <= 2'd0;
+                    last <= burst_last;
+                    state <= S_READ_WAIT;
+                end
+
+                S_READ_WAIT: begin
+                    if (own_ready) begin
+                        buffer[idx] <= mem_rdata;
+                        if (sum_mode)
+                            sum <= sum_next;
+                        idx <= idx + 1'b1;
+                        if (idx == last) begin
+                            own_valid <= 1'b0;
+                            own_lock <= 1'b0;
+                            src <= src + {28'h0, last, 2'b00} + 32'd4;
+                            idx <= 2'd0;
+                            if (!sum_mode) begin
+                                state <= S_WRITE;
+                            end else if (len == burst_bytes) begin
+                                len <= 20'h0;
+                                done <= 1'b1;
+                                irq <= irq_en;
+                                state <= S_IDLE;
+                            end else begin
+                                len <= len - burst_bytes;
+                                state <= S_READ;
+                            end
+                        end
+                    end
+                end
+
+                S_WRITE: begin
+                    own_valid <= 1'b1;
+                    own_addr <= dst;
+                    own_wdata <= fill_mode ? fill : buffer[idx];
+                    own_wstrb <= 4'hF;
+                    own_burst <= 4'h0;
+                    state <= S_WRITE_WAIT;
+                end
+
+                S_WRITE_WAIT: begin
+                    if (own_ready) begin
+                        own_valid <= 1'b0;
+                        own_lock <= 1'b0;
+                        dst <= dst + 32'd4;
+                        len <= len - 20'd4;
+                        idx <= idx + 1'b1;
+                        if (words_left == 18'h0) begin
+                            done <= 1'b1;
+                            irq <= irq_en;
+                            state <= S_IDLE;
+                        end else if (!fill_mode && idx == last) begin
+                            state <= S_READ;
+                        end else begin
+                            state <= S_WRITE;
+                        end
+                    end
+                end
+
+                default: state <= S_IDLE;
+            endcase
+        end
+    end
+
+endmodule
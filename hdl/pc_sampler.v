@@ -0,0 +1,172 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// pc_sampler.v - Statistical PC Sampler (hot-path profiling)
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+// PURPOSE: Every INTERVAL cycles, records the address of the next completed
+//          instruction fetch on the PicoRV32 bus into a block-RAM FIFO.
+//          Firmware drains it over MMIO (lib/pc_sampler.h) and tools/pcprof
+//          turns the addresses into a per-function profile against the ELF.
+//
+// Nothing runs on the CPU while sampling, so the profile includes code with
+// interrupts disabled and the ISRs themselves. The sampled address is the
+// first fetch after the interval ends: it lags the instruction that was
+// executing by up to one instruction (it is the one PicoRV32 fetches next),
+// which does not matter at function granularity. Fetches are word-aligned,
+// so with compressed instructions two halfwords share one sample address.
+//
+// Pick an INTERVAL that is not a multiple of a loop period (a prime works)
+// or a periodic loop aliases onto a few of its instructions.
+//
+// The CPU-side bus is sampled, so I-cache hits are seen like SRAM fetches.
+//==============================================================================
+
+module pc_sampler #(
+    parameter DEPTH = 512               // Samples (power of 2, 512 = 4 EBR)
+) (
+    input wire clk,
+    input wire resetn,
+
+    // MMIO Interface
+    input wire        mmio_valid,
+    input wire        mmio_write,
+    input wire [31:0] mmio_addr,
+    input wire [31:0] mmio_wdata,
+    input wire [ 3:0] mmio_wstrb,
+    output reg [31:0] mmio_rdata,
+    output wire       mmio_ready,
+
+    // PicoRV32 bus
+    input wire        cpu_mem_valid,
+    input wire        cpu_mem_ready,
+    input wire        cpu_mem_instr,
+    input wire [31:0] cpu_mem_addr
+);
+
+    // =========================================================================
+    // Register Map
+    // Base: 0x800001F0
+    // =========================================================================
+    // +0x00: CTRL     (RW) - [0]=enable, [1]=clear FIFO and LOST (W, self-
+    //                        clearing), [2]=ring (full: drop the oldest
+    //                        sample instead of the new one)
+    // +0x04: INTERVAL (RW) - Cycles between samples (0 is taken as 1)
+    // +0x08: STATUS   (R)  - [15:0]=samples in the FIFO, [16]=full,
+    //                        [17]=lost (a sample was dropped since the last
+    //                        clear), [27:24]=log2(DEPTH), [31]=present
+    // +0x0C: DATA     (R)  - Oldest sample; the read removes it (0 if empty)
+    // =========================================================================
+
+    localparam ADDR_CTRL     = 2'h0;
+    localparam ADDR_INTERVAL = 2'h1;
+    localparam ADDR_STATUS   = 2'h2;
+    localparam ADDR_DATA     = 2'h3;
+
+    localparam AW = $clog2(DEPTH);
+    localparam [3:0] LOG2_DEPTH = AW;
+
+    // MMIO ready - combinational response (same cycle)
+    assign mmio_ready = mmio_valid;
+
+    reg        enable;
+    reg        ring;
+    reg        lost;
+    reg [31:0] interval;
+    reg [31:0] countdown;
+    reg        armed;                   // Interval elapsed, take the next fetch
+
+    (* ram_style = "block" *) reg [31:0] mem [0:DEPTH-1];
+    reg [AW-1:0] wr_ptr;
+    reg [AW-1:0] rd_ptr;
+    reg [AW:0]   count;
+    reg [31:0]   head;                  // mem[rd_ptr], one cycle behind
+
+    wire full  = (count == DEPTH);
+    wire empty = (count == 0);
+
+    wire ctrl_write = mmio_valid && mmio_write && (mmio_addr[3:2] == ADDR_CTRL) && mmio_wstrb[0];
+    wire clear      = ctrl_write && mmio_wdata[1];
+    wire pop        = mmio_valid && !mmio_write && (mmio_addr[3:2] == ADDR_DATA) && !empty;
+
+    wire fetch  = cpu_mem_valid && cpu_mem_ready && cpu_mem_instr;
+    wire sample = enable && armed && fetch;
+    wire push   = sample && (!full || ring);
+
+    // Sample FIFO (registered read: head follows rd_ptr a cycle later, well
+    // before the CPU can issue the next load after a pop)
+    always @(posedge clk) begin
+        if (push)
+            mem[wr_ptr] <= {cpu_mem_addr[31:2], 2'b00};
+        head <= mem[rd_ptr];
+    end
+
+    always @(posedge clk) begin
+        if (!resetn || clear) begin
+            wr_ptr <= {AW{1'b0}};
+            rd_ptr <= {AW{1'b0}};
+            count <= {(AW+1){1'b0}};
+            lost <= 1'b0;
+        end else begin
+            if (push)
+                wr_ptr <= wr_ptr + 1'b1;
+            // Ring mode when full: the new sample replaces the oldest one
+            if (pop || (push && full))
+                rd_ptr <= rd_ptr + 1'b1;
+            if (push && !full && !pop)
+                count <= count + 1'b1;
+            else if (pop && !push)
+                count <= count - 1'b1;
+            if (sample && full)
+                lost <= 1'b1;
+        end
+    end
+
+    // Interval timer: arms once per INTERVAL cycles, the next fetch is taken
+    always @(posedge clk) begin
+        if (!resetn) begin
+            enable <= 1'b0;
+            ring <= 1'b0;
+            interval <= 32'd1000;
+            countdown <= 32'd0;
+            armed <= 1'b0;
+        end else begin
+            if (ctrl_write) begin
+                enable <= mmio_wdata[0];
+                ring <= mmio_wdata[2];
+            end
+            if (mmio_valid && mmio_write && (mmio_addr[3:2] == ADDR_INTERVAL) && (&mmio_wstrb))
+                interval <= mmio_wdata;
+
+            if (!enable) begin
+                countdown <= (interval > 32'd1) ? interval - 1'b1 : 32'd0;
+                armed <= 1'b0;
+            end else begin
+                if (sample)
+                    armed <= 1'b0;
+                if (countdown == 32'd0) begin
+                    countdown <= (interval > 32'd1) ? interval - 1'b1 : 32'd0;
+                    armed <= 1'b1;
+                end else begin
+                    countdown <= countdown - 1'b1;
+                end
+            end
+        end
+    end
+
+    always @(*) begin
+        case (mmio_addr[3:2])
+            ADDR_CTRL:     mmio_rdata = {29'h0, ring, 1'b0, enable};
+            ADDR_INTERVAL: mmio_rdata = interval;
+            ADDR_STATUS:   mmio_rdata = {1'b1, 3'h0, LOG2_DEPTH, 6'h0, lost, full,
+                                         {(16-AW-1){1'b0}}, count};
+            ADDR_DATA:     mmio_rdata = empty ? 32'h0 : head;
+            default:       mmio_rdata = 32'h0;
+        endcase
+    end
+
+endmodule
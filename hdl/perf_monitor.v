@@ -0,0 +1,173 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// perf_monitor.v - Performance Monitoring Unit (memory-stall accounting)
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+// PURPOSE: Free-running 32-bit event counters that show where the CPU spends
+//          its memory time. Wait-state counters come from mem_controller
+//          state, transaction counters from the PicoRV32 bus handshake, and
+//          hit/miss counters from the caches (tied off when not built).
+//
+// All counters only advance while CTRL.enable is set, so firmware can
+// bracket a region of code: clear + enable, run, disable, read.
+//==============================================================================
+
+module perf_monitor #(
+    parameter [31:0] CPU_INFO = 32'h0   // Read-only build options, see CPU_INFO
+) (
+    input wire clk,
+    input wire resetn,
+
+    // MMIO Interface
+    input wire        mmio_valid,
+    input wire        mmio_write,
+    input wire [31:0] mmio_addr,
+    input wire [31:0] mmio_wdata,
+    input wire [ 3:0] mmio_wstrb,
+    output reg [31:0] mmio_rdata,
+    output wire       mmio_ready,
+
+    // PicoRV32 bus (transaction classification)
+    input wire        cpu_mem_valid,
+    input wire        cpu_mem_ready,
+    input wire        cpu_mem_instr,
+    input wire [ 3:0] cpu_mem_wstrb,
+
+    // mem_controller state
+    input wire        stat_sram_wait,   // Level: waiting on SRAM
+    input wire        stat_mmio_wait,   // Level: waiting on a peripheral
+    input wire        stat_boot_wait,   // Level: waiting on the boot ROM
+    input wire        stat_spad,        // Pulse: scratchpad access
+
+    // Caches (pulses)
+    input wire        stat_ic_hit,
+    input wire        stat_ic_miss,
+    input wire        stat_dc_hit,
+    input wire        stat_dc_miss
+);
+
+    // =========================================================================
+    // Register Map
+    // Base: 0x80000080
+    // =========================================================================
+    // +0x00: CTRL      (RW) - [0]=enable, [1]=clear all counters (W, self-clearing)
+    // +0x04: CYCLES    (R)  - Clock cycles while enabled
+    // +0x08: SRAM_WAIT (R)  - Cycles in STATE_SRAM_WAIT
+    // +0x0C: MMIO_WAIT (R)  - Cycles in STATE_MMIO_WAIT
+    // +0x10: BOOT_WAIT (R)  - Cycles in STATE_BOOT_WAIT/BOOT_WAIT2
+    // +0x14: FETCHES   (R)  - Completed instruction fetches
+    // +0x18: LOADS     (R)  - Completed data reads
+    // +0x1C: STORES    (R)  - Completed data writes
+    // +0x20: IC_HIT    (R)  - I-cache hits
+    // +0x24: IC_MISS   (R)  - I-cache misses (line fills)
+    // +0x28: DC_HIT    (R)  - D-cache hits
+    // +0x2C: DC_MISS   (R)  - D-cache misses
+    // +0x30: SPAD      (R)  - Scratchpad RAM accesses
+    // +0x3C: CPU_INFO  (R)  - Core options in this bitstream: [0]=MUL,
+    //                         [1]=FAST_MUL, [2]=DIV, [3]=COMPRESSED_ISA,
+    //                         [4]=PCPI FPU (lib/pcpi_fpu.h),
+    //                         [5]=CATCH_ILLINSN (lib/gdbstub)
+    // =========================================================================
+
+    localparam ADDR_CTRL      = 4'h0;
+    localparam ADDR_CYCLES    = 4'h1;
+    localparam ADDR_SRAM_WAIT = 4'h2;
+    localparam ADDR_MMIO_WAIT = 4'h3;
+    localparam ADDR_BOOT_WAIT = 4'h4;
+    localparam ADDR_FETCHES   = 4'h5;
+    localparam ADDR_LOADS     = 4'h6;
+    localparam ADDR_STORES    = 4'h7;
+    localparam ADDR_IC_HIT    = 4'h8;
+    localparam ADDR_IC_MISS   = 4'h9;
+    localparam ADDR_DC_HIT    = 4'hA;
+    localparam ADDR_DC_MISS   = 4'hB;
+    localparam ADDR_SPAD      = 4'hC;
+    localparam ADDR_CPU_INFO  = 4'hF;
+
+    // MMIO ready - combinational response (same cycle)
+    assign mmio_ready = mmio_valid;
+
+    reg        enable;
+    reg [31:0] cnt_cycles;
+    reg [31:0] cnt_sram_wait;
+    reg [31:0] cnt_mmio_wait;
+    reg [31:0] cnt_boot_wait;
+    reg [31:0] cnt_fetches;
+    reg [31:0] cnt_loads;
+    reg [31:0] cnt_stores;
+    reg [31:0] cnt_ic_hit;
+    reg [31:0] cnt_ic_miss;
+    reg [31:0] cnt_dc_hit;
+    reg [31:0] cnt_dc_miss;
+    reg [31:0] cnt_spad;
+
+    wire done     = cpu_mem_valid && cpu_mem_ready;
+    wire is_store = |cpu_mem_wstrb;
+
+    wire ctrl_write = mmio_valid && mmio_write && (mmio_addr[5:2] == ADDR_CTRL) && mmio_wstrb[0];
+    wire clear      = ctrl_write && mmio_wdata[1];
+
+    always @(posedge clk) begin
+        if (!resetn || clear) begin
+            cnt_cycles <= 32'h0;
+            cnt_sram_wait <= 32'h0;
+            cnt_mmio_wait <= 32'h0;
+            cnt_boot_wait <= 32'h0;
+            cnt_fetches <= 32'h0;
+            cnt_loads <= 32'h0;
+            cnt_stores <= 32'h0;
+            cnt_ic_hit <= 32'h0;
+            cnt_ic_miss <= 32'h0;
+            cnt_dc_hit <= 32'h0;
+            cnt_dc_miss <= 32'h0;
+            cnt_spad <= 32'h0;
+        end else if (enable) begin
+            cnt_cycles <= cnt_cycles + 1'b1;
+            if (stat_sram_wait) cnt_sram_wait <= cnt_sram_wait + 1'b1;
+            if (stat_mmio_wait) cnt_mmio_wait <= cnt_mmio_wait + 1'b1;
+            if (stat_boot_wait) cnt_boot_wait <= cnt_boot_wait + 1'b1;
+            if (done && cpu_mem_instr) cnt_fetches <= cnt_fetches + 1'b1;
+            if (done && !cpu_mem_instr && !is_store) cnt_loads <= cnt_loads + 1'b1;
+            if (done && is_store) cnt_stores <= cnt_stores + 1'b1;
+            if (stat_ic_hit) cnt_ic_hit <= cnt_ic_hit + 1'b1;
+            if (stat_ic_miss) cnt_ic_miss <= cnt_ic_miss + 1'b1;
+            if (stat_dc_hit) cnt_dc_hit <= cnt_dc_hit + 1'b1;
+            if (stat_dc_miss) cnt_dc_miss <= cnt_dc_miss + 1'b1;
+            if (stat_spad) cnt_spad <= cnt_spad + 1'b1;
+        end
+    end
+
+    always @(posedge clk) begin
+        if (!resetn) begin
+            enable <= 1'b0;
+        end else if (ctrl_write) begin
+            enable <= mmio_wdata[0];
+        end
+    end
+
+    always @(*) begin
+        case (mmio_addr[5:2])
+            ADDR_CTRL:      mmio_rdata = {31'h0, enable};
+            ADDR_CYCLES:    mmio_rdata = cnt_cycles;
+            ADDR_SRAM_WAIT: mmio_rdata = cnt_sram_wait;
+            ADDR_MMIO_WAIT: mmio_rdata = cnt_mmio_wait;
+            ADDR_BOOT_WAIT: mmio_rdata = cnt_boot_wait;
+            ADDR_FETCHES:   mmio_rdata = cnt_fetches;
+            ADDR_LOADS:     mmio_rdata = cnt_loads;
+            ADDR_STORES:    mmio_rdata = cnt_stores;
+            ADDR_IC_HIT:    mmio_rdata = cnt_ic_hit;
+            ADDR_IC_MISS:   mmio_rdata = cnt_ic_miss;
+            ADDR_DC_HIT:    mmio_rdata = cnt_dc_hit;
+            ADDR_DC_MISS:   mmio_rdata = cnt_dc_miss;
+            ADDR_SPAD:      mmio_rdata = cnt_spad;
+            ADDR_CPU_INFO:  mmio_rdata = CPU_INFO;
+            default:        mmio_rdata = 32'h0;
+        endcase
+    end
+
+endmodule
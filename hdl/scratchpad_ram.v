@@ -0,0 +1,64 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// scratchpad_ram.v - Tightly-Coupled BRAM Scratchpad
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+
+/*
+ * Scratchpad RAM - 2/4/8 KB at 0x80000 (Kconfig SCRATCHPAD_SIZE)
+ *
+ * General-purpose read/write BRAM for interrupt handlers, the FreeRTOS
+ * context switch and small hot tables. The linker scripts place the
+ * .fastcode / .fastdata sections here; startup code copies them in from
+ * their load address in SRAM.
+ *
+ * Memory map:
+ *   0x00000000 - 0x0007FFFF : SRAM (512KB)
+ *   0x00080000 - 0x00081FFF : Scratchpad window (8KB) ← THIS MODULE
+ *                             (smaller sizes alias within the window)
+ *
+ * Interface:
+ *   - 32-bit read/write, byte write enables
+ *   - Address is sampled every cycle (registered output, one cycle later)
+ *   - mem_controller answers from rdata in the cycle after the request
+ */
+
+`default_nettype none
+
+module scratchpad_ram #(
+    parameter BYTES = 4096              // 2048, 4096 or 8192
+) (
+    input  wire        clk,
+    input  wire [12:0] addr,            // Byte address within the 8KB window
+    input  wire [ 3:0] we,              // Byte lane write enables
+    input  wire [31:0] wdata,
+    output reg  [31:0] rdata
+);
+
+    localparam WORDS     = BYTES / 4;
+    localparam ADDR_BITS = $clog2(WORDS);
+
+    wire [ADDR_BITS-1:0] word_addr = addr[ADDR_BITS+1:2];
+
+    // One array per byte lane so Yosys maps byte writes onto SB_RAM40_4K
+    (* ram_style = "block" *) reg [7:0] mem0 [0:WORDS-1];
+    (* ram_style = "block" *) reg [7:0] mem1 [0:WORDS-1];
+    (* ram_style = "block" *) reg [7:0] mem2 [0:WORDS-1];
+    (* ram_style = "block" *) reg [7:0] mem3 [0:WORDS-1];
+
+    always @(posedge clk) begin
+        if (we[0]) mem0[word_addr] <= wdata[ 7: 0];
+        if (we[1]) mem1[word_addr] <= wdata[15: 8];
+        if (we[2]) mem2[word_addr] <= wdata[23:16];
+        if (we[3]) mem3[word_addr] <= wdata[31:24];
+        rdata <= {mem3[word_addr], mem2[word_addr], mem1[word_addr], mem0[word_addr]};
+    end
+
+endmodule
+
+`default_nettype wire
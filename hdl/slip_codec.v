@@ -0,0 +1,400 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// slip_codec.v - SLIP Framer / Deframer (RFC 1055) in front of the UART
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+// PURPOSE: Take SLIP escaping off the CPU. With RX enabled, bytes from the
+//          UART core bypass the console RX FIFO and are de-escaped into a
+//          frame buffer; each END closes a frame and queues its length, so
+//          firmware reads whole packets (four bytes per load) instead of
+//          decoding byte by byte. TX stores are escaped on their way into
+//          the UART TX FIFO. lwIP driver: firmware/lwIP/port/slip_hw_netif.c
+//
+// RX is off after reset, so the bootloader and console see the raw UART.
+// A frame that does not fit (buffer full, over 4095 bytes, or the length
+// queue full) is dropped whole at its END and counted; empty frames (back
+// to back ENDs) are ignored. An unknown escape sequence passes the byte
+// through, like the Linux SLIP driver.
+//
+// The IRQ is a level (OR-ed into IRQ[4] with the UART RX interrupt): high
+// while a received frame is waiting and CTRL.IRQ_EN is set.
+//==============================================================================
+
+module slip_codec #(
+    parameter BUF_BITS   = 11,          // log2(RX frame buffer bytes)
+    parameter QUEUE_BITS = 3            // log2(queued frame lengths)
+) (
+    input wire clk,
+    input wire resetn,
+
+    // MMIO Interface
+    input wire        mmio_valid,
+    input wire        mmio_write,
+    input wire [31:0] mmio_addr,
+    input wire [31:0] mmio_wdata,
+    input wire [ 3:0] mmio_wstrb,
+    output reg [31:0] mmio_rdata,
+    output reg        mmio_ready,
+
+    // UART RX (from the UART core)
+    input wire [ 7:0] rx_data,
+    input wire        rx_strobe,
+    output wire       rx_active,        // RX enabled: keep bytes out of the console FIFO
+
+    // UART TX FIFO write side (shared with uart_peripheral)
+    output reg [ 7:0] tx_data,
+    output reg        tx_valid,
+    input wire        tx_full,
+
+    output wire       irq
+);
+
+    // =========================================================================
+    // Register Map
+    // Base: 0x800001C0
+    // =========================================================================
+    // +0x00: CTRL    (RW) - [0]=RX enable (clearing it flushes the buffer),
+    //                       [1]=IRQ enable; reads [31]=present
+    // +0x04: STATUS  (R)  - [QUEUE_BITS:0]=frames queued behind the current
+    //                       one, [31:16]=dropped frames (saturating)
+    //                (W)  - Clear the dropped frame counter
+    // +0x08: RX_LEN  (R)  - [31]=frame available, [11:0]=bytes left in it
+    //                (W)  - Discard the rest of the current frame
+    // +0x0C: RX_DATA (R)  - Next byte of the current frame
+    // +0x10: RX_WORD (R)  - Next four bytes, first byte in [7:0]; bytes
+    //                       past the end of the frame read as 0
+    // +0x14: TX_DATA (W)  - Escape and queue each enabled byte lane, lane 0
+    //                       first (sb queues one byte, sw four)
+    // +0x18: TX_END  (W)  - Queue END (0xC0): closes the frame
+    // =========================================================================
+
+    localparam ADDR_CTRL    = 3'h0;
+    localparam ADDR_STATUS  = 3'h1;
+    localparam ADDR_RX_LEN  = 3'h2;
+    localparam ADDR_RX_DATA = 3'h3;
+    localparam ADDR_RX_WORD = 3'h4;
+    localparam ADDR_TX_DATA = 3'h5;
+    localparam ADDR_TX_END  = 3'h6;
+
+    localparam [7:0] SLIP_END     = 8'hC0;
+    localparam [7:0] SLIP_ESC     = 8'hDB;
+    localparam [7:0] SLIP_ESC_END = 8'hDC;
+    localparam [7:0] SLIP_ESC_ESC = 8'hDD;
+
+    localparam DEPTH  = 1 << BUF_BITS;
+    localparam QDEPTH = 1 << QUEUE_BITS;
+
+    wire [2:0] reg_sel = mmio_addr[4:2];
+
+    reg        rx_en;
+    reg        irq_en;
+    reg [15:0] drop_cnt;
+
+    assign rx_active = rx_en;
+
+    // =========================================================================
+    // RX Frame Buffer and Length Queue
+    // =========================================================================
+    reg [7:0] mem [0:DEPTH-1];
+
+    reg [BUF_BITS:0] wr_ptr;            // Next byte of the frame being received
+    reg [BUF_BITS:0] frame_start;       // Start of that frame (rewind on drop)
+    reg [BUF_BITS:0] rd_ptr;
+    reg [11:0]       rx_len;            // Bytes in the frame being received
+    reg              rx_esc;            // Last byte was ESC
+    reg              rx_bad;            // Frame overflowed: drop at END
+
+    reg [11:0]       len_q [0:QDEPTH-1];
+    reg [QUEUE_BITS-1:0] q_head;
+    reg [QUEUE_BITS-1:0] q_tail;
+    reg [QUEUE_BITS:0]   q_count;
+
+    reg [11:0]       rd_remain;         // Bytes left in the frame being read
+
+    wire buf_full = (wr_ptr - rd_ptr) == DEPTH;
+    wire q_full = (q_count == QDEPTH);
+
+    // Read port: rd_q holds mem[rd_ptr] one cycle after rd_ptr moves
+    // (rd_stale covers that cycle), so RX_WORD takes two cycles per byte
+    reg              rd_stale;
+    reg [7:0]        rd_q;
+
+    always @(posedge clk) begin
+        rd_q <= mem[rd_ptr[BUF_BITS-1:0]];
+    end
+
+    // De-escaped byte from the UART (ENDs handled separately)
+    wire       rx_is_end = rx_strobe && rx_en && !rx_esc && rx_data == SLIP_END;
+    wire       rx_is_esc = rx_strobe && rx_en && !rx_esc && rx_data == SLIP_ESC;
+    wire       rx_store  = rx_strobe && rx_en && !rx_is_end && !rx_is_esc;
+    wire [7:0] rx_byte   = !rx_esc ? rx_data :
+                           (rx_data == SLIP_ESC_END) ? SLIP_END :
+                           (rx_data == SLIP_ESC_ESC) ? SLIP_ESC : rx_data;
+
+    wire rx_push_ok = !rx_bad && !buf_full && rx_len != 12'hFFF;
+    wire frame_done = rx_is_end && (rx_len != 12'h0 || rx_bad);
+    wire frame_keep = frame_done && !rx_bad && !q_full;
+
+    always @(posedge clk) begin
+        if (rx_store && rx_push_ok)
+            mem[wr_ptr[BUF_BITS-1:0]] <= rx_byte;
+    end
+
+    // A queued frame becomes the current one once the last is fully read
+    wire q_pop  = (rd_remain == 12'h0) && (q_count != 0) && !(mmio_valid && !mmio_ready);
+    wire q_push = frame_keep;
+
+    // =========================================================================
+    // TX Escaping
+    // =========================================================================
+    reg        tx_pend;
+    reg [31:0] tx_pend_data;
+    reg [ 3:0] tx_pend_lanes;
+    reg        tx_second;               // Second byte of an escape pending
+    reg [ 7:0] tx_second_byte;
+    reg        tx_end_pend;
+
+    // =========================================================================
+    // RX_WORD read sequencer (one byte per cycle)
+    // =========================================================================
+    reg        word_busy;
+    reg [ 2:0] word_lane;
+    reg [31:0] word_data;
+
+    assign irq = irq_en && (rd_remain != 12'h0 || q_count != 0);
+
+    always @(posedge clk) begin
+        if (!resetn) begin
+            mmio_rdata <= 32'h0;
+            mmio_ready <= 1'b0;
+            rx_en <= 1'b0;
+            irq_en <= 1'b0;
+            drop_cnt <= 16'h0;
+            wr_ptr <= 0;
+            frame_start <= 0;
+            rd_ptr <= 0;
+            rx_len <= 12'h0;
+            rx_esc <= 1'b0;
+            rx_bad <= 1'b0;
+            q_head <= 0;
+            q_tail <= 0;
+            q_count <= 0;
+            rd_remain <= 12'h0;
+            rd_stale <= 1'b0;
+            tx_data <= 8'h0;
+            tx_valid <= 1'b0;
+            tx_pend <= 1'b0;
+            tx_pend_data <= 32'h0;
+            tx_pend_lanes <= 4'h0;
+            tx_second <= 1'b0;
+            tx_second_byte <= 8'h0;
+            tx_end_pend <= 1'b0;
+            word_busy <= 1'b0;
+            word_lane <= 3'h0;
+            word_data <= 32'h0;
+        end else begin
+            mmio_ready <= 1'b0;
+            tx_valid <= 1'b0;
+            rd_stale <= 1'b0;
+
+            // -----------------------------------------------------------------
+            // Deframer
+            // -----------------------------------------------------------------
+            if (rx_strobe && rx_en) begin
+                if (rx_is_esc) begin
+                    rx_esc <= 1'b1;
+                end else if (rx_is_end) begin
+                    if (frame_done && !frame_keep) begin
+                        wr_ptr <= frame_start;
+                        if (drop_cnt != 16'hFFFF) drop_cnt <= drop_cnt + 1'b1;
+                    end else begin
+                        frame_start <= wr_ptr;
+                    end
+                    rx_len <= 12'h0;
+                    rx_bad <= 1'b0;
+                end else begin
+                    rx_esc <= 1'b0;
+                    if (rx_push_ok) begin
+                        wr_ptr <= wr_ptr + 1'b1;
+                        rx_len <= rx_len + 1'b1;
+                    end else begin
+                        rx_bad <= 1'b1;
+                    end
+                end
+            end
+
+            if (q_push) begin
+                len_q[q_tail] <= rx_len;
+                q_tail <= q_tail + 1'b1;
+            end
+
+            if (q_pop) begin
+                rd_remain <= len_q[q_head];
+                q_head <= q_head + 1'b1;
+            end
+
+            case ({q_push, q_pop})
+                2'b10: q_count <= q_count + 1'b1;
+                2'b01: q_count <= q_count - 1'b1;
+                default: ;
+            endcase
+
+            // -----------------------------------------------------------------
+            // Framer: one byte into the TX FIFO per cycle while it has room
+            // -----------------------------------------------------------------
+            if (!tx_full && !tx_valid) begin
+                if (tx_second) begin
+                    tx_data <= tx_second_byte;
+                    tx_valid <= 1'b1;
+                    tx_second <= 1'b0;
+                end else if (tx_end_pend) begin
+                    tx_data <= SLIP_END;
+                    tx_valid <= 1'b1;
+                    tx_end_pend <= 1'b0;
+                    mmio_ready <= 1'b1;
+                end else if (tx_pend) begin
+                    if (tx_pend_lanes == 4'h0) begin
+                        tx_pend <= 1'b0;
+                        mmio_ready <= 1'b1;
+                    end else begin
+                        if (tx_pend_lanes[0]) begin
+                            tx_valid <= 1'b1;
+                            if (tx_pend_data[7:0] == SLIP_END) begin
+                                tx_data <= SLIP_ESC;
+                                tx_second <= 1'b1;
+                                tx_second_byte <= SLIP_ESC_END;
+                            end else if (tx_pend_data[7:0] == SLIP_ESC) begin
+                                tx_data <= SLIP_ESC;
+                                tx_second <= 1'b1;
+                                tx_second_byte <= SLIP_ESC_ESC;
+                            end else begin
+                                tx_data <= tx_pend_data[7:0];
+                            end
+                        end
+                        tx_pend_data <= {8'h0, tx_pend_data[31:8]};
+                        tx_pend_lanes <= {1'b0, tx_pend_lanes[3:1]};
+                    end
+                end
+            end
+
+            // -----------------------------------------------------------------
+            // RX_WORD: collect up to four bytes of the current frame
+            // -----------------------------------------------------------------
+            if (word_busy && !rd_stale) begin
+                if (word_lane == 3'd4) begin
+                    word_busy <= 1'b0;
+                    mmio_rdata <= word_data;
+                    mmio_ready <= 1'b1;
+                end else begin
+                    if (rd_remain != 12'h0) begin
+                        word_data[8*word_lane[1:0] +: 8] <= rd_q;
+                        rd_stale <= 1'b1;
+                        rd_ptr <= rd_ptr + 1'b1;
+                        rd_remain <= rd_remain - 1'b1;
+                    end
+                    word_lane <= word_lane + 1'b1;
+                end
+            end
+
+            // -----------------------------------------------------------------
+            // MMIO
+            // -----------------------------------------------------------------
+            if (mmio_valid && !mmio_ready && !tx_pend && !tx_end_pend &&
+                !word_busy && !rd_stale) begin
+                if (mmio_write) begin
+                    case (reg_sel)
+                        ADDR_CTRL: begin
+                            if (mmio_wstrb[0]) begin
+                                rx_en <= mmio_wdata[0];
+                                irq_en <= mmio_wdata[1];
+                                if (!mmio_wdata[0]) begin
+                                    // Flush everything received so far
+                                    wr_ptr <= 0;
+                                    frame_start <= 0;
+                                    rd_ptr <= 0;
+                                    rx_len <= 12'h0;
+                                    rx_esc <= 1'b0;
+                                    rx_bad <= 1'b0;
+                                    q_head <= 0;
+                                    q_tail <= 0;
+                                    q_count <= 0;
+                                    rd_remain <= 12'h0;
+                                    rd_stale <= 1'b1;
+                                end
+                            end
+                            mmio_ready <= 1'b1;
+                        end
+
+                        ADDR_STATUS: begin
+                            drop_cnt <= 16'h0;
+                            mmio_ready <= 1'b1;
+                        end
+
+                        ADDR_RX_LEN: begin
+                            rd_stale <= 1'b1;
+                            rd_ptr <= rd_ptr + rd_remain;
+                            rd_remain <= 12'h0;
+                            mmio_ready <= 1'b1;
+                        end
+
+                        ADDR_TX_DATA: begin
+                            tx_pend <= 1'b1;
+                            tx_pend_data <= mmio_wdata;
+                            tx_pend_lanes <= mmio_wstrb;
+                        end
+
+                        ADDR_TX_END: begin
+                            tx_end_pend <= 1'b1;
+                        end
+
+                        default: mmio_ready <= 1'b1;
+                    endcase
+                end else begin
+                    case (reg_sel)
+                        ADDR_CTRL: begin
+                            mmio_rdata <= {1'b1, 29'h0, irq_en, rx_en};
+                            mmio_ready <= 1'b1;
+                        end
+
+                        ADDR_STATUS: begin
+                            mmio_rdata <= {drop_cnt, {(15 - QUEUE_BITS){1'b0}}, q_count};
+                            mmio_ready <= 1'b1;
+                        end
+
+                        ADDR_RX_LEN: begin
+                            mmio_rdata <= {rd_remain != 12'h0, 19'h0, rd_remain};
+                            mmio_ready <= 1'b1;
+                        end
+
+                        ADDR_RX_DATA: begin
+                            mmio_rdata <= {24'h0, rd_remain != 12'h0 ? rd_q : 8'h0};
+                            if (rd_remain != 12'h0) begin
+                                rd_stale <= 1'b1;
+                                rd_ptr <= rd_ptr + 1'b1;
+                                rd_remain <= rd_remain - 1'b1;
+                            end
+                            mmio_ready <= 1'b1;
+                        end
+
+                        ADDR_RX_WORD: begin
+                            word_busy <= 1'b1;
+                            word_lane <= 3'h0;
+                            word_data <= 32'h0;
+                        end
+
+                        default: begin
+                            mmio_rdata <= 32'h0;
+                            mmio_ready <= 1'b1;
+                        end
+                    endcase
+                end
+            end
+        end
+    end
+
+endmodule
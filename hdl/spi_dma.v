@@ -0,0 +1,383 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// spi_dma.v - DMA Engine between the SPI Master FIFOs and SRAM
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+// PURPOSE: Moves whole words between spi_master's TX/RX FIFOs and external
+//          SRAM through mem_controller's DMA port, so SD sector data never
+//          passes through the CPU.
+//
+// Directions:
+//   RX (SPI -> SRAM): loads the SPI fill-byte repeat counter with LEN, then
+//       writes every RX FIFO word to ADDR, ADDR+4, ...
+//   TX (SRAM -> SPI): reads ADDR, ADDR+4, ... and pushes the words into the
+//       TX FIFO; done once the last byte has left the shift register.
+//       Clear SPI_FIFO_CTRL capture first or the RX FIFO fills up.
+//
+// mem_controller arbitrates per transaction and alternates with the CPU
+// while both are requesting. DMA bypasses the caches: invalidate (RX) or
+// clean (TX) the D-cache range before starting (hardware.h helpers).
+//
+// Completion sets CTRL.DONE and, with CTRL.IRQ_EN, pulses irq (OR'ed into
+// spi_irq, IRQ[2]; the SPI1 engine's into IRQ[10]). Registers are decoded
+// from mmio_addr[3:2] only: the top level places each engine's block.
+//
+// Stream mode (STREAM=1, CTRL.STREAM with start): ADDR/LEN describe an SRAM
+// ring. Each update event of the selected timer channel runs one frame:
+// CS low, 1-4 fill bytes clocked in, CS high, and the received bytes (wire
+// order from bits [7:0], zero-extended) written as one ring word. HALF and
+// FULL flags mark the ring halves as complete, each with an irq pulse when
+// IRQ_EN is set, so a sample rate costs no CPU time per sample. Triggers
+// that arrive while a frame is still pending are counted, not queued.
+//==============================================================================
+
+module spi_dma #(
+    parameter STREAM = 0                // Timer-triggered stream mode
+) (
+    input wire clk,
+    input wire resetn,
+
+    // MMIO Interface
+    input wire        mmio_valid,
+    input wire        mmio_write,
+    input wire [31:0] mmio_addr,
+    input wire [31:0] mmio_wdata,
+    input wire [ 3:0] mmio_wstrb,
+    output reg [31:0] mmio_rdata,
+    output wire       mmio_ready,
+
+    // mem_controller DMA port (SRAM only; hold valid until ready)
+    output reg        mem_valid,
+    input wire        mem_ready,
+    output reg [31:0] mem_addr,
+    output reg [31:0] mem_wdata,
+    output reg [ 3:0] mem_wstrb,
+    input wire [31:0] mem_rdata,
+
+    // spi_master side port
+    output wire       spi_rx_pop,
+    input wire [31:0] spi_rx_data,
+    input wire        spi_rx_empty,
+    output wire       spi_tx_push,
+    output reg [31:0] spi_tx_data,
+    input wire        spi_tx_full,
+    output reg        spi_rep_load,
+    output reg [15:0] spi_rep_value,
+    input wire        spi_busy,
+    output reg        spi_cs_ctl,       // Stream mode owns CS ...
+    output reg        spi_cs,           // ... and drives it per frame
+
+    // Timer channel 1-3 update events (stream mode triggers)
+    input wire [ 3:1] trigger,
+
+    output reg        irq               // Single-cycle pulse on completion
+);
+
+    // =========================================================================
+    // Register Map
+    // Base: 0x800000D0 (SPI0), 0x800002A0 (SPI1)
+    // =========================================================================
+    // +0x00: ADDR  (RW) - SRAM address (word aligned); advances during a transfer
+    // +0x04: LEN   (RW) - Byte count (multiple of 4, max 65532); counts down
+    // +0x08: CTRL  (W)  - [0]=start, [1]=direction (0=RX SPI->SRAM, 1=TX),
+    //                     [2]=IRQ on completion (stream: on HALF/FULL),
+    //                     [4]=stream mode (with start)
+    //                     While streaming: [3]=stop after the current frame,
+    //                     [5]/[6]/[7]=clear HALF/FULL/OVERRUN
+    //              (R)  - [0]=busy, [1]=direction, [2]=IRQ enable, [3]=done
+    //                     (done clears on the next start), [4]=streaming,
+    //                     [5]=HALF (first half written), [6]=FULL (second
+    //                     half written, ring wrapped), [7]=OVERRUN (a flag
+    //                     was set again before being cleared)
+    // +0x0C: STREAM (RW) - [1:0]=frame bytes - 1, [3:2]=trigger timer
+    //                     channel 1-3 (0 = none); (R) [7]=stream mode built
+    //                     in, [31:16]=missed triggers since start
+    //
+    // Stream mode: ADDR is the ring start and LEN its size (a multiple of 8)
+    // when started; while it runs they read the next write position and
+    // the bytes left before the wrap.
+    // =========================================================================
+
+    localparam ADDR_ADDR   = 2'h0;
+    localparam ADDR_LEN    = 2'h1;
+    localparam ADDR_CTRL   = 2'h2;
+    localparam ADDR_STREAM = 2'h3;
+
+    // State Machine
+    localparam S_IDLE     = 4'h0;
+    localparam S_RX_WAIT  = 4'h1;   // Wait for an RX FIFO word
+    localparam S_RX_DATA  = 4'h2;   // FIFO read data arriving
+    localparam S_RX_WRITE = 4'h3;   // SRAM write
+    localparam S_TX_READ  = 4'h4;   // SRAM read
+    localparam S_TX_PUSH  = 4'h5;   // Wait for TX FIFO room
+    localparam S_TX_DRAIN = 4'h6;   // Wait for the last byte on the wire
+    localparam S_ST_WAIT  = 4'h7;   // Stream: wait for a trigger
+    localparam S_ST_CS    = 4'h8;   // Stream: CS asserted, load the fill count
+    localparam S_ST_RX    = 4'h9;   // Stream: wait for the frame word
+    localparam S_ST_DATA  = 4'hA;   // Stream: FIFO read data arriving
+    localparam S_ST_WRITE = 4'hB;   // Stream: SRAM write, ring position
+
+    reg [3:0]  state;
+    reg [31:0] addr;
+    reg [15:0] len;
+    reg        dir_tx;
+    reg        irq_en;
+    reg        done;
+
+    // Stream mode
+    reg        st_active;
+    reg        st_stop;             // Stop requested
+    reg        st_pend;             // Trigger waiting for a frame
+    reg        st_half, st_full, st_overrun;
+    reg [1:0]  st_frame;            // Frame bytes - 1
+    reg [1:0]  st_trig_sel;
+    reg [15:0] st_missed;
+    reg [31:0] st_base;
+    reg [15:0] st_size;
+
+    wire [1:0] reg_sel = mmio_addr[3:2];
+    wire       start   = mmio_valid && mmio_write && (reg_sel == ADDR_CTRL) &&
+                         mmio_wstrb[0] && mmio_wdata[0] && (state == S_IDLE);
+    wire       st_ctrl = mmio_valid && mmio_write && (reg_sel == ADDR_CTRL) &&
+                         mmio_wstrb[0] && st_active;
+    wire [3:0] st_triggers = {trigger, 1'b0};   // Selection 0: none
+    wire       st_trig = STREAM && st_active && st_triggers[st_trig_sel];
+    wire [15:0] st_half_len = {1'b0, st_size[15:1]};
+
+    // MMIO ready - combinational response (same cycle)
+    assign mmio_ready = mmio_valid;
+
+    assign spi_rx_pop  = ((state == S_RX_WAIT) && !spi_rx_empty) ||
+                         ((state == S_ST_RX) && !spi_rx_empty && !spi_busy);
+    assign spi_tx_push = (state == S_TX_PUSH) && !spi_tx_full;
+
+    always @(*) begin
+        case (reg_sel)
+            ADDR_ADDR:   mmio_rdata = addr;
+            ADDR_LEN:    mmio_rdata = {16'h0, len};
+            ADDR_CTRL:   mmio_rdata = {24'h0, st_overrun, st_full, st_half, st_active,
+                                       done, irq_en, dir_tx, state != S_IDLE};
+            ADDR_STREAM: mmio_rdata = STREAM ? {st_missed, 8'h00, 1'b1, 3'h0, st_trig_sel, st_frame} : 32'h0;
+            default:     mmio_rdata = 32'h0;
+        endcase
+    end
+
+    always @(posedge clk or negedge resetn) begin
+        if (!resetn) begin
+            state <= S_IDLE;
+            addr <= 32'h0;
+            len <= 16'h0;
+            dir_tx <= 1'b0;
+            irq_en <= 1'b0;
+            done <= 1'b0;
+            irq <= 1'b0;
+            mem_valid <= 1'b0;
+            mem_addr <= 32'h0;
+            mem_wdata <= 32'h0;
+            mem_wstrb <= 4'h0;
+            spi_tx_data <= 32'h0;
+            spi_rep_load <= 1'b0;
+            spi_rep_value <= 16'h0;
+            spi_cs_ctl <= 1'b0;
+            spi_cs <= 1'b1;
+            st_active <= 1'b0;
+            st_stop <= 1'b0;
+            st_pend <= 1'b0;
+            st_half <= 1'b0;
+            st_full <= 1'b0;
+            st_overrun <= 1'b0;
+            st_frame <= 2'd1;
+            st_trig_sel <= 2'd0;
+            st_missed <= 16'h0;
+            st_base <= 32'h0;
+            st_size <= 16'h0;
+        end else begin
+            irq <= 1'b0;
+            spi_rep_load <= 1'b0;
+
+            // Register writes (ADDR/LEN are ignored while a transfer runs)
+            if (mmio_valid && mmio_write && state == S_IDLE) begin
+                case (reg_sel)
+                    ADDR_ADDR: addr <= {mmio_wdata[31:2], 2'b00};
+                    ADDR_LEN:  len <= {mmio_wdata[15:2], 2'b00};
+                    ADDR_CTRL: if (mmio_wstrb[0]) begin
+                        dir_tx <= mmio_wdata[1];
+                        irq_en <= mmio_wdata[2];
+                    end
+                    ADDR_STREAM: if (mmio_wstrb[0]) begin
+                        st_frame <= mmio_wdata[1:0];
+                        st_trig_sel <= mmio_wdata[3:2];
+                    end
+                    default: ;
+                endcase
+            end
+
+            // Stream control while running (flag events below win)
+            if (st_ctrl) begin
+                if (mmio_wdata[3]) st_stop <= 1'b1;
+                if (mmio_wdata[5]) st_half <= 1'b0;
+                if (mmio_wdata[6]) st_full <= 1'b0;
+                if (mmio_wdata[7]) st_overrun <= 1'b0;
+            end
+
+            case (state)
+                S_IDLE: begin
+                    if (start) begin
+                        done <= 1'b0;
+                        if (len == 16'h0) begin
+                            done <= 1'b1;
+                            irq <= mmio_wdata[2];
+                        end else if (STREAM && mmio_wdata[4]) begin
+                            st_active <= 1'b1;
+                            st_stop <= 1'b0;
+                            st_pend <= 1'b0;
+                            st_half <= 1'b0;
+                            st_full <= 1'b0;
+                            st_overrun <= 1'b0;
+                            st_missed <= 16'h0;
+                            st_base <= addr;
+                            st_size <= len;
+                            spi_cs_ctl <= 1'b1;
+                            spi_cs <= 1'b1;
+                            state <= S_ST_WAIT;
+                        end else if (mmio_wdata[1]) begin
+                            state <= S_TX_READ;
+                        end else begin
+                            spi_rep_load <= 1'b1;
+                            spi_rep_value <= len;
+                            state <= S_RX_WAIT;
+                        end
+                    end
+                end
+
+                S_RX_WAIT: begin
+                    if (!spi_rx_empty)
+                        state <= S_RX_DATA;
+                end
+
+                S_RX_DATA: begin
+                    mem_valid <= 1'b1;
+                    mem_addr <= addr;
+                    mem_wdata <= spi_rx_data;
+                    mem_wstrb <= 4'hF;
+                    state <= S_RX_WRITE;
+                end
+
+                S_RX_WRITE: begin
+                    if (mem_ready) begin
+                        mem_valid <= 1'b0;
+                        addr <= addr + 32'd4;
+                        len <= len - 16'd4;
+                        if (len == 16'd4) begin
+                            done <= 1'b1;
+                            irq <= irq_en;
+                            state <= S_IDLE;
+                        end else begin
+                            state <= S_RX_WAIT;
+                        end
+                    end
+                end
+
+                S_TX_READ: begin
+                    mem_valid <= 1'b1;
+                    mem_addr <= addr;
+                    mem_wstrb <= 4'h0;
+                    if (mem_valid && mem_ready) begin
+                        mem_valid <= 1'b0;
+                        spi_tx_data <= mem_rdata;
+                        state <= S_TX_PUSH;
+                    end
+                end
+
+                S_TX_PUSH: begin
+                    if (!spi_tx_full) begin
+                        addr <= addr + 32'd4;
+                        len <= len - 16'd4;
+                        state <= (len == 16'd4) ? S_TX_DRAIN : S_TX_READ;
+                    end
+                end
+
+                S_TX_DRAIN: begin
+                    if (!spi_busy) begin
+                        done <= 1'b1;
+                        irq <= irq_en;
+                        state <= S_IDLE;
+                    end
+                end
+
+                S_ST_WAIT: begin
+                    if (st_stop) begin
+                        st_active <= 1'b0;
+                        st_stop <= 1'b0;
+                        spi_cs_ctl <= 1'b0;
+                        done <= 1'b1;
+                        state <= S_IDLE;
+                    end else if (st_pend) begin
+                        st_pend <= 1'b0;
+                        spi_cs <= 1'b0;
+                        state <= S_ST_CS;
+                    end
+                end
+
+                S_ST_CS: begin
+                    // spi_master registers CS: it is low before the first SCK edge
+                    spi_rep_load <= 1'b1;
+                    spi_rep_value <= {14'h0, st_frame} + 16'd1;
+                    state <= S_ST_RX;
+                end
+
+                S_ST_RX: begin
+                    if (!spi_rx_empty && !spi_busy) begin
+                        spi_cs <= 1'b1;
+                        state <= S_ST_DATA;
+                    end
+                end
+
+                S_ST_DATA: begin
+                    mem_valid <= 1'b1;
+                    mem_addr <= addr;
+                    mem_wdata <= spi_rx_data;
+                    mem_wstrb <= 4'hF;
+                    state <= S_ST_WRITE;
+                end
+
+                S_ST_WRITE: begin
+                    if (mem_ready) begin
+                        mem_valid <= 1'b0;
+                        if (len == 16'd4) begin
+                            addr <= st_base;
+                            len <= st_size;
+                            st_full <= 1'b1;
+                            if (st_full) st_overrun <= 1'b1;
+                            irq <= irq_en;
+                        end else begin
+                            addr <= addr + 32'd4;
+                            len <= len - 16'd4;
+                            if (len - 16'd4 == st_half_len) begin
+                                st_half <= 1'b1;
+                                if (st_half) st_overrun <= 1'b1;
+                                irq <= irq_en;
+                            end
+                        end
+                        state <= S_ST_WAIT;
+                    end
+                end
+
+                default: state <= S_IDLE;
+            endcase
+
+            // Stream triggers: one may wait while a frame runs, more are missed
+            if (st_trig) begin
+                if (st_pend && state != S_ST_WAIT && st_missed != 16'hFFFF)
+                    st_missed <= st_missed + 16'd1;
+                st_pend <= 1'b1;
+            end
+        end
+    end
+
+endmodule
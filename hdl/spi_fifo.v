@@ -0,0 +1,81 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// spi_fifo.v - Synchronous Word FIFO for the SPI Master
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+// PURPOSE: Single-clock FIFO backing the SPI master TX and RX queues.
+//
+// The data array has a registered read so Yosys maps it onto SB_RAM40_4K:
+// rdata is valid in the cycle after rd_en. A 32-bit FIFO takes two EBRs
+// (256x16) up to DEPTH=256 and four at DEPTH=512.
+//
+// Writes while full and reads while empty are ignored.
+//==============================================================================
+
+module spi_fifo #(
+    parameter WIDTH = 32,
+    parameter DEPTH = 128               // Power of two
+) (
+    input wire clk,
+    input wire resetn,
+    input wire clear,                   // Drop all entries (pulse)
+
+    input wire             wr_en,
+    input wire [WIDTH-1:0] wdata,
+    input wire             rd_en,
+    output reg [WIDTH-1:0] rdata,       // Valid the cycle after rd_en
+
+    output reg [$clog2(DEPTH):0] level,
+    output wire            full,
+    output wire            empty
+);
+
+    localparam PTR_BITS = $clog2(DEPTH);
+
+    (* ram_style = "block" *) reg [WIDTH-1:0] mem [0:DEPTH-1];
+
+    reg [PTR_BITS-1:0] wr_ptr;
+    reg [PTR_BITS-1:0] rd_ptr;
+
+    assign full  = (level == DEPTH);
+    assign empty = (level == 0);
+
+    wire do_wr = wr_en && !full;
+    wire do_rd = rd_en && !empty;
+
+    always @(posedge clk) begin
+        if (do_wr)
+            mem[wr_ptr] <= wdata;
+        if (do_rd)
+            rdata <= mem[rd_ptr];
+    end
+
+    always @(posedge clk or negedge resetn) begin
+        if (!resetn) begin
+            wr_ptr <= 0;
+            rd_ptr <= 0;
+            level <= 0;
+        end else if (clear) begin
+            wr_ptr <= 0;
+            rd_ptr <= 0;
+            level <= 0;
+        end else begin
+            if (do_wr)
+                wr_ptr <= wr_ptr + 1'b1;
+            if (do_rd)
+                rd_ptr <= rd_ptr + 1'b1;
+
+            case ({do_wr, do_rd})
+                2'b10:   level <= level + 1'b1;
+                2'b01:   level <= level - 1'b1;
+                default: ;
+            endcase
+        end
+    end
+
+endmodule
@@ -0,0 +1,287 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// spi_flash_xip.v - Execute-in-Place Reads from the Configuration SPI Flash
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+// PURPOSE: Maps the board's configuration flash (the bitstream leaves most
+//          of it unused) at 0x01000000 so read-only code and data can run
+//          or be read in place instead of taking SRAM (lib/spi_flash.h).
+//
+// Reads use FAST READ (0x0B) or, with DUAL=1, FAST READ DUAL OUTPUT (0x3B:
+// data on IO0 and IO1, half the clocks per word). SCK is clk / 2; MISO is
+// sampled at the end of each SCK high phase, a full SCK period after the
+// flash drove it.
+//
+// A 16-byte line buffer holds the line of the last miss. A miss starts the
+// read at the requested word (the CPU gets it as soon as it is in), the rest
+// of the line follows as prefetch, and CS stays low at the end of the line:
+// a miss on the next line (sequential code) continues the same read without
+// a new command. Any other miss raises CS and starts over.
+//
+// Register mode (CTRL.MANUAL) hands the pins to firmware for JEDEC ID,
+// erase and program: software chip select, one byte per DATA write, in on
+// IO1 as it goes out on IO0 (poll STATUS.BUSY, read DATA). Flash reads
+// return 0 in register mode; setting MANUAL drops the line buffer.
+//==============================================================================
+
+module spi_flash_xip #(
+    parameter DUAL = 1                  // 0x3B dual-output reads (0: 0x0B)
+) (
+    input wire clk,
+    input wire resetn,
+
+    // Read port (mem_controller, 0x01000000-0x01FFFFFF)
+    input wire        rd_start,         // Pulse: read the word at rd_addr
+    input wire [23:0] rd_addr,
+    output reg        rd_done,          // Pulse: rd_rdata is valid
+    output reg [31:0] rd_rdata,
+
+    // MMIO Interface
+    input wire        mmio_valid,
+    input wire        mmio_write,
+    input wire [31:0] mmio_addr,
+    input wire [31:0] mmio_wdata,
+    input wire [ 3:0] mmio_wstrb,
+    output reg [31:0] mmio_rdata,
+    output wire       mmio_ready,
+
+    // Configuration flash
+    output reg        flash_sck,
+    output reg        flash_cs_n,
+    inout wire        flash_io0,        // DI; second data line in dual reads
+    input wire        flash_io1         // DO
+);
+
+    // =========================================================================
+    // Register Map
+    // Base: 0x80000220
+    // =========================================================================
+    // +0x00: CTRL   (RW) - [0]=MANUAL (register mode), [1]=CS (assert chip
+    //                      select in register mode); read: [30]=DUAL,
+    //                      [31]=present
+    // +0x04: DATA   (RW) - Write [7:0]: clock one byte out (register mode)
+    //                      Read [7:0]: byte clocked in by the last write
+    // +0x08: STATUS (R)  - [0]=BUSY (byte transfer running)
+    // =========================================================================
+
+    localparam ADDR_CTRL   = 2'h0;
+    localparam ADDR_DATA   = 2'h1;
+    localparam ADDR_STATUS = 2'h2;
+
+    localparam [7:0] CMD_READ  = DUAL ? 8'h3B : 8'h0B;
+    localparam [5:0] WORD_CLKS = DUAL ? 6'd16 : 6'd32;
+
+    // State Machine
+    localparam S_IDLE     = 3'h0;
+    localparam S_DESELECT = 3'h1;       // CS high between reads (tSHSL)
+    localparam S_CMD      = 3'h2;       // Command and address on IO0
+    localparam S_DUMMY    = 3'h3;       // 8 dummy clocks, IO0 released (dual)
+    localparam S_DATA     = 3'h4;       // Words into the line buffer
+    localparam S_XFER     = 3'h5;       // Register-mode byte
+
+    reg [2:0]  state;
+    reg [5:0]  count;                   // SCK rising edges left in the phase
+    reg [31:0] shift_out;               // [31] drives IO0
+    reg [31:0] shift_in;
+    reg        io0_oe;
+
+    reg        manual;
+    reg        man_cs;
+
+    assign flash_io0 = io0_oe ? shift_out[31] : 1'bz;
+
+    // Dual: IO1 carries the higher bit of each pair
+    wire        dual_in    = DUAL && (state == S_DATA);
+    wire [31:0] shift_next = dual_in ? {shift_in[29:0], flash_io1, flash_io0}
+                                     : {shift_in[30:0], flash_io1};
+
+    // First byte on the wire is the lowest address
+    wire [31:0] word_in = {shift_next[7:0], shift_next[15:8],
+                           shift_next[23:16], shift_next[31:24]};
+
+    //==========================================================================
+    // Line Buffer and Read Stream
+    //==========================================================================
+    reg [31:0] lbuf [0:3];
+    reg [ 3:0] line_valid;
+    reg [19:0] line_tag;                // Byte address [23:4]
+    reg        stream_open;             // CS low, flash positioned at stream_word
+    reg [21:0] stream_word;             // Next word address the flash sends
+
+    reg        req_pending;
+    reg [21:0] req_word;
+
+    wire req_line  = (req_word[21:2] == line_tag);
+    wire req_hit   = req_line && line_valid[req_word[1:0]];
+    // Still coming in the read that fills the line
+    wire req_ahead = req_line && (req_word[1:0] >= stream_word[1:0]) &&
+                     (state == S_CMD || state == S_DUMMY || state == S_DATA);
+
+    //==========================================================================
+    // MMIO
+    //==========================================================================
+    wire [1:0] reg_sel = mmio_addr[3:2];
+    wire       wr      = mmio_valid && mmio_write;
+    wire       busy    = (state == S_XFER);
+
+    // MMIO ready - combinational response (same cycle)
+    assign mmio_ready = mmio_valid;
+
+    always @(*) begin
+        case (reg_sel)
+            ADDR_CTRL:   mmio_rdata = {1'b1, DUAL ? 1'b1 : 1'b0, 28'h0, man_cs, manual};
+            ADDR_DATA:   mmio_rdata = {24'h0, shift_in[7:0]};
+            ADDR_STATUS: mmio_rdata = {31'h0, busy};
+            default:     mmio_rdata = 32'h0;
+        endcase
+    end
+
+    always @(posedge clk) begin
+        if (!resetn) begin
+            state <= S_IDLE;
+            count <= 6'd0;
+            shift_out <= 32'h0;
+            shift_in <= 32'h0;
+            io0_oe <= 1'b1;
+            flash_sck <= 1'b0;
+            flash_cs_n <= 1'b1;
+            manual <= 1'b0;
+            man_cs <= 1'b0;
+            line_valid <= 4'h0;
+            line_tag <= 20'h0;
+            stream_open <= 1'b0;
+            stream_word <= 22'h0;
+            req_pending <= 1'b0;
+            req_word <= 22'h0;
+            rd_done <= 1'b0;
+            rd_rdata <= 32'h0;
+        end else begin
+            rd_done <= 1'b0;
+
+            if (rd_start) begin
+                req_pending <= 1'b1;
+                req_word <= rd_addr[23:2];
+            end
+
+            // Answer from the line buffer (register mode: 0)
+            if (req_pending && (req_hit || manual)) begin
+                rd_rdata <= manual ? 32'h0 : lbuf[req_word[1:0]];
+                rd_done <= 1'b1;
+                req_pending <= 1'b0;
+            end
+
+            case (state)
+                S_IDLE: begin
+                    if (manual) begin
+                        // Close a finished read before IO0 is driven again
+                        if (stream_open) begin
+                            flash_cs_n <= 1'b1;
+                            stream_open <= 1'b0;
+                        end else begin
+                            flash_cs_n <= !man_cs;
+                            io0_oe <= 1'b1;
+                        end
+                    end else if (req_pending && !req_hit) begin
+                        if (stream_open && stream_word == req_word) begin
+                            // Sequential: the open read goes on
+                            line_tag <= req_word[21:2];
+                            line_valid <= 4'h0;
+                            count <= WORD_CLKS;
+                            state <= S_DATA;
+                        end else if (stream_open) begin
+                            flash_cs_n <= 1'b1;
+                            stream_open <= 1'b0;
+                            count <= 6'd2;
+                            state <= S_DESELECT;
+                        end else begin
+                            line_tag <= req_word[21:2];
+                            line_valid <= 4'h0;
+                            stream_word <= req_word;
+                            shift_out <= {CMD_READ, req_word, 2'b00};
+                            io0_oe <= 1'b1;
+                            flash_cs_n <= 1'b0;
+                            count <= 6'd32;
+                            state <= S_CMD;
+                        end
+                    end
+                end
+
+                S_DESELECT: begin
+                    if (count == 6'd0)
+                        state <= S_IDLE;
+                    else
+                        count <= count - 1'b1;
+                end
+
+                default: begin
+                    // S_CMD, S_DUMMY, S_DATA, S_XFER: one SCK half period per clock
+                    if (!flash_sck) begin
+                        if (state != S_XFER && (manual ||
+                                (req_pending && !req_hit && !req_ahead))) begin
+                            // Abort (SCK is low): deselect and start over
+                            flash_cs_n <= 1'b1;
+                            stream_open <= 1'b0;
+                            count <= 6'd2;
+                            state <= S_DESELECT;
+                        end else begin
+                            flash_sck <= 1'b1;
+                            count <= count - 1'b1;
+                        end
+                    end else begin
+                        flash_sck <= 1'b0;
+                        shift_in <= shift_next;
+                        shift_out <= {shift_out[30:0], 1'b0};
+
+                        if (count == 6'd0) begin
+                            case (state)
+                                S_CMD: begin
+                                    io0_oe <= DUAL ? 1'b0 : 1'b1;
+                                    count <= 6'd8;
+                                    state <= S_DUMMY;
+                                end
+                                S_DUMMY: begin
+                                    count <= WORD_CLKS;
+                                    state <= S_DATA;
+                                end
+                                S_DATA: begin
+                                    lbuf[stream_word[1:0]] <= word_in;
+                                    line_valid[stream_word[1:0]] <= 1'b1;
+                                    stream_word <= stream_word + 1'b1;
+                                    if (stream_word[1:0] == 2'd3) begin
+                                        // End of the line: pause with CS low
+                                        stream_open <= 1'b1;
+                                        state <= S_IDLE;
+                                    end else begin
+                                        count <= WORD_CLKS;
+                                    end
+                                end
+                                default: state <= S_IDLE;   // S_XFER
+                            endcase
+                        end
+                    end
+                end
+            endcase
+
+            // Register writes
+            if (wr && reg_sel == ADDR_CTRL && mmio_wstrb[0]) begin
+                manual <= mmio_wdata[0];
+                man_cs <= mmio_wdata[1];
+                if (mmio_wdata[0])
+                    line_valid <= 4'h0;     // Erase / program may follow
+            end
+            if (wr && reg_sel == ADDR_DATA && mmio_wstrb[0] && manual &&
+                state == S_IDLE && !stream_open) begin
+                shift_out <= {mmio_wdata[7:0], 24'h0};
+                io0_oe <= 1'b1;
+                count <= 6'd8;
+                state <= S_XFER;
+            end
+        end
+    end
+
+endmodule
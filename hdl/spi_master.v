@@ -8,8 +8,40 @@
 // NOT FOR COMMERCIAL USE
 // Educational and research purposes only
 //==============================================================================
+// Byte mode (SPI_DATA) works as before: one MMIO write per byte, poll
+// SPI_STATUS, read SPI_DATA.
+//
+// Burst mode uses two EBR word FIFOs (FIFO_DEPTH words each):
+//   - SPI_FIFO_DATA writes queue four bytes (bits [7:0] go out first)
+//   - SPI_RX_REPEAT=N clocks out N 0xFF fill bytes and packs the MISO
+//     bytes into the RX FIFO, four per word (first byte in bits [7:0])
+//   - SPI_FIFO_DATA reads pop one RX word; the access stalls until a word
+//     is available while a transfer is still running
+// A 512-byte sector read is one SPI_RX_REPEAT write plus 128 word reads.
+//
+// spi_dma.v drives the same FIFOs through the dma_* side port; firmware
+// leaves SPI_FIFO_DATA alone while a DMA transfer is running.
+//
+// With HW_CRC=1 every byte on the wire (byte, burst and DMA modes) also
+// updates CRC16-CCITT accumulators for MISO and MOSI and a CRC7 over MOSI,
+// so the SD driver can run in CMD59 CRC mode without software CRCs.
+//
+// Register reads other than SPI_FIFO_DATA are combinational (ready in the
+// mmio_valid cycle), so SPI_STATUS polling costs one bus cycle less;
+// mem_controller registers the read data.
+//
+// BASE, FIFO_BASE and CRC_BASE place the three register blocks, so the
+// top level can build a second bus (Kconfig SPI1_MASTER, lib/spi_port.h)
+// with its own pins, FIFOs, DMA engine and interrupt.
+//==============================================================================
 
-module spi_master (
+module spi_master #(
+    parameter FIFO_DEPTH = 128,         // Words per FIFO (power of two)
+    parameter HW_CRC     = 1,           // CRC16/CRC7 accumulators at CRC_BASE
+    parameter BASE       = 32'h80000050,    // CTRL/DATA/STATUS/CS
+    parameter FIFO_BASE  = 32'h800000C0,    // Burst / FIFO registers
+    parameter CRC_BASE   = 32'h800000E0     // CRC registers
+) (
     input wire clk,           // 50 MHz system clock
     input wire resetn,        // Active-low reset
 
@@ -19,8 +51,8 @@ module spi_master (
     input wire [31:0] mmio_addr,
     input wire [31:0] mmio_wdata,
     input wire [ 3:0] mmio_wstrb,
-    output reg [31:0] mmio_rdata,
-    output reg        mmio_ready,
+    output wire [31:0] mmio_rdata,
+    output wire        mmio_ready,
 
     // SPI Physical Interface
     output reg        spi_sck,     // SPI clock
@@ -29,16 +61,45 @@ module spi_master (
     output reg        spi_cs,      // Chip Select (active low)
 
     // Interrupt
-    output wire       spi_irq      // Transfer complete interrupt (single-cycle pulse)
+    output wire       spi_irq,     // Transfer complete interrupt (single-cycle pulse)
+
+    // DMA side port (spi_dma.v) - FIFO access without MMIO round trips
+    input wire        dma_rx_pop,
+    output wire [31:0] dma_rx_data, // Valid the cycle after dma_rx_pop
+    output wire       dma_rx_empty,
+    input wire        dma_tx_push,
+    input wire [31:0] dma_tx_data,
+    output wire       dma_tx_full,
+    input wire        dma_rep_load, // Same as an SPI_RX_REPEAT write
+    input wire [15:0] dma_rep_value,
+    output wire       dma_spi_busy, // Queued or in-flight bytes
+    input wire        dma_cs_ctl,   // DMA stream mode drives CS (dma_cs) ...
+    input wire        dma_cs        // ... instead of the SPI_CS register
 );
 
     //==========================================================================
-    // Memory Map (Base: 0x80000050)
+    // Memory Map (Base: BASE, 0x80000050 for SPI0)
     //==========================================================================
-    localparam ADDR_SPI_CTRL   = 32'h80000050;  // Control register
-    localparam ADDR_SPI_DATA   = 32'h80000054;  // Data register
-    localparam ADDR_SPI_STATUS = 32'h80000058;  // Status register
-    localparam ADDR_SPI_CS     = 32'h8000005C;  // Chip select control
+    localparam ADDR_SPI_CTRL   = BASE + 32'h0;  // Control register
+    localparam ADDR_SPI_DATA   = BASE + 32'h4;  // Data register
+    localparam ADDR_SPI_STATUS = BASE + 32'h8;  // Status register
+    localparam ADDR_SPI_CS     = BASE + 32'hC;  // Chip select control
+
+    // SPI_CTRL: [0]=CPOL [1]=CPHA [4:2]=power-of-2 divider
+    //           [5]=use [15:8] as divider (half period = N+1 clocks)
+    //           [19:16]=MISO sample delay in clocks (CPHA=0, <= N)
+
+    // Burst / FIFO registers (Base: FIFO_BASE, 0x800000C0 for SPI0)
+    localparam ADDR_SPI_FIFO_DATA = FIFO_BASE + 32'h0;  // W: push TX word, R: pop RX word
+    localparam ADDR_SPI_FIFO_CTRL = FIFO_BASE + 32'h4;  // [0]=RX capture of TX bytes, [1]=flush (W)
+    localparam ADDR_SPI_FIFO_STAT = FIFO_BASE + 32'h8;  // [9:0]=TX words, [25:16]=RX words
+    localparam ADDR_SPI_RX_REPEAT = FIFO_BASE + 32'hC;  // W: clock N fill bytes into RX FIFO
+
+    // CRC registers (Base: CRC_BASE, 0x800000E0 for SPI0; HW_CRC=1)
+    localparam ADDR_SPI_CRC_CTRL  = CRC_BASE + 32'h0;   // [0]=accumulate, [1]=clear (W), [31]=present (R)
+    localparam ADDR_SPI_CRC16_RX  = CRC_BASE + 32'h4;   // CRC16 of MISO bytes since clear
+    localparam ADDR_SPI_CRC16_TX  = CRC_BASE + 32'h8;   // CRC16 of MOSI bytes since clear
+    localparam ADDR_SPI_CRC7      = CRC_BASE + 32'hC;   // [7:0] = {CRC7 of MOSI bytes, 1} (command end byte)
 
     //==========================================================================
     // Configuration Registers
@@ -46,6 +107,9 @@ module spi_master (
     reg        cpol;          // Clock polarity (0=idle low, 1=idle high)
     reg        cpha;          // Clock phase (0=sample on leading, 1=trailing)
     reg [2:0]  clk_div;       // Clock divider: 000=/1, 001=/2, 010=/4, 011=/8, 100=/16, 101=/32, 110=/64, 111=/128
+    reg        div_ext_en;    // Use div_ext instead of clk_div
+    reg [7:0]  div_ext;       // SCK half period = div_ext + 1 clocks
+    reg [3:0]  sample_delay;  // CPHA=0: sample MISO this many clocks after the edge
     reg        cs_manual;     // Manual chip select control
 
     //==========================================================================
@@ -57,6 +121,59 @@ module spi_master (
     reg        busy;          // Transfer in progress
     reg        done;          // Transfer complete flag
 
+    //==========================================================================
+    // Burst Mode State
+    //==========================================================================
+    reg        rx_capture;    // Store MISO bytes of TX FIFO words in the RX FIFO
+    reg        fifo_clear;    // Flush strobe
+    reg        rep_load;      // SPI_RX_REPEAT write strobe
+    reg [15:0] rep_value;
+    reg [15:0] rep_count;     // Fill bytes still to clock out
+
+    reg [31:0] tx_word;       // TX FIFO word being shifted out
+    reg [2:0]  tx_bytes;      // Bytes left in tx_word
+    reg        cur_capture;   // Byte in flight goes to the RX FIFO
+    reg [23:0] rx_word;       // Received bytes not yet pushed (newest on top)
+    reg [1:0]  rx_nbytes;
+    reg        rx_push;
+    reg [31:0] rx_push_data;
+
+    // FIFOs
+    wire [31:0] txf_rdata;
+    wire [31:0] rxf_rdata;
+    wire [$clog2(FIFO_DEPTH):0] txf_level;
+    wire [$clog2(FIFO_DEPTH):0] rxf_level;
+    wire        txf_full, txf_empty;
+    wire        rxf_full, rxf_empty;
+    wire        txf_wr, txf_rd, rxf_rd;
+    reg  [31:0] pend_wdata;
+
+    spi_fifo #(.WIDTH(32), .DEPTH(FIFO_DEPTH)) tx_fifo (
+        .clk(clk),
+        .resetn(resetn),
+        .clear(fifo_clear),
+        .wr_en(txf_wr),
+        .wdata(dma_tx_push ? dma_tx_data : pend_wdata),
+        .rd_en(txf_rd),
+        .rdata(txf_rdata),
+        .level(txf_level),
+        .full(txf_full),
+        .empty(txf_empty)
+    );
+
+    spi_fifo #(.WIDTH(32), .DEPTH(FIFO_DEPTH)) rx_fifo (
+        .clk(clk),
+        .resetn(resetn),
+        .clear(fifo_clear),
+        .wr_en(rx_push),
+        .wdata(rx_push_data),
+        .rd_en(rxf_rd),
+        .rdata(rxf_rdata),
+        .level(rxf_level),
+        .full(rxf_full),
+        .empty(rxf_empty)
+    );
+
     //==========================================================================
     // IRQ pulse generation
     //==========================================================================
@@ -69,31 +186,56 @@ module spi_master (
     localparam STATE_IDLE     = 2'b00;
     localparam STATE_TRANSMIT = 2'b01;
     localparam STATE_FINISH   = 2'b10;
+    localparam STATE_FETCH    = 2'b11;  // TX FIFO word arriving
 
     reg [1:0]  state;
     reg [2:0]  bit_count;     // 0-7 for 8 bits
     reg [7:0]  shift_reg;     // Shift register for TX/RX
+    reg [7:0]  cur_tx;        // Byte being sent (for the MOSI CRCs)
+
+    // Next byte source, in priority order: byte-mode write, TX FIFO, fill.
+    // Captured bytes wait while the RX FIFO is full.
+    wire start_word  = !tx_valid && (tx_bytes != 0) && (!rx_capture || !rxf_full);
+    wire fetch_word  = !tx_valid && (tx_bytes == 0) && !txf_empty;
+    wire start_fill  = !tx_valid && (tx_bytes == 0) && txf_empty && (rep_count != 0) && !rxf_full;
+    wire start_byte  = tx_valid || start_word || start_fill;
+    wire [7:0] start_data = tx_valid ? tx_data : start_word ? tx_word[7:0] : 8'hFF;
+
+    wire queue_empty = (tx_bytes == 0) && txf_empty && (rep_count == 0);
+    wire busy_any    = busy || tx_valid || (state != STATE_IDLE) || !queue_empty;
+    wire rx_pending  = busy_any || (rx_nbytes != 0) || rx_push;
+
+    assign txf_rd = (state == STATE_IDLE) && fetch_word;
+
+    // SPI_RX_REPEAT write or DMA start
+    wire        rep_set       = rep_load || dma_rep_load;
+    wire [15:0] rep_set_value = rep_load ? rep_value : dma_rep_value;
+
+    assign dma_rx_data  = rxf_rdata;
+    assign dma_rx_empty = rxf_empty;
+    assign dma_tx_full  = txf_full;
+    assign dma_spi_busy = busy_any;
 
     //==========================================================================
-    // Clock Divider Logic - Gate-Efficient Power-of-2 Divider
-    // Supports /1, /2, /4, /8, /16, /32, /64, /128 for SD card compatibility
+    // Clock Divider Logic
+    // Power-of-2 steps /1../128 (clk_div) or any half period of 1-256
+    // clocks (div_ext), so SCK can sit just below a card's rated clock
     //==========================================================================
-    reg [6:0]  clk_counter;   // 0-127 counter for maximum /128 division
+    reg [7:0]  clk_counter;   // 0-255 counter
     reg        spi_clk_en;    // Clock enable pulse
 
-    // Divider thresholds (all power-of-2 for simple bit checking)
-    wire [6:0] div_threshold;
-    assign div_threshold = (7'b1 << clk_div) - 1'b1;  // 2^clk_div - 1
+    wire [7:0] div_threshold;
+    assign div_threshold = div_ext_en ? div_ext : ((8'b1 << clk_div) - 1'b1);
 
     always @(posedge clk or negedge resetn) begin
         if (!resetn) begin
-            clk_counter <= 7'b0;
+            clk_counter <= 8'b0;
             spi_clk_en <= 1'b0;
         end else begin
             // Generate enable pulse when counter reaches threshold
-            if (clk_counter == div_threshold) begin
+            if (clk_counter >= div_threshold) begin
                 spi_clk_en <= 1'b1;
-                clk_counter <= 7'b0;
+                clk_counter <= 8'b0;
             end else begin
                 spi_clk_en <= 1'b0;
                 clk_counter <= clk_counter + 1'b1;
@@ -106,6 +248,7 @@ module spi_master (
     //==========================================================================
     reg sck_phase;  // Internal clock phase tracker
     reg miso_captured;  // Captured MISO bit (for CPHA=0 mode)
+    reg [3:0] sample_cnt;  // Clocks until the delayed MISO sample
 
     always @(posedge clk or negedge resetn) begin
         if (!resetn) begin
@@ -113,15 +256,39 @@ module spi_master (
             spi_sck <= 1'b0;
             spi_mosi <= 1'b0;
             shift_reg <= 8'h00;
+            cur_tx <= 8'h00;
             rx_data <= 8'h00;
             bit_count <= 3'b000;
             busy <= 1'b0;
             sck_phase <= 1'b0;
             miso_captured <= 1'b0;
+            sample_cnt <= 4'h0;
             irq_pulse <= 1'b0;
+            rep_count <= 16'h0;
+            tx_word <= 32'h0;
+            tx_bytes <= 3'd0;
+            cur_capture <= 1'b0;
+            rx_word <= 24'h0;
+            rx_nbytes <= 2'd0;
+            rx_push <= 1'b0;
+            rx_push_data <= 32'h0;
         end else begin
             // Default: Clear IRQ pulse (single-cycle pulse)
             irq_pulse <= 1'b0;
+            rx_push <= 1'b0;
+
+            // Delayed MISO sample (board/pad round trip at high SCK rates);
+            // lands before the shifting edge as long as sample_delay <= half period - 1
+            if (sample_cnt != 4'h0) begin
+                sample_cnt <= sample_cnt - 1'b1;
+                if (sample_cnt == 4'h1) begin
+                    miso_captured <= spi_miso;
+                end
+            end
+
+            if (rep_set) begin
+                rep_count <= rep_set_value;
+            end
 
             case (state)
                 STATE_IDLE: begin
@@ -129,21 +296,48 @@ module spi_master (
                     spi_sck <= cpol;  // Idle state based on polarity
                     sck_phase <= 1'b0;
 
-                    if (tx_valid) begin
+                    if (start_byte) begin
                         // Load shift register and start transfer
-                        shift_reg <= tx_data;
+                        shift_reg <= start_data;
+                        cur_tx <= start_data;
                         bit_count <= 3'b000;
                         busy <= 1'b1;
                         done <= 1'b0;
+                        cur_capture <= start_word ? rx_capture : start_fill;
                         state <= STATE_TRANSMIT;
 
+                        if (start_word) begin
+                            tx_word <= {8'h00, tx_word[31:8]};
+                            tx_bytes <= tx_bytes - 1'b1;
+                        end
+                        if (start_fill && !rep_set) begin
+                            rep_count <= rep_count - 1'b1;
+                        end
+
                         // Set MOSI for first bit if CPHA=0
                         if (!cpha) begin
-                            spi_mosi <= tx_data[7];
+                            spi_mosi <= start_data[7];
                         end
+                    end else if (fetch_word) begin
+                        state <= STATE_FETCH;
+                    end else if (queue_empty && rx_nbytes != 0) begin
+                        // Transfer ended mid-word: push the partial word
+                        rx_push <= 1'b1;
+                        case (rx_nbytes)
+                            2'd1:    rx_push_data <= {24'h0, rx_word[23:16]};
+                            2'd2:    rx_push_data <= {16'h0, rx_word[23:8]};
+                            default: rx_push_data <= {8'h0, rx_word};
+                        endcase
+                        rx_nbytes <= 2'd0;
                     end
                 end
 
+                STATE_FETCH: begin
+                    tx_word <= txf_rdata;
+                    tx_bytes <= 3'd4;
+                    state <= STATE_IDLE;
+                end
+
                 STATE_TRANSMIT: begin
                     if (spi_clk_en) begin
                         sck_phase <= ~sck_phase;
@@ -155,7 +349,11 @@ module spi_master (
                             // First edge
                             if (!cpha) begin
                                 // CPHA=0: Sample MISO on first edge (capture only, don't shift yet)
-                                miso_captured <= spi_miso;
+                                if (sample_delay == 4'h0) begin
+                                    miso_captured <= spi_miso;
+                                end else begin
+                                    sample_cnt <= sample_delay;
+                                end
                             end else begin
                                 // CPHA=1: Setup on first edge
                                 spi_mosi <= shift_reg[7];
@@ -189,38 +387,201 @@ module spi_master (
                     spi_sck <= cpol;
                     rx_data <= shift_reg;
                     busy <= 1'b0;
-                    irq_pulse <= 1'b1;  // Generate single-cycle interrupt pulse
+                    irq_pulse <= queue_empty;  // Single-cycle pulse once the queue drains
                     state <= STATE_IDLE;
+
+                    if (cur_capture) begin
+                        if (rx_nbytes == 2'd3) begin
+                            rx_push <= 1'b1;
+                            rx_push_data <= {shift_reg, rx_word};
+                            rx_nbytes <= 2'd0;
+                        end else begin
+                            rx_word <= {shift_reg, rx_word[23:8]};
+                            rx_nbytes <= rx_nbytes + 1'b1;
+                        end
+                    end
                 end
 
                 default: state <= STATE_IDLE;
             endcase
+
+            // Flush drops everything queued; a byte already on the wire
+            // completes but is not captured
+            if (fifo_clear) begin
+                rep_count <= 16'h0;
+                tx_bytes <= 3'd0;
+                cur_capture <= 1'b0;
+                rx_nbytes <= 2'd0;
+                rx_push <= 1'b0;
+            end
         end
     end
 
+    //==========================================================================
+    // CRC Accumulators
+    // Updated once per byte in STATE_FINISH, MSB first like the wire order.
+    // SD data CRC16: clear after the start token, then the accumulated CRC
+    // over data + received CRC bytes is 0 for a good block.
+    //==========================================================================
+    reg        crc_en;        // Accumulate (SPI_CRC_CTRL[0])
+    reg        crc_clear;     // Clear strobe
+    reg [15:0] crc16_rx;
+    reg [15:0] crc16_tx;
+    reg [6:0]  crc7_tx;
+
+    function [15:0] crc16_byte;
+        input [15:0] crc;
+        input [7:0]  data;
+        integer i;
+        begin
+            crc16_byte = crc;
+            for (i = 7; i >= 0; i = i - 1)
+                crc16_byte = {crc16_byte[14:0], 1'b0} ^
+                             ((crc16_byte[15] ^ data[i]) ? 16'h1021 : 16'h0000);
+        end
+    endfunction
+
+    function [6:0] crc7_byte;
+        input [6:0] crc;
+        input [7:0] data;
+        integer i;
+        begin
+            crc7_byte = crc;
+            for (i = 7; i >= 0; i = i - 1)
+                crc7_byte = {crc7_byte[5:0], 1'b0} ^
+                            ((crc7_byte[6] ^ data[i]) ? 7'h09 : 7'h00);
+        end
+    endfunction
+
+    generate
+        if (HW_CRC) begin : g_crc
+            always @(posedge clk or negedge resetn) begin
+                if (!resetn) begin
+                    crc16_rx <= 16'h0;
+                    crc16_tx <= 16'h0;
+                    crc7_tx <= 7'h0;
+                end else if (crc_clear) begin
+                    crc16_rx <= 16'h0;
+                    crc16_tx <= 16'h0;
+                    crc7_tx <= 7'h0;
+                end else if (crc_en && state == STATE_FINISH) begin
+                    crc16_rx <= crc16_byte(crc16_rx, shift_reg);
+                    crc16_tx <= crc16_byte(crc16_tx, cur_tx);
+                    crc7_tx <= crc7_byte(crc7_tx, cur_tx);
+                end
+            end
+        end else begin : g_no_crc
+            always @(*) begin
+                crc16_rx = 16'h0;
+                crc16_tx = 16'h0;
+                crc7_tx = 7'h0;
+            end
+        end
+    endgenerate
+
     //==========================================================================
     // MMIO Register Interface
     //==========================================================================
+    // mmio_valid is a single-cycle request; FIFO accesses that cannot
+    // complete yet are held in pend_push/pend_pop and acknowledged later.
+    reg pend_push;            // SPI_FIFO_DATA write waiting for TX space
+    reg pend_pop;             // SPI_FIFO_DATA read waiting for an RX word
+    reg pop_wait;             // RX FIFO read issued, data next cycle
+
+    wire [9:0] txf_level_w = txf_level;
+    wire [9:0] rxf_level_w = rxf_level;
+
+    assign txf_wr = (pend_push && !txf_full) || (dma_tx_push && !txf_full);
+    assign rxf_rd = (pend_pop && !pop_wait && !rxf_empty) || dma_rx_pop;
+
+    // Fast reads: every register but SPI_FIFO_DATA, ready in the same cycle
+    wire fast_read = mmio_valid && !mmio_write && mmio_addr != ADDR_SPI_FIFO_DATA;
+    reg [31:0] fast_rdata;
+
+    // SPI_FIFO_DATA reads and all writes: registered
+    reg [31:0] slow_rdata;
+    reg        slow_ready;
+
+    assign mmio_ready = fast_read || slow_ready;
+    assign mmio_rdata = slow_ready ? slow_rdata : fast_rdata;
+
+    always @(*) begin
+        case (mmio_addr)
+            ADDR_SPI_CTRL:      fast_rdata = {12'h0, sample_delay, div_ext, 2'b00, div_ext_en, clk_div, cpha, cpol};
+            ADDR_SPI_DATA:      fast_rdata = {24'h0, rx_data};
+            // Bit 0: busy, Bit 1: done (!busy for compatibility)
+            // Busy covers queued FIFO/fill bytes as well
+            ADDR_SPI_STATUS:    fast_rdata = {30'h0, ~busy_any, busy_any};
+            ADDR_SPI_CS:        fast_rdata = {31'h0, cs_manual};
+            ADDR_SPI_FIFO_CTRL: fast_rdata = {31'h0, rx_capture};
+            ADDR_SPI_FIFO_STAT: fast_rdata = {6'h0, rxf_level_w, 6'h0, txf_level_w};
+            ADDR_SPI_RX_REPEAT: fast_rdata = {16'h0, rep_count};
+            ADDR_SPI_CRC_CTRL:  fast_rdata = {(HW_CRC != 0), 30'h0, crc_en};
+            ADDR_SPI_CRC16_RX:  fast_rdata = {16'h0, crc16_rx};
+            ADDR_SPI_CRC16_TX:  fast_rdata = {16'h0, crc16_tx};
+            ADDR_SPI_CRC7:      fast_rdata = {24'h0, crc7_tx, 1'b1};
+            default:            fast_rdata = 32'h0;
+        endcase
+    end
+
     always @(posedge clk or negedge resetn) begin
         if (!resetn) begin
-            mmio_rdata <= 32'h0;
-            mmio_ready <= 1'b0;
+            slow_rdata <= 32'h0;
+            slow_ready <= 1'b0;
             cpol <= 1'b0;
             cpha <= 1'b0;
             clk_div <= 3'b111;    // Default: /128 = 390 kHz (SD card init safe)
+            div_ext_en <= 1'b0;
+            div_ext <= 8'hFF;
+            sample_delay <= 4'h0;
             cs_manual <= 1'b1;    // Default: CS high (inactive)
             spi_cs <= 1'b1;
             tx_data <= 8'h00;
             tx_valid <= 1'b0;
+            rx_capture <= 1'b0;
+            fifo_clear <= 1'b0;
+            rep_load <= 1'b0;
+            rep_value <= 16'h0;
+            pend_wdata <= 32'h0;
+            pend_push <= 1'b0;
+            pend_pop <= 1'b0;
+            pop_wait <= 1'b0;
+            crc_en <= 1'b0;
+            crc_clear <= 1'b0;
         end else begin
             // Clear control signals
-            mmio_ready <= 1'b0;
+            slow_ready <= 1'b0;
             tx_valid <= 1'b0;
+            fifo_clear <= 1'b0;
+            rep_load <= 1'b0;
+            crc_clear <= 1'b0;
 
-            // Update CS from manual control
-            spi_cs <= cs_manual;
+            // Update CS from manual control (or the DMA stream frames)
+            spi_cs <= dma_cs_ctl ? dma_cs : cs_manual;
 
-            if (mmio_valid && !mmio_ready) begin
+            // Deferred FIFO accesses
+            if (pend_push && !txf_full) begin
+                pend_push <= 1'b0;
+                slow_ready <= 1'b1;
+            end
+
+            if (pend_pop) begin
+                if (pop_wait) begin
+                    slow_rdata <= rxf_rdata;
+                    slow_ready <= 1'b1;
+                    pend_pop <= 1'b0;
+                    pop_wait <= 1'b0;
+                end else if (!rxf_empty) begin
+                    pop_wait <= 1'b1;
+                end else if (!rx_pending) begin
+                    // Nothing left to receive: don't hang the CPU
+                    slow_rdata <= 32'h0;
+                    slow_ready <= 1'b1;
+                    pend_pop <= 1'b0;
+                end
+            end
+
+            if (mmio_valid && !slow_ready) begin
                 if (mmio_write) begin
                     // ============ WRITE OPERATIONS ============
                     case (mmio_addr)
@@ -230,21 +591,29 @@ module spi_master (
                                 cpol <= mmio_wdata[0];
                                 cpha <= mmio_wdata[1];
                                 clk_div <= mmio_wdata[4:2];
+                                div_ext_en <= mmio_wdata[5];
                             end
-                            mmio_ready <= 1'b1;
+                            if (mmio_wstrb[1]) begin
+                                div_ext <= mmio_wdata[15:8];
+                            end
+                            if (mmio_wstrb[2]) begin
+                                sample_delay <= mmio_wdata[19:16];
+                            end
+                            slow_ready <= 1'b1;
 
                             // synthesis translate_off
-                            $display("[SPI] CTRL: CPOL=%b CPHA=%b CLK_DIV=%b",
-                                     mmio_wdata[0], mmio_wdata[1], mmio_wdata[4:2]);
+                            $display("[SPI] CTRL: CPOL=%b CPHA=%b CLK_DIV=%b DIV_EXT=%b/%0d DELAY=%0d",
+                                     mmio_wdata[0], mmio_wdata[1], mmio_wdata[4:2],
+                                     mmio_wdata[5], mmio_wdata[15:8], mmio_wdata[19:16]);
                             // synthesis translate_on
                         end
 
                         ADDR_SPI_DATA: begin
                             // Write to data register (initiate transfer)
-                            if (!busy && mmio_wstrb[0]) begin
+                            if (!busy_any && mmio_wstrb[0]) begin
                                 tx_data <= mmio_wdata[7:0];
                                 tx_valid <= 1'b1;
-                                mmio_ready <= 1'b1;
+                                slow_ready <= 1'b1;
 
                                 // synthesis translate_off
                                 $display("[SPI] TX: 0x%02x", mmio_wdata[7:0]);
@@ -258,55 +627,55 @@ module spi_master (
                             if (mmio_wstrb[0]) begin
                                 cs_manual <= mmio_wdata[0];
                             end
-                            mmio_ready <= 1'b1;
+                            slow_ready <= 1'b1;
 
                             // synthesis translate_off
                             $display("[SPI] CS: %b", mmio_wdata[0]);
                             // synthesis translate_on
                         end
 
-                        default: begin
-                            mmio_ready <= 1'b1;
+                        ADDR_SPI_FIFO_DATA: begin
+                            // Queue a TX word; acknowledged once the FIFO has room
+                            pend_wdata <= mmio_wdata;
+                            pend_push <= 1'b1;
                         end
-                    endcase
 
-                end else begin
-                    // ============ READ OPERATIONS ============
-                    case (mmio_addr)
-                        ADDR_SPI_CTRL: begin
-                            // Read control register
-                            mmio_rdata <= {27'h0, clk_div, cpha, cpol};
-                            mmio_ready <= 1'b1;
+                        ADDR_SPI_FIFO_CTRL: begin
+                            if (mmio_wstrb[0]) begin
+                                rx_capture <= mmio_wdata[0];
+                                fifo_clear <= mmio_wdata[1];
+                            end
+                            slow_ready <= 1'b1;
                         end
 
-                        ADDR_SPI_DATA: begin
-                            // Read received data
-                            mmio_rdata <= {24'h0, rx_data};
-                            mmio_ready <= 1'b1;
-
-                            // synthesis translate_off
-                            $display("[SPI] RX: 0x%02x", rx_data);
-                            // synthesis translate_on
+                        ADDR_SPI_CRC_CTRL: begin
+                            if (mmio_wstrb[0]) begin
+                                crc_en <= mmio_wdata[0] && (HW_CRC != 0);
+                                crc_clear <= mmio_wdata[1];
+                            end
+                            slow_ready <= 1'b1;
                         end
 
-                        ADDR_SPI_STATUS: begin
-                            // Read status register
-                            // Bit 0: busy, Bit 1: done (!busy for compatibility)
-                            mmio_rdata <= {30'h0, ~busy, busy};
-                            mmio_ready <= 1'b1;
-                        end
+                        ADDR_SPI_RX_REPEAT: begin
+                            rep_value <= mmio_wdata[15:0];
+                            rep_load <= 1'b1;
+                            slow_ready <= 1'b1;
 
-                        ADDR_SPI_CS: begin
-                            // Read chip select state
-                            mmio_rdata <= {31'h0, cs_manual};
-                            mmio_ready <= 1'b1;
+                            // synthesis translate_off
+                            $display("[SPI] RX repeat: %0d bytes", mmio_wdata[15:0]);
+                            // synthesis translate_on
                         end
 
                         default: begin
-                            mmio_rdata <= 32'h0;
-                            mmio_ready <= 1'b1;
+                            slow_ready <= 1'b1;
                         end
                     endcase
+
+                end else if (mmio_addr == ADDR_SPI_FIFO_DATA) begin
+                    // ============ READ OPERATIONS ============
+                    // Pop an RX word (data returned by the deferred path);
+                    // other reads: fast_rdata
+                    pend_pop <= 1'b1;
                 end
             end
         end
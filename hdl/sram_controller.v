@@ -0,0 +1,731 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// sram_controller.v - SRAM Controller with Selectable Timing Profiles
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//
+//==============================================================================
+// 32-bit start/busy/done port (mem_controller, firmware_loader) on the 16-bit
+// asynchronous SRAM. Replaces sram_unified_adapter + sram_controller_unified
+// and the earlier sram_driver_* / sram_proc_* experiments.
+//
+// TIMING (Kconfig SRAM_TIMING_*, `SRAM_TIMING in config.vh):
+//
+//   0  2-cycle   SETUP + CAPTURE per read halfword, SETUP + PULSE +
+//                COMPLETE per written halfword. WE falls a full cycle after
+//                the address and rises a full cycle before it changes.
+//   1  1-cycle   Registered outputs. Reads stream one halfword per cycle
+//                (capture the halfword addressed last cycle, present the
+//                next); WE falls with the address (tSA = 0) and rises a
+//                cycle later with the address held.
+//   2  burst     1-cycle plus sequential mode: after a read the next word's
+//                address stays on the bus with CS/OE low. A read of exactly
+//                that word captures its low halfword at once.
+//
+// Controller cycles, start to done (the front end adds 2 as before):
+//
+//   Transaction              2-cycle   1-cycle   burst
+//   32-bit read                 4         3      3 (2 sequential)
+//   32-bit write                6         4      4 (+1 after a read)
+//   Aligned halfword write      3         2      2 (+1 after a read)
+//   Byte write (RMW)            5         4      4 (+1 after a read)
+//   Burst read (cache fill)  1 + 2/word  same    same
+//
+// Partial writes go half by half: a halfword with no strobe is not
+// touched, one with both bytes strobed is written without a read, and only
+// a halfword with a single strobed byte is read first (a 3-byte write
+// reads one halfword and writes two).
+//
+// WRITE_COMBINE (Kconfig SRAM_WRITE_COMBINE): partial writes are merged
+// into a one-word buffer and done the next cycle; the buffer's bytes are
+// written (as one partial write, a full one once all 4 bytes are in) when
+// a partial write goes to another word, a read covers the buffered word
+// (bursts: any word of the burst), or the controller is idle WCB_HOLD
+// cycles after the last merge. A full write to the buffered word replaces it. Four
+// byte stores to one word (strcpy, memset, FatFS and incurses buffers)
+// then cost one 32-bit write instead of four RMWs. Both SRAM masters go
+// through this controller, so the buffer is never bypassed.
+//
+// Every profile captures read data one clock after the address changes, so
+// the clock period has to cover tAA plus the FPGA/board I/O delays.
+// scripts/gen_config_vh.sh checks this against SRAM_TAA_NS/SRAM_IO_NS and
+// refuses the 1-cycle profiles when it does not hold: their writes also
+// rely on tSA = tHA = 0, i.e. on every pin coming from a flip-flop on the
+// same clock edge (sram_addr/sram_we_n/sram_cs_n drive only the pads).
+//
+// SRAM CHIP: IS61WV51216BLL-10TLI (512KB, 16-bit, 10ns access)
+// - tAA (address access): 10ns max
+// - tPWE (WE pulse width): 8ns min → one clock in every profile
+// - tSA/tHA (address setup/hold to write): 0ns min
+//==============================================================================
+
+module sram_controller #(
+    parameter TIMING = 0,               // 0 = 2-cycle, 1 = 1-cycle, 2 = burst
+    parameter WRITE_COMBINE = 0,        // 1 = merge partial writes to one word
+    parameter WCB_HOLD = 15             // Idle cycles before the buffer is written
+) (
+    input wire clk,
+    input wire resetn,
+
+    // mem_controller Interface (start/busy/done style)
+    input wire start,
+    input wire [7:0] cmd,            // Command byte (unused - wstrb determines operation)
+    input wire [31:0] addr_in,
+    input wire [31:0] data_in,
+    input wire [3:0] mem_wstrb,
+    input wire [3:0] burst,          // Extra sequential read words (0 = single)
+    output reg busy,
+    output reg done,
+    output reg [31:0] result,
+
+    // SRAM Physical Interface (16-bit)
+    output reg [17:0] sram_addr,     // 18-bit word address (256K x 16)
+    inout wire [15:0] sram_data,
+    output reg sram_cs_n,
+    output reg sram_oe_n,
+    output reg sram_we_n
+);
+
+    localparam FAST = (TIMING != 0);    // 1-cycle reads and writes
+    localparam PARK = (TIMING == 2);    // Sequential mode
+
+    //==========================================================================
+    // Front End: start/busy/done → valid/ready
+    //==========================================================================
+    // Burst reads: when burst != 0 the core streams burst+1 sequential
+    // words; each one is forwarded as its own done pulse with result, busy
+    // stays high until the last word.
+    localparam FE_IDLE       = 2'd0;
+    localparam FE_ACTIVE     = 2'd1;
+    localparam FE_COMPLETING = 2'd2;
+
+    reg [1:0] fe_state;
+    reg valid;
+    reg ready;
+    reg [31:0] rdata;               // One ready pulse per word in a burst
+    reg [3:0] burst_reg;            // Burst length for this transaction
+    reg [3:0] words_left;           // Words still expected after the next one
+
+    always @(posedge clk) begin
+        if (!resetn) begin
+            fe_state <= FE_IDLE;
+            valid <= 1'b0;
+            busy <= 1'b0;
+            done <= 1'b0;
+            result <= 32'h0;
+            burst_reg <= 4'h0;
+            words_left <= 4'h0;
+        end else begin
+            case (fe_state)
+                FE_IDLE: begin
+                    done <= 1'b0;
+                    valid <= 1'b0;
+
+                    if (start && !busy) begin
+                        valid <= 1'b1;
+                        busy <= 1'b1;
+                        burst_reg <= (|mem_wstrb) ? 4'h0 : burst;
+                        words_left <= (|mem_wstrb) ? 4'h0 : burst;
+                        fe_state <= FE_ACTIVE;
+                    end
+                end
+
+                FE_ACTIVE: begin
+                    done <= 1'b0;
+
+                    if (ready && words_left != 4'h0) begin
+                        // Intermediate burst word
+                        valid <= 1'b0;
+                        result <= rdata;
+                        done <= 1'b1;
+                        words_left <= words_left - 1'b1;
+                    end else if (ready) begin
+                        // Transaction complete
+                        valid <= 1'b0;
+                        result <= rdata;
+                        done <= 1'b1;
+                        busy <= 1'b0;
+                        fe_state <= FE_COMPLETING;
+                    end
+                end
+
+                FE_COMPLETING: begin
+                    // Hold done for one cycle
+                    done <= 1'b0;
+                    fe_state <= FE_IDLE;
+                end
+
+                default: fe_state <= FE_IDLE;
+            endcase
+        end
+    end
+
+    //==========================================================================
+    // State Machine
+    //==========================================================================
+    localparam IDLE              = 5'd0;
+
+    // Full 32-bit read (wstrb == 4'b0000), 2-cycle profile
+    localparam READ_LOW_SETUP    = 5'd1;
+    localparam READ_LOW_CAPTURE  = 5'd2;
+    localparam READ_HIGH_SETUP   = 5'd3;
+    localparam READ_HIGH_CAPTURE = 5'd4;
+
+    // Full 32-bit write (wstrb == 4'b1111)
+    localparam WRITE_LOW_SETUP   = 5'd5;
+    localparam WRITE_LOW_PULSE   = 5'd6;
+    localparam WRITE_HIGH_SETUP  = 5'd7;
+    localparam WRITE_HIGH_PULSE  = 5'd8;
+
+    // Partial write (byte/halfword - need read-modify-write)
+    localparam RMW_READ_LOW_SETUP    = 5'd9;
+    localparam RMW_READ_LOW_CAPTURE  = 5'd10;
+    localparam RMW_READ_HIGH_SETUP   = 5'd11;
+    localparam RMW_READ_HIGH_CAPTURE = 5'd12;
+    localparam RMW_WRITE_LOW_SETUP   = 5'd13;
+    localparam RMW_WRITE_LOW_PULSE   = 5'd14;
+
+    // Write completion states (deassert WE cleanly)
+    localparam WRITE_LOW_COMPLETE      = 5'd15;
+    localparam WRITE_HIGH_COMPLETE     = 5'd16;
+    localparam RMW_WRITE_LOW_COMPLETE  = 5'd17;
+    localparam RMW_WRITE_HIGH_SETUP    = 5'd18;
+    localparam RMW_WRITE_HIGH_PULSE    = 5'd19;
+    localparam RMW_WRITE_HIGH_COMPLETE = 5'd20;
+
+    // Streamed reads: bursts, and every read in the 1-cycle profiles
+    localparam BURST_READ_SETUP  = 5'd21;
+    localparam BURST_READ_STREAM = 5'd22;
+
+    // Burst profile: next sequential address on the bus, CS/OE low
+    localparam PARKED            = 5'd23;
+
+    reg [4:0] state;
+
+    //==========================================================================
+    // Internal Registers
+    //==========================================================================
+    reg [31:0] addr_reg;        // Latched byte address
+    reg [31:0] wdata_reg;       // Latched write data
+    reg [3:0] wstrb_reg;        // Latched write strobes
+    reg [15:0] rdata_low;       // LOW halfword buffer
+    reg [15:0] rdata_high;      // HIGH halfword buffer
+    reg [15:0] data_out_reg;    // Data to drive on SRAM bus
+    reg data_oe;                // Output enable for tri-state buffer
+    reg [3:0] burst_left;       // Words remaining after the current one
+    reg burst_half;             // 0 = capturing LOW, 1 = capturing HIGH
+    reg [17:0] burst_next;      // Next halfword address to present
+    reg [17:0] park_addr;       // Halfword address on the bus while PARKED
+    reg flushing;               // Writing the combine buffer: no ready
+
+    // Write-combining buffer (WRITE_COMBINE)
+    reg wcb_valid;              // Holds bytes not yet in SRAM
+    reg [18:2] wcb_word;        // Word address
+    reg [31:0] wcb_data;
+    reg [3:0] wcb_strb;         // Bytes held
+    reg [3:0] wcb_age;          // Idle cycles since the last merge
+
+    // Tri-state control for SRAM data bus
+    assign sram_data = data_oe ? data_out_reg : 16'hzzzz;
+
+    //==========================================================================
+    // Write Strobe Decode
+    //==========================================================================
+    wire is_full_write = (wstrb_reg == 4'b1111);
+
+    // Aligned halfword write (can skip RMW), on the request strobes
+    wire req_low_halfword  = (mem_wstrb == 4'b0011);    // Bytes [1:0]
+    wire req_high_halfword = (mem_wstrb == 4'b1100);    // Bytes [3:2]
+
+    // Determine which halfwords are affected
+    wire low_halfword_affected = (wstrb_reg[1:0] != 2'b00);
+    wire high_halfword_affected = (wstrb_reg[3:2] != 2'b00);
+
+    // Halfwords with one byte strobed: the only ones RMW reads
+    wire high_halfword_partial = ^wstrb_reg[3:2];
+
+    // First state of a write with strobes s. A halfword is read only when
+    // one of its bytes is kept; fully strobed halves merge as wdata.
+    function [4:0] write_start(input [3:0] s);
+        write_start = (s == 4'b1111 || s == 4'b0011) ? WRITE_LOW_SETUP :
+                      (s == 4'b1100) ? WRITE_HIGH_SETUP :
+                      (^s[1:0]) ? RMW_READ_LOW_SETUP :
+                      RMW_READ_HIGH_SETUP;
+    endfunction
+
+    // First state of a request (IDLE, or a write leaving PARKED)
+    wire [4:0] dispatch =
+        (mem_wstrb == 4'b0000 && (FAST || burst_reg != 4'h0)) ? BURST_READ_SETUP :
+        (mem_wstrb == 4'b0000) ? READ_LOW_SETUP :
+        write_start(mem_wstrb);
+
+    //==========================================================================
+    // Write-Combining Buffer Decode
+    //==========================================================================
+    wire req = valid && !ready;
+    wire req_partial = (mem_wstrb != 4'b0000 && mem_wstrb != 4'b1111);
+    wire wcb_same = (addr_in[18:2] == wcb_word);
+
+    // Words from the request's to the end of its burst
+    wire [16:0] wcb_off = wcb_word - addr_in[18:2];
+    wire read_hits_wcb = (wcb_off <= {13'h0, burst_reg});
+
+    // Partial write merged into the buffer (done next cycle)
+    wire wcb_absorb = WRITE_COMBINE && req && req_partial &&
+                      (!wcb_valid || wcb_same);
+
+    // Buffer written first: in the way of the request, or held long enough
+    wire wcb_flush = WRITE_COMBINE && wcb_valid &&
+        (req ? ((mem_wstrb == 4'b0000 && read_hits_wcb) ||
+                (req_partial && !wcb_same))
+             : (wcb_age == WCB_HOLD));
+
+    //==========================================================================
+    // Address Calculation
+    //==========================================================================
+    // CPU provides byte address, SRAM needs word address (divide by 2)
+    // addr_reg[31:1] = word address
+    // addr_reg[0] = ignored (aligned to 16-bit boundaries)
+
+    wire [17:0] sram_addr_low  = addr_reg[18:1];      // LOW halfword address
+    wire [17:0] sram_addr_high = addr_reg[18:1] + 1;  // HIGH halfword address
+    wire [17:0] req_addr_low   = addr_in[18:1];
+
+    //==========================================================================
+    // Read-Modify-Write Data Merging
+    //==========================================================================
+    wire [15:0] merged_low;
+    wire [15:0] merged_high;
+
+    // Merge LOW halfword based on byte strobes
+    assign merged_low[7:0]  = wstrb_reg[0] ? wdata_reg[7:0]  : rdata_low[7:0];
+    assign merged_low[15:8] = wstrb_reg[1] ? wdata_reg[15:8] : rdata_low[15:8];
+
+    // Merge HIGH halfword based on byte strobes
+    assign merged_high[7:0]  = wstrb_reg[2] ? wdata_reg[23:16] : rdata_high[7:0];
+    assign merged_high[15:8] = wstrb_reg[3] ? wdata_reg[31:24] : rdata_high[15:8];
+
+    // Write pulse: 2-cycle holds WE high through SETUP and drops it in
+    // PULSE; 1-cycle drops it in SETUP and skips PULSE
+    wire setup_we_n = FAST ? 1'b0 : 1'b1;
+
+    //==========================================================================
+    // Main State Machine
+    //==========================================================================
+    always @(posedge clk) begin
+        if (!resetn) begin
+            state <= IDLE;
+            ready <= 1'b0;
+            sram_addr <= 18'h0;
+            sram_cs_n <= 1'b1;
+            sram_oe_n <= 1'b1;
+            sram_we_n <= 1'b1;
+            data_oe <= 1'b0;
+            addr_reg <= 32'h0;
+            wdata_reg <= 32'h0;
+            wstrb_reg <= 4'h0;
+            rdata <= 32'h0;
+            rdata_low <= 16'h0;
+            rdata_high <= 16'h0;
+            data_out_reg <= 16'h0;
+            burst_left <= 4'h0;
+            burst_half <= 1'b0;
+            burst_next <= 18'h0;
+            park_addr <= 18'h0;
+            flushing <= 1'b0;
+            wcb_valid <= 1'b0;
+            wcb_word <= 17'h0;
+            wcb_data <= 32'h0;
+            wcb_strb <= 4'h0;
+            wcb_age <= 4'h0;
+        end else begin
+            if (wcb_valid && wcb_age != WCB_HOLD) begin
+                wcb_age <= wcb_age + 1'b1;
+            end
+
+            // Merge: bytes of this write over what the buffer holds
+            if ((state == IDLE || state == PARKED) && !wcb_flush && wcb_absorb) begin
+                wcb_valid <= 1'b1;
+                wcb_word <= addr_in[18:2];
+                wcb_strb <= (wcb_valid ? wcb_strb : 4'h0) | mem_wstrb;
+                if (mem_wstrb[0]) wcb_data[7:0]   <= data_in[7:0];
+                if (mem_wstrb[1]) wcb_data[15:8]  <= data_in[15:8];
+                if (mem_wstrb[2]) wcb_data[23:16] <= data_in[23:16];
+                if (mem_wstrb[3]) wcb_data[31:24] <= data_in[31:24];
+                wcb_age <= 4'h0;
+            end
+
+            case (state)
+                //==============================================================
+                // IDLE: Wait for CPU transaction
+                //==============================================================
+                IDLE: begin
+                    ready <= 1'b0;
+                    sram_cs_n <= 1'b1;
+                    sram_oe_n <= 1'b1;
+                    sram_we_n <= 1'b1;
+                    data_oe <= 1'b0;
+
+                    flushing <= 1'b0;
+
+                    if (wcb_flush) begin
+                        // Buffer first; the request stays valid
+                        addr_reg <= {13'h0, wcb_word, 2'b00};
+                        wdata_reg <= wcb_data;
+                        wstrb_reg <= wcb_strb;
+                        wcb_valid <= 1'b0;
+                        flushing <= 1'b1;
+                        state <= write_start(wcb_strb);
+                    end else if (wcb_absorb) begin
+                        ready <= 1'b1;          // Merged above
+                    end else if (req) begin
+                        // Only accept new valid when ready is low (prevents double-trigger)
+                        addr_reg <= addr_in;
+                        wdata_reg <= data_in;
+                        wstrb_reg <= mem_wstrb;
+                        burst_left <= burst_reg;
+                        if (mem_wstrb == 4'b1111 && wcb_same) begin
+                            wcb_valid <= 1'b0;  // Overwritten
+                        end
+                        state <= dispatch;
+                    end
+                end
+
+                //==============================================================
+                // PARKED: Sequential mode (burst profile only)
+                //==============================================================
+                PARKED: begin
+                    ready <= 1'b0;
+                    flushing <= 1'b0;
+
+                    if (wcb_flush) begin
+                        // Release the bus for a cycle, then write the buffer
+                        sram_cs_n <= 1'b1;
+                        sram_oe_n <= 1'b1;
+                        addr_reg <= {13'h0, wcb_word, 2'b00};
+                        wdata_reg <= wcb_data;
+                        wstrb_reg <= wcb_strb;
+                        wcb_valid <= 1'b0;
+                        flushing <= 1'b1;
+                        state <= write_start(wcb_strb);
+                    end else if (wcb_absorb) begin
+                        ready <= 1'b1;          // Merged above, bus stays parked
+                    end else if (req) begin
+                        addr_reg <= addr_in;
+                        wdata_reg <= data_in;
+                        wstrb_reg <= mem_wstrb;
+                        burst_left <= burst_reg;
+                        if (mem_wstrb == 4'b1111 && wcb_same) begin
+                            wcb_valid <= 1'b0;  // Overwritten
+                        end
+
+                        if (mem_wstrb == 4'b0000 && req_addr_low == park_addr) begin
+                            // Sequential: the low halfword has been addressed
+                            // for at least a cycle, capture it now
+                            rdata_low <= sram_data;
+                            sram_addr <= park_addr + 1'b1;
+                            burst_next <= park_addr + 2'd2;
+                            burst_half <= 1'b1;
+                            state <= BURST_READ_STREAM;
+                        end else if (mem_wstrb == 4'b0000) begin
+                            // Other read: present its low halfword right away
+                            sram_addr <= req_addr_low;
+                            burst_next <= req_addr_low + 1'b1;
+                            burst_half <= 1'b0;
+                            state <= BURST_READ_STREAM;
+                        end else begin
+                            // Write: release the bus for a cycle before
+                            // SETUP drives it (no OE/data overlap)
+                            sram_cs_n <= 1'b1;
+                            sram_oe_n <= 1'b1;
+                            state <= dispatch;
+                        end
+                    end
+                end
+
+                //==============================================================
+                // FULL READ: 32-bit Read Operation (4 cycles, 2-cycle profile)
+                //==============================================================
+                READ_LOW_SETUP: begin
+                    // Cycle 1: Setup LOW halfword read
+                    sram_addr <= sram_addr_low;
+                    sram_cs_n <= 1'b0;
+                    sram_oe_n <= 1'b0;
+                    sram_we_n <= 1'b1;
+                    data_oe <= 1'b0;
+                    state <= READ_LOW_CAPTURE;
+                end
+
+                READ_LOW_CAPTURE: begin
+                    // Cycle 2: Capture LOW halfword (tAA within one clock)
+                    rdata_low <= sram_data;
+                    state <= READ_HIGH_SETUP;
+                end
+
+                READ_HIGH_SETUP: begin
+                    // Cycle 3: Setup HIGH halfword read
+                    sram_addr <= sram_addr_high;
+                    sram_cs_n <= 1'b0;
+                    sram_oe_n <= 1'b0;
+                    sram_we_n <= 1'b1;
+                    data_oe <= 1'b0;
+                    state <= READ_HIGH_CAPTURE;
+                end
+
+                READ_HIGH_CAPTURE: begin
+                    // Cycle 4: Capture HIGH halfword and complete
+                    rdata_high <= sram_data;
+                    rdata <= {sram_data, rdata_low};  // Assemble 32-bit result
+
+                    // Deassert SRAM signals
+                    sram_cs_n <= 1'b1;
+                    sram_oe_n <= 1'b1;
+
+                    // Signal completion
+                    ready <= 1'b1;
+                    state <= IDLE;
+                end
+
+                //==============================================================
+                // STREAMED READ: One halfword per cycle
+                //==============================================================
+                BURST_READ_SETUP: begin
+                    // Present first LOW halfword address
+                    sram_addr <= sram_addr_low;
+                    sram_cs_n <= 1'b0;
+                    sram_oe_n <= 1'b0;
+                    sram_we_n <= 1'b1;
+                    data_oe <= 1'b0;
+                    burst_next <= sram_addr_high;
+                    burst_half <= 1'b0;
+                    state <= BURST_READ_STREAM;
+                end
+
+                BURST_READ_STREAM: begin
+                    // Every cycle: capture the halfword addressed last cycle
+                    // and present the next one
+                    ready <= 1'b0;
+
+                    if (!burst_half) begin
+                        rdata_low <= sram_data;
+                        sram_addr <= burst_next;
+                        burst_next <= burst_next + 1'b1;
+                        burst_half <= 1'b1;
+                    end else begin
+                        rdata <= {sram_data, rdata_low};
+                        ready <= 1'b1;      // Word complete
+                        burst_half <= 1'b0;
+
+                        if (burst_left != 4'h0) begin
+                            burst_left <= burst_left - 1'b1;
+                            sram_addr <= burst_next;
+                            burst_next <= burst_next + 1'b1;
+                        end else if (PARK) begin
+                            // Keep the next word addressed for a sequential read
+                            sram_addr <= burst_next;
+                            park_addr <= burst_next;
+                            state <= PARKED;
+                        end else begin
+                            sram_cs_n <= 1'b1;
+                            sram_oe_n <= 1'b1;
+                            state <= IDLE;
+                        end
+                    end
+                end
+
+                //==============================================================
+                // FULL WRITE: 32-bit Write Operation (6 cycles, 4 with FAST)
+                //==============================================================
+                WRITE_LOW_SETUP: begin
+                    // Setup LOW halfword write (FAST: WE falls here, tSA = 0)
+                    sram_addr <= sram_addr_low;
+                    data_out_reg <= wdata_reg[15:0];
+                    data_oe <= 1'b1;
+                    sram_cs_n <= 1'b0;
+                    sram_oe_n <= 1'b1;  // OE must be high during write
+                    sram_we_n <= setup_we_n;
+                    state <= FAST ? WRITE_LOW_COMPLETE : WRITE_LOW_PULSE;
+                end
+
+                WRITE_LOW_PULSE: begin
+                    // 2-cycle: pulse WE for LOW halfword (one clock > tPWE)
+                    sram_we_n <= 1'b0;
+                    state <= WRITE_LOW_COMPLETE;
+                end
+
+                WRITE_LOW_COMPLETE: begin
+                    // Deassert WE (completes LOW write), address/data held
+                    sram_we_n <= 1'b1;
+
+                    // Check if we need to write HIGH halfword too
+                    if (is_full_write) begin
+                        state <= WRITE_HIGH_SETUP;
+                    end else begin
+                        // Only LOW halfword - done
+                        ready <= !flushing;
+                        state <= IDLE;
+                    end
+                end
+
+                WRITE_HIGH_SETUP: begin
+                    // Setup HIGH halfword write
+                    sram_addr <= sram_addr_high;
+                    data_out_reg <= wdata_reg[31:16];
+                    data_oe <= 1'b1;
+                    sram_cs_n <= 1'b0;
+                    sram_oe_n <= 1'b1;
+                    sram_we_n <= setup_we_n;
+                    state <= FAST ? WRITE_HIGH_COMPLETE : WRITE_HIGH_PULSE;
+                end
+
+                WRITE_HIGH_PULSE: begin
+                    // 2-cycle: pulse WE for HIGH halfword
+                    sram_we_n <= 1'b0;
+                    state <= WRITE_HIGH_COMPLETE;
+                end
+
+                WRITE_HIGH_COMPLETE: begin
+                    // Deassert WE (completes HIGH write)
+                    sram_we_n <= 1'b1;
+                    ready <= !flushing;
+                    state <= IDLE;
+                end
+
+                //==============================================================
+                // READ-MODIFY-WRITE: Partial Write Operation (4-8 cycles)
+                // Entered at RMW_READ_LOW_SETUP or RMW_READ_HIGH_SETUP
+                // (write_start), reading only the halves with one byte kept
+                //==============================================================
+                RMW_READ_LOW_SETUP: begin
+                    // Setup LOW halfword read
+                    sram_addr <= sram_addr_low;
+                    sram_cs_n <= 1'b0;
+                    sram_oe_n <= 1'b0;
+                    sram_we_n <= 1'b1;
+                    data_oe <= 1'b0;
+                    state <= RMW_READ_LOW_CAPTURE;
+                end
+
+                RMW_READ_LOW_CAPTURE: begin
+                    // Capture LOW halfword (FAST: and present HIGH)
+                    rdata_low <= sram_data;
+                    if (!high_halfword_partial) begin
+                        // HIGH written whole or not at all: no read
+                        sram_cs_n <= 1'b1;
+                        sram_oe_n <= 1'b1;
+                        state <= RMW_WRITE_LOW_SETUP;
+                    end else if (FAST) begin
+                        sram_addr <= sram_addr_high;
+                        state <= RMW_READ_HIGH_CAPTURE;
+                    end else begin
+                        state <= RMW_READ_HIGH_SETUP;
+                    end
+                end
+
+                RMW_READ_HIGH_SETUP: begin
+                    // Setup HIGH halfword read
+                    sram_addr <= sram_addr_high;
+                    sram_cs_n <= 1'b0;
+                    sram_oe_n <= 1'b0;
+                    sram_we_n <= 1'b1;
+                    data_oe <= 1'b0;
+                    state <= RMW_READ_HIGH_CAPTURE;
+                end
+
+                RMW_READ_HIGH_CAPTURE: begin
+                    // Capture HIGH halfword
+                    rdata_high <= sram_data;
+
+                    // Deassert read signals
+                    sram_cs_n <= 1'b1;
+                    sram_oe_n <= 1'b1;
+
+                    // Merge happens combinationally (merged_low/merged_high)
+                    if (low_halfword_affected) begin
+                        state <= RMW_WRITE_LOW_SETUP;
+                    end else if (high_halfword_affected) begin
+                        state <= RMW_WRITE_HIGH_SETUP;
+                    end else begin
+                        // No bytes selected? Should not happen
+                        ready <= !flushing;
+                        state <= IDLE;
+                    end
+                end
+
+                RMW_WRITE_LOW_SETUP: begin
+                    // Setup LOW halfword write (merged data)
+                    sram_addr <= sram_addr_low;
+                    data_out_reg <= merged_low;
+                    data_oe <= 1'b1;
+                    sram_cs_n <= 1'b0;
+                    sram_oe_n <= 1'b1;
+                    sram_we_n <= setup_we_n;
+                    state <= FAST ? RMW_WRITE_LOW_COMPLETE : RMW_WRITE_LOW_PULSE;
+                end
+
+                RMW_WRITE_LOW_PULSE: begin
+                    // Pulse WE for LOW halfword
+                    sram_we_n <= 1'b0;
+                    state <= RMW_WRITE_LOW_COMPLETE;
+                end
+
+                RMW_WRITE_LOW_COMPLETE: begin
+                    // Deassert WE (completes LOW write)
+                    sram_we_n <= 1'b1;
+
+                    if (high_halfword_affected) begin
+                        state <= RMW_WRITE_HIGH_SETUP;
+                    end else begin
+                        ready <= !flushing;
+                        state <= IDLE;
+                    end
+                end
+
+                RMW_WRITE_HIGH_SETUP: begin
+                    // Setup HIGH halfword write with merged data
+                    sram_addr <= sram_addr_high;
+                    data_out_reg <= merged_high;  // Use merged data, not wdata_reg!
+                    data_oe <= 1'b1;
+                    sram_cs_n <= 1'b0;
+                    sram_oe_n <= 1'b1;
+                    sram_we_n <= setup_we_n;
+                    state <= FAST ? RMW_WRITE_HIGH_COMPLETE : RMW_WRITE_HIGH_PULSE;
+                end
+
+                RMW_WRITE_HIGH_PULSE: begin
+                    // Pulse WE for HIGH halfword
+                    sram_we_n <= 1'b0;
+                    state <= RMW_WRITE_HIGH_COMPLETE;
+                end
+
+                RMW_WRITE_HIGH_COMPLETE: begin
+                    // Deassert WE (completes HIGH write)
+                    sram_we_n <= 1'b1;
+                    ready <= !flushing;
+                    state <= IDLE;
+                end
+
+                default: begin
+                    state <= IDLE;
+                end
+            endcase
+        end
+    end
+
+    //==========================================================================
+    // Simulation/Debug Support
+    //==========================================================================
+    // synthesis translate_off
+    initial begin
+        if (TIMING > 2) begin
+            $display("[SRAM_CTRL] ERROR: TIMING=%0d (0 = 2-cycle, 1 = 1-cycle, 2 = burst)", TIMING);
+            $finish;
+        end
+    end
+    // synthesis translate_on
+
+endmodule
@@ -0,0 +1,105 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// timebase.v - 64-bit Free-Running Microsecond Timebase
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+// PURPOSE: Monotonic time that no driver has to own: a 64-bit microsecond
+//          counter and a 32-bit millisecond counter, both running from reset
+//          and read-only (lib/timer.h timebase_us(), timebase_ms()).
+//
+// The microsecond tick is a phase accumulator (adds 1 MHz per clock, wraps
+// at CLK_HZ), so the rate is exact on average even when SYS_CLK_HZ is not
+// a whole number of MHz. Reading US_LO latches the upper half, so the pair
+// US_LO, US_HI is one consistent 64-bit sample.
+//==============================================================================
+
+module timebase #(
+    parameter CLK_HZ = 50_000_000
+) (
+    input wire clk,
+    input wire resetn,
+
+    // MMIO Interface
+    input wire        mmio_valid,
+    input wire        mmio_write,
+    input wire [31:0] mmio_addr,
+    input wire [31:0] mmio_wdata,
+    input wire [ 3:0] mmio_wstrb,
+    output reg [31:0] mmio_rdata,
+    output wire       mmio_ready
+);
+
+    // =========================================================================
+    // Register Map
+    // Base: 0x80000150
+    // =========================================================================
+    // +0x00: US_LO (R) - Microseconds since reset, bits [31:0]; latches US_HI
+    // +0x04: US_HI (R) - Bits [63:32] as of the last US_LO read
+    // +0x08: MS    (R) - Milliseconds since reset (wraps after 49.7 days)
+    // +0x0C: INFO  (R) - [31]=present, [23:0]=clock frequency in kHz
+    // =========================================================================
+
+    localparam ADDR_US_LO = 2'h0;
+    localparam ADDR_US_HI = 2'h1;
+    localparam ADDR_MS    = 2'h2;
+    localparam ADDR_INFO  = 2'h3;
+
+    localparam [23:0] CLK_KHZ = CLK_HZ / 1000;
+
+    reg [26:0] phase;           // Fractional microsecond (units of 1/CLK_HZ s)
+    reg [63:0] us_count;
+    reg [31:0] us_hi_latch;
+    reg [ 9:0] us_in_ms;
+    reg [31:0] ms_count;
+
+    wire [27:0] phase_next = phase + 28'd1_000_000;
+    wire        us_tick    = (phase_next >= CLK_HZ);
+
+    wire [1:0] reg_sel = mmio_addr[3:2];
+
+    // MMIO ready - combinational response (same cycle)
+    assign mmio_ready = mmio_valid;
+
+    always @(posedge clk) begin
+        if (!resetn) begin
+            phase <= 27'h0;
+            us_count <= 64'h0;
+            us_hi_latch <= 32'h0;
+            us_in_ms <= 10'd0;
+            ms_count <= 32'h0;
+        end else begin
+            if (us_tick) begin
+                phase <= phase_next - CLK_HZ;
+                us_count <= us_count + 1'b1;
+                if (us_in_ms == 10'd999) begin
+                    us_in_ms <= 10'd0;
+                    ms_count <= ms_count + 1'b1;
+                end else begin
+                    us_in_ms <= us_in_ms + 1'b1;
+                end
+            end else begin
+                phase <= phase_next[26:0];
+            end
+
+            // Same cycle as the US_LO read data below
+            if (mmio_valid && !mmio_write && reg_sel == ADDR_US_LO)
+                us_hi_latch <= us_count[63:32];
+        end
+    end
+
+    always @(*) begin
+        case (reg_sel)
+            ADDR_US_LO: mmio_rdata = us_count[31:0];
+            ADDR_US_HI: mmio_rdata = us_hi_latch;
+            ADDR_MS:    mmio_rdata = ms_count;
+            ADDR_INFO:  mmio_rdata = {1'b1, 7'h0, CLK_KHZ};
+            default:    mmio_rdata = 32'h0;
+        endcase
+    end
+
+endmodule
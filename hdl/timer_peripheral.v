@@ -8,6 +8,16 @@
 // NOT FOR COMMERCIAL USE
 // Educational and research purposes only
 //==============================================================================
+// One timer channel. The top level instantiates TIMER_CHANNELS of them
+// (Kconfig): channel 0 at 0x80000020 drives IRQ[0], channels 1-3 at
+// 0x80000160/0x80000180/0x800001A0 share IRQ[7]. lib/timer.h has the map.
+//
+// CCR is a compare register by default (CCIF when the counter reaches
+// CCR) or, with CR.CAPTURE, latches CNT on each capture_in pulse.
+//
+// update_out pulses on every update event (counter reload), whatever the
+// interrupt setup: spi_dma.v's stream mode starts an SPI frame on it.
+//==============================================================================
 
 module timer_peripheral (
     input wire clk,              // System clock (50 MHz)
@@ -22,19 +32,29 @@ module timer_peripheral (
     output reg [31:0] mmio_rdata,
     output wire       mmio_ready,    // Changed to wire for combinational response
 
+    // Capture trigger (single-cycle pulse)
+    input wire        capture_in,
+
     // Interrupt Output
-    output wire       timer_irq
+    output wire       timer_irq,
+
+    // Update event (single-cycle pulse when the counter reloads)
+    output reg        update_out
 );
 
     // =========================================================================
     // Register Map (STM32-style)
     // Base: 0x80000020
     // =========================================================================
-    // +0x00: CR  (Control Register)     - [0]=Enable, [1]=One-shot mode
-    // +0x04: SR  (Status Register)      - [0]=UIF (Update Interrupt Flag)
+    // +0x00: CR  (Control Register)     - [0]=Enable, [1]=One-shot mode,
+    //                                     [4]=CCIE (compare/capture IRQ),
+    //                                     [5]=Capture mode (CCR <= CNT on capture_in)
+    // +0x04: SR  (Status Register)      - [0]=UIF (Update Interrupt Flag),
+    //                                     [1]=CCIF (compare match / capture), W1C
     // +0x08: PSC (Prescaler)            - 16-bit clock divider (0-65535)
     // +0x0C: ARR (Auto-Reload Register) - 32-bit reload value
     // +0x10: CNT (Counter)              - 32-bit current count (read-only)
+    // +0x14: CCR (Compare/Capture)      - Compare value, or last captured CNT
     // =========================================================================
 
     localparam ADDR_CR  = 5'h00;
@@ -42,11 +62,16 @@ module timer_peripheral (
     localparam ADDR_PSC = 5'h08;
     localparam ADDR_ARR = 5'h0C;
     localparam ADDR_CNT = 5'h10;
+    localparam ADDR_CCR = 5'h14;
 
     // Timer Registers
     reg        cr_enable;       // CR[0]: Timer enable
     reg        cr_one_shot;     // CR[1]: One-shot mode (vs continuous)
+    reg        cr_ccie;         // CR[4]: Compare/capture interrupt enable
+    reg        cr_capture;      // CR[5]: Capture mode (vs compare)
     reg        sr_uif;          // SR[0]: Update interrupt flag
+    reg        sr_ccif;         // SR[1]: Compare/capture interrupt flag
+    reg [31:0] ccr_value;       // CCR: Compare value / captured count
     reg [15:0] psc_value;       // PSC: Prescaler value (0-65535)
     reg [31:0] arr_value;       // ARR: Auto-reload value
     reg [31:0] cnt_value;       // CNT: Current counter value
@@ -81,15 +106,19 @@ module timer_peripheral (
     always @(posedge clk) begin
         if (!resetn) begin
             // Reset all registers
-            mmio_rdata <= 32'h00000000;
             psc_counter <= 16'h0000;
             psc_value <= 16'h0000;
             arr_value <= 32'h00000000;
             cnt_value <= 32'h00000000;
             sr_uif <= 1'b0;
+            sr_ccif <= 1'b0;
             cr_enable <= 1'b0;
             cr_one_shot <= 1'b0;
+            cr_ccie <= 1'b0;
+            cr_capture <= 1'b0;
+            ccr_value <= 32'h00000000;
             irq_pulse <= 1'b0;
+            update_out <= 1'b0;
             // synthesis translate_off
             debug_cycle_count = 0;
             debug_mmio_cycles = 0;
@@ -132,16 +161,31 @@ module timer_peripheral (
             // synthesis translate_on
             // Default: Clear IRQ pulse (single-cycle pulse)
             irq_pulse <= 1'b0;
+            update_out <= 1'b0;
+
+            // Input capture
+            if (cr_capture && capture_in) begin
+                ccr_value <= cnt_value;
+                sr_ccif <= 1'b1;
+                if (cr_ccie) irq_pulse <= 1'b1;
+            end
 
             // Timer counting logic - runs EVERY cycle when enabled (independent of MMIO)
             if (cr_enable) begin
                 if (psc_tick) begin
                     psc_counter <= psc_value;  // Reload prescaler
 
+                    // Output compare: counter leaves CCR on this tick
+                    if (!cr_capture && cnt_value == ccr_value) begin
+                        sr_ccif <= 1'b1;
+                        if (cr_ccie) irq_pulse <= 1'b1;
+                    end
+
                     // Counter decrements on prescaler tick
                     if (cnt_value == 32'h00000000) begin
                         // Counter reached zero - generate single-cycle IRQ pulse
                         irq_pulse <= 1'b1;
+                        update_out <= 1'b1;
                         sr_uif <= 1'b1;
                         // synthesis translate_off
                         $display("[%0t] [TIMER_PERIPH] Counter reached 0 - generating IRQ pulse", $time);
@@ -182,6 +226,8 @@ module timer_peripheral (
                         if (mmio_wstrb[0]) begin
                             cr_enable   <= mmio_wdata[0];
                             cr_one_shot <= mmio_wdata[1];
+                            cr_ccie     <= mmio_wdata[4];
+                            cr_capture  <= mmio_wdata[5];
                             // When enabling timer, load counter with ARR
                             if (mmio_wdata[0] && !cr_enable) begin
                                 cnt_value <= arr_value;
@@ -196,9 +242,11 @@ module timer_peripheral (
 
                     ADDR_SR: begin
                         if (mmio_wstrb[0]) begin
-                            // Write 1 to clear interrupt flag
+                            // Write 1 to clear interrupt flags
                             if (mmio_wdata[0])
                                 sr_uif <= 1'b0;
+                            if (mmio_wdata[1])
+                                sr_ccif <= 1'b0;
                         end
                     end
 
@@ -214,22 +262,31 @@ module timer_peripheral (
                         if (mmio_wstrb[3]) arr_value[31:24] <= mmio_wdata[31:24];
                     end
 
-                    // CNT is read-only, writes ignored
-                endcase
-            end
+                    ADDR_CCR: begin
+                        if (mmio_wstrb[0]) ccr_value[7:0]   <= mmio_wdata[7:0];
+                        if (mmio_wstrb[1]) ccr_value[15:8]  <= mmio_wdata[15:8];
+                        if (mmio_wstrb[2]) ccr_value[23:16] <= mmio_wdata[23:16];
+                        if (mmio_wstrb[3]) ccr_value[31:24] <= mmio_wdata[31:24];
+                    end
 
-            // MMIO reads (separate combinational assignment)
-            if (mmio_valid) begin
-                case (mmio_addr[4:0])
-                    ADDR_CR:  mmio_rdata <= {30'h0, cr_one_shot, cr_enable};
-                    ADDR_SR:  mmio_rdata <= {31'h0, sr_uif};
-                    ADDR_PSC: mmio_rdata <= {16'h0000, psc_value};
-                    ADDR_ARR: mmio_rdata <= arr_value;
-                    ADDR_CNT: mmio_rdata <= cnt_value;
-                    default:  mmio_rdata <= 32'h00000000;
+                    // CNT is read-only, writes ignored
+                    default: ;
                 endcase
             end
         end
     end
 
+    // MMIO reads - combinational, valid in the mmio_ready cycle
+    always @(*) begin
+        case (mmio_addr[4:0])
+            ADDR_CR:  mmio_rdata = {26'h0, cr_capture, cr_ccie, 2'b00, cr_one_shot, cr_enable};
+            ADDR_SR:  mmio_rdata = {30'h0, sr_ccif, sr_uif};
+            ADDR_PSC: mmio_rdata = {16'h0000, psc_value};
+            ADDR_ARR: mmio_rdata = arr_value;
+            ADDR_CNT: mmio_rdata = cnt_value;
+            ADDR_CCR: mmio_rdata = ccr_value;
+            default:  mmio_rdata = 32'h00000000;
+        endcase
+    end
+
 endmodule
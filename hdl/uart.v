@@ -10,15 +10,14 @@
 //==============================================================================
 
 module uart #(
-    parameter CLK_FREQ = 100_000_000,  // frequency of system clock in Hertz
-    parameter BAUD_RATE = 115_200,     // data link baud rate in bits/second
-    parameter OS_RATE = 16,            // oversampling rate to find center of receive bits
     parameter D_WIDTH = 8,             // data bus width
     parameter PARITY = 0,              // 0 for no parity, 1 for parity
     parameter PARITY_EO = 1'b0         // 1'b0 for even, 1'b1 for odd parity
 ) (
     input wire clk,                           // system clock
     input wire reset_n,                       // asynchronous reset
+    input wire [23:0] baud_div,               // clocks per oversampling tick, 16.8 fixed point (>= 2.0)
+    input wire [4:0] os_rate,                 // oversampling ticks per bit (4-16)
     input wire tx_ena,                        // initiate transmission
     input wire [D_WIDTH-1:0] tx_data,         // data to transmit
     input wire rx,                            // receive pin
@@ -51,37 +50,40 @@ module uart #(
     reg [PARITY+D_WIDTH+1:0] tx_buffer;
     
     // Counters
-    integer count_baud;
+    reg [23:0] os_acc;
     integer count_os;
     integer rx_count;
     integer os_count;
     integer tx_count;
     
-    // Baud rate and oversampling rate generation
+    // Oversampling and baud rate generation
+    // Fractional divider: os_acc gains 1.0 (256) per clock and sheds baud_div
+    // on every tick, so ticks average baud_div/256 clocks apart (one clock of
+    // jitter, at most 1/os_rate of a bit) and any baud rate is reachable
+    // without the bit time having to be a whole number of clocks. The baud
+    // pulse is every os_rate-th tick, so TX and RX share the same timing.
+    wire [24:0] os_acc_next = os_acc + 25'd256;
+
     always @(posedge clk or negedge reset_n) begin
         if (!reset_n) begin
             baud_pulse <= 1'b0;
             os_pulse <= 1'b0;
-            count_baud <= 0;
+            os_acc <= 24'h0;
             count_os <= 0;
         end else begin
-            // Create baud enable pulse
-            if (count_baud < CLK_FREQ/BAUD_RATE-1) begin
-                count_baud <= count_baud + 1;
-                baud_pulse <= 1'b0;
+            baud_pulse <= 1'b0;
+            if (os_acc_next >= {1'b0, baud_div}) begin
+                os_acc <= os_acc_next - {1'b0, baud_div};
+                os_pulse <= 1'b1;
+                if (count_os < os_rate - 1) begin
+                    count_os <= count_os + 1;
+                end else begin
+                    count_os <= 0;
+                    baud_pulse <= 1'b1;
+                end
             end else begin
-                count_baud <= 0;
-                baud_pulse <= 1'b1;
-                count_os <= 0;  // reset oversampling counter to avoid cumulative error
-            end
-            
-            // Create oversampling enable pulse
-            if (count_os < CLK_FREQ/BAUD_RATE/OS_RATE-1) begin
-                count_os <= count_os + 1;
+                os_acc <= os_acc_next[23:0];
                 os_pulse <= 1'b0;
-            end else begin
-                count_os <= 0;
-                os_pulse <= 1'b1;
             end
         end
     end
@@ -106,7 +108,7 @@ module uart #(
                 RX_IDLE: begin
                     rx_busy <= 1'b0;
                     if (rx == 1'b0) begin  // start bit might be present
-                        if (os_count < OS_RATE/2) begin
+                        if (os_count < os_rate[4:1]) begin
                             os_count <= os_count + 1;
                             rx_state <= RX_IDLE;
                         end else begin
@@ -123,7 +125,7 @@ module uart #(
                 end
                 
                 RX_RECEIVE: begin
-                    if (os_count < OS_RATE-1) begin
+                    if (os_count < os_rate-1) begin
                         os_count <= os_count + 1;
                         rx_state <= RX_RECEIVE;
                     end else if (rx_count < PARITY+D_WIDTH) begin
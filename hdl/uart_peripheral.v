@@ -8,8 +8,47 @@
 // NOT FOR COMMERCIAL USE
 // Educational and research purposes only
 //==============================================================================
+// PURPOSE: UART TX/RX registers at BASE (0x80000000 for UART0).
+//
+// TX goes through a FIFO (circular_buffer in the top level): TX_DATA stores
+// queue one byte, TX_WORD stores queue every enabled byte lane, lane 0
+// first, so a 32-bit store sends four characters. Stores only stall while
+// the FIFO has no room; TX_STATUS reports the free space so firmware can
+// fill it without stalling the bus.
+//
+// Interrupts (CTRL_BASE, 0x80000120-0x8000012F for UART0): RX data available, RX level at the
+// watermark and RX idle timeout (bytes waiting, line quiet) drive irq_rx;
+// TX level at or below the low watermark drives irq_tx. Both are levels:
+// handlers disable the source (or drain/refill the FIFO) before returning.
+//
+// Baud rate (CTRL_BASE + 0x10): the UART core's fractional divider and
+// oversampling rate are registers, so firmware can change the rate at run
+// time (lib/uart_baud.h); CLK_HZ reads the system clock to compute them.
+//
+// RX_STATUS also counts bytes dropped because the RX FIFO was full and
+// bytes received with a bad stop bit (sticky, saturating), so firmware can
+// report lost data instead of silently passing on a corrupted stream.
+//
+// Status and control reads are combinational (ready in the mmio_valid
+// cycle, like timebase.v); mem_controller registers the result, so the
+// read path stays one register deep. RX_DATA reads (FIFO pop) and stores
+// are registered.
+//
+// BASE and CTRL_BASE place an instance: UART0 (SLIP, uploads, loader) at
+// the defaults, the console UART (uart_port.v, Kconfig CONSOLE_UART) at
+// 0x80000230 / 0x80000240. The top level routes irq_rx / irq_tx.
+//==============================================================================
 
-module uart_peripheral (
+module uart_peripheral #(
+    parameter [31:0] BASE      = 32'h80000000,  // TX/RX data and status
+    parameter [31:0] CTRL_BASE = 32'h80000120,  // IRQ, baud and clock
+    parameter TX_FIFO_BITS = 9,             // log2(TX FIFO bytes)
+    parameter RX_FIFO_BITS = 8,             // log2(RX FIFO bytes)
+    parameter IDLE_CYCLES  = 1000,          // Default RX idle timeout
+    parameter CLK_HZ       = 50_000_000,    // System clock, read back by CLK_HZ
+    parameter BAUD_DIV     = 800,           // Reset divider: 1 Mbaud at 50 MHz, OS 16
+    parameter OS_RATE      = 16             // Reset oversampling rate
+) (
     input wire clk,
     input wire resetn,
 
@@ -19,109 +58,271 @@ module uart_peripheral (
     input wire [31:0] mmio_addr,
     input wire [31:0] mmio_wdata,
     input wire [ 3:0] mmio_wstrb,
-    output reg [31:0] mmio_rdata,
-    output reg        mmio_ready,
+    output wire [31:0] mmio_rdata,
+    output wire        mmio_ready,
 
-    // UART TX Interface
+    // UART TX Interface (TX FIFO write side)
     output reg [ 7:0] uart_tx_data,
-    output reg        uart_tx_valid,
-    input wire        uart_tx_busy,
+    output reg        uart_tx_valid,        // Push uart_tx_data
+    input wire        uart_tx_full,
+    input wire [TX_FIFO_BITS:0] uart_tx_level,
+    input wire        uart_tx_busy,         // Character on the wire
+
+    // UART Core Timing
+    output reg [23:0] uart_baud_div,        // Clocks per oversampling tick (16.8)
+    output reg [ 4:0] uart_os_rate,         // Oversampling ticks per bit
 
     // UART RX Interface (circular buffer)
     input wire [ 7:0] uart_rx_data,
     output reg        uart_rx_rd_en,
-    input wire        uart_rx_empty
+    input wire        uart_rx_empty,
+    input wire [RX_FIFO_BITS:0] uart_rx_level,
+    input wire        uart_rx_strobe,       // Byte received from the wire
+    input wire        uart_rx_overflow,     // Byte dropped: RX FIFO full
+    input wire        uart_rx_frame_error,  // Byte received with a bad stop bit
+
+    // Interrupt Outputs (levels)
+    output wire       irq_rx,
+    output wire       irq_tx
 );
 
     // Memory Map
-    localparam ADDR_UART_TX_DATA   = 32'h80000000;
-    localparam ADDR_UART_TX_STATUS = 32'h80000004;
-    localparam ADDR_UART_RX_DATA   = 32'h80000008;
-    localparam ADDR_UART_RX_STATUS = 32'h8000000C;
+    localparam [31:0] ADDR_UART_TX_DATA   = BASE + 32'h00;
+    localparam [31:0] ADDR_UART_TX_STATUS = BASE + 32'h04;      // Read
+    localparam [31:0] ADDR_UART_TX_WORD   = BASE + 32'h04;      // Write
+    localparam [31:0] ADDR_UART_RX_DATA   = BASE + 32'h08;
+    localparam [31:0] ADDR_UART_RX_STATUS = BASE + 32'h0C;
+    localparam [31:0] ADDR_UART_IRQ_EN    = CTRL_BASE + 32'h00;
+    localparam [31:0] ADDR_UART_IRQ_STAT  = CTRL_BASE + 32'h04;
+    localparam [31:0] ADDR_UART_IRQ_LEVEL = CTRL_BASE + 32'h08;
+    localparam [31:0] ADDR_UART_IRQ_IDLE  = CTRL_BASE + 32'h0C;
+    localparam [31:0] ADDR_UART_BAUD      = CTRL_BASE + 32'h10;
+    localparam [31:0] ADDR_UART_CLK_HZ    = CTRL_BASE + 32'h14; // Read only
+
+    // IRQ_EN / IRQ_STAT bits: [0]=RX available, [1]=RX watermark,
+    //                         [2]=RX idle (sticky, write 1 to clear),
+    //                         [3]=TX low watermark
+    // IRQ_STAT also reads [16 +: RX_FIFO_BITS+1]=RX level
+    // IRQ_LEVEL: [RX_FIFO_BITS:0]=RX watermark (RX level >= value),
+    //            [25:16]=TX low watermark (TX level <= value)
+    // IRQ_IDLE: [23:0]=RX idle timeout in clock cycles (0 = off)
+    // BAUD: [23:0]=clocks per oversampling tick, 16.8 fixed point,
+    //       [28:24]=oversampling ticks per bit; baud = CLK_HZ*256/(div*os).
+    //       Written as a whole word; ignored unless div >= 2.0 and os 4-16
+
+    // TX_STATUS: [0]=FIFO full (legacy busy bit: wait before writing)
+    //            [1]=active (bytes queued or a character on the wire)
+    //            [27:16]=free FIFO bytes, [31]=TX FIFO present
+    localparam TX_DEPTH = 1 << TX_FIFO_BITS;
+
+    wire [TX_FIFO_BITS:0] tx_free = TX_DEPTH - uart_tx_level;
+    wire [11:0] tx_free_status = tx_free;
+    wire tx_active = (uart_tx_level != 0) || uart_tx_busy;
+
+    // RX_STATUS: [0]=data available, [1]=overflow seen, [2]=framing error seen
+    //            [19:8]=dropped bytes, [31:20]=framing errors (both saturate)
+    //            Any write clears the flags and counters
+    reg [11:0] rx_ovf_cnt;
+    reg [11:0] rx_frame_cnt;
+    reg        rx_ovf_seen;
+    reg        rx_frame_seen;
+
+    // Interrupt sources
+    reg [ 3:0] irq_en;
+    reg [RX_FIFO_BITS:0] rx_watermark;
+    reg [TX_FIFO_BITS:0] tx_watermark;
+    reg [23:0] idle_timeout;
+    reg [23:0] idle_cnt;
+    reg        rx_idle;
+
+    wire [3:0] irq_stat = {uart_tx_level <= tx_watermark,
+                           rx_idle,
+                           uart_rx_level >= rx_watermark,
+                           !uart_rx_empty};
+
+    assign irq_rx = |(irq_stat[2:0] & irq_en[2:0]);
+    assign irq_tx = irq_stat[3] & irq_en[3];
+
+    // Store being queued, one byte lane per cycle (acked when done)
+    reg        tx_pend;
+    reg [31:0] tx_pend_data;
+    reg [ 3:0] tx_pend_lanes;
+
+    // Fast reads: every register but RX_DATA, ready in the same cycle
+    wire fast_read = mmio_valid && !mmio_write && mmio_addr != ADDR_UART_RX_DATA;
+    reg [31:0] fast_rdata;
+
+    // RX_DATA reads and stores: registered
+    reg [31:0] slow_rdata;
+    reg        slow_ready;
+
+    assign mmio_ready = fast_read || slow_ready;
+    assign mmio_rdata = slow_ready ? slow_rdata : fast_rdata;
+
+    always @(*) begin
+        case (mmio_addr)
+            ADDR_UART_TX_STATUS: fast_rdata = {1'b1, 3'h0, tx_free_status, 14'h0, tx_active, uart_tx_full};
+            ADDR_UART_RX_STATUS: fast_rdata = {rx_frame_cnt, rx_ovf_cnt, 5'h0,
+                                               rx_frame_seen, rx_ovf_seen, ~uart_rx_empty};
+            ADDR_UART_IRQ_EN:    fast_rdata = {28'h0, irq_en};
+            ADDR_UART_IRQ_STAT:  fast_rdata = {{(15 - RX_FIFO_BITS){1'b0}}, uart_rx_level, 12'h0, irq_stat};
+            ADDR_UART_IRQ_LEVEL: fast_rdata = {{(15 - TX_FIFO_BITS){1'b0}}, tx_watermark,
+                                               {(15 - RX_FIFO_BITS){1'b0}}, rx_watermark};
+            ADDR_UART_IRQ_IDLE:  fast_rdata = {8'h0, idle_timeout};
+            ADDR_UART_BAUD:      fast_rdata = {3'h0, uart_os_rate, uart_baud_div};
+            ADDR_UART_CLK_HZ:    fast_rdata = CLK_HZ;
+            default:             fast_rdata = 32'h0;    // Invalid register
+        endcase
+    end
 
     always @(posedge clk) begin
         if (!resetn) begin
-            mmio_rdata <= 32'h0;
-            mmio_ready <= 1'b0;
+            slow_rdata <= 32'h0;
+            slow_ready <= 1'b0;
             uart_tx_data <= 8'h0;
             uart_tx_valid <= 1'b0;
             uart_rx_rd_en <= 1'b0;
+            tx_pend <= 1'b0;
+            tx_pend_data <= 32'h0;
+            tx_pend_lanes <= 4'h0;
+            irq_en <= 4'h0;
+            rx_watermark <= 1 << (RX_FIFO_BITS - 1);
+            tx_watermark <= 1 << (TX_FIFO_BITS - 2);
+            idle_timeout <= IDLE_CYCLES;
+            uart_baud_div <= BAUD_DIV;
+            uart_os_rate <= OS_RATE;
+            idle_cnt <= 24'h0;
+            rx_idle <= 1'b0;
+            rx_ovf_cnt <= 12'h0;
+            rx_frame_cnt <= 12'h0;
+            rx_ovf_seen <= 1'b0;
+            rx_frame_seen <= 1'b0;
         end else begin
             // Default: clear control signals
-            mmio_ready <= 1'b0;
+            slow_ready <= 1'b0;
             uart_tx_valid <= 1'b0;
             uart_rx_rd_en <= 1'b0;
 
-            if (mmio_valid && !mmio_ready) begin
+            // RX idle: bytes waiting and nothing received for idle_timeout
+            if (uart_rx_strobe || uart_rx_empty || rx_idle || idle_timeout == 24'h0) begin
+                idle_cnt <= 24'h0;
+            end else if (idle_cnt == idle_timeout - 1'b1) begin
+                rx_idle <= 1'b1;
+            end else begin
+                idle_cnt <= idle_cnt + 1'b1;
+            end
+
+            // RX error counters
+            if (uart_rx_overflow) begin
+                rx_ovf_seen <= 1'b1;
+                if (rx_ovf_cnt != 12'hFFF) rx_ovf_cnt <= rx_ovf_cnt + 1'b1;
+            end
+            if (uart_rx_frame_error) begin
+                rx_frame_seen <= 1'b1;
+                if (rx_frame_cnt != 12'hFFF) rx_frame_cnt <= rx_frame_cnt + 1'b1;
+            end
+
+            // Queue the pending store; a full FIFO holds the lane back
+            if (tx_pend) begin
+                if (tx_pend_lanes == 4'h0) begin
+                    tx_pend <= 1'b0;
+                    slow_ready <= 1'b1;
+                end else if (!tx_pend_lanes[0] || !uart_tx_full) begin
+                    uart_tx_data <= tx_pend_data[7:0];
+                    uart_tx_valid <= tx_pend_lanes[0];
+                    tx_pend_data <= {8'h0, tx_pend_data[31:8]};
+                    tx_pend_lanes <= {1'b0, tx_pend_lanes[3:1]};
+                end
+            end
+
+            if (mmio_valid && !slow_ready) begin
                 if (mmio_write) begin
                     // ============ WRITE OPERATIONS ============
                     case (mmio_addr)
                         ADDR_UART_TX_DATA: begin
-                            // Write to UART TX
-                            if (!uart_tx_busy) begin
-                                uart_tx_data <= mmio_wdata[7:0];
-                                uart_tx_valid <= 1'b1;
-                                mmio_ready <= 1'b1;
-
-                                // synthesis translate_off
-                                $display("[UART] TX: 0x%02x ('%c')",
-                                         mmio_wdata[7:0],
-                                         (mmio_wdata[7:0] >= 32 && mmio_wdata[7:0] < 127) ? mmio_wdata[7:0] : 8'h2E);
-                                // synthesis translate_on
-                            end
-                            // If busy, don't ack - CPU must retry
+                            // Queue one byte (acked once it is in the FIFO)
+                            tx_pend <= 1'b1;
+                            tx_pend_data <= {24'h0, mmio_wdata[7:0]};
+                            tx_pend_lanes <= 4'b0001;
+
+                            // synthesis translate_off
+                            $display("[UART] TX: 0x%02x ('%c')",
+                                     mmio_wdata[7:0],
+                                     (mmio_wdata[7:0] >= 32 && mmio_wdata[7:0] < 127) ? mmio_wdata[7:0] : 8'h2E);
+                            // synthesis translate_on
                         end
 
-                        default: begin
-                            // Write to invalid register - ignore
-                            mmio_ready <= 1'b1;
+                        ADDR_UART_TX_WORD: begin
+                            // Queue every enabled byte lane, lane 0 first
+                            tx_pend <= 1'b1;
+                            tx_pend_data <= mmio_wdata;
+                            tx_pend_lanes <= mmio_wstrb;
                         end
-                    endcase
 
-                end else begin
-                    // ============ READ OPERATIONS ============
-                    case (mmio_addr)
-                        ADDR_UART_TX_STATUS: begin
-                            // Read UART TX status
-                            mmio_rdata <= {31'h0, uart_tx_busy};
-                            mmio_ready <= 1'b1;
+                        ADDR_UART_RX_STATUS: begin
+                            // Clear the error flags and counters
+                            rx_ovf_cnt <= 12'h0;
+                            rx_frame_cnt <= 12'h0;
+                            rx_ovf_seen <= 1'b0;
+                            rx_frame_seen <= 1'b0;
+                            slow_ready <= 1'b1;
                         end
 
-                        ADDR_UART_RX_DATA: begin
-                            // Read from UART RX buffer
-                            if (!uart_rx_empty) begin
-                                mmio_rdata <= {24'h0, uart_rx_data};
-                                uart_rx_rd_en <= 1'b1;  // Advance buffer pointer
-                                mmio_ready <= 1'b1;
-
-                                // synthesis translate_off
-                                $display("[UART] RX: 0x%02x ('%c')",
-                                         uart_rx_data,
-                                         (uart_rx_data >= 32 && uart_rx_data < 127) ? uart_rx_data : 8'h2E);
-                                // synthesis translate_on
-                            end else begin
-                                // Buffer empty - return 0
-                                mmio_rdata <= 32'h0;
-                                mmio_ready <= 1'b1;
+                        ADDR_UART_IRQ_EN: begin
+                            if (mmio_wstrb[0]) irq_en <= mmio_wdata[3:0];
+                            slow_ready <= 1'b1;
+                        end
+
+                        ADDR_UART_IRQ_STAT: begin
+                            if (mmio_wstrb[0] && mmio_wdata[2]) rx_idle <= 1'b0;
+                            slow_ready <= 1'b1;
+                        end
+
+                        ADDR_UART_IRQ_LEVEL: begin
+                            if (mmio_wstrb == 4'hF) begin
+                                rx_watermark <= mmio_wdata[RX_FIFO_BITS:0];
+                                tx_watermark <= mmio_wdata[16 +: TX_FIFO_BITS + 1];
                             end
+                            slow_ready <= 1'b1;
                         end
 
-                        ADDR_UART_RX_STATUS: begin
-                            // Read UART RX status
-                            mmio_rdata <= {31'h0, ~uart_rx_empty};
-                            mmio_ready <= 1'b1;
+                        ADDR_UART_IRQ_IDLE: begin
+                            if (mmio_wstrb == 4'hF) idle_timeout <= mmio_wdata[23:0];
+                            slow_ready <= 1'b1;
+                        end
 
-                            // synthesis translate_off
-                            $display("[UART] RX STATUS: empty=%b, returning %b", uart_rx_empty, ~uart_rx_empty);
-                            // synthesis translate_on
+                        ADDR_UART_BAUD: begin
+                            if (mmio_wstrb == 4'hF && mmio_wdata[23:0] >= 24'd512 &&
+                                mmio_wdata[28:24] >= 5'd4 && mmio_wdata[28:24] <= 5'd16) begin
+                                uart_baud_div <= mmio_wdata[23:0];
+                                uart_os_rate <= mmio_wdata[28:24];
+                            end
+                            slow_ready <= 1'b1;
                         end
 
                         default: begin
-                            // Read from invalid register - return 0
-                            mmio_rdata <= 32'h0;
-                            mmio_ready <= 1'b1;
+                            // Write to invalid register - ignore
+                            slow_ready <= 1'b1;
                         end
                     endcase
+
+                end else if (mmio_addr == ADDR_UART_RX_DATA) begin
+                    // ============ READ OPERATIONS ============
+                    // Read from UART RX buffer (other reads: fast_rdata)
+                    if (!uart_rx_empty) begin
+                        slow_rdata <= {24'h0, uart_rx_data};
+                        uart_rx_rd_en <= 1'b1;  // Advance buffer pointer
+
+                        // synthesis translate_off
+                        $display("[UART] RX: 0x%02x ('%c')",
+                                 uart_rx_data,
+                                 (uart_rx_data >= 32 && uart_rx_data < 127) ? uart_rx_data : 8'h2E);
+                        // synthesis translate_on
+                    end else begin
+                        // Buffer empty - return 0
+                        slow_rdata <= 32'h0;
+                    end
+                    slow_ready <= 1'b1;
                 end
             end
         end
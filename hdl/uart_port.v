@@ -0,0 +1,172 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// uart_port.v - Self-Contained UART (core, FIFOs and MMIO registers)
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+// PURPOSE: A UART with nothing else on its line: uart.v, a TX and an RX
+//          circular_buffer and uart_peripheral.v, wired the way the top
+//          level wires UART0 minus the SLIP codec and the hardware loader.
+//          Used for the console UART (Kconfig CONSOLE_UART), so printf
+//          output never lands inside a SLIP frame or an upload.
+//
+// Same register layout as UART0 at BASE / CTRL_BASE, so the firmware
+// drivers take a base address (lib/uart_port.h). irq_rx / irq_tx are
+// the same level outputs; the top level decides which IRQ they drive.
+//==============================================================================
+
+module uart_port #(
+    parameter [31:0] BASE      = 32'h80000230,
+    parameter [31:0] CTRL_BASE = 32'h80000240,
+    parameter TX_FIFO_BITS = 8,             // log2(TX FIFO bytes)
+    parameter RX_FIFO_BITS = 8,             // log2(RX FIFO bytes)
+    parameter IDLE_CYCLES  = 1000,          // Reset RX idle timeout
+    parameter CLK_HZ       = 50_000_000,
+    parameter BAUD_DIV     = 800,           // Reset divider (16.8)
+    parameter OS_RATE      = 16             // Reset oversampling rate
+) (
+    input wire clk,
+    input wire resetn,
+
+    // MMIO Interface
+    input wire        mmio_valid,
+    input wire        mmio_write,
+    input wire [31:0] mmio_addr,
+    input wire [31:0] mmio_wdata,
+    input wire [ 3:0] mmio_wstrb,
+    output wire [31:0] mmio_rdata,
+    output wire       mmio_ready,
+
+    // Pins
+    input wire        rx,
+    output wire       tx,
+
+    // Interrupt Outputs (levels)
+    output wire       irq_rx,
+    output wire       irq_tx
+);
+
+    // UART core
+    wire [23:0] baud_div;
+    wire [ 4:0] os_rate;
+    wire [ 7:0] rx_data;
+    wire        rx_data_valid;
+    wire        rx_busy, rx_error;
+    wire        tx_busy;
+
+    // TX FIFO: MMIO stores push, the core drains it
+    wire [ 7:0] txq_wr_data;
+    wire        txq_wr_en;
+    wire [ 7:0] txq_rd_data;
+    wire        txq_full, txq_empty;
+    wire [TX_FIFO_BITS:0] txq_level;
+    reg         txq_settled;            // Head byte valid (read lags a cycle)
+    wire        txq_start = txq_settled && !txq_empty && !tx_busy;
+
+    always @(posedge clk) begin
+        if (!resetn)
+            txq_settled <= 1'b0;
+        else
+            txq_settled <= !txq_empty && !txq_start;
+    end
+
+    uart #(
+        .D_WIDTH(8),
+        .PARITY(0),
+        .PARITY_EO(1'b0)
+    ) core (
+        .clk(clk),
+        .reset_n(resetn),
+        .baud_div(baud_div),
+        .os_rate(os_rate),
+        .tx_ena(txq_start),
+        .tx_data(txq_rd_data),
+        .rx(rx),
+        .rx_busy(rx_busy),
+        .rx_error(rx_error),
+        .rx_data(rx_data),
+        .rx_data_valid(rx_data_valid),
+        .tx_busy(tx_busy),
+        .tx(tx)
+    );
+
+    circular_buffer #(
+        .DATA_WIDTH(8),
+        .ADDR_BITS(TX_FIFO_BITS)
+    ) tx_fifo (
+        .clk(clk),
+        .reset_n(resetn),
+        .clear(1'b0),
+        .wr_en(txq_wr_en),
+        .wr_data(txq_wr_data),
+        .full(txq_full),
+        .rd_en(txq_start),
+        .rd_data(txq_rd_data),
+        .empty(txq_empty),
+        .level(txq_level)
+    );
+
+    // RX FIFO
+    wire        rxq_rd_en;
+    wire [ 7:0] rxq_rd_data;
+    wire        rxq_full, rxq_empty;
+    wire [RX_FIFO_BITS:0] rxq_level;
+
+    circular_buffer #(
+        .DATA_WIDTH(8),
+        .ADDR_BITS(RX_FIFO_BITS)
+    ) rx_fifo (
+        .clk(clk),
+        .reset_n(resetn),
+        .clear(1'b0),
+        .wr_en(rx_data_valid && !rxq_full),
+        .wr_data(rx_data),
+        .full(rxq_full),
+        .rd_en(rxq_rd_en),
+        .rd_data(rxq_rd_data),
+        .empty(rxq_empty),
+        .level(rxq_level)
+    );
+
+    uart_peripheral #(
+        .BASE(BASE),
+        .CTRL_BASE(CTRL_BASE),
+        .TX_FIFO_BITS(TX_FIFO_BITS),
+        .RX_FIFO_BITS(RX_FIFO_BITS),
+        .IDLE_CYCLES(IDLE_CYCLES),
+        .CLK_HZ(CLK_HZ),
+        .BAUD_DIV(BAUD_DIV),
+        .OS_RATE(OS_RATE)
+    ) regs (
+        .clk(clk),
+        .resetn(resetn),
+        .mmio_valid(mmio_valid),
+        .mmio_write(mmio_write),
+        .mmio_addr(mmio_addr),
+        .mmio_wdata(mmio_wdata),
+        .mmio_wstrb(mmio_wstrb),
+        .mmio_rdata(mmio_rdata),
+        .mmio_ready(mmio_ready),
+        .uart_tx_data(txq_wr_data),
+        .uart_tx_valid(txq_wr_en),
+        .uart_tx_full(txq_full),
+        .uart_tx_level(txq_level),
+        .uart_tx_busy(tx_busy),
+        .uart_baud_div(baud_div),
+        .uart_os_rate(os_rate),
+        .uart_rx_data(rxq_rd_data),
+        .uart_rx_rd_en(rxq_rd_en),
+        .uart_rx_empty(rxq_empty),
+        .uart_rx_level(rxq_level),
+        .uart_rx_strobe(rx_data_valid),
+        .uart_rx_overflow(rx_data_valid && rxq_full),
+        .uart_rx_frame_error(rx_data_valid && rx_error),
+        .irq_rx(irq_rx),
+        .irq_tx(irq_tx)
+    );
+
+endmodule
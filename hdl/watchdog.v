@@ -0,0 +1,186 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// watchdog.v - Hardware Watchdog with Pre-Timeout IRQ and Reset Cause
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+// PURPOSE: A watchdog that owns its own microsecond counter, so crash
+//          protection no longer borrows a general-purpose timer channel
+//          (lib/watchdog.h).
+//
+// Once enabled the counter runs down from TIMEOUT microseconds; a kick
+// (KICK_KEY written to KICK) reloads it. PRETIME microseconds before expiry
+// STATUS.PRE is set and, with CTRL.PRE_IRQ, drives the irq output (shared
+// with the timers on IRQ[7]) so firmware can take a crash dump while the CPU
+// still answers. At zero STATUS.EXPIRED is set, the watchdog disables itself
+// and, with CTRL.RESET, pulses cpu_reset for 16 clocks.
+//
+// The block is reset by the global reset only: STATUS, RESET_CAUSE and the
+// watchdog reset count survive the CPU resets it causes. The hardware loader
+// holding the CPU (loader_hold) also disables it, so a running countdown
+// cannot reset the CPU in the middle of an upload.
+//==============================================================================
+
+module watchdog #(
+    parameter CLK_HZ = 50_000_000
+) (
+    input wire clk,
+    input wire resetn,              // Global reset (not the CPU reset)
+
+    // MMIO Interface
+    input wire        mmio_valid,
+    input wire        mmio_write,
+    input wire [31:0] mmio_addr,
+    input wire [31:0] mmio_wdata,
+    input wire [ 3:0] mmio_wstrb,
+    output reg [31:0] mmio_rdata,
+    output wire       mmio_ready,
+
+    input wire        loader_hold,  // Hardware loader owns the CPU
+    output wire       irq,          // Pre-timeout (level until cleared)
+    output wire       cpu_reset     // Active high: hold the CPU in reset
+);
+
+    // =========================================================================
+    // Register Map
+    // Base: 0x80000200
+    // =========================================================================
+    // +0x00: CTRL    (RW) - [0]=EN, [1]=PRE_IRQ, [2]=RESET, [3]=LOCK
+    //                       LOCK ignores CTRL/TIMEOUT/PRETIME writes until
+    //                       the watchdog fires or the loader takes the CPU
+    // +0x04: TIMEOUT (RW) - Microseconds from a kick to expiry
+    // +0x08: PRETIME (RW) - Pre-timeout this many microseconds before expiry
+    // +0x0C: KICK    (RW) - Write KICK_KEY to reload; read = microseconds left
+    // +0x10: STATUS  (RW) - [0]=PRE, [1]=EXPIRED (write 1 to clear)
+    // +0x14: CAUSE   (R)  - [1:0]=last CPU reset (0=power-on, 1=watchdog,
+    //                       2=hardware loader), [15:8]=watchdog resets since
+    //                       power-on, [31]=present
+    // =========================================================================
+
+    localparam ADDR_CTRL    = 3'h0;
+    localparam ADDR_TIMEOUT = 3'h1;
+    localparam ADDR_PRETIME = 3'h2;
+    localparam ADDR_KICK    = 3'h3;
+    localparam ADDR_STATUS  = 3'h4;
+    localparam ADDR_CAUSE   = 3'h5;
+
+    localparam [15:0] KICK_KEY = 16'h5AFE;
+
+    localparam [1:0] CAUSE_POWER_ON = 2'd0;
+    localparam [1:0] CAUSE_WATCHDOG = 2'd1;
+    localparam [1:0] CAUSE_LOADER   = 2'd2;
+
+    reg        en, pre_irq_en, reset_en, lock;
+    reg [31:0] timeout, pretime, left;
+    reg        pre, expired, pre_armed;
+    reg [ 1:0] cause;
+    reg [ 7:0] wdt_resets;
+    reg [ 4:0] reset_pulse;         // [4] set while the pulse runs
+
+    reg [26:0] phase;               // Fractional microsecond (units of 1/CLK_HZ s)
+
+    wire [27:0] phase_next = phase + 28'd1_000_000;
+    wire        us_tick    = (phase_next >= CLK_HZ);
+
+    wire [2:0] reg_sel = mmio_addr[4:2];
+    wire       wr      = mmio_valid && mmio_write && (mmio_wstrb == 4'hF);
+    wire       cfg_wr  = wr && !lock;
+    wire       kick    = wr && reg_sel == ADDR_KICK && mmio_wdata[15:0] == KICK_KEY;
+
+    // MMIO ready - combinational response (same cycle)
+    assign mmio_ready = mmio_valid;
+
+    assign irq       = pre && pre_irq_en;
+    assign cpu_reset = reset_pulse[4];
+
+    always @(posedge clk) begin
+        if (!resetn) begin
+            en <= 1'b0;
+            pre_irq_en <= 1'b0;
+            reset_en <= 1'b0;
+            lock <= 1'b0;
+            timeout <= 32'd1_000_000;
+            pretime <= 32'd0;
+            left <= 32'd0;
+            pre <= 1'b0;
+            expired <= 1'b0;
+            pre_armed <= 1'b0;
+            cause <= CAUSE_POWER_ON;
+            wdt_resets <= 8'd0;
+            reset_pulse <= 5'd0;
+            phase <= 27'h0;
+        end else begin
+            phase <= us_tick ? phase_next - CLK_HZ : phase_next[26:0];
+
+            if (reset_pulse[4])
+                reset_pulse <= reset_pulse + 1'b1;  // 16 clocks, wraps to 0
+
+            if (loader_hold) begin
+                en <= 1'b0;
+                lock <= 1'b0;
+                cause <= CAUSE_LOADER;
+            end else if (en) begin
+                if (left == 32'd0) begin
+                    expired <= 1'b1;
+                    en <= 1'b0;
+                    lock <= 1'b0;
+                    if (reset_en) begin
+                        reset_pulse <= 5'h10;
+                        cause <= CAUSE_WATCHDOG;
+                        wdt_resets <= wdt_resets + 1'b1;
+                    end
+                end else begin
+                    if (us_tick)
+                        left <= left - 1'b1;
+                    if (pre_armed && left <= pretime) begin
+                        pre <= 1'b1;
+                        pre_armed <= 1'b0;
+                    end
+                end
+            end
+
+            // Register writes (after the countdown, so a kick wins)
+            if (!loader_hold) begin
+                if (cfg_wr && reg_sel == ADDR_CTRL) begin
+                    en <= mmio_wdata[0];
+                    pre_irq_en <= mmio_wdata[1];
+                    reset_en <= mmio_wdata[2];
+                    lock <= mmio_wdata[3];
+                    if (mmio_wdata[0] && !en) begin
+                        left <= timeout;
+                        pre_armed <= 1'b1;
+                    end
+                end
+                if (cfg_wr && reg_sel == ADDR_TIMEOUT)
+                    timeout <= mmio_wdata;
+                if (cfg_wr && reg_sel == ADDR_PRETIME)
+                    pretime <= mmio_wdata;
+                if (kick && en) begin
+                    left <= timeout;
+                    pre_armed <= 1'b1;
+                end
+            end
+            if (wr && reg_sel == ADDR_STATUS) begin
+                if (mmio_wdata[0]) pre <= 1'b0;
+                if (mmio_wdata[1]) expired <= 1'b0;
+            end
+        end
+    end
+
+    always @(*) begin
+        case (reg_sel)
+            ADDR_CTRL:    mmio_rdata = {28'h0, lock, reset_en, pre_irq_en, en};
+            ADDR_TIMEOUT: mmio_rdata = timeout;
+            ADDR_PRETIME: mmio_rdata = pretime;
+            ADDR_KICK:    mmio_rdata = left;
+            ADDR_STATUS:  mmio_rdata = {30'h0, expired, pre};
+            ADDR_CAUSE:   mmio_rdata = {1'b1, 15'h0, wdt_resets, 6'h0, cause};
+            default:      mmio_rdata = 32'h0;
+        endcase
+    end
+
+endmodule
@@ -0,0 +1,213 @@
+//===============================================================================
+// Atomic Operations for PicoRV32 (no A extension)
+// IRQ-masked sections, atomic RAM words, and hdl/atomic_unit.v at 0x80000300
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// There is one hart and interrupts do not nest, so the only thing that can
+// get between a load and the store that depends on it is an interrupt (and,
+// under FreeRTOS, the task switch it may cause). Two ways to keep it out:
+//
+// Masked sections - maskirq around the few instructions of the update.
+// Nest, work in ISRs (where IRQs are already off) and in tasks, and are
+// compiler barriers; this is what FreeRTOS critical sections, lwIP's
+// SYS_ARCH_PROTECT, lib/softirq, lib/coop, lib/mem_pool and the printf
+// log ring use:
+//
+//   uint32_t irq = atomic_irq_save();
+//   ... a handful of instructions ...
+//   atomic_irq_restore(irq);
+//
+//   atomic_fetch_add(&counter, 1);             // RAM words, masked inside
+//   if (atomic_cas(&owner, 0, me)) { ... }
+//
+// Aligned 32-bit loads and stores are single bus transactions already:
+// atomic_load() / atomic_store() only keep the compiler from splitting,
+// merging or moving them. A single-producer/single-consumer ring (ISR in,
+// task out) needs nothing more.
+//
+// Atomic words (Kconfig ATOMIC_UNIT) - eight words in hardware whose
+// read-modify-write happens inside one MMIO access, with no masking at all,
+// for locks, counters and event bits shared between ISRs and tasks:
+//
+//   if (atomic_hw_present()) {
+//       atomic_hw_set_bits(EV_WORD, EV_DMA_DONE);      // ISR
+//       uint32_t ev = atomic_hw_take_bits(EV_WORD);    // Task: fetch-and-clear
+//   }
+//
+// atomic_hw_trylock() is a try-lock only: on one hart an ISR that spins on
+// a lock held by the code it interrupted never gets it back.
+//
+//===============================================================================
+
+#ifndef ATOMIC_H
+#define ATOMIC_H
+
+#include <stdint.h>
+
+#define ATOMIC_BASE         0x80000300
+#define ATOMIC_HW_WORDS     8
+
+// One window per operation, word n at +4n (hdl/atomic_unit.v)
+#define ATOMIC_REG(op, n)   (*(volatile uint32_t*)(ATOMIC_BASE + (op) + 4 * (n)))
+#define ATOMIC_WORD(n)      ATOMIC_REG(0x00, n)     // RW: value
+#define ATOMIC_TAS(n)       ATOMIC_REG(0x20, n)     // R: old, value = 1
+#define ATOMIC_INC(n)       ATOMIC_REG(0x40, n)     // R: old, value + 1
+#define ATOMIC_DEC(n)       ATOMIC_REG(0x60, n)     // R: old, value - 1
+#define ATOMIC_ADD(n)       ATOMIC_REG(0x80, n)     // W: value + wdata
+#define ATOMIC_BITS(n)      ATOMIC_REG(0xA0, n)     // R: old, value = 0; W: value | wdata
+#define ATOMIC_CLR(n)       ATOMIC_REG(0xC0, n)     // W: value & ~wdata
+#define ATOMIC_ID           (*(volatile uint32_t*)(ATOMIC_BASE + 0xE0))
+
+#define ATOMIC_ID_PRESENT   (1u << 31)
+
+//===============================================================================
+// Masked sections
+//===============================================================================
+
+#define atomic_barrier()    __asm__ volatile ("" : : : "memory")
+
+// Mask every IRQ; returns the previous mask for atomic_irq_restore()
+static inline uint32_t atomic_irq_save(void) {
+    uint32_t old;
+    __asm__ volatile (".insn r 0x0B, 6, 3, %0, %1, x0" : "=r"(old) : "r"(~0u) : "memory");
+    return old;
+}
+
+static inline void atomic_irq_restore(uint32_t old) {
+    uint32_t dummy;
+    __asm__ volatile (".insn r 0x0B, 6, 3, %0, %1, x0" : "=r"(dummy) : "r"(old) : "memory");
+    (void)dummy;
+}
+
+//===============================================================================
+// RAM words
+//===============================================================================
+
+static inline uint32_t atomic_load(const volatile uint32_t *p) {
+    uint32_t v;
+
+    atomic_barrier();
+    v = *p;
+    atomic_barrier();
+    return v;
+}
+
+static inline void atomic_store(volatile uint32_t *p, uint32_t v) {
+    atomic_barrier();
+    *p = v;
+    atomic_barrier();
+}
+
+// Read-modify-write: the value before the change
+static inline uint32_t atomic_fetch_add(volatile uint32_t *p, uint32_t v) {
+    uint32_t irq = atomic_irq_save();
+    uint32_t old = *p;
+
+    *p = old + v;
+    atomic_irq_restore(irq);
+    return old;
+}
+
+static inline uint32_t atomic_fetch_sub(volatile uint32_t *p, uint32_t v) {
+    return atomic_fetch_add(p, -v);
+}
+
+static inline uint32_t atomic_fetch_or(volatile uint32_t *p, uint32_t v) {
+    uint32_t irq = atomic_irq_save();
+    uint32_t old = *p;
+
+    *p = old | v;
+    atomic_irq_restore(irq);
+    return old;
+}
+
+static inline uint32_t atomic_fetch_and(volatile uint32_t *p, uint32_t v) {
+    uint32_t irq = atomic_irq_save();
+    uint32_t old = *p;
+
+    *p = old & v;
+    atomic_irq_restore(irq);
+    return old;
+}
+
+static inline uint32_t atomic_swap(volatile uint32_t *p, uint32_t v) {
+    uint32_t irq = atomic_irq_save();
+    uint32_t old = *p;
+
+    *p = v;
+    atomic_irq_restore(irq);
+    return old;
+}
+
+// Store desired if *p is expected; 1 if it did
+static inline int atomic_cas(volatile uint32_t *p, uint32_t expected, uint32_t desired) {
+    uint32_t irq = atomic_irq_save();
+    int ok = (*p == expected);
+
+    if (ok) {
+        *p = desired;
+    }
+    atomic_irq_restore(irq);
+    return ok;
+}
+
+//===============================================================================
+// Atomic words (hdl/atomic_unit.v)
+//===============================================================================
+
+static inline int atomic_hw_present(void) {
+    // Unmapped MMIO reads return 0
+    return (ATOMIC_ID & ATOMIC_ID_PRESENT) != 0;
+}
+
+static inline uint32_t atomic_hw_load(uint32_t n) {
+    return ATOMIC_WORD(n);
+}
+
+static inline void atomic_hw_store(uint32_t n, uint32_t v) {
+    ATOMIC_WORD(n) = v;
+}
+
+// 1 if the lock was free and is now taken
+static inline int atomic_hw_trylock(uint32_t n) {
+    int got = ATOMIC_TAS(n) == 0;
+
+    atomic_barrier();
+    return got;
+}
+
+static inline void atomic_hw_unlock(uint32_t n) {
+    atomic_barrier();
+    ATOMIC_TAS(n) = 0;
+}
+
+// The value before the change
+static inline uint32_t atomic_hw_inc(uint32_t n) {
+    return ATOMIC_INC(n);
+}
+
+static inline uint32_t atomic_hw_dec(uint32_t n) {
+    return ATOMIC_DEC(n);
+}
+
+static inline void atomic_hw_add(uint32_t n, uint32_t v) {
+    ATOMIC_ADD(n) = v;
+}
+
+static inline void atomic_hw_set_bits(uint32_t n, uint32_t bits) {
+    ATOMIC_BITS(n) = bits;
+}
+
+static inline void atomic_hw_clear_bits(uint32_t n, uint32_t bits) {
+    ATOMIC_CLR(n) = bits;
+}
+
+// Every bit set so far, cleared in the same access
+static inline uint32_t atomic_hw_take_bits(uint32_t n) {
+    return ATOMIC_BITS(n);
+}
+
+#endif // ATOMIC_H
@@ -0,0 +1,179 @@
+//===============================================================================
+// Binary Deferred-Format Logging - Implementation
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+
+#include <stdarg.h>
+#include "binlog.h"
+#include "../atomic.h"
+#include "../irq.h"
+#include "../timer.h"
+#include "../uart_irq.h"
+#include "../perf_counters.h"
+
+#define UART_TX_DATA        (*(volatile uint32_t*)0x80000000)
+#define UART_TX_STATUS      (*(volatile uint32_t*)0x80000004)
+#define UART_TX_WORD        (*(volatile uint32_t*)0x80000004)  // Write: all byte lanes
+
+#define UART_TX_FIFO        (1u << 31)                  // TX FIFO and TX_WORD present
+#define UART_TX_FREE(s)     (((s) >> 16) & 0xFFF)       // Free TX FIFO bytes
+
+#define RING_MASK           (BINLOG_RING_WORDS - 1)
+
+// TX FIFO level (of 512 bytes) at which the interrupt refills it
+#define BINLOG_TX_LOW       128
+
+#if (BINLOG_RING_WORDS & RING_MASK) != 0
+#error "BINLOG_RING_WORDS must be a power of two"
+#endif
+
+// Free-running word indices: head written under the mask, tail by the drain
+static uint32_t s_ring[BINLOG_RING_WORDS];
+static volatile uint32_t s_head;
+static volatile uint32_t s_tail;
+static uint32_t s_lost;                 // Not reported yet
+static uint32_t s_irq_mode;
+
+static binlog_stats_t s_stats;
+
+static inline uint32_t binlog_header(uint32_t id, uint32_t flags, uint32_t nargs) {
+    return BINLOG_SYNC | ((flags | nargs) << 8) | (id << 16);
+}
+
+void binlog_write(const char *fmt, uint32_t nargs, ...) {
+    uint32_t args[BINLOG_MAX_ARGS];
+    uint32_t flags = 0;
+    uint32_t irq, ts, need, used, h;
+    va_list ap;
+
+    va_start(ap, nargs);
+    for (uint32_t i = 0; i < nargs; i++) {
+        args[i] = va_arg(ap, uint32_t);
+    }
+    va_end(ap);
+
+    if (!timebase_present()) {
+        flags = BINLOG_FLAG_CYCLES;
+    }
+
+    irq = atomic_irq_save();
+    ts = flags ? rdcycle() : timebase_us32();   // In ring order
+    h = s_head;
+    used = h - s_tail;
+    need = 2 + nargs + (s_lost ? 3 : 0);
+
+    if (BINLOG_RING_WORDS - used < need) {
+        s_lost++;
+        s_stats.dropped++;
+        atomic_irq_restore(irq);
+        return;
+    }
+
+    if (s_lost) {
+        s_ring[h++ & RING_MASK] = binlog_header(BINLOG_ID_DROPPED, flags, 1);
+        s_ring[h++ & RING_MASK] = ts;
+        s_ring[h++ & RING_MASK] = s_lost;
+        s_lost = 0;
+    }
+    // The section sits at address 0: the pointer is the offset
+    s_ring[h++ & RING_MASK] = binlog_header((uint32_t)fmt, flags, nargs);
+    s_ring[h++ & RING_MASK] = ts;
+    for (uint32_t i = 0; i < nargs; i++) {
+        s_ring[h++ & RING_MASK] = args[i];
+    }
+    s_head = h;
+
+    s_stats.records++;
+    if (h - s_tail > s_stats.max_words) {
+        s_stats.max_words = h - s_tail;
+    }
+    if (s_irq_mode) {
+        uart_irq_enable(UART_IRQ_TX_LOW);
+    }
+    atomic_irq_restore(irq);
+}
+
+// One record from the ring into the UART, masked so nothing else written
+// to the UART lands inside it. 0 if the ring is empty or the FIFO short.
+static int binlog_send_record(void) {
+    uint32_t irq = atomic_irq_save();
+    uint32_t t = s_tail;
+    uint32_t status, words;
+
+    if (t == s_head) {
+        atomic_irq_restore(irq);
+        return 0;
+    }
+    words = 2 + ((s_ring[t & RING_MASK] >> 8) & 0x0F);
+
+    status = UART_TX_STATUS;
+    if (status & UART_TX_FIFO) {
+        if (UART_TX_FREE(status) < words * 4) {
+            atomic_irq_restore(irq);
+            return 0;
+        }
+        for (uint32_t i = 0; i < words; i++) {
+            UART_TX_WORD = s_ring[t++ & RING_MASK];
+        }
+    } else {
+        // Older bitstream: one byte at a time
+        for (uint32_t i = 0; i < words; i++) {
+            uint32_t w = s_ring[t++ & RING_MASK];
+            for (int b = 0; b < 4; b++, w >>= 8) {
+                while (UART_TX_STATUS & 0x01);
+                UART_TX_DATA = w & 0xFF;
+            }
+        }
+    }
+    s_tail = t;
+    atomic_irq_restore(irq);
+
+    return 1;
+}
+
+uint32_t binlog_drain(void) {
+    while (binlog_send_record());
+    return atomic_load(&s_head) - atomic_load(&s_tail);
+}
+
+void binlog_flush(void) {
+    while (binlog_drain());
+}
+
+static void binlog_tx_isr(uint32_t source) {
+    (void)source;
+    if (binlog_drain() == 0) {
+        uart_irq_disable(UART_IRQ_TX_LOW);      // binlog_write() re-arms
+    }
+}
+
+int binlog_irq_start(uint32_t prio) {
+    uint32_t irq = atomic_irq_save();
+
+    // Unmapped MMIO reads 0: no UART interrupts in this bitstream
+    uart_irq_enable(UART_IRQ_TX_LOW);
+    if (!(UART_IRQ_EN & UART_IRQ_TX_LOW) || !(UART_TX_STATUS & UART_TX_FIFO)) {
+        uart_irq_disable(UART_IRQ_TX_LOW);
+        atomic_irq_restore(irq);
+        return 0;
+    }
+
+    UART_IRQ_LEVEL = UART_IRQ_LEVELS(UART_IRQ_LEVEL & 0xFFFF, BINLOG_TX_LOW);
+    irq_register(IRQ_UART_TX, binlog_tx_isr, prio);
+    s_irq_mode = 1;
+    if (s_head == s_tail) {
+        uart_irq_disable(UART_IRQ_TX_LOW);
+    }
+    atomic_irq_restore(irq);
+
+    return 1;
+}
+
+void binlog_get_stats(binlog_stats_t *s) {
+    uint32_t irq = atomic_irq_save();
+
+    *s = s_stats;
+    atomic_irq_restore(irq);
+}
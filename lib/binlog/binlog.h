@@ -0,0 +1,102 @@
+//===============================================================================
+// Binary Deferred-Format Logging
+// The target logs a string ID and raw words, tools/binlog formats them
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// printf() at 1 Mbaud costs ~10 us per character plus the formatting, and
+// moves every timing it is meant to observe. BLOG() formats nothing: the
+// format string goes to the .binlog_fmt section, which the generated
+// linker script keeps in the ELF as a non-loaded (INFO) section at address
+// 0, and the call stores the string's offset, a timestamp and up to
+// BINLOG_MAX_ARGS argument words in a RAM ring - a masked section of a
+// dozen stores.
+//
+//   BLOG("rx %u bytes, crc %08x", len, crc);
+//
+//   for (;;) {
+//       ...
+//       binlog_drain();                           // Idle: ring to TX FIFO
+//   }
+//
+// binlog_irq_start() drains from the UART TX interrupt instead (IRQ[5]
+// through the start.S dispatcher, lib/irq.h): the TX FIFO is refilled when
+// it runs low and the interrupt is disarmed once the ring is empty. Only
+// whole records go into the FIFO, with IRQs masked, so text printed
+// between them stays readable.
+//
+// On the host:
+//
+//   tools/binlog/binlog_decode firmware/app.elf capture.log
+//   [    1.204113] rx 512 bytes, crc 1c291ca3
+//
+// Arguments are 32-bit words: integers, chars, pointers. %s prints a
+// string that is part of the ELF image (the decoder reads it from there,
+// not from RAM); 64-bit integers and floating point are not supported.
+// A full ring drops records and counts them; the next record that fits is
+// preceded by a "dropped" record.
+//
+// Wire frame (little-endian words, the ring layout as is):
+//
+//   word 0  0x1E | flags.nargs << 8 | id << 16    (flags bit 7: cycles)
+//   word 1  timestamp: timebase microseconds, or CPU cycles without one
+//   word 2+ arguments
+//
+//===============================================================================
+
+#ifndef BINLOG_H
+#define BINLOG_H
+
+#include <stdint.h>
+
+#ifndef BINLOG_RING_WORDS
+#define BINLOG_RING_WORDS   1024            // Power of two: 4 KB
+#endif
+
+#define BINLOG_MAX_ARGS     8
+
+#define BINLOG_SYNC         0x1E            // ASCII RS: starts every record
+#define BINLOG_FLAG_CYCLES  0x80            // Timestamp in CPU cycles
+#define BINLOG_ID_DROPPED   0xFFFF          // One argument: records lost
+
+// Argument count of a BLOG() call, 0 to 8
+#define BINLOG_NARGS(...)   BINLOG_NARGS_(0, ##__VA_ARGS__, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define BINLOG_NARGS_(z, a1, a2, a3, a4, a5, a6, a7, a8, a9, n, ...) n
+
+#define BLOG(fmt, ...) do {                                                     \
+    static const char binlog_fmt_[]                                             \
+        __attribute__((section(".binlog_fmt"), used)) = fmt;                    \
+    _Static_assert(BINLOG_NARGS(__VA_ARGS__) <= BINLOG_MAX_ARGS,                \
+                   "BLOG: at most 8 arguments");                                \
+    binlog_write(binlog_fmt_, BINLOG_NARGS(__VA_ARGS__), ##__VA_ARGS__);        \
+} while (0)
+
+typedef struct {
+    uint32_t records;               // Written to the ring
+    uint32_t dropped;               // Lost to a full ring
+    uint32_t max_words;             // Highest ring fill seen
+} binlog_stats_t;
+
+// Queue one record (ISR or main code). Use BLOG(), which passes the
+// format's ID and the argument count.
+void binlog_write(const char *fmt, uint32_t nargs, ...);
+
+// Move whole records into the TX FIFO's free space; never waits (without
+// a TX FIFO, older bitstreams, it sends one record byte by byte). Returns
+// the number of words still queued.
+uint32_t binlog_drain(void);
+
+// Wait until the whole ring is in the TX FIFO (before a reset, or before
+// printing text that should come after the records)
+void binlog_flush(void);
+
+// Drain from the UART TX-low interrupt (handler registered at prio).
+// Returns 0 without the UART interrupt block; the ring then waits for
+// binlog_drain().
+int binlog_irq_start(uint32_t prio);
+
+void binlog_get_stats(binlog_stats_t *s);
+
+#endif // BINLOG_H
@@ -0,0 +1,151 @@
+//===============================================================================
+// Block Upload Protocol - Sender (Downloads to the Host)
+// Host-pulled blocks with the upload packet format and per-block CRC32
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// No libc, like block_upload.c. Kept apart from it so the bootloaders, which
+// only receive, do not carry the sender.
+//
+
+#include "block_upload.h"
+#include "../crc32.h"
+
+static void put16(const block_source_t *src, uint8_t type, uint32_t v) {
+    src->putc(type);
+    src->putc(v & 0xFF);
+    src->putc((v >> 8) & 0xFF);
+}
+
+static void put32(const block_source_t *src, uint8_t type, uint32_t v) {
+    put16(src, type, v);
+    src->putc((v >> 16) & 0xFF);
+    src->putc((v >> 24) & 0xFF);
+}
+
+static void skip32(const block_source_t *src) {
+    for (int i = 0; i < 4; i++) {
+        src->getc();
+    }
+}
+
+static uint32_t block_len(uint32_t size, uint32_t index) {
+    uint32_t left = size - index * BLOCK_UPLOAD_BLOCK_SIZE;
+
+    return left < BLOCK_UPLOAD_BLOCK_SIZE ? left : BLOCK_UPLOAD_BLOCK_SIZE;
+}
+
+static void send_block(const block_source_t *src, uint32_t size, uint16_t index) {
+    uint32_t len = block_len(size, index);
+    const uint8_t *data = src->read((uint32_t)index * BLOCK_UPLOAD_BLOCK_SIZE, len);
+    uint32_t crc;
+
+    if (!data) {
+        len = 0;                            // Unreadable: empty packet, CRC 0
+    }
+
+    put16(src, BLOCK_RSP_DATA, index);
+    src->putc(len & 0xFF);
+    src->putc(len >> 8);
+    src->putc(block_upload_check(BLOCK_RSP_DATA, index, len));
+    for (uint32_t i = 0; i < len; i++) {
+        src->putc(data[i]);
+    }
+    crc = len ? crc32_calc(data, len) : 0;
+    for (int i = 0; i < 4; i++) {
+        src->putc((crc >> (i * 8)) & 0xFF);
+    }
+}
+
+// CRC32 of the range as it reads now (memory may have changed meanwhile)
+static uint32_t range_crc(const block_source_t *src, uint32_t size) {
+    uint32_t crc = 0;
+
+    for (uint32_t off = 0; off < size; off += BLOCK_UPLOAD_BLOCK_SIZE) {
+        uint32_t len = block_len(size, off / BLOCK_UPLOAD_BLOCK_SIZE);
+        const uint8_t *data = src->read(off, len);
+
+        if (!data) {
+            return ~crc;                    // Cannot match: the host reports it
+        }
+        crc = crc32_update(crc, data, len);
+    }
+    return crc;
+}
+
+int32_t block_send(const block_source_t *src, uint32_t size) {
+    uint32_t blocks = (size + BLOCK_UPLOAD_BLOCK_SIZE - 1) / BLOCK_UPLOAD_BLOCK_SIZE;
+    uint8_t hdr[BLOCK_UPLOAD_HEADER_SIZE];
+    uint32_t have = 0;
+
+    if (size > BLOCK_DOWNLOAD_MAX_SIZE) {
+        size = BLOCK_DOWNLOAD_MAX_SIZE;
+        blocks = BLOCK_DOWNLOAD_MAX_SIZE / BLOCK_UPLOAD_BLOCK_SIZE;
+    }
+
+    while (1) {
+        uint16_t arg, len;
+        int valid;
+
+        // Hunt as block_receive() does; every host packet here has len 0
+        while (have < BLOCK_UPLOAD_HEADER_SIZE) {
+            hdr[have] = src->getc();
+            if (have == 0 && hdr[0] == 0x03) {
+                return -BLOCK_ERROR_CANCEL;     // Ctrl-C from a terminal
+            }
+            have++;
+        }
+        arg = hdr[1] | (hdr[2] << 8);
+        len = hdr[3] | (hdr[4] << 8);
+        switch (hdr[0]) {
+        case BLOCK_PKT_PROBE:
+        case BLOCK_PKT_QUERY:
+        case BLOCK_PKT_FINISH:
+        case BLOCK_PKT_ABORT:
+            valid = 1;
+            break;
+        case BLOCK_PKT_GET:
+            valid = arg < blocks;
+            break;
+        default:
+            valid = 0;
+            break;
+        }
+        if (!valid || len != 0 || hdr[5] != block_upload_check(hdr[0], arg, len)) {
+            for (uint32_t i = 1; i < BLOCK_UPLOAD_HEADER_SIZE; i++) {
+                hdr[i - 1] = hdr[i];
+            }
+            have--;
+            continue;
+        }
+        have = 0;
+        skip32(src);                        // CRC32 of the empty payload
+
+        switch (hdr[0]) {
+        case BLOCK_PKT_PROBE:
+            src->putc(BLOCK_RSP_INFO);
+            src->putc(BLOCK_UPLOAD_VERSION);
+            src->putc(BLOCK_UPLOAD_BLOCK_SIZE & 0xFF);
+            src->putc(BLOCK_UPLOAD_BLOCK_SIZE >> 8);
+            src->putc(BLOCK_UPLOAD_WINDOW);
+            break;
+
+        case BLOCK_PKT_QUERY:
+            put32(src, BLOCK_RSP_SIZE, size);
+            break;
+
+        case BLOCK_PKT_GET:
+            send_block(src, size, arg);
+            break;
+
+        case BLOCK_PKT_FINISH:
+            put32(src, BLOCK_RSP_DONE, range_crc(src, size));
+            return (int32_t)size;
+
+        case BLOCK_PKT_ABORT:
+            return -BLOCK_ERROR_CANCEL;
+        }
+    }
+}
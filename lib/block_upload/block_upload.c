@@ -0,0 +1,216 @@
+//===============================================================================
+// Block Upload Protocol - Receiver
+// Windowed blocks, per-block CRC32 (lib/crc32.h accelerator), resume
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// No libc: builds into the -nostdlib bootloaders as well as the firmware.
+//
+
+#include "block_upload.h"
+#include "../crc32.h"
+
+// Session, kept across block_receive() calls for resume
+static uint32_t s_size;
+static uint32_t s_crc;
+static uint32_t s_blocks;
+static uint32_t s_count;                                // Blocks received
+static uint32_t s_done[BLOCK_UPLOAD_MAX_BLOCKS / 32];   // Received bitmap
+
+static int block_done(uint32_t i) {
+    return (s_done[i >> 5] >> (i & 31)) & 1;
+}
+
+static uint32_t first_missing(void) {
+    uint32_t i;
+
+    for (i = 0; i < s_blocks && block_done(i); i++);
+    return i;
+}
+
+static void put16(const block_callbacks_t *cb, uint8_t type, uint32_t v) {
+    cb->putc(type);
+    cb->putc(v & 0xFF);
+    cb->putc((v >> 8) & 0xFF);
+}
+
+static void put32(const block_callbacks_t *cb, uint8_t type, uint32_t v) {
+    put16(cb, type, v);
+    cb->putc((v >> 16) & 0xFF);
+    cb->putc((v >> 24) & 0xFF);
+}
+
+static uint32_t get32(const block_callbacks_t *cb) {
+    uint32_t v = 0;
+
+    for (int i = 0; i < 4; i++) {
+        v |= (uint32_t)cb->getc() << (i * 8);
+    }
+    return v;
+}
+
+// Payload length allowed for a packet type (0xFFFF: not a packet)
+static uint32_t payload_len(uint8_t type, uint16_t arg) {
+    switch (type) {
+    case BLOCK_PKT_PROBE:
+    case BLOCK_PKT_FINISH:
+    case BLOCK_PKT_ABORT:
+        return 0;
+    case BLOCK_PKT_SESSION:
+        return 8;
+    case BLOCK_PKT_DATA:
+        if (arg >= s_blocks) {
+            return 0xFFFF;
+        }
+        if (arg == s_blocks - 1 && (s_size % BLOCK_UPLOAD_BLOCK_SIZE)) {
+            return s_size % BLOCK_UPLOAD_BLOCK_SIZE;
+        }
+        return BLOCK_UPLOAD_BLOCK_SIZE;
+    default:
+        return 0xFFFF;
+    }
+}
+
+static void start_session(const block_callbacks_t *cb, uint32_t max_size,
+                          uint32_t size, uint32_t crc) {
+    if (size == 0 || size > max_size || size > BLOCK_UPLOAD_MAX_SIZE) {
+        put32(cb, BLOCK_RSP_REJECT, max_size);
+        return;
+    }
+
+    // Same image again: keep what arrived last time
+    if (size != s_size || crc != s_crc) {
+        for (uint32_t i = 0; i < BLOCK_UPLOAD_MAX_BLOCKS / 32; i++) {
+            s_done[i] = 0;
+        }
+        s_count = 0;
+        s_size = size;
+        s_crc = crc;
+        s_blocks = (size + BLOCK_UPLOAD_BLOCK_SIZE - 1) / BLOCK_UPLOAD_BLOCK_SIZE;
+    }
+
+    put32(cb, BLOCK_RSP_RESUME, first_missing() * BLOCK_UPLOAD_BLOCK_SIZE);
+}
+
+static void receive_block(const block_callbacks_t *cb, uint8_t *buffer,
+                          uint16_t index, uint32_t len) {
+    uint8_t *dst = buffer + (uint32_t)index * BLOCK_UPLOAD_BLOCK_SIZE;
+    uint32_t crc;
+
+    if (!block_done(index)) {
+        // Straight into place: a bad block is simply overwritten on resend
+        for (uint32_t i = 0; i < len; i++) {
+            dst[i] = cb->getc();
+        }
+        crc = crc32_calc(dst, len);
+    } else {
+        // Resent after a lost ACK: already stored, only check it
+        crc = 0;
+        for (uint32_t i = 0; i < len; i++) {
+            uint8_t b = cb->getc();
+            crc = crc32_update(crc, &b, 1);
+        }
+    }
+
+    if (get32(cb) != crc) {
+        put16(cb, BLOCK_RSP_NAK, index);
+        return;
+    }
+
+    if (!block_done(index)) {
+        s_done[index >> 5] |= 1u << (index & 31);
+        s_count++;
+        if (cb->progress) {
+            cb->progress(s_count * BLOCK_UPLOAD_BLOCK_SIZE, s_size);
+        }
+    }
+    put16(cb, BLOCK_RSP_ACK, index);
+}
+
+int32_t block_receive(const block_callbacks_t *cb, uint8_t *buffer, uint32_t max_size, int first) {
+    uint8_t hdr[BLOCK_UPLOAD_HEADER_SIZE];
+    uint32_t have = 0;
+
+    if (first >= 0) {
+        hdr[have++] = (uint8_t)first;
+    }
+
+    while (1) {
+        uint16_t arg, len;
+        uint32_t want;
+
+        // Hunt: shift bytes through until they form a valid header
+        while (have < BLOCK_UPLOAD_HEADER_SIZE) {
+            hdr[have++] = cb->getc();
+        }
+        arg = hdr[1] | (hdr[2] << 8);
+        len = hdr[3] | (hdr[4] << 8);
+        want = payload_len(hdr[0], arg);
+        if (want != len || hdr[5] != block_upload_check(hdr[0], arg, len)) {
+            for (uint32_t i = 1; i < BLOCK_UPLOAD_HEADER_SIZE; i++) {
+                hdr[i - 1] = hdr[i];
+            }
+            have--;
+            continue;
+        }
+        have = 0;
+
+        switch (hdr[0]) {
+        case BLOCK_PKT_PROBE:
+            get32(cb);
+            cb->putc(BLOCK_RSP_INFO);
+            cb->putc(BLOCK_UPLOAD_VERSION);
+            cb->putc(BLOCK_UPLOAD_BLOCK_SIZE & 0xFF);
+            cb->putc(BLOCK_UPLOAD_BLOCK_SIZE >> 8);
+            cb->putc(BLOCK_UPLOAD_WINDOW);
+            break;
+
+        case BLOCK_PKT_SESSION: {
+            uint8_t p[8];
+            uint32_t size, crc;
+
+            for (int i = 0; i < 8; i++) {
+                p[i] = cb->getc();
+            }
+            if (get32(cb) != crc32_calc(p, 8)) {
+                break;                      // Host times out and sends it again
+            }
+            size = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+            crc = p[4] | (p[5] << 8) | (p[6] << 16) | ((uint32_t)p[7] << 24);
+            start_session(cb, max_size, size, crc);
+            break;
+        }
+
+        case BLOCK_PKT_DATA:
+            receive_block(cb, buffer, arg, len);
+            break;
+
+        case BLOCK_PKT_FINISH: {
+            uint32_t missing, crc, size = s_size;
+
+            get32(cb);
+            if (!s_blocks) {
+                break;
+            }
+            missing = first_missing();
+            if (missing < s_blocks) {
+                put16(cb, BLOCK_RSP_NAK, missing);
+                break;
+            }
+            crc = crc32_calc(buffer, size);
+            put32(cb, BLOCK_RSP_DONE, crc);
+
+            // Done either way: the next session starts from scratch
+            s_size = 0;
+            s_blocks = 0;
+            return crc == s_crc ? (int32_t)size : -BLOCK_ERROR_CRC;
+        }
+
+        case BLOCK_PKT_ABORT:
+            get32(cb);
+            return -BLOCK_ERROR_CANCEL;
+        }
+    }
+}
@@ -0,0 +1,144 @@
+//===============================================================================
+// Block Upload Protocol - Windowed UART Upload with Per-Block CRC and Resume
+// Shared by the bootloaders (receiver, block_upload.c) and fw_upload_fast;
+// the same packets carry downloads the other way (sender, block_download.c)
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// The host streams the image in BLOCK_UPLOAD_BLOCK_SIZE blocks, keeping up to
+// BLOCK_UPLOAD_WINDOW of them unacknowledged, so the line never idles waiting
+// for the device. Every block carries its index and CRC32: a block the UART
+// damaged or lost is NAKed (or simply not ACKed) and sent again on its own,
+// instead of restarting the whole upload as with the FAST stream protocol.
+//
+// Host packets: 6-byte header, payload, CRC32 of the payload (little-endian)
+//
+//   type | arg (LE16) | len (LE16) | check = ~(type ^ arg ^ len bytes)
+//
+//   'W' probe     arg = version, len = 0      -> 'w' version, block (LE16), window
+//   'S' session   len = 8: size, image CRC    -> 'A' resume offset (LE32)
+//                                                 'J' max size (LE32): too large
+//   'D' data      arg = block index           -> 'K' index (LE16): stored
+//                                                 'N' index (LE16): bad CRC, resend
+//   'F' finish    len = 0                     -> 'C' image CRC (LE32)
+//                                                 'N' index: block still missing
+//   'X' abort     len = 0                     -> (receiver returns)
+//   'H' hold      arg = BLOCK_HOLD_MAGIC      -> 'w' as for the probe
+//
+// The hold packet is for the hardware loader (hdl/firmware_loader.v), which
+// watches the UART while the CPU runs: it holds the CPU in reset and takes
+// the upload itself. The bootloaders ignore it.
+//
+// The receiver hunts for a valid header byte by byte, so after bytes are lost
+// it falls back into step at the next packet. A session with the same size
+// and image CRC as the previous one keeps the blocks already received: a
+// host that was interrupted gets them skipped ('A' returns the offset of the
+// first missing block) instead of sending the image again.
+//
+// The probe contains no 'R' or Ctrl-C byte, so receivers that only know the
+// FAST or chunked protocols ignore it and the host falls back to those.
+//
+// Downloads (device -> host) are pulled by the host with the same header,
+// so the device only ever answers and needs no timers:
+//
+//   'W' probe     as above                    -> 'w' version, block, window
+//   'Q' query     len = 0                     -> 'O' size (LE32)
+//   'G' get       arg = block index           -> 'd' packet: header as above
+//                                                 (arg = index), payload, CRC32;
+//                                                 len = 0: block unreadable
+//   'F' finish    len = 0                     -> 'C' CRC32 of the whole range
+//   'X' abort     len = 0                     -> (sender returns)
+//
+// The host keeps up to BLOCK_UPLOAD_WINDOW gets outstanding. Answers come in
+// request order, so a block that arrives tells the host that every earlier
+// unanswered get was lost; it asks again, as it does for a bad CRC.
+//
+//===============================================================================
+
+#ifndef BLOCK_UPLOAD_H
+#define BLOCK_UPLOAD_H
+
+#include <stdint.h>
+
+//===============================================================================
+// Protocol Constants
+//===============================================================================
+
+#define BLOCK_UPLOAD_VERSION        1
+#define BLOCK_UPLOAD_BLOCK_SIZE     1024    // Payload bytes per data packet
+#define BLOCK_UPLOAD_WINDOW         8       // Blocks in flight before the host waits
+#define BLOCK_UPLOAD_MAX_SIZE       (512 * 1024)
+#define BLOCK_UPLOAD_MAX_BLOCKS     (BLOCK_UPLOAD_MAX_SIZE / BLOCK_UPLOAD_BLOCK_SIZE)
+#define BLOCK_UPLOAD_HEADER_SIZE    6
+#define BLOCK_DOWNLOAD_MAX_SIZE     (65536UL * BLOCK_UPLOAD_BLOCK_SIZE)    // 16-bit index
+
+// Host -> device
+#define BLOCK_PKT_PROBE     'W'
+#define BLOCK_PKT_SESSION   'S'
+#define BLOCK_PKT_DATA      'D'
+#define BLOCK_PKT_FINISH    'F'
+#define BLOCK_PKT_ABORT     'X'
+#define BLOCK_PKT_HOLD      'H'     // Hardware loader only
+#define BLOCK_PKT_QUERY     'Q'     // Download only
+#define BLOCK_PKT_GET       'G'     // Download only
+
+#define BLOCK_HOLD_MAGIC    0xC3A5  // arg of the hold packet
+
+// Device -> host (type byte, then the listed little-endian fields)
+#define BLOCK_RSP_INFO      'w'     // version, block size (2), window
+#define BLOCK_RSP_RESUME    'A'     // resume offset (4)
+#define BLOCK_RSP_REJECT    'J'     // max size (4)
+#define BLOCK_RSP_ACK       'K'     // index (2)
+#define BLOCK_RSP_NAK       'N'     // index (2)
+#define BLOCK_RSP_DONE      'C'     // image CRC (4)
+#define BLOCK_RSP_SIZE      'O'     // download size (4)
+#define BLOCK_RSP_DATA      'd'     // header, payload, CRC32
+
+// Header check byte
+static inline uint8_t block_upload_check(uint8_t type, uint16_t arg, uint16_t len) {
+    return (uint8_t)~(type ^ (arg & 0xFF) ^ (arg >> 8) ^ (len & 0xFF) ^ (len >> 8));
+}
+
+//===============================================================================
+// Receiver (block_upload.c)
+//===============================================================================
+
+typedef struct {
+    void (*putc)(uint8_t c);                            // Send one byte
+    uint8_t (*getc)(void);                              // Receive one byte (blocking)
+    void (*progress)(uint32_t received, uint32_t size); // After each new block, or 0
+} block_callbacks_t;
+
+typedef enum {
+    BLOCK_OK = 0,
+    BLOCK_ERROR_CRC = 1,            // All blocks passed but the image CRC did not
+    BLOCK_ERROR_CANCEL = 2          // Host sent 'X'
+} block_error_t;
+
+// Receive an image into buffer (up to max_size bytes). first is a byte the
+// caller already read while looking for its own commands (the probe's 'W'),
+// or -1. Returns the image size once the host finishes and the image CRC
+// matches, negative block_error_t otherwise. Session state is kept between
+// calls, so a later call resumes an interrupted upload.
+int32_t block_receive(const block_callbacks_t *cb, uint8_t *buffer, uint32_t max_size, int first);
+
+//===============================================================================
+// Sender (block_download.c)
+//===============================================================================
+
+typedef struct {
+    void (*putc)(uint8_t c);                            // Send one byte
+    uint8_t (*getc)(void);                              // Receive one byte (blocking)
+    // len bytes at offset, valid until the next call (memory: a pointer
+    // into it, SD: a sector buffer), or 0 if they cannot be read
+    const uint8_t *(*read)(uint32_t offset, uint32_t len);
+} block_source_t;
+
+// Serve size bytes (up to BLOCK_DOWNLOAD_MAX_SIZE) from src until the host finishes or aborts (a Ctrl-C
+// between packets aborts too). Returns size once the host has the range,
+// -BLOCK_ERROR_CANCEL otherwise.
+int32_t block_send(const block_source_t *src, uint32_t size);
+
+#endif // BLOCK_UPLOAD_H
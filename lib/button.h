@@ -0,0 +1,68 @@
+//===============================================================================
+// Debounced buttons at 0x80000270
+// BUT1/BUT2 state after a hardware debounce window, press/release on IRQ[6]
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// hdl/button_debounce.v changes a button's state only once its input has
+// held for BTN_DEBOUNCE microseconds (10 ms after reset), and latches each
+// change in BTN_EVENTS. Enabled events (BTN_IRQ_EN, presses after reset)
+// pulse IRQ[6], IRQ_BUTTON, so a UI sleeps until a button settles instead
+// of polling BUTTON_INPUT and timing its own debounce:
+//
+//   IRQC_PENDING = 1u << IRQ_BUTTON;
+//   irq_source_enable(IRQ_BUTTON);
+//   irq_wait_until(BTN_EVENTS & BTN_PRESS(0), 1u << IRQ_BUTTON);
+//   irq_source_disable(IRQ_BUTTON);
+//   button_take_events(BTN_PRESS(0));
+//
+// BUTTON_INPUT (0x80000018) still reads the raw synchronised inputs. On a
+// bitstream without the block every register reads 0: check
+// button_debounce_present() first.
+//
+//===============================================================================
+
+#ifndef BUTTON_H
+#define BUTTON_H
+
+#include <stdint.h>
+
+#define BTN_BASE            0x80000270
+#define BTN_STATE           (*(volatile uint32_t*)(BTN_BASE + 0x00))  // Read only
+#define BTN_EVENTS          (*(volatile uint32_t*)(BTN_BASE + 0x04))  // Write 1 to clear
+#define BTN_IRQ_EN          (*(volatile uint32_t*)(BTN_BASE + 0x08))
+#define BTN_DEBOUNCE        (*(volatile uint32_t*)(BTN_BASE + 0x0C))  // Microseconds
+
+// STATE bits
+#define BTN_STATE_MASK      0x3             // Debounced, bit n = button n (BUT1 = 0)
+#define BTN_STATE_RAW(s)    (((s) >> 8) & 0x3)  // Synchronised input
+#define BTN_PRESENT         (1u << 31)
+
+// EVENTS / IRQ_EN bits
+#define BTN_PRESS(n)        (1u << (n))
+#define BTN_RELEASE(n)      (1u << ((n) + 2))
+#define BTN_PRESS_ALL       0x3
+#define BTN_RELEASE_ALL     0xC
+
+#define BTN_DEBOUNCE_MAX_US 65535
+
+static inline int button_debounce_present(void) {
+    // Unmapped MMIO reads return 0
+    return (BTN_STATE & BTN_PRESENT) != 0;
+}
+
+static inline void button_set_debounce_us(uint32_t us) {
+    BTN_DEBOUNCE = us > BTN_DEBOUNCE_MAX_US ? BTN_DEBOUNCE_MAX_US : us;
+}
+
+// Latched events among mask, cleared
+static inline uint32_t button_take_events(uint32_t mask) {
+    uint32_t ev = BTN_EVENTS & mask;
+
+    BTN_EVENTS = ev;
+    return ev;
+}
+
+#endif // BUTTON_H
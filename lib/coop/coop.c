@@ -0,0 +1,352 @@
+//===============================================================================
+// Cooperative Tasks - Scheduler
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+
+#include "coop.h"
+#include "../irq.h"
+#include "../atomic.h"
+#include "../timer.h"
+
+#define COOP_STACK_FILL     0xC00FC00Fu     // Unused stack words (coop_stack_free)
+#define COOP_FRAME_WORDS    16              // coop_switch.S frame
+
+// coop_switch.S
+extern void coop_task_start(void);
+
+// Ready queue: one FIFO per priority, bit p of s_ready_map set while
+// list p is not empty. The running task is on no list.
+static coop_task_t *s_ready_head[COOP_MAX_PRIO + 1];
+static coop_task_t *s_ready_tail[COOP_MAX_PRIO + 1];
+static uint32_t s_ready_map;
+
+static coop_task_t *s_current;
+static coop_task_t *s_sleepers;             // By wake tick, earliest first
+static coop_task_t *s_waiters[IRQ_NUM_SOURCES];
+
+static volatile uint32_t s_ticks;
+static uint32_t s_switches;
+
+static coop_task_t s_idle;
+static uint32_t s_idle_stack[COOP_MIN_STACK];
+
+// Stands in for main() on the first switch; never resumed
+static coop_task_t s_boot;
+
+//==============================================================================
+// Helpers (IRQs masked)
+//==============================================================================
+
+static inline uint32_t coop_lock(void) {
+    return atomic_irq_save();
+}
+
+static inline void coop_unlock(uint32_t old) {
+    atomic_irq_restore(old);
+}
+
+static void ready_push(coop_task_t *t) {
+    uint32_t p = t->prio;
+
+    t->state = COOP_READY;
+    t->next = NULL;
+    if (s_ready_tail[p]) {
+        s_ready_tail[p]->next = t;
+    } else {
+        s_ready_head[p] = t;
+        s_ready_map |= 1u << p;
+    }
+    s_ready_tail[p] = t;
+}
+
+static coop_task_t *ready_pop_highest(void) {
+    // The idle task is ready whenever another task blocks
+    uint32_t p = 31 - __builtin_clz(s_ready_map);
+    coop_task_t *t = s_ready_head[p];
+
+    s_ready_head[p] = t->next;
+    if (!t->next) {
+        s_ready_tail[p] = NULL;
+        s_ready_map &= ~(1u << p);
+    }
+    return t;
+}
+
+static void sleep_insert(coop_task_t *t, uint32_t ticks) {
+    coop_task_t **pp = &s_sleepers;
+
+    // +1: the next tick may be only a moment away
+    t->wake = s_ticks + ticks + 1;
+    t->timed = 1;
+    while (*pp && (int32_t)(t->wake - (*pp)->wake) >= 0) {
+        pp = &(*pp)->sleep_next;
+    }
+    t->sleep_next = *pp;
+    *pp = t;
+}
+
+static void sleep_remove(coop_task_t *t) {
+    coop_task_t **pp = &s_sleepers;
+
+    while (*pp && *pp != t) {
+        pp = &(*pp)->sleep_next;
+    }
+    if (*pp) {
+        *pp = t->sleep_next;
+    }
+    t->timed = 0;
+}
+
+static void waiter_remove(coop_task_t *t) {
+    coop_task_t **pp = &s_waiters[t->source];
+
+    while (*pp && *pp != t) {
+        pp = &(*pp)->next;
+    }
+    if (*pp) {
+        *pp = t->next;
+    }
+}
+
+// Run the highest priority ready task. The caller has queued itself if it
+// stays ready; returns when it is switched back in.
+static void coop_schedule(void) {
+    coop_task_t *prev = s_current;
+    coop_task_t *next = ready_pop_highest();
+
+    if (next != prev) {
+        s_current = next;
+        next->switches++;
+        s_switches++;
+        coop_switch(&prev->sp, next->sp);
+    }
+}
+
+//==============================================================================
+// Interrupt Handlers (lib/irq.h dispatch table)
+//==============================================================================
+
+static void coop_tick_isr(uint32_t source) {
+    uint32_t now;
+    coop_task_t *t;
+
+    (void)source;
+    TIMER_CH_SR(0) = TIMER_CH_UIF;
+    now = ++s_ticks;
+
+    while (s_sleepers && (int32_t)(now - s_sleepers->wake) >= 0) {
+        t = s_sleepers;
+        s_sleepers = t->sleep_next;
+        t->timed = 0;
+        if (t->state == COOP_WAITING) {
+            waiter_remove(t);       // Timed out, events stay 0
+        }
+        ready_push(t);
+    }
+}
+
+static void coop_event_isr(uint32_t source) {
+    coop_task_t *t = s_waiters[source];
+    coop_task_t *next;
+
+    // Quiet until the next wait: the task serves the device first
+    irq_source_disable(source);
+    s_waiters[source] = NULL;
+
+    while (t) {
+        next = t->next;
+        t->events |= 1u << source;
+        if (t->timed) {
+            sleep_remove(t);
+        }
+        ready_push(t);
+        t = next;
+    }
+}
+
+//==============================================================================
+// Tasks
+//==============================================================================
+
+// Nothing else ready: sleep until an IRQ makes something ready
+static void coop_idle(void *arg) {
+    uint32_t old;
+
+    (void)arg;
+    for (;;) {
+        old = coop_lock();
+        if (s_ready_map == 0) {
+            irq_wait();
+        }
+        coop_unlock(old);           // The pending IRQ is taken here
+        coop_yield();
+    }
+}
+
+static void coop_task_setup(coop_task_t *t, const char *name, coop_entry_t entry,
+                            void *arg, uint32_t prio, uint32_t *stack, uint32_t words) {
+    volatile uint32_t *w = stack;   // Not turned into a memset() call
+    uint32_t *sp;
+    uint32_t old;
+
+    for (uint32_t i = 0; i < words; i++) {
+        w[i] = COOP_STACK_FILL;
+    }
+
+    // Switch frame at the 16-byte aligned top: "return" into coop_task_start
+    sp = (uint32_t *)((uintptr_t)(stack + words) & ~(uintptr_t)15) - COOP_FRAME_WORDS;
+    sp[0] = (uint32_t)(uintptr_t)coop_task_start;
+    sp[1] = (uint32_t)(uintptr_t)entry;     // s0
+    sp[2] = (uint32_t)(uintptr_t)arg;       // s1
+
+    t->sp = sp;
+    t->sleep_next = NULL;
+    t->wake = 0;
+    t->events = 0;
+    t->prio = (uint8_t)prio;
+    t->source = 0;
+    t->timed = 0;
+    t->name = name;
+    t->entry = entry;
+    t->arg = arg;
+    t->stack = stack;
+    t->switches = 0;
+
+    old = coop_lock();
+    ready_push(t);
+    coop_unlock(old);
+}
+
+//==============================================================================
+// API
+//==============================================================================
+
+void coop_init(void) {
+    uint32_t old = coop_lock();
+
+    for (uint32_t p = 0; p <= COOP_MAX_PRIO; p++) {
+        s_ready_head[p] = NULL;
+        s_ready_tail[p] = NULL;
+    }
+    for (uint32_t i = 0; i < IRQ_NUM_SOURCES; i++) {
+        s_waiters[i] = NULL;
+    }
+    s_ready_map = 0;
+    s_sleepers = NULL;
+    s_ticks = 0;
+    s_switches = 0;
+    s_current = &s_boot;
+
+    coop_task_setup(&s_idle, "idle", coop_idle, NULL, 0, s_idle_stack, COOP_MIN_STACK);
+    coop_unlock(old);
+}
+
+int coop_task_create(coop_task_t *t, const char *name, coop_entry_t entry,
+                     void *arg, uint32_t prio, uint32_t *stack, uint32_t words) {
+    if (!t || !entry || !stack || prio < 1 || prio > COOP_MAX_PRIO || words < COOP_MIN_STACK) {
+        return -1;
+    }
+    coop_task_setup(t, name, entry, arg, prio, stack, words);
+    return 0;
+}
+
+void coop_start(void) {
+    coop_lock();
+
+    irq_register(IRQ_TIMER, coop_tick_isr, 8);
+    TIMER_CH_CR(0) = 0;
+    TIMER_CH_PSC(0) = TIMER_PSC_1MHZ;
+    TIMER_CH_ARR(0) = 1000 - 1;                 // 1 kHz
+    TIMER_CH_SR(0) = TIMER_CH_UIF;
+    TIMER_CH_CR(0) = TIMER_CH_ENABLE;
+
+    // s_boot is on no list: main() is never switched back in
+    s_boot.state = COOP_DONE;
+    coop_schedule();
+    for (;;) {
+    }
+}
+
+void coop_yield(void) {
+    uint32_t old = coop_lock();
+
+    ready_push(s_current);
+    coop_schedule();
+    coop_unlock(old);
+}
+
+void coop_sleep_ms(uint32_t ms) {
+    uint32_t old;
+
+    if (ms == 0) {
+        coop_yield();
+        return;
+    }
+
+    old = coop_lock();
+    s_current->state = COOP_SLEEPING;
+    sleep_insert(s_current, ms);
+    coop_schedule();
+    coop_unlock(old);
+}
+
+uint32_t coop_wait_irq(uint32_t source, uint32_t timeout_ms) {
+    coop_task_t *t = s_current;
+    uint32_t old;
+    uint32_t events;
+
+    if (source >= IRQ_NUM_SOURCES) {
+        return 0;
+    }
+
+    old = coop_lock();
+    t->events = 0;
+    t->state = COOP_WAITING;
+    t->source = (uint8_t)source;
+    t->next = s_waiters[source];
+    s_waiters[source] = t;
+    if (timeout_ms != COOP_FOREVER) {
+        sleep_insert(t, timeout_ms);
+    }
+
+    // An event already pending in the controller fires once IRQs are on
+    irq_vector_table[source] = coop_event_isr;
+    irq_source_enable(source);
+
+    coop_schedule();
+    events = t->events;
+    coop_unlock(old);
+
+    return events;
+}
+
+void coop_exit(void) {
+    coop_lock();
+    s_current->state = COOP_DONE;
+    coop_schedule();
+    for (;;) {
+    }
+}
+
+coop_task_t *coop_self(void) {
+    return s_current;
+}
+
+uint32_t coop_ticks(void) {
+    return s_ticks;
+}
+
+uint32_t coop_switch_count(void) {
+    return s_switches;
+}
+
+uint32_t coop_stack_free(const coop_task_t *t) {
+    uint32_t n = 0;
+
+    while (t->stack + n < t->sp && t->stack[n] == COOP_STACK_FILL) {
+        n++;
+    }
+    return n;
+}
@@ -0,0 +1,125 @@
+//===============================================================================
+// Cooperative Tasks - Stackful Tasks for Bare-Metal Firmware
+// Priority bitmap ready queue, tick sleep and IRQ event waits
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// For firmware that wants blocking tasks without the FreeRTOS footprint:
+// every task has its own stack, but a switch only happens when the running
+// task yields, sleeps, waits or returns. The tick and event ISRs only move
+// tasks to the ready queue, so no locking is needed between tasks and a
+// switch saves 13 registers (coop_switch.S) instead of a full frame.
+//
+//   static coop_task_t blink, shell;
+//   static uint32_t blink_stack[256], shell_stack[512];
+//
+//   coop_init();
+//   coop_task_create(&blink, "blink", blink_main, NULL, 1, blink_stack, 256);
+//   coop_task_create(&shell, "shell", shell_main, NULL, 2, shell_stack, 512);
+//   coop_start();                               // Does not return
+//
+//   void shell_main(void *arg) {
+//       for (;;) {
+//           uart_irq_enable(UART_IRQ_RX_AVAIL);
+//           if (!(UART_RX_STATUS & 1))
+//               coop_wait_irq(IRQ_UART_RX, COOP_FOREVER);
+//           handle(UART_RX_DATA);
+//       }
+//   }
+//
+// Priorities are 1-31 (31 runs first), equal priorities take turns in FIFO
+// order; 0 is the idle task, which sleeps in waitirq when nothing is ready.
+// Picking the next task is one count-leading-zeros of the ready bitmap.
+//
+// The tick is timer channel 0 at 1 kHz (one tick per millisecond) through
+// the lib/irq.h dispatch table, so the firmware must not define irq_handler() itself.
+// coop_wait_irq() enables the source in the interrupt controller and its
+// handler disables it again before waking the waiters, which keeps level
+// sources (UART, SPI) quiet until the task has served the device. Waits
+// therefore need the controller (irqc_present()); the device side (e.g.
+// uart_irq_enable()) stays with the caller.
+//
+// Task functions run with interrupts enabled. No heap, no libc.
+//
+//===============================================================================
+
+#ifndef COOP_H
+#define COOP_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define COOP_MAX_PRIO       31
+#define COOP_FOREVER        0xFFFFFFFFu     // coop_wait_irq() timeout
+
+// Smallest useful stack: the switch frame plus a few calls
+#define COOP_MIN_STACK      64              // Words
+
+// Task states
+#define COOP_READY          0
+#define COOP_SLEEPING       1               // coop_sleep_ms()
+#define COOP_WAITING        2               // coop_wait_irq()
+#define COOP_DONE           3               // Entry function returned
+
+typedef void (*coop_entry_t)(void *arg);
+
+typedef struct coop_task {
+    uint32_t *sp;                   // Saved stack pointer (coop_switch.S)
+    struct coop_task *next;         // Ready list or IRQ waiter list
+    struct coop_task *sleep_next;   // Sleep list, by wake tick
+    uint32_t wake;                  // Tick to wake at (sleeping / timed wait)
+    uint32_t events;                // 1 << source of the IRQ that woke it
+    uint8_t prio;
+    uint8_t state;                  // COOP_*
+    uint8_t source;                 // IRQ waited on (COOP_WAITING)
+    uint8_t timed;                  // On the sleep list
+    const char *name;
+    coop_entry_t entry;
+    void *arg;
+    uint32_t *stack;                // Lowest word (stack check)
+    uint32_t switches;              // Times switched in
+} coop_task_t;
+
+// Reset the scheduler and create the idle task
+void coop_init(void);
+
+// Add a task (prio 1-COOP_MAX_PRIO, stack of words 32-bit words, at least
+// COOP_MIN_STACK). Works before and after coop_start(). Returns 0, or -1
+// for a bad priority or stack.
+int coop_task_create(coop_task_t *t, const char *name, coop_entry_t entry,
+                     void *arg, uint32_t prio, uint32_t *stack, uint32_t words);
+
+// Start the tick and run the highest priority task. Does not return.
+void coop_start(void) __attribute__((noreturn));
+
+// Let other ready tasks of the same or a higher priority run
+void coop_yield(void);
+
+// Block for at least ms milliseconds (rounded up to ticks; 0 = yield)
+void coop_sleep_ms(uint32_t ms);
+
+// Block until IRQ source (lib/irq.h IRQ_*) fires or timeout_ms passes
+// (COOP_FOREVER: no timeout). Returns the task's event bits
+// (1 << source), 0 on timeout.
+uint32_t coop_wait_irq(uint32_t source, uint32_t timeout_ms);
+
+// End the calling task (also what returning from its entry does)
+void coop_exit(void) __attribute__((noreturn));
+
+coop_task_t *coop_self(void);
+
+// Milliseconds (ticks) since coop_start()
+uint32_t coop_ticks(void);
+
+// Switches since coop_start() and the unused words at the bottom of a
+// task's stack (never written since creation)
+uint32_t coop_switch_count(void);
+uint32_t coop_stack_free(const coop_task_t *t);
+
+// Save the callee-saved registers on the current stack, store its SP in
+// *save_sp, load new_sp and return into that task (coop_switch.S)
+void coop_switch(uint32_t **save_sp, uint32_t *new_sp);
+
+#endif // COOP_H
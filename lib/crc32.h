@@ -0,0 +1,115 @@
+//===============================================================================
+// CRC32 (IEEE 802.3 / zlib) with the hardware accelerator at 0x800000F0
+// One API for the bootloader, SD manager, uploaders and hexedit
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// Same CRC as crc32_gen.v, the host upload tools and zlib's crc32():
+// polynomial 0xEDB88320 (reflected), init and final XOR 0xFFFFFFFF.
+//
+// Uses hdl/crc32_accel.v when the bitstream has it (one store per word);
+// otherwise falls back to software, so firmware runs on older bitstreams
+// unchanged. The accelerator holds a single running CRC: do not call these
+// from an interrupt handler while another CRC is running.
+//
+// Software CRC: slicing-by-4 over the const tables in lib/crc32.c (4 KB of
+// .rodata, link crc32.o; one word per four lookups). With CRC32_SMALL
+// defined (the 8 KB boot ROMs) it is the 64-byte nibble table below
+// instead, and the header needs no object file.
+//
+// Usage:
+//   uint32_t crc = crc32_calc(buf, len);
+//   crc = crc32_update(0, part1, len1);        // incremental
+//   crc = crc32_update(crc, part2, len2);
+//   crc = crc32_update_byte(crc, b);           // byte loops (receivers)
+//
+//===============================================================================
+
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <stdint.h>
+
+#define CRC32_ACCEL_BASE    0x800000F0
+#define CRC32_ACCEL_CTRL    (*(volatile uint32_t*)(CRC32_ACCEL_BASE + 0x00))
+#define CRC32_ACCEL_DATA    (*(volatile uint32_t*)(CRC32_ACCEL_BASE + 0x04))
+#define CRC32_ACCEL_DATA8   (*(volatile uint8_t*) (CRC32_ACCEL_BASE + 0x04))
+#define CRC32_ACCEL_VALUE   (*(volatile uint32_t*)(CRC32_ACCEL_BASE + 0x08))
+
+#define CRC32_ACCEL_INIT    (1 << 0)        // CTRL write: restart at 0xFFFFFFFF
+#define CRC32_ACCEL_PRESENT (1u << 31)      // CTRL read: accelerator built in
+
+static inline int crc32_hw_present(void) {
+    // Unmapped MMIO reads return 0
+    return (CRC32_ACCEL_CTRL & CRC32_ACCEL_PRESENT) != 0;
+}
+
+#ifdef CRC32_SMALL
+static inline uint32_t crc32_update_sw(uint32_t crc, const void *data, uint32_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+    static const uint32_t nibble_table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+        0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+        0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+    };
+
+    crc = ~crc;
+    while (len--) {
+        crc ^= *p++;
+        crc = (crc >> 4) ^ nibble_table[crc & 0x0F];
+        crc = (crc >> 4) ^ nibble_table[crc & 0x0F];
+    }
+    return ~crc;
+}
+#else
+extern const uint32_t crc32_table[4][256];
+
+// Software CRC of len more bytes, whatever the bitstream has (crc = 0 to start)
+uint32_t crc32_update_sw(uint32_t crc, const void *data, uint32_t len);
+#endif
+
+// One more byte in software: for loops that take a byte at a time from
+// the UART, where an accelerator round trip per byte would cost more
+static inline uint32_t crc32_update_byte(uint32_t crc, uint8_t b) {
+#ifdef CRC32_SMALL
+    return crc32_update_sw(crc, &b, 1);
+#else
+    crc = ~crc;
+    return ~((crc >> 8) ^ crc32_table[0][(crc ^ b) & 0xFF]);
+#endif
+}
+
+// Continue a CRC over len more bytes (crc = 0 to start)
+static inline uint32_t crc32_update(uint32_t crc, const void *data, uint32_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+
+    if (!crc32_hw_present()) {
+        return crc32_update_sw(crc, p, len);
+    }
+
+    CRC32_ACCEL_VALUE = crc;
+
+    // Byte stores up to a word boundary, word loads/stores, byte tail
+    while (len && ((uint32_t)p & 3)) {
+        CRC32_ACCEL_DATA8 = *p++;
+        len--;
+    }
+    for (const uint32_t *wp = (const uint32_t *)p; len >= 4; len -= 4) {
+        CRC32_ACCEL_DATA = *wp++;
+        p += 4;
+    }
+    while (len--) {
+        CRC32_ACCEL_DATA8 = *p++;
+    }
+
+    return CRC32_ACCEL_VALUE;
+}
+
+static inline uint32_t crc32_calc(const void *data, uint32_t len) {
+    return crc32_update(0, data, len);
+}
+
+#endif // CRC32_H
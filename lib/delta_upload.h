@@ -0,0 +1,155 @@
+//===============================================================================
+// Delta Image Upload (rsync-style block sums of the image already in RAM)
+// Only what changed since the last upload crosses the UART
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// SRAM keeps its contents over a reset or a return to the loader, so the
+// previous firmware or overlay is usually still in place. fw_upload_fast -d
+// asks for the sums of its blocks, finds each of them in the new image at
+// any offset (rsync's rolling weak sum, confirmed by the CRC32), and sends
+// moves for the blocks that shifted and data for the rest. Blocks that
+// stayed put cost nothing. Used by bootloader_fast, lib/simple_upload and
+// the SD manager's upload-and-run:
+//
+//   PC: 'D'                                   -> 'A'
+//   PC: image size (4), block size (4)        -> 'B' ('N' if refused)
+//                                             <- weak sum (4), CRC32 (4) of
+//                                                each block of the current
+//                                                content, the last one short
+//   PC: 'M' dst (4), src (4), length (4)      -> 'K' once moved (memmove)
+//   PC: 'W' dst (4), length (4), data
+//   PC: 'E'
+//   PC: 'C' + CRC32 of the image (4)          -> 'C' + CRC32 of the image
+//
+// The host orders the ops so that no move reads what an earlier op wrote
+// (a move that would is sent as data instead) and sends the writes last.
+// A long move would overrun the RX FIFO, so each one is acknowledged. An
+// op outside the image is dropped and fails the upload; an unknown op
+// stops the ops there and the CRC reports it. The uploader defines
+// DELTA_UPLOAD_HOST for the constants and the weak sum alone.
+//
+//===============================================================================
+
+#ifndef DELTA_UPLOAD_H
+#define DELTA_UPLOAD_H
+
+#include <stdint.h>
+
+#define DELTA_UPLOAD_CMD        'D'     // Opens a delta upload instead of 'R'
+#define DELTA_UPLOAD_MOVE       'M'
+#define DELTA_UPLOAD_WRITE      'W'
+#define DELTA_UPLOAD_END        'E'
+#define DELTA_UPLOAD_MOVED      'K'     // Reply to each 'M'
+
+#define DELTA_UPLOAD_MIN_BLOCK  64      // Block sizes: a power of two in between
+#define DELTA_UPLOAD_MAX_BLOCK  4096
+
+static inline int delta_upload_block_ok(uint32_t block) {
+    return block >= DELTA_UPLOAD_MIN_BLOCK && block <= DELTA_UPLOAD_MAX_BLOCK &&
+           (block & (block - 1)) == 0;
+}
+
+// rsync's weak sum: a = sum of the bytes, b = sum of the running a, 16 bits
+// each. The host rolls it one byte at a time over the new image.
+static inline uint32_t delta_upload_weak(const uint8_t *p, uint32_t n) {
+    uint32_t a = 0, b = 0;
+
+    while (n--) {
+        a += *p++;
+        b += a;
+    }
+    return (a & 0xFFFF) | (b << 16);
+}
+
+#ifndef DELTA_UPLOAD_HOST
+
+#include "crc32.h"
+
+static inline uint32_t delta_upload_get32(uint8_t (*getc)(void)) {
+    uint32_t v = 0;
+
+    for (int i = 0; i < 4; i++) {
+        v |= ((uint32_t)getc()) << (i * 8);
+    }
+    return v;
+}
+
+static inline void delta_upload_put32(void (*putc)(uint8_t), uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        putc((v >> (i * 8)) & 0xFF);
+    }
+}
+
+// Sums of the current content of dst[0, size), after 'B'
+static inline void delta_upload_sums(void (*putc)(uint8_t), const uint8_t *dst,
+                                     uint32_t size, uint32_t block) {
+    for (uint32_t off = 0; off < size; off += block) {
+        uint32_t n = size - off < block ? size - off : block;
+
+        delta_upload_put32(putc, delta_upload_weak(dst + off, n));
+        delta_upload_put32(putc, crc32_calc(dst + off, n));
+    }
+}
+
+// Apply the ops to the image of size bytes at dst up to 'E'. Returns 0, or
+// -1 if an op fell outside the image or was not one of 'M', 'W' and 'E'.
+static inline int delta_upload_apply(uint8_t (*getc)(void), void (*putc)(uint8_t),
+                                     uint8_t *dst, uint32_t size) {
+    int error = 0;
+
+    for (;;) {
+        uint8_t op = getc();
+        uint32_t to, from = 0, length;
+
+        if (op == DELTA_UPLOAD_END) {
+            return error;
+        }
+        if (op != DELTA_UPLOAD_MOVE && op != DELTA_UPLOAD_WRITE) {
+            return -1;
+        }
+        to = delta_upload_get32(getc);
+        if (op == DELTA_UPLOAD_MOVE) {
+            from = delta_upload_get32(getc);
+        }
+        length = delta_upload_get32(getc);
+
+        if (to > size || length > size - to ||
+            (op == DELTA_UPLOAD_MOVE && (from > size || length > size - from))) {
+            error = -1;
+            if (op == DELTA_UPLOAD_MOVE) {
+                putc(DELTA_UPLOAD_MOVED);
+            } else {
+                while (length--) {
+                    getc();
+                }
+            }
+            continue;
+        }
+
+        if (op == DELTA_UPLOAD_WRITE) {
+            for (uint8_t *p = dst + to; length; length--) {
+                *p++ = getc();
+            }
+            continue;
+        }
+
+        // memmove: the ranges may overlap
+        if (to < from) {
+            for (uint32_t i = 0; i < length; i++) {
+                dst[to + i] = dst[from + i];
+            }
+        } else {
+            while (length--) {
+                dst[to + length] = dst[from + length];
+            }
+        }
+        putc(DELTA_UPLOAD_MOVED);
+    }
+}
+
+#endif // DELTA_UPLOAD_HOST
+
+#endif // DELTA_UPLOAD_H
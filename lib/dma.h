@@ -0,0 +1,189 @@
+//===============================================================================
+// Memory DMA (SRAM copy / fill) with the engine at 0x80000100
+// memcpy()/memset() replacements for large, word-aligned SRAM buffers
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// hdl/mem_dma.v moves whole words between SRAM addresses while the CPU keeps
+// running from the caches. The engine needs word-aligned SRAM addresses and
+// a multiple of 4 bytes; anything else, short transfers, overlapping copies
+// with dst > src and bitstreams without the engine fall back to plain
+// memcpy()/memmove()/memset(), so callers never need to check.
+//
+// DMA bypasses the caches: these helpers clean the source range and
+// invalidate the destination range in the D-cache before starting. After
+// copying code, invalidate the I-cache as well (cache_sync_code()).
+//
+// Usage:
+//   dma_memcpy(dst, src, len);                 // blocking
+//   if (dma_memcpy_async(dst, src, len)) {     // overlap with other work
+//       ...
+//       dma_wait();
+//   }
+//
+//   uint32_t sum;                              // Internet checksum, aligned
+//   if (dma_chksum(buf, len, &sum))            // middle of a buffer only
+//       csum = ~dma_chksum_fold(sum);
+//
+//===============================================================================
+
+#ifndef DMA_H
+#define DMA_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define MEM_DMA_BASE        0x80000100
+#define MEM_DMA_SRC         (*(volatile uint32_t*)(MEM_DMA_BASE + 0x00))
+#define MEM_DMA_DST         (*(volatile uint32_t*)(MEM_DMA_BASE + 0x04))
+#define MEM_DMA_LEN         (*(volatile uint32_t*)(MEM_DMA_BASE + 0x08))
+#define MEM_DMA_CTRL        (*(volatile uint32_t*)(MEM_DMA_BASE + 0x0C))
+#define MEM_DMA_FILL        (*(volatile uint32_t*)(MEM_DMA_BASE + 0x10))
+#define MEM_DMA_SUM         (*(volatile uint32_t*)(MEM_DMA_BASE + 0x14))
+
+#define MEM_DMA_START       (1 << 0)        // CTRL write: start; read: busy
+#define MEM_DMA_FILL_MODE   (1 << 1)        // Write FILL instead of copying SRC
+#define MEM_DMA_IRQ_EN      (1 << 2)        // Pulse IRQ[3] on completion
+#define MEM_DMA_DONE        (1 << 3)        // CTRL read: last transfer finished
+#define MEM_DMA_CHKSUM      (1 << 3)        // CTRL write: sum SRC into SUM, no writes
+#define MEM_DMA_CHKSUM_MODE (1 << 4)        // CTRL read: checksum mode
+
+#define MEM_DMA_SRAM_END    0x00080000      // Engine only reaches SRAM
+#define MEM_DMA_MAX_LEN     0x000FFFFC
+
+#ifndef DMA_MEMCPY_MIN
+#define DMA_MEMCPY_MIN      64              // Below this the CPU loop is faster
+#endif
+
+// D-cache maintenance (same registers as sd_fatfs/hardware.h)
+#ifndef CACHE_BASE
+#define CACHE_BASE          0x80000060
+#define CACHE_CTRL          (*(volatile uint32_t*)(CACHE_BASE + 0x00))
+#define CACHE_DADDR         (*(volatile uint32_t*)(CACHE_BASE + 0x08))
+#define CACHE_DLEN          (*(volatile uint32_t*)(CACHE_BASE + 0x0C))
+#define CACHE_DCACHE_CLEAN  (1 << 1)
+#define CACHE_DCACHE_INV    (1 << 2)
+#endif
+
+static inline void dma_dcache_op(uint32_t op, uint32_t addr, uint32_t len) {
+    CACHE_DADDR = addr;
+    CACHE_DLEN = len;
+    CACHE_CTRL = op;
+    while (CACHE_CTRL & CACHE_DCACHE_CLEAN);  // Busy bit covers both operations
+}
+
+static inline int dma_present(void) {
+    // Unmapped MMIO reads return 0: FILL only reads back on real hardware
+    MEM_DMA_FILL = 0xA5C3965A;
+    return MEM_DMA_FILL == 0xA5C3965A;
+}
+
+static inline int dma_busy(void) {
+    return (MEM_DMA_CTRL & MEM_DMA_START) != 0;
+}
+
+static inline void dma_wait(void) {
+    while (dma_busy());
+}
+
+static inline int dma_usable(uint32_t addr, uint32_t len) {
+    return ((addr | len) & 3) == 0 && len >= DMA_MEMCPY_MIN &&
+           len <= MEM_DMA_MAX_LEN && addr + len <= MEM_DMA_SRAM_END;
+}
+
+// Start a copy and return 1, or return 0 without touching memory when the
+// engine cannot do it (caller falls back to memcpy)
+static inline int dma_memcpy_async(void *dst, const void *src, uint32_t len) {
+    uint32_t d = (uint32_t)dst;
+    uint32_t s = (uint32_t)src;
+
+    if (!dma_usable(d, len) || !dma_usable(s, len))
+        return 0;
+    if (d > s && d < s + len)               // Engine copies forward only
+        return 0;
+
+    dma_wait();                             // Registers ignore writes while busy
+    if (!dma_present())
+        return 0;
+
+    dma_dcache_op(CACHE_DCACHE_CLEAN, s, len);
+    dma_dcache_op(CACHE_DCACHE_INV, d, len);
+
+    MEM_DMA_SRC = s;
+    MEM_DMA_DST = d;
+    MEM_DMA_LEN = len;
+    MEM_DMA_CTRL = MEM_DMA_START;
+    return 1;
+}
+
+// Start filling len bytes with the byte value; same rules as dma_memcpy_async()
+static inline int dma_memset_async(void *dst, int value, uint32_t len) {
+    uint32_t d = (uint32_t)dst;
+
+    if (!dma_usable(d, len))
+        return 0;
+
+    dma_wait();
+    if (!dma_present())
+        return 0;
+
+    dma_dcache_op(CACHE_DCACHE_INV, d, len);
+
+    MEM_DMA_FILL = (uint8_t)value * 0x01010101u;
+    MEM_DMA_DST = d;
+    MEM_DMA_LEN = len;
+    MEM_DMA_CTRL = MEM_DMA_START | MEM_DMA_FILL_MODE;
+    return 1;
+}
+
+// Ones-complement sum (RFC 1071) of len bytes at src, added to *sum; returns
+// 0 without touching *sum when the engine cannot do it. Halfwords are summed
+// as loaded (little-endian), like lwIP's own checksum. Blocks until done.
+static inline int dma_chksum(const void *src, uint32_t len, uint32_t *sum) {
+    uint32_t s = (uint32_t)src;
+
+    if (!dma_usable(s, len))
+        return 0;
+
+    dma_wait();
+    if (!dma_present())
+        return 0;
+
+    dma_dcache_op(CACHE_DCACHE_CLEAN, s, len);
+
+    MEM_DMA_SRC = s;
+    MEM_DMA_LEN = len;
+    MEM_DMA_SUM = *sum;
+    MEM_DMA_CTRL = MEM_DMA_START | MEM_DMA_CHKSUM;
+    dma_wait();
+
+    *sum = MEM_DMA_SUM;
+    return 1;
+}
+
+// Fold a 32-bit ones-complement sum to 16 bits
+static inline uint16_t dma_chksum_fold(uint32_t sum) {
+    sum = (sum >> 16) + (sum & 0xFFFF);
+    sum += sum >> 16;
+    return (uint16_t)sum;
+}
+
+static inline void *dma_memcpy(void *dst, const void *src, uint32_t len) {
+    if (dma_memcpy_async(dst, src, len))
+        dma_wait();
+    else
+        memmove(dst, src, len);
+    return dst;
+}
+
+static inline void *dma_memset(void *dst, int value, uint32_t len) {
+    if (dma_memset_async(dst, value, len))
+        dma_wait();
+    else
+        memset(dst, value, len);
+    return dst;
+}
+
+#endif // DMA_H
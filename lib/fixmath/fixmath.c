@@ -0,0 +1,352 @@
+//===============================================================================
+// Fixed-Point Math Library - divide, sqrt, sin/cos, exp/log
+// See fixmath.h for formats, rounding and accuracy
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+
+#include "fixmath.h"
+
+// Leading zeros of a non-zero word (no Zbb, and __clzsi2 is a table walk)
+static inline int fix_clz(uint32_t x) {
+    int n = 0;
+    if (!(x & 0xFFFF0000)) { n += 16; x <<= 16; }
+    if (!(x & 0xFF000000)) { n += 8;  x <<= 8; }
+    if (!(x & 0xF0000000)) { n += 4;  x <<= 4; }
+    if (!(x & 0xC0000000)) { n += 2;  x <<= 2; }
+    if (!(x & 0x80000000)) { n += 1; }
+    return n;
+}
+
+// (a * b) >> 30 for the Q2.30 internals of exp and log
+static inline int32_t mul30(int32_t a, int32_t b) {
+    return (int32_t)(((int64_t)a * b) >> 30);
+}
+
+//==============================================================================
+// Divide
+//==============================================================================
+
+// floor(num * 2^bits / den) with 32-bit DIVU only; the caller makes sure the
+// result fits. Each step shifts in as many quotient bits as the remainder
+// has leading zeros, so a small divisor takes two DIVUs, not sixteen.
+static uint32_t div_shift(uint32_t num, uint32_t den, int bits) {
+    uint32_t res = num / den;
+    uint32_t rem = num - res * den;
+
+    while (bits > 0 && rem != 0) {
+        int s = fix_clz(rem);
+
+        if (s == 0) {
+            // rem << 1 needs 33 bits: one restoring step (rem < den)
+            res <<= 1;
+            if (rem >= den - rem) {
+                rem -= den - rem;
+                res |= 1;
+            } else {
+                rem <<= 1;
+            }
+            bits--;
+            continue;
+        }
+
+        if (s > bits) s = bits;
+        rem <<= s;
+        res <<= s;
+        bits -= s;
+
+        uint32_t d = rem / den;         // < 2^s because the old rem < den
+        res |= d;
+        rem -= d * den;
+    }
+
+    return res << bits;
+}
+
+fix16_t fix16_div(fix16_t a, fix16_t b) {
+    if (b == 0) {
+        return a >= 0 ? FIX16_MAX : FIX16_MIN;
+    }
+
+    uint32_t ua = a < 0 ? -(uint32_t)a : (uint32_t)a;
+    uint32_t ub = b < 0 ? -(uint32_t)b : (uint32_t)b;
+    int neg = (a < 0) != (b < 0);
+
+    if (ua / ub >= 0x8000) {            // Integer part does not fit
+        return neg ? FIX16_MIN : FIX16_MAX;
+    }
+
+    uint32_t q = div_shift(ua, ub, FIX16_SHIFT);
+    return neg ? -(fix16_t)q : (fix16_t)q;
+}
+
+q31_t q31_div(q31_t a, q31_t b) {
+    uint32_t ua = a < 0 ? -(uint32_t)a : (uint32_t)a;
+    uint32_t ub = b < 0 ? -(uint32_t)b : (uint32_t)b;
+    int neg = (a < 0) != (b < 0);
+
+    if (ua >= ub) {
+        return neg ? Q31_MIN : Q31_MAX;
+    }
+
+    uint32_t q = div_shift(ua, ub, 31);
+    return neg ? -(q31_t)q : (q31_t)q;
+}
+
+//==============================================================================
+// Square root
+//==============================================================================
+
+// Digit by digit: the integer half of the root from x, then 16 fraction
+// bits from the remainder shifted up, all in 32 bits
+fix16_t fix16_sqrt(fix16_t x) {
+    if (x <= 0) {
+        return 0;
+    }
+
+    uint32_t num = (uint32_t)x;
+    uint32_t res = 0;
+    uint32_t bit = (num & 0xFFF00000) ? (uint32_t)1 << 30 : (uint32_t)1 << 18;
+
+    while (bit > num) bit >>= 2;
+
+    for (int pass = 0; pass < 2; pass++) {
+        while (bit) {
+            if (num >= res + bit) {
+                num -= res + bit;
+                res = (res >> 1) + bit;
+            } else {
+                res >>= 1;
+            }
+            bit >>= 2;
+        }
+
+        if (pass == 0) {
+            if (num > 0xFFFF) {
+                // num << 16 would overflow: take the next bit (1/2) now
+                num -= res;
+                num = (num << 16) - 0x4000;     // (r + 1/2)^2 = r^2 + r + 1/4
+                res = (res << 16) + 0x8000;
+            } else {
+                num <<= 16;
+                res <<= 16;
+            }
+            bit = (uint32_t)1 << 14;
+        }
+    }
+
+    if (num > res) res++;               // Round to nearest
+    return (fix16_t)res;
+}
+
+// Same digit loop on the 62-bit x << 31
+q31_t q31_sqrt(q31_t x) {
+    if (x <= 0) {
+        return 0;
+    }
+
+    uint64_t num = (uint64_t)x << 31;
+    uint64_t res = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+
+    while (bit > num) bit >>= 2;
+    while (bit) {
+        if (num >= res + bit) {
+            num -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (q31_t)res;
+}
+
+//==============================================================================
+// sin / cos: quarter-wave table, linear interpolation
+//==============================================================================
+
+// sin(i * pi / 512) in Q16.16, i = 0..256
+static const int32_t sin_table[257] = {
+        0,   402,   804,  1206,  1608,  2010,  2412,  2814,
+     3216,  3617,  4019,  4420,  4821,  5222,  5623,  6023,
+     6424,  6824,  7224,  7623,  8022,  8421,  8820,  9218,
+     9616, 10014, 10411, 10808, 11204, 11600, 11996, 12391,
+    12785, 13180, 13573, 13966, 14359, 14751, 15143, 15534,
+    15924, 16314, 16703, 17091, 17479, 17867, 18253, 18639,
+    19024, 19409, 19792, 20175, 20557, 20939, 21320, 21699,
+    22078, 22457, 22834, 23210, 23586, 23961, 24335, 24708,
+    25080, 25451, 25821, 26190, 26558, 26925, 27291, 27656,
+    28020, 28383, 28745, 29106, 29466, 29824, 30182, 30538,
+    30893, 31248, 31600, 31952, 32303, 32652, 33000, 33347,
+    33692, 34037, 34380, 34721, 35062, 35401, 35738, 36075,
+    36410, 36744, 37076, 37407, 37736, 38064, 38391, 38716,
+    39040, 39362, 39683, 40002, 40320, 40636, 40951, 41264,
+    41576, 41886, 42194, 42501, 42806, 43110, 43412, 43713,
+    44011, 44308, 44604, 44898, 45190, 45480, 45769, 46056,
+    46341, 46624, 46906, 47186, 47464, 47741, 48015, 48288,
+    48559, 48828, 49095, 49361, 49624, 49886, 50146, 50404,
+    50660, 50914, 51166, 51417, 51665, 51911, 52156, 52398,
+    52639, 52878, 53114, 53349, 53581, 53812, 54040, 54267,
+    54491, 54714, 54934, 55152, 55368, 55582, 55794, 56004,
+    56212, 56418, 56621, 56823, 57022, 57219, 57414, 57607,
+    57798, 57986, 58172, 58356, 58538, 58718, 58896, 59071,
+    59244, 59415, 59583, 59750, 59914, 60075, 60235, 60392,
+    60547, 60700, 60851, 60999, 61145, 61288, 61429, 61568,
+    61705, 61839, 61971, 62101, 62228, 62353, 62476, 62596,
+    62714, 62830, 62943, 63054, 63162, 63268, 63372, 63473,
+    63572, 63668, 63763, 63854, 63944, 64031, 64115, 64197,
+    64277, 64354, 64429, 64501, 64571, 64639, 64704, 64766,
+    64827, 64884, 64940, 64993, 65043, 65091, 65137, 65180,
+    65220, 65259, 65294, 65328, 65358, 65387, 65413, 65436,
+    65457, 65476, 65492, 65505, 65516, 65525, 65531, 65535,
+    65536
+};
+
+// sin of a binary angle (2^32 = one turn), Q16.16
+static fix16_t sin_turn(uint32_t u) {
+    uint32_t pos = u & 0x3FFFFFFF;      // Position in the quadrant, 2^30 = 90 degrees
+
+    if (u & 0x40000000) {
+        pos = 0x40000000 - pos;         // Falling quadrant: mirror
+    }
+
+    uint32_t idx = pos >> 22;           // 0..256
+    int32_t v = sin_table[idx];
+    if (idx < 256) {
+        int32_t frac = (pos >> 6) & 0xFFFF;
+        v += (int32_t)(((int64_t)(sin_table[idx + 1] - v) * frac) >> 16);
+    }
+
+    return (u & 0x80000000) ? -v : v;
+}
+
+// Radians to binary angle: x * 2^32 / (2 pi), the low 32 bits of the product
+// wrap whole turns away for free
+#define FIX16_RAD_TO_TURN   683565276   // 2^32 / (2 pi) in Q16.16
+
+fix16_t fix16_sin(fix16_t x) {
+    return sin_turn((uint32_t)fix16_mul(x, FIX16_RAD_TO_TURN));
+}
+
+fix16_t fix16_cos(fix16_t x) {
+    return sin_turn((uint32_t)fix16_mul(x, FIX16_RAD_TO_TURN) + 0x40000000);
+}
+
+// phase in Q1.31 is already a binary angle (2^31 = pi)
+q31_t q31_sin(q31_t phase) {
+    int32_t v = sin_turn((uint32_t)phase);
+    if (v >= FIX16_ONE) return Q31_MAX;
+    if (v <= -FIX16_ONE) return Q31_MIN;
+    return (q31_t)((uint32_t)v << 15);
+}
+
+q31_t q31_cos(q31_t phase) {
+    return q31_sin((q31_t)((uint32_t)phase + 0x40000000));
+}
+
+//==============================================================================
+// exp / log
+//==============================================================================
+
+#define LN2_Q30     744261118           // ln 2 in Q2.30
+#define LN2_Q31     1488522236          // ln 2 in Q1.31
+#define INV_LN2_Q16 94548               // 1 / ln 2
+
+// e^x = 2^k * e^r, r = x - k ln 2 in [0, ln 2), e^r by its Taylor series
+// to r^7 in Q2.30 (next term < 2e-6)
+fix16_t fix16_exp(fix16_t x) {
+    static const int32_t coef[8] = {            // 1 / n! in Q2.30
+        1073741824, 1073741824, 536870912, 178956971,
+        44739243, 8947849, 1491308, 213044
+    };
+
+    if (x >= 681391) {                  // ln 32768
+        return FIX16_MAX;
+    }
+    if (x < -772243) {                  // Below half an LSB
+        return 0;
+    }
+
+    int32_t k = fix16_mul(x, INV_LN2_Q16) >> FIX16_SHIFT;     // floor
+    int64_t r31 = ((int64_t)x << 15) - (int64_t)k * LN2_Q31;
+    while (r31 < 0)        { k--; r31 += LN2_Q31; }
+    while (r31 >= LN2_Q31) { k++; r31 -= LN2_Q31; }
+
+    int32_t r = (int32_t)(r31 >> 1);    // Q2.30
+    int32_t p = coef[7];
+    for (int i = 6; i >= 0; i--) {
+        p = coef[i] + mul30(p, r);
+    }
+
+    // p is e^r in Q2.30: to Q16.16 with 2^k folded into the shift
+    int shift = 14 - k;
+    if (shift <= 0) {
+        return (fix16_t)((uint32_t)p << -shift);
+    }
+    if (shift >= 32) {
+        return 0;
+    }
+    return (fix16_t)(((uint32_t)p + ((uint32_t)1 << (shift - 1))) >> shift);
+}
+
+// ln x = e ln 2 + ln m, x = m * 2^e with m in [1, 2), and
+// ln m = 2 atanh(s), s = (m - 1) / (m + 1) < 1/3, series to s^11
+fix16_t fix16_log(fix16_t x) {
+    static const int32_t coef[6] = {            // 1 / (2n + 1) in Q2.30
+        1073741824, 357913941, 214748365, 153391689, 119304647, 97612893
+    };
+
+    if (x <= 0) {
+        return FIX16_MIN;
+    }
+
+    int lz = fix_clz((uint32_t)x);
+    int32_t e = 15 - lz;
+    uint32_t m = (uint32_t)x << (lz - 1);      // Q2.30, [1, 2)
+
+    int32_t s = (int32_t)(div_shift(m - (1u << 30), m + (1u << 30), 30));
+    int32_t s2 = mul30(s, s);
+    int32_t p = coef[5];
+    for (int i = 4; i >= 0; i--) {
+        p = coef[i] + mul30(p, s2);
+    }
+
+    int64_t ln_q30 = (int64_t)e * LN2_Q30 + 2 * (int64_t)mul30(s, p);
+    return (fix16_t)((ln_q30 + (1 << 13)) >> 14);
+}
+
+//==============================================================================
+// C versions of fixmath_rv32.S
+//==============================================================================
+
+#if !(defined(__riscv) && defined(__riscv_mul))
+
+fix16_t fix16_dot(const fix16_t *a, const fix16_t *b, uint32_t n) {
+    int64_t sum = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        sum += (int64_t)a[i] * b[i];
+    }
+    return (fix16_t)(sum >> FIX16_SHIFT);
+}
+
+int fix16_mandel(fix16_t cr, fix16_t ci, int max_iter) {
+    fix16_t zr = 0, zi = 0, zr2 = 0, zi2 = 0;
+    int iter = 0;
+
+    while (iter < max_iter && zr2 + zi2 < 4 * FIX16_ONE) {
+        zi = fix16_mul(zr, zi);
+        zi += zi;                       // 2 * zr * zi
+        zi += ci;
+        zr = zr2 - zi2 + cr;
+        zr2 = fix16_mul(zr, zr);
+        zi2 = fix16_mul(zi, zi);
+        iter++;
+    }
+
+    return iter;
+}
+
+#endif
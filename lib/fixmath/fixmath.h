@@ -0,0 +1,189 @@
+//===============================================================================
+// Fixed-Point Math Library - Q16.16 and Q1.31
+// Shared fixed-point arithmetic for firmware and overlays, so fractional
+// math does not have to go through newlib soft-float
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// fix16_t: Q16.16, range [-32768, 32768), resolution 1/65536
+// q31_t:   Q1.31,  range [-1, 1),         resolution 2^-31
+//
+// Multiplies are inline MUL + MULH (MULHU for the unsigned parts), which
+// needs ENABLE_MUL in the bitstream and -march=rv32im; divides use the
+// 32-bit DIVU only, never the libgcc 64-bit division. Multiplies truncate
+// toward minus infinity (like >> on the 64-bit product) and wrap on
+// overflow; divide, sqrt, exp saturate to FIX16_MAX / FIX16_MIN.
+//
+// fixmath.c has divide, sqrt, sin/cos (256-entry quarter-wave table with
+// linear interpolation) and exp/log; fixmath_rv32.S has the loops where
+// hand-scheduled assembly pays: the unrolled dot product and the
+// Mandelbrot escape-time iteration. Both have C versions for other CPUs.
+//
+// Accuracy (max abs error): sin/cos 3e-5 (4e-5 near |x| = 32768), exp 1e-5
+// relative for x >= 0 and 1 LSB below, log 1e-5. fix16_sqrt is rounded,
+// the divides are exact (truncated), q31_sqrt within 1 LSB.
+//
+// Usage:
+//   #include "fixmath.h"         (CFLAGS += -I../lib/fixmath)
+//   fix16_t r = fix16_mul(fix16_from_int(3), FIX16_PI);
+//   fix16_t s = fix16_sin(r);
+//
+//===============================================================================
+
+#ifndef FIXMATH_H
+#define FIXMATH_H
+
+#include <stdint.h>
+
+typedef int32_t fix16_t;
+typedef int32_t q31_t;
+
+#define FIX16_SHIFT     16
+#define FIX16_ONE       ((fix16_t)0x00010000)
+#define FIX16_HALF      ((fix16_t)0x00008000)
+#define FIX16_MAX       ((fix16_t)0x7FFFFFFF)
+#define FIX16_MIN       ((fix16_t)0x80000000)   // Also "no result" (log(0), x/0)
+
+#define FIX16_PI        ((fix16_t)205887)       // 3.14159
+#define FIX16_HALF_PI   ((fix16_t)102944)
+#define FIX16_TWO_PI    ((fix16_t)411775)
+#define FIX16_E         ((fix16_t)178145)       // 2.71828
+#define FIX16_LN2       ((fix16_t)45426)        // 0.693147
+
+#define Q31_MAX         ((q31_t)0x7FFFFFFF)     // Just below 1.0
+#define Q31_MIN         ((q31_t)0x80000000)     // -1.0
+
+//==============================================================================
+// Conversions (the double ones are meant for constants the compiler folds)
+//==============================================================================
+
+static inline fix16_t fix16_from_int(int32_t i) {
+    return (fix16_t)((uint32_t)i << FIX16_SHIFT);
+}
+
+// Rounds to nearest, halves away from zero
+static inline int32_t fix16_to_int(fix16_t x) {
+    return x >= 0 ? (x + FIX16_HALF) >> FIX16_SHIFT
+                  : -((-x + FIX16_HALF) >> FIX16_SHIFT);
+}
+
+static inline fix16_t fix16_from_double(double d) {
+    return (fix16_t)(d * FIX16_ONE);
+}
+
+static inline double fix16_to_double(fix16_t x) {
+    return (double)x / FIX16_ONE;
+}
+
+static inline fix16_t fix16_from_q31(q31_t x) {
+    return x >> 15;
+}
+
+// |x| must be below 1.0
+static inline q31_t q31_from_fix16(fix16_t x) {
+    return (q31_t)((uint32_t)x << 15);
+}
+
+static inline q31_t q31_from_double(double d) {
+    return d >= 1.0 ? Q31_MAX : (q31_t)(d * 2147483648.0);
+}
+
+static inline double q31_to_double(q31_t x) {
+    return (double)x / 2147483648.0;
+}
+
+//==============================================================================
+// Multiply
+//==============================================================================
+
+#if defined(__riscv) && defined(__riscv_mul)
+
+// (a * b) >> 16: low and high word of the product, then one funnel shift
+static inline fix16_t fix16_mul(fix16_t a, fix16_t b) {
+    int32_t lo, hi;
+    __asm__ ("mul  %0, %2, %3\n\t"
+             "mulh %1, %2, %3"
+             : "=&r"(lo), "=&r"(hi) : "r"(a), "r"(b));
+    return (fix16_t)(((uint32_t)hi << 16) | ((uint32_t)lo >> 16));
+}
+
+// (a * b) >> 31
+static inline q31_t q31_mul(q31_t a, q31_t b) {
+    int32_t lo, hi;
+    __asm__ ("mul  %0, %2, %3\n\t"
+             "mulh %1, %2, %3"
+             : "=&r"(lo), "=&r"(hi) : "r"(a), "r"(b));
+    return (q31_t)(((uint32_t)hi << 1) | ((uint32_t)lo >> 31));
+}
+
+// High word only, (a * b) >> 32: one instruction, one bit short of q31_mul
+static inline q31_t q31_mul_hi(q31_t a, q31_t b) {
+    int32_t hi;
+    __asm__ ("mulh %0, %1, %2" : "=r"(hi) : "r"(a), "r"(b));
+    return hi;
+}
+
+static inline uint32_t fix_mulhu(uint32_t a, uint32_t b) {
+    uint32_t hi;
+    __asm__ ("mulhu %0, %1, %2" : "=r"(hi) : "r"(a), "r"(b));
+    return hi;
+}
+
+#else
+
+static inline fix16_t fix16_mul(fix16_t a, fix16_t b) {
+    return (fix16_t)(((int64_t)a * b) >> FIX16_SHIFT);
+}
+
+static inline q31_t q31_mul(q31_t a, q31_t b) {
+    return (q31_t)(((int64_t)a * b) >> 31);
+}
+
+static inline q31_t q31_mul_hi(q31_t a, q31_t b) {
+    return (q31_t)(((int64_t)a * b) >> 32);
+}
+
+static inline uint32_t fix_mulhu(uint32_t a, uint32_t b) {
+    return (uint32_t)(((uint64_t)a * b) >> 32);
+}
+
+#endif
+
+static inline fix16_t fix16_sq(fix16_t x) {
+    return fix16_mul(x, x);
+}
+
+static inline fix16_t fix16_abs(fix16_t x) {
+    return x < 0 ? -x : x;
+}
+
+//==============================================================================
+// fixmath.c
+//==============================================================================
+
+fix16_t fix16_div(fix16_t a, fix16_t b);    // a / b, truncated toward zero
+fix16_t fix16_sqrt(fix16_t x);              // Rounded; 0 for x <= 0
+fix16_t fix16_sin(fix16_t x);               // Any x, radians
+fix16_t fix16_cos(fix16_t x);
+fix16_t fix16_exp(fix16_t x);               // FIX16_MAX above ~10.4
+fix16_t fix16_log(fix16_t x);               // Natural log; FIX16_MIN for x <= 0
+
+q31_t q31_div(q31_t a, q31_t b);            // |a| < |b|, else saturates
+q31_t q31_sqrt(q31_t x);                    // x in [0, 1); 0 for x <= 0
+q31_t q31_sin(q31_t phase);                 // phase -1..1 = -pi..pi
+q31_t q31_cos(q31_t phase);
+
+//==============================================================================
+// fixmath_rv32.S (C in fixmath.c without the M extension)
+//==============================================================================
+
+// sum(a[i] * b[i]) >> 16 with a 64-bit accumulator (no rounding per term)
+fix16_t fix16_dot(const fix16_t *a, const fix16_t *b, uint32_t n);
+
+// Escape-time iteration of z = z^2 + c from z = 0, same arithmetic as
+// fix16_mul: returns the first iteration with |z|^2 >= 4, or max_iter
+int fix16_mandel(fix16_t cr, fix16_t ci, int max_iter);
+
+#endif // FIXMATH_H
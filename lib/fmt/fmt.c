@@ -0,0 +1,931 @@
+//===============================================================================
+// fmt - Compact Formatted Output
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+
+#include "fmt.h"
+#include <stdint.h>
+
+#define FMT_CHUNK       64      // Sink chunk on the stack
+#define FMT_FLOAT_PREC  17      // Float digits computed, more are zeros
+
+// Flags
+#define F_LEFT      0x01
+#define F_PLUS      0x02
+#define F_SPACE     0x04
+#define F_ALT       0x08
+#define F_ZERO      0x10
+#define F_UPPER     0x20
+#define F_PTR       0x40    // %p: 0x also for NULL
+
+typedef struct {
+    char *p;            // Next byte
+    char *start;
+    char *end;
+    fmt_out_t out;      // NULL: start..end is the caller's, drop the overflow
+    void *ctx;
+    size_t count;       // Bytes produced, dropped ones included
+} fmt_state_t;
+
+//===============================================================================
+// Output
+//===============================================================================
+
+static void flush(fmt_state_t *st) {
+    if (st->p != st->start) {
+        st->out(st->ctx, st->start, st->p - st->start);
+        st->p = st->start;
+    }
+}
+
+static inline void put(fmt_state_t *st, char c) {
+    st->count++;
+    if (st->p == st->end) {
+        if (!st->out) {
+            return;
+        }
+        flush(st);
+    }
+    *st->p++ = c;
+}
+
+static void put_n(fmt_state_t *st, const char *s, size_t n) {
+    st->count += n;
+    while (n) {
+        size_t room = st->end - st->p;
+        if (!room) {
+            if (!st->out) {
+                return;
+            }
+            flush(st);
+            room = st->end - st->p;
+        }
+        if (room > n) {
+            room = n;
+        }
+        n -= room;
+        while (room--) {
+            *st->p++ = *s++;
+        }
+    }
+}
+
+static void pad(fmt_state_t *st, char c, int n) {
+    while (n-- > 0) {
+        put(st, c);
+    }
+}
+
+// prefix (sign, 0x), zeros, then the n digits, padded out to width
+static void emit_field(fmt_state_t *st, const char *prefix, int plen,
+                       int zeros, const char *digits, int n,
+                       int width, int flags) {
+    int fill = width - plen - zeros - n;
+
+    if (!(flags & (F_LEFT | F_ZERO))) {
+        pad(st, ' ', fill);
+    }
+    put_n(st, prefix, plen);
+    if ((flags & (F_LEFT | F_ZERO)) == F_ZERO) {
+        pad(st, '0', fill);
+    }
+    pad(st, '0', zeros);
+    put_n(st, digits, n);
+    if (flags & F_LEFT) {
+        pad(st, ' ', fill);
+    }
+}
+
+//===============================================================================
+// Integers
+//===============================================================================
+
+static const char hex_lower[] = "0123456789abcdef";
+static const char hex_upper[] = "0123456789ABCDEF";
+
+// Digits of v in base 8, 10 or 16, right-aligned ending at end
+static char *utoa32(char *end, uint32_t v, int base, const char *xdigits) {
+    if (base == 10) {
+        do {
+            *--end = '0' + v % 10;
+            v /= 10;
+        } while (v);
+    } else {
+        int shift = base == 16 ? 4 : 3;
+        do {
+            *--end = xdigits[v & (base - 1)];
+            v >>= shift;
+        } while (v);
+    }
+    return end;
+}
+
+static char *utoa64(char *end, uint64_t v, int base, const char *xdigits) {
+    if (base == 10) {
+        while (v >> 32) {
+            *--end = '0' + (int)(v % 10);
+            v /= 10;
+        }
+    } else {
+        int shift = base == 16 ? 4 : 3;
+        while (v >> 32) {
+            *--end = xdigits[v & (base - 1)];
+            v >>= shift;
+        }
+    }
+    return utoa32(end, (uint32_t)v, base, xdigits);
+}
+
+static void fmt_int(fmt_state_t *st, uint64_t v, int neg, int base,
+                    int flags, int width, int prec) {
+    char buf[24];
+    char *end = buf + sizeof(buf);
+    char *d = end;
+    char prefix[2];
+    int plen = 0;
+    const char *xdigits = (flags & F_UPPER) ? hex_upper : hex_lower;
+
+    if (neg) {
+        prefix[plen++] = '-';
+    } else if (flags & F_PLUS) {
+        prefix[plen++] = '+';
+    } else if (flags & F_SPACE) {
+        prefix[plen++] = ' ';
+    }
+
+    if (v || prec != 0) {
+        d = (v >> 32) ? utoa64(end, v, base, xdigits)
+                      : utoa32(end, (uint32_t)v, base, xdigits);
+    }
+    int n = end - d;
+
+    // An explicit precision turns off the 0 flag, the %#o one does not
+    if (prec >= 0) {
+        flags &= ~F_ZERO;
+    }
+    if (flags & F_ALT) {
+        if (base == 16 && (v || (flags & F_PTR))) {
+            prefix[plen++] = '0';
+            prefix[plen++] = (flags & F_UPPER) ? 'X' : 'x';
+        } else if (base == 8 && (n == 0 || d[0] != '0') && prec <= n) {
+            prec = n + 1;       // Leading 0
+        }
+    }
+
+    int zeros = prec > n ? prec - n : 0;
+    emit_field(st, prefix, plen, zeros, d, n, width, flags);
+}
+
+//===============================================================================
+// Floating point
+//===============================================================================
+
+#ifdef CONFIG_FMT_FLOAT
+
+#define BIG_WORDS   36      // 971 + 53 integer bits, 1074 fraction bits
+
+// Float text: buf[0..at), zmid zeros, buf[at..n), zend zeros. The zero
+// runs stand for digits past the computed ones and take no buffer.
+typedef struct {
+    char buf[FMT_FLOAT_PREC + 48];
+    int n;
+    int at;
+    int zmid;
+    int zend;
+} fmt_float_t;
+
+// prec fraction digits of f (0 <= f < 1) into out, rounded half away
+// from zero on the exact binary value; returns the carry into the
+// integer part. f * 2^128 is exact for f >= 2^-75, and anything smaller
+// rounds to zero in the digits asked for here.
+static int frac_digits(char *out, double f, int prec) {
+    union { double d; uint64_t u; } b = { .d = f };
+    int exp = (int)(b.u >> 52) & 0x7FF;
+    uint64_t m = (b.u & 0xFFFFFFFFFFFFFull) | (exp ? 1ull << 52 : 0);
+    int sh = exp - 947;         // f * 2^128 = m << sh
+    uint64_t hi = 0, lo = 0;
+
+    if (sh >= 64) {
+        hi = m << (sh - 64);
+    } else if (sh > 0) {
+        hi = m >> (64 - sh);
+        lo = m << sh;
+    } else if (sh > -64) {
+        lo = m >> -sh;
+    }
+
+    // Each digit is the carry out of the fraction times ten
+    uint32_t w[4] = { (uint32_t)lo, (uint32_t)(lo >> 32),
+                      (uint32_t)hi, (uint32_t)(hi >> 32) };
+    for (int i = 0; i < prec; i++) {
+        uint32_t c = 0;
+        for (int j = 0; j < 4; j++) {
+            uint64_t t = (uint64_t)w[j] * 10 + c;
+            w[j] = (uint32_t)t;
+            c = (uint32_t)(t >> 32);
+        }
+        out[i] = '0' + c;
+    }
+
+    // Remainder from one half up rounds away from zero
+    if (!(w[3] >> 31)) {
+        return 0;
+    }
+    for (int i = prec - 1; i >= 0; i--) {
+        if (out[i] != '9') {
+            out[i]++;
+            return 0;
+        }
+        out[i] = '0';
+    }
+    return 1;
+}
+
+// w[0..n) = m << shift, least significant word first
+static void big_set(uint32_t *w, int n, uint64_t m, int shift) {
+    int q = shift / 32, r = shift % 32;
+
+    for (int i = 0; i < n; i++) {
+        w[i] = 0;
+    }
+    if (q < n) {
+        w[q] = (uint32_t)(m << r);
+    }
+    if (q + 1 < n) {
+        w[q + 1] = (uint32_t)(m >> (32 - r));
+    }
+    if (q + 2 < n && r) {
+        w[q + 2] = (uint32_t)(m >> (64 - r));
+    }
+}
+
+// The 9 digits of chunk c (fewer when lead: no leading zeros) onto the
+// nd digits in dig, up to want; returns how many c has
+static int put_chunk(char *dig, int *nd, int want, uint32_t c, int lead) {
+    char t[9];
+    int n = 0;
+
+    do {
+        t[n++] = c % 10;
+        c /= 10;
+    } while (lead ? c != 0 : n < 9);
+    for (int i = n - 1; i >= 0; i--) {
+        if (*nd < want) {
+            dig[(*nd)++] = t[i];
+        }
+    }
+    return n;
+}
+
+// 1 + prec significant digits of v >= 0 (prec < FMT_FLOAT_PREC) into
+// mant, rounded half away from zero on the exact binary value; returns
+// the decimal exponent. With v = m * 2^s the integer part is divided
+// into 10^9 chunks, only the top three kept, and the fraction is
+// multiplied out 9 digits at a time.
+static int sig_digits(char *mant, double v, int prec) {
+    union { double d; uint64_t u; } b = { .d = v };
+    int exp = (int)(b.u >> 52) & 0x7FF;
+    uint64_t m = (b.u & 0xFFFFFFFFFFFFFull) | (exp ? 1ull << 52 : 0);
+    int s = exp ? exp - 1075 : -1074;
+    uint32_t w[BIG_WORDS];
+    char dig[FMT_FLOAT_PREC + 1];
+    int want = prec + 2;        // One more to round on
+    int nd = 0;
+    int e = -1;
+    int nw;
+
+    // Integer part
+    if (s >= 0) {
+        nw = s / 32 + 3;
+        big_set(w, nw, m, s);
+    } else {
+        nw = 2;
+        big_set(w, nw, s > -64 ? m >> -s : 0, 0);
+    }
+    uint32_t top[3] = { 0, 0, 0 };
+    int chunks = 0;
+    for (;;) {
+        while (nw && !w[nw - 1]) {
+            nw--;
+        }
+        if (!nw) {
+            break;
+        }
+        uint32_t rem = 0;
+        for (int i = nw - 1; i >= 0; i--) {
+            uint64_t t = ((uint64_t)rem << 32) | w[i];
+            w[i] = (uint32_t)(t / 1000000000u);
+            rem = (uint32_t)(t % 1000000000u);
+        }
+        top[2] = top[1];
+        top[1] = top[0];
+        top[0] = rem;
+        chunks++;
+    }
+    if (chunks) {
+        e += put_chunk(dig, &nd, want, top[0], 1) + 9 * (chunks - 1);
+        for (int i = 1; i < 3 && i < chunks; i++) {
+            put_chunk(dig, &nd, want, top[i], 0);
+        }
+    }
+
+    // Fraction, left-aligned in nw words
+    if (s < 0 && nd < want) {
+        int bits = -s;
+        nw = (bits + 31) / 32;
+        big_set(w, nw, bits < 64 ? m & ((1ull << bits) - 1) : m, nw * 32 - bits);
+
+        int lo = 0;
+        while (nd < want) {
+            while (lo < nw && !w[lo]) {
+                lo++;
+            }
+            if (lo == nw) {
+                break;
+            }
+            uint32_t c = 0;
+            for (int i = lo; i < nw; i++) {
+                uint64_t t = (uint64_t)w[i] * 1000000000u + c;
+                w[i] = (uint32_t)t;
+                c = (uint32_t)(t >> 32);
+            }
+            if (nd) {
+                put_chunk(dig, &nd, want, c, 0);
+            } else if (c) {
+                e -= 9 - put_chunk(dig, &nd, want, c, 1);
+            } else {
+                e -= 9;
+            }
+        }
+    }
+    if (!nd) {
+        e = 0;
+    }
+    while (nd < want) {
+        dig[nd++] = 0;
+    }
+
+    // 9.99.. may round to 10
+    if (dig[prec + 1] >= 5) {
+        int i = prec;
+        while (i >= 0 && dig[i] == 9) {
+            dig[i--] = 0;
+        }
+        if (i < 0) {
+            dig[0] = 1;
+            e++;
+        } else {
+            dig[i]++;
+        }
+    }
+    for (int i = 0; i <= prec; i++) {
+        mant[i] = '0' + dig[i];
+    }
+    return e;
+}
+
+// %f text of v >= 0 with prec fraction digits, the ones past cap zeros.
+// From 1.8e19 (beyond uint64_t) the integer part is FMT_FLOAT_PREC
+// significant digits and zeros.
+static void ftoa_fixed(fmt_float_t *f, double v, int prec, int cap, int flags) {
+    f->zmid = 0;
+    f->zend = 0;
+
+    if (v >= 1.8e19) {
+        int e = sig_digits(f->buf, v, FMT_FLOAT_PREC - 1);
+        f->n = FMT_FLOAT_PREC;
+        f->at = f->n;
+        f->zmid = e - (FMT_FLOAT_PREC - 1);
+        if (prec || (flags & F_ALT)) {
+            f->buf[f->n++] = '.';
+        }
+        f->zend = prec;
+        return;
+    }
+
+    uint64_t ip = (uint64_t)v;
+    char frac[FMT_FLOAT_PREC + 16];
+    char digits[24];
+    char *end = digits + sizeof(digits);
+    int exact = prec < cap ? prec : cap > 0 ? cap : 0;
+    int n = 0;
+
+    ip += frac_digits(frac, v - (double)ip, exact);
+
+    char *d = utoa64(end, ip, 10, hex_lower);
+    while (d < end) {
+        f->buf[n++] = *d++;
+    }
+    if (prec || (flags & F_ALT)) {
+        f->buf[n++] = '.';
+    }
+    for (int i = 0; i < exact; i++) {
+        f->buf[n++] = frac[i];
+    }
+    f->n = n;
+    f->at = n;
+    f->zmid = prec - exact;
+}
+
+// %e text of v >= 0, mantissa digits past FMT_FLOAT_PREC zeros
+static void ftoa_exp(fmt_float_t *f, double v, int prec, int flags) {
+    char mant[FMT_FLOAT_PREC];
+    int exact = prec < FMT_FLOAT_PREC - 1 ? prec : FMT_FLOAT_PREC - 1;
+    int e = sig_digits(mant, v, exact);
+    int n;
+
+    f->buf[0] = mant[0];
+    n = 1;
+    if (prec || (flags & F_ALT)) {
+        f->buf[n++] = '.';
+    }
+    for (int i = 1; i <= exact; i++) {
+        f->buf[n++] = mant[i];
+    }
+    f->at = n;
+    f->zmid = prec - exact;
+    f->zend = 0;
+
+    f->buf[n++] = (flags & F_UPPER) ? 'E' : 'e';
+    f->buf[n++] = e < 0 ? '-' : '+';
+    if (e < 0) {
+        e = -e;
+    }
+    if (e >= 100) {
+        f->buf[n++] = '0' + e / 100;
+    }
+    f->buf[n++] = '0' + e / 10 % 10;
+    f->buf[n++] = '0' + e % 10;
+    f->n = n;
+}
+
+// emit_field() with the zero runs of f
+static void emit_float(fmt_state_t *st, const char *prefix, int plen,
+                       const fmt_float_t *f, int width, int flags) {
+    int fill = width - plen - f->n - f->zmid - f->zend;
+
+    if (!(flags & (F_LEFT | F_ZERO))) {
+        pad(st, ' ', fill);
+    }
+    put_n(st, prefix, plen);
+    if ((flags & (F_LEFT | F_ZERO)) == F_ZERO) {
+        pad(st, '0', fill);
+    }
+    put_n(st, f->buf, f->at);
+    pad(st, '0', f->zmid);
+    put_n(st, f->buf + f->at, f->n - f->at);
+    pad(st, '0', f->zend);
+    if (flags & F_LEFT) {
+        pad(st, ' ', fill);
+    }
+}
+
+static void fmt_float(fmt_state_t *st, double v, int conv, int flags,
+                      int width, int prec) {
+    fmt_float_t f;
+    char prefix[1];
+    int plen = 0;
+
+    if (__builtin_signbit(v)) {
+        prefix[plen++] = '-';
+        v = -v;
+    } else if (flags & F_PLUS) {
+        prefix[plen++] = '+';
+    } else if (flags & F_SPACE) {
+        prefix[plen++] = ' ';
+    }
+
+    if (v != v || v > 1.7976931348623157e308) {
+        const char *s = (v != v) ? ((flags & F_UPPER) ? "NAN" : "nan")
+                                 : ((flags & F_UPPER) ? "INF" : "inf");
+        emit_field(st, prefix, plen, 0, s, 3, width, flags & ~F_ZERO);
+        return;
+    }
+
+    if (prec < 0) {
+        prec = 6;
+    }
+
+    if (conv == 'g') {
+        int p = prec ? prec : 1;
+        int x = 0;
+
+        if (v != 0.0) {
+            char mant[FMT_FLOAT_PREC];
+            x = sig_digits(mant, v, (p < FMT_FLOAT_PREC ? p : FMT_FLOAT_PREC) - 1);
+        }
+        if (x < p && x >= -4) {
+            ftoa_fixed(&f, v, p - 1 - x, FMT_FLOAT_PREC - 1 - x, flags);
+        } else {
+            ftoa_exp(&f, v, p - 1, flags);
+        }
+
+        if (!(flags & F_ALT)) {
+            // Drop trailing fraction zeros, before the exponent if any
+            int dot = -1, exp_at = f.n;
+            for (int i = 0; i < f.n; i++) {
+                if (f.buf[i] == '.') {
+                    dot = i;
+                } else if (f.buf[i] == 'e' || f.buf[i] == 'E') {
+                    exp_at = i;
+                }
+            }
+            if (dot >= 0) {
+                int cut = exp_at;
+                if (f.at > dot) {
+                    f.zmid = 0;
+                }
+                f.zend = 0;
+                while (cut > dot + 1 && f.buf[cut - 1] == '0') {
+                    cut--;
+                }
+                if (cut == dot + 1) {
+                    cut = dot;
+                }
+                for (int i = exp_at; i < f.n; i++) {
+                    f.buf[cut + i - exp_at] = f.buf[i];
+                }
+                if (f.at == exp_at) {
+                    f.at = cut;
+                }
+                f.n -= exp_at - cut;
+            }
+        }
+    } else if (conv == 'e') {
+        ftoa_exp(&f, v, prec, flags);
+    } else {
+        ftoa_fixed(&f, v, prec, FMT_FLOAT_PREC, flags);
+    }
+
+    emit_float(st, prefix, plen, &f, width, flags);
+}
+
+#endif // CONFIG_FMT_FLOAT
+
+//===============================================================================
+// Format string
+//===============================================================================
+
+enum { LEN_INT, LEN_CHAR, LEN_SHORT, LEN_LONG, LEN_LLONG, LEN_SIZE, LEN_MAX, LEN_PTRDIFF };
+
+static int run(fmt_state_t *st, const char *fmt, va_list ap) {
+    for (;;) {
+        // Literal text up to the next conversion in one copy
+        const char *lit = fmt;
+        while (*fmt && *fmt != '%') {
+            fmt++;
+        }
+        if (fmt != lit) {
+            put_n(st, lit, fmt - lit);
+        }
+        if (!*fmt) {
+            break;
+        }
+        fmt++;
+
+        // Fast path: conversion without flags, width or length
+        switch (*fmt) {
+        case 'd':
+        case 'i': {
+            int v = va_arg(ap, int);
+            char buf[12];
+            char *end = buf + sizeof(buf);
+            char *d = utoa32(end, v < 0 ? -(uint32_t)v : (uint32_t)v, 10, hex_lower);
+            if (v < 0) {
+                *--d = '-';
+            }
+            put_n(st, d, end - d);
+            fmt++;
+            continue;
+        }
+        case 'u':
+        case 'x': {
+            char buf[11];
+            char *end = buf + sizeof(buf);
+            char *d = utoa32(end, va_arg(ap, unsigned int),
+                             *fmt == 'u' ? 10 : 16, hex_lower);
+            put_n(st, d, end - d);
+            fmt++;
+            continue;
+        }
+        case 's': {
+            const char *s = va_arg(ap, const char *);
+            const char *e;
+            if (!s) {
+                s = "(null)";
+            }
+            for (e = s; *e; e++) {
+            }
+            put_n(st, s, e - s);
+            fmt++;
+            continue;
+        }
+        case 'c':
+            put(st, (char)va_arg(ap, int));
+            fmt++;
+            continue;
+        case '%':
+            put(st, '%');
+            fmt++;
+            continue;
+        }
+
+        // Flags
+        int flags = 0;
+        for (;; fmt++) {
+            if (*fmt == '-') {
+                flags |= F_LEFT;
+            } else if (*fmt == '+') {
+                flags |= F_PLUS;
+            } else if (*fmt == ' ') {
+                flags |= F_SPACE;
+            } else if (*fmt == '#') {
+                flags |= F_ALT;
+            } else if (*fmt == '0') {
+                flags |= F_ZERO;
+            } else {
+                break;
+            }
+        }
+
+        // Width
+        int width = 0;
+        if (*fmt == '*') {
+            width = va_arg(ap, int);
+            if (width < 0) {
+                flags |= F_LEFT;
+                width = -width;
+            }
+            fmt++;
+        } else {
+            while (*fmt >= '0' && *fmt <= '9') {
+                width = width * 10 + (*fmt++ - '0');
+            }
+        }
+
+        // Precision (-1: none)
+        int prec = -1;
+        if (*fmt == '.') {
+            fmt++;
+            prec = 0;
+            if (*fmt == '*') {
+                prec = va_arg(ap, int);
+                if (prec < 0) {
+                    prec = -1;
+                }
+                fmt++;
+            } else {
+                while (*fmt >= '0' && *fmt <= '9') {
+                    prec = prec * 10 + (*fmt++ - '0');
+                }
+            }
+        }
+
+        // Length
+        int len = LEN_INT;
+        switch (*fmt) {
+        case 'h':
+            fmt++;
+            len = LEN_SHORT;
+            if (*fmt == 'h') {
+                fmt++;
+                len = LEN_CHAR;
+            }
+            break;
+        case 'l':
+            fmt++;
+            len = LEN_LONG;
+            if (*fmt == 'l') {
+                fmt++;
+                len = LEN_LLONG;
+            }
+            break;
+        case 'z': fmt++; len = LEN_SIZE; break;
+        case 'j': fmt++; len = LEN_MAX; break;
+        case 't': fmt++; len = LEN_PTRDIFF; break;
+        }
+
+        char conv = *fmt;
+        if (!conv) {
+            break;
+        }
+        fmt++;
+
+        if (conv >= 'A' && conv <= 'Z' && conv != 'C' && conv != 'S') {
+            flags |= F_UPPER;
+            conv += 'a' - 'A';
+        }
+
+        switch (conv) {
+        case 'd':
+        case 'i': {
+            int64_t v;
+            if (len == LEN_LLONG || len == LEN_MAX) {
+                v = va_arg(ap, long long);
+            } else if (len == LEN_LONG) {
+                v = va_arg(ap, long);
+            } else if (len == LEN_PTRDIFF) {
+                v = va_arg(ap, ptrdiff_t);
+            } else if (len == LEN_SIZE) {
+                v = (ptrdiff_t)va_arg(ap, size_t);
+            } else {
+                v = va_arg(ap, int);
+                if (len == LEN_CHAR) {
+                    v = (signed char)v;
+                } else if (len == LEN_SHORT) {
+                    v = (short)v;
+                }
+            }
+            fmt_int(st, v < 0 ? -(uint64_t)v : (uint64_t)v, v < 0, 10,
+                    flags, width, prec);
+            break;
+        }
+
+        case 'u':
+        case 'x':
+        case 'o': {
+            uint64_t v;
+            if (len == LEN_LLONG || len == LEN_MAX) {
+                v = va_arg(ap, unsigned long long);
+            } else if (len == LEN_LONG) {
+                v = va_arg(ap, unsigned long);
+            } else if (len == LEN_SIZE) {
+                v = va_arg(ap, size_t);
+            } else if (len == LEN_PTRDIFF) {
+                v = (size_t)va_arg(ap, ptrdiff_t);
+            } else {
+                v = va_arg(ap, unsigned int);
+                if (len == LEN_CHAR) {
+                    v = (unsigned char)v;
+                } else if (len == LEN_SHORT) {
+                    v = (unsigned short)v;
+                }
+            }
+            fmt_int(st, v, 0, conv == 'u' ? 10 : conv == 'x' ? 16 : 8,
+                    flags & ~(F_PLUS | F_SPACE), width, prec);
+            break;
+        }
+
+        case 'p':
+            fmt_int(st, (uintptr_t)va_arg(ap, void *), 0, 16,
+                    (flags & F_LEFT) | F_ALT | F_PTR, width, -1);
+            break;
+
+        case 'c': {
+            char c = (char)va_arg(ap, int);
+            emit_field(st, "", 0, 0, &c, 1, width, flags & F_LEFT);
+            break;
+        }
+
+        case 's': {
+            const char *s = va_arg(ap, const char *);
+            int n = 0;
+            if (!s) {
+                s = "(null)";
+            }
+            while (s[n] && (prec < 0 || n < prec)) {
+                n++;
+            }
+            emit_field(st, "", 0, 0, s, n, width, flags & F_LEFT);
+            break;
+        }
+
+        case 'f':
+        case 'e':
+        case 'g':
+#ifdef CONFIG_FMT_FLOAT
+            fmt_float(st, va_arg(ap, double), conv, flags, width, prec);
+#else
+            (void)va_arg(ap, double);
+            emit_field(st, "", 0, 0, "?", 1, width, flags & F_LEFT);
+#endif
+            break;
+
+        default:
+            // Unknown conversion: print it as written
+            put(st, '%');
+            put(st, conv);
+            break;
+        }
+    }
+
+    return st->count;
+}
+
+//===============================================================================
+// Entry points
+//===============================================================================
+
+int fmt_vformat(fmt_out_t out, void *ctx, const char *fmt, va_list ap) {
+    char chunk[FMT_CHUNK] __attribute__((aligned(4)));
+    fmt_state_t st = {
+        .p = chunk, .start = chunk, .end = chunk + sizeof(chunk),
+        .out = out, .ctx = ctx, .count = 0
+    };
+    int n = run(&st, fmt, ap);
+
+    flush(&st);
+    return n;
+}
+
+int fmt_format(fmt_out_t out, void *ctx, const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    int n = fmt_vformat(out, ctx, fmt, ap);
+    va_end(ap);
+    return n;
+}
+
+int fmt_vsnprintf(char *buf, size_t size, const char *fmt, va_list ap) {
+    fmt_state_t st = {
+        .p = buf, .start = buf, .end = size ? buf + size - 1 : buf,
+        .out = NULL, .ctx = NULL, .count = 0
+    };
+    int n = run(&st, fmt, ap);
+
+    if (size) {
+        *st.p = '\0';
+    }
+    return n;
+}
+
+int fmt_snprintf(char *buf, size_t size, const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    int n = fmt_vsnprintf(buf, size, fmt, ap);
+    va_end(ap);
+    return n;
+}
+
+//===============================================================================
+// UART sink
+//===============================================================================
+
+#ifdef USE_FREERTOS
+
+extern int _write(int file, char *ptr, int len);
+
+// Through the log ring, in order with stdio output from the other tasks
+void fmt_uart_write(const char *s, size_t n) {
+    _write(1, (char *)s, n);
+}
+
+#else
+
+#define UART_TX_DATA    (*(volatile uint32_t*)0x80000000)
+#define UART_TX_STATUS  (*(volatile uint32_t*)0x80000004)
+#define UART_TX_WORD    (*(volatile uint32_t*)0x80000004)  // Write: queue all byte lanes
+
+#define UART_TX_FIFO    (1u << 31)                  // TX FIFO and TX_WORD present
+#define UART_TX_FREE(s) (((s) >> 16) & 0xFFF)       // Free TX FIFO bytes
+
+void fmt_uart_write(const char *s, size_t n) {
+    while (n) {
+        uint32_t status = UART_TX_STATUS;
+
+        if (!(status & UART_TX_FIFO)) {
+            if (!(status & 0x01)) {
+                UART_TX_DATA = *s++;    // Older bitstream: one byte at a time
+                n--;
+            }
+            continue;
+        }
+
+        size_t room = UART_TX_FREE(status);
+        if (room > n) {
+            room = n;
+        }
+        n -= room;
+
+        for (; room && ((uintptr_t)s & 3); room--) {
+            UART_TX_DATA = *s++;
+        }
+        for (; room >= 4; room -= 4, s += 4) {
+            UART_TX_WORD = *(const uint32_t *)s;
+        }
+        for (; room; room--) {
+            UART_TX_DATA = *s++;
+        }
+    }
+}
+
+#endif
+
+static void uart_out(void *ctx, const char *s, size_t n) {
+    (void)ctx;
+    fmt_uart_write(s, n);
+}
+
+int fmt_vprintf(const char *fmt, va_list ap) {
+    return fmt_vformat(uart_out, NULL, fmt, ap);
+}
+
+int fmt_printf(const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    int n = fmt_vprintf(fmt, ap);
+    va_end(ap);
+    return n;
+}
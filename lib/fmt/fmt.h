@@ -0,0 +1,67 @@
+//===============================================================================
+// fmt - Compact Formatted Output
+// printf without newlib's vfprintf: no malloc, no FILE, straight to the UART
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// The formatter keeps all of its state on the caller's stack (about 150
+// bytes, 300 more with floats), so it is reentrant: tasks and interrupt
+// handlers may format at the same time. Output goes through a 64-byte
+// chunk that is handed to a sink whenever it fills:
+//
+//   fmt_printf()    - UART TX FIFO, a word store per four bytes; under
+//                     USE_FREERTOS through _write() and the log ring
+//   fmt_snprintf()  - formats in place into the caller's buffer
+//   fmt_format()    - any fmt_out_t sink (SD file, SLIP frame, ...)
+//
+// Conversions: %d %i %u %x %X %o %c %s %p %%, flags - + space # 0, width
+// and precision (also *), lengths hh h l ll z j t. 32-bit values never
+// touch 64-bit arithmetic, and a bare %d %u %x %s %c skips the flag parser.
+// %f %e %g (and upper-case) with CONFIG_FMT_FLOAT; without it they print
+// "?" and still consume their argument. %n and %a are not supported.
+//
+// Floats carry 17 digits, any precision beyond prints as zeros: %f up to
+// 17 fraction digits, %e and %g up to 17 significant ones, and %f from
+// 1.8e19 up as 17 significant digits and zeros, positional still. %f
+// Every conversion rounds on the exact binary value, so the digits match
+// newlib except for ties (0.5, 0.25): half away from zero here, to even
+// there.
+//
+// Every entry point carries the printf format attribute, so -Wformat
+// checks the arguments against the format string at compile time.
+//
+// Kconfig PRINTF_FMT puts this behind printf/sprintf/snprintf (and their
+// v variants) in newlib firmware: fmt_newlib.c, linked with --wrap.
+//
+//===============================================================================
+
+#ifndef FMT_H
+#define FMT_H
+
+#include <stdarg.h>
+#include <stddef.h>
+
+#define FMT_PRINTF(f, a)    __attribute__((format(printf, f, a)))
+
+// Receives n formatted bytes (not NUL-terminated)
+typedef void (*fmt_out_t)(void *ctx, const char *s, size_t n);
+
+// Format to a sink. Returns the number of bytes produced.
+int fmt_vformat(fmt_out_t out, void *ctx, const char *fmt, va_list ap);
+int fmt_format(fmt_out_t out, void *ctx, const char *fmt, ...) FMT_PRINTF(3, 4);
+
+// Format to the UART
+int fmt_vprintf(const char *fmt, va_list ap);
+int fmt_printf(const char *fmt, ...) FMT_PRINTF(1, 2);
+
+// Format into buf, always NUL-terminated when size > 0. Returns the length
+// the whole output would have had (C99 snprintf).
+int fmt_vsnprintf(char *buf, size_t size, const char *fmt, va_list ap);
+int fmt_snprintf(char *buf, size_t size, const char *fmt, ...) FMT_PRINTF(3, 4);
+
+// The UART sink on its own (unformatted, blocks while the FIFO is full)
+void fmt_uart_write(const char *s, size_t n);
+
+#endif // FMT_H
@@ -0,0 +1,57 @@
+//===============================================================================
+// fmt - newlib printf Family on lib/fmt (Kconfig PRINTF_FMT)
+//
+// The firmware Makefile links with
+//   -Wl,--wrap=printf,--wrap=vprintf,--wrap=sprintf,--wrap=vsprintf,
+//   --wrap=snprintf,--wrap=vsnprintf
+// so these replace newlib's calls and its vfprintf is never pulled in by
+// them. fprintf(), puts() and putchar() stay on newlib's stdio; printf()
+// flushes stdout first so both keep their order on the terminal.
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+
+#include "fmt.h"
+#include <stdint.h>
+#include <stdio.h>
+
+// sprintf() has no size: everything up to the top of the address space
+#define SPRINTF_SIZE(buf)   ((size_t)(UINTPTR_MAX - (uintptr_t)(buf)))
+
+int __wrap_vprintf(const char *fmt, va_list ap) {
+    fflush(stdout);
+    return fmt_vprintf(fmt, ap);
+}
+
+int __wrap_printf(const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    int n = __wrap_vprintf(fmt, ap);
+    va_end(ap);
+    return n;
+}
+
+int __wrap_vsnprintf(char *buf, size_t size, const char *fmt, va_list ap) {
+    return fmt_vsnprintf(buf, size, fmt, ap);
+}
+
+int __wrap_snprintf(char *buf, size_t size, const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    int n = fmt_vsnprintf(buf, size, fmt, ap);
+    va_end(ap);
+    return n;
+}
+
+int __wrap_vsprintf(char *buf, const char *fmt, va_list ap) {
+    return fmt_vsnprintf(buf, SPRINTF_SIZE(buf), fmt, ap);
+}
+
+int __wrap_sprintf(char *buf, const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    int n = fmt_vsnprintf(buf, SPRINTF_SIZE(buf), fmt, ap);
+    va_end(ap);
+    return n;
+}
@@ -18,11 +18,21 @@
 #define configMAX_PRIORITIES            CONFIG_FREERTOS_MAX_PRIORITIES
 #define configMINIMAL_STACK_SIZE        CONFIG_FREERTOS_MINIMAL_STACK_SIZE
 #define configMAX_TASK_NAME_LEN         16
+#ifdef CONFIG_FREERTOS_OPTIMISED_TASK_SELECTION
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION 1   /* Ready bitmap (portmacro.h) */
+#else
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION 0
+#endif
 
 /* Memory - from Kconfig */
 #define configTOTAL_HEAP_SIZE           CONFIG_FREERTOS_TOTAL_HEAP_SIZE
 #define configSUPPORT_DYNAMIC_ALLOCATION 1
+#ifdef CONFIG_FREERTOS_STATIC_ALLOCATION
+#define configSUPPORT_STATIC_ALLOCATION 1   /* Idle/timer task memory in port.c */
+#else
 #define configSUPPORT_STATIC_ALLOCATION 0
+#endif
+#define configSTACK_DEPTH_TYPE          uint32_t
 
 /* Kernel Features */
 #define configUSE_PREEMPTION            1
@@ -30,6 +40,60 @@
 #define configUSE_16_BIT_TICKS          0
 #define configUSE_MUTEXES               1
 #define configUSE_COUNTING_SEMAPHORES   1
+#define configUSE_TASK_NOTIFICATIONS    1   /* I/O waits in freertos_irq.c */
+
+/* Tickless idle - from Kconfig */
+#ifdef CONFIG_FREERTOS_TICKLESS_IDLE
+#define configUSE_TICKLESS_IDLE         1
+#else
+#define configUSE_TICKLESS_IDLE         0
+#endif
+#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP 2
+
+/* printf() log ring (syscalls.c) checks the scheduler state */
+#define INCLUDE_xTaskGetSchedulerState  1
+
+/* Run-time stats and context switch trace - from Kconfig (freertos_trace.c) */
+#ifdef CONFIG_FREERTOS_RUN_TIME_STATS
+#define configUSE_TRACE_FACILITY        1
+#define configGENERATE_RUN_TIME_STATS   1
+#define configRUN_TIME_COUNTER_TYPE     uint32_t
+extern void vPortRunTimeStatsInit(void);
+extern uint32_t ulPortRunTimeCounter(void);
+extern void vPortTraceSwitchedIn(uint32_t ulTaskNumber);
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()    vPortRunTimeStatsInit()
+#define portGET_RUN_TIME_COUNTER_VALUE()            ulPortRunTimeCounter()
+#define portTRACE_STATS_SWITCHED_IN()   vPortTraceSwitchedIn(pxCurrentTCB->uxTCBNumber)
+#else
+#define configGENERATE_RUN_TIME_STATS   0
+#define portTRACE_STATS_SWITCHED_IN()
+#endif
+
+/* GDB remote stub - make GDB=1 (lib/gdbstub): tasks are GDB's threads */
+#ifdef GDB_STUB
+extern void gdbstub_task_created(void *tcb, const char *name);
+extern void gdbstub_task_deleted(void *tcb);
+#define portGDB_TASK_CREATE(pxNewTCB)   gdbstub_task_created((pxNewTCB), (pxNewTCB)->pcTaskName)
+#define traceTASK_DELETE(pxTCB)         gdbstub_task_deleted(pxTCB)
+#else
+#define portGDB_TASK_CREATE(pxNewTCB)
+#endif
+
+/* Event trace recorder - from Kconfig EVENT_TRACE (lib/trace) */
+#ifdef TRACE_ENABLE
+#define configUSE_TRACE_FACILITY        1
+#include "../trace/trace_freertos.h"
+#endif
+
+#ifndef configUSE_TRACE_FACILITY
+#define configUSE_TRACE_FACILITY        0
+#endif
+#ifndef traceTASK_SWITCHED_IN
+#define traceTASK_SWITCHED_IN()         portTRACE_STATS_SWITCHED_IN()
+#endif
+#ifndef traceTASK_CREATE
+#define traceTASK_CREATE(pxNewTCB)      portGDB_TASK_CREATE(pxNewTCB)
+#endif
 
 /* Hook Functions */
 #define configUSE_IDLE_HOOK             1
@@ -0,0 +1,173 @@
+/*
+ * FreeRTOS heap_5 Regions for PicoRV32 (Kconfig FREERTOS_HEAP_5)
+ *
+ * Region table from the linker symbols for heap_5, and a small first-fit
+ * heap for the scratchpad tail (freertos_heap.h).
+ */
+
+#include <FreeRTOS.h>
+#include <task.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#include "freertos_heap.h"
+
+/* Linker symbols (scripts/gen_linker.sh) */
+extern uint8_t __data_end[], __data_gap_end[];
+extern uint8_t __rtos_heap_start[], __rtos_heap_end[];
+extern uint8_t __sram_tail_start[], __sram_tail_end[];
+extern uint8_t __fastbss_end[], __fastram_end[];
+
+/* heap_5 keeps the pointers: the table has to outlive the call */
+static HeapRegion_t xHeapRegions[4];
+
+/*
+ * Scratchpad heap: free blocks in address order, merged with their
+ * neighbours when freed. A block starts with its header; xSize counts it.
+ */
+typedef struct FastBlock {
+    struct FastBlock *pxNext;
+    size_t xSize;
+} FastBlock_t;
+
+#define FAST_ALIGN          8
+#define FAST_HEADER         ((sizeof(FastBlock_t) + FAST_ALIGN - 1) & ~(size_t)(FAST_ALIGN - 1))
+#define FAST_MIN_SPLIT      (FAST_HEADER * 2)
+
+static FastBlock_t *pxFastFree;
+static uint8_t *pucFastStart, *pucFastEnd;
+static size_t xFastFreeBytes;
+
+static void prvAddRegion(size_t *pxCount, uint8_t *pucStart, uint8_t *pucEnd)
+{
+    if (pucEnd > pucStart && (size_t)(pucEnd - pucStart) >= portHEAP_REGION_MIN) {
+        xHeapRegions[*pxCount].pucStartAddress = pucStart;
+        xHeapRegions[*pxCount].xSizeInBytes = (size_t)(pucEnd - pucStart);
+        (*pxCount)++;
+    }
+}
+
+void vPortHeapRegionsInit(void)
+{
+    size_t xCount = 0;
+    uintptr_t uxStart;
+
+    /* Address order, as heap_5 requires */
+    prvAddRegion(&xCount, __data_end, __data_gap_end);
+    prvAddRegion(&xCount, __rtos_heap_start, __rtos_heap_end);
+    prvAddRegion(&xCount, __sram_tail_start, __sram_tail_end);
+    xHeapRegions[xCount].pucStartAddress = NULL;
+    xHeapRegions[xCount].xSizeInBytes = 0;
+    configASSERT(xCount > 0);
+    vPortDefineHeapRegions(xHeapRegions);
+
+    uxStart = ((uintptr_t)__fastbss_end + FAST_ALIGN - 1) & ~(uintptr_t)(FAST_ALIGN - 1);
+    pucFastStart = (uint8_t *)uxStart;
+    pucFastEnd = (uint8_t *)((uintptr_t)__fastram_end & ~(uintptr_t)(FAST_ALIGN - 1));
+    if (pucFastEnd > pucFastStart && (size_t)(pucFastEnd - pucFastStart) >= FAST_MIN_SPLIT) {
+        pxFastFree = (FastBlock_t *)pucFastStart;
+        pxFastFree->pxNext = NULL;
+        pxFastFree->xSize = (size_t)(pucFastEnd - pucFastStart);
+        xFastFreeBytes = pxFastFree->xSize;
+    } else {
+        pucFastEnd = pucFastStart;
+    }
+}
+
+void *pvPortMallocFast(size_t xWantedSize)
+{
+    FastBlock_t **ppxPrev, *pxBlock;
+    void *pvReturn = NULL;
+    size_t xNeed;
+
+    if (xWantedSize == 0 || xWantedSize > xFastFreeBytes) {
+        return pvPortMalloc(xWantedSize);
+    }
+    xNeed = FAST_HEADER + ((xWantedSize + FAST_ALIGN - 1) & ~(size_t)(FAST_ALIGN - 1));
+
+    vTaskSuspendAll();
+    for (ppxPrev = &pxFastFree; (pxBlock = *ppxPrev) != NULL; ppxPrev = &pxBlock->pxNext) {
+        if (pxBlock->xSize < xNeed) {
+            continue;
+        }
+        if (pxBlock->xSize - xNeed >= FAST_MIN_SPLIT) {
+            FastBlock_t *pxRest = (FastBlock_t *)((uint8_t *)pxBlock + xNeed);
+
+            pxRest->xSize = pxBlock->xSize - xNeed;
+            pxRest->pxNext = pxBlock->pxNext;
+            pxBlock->xSize = xNeed;
+            *ppxPrev = pxRest;
+        } else {
+            *ppxPrev = pxBlock->pxNext;
+        }
+        pxBlock->pxNext = NULL;
+        xFastFreeBytes -= pxBlock->xSize;
+        pvReturn = (uint8_t *)pxBlock + FAST_HEADER;
+        break;
+    }
+    (void)xTaskResumeAll();
+
+    return pvReturn ? pvReturn : pvPortMalloc(xWantedSize);
+}
+
+void vPortFreeFast(void *pv)
+{
+    FastBlock_t *pxBlock, *pxPrev = NULL, *pxNext;
+
+    if ((uint8_t *)pv < pucFastStart || (uint8_t *)pv >= pucFastEnd) {
+        vPortFree(pv);
+        return;
+    }
+    pxBlock = (FastBlock_t *)((uint8_t *)pv - FAST_HEADER);
+
+    vTaskSuspendAll();
+    xFastFreeBytes += pxBlock->xSize;
+    for (pxNext = pxFastFree; pxNext != NULL && pxNext < pxBlock; pxNext = pxNext->pxNext) {
+        pxPrev = pxNext;
+    }
+
+    /* Merge with the block after, then with the one before */
+    if (pxNext != NULL && (uint8_t *)pxBlock + pxBlock->xSize == (uint8_t *)pxNext) {
+        pxBlock->xSize += pxNext->xSize;
+        pxNext = pxNext->pxNext;
+    }
+    pxBlock->pxNext = pxNext;
+    if (pxPrev == NULL) {
+        pxFastFree = pxBlock;
+    } else if ((uint8_t *)pxPrev + pxPrev->xSize == (uint8_t *)pxBlock) {
+        pxPrev->xSize += pxBlock->xSize;
+        pxPrev->pxNext = pxNext;
+    } else {
+        pxPrev->pxNext = pxBlock;
+    }
+    (void)xTaskResumeAll();
+}
+
+size_t xPortGetFreeFastHeapSize(void)
+{
+    return xFastFreeBytes;
+}
+
+size_t xPortGetFastHeapSize(void)
+{
+    return (size_t)(pucFastEnd - pucFastStart);
+}
+
+void vPortHeapRegionsPrint(void)
+{
+    size_t xTotal = 0;
+
+    for (const HeapRegion_t *pxRegion = xHeapRegions; pxRegion->xSizeInBytes; pxRegion++) {
+        printf("  SRAM    0x%05lX-0x%05lX  %6u bytes\r\n",
+               (unsigned long)(uintptr_t)pxRegion->pucStartAddress,
+               (unsigned long)((uintptr_t)pxRegion->pucStartAddress + pxRegion->xSizeInBytes),
+               (unsigned int)pxRegion->xSizeInBytes);
+        xTotal += pxRegion->xSizeInBytes;
+    }
+    printf("  Scratch 0x%05lX-0x%05lX  %6u bytes\r\n",
+           (unsigned long)(uintptr_t)pucFastStart, (unsigned long)(uintptr_t)pucFastEnd,
+           (unsigned int)xPortGetFastHeapSize());
+    printf("  Free: %u of %u bytes SRAM, %u of %u bytes scratchpad\r\n",
+           (unsigned int)xPortGetFreeHeapSize(), (unsigned int)xTotal,
+           (unsigned int)xFastFreeBytes, (unsigned int)xPortGetFastHeapSize());
+}
@@ -0,0 +1,55 @@
+/*
+ * FreeRTOS heap_5 Regions for PicoRV32 (Kconfig FREERTOS_HEAP_5)
+ *
+ * heap_4 takes one configTOTAL_HEAP_SIZE array out of .bss. With heap_5
+ * pvPortMalloc() instead uses every piece of SRAM the linker script
+ * (scripts/gen_linker.sh) leaves free, in address order:
+ *
+ *   __data_end        .. __data_gap_end    gap below .overlay_comm (0x2A000)
+ *   __rtos_heap_start .. __rtos_heap_end   after newlib's share of the heap
+ *                                          (FREERTOS_NEWLIB_HEAP_SIZE)
+ *   __sram_tail_start .. __sram_tail_end   above a separate lwIP pool
+ *
+ * The rest of the scratchpad BRAM after .fastbss is a heap of its own, for
+ * blocks that have to be fast (BRAM, no external SRAM cycles): stacks of
+ * busy tasks, I/O buffers, hot tables:
+ *
+ *   pucStack = pvPortMallocFast(1024);      // Scratchpad, else SRAM
+ *   vPortFreeFast(pucStack);
+ *
+ * startFRT.S calls vPortHeapRegionsInit() before main(), so nothing can
+ * allocate first. vPortHeapRegionsPrint() lists the regions and what is
+ * free in each heap.
+ *
+ * Copyright (c) October 2025 Michael Wolak
+ * Email: mikewolak@gmail.com, mike@epromfoundry.com
+ */
+
+#ifndef FREERTOS_HEAP_H
+#define FREERTOS_HEAP_H
+
+#include <stddef.h>
+#include <FreeRTOS.h>
+
+/* Regions smaller than this are left out */
+#define portHEAP_REGION_MIN             256
+
+/* Hand heap_5 its regions and set up the scratchpad heap (startFRT.S) */
+void vPortHeapRegionsInit(void);
+
+/*
+ * A block from the scratchpad heap, 8-byte aligned. Falls back to
+ * pvPortMalloc() when the scratchpad has no room; vPortFreeFast() frees
+ * either kind.
+ */
+void *pvPortMallocFast(size_t xWantedSize);
+void vPortFreeFast(void *pv);
+
+/* Free bytes in the scratchpad heap, and its total size */
+size_t xPortGetFreeFastHeapSize(void);
+size_t xPortGetFastHeapSize(void);
+
+/* Print the region map and the free bytes of both heaps */
+void vPortHeapRegionsPrint(void);
+
+#endif /* FREERTOS_HEAP_H */
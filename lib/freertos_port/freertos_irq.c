@@ -3,6 +3,11 @@
  *
  * Provides timer interrupt handler for FreeRTOS tick generation.
  * Uses PicoRV32 timer peripheral at 0x80000020.
+ * Also wakes tasks blocked on the UART (IRQ[4] RX, IRQ[5] TX) or on any
+ * other interrupt (SPI / DMA completion) with a direct task notification,
+ * runs the UART stream driver's ISR (freertos_uart.c) when it is started,
+ * calls the application's ISR (pxPortApplicationIsr) for the sources the
+ * port leaves alone, and stretches the tick period while idle (configUSE_TICKLESS_IDLE).
  *
  * Copyright (c) October 2025 Michael Wolak
  * Email: mikewolak@gmail.com, mike@epromfoundry.com
@@ -10,7 +15,10 @@
 
 #include <FreeRTOS.h>
 #include <task.h>
+#include <stddef.h>
 #include <stdint.h>
+#include "../uart_irq.h"
+#include "../trace/trace.h"
 
 //==============================================================================
 // Timer Peripheral Registers (Base: 0x80000020)
@@ -30,6 +38,11 @@
 // Timer status register bits
 #define TIMER_SR_UIF        (1 << 0)    // Update interrupt flag
 
+// UART receive registers
+#define UART_RX_DATA        (*(volatile uint32_t*)0x80000008)
+#define UART_RX_STATUS      (*(volatile uint32_t*)0x8000000C)
+#define UART_RX_AVAIL       (1 << 0)
+
 //==============================================================================
 // Timer Tick Configuration
 //==============================================================================
@@ -38,7 +51,7 @@
  * Timer tick calculation for FreeRTOS:
  *
  * Target: configTICK_RATE_HZ (1000 Hz = 1 ms tick)
- * System clock: configCPU_CLOCK_HZ (50,000,000 Hz = 50 MHz)
+ * System clock: configCPU_CLOCK_HZ (Kconfig SYS_CLK_HZ, 50 MHz default)
  *
  * Timer operation:
  *   - Prescaler (PSC) divides the system clock
@@ -49,16 +62,35 @@
  *   Interrupt frequency = CPU_CLOCK / (PSC + 1) / (ARR + 1)
  *
  * For 1000 Hz (1 ms tick):
- *   PSC = 49  → Clock after prescaler = 50MHz / 50 = 1 MHz
+ *   PSC = CPU_CLOCK / 1 MHz - 1 (49 at 50 MHz, rounded for 65.97 MHz)
+ *         → Clock after prescaler = 1 MHz
  *   ARR = 999 → Interrupt rate = 1MHz / 1000 = 1000 Hz
  *
  * Note: PSC and ARR are 0-indexed (PSC=49 means divide by 50)
  * Verified: timer_clock.c uses PSC=49, ARR=16666 for perfect 60 Hz
  */
 
-#define TIMER_PRESCALER     49      // 50 MHz / 50 = 1 MHz
+#define TIMER_PRESCALER     ((configCPU_CLOCK_HZ + 500000) / 1000000 - 1)   // → 1 MHz
 #define TIMER_AUTO_RELOAD   999     // 1 MHz / 1000 = 1000 Hz (1 ms)
 
+#define TIMER_COUNTS_PER_TICK   (TIMER_AUTO_RELOAD + 1)
+
+// Longest sleep that still fits the 32-bit ARR (about 71 minutes)
+#define TIMER_MAX_SUPPRESSED_TICKS  (0xFFFFFFFFUL / TIMER_COUNTS_PER_TICK - 1)
+
+// Tasks blocked in xPortIrqWait(), notified from the ISR
+static TaskHandle_t xIrqWaiter[32];
+static volatile uint32_t ulIrqWaiting = 0;     // Bit n: xIrqWaiter[n] is set
+static BaseType_t xSchedulerRunning = pdFALSE;
+
+// UART stream driver (freertos_uart.c), set by xPortUartStreamStart(): takes
+// the UART events it armed and returns the rest for xPortUartWait()
+uint32_t (*pxPortUartStreamIsr)(uint32_t ulEvents, BaseType_t *pxSwitchRequired) = NULL;
+
+// Application ISR (portmacro.h), first thing on every interrupt
+__attribute__((section(".fastdata")))
+void (*pxPortApplicationIsr)(uint32_t ulIrqs) = NULL;
+
 //==============================================================================
 // Timer Initialization
 //==============================================================================
@@ -87,6 +119,9 @@ void vPortSetupTimerInterrupt(void)
     // Enable timer in continuous mode (interrupts enabled automatically)
     TIMER_CR = TIMER_CR_ENABLE;
 
+    // Tasks may block on interrupts from here on
+    xSchedulerRunning = pdTRUE;
+
     // Timer is now running and will generate interrupts at 1 KHz
 }
 
@@ -100,6 +135,11 @@ volatile uint32_t timer_irq_count = 0;
 // Yield pending flag - set by portYIELD(), cleared by ISR after context switch
 volatile uint32_t xPortYieldPending = 0;
 
+// Set by the ISR when a switch is due; startFRT.S irq_vec then saves the
+// full context and calls vTaskSwitchContext() (the fast path skips both)
+__attribute__((section(".fastdata")))
+volatile uint32_t xPortSwitchRequired = 0;
+
 /*
  * IRQ Handler - overrides weak symbol from start.S
  *
@@ -117,9 +157,48 @@ volatile uint32_t xPortYieldPending = 0;
  *
  * CRITICAL: Must clear interrupt flag BEFORE calling FreeRTOS functions,
  *           otherwise interrupt will re-trigger immediately!
+ *
+ * Lives in scratchpad RAM (.fastcode) next to the irq_vec context switch.
  */
+__attribute__((section(".fastcode")))
 void irq_handler(uint32_t irqs)
 {
+    BaseType_t xSwitchRequired = pdFALSE;
+
+    if (pxPortApplicationIsr != NULL) {
+        pxPortApplicationIsr(irqs);
+    }
+
+    TRACE_ISR_ENTER_MASK(irqs);
+
+    // UART interrupts are levels: disarm the source, then wake the waiter
+    if (irqs & ((1 << IRQ_UART_RX) | (1 << IRQ_UART_TX))) {
+        uint32_t events = UART_IRQ_STAT & UART_IRQ_EN;
+        uart_irq_disable(events);
+
+        if (pxPortUartStreamIsr != NULL) {
+            events = pxPortUartStreamIsr(events, &xSwitchRequired);
+        }
+
+        if (!(events & UART_IRQ_RX_ALL)) {
+            irqs &= ~(1u << IRQ_UART_RX);
+        }
+        if (!(events & UART_IRQ_TX_LOW)) {
+            irqs &= ~(1u << IRQ_UART_TX);
+        }
+    }
+
+    // Notify each task waiting on an IRQ that fired (one-shot)
+    uint32_t wake = irqs & ulIrqWaiting;
+    if (wake) {
+        ulIrqWaiting &= ~wake;
+        for (uint32_t n = 0; wake; n++, wake >>= 1) {
+            if (wake & 1) {
+                vTaskNotifyGiveFromISR(xIrqWaiter[n], &xSwitchRequired);
+            }
+        }
+    }
+
     // Check if timer interrupt (IRQ bit 0)
     if (irqs & (1 << 0)) {
         // CRITICAL: Clear timer interrupt flag FIRST
@@ -136,26 +215,215 @@ void irq_handler(uint32_t irqs)
         //
         // xTaskIncrementTick() increments xTickCount and checks if any tasks waiting
         // on this tick should be unblocked. It returns pdTRUE if a context switch is needed.
-        BaseType_t xSwitchRequired = xTaskIncrementTick();
+        if (xTaskIncrementTick() != pdFALSE) {
+            xSwitchRequired = pdTRUE;
+        }
 
         // Also check if a task called portYIELD() and is waiting for context switch
         if (xPortYieldPending) {
             xSwitchRequired = pdTRUE;
             xPortYieldPending = 0;  // Clear the pending flag
         }
+    }
+
+    if (xSwitchRequired != pdFALSE) {
+        // A context switch is required (higher priority task now ready)
+        // On return the assembly saves s0-s11 and the PC, then calls
+        // vTaskSwitchContext() and restores from the new task's stack
+        xPortSwitchRequired = 1;
+    }
+
+    TRACE_ISR_EXIT_MASK();
+}
+
+//==============================================================================
+// Tickless Idle
+//==============================================================================
+
+#if configUSE_TICKLESS_IDLE == 1
+
+// Restart the (stopped) timer with ulCounts + 1 counts to the next IRQ,
+// then continue at the normal 1 ms period
+static inline void prvTimerRestart(uint32_t ulCounts)
+{
+    TIMER_ARR = ulCounts;
+    TIMER_CR = TIMER_CR_ENABLE;         // Enabling loads CNT from ARR
+    TIMER_ARR = TIMER_AUTO_RELOAD;      // Used from the next reload on
+}
+
+/*
+ * Called by the idle task (scheduler suspended) when no task is due for
+ * xExpectedIdleTime ticks. Programs one long timer period instead of
+ * taking an interrupt every tick, halts in waitirq until the timer or any
+ * other interrupt fires, then steps the tick count by the ticks that
+ * passed and realigns CNT to the old tick boundaries.
+ *
+ * The timer counts down from ARR and interrupts on reaching 0, so CNT + 1
+ * counts remain in the current tick. Stopping it to reprogram costs a
+ * few cycles (the prescaler phase) per sleep; the tick drifts by that
+ * much against the timebase, never by whole ticks.
+ */
+void vPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime)
+{
+    uint32_t ulCount, ulSleepCounts, ulCompleteTicks;
+
+    if (xExpectedIdleTime > TIMER_MAX_SUPPRESSED_TICKS) {
+        xExpectedIdleTime = TIMER_MAX_SUPPRESSED_TICKS;
+    }
+
+    // IRQs stay pending in the CPU while masked, and waitirq still sees them
+    portDISABLE_INTERRUPTS();
+
+    // Freeze the counter so CNT and UIF are consistent
+    TIMER_CR = 0;
+    ulCount = TIMER_CNT;
+
+    // A task became ready or the tick just fired: carry on as normal
+    if (eTaskConfirmSleepModeStatus() == eAbortSleep || (TIMER_SR & TIMER_SR_UIF)) {
+        prvTimerRestart(ulCount);
+        portENABLE_INTERRUPTS();
+        return;
+    }
+
+    // Rest of this tick plus xExpectedIdleTime - 1 whole ticks
+    ulSleepCounts = ulCount + TIMER_COUNTS_PER_TICK * (xExpectedIdleTime - 1);
+    prvTimerRestart(ulSleepCounts);
 
-        if (xSwitchRequired != pdFALSE) {
-            // A context switch is required (higher priority task now ready)
-            // vTaskSwitchContext() updates pxCurrentTCB to point to new task
-            // When we return from IRQ, the assembly will restore from new task's stack
-            vTaskSwitchContext();
+    (void)vPortWaitForInterrupt();
+
+    TIMER_CR = 0;
+    ulCount = TIMER_CNT;
+
+    if (TIMER_SR & TIMER_SR_UIF) {
+        // Slept the whole period. The timer already reloaded for the next
+        // tick and the pending IRQ counts the last tick when unmasked.
+        ulCompleteTicks = xExpectedIdleTime - 1;
+    } else {
+        // Woken early by another interrupt: ulCount + 1 counts were left
+        // to the final tick boundary
+        ulCompleteTicks = (xExpectedIdleTime - 1) - ulCount / TIMER_COUNTS_PER_TICK;
+        ulCount %= TIMER_COUNTS_PER_TICK;
+    }
+
+    prvTimerRestart(ulCount);
+    vTaskStepTick(ulCompleteTicks);
+
+    portENABLE_INTERRUPTS();
+}
+
+#endif /* configUSE_TICKLESS_IDLE */
+
+//==============================================================================
+// Blocking I/O Waits
+//==============================================================================
+
+/*
+ * Arm a wait for interrupt ulIrq (IRQ_SPI, IRQ_MEM_DMA, ...): the next time
+ * it fires, the ISR sends the calling task a notification. Arm before
+ * starting the operation and check its status afterwards, so a completion
+ * that comes before xPortIrqWait() is not lost. One waiter per IRQ.
+ *
+ * Uses the task's notification value (ulTaskNotifyTake), so a task should
+ * not mix these waits with its own notifications.
+ */
+void vPortIrqArm(uint32_t ulIrq)
+{
+    if (!xSchedulerRunning) {
+        return;
+    }
+
+    // Drop a give from an earlier wait that timed out
+    ulTaskNotifyTake(pdTRUE, 0);
+
+    portENTER_CRITICAL();
+    xIrqWaiter[ulIrq] = xTaskGetCurrentTaskHandle();
+    ulIrqWaiting |= 1u << ulIrq;
+    portEXIT_CRITICAL();
+}
+
+/*
+ * Block until the IRQ armed with vPortIrqArm() fires. Returns pdTRUE when
+ * it did, pdFALSE on timeout (or at once before the scheduler runs).
+ * Shared lines (IRQ[2] is every SPI transfer as well as SPI DMA done) can
+ * wake the task early: re-check the device and re-arm in a loop.
+ */
+BaseType_t xPortIrqWait(uint32_t ulIrq, TickType_t xTicksToWait)
+{
+    BaseType_t xResult;
+
+    if (!xSchedulerRunning) {
+        return pdFALSE;
+    }
+
+    xResult = (ulTaskNotifyTake(pdTRUE, xTicksToWait) != 0) ? pdTRUE : pdFALSE;
+
+    portENTER_CRITICAL();
+    ulIrqWaiting &= ~(1u << ulIrq);
+    xIrqWaiter[ulIrq] = NULL;
+    portEXIT_CRITICAL();
+    return xResult;
+}
+
+/*
+ * Block the calling task until one of the given UART events holds
+ * (UART_IRQ_RX_AVAIL, _RX_WM, _RX_IDLE for RX; UART_IRQ_TX_LOW for TX).
+ * One RX waiter and one TX waiter at a time.
+ *
+ * Returns pdTRUE when an event fired, pdFALSE on timeout (or at once before
+ * the scheduler runs). Level events that already hold fire as soon as they
+ * are enabled, so nothing is missed between the caller's last FIFO check
+ * and the wait. Bitstreams without UART interrupts only time out: keep
+ * xTicksToWait short and re-check the FIFO.
+ */
+BaseType_t xPortUartWait(uint32_t ulEvents, TickType_t xTicksToWait)
+{
+    uint32_t ulIrq = (ulEvents & UART_IRQ_TX_LOW) ? IRQ_UART_TX : IRQ_UART_RX;
+
+    if (!xSchedulerRunning) {
+        return pdFALSE;
+    }
+
+    vPortIrqArm(ulIrq);
+
+    // IRQ_EN read-modify-write races the ISR's disarm
+    portENTER_CRITICAL();
+    if (ulEvents & UART_IRQ_RX_IDLE) {
+        uart_irq_ack();
+    }
+    uart_irq_enable(ulEvents);
+    portEXIT_CRITICAL();
+
+    BaseType_t xResult = xPortIrqWait(ulIrq, xTicksToWait);
+
+    portENTER_CRITICAL();
+    uart_irq_disable(ulEvents);
+    portEXIT_CRITICAL();
+    return xResult;
+}
+
+/*
+ * Read up to len bytes from the UART RX FIFO, sleeping on the RX interrupt
+ * while it is empty. Returns once len bytes arrived or xTicksToWait passed,
+ * with the number of bytes read (0 on timeout).
+ */
+size_t uart_read_timeout(char *buf, size_t len, TickType_t xTicksToWait)
+{
+    TimeOut_t xTimeOut;
+    size_t got = 0;
+
+    vTaskSetTimeOutState(&xTimeOut);
+
+    while (got < len) {
+        while (got < len && (UART_RX_STATUS & UART_RX_AVAIL)) {
+            buf[got++] = UART_RX_DATA & 0xFF;
+        }
+        if (got == len || xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) != pdFALSE) {
+            break;
         }
+        xPortUartWait(UART_IRQ_RX_AVAIL, xTicksToWait);
     }
 
-    // Future: Handle other interrupt sources here
-    // if (irqs & (1 << 1)) { ... }  // UART interrupt
-    // if (irqs & (1 << 2)) { ... }  // GPIO interrupt
-    // etc.
+    return got;
 }
 
 //==============================================================================
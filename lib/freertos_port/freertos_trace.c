@@ -0,0 +1,93 @@
+/*
+ * FreeRTOS Run-Time Stats and Context Switch Trace for PicoRV32
+ *
+ * Run-time counter: the free-running 1 MHz timebase, so each sample is a
+ * single register read. On bitstreams without it the tick count (scaled to
+ * microseconds) stands in, with one tick of resolution.
+ *
+ * Switch trace: vPortTraceSwitchedIn() runs from traceTASK_SWITCHED_IN()
+ * inside vTaskSwitchContext(), which this port only calls from the IRQ
+ * vector (interrupts off), so the ring needs no locking on the write side.
+ *
+ * Copyright (c) October 2025 Michael Wolak
+ * Email: mikewolak@gmail.com, mike@epromfoundry.com
+ */
+
+#include <FreeRTOS.h>
+#include <task.h>
+#include <stdint.h>
+#include "freertos_trace.h"
+#include "../timer.h"
+
+#if (configGENERATE_RUN_TIME_STATS == 1)
+
+#define TRACE_MASK  (CONFIG_FREERTOS_TRACE_ENTRIES - 1)
+
+static BaseType_t xUseTimebase = pdFALSE;
+
+static PortTraceEvent_t xTraceRing[CONFIG_FREERTOS_TRACE_ENTRIES];
+static uint32_t ulTraceHead = 0;        // Total events written
+static uint32_t ulTaskSwitchIns[portTRACE_TASK_SLOTS];
+
+//==============================================================================
+// Run-Time Counter (portCONFIGURE_TIMER_FOR_RUN_TIME_STATS / _GET_..._VALUE)
+//==============================================================================
+
+void vPortRunTimeStatsInit(void)
+{
+    xUseTimebase = timebase_present() ? pdTRUE : pdFALSE;
+}
+
+__attribute__((section(".fastcode")))
+uint32_t ulPortRunTimeCounter(void)
+{
+    if (xUseTimebase) {
+        return timebase_us32();
+    }
+    return xTaskGetTickCount() * (1000000UL / configTICK_RATE_HZ);
+}
+
+//==============================================================================
+// Context Switch Trace
+//==============================================================================
+
+__attribute__((section(".fastcode")))
+void vPortTraceSwitchedIn(uint32_t ulTaskNumber)
+{
+    PortTraceEvent_t *pxEvent = &xTraceRing[ulTraceHead & TRACE_MASK];
+
+    pxEvent->ulTime = ulPortRunTimeCounter();
+    pxEvent->ulTaskNumber = ulTaskNumber;
+    ulTraceHead++;
+    ulTaskSwitchIns[ulTaskNumber % portTRACE_TASK_SLOTS]++;
+}
+
+uint32_t ulPortTraceSnapshot(PortTraceEvent_t *pxEvents, uint32_t ulMax)
+{
+    uint32_t ulCount, ulFirst;
+
+    portENTER_CRITICAL();
+    ulCount = (ulTraceHead < CONFIG_FREERTOS_TRACE_ENTRIES) ? ulTraceHead : CONFIG_FREERTOS_TRACE_ENTRIES;
+    if (ulCount > ulMax) {
+        ulCount = ulMax;
+    }
+    ulFirst = ulTraceHead - ulCount;
+    for (uint32_t i = 0; i < ulCount; i++) {
+        pxEvents[i] = xTraceRing[(ulFirst + i) & TRACE_MASK];
+    }
+    portEXIT_CRITICAL();
+
+    return ulCount;
+}
+
+uint32_t ulPortTraceSwitches(void)
+{
+    return ulTraceHead;
+}
+
+uint32_t ulPortTraceSwitchIns(uint32_t ulTaskNumber)
+{
+    return ulTaskSwitchIns[ulTaskNumber % portTRACE_TASK_SLOTS];
+}
+
+#endif /* configGENERATE_RUN_TIME_STATS */
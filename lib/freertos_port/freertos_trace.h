@@ -0,0 +1,40 @@
+/*
+ * FreeRTOS Run-Time Stats and Context Switch Trace for PicoRV32
+ *
+ * With CONFIG_FREERTOS_RUN_TIME_STATS the kernel's run-time counter is the
+ * 1 MHz timebase (lib/timer.h), so TaskStatus_t.ulRunTimeCounter is in
+ * microseconds, and every switch is recorded in a RAM ring buffer by the
+ * traceTASK_SWITCHED_IN() hook (FreeRTOSConfig.h).
+ *
+ * Copyright (c) October 2025 Michael Wolak
+ * Email: mikewolak@gmail.com, mike@epromfoundry.com
+ */
+
+#ifndef FREERTOS_TRACE_H
+#define FREERTOS_TRACE_H
+
+#include <stdint.h>
+
+#ifndef CONFIG_FREERTOS_TRACE_ENTRIES
+#define CONFIG_FREERTOS_TRACE_ENTRIES   256     /* Power of two */
+#endif
+
+/* Per-task switch counters are indexed by task number modulo this */
+#define portTRACE_TASK_SLOTS            32
+
+typedef struct {
+    uint32_t ulTime;            /* Run-time counter (us) at the switch */
+    uint32_t ulTaskNumber;      /* TaskStatus_t.xTaskNumber switched in */
+} PortTraceEvent_t;
+
+/* Run-time counter frequency (Hz) */
+#define portRUN_TIME_COUNTER_HZ         1000000UL
+
+/* Copy up to ulMax of the latest events, oldest first; returns the count */
+uint32_t ulPortTraceSnapshot(PortTraceEvent_t *pxEvents, uint32_t ulMax);
+
+/* Total switches since boot, and switches into one task */
+uint32_t ulPortTraceSwitches(void);
+uint32_t ulPortTraceSwitchIns(uint32_t ulTaskNumber);
+
+#endif /* FREERTOS_TRACE_H */
@@ -0,0 +1,244 @@
+/*
+ * FreeRTOS UART Stream Driver for PicoRV32
+ *
+ * RX: IRQ[4] fires at the RX watermark or when the line goes idle with
+ * fewer bytes waiting. The ISR empties the FIFO into the RX stream buffer,
+ * which wakes the reader at its trigger level; an idle line wakes it with
+ * whatever arrived (xStreamBufferSendCompletedFromISR). When the stream is
+ * full the interrupt stays off and the FIFO (then the UART's dropped-byte
+ * counter) takes the overflow until the reader makes room.
+ *
+ * TX: IRQ[5] fires while the TX FIFO is at or below portUART_STREAM_TX_LOW.
+ * The ISR refills it from the TX stream buffer, four bytes per word store,
+ * and disarms once the stream is empty; the writer re-arms after queuing.
+ *
+ * irq_handler() (freertos_irq.c) disarms the UART events and hands them to
+ * prvUartStreamIsr() through pxPortUartStreamIsr.
+ *
+ * Copyright (c) October 2025 Michael Wolak
+ * Email: mikewolak@gmail.com, mike@epromfoundry.com
+ */
+
+#include <FreeRTOS.h>
+#include <task.h>
+#include <stream_buffer.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "../uart_irq.h"
+#include "freertos_uart.h"
+#include "../trace/trace.h"
+
+// UART data registers
+#define UART_TX_DATA        (*(volatile uint32_t*)0x80000000)
+#define UART_TX_STATUS      (*(volatile uint32_t*)0x80000004)
+#define UART_TX_WORD        (*(volatile uint32_t*)0x80000004)  // Write: all byte lanes
+#define UART_RX_DATA        (*(volatile uint32_t*)0x80000008)
+#define UART_RX_STATUS      (*(volatile uint32_t*)0x8000000C)
+
+#define UART_TX_FIFO        (1u << 31)                  // TX FIFO and TX_WORD present
+#define UART_TX_FREE(s)     (((s) >> 16) & 0xFFF)       // Free TX FIFO bytes
+#define UART_RX_AVAIL       (1 << 0)
+
+#define UART_STREAM_RX_EVENTS   (UART_IRQ_RX_WM | UART_IRQ_RX_IDLE)
+
+// Bytes moved per stream buffer call in the ISR (on the ISR stack)
+#define UART_STREAM_CHUNK   64
+
+// irq_handler() hook (freertos_irq.c)
+extern uint32_t (*pxPortUartStreamIsr)(uint32_t ulEvents, BaseType_t *pxSwitchRequired);
+
+static StreamBufferHandle_t xRxStream = NULL;
+static StreamBufferHandle_t xTxStream = NULL;
+static volatile uint32_t ulRxStalled = 0;      // Stream full, RX interrupt left off
+
+//==============================================================================
+// Interrupt Side
+//==============================================================================
+
+// FIFO into the RX stream until one is empty or the other full
+static void prvRxDrain(BaseType_t *pxSwitchRequired)
+{
+    uint8_t ucChunk[UART_STREAM_CHUNK];
+    size_t xSpace = xStreamBufferSpacesAvailable(xRxStream);
+    size_t xStart = xSpace;
+    size_t n;
+
+    do {
+        n = 0;
+        while (n < UART_STREAM_CHUNK && n < xSpace && (UART_RX_STATUS & UART_RX_AVAIL)) {
+            ucChunk[n++] = UART_RX_DATA & 0xFF;
+        }
+        if (n) {
+            xStreamBufferSendFromISR(xRxStream, ucChunk, n, pxSwitchRequired);
+            xSpace -= n;
+        }
+    } while (n == UART_STREAM_CHUNK);
+    TRACE_EVENT(TRACE_EV_UART_RX, 0, xStart - xSpace);
+
+    if (xSpace == 0 && (UART_RX_STATUS & UART_RX_AVAIL)) {
+        ulRxStalled = 1;                        // The reader re-arms
+    } else {
+        uart_irq_enable(UART_STREAM_RX_EVENTS);
+    }
+}
+
+// TX stream into the FIFO's free space; disarms once the stream is empty
+static void prvTxFill(BaseType_t *pxSwitchRequired)
+{
+    uint32_t ulChunk[UART_STREAM_CHUNK / 4];
+    const uint8_t *pucChunk = (const uint8_t *)ulChunk;
+    size_t xRoom = UART_TX_FREE(UART_TX_STATUS);
+    size_t xStart = xRoom;
+    size_t n, i;
+
+    while (xRoom) {
+        n = xStreamBufferReceiveFromISR(xTxStream, ulChunk,
+                                        xRoom < UART_STREAM_CHUNK ? xRoom : UART_STREAM_CHUNK,
+                                        pxSwitchRequired);
+        if (n == 0) {
+            break;
+        }
+        xRoom -= n;
+
+        for (i = 0; i + 4 <= n; i += 4) {
+            UART_TX_WORD = ulChunk[i / 4];
+        }
+        for (; i < n; i++) {
+            UART_TX_DATA = pucChunk[i];
+        }
+    }
+    TRACE_EVENT(TRACE_EV_UART_TX, 0, xStart - xRoom);
+
+    if (!xStreamBufferIsEmpty(xTxStream)) {
+        uart_irq_enable(UART_IRQ_TX_LOW);
+    }
+}
+
+// Takes the events this driver armed; returns the rest
+static uint32_t prvUartStreamIsr(uint32_t ulEvents, BaseType_t *pxSwitchRequired)
+{
+    if (xRxStream != NULL && (ulEvents & UART_IRQ_RX_ALL)) {
+        // Idle cleared first, so bytes arriving during the drain raise it again
+        uart_irq_ack();
+        prvRxDrain(pxSwitchRequired);
+        if (ulEvents & UART_IRQ_RX_IDLE) {
+            // End of a burst: wake the reader below the trigger level too
+            xStreamBufferSendCompletedFromISR(xRxStream, pxSwitchRequired);
+        }
+        ulEvents &= ~UART_IRQ_RX_ALL;
+    }
+
+    if (xTxStream != NULL && (ulEvents & UART_IRQ_TX_LOW)) {
+        prvTxFill(pxSwitchRequired);
+        ulEvents &= ~UART_IRQ_TX_LOW;
+    }
+
+    return ulEvents;
+}
+
+//==============================================================================
+// Task Side
+//==============================================================================
+
+BaseType_t xPortUartStreamStart(size_t xRxSize, size_t xRxTrigger, size_t xTxSize)
+{
+    uint32_t ulRxWm = xRxTrigger;
+
+    // Unmapped MMIO reads 0: no UART interrupts in this bitstream
+    uart_irq_disable(UART_IRQ_RX_ALL | UART_IRQ_TX_LOW);
+    uart_irq_enable(UART_IRQ_RX_AVAIL);
+    if (!(UART_IRQ_EN & UART_IRQ_RX_AVAIL)) {
+        return pdFAIL;
+    }
+    uart_irq_disable(UART_IRQ_RX_AVAIL);
+
+    if (xTxSize && !(UART_TX_STATUS & UART_TX_FIFO)) {
+        return pdFAIL;
+    }
+
+    if (xRxTrigger == 0) {
+        xRxTrigger = ulRxWm = 1;
+    }
+    if (ulRxWm > portUART_STREAM_RX_WM_MAX) {
+        ulRxWm = portUART_STREAM_RX_WM_MAX;
+    }
+
+    if (xRxSize) {
+        xRxStream = xStreamBufferCreate(xRxSize, xRxTrigger);
+        if (xRxStream == NULL) {
+            return pdFAIL;
+        }
+    }
+    if (xTxSize) {
+        xTxStream = xStreamBufferCreate(xTxSize, 1);
+        if (xTxStream == NULL) {
+            return pdFAIL;
+        }
+    }
+
+    portENTER_CRITICAL();
+    pxPortUartStreamIsr = prvUartStreamIsr;
+    UART_IRQ_LEVEL = UART_IRQ_LEVELS(xRxStream ? ulRxWm : (UART_IRQ_LEVEL & 0xFFFF),
+                                     xTxStream ? portUART_STREAM_TX_LOW : (UART_IRQ_LEVEL >> 16) & 0xFFFF);
+    if (xRxStream) {
+        uart_irq_ack();
+        // Bytes already waiting below the watermark come in on RX_AVAIL
+        uart_irq_enable(UART_STREAM_RX_EVENTS | UART_IRQ_RX_AVAIL);
+    }
+    portEXIT_CRITICAL();
+
+    return pdPASS;
+}
+
+size_t xPortUartStreamRead(void *pvBuf, size_t xLen, TickType_t xTicksToWait)
+{
+    size_t xGot = xStreamBufferReceive(xRxStream, pvBuf, xLen, xTicksToWait);
+
+    if (ulRxStalled) {
+        // Room again: the ISR takes what piled up in the FIFO meanwhile
+        portENTER_CRITICAL();
+        ulRxStalled = 0;
+        uart_irq_enable(UART_STREAM_RX_EVENTS | UART_IRQ_RX_AVAIL);
+        portEXIT_CRITICAL();
+    }
+
+    return xGot;
+}
+
+size_t xPortUartStreamWrite(const void *pvBuf, size_t xLen, TickType_t xTicksToWait)
+{
+    const uint8_t *pucBuf = (const uint8_t *)pvBuf;
+    TimeOut_t xTimeOut;
+    size_t xSent = 0;
+
+    vTaskSetTimeOutState(&xTimeOut);
+
+    for (;;) {
+        xSent += xStreamBufferSend(xTxStream, pucBuf + xSent, xLen - xSent, 0);
+
+        // IRQ_EN read-modify-write races the ISR's disarm
+        portENTER_CRITICAL();
+        uart_irq_enable(UART_IRQ_TX_LOW);
+        portEXIT_CRITICAL();
+
+        if (xSent == xLen || xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) != pdFALSE) {
+            break;
+        }
+
+        // Full: sleep until the ISR has moved a FIFO's worth out (one
+        // wakeup per refill), then queue as much as fits again
+        xSent += xStreamBufferSend(xTxStream, pucBuf + xSent, 1, xTicksToWait);
+    }
+
+    return xSent;
+}
+
+size_t xPortUartStreamRxAvailable(void)
+{
+    return xRxStream ? xStreamBufferBytesAvailable(xRxStream) : 0;
+}
+
+BaseType_t xPortUartStreamRxActive(void)
+{
+    return xRxStream != NULL ? pdTRUE : pdFALSE;
+}
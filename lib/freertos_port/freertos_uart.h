@@ -0,0 +1,60 @@
+/*
+ * FreeRTOS UART Stream Driver for PicoRV32
+ *
+ * The UART interrupt moves bytes between the hardware FIFOs and two
+ * FreeRTOS stream buffers, a FIFO-full at a time, so tasks read and write
+ * the console or a SLIP link in bulk: a reader is woken once per burst
+ * (xRxTrigger bytes, or the line going idle after fewer), not once per
+ * byte as with a queue of chars.
+ *
+ *   xPortUartStreamStart(1024, 32, 512);       // Before or after the scheduler
+ *
+ *   n = xPortUartStreamRead(buf, sizeof(buf), portMAX_DELAY);
+ *   xPortUartStreamWrite(msg, len, portMAX_DELAY);
+ *
+ * One reader task and one writer task at a time (stream buffer rule).
+ * While the RX stream runs it takes every received byte: xPortUartWait()
+ * and uart_read_timeout() see no RX events. Output written straight to the
+ * UART (printf through syscalls.c, sio_send) is not ordered with the TX
+ * stream; start it with xTxSize 0 to leave TX alone.
+ *
+ * Copyright (c) October 2025 Michael Wolak
+ * Email: mikewolak@gmail.com, mike@epromfoundry.com
+ */
+
+#ifndef FREERTOS_UART_H
+#define FREERTOS_UART_H
+
+#include <stddef.h>
+#include <FreeRTOS.h>
+
+/* RX FIFO level that raises the interrupt: xRxTrigger, at most this */
+#define portUART_STREAM_RX_WM_MAX       128     /* Half the 256-byte RX FIFO */
+
+/* TX FIFO level at or below which the interrupt refills it */
+#define portUART_STREAM_TX_LOW          128     /* Of 512 bytes */
+
+/*
+ * Create the stream buffers (xRxSize / xTxSize bytes, 0 = that direction
+ * unbuffered) and arm the UART interrupt. A reader is woken when
+ * xRxTrigger bytes are buffered, or the line goes idle.
+ *
+ * Returns pdFAIL without the UART interrupt block or TX FIFO (older
+ * bitstreams), or when the heap is short.
+ */
+BaseType_t xPortUartStreamStart(size_t xRxSize, size_t xRxTrigger, size_t xTxSize);
+
+/* Up to xLen bytes, at least one unless xTicksToWait passed (then 0) */
+size_t xPortUartStreamRead(void *pvBuf, size_t xLen, TickType_t xTicksToWait);
+
+/* Queue xLen bytes, blocking up to xTicksToWait for room; returns the
+ * number queued */
+size_t xPortUartStreamWrite(const void *pvBuf, size_t xLen, TickType_t xTicksToWait);
+
+/* Bytes received and queued but not read yet; 0 before the start */
+size_t xPortUartStreamRxAvailable(void);
+
+/* The stream driver has the RX side */
+BaseType_t xPortUartStreamRxActive(void);
+
+#endif /* FREERTOS_UART_H */
@@ -11,8 +11,8 @@
 /* PicoRV32 IRQ control (from portmacro.h) */
 extern uint32_t picorv32_maskirq(uint32_t mask);
 
-/* Critical nesting counter */
-static UBaseType_t uxCriticalNesting = 0;
+/* Critical nesting counter (portmacro.h critical sections) */
+UBaseType_t uxCriticalNesting = 0;
 
 /*
  * Setup the stack of a new task
@@ -29,26 +29,27 @@ StackType_t *pxPortInitialiseStack(StackType_t *pxTopOfStack,
 
     /* Simulate the stack frame as created by context switch
      * Stack layout (grows downward):
-     *   - Task entry point in ra
+     *   - Task entry point in pc and ra
      *   - Parameter in a0
      *   - All other registers zeroed
      */
 
-    /* Leave room for 16 caller-saved registers (64 bytes total)
-     * This matches what startFRT.S irq_vec saves/restores:
-     * ra, a0-a7, t0-t6 */
-    pxTopOfStack -= 16;
+    /* Leave room for the full 128-byte frame that the startFRT.S irq_vec
+     * task switch saves/restores: ra, a0-a7, t0-t6, s0-s11, pc (q0) */
+    pxTopOfStack -= 32;
 
     /* Initialize all registers to zero */
-    memset(pxTopOfStack, 0, 16 * sizeof(StackType_t));
+    memset(pxTopOfStack, 0, 32 * sizeof(StackType_t));
 
     /* Set up initial register values to match stack frame layout:
-     * Stack offset 0: ra (return address) = task entry point
-     * Stack offset 4: a0 (argument 0) = task parameter
+     * Stack offset 0:   ra (return address) = task entry point
+     * Stack offset 4:   a0 (argument 0) = task parameter
+     * Stack offset 112: pc = task entry point
      * When task first runs via retirq, these will be restored
      */
     pxTopOfStack[0] = (StackType_t)pxCode;        /* ra - task entry point */
     pxTopOfStack[1] = (StackType_t)pvParameters;  /* a0 - task parameter */
+    pxTopOfStack[28] = (StackType_t)pxCode;       /* pc - retirq target */
 
     printf("pxPortInitialiseStack: Stored 0x%08lX at pxTopOfStack[0]\r\n",
            (unsigned long)pxTopOfStack[0]);
@@ -92,6 +93,31 @@ BaseType_t xPortStartScheduler(void)
     return pdFALSE;
 }
 
+/*
+ * Highest set bit of a byte, for portGET_HIGHEST_PRIORITY() (portmacro.h);
+ * entry 0 is never used, the idle priority is always ready
+ */
+#if (configUSE_PORT_OPTIMISED_TASK_SELECTION == 1) && !defined(__riscv_zbb)
+const uint8_t ucPortHighestBit[256] = {
+    0, 0, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+    5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+    7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+    7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+    7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+    7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+    7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+    7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+    7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7
+};
+#endif
+
 /*
  * End scheduler (not typically used in embedded)
  */
@@ -102,32 +128,43 @@ void vPortEndScheduler(void)
 }
 
 /*
- * Enter critical section
+ * Static memory for the kernel's own tasks (configSUPPORT_STATIC_ALLOCATION)
  */
-void vPortEnterCritical(void)
-{
-    /* Disable interrupts */
-    picorv32_maskirq(~0);
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+
+#ifdef CONFIG_FREERTOS_IDLE_TASK_SCRATCHPAD
+#define IDLE_TASK_SECTION   __attribute__((section(".fastbss")))
+#else
+#define IDLE_TASK_SECTION
+#endif
 
-    /* Increment nesting count */
-    uxCriticalNesting++;
+static StaticTask_t xIdleTaskTCB IDLE_TASK_SECTION;
+static StackType_t uxIdleTaskStack[configMINIMAL_STACK_SIZE] IDLE_TASK_SECTION;
+
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer,
+                                   StackType_t **ppxIdleTaskStackBuffer,
+                                   configSTACK_DEPTH_TYPE *puxIdleTaskStackSize)
+{
+    *ppxIdleTaskTCBBuffer = &xIdleTaskTCB;
+    *ppxIdleTaskStackBuffer = uxIdleTaskStack;
+    *puxIdleTaskStackSize = configMINIMAL_STACK_SIZE;
 }
 
-/*
- * Exit critical section
- */
-void vPortExitCritical(void)
+#if (configUSE_TIMERS == 1)
+static StaticTask_t xTimerTaskTCB;
+static StackType_t uxTimerTaskStack[configTIMER_TASK_STACK_DEPTH];
+
+void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer,
+                                    StackType_t **ppxTimerTaskStackBuffer,
+                                    configSTACK_DEPTH_TYPE *puxTimerTaskStackSize)
 {
-    /* Decrement nesting count */
-    if (uxCriticalNesting > 0) {
-        uxCriticalNesting--;
-
-        /* Re-enable interrupts if no longer nested */
-        if (uxCriticalNesting == 0) {
-            picorv32_maskirq(0);
-        }
-    }
+    *ppxTimerTaskTCBBuffer = &xTimerTaskTCB;
+    *ppxTimerTaskStackBuffer = uxTimerTaskStack;
+    *puxTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
 }
+#endif
+
+#endif /* configSUPPORT_STATIC_ALLOCATION */
 
 /*
  * Malloc failed hook (required by config)
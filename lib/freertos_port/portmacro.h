@@ -7,7 +7,9 @@
 #ifndef PORTMACRO_H
 #define PORTMACRO_H
 
+#include <stddef.h>
 #include <stdint.h>
+#include "../atomic.h"
 
 /* Type definitions for RV32I */
 #define portSTACK_TYPE      uint32_t
@@ -34,10 +36,11 @@ typedef portUBASE_TYPE   TickType_t;
 #define portTICK_PERIOD_MS        ((TickType_t) 1000 / configTICK_RATE_HZ)
 #define portBYTE_ALIGNMENT        16
 
-/* PicoRV32 IRQ control inline functions (MUST be defined BEFORE use) */
+/* PicoRV32 IRQ control inline functions (MUST be defined BEFORE use);
+ * a compiler barrier like lib/atomic.h's masked sections */
 static inline uint32_t picorv32_maskirq(uint32_t mask) {
     uint32_t old_mask;
-    __asm__ volatile (".insn r 0x0B, 6, 3, %0, %1, x0" : "=r"(old_mask) : "r"(mask));
+    __asm__ volatile (".insn r 0x0B, 6, 3, %0, %1, x0" : "=r"(old_mask) : "r"(mask) : "memory");
     return old_mask;
 }
 
@@ -47,43 +50,143 @@ static inline uint32_t picorv32_getirq(void) {
     return irqs;
 }
 
+/* Halt until an interrupt is pending, masked or not (waitirq): no
+ * instruction fetches meanwhile. Returns the pending bits. */
+static inline uint32_t vPortWaitForInterrupt(void) {
+    uint32_t pending;
+    __asm__ volatile (".insn r 0x0B, 4, 4, %0, x0, x0" : "=r"(pending) : : "memory");
+    return pending;
+}
+
 /* Critical section management using PicoRV32 IRQ masking */
-#define portDISABLE_INTERRUPTS()    picorv32_maskirq(~0)
-#define portENABLE_INTERRUPTS()     picorv32_maskirq(0)
+#define portDISABLE_INTERRUPTS()    ((void)atomic_irq_save())
+#define portENABLE_INTERRUPTS()     atomic_irq_restore(0)
+
+/* Critical section entry/exit: inline, the kernel enters one on every
+ * queue and list operation. One nesting count (port.c), as ISRs never
+ * nest and run with IRQs masked anyway. */
+extern UBaseType_t uxCriticalNesting;
+
+static inline void vPortEnterCritical(void) {
+    (void)atomic_irq_save();
+    uxCriticalNesting++;
+}
+
+static inline void vPortExitCritical(void) {
+    if (uxCriticalNesting > 0 && --uxCriticalNesting == 0) {
+        atomic_irq_restore(0);
+    }
+}
 
-/* Critical section entry/exit (implemented in port.c) */
-extern void vPortEnterCritical(void);
-extern void vPortExitCritical(void);
 #define portENTER_CRITICAL()    vPortEnterCritical()
 #define portEXIT_CRITICAL()     vPortExitCritical()
 
 /* Scheduler utilities */
 extern void vTaskSwitchContext(void);
 
-/* Yield - for PicoRV32 without software interrupts, we use a busy-wait
- * loop to wait for the next timer tick, which will perform the context switch. */
+/* Task selection: one bit per priority with ready tasks; the kernel sets
+ * and clears them as tasks enter and leave the ready lists, and every
+ * switch takes the highest set bit instead of walking down the lists.
+ * RV32IM has no count-leading-zeros (Zbb) and libgcc's __clzsi2 is a
+ * call around a table of its own, so without Zbb it is a 256-entry table of the highest
+ * bit of a byte (port.c), after only the byte steps configMAX_PRIORITIES
+ * needs: none at up to 8 priorities, one at up to 16, two beyond. */
+#if configUSE_PORT_OPTIMISED_TASK_SELECTION == 1
+
+#if configMAX_PRIORITIES > 32
+#error configMAX_PRIORITIES must be 32 or less with configUSE_PORT_OPTIMISED_TASK_SELECTION
+#endif
+
+#ifndef __riscv_zbb
+extern const uint8_t ucPortHighestBit[256];
+#endif
+
+static inline UBaseType_t uxPortHighestPriority(uint32_t ulReady) {
+#if defined(__riscv_zbb)
+    return 31 - (UBaseType_t)__builtin_clz(ulReady);
+#else
+    UBaseType_t uxBase = 0;
+#if configMAX_PRIORITIES > 16
+    if (ulReady & 0xFFFF0000UL) {
+        ulReady >>= 16;
+        uxBase = 16;
+    }
+#endif
+#if configMAX_PRIORITIES > 8
+    if (ulReady & 0xFF00UL) {
+        ulReady >>= 8;
+        uxBase += 8;
+    }
+#endif
+    return uxBase + ucPortHighestBit[ulReady];
+#endif
+}
+
+#define portRECORD_READY_PRIORITY(uxPriority, uxReadyPriorities) \
+    ((uxReadyPriorities) |= (1UL << (uxPriority)))
+#define portRESET_READY_PRIORITY(uxPriority, uxReadyPriorities) \
+    ((uxReadyPriorities) &= ~(1UL << (uxPriority)))
+/* Never empty: the idle task is always ready */
+#define portGET_HIGHEST_PRIORITY(uxTopPriority, uxReadyPriorities) \
+    ((uxTopPriority) = uxPortHighestPriority(uxReadyPriorities))
+
+#endif /* configUSE_PORT_OPTIMISED_TASK_SELECTION */
+
+/* Block on interrupts and UART events (lib/uart_irq.h UART_IRQ_* bits);
+ * the ISR wakes the task with a direct notification (freertos_irq.c) */
+extern void vPortIrqArm(uint32_t ulIrq);
+extern BaseType_t xPortIrqWait(uint32_t ulIrq, TickType_t xTicksToWait);
+extern BaseType_t xPortUartWait(uint32_t ulEvents, TickType_t xTicksToWait);
+extern size_t uart_read_timeout(char *buf, size_t len, TickType_t xTicksToWait);
+
+/* Application ISR (freertos_irq.c), NULL for none: called first on every
+ * interrupt with the pending IRQ mask, for sources the port does not
+ * handle (IRQ_TIMERS, IRQ_BUTTON). IRQs are masked; it clears its own
+ * source and calls no FreeRTOS API (vPortIrqArm() waiters are still
+ * woken by the port afterwards). */
+extern void (*pxPortApplicationIsr)(uint32_t ulIrqs);
+
+/* Tickless idle - stretch the timer period while idle (freertos_irq.c) */
+#if configUSE_TICKLESS_IDLE == 1
+extern void vPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime);
+#define portSUPPRESS_TICKS_AND_SLEEP(xExpectedIdleTime) vPortSuppressTicksAndSleep(xExpectedIdleTime)
+#endif
+
+/* Idle hook body: sleep until the next interrupt, the tick at the latest.
+ * An ISR that readies a task switches to it on return, so no wakeup is
+ * lost; another idle-priority task that is ready runs after that
+ * interrupt too. Tickless idle sleeps in vPortSuppressTicksAndSleep()
+ * instead, over several ticks, so this returns at once there. */
+static inline void vPortIdleWait(void) {
+#if configUSE_TICKLESS_IDLE == 0
+    (void)vPortWaitForInterrupt();
+#endif
+}
+
+/* Yield - for PicoRV32 without software interrupts, we wait for the
+ * next timer tick, which will perform the context switch. The flag is
+ * checked with IRQs masked so the tick cannot come between the check
+ * and waitirq; it is taken when they are enabled again. */
 extern volatile uint32_t xPortYieldPending;
-extern int printf(const char *format, ...);
 static inline void portYIELD(void) {
-    printf("DEBUG: portYIELD called, flag=1\r\n");
     xPortYieldPending = 1;
 
-    /* Ensure interrupts are enabled so timer can fire */
-    portENABLE_INTERRUPTS();
-
-    /* Busy-wait for timer interrupt to perform context switch */
-    printf("DEBUG: Entering busy-wait loop\r\n");
     while (xPortYieldPending) {
-        __asm__ volatile ("nop");
+        portDISABLE_INTERRUPTS();
+        if (xPortYieldPending) {
+            (void)vPortWaitForInterrupt();
+        }
+        portENABLE_INTERRUPTS();
     }
-    printf("DEBUG: portYIELD returned, flag cleared\r\n");
 }
 
 /* Yield from ISR - used by xTaskIncrementTick() and other ISR functions
  * to request a context switch. The actual switch happens when we return
- * from the ISR (in startFRT.S irq_vec). */
+ * from the ISR (in startFRT.S irq_vec), which only saves the callee-saved
+ * registers when this flag is set. */
+extern volatile uint32_t xPortSwitchRequired;
 #define portEND_SWITCHING_ISR(xSwitchRequired) \
-    do { if(xSwitchRequired) vTaskSwitchContext(); } while(0)
+    do { if(xSwitchRequired) xPortSwitchRequired = 1; } while(0)
 
 #define portYIELD_FROM_ISR(x) portEND_SWITCHING_ISR(x)
 
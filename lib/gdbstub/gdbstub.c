@@ -0,0 +1,1011 @@
+//===============================================================================
+// GDB Remote Serial Protocol Stub - Implementation
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+
+#include "gdbstub.h"
+#include "../irq.h"
+#include "../dma.h"
+#include "../pcpi_fpu.h"
+#include "../uart_port.h"
+#include "../watchdog.h"
+#include <string.h>
+
+#define GDB_SIGINT          2
+#define GDB_SIGILL          4
+#define GDB_SIGTRAP         5
+
+#define GDB_REG_PC          32
+#define GDB_NUM_REGS        33
+
+#define GDB_IRQ_EBREAK      1               // PicoRV32 IRQ[1]: EBREAK, ECALL, illegal instruction
+#define GDB_ICACHE_INV      (1 << 0)        // CACHE_CTRL: invalidate all, reads busy
+
+#define GDB_EBREAK          0x00100073
+#define GDB_C_EBREAK        0x9002
+
+// The IRQ frame start.S / startFRT.S built below the interrupted sp
+#ifdef USE_FREERTOS
+#define GDB_FRAME_BYTES     128
+#else
+#define GDB_FRAME_BYTES     64
+#endif
+
+// x0-x31, pc. gdbstub_trap saves gp, tp and s0-s11 here and loads them
+// back after the stop; the rest comes from and goes to the IRQ frame.
+uint32_t gdbstub_regs[GDB_NUM_REGS] __attribute__((used, externally_visible));
+
+// Register -> word in an IRQ frame (a task's frame under FreeRTOS also
+// has s0-s11 at 16-27 and pc at 28); -1: not in the frame
+static const int8_t s_frame_slot[GDB_NUM_REGS] = {
+    -1,  0, -1, -1, -1,  9, 10, 11,     // zero ra sp gp tp t0-t2
+    16, 17,  1,  2,  3,  4,  5,  6,     // s0 s1 a0-a5
+     7,  8, 18, 19, 20, 21, 22, 23,     // a6 a7 s2-s7
+    24, 25, 26, 27, 12, 13, 14, 15,     // s8-s11 t3-t6
+    28                                  // pc
+};
+
+static const char s_hex[] = "0123456789abcdef";
+
+static const char s_target_xml[] =
+    "<?xml version=\"1.0\"?>"
+    "<!DOCTYPE target SYSTEM \"gdb-target.dtd\">"
+    "<target version=\"1.0\">"
+    "<architecture>riscv:rv32</architecture>"
+    "<feature name=\"org.gnu.gdb.riscv.cpu\">"
+    "<reg name=\"zero\" bitsize=\"32\" type=\"int\"/>"
+    "<reg name=\"ra\" bitsize=\"32\" type=\"code_ptr\"/>"
+    "<reg name=\"sp\" bitsize=\"32\" type=\"data_ptr\"/>"
+    "<reg name=\"gp\" bitsize=\"32\" type=\"data_ptr\"/>"
+    "<reg name=\"tp\" bitsize=\"32\" type=\"data_ptr\"/>"
+    "<reg name=\"t0\" bitsize=\"32\" type=\"int\"/>"
+    "<reg name=\"t1\" bitsize=\"32\" type=\"int\"/>"
+    "<reg name=\"t2\" bitsize=\"32\" type=\"int\"/>"
+    "<reg name=\"fp\" bitsize=\"32\" type=\"data_ptr\"/>"
+    "<reg name=\"s1\" bitsize=\"32\" type=\"int\"/>"
+    "<reg name=\"a0\" bitsize=\"32\" type=\"int\"/>"
+    "<reg name=\"a1\" bitsize=\"32\" type=\"int\"/>"
+    "<reg name=\"a2\" bitsize=\"32\" type=\"int\"/>"
+    "<reg name=\"a3\" bitsize=\"32\" type=\"int\"/>"
+    "<reg name=\"a4\" bitsize=\"32\" type=\"int\"/>"
+    "<reg name=\"a5\" bitsize=\"32\" type=\"int\"/>"
+    "<reg name=\"a6\" bitsize=\"32\" type=\"int\"/>"
+    "<reg name=\"a7\" bitsize=\"32\" type=\"int\"/>"
+    "<reg name=\"s2\" bitsize=\"32\" type=\"int\"/>"
+    "<reg name=\"s3\" bitsize=\"32\" type=\"int\"/>"
+    "<reg name=\"s4\" bitsize=\"32\" type=\"int\"/>"
+    "<reg name=\"s5\" bitsize=\"32\" type=\"int\"/>"
+    "<reg name=\"s6\" bitsize=\"32\" type=\"int\"/>"
+    "<reg name=\"s7\" bitsize=\"32\" type=\"int\"/>"
+    "<reg name=\"s8\" bitsize=\"32\" type=\"int\"/>"
+    "<reg name=\"s9\" bitsize=\"32\" type=\"int\"/>"
+    "<reg name=\"s10\" bitsize=\"32\" type=\"int\"/>"
+    "<reg name=\"s11\" bitsize=\"32\" type=\"int\"/>"
+    "<reg name=\"t3\" bitsize=\"32\" type=\"int\"/>"
+    "<reg name=\"t4\" bitsize=\"32\" type=\"int\"/>"
+    "<reg name=\"t5\" bitsize=\"32\" type=\"int\"/>"
+    "<reg name=\"t6\" bitsize=\"32\" type=\"int\"/>"
+    "<reg name=\"pc\" bitsize=\"32\" type=\"code_ptr\"/>"
+    "</feature></target>";
+
+typedef struct {
+    uint32_t addr;
+    uint16_t orig[2];
+    uint8_t len;                            // 2 (c.ebreak) or 4, 0 = free
+} gdb_bp_t;
+
+static uint32_t s_uart;                     // 0: stub off
+static char s_buf[GDB_STUB_PACKET_SIZE + 1];
+static uint8_t s_tx_sum;
+static uint8_t s_noack;
+static uint8_t s_attached;                  // GDB resumed us: report the next stop
+static uint8_t s_interrupt;                 // gdbstub_poll() stopped us
+static uint8_t s_in_packet;                 // gdbstub_poll() already took the '$'
+static uint8_t s_sig;
+
+static gdb_bp_t s_bps[GDB_STUB_MAX_BREAKPOINTS];
+static gdb_bp_t s_step;
+
+//-------------------------------------------------------------------------------
+// Entry from the IRQ vector
+//-------------------------------------------------------------------------------
+
+// Only called from the asm below: kept and not renamed under LTO
+uint32_t gdbstub_handle(uint32_t irqs, uint32_t *frame) __attribute__((used, externally_visible));
+
+// a0 = IRQ mask, sp = frame. The callee-saved registers are not in the
+// frame: they are stored for GDB, and whatever GDB left is loaded back.
+__asm__ (
+    "    .section .text.gdbstub_trap, \"ax\"\n"
+    "    .global gdbstub_trap\n"
+    "gdbstub_trap:\n"
+    "    la   t0, gdbstub_regs\n"
+    "    sw   gp,  12(t0)\n"
+    "    sw   tp,  16(t0)\n"
+    "    sw   s0,  32(t0)\n"
+    "    sw   s1,  36(t0)\n"
+    "    sw   s2,  72(t0)\n"
+    "    sw   s3,  76(t0)\n"
+    "    sw   s4,  80(t0)\n"
+    "    sw   s5,  84(t0)\n"
+    "    sw   s6,  88(t0)\n"
+    "    sw   s7,  92(t0)\n"
+    "    sw   s8,  96(t0)\n"
+    "    sw   s9, 100(t0)\n"
+    "    sw   s10, 104(t0)\n"
+    "    sw   s11, 108(t0)\n"
+    "    addi sp, sp, -16\n"
+    "    sw   ra, 12(sp)\n"
+    "    addi a1, sp, 16\n"
+    "    call gdbstub_handle\n"
+    "    lw   ra, 12(sp)\n"
+    "    addi sp, sp, 16\n"
+    "    la   t0, gdbstub_regs\n"
+    "    lw   s0,  32(t0)\n"
+    "    lw   s1,  36(t0)\n"
+    "    lw   s2,  72(t0)\n"
+    "    lw   s3,  76(t0)\n"
+    "    lw   s4,  80(t0)\n"
+    "    lw   s5,  84(t0)\n"
+    "    lw   s6,  88(t0)\n"
+    "    lw   s7,  92(t0)\n"
+    "    lw   s8,  96(t0)\n"
+    "    lw   s9, 100(t0)\n"
+    "    lw   s10, 104(t0)\n"
+    "    lw   s11, 108(t0)\n"
+    "    lw   tp,  16(t0)\n"
+    "    lw   gp,  12(t0)\n"
+    "    ret\n"
+    "    .text\n"
+);
+
+//-------------------------------------------------------------------------------
+// Packet I/O (polled)
+//-------------------------------------------------------------------------------
+
+static void gdb_putc(char c) {
+    while (UART_PORT_TX_STATUS(s_uart) & UART_PORT_TX_FULL);
+    UART_PORT_TX_DATA(s_uart) = (uint8_t)c;
+}
+
+static int gdb_getc(void) {
+    while (!(UART_PORT_RX_STATUS(s_uart) & UART_PORT_RX_AVAIL)) {
+        watchdog_kick();                    // Halted in GDB is not a hang
+    }
+    return UART_PORT_RX_DATA(s_uart) & 0xFF;
+}
+
+static int gdb_hexval(int c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Next good packet into s_buf (NUL-terminated); returns its length
+static uint32_t gdb_get_packet(void) {
+    for (;;) {
+        uint32_t len = 0;
+        uint8_t sum = 0;
+        int overflow = 0;
+        int c;
+
+        if (!s_in_packet) {
+            while (gdb_getc() != '$');      // Skips acks and stray Ctrl-C
+        }
+        s_in_packet = 0;
+
+        while ((c = gdb_getc()) != '#') {
+            if (c == '$') {                 // Resync on a new start
+                len = 0;
+                sum = 0;
+                overflow = 0;
+                continue;
+            }
+            if (len < GDB_STUB_PACKET_SIZE) {
+                s_buf[len++] = (char)c;
+            } else {
+                overflow = 1;
+            }
+            sum += (uint8_t)c;
+        }
+        c = gdb_hexval(gdb_getc()) << 4;
+        c |= gdb_hexval(gdb_getc());
+
+        if (s_noack) {
+            if (!overflow) {
+                s_buf[len] = 0;
+                return len;
+            }
+        } else if (c == sum && !overflow) {
+            gdb_putc('+');
+            s_buf[len] = 0;
+            return len;
+        } else {
+            gdb_putc('-');
+        }
+    }
+}
+
+// Replies are sent as they are built; only the checksum is kept. A NAK
+// from GDB is not answered with a resend (GDB retries the request).
+static void gdb_reply_begin(void) {
+    gdb_putc('$');
+    s_tx_sum = 0;
+}
+
+static void gdb_reply_char(char c) {
+    gdb_putc(c);
+    s_tx_sum += (uint8_t)c;
+}
+
+static void gdb_reply_str(const char *s) {
+    while (*s) {
+        gdb_reply_char(*s++);
+    }
+}
+
+static void gdb_reply_hex8(uint8_t b) {
+    gdb_reply_char(s_hex[b >> 4]);
+    gdb_reply_char(s_hex[b & 0xF]);
+}
+
+// Register value in target (little-endian) byte order
+static void gdb_reply_reg(uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        gdb_reply_hex8((uint8_t)(v >> (i * 8)));
+    }
+}
+
+// Number, most significant digit first
+static void gdb_reply_num(uint32_t v) {
+    int shift = 28;
+
+    while (shift > 0 && !((v >> shift) & 0xF)) {
+        shift -= 4;
+    }
+    for (; shift >= 0; shift -= 4) {
+        gdb_reply_char(s_hex[(v >> shift) & 0xF]);
+    }
+}
+
+static void gdb_reply_bin(uint8_t b) {
+    if (b == '#' || b == '$' || b == '}' || b == '*') {
+        gdb_reply_char('}');
+        b ^= 0x20;
+    }
+    gdb_reply_char((char)b);
+}
+
+static void gdb_reply_end(void) {
+    gdb_putc('#');
+    gdb_putc(s_hex[s_tx_sum >> 4]);
+    gdb_putc(s_hex[s_tx_sum & 0xF]);
+}
+
+static void gdb_reply(const char *s) {
+    gdb_reply_begin();
+    gdb_reply_str(s);
+    gdb_reply_end();
+}
+
+//-------------------------------------------------------------------------------
+// Parsing
+//-------------------------------------------------------------------------------
+
+static uint32_t gdb_parse_hex(const char **p) {
+    uint32_t v = 0;
+    int d;
+
+    while ((d = gdb_hexval(**p)) >= 0) {
+        v = (v << 4) | (uint32_t)d;
+        (*p)++;
+    }
+    return v;
+}
+
+// Register value in target byte order
+static uint32_t gdb_parse_reg(const char **p) {
+    uint32_t v = 0;
+
+    for (int i = 0; i < 4; i++) {
+        int hi = gdb_hexval((*p)[0]);
+        int lo = gdb_hexval((*p)[1]);
+
+        if (hi < 0 || lo < 0) {
+            break;
+        }
+        v |= (uint32_t)((hi << 4) | lo) << (i * 8);
+        *p += 2;
+    }
+    return v;
+}
+
+// "addr,len" followed by sep; returns 0 if malformed
+static int gdb_parse_range(const char **p, uint32_t *addr, uint32_t *len, char sep) {
+    *addr = gdb_parse_hex(p);
+    if (*(*p)++ != ',') {
+        return 0;
+    }
+    *len = gdb_parse_hex(p);
+    if (sep) {
+        return *(*p)++ == sep;
+    }
+    return **p == 0;
+}
+
+static int gdb_prefix(const char *p, const char *s) {
+    return strncmp(p, s, strlen(s)) == 0;
+}
+
+//-------------------------------------------------------------------------------
+// Memory
+//-------------------------------------------------------------------------------
+
+// Code may have been written: push it out of the D-cache, drop the I-cache
+static void gdb_sync_code(uint32_t addr, uint32_t len) {
+    if (addr >= 0x80000000u) {
+        return;                             // MMIO
+    }
+    dma_dcache_op(CACHE_DCACHE_CLEAN, addr, len);
+    CACHE_CTRL = GDB_ICACHE_INV;
+    while (CACHE_CTRL & GDB_ICACHE_INV);
+}
+
+// Word accesses when address and length allow it, so MMIO registers read
+// and write as they would from code; bytes otherwise
+static void gdb_mem_read(uint32_t addr, uint32_t len, int binary) {
+    int words = ((addr | len) & 3) == 0;
+
+    for (uint32_t i = 0; i < len; ) {
+        uint32_t v;
+        int n;
+
+        if (words) {
+            v = *(volatile uint32_t *)(addr + i);
+            n = 4;
+        } else {
+            v = *(volatile uint8_t *)(addr + i);
+            n = 1;
+        }
+        for (int k = 0; k < n; k++, v >>= 8) {
+            if (binary) {
+                gdb_reply_bin((uint8_t)v);
+            } else {
+                gdb_reply_hex8((uint8_t)v);
+            }
+        }
+        i += (uint32_t)n;
+    }
+}
+
+static void gdb_mem_write(uint32_t addr, const uint8_t *src, uint32_t len) {
+    if (((addr | len) & 3) == 0) {
+        for (uint32_t i = 0; i < len; i += 4) {
+            uint32_t v;
+
+            memcpy(&v, src + i, 4);
+            *(volatile uint32_t *)(addr + i) = v;
+        }
+    } else {
+        for (uint32_t i = 0; i < len; i++) {
+            *(volatile uint8_t *)(addr + i) = src[i];
+        }
+    }
+    gdb_sync_code(addr, len);
+}
+
+static uint16_t gdb_read16(uint32_t addr) {
+    return *(volatile uint16_t *)addr;
+}
+
+static void gdb_write16(uint32_t addr, uint16_t v) {
+    *(volatile uint16_t *)addr = v;
+}
+
+//-------------------------------------------------------------------------------
+// Breakpoints (halfword accesses: RV32C code is only 2-byte aligned)
+//-------------------------------------------------------------------------------
+
+static void gdb_bp_insert(gdb_bp_t *bp, uint32_t addr, uint32_t len) {
+    bp->addr = addr;
+    bp->len = (uint8_t)len;
+    bp->orig[0] = gdb_read16(addr);
+    if (len == 4) {
+        bp->orig[1] = gdb_read16(addr + 2);
+        gdb_write16(addr, (uint16_t)GDB_EBREAK);
+        gdb_write16(addr + 2, (uint16_t)(GDB_EBREAK >> 16));
+    } else {
+        gdb_write16(addr, GDB_C_EBREAK);
+    }
+    gdb_sync_code(addr, len);
+}
+
+static void gdb_bp_remove(gdb_bp_t *bp) {
+    if (!bp->len) {
+        return;
+    }
+    gdb_write16(bp->addr, bp->orig[0]);
+    if (bp->len == 4) {
+        gdb_write16(bp->addr + 2, bp->orig[1]);
+    }
+    gdb_sync_code(bp->addr, bp->len);
+    bp->len = 0;
+}
+
+static gdb_bp_t *gdb_bp_find(uint32_t addr) {
+    for (int i = 0; i < GDB_STUB_MAX_BREAKPOINTS; i++) {
+        if (s_bps[i].len && s_bps[i].addr == addr) {
+            return &s_bps[i];
+        }
+    }
+    return 0;
+}
+
+static int gdb_bp_set(uint32_t addr, uint32_t kind) {
+    if (gdb_bp_find(addr)) {
+        return 0;
+    }
+    for (int i = 0; i < GDB_STUB_MAX_BREAKPOINTS; i++) {
+        if (!s_bps[i].len) {
+            gdb_bp_insert(&s_bps[i], addr, kind == 2 ? 2 : 4);
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static void gdb_bp_clear_all(void) {
+    for (int i = 0; i < GDB_STUB_MAX_BREAKPOINTS; i++) {
+        gdb_bp_remove(&s_bps[i]);
+    }
+}
+
+static int gdb_insn_len(uint32_t addr) {
+    return (gdb_read16(addr) & 3) == 3 ? 4 : 2;
+}
+
+static int gdb_is_ebreak(uint32_t addr, int len) {
+    if (len == 2) {
+        return gdb_read16(addr) == GDB_C_EBREAK;
+    }
+    return (gdb_read16(addr) | ((uint32_t)gdb_read16(addr + 2) << 16)) == GDB_EBREAK;
+}
+
+//-------------------------------------------------------------------------------
+// Single step: where the instruction at pc goes next
+//-------------------------------------------------------------------------------
+
+static uint32_t gdb_sext(uint32_t v, int bits) {
+    return (uint32_t)((int32_t)(v << (32 - bits)) >> (32 - bits));
+}
+
+static uint32_t gdb_x(uint32_t n) {
+    return n ? gdbstub_regs[n] : 0;
+}
+
+static uint32_t gdb_next_pc(uint32_t pc) {
+    uint32_t lo = gdb_read16(pc);
+
+    if ((lo & 3) == 3) {
+        uint32_t i = lo | ((uint32_t)gdb_read16(pc + 2) << 16);
+        uint32_t rs1 = gdb_x((i >> 15) & 31);
+        uint32_t rs2 = gdb_x((i >> 20) & 31);
+        uint32_t imm;
+        int taken;
+
+        switch (i & 0x7F) {
+        case 0x6F:                          // JAL
+            imm = ((i >> 31) & 1) << 20 | ((i >> 12) & 0xFF) << 12 |
+                  ((i >> 20) & 1) << 11 | ((i >> 21) & 0x3FF) << 1;
+            return pc + gdb_sext(imm, 21);
+        case 0x67:                          // JALR
+            return (rs1 + gdb_sext(i >> 20, 12)) & ~1u;
+        case 0x63:                          // Branches
+            imm = ((i >> 31) & 1) << 12 | ((i >> 7) & 1) << 11 |
+                  ((i >> 25) & 0x3F) << 5 | ((i >> 8) & 0xF) << 1;
+            switch ((i >> 12) & 7) {
+            case 0:  taken = rs1 == rs2; break;
+            case 1:  taken = rs1 != rs2; break;
+            case 4:  taken = (int32_t)rs1 < (int32_t)rs2; break;
+            case 5:  taken = (int32_t)rs1 >= (int32_t)rs2; break;
+            case 6:  taken = rs1 < rs2; break;
+            case 7:  taken = rs1 >= rs2; break;
+            default: taken = 0; break;
+            }
+            return taken ? pc + gdb_sext(imm, 13) : pc + 4;
+        }
+        return pc + 4;
+    }
+
+    uint32_t funct3 = lo >> 13;
+
+    if ((lo & 3) == 1 && (funct3 == 1 || funct3 == 5)) {        // C.JAL, C.J
+        uint32_t imm = ((lo >> 12) & 1) << 11 | ((lo >> 11) & 1) << 4 |
+                       ((lo >> 9) & 3) << 8 | ((lo >> 8) & 1) << 10 |
+                       ((lo >> 7) & 1) << 6 | ((lo >> 6) & 1) << 7 |
+                       ((lo >> 3) & 7) << 1 | ((lo >> 2) & 1) << 5;
+        return pc + gdb_sext(imm, 12);
+    }
+    if ((lo & 3) == 1 && (funct3 == 6 || funct3 == 7)) {        // C.BEQZ, C.BNEZ
+        uint32_t rs1 = gdb_x(8 + ((lo >> 7) & 7));
+        uint32_t imm = ((lo >> 12) & 1) << 8 | ((lo >> 10) & 3) << 3 |
+                       ((lo >> 5) & 3) << 6 | ((lo >> 3) & 3) << 1 |
+                       ((lo >> 2) & 1) << 5;
+        int taken = (funct3 == 6) ? rs1 == 0 : rs1 != 0;
+        return taken ? pc + gdb_sext(imm, 9) : pc + 2;
+    }
+    if ((lo & 3) == 2 && funct3 == 4 && ((lo >> 2) & 31) == 0 && ((lo >> 7) & 31) != 0) {
+        return gdb_x((lo >> 7) & 31) & ~1u;                     // C.JR, C.JALR
+    }
+    return pc + 2;
+}
+
+//-------------------------------------------------------------------------------
+// FreeRTOS tasks as threads (id = slot + 1)
+//-------------------------------------------------------------------------------
+
+static struct {
+    void *tcb;
+    const char *name;
+} s_threads[GDB_STUB_MAX_THREADS];
+
+static uint32_t s_sel_tid;                  // Hg; 0 = the stopped one
+
+#ifdef USE_FREERTOS
+extern void * volatile pxCurrentTCB;
+#endif
+
+void gdbstub_task_created(void *tcb, const char *name) {
+    for (int i = 0; i < GDB_STUB_MAX_THREADS; i++) {
+        if (!s_threads[i].tcb) {
+            s_threads[i].tcb = tcb;
+            s_threads[i].name = name;
+            return;
+        }
+    }
+}
+
+void gdbstub_task_deleted(void *tcb) {
+    for (int i = 0; i < GDB_STUB_MAX_THREADS; i++) {
+        if (s_threads[i].tcb == tcb) {
+            s_threads[i].tcb = 0;
+        }
+    }
+}
+
+// The running task's id, 0 without threads
+static uint32_t gdb_cur_tid(void) {
+#ifdef USE_FREERTOS
+    for (int i = 0; i < GDB_STUB_MAX_THREADS; i++) {
+        if (s_threads[i].tcb && s_threads[i].tcb == pxCurrentTCB) {
+            return (uint32_t)i + 1;
+        }
+    }
+#endif
+    return 0;
+}
+
+static int gdb_tid_valid(uint32_t tid) {
+    return tid >= 1 && tid <= GDB_STUB_MAX_THREADS && s_threads[tid - 1].tcb;
+}
+
+// Frame of a task that is not running (pxTopOfStack, the first TCB field)
+static uint32_t *gdb_task_frame(uint32_t tid) {
+    if (tid == 0 || tid == gdb_cur_tid() || !gdb_tid_valid(tid)) {
+        return 0;
+    }
+    return *(uint32_t **)s_threads[tid - 1].tcb;
+}
+
+static uint32_t gdb_reg_get(uint32_t tid, uint32_t n) {
+    uint32_t *top = gdb_task_frame(tid);
+    int slot = s_frame_slot[n];
+
+    if (!top) {
+        return gdbstub_regs[n];
+    }
+    if (n == 2) {
+        return (uint32_t)top + 128;
+    }
+    if (slot < 0) {
+        return n ? gdbstub_regs[n] : 0; // gp, tp: shared
+    }
+    return n == GDB_REG_PC ? top[slot] & ~1u : top[slot];
+}
+
+static void gdb_reg_set(uint32_t tid, uint32_t n, uint32_t v) {
+    uint32_t *top = gdb_task_frame(tid);
+    int slot = s_frame_slot[n];
+
+    if (n == 0 || n == 2) {
+        return;
+    }
+    if (!top) {
+        gdbstub_regs[n] = v;
+    } else if (slot >= 0) {
+        top[slot] = v;
+    }
+}
+
+//-------------------------------------------------------------------------------
+// Commands
+//-------------------------------------------------------------------------------
+
+static void gdb_send_stop(void) {
+    uint32_t tid = gdb_cur_tid();
+
+    gdb_reply_begin();
+    gdb_reply_char(tid ? 'T' : 'S');
+    gdb_reply_hex8(s_sig);
+    if (tid) {
+        gdb_reply_str("thread:");
+        gdb_reply_num(tid);
+        gdb_reply_char(';');
+    }
+    gdb_reply_end();
+}
+
+static void gdb_cmd_query(const char *p) {
+    if (gdb_prefix(p, "qSupported")) {
+        gdb_reply_begin();
+        gdb_reply_str("PacketSize=");
+        gdb_reply_num(GDB_STUB_PACKET_SIZE);
+        gdb_reply_str(";qXfer:features:read+;binary-upload+;QStartNoAckMode+");
+        gdb_reply_end();
+    } else if (gdb_prefix(p, "qXfer:features:read:target.xml:")) {
+        uint32_t off, len;
+        const char *q = p + strlen("qXfer:features:read:target.xml:");
+
+        if (!gdb_parse_range(&q, &off, &len, 0)) {
+            gdb_reply("E01");
+            return;
+        }
+        uint32_t size = sizeof(s_target_xml) - 1;
+        if (off > size) {
+            off = size;
+        }
+        if (len > size - off) {
+            len = size - off;
+        }
+        gdb_reply_begin();
+        gdb_reply_char(off + len < size ? 'm' : 'l');
+        for (uint32_t i = 0; i < len; i++) {
+            gdb_reply_char(s_target_xml[off + i]);
+        }
+        gdb_reply_end();
+    } else if (gdb_prefix(p, "qAttached")) {
+        gdb_reply("1");
+    } else if (gdb_prefix(p, "qC") && p[2] == 0 && gdb_cur_tid()) {
+        gdb_reply_begin();
+        gdb_reply_str("QC");
+        gdb_reply_num(gdb_cur_tid());
+        gdb_reply_end();
+    } else if (gdb_prefix(p, "qfThreadInfo") && gdb_cur_tid()) {
+        char sep = 'm';
+
+        gdb_reply_begin();
+        for (uint32_t i = 0; i < GDB_STUB_MAX_THREADS; i++) {
+            if (s_threads[i].tcb) {
+                gdb_reply_char(sep);
+                gdb_reply_num(i + 1);
+                sep = ',';
+            }
+        }
+        gdb_reply_end();
+    } else if (gdb_prefix(p, "qsThreadInfo") && gdb_cur_tid()) {
+        gdb_reply("l");
+    } else if (gdb_prefix(p, "qThreadExtraInfo,")) {
+        const char *q = p + strlen("qThreadExtraInfo,");
+        uint32_t tid = gdb_parse_hex(&q);
+
+        if (!gdb_tid_valid(tid)) {
+            gdb_reply("E01");
+            return;
+        }
+        const char *name = s_threads[tid - 1].name;
+        gdb_reply_begin();
+        while (name && *name) {
+            gdb_reply_hex8((uint8_t)*name++);
+        }
+        if (tid == gdb_cur_tid()) {
+            for (const char *s = " (running)"; *s; s++) {
+                gdb_reply_hex8((uint8_t)*s);
+            }
+        }
+        gdb_reply_end();
+    } else {
+        gdb_reply("");
+    }
+}
+
+// Serve GDB until it resumes the program
+static void gdb_serve(void) {
+    for (;;) {
+        uint32_t len = gdb_get_packet();
+        const char *p = s_buf + 1;
+        uint32_t addr, n;
+
+        switch (s_buf[0]) {
+        case '?':
+            gdb_send_stop();
+            break;
+
+        case 'g':
+            gdb_reply_begin();
+            for (n = 0; n < GDB_NUM_REGS; n++) {
+                gdb_reply_reg(gdb_reg_get(s_sel_tid, n));
+            }
+            gdb_reply_end();
+            break;
+
+        case 'G':
+            for (n = 0; n < GDB_NUM_REGS && *p; n++) {
+                gdb_reg_set(s_sel_tid, n, gdb_parse_reg(&p));
+            }
+            gdb_reply("OK");
+            break;
+
+        case 'p':
+            n = gdb_parse_hex(&p);
+            if (n >= GDB_NUM_REGS) {
+                gdb_reply("E01");
+                break;
+            }
+            gdb_reply_begin();
+            gdb_reply_reg(gdb_reg_get(s_sel_tid, n));
+            gdb_reply_end();
+            break;
+
+        case 'P':
+            n = gdb_parse_hex(&p);
+            if (n >= GDB_NUM_REGS || *p++ != '=') {
+                gdb_reply("E01");
+                break;
+            }
+            gdb_reg_set(s_sel_tid, n, gdb_parse_reg(&p));
+            gdb_reply("OK");
+            break;
+
+        case 'm':
+        case 'x':
+            if (!gdb_parse_range(&p, &addr, &n, 0)) {
+                gdb_reply("E01");
+                break;
+            }
+            if (s_buf[0] == 'm' && n > GDB_STUB_PACKET_SIZE / 2) {
+                n = GDB_STUB_PACKET_SIZE / 2;
+            }
+            gdb_reply_begin();
+            if (s_buf[0] == 'x') {
+                gdb_reply_char('b');
+            }
+            gdb_mem_read(addr, n, s_buf[0] == 'x');
+            gdb_reply_end();
+            break;
+
+        case 'M': {
+            uint8_t *dst;
+
+            if (!gdb_parse_range(&p, &addr, &n, ':') ||
+                (uint32_t)(s_buf + len - p) < n * 2) {
+                gdb_reply("E01");
+                break;
+            }
+            // Decoded in place: the bytes need half the room of the hex
+            dst = (uint8_t *)s_buf;
+            for (uint32_t i = 0; i < n; i++, p += 2) {
+                dst[i] = (uint8_t)(gdb_hexval(p[0]) << 4 | gdb_hexval(p[1]));
+            }
+            gdb_mem_write(addr, dst, n);
+            gdb_reply("OK");
+            break;
+        }
+
+        case 'X': {
+            const char *end = s_buf + len;
+            uint8_t *dst;
+            uint32_t got = 0;
+
+            if (!gdb_parse_range(&p, &addr, &n, ':')) {
+                gdb_reply("E01");
+                break;
+            }
+            dst = (uint8_t *)s_buf;
+            while (p < end && got < n) {
+                uint8_t b = (uint8_t)*p++;
+
+                if (b == '}' && p < end) {
+                    b = (uint8_t)(*p++ ^ 0x20);
+                }
+                dst[got++] = b;
+            }
+            if (got != n) {
+                gdb_reply("E01");
+                break;
+            }
+            gdb_mem_write(addr, dst, n);
+            gdb_reply("OK");
+            break;
+        }
+
+        case 'Z':
+        case 'z':
+            if (*p != '0' || p[1] != ',') {
+                gdb_reply("");              // Only software breakpoints
+                break;
+            }
+            p += 2;
+            if (!gdb_parse_range(&p, &addr, &n, 0) && *p != ';') {
+                gdb_reply("E01");
+                break;
+            }
+            if (s_buf[0] == 'Z') {
+                gdb_reply(gdb_bp_set(addr, n) == 0 ? "OK" : "E0C");
+            } else {
+                gdb_bp_t *bp = gdb_bp_find(addr);
+                if (bp) {
+                    gdb_bp_remove(bp);
+                }
+                gdb_reply("OK");
+            }
+            break;
+
+        case 'c':
+        case 's':
+            if (*p) {
+                gdbstub_regs[GDB_REG_PC] = gdb_parse_hex(&p);
+            }
+            if (s_buf[0] == 's') {
+                uint32_t next = gdb_next_pc(gdbstub_regs[GDB_REG_PC]);
+                gdb_bp_insert(&s_step, next, (uint32_t)gdb_insn_len(next));
+            }
+            s_attached = 1;
+            return;
+
+        case 'D':
+            gdb_bp_clear_all();
+            gdb_reply("OK");
+            s_attached = 0;
+            s_noack = 0;
+            return;
+
+        case 'k':
+            gdb_bp_clear_all();
+            s_attached = 0;
+            s_noack = 0;
+            return;
+
+        case 'H':
+            if (*p == 'g') {
+                p++;
+                n = (*p == '-') ? 0 : gdb_parse_hex(&p);
+                if (n != 0 && !gdb_tid_valid(n)) {
+                    gdb_reply("E01");
+                    break;
+                }
+                s_sel_tid = n;
+            }
+            gdb_reply("OK");
+            break;
+
+        case 'T':
+            n = gdb_parse_hex(&p);
+            gdb_reply(gdb_tid_valid(n) ? "OK" : "E01");
+            break;
+
+        case 'q':
+            gdb_cmd_query(s_buf);
+            break;
+
+        case 'Q':
+            if (gdb_prefix(s_buf, "QStartNoAckMode")) {
+                gdb_reply("OK");
+                s_noack = 1;
+            } else {
+                gdb_reply("");
+            }
+            break;
+
+        default:
+            gdb_reply("");                  // Unsupported (vMustReplyEmpty too)
+            break;
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------
+// Stop
+//-------------------------------------------------------------------------------
+
+static uint32_t gdb_getq0(void) {
+    uint32_t v;
+    __asm__ volatile (".insn r 0x0B, 4, 0, %0, x0, x0" : "=r"(v));  // getq v, q0
+    return v;
+}
+
+static void gdb_setq0(uint32_t v) {
+    __asm__ volatile (".insn r 0x0B, 2, 1, x0, %0, x0" : : "r"(v));  // setq q0, v
+}
+
+uint32_t gdbstub_handle(uint32_t irqs, uint32_t *frame) {
+    uint32_t q0 = gdb_getq0();
+    uint32_t next = q0 & ~1u;
+    uint32_t pc = (q0 & 1) ? next - 2 : next - 4;
+    int soft = irqc_present() && (IRQC_PENDING & (1u << IRQ_SOFT));
+    int stub_bp;
+
+    if (!s_uart) {
+        return irqs;
+    }
+    if (gdb_is_ebreak(pc, (q0 & 1) ? 2 : 4)) {
+        s_sig = s_interrupt ? GDB_SIGINT : GDB_SIGTRAP;
+    } else if (irqc_present() && !soft) {
+        s_sig = GDB_SIGILL;                 // Illegal instruction or ECALL
+    } else {
+        return irqs;                        // The soft interrupt
+    }
+
+    for (int i = 1; i < 32; i++) {
+        if (s_frame_slot[i] >= 0 && s_frame_slot[i] < 16) {
+            gdbstub_regs[i] = frame[s_frame_slot[i]];
+        }
+    }
+    gdbstub_regs[0] = 0;
+    gdbstub_regs[2] = (uint32_t)frame + GDB_FRAME_BYTES;
+
+    // A breakpoint of ours stops at the EBREAK, which GDB puts back; a
+    // compiled-in one (configASSERT, gdbstub_breakpoint) after it
+    stub_bp = (s_step.len && s_step.addr == pc) || gdb_bp_find(pc);
+    gdb_bp_remove(&s_step);
+    gdbstub_regs[GDB_REG_PC] = (s_sig == GDB_SIGTRAP && stub_bp) || s_sig == GDB_SIGILL ? pc : next;
+    s_interrupt = 0;
+    s_sel_tid = 0;
+    if (s_in_packet) {
+        s_attached = 0;                     // A new session: no stop to report
+        s_noack = 0;
+    }
+
+    if (s_attached) {
+        gdb_send_stop();
+    }
+    gdb_serve();
+
+    for (int i = 1; i < 32; i++) {
+        if (s_frame_slot[i] >= 0 && s_frame_slot[i] < 16) {
+            frame[s_frame_slot[i]] = gdbstub_regs[i];
+        }
+    }
+    gdb_setq0(gdbstub_regs[GDB_REG_PC]);
+
+    return soft ? irqs : irqs & ~(1u << GDB_IRQ_EBREAK);
+}
+
+void gdbstub_poll(void) {
+    int c;
+
+    if (!s_uart || !(UART_PORT_RX_STATUS(s_uart) & UART_PORT_RX_AVAIL)) {
+        return;
+    }
+    c = UART_PORT_RX_DATA(s_uart) & 0xFF;
+    if (c == 0x03 || c == '$') {            // Ctrl-C, or GDB attaching
+        s_interrupt = 1;
+        s_in_packet = (c == '$');
+        gdbstub_breakpoint();
+    }
+}
+
+int gdbstub_init(uint32_t uart_base) {
+    if (!(PMU_CPU_INFO & CPU_INFO_CATCH_ILLINSN)) {
+        return -1;                          // EBREAK would hang the core
+    }
+    s_uart = uart_base;
+
+    // A masked IRQ[1] would halt the core at the first EBREAK
+    uint32_t old = irq_setmask(~0u);
+    irq_setmask(old & ~(1u << GDB_IRQ_EBREAK));
+
+    return 0;
+}
@@ -0,0 +1,84 @@
+//===============================================================================
+// GDB Remote Serial Protocol Stub - Breakpoints, Stepping, Binary Memory I/O
+// Linked in with 'make GDB=1'; needs a bitstream with Kconfig CATCH_ILLINSN
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// PicoRV32 turns EBREAK (and ECALL or an illegal instruction) into IRQ[1]
+// when the core is built with CATCH_ILLINSN. With GDB_STUB defined, start.S
+// and startFRT.S send that IRQ to gdbstub_trap() before irq_handler(): the
+// program stops and the stub talks to GDB over a UART, polled, with
+// interrupts off, until GDB continues. The soft interrupt shares IRQ[1];
+// the stub only claims an IRQ[1] whose instruction is an EBREAK (or, with
+// the interrupt controller, one that the soft interrupt did not raise).
+//
+//   gdbstub_init(UART1_BASE);       // Console UART; UART0_BASE for the main one
+//   gdbstub_breakpoint();           // Wait here for GDB
+//
+//   $ riscv64-unknown-elf-gdb firmware.elf
+//   (gdb) set serial baud 1000000
+//   (gdb) target remote /dev/ttyUSB1
+//
+// Supported: registers (g/G/p/P), memory in hex (m/M) and binary (X, and x
+// for GDB 16 and later), software breakpoints (Z0/z0), continue and step,
+// no-ack mode, and PacketSize=GDB_STUB_PACKET_SIZE, so a 100 KB load or dump
+// is a handful of packets instead of hundreds. Code writes invalidate the
+// I-cache and clean the D-cache. A step places a temporary EBREAK at the
+// next instruction, decoded from the registers (branches, JAL/JALR and the
+// RV32C jumps).
+//
+// FreeRTOS builds list the tasks as threads ('info threads', 'thread N'):
+// FreeRTOSConfig.h registers each task with gdbstub_task_created(), and a
+// task that is not running is shown with the registers startFRT.S saved in
+// its frame. configASSERT() stops in the stub through its EBREAK.
+//
+// GDB's Ctrl-C is only seen where the program calls gdbstub_poll(). The
+// stub cannot stop inside interrupt handlers: an EBREAK there halts the
+// core, and so does one while the program has IRQ[1] masked. Writes to sp
+// are ignored.
+//
+//===============================================================================
+
+#ifndef GDBSTUB_H
+#define GDBSTUB_H
+
+#include <stdint.h>
+
+// Largest packet body; one buffer of this size is the stub's only RAM cost
+#ifndef GDB_STUB_PACKET_SIZE
+#define GDB_STUB_PACKET_SIZE        16384
+#endif
+
+// Software breakpoints GDB can have inserted at once
+#ifndef GDB_STUB_MAX_BREAKPOINTS
+#define GDB_STUB_MAX_BREAKPOINTS    16
+#endif
+
+// FreeRTOS tasks shown as threads
+#ifndef GDB_STUB_MAX_THREADS
+#define GDB_STUB_MAX_THREADS        16
+#endif
+
+// Talk to GDB on the UART at uart_base (lib/uart_port.h). Returns -1 (the
+// stub stays off) if the bitstream does not trap EBREAK.
+int gdbstub_init(uint32_t uart_base);
+
+// Stop and wait for GDB
+static inline void gdbstub_breakpoint(void) {
+    __asm__ volatile ("ebreak");
+}
+
+// Main loop: stop if GDB sent Ctrl-C
+void gdbstub_poll(void);
+
+// start.S / startFRT.S (GDB_STUB): a0 = IRQ mask, sp = the IRQ frame.
+// Returns the IRQs left for irq_handler().
+uint32_t gdbstub_trap(uint32_t irqs);
+
+// FreeRTOSConfig.h task hooks (run inside tasks.c)
+void gdbstub_task_created(void *tcb, const char *name);
+void gdbstub_task_deleted(void *tcb);
+
+#endif // GDBSTUB_H
@@ -0,0 +1,267 @@
+//===============================================================================
+// High-Resolution Time and Timer Service - Implementation
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+
+#include "hrtimer.h"
+#include "../irq.h"
+#include "../atomic.h"
+#include "../timer.h"
+#include "../perf_counters.h"
+
+// Armed timers, earliest first (equal deadlines in start order)
+static hrt_timer_t *s_head;
+static uint32_t s_ch;
+static uint32_t s_running;
+
+// Cycle counter extension for bitstreams without the timebase
+static uint32_t s_cyc_last;
+static uint32_t s_cyc_hi;
+
+static hrt_stats_t s_stats;
+
+//===============================================================================
+// Time
+//===============================================================================
+
+uint64_t hrt_now_us(void) {
+    uint32_t irq, lo;
+    uint64_t cycles;
+
+    if (timebase_present()) {
+        return timebase_us();
+    }
+
+    irq = atomic_irq_save();
+    lo = rdcycle();
+    if (lo < s_cyc_last) {
+        s_cyc_hi++;
+    }
+    s_cyc_last = lo;
+    cycles = ((uint64_t)s_cyc_hi << 32) | lo;
+    atomic_irq_restore(irq);
+
+    // Whole seconds first: no overflow, any clock
+    return (cycles / SYS_CLK_HZ) * 1000000 +
+           (uint32_t)(cycles % SYS_CLK_HZ) * 1000000ull / SYS_CLK_HZ;
+}
+
+uint32_t hrt_now_ms(void) {
+    if (timebase_present()) {
+        return timebase_ms();
+    }
+    return (uint32_t)(hrt_now_us() / 1000);
+}
+
+uint32_t hrt_remaining_us(hrt_deadline_t deadline) {
+    uint64_t now = hrt_now_us();
+
+    if (now >= deadline) {
+        return 0;
+    }
+    return (deadline - now > 0xFFFFFFFFu) ? 0xFFFFFFFFu : (uint32_t)(deadline - now);
+}
+
+//===============================================================================
+// List and Channel (called masked)
+//===============================================================================
+
+static void hrt_unlink(hrt_timer_t *t) {
+    hrt_timer_t **p;
+
+    for (p = &s_head; *p; p = &(*p)->next) {
+        if (*p == t) {
+            *p = t->next;
+            break;
+        }
+    }
+    t->armed = 0;
+    s_stats.armed--;
+}
+
+static void hrt_insert(hrt_timer_t *t) {
+    hrt_timer_t **p;
+
+    for (p = &s_head; *p && (*p)->expires <= t->expires; p = &(*p)->next);
+    t->next = *p;
+    *p = t;
+    t->armed = 1;
+    s_stats.armed++;
+}
+
+// One-shot for the head of the list, or the channel stopped if it is empty
+static void hrt_arm(void) {
+    uint64_t now, left;
+
+    TIMER_CH_CR(s_ch) = 0;
+    TIMER_CH_SR(s_ch) = TIMER_CH_UIF;
+    if (!s_head) {
+        return;     // Free for others until the next start
+    }
+
+    now = hrt_now_us();
+    left = (s_head->expires > now) ? s_head->expires - now : 1;
+    if (left > HRT_MAX_ARM_US) {
+        left = HRT_MAX_ARM_US;
+    }
+    TIMER_CH_PSC(s_ch) = TIMER_PSC_1MHZ;
+    TIMER_CH_ARR(s_ch) = (uint32_t)left - 1;
+    TIMER_CH_CR(s_ch) = TIMER_CH_ENABLE | TIMER_CH_ONE_SHOT;
+}
+
+//===============================================================================
+// Timer Service
+//===============================================================================
+
+static void hrt_isr(uint32_t source) {
+    (void)source;
+    hrt_irq();
+}
+
+int hrt_init(uint32_t ch, uint32_t prio) {
+    uint32_t irq = atomic_irq_save();
+
+    // Unmapped MMIO reads 0: CR does not hold the enable bit
+    TIMER_CH_CR(ch) = 0;
+    TIMER_CH_SR(ch) = TIMER_CH_UIF;
+    TIMER_CH_PSC(ch) = TIMER_PSC_1MHZ;
+    TIMER_CH_ARR(ch) = 0xFFFFFFFFu;
+    TIMER_CH_CR(ch) = TIMER_CH_ENABLE | TIMER_CH_ONE_SHOT;
+    if (ch == 0 || ch > 3 || !(TIMER_CH_CR(ch) & TIMER_CH_ENABLE)) {
+        TIMER_CH_CR(ch) = 0;
+        atomic_irq_restore(irq);
+        return 0;
+    }
+
+    s_ch = ch;
+    s_running = 1;
+    hrt_arm();
+    irq_register(IRQ_TIMERS, hrt_isr, prio);
+    atomic_irq_restore(irq);
+
+    return 1;
+}
+
+int hrt_running(void) {
+    return s_running;
+}
+
+void hrt_timer_init(hrt_timer_t *t, hrt_fn_t fn, void *arg) {
+    t->next = 0;
+    t->expires = 0;
+    t->period_us = 0;
+    t->fn = fn;
+    t->arg = arg;
+    t->armed = 0;
+}
+
+void hrt_timer_start_at(hrt_timer_t *t, hrt_deadline_t deadline, uint32_t period_us) {
+    uint32_t irq = atomic_irq_save();
+
+    if (t->armed) {
+        hrt_unlink(t);
+    }
+    t->expires = deadline;
+    t->period_us = period_us;
+    hrt_insert(t);
+    if (s_running && s_head == t) {
+        hrt_arm();
+    }
+    atomic_irq_restore(irq);
+}
+
+void hrt_timer_start(hrt_timer_t *t, uint32_t us, uint32_t period_us) {
+    hrt_timer_start_at(t, hrt_deadline_us(us), period_us);
+}
+
+int hrt_timer_cancel(hrt_timer_t *t) {
+    uint32_t irq = atomic_irq_save();
+    int was = t->armed != 0;
+
+    if (was) {
+        int head = (s_head == t);
+        hrt_unlink(t);
+        if (s_running && head) {
+            hrt_arm();
+        }
+    }
+    atomic_irq_restore(irq);
+
+    return was;
+}
+
+void hrt_irq(void) {
+    uint64_t now;
+
+    if (!s_running || !s_head || !(TIMER_CH_SR(s_ch) & TIMER_CH_UIF)) {
+        return;
+    }
+    TIMER_CH_SR(s_ch) = TIMER_CH_UIF;
+
+    now = hrt_now_us();
+    while (s_head && s_head->expires <= now) {
+        hrt_timer_t *t = s_head;
+        uint32_t late = (uint32_t)(now - t->expires);
+
+        if (late > s_stats.max_late_us) {
+            s_stats.max_late_us = late;
+        }
+
+        // Off the list (or back on it) before the callback runs, so it
+        // can restart or cancel itself
+        hrt_unlink(t);
+        if (t->period_us) {
+            t->expires += t->period_us;
+            if (t->expires <= now) {
+                s_stats.overruns += (uint32_t)((now - t->expires) / t->period_us) + 1;
+                t->expires = now + t->period_us;
+            }
+            hrt_insert(t);
+        }
+
+        s_stats.fired++;
+        t->fn(t->arg);
+        now = hrt_now_us();
+    }
+    hrt_arm();
+}
+
+void hrt_get_stats(hrt_stats_t *s) {
+    uint32_t irq = atomic_irq_save();
+
+    *s = s_stats;
+    atomic_irq_restore(irq);
+}
+
+//===============================================================================
+// Delay
+//===============================================================================
+
+static void hrt_wake(void *arg) {
+    *(volatile uint32_t *)arg = 1;
+}
+
+void hrt_sleep_until(hrt_deadline_t deadline, uint32_t wake) {
+    volatile uint32_t done = 0;
+    hrt_timer_t t;
+
+    if (!s_running) {
+        while (!hrt_expired(deadline));
+        return;
+    }
+
+    // The deadline test too: firmware whose irq_handler() does not call
+    // hrt_irq() still leaves waitirq on the channel's IRQ
+    hrt_timer_init(&t, hrt_wake, (void *)&done);
+    hrt_timer_start_at(&t, deadline, 0);
+    irq_wait_until(done || hrt_expired(deadline), wake | (1u << IRQ_TIMERS));
+    hrt_timer_cancel(&t);
+}
+
+void hrt_delay_us(uint32_t us) {
+    if (us) {
+        hrt_sleep_until(hrt_deadline_us(us), 0);
+    }
+}
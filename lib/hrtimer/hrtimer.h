@@ -0,0 +1,133 @@
+//===============================================================================
+// High-Resolution Time and Timer Service
+// Microsecond clock, deadlines, one-shot and periodic timer callbacks on
+// one hardware timer channel
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// Time: hrt_now_us() is the 64-bit timebase (lib/timer.h). Bitstreams
+// without it count CPU cycles instead, extended to 64 bits in software,
+// which needs a call at least once per counter wrap (85 s at 50 MHz).
+// Deadlines are absolute microseconds, so a wait that spans several
+// polls keeps one and needs no start time or elapsed arithmetic:
+//
+//   hrt_deadline_t dl = hrt_deadline_ms(100);
+//   while (!ready()) {
+//       if (hrt_expired(dl)) return TIMEOUT;
+//   }
+//
+// Timers: hrt_init() claims one channel of timer_peripheral.v as a 1 MHz
+// one-shot, always armed for the earliest deadline of a sorted list. Any
+// number of timers share it; there is no periodic tick.
+//
+//   static void blink(void *arg) { LED_REG ^= 1; }
+//   static hrt_timer_t t = HRT_TIMER_INIT(blink, NULL);
+//
+//   hrt_init(3, 8);                       // Channel 3, IRQ[7] priority 8
+//   hrt_timer_start(&t, 250000, 250000);  // In 250 ms, then every 250 ms
+//   irq_enable_all();
+//
+// Callbacks run from the timer interrupt, masked like any handler: keep
+// them short, or hand the work to lib/softirq. A callback may start or
+// cancel any timer, itself included. Periodic timers keep their phase
+// (each deadline is the last one plus the period); one that falls behind
+// by a whole period skips ahead and counts an overrun.
+//
+// hrt_init() registers hrt_irq() for IRQ[7] with the start.S dispatcher.
+// Firmware with its own irq_handler() calls hrt_irq() for IRQ[7]; it
+// ignores the IRQ unless the service has a timer armed and its channel
+// fired, so the sources sharing IRQ[7] (the other channels, the watchdog
+// pre-timeout) are left to their own handlers.
+//
+//===============================================================================
+
+#ifndef HRTIMER_H
+#define HRTIMER_H
+
+#include <stdint.h>
+
+// Longest single arm of the channel; longer timers re-arm on the way
+#define HRT_MAX_ARM_US      1000000
+
+typedef uint64_t hrt_deadline_t;        // hrt_now_us() value
+
+typedef void (*hrt_fn_t)(void *arg);
+
+typedef struct hrt_timer {
+    struct hrt_timer *next;
+    hrt_deadline_t expires;
+    uint32_t period_us;                 // 0: one-shot
+    hrt_fn_t fn;
+    void *arg;
+    volatile uint32_t armed;
+} hrt_timer_t;
+
+#define HRT_TIMER_INIT(f, a)    { 0, 0, 0, (f), (a), 0 }
+
+typedef struct {
+    uint32_t fired;                     // Callbacks run
+    uint32_t overruns;                  // Periods skipped
+    uint32_t max_late_us;               // Worst deadline to callback delay
+    uint32_t armed;                     // Timers in the list now
+} hrt_stats_t;
+
+//===============================================================================
+// Time
+//===============================================================================
+
+uint64_t hrt_now_us(void);
+uint32_t hrt_now_ms(void);
+
+static inline hrt_deadline_t hrt_deadline_us(uint32_t us) {
+    return hrt_now_us() + us;
+}
+
+static inline hrt_deadline_t hrt_deadline_ms(uint32_t ms) {
+    return hrt_now_us() + (uint64_t)ms * 1000;
+}
+
+static inline int hrt_expired(hrt_deadline_t deadline) {
+    return hrt_now_us() >= deadline;
+}
+
+// Microseconds until the deadline, 0 once it passed (saturates at 2^32 - 1)
+uint32_t hrt_remaining_us(hrt_deadline_t deadline);
+
+// Sleep in waitirq on a one-shot timer while the service runs, otherwise
+// poll the clock. hrt_sleep_until() also unmasks the IRQs in wake while it
+// sleeps (irq_wait_until()), for handlers that clear what would otherwise
+// end every waitirq at once.
+void hrt_delay_us(uint32_t us);
+void hrt_sleep_until(hrt_deadline_t deadline, uint32_t wake);
+
+//===============================================================================
+// Timer Service
+//===============================================================================
+
+// Claim timer channel ch (1-3; 0 is the system tick) and register hrt_irq()
+// for IRQ[7] at prio. Returns 0 if the bitstream has no such channel.
+int hrt_init(uint32_t ch, uint32_t prio);
+int hrt_running(void);
+
+void hrt_timer_init(hrt_timer_t *t, hrt_fn_t fn, void *arg);
+
+// Run fn in us microseconds (may be 0), then every period_us if non-zero.
+// Restarts a timer that is already armed.
+void hrt_timer_start(hrt_timer_t *t, uint32_t us, uint32_t period_us);
+void hrt_timer_start_at(hrt_timer_t *t, hrt_deadline_t deadline, uint32_t period_us);
+
+// Returns 1 if it was armed
+int hrt_timer_cancel(hrt_timer_t *t);
+
+static inline int hrt_timer_active(const hrt_timer_t *t) {
+    return t->armed != 0;
+}
+
+// IRQ[7] entry for firmware with its own irq_handler()
+void hrt_irq(void);
+
+void hrt_get_stats(hrt_stats_t *s);
+
+#endif // HRTIMER_H
@@ -0,0 +1,37 @@
+//===============================================================================
+// Hardware Firmware Loader (Kconfig HW_LOADER) at 0x800001E0
+// Status of the last image written by hdl/firmware_loader.v
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// The loader takes uploads with the CPU held in reset (fw_upload_fast -H,
+// protocol in lib/block_upload/block_upload.h). Once the image in SRAM
+// checks out it lets the CPU run with STATUS.LOADED set; the bootloaders
+// clear it and jump straight to the image:
+//
+//   if (HW_LOADER_STATUS & HW_LOADER_LOADED) {
+//       HW_LOADER_STATUS = HW_LOADER_LOADED;
+//       jump_to_firmware(0);
+//   }
+//
+// Without the loader all three registers read 0.
+//
+//===============================================================================
+
+#ifndef HW_LOADER_H
+#define HW_LOADER_H
+
+#include <stdint.h>
+
+#define HW_LOADER_BASE      0x800001E0
+#define HW_LOADER_STATUS    (*(volatile uint32_t*)(HW_LOADER_BASE + 0x00))
+#define HW_LOADER_SIZE      (*(volatile uint32_t*)(HW_LOADER_BASE + 0x04))  // Read only
+#define HW_LOADER_CRC       (*(volatile uint32_t*)(HW_LOADER_BASE + 0x08))  // Read only
+
+// STATUS bits (write HW_LOADER_LOADED to clear it)
+#define HW_LOADER_LOADED    (1 << 0)        // Image in SRAM, SIZE and CRC valid
+#define HW_LOADER_PRESENT   (1u << 31)
+
+#endif // HW_LOADER_H
@@ -68,14 +68,25 @@ enum {
 #define LINES 24
 #define COLS 80
 
-/* Arrow key codes (for compatibility) */
-#define KEY_UP    65
-#define KEY_DOWN  66
-#define KEY_RIGHT 67
-#define KEY_LEFT  68
-
-/* Function keys */
-#define KEY_F(n)  (256 + (n))
+/* Keys from getch() with keypad(stdscr, TRUE), ncurses values: above
+ * any byte, so 'A' stays 'A' */
+#define KEY_DOWN   0402
+#define KEY_UP     0403
+#define KEY_LEFT   0404
+#define KEY_RIGHT  0405
+#define KEY_HOME   0406
+#define KEY_F0     0410
+#define KEY_F(n)   (KEY_F0 + (n))
+#define KEY_DC     0512                 /* Delete */
+#define KEY_IC     0513                 /* Insert */
+#define KEY_SF     0520                 /* Shift+Down */
+#define KEY_SR     0521                 /* Shift+Up */
+#define KEY_NPAGE  0522                 /* Page Down */
+#define KEY_PPAGE  0523                 /* Page Up */
+#define KEY_BTAB   0541                 /* Shift+Tab */
+#define KEY_END    0550
+#define KEY_SLEFT  0611
+#define KEY_SRIGHT 0622
 
 enum {
   A_NORMAL    = ((attr_t)0x0000),
@@ -145,6 +156,16 @@ extern int move(int, int);
 extern int refresh(void);
 extern char *unctrl(chtype);
 
+/* incurses extensions: bytes sent to the terminal, in all and between
+ * the last two refresh() calls (one frame) */
+extern uint32_t incurses_bytes(void);
+extern uint32_t incurses_frame_bytes(void);
+
+/* Input wait hooks, weak defaults in incurses.c: milliseconds since any
+ * start, and a sleep until input or timeout_ms pass (-1: no limit) */
+extern uint32_t incurses_millis(void);
+extern void incurses_wait_input(int timeout_ms);
+
 /* Window functions (compatibility - all map to stdscr) */
 extern WINDOW *newwin(int, int, int, int);
 extern int delwin(WINDOW *);
@@ -160,6 +181,14 @@ extern int doupdate(void);
 extern int insertln(void);
 extern int deleteln(void);
 
+/* Scrolling region: setscrreg() takes screen rows, first and last */
+extern int setscrreg(int, int);
+extern int wsetscrreg(WINDOW *, int, int);
+extern int scrollok(WINDOW *, bool);
+extern int scrl(int);
+extern int wscrl(WINDOW *, int);
+extern int scroll(WINDOW *);
+
 #ifdef __cplusplus
 }
 #endif
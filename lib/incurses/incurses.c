@@ -35,7 +35,7 @@
 
 /* Assume there's only ever one window, the whole thing */
 WINDOW *stdscr = (WINDOW *)1;
-WINDOW *curscr = (WINDOW *)1;
+WINDOW *curscr = (WINDOW *)2;           /* wrefresh(curscr): repaint all */
 attr_t incurses_pairs[COLOR_PAIRS];
 
 /* Private global data */
@@ -45,6 +45,8 @@ static struct {
     int keypad;                         /* recognise e.g ESC[A as keys? */
     attr_t attr;                        /* current colour and attributes */
     uint8_t x, y;                       /* current column end row */
+    uint8_t top, bot;                   /* scrolling region (setscrreg) */
+    bool scroll;                        /* scroll at its bottom (scrollok) */
 } incur_global = {
     .started = false,
     .echo = true,
@@ -52,6 +54,9 @@ static struct {
     .attr = 0x00,
     .x = 0,
     .y = LINES-1,
+    .top = 0,
+    .bot = LINES-1,
+    .scroll = true,
 };
 
 /* Shortcut to private globals data */
@@ -61,8 +66,20 @@ static struct {
 #define GET_FG(a) ((((a) & INCURSES_FG_MASK) >> INCURSES_FG_SHIFT) - 1)
 #define GET_BG(a) ((((a) & INCURSES_BG_MASK) >> INCURSES_BG_SHIFT) - 1)
 
+/* Terminal attributes not known, e.g. before the first output */
+#define ATTR_UNKNOWN ((attr_t)0xffff)
+
+/* Bytes sent, for incurses_bytes() and incurses_frame_bytes() */
+static uint32_t out_total;
+static uint32_t out_frame_start;
+static uint32_t out_frame;
+
 /* Forward declarations */
+static void _out(int c);
+static void _outs(const char *str);
 static void _move(unsigned y, unsigned x);
+static void _sgr(attr_t from, attr_t to);
+static void _region(unsigned top, unsigned bot);
 
 #ifdef DEBUG
 /*-----------------------------------------------------------------------
@@ -165,33 +182,315 @@ _mbedserial_puts(const char *str)
  *      RISC-V / Embedded UART driver (direct hardware access)
  *      Bypasses stdio to get unbuffered character input for curses
  *-----------------------------------------------------------------------*/
+#include "../timer.h"
+
 // External UART functions (defined in application)
 extern char uart_getc(void);
 extern void uart_putc(char c);
 extern int uart_getc_available(void);
 
 // Global timeout setting for getch()
-static int g_getch_timeout = -1;  // -1 = blocking, 0 = non-blocking
+static int g_getch_timeout = -1;  // -1 = blocking, 0 = non-blocking, N = N ms
+
+/*
+ * Input queue (INCURSES_RXBUF bytes, a power of 2). Bytes are moved
+ * here from the UART by getch() and by output that has to wait for
+ * the TX ring, so a paste or fast typing during a long redraw is kept
+ * instead of overrunning the UART RX FIFO. getch() takes keys from the
+ * queue; with keypad(stdscr, TRUE) it decodes VT100/xterm sequences
+ * (ESC [ ..., ESC O ...) into KEY_* codes, waiting up to
+ * INCURSES_ESCDELAY ms for each byte after the ESC. A lone ESC is
+ * returned as 27, an unknown sequence is dropped.
+ *
+ * Waits go through two hooks with weak defaults: incurses_millis()
+ * (the hardware timebase, or CPU cycles without it) and
+ * incurses_wait_input(ms), which may sleep until a byte arrives or ms
+ * pass (-1: no limit). The default returns at once, so getch() polls;
+ * the SD card manager sleeps on the UART RX IRQ instead (io.c).
+ */
+#ifndef INCURSES_RXBUF
+#define INCURSES_RXBUF 64
+#endif
+#if INCURSES_RXBUF & (INCURSES_RXBUF - 1)
+#error "INCURSES_RXBUF must be a power of 2"
+#endif
+#define RX_MASK (INCURSES_RXBUF - 1)
+
+#ifndef INCURSES_ESCDELAY
+#define INCURSES_ESCDELAY 50            /* ms between sequence bytes */
+#endif
+
+static unsigned char rx_ring[INCURSES_RXBUF];
+static uint32_t rx_head, rx_tail;       /* free running */
+
+__attribute__((weak)) uint32_t
+incurses_millis(void)
+{
+    if (timebase_present()) {
+        return timebase_ms();
+    }
+    uint32_t cycles;
+    __asm__ volatile ("rdcycle %0" : "=r"(cycles));
+    return cycles / (SYS_CLK_HZ / 1000);
+}
+
+__attribute__((weak)) void
+incurses_wait_input(int timeout_ms)
+{
+    (void)timeout_ms;
+}
+
+/* Move what the UART has into the queue, as far as it has room */
+static void
+_rx_poll(void)
+{
+    while (rx_head - rx_tail < INCURSES_RXBUF && uart_getc_available()) {
+        rx_ring[rx_head++ & RX_MASK] = (unsigned char)uart_getc();
+    }
+}
+
+static void
+_rx_flush(void)
+{
+    rx_tail = rx_head;
+    while (uart_getc_available()) {
+        (void)uart_getc();
+    }
+}
 
 static int
-_embeddedserial_getc(int timeout_ms)
+_rx_peek(unsigned n)
+{
+    return rx_ring[(rx_tail + n) & RX_MASK];
+}
+
+#ifdef INCURSES_TXBUF
+/*
+ * Output ring (INCURSES_TXBUF bytes, a power of 2). Output is queued
+ * here and moved into the UART TX FIFO, a word store per four bytes,
+ * by uart_write_some() (queue what fits, return how much). refresh()
+ * passes on what fits and returns; the rest of the frame follows from
+ * getch(), move(), addstr() and the next refresh(), so the program
+ * builds its next frame while this one is on the wire. Only a full
+ * ring waits. endwin() queues everything before anything else may
+ * write to the UART.
+ */
+#if INCURSES_TXBUF & (INCURSES_TXBUF - 1)
+#error "INCURSES_TXBUF must be a power of 2"
+#endif
+#define TX_MASK (INCURSES_TXBUF - 1)
+
+extern unsigned uart_write_some(const char *buf, unsigned len);
+
+static char tx_ring[INCURSES_TXBUF];
+static uint32_t tx_head, tx_tail;       /* free running */
+
+/* Pass the UART what it has room for */
+static void
+_tx_pump(void)
+{
+    while (tx_tail != tx_head) {
+        unsigned at = tx_tail & TX_MASK;
+        unsigned n = tx_head - tx_tail;
+        if (n > INCURSES_TXBUF - at) n = INCURSES_TXBUF - at;
+        n = uart_write_some(&tx_ring[at], n);
+        if (n == 0) break;              /* TX FIFO full */
+        tx_tail += n;
+    }
+}
+
+static void
+_tx_drain(void)
+{
+    while (tx_tail != tx_head) {
+        _tx_pump();
+        _rx_poll();
+    }
+}
+#endif
+
+/*
+ * Wait until more than n bytes are queued, up to timeout_ms (-1: no
+ * limit, 0: do not wait). Returns false on timeout. The output ring is
+ * passed on first: the hook only sleeps once it is empty.
+ */
+static bool
+_rx_wait(unsigned n, int timeout_ms)
+{
+    uint32_t start = incurses_millis();
+
+    for (;;) {
+        _rx_poll();
+        if (rx_head - rx_tail > n) {
+            return true;
+        }
+
+        int left = -1;
+        if (timeout_ms >= 0) {
+            uint32_t elapsed = incurses_millis() - start;
+            if (elapsed >= (uint32_t)timeout_ms) {
+                return false;
+            }
+            left = timeout_ms - (int)elapsed;
+        }
+#ifdef INCURSES_TXBUF
+        if (tx_tail != tx_head) {
+            _tx_pump();
+            continue;
+        }
+#endif
+        incurses_wait_input(left);
+    }
+}
+
+/* Key for a CSI (ESC [) sequence: the first parameter, the modifier and
+ * the final byte; 0 if unknown */
+static int
+_csi_key(unsigned p1, unsigned mod, int final)
 {
-    /* Direct UART access for unbuffered input */
+    bool shift = (mod == 2);
+
+    switch (final) {
+    case 'A': return shift ? KEY_SR : KEY_UP;
+    case 'B': return shift ? KEY_SF : KEY_DOWN;
+    case 'C': return shift ? KEY_SRIGHT : KEY_RIGHT;
+    case 'D': return shift ? KEY_SLEFT : KEY_LEFT;
+    case 'H': return KEY_HOME;
+    case 'F': return KEY_END;
+    case 'Z': return KEY_BTAB;
+    case '~':
+        switch (p1) {
+        case 1: case 7: return KEY_HOME;
+        case 2: return KEY_IC;
+        case 3: return KEY_DC;
+        case 4: case 8: return KEY_END;
+        case 5: return KEY_PPAGE;
+        case 6: return KEY_NPAGE;
+        case 11: case 12: case 13: case 14: case 15:
+            return KEY_F(p1 - 10);
+        case 17: case 18: case 19: case 20: case 21:
+            return KEY_F(p1 - 11);
+        case 23: case 24:
+            return KEY_F(p1 - 12);
+        }
+        break;
+    }
+    return 0;
+}
 
-    // If non-blocking (timeout <= 0) and no data available, return ERR
-    if (timeout_ms <= 0 && !uart_getc_available()) {
-        return ERR;
+/* Key for an SS3 (ESC O) sequence, sent in application cursor mode and
+ * for F1-F4; 0 if unknown */
+static int
+_ss3_key(int final)
+{
+    switch (final) {
+    case 'A': return KEY_UP;
+    case 'B': return KEY_DOWN;
+    case 'C': return KEY_RIGHT;
+    case 'D': return KEY_LEFT;
+    case 'H': return KEY_HOME;
+    case 'F': return KEY_END;
+    case 'P': case 'Q': case 'R': case 'S':
+        return KEY_F(final - 'P' + 1);
     }
+    return 0;
+}
+
+/*
+ * Decode the sequence at the head of the queue (ESC first). Returns the
+ * key and its length in *len, 0 if the sequence is unknown (*len bytes
+ * to drop), or 27 with *len = 1 for a lone ESC.
+ */
+static int
+_decode_esc(unsigned *len)
+{
+    *len = 1;
+    if (!_rx_wait(1, INCURSES_ESCDELAY)) {
+        return 27;
+    }
+
+    int intro = _rx_peek(1);
+    if (intro != '[' && intro != 'O') {
+        return 27;                      /* ESC x: x is the next key */
+    }
+    if (!_rx_wait(2, INCURSES_ESCDELAY)) {
+        *len = 2;
+        return 0;
+    }
+    if (intro == 'O') {
+        *len = 3;
+        return _ss3_key(_rx_peek(2));
+    }
+
+    /* CSI: parameters and separators, then a final byte 0x40-0x7E */
+    unsigned param[2] = { 0, 0 }, np = 0, n = 2;
+    for (;;) {
+        int c = _rx_peek(n++);
+        if (c >= '0' && c <= '9') {
+            if (np < 2) param[np] = param[np] * 10 + (c - '0');
+        } else if (c == ';') {
+            np++;
+        } else if (c >= 0x40 && c <= 0x7e) {
+            *len = n;
+            return _csi_key(param[0], np >= 1 ? param[1] : 1, c);
+        } else if (c < 0x20 || c > 0x3f) {
+            *len = n - 1;               /* Not a CSI byte: stop before it */
+            return 0;
+        }
+        if (n >= INCURSES_RXBUF || !_rx_wait(n, INCURSES_ESCDELAY)) {
+            *len = n;
+            return 0;
+        }
+    }
+}
+
+static int
+_embeddedserial_getc(int timeout_ms)
+{
+    uint32_t start = incurses_millis();
+
+#ifdef INCURSES_TXBUF
+    // Keep the frame going out, also while blocked waiting for a key
+    _tx_pump();
+#endif
+
+    for (;;) {
+        int left = timeout_ms;
+        if (timeout_ms > 0) {
+            uint32_t elapsed = incurses_millis() - start;
+            left = elapsed >= (uint32_t)timeout_ms ? 0 : timeout_ms - (int)elapsed;
+        }
+        if (!_rx_wait(0, left)) {
+            return ERR;
+        }
 
-    // Block until data available (or return immediately if available)
-    return (int)uart_getc();
+        int c = _rx_peek(0);
+        unsigned len = 1;
+        if (c == 27 && G(keypad)) {
+            c = _decode_esc(&len);
+        }
+        rx_tail += len;
+        if (c != 0) {
+            return c;
+        }
+        /* Unknown sequence dropped: wait on for a key */
+    }
 }
 
+
 static void
 _embeddedserial_putc(int c)
 {
     DBGC(c);
+#ifdef INCURSES_TXBUF
+    while (tx_head - tx_tail == INCURSES_TXBUF) {
+        _tx_pump();
+        _rx_poll();
+    }
+    tx_ring[tx_head++ & TX_MASK] = c;
+#else
     uart_putc((char)c);
+#endif
 }
 
 static void
@@ -206,10 +505,16 @@ _embeddedserial_puts(const char *str)
 #define DRV_RAW(bf)
 #define DRV_ECHO(bf)
 #define DRV_GETC _embeddedserial_getc
-#define DRV_FLUSHIN()
+#define DRV_FLUSHIN() _rx_flush()
 #define DRV_PUTC _embeddedserial_putc
 #define DRV_PUTS _embeddedserial_puts
+#ifdef INCURSES_TXBUF
+#define DRV_FLUSH() (fflush(stdout), _tx_pump())
+#define DRV_IDLE() _tx_pump()
+#define DRV_DRAIN() _tx_drain()
+#else
 #define DRV_FLUSH() fflush(stdout)
+#endif
 
 #else
 /*-----------------------------------------------------------------------
@@ -275,6 +580,393 @@ unixterm_puts(const char *str)
 
 #endif
 
+/* Output ring hooks (INCURSES_TXBUF): pass some on, pass all on */
+#ifndef DRV_IDLE
+#define DRV_IDLE()
+#define DRV_DRAIN()
+#endif
+
+#ifdef INCURSES_BACKBUFFER
+/*-----------------------------------------------------------------------
+ *	Back buffer
+ *
+ *	addch() and friends only write the virtual screen (vscr); refresh()
+ *	compares it with what the terminal shows (pscr) and sends just the
+ *	cells that differ, with the shortest cursor motion it knows and
+ *	ESC[K for blank row tails. Redrawing a whole menu to move the
+ *	highlight costs a few dozen bytes instead of the full screen.
+ *	Nothing reaches the terminal before refresh(). After endwin() the
+ *	terminal is assumed overwritten: the next refresh() repaints it, as
+ *	does wrefresh(curscr). clear() only blanks vscr.
+ *
+ *	Cells hold a BMP code point, so UTF-8 strings (e.g. a check mark)
+ *	take one column as on the terminal.
+ *
+ *	scrl(), insertln(), deleteln() and a line feed at the bottom of
+ *	the scrolling region move rows of vscr and note the move; refresh()
+ *	has the terminal do the same (DECSTBM region, then LF or RI) when
+ *	that leaves more rows matching, and sends only the rows that came
+ *	in. A list scrolled by one line costs that line.
+ *-----------------------------------------------------------------------*/
+typedef struct {
+    uint16_t ch;                        /* code point */
+    attr_t attr;
+} incur_cell;
+
+static unsigned _motion(unsigned py, unsigned px, unsigned y, unsigned x, bool emit);
+
+static incur_cell vscr[LINES][COLS];    /* what the program drew */
+static incur_cell pscr[LINES][COLS];    /* what the terminal shows */
+
+/* Rows top..bot of vscr moved up n (down if n < 0) */
+typedef struct {
+    uint8_t top, bot;
+    int8_t n;
+} incur_scroll;
+
+#define BB_SCROLLS 4
+
+static struct {
+    bool valid;                         /* pscr matches the terminal */
+    bool cleared;                       /* clear() since the last refresh */
+    attr_t clear_attr;                  /* ...in these colours */
+    uint8_t x, y;                       /* terminal cursor, x == COLS */
+                                        /* after the last column */
+    attr_t attr;                        /* terminal attributes */
+    uint8_t rtop, rbot;                 /* terminal scrolling region */
+    uint32_t u8_cp;                     /* UTF-8 sequence being added */
+    uint8_t u8_need;                    /* continuation bytes to come */
+    incur_scroll scrolls[BB_SCROLLS];   /* since the last refresh */
+    uint8_t nscrolls;
+} incur_bb = {
+    .valid = false,
+    .rtop = 0,
+    .rbot = LINES-1,
+};
+
+#define BB(v) (incur_bb.v)
+
+
+/* Blank cell in the current colours, as ESC[2J and ESC[K leave it */
+static incur_cell
+_bb_blank(void)
+{
+    incur_cell c = { ' ', G(attr) & (INCURSES_FG_MASK | INCURSES_BG_MASK) };
+    return c;
+}
+
+static void
+_bb_fill(unsigned y, unsigned x, unsigned x_end)
+{
+    incur_cell c = _bb_blank();
+    while (x < x_end) {
+        vscr[y][x++] = c;
+    }
+}
+
+/* Move rows top..bot up n, or down -n; blank the rows that come in */
+static void
+_bb_scroll(unsigned top, unsigned bot, int n)
+{
+    unsigned h = bot - top + 1, a = n < 0 ? -n : n, y;
+
+    if (n == 0) {
+        return;
+    }
+    if (a >= h) {
+        a = h;
+    } else if (n > 0) {
+        memmove(vscr[top], vscr[top+a], sizeof(vscr[0]) * (h - a));
+    } else {
+        memmove(vscr[top+a], vscr[top], sizeof(vscr[0]) * (h - a));
+    }
+    for (y = 0; y < a; y++) {
+        _bb_fill(n > 0 ? bot - y : top + y, 0, COLS);
+    }
+
+    /* Note it for refresh(), merged with the last one if alike */
+    incur_scroll *s = BB(nscrolls) ? &BB(scrolls)[BB(nscrolls) - 1] : NULL;
+    if (s && s->top == top && s->bot == bot &&
+        (s->n > 0) == (n > 0) && s->n + n > -LINES && s->n + n < LINES) {
+        s->n += n;
+    } else if (BB(nscrolls) < BB_SCROLLS) {
+        s = &BB(scrolls)[BB(nscrolls)++];
+        s->top = top;
+        s->bot = bot;
+        s->n = n;
+    }
+    /* else: the rows are redrawn instead */
+}
+
+static void
+_bb_linefeed(void)
+{
+    if (G(y) == G(bot)) {
+        /* Bottom of the region: scroll, as the terminal would have */
+        if (G(scroll)) {
+            _bb_scroll(G(top), G(bot), 1);
+        }
+    } else if (G(y) < LINES-1) {
+        ++ G(y);
+    }
+}
+
+static void
+_bb_put(uint16_t ch)
+{
+    if (G(x) >= COLS) {                 /* auto margin */
+        G(x) = 0;
+        _bb_linefeed();
+    }
+    vscr[G(y)][G(x)].ch = ch;
+    vscr[G(y)][G(x)].attr = G(attr);
+    ++ G(x);
+}
+
+static void
+_bb_addch(uint8_t ch)
+{
+    if (ch < 0x80) {
+        BB(u8_need) = 0;
+    }
+    switch (ch) {
+    case 0x08:
+        if (G(x) > 0) {
+            -- G(x);
+        }
+        break;
+    case 0x09:				/* Move to 8-sized tab stop */
+        do {
+            _bb_put(' ');
+        } while (G(x) % 8 && G(x) < COLS);
+        break;
+    case 0x0a:
+        clrtoeol();
+        _bb_linefeed();
+        G(x) = 0;
+        break;
+    case 0x0d:
+        G(x) = 0;
+        break;
+    default:
+        if (ch >= 0xc0) {               /* UTF-8 lead byte */
+            BB(u8_need) = ch >= 0xf0 ? 3 : ch >= 0xe0 ? 2 : 1;
+            BB(u8_cp) = ch & (0x3f >> BB(u8_need));
+        } else if (ch >= 0x80) {
+            if (BB(u8_need) > 0) {
+                BB(u8_cp) = (BB(u8_cp) << 6) | (ch & 0x3f);
+                if (-- BB(u8_need) == 0) {
+                    _bb_put(BB(u8_cp) > 0xffff ? '?' : BB(u8_cp));
+                }
+            }
+        } else if (ch >= 0x20 && ch < 0x7f) {
+            _bb_put(ch);
+        } else {
+            DBG("addch %02x", ch);      /* no cell for other controls */
+        }
+    }
+}
+
+static void
+_bb_putch(uint16_t ch)
+{
+    if (ch < 0x80) {
+        _out(ch);
+    } else if (ch < 0x800) {
+        _out(0xc0 | (ch >> 6));
+        _out(0x80 | (ch & 0x3f));
+    } else {
+        _out(0xe0 | (ch >> 12));
+        _out(0x80 | ((ch >> 6) & 0x3f));
+        _out(0x80 | (ch & 0x3f));
+    }
+}
+
+static void
+_bb_attr(attr_t attr)
+{
+    if (attr != BB(attr)) {
+        _sgr(BB(attr), attr);
+        BB(attr) = attr;
+    }
+}
+
+/* Terminal cursor to (y, x), cheapest way first */
+static void
+_bb_goto(unsigned y, unsigned x)
+{
+    unsigned px = BB(x), i;
+
+    if (BB(y) == y && px == x) {
+        return;
+    }
+    if (BB(y) == y && px < x && x - px < _motion(BB(y), px, y, x, false)) {
+        /* Sending again what is already there can be shorter */
+        for (i = px; i < x; i++) {
+            if (pscr[y][i].ch >= 0x80 || pscr[y][i].attr != BB(attr)) break;
+        }
+        if (i == x) {
+            for (i = px; i < x; i++) {
+                _out(pscr[y][i].ch);
+            }
+            BB(x) = x;
+            return;
+        }
+    }
+    _motion(BB(y), px, y, x, true);
+    BB(y) = y;
+    BB(x) = x;
+}
+
+static void
+_bb_region(unsigned top, unsigned bot)
+{
+    _region(top, bot);
+    BB(rtop) = top;
+    BB(rbot) = bot;
+    BB(x) = BB(y) = 0;
+}
+
+/* Have the terminal scroll as vscr did, if that leaves more rows right */
+static void
+_bb_hwscroll(const incur_scroll *s)
+{
+    unsigned top = s->top, bot = s->bot, h = bot - top + 1;
+    unsigned a = s->n < 0 ? -s->n : s->n, y, i, moved = 0, kept = 0;
+
+    if (a >= h) {
+        return;
+    }
+    for (y = top; y <= bot; y++) {
+        unsigned from = s->n > 0 ? y + a : y - a;   /* wraps if y < a */
+        if (from >= top && from <= bot) {
+            moved += memcmp(vscr[y], pscr[from], sizeof(vscr[y])) == 0;
+        }
+        kept += memcmp(vscr[y], pscr[y], sizeof(vscr[y])) == 0;
+    }
+    if (moved <= kept) {
+        return;
+    }
+
+    if (BB(rtop) != top || BB(rbot) != bot) {
+        _bb_region(top, bot);
+    }
+    _bb_attr(A_NORMAL);                 /* rows come in blank */
+    if (s->n > 0) {
+        _bb_goto(bot, 0);
+        for (i = 0; i < a; i++) {
+            _out('\n');                 /* LF at the bottom margin */
+        }
+        memmove(pscr[top], pscr[top+a], sizeof(pscr[0]) * (h - a));
+    } else {
+        _bb_goto(top, 0);
+        for (i = 0; i < a; i++) {
+            _outs(ESC"M");              /* RI at the top margin */
+        }
+        memmove(pscr[top+a], pscr[top], sizeof(pscr[0]) * (h - a));
+    }
+    for (i = 0; i < a; i++) {
+        y = s->n > 0 ? bot - i : top + i;
+        for (unsigned x = 0; x < COLS; x++) {
+            pscr[y][x].ch = ' ';
+            pscr[y][x].attr = A_NORMAL;
+        }
+    }
+}
+
+/* Send the differences between vscr and the terminal */
+static void
+_bb_update(void)
+{
+    unsigned x, y;
+
+    if (BB(valid)) {
+        for (unsigned i = 0; i < BB(nscrolls); i++) {
+            _bb_hwscroll(&BB(scrolls)[i]);
+        }
+    }
+    BB(nscrolls) = 0;
+
+    bool repaint = ! BB(valid);
+
+    if (! repaint && BB(cleared)) {
+        /* After clear(), ESC[2J may beat blanking cell by cell */
+        unsigned changed = 0, drawn = 0;
+        for (y = 0; y < LINES; y++) {
+            for (x = 0; x < COLS; x++) {
+                incur_cell c = vscr[y][x];
+                changed += c.ch != pscr[y][x].ch || c.attr != pscr[y][x].attr;
+                drawn += c.ch != ' ' || c.attr != BB(clear_attr);
+            }
+        }
+        repaint = drawn + 8 < changed;
+    }
+    if (repaint) {
+        attr_t blank = BB(cleared) ? BB(clear_attr) : A_NORMAL;
+        if (! BB(valid)) {
+            BB(attr) = ATTR_UNKNOWN;
+            _bb_region(0, LINES-1);     /* also homes the cursor */
+        }
+        _bb_attr(blank);
+        _outs(ESC"[2J");
+        for (y = 0; y < LINES; y++) {
+            for (x = 0; x < COLS; x++) {
+                pscr[y][x].ch = ' ';
+                pscr[y][x].attr = blank;
+            }
+        }
+        BB(valid) = true;
+    }
+    BB(cleared) = false;
+
+    for (y = 0; y < LINES; y++) {
+        unsigned tail;
+
+        if (memcmp(vscr[y], pscr[y], sizeof(vscr[y])) == 0) {
+            continue;
+        }
+
+        /* Start of the blank run that ends the row */
+        incur_cell last = vscr[y][COLS-1];
+        tail = COLS;
+        if (last.ch == ' ' && !(last.attr & INCURSES_ATTR_MASK)) {
+            while (tail > 0 && vscr[y][tail-1].ch == ' ' &&
+                   vscr[y][tail-1].attr == last.attr) {
+                -- tail;
+            }
+        }
+
+        for (x = 0; x < COLS; x++) {
+            incur_cell c = vscr[y][x];
+
+            if (c.ch == pscr[y][x].ch && c.attr == pscr[y][x].attr) {
+                continue;
+            }
+            if (x >= tail) {
+                unsigned n = 0;
+                for (unsigned i = x; i < COLS; i++) {
+                    n += pscr[y][i].ch != ' ' || pscr[y][i].attr != last.attr;
+                }
+                if (n > 3) {
+                    _bb_goto(y, x);
+                    _bb_attr(last.attr);
+                    _outs(ESC"[K");
+                    memcpy(&pscr[y][x], &vscr[y][x], sizeof(incur_cell) * (COLS - x));
+                    break;
+                }
+            }
+            _bb_goto(y, x);
+            _bb_attr(c.attr);
+            _bb_putch(c.ch);
+            pscr[y][x] = c;
+            ++ BB(x);                   /* COLS: wrap pending */
+        }
+    }
+
+    _bb_goto(G(y), G(x) < COLS ? G(x) : COLS-1);
+}
+#endif
+
 /*-----------------------------------------------------------------------
  *	initscr
  *-----------------------------------------------------------------------*/
@@ -284,6 +976,7 @@ initscr(void)
     DRV_ECHO(false);
     attrset(A_NORMAL);
     clear();
+    setscrreg(0, LINES-1);
     move(0,0);
     G(started) = true;
     return stdscr;
@@ -296,8 +989,18 @@ endwin(void)
     attrset(A_NORMAL);
     clrtoeol();
     curs_set(true);
-    DRV_PUTS(ESC"[4l");                 /* set replace mode */
+    _outs(ESC"[4l");                 /* set replace mode */
+    setscrreg(0, LINES-1);
     refresh();
+#ifdef INCURSES_BACKBUFFER
+    if (BB(rtop) != 0 || BB(rbot) != LINES-1) {
+        _bb_region(0, LINES-1);
+        _move(LINES-1, 0);
+    }
+    _bb_attr(A_NORMAL);                 /* for whatever prints next */
+    BB(valid) = false;
+#endif
+    DRV_DRAIN();
     DRV_ECHO(true);
     G(started) = false;
     return OK;
@@ -404,9 +1107,9 @@ int
 curs_set(bool visible)
 {
     if (visible) {
-        DRV_PUTS(ESC"[?25h");
+        _outs(ESC"[?25h");
     } else {
-        DRV_PUTS(ESC"[?25l");
+        _outs(ESC"[?25l");
     }
     return OK;
 }
@@ -414,10 +1117,13 @@ curs_set(bool visible)
 int
 addch(uint8_t ch)
 {
+#ifdef INCURSES_BACKBUFFER
+    _bb_addch(ch);
+#else
     switch (ch) {
     case 0x08:				/* Left unless at first column */
         if (G(x) > 0) {
-            DRV_PUTC(ch);
+            _out(ch);
             -- G(x);
         }
         break;
@@ -426,24 +1132,31 @@ addch(uint8_t ch)
         break;
     case 0x0a:
         clrtoeol();
-        DRV_PUTC(ch);
-        ++ G(y);
+        if (G(y) == G(bot) && ! G(scroll)) {
+            _out('\r');                 /* stay on the bottom line */
+        } else {
+            _out(ch);
+        }
+        if (G(y) != G(bot) && G(y) < LINES-1) {
+            ++ G(y);
+        }
         G(x) = 0;
         break;
     case 0x0d:				/* Move to first column */
-        DRV_PUTC(ch);
+        _out(ch);
         G(x) = 0;
         break;
     default:
         if (ch < 0x20 || ch >= 0x7f) {
             /* FIXME */
             DBG("addch %02x", ch);
-            DRV_PUTC(ch);
+            _out(ch);
         } else {
-            DRV_PUTC(ch);
+            _out(ch);
             ++ G(x);
         }
     }
+#endif
     return OK;
 }
 
@@ -452,6 +1165,7 @@ addnstr(const char *str, int n)
 {
     if (n < 0) n = strlen(str);
     DBG("addstr \"%.*s\"", n, str);
+    DRV_IDLE();
     while (n-- > 0) {
         chtype c = *str++;
         addch(c);
@@ -479,23 +1193,9 @@ attrset(attr_t attr)
 {
     if (attr != G(attr)) {
         DBG("attrset %04x", attr);
-        DRV_PUTS(ESC"[0");
-        if (attr & INCURSES_FG_MASK) {
-            DRV_PUTS(";3");
-            DRV_PUTC('0' + GET_FG(attr));
-        }
-        if (attr & INCURSES_BG_MASK) {
-            DRV_PUTS(";4");
-            DRV_PUTC('0' + GET_BG(attr));
-        }
-        if (attr & A_UNDERLINE) {
-            DRV_PUTS(";4");
-        }
-        if (attr & A_REVERSE) {
-            DRV_PUTS(";7");
-        }
-        DRV_PUTC('m');
-
+#ifndef INCURSES_BACKBUFFER
+        _sgr(G(attr), attr);
+#endif
         G(attr) = attr;
     }
     return OK;
@@ -504,36 +1204,72 @@ attrset(attr_t attr)
 int
 clear(void)
 {
-    DRV_PUTS(ESC"[2J");                 /* clear screen */
+#ifdef INCURSES_BACKBUFFER
+    for (unsigned y = 0; y < LINES; y++) {
+        _bb_fill(y, 0, COLS);
+    }
+    BB(cleared) = true;
+    BB(clear_attr) = _bb_blank().attr;
+#else
+    _outs(ESC"[2J");                 /* clear screen */
+#endif
     return OK;
 }
 
 int
 clrtoeol(void)
 {
-    DRV_PUTS(ESC"[K");                  /* clear to end of line */
+#ifdef INCURSES_BACKBUFFER
+    _bb_fill(G(y), G(x), COLS);
+#else
+    _outs(ESC"[K");                  /* clear to end of line */
+#endif
     return OK;
 }
 
 int
 move(int y, int x)
 {
+    DRV_IDLE();
+#ifdef INCURSES_BACKBUFFER
+    /* Clamp like the terminal does for ESC[y;xH */
+    G(x) = x < 0 ? 0 : x >= COLS ? COLS-1 : x;
+    G(y) = y < 0 ? 0 : y >= LINES ? LINES-1 : y;
+#else
     if (! (x == G(x) && y == G(y))) {
         DBG("move %d %d", y, x);
         G(x) = x;
         G(y) = y;
         _move(y, x);
     }
+#endif
     return OK;
 }
 
 int
 refresh(void)
 {
+#ifdef INCURSES_BACKBUFFER
+    _bb_update();
+#endif
     DRV_FLUSH();
+    out_frame = out_total - out_frame_start;
+    out_frame_start = out_total;
     return OK;
 }
 
+uint32_t
+incurses_bytes(void)
+{
+    return out_total;
+}
+
+uint32_t
+incurses_frame_bytes(void)
+{
+    return out_frame;
+}
+
 char *
 unctrl(chtype c)
 {
@@ -660,6 +1396,11 @@ wclear(WINDOW *win)
 int
 wrefresh(WINDOW *win)
 {
+#ifdef INCURSES_BACKBUFFER
+    if (win == curscr) {
+        BB(valid) = false;              /* terminal garbled: repaint */
+    }
+#endif
     (void)win;
     return refresh();
 }
@@ -682,8 +1423,15 @@ doupdate(void)
 int
 insertln(void)
 {
-    /* Insert a blank line at cursor position, scrolling down */
-    DRV_PUTS(ESC"[L");
+    /* Insert a blank line at cursor position, scrolling down to the
+     * bottom of the region; outside it the terminal ignores ESC[L */
+#ifdef INCURSES_BACKBUFFER
+    if (G(y) >= G(top) && G(y) <= G(bot)) {
+        _bb_scroll(G(y), G(bot), -1);
+    }
+#else
+    _outs(ESC"[L");
+#endif
     return OK;
 }
 
@@ -691,19 +1439,280 @@ int
 deleteln(void)
 {
     /* Delete line at cursor position, scrolling up */
-    DRV_PUTS(ESC"[M");
+#ifdef INCURSES_BACKBUFFER
+    if (G(y) >= G(top) && G(y) <= G(bot)) {
+        _bb_scroll(G(y), G(bot), 1);
+    }
+#else
+    _outs(ESC"[M");
+#endif
     return OK;
 }
 
+/*-----------------------------------------------------------------------
+ *	Scrolling region
+ *-----------------------------------------------------------------------*/
+int
+setscrreg(int top, int bot)
+{
+    if (top < 0 || bot >= LINES || top >= bot) return ERR;
+    G(top) = top;
+    G(bot) = bot;
+#ifndef INCURSES_BACKBUFFER
+    _region(top, bot);
+    _move(G(y), G(x));                  /* DECSTBM homed the cursor */
+#endif
+    return OK;
+}
+
+int
+wsetscrreg(WINDOW *win, int top, int bot)
+{
+    (void)win;
+    return setscrreg(top, bot);
+}
+
+int
+scrollok(WINDOW *win, bool bf)
+{
+    (void)win;
+    G(scroll) = bf;
+    return OK;
+}
+
+int
+scrl(int n)
+{
+    /* Scroll the region up n lines, or down -n */
+#ifdef INCURSES_BACKBUFFER
+    _bb_scroll(G(top), G(bot), n);
+#else
+    if (n == 0) {
+        return OK;
+    }
+    _move(n > 0 ? G(bot) : G(top), 0);
+    for (; n > 0; n--) {
+        _out('\n');                     /* LF at the bottom margin */
+    }
+    for (; n < 0; n++) {
+        _outs(ESC"M");                  /* RI at the top margin */
+    }
+    _move(G(y), G(x));
+#endif
+    return OK;
+}
+
+int
+wscrl(WINDOW *win, int n)
+{
+    (void)win;
+    return scrl(n);
+}
+
+int
+scroll(WINDOW *win)
+{
+    return wscrl(win, 1);
+}
+
 /*-----------------------------------------------------------------------
  *	internals
  *-----------------------------------------------------------------------*/
 static void
+_out(int c)
+{
+    ++ out_total;
+    DRV_PUTC(c);
+}
+
+static void
+_outs(const char *str)
+{
+    out_total += strlen(str);
+    DRV_PUTS(str);
+}
+
+/* Absolute move in its shortest form: ESC[H, ESC[yH or ESC[y;xH */
+static void
 _move(unsigned y, unsigned x)
 {
     char cmd[10];
-    sprintf(cmd, ESC"[%u;%uH", y+1, x+1);
-    DRV_PUTS(cmd);
+    if (x == 0 && y == 0) {
+        _outs(ESC"[H");
+        return;
+    }
+    if (x == 0) {
+        sprintf(cmd, ESC"[%uH", y+1);
+    } else {
+        sprintf(cmd, ESC"[%u;%uH", y+1, x+1);
+    }
+    _outs(cmd);
+}
+
+/* DECSTBM scrolling region, rows top..bot; the terminal homes the cursor */
+static void
+_region(unsigned top, unsigned bot)
+{
+    char cmd[10];
+    if (top == 0 && bot == LINES-1) {
+        _outs(ESC"[r");
+        return;
+    }
+    sprintf(cmd, ESC"[%u;%ur", top+1, bot+1);
+    _outs(cmd);
+}
+
+#ifdef INCURSES_BACKBUFFER
+static unsigned
+_digits(unsigned n)
+{
+    return n >= 100 ? 3 : n >= 10 ? 2 : 1;
+}
+
+/* ESC[<n><cmd> */
+static void
+_csi(unsigned n, char cmd)
+{
+    char buf[8];
+    sprintf(buf, ESC"[%u%c", n, cmd);
+    _outs(buf);
+}
+
+/* Length of what _move() sends */
+static unsigned
+_move_cost(unsigned y, unsigned x)
+{
+    if (x == 0) {
+        return y == 0 ? 3 : 3 + _digits(y+1);
+    }
+    return 4 + _digits(y+1) + _digits(x+1);
+}
+
+/* Move along the row from column px (< COLS): CR, backspaces, ESC[nC/D */
+static unsigned
+_hmove(unsigned px, unsigned x, bool emit)
+{
+    unsigned n, bs, csi, cr;
+
+    if (x >= px) {
+        n = x - px;
+        if (n == 0) return 0;
+        if (emit) _csi(n, 'C');
+        return 3 + _digits(n);
+    }
+    n = px - x;
+    bs = n;
+    csi = 3 + _digits(n);
+    cr = x == 0 ? 1 : 4 + _digits(x);
+    if (cr <= bs && cr <= csi) {
+        if (emit) {
+            _out('\r');
+            if (x) _csi(x, 'C');
+        }
+        return cr;
+    }
+    if (bs <= csi) {
+        if (emit) {
+            while (n--) _out('\b');
+        }
+        return bs;
+    }
+    if (emit) _csi(n, 'D');
+    return csi;
+}
+
+/*
+ * Cheapest motion from the terminal cursor (py, px) to (y, x); sends it
+ * if emit, returns its length. px == COLS: the last column was written
+ * and the wrap is pending, so only CR is sure to work from there.
+ * ESC[nA/B stop at the margins of the scrolling region the cursor is
+ * in, and LF at its bottom scrolls: those are left out across them.
+ */
+static unsigned
+_motion(unsigned py, unsigned px, unsigned y, unsigned x, bool emit)
+{
+    unsigned best = _move_cost(y, x), cost, pre = 0, hx = 0;
+    int how = 0;
+
+    if (py < LINES && px <= COLS) {
+        bool inside = py >= BB(rtop) && py <= BB(rbot);
+        bool fenced = inside && (y < BB(rtop) || y > BB(rbot));
+
+        pre = px < COLS ? 0 : 1;            /* CR out of the pending wrap */
+        hx = px < COLS ? px : 0;
+        if (py == y) {
+            cost = pre + _hmove(hx, x, false);
+            if (cost < best) { best = cost; how = 1; }
+        } else if (! fenced) {
+            /* ESC[nA / ESC[nB keep the column */
+            unsigned n = y > py ? y - py : py - y;
+            cost = pre + 3 + _digits(n) + _hmove(hx, x, false);
+            if (cost < best) { best = cost; how = 2; }
+        }
+        if (y == py + 1 && py != BB(rbot)) {
+            cost = 2 + _hmove(0, x, false); /* CR LF */
+            if (cost < best) { best = cost; how = 3; }
+        }
+    }
+    if (! emit) return best;
+
+    switch (how) {
+    case 0:
+        _move(y, x);
+        break;
+    case 1:
+    case 2:
+        if (pre) _out('\r');
+        if (how == 2) _csi(y > py ? y - py : py - y, y > py ? 'B' : 'A');
+        _hmove(hx, x, true);
+        break;
+    case 3:
+        _outs("\r\n");
+        _hmove(0, x, true);
+        break;
+    }
+    return best;
+}
+
+#endif
+
+/* Change the terminal attributes from `from` (ATTR_UNKNOWN: anything)
+ * to `to`: the shorter of a reset list ESC[0;...m and a change list */
+static void
+_sgr(attr_t from, attr_t to)
+{
+    char full[20], delta[20];
+    char *p;
+
+    p = full + sprintf(full, ESC"[0");
+    if (to & INCURSES_FG_MASK) p += sprintf(p, ";3%d", GET_FG(to));
+    if (to & INCURSES_BG_MASK) p += sprintf(p, ";4%d", GET_BG(to));
+    if (to & A_UNDERLINE) p += sprintf(p, ";4");
+    if (to & A_REVERSE) p += sprintf(p, ";7");
+    sprintf(p, "m");
+
+    if (from == ATTR_UNKNOWN) {
+        _outs(full);
+        return;
+    }
+    p = delta + sprintf(delta, ESC"[");
+    if ((from ^ to) & INCURSES_FG_MASK) {
+        p += (to & INCURSES_FG_MASK) ? sprintf(p, "3%d;", GET_FG(to)) : sprintf(p, "39;");
+    }
+    if ((from ^ to) & INCURSES_BG_MASK) {
+        p += (to & INCURSES_BG_MASK) ? sprintf(p, "4%d;", GET_BG(to)) : sprintf(p, "49;");
+    }
+    if ((from ^ to) & A_UNDERLINE) {
+        p += sprintf(p, (to & A_UNDERLINE) ? "4;" : "24;");
+    }
+    if ((from ^ to) & A_REVERSE) {
+        p += sprintf(p, (to & A_REVERSE) ? "7;" : "27;");
+    }
+    if (p[-1] != ';') {
+        return;                         /* no change */
+    }
+    p[-1] = 'm';
+    _outs(p - delta < (int)strlen(full) ? delta : full);
 }
 
 /* end */
@@ -0,0 +1,448 @@
+//===============================================================================
+// Inflate - Table-Driven DEFLATE / gzip Decoder
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+
+#include "inflate.h"
+
+#define FAST_MASK   ((1u << INFLATE_FAST_BITS) - 1)
+
+// Length codes 257..285: base and extra bits
+static const uint16_t len_base[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uint8_t len_extra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+
+// Distance codes 0..29
+static const uint16_t dist_base[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+    8193, 12289, 16385, 24577
+};
+static const uint8_t dist_extra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+// Order of the code length code lengths in a dynamic block header
+static const uint8_t clen_order[19] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+//===============================================================================
+// Bit Buffer
+//===============================================================================
+
+// At least n bits (n <= 25) in bitbuf; zeros past the end of the input
+static inline void need(inflate_t *d, uint32_t n) {
+    while (d->bitcnt < n) {
+        uint32_t b = 0;
+
+        if (d->in < d->in_end) {
+            b = *d->in++;
+        } else {
+            d->overrun++;
+        }
+        d->bitbuf |= b << d->bitcnt;
+        d->bitcnt += 8;
+    }
+}
+
+static inline uint32_t bits(inflate_t *d, uint32_t n) {
+    uint32_t v;
+
+    need(d, n);
+    v = d->bitbuf & ((1u << n) - 1);
+    d->bitbuf >>= n;
+    d->bitcnt -= n;
+    return v;
+}
+
+// Some of the bits used were zeros fed past the end
+static int truncated(const inflate_t *d) {
+    return d->overrun * 8 > d->bitcnt;
+}
+
+//===============================================================================
+// Huffman Tables
+//===============================================================================
+
+static uint32_t reverse(uint32_t code, uint32_t len) {
+    uint32_t r = 0;
+
+    while (len--) {
+        r = (r << 1) | (code & 1);
+        code >>= 1;
+    }
+    return r;
+}
+
+// Canonical code from n code lengths. Returns the unused code space
+// (0: complete), or -1 if the lengths are over-subscribed.
+static int build(inflate_huff_t *h, const uint8_t *lens, uint32_t n) {
+    uint16_t offs[16];
+    uint32_t code = 0;
+    uint32_t idx = 0;
+    int left = 1;
+
+    for (uint32_t len = 0; len < 16; len++) {
+        h->count[len] = 0;
+    }
+    for (uint32_t s = 0; s < n; s++) {
+        h->count[lens[s]]++;
+    }
+    h->count[0] = 0;
+
+    for (uint32_t len = 1; len < 16; len++) {
+        left = (left << 1) - h->count[len];
+        if (left < 0) {
+            return -1;
+        }
+    }
+
+    offs[1] = 0;
+    for (uint32_t len = 1; len < 15; len++) {
+        offs[len + 1] = offs[len] + h->count[len];
+    }
+    for (uint32_t s = 0; s < n; s++) {
+        if (lens[s]) {
+            h->symbol[offs[lens[s]]++] = (uint16_t)s;
+        }
+    }
+
+    // Every code of up to FAST_BITS at all the table slots it prefixes
+    // (the stream sends codes MSB first, so the slot index is reversed)
+    for (uint32_t i = 0; i <= FAST_MASK; i++) {
+        h->fast[i] = 0;
+    }
+    for (uint32_t len = 1; len <= INFLATE_FAST_BITS; len++) {
+        for (uint32_t k = 0; k < h->count[len]; k++) {
+            uint16_t e = (uint16_t)(h->symbol[idx++] | (len << 9));
+
+            for (uint32_t j = reverse(code, len); j <= FAST_MASK; j += 1u << len) {
+                h->fast[j] = e;
+            }
+            code++;
+        }
+        code <<= 1;
+    }
+
+    return left;
+}
+
+// Next symbol, or -1 for a code that is not in the table
+static inline int decode(inflate_t *d, const inflate_huff_t *h) {
+    uint32_t e;
+
+    need(d, 15);
+    e = h->fast[d->bitbuf & FAST_MASK];
+    if (e) {
+        d->bitbuf >>= e >> 9;
+        d->bitcnt -= e >> 9;
+        return e & 0x1FF;
+    }
+
+    // Longer code: walk the canonical code a bit at a time
+    int code = 0, first = 0, index = 0;
+    uint32_t b = d->bitbuf;
+
+    for (uint32_t len = 1; len < 16; len++) {
+        int count = h->count[len];
+
+        code |= b & 1;
+        b >>= 1;
+        if (code - count < first) {
+            d->bitbuf >>= len;
+            d->bitcnt -= len;
+            return h->symbol[index + (code - first)];
+        }
+        index += count;
+        first = (first + count) << 1;
+        code <<= 1;
+    }
+    return -1;
+}
+
+//===============================================================================
+// Blocks
+//===============================================================================
+
+// Window full at pos: out it goes
+static int window_full(inflate_t *d, uint32_t pos) {
+    d->total = pos;
+    return d->flush(d->ctx, d->window, d->mask + 1) != 0;
+}
+
+// Literal/length and distance codes up to the end-of-block code
+static int codes(inflate_t *d) {
+    uint8_t *win = d->window;
+    uint32_t mask = d->mask;
+    uint32_t pos = d->total;
+
+    for (;;) {
+        int sym = decode(d, &d->lit);
+
+        if (sym < 256) {
+            if (sym < 0) {
+                return INFLATE_ERR_DATA;
+            }
+            win[pos & mask] = (uint8_t)sym;
+            pos++;
+            if (!(pos & mask) && window_full(d, pos)) {
+                return INFLATE_ERR_FLUSH;
+            }
+        } else if (sym == 256) {
+            d->total = pos;
+            return INFLATE_OK;
+        } else {
+            uint32_t len, dist, from;
+            int ds;
+
+            sym -= 257;
+            if (sym >= 29) {
+                return INFLATE_ERR_DATA;
+            }
+            len = len_base[sym] + bits(d, len_extra[sym]);
+
+            ds = decode(d, &d->dist);
+            if (ds < 0 || ds >= 30) {
+                return INFLATE_ERR_DATA;
+            }
+            dist = dist_base[ds] + bits(d, dist_extra[ds]);
+            if (dist > pos) {
+                return INFLATE_ERR_DATA;    // Before the start of the data
+            }
+
+            // Byte by byte: overlapping matches repeat the last dist bytes
+            from = pos - dist;
+            while (len--) {
+                win[pos & mask] = win[from++ & mask];
+                pos++;
+                if (!(pos & mask) && window_full(d, pos)) {
+                    return INFLATE_ERR_FLUSH;
+                }
+            }
+        }
+
+        // Corrupt data decoding zeros past the end would never stop
+        if (d->overrun > 4) {
+            return INFLATE_ERR_DATA;
+        }
+    }
+}
+
+static int stored(inflate_t *d) {
+    uint32_t len, nlen;
+
+    // To the byte boundary
+    d->bitbuf >>= d->bitcnt & 7;
+    d->bitcnt &= ~7u;
+
+    len = bits(d, 16);
+    nlen = bits(d, 16);
+    if (len != (~nlen & 0xFFFF) || truncated(d)) {
+        return INFLATE_ERR_DATA;
+    }
+
+    while (len--) {
+        d->window[d->total & d->mask] = (uint8_t)bits(d, 8);
+        d->total++;
+        if (!(d->total & d->mask) && window_full(d, d->total)) {
+            return INFLATE_ERR_FLUSH;
+        }
+    }
+    return truncated(d) ? INFLATE_ERR_DATA : INFLATE_OK;
+}
+
+static int fixed(inflate_t *d) {
+    uint8_t lens[288];
+    uint32_t i;
+
+    for (i = 0; i < 144; i++) lens[i] = 8;
+    for (; i < 256; i++) lens[i] = 9;
+    for (; i < 280; i++) lens[i] = 7;
+    for (; i < 288; i++) lens[i] = 8;
+    build(&d->lit, lens, 288);
+
+    for (i = 0; i < 30; i++) lens[i] = 5;
+    build(&d->dist, lens, 30);
+
+    return codes(d);
+}
+
+static int dynamic(inflate_t *d) {
+    uint8_t lens[286 + 30];
+    uint32_t hlit = bits(d, 5) + 257;
+    uint32_t hdist = bits(d, 5) + 1;
+    uint32_t hclen = bits(d, 4) + 4;
+    uint32_t i;
+
+    if (hlit > 286 || hdist > 30) {
+        return INFLATE_ERR_DATA;
+    }
+
+    // Code length code, in the distance table until the real one
+    for (i = 0; i < 19; i++) {
+        lens[clen_order[i]] = (i < hclen) ? (uint8_t)bits(d, 3) : 0;
+    }
+    if (build(&d->dist, lens, 19) != 0) {
+        return INFLATE_ERR_DATA;
+    }
+
+    for (i = 0; i < hlit + hdist; ) {
+        int sym = decode(d, &d->dist);
+        uint32_t rep;
+        uint8_t v = 0;
+
+        if (sym < 0) {
+            return INFLATE_ERR_DATA;
+        }
+        if (sym < 16) {
+            lens[i++] = (uint8_t)sym;
+            continue;
+        }
+        if (sym == 16) {
+            if (i == 0) {
+                return INFLATE_ERR_DATA;
+            }
+            v = lens[i - 1];
+            rep = 3 + bits(d, 2);
+        } else if (sym == 17) {
+            rep = 3 + bits(d, 3);
+        } else {
+            rep = 11 + bits(d, 7);
+        }
+        if (i + rep > hlit + hdist) {
+            return INFLATE_ERR_DATA;
+        }
+        while (rep--) {
+            lens[i++] = v;
+        }
+    }
+
+    // Incomplete codes are fine here: an unused code fails in decode()
+    if (lens[256] == 0 || truncated(d) ||
+        build(&d->lit, lens, hlit) < 0 ||
+        build(&d->dist, lens + hlit, hdist) < 0) {
+        return INFLATE_ERR_DATA;
+    }
+
+    return codes(d);
+}
+
+// Blocks up to the last one, and the rest of the window out
+static int blocks(inflate_t *d) {
+    uint32_t last;
+
+    do {
+        int res;
+
+        last = bits(d, 1);
+        switch (bits(d, 2)) {
+            case 0:  res = stored(d);  break;
+            case 1:  res = fixed(d);   break;
+            case 2:  res = dynamic(d); break;
+            default: res = INFLATE_ERR_DATA; break;
+        }
+        if (res != INFLATE_OK) {
+            return res;
+        }
+        if (truncated(d)) {
+            return INFLATE_ERR_DATA;
+        }
+    } while (!last);
+
+    if ((d->total & d->mask) && d->flush(d->ctx, d->window, d->total & d->mask)) {
+        return INFLATE_ERR_FLUSH;
+    }
+    return INFLATE_OK;
+}
+
+//===============================================================================
+// API
+//===============================================================================
+
+void inflate_init(inflate_t *d, uint8_t *window, uint32_t window_size,
+                  inflate_flush_fn flush, void *ctx) {
+    d->window = window;
+    d->mask = window_size - 1;
+    d->flush = flush;
+    d->ctx = ctx;
+    d->total = 0;
+    d->gzip_crc = 0;
+    d->gzip_size = 0;
+}
+
+static void input(inflate_t *d, const uint8_t *in, uint32_t len) {
+    d->in = in;
+    d->in_end = in + len;
+    d->bitbuf = 0;
+    d->bitcnt = 0;
+    d->overrun = 0;
+}
+
+int inflate_raw(inflate_t *d, const uint8_t *in, uint32_t len) {
+    input(d, in, len);
+    return blocks(d);
+}
+
+int inflate_gzip(inflate_t *d, const uint8_t *in, uint32_t len) {
+    uint32_t flg;
+    int res;
+
+    input(d, in, len);
+
+    // ID1 ID2 CM FLG MTIME(4) XFL OS
+    if (bits(d, 8) != 0x1F || bits(d, 8) != 0x8B || bits(d, 8) != 8) {
+        return INFLATE_ERR_HEADER;
+    }
+    flg = bits(d, 8);
+    if (flg & 0xE0) {
+        return INFLATE_ERR_HEADER;
+    }
+    bits(d, 16);
+    bits(d, 16);
+    bits(d, 16);
+
+    if (flg & 0x04) {                       // FEXTRA
+        for (uint32_t n = bits(d, 16); n && !d->overrun; n--) {
+            bits(d, 8);
+        }
+    }
+    if (flg & 0x08) {                       // FNAME
+        while (bits(d, 8) != 0 && !d->overrun);
+    }
+    if (flg & 0x10) {                       // FCOMMENT
+        while (bits(d, 8) != 0 && !d->overrun);
+    }
+    if (flg & 0x02) {                       // FHCRC
+        bits(d, 16);
+    }
+    if (d->overrun) {
+        return INFLATE_ERR_HEADER;
+    }
+
+    res = blocks(d);
+    if (res != INFLATE_OK) {
+        return res;
+    }
+
+    // Trailer: CRC32 and ISIZE, byte aligned
+    d->bitbuf >>= d->bitcnt & 7;
+    d->bitcnt &= ~7u;
+    d->gzip_crc = bits(d, 16);
+    d->gzip_crc |= bits(d, 16) << 16;
+    d->gzip_size = bits(d, 16);
+    d->gzip_size |= bits(d, 16) << 16;
+    if (truncated(d) || d->gzip_size != d->total) {
+        return INFLATE_ERR_DATA;
+    }
+
+    return INFLATE_OK;
+}
@@ -0,0 +1,88 @@
+//===============================================================================
+// Inflate - Table-Driven DEFLATE / gzip Decoder
+// Decodes a gzip image in memory into a window that is handed out as it fills
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// Replaces uzlib's bit-at-a-time Huffman decoding for the compressed
+// bootloader upload (overlay_upload.c). Codes of up to INFLATE_FAST_BITS
+// bits - nearly all of them - decode with one table lookup on a 32-bit
+// bit buffer that is refilled a byte at a time; longer codes fall back to
+// a canonical walk from the same counts.
+//
+// Output goes to a power-of-2 window (at least 32 KB, the DEFLATE
+// distance limit) in SRAM. The window is the LZ77 history: every time it
+// fills, and once at the end for what is left, flush() gets it, e.g. to
+// write it to the card while the next window decodes over it:
+//
+//   static inflate_t inf;              // ~5 KB of tables: not on the stack
+//   static uint8_t window[32768];
+//
+//   inflate_init(&inf, window, sizeof(window), write_window, &ctx);
+//   res = inflate_gzip(&inf, gz, gz_len);
+//   // INFLATE_OK: inf.total bytes out, inf.gzip_crc / inf.gzip_size
+//   // from the trailer for the caller to check
+//
+// No libc calls.
+//
+//===============================================================================
+
+#ifndef INFLATE_H
+#define INFLATE_H
+
+#include <stdint.h>
+
+// Code lengths decoded by one lookup (table of 2^INFLATE_FAST_BITS entries)
+#define INFLATE_FAST_BITS   10
+
+// Results
+#define INFLATE_OK          0
+#define INFLATE_ERR_HEADER  -1          // Not a gzip/deflate stream
+#define INFLATE_ERR_DATA    -2          // Corrupt or truncated stream
+#define INFLATE_ERR_FLUSH   -3          // flush() failed
+
+// Window out: len bytes at buf. Non-zero stops the decode (INFLATE_ERR_FLUSH).
+typedef int (*inflate_flush_fn)(void *ctx, const uint8_t *buf, uint32_t len);
+
+typedef struct {
+    uint16_t fast[1 << INFLATE_FAST_BITS];  // Symbol | length << 9, 0: longer code
+    uint16_t count[16];                     // Codes per length
+    uint16_t symbol[288];                   // Symbols in canonical order
+} inflate_huff_t;
+
+typedef struct {
+    // Input
+    const uint8_t *in;
+    const uint8_t *in_end;
+    uint32_t bitbuf;                // Next bits, LSB first
+    uint32_t bitcnt;
+    uint32_t overrun;               // Zero bytes fed past in_end
+
+    // Output
+    uint8_t *window;
+    uint32_t mask;                  // Window size - 1
+    uint32_t total;                 // Bytes out so far
+    inflate_flush_fn flush;
+    void *ctx;
+
+    // gzip trailer
+    uint32_t gzip_crc;              // CRC32 of the data
+    uint32_t gzip_size;             // Its size mod 2^32
+
+    inflate_huff_t lit;             // Literal/length codes
+    inflate_huff_t dist;            // Distance codes (and code length codes)
+} inflate_t;
+
+// window_size: a power of 2, at least 32768
+void inflate_init(inflate_t *d, uint8_t *window, uint32_t window_size,
+                  inflate_flush_fn flush, void *ctx);
+
+// Raw DEFLATE stream of len bytes
+int inflate_raw(inflate_t *d, const uint8_t *in, uint32_t len);
+
+// gzip member of len bytes: header, DEFLATE stream, trailer
+int inflate_gzip(inflate_t *d, const uint8_t *in, uint32_t len);
+
+#endif // INFLATE_H
@@ -0,0 +1,133 @@
+//===============================================================================
+// Interrupt controller (enable / pending / priority) at 0x80000140
+// Table-driven dispatch for firmware built with the generated start.S
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// Firmware that does not define irq_handler() gets the dispatcher in
+// start.S: on every IRQ entry it reads IRQC_CLAIM, acknowledges the highest
+// priority pending source and calls its entry in irq_vector_table[], until
+// nothing is left. Handlers run with interrupts off, exactly like a C
+// irq_handler(), and still have to clear (or disable) their source.
+//
+//   static void on_timer(uint32_t source) { TIMER_SR = TIMER_SR_UIF; ticks++; }
+//
+//   irq_register(IRQ_TIMER, on_timer, 8);
+//   irq_register(IRQ_UART_RX, on_uart_rx, 12);  // Dispatched first
+//   irq_enable_all();                           // CPU IRQ mask
+//
+// Defining irq_handler(uint32_t irqs) yourself still works and bypasses the
+// table. Without the controller (older bitstreams) the dispatcher falls back
+// to the PicoRV32 pending mask, lowest IRQ number first.
+//
+// Waiting: irq_wait() halts the CPU in waitirq - no instruction fetches,
+// no SRAM traffic - until an interrupt is pending. irq_wait_until() wraps
+// it for "sleep until this is true" loops, unmasking the sources that may
+// wake it only while their handler can run:
+//
+//   uart_irq_enable(UART_IRQ_RX_AVAIL);      // Handler disables it again
+//   irq_wait_until(UART_RX_STATUS & 1, 1u << IRQ_UART_RX);
+//
+// PicoRV32 latches every IRQ and keeps a masked one pending, so a source
+// that fired while masked ends each wait at once: the loop then polls,
+// as it did before.
+//
+//===============================================================================
+
+#ifndef IRQ_H
+#define IRQ_H
+
+#include <stdint.h>
+#include "atomic.h"
+
+#define IRQC_BASE           0x80000140
+#define IRQC_ENABLE         (*(volatile uint32_t*)(IRQC_BASE + 0x00))
+#define IRQC_PENDING        (*(volatile uint32_t*)(IRQC_BASE + 0x04))
+#define IRQC_PRIORITY       (*(volatile uint32_t*)(IRQC_BASE + 0x08))
+#define IRQC_CLAIM          (*(volatile uint32_t*)(IRQC_BASE + 0x0C))
+
+#define IRQC_CLAIM_VALID    (1u << 31)      // A source is pending
+#define IRQC_CLAIM_PRESENT  (1u << 30)      // Controller built in
+#define IRQC_CLAIM_SOURCE(c) ((c) & 0x7)
+
+// Sources (= PicoRV32 IRQ numbers)
+#define IRQ_TIMER           0
+#define IRQ_SOFT            1
+#define IRQ_SPI             2
+#define IRQ_MEM_DMA         3
+#define IRQ_UART_RX         4
+#define IRQ_UART_TX         5
+#define IRQ_BUTTON          6               // BUT1/BUT2 debounced event (lib/button.h); disabled at reset
+#define IRQ_TIMERS          7               // Timer channels 1-3, watchdog pre-timeout
+#define IRQ_NUM_SOURCES     8
+
+typedef void (*irq_vector_t)(uint32_t source);
+
+// Dispatch table, in scratchpad RAM next to the IRQ entry (start.S)
+extern irq_vector_t irq_vector_table[IRQ_NUM_SOURCES];
+
+static inline int irqc_present(void) {
+    // Unmapped MMIO reads return 0
+    return (IRQC_CLAIM & IRQC_CLAIM_PRESENT) != 0;
+}
+
+static inline void irq_set_priority(uint32_t source, uint32_t prio) {
+    uint32_t shift = source * 4;
+    IRQC_PRIORITY = (IRQC_PRIORITY & ~(0xFu << shift)) | ((prio & 0xF) << shift);
+}
+
+static inline void irq_source_enable(uint32_t source) {
+    IRQC_ENABLE |= 1u << source;
+}
+
+static inline void irq_source_disable(uint32_t source) {
+    IRQC_ENABLE &= ~(1u << source);
+}
+
+// Install a handler (0 = none) with priority 0-15 (15 = dispatched first)
+// and enable its source in the controller
+static inline void irq_register(uint32_t source, irq_vector_t handler, uint32_t prio) {
+    irq_vector_table[source] = handler;
+    if (irqc_present()) {
+        irq_set_priority(source, prio);
+        IRQC_PENDING = 1u << source;        // Drop events from before now
+        irq_source_enable(source);
+    }
+}
+
+// PicoRV32 CPU IRQ mask (maskirq): 0 = all IRQs enabled
+static inline uint32_t irq_setmask(uint32_t mask) {
+    uint32_t old;
+    __asm__ volatile (".insn r 0x0B, 6, 3, %0, %1, x0" : "=r"(old) : "r"(mask));
+    return old;
+}
+
+static inline void irq_enable_all(void) {
+    irq_setmask(0);
+}
+
+// Halt until an interrupt is pending, masked or not (PicoRV32 waitirq);
+// returns the pending bits. A compiler barrier: memory is read again after.
+static inline uint32_t irq_wait(void) {
+    uint32_t pending;
+    __asm__ volatile (".insn r 0x0B, 4, 4, %0, x0, x0" : "=r"(pending) : : "memory");
+    return pending;
+}
+
+// Sleep until cond holds. cond is tested with every IRQ masked, so the
+// wakeup cannot be taken between the test and waitirq; after each wakeup
+// the CPU IRQs in wake (plus those the caller had enabled) are unmasked
+// for their handlers to run, then cond is tested again.
+#define irq_wait_until(cond, wake) do {                             \
+    uint32_t irq_wait_old_ = atomic_irq_save();                     \
+    while (!(cond)) {                                               \
+        irq_wait();                                                 \
+        atomic_irq_restore(irq_wait_old_ & ~(uint32_t)(wake));      \
+        (void)atomic_irq_save();                                    \
+    }                                                               \
+    atomic_irq_restore(irq_wait_old_);                              \
+} while (0)
+
+#endif // IRQ_H
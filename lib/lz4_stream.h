@@ -0,0 +1,110 @@
+//===============================================================================
+// LZ4 Block Decoder for Byte Streams (UART uploads)
+// Decodes straight into the destination as the compressed bytes arrive
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// Raw LZ4 block format, as written by tools/lz4boot and fw_upload_fast -z.
+// Matches copy from the output already written, so there is no window
+// buffer: the only state is this struct. Used by bootloader_fast and
+// lib/simple_upload for the compressed FAST upload ('Z'):
+//
+//   PC: 'Z'                                   -> 'A'
+//   PC: compressed size (4), image size (4)   -> 'B' ('N' if too large)
+//   PC: LZ4 block, streamed
+//   PC: 'C' + CRC32 of the image (4)          -> 'C' + CRC32 of what decoded
+//
+// The decoder always takes exactly the announced number of input bytes,
+// even from a corrupt block, so the 'C' that follows is read in step.
+// No libc calls: fits the -nostdlib bootloaders.
+//
+//===============================================================================
+
+#ifndef LZ4_STREAM_H
+#define LZ4_STREAM_H
+
+#include <stdint.h>
+
+#define LZ4_STREAM_CMD      'Z'     // Opens a compressed upload instead of 'R'
+
+typedef struct {
+    uint8_t (*getc)(void);          // Next input byte (blocking)
+    uint32_t left;                  // Input bytes still to come
+    int      error;
+} lz4_stream_t;
+
+static inline uint8_t lz4_stream_byte(lz4_stream_t *s) {
+    if (s->left == 0) {
+        s->error = -1;              // Block ends early
+        return 0;
+    }
+    s->left--;
+    return s->getc();
+}
+
+// LZ4 length: 4-bit field, continued by bytes while they are 255
+static inline uint32_t lz4_stream_length(lz4_stream_t *s, uint32_t n) {
+    if (n == 15) {
+        uint8_t b;
+        do {
+            b = lz4_stream_byte(s);
+            n += b;
+        } while (b == 255 && !s->error);
+    }
+    return n;
+}
+
+// Decode s->left input bytes into exactly length bytes at dst.
+// Returns 0, or -1 for a corrupt block (the rest of the input is drained).
+static inline int lz4_stream_decode(lz4_stream_t *s, uint8_t *dst, uint32_t length) {
+    uint8_t *out = dst;
+    uint8_t *end = dst + length;
+
+    s->error = 0;
+    while (!s->error) {
+        uint8_t token = lz4_stream_byte(s);
+
+        // Literals
+        uint32_t n = lz4_stream_length(s, token >> 4);
+        if (n > (uint32_t)(end - out)) {
+            s->error = -1;
+            break;
+        }
+        while (n-- && !s->error) {
+            *out++ = lz4_stream_byte(s);
+        }
+
+        // The last sequence has no match
+        if (out == end) {
+            break;
+        }
+
+        // Match: 16-bit offset back into the output, length + 4
+        uint32_t offset = lz4_stream_byte(s);
+        offset |= (uint32_t)lz4_stream_byte(s) << 8;
+        n = lz4_stream_length(s, token & 15) + 4;
+        if (offset == 0 || offset > (uint32_t)(out - dst) ||
+            n > (uint32_t)(end - out)) {
+            s->error = -1;
+            break;
+        }
+        const uint8_t *src = out - offset;
+        while (n--) {
+            *out++ = *src++;
+        }
+    }
+
+    // Trailing bytes after the last literals are an error too
+    if (s->left) {
+        s->error = -1;
+        while (s->left) {
+            s->left--;
+            s->getc();
+        }
+    }
+    return s->error;
+}
+
+#endif // LZ4_STREAM_H
@@ -0,0 +1,137 @@
+//===============================================================================
+// Inter-core mailbox and core 1 control (hdl/mailbox.v, Kconfig DUAL_CORE)
+// One word each way between core 0 and core 1, at 0x80000260 on both
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// Core 1 (hdl/core1.v) is an RV32I PicoRV32 that starts at CORE1_RESET_ADDR
+// in SRAM once core 0 has copied its image there and set the run bit.
+// Both cores include this header: each sees its own side of the mailbox,
+// core_id() tells them apart.
+//
+// Shared memory: SRAM is common to both cores, but core 0's D-cache (Kconfig
+// DCACHE) is not coherent with core 1. Clean what core 1 will read with
+// mailbox_flush() before sending, and drop stale lines of what core 1 wrote
+// with mailbox_invalidate() before reading it. The atomic words
+// (lib/atomic.h) are one MMIO access each however many cores ask, so their
+// test-and-set locks work between the cores too.
+//
+// Usage (core 0):
+//   heap_set_limit((void *)CORE1_RESET_ADDR);  // Keep malloc() out of it
+//   core1_start(core1_image, core1_image_size);
+//   mailbox_flush(&job, sizeof(job));
+//   mailbox_send((uint32_t)&job);
+//   while (mailbox_recv() != (uint32_t)&job);
+//   mailbox_invalidate(&job, sizeof(job));
+//
+//===============================================================================
+
+#ifndef MAILBOX_H
+#define MAILBOX_H
+
+#include <stdint.h>
+#include "dma.h"
+
+#define MBOX_BASE               0x80000260
+#define MBOX_STATUS             (*(volatile uint32_t*)(MBOX_BASE + 0x00))
+#define MBOX_TX                 (*(volatile uint32_t*)(MBOX_BASE + 0x04))
+#define MBOX_RX                 (*(volatile uint32_t*)(MBOX_BASE + 0x08))
+#define MBOX_CTRL               (*(volatile uint32_t*)(MBOX_BASE + 0x0C))
+
+// STATUS
+#define MBOX_RX_FULL            (1u << 0)       // A message is waiting
+#define MBOX_TX_FULL            (1u << 1)       // The peer has not read ours yet
+#define MBOX_CORE_ID            (1u << 8)       // 1 on core 1
+#define MBOX_CORE1_RUNNING      (1u << 16)
+#define MBOX_PRESENT            (1u << 31)
+
+// CTRL
+#define MBOX_CTRL_IRQ_EN        (1u << 0)       // IRQ while RX_FULL
+#define MBOX_CTRL_CORE1_RUN     (1u << 8)       // Core 0 only: release core 1
+
+#define IRQ_MAILBOX             9               // Core 0 CPU IRQ; IRQ[0] on core 1
+
+// Core 1 image window in SRAM (Kconfig CORE1_RESET_ADDR); PROGADDR_IRQ is
+// 0x10 above the reset address, as for core 0
+#ifndef CORE1_RESET_ADDR
+#define CORE1_RESET_ADDR        0x00060000
+#endif
+#define CORE1_IMAGE_MAX         0x10000
+
+static inline int mailbox_present(void) {
+    // Unmapped MMIO reads return 0
+    return (MBOX_STATUS & MBOX_PRESENT) != 0;
+}
+
+static inline uint32_t core_id(void) {
+    return (MBOX_STATUS & MBOX_CORE_ID) ? 1 : 0;
+}
+
+// Post a word for the other core; 0 if the last one is still unread
+static inline int mailbox_try_send(uint32_t msg) {
+    if (MBOX_STATUS & MBOX_TX_FULL)
+        return 0;
+    MBOX_TX = msg;
+    return 1;
+}
+
+static inline void mailbox_send(uint32_t msg) {
+    while (!mailbox_try_send(msg));
+}
+
+static inline int mailbox_try_recv(uint32_t *msg) {
+    if (!(MBOX_STATUS & MBOX_RX_FULL))
+        return 0;
+    *msg = MBOX_RX;
+    return 1;
+}
+
+static inline uint32_t mailbox_recv(void) {
+    while (!(MBOX_STATUS & MBOX_RX_FULL));
+    return MBOX_RX;
+}
+
+// IRQ_MAILBOX (core 0) / IRQ[0] (core 1) while a message is waiting
+static inline void mailbox_irq_enable(int on) {
+    MBOX_CTRL = (MBOX_CTRL & ~MBOX_CTRL_IRQ_EN) | (on ? MBOX_CTRL_IRQ_EN : 0);
+}
+
+// Core 0 D-cache maintenance for buffers the cores share (no-ops without it)
+static inline void mailbox_flush(const void *p, uint32_t len) {
+    dma_dcache_op(CACHE_DCACHE_CLEAN, (uint32_t)p, len);
+}
+
+static inline void mailbox_invalidate(const void *p, uint32_t len) {
+    dma_dcache_op(CACHE_DCACHE_INV, (uint32_t)p, len);
+}
+
+//===============================================================================
+// Core 0 only
+//===============================================================================
+
+// Hold core 1 in reset; its side of the mailbox empties
+static inline void core1_stop(void) {
+    MBOX_CTRL = MBOX_CTRL & ~MBOX_CTRL_CORE1_RUN;
+}
+
+// Copy an image linked for CORE1_RESET_ADDR (firmware/core1/) and start it
+// from its first word. Returns 0 without a second core or if len is too big.
+static inline int core1_start(const void *image, uint32_t len) {
+    const uint32_t *src = (const uint32_t *)image;
+    volatile uint32_t *dst = (volatile uint32_t *)CORE1_RESET_ADDR;
+
+    if (!mailbox_present() || len > CORE1_IMAGE_MAX)
+        return 0;
+
+    core1_stop();
+    for (uint32_t i = 0; i < (len + 3) / 4; i++)
+        dst[i] = src[i];
+    mailbox_flush((const void *)CORE1_RESET_ADDR, len);
+
+    MBOX_CTRL |= MBOX_CTRL_CORE1_RUN;
+    return 1;
+}
+
+#endif // MAILBOX_H
@@ -0,0 +1,115 @@
+//===============================================================================
+// Fixed-block memory pool
+// O(1) alloc/free of equal-size blocks, safe from tasks and interrupts
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// For message buffers and queue items that come and go at a steady rate:
+// no fragmentation, no heap lock, and the storage can sit in scratchpad
+// RAM (.fastbss) instead of SRAM. Pass block pointers through a queue of
+// pointers instead of copying large items into the queue:
+//
+//   MEM_POOL_STORAGE_FAST(msg_storage, sizeof(Message_t), 8);
+//   static mem_pool_t msg_pool;
+//
+//   mem_pool_init(&msg_pool, msg_storage, sizeof(Message_t), 8);
+//   xQueue = xQueueCreate(8, sizeof(Message_t *));
+//
+//   Message_t *m = mem_pool_alloc(&msg_pool);  // Producer (NULL if empty)
+//   xQueueSend(xQueue, &m, portMAX_DELAY);
+//
+//   xQueueReceive(xQueue, &m, portMAX_DELAY);  // Consumer
+//   mem_pool_free(&msg_pool, m);
+//
+// Works the same without FreeRTOS: the critical sections mask IRQs with
+// PicoRV32 maskirq and restore the previous mask (lib/atomic.h), so they
+// nest with portENTER_CRITICAL() and are safe inside interrupt handlers.
+//
+//===============================================================================
+
+#ifndef MEM_POOL_H
+#define MEM_POOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "atomic.h"
+
+typedef struct {
+    void    *free_list;     // First free block (links stored in the blocks)
+    uint32_t block_words;
+    uint32_t count;
+    uint32_t in_use;
+    uint32_t peak;          // Most blocks ever in use at once
+} mem_pool_t;
+
+// Block size rounded up to whole words (blocks stay word aligned)
+#define MEM_POOL_WORDS(block_size)  (((block_size) + 3) / 4)
+
+// Storage for count blocks of block_size bytes, in SRAM or scratchpad
+#define MEM_POOL_STORAGE(name, block_size, count) \
+    static uint32_t name[(count) * MEM_POOL_WORDS(block_size)]
+#define MEM_POOL_STORAGE_FAST(name, block_size, count) \
+    static uint32_t name[(count) * MEM_POOL_WORDS(block_size)] __attribute__((section(".fastbss")))
+
+static inline uint32_t mem_pool_lock(void) {
+    return atomic_irq_save();
+}
+
+static inline void mem_pool_unlock(uint32_t old) {
+    atomic_irq_restore(old);
+}
+
+static inline void mem_pool_init(mem_pool_t *pool, uint32_t *storage,
+                                 uint32_t block_size, uint32_t count) {
+    uint32_t words = MEM_POOL_WORDS(block_size);
+
+    if (words == 0) words = 1;              // Room for the free-list link
+    pool->block_words = words;
+    pool->count = count;
+    pool->in_use = 0;
+    pool->peak = 0;
+    pool->free_list = NULL;
+
+    // Link the blocks back to front so allocation starts at the lowest
+    for (uint32_t i = count; i > 0; i--) {
+        uint32_t *block = storage + (i - 1) * words;
+        *(void **)block = pool->free_list;
+        pool->free_list = block;
+    }
+}
+
+// Returns NULL when every block is in use
+static inline void *mem_pool_alloc(mem_pool_t *pool) {
+    uint32_t mask = mem_pool_lock();
+    void *block = pool->free_list;
+
+    if (block) {
+        pool->free_list = *(void **)block;
+        if (++pool->in_use > pool->peak)
+            pool->peak = pool->in_use;
+    }
+
+    mem_pool_unlock(mask);
+    return block;
+}
+
+static inline void mem_pool_free(mem_pool_t *pool, void *block) {
+    uint32_t mask;
+
+    if (!block)
+        return;
+
+    mask = mem_pool_lock();
+    *(void **)block = pool->free_list;
+    pool->free_list = block;
+    pool->in_use--;
+    mem_pool_unlock(mask);
+}
+
+static inline uint32_t mem_pool_available(const mem_pool_t *pool) {
+    return pool->count - pool->in_use;
+}
+
+#endif // MEM_POOL_H
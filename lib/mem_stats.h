@@ -0,0 +1,73 @@
+//===============================================================================
+// Memory Statistics - Stack High-Water Mark, Heap Peak, malloc Counters
+// Sizing data for the SRAM regions (firmware/overlay_sdk/common/memory_config.h)
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// Implemented in lib/syscalls.c (newlib builds only):
+//
+//   - start.S / startFRT.S paint the STACK region (__stack_region ..
+//     __stack_top) with MEM_STACK_PAINT before main(); the high-water mark
+//     is the lowest word that no longer holds the pattern.
+//   - _sbrk() keeps the highest break it ever handed out.
+//   - The firmware Makefile links with -Wl,--wrap=_malloc_r,_free_r,_realloc_r
+//     and the wrappers count the calls reaching the allocator. A realloc()
+//     that has to move its block also counts as one malloc and one free;
+//     calloc() counts as a malloc with newlib's allocator (not with
+//     MALLOC_TLSF, where lib/tlsf/tlsf_malloc.c serves it directly).
+//
+//   mem_stats_t m;
+//   mem_stats_get(&m);
+//   printf("heap %lu/%lu peak, stack %lu/%lu peak, %lu free chunks\r\n",
+//          m.heap_peak, m.heap_size, m.stack_peak, m.stack_size, m.free_chunks);
+//
+// Overlays use the top of SRAM, which includes the STACK region: after an
+// overlay has run, call mem_stack_repaint() or the peak reads as the whole
+// region. Under FreeRTOS only main() before vTaskStartScheduler() runs on
+// this stack; task stacks have uxTaskGetStackHighWaterMark().
+//
+//===============================================================================
+
+#ifndef MEM_STATS_H
+#define MEM_STATS_H
+
+#include <stdint.h>
+
+#define MEM_STACK_PAINT     0xA5A5A5A5u
+
+typedef struct {
+    // _sbrk(): break between __heap_start and the heap limit
+    uint32_t heap_size;         // Limit - __heap_start (heap_set_limit() lowers it)
+    uint32_t heap_brk;          // Bytes below the current break
+    uint32_t heap_peak;         // Highest break since boot, in bytes
+    uint32_t sbrk_fails;        // ENOMEM returns
+
+    // newlib allocator state below the break (mallinfo, free list)
+    uint32_t heap_in_use;       // Bytes in allocated chunks, headers included
+    uint32_t heap_free;         // Bytes in free chunks
+    uint32_t free_chunks;       // Free-list length (fragmentation)
+
+    // Allocator calls since boot
+    uint32_t malloc_calls;
+    uint32_t malloc_fails;      // NULL returns
+    uint32_t malloc_bytes;      // Sum of the sizes asked of malloc()
+    uint32_t free_calls;        // free(NULL) included
+    uint32_t realloc_calls;
+
+    // Main stack (STACK region)
+    uint32_t stack_size;        // __stack_top - __stack_region
+    uint32_t stack_peak;        // Deepest use since the last paint, in bytes
+} mem_stats_t;
+
+// Snapshot of all counters. Walks the main stack paint and the free list.
+void mem_stats_get(mem_stats_t *m);
+
+// Deepest main stack use since the last paint, in bytes
+uint32_t mem_stack_peak(void);
+
+// Paint the unused part of the main stack again (below the caller's frame)
+void mem_stack_repaint(void);
+
+#endif // MEM_STATS_H
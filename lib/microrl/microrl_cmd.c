@@ -0,0 +1,247 @@
+//===============================================================================
+// MicroRL Command Registry - Hashed Dispatch, Completion, Scripts
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+
+#include "microrl_cmd.h"
+
+static char lower(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+}
+
+// FNV-1a of the lower-cased name
+static uint32_t name_hash(const char *s) {
+    uint32_t h = 2166136261u;
+
+    while (*s) {
+        h ^= (uint8_t)lower(*s++);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static int name_equal(const char *a, const char *b) {
+    while (*a && lower(*a) == lower(*b)) {
+        a++;
+        b++;
+    }
+    return lower(*a) == lower(*b);
+}
+
+// Name begins with prefix (case-insensitive)
+static int name_prefix(const char *name, const char *prefix) {
+    while (*prefix) {
+        if (lower(*name++) != lower(*prefix++)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+//===============================================================================
+// Table
+//===============================================================================
+
+int mrl_cmd_init(mrl_cmd_table_t *t, const mrl_cmd_t *cmds, int count,
+                 void (*out)(const char *s)) {
+    t->cmds = cmds;
+    t->count = 0;
+    t->out = out;
+    for (int i = 0; i < MRL_CMD_SLOTS; i++) {
+        t->slot[i] = 0;
+    }
+
+    if (count > MRL_CMD_MAX) {
+        out("mrl_cmd: too many commands\n");
+        return -1;
+    }
+
+    for (int i = 0; i < count; i++) {
+        uint32_t s = name_hash(cmds[i].name) & (MRL_CMD_SLOTS - 1);
+
+        while (t->slot[s]) {
+            if (name_equal(cmds[t->slot[s] - 1].name, cmds[i].name)) {
+                out("mrl_cmd: duplicate command ");
+                out(cmds[i].name);
+                out("\n");
+                return -1;
+            }
+            s = (s + 1) & (MRL_CMD_SLOTS - 1);
+        }
+        t->slot[s] = (uint8_t)(i + 1);
+    }
+    t->count = (uint8_t)count;
+
+    return 0;
+}
+
+const mrl_cmd_t *mrl_cmd_find(const mrl_cmd_table_t *t, const char *name) {
+    uint32_t s = name_hash(name) & (MRL_CMD_SLOTS - 1);
+
+    while (t->slot[s]) {
+        const mrl_cmd_t *c = &t->cmds[t->slot[s] - 1];
+
+        if (name_equal(c->name, name)) {
+            return c;
+        }
+        s = (s + 1) & (MRL_CMD_SLOTS - 1);
+    }
+    return NULL;
+}
+
+int mrl_cmd_exec(const mrl_cmd_table_t *t, int argc, const char *const *argv) {
+    const mrl_cmd_t *c;
+
+    if (argc == 0) {
+        return 0;
+    }
+
+    c = mrl_cmd_find(t, argv[0]);
+    if (!c) {
+        t->out("Unknown command: ");
+        t->out(argv[0]);
+        t->out(". Type 'h' for help.\n");
+        return -1;
+    }
+    return c->fn(argc, argv);
+}
+
+int mrl_cmd_exec_line(const mrl_cmd_table_t *t, char *line) {
+    const char *argv[MICRORL_CFG_CMD_TOKEN_NMB + 1];
+    int argc = 0;
+    char *p = line;
+
+    while (*p == ' ' || *p == '\t') {
+        p++;
+    }
+    if (*p == '#') {
+        return 0;
+    }
+
+    while (*p) {
+        if (argc == MICRORL_CFG_CMD_TOKEN_NMB) {
+            t->out("Too many arguments\n");
+            return -1;
+        }
+        argv[argc++] = p;
+        while (*p && *p != ' ' && *p != '\t') {
+            p++;
+        }
+        while (*p == ' ' || *p == '\t') {
+            *p++ = '\0';
+        }
+    }
+    argv[argc] = NULL;
+
+    return mrl_cmd_exec(t, argc, argv);
+}
+
+void mrl_cmd_help(const mrl_cmd_table_t *t) {
+    for (int i = 0; i < t->count; i++) {
+        if (t->cmds[i].help) {
+            t->out("  ");
+            t->out(t->cmds[i].help);
+            t->out("\n");
+        }
+    }
+}
+
+//===============================================================================
+// microRL
+//===============================================================================
+
+int mrl_cmd_microrl_exec(microrl_t *mrl, int argc, const char *const *argv) {
+    mrl_cmd_exec((const mrl_cmd_table_t *)mrl->userdata_ptr, argc, argv);
+    return 0;
+}
+
+#if MICRORL_CFG_USE_COMPLETE
+// Command names that begin with the first word; arguments are not completed
+static char **complete(microrl_t *mrl, int argc, const char *const *argv) {
+    mrl_cmd_table_t *t = (mrl_cmd_table_t *)mrl->userdata_ptr;
+    int n = 0;
+
+    if (argc == 1) {
+        for (int i = 0; i < t->count; i++) {
+            if (name_prefix(t->cmds[i].name, argv[0])) {
+                t->compl[n++] = t->cmds[i].name;
+            }
+        }
+    }
+    t->compl[n] = NULL;
+
+    return (char **)t->compl;
+}
+#endif
+
+void mrl_cmd_attach(mrl_cmd_table_t *t, microrl_t *mrl) {
+    mrl->userdata_ptr = t;
+    microrl_set_execute_callback(mrl, mrl_cmd_microrl_exec);
+#if MICRORL_CFG_USE_COMPLETE
+    microrl_set_complete_callback(mrl, complete);
+#endif
+}
+
+//===============================================================================
+// Scripts
+//===============================================================================
+
+int mrl_cmd_run(const mrl_cmd_table_t *t, mrl_cmd_reader_fn next_line, void *ctx) {
+    char line[MRL_CMD_LINE_LEN + 1];
+    int lineno = 0;
+    int run = 0;
+
+    while (next_line(line, sizeof(line), ctx) >= 0) {
+        char *p = line;
+
+        lineno++;
+        while (*p == ' ' || *p == '\t') {
+            p++;
+        }
+        if (*p == '\0' || *p == '#') {
+            continue;
+        }
+        if (mrl_cmd_exec_line(t, p) != 0) {
+            return -lineno;
+        }
+        run++;
+    }
+
+    return run;
+}
+
+typedef struct {
+    const char *p;
+    const char *end;
+} text_reader_t;
+
+// One line of the text; a line longer than the buffer is cut at its size
+static int text_next_line(char *buf, size_t size, void *ctx) {
+    text_reader_t *r = (text_reader_t *)ctx;
+    size_t n = 0;
+
+    if (r->p >= r->end || *r->p == '\0') {
+        return -1;
+    }
+    while (r->p < r->end && *r->p != '\0' && *r->p != '\n') {
+        char c = *r->p++;
+
+        if (c != '\r' && n < size - 1) {
+            buf[n++] = c;
+        }
+    }
+    if (r->p < r->end && *r->p == '\n') {
+        r->p++;
+    }
+    buf[n] = '\0';
+
+    return (int)n;
+}
+
+int mrl_cmd_run_text(const mrl_cmd_table_t *t, const char *text, size_t len) {
+    text_reader_t r = { text, text + len };
+
+    return mrl_cmd_run(t, text_next_line, &r);
+}
@@ -0,0 +1,103 @@
+//===============================================================================
+// MicroRL Command Registry - Hashed Dispatch, Completion, Scripts
+// One table of named commands behind a microRL prompt and batch scripts
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// A firmware lists its commands once; the registry hashes the names (FNV-1a,
+// case-insensitive, open addressing) so a line costs one hash and one
+// compare instead of a strcmp chain, completes command names on Tab, and
+// runs the same commands from a script without going through microRL:
+//
+//   static const mrl_cmd_t cmds[] = {
+//       { "dump", cmd_dump, "dump <addr> [len]   - Dump memory" },
+//       { "d",    cmd_dump, NULL },                  // Alias: not in help
+//       ...
+//   };
+//   static mrl_cmd_table_t shell;
+//
+//   mrl_cmd_init(&shell, cmds, MICRORL_ARRAYSIZE(cmds), uart_puts);
+//   microrl_init(&mrl, microrl_output, mrl_cmd_microrl_exec);
+//   mrl_cmd_attach(&shell, &mrl);                // exec + Tab completion
+//   ...
+//   mrl_cmd_run_text(&shell, buf, len);          // Script in memory
+//
+// A command returns 0 on success; anything else stops a script. Scripts
+// are plain text, one command per line; blank lines and lines starting
+// with '#' are skipped, and nothing is echoed, so a script runs as fast
+// as its commands do. mrl_cmd_run() takes its lines from a callback (a
+// FatFS f_gets() wrapper, the UART, ...), mrl_cmd_run_text() from memory.
+//
+//===============================================================================
+
+#ifndef MICRORL_CMD_H
+#define MICRORL_CMD_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "microrl.h"
+
+// Most commands in one table (aliases included)
+#ifndef MRL_CMD_MAX
+#define MRL_CMD_MAX         48
+#endif
+
+// Hash slots: power of 2, at least 2 x MRL_CMD_MAX keeps probes short
+#define MRL_CMD_SLOTS       128
+
+// Longest script line (the microRL command line length)
+#define MRL_CMD_LINE_LEN    MICRORL_CFG_CMDLINE_LEN
+
+// Command handler: argv[0] is the command name as typed
+typedef int (*mrl_cmd_fn)(int argc, const char *const *argv);
+
+typedef struct {
+    const char *name;
+    mrl_cmd_fn fn;
+    const char *help;               // Help line, NULL: alias, not listed
+} mrl_cmd_t;
+
+typedef struct {
+    const mrl_cmd_t *cmds;
+    uint8_t count;
+    uint8_t slot[MRL_CMD_SLOTS];    // Index + 1 into cmds, 0: empty
+    void (*out)(const char *s);
+    const char *compl[MRL_CMD_MAX + 1];  // Tab completion candidates
+} mrl_cmd_table_t;
+
+// Next script line into buf (NUL-terminated, without the newline);
+// -1 at the end of the script
+typedef int (*mrl_cmd_reader_fn)(char *buf, size_t size, void *ctx);
+
+// Build the hash table. -1 for more than MRL_CMD_MAX commands or a
+// name listed twice (reported through out).
+int mrl_cmd_init(mrl_cmd_table_t *t, const mrl_cmd_t *cmds, int count,
+                 void (*out)(const char *s));
+
+// Command by name (case-insensitive); NULL if there is none
+const mrl_cmd_t *mrl_cmd_find(const mrl_cmd_table_t *t, const char *name);
+
+// Run argv[0]: its handler's result, or -1 (and a message) if unknown
+int mrl_cmd_exec(const mrl_cmd_table_t *t, int argc, const char *const *argv);
+
+// Split line in place at spaces and tabs and run it; 0 for an empty
+// line or a '#' comment
+int mrl_cmd_exec_line(const mrl_cmd_table_t *t, char *line);
+
+// microRL callbacks for a table attached to mrl (mrl->userdata_ptr)
+void mrl_cmd_attach(mrl_cmd_table_t *t, microrl_t *mrl);
+int mrl_cmd_microrl_exec(microrl_t *mrl, int argc, const char *const *argv);
+
+// The help lines of all commands that have one
+void mrl_cmd_help(const mrl_cmd_table_t *t);
+
+// Run a script until its end or the first failing command. Returns the
+// number of commands run, or -(line number) of the line that failed.
+int mrl_cmd_run(const mrl_cmd_table_t *t, mrl_cmd_reader_fn next_line, void *ctx);
+
+// Script of len bytes at text (it also ends at a NUL byte)
+int mrl_cmd_run_text(const mrl_cmd_table_t *t, const char *text, size_t len);
+
+#endif // MICRORL_CMD_H
@@ -22,8 +22,8 @@ extern "C" {
 /* Disable colored prompts (ANSI codes) */
 #define MICRORL_CFG_USE_PROMPT_COLOR          0
 
-/* Disable tab completion (not needed for hexedit) */
-#define MICRORL_CFG_USE_COMPLETE              0
+/* Tab completion of command names (microrl_cmd.c) */
+#define MICRORL_CFG_USE_COMPLETE              1
 
 /* Disable quoting (not needed) */
 #define MICRORL_CFG_USE_QUOTING               0
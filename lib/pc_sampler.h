@@ -0,0 +1,82 @@
+//===============================================================================
+// PC Sampler (Kconfig PC_SAMPLER) at 0x800001F0
+// Statistical profiling with hdl/pc_sampler.v and tools/pcprof
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// Every INTERVAL cycles the sampler stores the address of the next
+// instruction fetch in a block-RAM FIFO. No code runs per sample, so
+// interrupt handlers and code with interrupts off show up as well:
+//
+//   if (pc_sampler_present()) {
+//       pc_sampler_start(9973, 0);          // Prime: no loop aliasing
+//       ... code under test ...
+//       pc_sampler_stop();
+//       while (pc_sampler_count())
+//           printf("PCS %08lx\r\n", (unsigned long)pc_sampler_pop());
+//   }
+//
+// Capture the UART output to a file and run
+//   tools/pcprof/pcprof firmware/<name>.elf capture.log
+// for the per-function histogram; lines other than "PCS <hex>" are ignored.
+//
+// Without PC_SAMPLER in the bitstream every register reads 0.
+//
+//===============================================================================
+
+#ifndef PC_SAMPLER_H
+#define PC_SAMPLER_H
+
+#include <stdint.h>
+
+#define PC_SAMPLER_BASE     0x800001F0
+#define PC_SAMPLER_CTRL     (*(volatile uint32_t*)(PC_SAMPLER_BASE + 0x00))
+#define PC_SAMPLER_INTERVAL (*(volatile uint32_t*)(PC_SAMPLER_BASE + 0x04))
+#define PC_SAMPLER_STATUS   (*(volatile uint32_t*)(PC_SAMPLER_BASE + 0x08))  // Read only
+#define PC_SAMPLER_DATA     (*(volatile uint32_t*)(PC_SAMPLER_BASE + 0x0C))  // Read pops
+
+// CTRL bits
+#define PC_SAMPLER_ENABLE   (1 << 0)
+#define PC_SAMPLER_CLEAR    (1 << 1)        // Empty the FIFO, clear LOST (self-clearing)
+#define PC_SAMPLER_RING     (1 << 2)        // Full: keep the newest samples
+
+// STATUS fields
+#define PC_SAMPLER_LEVEL    0xFFFF          // Samples waiting
+#define PC_SAMPLER_FULL     (1 << 16)
+#define PC_SAMPLER_LOST     (1 << 17)       // Samples dropped since the last clear
+#define PC_SAMPLER_PRESENT  (1u << 31)
+
+static inline int pc_sampler_present(void) {
+    return (PC_SAMPLER_STATUS & PC_SAMPLER_PRESENT) != 0;
+}
+
+// FIFO size in samples (0 when not built)
+static inline uint32_t pc_sampler_depth(void) {
+    uint32_t s = PC_SAMPLER_STATUS;
+    return (s & PC_SAMPLER_PRESENT) ? 1u << ((s >> 24) & 0xF) : 0;
+}
+
+// Empty the FIFO and sample every `interval` cycles. flags: PC_SAMPLER_RING
+// to keep the last DEPTH samples, else sampling stops once the FIFO is full.
+static inline void pc_sampler_start(uint32_t interval, uint32_t flags) {
+    PC_SAMPLER_CTRL = PC_SAMPLER_CLEAR;
+    PC_SAMPLER_INTERVAL = interval;
+    PC_SAMPLER_CTRL = PC_SAMPLER_ENABLE | (flags & PC_SAMPLER_RING);
+}
+
+static inline void pc_sampler_stop(void) {
+    PC_SAMPLER_CTRL = PC_SAMPLER_CTRL & PC_SAMPLER_RING;
+}
+
+static inline uint32_t pc_sampler_count(void) {
+    return PC_SAMPLER_STATUS & PC_SAMPLER_LEVEL;
+}
+
+// Oldest sample; check pc_sampler_count() first (reads 0 when empty)
+static inline uint32_t pc_sampler_pop(void) {
+    return PC_SAMPLER_DATA;
+}
+
+#endif // PC_SAMPLER_H
@@ -0,0 +1,104 @@
+//===============================================================================
+// PCPI FPU - single-precision add/subtract/multiply instructions
+// Intrinsics for hdl/pcpi_fpu.v (Kconfig PCPI_FPU)
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// The unit executes custom-1 R-type instructions on PicoRV32's co-processor
+// port. Under the ilp32 soft-float ABI a float already lives in an integer
+// register, so each call is one instruction in place of __addsf3/__subsf3/
+// __mulsf3 (~12 cycles per add, 27 per multiply against 100-300).
+//
+// Rounding is to nearest even, like libgcc; unlike libgcc, denormal inputs
+// and results are flushed to zero, which only shows below 1.2e-38.
+//
+// On a bitstream without the unit the instructions stall the CPU for good
+// (CATCH_ILLINSN is off), so either:
+//   - check pcpi_fpu_present() once and pick a code path, or
+//   - build with -DPCPI_FPU (the firmware Makefile adds it for
+//     CONFIG_PCPI_FPU=y) and use the FPU_ADD/FPU_SUB/FPU_MUL macros, which
+//     fall back to C operators (soft-float) without it.
+//
+// Usage:
+//   if (pcpi_fpu_present())
+//       y = pcpi_fadd(pcpi_fmul(a, x), b);
+//
+//===============================================================================
+
+#ifndef PCPI_FPU_H
+#define PCPI_FPU_H
+
+#include <stdint.h>
+
+// Build options of the running bitstream (perf_monitor.v, 0 on older ones)
+#define PMU_CPU_INFO        (*(volatile uint32_t*)0x800000BC)
+
+#define CPU_INFO_MUL        (1u << 0)
+#define CPU_INFO_FAST_MUL   (1u << 1)
+#define CPU_INFO_DIV        (1u << 2)
+#define CPU_INFO_COMPRESSED (1u << 3)
+#define CPU_INFO_PCPI_FPU   (1u << 4)
+#define CPU_INFO_CATCH_ILLINSN (1u << 5)   // EBREAK/illegal instructions raise IRQ[1]
+
+static inline int pcpi_fpu_present(void) {
+    return (PMU_CPU_INFO & CPU_INFO_PCPI_FPU) != 0;
+}
+
+static inline uint32_t pcpi_fpu_bits(float f) {
+    union { float f; uint32_t u; } v = { .f = f };
+    return v.u;
+}
+
+static inline float pcpi_fpu_float(uint32_t u) {
+    union { uint32_t u; float f; } v = { .u = u };
+    return v.f;
+}
+
+//===============================================================================
+// Instructions: .insn r CUSTOM_1 (0x2B), funct3 = operation, funct7 = 0
+//===============================================================================
+
+#if defined(__riscv)
+
+#define PCPI_FPU_OP(funct3, a, b) ({                                        \
+    uint32_t _r;                                                            \
+    __asm__ (".insn r 0x2B, " #funct3 ", 0, %0, %1, %2"                     \
+             : "=r"(_r) : "r"(pcpi_fpu_bits(a)), "r"(pcpi_fpu_bits(b)));    \
+    pcpi_fpu_float(_r); })
+
+static inline float pcpi_fadd(float a, float b) { return PCPI_FPU_OP(0, a, b); }
+static inline float pcpi_fsub(float a, float b) { return PCPI_FPU_OP(1, a, b); }
+static inline float pcpi_fmul(float a, float b) { return PCPI_FPU_OP(2, a, b); }
+
+#else
+
+// Host builds (tests): the same results apart from denormals
+static inline float pcpi_fadd(float a, float b) { return a + b; }
+static inline float pcpi_fsub(float a, float b) { return a - b; }
+static inline float pcpi_fmul(float a, float b) { return a * b; }
+
+#endif
+
+// a < b for a, b >= 0 (or +inf / NaN): IEEE bit patterns of non-negative
+// floats order like integers, so no __ltsf2 call
+static inline int pcpi_fless_pos(float a, float b) {
+    return pcpi_fpu_bits(a) < pcpi_fpu_bits(b);
+}
+
+//===============================================================================
+// Compile-time selection
+//===============================================================================
+
+#ifdef PCPI_FPU
+#define FPU_ADD(a, b)   pcpi_fadd((a), (b))
+#define FPU_SUB(a, b)   pcpi_fsub((a), (b))
+#define FPU_MUL(a, b)   pcpi_fmul((a), (b))
+#else
+#define FPU_ADD(a, b)   ((float)(a) + (float)(b))
+#define FPU_SUB(a, b)   ((float)(a) - (float)(b))
+#define FPU_MUL(a, b)   ((float)(a) * (float)(b))
+#endif
+
+#endif // PCPI_FPU_H
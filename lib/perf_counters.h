@@ -0,0 +1,113 @@
+//===============================================================================
+// PicoRV32 Cycle / Instret Counters
+// Cycle-accurate timing with the RV32I rdcycle/rdinstret instructions
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// Requires CONFIG_ENABLE_COUNTERS (and CONFIG_ENABLE_COUNTERS64 for the *h /
+// 64-bit helpers) in the bitstream. The counters run at the CPU clock, so
+// at 50 MHz the 32-bit cycle counter wraps every ~85 seconds; unsigned
+// subtraction of two samples is still correct across a single wrap.
+//
+// Usage:
+//   perf_sample_t start, end;
+//   perf_sample(&start);
+//   ... code under test ...
+//   perf_sample(&end);
+//   uint32_t cycles  = end.cycles  - start.cycles;
+//   uint32_t instret = end.instret - start.instret;
+//   uint32_t cpi_x100 = perf_cpi_x100(cycles, instret);
+//
+//===============================================================================
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <stdint.h>
+
+#ifdef SYS_CLK_HZ
+#define PERF_CPU_HZ         ((unsigned long)SYS_CLK_HZ)     // Kconfig system clock
+#else
+#define PERF_CPU_HZ         50000000UL      // Matches the 50 MHz system clock
+#endif
+
+typedef struct {
+    uint32_t cycles;
+    uint32_t instret;
+} perf_sample_t;
+
+//===============================================================================
+// Raw Counter Reads
+//
+// Encoded as CSRRS rd, <csr>, x0 with .insn: newer binutils only accept the
+// rdcycle/csrr mnemonics with _zicsr in -march, older GCC rejects _zicsr.
+//===============================================================================
+
+static inline uint32_t rdcycle(void) {
+    uint32_t v;
+    __asm__ volatile (".insn i 0x73, 2, %0, x0, -1024" : "=r"(v));  // rdcycle
+    return v;
+}
+
+static inline uint32_t rdinstret(void) {
+    uint32_t v;
+    __asm__ volatile (".insn i 0x73, 2, %0, x0, -1022" : "=r"(v));  // rdinstret
+    return v;
+}
+
+static inline uint32_t rdcycleh(void) {
+    uint32_t v;
+    __asm__ volatile (".insn i 0x73, 2, %0, x0, -896" : "=r"(v));  // rdcycleh
+    return v;
+}
+
+static inline uint32_t rdinstreth(void) {
+    uint32_t v;
+    __asm__ volatile (".insn i 0x73, 2, %0, x0, -894" : "=r"(v));  // rdinstreth
+    return v;
+}
+
+// 64-bit reads: re-read if the low word wrapped between the two halves
+static inline uint64_t rdcycle64(void) {
+    uint32_t hi, lo, hi2;
+    do {
+        hi  = rdcycleh();
+        lo  = rdcycle();
+        hi2 = rdcycleh();
+    } while (hi != hi2);
+    return ((uint64_t)hi << 32) | lo;
+}
+
+static inline uint64_t rdinstret64(void) {
+    uint32_t hi, lo, hi2;
+    do {
+        hi  = rdinstreth();
+        lo  = rdinstret();
+        hi2 = rdinstreth();
+    } while (hi != hi2);
+    return ((uint64_t)hi << 32) | lo;
+}
+
+//===============================================================================
+// Helpers
+//===============================================================================
+
+static inline void perf_sample(perf_sample_t *s) {
+    s->cycles  = rdcycle();
+    s->instret = rdinstret();
+}
+
+// Cycles per instruction x100 (e.g. 412 = 4.12 CPI), 0 if nothing retired
+static inline uint32_t perf_cpi_x100(uint32_t cycles, uint32_t instret) {
+    if (instret == 0) return 0;
+    return (uint32_t)(((uint64_t)cycles * 100) / instret);
+}
+
+// Elapsed microseconds for a cycle count
+static inline uint32_t perf_cycles_to_us(uint32_t cycles) {
+    return cycles / (PERF_CPU_HZ / 1000000UL);
+}
+
+#endif // PERF_COUNTERS_H
@@ -0,0 +1,119 @@
+//===============================================================================
+// Profile Dump - gcov Counters of a -fprofile-generate Build
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <gcov.h>
+#include "pgo.h"
+
+#define PGO_LINE_BYTES  32
+
+// Linker script: the gcov_info pointer of every instrumented object
+extern const struct gcov_info *const __gcov_info_start[];
+extern const struct gcov_info *const __gcov_info_end[];
+
+typedef struct {
+    pgo_write_fn write;
+    void *arg;
+    unsigned col;                       // Bytes on the current hex line
+    char line[4 + 2 * PGO_LINE_BYTES + 2];
+} pgo_sink_t;
+
+static void pgo_text(pgo_sink_t *sink, const char *text) {
+    sink->write(text, (unsigned)strlen(text), sink->arg);
+}
+
+static void pgo_end_line(pgo_sink_t *sink) {
+    if (sink->col != 0) {
+        memcpy(&sink->line[4 + 2 * sink->col], "\r\n", 2);
+        sink->write(sink->line, 4 + 2 * sink->col + 2, sink->arg);
+        sink->col = 0;
+    }
+}
+
+// gcda bytes of the current object
+static void pgo_data(const void *data, unsigned len, void *arg) {
+    static const char digits[] = "0123456789abcdef";
+    pgo_sink_t *sink = arg;
+    const uint8_t *p = data;
+
+    for (unsigned i = 0; i < len; i++) {
+        char *hex = &sink->line[4 + 2 * sink->col];
+        hex[0] = digits[p[i] >> 4];
+        hex[1] = digits[p[i] & 15];
+        if (++sink->col == PGO_LINE_BYTES) {
+            pgo_end_line(sink);
+        }
+    }
+}
+
+// Called once per object, ahead of its data
+static void pgo_filename(const char *name, void *arg) {
+    pgo_sink_t *sink = arg;
+
+    pgo_end_line(sink);
+    pgo_text(sink, "PGO file ");
+    pgo_text(sink, name ? name : "-");
+    pgo_text(sink, "\r\n");
+}
+
+// Scratch for the top-N value counters (a few bytes per counter, per dump)
+static void *pgo_allocate(unsigned len, void *arg) {
+    (void)arg;
+    return malloc(len);
+}
+
+int pgo_objects(void) {
+    const struct gcov_info *const *info = __gcov_info_start;
+
+    // Both symbols are at the same place in an uninstrumented image: keep
+    // the compiler from assuming two distinct arrays
+    __asm__ ("" : "+r"(info));
+    return (int)(__gcov_info_end - info);
+}
+
+int pgo_dump(pgo_write_fn write, void *arg) {
+    const struct gcov_info *const *info = __gcov_info_start;
+    pgo_sink_t sink;
+    char begin[32];
+    int n = pgo_objects();
+
+    sink.write = write;
+    sink.arg = arg;
+    sink.col = 0;
+    memcpy(sink.line, "PGO ", 4);
+
+    snprintf(begin, sizeof(begin), "PGO begin objects=%d\r\n", n);
+    pgo_text(&sink, begin);
+    __asm__ ("" : "+r"(info));
+    for (; info != __gcov_info_end; info++) {
+        __gcov_info_to_gcda(*info, pgo_filename, pgo_data, pgo_allocate, &sink);
+        pgo_end_line(&sink);
+    }
+    pgo_text(&sink, "PGO end\r\n");
+    return n ? 0 : -1;
+}
+
+//==============================================================================
+// UART
+//==============================================================================
+
+static void pgo_stdout(const char *text, unsigned len, void *arg) {
+    (void)arg;
+    fwrite(text, 1, len, stdout);
+}
+
+int pgo_dump_uart(void) {
+    int result;
+
+    fputs("\r\n", stdout);
+    result = pgo_dump(pgo_stdout, NULL);
+    fflush(stdout);
+    return result;
+}
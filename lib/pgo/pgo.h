@@ -0,0 +1,49 @@
+//===============================================================================
+// Profile Dump - gcov Counters of a -fprofile-generate Build
+// Arc and value counters of PGO=gen firmware as PGO text lines
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// firmware/Makefile PGO=gen (and the overlay SDK's) builds with
+// -fprofile-generate -fprofile-info-section: every object counts its arcs
+// and values while it runs, and its gcov_info goes into .gcov_info
+// (__gcov_info_start .. __gcov_info_end in the linker scripts) instead of
+// being registered for exit(). Nothing here ever exits or has the files
+// libgcov would write, so the counters leave through pgo_dump(): libgcov's
+// __gcov_info_to_gcda() (GCC 12 and later) turns each object into the
+// bytes of its .gcda file, and pgo_dump() hands them to a sink as text.
+// scripts/pgo.sh writes the .gcda files next to the objects and PGO=use
+// rebuilds with them (make pgo).
+//
+//   ... workload ...
+//   pgo_dump_uart();                // PGO lines on the UART
+//
+// Format, one object after the other (gcda bytes in hex, 32 a line):
+//   PGO begin objects=<n>
+//   PGO file <path of the .gcda file>
+//   PGO <hex>
+//   PGO end
+//
+// The counters keep running: a later dump holds everything since reset.
+//
+//===============================================================================
+
+#ifndef PGO_H
+#define PGO_H
+
+// Sink for the PGO lines: len characters at text, arg as given to pgo_dump()
+typedef void (*pgo_write_fn)(const char *text, unsigned len, void *arg);
+
+// Instrumented objects in the image (0: not a PGO=gen build)
+int pgo_objects(void);
+
+// Write the PGO lines of every instrumented object to write(); -1 if there
+// are none (the begin and end lines are written all the same)
+int pgo_dump(pgo_write_fn write, void *arg);
+
+// pgo_dump() to stdout
+int pgo_dump_uart(void);
+
+#endif // PGO_H
@@ -0,0 +1,186 @@
+//===============================================================================
+// Sampling Profiler - Timer IRQ PC Histogram
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+
+#include "profiler.h"
+#include "../timer.h"
+
+// Linker script symbols (scripts/gen_linker.sh)
+extern char __text_start[], __text_end[];
+extern char __fastcode_start[], __fastcode_end[];
+
+static uint16_t buckets[PROFILER_BUCKETS];
+
+// Written before the timer starts, read by the IRQ handler
+static uint32_t text_base, text_size;
+static uint32_t fast_base, fast_size, fast_first;
+static uint32_t shift;
+static uint32_t rate_hz;
+
+static volatile uint32_t samples;
+static volatile uint32_t other;
+static volatile int running;
+
+// getq rd, q0: return address of the interrupted code. Bit 0 is set when
+// it was a compressed instruction.
+static inline uint32_t irq_return_pc(void) {
+    uint32_t pc;
+    __asm__ volatile (".insn r 0x0B, 4, 0, %0, x0, x0" : "=r"(pc));
+    return pc & ~1u;
+}
+
+static void layout(void) {
+    text_base = (uint32_t)__text_start;
+    text_size = (uint32_t)(__text_end - __text_start);
+    fast_base = (uint32_t)__fastcode_start;
+    fast_size = (uint32_t)(__fastcode_end - __fastcode_start);
+
+    // Smallest bucket that fits both ranges
+    shift = 2;
+    while (((text_size + (1u << shift) - 1) >> shift) +
+           ((fast_size + (1u << shift) - 1) >> shift) > PROFILER_BUCKETS)
+        shift++;
+    fast_first = (text_size + (1u << shift) - 1) >> shift;
+}
+
+void profiler_clear(void) {
+    for (uint32_t i = 0; i < PROFILER_BUCKETS; i++)
+        buckets[i] = 0;
+    samples = 0;
+    other = 0;
+}
+
+int profiler_start(uint32_t hz) {
+    if (hz == 0 || hz > PROFILER_MAX_HZ)
+        return -1;
+
+    profiler_stop();
+    layout();
+    profiler_clear();
+
+    // Channels 1-3 may not be built (TIMER_CHANNELS): they read back 0
+    TIMER_CH_PSC(TIMER_PROFILER_CH) = TIMER_PSC_1MHZ;
+    TIMER_CH_ARR(TIMER_PROFILER_CH) = 1000000 / hz - 1;
+    if (TIMER_CH_PSC(TIMER_PROFILER_CH) != TIMER_PSC_1MHZ)
+        return -1;
+
+    rate_hz = hz;
+    running = 1;
+    TIMER_CH_CNT(TIMER_PROFILER_CH) = 0;
+    TIMER_CH_SR(TIMER_PROFILER_CH) = TIMER_CH_UIF | TIMER_CH_CCIF;
+    TIMER_CH_CR(TIMER_PROFILER_CH) = TIMER_CH_ENABLE;
+    return 0;
+}
+
+void profiler_stop(void) {
+    TIMER_CH_CR(TIMER_PROFILER_CH) = 0;
+    TIMER_CH_SR(TIMER_PROFILER_CH) = TIMER_CH_UIF | TIMER_CH_CCIF;
+    running = 0;
+}
+
+// Runs with interrupts off, from scratchpad like the IRQ entry
+__attribute__((section(".fastcode")))
+void profiler_irq(uint32_t source) {
+    (void)source;
+    if (!(TIMER_CH_SR(TIMER_PROFILER_CH) & TIMER_CH_UIF))
+        return;                     // Another channel on IRQ[7]
+    TIMER_CH_SR(TIMER_PROFILER_CH) = TIMER_CH_UIF;
+
+    uint32_t pc = irq_return_pc();
+    uint32_t i;
+    if (pc - text_base < text_size)
+        i = (pc - text_base) >> shift;
+    else if (pc - fast_base < fast_size)
+        i = fast_first + ((pc - fast_base) >> shift);
+    else {
+        other++;
+        samples++;
+        return;
+    }
+    if (buckets[i] != 0xFFFF)
+        buckets[i]++;
+    samples++;
+}
+
+int profiler_running(void) {
+    return running;
+}
+
+uint32_t profiler_samples(void) {
+    return samples;
+}
+
+uint32_t profiler_other(void) {
+    return other;
+}
+
+uint32_t profiler_bucket_bytes(void) {
+    return 1u << shift;
+}
+
+//===============================================================================
+// Dump
+//===============================================================================
+
+static char *put_hex(char *p, uint32_t v, int digits) {
+    for (int i = digits - 1; i >= 0; i--) {
+        uint32_t d = (v >> (i * 4)) & 0xF;
+        *p++ = (char)(d < 10 ? '0' + d : 'a' + d - 10);
+    }
+    return p;
+}
+
+static char *put_dec(char *p, uint32_t v) {
+    char tmp[10];
+    int n = 0;
+    do {
+        tmp[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    while (n)
+        *p++ = tmp[--n];
+    return p;
+}
+
+static char *put_str(char *p, const char *s) {
+    while (*s)
+        *p++ = *s++;
+    return p;
+}
+
+void profiler_dump(void (*out)(const char *s)) {
+    char line[64];
+    char *p = line;
+
+    p = put_str(p, "PROF begin hz=");
+    p = put_dec(p, rate_hz);
+    p = put_str(p, " shift=");
+    p = put_dec(p, shift);
+    p = put_str(p, " samples=");
+    p = put_dec(p, samples);
+    p = put_str(p, " other=");
+    p = put_dec(p, other);
+    p = put_str(p, "\n");
+    *p = '\0';
+    out(line);
+
+    uint32_t n = fast_first + ((fast_size + (1u << shift) - 1) >> shift);
+    for (uint32_t i = 0; i < n && i < PROFILER_BUCKETS; i++) {
+        if (!buckets[i])
+            continue;
+        uint32_t addr = i < fast_first ? text_base + (i << shift)
+                                       : fast_base + ((i - fast_first) << shift);
+        p = put_str(line, "PROF ");
+        p = put_hex(p, addr, 8);
+        *p++ = ' ';
+        p = put_hex(p, buckets[i], 4);
+        p = put_str(p, "\n");
+        *p = '\0';
+        out(line);
+    }
+
+    out("PROF end\n");
+}
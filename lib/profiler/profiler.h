@@ -0,0 +1,72 @@
+//===============================================================================
+// Sampling Profiler - Timer IRQ PC Histogram
+// Interrupted PC (PicoRV32 q0) per timer tick into a bucket histogram
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// Timer channel TIMER_PROFILER_CH (lib/timer.h) interrupts at the sample
+// rate; the handler reads q0, the return address of the interrupted code,
+// and counts it in a bucket of .text or .fastcode. Code that runs with
+// interrupts off (other ISRs, critical sections) is never sampled: its time
+// shows up on the instruction after it re-enables them. The hardware PC
+// sampler (lib/pc_sampler.h) does not have that blind spot.
+//
+// Firmware with its own irq_handler() calls profiler_irq() for IRQ[7]:
+//
+//   void irq_handler(uint32_t irqs) {
+//       if (irqs & (1 << IRQ_TIMERS)) profiler_irq(IRQ_TIMERS);
+//       ...
+//   }
+//
+// with the start.S table dispatch, irq_register(IRQ_TIMERS, profiler_irq, 15).
+// Then:
+//
+//   profiler_start(1000);           // 1 kHz
+//   ... workload ...
+//   profiler_stop();
+//   profiler_dump(uart_puts);       // PROF lines for scripts/prof_report.sh
+//
+// Dump format, one line per non-empty bucket (addresses and counts in hex):
+//   PROF begin hz=<n> shift=<n> samples=<n> other=<n>
+//   PROF <bucket address> <count>
+//   PROF end
+//
+//===============================================================================
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+
+// Histogram size (16-bit saturating counts). Bucket size is the smallest
+// power of 2 (>= 4 bytes) that fits .text + .fastcode in this many buckets.
+#ifndef PROFILER_BUCKETS
+#define PROFILER_BUCKETS    4096
+#endif
+
+#define PROFILER_MAX_HZ     20000
+
+// Clear the histogram and sample at hz. Returns -1 without the timer channel
+// or for a rate outside 1..PROFILER_MAX_HZ.
+int profiler_start(uint32_t hz);
+
+// Stop the sampling timer; the histogram is kept
+void profiler_stop(void);
+
+// Empty the histogram
+void profiler_clear(void);
+
+// Timer channel IRQ (irq_vector_t signature); clears the channel flag
+void profiler_irq(uint32_t source);
+
+int profiler_running(void);
+uint32_t profiler_samples(void);    // Samples taken since the last clear
+uint32_t profiler_other(void);      // Samples outside .text/.fastcode
+uint32_t profiler_bucket_bytes(void);
+
+// Write the histogram as PROF lines, one string at a time
+void profiler_dump(void (*out)(const char *s));
+
+#endif // PROFILER_H
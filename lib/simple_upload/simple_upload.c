@@ -7,30 +7,139 @@
 //===============================================================================
 
 #include "simple_upload.h"
+#include "../lz4_stream.h"
+#include "../sparse_upload.h"
+#include "../delta_upload.h"
+#include "../crc32.h"
 #include <string.h>
 
 //===============================================================================
-// CRC32 Calculation (matches bootloader and fw_upload.c)
+// Receive Compressed File (after 'Z', streamed with no chunk ACKs)
 //===============================================================================
 
-static uint32_t crc32_table[256];
-static int crc32_initialized = 0;
+static uint32_t get32(simple_callbacks_t *callbacks) {
+    uint32_t v = 0;
 
-static void crc32_init(void) {
-    if (crc32_initialized) return;
+    for (int i = 0; i < 4; i++) {
+        v |= ((uint32_t)callbacks->getc()) << (i * 8);
+    }
+    return v;
+}
 
-    for (uint32_t i = 0; i < 256; i++) {
-        uint32_t crc = i;
-        for (int j = 0; j < 8; j++) {
-            crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320 : 0);
-        }
-        crc32_table[i] = crc;
+static int32_t simple_receive_lz4(simple_callbacks_t *callbacks, uint8_t *buffer, uint32_t max_size) {
+    lz4_stream_t s = { callbacks->getc, 0, 0 };
+    uint32_t length, expected_crc;
+    uint32_t calculated_crc;
+
+    callbacks->putc('A');
+
+    // Compressed size, then image size
+    s.left = get32(callbacks);
+    length = get32(callbacks);
+    if (length == 0 || length > max_size) {
+        callbacks->putc('N');
+        return -SIMPLE_ERROR_SIZE;
+    }
+    callbacks->putc('B');
+
+    // Decoded into place as it arrives; a corrupt block fails the CRC
+    lz4_stream_decode(&s, buffer, length);
+    calculated_crc = crc32_calc(buffer, length);
+
+    if (callbacks->getc() != 'C') {
+        return -SIMPLE_ERROR_CRC;
+    }
+    expected_crc = get32(callbacks);
+
+    callbacks->putc('C');
+    callbacks->putc((calculated_crc >> 0) & 0xFF);
+    callbacks->putc((calculated_crc >> 8) & 0xFF);
+    callbacks->putc((calculated_crc >> 16) & 0xFF);
+    callbacks->putc((calculated_crc >> 24) & 0xFF);
+
+    if (calculated_crc != expected_crc) {
+        return -SIMPLE_ERROR_CRC;
+    }
+    return (int32_t)length;
+}
+
+//===============================================================================
+// Receive Sparse Image (after 'S': ELF segments at their offsets in buffer)
+//===============================================================================
+
+static int32_t simple_receive_sparse(simple_callbacks_t *callbacks, uint8_t *buffer, uint32_t max_size) {
+    uint32_t length, expected_crc;
+    uint32_t calculated_crc;
+    int error;
+
+    callbacks->putc('A');
+
+    length = get32(callbacks);
+    if (length == 0 || length > max_size) {
+        callbacks->putc('N');
+        return -SIMPLE_ERROR_SIZE;
+    }
+    sparse_upload_zero(buffer, length);
+    callbacks->putc('B');
+
+    error = sparse_upload_segments(callbacks->getc, buffer, length);
+    calculated_crc = crc32_calc(buffer, length);
+
+    if (callbacks->getc() != 'C') {
+        return -SIMPLE_ERROR_CRC;
     }
-    crc32_initialized = 1;
+    expected_crc = get32(callbacks);
+
+    callbacks->putc('C');
+    callbacks->putc((calculated_crc >> 0) & 0xFF);
+    callbacks->putc((calculated_crc >> 8) & 0xFF);
+    callbacks->putc((calculated_crc >> 16) & 0xFF);
+    callbacks->putc((calculated_crc >> 24) & 0xFF);
+
+    if (error || calculated_crc != expected_crc) {
+        return -SIMPLE_ERROR_CRC;
+    }
+    return (int32_t)length;
 }
 
-static uint32_t crc32_update(uint32_t crc, uint8_t byte) {
-    return (crc >> 8) ^ crc32_table[(crc ^ byte) & 0xFF];
+//===============================================================================
+// Receive Delta (after 'D': against what buffer already holds)
+//===============================================================================
+
+static int32_t simple_receive_delta(simple_callbacks_t *callbacks, uint8_t *buffer, uint32_t max_size) {
+    uint32_t length, block, expected_crc;
+    uint32_t calculated_crc;
+    int error;
+
+    callbacks->putc('A');
+
+    length = get32(callbacks);
+    block = get32(callbacks);
+    if (length == 0 || length > max_size || !delta_upload_block_ok(block)) {
+        callbacks->putc('N');
+        return -SIMPLE_ERROR_SIZE;
+    }
+    callbacks->putc('B');
+
+    delta_upload_sums(callbacks->putc, buffer, length, block);
+    error = delta_upload_apply(callbacks->getc, callbacks->putc, buffer, length);
+    calculated_crc = crc32_calc(buffer, length);
+
+    if (callbacks->getc() != 'C') {
+        return -SIMPLE_ERROR_CRC;
+    }
+    expected_crc = get32(callbacks);
+
+    callbacks->putc('C');
+    callbacks->putc((calculated_crc >> 0) & 0xFF);
+    callbacks->putc((calculated_crc >> 8) & 0xFF);
+    callbacks->putc((calculated_crc >> 16) & 0xFF);
+    callbacks->putc((calculated_crc >> 24) & 0xFF);
+
+    if (error || calculated_crc != expected_crc) {
+        return -SIMPLE_ERROR_CRC;
+    }
+    return (int32_t)length;
 }
 
 //===============================================================================
@@ -41,18 +150,27 @@ int32_t simple_receive(simple_callbacks_t *callbacks, uint8_t *buffer, uint32_t
     uint32_t packet_size = 0;
     uint32_t bytes_received = 0;
     uint32_t expected_crc;
-    uint32_t calculated_crc = 0xFFFFFFFF;  // CRC32 initial value
+    uint32_t calculated_crc = 0;
     uint8_t ack_char = 'A';
 
-    // Initialize CRC32 lookup table
-    crc32_init();
-
     // Step 1: Wait for 'R' (Ready) command
     while (1) {
         uint8_t cmd = callbacks->getc();
         if (cmd == 'R' || cmd == 'r') {
             break;
         }
+        // Compressed upload (fw_upload_fast -z)
+        if (cmd == LZ4_STREAM_CMD) {
+            return simple_receive_lz4(callbacks, buffer, max_size);
+        }
+        // Sparse upload (fw_upload_fast with an ELF)
+        if (cmd == SPARSE_UPLOAD_CMD) {
+            return simple_receive_sparse(callbacks, buffer, max_size);
+        }
+        // Delta upload (fw_upload_fast -d)
+        if (cmd == DELTA_UPLOAD_CMD) {
+            return simple_receive_delta(callbacks, buffer, max_size);
+        }
         // Check for Ctrl-C cancel
         if (cmd == 0x03) {
             return -SIMPLE_ERROR_CANCEL;
@@ -88,7 +206,7 @@ int32_t simple_receive(simple_callbacks_t *callbacks, uint8_t *buffer, uint32_t
             buffer[bytes_received] = byte;
 
             // Update CRC32 incrementally
-            calculated_crc = crc32_update(calculated_crc, byte);
+            calculated_crc = crc32_update_byte(calculated_crc, byte);
 
             bytes_received++;
             chunk_bytes++;
@@ -100,9 +218,6 @@ int32_t simple_receive(simple_callbacks_t *callbacks, uint8_t *buffer, uint32_t
         if (ack_char > 'Z') ack_char = 'A';  // Wrap around
     }
 
-    // Finalize CRC32
-    calculated_crc = ~calculated_crc;
-
     // Step 6: Wait for 'C' (CRC command)
     uint8_t crc_cmd = callbacks->getc();
     if (crc_cmd != 'C') {
@@ -139,13 +254,10 @@ int32_t simple_receive(simple_callbacks_t *callbacks, uint8_t *buffer, uint32_t
 //===============================================================================
 
 simple_error_t simple_send(simple_callbacks_t *callbacks, const uint8_t *buffer, uint32_t size) {
-    uint32_t calculated_crc = 0xFFFFFFFF;  // CRC32 initial value
+    uint32_t calculated_crc = 0;
     uint8_t expected_ack = 'A';
     uint32_t bytes_sent = 0;
 
-    // Initialize CRC32 lookup table
-    crc32_init();
-
     // Step 1: Send 'R' (Ready) to initiate transfer
     callbacks->putc('R');
 
@@ -179,7 +291,7 @@ simple_error_t simple_send(simple_callbacks_t *callbacks, const uint8_t *buffer,
             callbacks->putc(byte);
 
             // Update CRC32 incrementally
-            calculated_crc = crc32_update(calculated_crc, byte);
+            calculated_crc = crc32_update_byte(calculated_crc, byte);
 
             bytes_sent++;
             chunk_bytes++;
@@ -195,9 +307,6 @@ simple_error_t simple_send(simple_callbacks_t *callbacks, const uint8_t *buffer,
         if (expected_ack > 'Z') expected_ack = 'A';  // Wrap around
     }
 
-    // Finalize CRC32
-    calculated_crc = ~calculated_crc;
-
     // Step 6: Send 'C' (CRC command)
     callbacks->putc('C');
 
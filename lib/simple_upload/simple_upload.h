@@ -43,7 +43,10 @@ typedef enum {
 // API Functions
 //===============================================================================
 
-// Receive file from host
+// Receive file from host: 'R' starts the chunked protocol, 'Z' a compressed
+// stream that is decoded into buffer as it arrives (lib/lz4_stream.h), 'S'
+// the load segments of an ELF at their offsets in buffer (lib/sparse_upload.h),
+// 'D' only the changes against what buffer holds (lib/delta_upload.h)
 // Returns number of bytes received on success, negative error code on failure
 int32_t simple_receive(simple_callbacks_t *callbacks, uint8_t *buffer, uint32_t max_size);
 
@@ -0,0 +1,69 @@
+//===============================================================================
+// Hardware SLIP framer/deframer (Kconfig SLIP_CODEC) at 0x800001C0
+// Frame end raises IRQ[4], shared with the UART RX interrupt
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// With RX enabled the codec takes every byte from the UART core (the
+// console RX FIFO sees nothing), removes the SLIP escapes and keeps whole
+// frames: RX_LEN tells how many bytes are left in the oldest frame, and
+// RX_WORD hands them out four at a time. The frame IRQ is a level, high
+// while RX_LEN is non-zero or more frames are queued, so a handler reads
+// or discards frames until RX_LEN reads 0.
+//
+//   SLIP_CTRL = SLIP_CTRL_RX_EN | SLIP_CTRL_IRQ_EN;
+//
+//   uint32_t len = SLIP_RX_LEN;
+//   if (len & SLIP_RX_VALID) {
+//       len &= SLIP_RX_LEN_MASK;
+//       for (i = 0; i + 4 <= len; i += 4) *(uint32_t *)&buf[i] = SLIP_RX_WORD;
+//       for (; i < len; i++) buf[i] = SLIP_RX_DATA;
+//   }
+//
+//   SLIP_TX_WORD = *(uint32_t *)buf;   // Escaped on the way out
+//   SLIP_TX_BYTE = buf[4];
+//   SLIP_TX_END = 0;                   // END closes the frame
+//
+// TX stores stall until the bytes fit in the UART TX FIFO. Console output
+// written while a frame is being sent ends up inside that frame.
+//
+//===============================================================================
+
+#ifndef SLIP_CODEC_H
+#define SLIP_CODEC_H
+
+#include <stdint.h>
+
+#define SLIP_BASE           0x800001C0
+#define SLIP_CTRL           (*(volatile uint32_t*)(SLIP_BASE + 0x00))
+#define SLIP_STATUS         (*(volatile uint32_t*)(SLIP_BASE + 0x04))
+#define SLIP_RX_LEN         (*(volatile uint32_t*)(SLIP_BASE + 0x08))
+#define SLIP_RX_DATA        (*(volatile uint32_t*)(SLIP_BASE + 0x0C))
+#define SLIP_RX_WORD        (*(volatile uint32_t*)(SLIP_BASE + 0x10))
+#define SLIP_TX_BYTE        (*(volatile uint8_t*)(SLIP_BASE + 0x14))
+#define SLIP_TX_WORD        (*(volatile uint32_t*)(SLIP_BASE + 0x14))
+#define SLIP_TX_END         (*(volatile uint32_t*)(SLIP_BASE + 0x18))
+
+// CTRL bits
+#define SLIP_CTRL_RX_EN     (1 << 0)        // Divert UART RX; clearing flushes
+#define SLIP_CTRL_IRQ_EN    (1 << 1)        // Frame waiting -> IRQ[4]
+#define SLIP_CTRL_PRESENT   (1u << 31)      // Read only
+
+// RX_LEN (write any value: discard the rest of the frame)
+#define SLIP_RX_VALID       (1u << 31)
+#define SLIP_RX_LEN_MASK    0xFFF
+
+// STATUS (write any value: clear the drop counter)
+#define SLIP_STATUS_QUEUED(s)   ((s) & 0xFFFF)      // Frames behind the current one
+#define SLIP_STATUS_DROPPED(s)  ((s) >> 16)         // Buffer or queue full (saturates)
+
+#define IRQ_SLIP            4               // Shares IRQ[4] with the UART RX
+
+static inline int slip_codec_present(void) {
+    // Unmapped MMIO reads return 0
+    return (SLIP_CTRL & SLIP_CTRL_PRESENT) != 0;
+}
+
+#endif // SLIP_CODEC_H
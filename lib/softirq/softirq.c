@@ -0,0 +1,141 @@
+//===============================================================================
+// Deferred Work (Bottom Halves) on the Software Interrupt - Implementation
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+
+#include "softirq.h"
+#include "../irq.h"
+#include "../atomic.h"
+
+// FIFO of queued items; the running item is already off the list
+static softirq_work_t *s_head;
+static softirq_work_t *s_tail;
+static uint32_t s_depth;
+static uint32_t s_mode = SOFTIRQ_MODE_POLL;
+
+static softirq_stats_t s_stats;
+
+// Next item off the queue (NULL if empty), pending cleared so it can be
+// raised again while it runs
+static softirq_work_t *softirq_take(void) {
+    uint32_t old = atomic_irq_save();
+    softirq_work_t *w = s_head;
+
+    if (w) {
+        s_head = w->next;
+        if (!s_head) {
+            s_tail = 0;
+        }
+        w->pending = 0;
+        s_depth--;
+    }
+    atomic_irq_restore(old);
+
+    return w;
+}
+
+static void softirq_isr(uint32_t source) {
+    (void)source;
+    softirq_irq();
+}
+
+void softirq_init(uint32_t mode) {
+    s_mode = mode;
+    if (mode == SOFTIRQ_MODE_IRQ) {
+        // Lowest priority: the dispatcher claims hardware sources first
+        irq_register(IRQ_SOFT, softirq_isr, 0);
+        if (s_head) {
+            SOFT_IRQ_TRIGGER = 1;
+        }
+    } else {
+        irq_register(IRQ_SOFT, 0, 0);
+        if (irqc_present()) {
+            irq_source_disable(IRQ_SOFT);
+        }
+    }
+}
+
+int softirq_raise(softirq_work_t *w) {
+    uint32_t old = atomic_irq_save();
+    int queued = !w->pending;
+
+    if (queued) {
+        w->pending = 1;
+        w->next = 0;
+        if (s_tail) {
+            s_tail->next = w;
+        } else {
+            s_head = w;
+        }
+        s_tail = w;
+        s_stats.raised++;
+        if (++s_depth > s_stats.max_depth) {
+            s_stats.max_depth = s_depth;
+        }
+        // Empty -> not empty: one soft IRQ drains it (it re-raises itself)
+        if (s_mode == SOFTIRQ_MODE_IRQ && s_depth == 1) {
+            SOFT_IRQ_TRIGGER = 1;
+        }
+    } else {
+        s_stats.coalesced++;
+    }
+    atomic_irq_restore(old);
+
+    return queued;
+}
+
+uint32_t softirq_poll(void) {
+    softirq_work_t *w;
+    uint32_t n = 0;
+
+    while ((w = softirq_take()) != 0) {
+        w->fn(w->arg);
+        n++;
+    }
+    s_stats.run += n;
+
+    return n;
+}
+
+void softirq_wait(void) {
+    uint32_t old = atomic_irq_save();
+
+    if (!s_head) {
+        irq_wait();
+    }
+    atomic_irq_restore(old);           // The pending IRQ is taken here
+}
+
+void softirq_irq(void) {
+    softirq_work_t *w;
+
+    for (uint32_t n = 0; n < SOFTIRQ_BUDGET; n++) {
+        w = softirq_take();
+        if (!w) {
+            return;
+        }
+        w->fn(w->arg);
+        s_stats.run++;
+    }
+
+    // Let the dispatcher take waiting hardware IRQs before the rest
+    if (s_head) {
+        SOFT_IRQ_TRIGGER = 1;
+    }
+}
+
+int softirq_pending(void) {
+    return s_head != 0;
+}
+
+void softirq_get_stats(softirq_stats_t *s) {
+    uint32_t old = atomic_irq_save();
+
+    s->raised = s_stats.raised;
+    s->coalesced = s_stats.coalesced;
+    s->run = s_stats.run;
+    s->max_depth = s_stats.max_depth;
+    atomic_irq_restore(old);
+}
@@ -0,0 +1,102 @@
+//===============================================================================
+// Deferred Work (Bottom Halves) on the Software Interrupt
+// Hard ISRs queue work items, the soft IRQ or the main loop runs them
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// A hard ISR does the least that cannot wait (clear the source, move the
+// data out of the FIFO) and hands the rest to a work item:
+//
+//   static void rx_work_fn(void *arg) { parse_lines(); }
+//   static softirq_work_t rx_work = SOFTIRQ_WORK_INIT(rx_work_fn, NULL);
+//
+//   static void on_uart_rx(uint32_t source) {     // lib/irq.h handler
+//       drain_fifo_to_ring();
+//       softirq_raise(&rx_work);
+//   }
+//
+//   softirq_init(SOFTIRQ_MODE_IRQ);
+//
+// An item is queued at most once: raising it again before it ran only
+// counts as coalesced, and its function should handle everything that
+// piled up. Items run in FIFO order; one raised while it runs runs again.
+//
+// SOFTIRQ_MODE_IRQ runs the queue from the software interrupt (IRQ[1],
+// 0x80000040), registered at the lowest controller priority: the start.S
+// dispatcher serves every pending hardware IRQ first. PicoRV32 does not
+// nest interrupts, so a running item still holds off hardware IRQs; after
+// SOFTIRQ_BUDGET items the handler re-raises the soft IRQ and returns, so
+// a hard IRQ waits at most for the item in progress. Split long jobs into
+// steps that re-raise their own item.
+//
+// SOFTIRQ_MODE_POLL leaves the soft IRQ alone; the main loop runs the
+// queue with interrupts enabled, so hard ISRs preempt the work and the
+// items share one context (what lwIP NO_SYS needs):
+//
+//   for (;;) {
+//       softirq_poll();
+//       softirq_wait();                           // waitirq if nothing queued
+//   }
+//
+// No locks: PicoRV32 interrupts do not nest, so ISRs never race each
+// other, and task-level callers mask IRQs around the few instructions of
+// the enqueue (lib/atomic.h masked sections). Firmware with its own irq_handler() calls softirq_irq() for
+// IRQ[1] after its hardware sources.
+//
+//===============================================================================
+
+#ifndef SOFTIRQ_H
+#define SOFTIRQ_H
+
+#include <stdint.h>
+
+#define SOFT_IRQ_TRIGGER    (*(volatile uint32_t*)0x80000040)  // Any write: pulse IRQ[1]
+
+#ifndef SOFTIRQ_BUDGET
+#define SOFTIRQ_BUDGET      4               // Items per soft IRQ entry
+#endif
+
+#define SOFTIRQ_MODE_IRQ    0               // Run from the soft IRQ
+#define SOFTIRQ_MODE_POLL   1               // Run from softirq_poll()
+
+typedef void (*softirq_fn_t)(void *arg);
+
+typedef struct softirq_work {
+    struct softirq_work *next;
+    softirq_fn_t fn;
+    void *arg;
+    volatile uint32_t pending;      // Queued, not yet started
+} softirq_work_t;
+
+#define SOFTIRQ_WORK_INIT(f, a)    { 0, (f), (a), 0 }
+
+typedef struct {
+    uint32_t raised;                // Items queued
+    uint32_t coalesced;             // Raises of an item already queued
+    uint32_t run;                   // Items run
+    uint32_t max_depth;             // Longest queue seen
+} softirq_stats_t;
+
+// Choose where the queue runs (again to switch modes; the queue is kept)
+void softirq_init(uint32_t mode);
+
+// Queue w (from an ISR or a task). Returns 1 if queued, 0 if it already was.
+int softirq_raise(softirq_work_t *w);
+
+// Run everything queued, interrupts as the caller has them. Returns the
+// number of items run.
+uint32_t softirq_poll(void);
+
+// Sleep in waitirq unless work is queued (no lost wakeup: checked with
+// IRQs masked)
+void softirq_wait(void);
+
+// Soft IRQ entry: up to SOFTIRQ_BUDGET items, then re-raise if any are left
+void softirq_irq(void);
+
+int softirq_pending(void);
+void softirq_get_stats(softirq_stats_t *s);
+
+#endif // SOFTIRQ_H
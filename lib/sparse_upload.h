@@ -0,0 +1,81 @@
+//===============================================================================
+// Sparse Image Upload (ELF load segments, zeros made on the target)
+// Only the non-zero parts of an image cross the UART
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// fw_upload_fast takes an ELF and sends its PT_LOAD segments instead of a
+// flat binary: the target zeroes the whole image first, so .bss, alignment
+// gaps and long zero runs inside the data are never sent. Used by
+// bootloader_fast and lib/simple_upload:
+//
+//   PC: 'S'                                   -> 'A'
+//   PC: image size (4)                        -> 'B' ('N' if too large);
+//                                                the image is zeroed first
+//   PC: segment: offset (4), length (4), data   (repeated)
+//   PC: offset 0, length 0
+//   PC: 'C' + CRC32 of the image (4)          -> 'C' + CRC32 of the image
+//
+// The CRC covers the whole image, zeros included, as a flat upload of it
+// would. A segment outside the image is read and dropped, so the 'C' stays
+// in step and the CRC reports it. No libc calls: fits the -nostdlib
+// bootloaders.
+//
+//===============================================================================
+
+#ifndef SPARSE_UPLOAD_H
+#define SPARSE_UPLOAD_H
+
+#include <stdint.h>
+
+#define SPARSE_UPLOAD_CMD   'S'     // Opens a sparse upload instead of 'R'
+
+static inline uint32_t sparse_upload_get32(uint8_t (*getc)(void)) {
+    uint32_t v = 0;
+
+    for (int i = 0; i < 4; i++) {
+        v |= ((uint32_t)getc()) << (i * 8);
+    }
+    return v;
+}
+
+// Zero size bytes at dst (before 'B': the host waits for it)
+static inline void sparse_upload_zero(uint8_t *dst, uint32_t size) {
+    uint32_t i = 0;
+
+    for (; i < (size & ~3u); i += 4) {
+        *(volatile uint32_t *)(dst + i) = 0;
+    }
+    for (; i < size; i++) {
+        dst[i] = 0;
+    }
+}
+
+// Read segments into an image of size bytes at dst up to the terminator.
+// Returns 0, or -1 if a segment fell outside the image (its data dropped).
+static inline int sparse_upload_segments(uint8_t (*getc)(void), uint8_t *dst, uint32_t size) {
+    int error = 0;
+
+    for (;;) {
+        uint32_t offset = sparse_upload_get32(getc);
+        uint32_t length = sparse_upload_get32(getc);
+
+        if (length == 0) {
+            return error;
+        }
+        if (offset > size || length > size - offset) {
+            error = -1;
+            while (length--) {
+                getc();
+            }
+            continue;
+        }
+        for (uint8_t *p = dst + offset; length; length--) {
+            *p++ = getc();
+        }
+    }
+}
+
+#endif // SPARSE_UPLOAD_H
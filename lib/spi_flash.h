@@ -0,0 +1,165 @@
+//===============================================================================
+// Configuration SPI flash (Kconfig FLASH_XIP): read window at 0x01000000,
+// register mode at 0x80000220
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// hdl/spi_flash_xip.v maps the whole flash at SPI_FLASH_XIP_BASE: byte N of
+// the flash reads at SPI_FLASH_XIP_BASE + N, instruction fetches included.
+// The bitstream sits at offset 0; firmware data starts at
+// SPI_FLASH_DATA_OFFSET, which is where the linker script's .xip section
+// (XIP_CODE / XIP_RODATA) is placed and what the SD card manager programs.
+//
+//   static const char big_table[] XIP_RODATA = { ... };
+//   XIP_CODE void rarely_used(void) { ... }
+//
+// Erase and program go through register mode, in which reads of the window
+// return 0: anything between spi_flash_begin() and spi_flash_end() must run
+// from SRAM (as the inline functions here do) and not touch .xip.
+//
+//   spi_flash_begin();
+//   spi_flash_erase_sector(off);                   // 4 KB, erases to 0xFF
+//   spi_flash_program(off, buf, len);              // Within erased space
+//   spi_flash_end();
+//
+// Without the controller in the bitstream every register reads 0.
+//
+//===============================================================================
+
+#ifndef SPI_FLASH_H
+#define SPI_FLASH_H
+
+#include <stdint.h>
+
+#define SPI_FLASH_XIP_BASE      0x01000000
+#define SPI_FLASH_DATA_OFFSET   0x00100000      // Below: bitstream (and room for a second)
+
+#define SPI_FLASH_SECTOR_SIZE   4096
+#define SPI_FLASH_PAGE_SIZE     256
+
+#define SPI_FLASH_BASE          0x80000220
+#define SPI_FLASH_CTRL          (*(volatile uint32_t*)(SPI_FLASH_BASE + 0x00))
+#define SPI_FLASH_DATA          (*(volatile uint32_t*)(SPI_FLASH_BASE + 0x04))
+#define SPI_FLASH_STATUS        (*(volatile uint32_t*)(SPI_FLASH_BASE + 0x08))  // Read only
+
+// CTRL bits
+#define SPI_FLASH_MANUAL        (1 << 0)        // Register mode: window reads return 0
+#define SPI_FLASH_CS            (1 << 1)        // Assert chip select (register mode)
+#define SPI_FLASH_DUAL          (1u << 30)      // Read only: 0x3B dual-output reads
+#define SPI_FLASH_PRESENT       (1u << 31)      // Read only
+
+// STATUS bits
+#define SPI_FLASH_BUSY          (1 << 0)        // Byte transfer running
+
+// Flash commands (W25Q / AT25 / MX25 common set)
+#define SPI_FLASH_CMD_WREN      0x06
+#define SPI_FLASH_CMD_RDSR      0x05
+#define SPI_FLASH_CMD_PP        0x02            // Page program
+#define SPI_FLASH_CMD_SE        0x20            // 4 KB sector erase
+#define SPI_FLASH_CMD_RDID      0x9F            // JEDEC ID
+#define SPI_FLASH_CMD_WAKE      0xAB            // Release from power-down
+
+#define SPI_FLASH_SR_WIP        (1 << 0)        // Erase / program in progress
+
+// Place code or constant data in the flash (.xip, Kconfig FLASH_XIP)
+#define XIP_CODE    __attribute__((section(".xip.text"), noinline))
+#define XIP_RODATA  __attribute__((section(".xip.rodata")))
+
+static inline int spi_flash_present(void) {
+    // Unmapped MMIO reads return 0
+    return (SPI_FLASH_CTRL & SPI_FLASH_PRESENT) != 0;
+}
+
+// Flash offset to the address it reads at
+static inline const volatile void *spi_flash_xip_addr(uint32_t offset) {
+    return (const volatile void *)(SPI_FLASH_XIP_BASE + offset);
+}
+
+static inline void spi_flash_begin(void) {
+    SPI_FLASH_CTRL = SPI_FLASH_MANUAL;
+}
+
+static inline void spi_flash_end(void) {
+    SPI_FLASH_CTRL = SPI_FLASH_MANUAL;  // Chip select off first
+    SPI_FLASH_CTRL = 0;
+}
+
+static inline void spi_flash_select(int on) {
+    SPI_FLASH_CTRL = SPI_FLASH_MANUAL | (on ? SPI_FLASH_CS : 0);
+}
+
+// One byte out on DI, the byte clocked in on DO back
+static inline uint8_t spi_flash_xfer(uint8_t out) {
+    SPI_FLASH_DATA = out;
+    while (SPI_FLASH_STATUS & SPI_FLASH_BUSY);
+    return (uint8_t)SPI_FLASH_DATA;
+}
+
+static inline void spi_flash_cmd_addr(uint8_t cmd, uint32_t offset) {
+    spi_flash_xfer(cmd);
+    spi_flash_xfer((uint8_t)(offset >> 16));
+    spi_flash_xfer((uint8_t)(offset >> 8));
+    spi_flash_xfer((uint8_t)offset);
+}
+
+static inline void spi_flash_cmd(uint8_t cmd) {
+    spi_flash_select(1);
+    spi_flash_xfer(cmd);
+    spi_flash_select(0);
+}
+
+// Manufacturer, memory type, capacity (0xEF4015: W25Q16, 2 MB)
+static inline uint32_t spi_flash_jedec_id(void) {
+    uint32_t id;
+
+    spi_flash_select(1);
+    spi_flash_xfer(SPI_FLASH_CMD_RDID);
+    id = (uint32_t)spi_flash_xfer(0xFF) << 16;
+    id |= (uint32_t)spi_flash_xfer(0xFF) << 8;
+    id |= spi_flash_xfer(0xFF);
+    spi_flash_select(0);
+    return id;
+}
+
+static inline void spi_flash_wait(void) {
+    spi_flash_select(1);
+    spi_flash_xfer(SPI_FLASH_CMD_RDSR);
+    while (spi_flash_xfer(0xFF) & SPI_FLASH_SR_WIP);
+    spi_flash_select(0);
+}
+
+// Erase the 4 KB sector at offset (rounded down); ~50 ms
+static inline void spi_flash_erase_sector(uint32_t offset) {
+    spi_flash_cmd(SPI_FLASH_CMD_WREN);
+    spi_flash_select(1);
+    spi_flash_cmd_addr(SPI_FLASH_CMD_SE, offset & ~(SPI_FLASH_SECTOR_SIZE - 1));
+    spi_flash_select(0);
+    spi_flash_wait();
+}
+
+// Program erased flash, one page command per 256-byte page touched
+static inline void spi_flash_program(uint32_t offset, const void *data, uint32_t len) {
+    const uint8_t *p = data;
+
+    while (len) {
+        uint32_t n = SPI_FLASH_PAGE_SIZE - (offset & (SPI_FLASH_PAGE_SIZE - 1));
+        if (n > len) n = len;
+
+        spi_flash_cmd(SPI_FLASH_CMD_WREN);
+        spi_flash_select(1);
+        spi_flash_cmd_addr(SPI_FLASH_CMD_PP, offset);
+        for (uint32_t i = 0; i < n; i++) {
+            spi_flash_xfer(p[i]);
+        }
+        spi_flash_select(0);
+        spi_flash_wait();
+
+        offset += n;
+        p += n;
+        len -= n;
+    }
+}
+
+#endif // SPI_FLASH_H
@@ -0,0 +1,168 @@
+//===============================================================================
+// SPI master instances: SPI0 (SD card) and the second bus
+// SPI0 at 0x80000050 / 0x800000C0 / 0x800000D0 / 0x800000E0, SPI1 at 0x80000280-0x800002BF
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// Both are spi_master.v + spi_dma.v: byte registers, burst FIFOs, a DMA
+// engine and the CRC accumulators, bits as in sd_fatfs/hardware.h. SPI0
+// carries the SD card; SPI1 (Kconfig SPI1_MASTER) has pins of its own, so
+// a sensor or ADC streams by DMA while an SD transfer is in flight. The
+// two DMA engines take turns at the SRAM port word by word.
+//
+// SPI0's interrupts are IRQ[2]; SPI1's drive CPU IRQ[10] directly, for
+// firmware with its own irq_handler().
+//
+// Stream mode (Kconfig SPI1_STREAM): a timer channel's update events run
+// one SPI1 frame each (CS low, 1-4 bytes, CS high) and the DMA engine
+// writes every frame as one word into an SRAM ring. HALF / FULL flag each
+// completed half; the consumer invalidates and copies that half, e.g.
+// into firmware/sd_fatfs/log_writer, with no CPU work per sample. With
+// CONFIG_DCACHE invalidate the whole ring before start as well, or dirty
+// lines written back later overwrite captured samples:
+//   static uint32_t ring[1024] __attribute__((aligned(4)));
+//   dcache_invalidate_range((uint32_t)ring, sizeof(ring));
+//   TIMER_CH_PSC(2) = TIMER_PSC_1MHZ;  TIMER_CH_ARR(2) = 99;   // 10 kHz
+//   spi_port_stream_start(SPI1_FIFO, SPI1_DMA, ring, sizeof(ring), 2, 2, 0);
+//   TIMER_CH_CR(2) = TIMER_CH_ENABLE;
+//   flags = spi_port_stream_take(SPI1_DMA);   // SPI_PORT_ST_HALF: ring[0..511]
+//
+// Usage:
+//   if (spi1_present()) {
+//       SPI_PORT_CTRL(SPI1_REGS) = SPI_PORT_CLK_DIV(3);   // 6.25 MHz
+//       SPI_PORT_CS(SPI1_REGS) = 0;
+//       rx = spi_port_xfer(SPI1_REGS, tx);
+//       SPI_PORT_CS(SPI1_REGS) = 1;
+//   }
+//
+//===============================================================================
+
+#ifndef SPI_PORT_H
+#define SPI_PORT_H
+
+#include <stdint.h>
+
+#define SPI0_REGS               0x80000050
+#define SPI0_FIFO               0x800000C0
+#define SPI0_DMA                0x800000D0
+#define SPI0_CRC                0x800000E0
+#define SPI1_REGS               0x80000280
+#define SPI1_FIFO               0x80000290
+#define SPI1_DMA                0x800002A0
+#define SPI1_CRC                0x800002B0
+
+#define IRQ_SPI1                10              // CPU IRQ, not a controller source
+
+#define SPI_PORT_REG(a)         (*(volatile uint32_t*)(a))
+
+// Byte registers (regs)
+#define SPI_PORT_CTRL(r)        SPI_PORT_REG((r) + 0x00)
+#define SPI_PORT_DATA(r)        SPI_PORT_REG((r) + 0x04)
+#define SPI_PORT_STATUS(r)      SPI_PORT_REG((r) + 0x08)
+#define SPI_PORT_CS(r)          SPI_PORT_REG((r) + 0x0C)  // 0 = selected
+
+// Burst FIFOs (fifo)
+#define SPI_PORT_FIFO_DATA(f)   SPI_PORT_REG((f) + 0x00)
+#define SPI_PORT_FIFO_CTRL(f)   SPI_PORT_REG((f) + 0x04)
+#define SPI_PORT_FIFO_STAT(f)   SPI_PORT_REG((f) + 0x08)
+#define SPI_PORT_RX_REPEAT(f)   SPI_PORT_REG((f) + 0x0C)
+
+// DMA engine (dma)
+#define SPI_PORT_DMA_ADDR(d)    SPI_PORT_REG((d) + 0x00)
+#define SPI_PORT_DMA_LEN(d)     SPI_PORT_REG((d) + 0x04)
+#define SPI_PORT_DMA_CTRL(d)    SPI_PORT_REG((d) + 0x08)
+#define SPI_PORT_DMA_STREAM(d)  SPI_PORT_REG((d) + 0x0C)
+
+// CRC accumulators (crc)
+#define SPI_PORT_CRC_CTRL(c)    SPI_PORT_REG((c) + 0x00)
+#define SPI_PORT_CRC16_RX(c)    SPI_PORT_REG((c) + 0x04)
+#define SPI_PORT_CRC16_TX(c)    SPI_PORT_REG((c) + 0x08)
+#define SPI_PORT_CRC7(c)        SPI_PORT_REG((c) + 0x0C)
+
+#define SPI_PORT_BUSY           (1u << 0)               // STATUS: transfer in progress
+#define SPI_PORT_DONE           (1u << 1)
+#define SPI_PORT_CLK_DIV(n)     ((1u << 5) | (((n) & 0xFF) << 8))  // SCK = clk / (2 * (n + 1))
+#define SPI_PORT_FIFO_CAPTURE   (1u << 0)
+#define SPI_PORT_FIFO_FLUSH     (1u << 1)
+#define SPI_PORT_DMA_START      (1u << 0)               // Write: start, read: busy
+#define SPI_PORT_DMA_TX         (1u << 1)               // SRAM -> SPI
+#define SPI_PORT_DMA_IRQ_EN     (1u << 2)
+#define SPI_PORT_DMA_DONE       (1u << 3)
+
+// Stream mode: DMA_CTRL bits (STOP and the W1C flags only while streaming)
+#define SPI_PORT_DMA_STREAM_EN  (1u << 4)               // With START; read: streaming
+#define SPI_PORT_ST_STOP        (1u << 3)               // After the current frame
+#define SPI_PORT_ST_HALF        (1u << 5)               // First half written
+#define SPI_PORT_ST_FULL        (1u << 6)               // Second half written, wrapped
+#define SPI_PORT_ST_OVERRUN     (1u << 7)               // A half came round again unread
+// DMA_STREAM fields
+#define SPI_PORT_ST_FRAME(n)    (((n) - 1) & 3)         // Bytes per frame, 1-4
+#define SPI_PORT_ST_TIMER(ch)   (((ch) & 3) << 2)       // Trigger: timer channel 1-3
+#define SPI_PORT_ST_PRESENT     (1u << 7)
+#define SPI_PORT_ST_MISSED(s)   ((s) >> 16)             // Triggers lost since start
+
+// Second bus built in (unmapped MMIO reads 0; STATUS sets BUSY or DONE)
+static inline int spi1_present(void) {
+    return SPI_PORT_STATUS(SPI1_REGS) != 0;
+}
+
+// One byte each way (chip select is the caller's)
+static inline uint8_t spi_port_xfer(uint32_t regs, uint8_t tx) {
+    SPI_PORT_DATA(regs) = tx;               // Held off while a transfer runs
+    while (SPI_PORT_STATUS(regs) & SPI_PORT_BUSY);
+    return (uint8_t)SPI_PORT_DATA(regs);
+}
+
+// Start a DMA transfer of len bytes (multiple of 4) between a word-aligned
+// SRAM buffer and the bus's FIFOs: RX clocks out len 0xFF bytes itself, TX
+// wants FIFO_CTRL capture off. The engine bypasses the D-cache, so
+// invalidate (RX) or clean (TX) the range first, as io.c does for SPI0.
+static inline void spi_port_dma_start(uint32_t dma, void *buf, uint32_t len, int tx) {
+    SPI_PORT_DMA_ADDR(dma) = (uint32_t)buf;
+    SPI_PORT_DMA_LEN(dma) = len;
+    SPI_PORT_DMA_CTRL(dma) = SPI_PORT_DMA_START | (tx ? SPI_PORT_DMA_TX : 0);
+}
+
+static inline int spi_port_dma_busy(uint32_t dma) {
+    return (SPI_PORT_DMA_CTRL(dma) & SPI_PORT_DMA_START) != 0;
+}
+
+// Stream mode built into this engine (reads 0 without SPI1 or SPI1_STREAM)
+static inline int spi_port_stream_present(uint32_t dma) {
+    return (SPI_PORT_DMA_STREAM(dma) & SPI_PORT_ST_PRESENT) != 0;
+}
+
+// Sample on every update event of timer channel timer_ch (1-3): frame
+// bytes (1-4, wire order from bits [7:0]) per ring word. len is a multiple
+// of 8; irq pulses IRQ[10] as each half completes. Set the SPI clock and
+// mode first; the engine owns CS until spi_port_stream_stop().
+static inline void spi_port_stream_start(uint32_t fifo, uint32_t dma, void *ring, uint32_t len,
+                                         unsigned frame, unsigned timer_ch, int irq) {
+    SPI_PORT_FIFO_CTRL(fifo) = SPI_PORT_FIFO_FLUSH;
+    SPI_PORT_DMA_STREAM(dma) = SPI_PORT_ST_FRAME(frame) | SPI_PORT_ST_TIMER(timer_ch);
+    SPI_PORT_DMA_ADDR(dma) = (uint32_t)ring;
+    SPI_PORT_DMA_LEN(dma) = len;
+    SPI_PORT_DMA_CTRL(dma) = SPI_PORT_DMA_START | SPI_PORT_DMA_STREAM_EN |
+                             (irq ? SPI_PORT_DMA_IRQ_EN : 0);
+}
+
+// HALF / FULL / OVERRUN since the last call, cleared. A flag means that
+// half of the ring is complete and stays untouched for one half period.
+static inline uint32_t spi_port_stream_take(uint32_t dma) {
+    uint32_t f = SPI_PORT_DMA_CTRL(dma) & (SPI_PORT_ST_HALF | SPI_PORT_ST_FULL | SPI_PORT_ST_OVERRUN);
+    if (f)
+        SPI_PORT_DMA_CTRL(dma) = f;
+    return f;
+}
+
+// Stop after the frame in flight and release CS
+static inline void spi_port_stream_stop(uint32_t dma) {
+    if (SPI_PORT_DMA_CTRL(dma) & SPI_PORT_DMA_STREAM_EN) {
+        SPI_PORT_DMA_CTRL(dma) = SPI_PORT_ST_STOP;
+        while (spi_port_dma_busy(dma));
+    }
+}
+
+#endif // SPI_PORT_H
@@ -1,52 +1,59 @@
 //===============================================================================
 // Minimal RISC-V Syscalls for UART stdio
-// Provides _read(), _write() syscalls for printf/scanf support
+// Provides _read(), _write() syscalls for printf/scanf support, and file
+// descriptors on a filesystem backend (syscalls_fs.h)
 //
 // Copyright (c) October 2025 Michael Wolak
 // Email: mikewolak@gmail.com, mike@epromfoundry.com
 //===============================================================================
 
 #include <errno.h>
+#include <fcntl.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <malloc.h>
+#include <string.h>
+#include <sys/reent.h>
+#include <sys/stat.h>
+#include "irq.h"
+#include "atomic.h"
+#include "mem_stats.h"
+#include "syscalls_fs.h"
+#include "uart_irq.h"
+#include "uart_port.h"
 
 // FreeRTOS support for thread-safe newlib
 #ifdef USE_FREERTOS
 #include <FreeRTOS.h>
-#include <semphr.h>
 #include <task.h>
-#include <sys/reent.h>
-
-static SemaphoreHandle_t uart_mutex = NULL;
-
-// Initialize UART mutex (call this before starting scheduler)
-void syscalls_init_uart_mutex(void) {
-    if (uart_mutex == NULL) {
-        uart_mutex = xSemaphoreCreateMutex();
-    }
-}
 
 //===============================================================================
 // Newlib Reentrant Locking Functions
 // Required for thread-safe malloc, environment variables, etc.
+// A nesting critical section (newlib re-enters the malloc lock from realloc)
+// costs a few instructions; suspending the scheduler costs a kernel call on
+// each side and a pended-tick replay. The locked sections only walk the
+// free list, so the IRQ latency they add stays short.
 //===============================================================================
 
 void __malloc_lock(struct _reent *reent) {
     (void)reent;
-    vTaskSuspendAll();
+    taskENTER_CRITICAL();
 }
 
 void __malloc_unlock(struct _reent *reent) {
     (void)reent;
-    xTaskResumeAll();
+    taskEXIT_CRITICAL();
 }
 
 void __env_lock(struct _reent *reent) {
     (void)reent;
-    vTaskSuspendAll();
+    taskENTER_CRITICAL();
 }
 
 void __env_unlock(struct _reent *reent) {
     (void)reent;
-    xTaskResumeAll();
+    taskEXIT_CRITICAL();
 }
 
 #endif
@@ -62,38 +69,312 @@ void __env_unlock(struct _reent *reent) {
 #define EINVAL 22
 #endif
 
-#define S_IFCHR  0020000  // Character device
-
-struct stat {
-    unsigned short st_mode;
-};
-
 // errno variable - don't define when using full newlib (it provides errno)
 // Only define for minimal bare-metal builds
 #if 0
 int errno;
 #endif
 
+// stdio UART: UART0, or with STDIO_CONSOLE_UART (Kconfig) the console UART
+// when the bitstream has it, so printf stays off the SLIP / upload link.
+// The console's interrupts are not routed through the controller, so
+// waits on it poll a tick at a time instead of sleeping on an IRQ.
+#ifdef STDIO_CONSOLE_UART
+static unsigned int stdio_probed;
+static unsigned int stdio_console;
+
+static unsigned int stdio_on_console(void) {
+    if (!stdio_probed) {
+        stdio_console = uart1_present();
+        stdio_probed = 1;
+    }
+    return stdio_console;
+}
+#define STDIO_BASE      (stdio_on_console() ? UART1_BASE : UART0_BASE)
+#define STDIO_CTRL      (stdio_on_console() ? UART1_CTRL : UART0_CTRL)
+#else
+#define stdio_on_console() 0
+#define STDIO_BASE      UART0_BASE
+#define STDIO_CTRL      UART0_CTRL
+#endif
+
 // UART Register Definitions
-#define UART_TX_DATA   (*(volatile unsigned int*)0x80000000)
-#define UART_TX_STATUS (*(volatile unsigned int*)0x80000004)
-#define UART_RX_DATA   (*(volatile unsigned int*)0x80000008)
-#define UART_RX_STATUS (*(volatile unsigned int*)0x8000000C)
+#define UART_TX_DATA    UART_PORT_TX_DATA(STDIO_BASE)
+#define UART_TX_STATUS  UART_PORT_TX_STATUS(STDIO_BASE)
+#define UART_TX_WORD    UART_PORT_TX_WORD(STDIO_BASE)    // Write: queue all byte lanes
+#define UART_RX_DATA    UART_PORT_RX_DATA(STDIO_BASE)
+#define UART_RX_STATUS  UART_PORT_RX_STATUS(STDIO_BASE)
 
 //===============================================================================
 // Low-level UART functions
 //===============================================================================
 
-static void uart_putc(char c) {
-    // Wait for TX ready
-    while (UART_TX_STATUS & 0x01);
-    UART_TX_DATA = c;
+#define UART_TX_FIFO    (1u << 31)                  // TX FIFO and TX_WORD present
+#define UART_TX_FREE(s) (((s) >> 16) & 0xFFF)       // Free TX FIFO bytes
+
+// Fill the TX FIFO up to its free space, four bytes per word store;
+// returns the number of bytes queued (0 if the FIFO is full)
+static int uart_write_some(const char *ptr, int len) {
+    unsigned int status = UART_TX_STATUS;
+    int room, queued;
+
+    if (!(status & UART_TX_FIFO)) {
+        if (status & 0x01)
+            return 0;
+        UART_TX_DATA = *ptr;    // Older bitstream: one byte at a time
+        return 1;
+    }
+
+    room = UART_TX_FREE(status);
+    if (room > len) room = len;
+    queued = room;
+
+    for (; room && ((unsigned int)ptr & 3); room--) {
+        UART_TX_DATA = *ptr++;
+    }
+    for (; room >= 4; room -= 4, ptr += 4) {
+        UART_TX_WORD = *(const unsigned int *)ptr;
+    }
+    for (; room; room--) {
+        UART_TX_DATA = *ptr++;
+    }
+
+    return queued;
 }
 
-static char uart_getc(void) {
-    // Wait for RX data available (bit is 1 when data available)
+static void uart_write(const char *ptr, int len) {
+    while (len > 0) {
+        int queued = uart_write_some(ptr, len);
+        ptr += queued;
+        len -= queued;
+    }
+}
+
+// Wait for RX data available (bit is 1 when data available)
+static void uart_rx_wait_data(void) {
+#ifdef USE_FREERTOS
+    // Block the task on the UART RX interrupt instead of spinning
+    while (!(UART_RX_STATUS & 0x01)) {
+        if (stdio_on_console())
+            vTaskDelay(1);
+        else
+            xPortUartWait(UART_IRQ_RX_AVAIL, pdMS_TO_TICKS(10));
+    }
+#else
     while (!(UART_RX_STATUS & 0x01));
-    return UART_RX_DATA & 0xFF;
+#endif
+}
+
+// Bytes in the RX FIFO; older bitstreams without the UART IRQ block
+// (level reads 0) only have the status bit
+static unsigned int uart_rx_level(void) {
+    unsigned int level = UART_IRQ_RX_LEVEL(UART_PORT_IRQ_STAT(STDIO_CTRL));
+
+    if (level == 0 && (UART_RX_STATUS & 0x01))
+        level = 1;
+    return level;
+}
+
+// Take what the RX FIFO holds, up to len bytes or the end of a line (CR
+// becomes LF); sets *eol when the last byte ended a line
+static int uart_read_some(char *ptr, int len, int *eol) {
+    int n = 0;
+    unsigned int level;
+
+    *eol = 0;
+    while (n < len && (level = uart_rx_level()) != 0) {
+        for (; level && n < len; level--) {
+            char c = UART_RX_DATA & 0xFF;
+            if (c == '\r')
+                c = '\n';
+            ptr[n++] = c;
+            if (c == '\n') {
+                *eol = 1;
+                return n;
+            }
+        }
+    }
+    return n;
+}
+
+#ifdef USE_FREERTOS
+//===============================================================================
+// printf Log Ring (FreeRTOS)
+// _write() from a task copies into this ring and returns; the Log task
+// drains it into the UART TX FIFO, sleeping on the TX low-watermark IRQ.
+// Writers of any priority never block each other: IRQs are masked only for
+// the handful of instructions that reserve and commit ring space, not for
+// the copy. The scheduler is only involved when the ring was idle (wake the
+// Log task) or is full (the writer sleeps a tick and retries).
+//===============================================================================
+
+#ifndef CONFIG_FREERTOS_LOG_BUFFER
+#define CONFIG_FREERTOS_LOG_BUFFER  2048    // Power of two
+#endif
+
+#define LOG_SIZE            CONFIG_FREERTOS_LOG_BUFFER
+#define LOG_MASK            (LOG_SIZE - 1)
+#define LOG_TASK_PRIORITY   (tskIDLE_PRIORITY + 1)
+
+static char log_ring[LOG_SIZE];
+static volatile unsigned int log_reserve = 0;   // Next byte handed to a writer
+static volatile unsigned int log_commit = 0;    // All bytes before this are copied
+static volatile unsigned int log_tail = 0;      // Next byte to send (Log task only)
+static volatile unsigned int log_writers = 0;   // Copies in progress
+static volatile unsigned int log_idle = 0;      // Log task waiting for data
+static TaskHandle_t log_task = NULL;
+
+static inline unsigned int log_lock(void) {
+    return atomic_irq_save();
+}
+
+static inline void log_unlock(unsigned int old) {
+    atomic_irq_restore(old);
+}
+
+// Ring only from a running task with IRQs on; ISRs, critical sections and
+// code before vTaskStartScheduler() write straight to the UART
+static int log_usable(void) {
+    unsigned int mask;
+
+    if (log_task == NULL || xTaskGetSchedulerState() != taskSCHEDULER_RUNNING)
+        return 0;
+    mask = log_lock();
+    log_unlock(mask);
+    return mask == 0;
+}
+
+static void log_write(const char *ptr, int len) {
+    while (len > 0) {
+        unsigned int mask, start, n, first;
+        int wake = 0;
+
+        // Reserve
+        mask = log_lock();
+        n = LOG_SIZE - (log_reserve - log_tail);
+        if (n > (unsigned int)len) n = len;
+        start = log_reserve;
+        log_reserve = start + n;
+        if (n) log_writers++;
+        log_unlock(mask);
+
+        if (n == 0) {
+            vTaskDelay(1);      // Full: let the Log task catch up
+            continue;
+        }
+
+        // Copy (preemptible; another writer may reserve behind us)
+        first = LOG_SIZE - (start & LOG_MASK);
+        if (first > n) first = n;
+        memcpy(&log_ring[start & LOG_MASK], ptr, first);
+        memcpy(log_ring, ptr + first, n - first);
+        ptr += n;
+        len -= n;
+
+        // Commit once no copy is in flight, so the Log task never sees a hole
+        mask = log_lock();
+        if (--log_writers == 0) {
+            log_commit = log_reserve;
+            if (log_idle) {
+                log_idle = 0;
+                wake = 1;
+            }
+        }
+        log_unlock(mask);
+
+        if (wake) {
+            xTaskNotifyGive(log_task);
+        }
+    }
+}
+
+static void log_drain_task(void *pvParameters) {
+    (void)pvParameters;
+
+    for (;;) {
+        unsigned int mask, tail, avail, sent;
+
+        mask = log_lock();
+        tail = log_tail;
+        avail = log_commit - tail;
+        if (avail == 0) log_idle = 1;
+        log_unlock(mask);
+
+        if (avail == 0) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+
+        // Contiguous run up to the end of the ring
+        if (avail > LOG_SIZE - (tail & LOG_MASK))
+            avail = LOG_SIZE - (tail & LOG_MASK);
+
+        sent = uart_write_some(&log_ring[tail & LOG_MASK], avail);
+        log_tail = tail + sent;
+
+        if (sent < avail) {
+            // FIFO full: sleep until it drains (or a tick on old bitstreams
+            // and on the console UART)
+            if (stdio_on_console())
+                vTaskDelay(1);
+            else
+                xPortUartWait(UART_IRQ_TX_LOW, 1);
+        }
+    }
+}
+
+// Start the Log task (call this before starting the scheduler); until then
+// printf() writes straight to the UART
+void syscalls_init_log(void) {
+    if (log_task == NULL) {
+        xTaskCreate(log_drain_task, "Log", configMINIMAL_STACK_SIZE, NULL,
+                    LOG_TASK_PRIORITY, &log_task);
+    }
+}
+#endif
+
+//===============================================================================
+// Filesystem backend (syscalls_fs.h) and stdin flags
+//===============================================================================
+
+static const syscalls_fs_t *fs_backend;
+static int stdin_flags;                 // O_NONBLOCK from fcntl()
+static syscalls_stdout_fn stdout_hook;  // syscalls_set_stdout()
+static int stdout_uart_too;
+
+void syscalls_set_fs(const syscalls_fs_t *fs) {
+    fs_backend = fs;
+}
+
+void syscalls_set_stdout(syscalls_stdout_fn write, int uart_too) {
+    stdout_uart_too = uart_too;
+    stdout_hook = write;
+}
+
+// Backend handle for fd, or -1 with EBADF
+static int fs_handle(int file) {
+    if (file < SYSCALLS_FD_FIRST || fs_backend == NULL) {
+        errno = EBADF;
+        return -1;
+    }
+    return file - SYSCALLS_FD_FIRST;
+}
+
+//===============================================================================
+// Syscall: _open
+// Used by fopen(); every path goes to the filesystem backend
+//===============================================================================
+
+int _open(const char *path, int flags, int mode) {
+    int handle;
+
+    if (fs_backend == NULL) {
+        errno = ENOSYS;
+        return -1;
+    }
+
+    handle = fs_backend->open(path, flags, mode);
+    return handle < 0 ? -1 : handle + SYSCALLS_FD_FIRST;
 }
 
 //===============================================================================
@@ -104,32 +385,36 @@ static char uart_getc(void) {
 int _write(int file, char *ptr, int len) {
     int written = 0;
 
+    if (file >= SYSCALLS_FD_FIRST) {
+        int handle = fs_handle(file);
+        return handle < 0 ? -1 : fs_backend->write(handle, ptr, len);
+    }
+
     // Only support stdout (fd 1) and stderr (fd 2)
     if (file != 1 && file != 2) {
         errno = EBADF;
         return -1;
     }
 
-#ifdef USE_FREERTOS
-    // Take mutex to protect UART access in multithreaded environment
-    if (uart_mutex != NULL) {
-        xSemaphoreTake(uart_mutex, portMAX_DELAY);
-    }
-#endif
-
-    // Write each character to UART
-    for (int i = 0; i < len; i++) {
-        uart_putc(*ptr++);
-        written++;
+    if (stdout_hook) {
+        stdout_hook(ptr, len);
+        if (!stdout_uart_too) {
+            return len;
+        }
     }
 
 #ifdef USE_FREERTOS
-    // Release mutex
-    if (uart_mutex != NULL) {
-        xSemaphoreGive(uart_mutex);
+    // Copy into the log ring; the Log task sends it
+    if (log_usable()) {
+        log_write(ptr, len);
+        return len;
     }
 #endif
 
+    // Queue the whole buffer; returns once it is in the TX FIFO
+    uart_write(ptr, len);
+    written = len;
+
     return written;
 }
 
@@ -139,37 +424,75 @@ int _write(int file, char *ptr, int len) {
 //===============================================================================
 
 int _read(int file, char *ptr, int len) {
-    int read = 0;
+    int read, eol;
+
+    if (file >= SYSCALLS_FD_FIRST) {
+        int handle = fs_handle(file);
+        return handle < 0 ? -1 : fs_backend->read(handle, ptr, len);
+    }
 
     // Only support stdin (fd 0)
     if (file != 0) {
         errno = EBADF;
         return -1;
     }
+    if (len <= 0) {
+        return 0;
+    }
 
-    // Read characters from UART
-    for (int i = 0; i < len; i++) {
-        char c = uart_getc();
+    // Wait for the first byte, then take everything the RX FIFO already
+    // holds (a pasted line arrives in one call, not one byte per call)
+    if (!(UART_RX_STATUS & 0x01)) {
+        if (stdin_flags & O_NONBLOCK) {
+            errno = EAGAIN;
+            return -1;
+        }
+        uart_rx_wait_data();
+    }
+    read = uart_read_some(ptr, len, &eol);
 
-        // Echo character (optional, comment out if not desired)
-        uart_putc(c);
+    // Echo (optional, comment out if not desired) in one write; through
+    // _write() so it stays behind any prompt still in the log ring
+    _write(1, ptr, eol ? read - 1 : read);
+    if (eol) {
+        _write(1, "\r\n", 2);
+    }
 
-        // Handle newline
-        if (c == '\r') {
-            c = '\n';
-            uart_putc('\n');  // Echo newline
-        }
+    return read;
+}
 
-        *ptr++ = c;
-        read++;
+//===============================================================================
+// fcntl: O_NONBLOCK on stdin, flags of the other descriptors
+//===============================================================================
 
-        // Stop at newline for line-buffered input
-        if (c == '\n') {
-            break;
+int fcntl(int file, int cmd, ...) {
+    va_list ap;
+    int flags;
+
+    switch (cmd) {
+    case F_GETFL:
+        if (file == 0)
+            return O_RDONLY | stdin_flags;
+        if (file == 1 || file == 2)
+            return O_WRONLY;
+        return fs_handle(file) < 0 ? -1 : O_RDWR;
+
+    case F_SETFL:
+        va_start(ap, cmd);
+        flags = va_arg(ap, int);
+        va_end(ap);
+        if (file == 0) {
+            stdin_flags = flags & O_NONBLOCK;
+            return 0;
         }
-    }
+        if (file == 1 || file == 2)
+            return 0;
+        return fs_handle(file) < 0 ? -1 : 0;
 
-    return read;
+    default:
+        errno = EINVAL;
+        return -1;
+    }
 }
 
 //===============================================================================
@@ -177,8 +500,9 @@ int _read(int file, char *ptr, int len) {
 //===============================================================================
 
 int _close(int file) {
-    (void)file;
-    return -1;
+    int handle = fs_handle(file);
+
+    return handle < 0 ? -1 : fs_backend->close(handle);
 }
 
 //===============================================================================
@@ -186,10 +510,12 @@ int _close(int file) {
 //===============================================================================
 
 int _lseek(int file, int offset, int whence) {
-    (void)file;
-    (void)offset;
-    (void)whence;
-    return 0;
+    if (file < SYSCALLS_FD_FIRST) {
+        return 0;   // UART: nothing to seek
+    }
+
+    int handle = fs_handle(file);
+    return handle < 0 ? -1 : fs_backend->lseek(handle, offset, whence);
 }
 
 //===============================================================================
@@ -197,8 +523,21 @@ int _lseek(int file, int offset, int whence) {
 //===============================================================================
 
 int _fstat(int file, struct stat *st) {
-    (void)file;
-    st->st_mode = S_IFCHR;  // Character device
+    memset(st, 0, sizeof(*st));
+
+    if (file < SYSCALLS_FD_FIRST) {
+        st->st_mode = S_IFCHR;  // Character device
+        return 0;
+    }
+
+    int handle = fs_handle(file);
+    int size = handle < 0 ? -1 : fs_backend->size(handle);
+    if (size < 0) {
+        return -1;
+    }
+    st->st_mode = S_IFREG;
+    st->st_size = size;
+    st->st_blksize = 512;       // SD sector
     return 0;
 }
 
@@ -207,8 +546,11 @@ int _fstat(int file, struct stat *st) {
 //===============================================================================
 
 int _isatty(int file) {
-    (void)file;
-    return 1;  // All files are "tty" (UART)
+    if (file < SYSCALLS_FD_FIRST) {
+        return 1;  // UART
+    }
+    errno = ENOTTY;
+    return 0;
 }
 
 //===============================================================================
@@ -220,20 +562,148 @@ extern char __heap_start;  // Defined in linker script
 extern char __heap_end;    // Defined in linker script
 
 static char *heap_ptr = &__heap_start;
+static char *heap_limit = &__heap_end;
+static char *heap_peak = &__heap_start;
+static uint32_t sbrk_fails;
 
 void *_sbrk(int incr) {
     char *prev_heap_ptr = heap_ptr;
 
     // Check if we would exceed heap
-    if (heap_ptr + incr > &__heap_end) {
+    if (heap_ptr + incr > heap_limit) {
+        sbrk_fails++;
         errno = ENOMEM;
         return (void *)-1;
     }
 
     heap_ptr += incr;
+    if (heap_ptr > heap_peak) {
+        heap_peak = heap_ptr;
+    }
     return (void *)prev_heap_ptr;
 }
 
+// Keep malloc() below limit, e.g. to reserve the overlay slot at the top
+// of the heap. Only ever lowers the limit: one at or above the current one
+// (the linker script may end the heap below the slot) is already met.
+// Fails (-1) if the heap already reaches past limit.
+int heap_set_limit(void *limit) {
+    char *p = (char *)limit;
+
+    if (p < heap_ptr) {
+        return -1;
+    }
+
+    if (p < heap_limit) {
+        heap_limit = p;
+    }
+    return 0;
+}
+
+//===============================================================================
+// Memory Statistics (mem_stats.h)
+// Allocator call counters via -Wl,--wrap (firmware/Makefile), stack
+// high-water mark from the start.S paint
+//===============================================================================
+
+extern uint32_t __stack_region[];   // Defined in linker script
+extern uint32_t __stack_top[];      // Defined in linker script
+
+// newlib-nano keeps its free list in a global; full newlib has no such
+// symbol (weak: NULL) and reports the free chunk count in mallinfo()
+struct nano_chunk {
+    long size;
+    struct nano_chunk *next;
+};
+extern struct nano_chunk *__malloc_free_list __attribute__((weak));
+
+static uint32_t malloc_calls, malloc_fails, malloc_bytes;
+static uint32_t free_calls, realloc_calls;
+
+void *__real__malloc_r(struct _reent *r, size_t size);
+void __real__free_r(struct _reent *r, void *ptr);
+void *__real__realloc_r(struct _reent *r, void *ptr, size_t size);
+
+// Counted under the malloc lock: FreeRTOS tasks allocate concurrently
+void *__wrap__malloc_r(struct _reent *r, size_t size) {
+    void *p = __real__malloc_r(r, size);
+
+    __malloc_lock(r);
+    malloc_calls++;
+    malloc_bytes += size;
+    if (!p) {
+        malloc_fails++;
+    }
+    __malloc_unlock(r);
+    return p;
+}
+
+void __wrap__free_r(struct _reent *r, void *ptr) {
+    __real__free_r(r, ptr);
+
+    __malloc_lock(r);
+    free_calls++;
+    __malloc_unlock(r);
+}
+
+void *__wrap__realloc_r(struct _reent *r, void *ptr, size_t size) {
+    __malloc_lock(r);
+    realloc_calls++;
+    __malloc_unlock(r);
+    return __real__realloc_r(r, ptr, size);
+}
+
+uint32_t mem_stack_peak(void) {
+    const uint32_t *p = __stack_region;
+
+    while (p < __stack_top && *p == MEM_STACK_PAINT) {
+        p++;
+    }
+    return (uint32_t)((char *)__stack_top - (char *)p);
+}
+
+void mem_stack_repaint(void) {
+    uint32_t *sp;
+
+    // IRQ frames go below sp: keep them out while the paint runs there
+    uint32_t mask = irq_setmask(~0u);
+    __asm__ volatile ("mv %0, sp" : "=r"(sp));
+    for (uint32_t *p = __stack_region; p < sp - 4; p++) {
+        *p = MEM_STACK_PAINT;
+    }
+    irq_setmask(mask);
+}
+
+void mem_stats_get(mem_stats_t *m) {
+    struct mallinfo mi = mallinfo();
+
+    __malloc_lock(_REENT);
+    m->heap_size = (uint32_t)(heap_limit - &__heap_start);
+    m->heap_brk = (uint32_t)(heap_ptr - &__heap_start);
+    m->heap_peak = (uint32_t)(heap_peak - &__heap_start);
+    m->sbrk_fails = sbrk_fails;
+
+    m->heap_in_use = (uint32_t)mi.uordblks;
+    m->heap_free = (uint32_t)mi.fordblks;
+    m->free_chunks = (uint32_t)mi.ordblks;
+    if (&__malloc_free_list) {
+        m->free_chunks = 0;
+        for (struct nano_chunk *c = __malloc_free_list; c; c = c->next) {
+            m->free_chunks++;
+        }
+    }
+
+    m->malloc_calls = malloc_calls;
+    m->malloc_fails = malloc_fails;
+    m->malloc_bytes = malloc_bytes;
+    m->free_calls = free_calls;
+    m->realloc_calls = realloc_calls;
+    __malloc_unlock(_REENT);
+
+    m->stack_size = (uint32_t)((char *)__stack_top - (char *)__stack_region);
+    m->stack_peak = mem_stack_peak();
+}
+
 //===============================================================================
 // Syscall: _kill
 //===============================================================================
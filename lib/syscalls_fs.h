@@ -0,0 +1,57 @@
+//===============================================================================
+// File Descriptors beyond the UART for lib/syscalls.c
+// open()/fopen() on a filesystem backend (sd_fatfs/fatfs_stdio.c for SD)
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// fd 0-2 are the UART. A backend installed with syscalls_set_fs() gets
+// every _open() and all descriptors from SYSCALLS_FD_FIRST up; the syscalls
+// hand it whole buffers, so fread()/fwrite() cost one backend call per
+// stdio buffer (BUFSIZ) or per large request:
+//
+//   fatfs_stdio_init();                     // syscalls_set_fs(&fatfs_stdio)
+//   f_mount(&fs, "", 1);
+//   FILE *f = fopen("DATA.BIN", "rb");
+//   fread(buf, 1, sizeof(buf), f);
+//
+// Backend calls return -1 with errno set on failure. Without a backend
+// open() fails with ENOSYS.
+//
+// stdin can be made non-blocking: read() and getchar() then return at once
+// with EAGAIN (stdio: EOF and the error flag, clearerr() before the next
+// try) when the RX FIFO is empty:
+//
+//   fcntl(0, F_SETFL, O_NONBLOCK);
+//
+// stdout and stderr can be handed to another sink, such as the network
+// console (lwIP/port/net_console.c), while the UART carries SLIP:
+//
+//   syscalls_set_stdout(net_console_write, 0);  // 1: the UART gets it too
+//
+//===============================================================================
+
+#ifndef SYSCALLS_FS_H
+#define SYSCALLS_FS_H
+
+#define SYSCALLS_FD_FIRST   3       // First backend descriptor
+
+typedef struct {
+    int (*open)(const char *path, int flags, int mode);    // Handle >= 0
+    int (*close)(int handle);
+    int (*read)(int handle, void *buf, int len);            // Bytes, 0 at EOF
+    int (*write)(int handle, const void *buf, int len);
+    int (*lseek)(int handle, int offset, int whence);       // New offset
+    int (*size)(int handle);                                // For fstat()
+} syscalls_fs_t;
+
+// Install (or with NULL remove) the backend behind descriptors >= 3
+void syscalls_set_fs(const syscalls_fs_t *fs);
+
+// Send fd 1 and 2 to write (NULL: back to the UART only). write must not
+// block; it is called from wherever printf() is.
+typedef void (*syscalls_stdout_fn)(const char *ptr, int len);
+void syscalls_set_stdout(syscalls_stdout_fn write, int uart_too);
+
+#endif // SYSCALLS_FS_H
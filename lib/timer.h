@@ -0,0 +1,116 @@
+//===============================================================================
+// Hardware timer channels and the 64-bit timebase
+// Channel 0 at 0x80000020 (IRQ[0]), channels 1-3 at 0x80000160 (IRQ[7]),
+// timebase at 0x80000150
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// Channel use by the platform firmware:
+//   0  System tick (FreeRTOS, lib/coop, lwIP demos, timer_ms.c)
+//   2  Sampling profiler (lib/profiler), while it runs; SPI1 stream
+//      trigger in the SD card manager's capture (lib/spi_port.h)
+//   1  Timer service (lib/hrtimer) in the SD card manager, for the io.c
+//      delays; stopped while no timer is armed, so free to overlays
+//   1+ Free for applications / benchmarks otherwise
+//
+// The overlay watchdog is a peripheral of its own (lib/watchdog.h) and
+// needs no channel; its pre-timeout shares IRQ[7] with channels 1-3.
+//
+// The timebase needs no setup and has no owner: timebase_us() and
+// timebase_ms() count from reset and never stop, so code that only wants
+// time stamps should use it instead of claiming a channel. lib/hrtimer
+// wraps it with deadlines and runs timer callbacks on one channel.
+//
+// Usage:
+//   uint64_t t0 = timebase_us();
+//   ...
+//   uint32_t elapsed = (uint32_t)(timebase_us() - t0);
+//
+//   TIMER_CH_CR(2) = 0;                        // Periodic IRQ on channel 2
+//   TIMER_CH_PSC(2) = TIMER_PSC_1MHZ;
+//   TIMER_CH_ARR(2) = 999;                     // 1 kHz
+//   TIMER_CH_CR(2) = TIMER_CH_ENABLE;
+//
+//===============================================================================
+
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <stdint.h>
+#include "atomic.h"
+
+#ifndef SYS_CLK_HZ
+#define SYS_CLK_HZ          50000000
+#endif
+
+// Prescaler for a 1 MHz counter clock
+#define TIMER_PSC_1MHZ      ((SYS_CLK_HZ + 500000) / 1000000 - 1)
+
+// Channel registers (n = 0..3)
+#define TIMER_CH_BASE(n)    ((n) == 0 ? 0x80000020u : 0x80000140u + (n) * 0x20u)
+#define TIMER_CH_REG(n, o)  (*(volatile uint32_t*)(TIMER_CH_BASE(n) + (o)))
+#define TIMER_CH_CR(n)      TIMER_CH_REG(n, 0x00)
+#define TIMER_CH_SR(n)      TIMER_CH_REG(n, 0x04)
+#define TIMER_CH_PSC(n)     TIMER_CH_REG(n, 0x08)
+#define TIMER_CH_ARR(n)     TIMER_CH_REG(n, 0x0C)
+#define TIMER_CH_CNT(n)     TIMER_CH_REG(n, 0x10)
+#define TIMER_CH_CCR(n)     TIMER_CH_REG(n, 0x14)
+
+// CR bits
+#define TIMER_CH_ENABLE     (1 << 0)
+#define TIMER_CH_ONE_SHOT   (1 << 1)
+#define TIMER_CH_CCIE       (1 << 4)        // IRQ on compare match / capture
+#define TIMER_CH_CAPTURE    (1 << 5)        // CCR latches CNT on a button press
+
+// SR bits (write 1 to clear)
+#define TIMER_CH_UIF        (1 << 0)        // Counter reached 0
+#define TIMER_CH_CCIF       (1 << 1)        // Compare match / capture
+
+#define TIMER_PROFILER_CH   2
+
+// Timebase
+#define TIMEBASE_BASE       0x80000150
+#define TIMEBASE_US_LO      (*(volatile uint32_t*)(TIMEBASE_BASE + 0x00))
+#define TIMEBASE_US_HI      (*(volatile uint32_t*)(TIMEBASE_BASE + 0x04))
+#define TIMEBASE_MS         (*(volatile uint32_t*)(TIMEBASE_BASE + 0x08))
+#define TIMEBASE_INFO       (*(volatile uint32_t*)(TIMEBASE_BASE + 0x0C))
+
+#define TIMEBASE_PRESENT    (1u << 31)
+
+static inline int timebase_present(void) {
+    // Unmapped MMIO reads return 0
+    return (TIMEBASE_INFO & TIMEBASE_PRESENT) != 0;
+}
+
+// Microseconds since reset. Reading US_LO latches US_HI, so this is one
+// consistent sample; an interrupt between the loads (with its own read)
+// can re-latch the high word, hence the short critical section.
+static inline uint64_t timebase_us(void) {
+    uint32_t mask, lo, hi;
+
+    mask = atomic_irq_save();
+    lo = TIMEBASE_US_LO;
+    hi = TIMEBASE_US_HI;
+    atomic_irq_restore(mask);
+
+    return ((uint64_t)hi << 32) | lo;
+}
+
+// Low 32 bits only (wraps after 71 minutes): no critical section needed
+static inline uint32_t timebase_us32(void) {
+    return TIMEBASE_US_LO;
+}
+
+// Milliseconds since reset (wraps after 49.7 days)
+static inline uint32_t timebase_ms(void) {
+    return TIMEBASE_MS;
+}
+
+static inline void timebase_delay_us(uint32_t us) {
+    uint32_t start = TIMEBASE_US_LO;
+    while ((uint32_t)(TIMEBASE_US_LO - start) < us);
+}
+
+#endif // TIMER_H
@@ -0,0 +1,479 @@
+//===============================================================================
+// TLSF - Two-Level Segregated Fit Allocator
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+
+#include "tlsf.h"
+#include <string.h>
+
+//===============================================================================
+// Size Classes
+//===============================================================================
+
+#define ALIGN_LOG2      3
+#define ALIGN_SIZE      (1u << ALIGN_LOG2)
+
+// 16 second-level lists per power of two: at most 1/16 (6%) rounded away
+#define SL_LOG2         4
+#define SL_COUNT        (1u << SL_LOG2)
+
+// Below SMALL_BLOCK one first-level class covers 16 lists of 8 bytes each.
+// FL_MAX bounds the biggest block: 1 MB, twice the SRAM.
+#define FL_SHIFT        (SL_LOG2 + ALIGN_LOG2)
+#define FL_MAX          20
+#define FL_COUNT        (FL_MAX - FL_SHIFT + 1)
+#define SMALL_BLOCK     (1u << FL_SHIFT)
+#define BLOCK_MAX       (1u << FL_MAX)
+
+// Separate (non-contiguous) pools, for tlsf_get_stats()/tlsf_check()
+#define MAX_POOLS       8
+
+//===============================================================================
+// Blocks
+//===============================================================================
+
+typedef struct block {
+    struct block *prev_phys;    // Physical predecessor (NULL: first of a pool)
+    size_t size;                // Payload bytes | BLOCK_FREE
+    // Payload. While the block is free:
+    struct block *next_free;
+    struct block *prev_free;
+} block_t;
+
+#define BLOCK_FREE      1u
+#define HDR             offsetof(block_t, next_free)
+#define BLOCK_MIN       (sizeof(block_t) - HDR)     // Room for the list links
+
+struct tlsf {
+    uint32_t fl_bitmap;
+    uint32_t sl_bitmap[FL_COUNT];
+    block_t *heads[FL_COUNT][SL_COUNT];
+    block_t *last_sentinel;     // End of the pool added last
+    block_t *pools[MAX_POOLS];
+    uint32_t npools;
+};
+
+static inline size_t bsize(const block_t *b) {
+    return b->size & ~(size_t)(ALIGN_SIZE - 1);
+}
+
+static inline int is_free(const block_t *b) {
+    return (b->size & BLOCK_FREE) != 0;
+}
+
+static inline void *payload(block_t *b) {
+    return (char *)b + HDR;
+}
+
+static inline block_t *header(const void *p) {
+    return (block_t *)((char *)p - HDR);
+}
+
+static inline block_t *next_phys(const block_t *b) {
+    return (block_t *)((char *)b + HDR + bsize(b));
+}
+
+static inline size_t align_up(size_t x, size_t a) {
+    return (x + a - 1) & ~(a - 1);
+}
+
+static inline int fls32(uint32_t x) {
+    return x ? 31 - __builtin_clz(x) : -1;
+}
+
+static inline int ffs32(uint32_t x) {
+    return x ? __builtin_ctz(x) : -1;
+}
+
+//===============================================================================
+// Free Lists
+//===============================================================================
+
+static void mapping_insert(size_t size, int *fl, int *sl) {
+    if (size < SMALL_BLOCK) {
+        *fl = 0;
+        *sl = (int)(size >> ALIGN_LOG2);
+    } else {
+        int f = fls32((uint32_t)size);
+        *sl = (int)((size >> (f - SL_LOG2)) ^ SL_COUNT);
+        *fl = f - (FL_SHIFT - 1);
+    }
+}
+
+// Round up to the next list boundary: any block on that list fits
+static void mapping_search(size_t size, int *fl, int *sl) {
+    if (size >= SMALL_BLOCK) {
+        size += (1u << (fls32((uint32_t)size) - SL_LOG2)) - 1;
+    }
+    mapping_insert(size, fl, sl);
+}
+
+static void insert_free(tlsf_t *t, block_t *b) {
+    int fl, sl;
+
+    mapping_insert(bsize(b), &fl, &sl);
+    b->size |= BLOCK_FREE;
+    b->prev_free = NULL;
+    b->next_free = t->heads[fl][sl];
+    if (b->next_free) {
+        b->next_free->prev_free = b;
+    }
+    t->heads[fl][sl] = b;
+    t->fl_bitmap |= 1u << fl;
+    t->sl_bitmap[fl] |= 1u << sl;
+}
+
+static void remove_free(tlsf_t *t, block_t *b) {
+    int fl, sl;
+
+    mapping_insert(bsize(b), &fl, &sl);
+    if (b->next_free) {
+        b->next_free->prev_free = b->prev_free;
+    }
+    if (b->prev_free) {
+        b->prev_free->next_free = b->next_free;
+    } else {
+        t->heads[fl][sl] = b->next_free;
+        if (!b->next_free) {
+            t->sl_bitmap[fl] &= ~(1u << sl);
+            if (!t->sl_bitmap[fl]) {
+                t->fl_bitmap &= ~(1u << fl);
+            }
+        }
+    }
+    b->size &= ~(size_t)BLOCK_FREE;
+}
+
+// First free block of at least size, taken off its list
+static block_t *locate_free(tlsf_t *t, size_t size) {
+    int fl, sl;
+
+    mapping_search(size, &fl, &sl);
+    if (fl >= (int)FL_COUNT) {
+        return NULL;
+    }
+
+    uint32_t sl_map = t->sl_bitmap[fl] & (~0u << sl);
+    if (!sl_map) {
+        uint32_t fl_map = t->fl_bitmap & (~0u << (fl + 1));
+        if (!fl_map) {
+            return NULL;
+        }
+        fl = ffs32(fl_map);
+        sl_map = t->sl_bitmap[fl];
+    }
+    sl = ffs32(sl_map);
+
+    block_t *b = t->heads[fl][sl];
+    remove_free(t, b);
+    return b;
+}
+
+//===============================================================================
+// Split / Merge
+//===============================================================================
+
+// Absorb the physical successor if it is free (b is off the lists)
+static void merge_next(tlsf_t *t, block_t *b) {
+    block_t *n = next_phys(b);
+
+    if (is_free(n)) {
+        remove_free(t, n);
+        b->size += HDR + bsize(n);
+        next_phys(b)->prev_phys = b;
+    }
+}
+
+// Absorb the physical predecessor if it is free; returns the merged block
+static block_t *merge_prev(tlsf_t *t, block_t *b) {
+    block_t *p = b->prev_phys;
+
+    if (p && is_free(p)) {
+        remove_free(t, p);
+        p->size += HDR + bsize(b);
+        next_phys(p)->prev_phys = p;
+        return p;
+    }
+    return b;
+}
+
+// Cut b (in use, off the lists) down to size, freeing the tail if it can
+// hold a block
+static void trim(tlsf_t *t, block_t *b, size_t size) {
+    size_t have = bsize(b);
+
+    if (have < size + HDR + BLOCK_MIN) {
+        return;
+    }
+
+    block_t *rest = (block_t *)((char *)payload(b) + size);
+    rest->prev_phys = b;
+    rest->size = have - size - HDR;
+    b->size = size;
+    next_phys(rest)->prev_phys = rest;
+    merge_next(t, rest);
+    insert_free(t, rest);
+}
+
+// Request size to payload size; 0 if it can never fit
+static size_t adjust(size_t size) {
+    if (size >= BLOCK_MAX) {
+        return 0;
+    }
+    size = align_up(size, ALIGN_SIZE);
+    return size < BLOCK_MIN ? BLOCK_MIN : size;
+}
+
+//===============================================================================
+// Pools
+//===============================================================================
+
+size_t tlsf_size(void) {
+    return align_up(sizeof(tlsf_t), ALIGN_SIZE);
+}
+
+size_t tlsf_pool_overhead(void) {
+    return 2 * HDR;
+}
+
+int tlsf_add_pool(tlsf_t *t, void *mem, size_t bytes) {
+    char *start = (char *)align_up((size_t)mem, ALIGN_SIZE);
+
+    if (bytes < (size_t)(start - (char *)mem) + 2 * HDR + BLOCK_MIN) {
+        return -1;
+    }
+    bytes = (bytes - (size_t)(start - (char *)mem)) & ~(size_t)(ALIGN_SIZE - 1);
+
+    // Right behind the last pool: its sentinel becomes a free block
+    block_t *s = t->last_sentinel;
+    if (s && start == (char *)s + HDR && bsize(s->prev_phys) + bytes < BLOCK_MAX) {
+        block_t *end = (block_t *)(start + bytes - HDR);
+
+        s->size = bytes - HDR;
+        end->prev_phys = s;
+        end->size = 0;
+        t->last_sentinel = end;
+        insert_free(t, merge_prev(t, s));
+        return 0;
+    }
+
+    if (t->npools == MAX_POOLS) {
+        return -1;
+    }
+    if (bytes - 2 * HDR >= BLOCK_MAX) {
+        bytes = BLOCK_MAX - ALIGN_SIZE + 2 * HDR;
+    }
+
+    block_t *b = (block_t *)start;
+    b->prev_phys = NULL;
+    b->size = bytes - 2 * HDR;
+
+    block_t *end = next_phys(b);
+    end->prev_phys = b;
+    end->size = 0;
+
+    t->last_sentinel = end;
+    t->pools[t->npools++] = b;
+    insert_free(t, b);
+    return 0;
+}
+
+tlsf_t *tlsf_create(void *mem, size_t bytes) {
+    tlsf_t *t = (tlsf_t *)align_up((size_t)mem, ALIGN_SIZE);
+    size_t used = (size_t)((char *)t - (char *)mem) + tlsf_size();
+
+    if (bytes < used) {
+        return NULL;
+    }
+
+    memset(t, 0, sizeof(*t));
+    if (tlsf_add_pool(t, (char *)t + tlsf_size(), bytes - used) < 0) {
+        return NULL;
+    }
+    return t;
+}
+
+//===============================================================================
+// Allocation
+//===============================================================================
+
+void *tlsf_malloc(tlsf_t *t, size_t size) {
+    size_t want = adjust(size);
+
+    if (!want) {
+        return NULL;
+    }
+
+    block_t *b = locate_free(t, want);
+    if (!b) {
+        return NULL;
+    }
+    trim(t, b, want);
+    return payload(b);
+}
+
+void *tlsf_memalign(tlsf_t *t, size_t align, size_t size) {
+    if (align <= ALIGN_SIZE) {
+        return tlsf_malloc(t, size);
+    }
+    if (align & (align - 1)) {
+        return NULL;
+    }
+
+    size_t want = adjust(size);
+    if (!want || want + align + HDR + BLOCK_MIN >= BLOCK_MAX) {
+        return NULL;
+    }
+
+    // The worst gap to the alignment still leaves a free block in front
+    block_t *b = locate_free(t, want + align + HDR + BLOCK_MIN);
+    if (!b) {
+        return NULL;
+    }
+
+    size_t p = (size_t)payload(b);
+    size_t gap = align_up(p, align) - p;
+    if (gap && gap < HDR + BLOCK_MIN) {
+        gap = align_up(p + HDR + BLOCK_MIN, align) - p;
+    }
+
+    if (gap) {
+        block_t *a = (block_t *)((char *)b + gap);
+        a->prev_phys = b;
+        a->size = bsize(b) - gap;
+        b->size = gap - HDR;
+        next_phys(a)->prev_phys = a;
+        insert_free(t, b);          // Predecessor was not free: no merge
+        b = a;
+    }
+
+    trim(t, b, want);
+    return payload(b);
+}
+
+void tlsf_free(tlsf_t *t, void *ptr) {
+    if (!ptr) {
+        return;
+    }
+
+    block_t *b = merge_prev(t, header(ptr));
+    merge_next(t, b);
+    insert_free(t, b);
+}
+
+void *tlsf_realloc(tlsf_t *t, void *ptr, size_t size) {
+    if (!ptr) {
+        return tlsf_malloc(t, size);
+    }
+    if (size == 0) {
+        tlsf_free(t, ptr);
+        return NULL;
+    }
+
+    size_t want = adjust(size);
+    if (!want) {
+        return NULL;
+    }
+
+    block_t *b = header(ptr);
+    size_t have = bsize(b);
+
+    // Grow in place into a free successor
+    if (want > have) {
+        block_t *n = next_phys(b);
+        if (is_free(n) && have + HDR + bsize(n) >= want) {
+            merge_next(t, b);
+        }
+    }
+
+    if (bsize(b) >= want) {
+        trim(t, b, want);
+        return ptr;
+    }
+
+    void *p = tlsf_malloc(t, size);
+    if (p) {
+        memcpy(p, ptr, have);
+        tlsf_free(t, ptr);
+    }
+    return p;
+}
+
+size_t tlsf_block_size(const void *ptr) {
+    return bsize(header(ptr));
+}
+
+//===============================================================================
+// Statistics / Consistency
+//===============================================================================
+
+void tlsf_get_stats(tlsf_t *t, tlsf_stats_t *s) {
+    memset(s, 0, sizeof(*s));
+
+    for (uint32_t i = 0; i < t->npools; i++) {
+        for (block_t *b = t->pools[i]; bsize(b); b = next_phys(b)) {
+            if (is_free(b)) {
+                s->free += bsize(b);
+                s->free_blocks++;
+                if (bsize(b) > s->largest_free) {
+                    s->largest_free = bsize(b);
+                }
+            } else {
+                s->used += bsize(b);
+                s->used_blocks++;
+            }
+        }
+    }
+}
+
+int tlsf_check(tlsf_t *t) {
+    int errors = 0;
+    size_t listed = 0, walked = 0;
+
+    for (int fl = 0; fl < (int)FL_COUNT; fl++) {
+        if (!!(t->fl_bitmap & (1u << fl)) != !!t->sl_bitmap[fl]) {
+            errors++;
+        }
+        for (int sl = 0; sl < (int)SL_COUNT; sl++) {
+            block_t *h = t->heads[fl][sl];
+            if (!!(t->sl_bitmap[fl] & (1u << sl)) != !!h) {
+                errors++;
+            }
+            for (block_t *b = h; b; b = b->next_free) {
+                int bfl, bsl;
+                mapping_insert(bsize(b), &bfl, &bsl);
+                if (!is_free(b) || bfl != fl || bsl != sl ||
+                    (b->next_free && b->next_free->prev_free != b)) {
+                    errors++;
+                }
+                listed++;
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < t->npools; i++) {
+        block_t *prev = NULL;
+        for (block_t *b = t->pools[i]; ; b = next_phys(b)) {
+            if (b->prev_phys != prev) {
+                errors++;
+            }
+            if (!bsize(b)) {
+                break;
+            }
+            if (is_free(b)) {
+                walked++;
+                if (prev && is_free(prev)) {
+                    errors++;           // Two free neighbours: missed merge
+                }
+            }
+            prev = b;
+        }
+    }
+
+    if (listed != walked) {
+        errors++;
+    }
+    return errors;
+}
@@ -0,0 +1,78 @@
+//===============================================================================
+// TLSF - Two-Level Segregated Fit Allocator
+// O(1) malloc/free for the firmware and overlay heaps (Kconfig MALLOC_TLSF)
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// Free blocks sit on 16 lists per power of two of their size; two bitmaps
+// say which lists are non-empty. malloc() rounds the request up to the
+// next list boundary, finds the first non-empty list at or above it with
+// two find-first-set operations and splits the block; free() merges with
+// the physical neighbours and pushes the result on its list. Neither walks
+// a list, so the time is bounded whatever the heap looks like; newlib's
+// first-fit walks the whole free list.
+//
+// Every block has an 8-byte header (previous block, size and flags);
+// payloads are 8-byte aligned.
+//
+//   tlsf_t *t = tlsf_create(mem, bytes);    // Control structure + first pool
+//   void *p = tlsf_malloc(t, 100);
+//   tlsf_free(t, p);
+//
+// tlsf_malloc.c puts newlib's _malloc_r family on top of this, growing the
+// heap with _sbrk().
+//
+//===============================================================================
+
+#ifndef TLSF_H
+#define TLSF_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct tlsf tlsf_t;
+
+typedef struct {
+    size_t used;            // Payload bytes in allocated blocks
+    size_t free;            // Payload bytes in free blocks
+    size_t used_blocks;
+    size_t free_blocks;
+    size_t largest_free;    // Biggest single free block
+} tlsf_stats_t;
+
+// Bytes tlsf_create() keeps for the control structure
+size_t tlsf_size(void);
+
+// Header bytes per pool (first block and end sentinel)
+size_t tlsf_pool_overhead(void);
+
+// Control structure at the start of mem, the rest becomes the first pool.
+// NULL if bytes is too small.
+tlsf_t *tlsf_create(void *mem, size_t bytes);
+
+// Add memory. A region starting where the last pool ends extends that pool
+// (consecutive _sbrk() calls); anything else becomes a separate pool.
+// Returns -1 if bytes is too small to hold a block.
+int tlsf_add_pool(tlsf_t *t, void *mem, size_t bytes);
+
+void *tlsf_malloc(tlsf_t *t, size_t size);
+void *tlsf_memalign(tlsf_t *t, size_t align, size_t size);
+void *tlsf_realloc(tlsf_t *t, void *ptr, size_t size);
+void tlsf_free(tlsf_t *t, void *ptr);
+
+// Payload bytes of an allocated block (>= the size asked for)
+size_t tlsf_block_size(const void *ptr);
+
+// Walk all pools (O(blocks), for statistics only)
+void tlsf_get_stats(tlsf_t *t, tlsf_stats_t *s);
+
+// Check the lists, bitmaps and block chain. Returns 0 if consistent, else
+// the number of errors found.
+int tlsf_check(tlsf_t *t);
+
+// tlsf_malloc.c: the heap behind malloc() (NULL before the first allocation)
+tlsf_t *tlsf_malloc_heap(void);
+
+#endif // TLSF_H
@@ -0,0 +1,182 @@
+//===============================================================================
+// TLSF - newlib malloc Replacement
+// _malloc_r family on lib/tlsf, heap grown with _sbrk()
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// Linked ahead of -lc (firmware/Makefile, Makefile.overlay with Kconfig
+// MALLOC_TLSF), so these names resolve here and newlib's allocator is never
+// pulled in. newlib's own malloc()/free()/calloc()/realloc() wrappers call
+// the _r functions below, as does everything inside newlib that allocates.
+//
+// The heap grows on demand through _sbrk(), at least TLSF_SBRK_STEP at a
+// time, so the break and heap_set_limit() (lib/syscalls.c) work as with
+// newlib's malloc and the overlay's _sbrk() bounds it to the overlay heap.
+// Consecutive _sbrk() regions extend one pool. __malloc_lock() serializes,
+// as it does for newlib (a critical section under FreeRTOS).
+//
+//===============================================================================
+
+#include <errno.h>
+#include <string.h>
+#include <malloc.h>
+#include <sys/reent.h>
+#include "tlsf.h"
+
+void *_sbrk(int incr);
+
+#ifndef TLSF_SBRK_STEP
+#define TLSF_SBRK_STEP      (8 * 1024)
+#endif
+
+static tlsf_t *heap;
+static size_t heap_arena;       // Bytes taken with _sbrk()
+
+static void *sbrk_bytes(size_t bytes) {
+    void *p = _sbrk((int)bytes);
+    if (p == (void *)-1) {
+        return NULL;
+    }
+    heap_arena += bytes;
+    return p;
+}
+
+// Room for a payload of size (aligned to align) after a grow. The search
+// rounds up by at most 1/16, and a new pool needs its headers.
+static int grow(size_t size, size_t align) {
+    size_t need = size + (size >> 4) + align + tlsf_pool_overhead() + 64;
+    need = (need + 7) & ~(size_t)7;
+
+    size_t step = need < TLSF_SBRK_STEP ? TLSF_SBRK_STEP : need;
+    void *p = sbrk_bytes(step);
+    if (!p && step != need) {
+        step = need;
+        p = sbrk_bytes(step);
+    }
+    if (!p) {
+        return -1;
+    }
+    return tlsf_add_pool(heap, p, step);
+}
+
+static int heap_init(void) {
+    // 8-byte aligned break: every later _sbrk() region then continues the pool
+    char *brk = _sbrk(0);
+    size_t pad = (size_t)(-(uintptr_t)brk & 7);
+    if (brk == (void *)-1 || (pad && !sbrk_bytes(pad))) {
+        return -1;
+    }
+
+    size_t first = tlsf_size() + TLSF_SBRK_STEP;
+    void *p = sbrk_bytes(first);
+    if (!p) {
+        return -1;
+    }
+    heap = tlsf_create(p, first);
+    return heap ? 0 : -1;
+}
+
+static void *alloc(struct _reent *r, size_t align, size_t size) {
+    void *p = NULL;
+
+    __malloc_lock(r);
+    if (heap || heap_init() == 0) {
+        p = tlsf_memalign(heap, align, size);
+        if (!p && grow(size, align) == 0) {
+            p = tlsf_memalign(heap, align, size);
+        }
+    }
+    __malloc_unlock(r);
+
+    if (!p) {
+        r->_errno = ENOMEM;
+    }
+    return p;
+}
+
+void *_malloc_r(struct _reent *r, size_t size) {
+    return alloc(r, 0, size);
+}
+
+void *_memalign_r(struct _reent *r, size_t align, size_t size) {
+    return alloc(r, align, size);
+}
+
+void *_calloc_r(struct _reent *r, size_t n, size_t size) {
+    size_t bytes = n * size;
+
+    if (size && bytes / size != n) {
+        r->_errno = ENOMEM;
+        return NULL;
+    }
+
+    void *p = alloc(r, 0, bytes);
+    if (p) {
+        memset(p, 0, bytes);
+    }
+    return p;
+}
+
+void _free_r(struct _reent *r, void *ptr) {
+    if (!ptr) {
+        return;
+    }
+
+    __malloc_lock(r);
+    tlsf_free(heap, ptr);
+    __malloc_unlock(r);
+}
+
+void *_realloc_r(struct _reent *r, void *ptr, size_t size) {
+    if (!ptr) {
+        return alloc(r, 0, size);
+    }
+
+    __malloc_lock(r);
+    void *p = tlsf_realloc(heap, ptr, size);
+    __malloc_unlock(r);
+
+    // Out of pool: grow, or move to a fresh block
+    if (!p && size) {
+        p = alloc(r, 0, size);
+        if (p) {
+            size_t have = tlsf_block_size(ptr);
+            memcpy(p, ptr, have < size ? have : size);
+            _free_r(r, ptr);
+        }
+    }
+    return p;
+}
+
+size_t _malloc_usable_size_r(struct _reent *r, void *ptr) {
+    (void)r;
+    return ptr ? tlsf_block_size(ptr) : 0;
+}
+
+// For lib/mem_stats.h: free-list length and in-use bytes
+struct mallinfo _mallinfo_r(struct _reent *r) {
+    struct mallinfo mi;
+    tlsf_stats_t s = { 0 };
+
+    memset(&mi, 0, sizeof(mi));
+    __malloc_lock(r);
+    if (heap) {
+        tlsf_get_stats(heap, &s);
+    }
+    mi.arena = heap_arena;
+    mi.ordblks = s.free_blocks;
+    mi.fordblks = s.free;
+    mi.uordblks = heap_arena - s.free;
+    __malloc_unlock(r);
+    return mi;
+}
+
+struct mallinfo mallinfo(void) {
+    return _mallinfo_r(_REENT);
+}
+
+tlsf_t *tlsf_malloc_heap(void) {
+    return heap;
+}
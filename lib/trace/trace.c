@@ -0,0 +1,255 @@
+//===============================================================================
+// Event Trace Recorder - Implementation
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+
+#include "trace.h"
+#include "../atomic.h"
+#include "../timer.h"
+#include "../perf_counters.h"
+
+#define UART_TX_DATA        (*(volatile uint32_t*)0x80000000)
+#define UART_TX_STATUS      (*(volatile uint32_t*)0x80000004)
+#define UART_TX_WORD        (*(volatile uint32_t*)0x80000004)  // Write: all byte lanes
+
+#define UART_TX_FIFO        (1u << 31)                  // TX FIFO and TX_WORD present
+#define UART_TX_FREE(s)     (((s) >> 16) & 0xFFF)       // Free TX FIFO bytes
+
+#define RING_MASK           (TRACE_RECORDS - 1)
+#define HEADER_BYTES        16
+#define NAME_BYTES          (TRACE_NAME_LEN + 1)
+
+#if (TRACE_RECORDS & RING_MASK) != 0 || TRACE_RECORDS > 0x8000
+#error "TRACE_RECORDS must be a power of two, at most 32768"
+#endif
+
+typedef struct {
+    uint32_t cycles;
+    uint32_t info;                      // type | id << 8 | arg << 16
+} trace_rec_t;
+
+typedef struct {
+    uint8_t id;
+    char name[TRACE_NAME_LEN];
+} trace_name_t;
+
+// Free-running indices: head written under the mask, tail by the reader
+static trace_rec_t s_ring[TRACE_RECORDS];
+static volatile uint32_t s_head;
+static volatile uint32_t s_tail;
+static uint32_t s_mode = TRACE_MODE_SNAPSHOT;
+static volatile uint32_t s_on = 1;
+static uint32_t s_dropped;
+static uint32_t s_wrapped;              // Snapshot events overwritten
+
+static trace_name_t s_names[TRACE_MAX_NAMES] __attribute__((aligned(4)));
+static uint32_t s_num_names;
+static uint32_t s_names_sent;           // Streamed with an earlier block
+
+//===============================================================================
+// Recording
+//===============================================================================
+
+__attribute__((section(".fastcode")))
+void trace_record(uint32_t type, uint32_t id, uint32_t arg) {
+    uint32_t irq = atomic_irq_save();
+    uint32_t h = s_head;
+
+    if (s_on) {
+        if (h - s_tail >= TRACE_RECORDS) {
+            if (s_mode == TRACE_MODE_STREAM) {
+                s_dropped++;
+                atomic_irq_restore(irq);
+                return;
+            }
+            s_tail = h - TRACE_RECORDS + 1;     // Oldest one goes
+            s_wrapped = 1;
+        }
+        s_ring[h & RING_MASK].cycles = rdcycle();
+        s_ring[h & RING_MASK].info = type | ((id & 0xFF) << 8) | (arg << 16);
+        s_head = h + 1;
+    }
+    atomic_irq_restore(irq);
+}
+
+__attribute__((section(".fastcode")))
+void trace_isr_call(uint32_t source, void (*handler)(uint32_t)) {
+    trace_record(TRACE_EV_ISR_ENTER, source, 0);
+    handler(source);
+    trace_record(TRACE_EV_ISR_EXIT, source, 0);
+}
+
+void trace_init(uint32_t mode) {
+    uint32_t irq = atomic_irq_save();
+
+    s_mode = mode;
+    s_names_sent = 0;
+    atomic_irq_restore(irq);
+}
+
+void trace_enable(int on) {
+    atomic_store(&s_on, on ? 1 : 0);
+}
+
+void trace_name(uint32_t id, const char *name) {
+    uint32_t irq = atomic_irq_save();
+    uint32_t n;
+
+    for (n = 0; n < s_num_names && s_names[n].id != (id & 0xFF); n++);
+    if (n == TRACE_MAX_NAMES) {
+        atomic_irq_restore(irq);
+        return;
+    }
+    if (n == s_num_names) {
+        s_num_names++;
+    } else if (n < s_names_sent) {
+        s_names_sent = 0;               // Renamed: send the table again
+    }
+
+    s_names[n].id = id & 0xFF;
+    for (uint32_t i = 0; i < TRACE_NAME_LEN; i++) {
+        s_names[n].name[i] = name[i];
+        if (!name[i]) {
+            for (; i < TRACE_NAME_LEN; i++) {
+                s_names[n].name[i] = 0;
+            }
+        }
+    }
+    atomic_irq_restore(irq);
+}
+
+uint32_t trace_dropped(void) {
+    return atomic_load(&s_dropped);
+}
+
+//===============================================================================
+// Output
+//===============================================================================
+
+static void trace_header(uint32_t *w, uint32_t records, uint32_t names, uint32_t flags) {
+    w[0] = 'T' | ('R' << 8) | ('C' << 16) | ('1' << 24);
+    w[1] = SYS_CLK_HZ;
+    w[2] = records | (names << 16) | (flags << 24);
+    w[3] = s_dropped;
+}
+
+// Events [t, t + n) of the ring, in up to two runs
+static int trace_write_records(trace_write_fn write, void *ctx, uint32_t t, uint32_t n) {
+    while (n) {
+        uint32_t run = TRACE_RECORDS - (t & RING_MASK);
+        if (run > n) {
+            run = n;
+        }
+        if (write(&s_ring[t & RING_MASK], run * sizeof(trace_rec_t), ctx)) {
+            return -1;
+        }
+        t += run;
+        n -= run;
+    }
+    return 0;
+}
+
+int trace_dump(trace_write_fn write, void *ctx) {
+    uint32_t header[HEADER_BYTES / 4];
+    uint32_t was_on = atomic_load(&s_on);
+    uint32_t t, n;
+    int err;
+
+    // Paused, so the ring keeps still while it goes out
+    trace_enable(0);
+    t = s_tail;
+    n = s_head - t;
+
+    trace_header(header, n, s_num_names, s_wrapped ? TRACE_BLOCK_WRAPPED : 0);
+    err = write(header, HEADER_BYTES, ctx);
+    if (!err && s_num_names) {
+        err = write(s_names, s_num_names * NAME_BYTES, ctx);
+    }
+    if (!err) {
+        err = trace_write_records(write, ctx, t, n);
+    }
+    if (!err) {
+        s_tail = t + n;
+        s_wrapped = 0;
+    }
+    trace_enable(was_on);
+
+    return err ? -1 : (int)n;
+}
+
+//===============================================================================
+// UART
+//===============================================================================
+
+static int trace_uart_write(const void *buf, uint32_t len, void *ctx) {
+    const uint8_t *p = buf;
+
+    (void)ctx;
+    if (UART_TX_STATUS & UART_TX_FIFO) {
+        // Every chunk is a whole number of words, and word aligned
+        const uint32_t *w = buf;
+        for (uint32_t i = 0; i < len / 4; i++) {
+            while (UART_TX_FREE(UART_TX_STATUS) < 4);
+            UART_TX_WORD = w[i];
+        }
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < len; i++) {
+        while (UART_TX_STATUS & 0x01);
+        UART_TX_DATA = p[i];
+    }
+    return 0;
+}
+
+int trace_dump_uart(void) {
+    return trace_dump(trace_uart_write, 0);
+}
+
+//===============================================================================
+// Streaming
+//===============================================================================
+
+uint32_t trace_stream_poll(void) {
+    uint32_t header[HEADER_BYTES / 4];
+    uint32_t irq, status, room, t, n, names;
+
+    status = UART_TX_STATUS;
+    if (!(status & UART_TX_FIFO)) {
+        return atomic_load(&s_head) - atomic_load(&s_tail);
+    }
+
+    // Masked, so no other UART output lands inside the block
+    irq = atomic_irq_save();
+    t = s_tail;
+    n = s_head - t;
+    names = s_num_names - s_names_sent;
+    room = UART_TX_FREE(status);
+
+    if (n == 0 && names == 0) {
+        atomic_irq_restore(irq);
+        return 0;
+    }
+    if (room < HEADER_BYTES + names * NAME_BYTES + sizeof(trace_rec_t)) {
+        atomic_irq_restore(irq);
+        return n;
+    }
+
+    room -= HEADER_BYTES + names * NAME_BYTES;
+    if (n > room / sizeof(trace_rec_t)) {
+        n = room / sizeof(trace_rec_t);
+    }
+
+    trace_header(header, n, names, TRACE_BLOCK_STREAM);
+    trace_uart_write(header, HEADER_BYTES, 0);
+    trace_uart_write(&s_names[s_names_sent], names * NAME_BYTES, 0);
+    trace_write_records(trace_uart_write, 0, t, n);
+    s_names_sent = s_num_names;
+    s_tail = t + n;
+    n = s_head - s_tail;
+    atomic_irq_restore(irq);
+
+    return n;
+}
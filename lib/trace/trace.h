@@ -0,0 +1,140 @@
+//===============================================================================
+// Event Trace Recorder
+// ISR entry/exit, task switches and driver events with cycle timestamps
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// Built in with Kconfig EVENT_TRACE (or make TRACE=1), which defines
+// TRACE_ENABLE; without it every TRACE_*() macro below compiles to nothing
+// and the hooks cost no code. Each event is 8 bytes in a RAM ring: the
+// low word of rdcycle and type / id / 16-bit argument, written in a masked
+// section from .fastcode.
+//
+// Hooks already in the tree:
+//   start.S dispatcher    ISR enter / exit per source (trace_isr_call)
+//   freertos_irq.c        irq_handler() enter / exit with the pending mask
+//   trace_freertos.h      task switch, ready, create, delay (FreeRTOSConfig.h)
+//   freertos_uart.c       bytes moved per RX drain / TX refill
+//   sd_fatfs io.c         SPI DMA and FIFO block transfers, begin / end
+//
+// Firmware adds its own spans and points:
+//
+//   TRACE_MARK_BEGIN(3);  parse_frame();  TRACE_MARK_END(3);
+//   TRACE_MARK(7, queue_depth);
+//
+// Two ways to get the events out:
+//
+//   TRACE_MODE_SNAPSHOT (the default) keeps the last TRACE_RECORDS events,
+//   overwriting the oldest; trace_dump() writes them out once, to any sink
+//   (trace_dump_uart(), a FatFs file in sd_card_manager's benchmark).
+//
+//   TRACE_MODE_STREAM keeps events until trace_stream_poll() - the idle
+//   loop or idle hook - sends them as blocks that fit the free TX FIFO
+//   space, so it never waits. When the ring is full new events are
+//   dropped and counted.
+//
+// tools/trace2json converts a dump file or a UART capture (the text around
+// the blocks is skipped) to Chrome trace JSON for chrome://tracing or
+// ui.perfetto.dev.
+//
+// Block format (little-endian):
+//   +0   "TRC1"
+//   +4   CPU clock in Hz
+//   +8   u16 records, u8 names, u8 flags (TRACE_BLOCK_*)
+//   +12  events dropped so far
+//   +16  names: 16 bytes each, u8 id + NUL-padded name (task names)
+//   then records: u32 cycles, u32 type | id << 8 | arg << 16
+//
+//===============================================================================
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+#ifndef TRACE_RECORDS
+#define TRACE_RECORDS        1024           // Power of two: 8 KB
+#endif
+
+#define TRACE_MAX_NAMES      32
+#define TRACE_NAME_LEN       15
+
+#define TRACE_MODE_SNAPSHOT  0              // Overwrite the oldest
+#define TRACE_MODE_STREAM    1              // Drop the newest when full
+
+// Event types
+#define TRACE_EV_ISR_ENTER   1              // id: IRQ source, or TRACE_ID_IRQS (arg: pending mask)
+#define TRACE_EV_ISR_EXIT    2
+#define TRACE_EV_TASK_SWITCH 3              // id: task number now running
+#define TRACE_EV_TASK_READY  4              // id: task number made ready
+#define TRACE_EV_TASK_CREATE 5              // id: task number, arg: priority
+#define TRACE_EV_TASK_DELAY  6              // The running task blocks on a delay
+#define TRACE_EV_SPI_BEGIN   7              // id: TRACE_SPI_READ / _WRITE, arg: bytes
+#define TRACE_EV_SPI_END     8              // Closes the transfer begun last
+#define TRACE_EV_UART_RX     9              // arg: bytes
+#define TRACE_EV_UART_TX     10             // arg: bytes
+#define TRACE_EV_MARK_BEGIN  11             // id: firmware defined
+#define TRACE_EV_MARK_END    12
+#define TRACE_EV_MARK        13             // arg: firmware defined
+
+#define TRACE_ID_IRQS        0xFF           // A C irq_handler() serving a mask
+#define TRACE_SPI_READ       0
+#define TRACE_SPI_WRITE      1
+
+#define TRACE_BLOCK_STREAM   0x01           // More blocks follow
+#define TRACE_BLOCK_WRAPPED  0x02           // Older snapshot events were overwritten
+
+// Sink for trace_dump(): 0 on success
+typedef int (*trace_write_fn)(const void *buf, uint32_t len, void *ctx);
+
+#ifdef TRACE_ENABLE
+
+#define TRACE_EVENT(type, id, arg)  trace_record((type), (id), (arg))
+#define TRACE_ISR_ENTER_MASK(irqs)  trace_record(TRACE_EV_ISR_ENTER, TRACE_ID_IRQS, (irqs))
+#define TRACE_ISR_EXIT_MASK()       trace_record(TRACE_EV_ISR_EXIT, TRACE_ID_IRQS, 0)
+#define TRACE_MARK_BEGIN(id)        trace_record(TRACE_EV_MARK_BEGIN, (id), 0)
+#define TRACE_MARK_END(id)          trace_record(TRACE_EV_MARK_END, (id), 0)
+#define TRACE_MARK(id, arg)         trace_record(TRACE_EV_MARK, (id), (arg))
+
+#else
+
+#define TRACE_EVENT(type, id, arg)  ((void)0)
+#define TRACE_ISR_ENTER_MASK(irqs)  ((void)0)
+#define TRACE_ISR_EXIT_MASK()       ((void)0)
+#define TRACE_MARK_BEGIN(id)        ((void)0)
+#define TRACE_MARK_END(id)          ((void)0)
+#define TRACE_MARK(id, arg)         ((void)0)
+
+#endif // TRACE_ENABLE
+
+// Snapshot or stream (events kept); the ring records from reset on
+void trace_init(uint32_t mode);
+
+// Pause / resume recording (events in between are not counted as dropped)
+void trace_enable(int on);
+
+// One event, from anywhere. Use the macros, which vanish without TRACE_ENABLE.
+void trace_record(uint32_t type, uint32_t id, uint32_t arg);
+
+// Name for an id in the dump (task names; trace_freertos.h does this)
+void trace_name(uint32_t id, const char *name);
+
+// The start.S dispatcher's call of an irq_register() handler
+void trace_isr_call(uint32_t source, void (*handler)(uint32_t));
+
+// Write every event not sent yet as one block, recording paused meanwhile.
+// Returns the number of events, or -1 if the sink failed.
+int trace_dump(trace_write_fn write, void *ctx);
+
+// trace_dump() to the UART, waiting for it
+int trace_dump_uart(void);
+
+// TRACE_MODE_STREAM: send what fits in the TX FIFO now; returns the
+// number of events still queued
+uint32_t trace_stream_poll(void);
+
+uint32_t trace_dropped(void);
+
+#endif // TRACE_H
@@ -0,0 +1,44 @@
+//===============================================================================
+// Event Trace Recorder - FreeRTOS Kernel Hooks
+// Included by FreeRTOSConfig.h when TRACE_ENABLE is defined
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// The macros expand inside tasks.c, where the TCB fields are visible.
+// Tasks are identified by uxTCBNumber (TaskStatus_t.xTaskNumber); the
+// create hook names them in the dump. The run-time stats switch hook keeps
+// running next to the trace one.
+//
+//===============================================================================
+
+#ifndef TRACE_FREERTOS_H
+#define TRACE_FREERTOS_H
+
+#include "trace.h"
+
+#define traceTASK_SWITCHED_IN()                                             \
+    do {                                                                    \
+        portTRACE_STATS_SWITCHED_IN();                                      \
+        trace_record(TRACE_EV_TASK_SWITCH, pxCurrentTCB->uxTCBNumber, 0);   \
+    } while (0)
+
+#define traceTASK_CREATE(pxNewTCB)                                          \
+    do {                                                                    \
+        portGDB_TASK_CREATE(pxNewTCB);                                      \
+        trace_name((pxNewTCB)->uxTCBNumber, (pxNewTCB)->pcTaskName);        \
+        trace_record(TRACE_EV_TASK_CREATE, (pxNewTCB)->uxTCBNumber,         \
+                     (pxNewTCB)->uxPriority);                               \
+    } while (0)
+
+#define traceMOVED_TASK_TO_READY_STATE(pxTCB) \
+    trace_record(TRACE_EV_TASK_READY, (pxTCB)->uxTCBNumber, 0)
+
+#define traceTASK_DELAY() \
+    trace_record(TRACE_EV_TASK_DELAY, pxCurrentTCB->uxTCBNumber, 0)
+
+#define traceTASK_DELAY_UNTIL(xTimeToWake) \
+    trace_record(TRACE_EV_TASK_DELAY, pxCurrentTCB->uxTCBNumber, 0)
+
+#endif // TRACE_FREERTOS_H
@@ -0,0 +1,233 @@
+//===============================================================================
+// UART Baud Rate - Run-Time Divider and Auto-Baud Handshake
+// Registers at 0x80000130, handshake shared with fw_upload_fast and slattach_1m
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// The UART core takes its timing from the BAUD register: a 16.8 fixed-point
+// count of clocks per oversampling tick and the ticks per bit (16, or 8/4
+// for the fastest rates). uart_baud_set() picks both for a baud rate; the
+// result is exact to 1/256 clock, so USB-serial rates like 3 Mbaud work at
+// any system clock. The CPU reset restores 1 Mbaud.
+//
+// Auto-baud handshake, always started by the host at the current rate:
+//
+//   Host: 'U' + rate (LE32) + check        -> 'u' + rate: switching
+//                                              'n': rate not reachable
+//   Both switch. Host waits UART_BAUD_SETTLE_MS, then at the new rate:
+//   Host: UART_BAUD_PATTERN_LEN test bytes -> the same bytes echoed
+//   Host: 'K'                              -> 'K': rate kept
+//
+// A device that sees a wrong byte, or nothing for UART_BAUD_TIMEOUT_MS,
+// goes back to the old rate; so does a host that gets a wrong echo. The
+// host then tries the next lower rate, down to the one it started at.
+// check = ~('U' ^ the four rate bytes). Receivers that do not know 'U'
+// ignore the handshake and the host stays at its rate.
+//
+// The device side (uart_baud_accept / uart_baud_listen) is built only for
+// the target; hosts include this header for the constants.
+//
+//===============================================================================
+
+#ifndef UART_BAUD_H
+#define UART_BAUD_H
+
+#include <stdint.h>
+
+#define UART_BAUD_CMD           'U'     // Host: rate request
+#define UART_BAUD_ACK           'u'     // Device: switching to the rate
+#define UART_BAUD_NAK           'n'     // Device: rate not reachable
+#define UART_BAUD_COMMIT        'K'     // Both: test passed, keep the rate
+#define UART_BAUD_PATTERN_LEN   16
+#define UART_BAUD_SETTLE_MS     20      // Host delay before the test pattern
+#define UART_BAUD_TIMEOUT_MS    200     // Device gives up, back to the old rate
+
+static inline uint8_t uart_baud_check(uint32_t rate) {
+    return (uint8_t)~(UART_BAUD_CMD ^ (rate & 0xFF) ^ ((rate >> 8) & 0xFF) ^
+                      ((rate >> 16) & 0xFF) ^ (rate >> 24));
+}
+
+// Test pattern: single edges, runs of 0s and 1s, alternating bits. A rate
+// that is a few percent off drops or shifts some of them.
+static inline uint8_t uart_baud_pattern(int i) {
+    static const uint8_t pattern[UART_BAUD_PATTERN_LEN] = {
+        0x55, 0xAA, 0x00, 0xFF, 0x0F, 0xF0, 0x01, 0x80,
+        0xFE, 0x7F, 0x33, 0xCC, 0x5A, 0xA5, 0xC3, 0x3C
+    };
+    return pattern[i];
+}
+
+#ifdef __riscv
+
+#include "timer.h"
+
+#define UART_BAUD_REG           (*(volatile uint32_t*)0x80000130)
+#define UART_BAUD_CLK_HZ        (*(volatile uint32_t*)0x80000134)   // Read only
+
+#define UART_BAUD_DIV(r)        ((r) & 0xFFFFFF)        // Clocks per tick (16.8)
+#define UART_BAUD_OS(r)         (((r) >> 24) & 0x1F)    // Ticks per bit
+#define UART_BAUD_VALUE(div, os) (((uint32_t)(os) << 24) | (div))
+#define UART_BAUD_MIN_DIV       512                     // 2.0 clocks per tick
+
+// UART data registers, local names so this header goes in beside any driver
+#define UART_BAUD_TX_DATA       (*(volatile uint32_t*)0x80000000)
+#define UART_BAUD_TX_STATUS     (*(volatile uint32_t*)0x80000004)
+#define UART_BAUD_RX_DATA       (*(volatile uint32_t*)0x80000008)
+#define UART_BAUD_RX_STATUS     (*(volatile uint32_t*)0x8000000C)
+
+// a * 256 / b without 64-bit division (no libgcc in the bootloaders)
+static inline uint32_t uart_baud_div256(uint32_t a, uint32_t b) {
+    uint32_t q = a / b, r = a % b;
+
+    r <<= 4;
+    q = (q << 4) + r / b;
+    r = (r % b) << 4;
+    return (q << 4) + (r + b / 2) / b;
+}
+
+// BAUD register value for a rate, or 0 if the UART cannot reach it. Uses
+// the most oversampling that still leaves two clocks per tick.
+static inline uint32_t uart_baud_value(uint32_t baud) {
+    uint32_t clk = UART_BAUD_CLK_HZ;    // 0 on bitstreams without the register
+
+    if (clk == 0 || baud == 0) {
+        return 0;
+    }
+    for (uint32_t os = 16; os >= 4; os >>= 1) {
+        if (baud > clk / os) {
+            continue;                   // Less than a clock per tick
+        }
+        uint32_t div = uart_baud_div256(clk, baud * os);
+        if (div >= UART_BAUD_MIN_DIV && div <= 0xFFFFFF) {
+            return UART_BAUD_VALUE(div, os);
+        }
+    }
+    return 0;
+}
+
+// Current baud rate (0 if the register is missing)
+static inline uint32_t uart_baud_get(void) {
+    uint32_t v = UART_BAUD_REG;
+    uint32_t ticks = UART_BAUD_DIV(v) * UART_BAUD_OS(v);
+
+    return ticks ? uart_baud_div256(UART_BAUD_CLK_HZ, ticks) : 0;
+}
+
+// Wait until the TX FIFO is empty and the last character is on the wire
+static inline void uart_baud_drain(void) {
+    while (UART_BAUD_TX_STATUS & (1 << 1));
+}
+
+// Returns 0, or -1 if the rate is not reachable (the rate is unchanged)
+static inline int uart_baud_set(uint32_t baud) {
+    uint32_t v = uart_baud_value(baud);
+
+    if (!v) {
+        return -1;
+    }
+    uart_baud_drain();
+    UART_BAUD_REG = v;
+    return 0;
+}
+
+static inline void uart_baud_putc(uint8_t c) {
+    while (UART_BAUD_TX_STATUS & 1);
+    UART_BAUD_TX_DATA = c;
+}
+
+// Next RX byte, or -1 after timeout_us
+static inline int uart_baud_getc(uint32_t timeout_us) {
+    uint32_t start = timebase_us32();
+
+    while (!(UART_BAUD_RX_STATUS & 1)) {
+        if ((uint32_t)(timebase_us32() - start) >= timeout_us) {
+            return -1;
+        }
+    }
+    return UART_BAUD_RX_DATA & 0xFF;
+}
+
+// Handshake after the caller has read the 'U'. Returns the new baud rate,
+// or -1 with the old rate still set.
+static inline int32_t uart_baud_accept(void) {
+    const uint32_t timeout = UART_BAUD_TIMEOUT_MS * 1000;
+    uint32_t rate = 0, old, v;
+    int c, i;
+
+    for (i = 0; i < 5; i++) {
+        if ((c = uart_baud_getc(timeout)) < 0) {
+            return -1;
+        }
+        if (i < 4) {
+            rate |= (uint32_t)c << (i * 8);
+        } else if (c != uart_baud_check(rate)) {
+            return -1;                  // Garbage that started with 'U'
+        }
+    }
+
+    v = uart_baud_value(rate);
+    if (!v) {
+        uart_baud_putc(UART_BAUD_NAK);
+        return -1;
+    }
+    uart_baud_putc(UART_BAUD_ACK);
+    for (i = 0; i < 4; i++) {
+        uart_baud_putc((rate >> (i * 8)) & 0xFF);
+    }
+
+    // Switch, then drop whatever arrived while the host was switching
+    uart_baud_drain();
+    old = UART_BAUD_REG;
+    UART_BAUD_REG = v;
+    timebase_delay_us(UART_BAUD_SETTLE_MS * 1000 / 2);
+    while (UART_BAUD_RX_STATUS & 1) {
+        (void)UART_BAUD_RX_DATA;
+    }
+
+    for (i = 0; i < UART_BAUD_PATTERN_LEN; i++) {
+        if (uart_baud_getc(timeout) != uart_baud_pattern(i)) {
+            break;
+        }
+    }
+    if (i == UART_BAUD_PATTERN_LEN) {
+        for (i = 0; i < UART_BAUD_PATTERN_LEN; i++) {
+            uart_baud_putc(uart_baud_pattern(i));
+        }
+        if (uart_baud_getc(timeout) == UART_BAUD_COMMIT) {
+            uart_baud_putc(UART_BAUD_COMMIT);
+            UART_BAUD_RX_STATUS = 0;    // Framing errors from the switch
+            return (int32_t)rate;
+        }
+    }
+
+    uart_baud_drain();
+    UART_BAUD_REG = old;
+    UART_BAUD_RX_STATUS = 0;
+    return -1;
+}
+
+// Answer handshakes for ms milliseconds, e.g. before attaching SLIP so that
+// slattach_1m -n can raise the rate. Other bytes are dropped. Returns the
+// rate agreed, or -1 if none was.
+static inline int32_t uart_baud_listen(uint32_t ms) {
+    uint32_t start = timebase_ms();
+    int32_t rate = -1;
+
+    while ((uint32_t)(timebase_ms() - start) < ms) {
+        if (uart_baud_getc(1000) == UART_BAUD_CMD) {
+            int32_t r = uart_baud_accept();
+            if (r > 0) {
+                rate = r;
+                break;
+            }
+            start = timebase_ms();      // The host steps down and asks again
+        }
+    }
+    return rate;
+}
+
+#endif // __riscv
+
+#endif // UART_BAUD_H
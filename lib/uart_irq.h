@@ -0,0 +1,81 @@
+//===============================================================================
+// UART interrupts (RX available / watermark / idle, TX low watermark)
+// Registers at 0x80000120, IRQ[4] = RX, IRQ[5] = TX
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// The UART interrupt lines are levels: they stay high while an enabled
+// condition holds (data in the RX FIFO, RX level at the watermark, TX
+// level at or below the low watermark). PicoRV32 latches every IRQ, so
+// a handler must drain/refill the FIFO or disable the source before it
+// returns, or it is entered again straight away. The usual pattern is
+// "arm, sleep, disarm in the handler":
+//
+//   void irq_handler(uint32_t irqs) {
+//       if (irqs & (1 << IRQ_UART_RX)) uart_irq_disable(UART_IRQ_RX_ALL);
+//   }
+//
+//   uart_rx_wait();                    // Sleeps in waitirq until RX data
+//
+// RX idle (bytes waiting but nothing received for IRQ_IDLE cycles, two
+// character times after reset) is sticky: clear it with uart_irq_ack().
+//
+//===============================================================================
+
+#ifndef UART_IRQ_H
+#define UART_IRQ_H
+
+#include <stdint.h>
+
+#define UART_IRQ_BASE       0x80000120
+#define UART_IRQ_EN         (*(volatile uint32_t*)(UART_IRQ_BASE + 0x00))
+#define UART_IRQ_STAT       (*(volatile uint32_t*)(UART_IRQ_BASE + 0x04))
+#define UART_IRQ_LEVEL      (*(volatile uint32_t*)(UART_IRQ_BASE + 0x08))
+#define UART_IRQ_IDLE       (*(volatile uint32_t*)(UART_IRQ_BASE + 0x0C))
+
+// IRQ_EN / IRQ_STAT bits
+#define UART_IRQ_RX_AVAIL   (1 << 0)        // RX FIFO not empty
+#define UART_IRQ_RX_WM      (1 << 1)        // RX level >= RX watermark
+#define UART_IRQ_RX_IDLE    (1 << 2)        // RX bytes waiting, line idle (W1C)
+#define UART_IRQ_TX_LOW     (1 << 3)        // TX level <= TX low watermark
+#define UART_IRQ_RX_ALL     (UART_IRQ_RX_AVAIL | UART_IRQ_RX_WM | UART_IRQ_RX_IDLE)
+
+#define UART_IRQ_RX_LEVEL(stat)         (((stat) >> 16) & 0x1FFF)   // Up to 4 KB FIFO
+#define UART_IRQ_LEVELS(rx_wm, tx_wm)   (((uint32_t)(tx_wm) << 16) | (rx_wm))
+
+// PicoRV32 IRQ numbers
+#define IRQ_UART_RX         4
+#define IRQ_UART_TX         5
+
+static inline void uart_irq_enable(uint32_t mask) {
+    UART_IRQ_EN |= mask;
+}
+
+static inline void uart_irq_disable(uint32_t mask) {
+    UART_IRQ_EN &= ~mask;
+}
+
+static inline void uart_irq_ack(void) {
+    UART_IRQ_STAT = UART_IRQ_RX_IDLE;
+}
+
+// Pause until any interrupt is pending (PicoRV32 waitirq)
+static inline uint32_t picorv32_waitirq(void) {
+    uint32_t pending;
+    __asm__ volatile (".insn r 0x0B, 4, 4, %0, x0, x0" : "=r"(pending) : : "memory");
+    return pending;
+}
+
+// Sleep until the RX FIFO has data. Needs interrupts enabled and an
+// irq_handler that disables UART_IRQ_RX_ALL on IRQ[4]; any other IRQ
+// (the timer tick) also wakes it, so callers loop on their own condition.
+static inline void uart_rx_wait(void) {
+    if (UART_IRQ_STAT & UART_IRQ_RX_AVAIL)
+        return;
+    uart_irq_enable(UART_IRQ_RX_AVAIL);
+    picorv32_waitirq();
+}
+
+#endif // UART_IRQ_H
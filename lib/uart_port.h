@@ -0,0 +1,66 @@
+//===============================================================================
+// UART instances: UART0 (data link) and the console UART
+// UART0 at 0x80000000 / 0x80000120, console at 0x80000230 / 0x80000240
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// Both are uart_peripheral.v: TX/RX data and status at a base address,
+// interrupt, baud and clock registers at a control address. UART0 carries
+// SLIP, uploads and the hardware loader; the console UART (hdl/uart_port.v,
+// Kconfig CONSOLE_UART) has pins of its own, so debug output cannot land
+// inside a frame. lib/syscalls.c puts stdio on it with STDIO_CONSOLE_UART.
+//
+// UART0's interrupts are IRQ[4] / IRQ[5] through the interrupt controller
+// (lib/uart_irq.h); the console's drive CPU IRQ[8] directly and are off
+// after reset, so only firmware with its own irq_handler() enables them.
+//
+// Usage:
+//   if (uart1_present()) {
+//       while (UART_PORT_TX_STATUS(UART1_BASE) & UART_PORT_TX_FULL);
+//       UART_PORT_TX_DATA(UART1_BASE) = c;
+//   }
+//
+//===============================================================================
+
+#ifndef UART_PORT_H
+#define UART_PORT_H
+
+#include <stdint.h>
+
+#define UART0_BASE              0x80000000
+#define UART0_CTRL              0x80000120
+#define UART1_BASE              0x80000230
+#define UART1_CTRL              0x80000240
+
+#define IRQ_UART1               8               // CPU IRQ, not a controller source
+
+#define UART_PORT_REG(a)        (*(volatile uint32_t*)(a))
+
+// Data block (base)
+#define UART_PORT_TX_DATA(b)    UART_PORT_REG((b) + 0x00)
+#define UART_PORT_TX_STATUS(b)  UART_PORT_REG((b) + 0x04)  // Read
+#define UART_PORT_TX_WORD(b)    UART_PORT_REG((b) + 0x04)  // Write: all byte lanes
+#define UART_PORT_RX_DATA(b)    UART_PORT_REG((b) + 0x08)
+#define UART_PORT_RX_STATUS(b)  UART_PORT_REG((b) + 0x0C)
+
+// Control block (ctrl); bits as in lib/uart_irq.h and lib/uart_baud.h
+#define UART_PORT_IRQ_EN(c)     UART_PORT_REG((c) + 0x00)
+#define UART_PORT_IRQ_STAT(c)   UART_PORT_REG((c) + 0x04)
+#define UART_PORT_IRQ_LEVEL(c)  UART_PORT_REG((c) + 0x08)
+#define UART_PORT_IRQ_IDLE(c)   UART_PORT_REG((c) + 0x0C)
+#define UART_PORT_BAUD(c)       UART_PORT_REG((c) + 0x10)
+#define UART_PORT_CLK_HZ(c)     UART_PORT_REG((c) + 0x14)
+
+#define UART_PORT_TX_FULL       (1u << 0)               // Wait before writing
+#define UART_PORT_TX_FIFO       (1u << 31)              // TX FIFO and TX_WORD present
+#define UART_PORT_TX_FREE(s)    (((s) >> 16) & 0xFFF)   // Free TX FIFO bytes
+#define UART_PORT_RX_AVAIL      (1u << 0)
+
+// Console UART built in (unmapped MMIO reads 0; TX_STATUS sets bit 31)
+static inline int uart1_present(void) {
+    return (UART_PORT_TX_STATUS(UART1_BASE) & UART_PORT_TX_FIFO) != 0;
+}
+
+#endif // UART_PORT_H
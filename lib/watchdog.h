@@ -0,0 +1,91 @@
+//===============================================================================
+// Hardware watchdog at 0x80000200
+// Own microsecond counter, pre-timeout on IRQ[7], CPU reset at expiry
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+//
+// The watchdog does not use a timer channel, so code under it keeps all of
+// lib/timer.h. PRETIME microseconds before expiry STATUS.PRE is set and,
+// with WDT_PRE_IRQ, raises IRQ[7] (shared with timer channels 1-3); the
+// handler can still take a crash dump. At expiry the watchdog disables
+// itself and, with WDT_RESET, resets the CPU. WDT_CAUSE tells the restarted
+// firmware why:
+//
+//   watchdog_start(2000000, 100000, WDT_PRE_IRQ | WDT_RESET);  // 2 s
+//   while (work_left()) {
+//       step();
+//       watchdog_kick();
+//   }
+//   watchdog_stop();
+//
+//   if (watchdog_reset_cause() == WDT_CAUSE_WATCHDOG) ...
+//
+// Without the watchdog in the bitstream every register reads 0.
+//
+//===============================================================================
+
+#ifndef WATCHDOG_H
+#define WATCHDOG_H
+
+#include <stdint.h>
+
+#define WDT_BASE            0x80000200
+#define WDT_CTRL            (*(volatile uint32_t*)(WDT_BASE + 0x00))
+#define WDT_TIMEOUT         (*(volatile uint32_t*)(WDT_BASE + 0x04))  // Microseconds
+#define WDT_PRETIME         (*(volatile uint32_t*)(WDT_BASE + 0x08))  // Before expiry
+#define WDT_KICK            (*(volatile uint32_t*)(WDT_BASE + 0x0C))  // Read = left
+#define WDT_STATUS          (*(volatile uint32_t*)(WDT_BASE + 0x10))  // Write 1 to clear
+#define WDT_CAUSE           (*(volatile uint32_t*)(WDT_BASE + 0x14))  // Read only
+
+// CTRL bits
+#define WDT_ENABLE          (1 << 0)        // Count down; setting it reloads TIMEOUT
+#define WDT_PRE_IRQ         (1 << 1)        // STATUS.PRE raises IRQ[7]
+#define WDT_RESET           (1 << 2)        // Expiry resets the CPU
+#define WDT_LOCK            (1 << 3)        // CTRL/TIMEOUT/PRETIME read only until expiry
+
+#define WDT_KICK_KEY        0x5AFE
+
+// STATUS bits
+#define WDT_STATUS_PRE      (1 << 0)        // Pre-timeout reached
+#define WDT_STATUS_EXPIRED  (1 << 1)        // Counter reached 0
+
+// CAUSE fields (survive the CPU reset)
+#define WDT_CAUSE_MASK      0x3
+#define WDT_CAUSE_POWER_ON  0
+#define WDT_CAUSE_WATCHDOG  1
+#define WDT_CAUSE_LOADER    2               // Hardware loader (Kconfig HW_LOADER)
+#define WDT_CAUSE_COUNT(c)  (((c) >> 8) & 0xFF)  // Watchdog resets since power-on
+#define WDT_PRESENT         (1u << 31)
+
+static inline int watchdog_present(void) {
+    // Unmapped MMIO reads return 0
+    return (WDT_CAUSE & WDT_PRESENT) != 0;
+}
+
+static inline void watchdog_kick(void) {
+    WDT_KICK = WDT_KICK_KEY;
+}
+
+// Arm with a timeout and a pre-timeout lead (both in microseconds) and the
+// WDT_PRE_IRQ / WDT_RESET / WDT_LOCK flags
+static inline void watchdog_start(uint32_t timeout_us, uint32_t pretime_us, uint32_t flags) {
+    WDT_CTRL = 0;
+    WDT_STATUS = WDT_STATUS_PRE | WDT_STATUS_EXPIRED;
+    WDT_TIMEOUT = timeout_us;
+    WDT_PRETIME = pretime_us;
+    WDT_CTRL = WDT_ENABLE | flags;
+}
+
+// Disable (the CTRL write is ignored while WDT_LOCK is set)
+static inline void watchdog_stop(void) {
+    WDT_CTRL = 0;
+    WDT_STATUS = WDT_STATUS_PRE | WDT_STATUS_EXPIRED;
+}
+
+static inline uint32_t watchdog_reset_cause(void) {
+    return WDT_CAUSE & WDT_CAUSE_MASK;
+}
+
+#endif // WATCHDOG_H
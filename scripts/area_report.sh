@@ -0,0 +1,77 @@
+#!/bin/bash
+# Logic-cell and EBR cost of each optional HDL block
+#
+# Builds the current .config once as the baseline, then once per option
+# with only that option flipped (layered over .config with
+# scripts/build_profile.sh), and reports the nextpnr ICESTORM_LC and
+# ICESTORM_RAM counts against the baseline. A negative delta is what
+# turning a block off frees; a positive one is what turning it on costs.
+#
+# Usage: scripts/area_report.sh [OPTION...]     (CONFIG_ prefix optional)
+# Results: build/area_report/report.txt, build/profiles/area_<option>/
+
+set -e
+
+OPTIONS="$*"
+if [ -z "$OPTIONS" ]; then
+    OPTIONS="PERIPHERAL_PMU PERIPHERAL_CRC32 PERIPHERAL_WATCHDOG CONSOLE_UART
+             SPI_HW_CRC SLIP_CODEC HW_LOADER PC_SAMPLER ATOMIC_UNIT FLASH_XIP
+             DUAL_CORE"
+fi
+
+if [ ! -f .config ]; then
+    echo "ERROR: .config not found. Run 'make menuconfig' or 'make defconfig' first."
+    exit 1
+fi
+
+AREA=build/area_report
+REPORT=$AREA/report.txt
+mkdir -p "$AREA"
+
+# lc_ram <build.log>: "<LCs> <EBRs>" from the nextpnr utilisation lines
+lc_ram() {
+    local lc ram
+    lc=$(grep 'ICESTORM_LC:' "$1" 2>/dev/null | tail -1 | sed -E 's/.*ICESTORM_LC: *([0-9]+)\/.*/\1/')
+    ram=$(grep 'ICESTORM_RAM:' "$1" 2>/dev/null | tail -1 | sed -E 's/.*ICESTORM_RAM: *([0-9]+)\/.*/\1/')
+    echo "${lc:--} ${ram:--}"
+}
+
+echo "# area report: baseline" > "$AREA/area_base.config"
+./scripts/build_profile.sh "$AREA/area_base.config" || echo "✗ baseline build failed"
+
+for opt in $OPTIONS; do
+    opt=${opt#CONFIG_}
+    name=$(echo "area_${opt}" | tr 'A-Z' 'a-z')
+    FRAG="$AREA/${name}.config"
+    if grep -q "^CONFIG_${opt}=y" .config; then
+        echo "# CONFIG_${opt} is not set" > "$FRAG"
+    else
+        echo "CONFIG_${opt}=y" > "$FRAG"
+    fi
+    # A failed P&R (the block does not fit) still gets a row in the report
+    ./scripts/build_profile.sh "$FRAG" || echo "✗ ${opt} build failed"
+done
+
+set -- $(lc_ram build/profiles/area_base/build.log)
+BASE_LC=$1
+BASE_RAM=$2
+
+{
+    echo "========================================="
+    echo "Area Report (against the current .config)"
+    echo "========================================="
+    printf "%-22s %-6s %-8s %-8s %-8s %s\n" "Option" "Set" "LCs" "dLCs" "EBRs" "dEBRs"
+    printf "%-22s %-6s %-8s %-8s %-8s %s\n" "(baseline)" "-" "$BASE_LC" "-" "$BASE_RAM" "-"
+    for opt in $OPTIONS; do
+        opt=${opt#CONFIG_}
+        name=$(echo "area_${opt}" | tr 'A-Z' 'a-z')
+        if grep -q "^CONFIG_${opt}=y" .config; then set_to=n; else set_to=y; fi
+        set -- $(lc_ram "build/profiles/${name}/build.log")
+        if [ "$1" = "-" ] || [ "$BASE_LC" = "-" ]; then
+            printf "%-22s %-6s %-8s %-8s %-8s %s\n" "$opt" "$set_to" "$1" "-" "$2" "-"
+        else
+            printf "%-22s %-6s %-8s %+-8d %-8s %+d\n" "$opt" "$set_to" "$1" $(($1 - BASE_LC)) \
+                   "$2" $(($2 - BASE_RAM))
+        fi
+    done
+} | tee "$REPORT"
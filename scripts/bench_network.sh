@@ -0,0 +1,433 @@
+#!/bin/bash
+# Network benchmark matrix over SLIP
+#
+# Every lwIP demo speaks its own protocol; this runs a fixed set of tests
+# against them with the same setup each time and writes one summary. For
+# each test the board is reset into the UART bootloader (iceprog), the
+# server firmware is uploaded with fw_upload, sl0 is brought up with
+# slattach_1m and the host side runs:
+#
+#   echo      slip_echo_server   ICMP ping RTT, TCP echo RTT on port 7777
+#   perf      slip_perf_server   slip_perf_client TCP blocks (TX/RX KB/s, RTT)
+#   udp       slip_perf_server   slip_perf_client -u stream (loss, RTT)
+#   iperf     iperf_server       iperf -r: host -> board, then board -> host,
+#                                CPU cycles/byte (5002)
+#   tcp_perf  tcp_perf_server    iperf to port 5001, checksum cycles/KB (5002);
+#                                board -> host zero-copy (5003) and copying
+#                                (5004): KB/s, tcp_write cycles/KB, cycles/byte
+#   http      slip_http_server   http_bench GET /: a connection per request,
+#                                keep-alive and pipelined (requests/s)
+#
+# Results go to build/bench_network/: results.txt (test metric value unit),
+# summary.json and summary.md. Tests whose host tool is missing (iperf)
+# are skipped and listed in the summary.
+#
+# -P cslip attaches sl0 with VJ header compression, which the lwIP port
+# answers in kind (slip_vj.c), and writes build/bench_network_cslip/:
+# run once with each protocol for the before/after of the small-packet
+# RTTs. Linux compresses its own TCP headers only with
+# net.ipv4.tcp_timestamps=0 (a changing option defeats CSLIP).
+#
+# Usage: scripts/bench_network.sh -p PORT [-b BAUD] [-d SECS] [-B BITSTREAM] [-P PROTO] [-n] [test...]
+#   -p PORT       Serial port of the board
+#   -b BAUD       UART bootloader baud rate for the upload (default 115200)
+#   -d SECS       Duration of each throughput test (default 10)
+#   -B BITSTREAM  Bitstream with the UART bootloader
+#                 (default build/ice40_picorv32.bin, rebuilt with SYNTH_BOOTLOADER=uart)
+#   -P PROTO      slattach_1m protocol: slip (default) or cslip
+#   -n            Reuse the firmware and bitstream from a previous run (no rebuild)
+#
+# slattach_1m and ifconfig need root: the script uses sudo unless run as
+# root. The TCP echo timing needs bash 5 (EPOCHREALTIME).
+
+set -e
+
+PORT=""
+BAUD=115200
+DURATION=10
+BITSTREAM=build/ice40_picorv32.bin
+REBUILD=1
+PROTO=slip
+MAKE=${MAKE:-make}
+
+while getopts "p:b:d:B:P:n" opt; do
+    case $opt in
+        p) PORT=$OPTARG ;;
+        b) BAUD=$OPTARG ;;
+        d) DURATION=$OPTARG ;;
+        B) BITSTREAM=$OPTARG ;;
+        P) PROTO=$OPTARG ;;
+        n) REBUILD=0 ;;
+        *) echo "Usage: $0 -p PORT [-b BAUD] [-d SECS] [-B BITSTREAM] [-P PROTO] [-n] [test...]"; exit 1 ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+TESTS="${*:-echo perf udp iperf tcp_perf http}"
+
+HOST_IP=192.168.100.1
+BOARD_IP=192.168.100.2
+SLIP_BAUD=1000000
+ECHO_COUNT=100
+PING_COUNT=50
+HTTP_COUNT=200
+HTTP_DEPTH=4
+
+case $PROTO in
+    slip)  OUT=build/bench_network ;;
+    cslip) OUT=build/bench_network_cslip ;;
+    *)     echo "ERROR: unknown protocol '$PROTO' (slip cslip)"; exit 1 ;;
+esac
+RESULTS=$OUT/results.txt
+UPLOAD=tools/uploader/fw_upload
+SLATTACH=tools/slattach_1m/slattach_1m
+CLIENT=tools/slip_perf_client/slip_perf_client
+HTTP_BENCH=tools/http_bench/http_bench
+
+SUDO=""
+if [ "$(id -u)" != "0" ]; then
+    SUDO=sudo
+fi
+
+# test -> firmware
+firmware_for() {
+    case $1 in
+        echo)     echo slip_echo_server ;;
+        perf|udp) echo slip_perf_server ;;
+        iperf)    echo iperf_server ;;
+        tcp_perf) echo tcp_perf_server ;;
+        http)     echo slip_http_server ;;
+        *)        return 1 ;;
+    esac
+}
+
+#------------------------------------------------------------------------------
+# Helpers
+#------------------------------------------------------------------------------
+
+# record <test> <metric> <value> <unit>
+record() {
+    [ -n "$3" ] || return 0
+    echo "$1 $2 $3 $4" >> "$RESULTS"
+    printf "  %-24s %12s %s\n" "$2" "$3" "$4"
+}
+
+skip() {
+    echo "$1 $2" >> "$OUT/skipped.txt"
+    echo "  - skipped: $2"
+}
+
+# Reset into the UART bootloader, upload the server, bring up sl0
+start_firmware() {
+    local fw=$1
+
+    iceprog "$BITSTREAM" > "$OUT/iceprog.log" 2>&1
+    sleep 2
+    "$UPLOAD" -p "$PORT" -b "$BAUD" "firmware/${fw}.bin" > "$OUT/upload_${fw}.log" 2>&1
+
+    $SUDO "$SLATTACH" -p "$PROTO" -s "$SLIP_BAUD" -L "$PORT" > "$OUT/slattach_${fw}.log" 2>&1 &
+    SLATTACH_PID=$!
+    sleep 1
+    $SUDO ifconfig sl0 "$HOST_IP" pointopoint "$BOARD_IP" up
+
+    # The lwIP port listens for an auto-baud request first (sio_open)
+    for _ in $(seq 20); do
+        if ping -c 1 -W 1 "$BOARD_IP" > /dev/null 2>&1; then
+            return 0
+        fi
+    done
+    echo "  ✗ $fw: no ping reply from $BOARD_IP"
+    stop_firmware
+    return 1
+}
+
+stop_firmware() {
+    if [ -n "$SLATTACH_PID" ]; then
+        $SUDO kill "$SLATTACH_PID" 2> /dev/null || true
+        wait "$SLATTACH_PID" 2> /dev/null || true
+        SLATTACH_PID=""
+    fi
+}
+trap stop_firmware EXIT
+
+# Median and mean of the microsecond samples on stdin, in ms: "p50 mean n"
+stats_ms() {
+    sort -n | awk '{ v[NR] = $1; sum += $1 }
+        END { if (NR) printf "%.2f %.2f %d\n", v[int((NR + 1) / 2)] / 1000, sum / NR / 1000, NR }'
+}
+
+# Value after "<key> " in the "min a ms, p50 b ms, ..." line of slip_perf_client
+rtt_field() {
+    sed -n "s/.* $1 \([0-9.]*\) ms.*/\1/p" | head -1
+}
+
+#------------------------------------------------------------------------------
+# Tests
+#------------------------------------------------------------------------------
+
+test_echo() {
+    local log=$OUT/echo.log line samples
+
+    ping -c "$PING_COUNT" -i 0.2 "$BOARD_IP" > "$log" 2>&1 || true
+    line=$(grep "min/avg/max" "$log" | sed 's/.* = //')
+    record echo icmp_rtt_min "$(echo "$line" | cut -d/ -f1)" ms
+    record echo icmp_rtt_avg "$(echo "$line" | cut -d/ -f2)" ms
+    record echo icmp_loss "$(sed -n 's/.* \([0-9.]*\)% packet loss.*/\1/p' "$log")" %
+
+    # One 64 byte line at a time, timed until the echo is back
+    samples=$OUT/echo_tcp.txt
+    : > "$samples"
+    if exec 4<> "/dev/tcp/$BOARD_IP/7777"; then
+        for ((i = 0; i < ECHO_COUNT; i++)); do
+            # Microseconds (bash 5), no subshell inside the timed part
+            local t0=${EPOCHREALTIME/[.,]/} t1
+            printf '%063d\n' "$i" >&4
+            read -r -t 5 line <&4 || break
+            t1=${EPOCHREALTIME/[.,]/}
+            echo $((t1 - t0)) >> "$samples"
+        done
+        exec 4<&-
+    fi
+    read -r p50 mean n < <(stats_ms < "$samples") || true
+    record echo tcp_rtt_p50 "$p50" ms
+    record echo tcp_rtt_avg "$mean" ms
+    record echo tcp_samples "$n" count
+}
+
+test_perf() {
+    local log=$OUT/perf.log
+
+    "$CLIENT" "$BOARD_IP" -d "$DURATION" -t 30 > "$log" 2>&1 || true
+    record perf tcp_tx "$(sed -n 's/^TX: .*, \([0-9.]*\) KB\/s)$/\1/p' "$log")" KB/s
+    record perf tcp_rx "$(sed -n 's/^RX: .*, \([0-9.]*\) KB\/s)$/\1/p' "$log")" KB/s
+    record perf tcp_errors "$(sed -n 's/^Errors: *\([0-9]*\)$/\1/p' "$log")" count
+    record perf block_rtt_p50 "$(grep -A1 "^Block RTT:" "$log" | rtt_field p50)" ms
+    record perf block_rtt_p99 "$(grep -A1 "^Block RTT:" "$log" | rtt_field p99)" ms
+}
+
+test_udp() {
+    local log=$OUT/udp.log
+
+    "$CLIENT" "$BOARD_IP" -u -d "$DURATION" > "$log" 2>&1 || true
+    record udp sent "$(sed -n 's/^Sent: .*(\([0-9.]*\) KB\/s).*/\1/p' "$log")" KB/s
+    record udp delivered "$(sed -n 's/^Delivered: .*(\([0-9.]*\) KB\/s)$/\1/p' "$log")" KB/s
+    record udp loss "$(sed -n 's/^Lost: .*(\([0-9.]*\)%)$/\1/p' "$log")" %
+    record udp reordered "$(sed -n 's/^Reordered: *\([0-9]*\)$/\1/p' "$log")" count
+    record udp rtt_p50 "$(grep -A1 "^RTT:" "$log" | rtt_field p50)" ms
+    record udp rtt_p99 "$(grep -A1 "^RTT:" "$log" | rtt_field p99)" ms
+}
+
+# Report of the stats port (5002) of iperf_server and tcp_perf_server,
+# appended to <log>; it resets the board's counters
+read_stats() {
+    local line
+
+    if exec 5<> "/dev/tcp/$BOARD_IP/5002"; then
+        while read -r -t 5 line <&5; do
+            echo "${line%$'\r'}"
+        done
+        exec 5<&-
+    fi | tee -a "$1"
+}
+
+# "cpu N.NN cycles/byte busy over N bytes"
+cpu_field() {
+    sed -n 's/^cpu \([0-9.]*\) cycles\/byte.*/\1/p'
+}
+
+# Kbits/sec of the n-th iperf result line
+iperf_kbps() {
+    sed -n 's/.* \([0-9.]*\) Kbits\/sec.*/\1/p' "$1" | sed -n "${2}p"
+}
+
+test_iperf() {
+    local log=$OUT/iperf.log
+
+    if ! command -v iperf > /dev/null; then
+        skip iperf "iperf (version 2) not installed"
+        return 0
+    fi
+    # -r: the board connects back for the second half (lwiperf tradeoff)
+    iperf -c "$BOARD_IP" -t "$DURATION" -r -f k > "$log" 2>&1 || true
+    record iperf to_board "$(iperf_kbps "$log" 1)" Kbit/s
+    record iperf from_board "$(iperf_kbps "$log" 2)" Kbit/s
+    record iperf cpu "$(read_stats "$log" | cpu_field)" cycles/byte
+}
+
+# Board -> host on <port> for DURATION seconds: <name> KB/s, tcp_write
+# cycles/KB and CPU cycles/byte from the report that follows
+tcp_perf_tx() {
+    local log=$OUT/tcp_perf.log stats
+
+    if exec 6< "/dev/tcp/$BOARD_IP/$2"; then
+        timeout "$DURATION" cat <&6 > /dev/null || true
+        exec 6<&-
+    fi
+    # "tx N bytes in N ms (N KB/s, zero-copy), tcp_write N cycles/KB"
+    stats=$(read_stats "$log")
+    record tcp_perf "from_board_$1" "$(echo "$stats" | sed -n 's/^tx .*(\([0-9]*\) KB\/s,.*/\1/p')" KB/s
+    record tcp_perf "tcp_write_$1" "$(echo "$stats" | sed -n 's/.*tcp_write \([0-9]*\) cycles\/KB.*/\1/p')" cycles/KB
+    record tcp_perf "cpu_tx_$1" "$(echo "$stats" | cpu_field)" cycles/byte
+}
+
+test_tcp_perf() {
+    local log=$OUT/tcp_perf.log stats
+
+    : > "$log"
+    if command -v iperf > /dev/null; then
+        iperf -c "$BOARD_IP" -p 5001 -t "$DURATION" -f k >> "$log" 2>&1 || true
+        record tcp_perf to_board "$(iperf_kbps "$log" 1)" Kbit/s
+
+        # "rx N bytes, checksum N bytes in N calls (N by DMA), N cycles/KB"
+        stats=$(read_stats "$log")
+        record tcp_perf checksum "$(echo "$stats" | sed -n 's/^rx .* \([0-9]*\) cycles\/KB.*/\1/p')" cycles/KB
+        record tcp_perf cpu_rx "$(echo "$stats" | cpu_field)" cycles/byte
+    else
+        skip tcp_perf "iperf (version 2) not installed: transmit tests only"
+        read_stats "$log" > /dev/null
+    fi
+
+    tcp_perf_tx zero_copy 5003
+    tcp_perf_tx copy 5004
+}
+
+# http_bench run: <name> <options>; records req/s, failed and p50 latency
+http_run() {
+    local name=$1 tag=${1%_}
+    local log=$OUT/http_${tag:-close}.log
+
+    shift
+    "$HTTP_BENCH" -n "$HTTP_COUNT" "$@" "$BOARD_IP" > "$log" 2>&1 || true
+    record http "${name}requests_per_sec" "$(sed -n 's/^Time: .*, \([0-9.]*\) req\/s,.*/\1/p' "$log")" req/s
+    record http "${name}failed" "$(sed -n 's/^Requests: .*, \([0-9]*\) failed,.*/\1/p' "$log")" count
+    record http "${name}latency_p50" "$(grep "^Latency:" "$log" | rtt_field p50)" ms
+}
+
+# A new connection per request, then keep-alive, then HTTP_DEPTH pipelined
+test_http() {
+    http_run ""
+    http_run keepalive_ -k
+    http_run pipelined_ -P "$HTTP_DEPTH"
+}
+
+#------------------------------------------------------------------------------
+# Build
+#------------------------------------------------------------------------------
+
+if [ -z "$PORT" ]; then
+    echo "ERROR: no serial port (-p PORT, or PORT=... for make bench-network)"
+    exit 1
+fi
+
+FIRMWARE=""
+for t in $TESTS; do
+    fw=$(firmware_for "$t") || { echo "ERROR: unknown test '$t' (echo perf udp iperf tcp_perf http)"; exit 1; }
+    case " $FIRMWARE " in
+        *" $fw "*) ;;
+        *) FIRMWARE="$FIRMWARE $fw" ;;
+    esac
+done
+
+if [ "$REBUILD" = "1" ]; then
+    $MAKE generate
+    for fw in $FIRMWARE; do
+        $MAKE -C firmware "$fw"
+    done
+    $MAKE SYNTH_BOOTLOADER=uart synth pnr pack
+fi
+
+for f in "$UPLOAD" "$SLATTACH" "$CLIENT" "$HTTP_BENCH"; do
+    if [ ! -x "$f" ]; then
+        echo "ERROR: $f not found. Run 'make upload-tool lwip-tools' first."
+        exit 1
+    fi
+done
+for fw in $FIRMWARE; do
+    if [ ! -f "firmware/${fw}.bin" ]; then
+        echo "ERROR: firmware/${fw}.bin not found."
+        exit 1
+    fi
+done
+if [ ! -f "$BITSTREAM" ]; then
+    echo "ERROR: $BITSTREAM not found (needs the UART bootloader: make SYNTH_BOOTLOADER=uart synth pnr pack)."
+    exit 1
+fi
+
+#------------------------------------------------------------------------------
+# Run
+#------------------------------------------------------------------------------
+
+mkdir -p "$OUT"
+: > "$RESULTS"
+: > "$OUT/skipped.txt"
+
+if [ "$PROTO" = "cslip" ] && [ "$(cat /proc/sys/net/ipv4/tcp_timestamps 2> /dev/null)" != "0" ]; then
+    echo "NOTE: TCP timestamps on: only the board's headers get compressed"
+    echo "      (sudo sysctl net.ipv4.tcp_timestamps=0 for both directions)"
+fi
+
+for t in $TESTS; do
+    fw=$(firmware_for "$t")
+    echo ""
+    echo "========================================="
+    echo "$t ($fw)"
+    echo "========================================="
+    if start_firmware "$fw"; then
+        "test_$t"
+        stop_firmware
+    else
+        skip "$t" "$fw did not come up"
+    fi
+done
+
+#------------------------------------------------------------------------------
+# Summary
+#------------------------------------------------------------------------------
+
+COMMIT=$(git rev-parse --short HEAD 2> /dev/null || echo unknown)
+DATE=$(date -u +%Y-%m-%dT%H:%M:%SZ)
+
+awk -v commit="$COMMIT" -v date="$DATE" -v secs="$DURATION" -v baud="$SLIP_BAUD" \
+    -v proto="$PROTO" -v skipped="$OUT/skipped.txt" '
+    { test[NR] = $1; metric[NR] = $2; value[NR] = $3; unit[NR] = $4 }
+    END {
+        printf "{\n  \"commit\": \"%s\",\n  \"date\": \"%s\",\n", commit, date
+        printf "  \"duration_sec\": %s,\n  \"slip_baud\": %s,\n", secs, baud
+        printf "  \"protocol\": \"%s\",\n  \"results\": {", proto
+        for (i = 1; i <= NR; i++) {
+            if (i == 1 || test[i] != test[i - 1])
+                printf "%s\n    \"%s\": {", (i > 1 ? "\n    }," : ""), test[i]
+            else
+                printf ","
+            printf "\n      \"%s\": { \"value\": %s, \"unit\": \"%s\" }", metric[i], value[i], unit[i]
+        }
+        printf "%s},\n  \"skipped\": [", (NR ? "\n    }\n  " : "")
+        n = 0
+        while ((getline l < skipped) > 0) {
+            name = l
+            sub(/ .*/, "", name)
+            sub(/^[^ ]* /, "", l)
+            printf "%s\n    { \"test\": \"%s\", \"reason\": \"%s\" }", (n++ ? "," : ""), name, l
+        }
+        printf "%s]\n}\n", (n ? "\n  " : "")
+    }' "$RESULTS" > "$OUT/summary.json"
+
+{
+    echo "# Network benchmark ($COMMIT, $DATE)"
+    echo ""
+    echo "${PROTO^^} at $SLIP_BAUD baud, ${DURATION} s per throughput test."
+    echo ""
+    echo "| Test | Metric | Value | Unit |"
+    echo "|------|--------|------:|------|"
+    awk '{ printf "| %s | %s | %s | %s |\n", $1, $2, $3, $4 }' "$RESULTS"
+    if [ -s "$OUT/skipped.txt" ]; then
+        echo ""
+        echo "Skipped:"
+        sed 's/^\([^ ]*\) \(.*\)$/- \1: \2/' "$OUT/skipped.txt"
+    fi
+} > "$OUT/summary.md"
+
+echo ""
+cat "$OUT/summary.md"
+echo ""
+echo "Summary: $OUT/summary.json, $OUT/summary.md"
@@ -0,0 +1,219 @@
+#!/bin/bash
+# Benchmark matrix: build profiles x firmware benchmarks
+#
+# For every profile in configs/profiles/ (or the ones named on the command
+# line) this builds a bitstream with the UART bootloader, programs it with
+# iceprog, uploads mandelbrot_fixed, mandelbrot_float, math_test, algo_test,
+# math_bench, memops_bench, mem_bench, coremark and dhrystone with fw_upload,
+# drives their menus over the serial port and collects the
+#   PERF <name> iters=<n> cyc_per_iter=<n>
+#   SCORE <metric> <value>
+# lines they print. The report puts nextpnr logic-cell and EBR usage next
+# to the cycles per iteration of each benchmark, then the standard scores
+# (CoreMark/MHz, DMIPS/MHz) of each profile.
+#
+# Usage: scripts/bench_profiles.sh [-p PORT] [-b BAUD] [-n] [profile...]
+#   -p PORT   Serial port of the board. Without it only area/fmax is reported.
+#   -b BAUD   UART baud rate (default 115200)
+#   -n        Reuse build/profiles/<name>/ from a previous run (no rebuild)
+
+set -e
+
+PORT=""
+BAUD=115200
+REBUILD=1
+MAKE=${MAKE:-make}
+
+while getopts "p:b:n" opt; do
+    case $opt in
+        p) PORT=$OPTARG ;;
+        b) BAUD=$OPTARG ;;
+        n) REBUILD=0 ;;
+        *) echo "Usage: $0 [-p PORT] [-b BAUD] [-n] [profile...]"; exit 1 ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+PROFILES="$*"
+if [ -z "$PROFILES" ]; then
+    PROFILES=$(ls configs/profiles/*.config | xargs -n1 basename | sed 's/\.config$//')
+fi
+
+BENCHMARKS="mandelbrot_fixed mandelbrot_float math_test algo_test math_bench memops_bench mem_bench coremark dhrystone"
+RESULTS=build/profiles/results.txt
+SCORES=build/profiles/scores.txt
+UPLOAD=tools/uploader/fw_upload
+
+#------------------------------------------------------------------------------
+# Serial helpers
+#------------------------------------------------------------------------------
+
+# Raw mode, no echo (GNU stty -F, BSD/macOS stty -f)
+port_raw() {
+    stty -F "$PORT" "$BAUD" raw -echo 2>/dev/null || stty -f "$PORT" "$BAUD" raw -echo
+}
+
+# send <string>
+send() {
+    printf '%s' "$1" >&3
+}
+
+# collect <profile> <done-marker> <timeout-seconds>
+# Append PERF lines to $RESULTS (SCORE lines to $SCORES) until a line
+# starting with the marker arrives
+collect() {
+    local profile=$1 marker=$2 limit=$3 line
+    while IFS= read -r -t "$limit" line <&3; do
+        line=${line%$'\r'}
+        case "$line" in
+            PERF\ *) echo "$profile ${line#PERF }" >> "$RESULTS"; echo "  $line" ;;
+            SCORE\ *) echo "$profile ${line#SCORE }" >> "$SCORES"; echo "  $line" ;;
+        esac
+        case "$line" in
+            "$marker"*) return 0 ;;
+        esac
+    done
+    echo "  ✗ Timed out waiting for '$marker'"
+    return 1
+}
+
+# run_benchmark <profile> <firmware>
+run_benchmark() {
+    local profile=$1 fw=$2
+
+    # Hold the port open across the upload so no output is lost
+    port_raw
+    exec 3<>"$PORT"
+    "$UPLOAD" -p "$PORT" -b "$BAUD" "firmware/${fw}.bin" > /dev/null
+    port_raw
+    sleep 1
+
+    case $fw in
+        mandelbrot_fixed)
+            # Start, let the first frame render (terminal query times out), quit
+            send " "; sleep 5; send "q"
+            collect "$profile" "Performance:" 120 ;;
+        mandelbrot_float)
+            # First frame, F for the other kernel (soft-float takes longest), quit
+            send " "; sleep 5; send "f"; sleep 30; send "q"
+            collect "$profile" "Performance:" 120 ;;
+        math_test)
+            # Press-any-key, then 7 = stress test
+            send " "; sleep 1; send "7"
+            collect "$profile" "PASS (no crashes)" 300 ;;
+        algo_test)
+            # Press-any-key, then 6 = combined stress test
+            send " "; sleep 1; send "6"
+            collect "$profile" "Combined stress test complete" 300 ;;
+        math_bench)
+            # Press-any-key runs every kernel in float, double and Q16.16
+            send " "
+            collect "$profile" "Benchmark complete" 300 ;;
+        memops_bench)
+            # Press-any-key verifies, then times every routine 4 B - 64 KB
+            send " "
+            collect "$profile" "Benchmark complete" 300 ;;
+        mem_bench)
+            # Press-any-key times every region and width, then the strides
+            send " "
+            collect "$profile" "Benchmark complete" 300 ;;
+        coremark|dhrystone)
+            # Run at start-up (CoreMark calibrates to at least 10 s)
+            collect "$profile" "Benchmark complete" 300 ;;
+    esac
+    local rc=$?
+
+    exec 3<&-
+    return $rc
+}
+
+#------------------------------------------------------------------------------
+# Build + run
+#------------------------------------------------------------------------------
+
+if [ -n "$PORT" ]; then
+    if [ ! -x "$UPLOAD" ]; then
+        echo "ERROR: $UPLOAD not found. Run 'make upload-tool' first."
+        exit 1
+    fi
+    for fw in $BENCHMARKS; do
+        if [ ! -f "firmware/${fw}.bin" ]; then
+            echo "ERROR: firmware/${fw}.bin not found. Run 'make firmware-newlib fw-coremark' first."
+            exit 1
+        fi
+    done
+fi
+
+mkdir -p build/profiles
+: > "$RESULTS"
+: > "$SCORES"
+
+for p in $PROFILES; do
+    if [ "$REBUILD" = "1" ]; then
+        BOOTLOADER=uart ./scripts/build_profile.sh "$p"
+    fi
+
+    if [ -n "$PORT" ]; then
+        echo ""
+        echo "========================================="
+        echo "Benchmarking profile: $p"
+        echo "========================================="
+        iceprog "build/ice40_picorv32_${p}.bin"
+        sleep 2
+        for fw in $BENCHMARKS; do
+            echo "$fw:"
+            run_benchmark "$p" "$fw" || true
+        done
+    fi
+done
+
+#------------------------------------------------------------------------------
+# Report
+#------------------------------------------------------------------------------
+
+echo ""
+echo "========================================="
+echo "Profile Comparison"
+echo "========================================="
+printf "%-10s %-16s %-10s %-10s\n" "Profile" "Logic cells" "EBR" "Fmax (MHz)"
+for p in $PROFILES; do
+    LOG="build/profiles/${p}/build.log"
+    LC=$(awk '/ICESTORM_LC:/ { v = $3 "" $4 } END { print v }' "$LOG" 2>/dev/null)
+    RAM=$(awk '/ICESTORM_RAM:/ { v = $3 "" $4 } END { print v }' "$LOG" 2>/dev/null)
+    FMAX=$(grep "Max frequency for clock" "$LOG" 2>/dev/null | tail -1 | sed -E 's/.*: *([0-9.]+) MHz.*/\1/')
+    printf "%-10s %-16s %-10s %-10s\n" "$p" "${LC:-?}" "${RAM:-?}" "${FMAX:-?}"
+done
+
+if [ -s "$RESULTS" ]; then
+    echo ""
+    printf "%-20s" "Cycles/iteration"
+    for p in $PROFILES; do printf " %12s" "$p"; done
+    echo ""
+    for name in $(awk '{ print $2 }' "$RESULTS" | awk '!seen[$0]++'); do
+        printf "%-20s" "$name"
+        for p in $PROFILES; do
+            CPI=$(awk -v p="$p" -v n="$name" '$1 == p && $2 == n {
+                      for (i = 3; i <= NF; i++) if ($i ~ /^cyc_per_iter=/) { sub(/^cyc_per_iter=/, "", $i); v = $i } }
+                  END { print v }' "$RESULTS")
+            printf " %12s" "${CPI:--}"
+        done
+        echo ""
+    done
+    echo ""
+    echo "Raw results: $RESULTS"
+fi
+
+if [ -s "$SCORES" ]; then
+    echo ""
+    printf "%-20s" "Score"
+    for p in $PROFILES; do printf " %12s" "$p"; done
+    echo ""
+    for name in $(awk '{ print $2 }' "$SCORES" | awk '!seen[$0]++'); do
+        printf "%-20s" "$name"
+        for p in $PROFILES; do
+            V=$(awk -v p="$p" -v n="$name" '$1 == p && $2 == n { v = $3 } END { print v }' "$SCORES")
+            printf " %12s" "${V:--}"
+        done
+        echo ""
+    done
+fi
@@ -0,0 +1,77 @@
+#!/bin/bash
+# Boot ROM swap: new bootloader contents in a placed and routed bitstream
+#
+# The bootloader ROM (hdl/bootloader_rom.v, 2048 x 32 bits) is sixteen
+# SB_RAM40_4K blocks whose contents are only initialization bits in the
+# .asc. icebram rewrites them in place, so a bootloader change needs no
+# synthesis or place and route: seconds instead of minutes.
+#
+# icebram finds the blocks by their current contents, which must be unique:
+# the base bitstream is built once with a random ROM image (icebram -g)
+# instead of a bootloader, whose zero-filled end would match many blocks.
+#
+#   make bootrom-base     random image, synth + pnr once (build/bootrom_base.asc)
+#   make bootrom-swap     bootloader.hex.selected into a copy of the base,
+#                         -> build/ice40_picorv32.asc and .bin
+#
+# Rerun bootrom-base after any HDL or Kconfig change; a swap only
+# replaces the ROM contents.
+#
+# Usage: scripts/bootrom_swap.sh -g         (new random image for the base)
+#        scripts/bootrom_swap.sh [file.hex]  (default bootloader/bootloader.hex.selected)
+
+set -e
+
+WORDS=2048
+SEED_HEX=build/bootrom_seed.hex
+BASE_ASC=build/bootrom_base.asc
+ROM_HEX=build/bootrom.hex
+ASC=build/ice40_picorv32.asc
+BIN=build/ice40_picorv32.bin
+
+ICEBRAM=icebram
+ICEPACK=icepack
+if [ -f downloads/oss-cad-suite/bin/icebram ]; then
+    ICEBRAM=downloads/oss-cad-suite/bin/icebram
+    ICEPACK=downloads/oss-cad-suite/bin/icepack
+fi
+
+if ! command -v "$ICEBRAM" >/dev/null 2>&1; then
+    echo "ERROR: icebram not found (IceStorm tools)"
+    exit 1
+fi
+
+mkdir -p build
+
+if [ "$1" = "-g" ]; then
+    "$ICEBRAM" -g 32 $WORDS > "$SEED_HEX"
+    echo "✓ Random ROM image for the base bitstream: $SEED_HEX"
+    exit 0
+fi
+
+HEX=${1:-bootloader/bootloader.hex.selected}
+
+if [ ! -f "$BASE_ASC" ] || [ ! -f "$SEED_HEX" ]; then
+    echo "ERROR: no base bitstream ($BASE_ASC). Run 'make bootrom-base' first."
+    exit 1
+fi
+if [ ! -f "$HEX" ]; then
+    echo "ERROR: $HEX not found"
+    exit 1
+fi
+
+# $readmemh image (an @00000000 line, one word a line) as icebram reads it:
+# exactly WORDS words, the rest of the ROM zero
+awk -v n=$WORDS '
+    /^@/ || NF == 0 { next }
+    { print; w++ }
+    END {
+        if (w > n) { print "ERROR: " w " words, the ROM holds " n > "/dev/stderr"; exit 1 }
+        while (w++ < n) print "00000000"
+    }' "$HEX" > "$ROM_HEX"
+
+"$ICEBRAM" "$SEED_HEX" "$ROM_HEX" < "$BASE_ASC" > "$ASC.tmp"
+mv "$ASC.tmp" "$ASC"
+"$ICEPACK" "$ASC" "$BIN"
+
+echo "✓ Boot ROM replaced: $(readlink -f "$HEX" 2>/dev/null || echo "$HEX") -> $BIN"
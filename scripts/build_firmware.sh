@@ -90,6 +90,8 @@ if [ "$USE_NEWLIB" = "1" ]; then
 
     CFLAGS="$CFLAGS --sysroot=$SYSROOT"
     LDFLAGS="$LDFLAGS --sysroot=$SYSROOT -static"
+    # Allocator call counters in syscalls.c (lib/mem_stats.h)
+    LDFLAGS="$LDFLAGS -Wl,--wrap=_malloc_r,--wrap=_free_r,--wrap=_realloc_r"
     LIBS="lib/syscalls.c $LIBS -lc -lm"
 
     # Add extra object files
@@ -43,6 +43,12 @@ if [ ! -d "$NEWLIB_SRC" ]; then
     git clone --depth 1 ${CONFIG_NEWLIB_REPO:-https://sourceware.org/git/newlib-cygwin.git} "$NEWLIB_SRC"
 fi
 
+# Reconfigure from scratch when the ISA changed (Kconfig COMPRESSED_ISA)
+if [ -f "$NEWLIB_BUILD/.march" ] && [ "$(cat "$NEWLIB_BUILD/.march")" != "$ARCH" ]; then
+    echo "ISA changed ($(cat "$NEWLIB_BUILD/.march") -> $ARCH), cleaning previous build..."
+    rm -rf "$NEWLIB_BUILD"
+fi
+
 # Create build directory
 mkdir -p "$NEWLIB_BUILD"
 mkdir -p "$NEWLIB_INSTALL"
@@ -79,6 +85,7 @@ if [ ! -f Makefile ]; then
         --disable-multilib \
         $CONFIG_OPTS \
         CFLAGS_FOR_TARGET="$CFLAGS_FOR_TARGET"
+    echo "$ARCH" > .march
 fi
 
 # Build newlib
@@ -91,6 +98,7 @@ make -j$NPROC
 echo ""
 echo "Installing newlib..."
 make install
+echo "$ARCH" > ../../$NEWLIB_INSTALL/.march     # checked by firmware/Makefile
 
 echo ""
 echo "========================================="
@@ -95,6 +95,7 @@ make -j$NPROC
 echo ""
 echo "Installing PIC newlib..."
 make install
+echo "$ARCH" > ../../$NEWLIB_INSTALL_PIC/.march     # checked by Makefile.overlay
 
 echo ""
 echo "========================================="
@@ -1,6 +1,6 @@
 #!/bin/bash
 # Build additional libraries with -fPIC for overlay use
-# Builds: incurses, microrl
+# Builds: incurses, microrl, fixmath, memops
 
 set -e
 
@@ -83,6 +83,52 @@ ls -lh $SYSROOT_PIC/riscv64-unknown-elf/lib/libmicrorl.a
 cp $LIB_DIR/microrl/microrl.h $SYSROOT_PIC/riscv64-unknown-elf/include/
 echo "✓ microrl.h installed"
 
+#==============================================================================
+# Build fixmath library
+#==============================================================================
+
+echo ""
+echo "Building fixmath..."
+echo "-------------------"
+
+riscv64-unknown-elf-gcc $CFLAGS \
+    -I$LIB_DIR/fixmath \
+    -c $LIB_DIR/fixmath/fixmath.c \
+    -o $BUILD_DIR/fixmath.o
+
+# Empty without the M extension (fixmath.c then has the C versions)
+riscv64-unknown-elf-gcc $CFLAGS \
+    -c $LIB_DIR/fixmath/fixmath_rv32.S \
+    -o $BUILD_DIR/fixmath_rv32.o
+
+riscv64-unknown-elf-ar rcs $SYSROOT_PIC/riscv64-unknown-elf/lib/libfixmath.a \
+    $BUILD_DIR/fixmath.o $BUILD_DIR/fixmath_rv32.o
+
+echo "✓ libfixmath.a created"
+ls -lh $SYSROOT_PIC/riscv64-unknown-elf/lib/libfixmath.a
+
+# Copy header
+cp $LIB_DIR/fixmath/fixmath.h $SYSROOT_PIC/riscv64-unknown-elf/include/
+echo "✓ fixmath.h installed"
+
+#==============================================================================
+# Build memops library (memcpy/memmove/memset/strlen, linked ahead of -lc)
+#==============================================================================
+
+echo ""
+echo "Building memops..."
+echo "------------------"
+
+riscv64-unknown-elf-gcc $CFLAGS \
+    -c $LIB_DIR/memops/memops_rv32.S \
+    -o $BUILD_DIR/memops_rv32.o
+
+riscv64-unknown-elf-ar rcs $SYSROOT_PIC/riscv64-unknown-elf/lib/libmemops.a \
+    $BUILD_DIR/memops_rv32.o
+
+echo "✓ libmemops.a created"
+ls -lh $SYSROOT_PIC/riscv64-unknown-elf/lib/libmemops.a
+
 #==============================================================================
 # Summary
 #==============================================================================
@@ -93,11 +139,12 @@ echo "✓ Overlay libraries built successfully"
 echo "========================================="
 echo ""
 echo "Installed libraries:"
-ls -lh $SYSROOT_PIC/riscv64-unknown-elf/lib/lib{incurses,microrl}.a
+ls -lh $SYSROOT_PIC/riscv64-unknown-elf/lib/lib{incurses,microrl,fixmath,memops}.a
 echo ""
 echo "Installed headers:"
-ls -lh $SYSROOT_PIC/riscv64-unknown-elf/include/{curses,microrl}.h
+ls -lh $SYSROOT_PIC/riscv64-unknown-elf/include/{curses,microrl,fixmath}.h
 echo ""
-echo "You can now build overlays with incurses/microrl support!"
-echo "Link with: -lincurses -lmicrorl"
+echo "You can now build overlays with incurses/microrl/fixmath support!"
+echo "Link with: -lincurses -lmicrorl -lfixmath"
+echo "(Makefile.overlay puts -lmemops ahead of -lc by itself)"
 echo ""
@@ -0,0 +1,69 @@
+#!/bin/bash
+# Build a bitstream for one configs/profiles/<name>.config profile
+#
+# The profile fragment is layered over the current .config (every symbol it
+# mentions replaces the base setting), the normal synth/pnr/pack flow runs,
+# and .config is restored afterwards. Results:
+#   build/ice40_picorv32_<name>.bin
+#   build/profiles/<name>/config        merged configuration
+#   build/profiles/<name>/build.log     yosys + nextpnr output (utilisation)
+#
+# Set BOOTLOADER=uart to embed the UART bootloader instead of the SD one
+# (needed to upload benchmark firmware with fw_upload).
+
+set -e
+set -o pipefail
+
+if [ -z "$1" ]; then
+    echo "Usage: $0 <profile | fragment.config>"
+    echo "Profiles: $(ls configs/profiles/*.config 2>/dev/null | xargs -n1 basename | sed 's/\.config$//' | tr '\n' ' ')"
+    exit 1
+fi
+
+# Either a profile name or a path to a fragment (scripts/timing_sweep.sh)
+if [ -f "$1" ]; then
+    FRAGMENT=$1
+    PROFILE=$(basename "$1" .config)
+else
+    PROFILE=$1
+    FRAGMENT="configs/profiles/${PROFILE}.config"
+fi
+OUT="build/profiles/${PROFILE}"
+MAKE=${MAKE:-make}
+
+if [ ! -f "$FRAGMENT" ]; then
+    echo "ERROR: $FRAGMENT not found"
+    exit 1
+fi
+
+if [ ! -f .config ]; then
+    echo "ERROR: .config not found. Run 'make menuconfig' or 'make defconfig' first."
+    exit 1
+fi
+
+mkdir -p "$OUT"
+cp .config "$OUT/base.config"
+trap 'cp "$OUT/base.config" .config' EXIT
+
+# Drop every symbol the fragment sets (either form), then append it
+SYMS=$(grep -oE '^(# )?CONFIG_[A-Za-z0-9_]+' "$FRAGMENT" | sed 's/^# //' | sort -u | paste -sd'|' -)
+grep -vE "^(# )?(${SYMS})(=| is not set)" "$OUT/base.config" > "$OUT/config" || true
+cat "$FRAGMENT" >> "$OUT/config"
+cp "$OUT/config" .config
+
+echo "========================================="
+echo "Build profile: ${PROFILE}"
+echo "========================================="
+grep -E '^(# )?CONFIG_' "$FRAGMENT" | sed 's/^/  /'
+echo ""
+
+$MAKE --no-print-directory SYNTH_BOOTLOADER=${BOOTLOADER:-sdcard} synth pnr pack 2>&1 | tee "$OUT/build.log"
+
+cp build/ice40_picorv32.bin "build/ice40_picorv32_${PROFILE}.bin"
+cp build/ice40_picorv32.asc "$OUT/ice40_picorv32.asc"
+
+echo ""
+echo "✓ Profile ${PROFILE}: build/ice40_picorv32_${PROFILE}.bin"
+for key in 'ICESTORM_LC:' 'ICESTORM_RAM:' 'Max frequency for clock'; do
+    grep "$key" "$OUT/build.log" | tail -1 | sed 's/^Info: */  /'
+done
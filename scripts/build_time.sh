@@ -0,0 +1,108 @@
+#!/bin/bash
+# Wall-clock time of the firmware build (make build-time)
+#
+# Times 'make firmware' (every firmware target, the overlay SDK projects)
+# from clean objects, serially as before and with make -j (objects of each
+# target, the lwIP/FreeRTOS sources and the overlay projects in parallel),
+# then again with nothing to do (generate no longer reruns per target).
+# With ccache installed the clean -j build is timed twice more through it,
+# from an empty and from a warm cache (CCACHE=1, a cache of its own in
+# build/build_time/ccache). -b adds 'make bitstream' from scratch and
+# again with nothing changed (yosys and nextpnr skipped).
+#
+# Usage: scripts/build_time.sh [-b] [-j JOBS]
+#   -b        Also time the bitstream
+#   -j JOBS   Parallel jobs (default: nproc)
+
+set -e
+
+BITSTREAM=0
+JOBS=$(nproc 2>/dev/null || sysctl -n hw.ncpu 2>/dev/null || echo 4)
+MAKE=${MAKE:-make}
+
+while getopts "bj:" opt; do
+    case $opt in
+        b) BITSTREAM=1 ;;
+        j) JOBS=$OPTARG ;;
+        *) echo "Usage: $0 [-b] [-j JOBS]"; exit 1 ;;
+    esac
+done
+
+OUT=build/build_time
+RESULTS=$OUT/results.txt
+mkdir -p "$OUT"
+: > "$RESULTS"
+
+# As scripts/opt_report.sh: nothing built before is reused
+clean_objects() {
+    $MAKE -C firmware clean > /dev/null
+    find firmware/sd_fatfs firmware/overlay_sdk/projects lib/inflate \
+         -name '*.o' -delete 2>/dev/null || true
+}
+
+# measure <name> <make arguments...>: wall clock in seconds to results
+measure() {
+    local name=$1 t
+    shift
+    echo "--- $name: $MAKE $* ---"
+    TIMEFORMAT=%R
+    if ! t=$( { time $MAKE "$@" > "$OUT/$name.log" 2>&1; } 2>&1 ); then
+        echo "✗ $name failed, see $OUT/$name.log"
+        exit 1
+    fi
+    echo "$name $t" >> "$RESULTS"
+    echo "  ${t} s"
+}
+
+$MAKE generate > /dev/null
+
+clean_objects
+measure serial firmware -j1
+
+clean_objects
+measure parallel firmware -j"$JOBS"
+
+measure noop firmware -j"$JOBS"
+
+if command -v ccache >/dev/null 2>&1; then
+    export CCACHE_DIR=$PWD/$OUT/ccache
+    rm -rf "$CCACHE_DIR"
+    clean_objects
+    measure ccache_cold firmware -j"$JOBS" CCACHE=1
+    clean_objects
+    measure ccache_warm firmware -j"$JOBS" CCACHE=1
+else
+    echo "(ccache not installed: no ccache runs)"
+fi
+
+if [ "$BITSTREAM" = "1" ]; then
+    rm -f build/ice40_picorv32.json build/ice40_picorv32.asc build/ice40_picorv32.bin
+    measure bitstream bitstream
+    measure bitstream_noop bitstream
+fi
+
+# Leave the objects of a normal build
+clean_objects
+
+#------------------------------------------------------------------------------
+# Report
+#------------------------------------------------------------------------------
+
+echo ""
+echo "========================================="
+echo "Build wall clock (make -j$JOBS vs serial)"
+echo "========================================="
+awk '
+    { t[$1] = $2; order[++n] = $1 }
+    END {
+        printf "%-16s %10s %10s\n", "Build", "Seconds", "vs serial"
+        for (i = 1; i <= n; i++) {
+            k = order[i]
+            printf "%-16s %10.1f", k, t[k]
+            if (k !~ /^bitstream/ && t["serial"] > 0)
+                printf " %9.1fx", t["serial"] / (t[k] > 0 ? t[k] : 0.01)
+            printf "\n"
+        }
+    }' "$RESULTS"
+echo ""
+echo "Logs: $OUT/<build>.log"
@@ -31,6 +31,10 @@ if [ "${CONFIG_ENABLE_MUL}" = "y" ]; then
     echo "\`define ENABLE_MUL" >> build/generated/config.vh
 fi
 
+if [ "${CONFIG_ENABLE_FAST_MUL}" = "y" ]; then
+    echo "\`define ENABLE_FAST_MUL" >> build/generated/config.vh
+fi
+
 if [ "${CONFIG_ENABLE_DIV}" = "y" ]; then
     echo "\`define ENABLE_DIV" >> build/generated/config.vh
 fi
@@ -39,6 +43,153 @@ if [ "${CONFIG_BARREL_SHIFTER}" = "y" ]; then
     echo "\`define BARREL_SHIFTER" >> build/generated/config.vh
 fi
 
+if [ "${CONFIG_TWO_STAGE_SHIFT}" = "y" ]; then
+    echo "\`define TWO_STAGE_SHIFT" >> build/generated/config.vh
+fi
+
+if [ "${CONFIG_REGS_DUALPORT}" = "y" ]; then
+    echo "\`define REGS_DUALPORT" >> build/generated/config.vh
+fi
+
+if [ "${CONFIG_PCPI_FPU}" = "y" ]; then
+    echo "\`define PCPI_FPU" >> build/generated/config.vh
+fi
+
+if [ "${CONFIG_CATCH_ILLINSN}" = "y" ]; then
+    echo "\`define CATCH_ILLINSN" >> build/generated/config.vh
+fi
+
+if [ "${CONFIG_ENABLE_COUNTERS}" = "y" ]; then
+    echo "\`define ENABLE_COUNTERS" >> build/generated/config.vh
+fi
+
+if [ "${CONFIG_ENABLE_COUNTERS64}" = "y" ]; then
+    echo "\`define ENABLE_COUNTERS64" >> build/generated/config.vh
+fi
+
+if [ "${CONFIG_ICACHE}" = "y" ]; then
+    echo "\`define ENABLE_ICACHE" >> build/generated/config.vh
+    echo "\`define ICACHE_SIZE ${CONFIG_ICACHE_SIZE:-2048}" >> build/generated/config.vh
+fi
+
+if [ "${CONFIG_DCACHE}" = "y" ]; then
+    echo "\`define ENABLE_DCACHE" >> build/generated/config.vh
+    echo "\`define DCACHE_SIZE ${CONFIG_DCACHE_SIZE:-2048}" >> build/generated/config.vh
+fi
+
+if [ "${CONFIG_MEM_LOOKAHEAD}" = "y" ]; then
+    echo "\`define ENABLE_MEM_LOOKAHEAD" >> build/generated/config.vh
+fi
+
+echo "\`define SCRATCHPAD_SIZE ${CONFIG_SCRATCHPAD_SIZE:-4096}" >> build/generated/config.vh
+
+if [ "${CONFIG_DUAL_CORE}" = "y" ]; then
+    CORE1_RESET_ADDR=${CONFIG_CORE1_RESET_ADDR:-0x00060000}
+    echo "\`define DUAL_CORE" >> build/generated/config.vh
+    echo "\`define CORE1_RESET_ADDR 32'h${CORE1_RESET_ADDR#0x}" >> build/generated/config.vh
+fi
+echo "\`define SPI_FIFO_DEPTH ${CONFIG_SPI_FIFO_DEPTH:-128}" >> build/generated/config.vh
+echo "\`define UART_RX_BUF_SIZE ${CONFIG_UART_RX_BUF_SIZE:-512}" >> build/generated/config.vh
+
+if [ "${CONFIG_SPI_HW_CRC}" = "y" ]; then
+    echo "\`define SPI_HW_CRC" >> build/generated/config.vh
+fi
+
+if [ "${CONFIG_SPI1_MASTER}" = "y" ]; then
+    echo "\`define SPI1_MASTER" >> build/generated/config.vh
+    if [ "${CONFIG_SPI1_STREAM}" = "y" ]; then
+        echo "\`define SPI1_STREAM" >> build/generated/config.vh
+    fi
+fi
+
+if [ "${CONFIG_SLIP_CODEC}" = "y" ]; then
+    echo "\`define SLIP_CODEC" >> build/generated/config.vh
+    echo "\`define SLIP_CODEC_BUF_SIZE ${CONFIG_SLIP_CODEC_BUF_SIZE:-2048}" >> build/generated/config.vh
+fi
+
+if [ "${CONFIG_HW_LOADER}" = "y" ]; then
+    echo "\`define HW_LOADER" >> build/generated/config.vh
+fi
+
+if [ "${CONFIG_FLASH_XIP}" = "y" ]; then
+    echo "\`define FLASH_XIP" >> build/generated/config.vh
+    if [ "${CONFIG_FLASH_XIP_DUAL}" = "y" ]; then
+        echo "\`define FLASH_XIP_DUAL" >> build/generated/config.vh
+    fi
+fi
+
+if [ "${CONFIG_CONSOLE_UART}" = "y" ]; then
+    echo "\`define CONSOLE_UART" >> build/generated/config.vh
+fi
+
+if [ "${CONFIG_ATOMIC_UNIT}" = "y" ]; then
+    echo "\`define ATOMIC_UNIT" >> build/generated/config.vh
+fi
+
+# Blocks built in by default; only an explicit "is not set" prunes them,
+# so a .config from before the option keeps them
+if grep -q "^# CONFIG_PERIPHERAL_PMU is not set" .config; then
+    echo "\`define NO_PMU" >> build/generated/config.vh
+fi
+
+if grep -q "^# CONFIG_PERIPHERAL_CRC32 is not set" .config; then
+    echo "\`define NO_CRC32_ACCEL" >> build/generated/config.vh
+fi
+
+if grep -q "^# CONFIG_PERIPHERAL_WATCHDOG is not set" .config; then
+    echo "\`define NO_WATCHDOG" >> build/generated/config.vh
+fi
+
+if [ "${CONFIG_PC_SAMPLER}" = "y" ]; then
+    echo "\`define PC_SAMPLER" >> build/generated/config.vh
+    echo "\`define PC_SAMPLER_DEPTH ${CONFIG_PC_SAMPLER_DEPTH:-512}" >> build/generated/config.vh
+fi
+
+# System clock: EXTCLK (100 MHz) / 2, or SB_PLL40_CORE
+# PLL settings as computed by icepll: DIVR DIVF DIVQ FILTER_RANGE
+SYS_CLK_HZ=${CONFIG_SYS_CLK_HZ:-50000000}
+case "${SYS_CLK_HZ}" in
+    50000000) PLL="" ;;
+    60000000) PLL="4 47 4 2" ;;     # PFD 20.00 MHz, VCO  960.0 MHz
+    65972222) PLL="8 94 4 1" ;;     # PFD 11.11 MHz, VCO 1055.6 MHz
+    75000000) PLL="0 5 3 5" ;;      # PFD 100.0 MHz, VCO  600.0 MHz
+    *)
+        echo "ERROR: no PLL settings for CONFIG_SYS_CLK_HZ=${SYS_CLK_HZ}"
+        exit 1
+        ;;
+esac
+
+echo "\`define SYS_CLK_HZ ${SYS_CLK_HZ}" >> build/generated/config.vh
+
+# SRAM timing profile against the clock: every profile captures read data
+# one clock after the address changes (tAA + I/O delays within a period).
+# The 1-cycle profiles have no other margin left, so they are refused.
+SRAM_TIMING=${CONFIG_SRAM_TIMING:-0}
+SRAM_TAA_NS=${CONFIG_SRAM_TAA_NS:-10}
+SRAM_IO_NS=${CONFIG_SRAM_IO_NS:-7}
+PERIOD_PS=$((1000000000000 / SYS_CLK_HZ))
+NEED_PS=$(((SRAM_TAA_NS + SRAM_IO_NS) * 1000))
+if [ ${PERIOD_PS} -lt ${NEED_PS} ]; then
+    MSG="SRAM read window: ${PERIOD_PS} ps clock < tAA ${SRAM_TAA_NS} ns + I/O ${SRAM_IO_NS} ns"
+    if [ "${SRAM_TIMING}" != "0" ]; then
+        echo "ERROR: ${MSG}; use SRAM_TIMING_2CYCLE or a slower SYS_CLK"
+        exit 1
+    fi
+    echo "WARNING: ${MSG} (check 'make timing-sweep')"
+fi
+echo "\`define SRAM_TIMING ${SRAM_TIMING}" >> build/generated/config.vh
+if [ "${CONFIG_SRAM_WRITE_COMBINE}" = "y" ]; then
+    echo "\`define SRAM_WRITE_COMBINE" >> build/generated/config.vh
+fi
+if [ -n "${PLL}" ]; then
+    set -- ${PLL}
+    echo "\`define SYS_CLK_PLL" >> build/generated/config.vh
+    echo "\`define PLL_DIVR 4'd$1" >> build/generated/config.vh
+    echo "\`define PLL_DIVF 7'd$2" >> build/generated/config.vh
+    echo "\`define PLL_DIVQ 3'd$3" >> build/generated/config.vh
+    echo "\`define PLL_FILTER_RANGE 3'd$4" >> build/generated/config.vh
+fi
+
 cat >> build/generated/config.vh << EOF
 
 // Memory Map
@@ -67,6 +218,7 @@ fi
 
 cat >> build/generated/config.vh << EOF
 \`define TIMER_BASE 32'h${CONFIG_TIMER_BASE:-80000020}
+\`define TIMER_CHANNELS ${CONFIG_TIMER_CHANNELS:-3}
 
 \`endif // CONFIG_VH
 EOF
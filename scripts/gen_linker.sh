@@ -12,6 +12,164 @@ source .config
 
 mkdir -p build/generated
 
+# Scratchpad RAM at 0x80000: the first 1 KB belongs to overlays
+# (overlay_linker.ld), the firmware gets the rest
+SPAD_SIZE=${CONFIG_SCRATCHPAD_SIZE:-4096}
+FAST_ORIGIN=0x00080400
+FAST_LENGTH=$(printf "0x%08X" $((SPAD_SIZE - 0x400)))
+
+# lwIP receive pbuf pool (Kconfig "Networking"): lwipopts.h gives it the
+# input section .bss.lwip.memp_memory_PBUF_POOL_base, placed here in
+# .fastbss, in its own SRAM region or (by default) in .bss
+LWIP_POOL_SECTION='*(.bss.lwip.memp_memory_PBUF_POOL_base)'
+LWIP_POOL_FAST=""
+LWIP_POOL_MEMORY=""
+LWIP_POOL_OUTPUT="    __lwip_pool_start = 0;  /* No separate pool region */
+    __lwip_pool_end = 0;
+"
+HEAP_END="ORIGIN(STACK)"
+SRAM_TAIL="ORIGIN(STACK)"
+if [ "${CONFIG_LWIP_PBUF_POOL_SCRATCHPAD}" = "y" ]; then
+    LWIP_POOL_FAST="        ${LWIP_POOL_SECTION}    /* lwIP PBUF_POOL */"
+elif [ "${CONFIG_LWIP_PBUF_POOL_SRAM}" = "y" ]; then
+    LWIP_POOL_ORIGIN=${CONFIG_LWIP_PBUF_POOL_ADDR:-0x00058000}
+    LWIP_POOL_LENGTH=${CONFIG_LWIP_PBUF_POOL_REGION_SIZE:-0x00008000}
+    LWIP_POOL_MEMORY="    LWIPRAM (rw)  : ORIGIN = ${LWIP_POOL_ORIGIN}, LENGTH = ${LWIP_POOL_LENGTH}  /* lwIP PBUF_POOL */"
+    LWIP_POOL_OUTPUT="    /* lwIP receive pbuf pool, outside the malloc() heap */
+    .lwip_pool (NOLOAD) : {
+        __lwip_pool_start = .;
+        ${LWIP_POOL_SECTION}
+        . = ALIGN(4);
+        __lwip_pool_end = .;
+    } > LWIPRAM
+"
+    HEAP_END="ORIGIN(LWIPRAM)"
+    SRAM_TAIL="ORIGIN(LWIPRAM) + LENGTH(LWIPRAM)"
+fi
+
+# FreeRTOS heap_5 (Kconfig FREERTOS_HEAP_5): newlib's heap keeps the first
+# FREERTOS_NEWLIB_HEAP_SIZE bytes after .bss, FreeRTOS gets the rest and the
+# other free SRAM: the gap from the end of .data to .overlay_comm, and the
+# SRAM between a separate lwIP pool and the stack.
+# lib/freertos_port/freertos_heap.c reads the symbols
+HEAP_SPLIT="${HEAP_END}"
+if [ "${CONFIG_FREERTOS_HEAP_5}" = "y" ]; then
+    HEAP_SPLIT="MIN(__heap_start + ${CONFIG_FREERTOS_NEWLIB_HEAP_SIZE:-65536}, ${HEAP_END})"
+fi
+
+# Hot function placement (Kconfig HOT_PLACEMENT): the functions of a
+# scripts/prof_report.sh -o list, hottest first, go to scratchpad RAM while
+# their sizes fit HOT_FASTCODE_BYTES, the rest to the start of .text, next
+# to each other. Each function has its own .text.<name> input section
+# (firmware/Makefile adds -ffunction-sections when this is on).
+HOT_FAST=""
+HOT_TEXT=""
+HOT_FAST_OUTPUT=""
+HOT_FAST_IMAGE=""
+HOT_ASSERT=""
+HOT_SUMMARY=""
+FASTCODE_START="        __fastcode_start = .;
+"
+FASTCODE_LOAD="__fastcode_load = LOADADDR(.fastcode);"
+HOT_SIZE=""
+if [ "${CONFIG_HOT_PLACEMENT}" = "y" ]; then
+    HOT_FILE=${CONFIG_HOT_FUNCTIONS_FILE:-build/hot_functions.txt}
+    HOT_BUDGET=${CONFIG_HOT_FASTCODE_BYTES:-1024}
+
+    # The scratchpad split has to match what overlays assume
+    MEMORY_CONFIG=firmware/overlay_sdk/common/memory_config.h
+    SPAD_BASE=$(sed -n 's/^#define SCRATCHPAD_BASE[[:space:]]*\(0x[0-9A-Fa-f]*\).*/\1/p' "$MEMORY_CONFIG")
+    OVERLAY_FAST=$(sed -n 's/^#define OVERLAY_FAST_SIZE[[:space:]]*(\([0-9 *]*\)).*/\1/p' "$MEMORY_CONFIG")
+    if [ -z "$SPAD_BASE" ] || [ -z "$OVERLAY_FAST" ] || \
+       [ $((SPAD_BASE + OVERLAY_FAST)) -ne $((FAST_ORIGIN)) ]; then
+        echo "ERROR: FASTRAM origin ${FAST_ORIGIN} does not match ${MEMORY_CONFIG} (SCRATCHPAD_BASE + OVERLAY_FAST_SIZE)"
+        exit 1
+    fi
+    if [ "$HOT_BUDGET" -gt $((FAST_LENGTH)) ]; then
+        echo "ERROR: HOT_FASTCODE_BYTES ($HOT_BUDGET) exceeds the firmware scratchpad ($((FAST_LENGTH)) bytes)"
+        exit 1
+    fi
+
+    if [ ! -f "$HOT_FILE" ]; then
+        echo "Note: $HOT_FILE not found (scripts/prof_report.sh -o), no hot function placement"
+    else
+        HOT_USED=0
+        HOT_NFAST=0
+        HOT_NTEXT=0
+        while read -r name size rest; do
+            case "$name" in ''|'#'*) continue ;; esac
+            size=$(( (${size:-0} + 3) & ~3 ))
+            if [ "$size" -gt 0 ] && [ $((HOT_USED + size)) -le "$HOT_BUDGET" ]; then
+                HOT_FAST="${HOT_FAST}        *(.text.${name} .text.${name}.*)
+"
+                HOT_USED=$((HOT_USED + size))
+                HOT_NFAST=$((HOT_NFAST + 1))
+            else
+                HOT_TEXT="${HOT_TEXT}        *(.text.${name} .text.${name}.*)
+"
+                HOT_NTEXT=$((HOT_NTEXT + 1))
+            fi
+        done < "$HOT_FILE"
+        if [ -n "$HOT_TEXT" ]; then
+            HOT_TEXT="        /* Hot functions that did not fit the scratchpad (${HOT_FILE}) */
+${HOT_TEXT}"
+        fi
+        # .fasthot comes first: the linker takes an input section for the
+        # first pattern it matches, and .text has *(.text*). Its image is
+        # reserved just below the .fastcode image, so start.S copies both
+        # (and the profiler sees both) as one .fastcode range
+        if [ -n "$HOT_FAST" ]; then
+            HOT_FAST_OUTPUT="    /* Hot functions in scratchpad RAM (${HOT_FILE}), loaded from
+     * .fasthot_image right below the .fastcode image */
+    .fasthot : AT(__fasthot_load) {
+${HOT_FAST}        . = ALIGN(4);
+    } > FASTRAM
+
+"
+            HOT_FAST_IMAGE="    .fasthot_image : {
+        __fasthot_load = .;
+        . += SIZEOF(.fasthot);
+    } > APPSRAM
+"
+            FASTCODE_START=""
+            FASTCODE_LOAD="__fastcode_start = ADDR(.fasthot);
+    __fastcode_load = LOADADDR(.fasthot);"
+            HOT_SIZE=" + SIZEOF(.fasthot)"
+            HOT_ASSERT="    ASSERT(SIZEOF(.fasthot) <= ${HOT_BUDGET}, \"ERROR: hot functions outgrew HOT_FASTCODE_BYTES - regenerate ${HOT_FILE}!\")
+    ASSERT(LOADADDR(.fastcode) - LOADADDR(.fasthot) == ADDR(.fastcode) - ADDR(.fasthot), \"ERROR: .fasthot and .fastcode images are not contiguous!\")
+"
+        fi
+        HOT_SUMMARY="✓ Hot functions: ${HOT_NFAST} in scratchpad RAM (${HOT_USED} of ${HOT_BUDGET} bytes), ${HOT_NTEXT} at the start of .text"
+    fi
+fi
+
+# SPI flash execute in place (Kconfig FLASH_XIP): XIP_CODE / XIP_RODATA
+# (lib/spi_flash.h) go to .xip, read from the configuration flash above
+# the bitstream at SPI_FLASH_DATA_OFFSET and left out of the .bin
+# ('make <target>.xip.bin' for the SD card manager's Program SPI Flash).
+# Without it they stay in .text / .rodata.
+XIP_MEMORY=""
+XIP_OUTPUT=""
+XIP_TEXT="        *(.xip.text*)       /* XIP_CODE (no FLASH_XIP: SRAM) */
+"
+XIP_RODATA="        *(.xip.rodata*)
+"
+if [ "${CONFIG_FLASH_XIP}" = "y" ]; then
+    XIP_MEMORY="    XIPFLASH (rx) : ORIGIN = 0x01100000, LENGTH = 0x00F00000  /* SPI flash from 1 MB */"
+    XIP_OUTPUT="    /* Configuration flash, execute in place (not in the .bin) */
+    .xip : {
+        __xip_start = .;
+        *(.xip.text*)
+        *(.xip.rodata*)
+        . = ALIGN(4);
+        __xip_end = .;
+    } > XIPFLASH
+
+"
+    XIP_TEXT=""
+    XIP_RODATA=""
+fi
+
 cat > build/generated/linker.ld << EOF
 /* Auto-generated from .config - DO NOT EDIT */
 /* Generated: $(date) */
@@ -20,24 +178,32 @@ MEMORY
 {
     APPSRAM (rwx) : ORIGIN = ${CONFIG_APP_SRAM_BASE:-0x00000000}, LENGTH = ${CONFIG_APP_SRAM_SIZE:-0x00040000}
     STACK (rw)    : ORIGIN = 0x00074000, LENGTH = 0x0000C000  /* 48KB stack (3x safety margin) */
+    FASTRAM (rwx) : ORIGIN = ${FAST_ORIGIN}, LENGTH = ${FAST_LENGTH}  /* Scratchpad BRAM */
+${LWIP_POOL_MEMORY}
+${XIP_MEMORY}
 }
 
 SECTIONS
 {
     ENTRY(_start)
 
-    /* Code section at 0x0 */
+${HOT_FAST_OUTPUT}    /* Code section at 0x0 */
     .text : {
+        __text_start = .;
         *(.text.start)      /* Startup code first */
-        *(.text*)
-        . = ALIGN(4);
+${HOT_TEXT}        *(.text*)
+${XIP_TEXT}        . = ALIGN(4);
+        __text_end = .;     /* Sampling profiler range (lib/profiler) */
     } > APPSRAM
 
     /* Read-only data */
     .rodata : {
         *(.rodata*)
         *(.srodata*)
-        . = ALIGN(4);
+${XIP_RODATA}        . = ALIGN(4);
+        __gcov_info_start = .;      /* PGO=gen builds (lib/pgo) */
+        KEEP(*(.gcov_info))
+        __gcov_info_end = .;
     } > APPSRAM
 
     /* Initialized data */
@@ -45,6 +211,7 @@ SECTIONS
         *(.data*)
         *(.sdata*)
         . = ALIGN(4);
+        __data_end = .;     /* Free SRAM up to .overlay_comm, if any (heap_5) */
     } > APPSRAM
 
     /* CRITICAL: Overlay Communication Section at Fixed Address 0x2A000
@@ -56,10 +223,42 @@ SECTIONS
     . = 0x0002A000;
     .overlay_comm 0x0002A000 : {
         KEEP(*(.overlay_comm))
+        KEEP(*(.overlay_comm.services))   /* SD card manager service table, 0x2A004 */
+        KEEP(*(.overlay_comm.cache))      /* Last overlay image loaded (overlay_loader.h) */
         . = ALIGN(4);
     } > APPSRAM
 
-    /* Uninitialized data */
+    /* Scratchpad RAM: stored in SRAM after .overlay_comm, copied to
+     * 0x80400+ by start.S before main(). Use
+     *   __attribute__((section(".fastcode"))) for ISRs / hot loops
+     *   __attribute__((section(".fastdata"))) for small hot tables
+     *   __attribute__((section(".fastbss")))  for zeroed buffers / pools
+     *                                          (not stored in the image)
+     */
+${HOT_FAST_IMAGE}    .fastcode : {
+${FASTCODE_START}        *(.fastcode*)
+        . = ALIGN(4);
+        __fastcode_end = .;
+    } > FASTRAM AT > APPSRAM
+    ${FASTCODE_LOAD}
+
+    .fastdata : {
+        __fastdata_start = .;
+        *(.fastdata*)
+        . = ALIGN(4);
+        __fastdata_end = .;
+    } > FASTRAM AT > APPSRAM
+
+    .fastbss (NOLOAD) : {
+        __fastbss_start = .;
+        *(.fastbss*)
+${LWIP_POOL_FAST}
+        . = ALIGN(4);
+        __fastbss_end = .;
+    } > FASTRAM
+
+${LWIP_POOL_OUTPUT}
+${XIP_OUTPUT}    /* Uninitialized data */
     .bss : {
         __bss_start = .;
         *(.bss*)
@@ -71,15 +270,41 @@ SECTIONS
 
     /* Heap starts after BSS, extends to stack */
     __heap_start = ALIGN(., 4);
-    __heap_end = ORIGIN(STACK);  /* Heap ends at 0x74000, ~200KB+ available for buffers */
+    __heap_end = ${HEAP_SPLIT};  /* Heap ends at 0x74000, ~200KB+ available for buffers */
+
+    /* FreeRTOS heap_5 regions (empty without it), lib/freertos_port/freertos_heap.c.
+     * The .data gap exists only when there is an .overlay_comm to skip to */
+    __data_gap_end = SIZEOF(.overlay_comm) ? ADDR(.overlay_comm) : __data_end;
+    __rtos_heap_start = __heap_end;
+    __rtos_heap_end = ${HEAP_END};
+    __sram_tail_start = ${SRAM_TAIL};
+    __sram_tail_end = ORIGIN(STACK);
+    __fastram_end = ORIGIN(FASTRAM) + LENGTH(FASTRAM);
+
+    __stack_region = ORIGIN(STACK);
 
     /* Stack pointer (grows down from top of SRAM) */
     __stack_top = 0x00080000;  /* Top of 512KB SRAM */
 
     /* Verify application fits in SRAM */
-    __app_size = SIZEOF(.text) + SIZEOF(.rodata) + SIZEOF(.data) + SIZEOF(.bss);
+    __app_size = SIZEOF(.text) + SIZEOF(.rodata) + SIZEOF(.data) + SIZEOF(.fastcode) + SIZEOF(.fastdata) + SIZEOF(.bss)${HOT_SIZE};
     ASSERT(__app_size <= ${CONFIG_APP_SRAM_SIZE:-0x00040000}, "ERROR: Application exceeds SRAM!")
-}
+    ASSERT(__fastbss_end <= ORIGIN(FASTRAM) + LENGTH(FASTRAM), "ERROR: .fastcode/.fastdata/.fastbss exceed scratchpad RAM!")
+    ASSERT(__heap_start <= __heap_end, "ERROR: .bss runs into the lwIP pbuf pool region!")
+    ASSERT(DEFINED(overlay_services_table) ? overlay_services_table == 0x0002A004 : 1, "ERROR: Overlay service table must be at 0x2A004!")
+
+    /* BLOG() format strings (lib/binlog): kept in the ELF for the host
+     * decoder, never loaded. At address 0 a string's address is its
+     * 16-bit ID; 0xFFFF is reserved.
+     */
+    .binlog 0 (INFO) : {
+        KEEP(*(.binlog_fmt))
+    }
+    ASSERT(SIZEOF(.binlog) < 0xFFFF, "ERROR: BLOG() format strings exceed 64 KB!")
+${HOT_ASSERT}}
 EOF
 
 echo "✓ Generated build/generated/linker.ld"
+if [ -n "$HOT_SUMMARY" ]; then
+    echo "$HOT_SUMMARY"
+fi
@@ -28,6 +28,8 @@ cat > build/generated/platform.h << EOF
 #define ROM_SIZE         ${CONFIG_ROM_SIZE:-0x00002000}
 #define STACK_SRAM_BASE  ${CONFIG_STACK_SRAM_BASE:-0x00042000}
 #define STACK_TOP        ${CONFIG_STACKADDR:-0x00080000}
+#define SPAD_BASE        0x00080000
+#define SPAD_SIZE        ${CONFIG_SCRATCHPAD_SIZE:-4096}
 
 /* MMIO Peripherals */
 #define MMIO_BASE        ${CONFIG_MMIO_BASE:-0x80000000}
@@ -49,6 +51,33 @@ cat > build/generated/platform.h << EOF
 /* Timer */
 #define TIMER_BASE       ${CONFIG_TIMER_BASE:-0x80000020}
 
+/* Cache Control */
+#define CACHE_CTRL       (MMIO_BASE + 0x60)
+#define CACHE_INFO       (MMIO_BASE + 0x64)
+#define CACHE_DADDR      (MMIO_BASE + 0x68)
+#define CACHE_DLEN       (MMIO_BASE + 0x6C)
+#define CACHE_ICACHE_INV 0x01
+#define CACHE_DCACHE_CLEAN 0x02
+#define CACHE_DCACHE_INV 0x04
+
+/* Performance Monitoring Unit */
+#define PMU_BASE         (MMIO_BASE + 0x80)
+#define PMU_CTRL         (PMU_BASE + 0x00)
+#define PMU_CYCLES       (PMU_BASE + 0x04)
+#define PMU_SRAM_WAIT    (PMU_BASE + 0x08)
+#define PMU_MMIO_WAIT    (PMU_BASE + 0x0C)
+#define PMU_BOOT_WAIT    (PMU_BASE + 0x10)
+#define PMU_FETCHES      (PMU_BASE + 0x14)
+#define PMU_LOADS        (PMU_BASE + 0x18)
+#define PMU_STORES       (PMU_BASE + 0x1C)
+#define PMU_IC_HIT       (PMU_BASE + 0x20)
+#define PMU_IC_MISS      (PMU_BASE + 0x24)
+#define PMU_DC_HIT       (PMU_BASE + 0x28)
+#define PMU_DC_MISS      (PMU_BASE + 0x2C)
+#define PMU_SPAD         (PMU_BASE + 0x30)
+#define PMU_CTRL_ENABLE  0x01
+#define PMU_CTRL_CLEAR   0x02
+
 /* Helper functions */
 static inline void uart_putc(char c) {
     volatile uint32_t *tx_data = (volatile uint32_t *)UART_TX_DATA;
@@ -64,6 +93,20 @@ static inline char uart_getc(void) {
     return (char)(*rx_data & 0xFF);
 }
 
+static inline void icache_invalidate(void) {
+    volatile uint32_t *cache_ctrl = (volatile uint32_t *)CACHE_CTRL;
+    *cache_ctrl = CACHE_ICACHE_INV;
+    while (*cache_ctrl & CACHE_ICACHE_INV);  // Wait for invalidate to finish
+}
+
+static inline void dcache_op_range(uint32_t op, uint32_t addr, uint32_t len) {
+    volatile uint32_t *cache_ctrl = (volatile uint32_t *)CACHE_CTRL;
+    *(volatile uint32_t *)CACHE_DADDR = addr;
+    *(volatile uint32_t *)CACHE_DLEN = len;
+    *cache_ctrl = op;
+    while (*cache_ctrl & CACHE_DCACHE_CLEAN);  // Wait for maintenance to finish
+}
+
 #endif /* PLATFORM_H */
 EOF
 
@@ -0,0 +1,37 @@
+#!/bin/bash
+# Generate the nextpnr timing constraints from .config (CONFIG_SYS_CLK_HZ)
+
+set -e
+
+if [ ! -f .config ]; then
+    echo "ERROR: .config not found. Run 'make menuconfig' or 'make defconfig' first."
+    exit 1
+fi
+
+source .config
+
+mkdir -p build/generated
+
+SYS_CLK_HZ=${CONFIG_SYS_CLK_HZ:-50000000}
+PERIOD=$(awk -v hz="${SYS_CLK_HZ}" 'BEGIN { printf "%.3f", 1e9 / hz }')
+MHZ=$(awk -v hz="${SYS_CLK_HZ}" 'BEGIN { printf "%.2f", hz / 1e6 }')
+
+if [ "${SYS_CLK_HZ}" = "50000000" ]; then
+    SOURCE="EXTCLK / 2"
+else
+    SOURCE="SB_PLL40_CORE from EXTCLK"
+fi
+
+cat > build/generated/ice40_picorv32.sdc << EOF2
+# Auto-generated from .config - DO NOT EDIT
+# Generated: $(date)
+# Reference (50 MHz) version with notes: hdl/ice40_picorv32.sdc
+
+# Primary external clock input: 100 MHz crystal oscillator
+create_clock -period 10.0 -name EXTCLK [get_ports {EXTCLK}]
+
+# Internal system clock net: ${MHZ} MHz (${SOURCE})
+create_clock -period ${PERIOD} -name clk [get_nets {clk}]
+EOF2
+
+echo "✓ Generated build/generated/ice40_picorv32.sdc (${MHZ} MHz)"
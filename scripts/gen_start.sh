@@ -30,6 +30,11 @@ _start:
 .balign 16
 .global irq_vec
 irq_vec:
+    /* The handler body runs from scratchpad RAM (.fastcode) */
+    j irq_vec_fast
+
+.section .fastcode, "ax"
+irq_vec_fast:
     /* Save ALL caller-saved registers */
     addi sp, sp, -64
     sw ra,  0(sp)
@@ -52,6 +57,14 @@ irq_vec:
     /* Read which IRQ(s) fired from q1 */
     .insn r 0x0B, 4, 0, a0, x1, x0  // getq a0, q1
 
+#ifdef GDB_STUB
+    /* EBREAK (IRQ[1]): the GDB stub first, it returns what is left */
+    andi t0, a0, 2
+    beqz t0, 1f
+    call gdbstub_trap
+1:
+#endif
+
     /* Call C interrupt handler */
     call irq_handler
 
@@ -77,6 +90,8 @@ irq_vec:
     /* Return from interrupt */
     .insn r 0x0B, 0, 2, x0, x0, x0  // retirq
 
+.section .text.start
+
 //==============================================================================
 // Initialization Code
 //==============================================================================
@@ -85,6 +100,16 @@ init_start:
     /* Set up stack pointer */
     la sp, __stack_top
 
+    /* Paint the stack for the high-water mark (lib/mem_stats.h) */
+    la t0, __stack_region
+    li t1, 0xA5A5A5A5
+paint_stack:
+    bgeu t0, sp, done_paint_stack
+    sw t1, 0(t0)
+    addi t0, t0, 4
+    j paint_stack
+done_paint_stack:
+
     /* Clear BSS section */
     la t0, __bss_start
     la t1, __bss_end
@@ -95,6 +120,29 @@ clear_bss:
     j clear_bss
 done_clear_bss:
 
+    /* Copy .fastcode/.fastdata from SRAM into scratchpad RAM */
+    la t0, __fastcode_load
+    la t1, __fastcode_start
+    la t2, __fastdata_end
+copy_fast:
+    bge t1, t2, done_copy_fast
+    lw t3, 0(t0)
+    sw t3, 0(t1)
+    addi t0, t0, 4
+    addi t1, t1, 4
+    j copy_fast
+done_copy_fast:
+
+    /* Zero .fastbss (scratchpad only, not in the image) */
+    la t1, __fastbss_start
+    la t2, __fastbss_end
+clear_fastbss:
+    bge t1, t2, done_clear_fastbss
+    sw zero, 0(t1)
+    addi t1, t1, 4
+    j clear_fastbss
+done_clear_fastbss:
+
     /* Set up argc and argv for main(int argc, char **argv) */
     li a0, 0        // argc = 0
     li a1, 0        // argv = NULL
@@ -107,12 +155,77 @@ loop_forever:
     j loop_forever
 
 //==============================================================================
-// Default (Weak) IRQ Handler
+// Default (Weak) IRQ Handler: table dispatch (lib/irq.h)
 //==============================================================================
+// a0 = PicoRV32 pending mask. Claims sources from the interrupt controller,
+// highest priority first, acknowledging each before calling its handler so a
+// new event during the handler is not lost. Without the controller (CLAIM
+// reads 0) the pending mask is dispatched instead, lowest IRQ first.
+
+.equ IRQC_CLAIM, 0x8000014C
 
+.section .fastcode, "ax"
 .weak irq_handler
 irq_handler:
-    ret  // Do nothing, just return
+    addi sp, sp, -16
+    sw ra, 0(sp)
+    sw s0, 4(sp)
+    sw s1, 8(sp)
+    andi s1, a0, 0xFF           // Fallback mask (8 table entries)
+    li s0, IRQC_CLAIM
+
+irq_dispatch_next:
+    lw t0, 0(s0)
+    bgez t0, irq_dispatch_nocl  // [31] clear: nothing claimed
+    andi t0, t0, 7
+    sw t0, 0(s0)                // Acknowledge
+    j irq_dispatch_call
+
+irq_dispatch_nocl:
+    slli t0, t0, 1
+    bltz t0, irq_dispatch_done  // [30] controller present: all handled
+    beqz s1, irq_dispatch_done
+    li t0, 0                    // Lowest set bit of the fallback mask
+irq_dispatch_scan:
+    srl t1, s1, t0
+    andi t1, t1, 1
+    bnez t1, irq_dispatch_take
+    addi t0, t0, 1
+    j irq_dispatch_scan
+irq_dispatch_take:
+    li t1, 1
+    sll t1, t1, t0
+    xor s1, s1, t1
+
+irq_dispatch_call:
+    la t1, irq_vector_table
+    slli t2, t0, 2
+    add t1, t1, t2
+    lw t1, 0(t1)
+    beqz t1, irq_dispatch_next  // No handler installed
+#ifdef TRACE_ENABLE
+    mv a1, t1                   // Enter / exit events around it (lib/trace)
+    mv a0, t0
+    call trace_isr_call
+#else
+    mv a0, t0
+    jalr t1
+#endif
+    j irq_dispatch_next
+
+irq_dispatch_done:
+    lw ra, 0(sp)
+    lw s0, 4(sp)
+    lw s1, 8(sp)
+    addi sp, sp, 16
+    ret
+
+// Handlers installed by irq_register(), kept next to the entry code
+.section .fastdata, "aw"
+.balign 4
+.global irq_vector_table
+irq_vector_table:
+    .word 0, 0, 0, 0, 0, 0, 0, 0
 EOF
 
 echo "✓ Generated build/generated/start.S"
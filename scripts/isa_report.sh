@@ -0,0 +1,177 @@
+#!/bin/bash
+# RV32IM vs RV32IMC code size and runtime report
+#
+# Builds hexedit_fast, sd_card_manager and the overlay SDK projects twice
+# (ARCH=rv32im and ARCH=rv32imc) and compares their .text sizes. With a
+# serial port it also programs the "compressed" profile bitstream (UART
+# bootloader; an RV32C core runs both builds), uploads each hexedit_fast
+# build and times a few commands with its PMU "perf" command, so the
+# fetch count / SRAM wait difference shows up next to the size saving.
+#
+# sd_card_manager and the overlays load from the SD card, so only their
+# size is compared here.
+#
+# Usage: scripts/isa_report.sh [-p PORT] [-b BAUD] [-n]
+#   -p PORT   Serial port of the board (enables the runtime comparison)
+#   -b BAUD   UART baud rate (default 115200)
+#   -n        Reuse build/ice40_picorv32_compressed.bin (no rebuild)
+#
+# Library code (newlib) is only compressed if newlib was built with
+# CONFIG_COMPRESSED_ISA=y; firmware/Makefile prints a note otherwise.
+
+set -e
+
+PORT=""
+BAUD=115200
+REBUILD=1
+MAKE=${MAKE:-make}
+
+while getopts "p:b:n" opt; do
+    case $opt in
+        p) PORT=$OPTARG ;;
+        b) BAUD=$OPTARG ;;
+        n) REBUILD=0 ;;
+        *) echo "Usage: $0 [-p PORT] [-b BAUD] [-n]"; exit 1 ;;
+    esac
+done
+
+ARCHES="rv32im rv32imc"
+OVERLAYS="hello_world heap_test hexedit mandelbrot_fixed mandelbrot_float printf_demo timer_test"
+PERF_COMMANDS="c 60000 64000 4000|f 60000 8000 55"
+OUT=build/isa_report
+UPLOAD=tools/uploader/fw_upload
+
+if [ -x "build/toolchain/bin/riscv64-unknown-elf-size" ]; then
+    SIZE="build/toolchain/bin/riscv64-unknown-elf-size"
+elif command -v riscv-none-elf-size >/dev/null 2>&1; then
+    SIZE="riscv-none-elf-size"
+else
+    SIZE="riscv64-unknown-elf-size"
+fi
+
+# Start from clean objects so nothing built for the other ISA is reused
+clean_objects() {
+    $MAKE -C firmware clean > /dev/null
+    find firmware/sd_fatfs lib/inflate -name '*.o' -delete 2>/dev/null || true
+}
+
+text_size() {
+    $SIZE -A "$1" 2>/dev/null | awk '$1 == ".text" { print $2 }'
+}
+
+#------------------------------------------------------------------------------
+# Build both ISA variants
+#------------------------------------------------------------------------------
+
+for arch in $ARCHES; do
+    echo "========================================="
+    echo "Building firmware for $arch"
+    echo "========================================="
+    mkdir -p "$OUT/$arch"
+
+    clean_objects
+    $MAKE -C firmware TARGET=hexedit_fast USE_NEWLIB=1 ARCH=$arch single-target
+    cp firmware/hexedit_fast.elf firmware/hexedit_fast.bin "$OUT/$arch/"
+
+    clean_objects
+    $MAKE -C firmware sd_card_manager ARCH=$arch
+    cp firmware/sd_card_manager.elf "$OUT/$arch/"
+
+    for p in $OVERLAYS; do
+        $MAKE -C firmware/overlay_sdk/projects/$p clean > /dev/null
+        $MAKE -C firmware/overlay_sdk/projects/$p all ARCH=$arch
+        cp firmware/overlay_sdk/projects/$p/$p.elf "$OUT/$arch/overlay_$p.elf"
+    done
+done
+
+# Leave the tree built for the configured ISA
+clean_objects
+
+#------------------------------------------------------------------------------
+# Runtime: hexedit_fast "perf <cmd>" on the RV32C bitstream
+#------------------------------------------------------------------------------
+
+port_raw() {
+    stty -F "$PORT" "$BAUD" raw -echo 2>/dev/null || stty -f "$PORT" "$BAUD" raw -echo
+}
+
+# perf_run <arch> <command>: prints "<cycles> <fetches> <sram_wait>"
+perf_run() {
+    local cycles="" fetches="" sram="" line
+    printf 'perf %s\r' "$2" >&3
+    while IFS= read -r -t 60 line <&3; do
+        line=${line%$'\r'}
+        case "$line" in
+            *"Total cycles"*) cycles=$(echo "$line" | awk '{ print $3 }') ;;
+            *"SRAM wait"*)    sram=$(echo "$line" | awk '{ print $3 }') ;;
+            *"Fetches"*)      fetches=$(echo "$line" | awk '{ print $2 }') ;;
+            *"Scratchpad"*)   break ;;
+        esac
+    done
+    echo "${cycles:--} ${fetches:--} ${sram:--}"
+}
+
+if [ -n "$PORT" ]; then
+    if [ ! -x "$UPLOAD" ]; then
+        echo "ERROR: $UPLOAD not found. Run 'make upload-tool' first."
+        exit 1
+    fi
+    if [ "$REBUILD" = "1" ]; then
+        BOOTLOADER=uart ./scripts/build_profile.sh compressed
+    fi
+    iceprog build/ice40_picorv32_compressed.bin
+    sleep 2
+
+    : > "$OUT/runtime.txt"
+    for arch in $ARCHES; do
+        echo ""
+        echo "Timing hexedit_fast ($arch)..."
+        port_raw
+        exec 3<>"$PORT"
+        "$UPLOAD" -p "$PORT" -b "$BAUD" "$OUT/$arch/hexedit_fast.bin" > /dev/null
+        port_raw
+        sleep 1
+        printf '\r' >&3
+        sleep 1
+        IFS='|'
+        for cmd in $PERF_COMMANDS; do
+            unset IFS
+            echo "$arch|$cmd|$(perf_run "$arch" "$cmd")" >> "$OUT/runtime.txt"
+            IFS='|'
+        done
+        unset IFS
+        exec 3<&-
+    done
+fi
+
+#------------------------------------------------------------------------------
+# Report
+#------------------------------------------------------------------------------
+
+echo ""
+echo "========================================="
+echo "RV32IM vs RV32IMC: .text size (bytes)"
+echo "========================================="
+printf "%-28s %10s %10s %8s\n" "Image" "rv32im" "rv32imc" "Saved"
+for elf in $(cd "$OUT/rv32im" && ls *.elf); do
+    A=$(text_size "$OUT/rv32im/$elf")
+    B=$(text_size "$OUT/rv32imc/$elf")
+    awk -v n="${elf%.elf}" -v a="${A:-0}" -v b="${B:-0}" 'BEGIN {
+        printf "%-28s %10d %10d %7.1f%%\n", n, a, b, a ? 100 * (a - b) / a : 0
+    }'
+done
+
+if [ -s "$OUT/runtime.txt" ]; then
+    echo ""
+    echo "========================================="
+    echo "hexedit_fast runtime (PMU, RV32C bitstream)"
+    echo "========================================="
+    printf "%-24s %-8s %12s %10s %12s\n" "Command" "ISA" "Cycles" "Fetches" "SRAM wait"
+    while IFS='|' read -r arch cmd result; do
+        set -- $result
+        printf "%-24s %-8s %12s %10s %12s\n" "$cmd" "$arch" "$1" "$2" "$3"
+    done < "$OUT/runtime.txt"
+fi
+
+echo ""
+echo "ELF files: $OUT/<isa>/"
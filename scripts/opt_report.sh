@@ -0,0 +1,123 @@
+#!/bin/bash
+# Firmware build profile size and speed report (OPT=default vs OPT=lto)
+#
+# Builds every firmware target the tree can build (bare metal, newlib,
+# incurses, hexedit, FreeRTOS, lwIP, SD/FatFS) in firmware/Makefile's two
+# build profiles and compares their .text/.data/.bss sizes. Each build then
+# runs the scripts/perf_regress.sh benchmark set on the Verilator model
+# (cycle-exact, so the two profiles' counts compare directly): the cost of
+# -Os outside the hot files shows up next to the size saving.
+#
+# Targets whose libraries are missing (downloads/freertos, downloads/lwip,
+# newlib) are skipped; the overlay SDK keeps its own flags.
+#
+# Usage: scripts/opt_report.sh [-n]
+#   -n        Sizes only (no Verilator runs)
+
+set -e
+
+SPEED=1
+MAKE=${MAKE:-make}
+
+while getopts "n" opt; do
+    case $opt in
+        n) SPEED=0 ;;
+        *) echo "Usage: $0 [-n]"; exit 1 ;;
+    esac
+done
+
+PROFILES="default lto"
+TARGET_GROUPS="bare-metal-targets newlib-only-targets incurses-targets hexedit-targets freertos-targets lwip-targets sd-fatfs-targets"
+OUT=build/opt_report
+
+if [ -x "build/toolchain/bin/riscv64-unknown-elf-size" ]; then
+    SIZE="build/toolchain/bin/riscv64-unknown-elf-size"
+elif command -v riscv-none-elf-size >/dev/null 2>&1; then
+    SIZE="riscv-none-elf-size"
+else
+    SIZE="riscv64-unknown-elf-size"
+fi
+
+# Start from clean objects so nothing built in the other profile is reused
+# (firmware/Makefile also deletes them when OPT changes)
+clean_objects() {
+    $MAKE -C firmware clean > /dev/null
+    find firmware/sd_fatfs lib/inflate -name '*.o' -delete 2>/dev/null || true
+}
+
+# sizes <elf>: prints "<text> <data> <bss>"
+sizes() {
+    $SIZE "$1" 2>/dev/null | awk 'NR == 2 { print $1, $2, $3 }'
+}
+
+#------------------------------------------------------------------------------
+# Build both profiles
+#------------------------------------------------------------------------------
+
+if [ "$SPEED" = "1" ]; then
+    $MAKE generate
+    $MAKE -C sim/verilator
+fi
+
+for p in $PROFILES; do
+    echo "========================================="
+    echo "Building firmware, OPT=$p"
+    echo "========================================="
+    rm -rf "$OUT/$p"
+    mkdir -p "$OUT/$p"
+
+    clean_objects
+    for g in $TARGET_GROUPS; do
+        $MAKE -C firmware $g OPT=$p || echo "($g: not built)"
+    done
+    cp firmware/*.elf "$OUT/$p/" 2>/dev/null || true
+
+    # perf_regress.sh -n runs the firmware/*.elf just built; no threshold
+    if [ "$SPEED" = "1" ]; then
+        scripts/perf_regress.sh -n -t 1000000 > "$OUT/$p/perf.log" 2>&1 || \
+            echo "(OPT=$p: not every benchmark ran, see $OUT/$p/perf.log)"
+        cp build/perf_regress/results.txt "$OUT/$p/perf.txt" 2>/dev/null || true
+    fi
+done
+
+# Leave the tree built for the configured profile
+clean_objects
+
+#------------------------------------------------------------------------------
+# Report
+#------------------------------------------------------------------------------
+
+echo ""
+echo "========================================="
+echo "OPT=default vs OPT=lto: size (bytes)"
+echo "========================================="
+printf "%-24s %9s %9s %7s %7s %7s %8s\n" "Image" ".text" "lto" ".data" "lto" ".bss" "Saved"
+for elf in $(cd "$OUT/default" && ls *.elf 2>/dev/null); do
+    [ -f "$OUT/lto/$elf" ] || continue
+    set -- $(sizes "$OUT/default/$elf") $(sizes "$OUT/lto/$elf")
+    awk -v n="${elf%.elf}" -v at="${1:-0}" -v ad="${2:-0}" -v ab="${3:-0}" \
+        -v bt="${4:-0}" -v bd="${5:-0}" -v bb="${6:-0}" 'BEGIN {
+        a = at + ad; b = bt + bd
+        printf "%-24s %9d %9d %7d %7d %7d %7.1f%%\n", n, at, bt, ad, bd, bb - ab,
+               a ? 100 * (a - b) / a : 0
+    }'
+done
+echo "(.bss column: lto minus default; Saved: .text + .data, the loaded image)"
+
+if [ -s "$OUT/default/perf.txt" ] && [ -s "$OUT/lto/perf.txt" ]; then
+    echo ""
+    echo "========================================="
+    echo "OPT=default vs OPT=lto: cycles (Verilator)"
+    echo "========================================="
+    awk -v lto="$OUT/lto/perf.txt" '
+        BEGIN {
+            while ((getline l < lto) > 0) { split(l, f, " "); m[f[1]] = f[2] }
+            printf "%-20s %12s %12s %9s\n", "Benchmark", "default", "lto", "Change"
+        }
+        $1 in m {
+            printf "%-20s %12s %12s %+8.2f%%\n", $1, $2, m[$1], $2 ? (m[$1] - $2) * 100.0 / $2 : 0
+        }' "$OUT/default/perf.txt"
+fi
+
+echo ""
+echo "ELF files and benchmark logs: $OUT/<profile>/"
@@ -0,0 +1,226 @@
+#!/bin/bash
+# Overlay benchmark run on the board (make -C firmware/overlay_sdk bench)
+#
+# Builds the overlay SDK projects, then for each benchmark project (one
+# whose sources include common/bench.h, see templates/bench.c.template):
+#
+#   1. moves the SD card manager's main menu to Upload & Execute and
+#      enters it (k to the top, 9 x j, Enter),
+#   2. sends the overlay with fw_upload_fast (the FAST stream that
+#      menu_upload_and_execute() receives), then the keys of a
+#      "// BENCH_KEYS: <keys>" line in its sources if it has one (printf
+#      %b escapes; interactive overlays such as heap_test),
+#   3. reads the UART until the manager prints "Overlay returned
+#      successfully", keeping the overlay's
+#        PERF <name> iters=<n> cyc_per_iter=<n>
+#        BENCH <name> cycles=<n> instret=<n> cpi_x100=<n>
+#      lines, and presses a key to get back to the menu.
+#
+# The board must be at the SD card manager's main menu. Results go to
+# build/overlay_bench/ (-o): results.txt (project name iters
+# cyc_per_iter cycles instret cpi_x100), report.json and report.md, one
+# log per project.
+#
+# Usage: scripts/overlay_bench.sh -p PORT [-b BAUD] [-t SECS] [-n]
+#                                 [-B DIR] [-o DIR] [project...]
+#   -p PORT   Serial port of the board
+#   -b BAUD   UART baud rate of the manager (default 115200)
+#   -t SECS   Time allowed for one overlay to run (default 60)
+#   -n        Use the overlays as built (no 'make projects' first)
+#   -B DIR    Upload DIR/<project>.bin instead of the project's own (implies -n)
+#   -o DIR    Output directory (default build/overlay_bench)
+
+set -e
+
+PORT=""
+BAUD=115200
+TIMEOUT=60
+REBUILD=1
+BINDIR=""
+OUT=build/overlay_bench
+MAKE=${MAKE:-make}
+
+while getopts "p:b:t:nB:o:" opt; do
+    case $opt in
+        p) PORT=$OPTARG ;;
+        b) BAUD=$OPTARG ;;
+        t) TIMEOUT=$OPTARG ;;
+        n) REBUILD=0 ;;
+        B) BINDIR=$OPTARG; REBUILD=0 ;;
+        o) OUT=$OPTARG ;;
+        *) echo "Usage: $0 -p PORT [-b BAUD] [-t SECS] [-n] [-B DIR] [-o DIR] [project...]"; exit 1 ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+SDK=firmware/overlay_sdk
+RESULTS=$OUT/results.txt
+UPLOAD=tools/uploader/fw_upload_fast
+
+# Main menu: MENU_UPLOAD_EXEC is entry 9 (sd_card_manager.c)
+MENU_KEYS='kkkkkkkkkkkkkkkkjjjjjjjjj\r'
+DONE_TEXT='Overlay returned successfully'
+
+if [ -z "$PORT" ]; then
+    echo "ERROR: no serial port (-p PORT, or PORT=... for make bench)"
+    exit 1
+fi
+
+#------------------------------------------------------------------------------
+# Build
+#------------------------------------------------------------------------------
+
+if [ "$REBUILD" = "1" ]; then
+    $MAKE -C "$SDK" projects
+fi
+if [ ! -x "$UPLOAD" ]; then
+    echo "ERROR: $UPLOAD not found. Run 'make upload-tool' first."
+    exit 1
+fi
+
+PROJECTS="$*"
+if [ -z "$PROJECTS" ]; then
+    for dir in "$SDK"/projects/*/; do
+        if grep -qs '#include "bench.h"' "$dir"*.c; then
+            PROJECTS="$PROJECTS $(basename "$dir")"
+        fi
+    done
+fi
+if [ -z "$PROJECTS" ]; then
+    echo "ERROR: no benchmark projects (none includes common/bench.h)"
+    exit 1
+fi
+
+#------------------------------------------------------------------------------
+# Run
+#------------------------------------------------------------------------------
+
+mkdir -p "$OUT"
+: > "$RESULTS"
+: > "$OUT/failed.txt"
+
+# run <project>: upload and run it, append its results
+run() {
+    local p=$1 bin="${BINDIR:-$SDK/projects/$1}/$1.bin" log="$OUT/$1.log" rc=0
+    local keys
+
+    keys=$(sed -n 's|^// BENCH_KEYS: *||p' "$SDK/projects/$p"/*.c 2> /dev/null | tr -d '\r' | head -1)
+
+    echo ""
+    echo "========================================="
+    echo "$p"
+    echo "========================================="
+    if [ ! -f "$bin" ]; then
+        echo "$p not built" >> "$OUT/failed.txt"
+        echo "  ✗ $bin not found"
+        return 0
+    fi
+
+    # Held open throughout: what the overlay prints while fw_upload_fast
+    # exits stays in the tty buffer
+    exec 3<> "$PORT"
+    stty -F "$PORT" "$BAUD" raw -echo
+
+    printf "$MENU_KEYS" >&3
+    sleep 1
+    if ! "$UPLOAD" -p "$PORT" -b "$BAUD" "$bin" > "$OUT/upload_$p.log" 2>&1; then
+        exec 3>&-
+        echo "$p upload failed" >> "$OUT/failed.txt"
+        echo "  ✗ upload failed (see $OUT/upload_$p.log)"
+        return 0
+    fi
+    stty -F "$PORT" "$BAUD" raw -echo
+    if [ -n "$keys" ]; then
+        printf '%b' "$keys" >&3             # RX FIFO holds them until read
+    fi
+
+    timeout "$TIMEOUT" sed -u -n "/$DONE_TEXT/q;p" <&3 > "$log.raw" || rc=$?
+    printf ' ' >&3                      # Result screen: any key
+    exec 3>&-
+    tr -d '\r' < "$log.raw" > "$log"
+    rm -f "$log.raw"
+
+    if [ "$rc" != "0" ]; then
+        echo "$p no return within ${TIMEOUT} s" >> "$OUT/failed.txt"
+        echo "  ✗ did not return within ${TIMEOUT} s (see $log)"
+    fi
+
+    # PERF and BENCH lines of one result joined on the name
+    awk -v project="$p" '
+        /^PERF [^ ]* iters=[0-9]* cyc_per_iter=[0-9]*$/ {
+            name = $2; split($3, a, "="); split($4, b, "=")
+            order[++n] = name; iters[name] = a[2]; cpi[name] = b[2]
+        }
+        /^BENCH [^ ]* cycles=[0-9]* instret=[0-9]* cpi_x100=[0-9]*$/ {
+            split($3, a, "="); split($4, b, "="); split($5, c, "=")
+            cyc[$2] = a[2]; ins[$2] = b[2]; x100[$2] = c[2]
+        }
+        END {
+            for (i = 1; i <= n; i++) {
+                k = order[i]
+                printf "%s %s %s %s %s %s %s\n", project, k, iters[k], cpi[k],
+                    (k in cyc) ? cyc[k] : "-", (k in ins) ? ins[k] : "-",
+                    (k in x100) ? x100[k] : "-"
+                printf "  %-28s %10s cycles/iter\n", k, cpi[k] > "/dev/stderr"
+            }
+        }' "$log" >> "$RESULTS"
+    sleep 1
+}
+
+for p in $PROJECTS; do
+    run "$p"
+done
+
+#------------------------------------------------------------------------------
+# Report
+#------------------------------------------------------------------------------
+
+COMMIT=$(git rev-parse --short HEAD 2> /dev/null || echo unknown)
+DATE=$(date -u +%Y-%m-%dT%H:%M:%SZ)
+
+awk -v commit="$COMMIT" -v date="$DATE" -v failed="$OUT/failed.txt" '
+    function num(v) { return v == "-" ? "null" : v }
+    { p[NR] = $1; name[NR] = $2; it[NR] = $3; cpi[NR] = $4; cyc[NR] = $5; ins[NR] = $6; x100[NR] = $7 }
+    END {
+        printf "{\n  \"commit\": \"%s\",\n  \"date\": \"%s\",\n  \"results\": {", commit, date
+        for (i = 1; i <= NR; i++) {
+            if (i == 1 || p[i] != p[i - 1])
+                printf "%s\n    \"%s\": {", (i > 1 ? "\n    }," : ""), p[i]
+            else
+                printf ","
+            printf "\n      \"%s\": { \"iters\": %s, \"cyc_per_iter\": %s, \"cycles\": %s, \"instret\": %s, \"cpi_x100\": %s }",
+                name[i], it[i], cpi[i], num(cyc[i]), num(ins[i]), num(x100[i])
+        }
+        printf "%s},\n  \"failed\": [", (NR ? "\n    }\n  " : "")
+        n = 0
+        while ((getline l < failed) > 0) {
+            proj = l
+            sub(/ .*/, "", proj)
+            sub(/^[^ ]* /, "", l)
+            printf "%s\n    { \"project\": \"%s\", \"reason\": \"%s\" }", (n++ ? "," : ""), proj, l
+        }
+        printf "%s]\n}\n", (n ? "\n  " : "")
+    }' "$RESULTS" > "$OUT/report.json"
+
+{
+    echo "# Overlay benchmarks ($COMMIT, $DATE)"
+    echo ""
+    echo "Best of BENCH_RUNS runs each (common/bench.h), CPU cycles."
+    echo ""
+    echo "| Project | Benchmark | Iterations | Cycles/iter | Cycles | Instructions | CPI |"
+    echo "|---------|-----------|-----------:|------------:|-------:|-------------:|----:|"
+    awk '{ cpi = $7 == "-" ? "-" : sprintf("%.2f", $7 / 100)
+           printf "| %s | %s | %s | %s | %s | %s | %s |\n", $1, $2, $3, $4, $5, $6, cpi }' "$RESULTS"
+    if [ -s "$OUT/failed.txt" ]; then
+        echo ""
+        echo "Failed:"
+        sed 's/^\([^ ]*\) \(.*\)$/- \1: \2/' "$OUT/failed.txt"
+    fi
+} > "$OUT/report.md"
+
+echo ""
+cat "$OUT/report.md"
+echo ""
+echo "Report: $OUT/report.json, $OUT/report.md"
+
+[ ! -s "$OUT/failed.txt" ]
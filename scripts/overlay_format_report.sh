@@ -0,0 +1,62 @@
+#!/bin/bash
+# Flat .bin vs relocatable .ovl container size for the overlay SDK projects
+#
+# Builds every project in firmware/overlay_sdk/projects (the .bin as
+# before, plus <project>.rel.elf and the .ovl made from it by
+# tools/ovlpack) and compares the bytes each format puts on the SD card.
+# The .ovl leaves out .bss and zero runs and adds a segment table and
+# one word per relocation, so small overlays with no zero data can come
+# out a little bigger.
+#
+# Usage: scripts/overlay_format_report.sh
+
+set -e
+
+MAKE=${MAKE:-make}
+PROJECTS_DIR=firmware/overlay_sdk/projects
+OVLPACK=tools/ovlpack/ovlpack
+
+if [ ! -x "$OVLPACK" ]; then
+    $MAKE -C tools/ovlpack
+fi
+
+PROJECTS=$(cd "$PROJECTS_DIR" && for d in */; do [ -f "$d/Makefile" ] && echo "${d%/}"; done)
+
+#------------------------------------------------------------------------------
+# Build
+#------------------------------------------------------------------------------
+
+for p in $PROJECTS; do
+    echo "========================================="
+    echo "Building overlay: $p"
+    echo "========================================="
+    $MAKE -C "$PROJECTS_DIR/$p" "$p.bin" "$p.ovl"
+done
+
+#------------------------------------------------------------------------------
+# Report
+#------------------------------------------------------------------------------
+
+file_size() {
+    wc -c < "$1" | tr -d ' '
+}
+
+echo ""
+echo "========================================="
+echo "Overlay image size: flat .bin vs .ovl (bytes)"
+echo "========================================="
+printf "%-20s %10s %10s %10s %8s\n" "Overlay" ".bin" ".ovl" "Saved" ""
+TOTAL_BIN=0
+TOTAL_OVL=0
+for p in $PROJECTS; do
+    BIN=$(file_size "$PROJECTS_DIR/$p/$p.bin")
+    OVL=$(file_size "$PROJECTS_DIR/$p/$p.ovl")
+    TOTAL_BIN=$((TOTAL_BIN + BIN))
+    TOTAL_OVL=$((TOTAL_OVL + OVL))
+    awk -v n="$p" -v a="$BIN" -v b="$OVL" 'BEGIN {
+        printf "%-20s %10d %10d %10d %7.1f%%\n", n, a, b, a - b, a ? 100 * (a - b) / a : 0
+    }'
+done
+awk -v a="$TOTAL_BIN" -v b="$TOTAL_OVL" 'BEGIN {
+    printf "%-20s %10d %10d %10d %7.1f%%\n", "Total", a, b, a - b, a ? 100 * (a - b) / a : 0
+}'
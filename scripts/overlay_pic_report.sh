@@ -0,0 +1,118 @@
+#!/bin/bash
+# Overlay code cost of PIC: the same overlays built with OVERLAY_PIC=1
+# (default, every global through its GOT entry) and OVERLAY_PIC=0 (linked
+# for 0x60000, gp-relative small data; Makefile.overlay)
+#
+# Builds each project both ways into build/overlay_pic/{fixed,pic}/ and
+# compares .text and .got size, instruction count and the number of
+# GOT loads and gp-relative accesses in the code. With -p the two sets of
+# .bin files are run on the board by scripts/overlay_bench.sh and their
+# cycles per iteration are compared as well (the board must be at the SD
+# card manager's main menu).
+#
+# The projects are left built with PIC, as 'make projects' builds them.
+#
+# Usage: scripts/overlay_pic_report.sh [-p PORT] [-b BAUD] [project...]
+#   (default projects: mandelbrot_fixed heap_test bench_core)
+
+set -e
+
+MAKE=${MAKE:-make}
+PREFIX=${PREFIX:-riscv64-unknown-elf-}
+PROJECTS_DIR=firmware/overlay_sdk/projects
+OUT=build/overlay_pic
+PORT=""
+BAUD=115200
+
+while getopts "p:b:" opt; do
+    case $opt in
+        p) PORT=$OPTARG ;;
+        b) BAUD=$OPTARG ;;
+        *) echo "Usage: $0 [-p PORT] [-b BAUD] [project...]"; exit 1 ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+PROJECTS=${*:-mandelbrot_fixed heap_test bench_core}
+
+#------------------------------------------------------------------------------
+# Build (fixed first: the PIC build is what stays in the project)
+#------------------------------------------------------------------------------
+
+for mode in fixed pic; do
+    pic=$([ "$mode" = "pic" ] && echo 1 || echo 0)
+    mkdir -p "$OUT/$mode"
+    for p in $PROJECTS; do
+        echo "========================================="
+        echo "Building overlay: $p (OVERLAY_PIC=$pic)"
+        echo "========================================="
+        $MAKE -C "$PROJECTS_DIR/$p" clean > /dev/null
+        $MAKE -C "$PROJECTS_DIR/$p" OVERLAY_PIC=$pic "$p.bin"
+        cp "$PROJECTS_DIR/$p/$p.elf" "$PROJECTS_DIR/$p/$p.bin" "$OUT/$mode/"
+    done
+done
+
+#------------------------------------------------------------------------------
+# Static report
+#------------------------------------------------------------------------------
+
+# section_size <elf> <section>: bytes (0 if absent)
+section_size() {
+    ${PREFIX}size -A "$1" | awk -v s="$2" '$1 == s { print $2; f = 1 } END { if (!f) print 0 }'
+}
+
+# code_stats <elf>: instructions, GOT loads, gp-relative accesses
+code_stats() {
+    ${PREFIX}objdump -d -j .text "$1" | awk -F'\t' '
+        NF >= 3 && $1 ~ /^ *[0-9a-f]+:$/ { n++ }
+        /_GLOBAL_OFFSET_TABLE_|<\.got/ { got++ }
+        $4 ~ /\(gp\)|,gp,/ { gp++ }
+        END { printf "%d %d %d\n", n, got, gp }'
+}
+
+{
+    echo "# Overlay PIC overhead ($(git rev-parse --short HEAD 2> /dev/null || echo unknown))"
+    echo ""
+    echo "| Project | Build | .text | .got | Instructions | GOT loads | gp accesses | .bin |"
+    echo "|---------|-------|------:|-----:|-------------:|----------:|------------:|-----:|"
+    for p in $PROJECTS; do
+        for mode in pic fixed; do
+            elf="$OUT/$mode/$p.elf"
+            read -r insns got gp <<< "$(code_stats "$elf")"
+            echo "| $p | $mode | $(section_size "$elf" .text) | $(section_size "$elf" .got) |" \
+                 "$insns | $got | $gp | $(wc -c < "$OUT/$mode/$p.bin" | tr -d ' ') |"
+        done
+    done
+} > "$OUT/report.md"
+
+#------------------------------------------------------------------------------
+# Run both sets on the board
+#------------------------------------------------------------------------------
+
+if [ -n "$PORT" ]; then
+    for mode in pic fixed; do
+        scripts/overlay_bench.sh -p "$PORT" -b "$BAUD" -B "$OUT/$mode" \
+            -o "$OUT/$mode/bench" $PROJECTS || true
+    done
+
+    {
+        echo ""
+        echo "| Benchmark | PIC cycles/iter | Fixed cycles/iter | Change |"
+        echo "|-----------|----------------:|------------------:|-------:|"
+        awk 'FILENAME == ARGV[1] { pic[$2] = $4; order[++n] = $2 }
+             FILENAME == ARGV[2] { fixed[$2] = $4 }
+             END {
+                 for (i = 1; i <= n; i++) {
+                     k = order[i]
+                     if (!(k in fixed)) continue
+                     printf "| %s | %s | %s | %+.1f%% |\n", k, pic[k], fixed[k],
+                         pic[k] ? 100 * (fixed[k] - pic[k]) / pic[k] : 0
+                 }
+             }' "$OUT/pic/bench/results.txt" "$OUT/fixed/bench/results.txt"
+    } >> "$OUT/report.md"
+fi
+
+echo ""
+cat "$OUT/report.md"
+echo ""
+echo "Report: $OUT/report.md"
@@ -0,0 +1,210 @@
+#!/bin/bash
+# Cycle-count regression check on the Verilator model
+#
+# Runs a fixed benchmark set on build/verilator/picorv32_sim (sim/verilator,
+# built from the current .config), collects the
+#   PERF <name> iters=<n> cyc_per_iter=<n>
+# lines the firmware prints and compares them against the checked-in
+# baseline sim/verilator/perf_baseline.json. The model is cycle-exact and
+# the inputs are scripted, so every run of the same tree gives the same
+# counts; anything slower than the baseline by more than the threshold
+# fails the run.
+#
+#   algo_crc32          algo_test 4: table CRC32 of 100 KB (cycles per byte)
+#   algo_crc32_slice4   algo_test 4: lib/crc32.c slicing-by-4, same data
+#   memcpy_64/_4k       memops_bench: lib/memops memcpy (cycles per call)
+#   sram_*              mem_bench: 64 KB SRAM word read/write/copy (cycles
+#                       per KB), dependent load at stride 16 (cycles per load)
+#   mandelbrot_fixed    mandelbrot_fixed: first 80x24 frame (cycles per iteration)
+#   fatfs_read          fatfs_bench: 64 KB f_read from an SD image (cycles per sector)
+#   rtos_tick/_switch   freertos_isr_bench: tick ISR, tick + two context switches
+#   rtos_switch_top     freertos_isr_bench: the same to a task at the top priority
+#   rtos_yield          freertos_isr_bench: taskYIELD() ping-pong (cycles per switch,
+#                       the port's yield waits for the next tick)
+#   coop_yield/_wake    coop_bench: lib/coop yield ping-pong (cycles per switch),
+#                       software IRQ to the waiting task running
+#   irq_lat_spin/_sram  irq_latency_bench: timer IRQ to the dispatched handler,
+#                       CPU spinning / copying through SRAM (average cycles)
+#   rtos_irq_lat/_sram  freertos_irq_latency: the same to the FreeRTOS port's ISR
+#   rtos_irq_wake       freertos_irq_latency: timer IRQ to the woken task running
+#
+# The names in the baseline are the tracked set; a null value is not
+# compared yet. The baseline holds for configs/defconfig: record a new one
+# with -u after a change that is meant to move the numbers (or on another
+# configuration) and commit it with the change.
+#
+# Usage: scripts/perf_regress.sh [-t PCT] [-u] [-n]
+#   -t PCT    Allowed slowdown in percent (default 2)
+#   -u        Write the measured counts to the baseline instead of failing
+#   -n        Reuse the model and firmware from a previous run (no rebuild)
+
+set -e
+
+THRESHOLD=2
+UPDATE=0
+REBUILD=1
+MAKE=${MAKE:-make}
+
+while getopts "t:un" opt; do
+    case $opt in
+        t) THRESHOLD=$OPTARG ;;
+        u) UPDATE=1 ;;
+        n) REBUILD=0 ;;
+        *) echo "Usage: $0 [-t PCT] [-u] [-n]"; exit 1 ;;
+    esac
+done
+
+BASELINE=sim/verilator/perf_baseline.json
+SIM=build/verilator/picorv32_sim
+OUT=build/perf_regress
+RESULTS=$OUT/results.txt
+SD_IMAGE=$OUT/sd.img
+FIRMWARE="fw-algo-test fw-memops-bench fw-mem-bench fw-mandelbrot-fixed fw-fatfs-bench fw-freertos-isr-bench fw-coop-bench fw-irq-latency-bench fw-freertos-irq-latency"
+
+# Any single benchmark finishes well inside this (a few seconds of 50 MHz)
+MAX_CYCLES=1000000000
+
+#------------------------------------------------------------------------------
+# Helpers
+#------------------------------------------------------------------------------
+
+# Baseline as "name value" lines (value: count or null)
+baseline() {
+    sed -n 's/^ *"\([^"]*\)" *: *\([0-9a-z]*\) *,\{0,1\} *$/\1 \2/p' "$BASELINE"
+}
+
+# run <firmware> <until-text> <input> [simulator options...]
+# Append the PERF lines of one simulation to $RESULTS
+run() {
+    local fw=$1 until=$2 input=$3 log="$OUT/$1.log" rc=0
+    shift 3
+
+    echo "  $fw"
+    "$SIM" -n -q -c "$MAX_CYCLES" -u "$until" -i "$input" "$@" "firmware/${fw}.elf" \
+        > "$log" 2>&1 || rc=$?
+    if [ "$rc" != "0" ]; then
+        echo "  ✗ $fw did not reach '$until' (simulator exit $rc, see $log)"
+        FAILED=1
+        return 0
+    fi
+    tr -d '\r' < "$log" | \
+        sed -n 's/^PERF \([^ ]*\) iters=[0-9]* cyc_per_iter=\([0-9]*\)$/\1 \2/p' >> "$RESULTS"
+}
+
+#------------------------------------------------------------------------------
+# Build + run
+#------------------------------------------------------------------------------
+
+if [ ! -f "$BASELINE" ]; then
+    echo "ERROR: $BASELINE not found"
+    exit 1
+fi
+
+if [ "$REBUILD" = "1" ]; then
+    $MAKE generate
+    $MAKE -C sim/verilator
+    for t in $FIRMWARE; do
+        $MAKE "$t"
+    done
+fi
+
+if [ ! -x "$SIM" ]; then
+    echo "ERROR: $SIM not found. Run 'make sim-verilator' first."
+    exit 1
+fi
+
+mkdir -p "$OUT"
+: > "$RESULTS"
+FAILED=0
+
+# Blank card every run: fatfs_bench formats it (F) and writes its file
+# before the timed read, so the image layout is always the same
+rm -f "$SD_IMAGE"
+dd if=/dev/zero of="$SD_IMAGE" bs=1M count=4 2> /dev/null
+
+echo ""
+echo "========================================="
+echo "Running benchmarks on the Verilator model"
+echo "========================================="
+
+# Menu key, then 4 = CRC32 (PERF line comes before the expected value)
+run algo_test "Expected:" " 4"
+# Press-any-key verifies, then times every routine 4 B - 64 KB
+run memops_bench "Benchmark complete" " "
+# Press-any-key times every region and width, then the strides
+run mem_bench "Benchmark complete" " "
+# Start, a fixed 24x80 reply to the terminal size query, q after the first frame
+run mandelbrot_fixed "Performance:" " \\e[24;80Rq"
+# Start, F formats the blank image
+run fatfs_bench "Benchmark complete" " F" -d "$SD_IMAGE"
+# Runs on its own; PERF lines come before the per-run summary
+run freertos_isr_bench "Tick + switch" ""
+# Runs on its own; PERF lines come before the per-run summary
+run coop_bench "IRQ wake" ""
+# Press-any-key runs the three scenarios
+run irq_latency_bench "Benchmark complete" " "
+# Runs on its own; PERF lines come before the per-run summary
+run freertos_irq_latency "Wake, idle" ""
+
+#------------------------------------------------------------------------------
+# Compare / update
+#------------------------------------------------------------------------------
+
+echo ""
+echo "========================================="
+echo "Cycle counts against $BASELINE"
+echo "========================================="
+
+if [ "$UPDATE" = "1" ]; then
+    if [ "$FAILED" = "1" ]; then
+        echo "ERROR: not all benchmarks ran, baseline left unchanged"
+        exit 1
+    fi
+    TMP=$(mktemp)
+    baseline | awk -v results="$RESULTS" '
+        BEGIN { while ((getline l < results) > 0) { split(l, f, " "); m[f[1]] = f[2] } }
+        { name[++n] = $1 }
+        END {
+            print "{"
+            for (i = 1; i <= n; i++)
+                printf "    \"%s\": %s%s\n", name[i], (name[i] in m) ? m[name[i]] : "null", i < n ? "," : ""
+            print "}"
+        }' > "$TMP"
+    cat "$TMP" > "$BASELINE"
+    rm -f "$TMP"
+    cat "$BASELINE"
+    echo ""
+    echo "✓ Baseline updated: $BASELINE"
+    exit 0
+fi
+
+REGRESSED=0
+baseline | awk -v results="$RESULTS" -v limit="$THRESHOLD" '
+    BEGIN {
+        while ((getline l < results) > 0) { split(l, f, " "); m[f[1]] = f[2] }
+        printf "%-20s %12s %12s %9s\n", "Benchmark", "Baseline", "Measured", "Change"
+    }
+    {
+        if (!($1 in m)) {
+            printf "%-20s %12s %12s %9s  ✗ not reported\n", $1, $2, "-", "-"
+            bad = 1
+        } else if ($2 == "null") {
+            printf "%-20s %12s %12s %9s  (no baseline yet)\n", $1, "-", m[$1], "-"
+        } else {
+            pct = $2 ? (m[$1] - $2) * 100.0 / $2 : 0
+            note = ""
+            if (pct > limit) { note = "  ✗ REGRESSED"; bad = 1 }
+            else if (pct < -limit) note = "  (faster: record with -u)"
+            printf "%-20s %12s %12s %+8.2f%%%s\n", $1, $2, m[$1], pct, note
+        }
+    }
+    END { exit bad }' || REGRESSED=1
+
+echo ""
+echo "Raw results: $RESULTS"
+
+if [ "$FAILED" = "1" ] || [ "$REGRESSED" = "1" ]; then
+    echo "✗ Performance regression check failed (threshold ${THRESHOLD}%)"
+    exit 1
+fi
+echo "✓ No regression over ${THRESHOLD}%"
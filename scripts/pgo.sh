@@ -0,0 +1,132 @@
+#!/bin/bash
+# Profile-guided optimization of the SD card manager (make pgo)
+#
+# 1. Builds sd_card_manager instrumented (firmware/Makefile PGO=gen): every
+#    object counts its branches and values, lib/pgo dumps the counters as
+#    PGO lines on the UART (on 'q', or 'P' in the main menu) and to
+#    /PGO.TXT on the card.
+# 2. Runs a workload on the Verilator model with a FAT image in the SD slot
+#    (detect, the read/write benchmark with its IOPS test, quit), or takes
+#    the PGO lines of a run on the board (-l: a UART capture or PGO.TXT).
+# 3. Writes the .gcda files the dump names, next to the objects.
+# 4. Rebuilds with them (PGO=use): GCC lays out, inlines and unrolls for
+#    the paths the workload took.
+#
+# The profile holds for the source it was taken from; after a change run
+# this again (PGO=use builds objects without a profile as usual).
+#
+# Overlays (firmware/overlay_sdk, PGO=gen) dump when they exit: capture
+# their UART output on the board, decode it with -l ... -s, then
+#   make -C firmware/overlay_sdk/projects/<name> PGO=use
+#
+# Usage: scripts/pgo.sh [-w KEYS] [-c CYCLES] [-l capture.log] [-s]
+#   -w KEYS     Workload keys for the simulator run (\r \e \xHH escapes)
+#   -c CYCLES   Simulation cycle limit (default 20000000000)
+#   -l FILE     Decode the PGO lines in FILE instead of simulating
+#   -s          Only write the .gcda files (no PGO=use rebuild)
+
+set -e
+
+# Main menu: Enter = Detect Card (mounts it), any key back; 11 x j to
+# Benchmark, Enter, I for the IOPS test, any key back; q dumps and quits
+WORKLOAD='\r jjjjjjjjjjj\rI q'
+MAX_CYCLES=20000000000
+CAPTURE=
+REBUILD=1
+MAKE=${MAKE:-make}
+
+while getopts "w:c:l:s" opt; do
+    case $opt in
+        w) WORKLOAD=$OPTARG ;;
+        c) MAX_CYCLES=$OPTARG ;;
+        l) CAPTURE=$OPTARG ;;
+        s) REBUILD=0 ;;
+        *) echo "Usage: $0 [-w KEYS] [-c CYCLES] [-l capture.log] [-s]"; exit 1 ;;
+    esac
+done
+
+SIM=build/verilator/picorv32_sim
+OUT=build/pgo
+SD_IMAGE=$OUT/sd.img
+LOG=$OUT/sim.log
+
+mkdir -p "$OUT"
+
+#------------------------------------------------------------------------------
+# Instrumented run
+#------------------------------------------------------------------------------
+
+if [ -z "$CAPTURE" ]; then
+    if ! command -v mkfs.fat >/dev/null 2>&1; then
+        echo "ERROR: mkfs.fat not found (dosfstools) for the SD card image"
+        exit 1
+    fi
+
+    $MAKE generate
+    $MAKE -C sim/verilator
+    $MAKE -C firmware sd_card_manager PGO=gen
+
+    # 32 MB FAT32 card, blank: the benchmark writes its own test file
+    rm -f "$SD_IMAGE"
+    mkfs.fat -C -F 32 -n PGO "$SD_IMAGE" 32768 > /dev/null
+
+    echo ""
+    echo "========================================="
+    echo "Running the workload on the Verilator model"
+    echo "========================================="
+    rc=0
+    "$SIM" -n -q -c "$MAX_CYCLES" -u "PGO end" -i "$WORKLOAD" -d "$SD_IMAGE" \
+        firmware/sd_card_manager.elf > "$LOG" 2>&1 || rc=$?
+    if [ "$rc" != "0" ]; then
+        echo "✗ Workload did not reach the profile dump (simulator exit $rc, see $LOG)"
+        exit 1
+    fi
+    CAPTURE=$LOG
+fi
+
+if [ ! -f "$CAPTURE" ]; then
+    echo "ERROR: $CAPTURE not found"
+    exit 1
+fi
+
+#------------------------------------------------------------------------------
+# PGO lines to .gcda files
+#------------------------------------------------------------------------------
+
+# The last dump in the capture (counters are cumulative); lines may follow
+# terminal output on the same line
+tr -d '\r' < "$CAPTURE" | sed -n 's/^.*\(PGO .*\)$/\1/p' | \
+    awk '/^PGO begin/ { n = 0 } { l[++n] = $0 } END { for (i = 1; i <= n; i++) print l[i] }' \
+    > "$OUT/dump.txt"
+
+if ! grep -q '^PGO end' "$OUT/dump.txt"; then
+    echo "ERROR: no complete PGO dump in $CAPTURE (not a PGO=gen build?)"
+    exit 1
+fi
+
+# Stale profiles of objects the workload no longer reaches would be used
+# as they are: drop them first
+find firmware lib downloads/freertos downloads/lwip \
+     -name '*.gcda' -delete 2>/dev/null || true
+
+FILES=$(perl -ne '
+    if (/^PGO file (.+)$/) {
+        close(OUT) if $open;
+        $open = 0;
+        if ($1 ne "-") { open(OUT, ">:raw", $1) or die "$1: $!\n"; $open = 1; $n++ }
+    } elsif (/^PGO ([0-9a-f]+)$/) {
+        print OUT pack("H*", $1) if $open;
+    }
+    END { close(OUT) if $open; print $n + 0 }' "$OUT/dump.txt")
+
+echo "✓ $FILES profiles written ($(sed -n 's/^PGO begin //p' "$OUT/dump.txt"))"
+
+#------------------------------------------------------------------------------
+# Optimized build
+#------------------------------------------------------------------------------
+
+if [ "$REBUILD" = "1" ]; then
+    $MAKE -C firmware sd_card_manager PGO=use
+    echo ""
+    echo "✓ firmware/sd_card_manager.elf built with the profile"
+fi
@@ -0,0 +1,170 @@
+#!/bin/bash
+# Per-function report of a sampling profiler dump (lib/profiler)
+#
+# Reads the PROF lines firmware prints with profiler_dump() (hexedit_fast
+# "prof dump" / "prof <command>") from a UART capture, maps every bucket to
+# the function containing it with objdump -t and prints the samples per
+# function. With -l the hottest buckets are also listed with their source
+# line (addr2line).
+#
+# A bucket that spans the end of one function and the start of the next is
+# counted for the first; "prof" in hexedit_fast prints the bucket size.
+#
+# With -o the listed functions also go to a hot function list, hottest
+# first, for scripts/gen_linker.sh (Kconfig HOT_PLACEMENT): one
+# "<name> <size> <samples>" line each.
+#
+# Usage: scripts/prof_report.sh [-n N] [-l] [-o hot.txt] <firmware.elf> [capture.log]
+#   -n N      Functions (and buckets with -l) listed (default 30, 0: all)
+#   -l        Also list the hottest buckets with file:line
+#   -o FILE   Write the listed functions as a hot function list
+#   The capture is read from stdin when no file is given.
+#
+# OBJDUMP / ADDR2LINE override the tools (default: the RISC-V toolchain
+# in build/toolchain, else riscv64-unknown-elf- on the PATH).
+
+set -e
+
+TOP=30
+LINES=0
+HOTFILE=
+
+while getopts "n:lo:" opt; do
+    case $opt in
+        n) TOP=$OPTARG ;;
+        l) LINES=1 ;;
+        o) HOTFILE=$OPTARG ;;
+        *) echo "Usage: $0 [-n N] [-l] [-o hot.txt] <firmware.elf> [capture.log]"; exit 1 ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+ELF=$1
+LOG=${2:--}
+
+if [ -z "$ELF" ]; then
+    echo "Usage: $0 [-n N] [-l] [-o hot.txt] <firmware.elf> [capture.log]"
+    exit 1
+fi
+if [ ! -f "$ELF" ]; then
+    echo "ERROR: $ELF not found"
+    exit 1
+fi
+
+# Toolchain (as scripts/build_firmware.sh)
+if [ -x "build/toolchain/bin/riscv64-unknown-elf-gcc" ]; then
+    PREFIX="build/toolchain/bin/riscv64-unknown-elf-"
+elif [ -x "build/toolchain/bin/riscv32-unknown-elf-gcc" ]; then
+    PREFIX="build/toolchain/bin/riscv32-unknown-elf-"
+else
+    PREFIX="riscv64-unknown-elf-"
+fi
+OBJDUMP=${OBJDUMP:-${PREFIX}objdump}
+ADDR2LINE=${ADDR2LINE:-${PREFIX}addr2line}
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+# "addr count" (hex) per bucket and the header line of the last dump
+if [ "$LOG" = "-" ]; then
+    tr -d '\r' > "$TMP/log"
+else
+    tr -d '\r' < "$LOG" > "$TMP/log"
+fi
+sed -n 's/^.*PROF \([0-9a-f]\{8\}\) \([0-9a-f]\{1,8\}\)$/\1 \2/p' "$TMP/log" > "$TMP/buckets"
+HEADER=$(sed -n 's/^.*PROF begin \(.*\)$/\1/p' "$TMP/log" | tail -1)
+
+if [ ! -s "$TMP/buckets" ]; then
+    echo "ERROR: no PROF lines in ${2:-stdin}"
+    exit 1
+fi
+
+# Function symbols: "addr size name", by address
+"$OBJDUMP" -t "$ELF" | \
+    awk '/ F / && NF >= 6 { print $1, $(NF-1), $NF }' | sort > "$TMP/syms"
+
+awk -v top="$TOP" -v header="$HEADER" -v symfile="$TMP/syms" -v hotfile="$HOTFILE" '
+    function hex(s,    i, n, c) {
+        n = 0
+        s = tolower(s)
+        for (i = 1; i <= length(s); i++) {
+            c = index("0123456789abcdef", substr(s, i, 1))
+            if (c == 0) break
+            n = n * 16 + c - 1
+        }
+        return n
+    }
+    # Function containing a, else the first one starting in [a, a + span)
+    function owner(a, span,    lo, hi, mid) {
+        lo = 1; hi = ns
+        while (lo < hi) {
+            mid = int((lo + hi + 1) / 2)
+            if (sa[mid] <= a) lo = mid; else hi = mid - 1
+        }
+        if (ns && sa[lo] <= a && a < sa[lo] + sz[lo]) return sn[lo]
+        if (ns && sa[lo] > a && sa[lo] < a + span) return sn[lo]
+        if (lo < ns && sa[lo + 1] > a && sa[lo + 1] < a + span) return sn[lo + 1]
+        return "(no symbol)"
+    }
+    BEGIN {
+        while ((getline l < symfile) > 0) {
+            split(l, f, " ")
+            ns++; sa[ns] = hex(f[1]); sz[ns] = hex(f[2]); sn[ns] = f[3]
+            size[f[3]] = sz[ns]
+        }
+        span = 4
+        if (match(header, /shift=[0-9]+/))
+            span = 2 ^ substr(header, RSTART + 6, RLENGTH - 6)
+    }
+    {
+        n = hex($2)
+        fn = owner(hex($1), span)
+        if (!(fn in cnt)) order[++nf] = fn
+        cnt[fn] += n
+        total += n
+    }
+    END {
+        if (header != "") print "Profile: " header
+        printf "%d samples in .text/.fastcode, %d byte buckets\n\n", total, span
+        # Selection sort by count (small lists)
+        for (i = 1; i <= nf; i++)
+            for (j = i + 1; j <= nf; j++)
+                if (cnt[order[j]] > cnt[order[i]]) { t = order[i]; order[i] = order[j]; order[j] = t }
+        printf "%9s %7s %7s  %s\n", "Samples", "%", "Cum %", "Function"
+        cum = 0
+        for (i = 1; i <= nf && (top == 0 || i <= top); i++) {
+            cum += cnt[order[i]]
+            printf "%9d %6.2f%% %6.2f%%  %s\n", cnt[order[i]], 100 * cnt[order[i]] / total,
+                   100 * cum / total, order[i]
+            if (hotfile != "" && order[i] != "(no symbol)") {
+                if (!hot++) print "# Hot functions: name, size (bytes), samples" > hotfile
+                print order[i], size[order[i]], cnt[order[i]] > hotfile
+            }
+        }
+        if (top && nf > top) printf "%9s  ... %d more functions (-n 0 lists all)\n", "", nf - top
+    }' "$TMP/buckets"
+
+if [ -n "$HOTFILE" ]; then
+    echo ""
+    echo "Hot function list: $HOTFILE"
+fi
+
+if [ "$LINES" = "1" ]; then
+    echo ""
+    printf "%9s  %-10s  %s\n" "Samples" "Bucket" "Function / source line"
+    awk '
+        function hex(s,    i, n, c) {
+            n = 0
+            for (i = 1; i <= length(s); i++) {
+                c = index("0123456789abcdef", substr(s, i, 1))
+                if (c == 0) break
+                n = n * 16 + c - 1
+            }
+            return n
+        }
+        { print hex($2), $1 }' "$TMP/buckets" | sort -rn | \
+        if [ "$TOP" = "0" ]; then cat; else head -n "$TOP"; fi > "$TMP/hot"
+    awk '{ print "0x" $2 }' "$TMP/hot" | "$ADDR2LINE" -f -s -e "$ELF" | paste - - > "$TMP/where"
+    paste "$TMP/hot" "$TMP/where" | \
+        awk -F '\t' '{ split($1, h, " "); printf "%9d  0x%s  %s  %s\n", h[1], h[2], $2, $3 }'
+fi
@@ -0,0 +1,128 @@
+#!/bin/bash
+# FreeRTOS task selection sweep on the Verilator model
+#
+# Builds freertos_isr_bench once per CONFIG_FREERTOS_MAX_PRIORITIES setting,
+# with generic and with port-optimised task selection (ready bitmap,
+# lib/freertos_port/portmacro.h), runs each on build/verilator/picorv32_sim
+# and reports the tick + switch cost to a priority 2 task (rtos_switch) and
+# to one at the top priority (rtos_switch_top). The generic selection walks
+# down every empty ready list between the two, so its top-priority cost
+# grows with the number of priorities; the bitmap's should not.
+#
+# The settings are layered over .config, which is restored afterwards.
+#
+# Usage: scripts/rtos_prio_sweep.sh [-n] [priorities...]   (default: 5 16 32)
+#   -n        Reuse the model from a previous run (firmware is always rebuilt)
+# Results: build/rtos_prio_sweep/<prios>_<selection>.log
+
+set -e
+
+REBUILD=1
+MAKE=${MAKE:-make}
+
+while getopts "n" opt; do
+    case $opt in
+        n) REBUILD=0 ;;
+        *) echo "Usage: $0 [-n] [priorities...]"; exit 1 ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+PRIOS="$*"
+if [ -z "$PRIOS" ]; then
+    PRIOS="5 16 32"
+fi
+
+SIM=build/verilator/picorv32_sim
+OUT=build/rtos_prio_sweep
+RESULTS=$OUT/results.txt
+MAX_CYCLES=1000000000
+
+for n in $PRIOS; do
+    if [ "$n" -lt 2 ] || [ "$n" -gt 32 ]; then
+        echo "ERROR: $n priorities (Kconfig range 2-32)"
+        exit 1
+    fi
+done
+
+if [ ! -f .config ]; then
+    echo "ERROR: .config not found. Run 'make menuconfig' or 'make defconfig' first."
+    exit 1
+fi
+
+mkdir -p "$OUT"
+cp .config "$OUT/base.config"
+trap 'cp "$OUT/base.config" .config' EXIT
+: > "$RESULTS"
+
+if [ "$REBUILD" = "1" ]; then
+    $MAKE generate
+    $MAKE -C sim/verilator
+fi
+
+if [ ! -x "$SIM" ]; then
+    echo "ERROR: $SIM not found. Run 'make sim-verilator' first."
+    exit 1
+fi
+
+for n in $PRIOS; do
+    for sel in generic optimised; do
+        log="$OUT/${n}_${sel}.log"
+        {
+            grep -vE '^(# )?CONFIG_FREERTOS_(MAX_PRIORITIES|OPTIMISED_TASK_SELECTION)(=| is not set)' "$OUT/base.config" || true
+            echo "CONFIG_FREERTOS_MAX_PRIORITIES=$n"
+            if [ "$sel" = "optimised" ]; then
+                echo "CONFIG_FREERTOS_OPTIMISED_TASK_SELECTION=y"
+            else
+                echo "# CONFIG_FREERTOS_OPTIMISED_TASK_SELECTION is not set"
+            fi
+        } > .config
+
+        echo "========================================="
+        echo "$n priorities, $sel task selection"
+        echo "========================================="
+
+        # The kernel objects depend on configMAX_PRIORITIES: build them again
+        find downloads/freertos lib/freertos_port -name "*.o" -type f -delete 2>/dev/null || true
+        rm -f firmware/freertos_isr_bench.o firmware/freertos_isr_bench.elf
+        $MAKE fw-freertos-isr-bench > "$OUT/${n}_${sel}.build.log" 2>&1 || {
+            echo "  ✗ build failed (see $OUT/${n}_${sel}.build.log)"
+            continue
+        }
+
+        rc=0
+        "$SIM" -n -q -c "$MAX_CYCLES" -u "Tick + switch" -i "" firmware/freertos_isr_bench.elf \
+            > "$log" 2>&1 || rc=$?
+        if [ "$rc" != "0" ]; then
+            echo "  ✗ did not reach 'Tick + switch' (simulator exit $rc, see $log)"
+            continue
+        fi
+        tr -d '\r' < "$log" | \
+            sed -n "s/^PERF \\(rtos_switch[a-z_]*\\) iters=[0-9]* cyc_per_iter=\\([0-9]*\\)\$/$n $sel \\1 \\2/p" | \
+            tee -a "$RESULTS"
+    done
+done
+
+# The objects left are from the sweep's settings, not the restored .config
+find downloads/freertos lib/freertos_port -name "*.o" -type f -delete 2>/dev/null || true
+rm -f firmware/freertos_isr_bench.o firmware/freertos_isr_bench.elf
+
+echo ""
+echo "========================================="
+echo "Tick + switch, cycles (freertos_isr_bench)"
+echo "========================================="
+awk '
+    { v[$1 " " $2 " " $3] = $4; if (!($1 in seen)) { seen[$1] = 1; order[++n] = $1 } }
+    function get(k) { return (k in v) ? v[k] : "-" }
+    END {
+        printf "%-12s %-12s %-12s %-12s %s\n", "Priorities", "Selection", "Prio 2", "Top prio", "Top - prio 2"
+        for (i = 1; i <= n; i++) {
+            split("generic optimised", sel, " ")
+            for (j = 1; j <= 2; j++) {
+                a = get(order[i] " " sel[j] " rtos_switch")
+                b = get(order[i] " " sel[j] " rtos_switch_top")
+                printf "%-12s %-12s %-12s %-12s %s\n", order[i], sel[j], a, b,
+                       (a != "-" && b != "-") ? b - a : "-"
+            }
+        }
+    }' "$RESULTS"
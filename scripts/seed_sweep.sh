@@ -0,0 +1,121 @@
+#!/bin/bash
+# Placement seed sweep: the best-Fmax nextpnr run of N seeds
+#
+# Runs nextpnr on build/ice40_picorv32.json once per placement seed, JOBS
+# runs at a time, against build/generated/ice40_picorv32.sdc. The run
+# with the highest Fmax on the system clock net (the slack the PLL
+# setting has left) becomes build/ice40_picorv32.asc and .bin. Its log
+# and an icetime report are archived with the seed, so the placement can
+# be reproduced with --seed.
+#
+# Usage: scripts/seed_sweep.sh [-n SEEDS] [-f FIRST] [-j JOBS]
+#   -n SEEDS  Seeds to try (default 16)
+#   -f FIRST  First seed (default 1)
+#   -j JOBS   nextpnr runs at a time (default: nproc)
+# Results: build/seed_sweep/summary.txt, build/seed_sweep/best/
+
+set -e
+
+SEEDS=16
+FIRST=1
+JOBS=${NPROC:-$(nproc 2>/dev/null || sysctl -n hw.ncpu 2>/dev/null || echo 4)}
+
+while getopts "n:f:j:" opt; do
+    case $opt in
+        n) SEEDS=$OPTARG ;;
+        f) FIRST=$OPTARG ;;
+        j) JOBS=$OPTARG ;;
+        *) echo "Usage: $0 [-n SEEDS] [-f FIRST] [-j JOBS]"; exit 1 ;;
+    esac
+done
+
+JSON=build/ice40_picorv32.json
+SDC=build/generated/ice40_picorv32.sdc
+OUT=build/seed_sweep
+
+if [ ! -f "$JSON" ]; then
+    echo "ERROR: $JSON not found. Run 'make synth' first."
+    exit 1
+fi
+
+NEXTPNR=nextpnr-ice40
+ICETIME=icetime
+ICEPACK=icepack
+if [ -f downloads/oss-cad-suite/bin/nextpnr-ice40 ]; then
+    NEXTPNR=$PWD/downloads/oss-cad-suite/bin/nextpnr-ice40
+    ICETIME=$PWD/downloads/oss-cad-suite/bin/icetime
+    ICEPACK=$PWD/downloads/oss-cad-suite/bin/icepack
+fi
+
+. ./.config
+PCF_FILE=${CONFIG_PCF_FILE:-hdl/ice40_picorv32.pcf}
+
+./scripts/gen_sdc.sh
+rm -rf "$OUT"
+mkdir -p "$OUT/best"
+
+LAST=$((FIRST + SEEDS - 1))
+echo "========================================="
+echo "Seed sweep: seeds $FIRST-$LAST, $JOBS at a time"
+echo "========================================="
+
+# One nextpnr per seed; a seed that fails to route only loses its row
+export NEXTPNR JSON SDC PCF_FILE OUT
+seq "$FIRST" "$LAST" | xargs -P "$JOBS" -I{} sh -c '
+    if "$NEXTPNR" --hx8k --package ct256 --json "$JSON" --pcf "$PCF_FILE" \
+           --sdc "$SDC" --asc "$OUT/seed{}.asc" --placer heap --seed {} \
+           > "$OUT/seed{}.log" 2>&1; then
+        echo "  seed {}: routed"
+    else
+        echo "  seed {}: failed"; rm -f "$OUT/seed{}.asc"
+    fi' || true
+
+#------------------------------------------------------------------------------
+# Fmax of each seed (system clock net, as scripts/timing_sweep.sh)
+#------------------------------------------------------------------------------
+
+: > "$OUT/results.txt"
+for seed in $(seq "$FIRST" "$LAST"); do
+    [ -f "$OUT/seed$seed.asc" ] || continue
+    LINE=$(grep "Max frequency for clock" "$OUT/seed$seed.log" | grep -v EXTCLK | tail -1)
+    [ -n "$LINE" ] || continue
+    echo "$LINE" | sed -E "s/.*: *([0-9.]+) MHz \((PASS|FAIL) at ([0-9.]+) MHz\).*/$seed \1 \3 \2/" \
+        >> "$OUT/results.txt"
+done
+
+if [ ! -s "$OUT/results.txt" ]; then
+    echo "✗ No seed routed (see $OUT/seed*.log)"
+    exit 1
+fi
+
+{
+    printf "%-6s %-12s %-12s %-12s %-12s %s\n" "Seed" "Fmax MHz" "Target MHz" "Slack MHz" "Slack ns" "Result"
+    sort -k2 -n -r "$OUT/results.txt" | awk '{
+        printf "%-6s %-12.2f %-12.2f %-12.2f %-12.3f %s\n", $1, $2, $3, $2 - $3, 1000 / $3 - 1000 / $2, $4
+    }'
+} > "$OUT/summary.txt"
+
+BEST=$(sort -k2 -n -r "$OUT/results.txt" | head -1 | awk '{ print $1 }')
+
+#------------------------------------------------------------------------------
+# Keep the best placement
+#------------------------------------------------------------------------------
+
+cp "$OUT/seed$BEST.asc" build/ice40_picorv32.asc
+"$ICEPACK" build/ice40_picorv32.asc build/ice40_picorv32.bin
+cp "$OUT/seed$BEST.log" "$OUT/best/nextpnr.log"
+cp .config "$OUT/best/config"
+echo "$BEST" > "$OUT/best/seed"
+"$ICETIME" -d hx8k -mtr "$OUT/best/timing_report.txt" build/ice40_picorv32.asc > /dev/null 2>&1 || \
+    echo "(icetime failed: no timing report)"
+cp "$OUT/summary.txt" "$OUT/best/"
+rm -f "$OUT"/seed*.asc
+
+echo ""
+echo "========================================="
+echo "Seed Sweep (system clock net)"
+echo "========================================="
+cat "$OUT/summary.txt"
+echo ""
+echo "✓ Seed $BEST: build/ice40_picorv32.bin"
+echo "  Log, timing report and config: $OUT/best/"
@@ -0,0 +1,356 @@
+#!/bin/bash
+# Firmware and overlay size report against a stored baseline
+#
+# Builds every firmware target the tree can build (the scripts/opt_report.sh
+# groups) and every overlay SDK project, then records for each image
+#   build/size_report/sizes.txt              .text/.data/.bss per target
+#   build/size_report/<target>.objects.txt   the same per object (link map)
+#   build/size_report/<target>.symbols.txt   size, column and name per symbol
+# and compares the totals and the objects with firmware/size_baseline.txt.
+# .text is code plus read-only data, .data includes .overlay_comm, and both
+# include their scratchpad sections (.fasthot/.fastcode, .fastdata); .bss
+# includes .fastbss and a separate lwIP pool.
+#
+# Each target is also measured against the memory regions it has to fit:
+#   sram        the image and .bss (__app_size) in APP_SRAM_SIZE
+#   image       .text/.rodata/.data below .overlay_comm at 0x2A000
+#   scratchpad  the firmware's scratchpad share (SCRATCHPAD_SIZE - 1 KB),
+#               overlays' 1 KB (OVERLAY_FAST_SIZE)
+#   hot         .fasthot in HOT_FASTCODE_BYTES (HOT_PLACEMENT builds)
+#   upload      sd_card_manager's .bss end below UPLOAD_BUFFER_BASE
+#               (sd_fatfs/overlay_upload.h), where uploads land
+#   overlay     an overlay's code/data/bss in OVERLAY_MAX_SIZE
+# A region filled past the warning level is flagged; past its limit the
+# run fails (the link should have failed first).
+#
+# The baseline holds for configs/defconfig: record a new one with -u after
+# a change that is meant to move the sizes and commit it with the change.
+# Targets not in the baseline are reported as new.
+#
+# Usage: scripts/size_report.sh [-u] [-n] [-w PCT]
+#   -u        Write the measured sizes to the baseline
+#   -n        Report on the ELF files from a previous build (no rebuild)
+#   -w PCT    Flag regions filled past PCT percent (default 90)
+
+set -e
+
+UPDATE=0
+REBUILD=1
+WARN=90
+MAKE=${MAKE:-make}
+
+while getopts "unw:" opt; do
+    case $opt in
+        u) UPDATE=1 ;;
+        n) REBUILD=0 ;;
+        w) WARN=$OPTARG ;;
+        *) echo "Usage: $0 [-u] [-n] [-w PCT]"; exit 1 ;;
+    esac
+done
+
+TARGET_GROUPS="bare-metal-targets newlib-only-targets incurses-targets hexedit-targets freertos-targets lwip-targets sd-fatfs-targets"
+BASELINE=firmware/size_baseline.txt
+OUT=build/size_report
+SIZES=$OUT/sizes.txt
+REGIONS=$OUT/regions.txt
+MEMORY_CONFIG=firmware/overlay_sdk/common/memory_config.h
+UPLOAD_H=firmware/sd_fatfs/overlay_upload.h
+
+if [ -x "build/toolchain/bin/riscv64-unknown-elf-size" ]; then
+    SIZE="build/toolchain/bin/riscv64-unknown-elf-size"
+elif command -v riscv-none-elf-size >/dev/null 2>&1; then
+    SIZE="riscv-none-elf-size"
+else
+    SIZE="riscv64-unknown-elf-size"
+fi
+NM=${SIZE%size}nm
+
+if [ ! -f .config ]; then
+    echo "ERROR: .config not found. Run 'make menuconfig' or 'make defconfig' first."
+    exit 1
+fi
+source .config
+
+# Limits (bytes)
+SRAM_LIMIT=$((${CONFIG_APP_SRAM_SIZE:-0x00040000}))
+IMAGE_LIMIT=$((0x0002A000))
+FAST_LIMIT=$((${CONFIG_SCRATCHPAD_SIZE:-4096} - 0x400))
+HOT_LIMIT=0
+if [ "${CONFIG_HOT_PLACEMENT}" = "y" ]; then
+    HOT_LIMIT=${CONFIG_HOT_FASTCODE_BYTES:-1024}
+fi
+UPLOAD_LIMIT=$(( $(sed -n 's/^#define UPLOAD_BUFFER_BASE[[:space:]]*\(0x[0-9A-Fa-f]*\).*/\1/p' "$UPLOAD_H") ))
+OVERLAY_LIMIT=$(( $(sed -n 's/^#define OVERLAY_MAX_SIZE[[:space:]]*(\([0-9 *]*\)).*/\1/p' "$MEMORY_CONFIG") ))
+OVERLAY_FAST_LIMIT=$(( $(sed -n 's/^#define OVERLAY_FAST_SIZE[[:space:]]*(\([0-9 *]*\)).*/\1/p' "$MEMORY_CONFIG") ))
+OVERLAY_BASE=$((0x00060000))
+
+#------------------------------------------------------------------------------
+# Helpers
+#------------------------------------------------------------------------------
+
+# sections <elf>: "<name> <size> <addr>" per allocated section
+sections() {
+    $SIZE -A -d "$1" 2>/dev/null | awk '$1 ~ /^\./ && NF == 3 { print }'
+}
+
+# totals <sections-file>: "<text> <data> <bss>"
+totals() {
+    awk '
+        $1 ~ /^\.(text|rodata|fasthot|fastcode)$/ { t += $2 }
+        $1 ~ /^\.(data|fastdata|overlay_comm)$/  { d += $2 }
+        $1 ~ /^\.(bss|fastbss|lwip_pool)$/        { b += $2 }
+        END { print t + 0, d + 0, b + 0 }' "$1"
+}
+
+# sec <sections-file> <name> <size|end>: 0 if the section is not there
+sec() {
+    awk -v n="$2" -v f="$3" '$1 == n { print (f == "end") ? $2 + $3 : $2; found = 1 }
+                             END { if (!found) print 0 }' "$1"
+}
+
+# objects <map>: "<object> <text> <data> <bss>", largest first. Input
+# sections of the memory map, one line or split after a long name:
+#   .text.main     0x00000100       0x1a4 main.o
+#   .text.a_long_function_name
+#                  0x000002a4        0x40 ../lib/x.o
+objects() {
+    awk '
+        function hex(s,    i, v) {
+            s = tolower(s); sub(/^0x/, "", s)
+            for (i = 1; i <= length(s); i++) v = v * 16 + index("0123456789abcdef", substr(s, i, 1)) - 1
+            return v
+        }
+        function add(sec, size, file,    col) {
+            if (sec ~ /^\.(text|rodata|srodata|fasthot|fastcode|gcov_info)/) col = 1
+            else if (sec ~ /^\.(data|sdata|fastdata|overlay_comm)/) col = 2
+            else if (sec ~ /^\.(bss|sbss|fastbss|scommon)/ || sec == "COMMON") col = 3
+            else return
+            size = hex(size)
+            if (size == 0) return
+            # Archive members as libc.a(member.o), objects relative to firmware/
+            if (file ~ /\(/) sub(/^.*\//, "", file)
+            else { sub(/^(\.\.\/)+/, "", file); sub(/^\/.*\//, "", file) }
+            s[file, col] += size
+            seen[file] = 1
+        }
+        /^Linker script and memory map/ { inmap = 1; next }
+        !inmap { next }
+        pending != "" {
+            if ($1 ~ /^0x/ && $2 ~ /^0x/ && NF >= 3) add(pending, $2, $3)
+            pending = ""
+            next
+        }
+        /^ [.A-Z]/ {
+            if (NF >= 4 && $2 ~ /^0x/ && $3 ~ /^0x/) add($1, $3, $4)
+            else if (NF == 1) pending = $1
+        }
+        END {
+            for (f in seen) printf "%s %d %d %d\n", f, s[f, 1], s[f, 2], s[f, 3]
+        }' "$1" | sort -k2,2nr -k3,3nr -k4,4nr
+}
+
+# symbols <elf>: "<size> <text|data|bss> <name>", largest first
+symbols() {
+    $NM -S --size-sort -r "$1" 2>/dev/null | awk '
+        function hex(s,    i, v) {
+            s = tolower(s)
+            for (i = 1; i <= length(s); i++) v = v * 16 + index("0123456789abcdef", substr(s, i, 1)) - 1
+            return v
+        }
+        NF == 4 {
+            t = $3
+            if (t ~ /[tTrR]/) col = "text"; else if (t ~ /[dDgG]/) col = "data"
+            else if (t ~ /[bBsS]/) col = "bss"; else next
+            printf "%d %s %s\n", hex($2), col, $4
+        }'
+}
+
+# region <target> <name> <used> <limit>
+region() {
+    [ "$4" -gt 0 ] && echo "$1 $2 $3 $4" >> "$REGIONS"
+    return 0
+}
+
+# measure <target> <elf> <map> <kind: firmware|overlay>
+measure() {
+    local target=$1 elf=$2 map=$3 kind=$4 secs="$OUT/$1.sections.txt"
+    local t d b text rodata data fasthot fastcode fastdata fastbss bss_end ovl_end
+
+    sections "$elf" > "$secs"
+    if [ ! -s "$secs" ]; then
+        echo "  ✗ $target: no sections ($SIZE)"
+        return 0
+    fi
+    read -r t d b <<< "$(totals "$secs")"
+    echo "$target $t $d $b" >> "$SIZES"
+    if [ -f "$map" ]; then
+        objects "$map" > "$OUT/$target.objects.txt"
+    fi
+    symbols "$elf" > "$OUT/$target.symbols.txt"
+
+    fasthot=$(sec "$secs" .fasthot size); fastcode=$(sec "$secs" .fastcode size)
+    fastdata=$(sec "$secs" .fastdata size); fastbss=$(sec "$secs" .fastbss size)
+
+    if [ "$kind" = "overlay" ]; then
+        ovl_end=$(sec "$secs" .bss end)
+        [ "$ovl_end" -gt 0 ] || ovl_end=$(sec "$secs" .data end)
+        region "$target" overlay $((ovl_end - OVERLAY_BASE)) "$OVERLAY_LIMIT"
+        region "$target" scratchpad $((fastcode + fastdata)) "$OVERLAY_FAST_LIMIT"
+        return 0
+    fi
+
+    region "$target" sram $((t + d - $(sec "$secs" .overlay_comm size) + $(sec "$secs" .bss size))) "$SRAM_LIMIT"
+    text=$(sec "$secs" .text end); rodata=$(sec "$secs" .rodata end); data=$(sec "$secs" .data end)
+    region "$target" image $(printf '%s\n' "$text" "$rodata" "$data" | sort -n | tail -1) "$IMAGE_LIMIT"
+    region "$target" scratchpad $((fasthot + fastcode + fastdata + fastbss)) "$FAST_LIMIT"
+    region "$target" hot "$fasthot" "$HOT_LIMIT"
+    if [ "$target" = "sd_card_manager" ]; then
+        bss_end=$(sec "$secs" .bss end)
+        region "$target" upload "$bss_end" "$UPLOAD_LIMIT"
+    fi
+}
+
+#------------------------------------------------------------------------------
+# Build
+#------------------------------------------------------------------------------
+
+if [ "$REBUILD" = "1" ]; then
+    $MAKE generate
+    for g in $TARGET_GROUPS; do
+        $MAKE -C firmware $g || echo "($g: not built)"
+    done
+    $MAKE -C firmware/overlay_sdk projects || echo "(overlay projects: not built)"
+fi
+
+#------------------------------------------------------------------------------
+# Measure
+#------------------------------------------------------------------------------
+
+rm -rf "$OUT"
+mkdir -p "$OUT"
+: > "$SIZES"
+: > "$REGIONS"
+
+for elf in firmware/*.elf; do
+    [ -f "$elf" ] || continue
+    n=$(basename "$elf" .elf)
+    measure "$n" "$elf" "firmware/$n.map" firmware
+done
+for elf in firmware/overlay_sdk/projects/*/*.elf; do
+    [ -f "$elf" ] || continue
+    n=$(basename "$elf" .elf)
+    case "$n" in *.rel) continue ;; esac
+    measure "overlay.$n" "$elf" "${elf%.elf}.map" overlay
+done
+
+if [ ! -s "$SIZES" ]; then
+    echo "ERROR: no firmware or overlay ELF files found"
+    exit 1
+fi
+
+# Baseline in the same "T <target> ..." / "O <target> <object> ..." form
+{
+    awk '{ print "T", $0 }' "$SIZES"
+    for f in "$OUT"/*.objects.txt; do
+        [ -f "$f" ] || continue
+        n=$(basename "$f" .objects.txt)
+        awk -v n="$n" '{ print "O", n, $0 }' "$f"
+    done
+} > "$OUT/baseline.txt"
+
+if [ "$UPDATE" = "1" ]; then
+    {
+        echo "# Firmware and overlay sizes for configs/defconfig (scripts/size_report.sh -u)"
+        echo "# T <target> <text> <data> <bss>"
+        echo "# O <target> <object> <text> <data> <bss>"
+        cat "$OUT/baseline.txt"
+    } > "$BASELINE"
+    echo "✓ Baseline written to $BASELINE ($(wc -l < "$SIZES") targets)"
+fi
+
+#------------------------------------------------------------------------------
+# Report
+#------------------------------------------------------------------------------
+
+echo ""
+echo "========================================="
+echo "Size (bytes) against $BASELINE"
+echo "========================================="
+awk -v base="$BASELINE" -v regions="$REGIONS" -v warn="$WARN" '
+    BEGIN {
+        while ((getline l < base) > 0) {
+            n = split(l, f, " ")
+            if (f[1] == "T") { bt[f[2]] = f[3]; bd[f[2]] = f[4]; bb[f[2]] = f[5] }
+        }
+        # Fullest region of each target
+        while ((getline l < regions) > 0) {
+            split(l, f, " ")
+            p = 100.0 * f[3] / f[4]
+            if (!(f[1] in pct) || p > pct[f[1]]) { pct[f[1]] = p; rname[f[1]] = f[2] }
+        }
+        printf "%-28s %9s %7s %7s %9s %8s  %s\n", "Target", ".text", ".data", ".bss",
+               "Δ image", "Δ .bss", "Fullest region"
+    }
+    {
+        delta = ($1 in bt) ? sprintf("%+d", $2 + $3 - bt[$1] - bd[$1]) : "new"
+        dbss = ($1 in bb) ? sprintf("%+d", $4 - bb[$1]) : "-"
+        full = ($1 in pct) ? sprintf("%s %.1f%%%s", rname[$1], pct[$1], pct[$1] >= warn ? "  ⚠" : "") : "-"
+        printf "%-28s %9d %7d %7d %9s %8s  %s\n", $1, $2, $3, $4, delta, dbss, full
+    }' "$SIZES"
+echo "(Δ image: .text + .data against the baseline)"
+
+# Objects that moved in the targets the baseline has, largest change first
+CHANGES=$(awk -v base="$BASELINE" '
+    BEGIN {
+        while ((getline l < base) > 0) {
+            split(l, f, " ")
+            if (f[1] == "T") in_base[f[2]] = 1
+            if (f[1] == "O") old[f[2] " " f[3]] = f[4] + f[5] + f[6]
+        }
+    }
+    $1 == "T" { in_run[$2] = 1 }
+    $1 == "O" { cur[$2 " " $3] = $4 + $5 + $6 }
+    END {
+        for (k in cur) {
+            split(k, f, " ")
+            d = cur[k] - ((k in old) ? old[k] : 0)
+            if ((f[1] in in_base) && d != 0) printf "%s %d %s %+d%s\n", f[1], d < 0 ? -d : d, f[2], d, (k in old) ? "" : " (new)"
+        }
+        for (k in old) {
+            split(k, f, " ")
+            if ((f[1] in in_run) && !(k in cur)) printf "%s %d %s %+d (gone)\n", f[1], old[k], f[2], -old[k]
+        }
+    }' "$OUT/baseline.txt" | sort -k1,1 -k2,2nr | cut -d' ' -f1,3-)
+if [ -n "$CHANGES" ]; then
+    echo ""
+    echo "========================================="
+    echo "Objects that changed (text + data + bss)"
+    echo "========================================="
+    echo "$CHANGES" | awk '
+        $1 != last { if (last != "") print ""; print $1; last = $1; shown = 0 }
+        shown++ < 8 { printf "  %-40s %s%s\n", $2, $3, (NF > 3) ? " " $4 : "" }'
+fi
+
+echo ""
+echo "========================================="
+echo "Memory regions past ${WARN}%"
+echo "========================================="
+OVER=$(awk -v warn="$WARN" '
+    { p = 100.0 * $3 / $4 }
+    p >= warn {
+        printf "  %-28s %-11s %8d of %8d bytes (%5.1f%%)%s\n", $1, $2, $3, $4, p, (p > 100) ? "  ✗ over the limit" : ""
+        if (p > 100) over = 1
+    }
+    END { exit over }' "$REGIONS") || FAILED=1
+if [ -n "$OVER" ]; then
+    echo "$OVER"
+else
+    echo "  (none)"
+fi
+
+echo ""
+echo "Per-object and per-symbol tables: $OUT/<target>.{objects,symbols}.txt"
+if [ "${FAILED:-0}" = "1" ]; then
+    echo "✗ A target does not fit its memory region"
+    exit 1
+fi
@@ -0,0 +1,68 @@
+#!/bin/bash
+# Timing closure sweep over the Kconfig "System clock" choices
+#
+# Builds the design once per SYS_CLK_* setting (layered over .config with
+# scripts/build_profile.sh) and reports the nextpnr Fmax of the system
+# clock net against the target, as MHz and ns of slack.
+#
+# Usage: scripts/timing_sweep.sh [MHz...]     (default: 50 60 66 75)
+# Results: build/profiles/clk<MHz>/build.log, build/ice40_picorv32_clk<MHz>.bin
+
+set -e
+
+CLOCKS="$*"
+if [ -z "$CLOCKS" ]; then
+    CLOCKS="50 60 66 75"
+fi
+
+ALL_CLOCKS="50 60 66 75"
+SWEEP=build/timing_sweep
+mkdir -p "$SWEEP"
+
+for mhz in $CLOCKS; do
+    case " $ALL_CLOCKS " in
+        *" $mhz "*) ;;
+        *) echo "ERROR: no SYS_CLK_${mhz} option (choose from: $ALL_CLOCKS)"; exit 1 ;;
+    esac
+
+    FRAG="$SWEEP/clk${mhz}.config"
+    {
+        echo "# timing sweep: ${mhz} MHz"
+        for c in $ALL_CLOCKS; do
+            if [ "$c" = "$mhz" ]; then
+                echo "CONFIG_SYS_CLK_${c}=y"
+            else
+                echo "# CONFIG_SYS_CLK_${c} is not set"
+            fi
+        done
+        case $mhz in
+            50) echo "CONFIG_SYS_CLK_HZ=50000000" ;;
+            60) echo "CONFIG_SYS_CLK_HZ=60000000" ;;
+            66) echo "CONFIG_SYS_CLK_HZ=65972222" ;;
+            75) echo "CONFIG_SYS_CLK_HZ=75000000" ;;
+        esac
+    } > "$FRAG"
+
+    # A failed P&R still gets a row in the report
+    ./scripts/build_profile.sh "$FRAG" || echo "✗ ${mhz} MHz build failed"
+done
+
+echo ""
+echo "========================================="
+echo "Timing Sweep (system clock net)"
+echo "========================================="
+printf "%-8s %-12s %-12s %-12s %-12s %s\n" "Target" "Target MHz" "Fmax MHz" "Slack MHz" "Slack ns" "Result"
+for mhz in $CLOCKS; do
+    LOG="build/profiles/clk${mhz}/build.log"
+    LINE=$(grep "Max frequency for clock" "$LOG" 2>/dev/null | grep -v EXTCLK | tail -1)
+    if [ -z "$LINE" ]; then
+        printf "%-8s %-12s %-12s %-12s %-12s %s\n" "${mhz}" "-" "-" "-" "-" "no P&R result"
+        continue
+    fi
+    FMAX=$(echo "$LINE" | sed -E 's/.*: *([0-9.]+) MHz \((PASS|FAIL) at ([0-9.]+) MHz\).*/\1/')
+    TARGET=$(echo "$LINE" | sed -E 's/.*: *([0-9.]+) MHz \((PASS|FAIL) at ([0-9.]+) MHz\).*/\3/')
+    RESULT=$(echo "$LINE" | sed -E 's/.*\((PASS|FAIL) at.*/\1/')
+    awk -v m="$mhz" -v t="$TARGET" -v f="$FMAX" -v r="$RESULT" 'BEGIN {
+        printf "%-8s %-12.2f %-12.2f %-12.2f %-12.3f %s\n", m, t, f, f - t, 1000 / t - 1000 / f, r
+    }'
+done
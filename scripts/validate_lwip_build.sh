@@ -2,10 +2,17 @@
 #===============================================================================
 # lwIP Build Validation Script
 #
-# Validates that the compiled firmware BSS size matches lwIP configuration.
-# This catches common issues where lwipopts.h changes don't trigger recompile.
+# Validates that the compiled firmware matches the lwIP configuration and
+# that the memory layout fits:
+#   - The PBUF_POOL (memp_memory_PBUF_POOL_base) is at least as large as
+#     the configured pool. This catches lwipopts.h / .config changes that
+#     didn't trigger a recompile.
+#   - The pool sits where Kconfig "Networking (lwIP)" placed it (.bss,
+#     scratchpad BRAM or its own SRAM region) and inside that region.
+#   - The malloc() heap is not empty and the pool stays out of the
+#     overlay slot (0x60000-0x78000).
 #
-# Usage: validate_lwip_build.sh <elf_file> <lwipopts.h>
+# Usage: validate_lwip_build.sh <elf_file> <lwipopts.h> [.config]
 #
 # Copyright (c) October 2025 Michael Wolak
 #===============================================================================
@@ -13,14 +20,15 @@
 set -e
 
 # Check arguments
-if [ $# -ne 2 ]; then
+if [ $# -lt 2 ] || [ $# -gt 3 ]; then
     echo "ERROR: Invalid arguments"
-    echo "Usage: $0 <elf_file> <lwipopts.h>"
+    echo "Usage: $0 <elf_file> <lwipopts.h> [.config]"
     exit 1
 fi
 
 ELF_FILE="$1"
 LWIPOPTS_H="$2"
+CONFIG_FILE="${3:-$(dirname "$0")/../.config}"
 
 # Check if files exist
 if [ ! -f "$ELF_FILE" ]; then
@@ -33,75 +41,116 @@ if [ ! -f "$LWIPOPTS_H" ]; then
     exit 1
 fi
 
+if [ -f "$CONFIG_FILE" ]; then
+    source "$CONFIG_FILE"
+fi
+
 # Detect toolchain prefix
 if command -v riscv64-unknown-elf-size &> /dev/null; then
-    SIZE_CMD="riscv64-unknown-elf-size"
+    PREFIX="riscv64-unknown-elf-"
 elif command -v riscv32-unknown-elf-size &> /dev/null; then
-    SIZE_CMD="riscv32-unknown-elf-size"
+    PREFIX="riscv32-unknown-elf-"
 else
     echo "ERROR: RISC-V size command not found (riscv64-unknown-elf-size or riscv32-unknown-elf-size)"
     exit 1
 fi
 
 # Extract BSS size from ELF file
-BSS_ACTUAL=$($SIZE_CMD "$ELF_FILE" | tail -n 1 | awk '{print $3}')
+BSS_ACTUAL=$(${PREFIX}size "$ELF_FILE" | tail -n 1 | awk '{print $3}')
 
-if [ -z "$BSS_ACTUAL" ] || [ "$BSS_ACTUAL" -eq 0 ] 2>/dev/null; then
+if [ -z "$BSS_ACTUAL" ]; then
     echo "ERROR: Failed to extract BSS size from $ELF_FILE"
     exit 1
 fi
 
-# Parse lwipopts.h for configuration values
-PBUF_POOL_SIZE=$(grep -E "^#define\s+PBUF_POOL_SIZE\s+" "$LWIPOPTS_H" | awk '{print $3}')
-PBUF_POOL_BUFSIZE=$(grep -E "^#define\s+PBUF_POOL_BUFSIZE\s+" "$LWIPOPTS_H" | awk '{print $3}')
-MEMP_NUM_TCP_SEG=$(grep -E "^#define\s+MEMP_NUM_TCP_SEG\s+" "$LWIPOPTS_H" | awk '{print $3}')
+# Symbol address/size from the ELF ("" if absent)
+sym_addr() {
+    ${PREFIX}nm "$ELF_FILE" | awk -v s="$1" '$3 == s { print "0x" $1; exit }'
+}
+
+sym_size() {
+    ${PREFIX}nm -S "$ELF_FILE" | awk -v s="$1" '$4 == s { print "0x" $2; exit }'
+}
+
+# Numeric #define from a header ("" if absent or not a plain number)
+header_value() {
+    grep -E "^#define\s+$1\s+[0-9]" "$2" | head -n 1 | awk '{print $3}' | tr -d '()'
+}
+
+# Configured pool: a profile header's own numbers win (lwipopts.h includes
+# it first), then .config, then the lwipopts.h defaults
+if [ "$(basename "$LWIPOPTS_H")" != "lwipopts.h" ]; then
+    PBUF_POOL_SIZE=$(header_value PBUF_POOL_SIZE "$LWIPOPTS_H")
+    PBUF_POOL_BUFSIZE=$(header_value PBUF_POOL_BUFSIZE "$LWIPOPTS_H")
+    MEMP_NUM_TCP_SEG=$(header_value MEMP_NUM_TCP_SEG "$LWIPOPTS_H")
+fi
+PBUF_POOL_SIZE=${PBUF_POOL_SIZE:-${CONFIG_LWIP_PBUF_POOL_SIZE:-$(header_value PBUF_POOL_SIZE "$LWIPOPTS_H")}}
+PBUF_POOL_BUFSIZE=${PBUF_POOL_BUFSIZE:-${CONFIG_LWIP_PBUF_POOL_BUFSIZE:-$(header_value PBUF_POOL_BUFSIZE "$LWIPOPTS_H")}}
+MEMP_NUM_TCP_SEG=${MEMP_NUM_TCP_SEG:-${CONFIG_LWIP_MEMP_NUM_TCP_SEG:-$(header_value MEMP_NUM_TCP_SEG "$LWIPOPTS_H")}}
 
 if [ -z "$PBUF_POOL_SIZE" ] || [ -z "$PBUF_POOL_BUFSIZE" ]; then
-    echo "ERROR: Failed to parse PBUF_POOL_SIZE or PBUF_POOL_BUFSIZE from $LWIPOPTS_H"
+    echo "ERROR: Failed to parse PBUF_POOL_SIZE or PBUF_POOL_BUFSIZE from $LWIPOPTS_H or $CONFIG_FILE"
     exit 1
 fi
 
-# Calculate expected PBUF pool size in bytes
-# The PBUF_POOL is allocated in BSS via MEMP system
-# Each pbuf requires PBUF_POOL_BUFSIZE bytes, aligned
-# Formula: PBUF_POOL_SIZE * (PBUF_POOL_BUFSIZE + alignment overhead)
-# We'll use a conservative estimate with ~4 byte alignment per buffer
-
+# Each pool element is PBUF_POOL_BUFSIZE plus the struct pbuf header, so the
+# pool is at least PBUF_POOL_SIZE * PBUF_POOL_BUFSIZE bytes
 PBUF_POOL_BYTES=$((PBUF_POOL_SIZE * PBUF_POOL_BUFSIZE))
 
-# Expected minimum BSS: pbuf pool + other lwIP structures
-# Base BSS for non-lwIP is ~4KB, lwIP adds pbuf pool + other MEMP structures
-# We expect BSS to be at least (4KB base + PBUF_POOL_BYTES)
+POOL_ADDR=$(sym_addr memp_memory_PBUF_POOL_base)
+POOL_SIZE=$(sym_size memp_memory_PBUF_POOL_base)
+HEAP_START=$(sym_addr __heap_start)
+HEAP_END=$(sym_addr __heap_end)
 
-BASE_BSS=4096
-MIN_BSS_EXPECTED=$((BASE_BSS + PBUF_POOL_BYTES - 5000))  # Allow 5KB tolerance below
-MAX_BSS_EXPECTED=$((BASE_BSS + PBUF_POOL_BYTES + 30000)) # Allow 30KB overhead for other MEMP pools
+if [ -z "$POOL_ADDR" ] || [ -z "$POOL_SIZE" ]; then
+    echo "ERROR: memp_memory_PBUF_POOL_base not found in $ELF_FILE"
+    exit 1
+fi
+POOL_END=$((POOL_ADDR + POOL_SIZE))
+
+# Region Kconfig placed the pool in
+if [ "$CONFIG_LWIP_PBUF_POOL_SCRATCHPAD" = "y" ]; then
+    PLACEMENT="scratchpad BRAM"
+    REGION_START=$((0x00080400))
+    REGION_END=$((0x00080000 + ${CONFIG_SCRATCHPAD_SIZE:-4096}))
+elif [ "$CONFIG_LWIP_PBUF_POOL_SRAM" = "y" ]; then
+    PLACEMENT="SRAM region"
+    REGION_START=$((${CONFIG_LWIP_PBUF_POOL_ADDR:-0x00058000}))
+    REGION_END=$((REGION_START + ${CONFIG_LWIP_PBUF_POOL_REGION_SIZE:-0x00008000}))
+else
+    PLACEMENT=".bss"
+    REGION_START=$(($(sym_addr __bss_start)))
+    REGION_END=$(($(sym_addr __bss_end)))
+fi
 
 # Display configuration
 echo "===================================="
 echo "lwIP Build Validation"
 echo "===================================="
-echo "Configuration (from $LWIPOPTS_H):"
+echo "Configuration (from $LWIPOPTS_H, $CONFIG_FILE):"
 echo "  PBUF_POOL_SIZE      = $PBUF_POOL_SIZE buffers"
 echo "  PBUF_POOL_BUFSIZE   = $PBUF_POOL_BUFSIZE bytes"
 if [ -n "$MEMP_NUM_TCP_SEG" ]; then
     echo "  MEMP_NUM_TCP_SEG    = $MEMP_NUM_TCP_SEG segments"
 fi
+echo "  Pool placement      = $PLACEMENT"
 echo ""
 echo "Memory Analysis:"
-echo "  PBUF pool size      = $((PBUF_POOL_BYTES / 1024)) KB (${PBUF_POOL_SIZE} × ${PBUF_POOL_BUFSIZE} bytes)"
-echo "  Expected BSS range  = $((MIN_BSS_EXPECTED / 1024))-$((MAX_BSS_EXPECTED / 1024)) KB"
+echo "  PBUF pool expected  >= $((PBUF_POOL_BYTES / 1024)) KB (${PBUF_POOL_SIZE} × ${PBUF_POOL_BUFSIZE} bytes)"
+printf "  PBUF pool actual    = %d bytes at 0x%08X-0x%08X\n" $((POOL_SIZE)) $((POOL_ADDR)) $POOL_END
+printf "  Region              = 0x%08X-0x%08X\n" $REGION_START $REGION_END
+printf "  Heap                = 0x%08X-0x%08X\n" $((HEAP_START)) $((HEAP_END))
 echo "  Actual BSS size     = $((BSS_ACTUAL / 1024)) KB ($BSS_ACTUAL bytes)"
 echo ""
 
-# Validate BSS is in expected range
-if [ "$BSS_ACTUAL" -lt "$MIN_BSS_EXPECTED" ]; then
-    echo "❌ VALIDATION FAILED: BSS size is too small!"
+# Validate the pool matches the configuration
+if [ $((POOL_SIZE)) -lt "$PBUF_POOL_BYTES" ]; then
+    echo "❌ VALIDATION FAILED: PBUF pool is too small!"
     echo ""
-    echo "Expected at least $((MIN_BSS_EXPECTED / 1024)) KB, got $((BSS_ACTUAL / 1024)) KB"
+    echo "Expected at least $PBUF_POOL_BYTES bytes, got $((POOL_SIZE)) bytes"
     echo ""
     echo "This usually means lwIP source files were not recompiled after"
-    echo "lwipopts.h was modified. Try:"
+    echo "lwipopts.h or the Networking menu was modified. Try:"
     echo ""
     echo "  cd firmware"
     echo "  find ../downloads/lwip -name '*.o' -delete"
@@ -111,17 +160,27 @@ if [ "$BSS_ACTUAL" -lt "$MIN_BSS_EXPECTED" ]; then
     exit 1
 fi
 
-if [ "$BSS_ACTUAL" -gt "$MAX_BSS_EXPECTED" ]; then
-    echo "⚠️  WARNING: BSS size is larger than expected"
+# Validate the layout
+if [ $((POOL_ADDR)) -lt $REGION_START ] || [ $POOL_END -gt $REGION_END ]; then
+    echo "❌ VALIDATION FAILED: PBUF pool is not inside the $PLACEMENT!"
     echo ""
-    echo "Expected at most $((MAX_BSS_EXPECTED / 1024)) KB, got $((BSS_ACTUAL / 1024)) KB"
+    echo "Regenerate the linker script (make defconfig / make menuconfig)"
+    echo "and rebuild, or make the pool smaller."
     echo ""
-    echo "This might indicate:"
-    echo "  - Additional MEMP pools were added"
-    echo "  - Configuration changed without updating this script"
-    echo "  - New lwIP structures allocated in BSS"
+    exit 1
+fi
+
+if [ $((HEAP_START)) -ge $((HEAP_END)) ]; then
+    echo "❌ VALIDATION FAILED: no room left for the malloc() heap!"
+    echo ""
+    exit 1
+fi
+
+if [ $((POOL_ADDR)) -lt $((0x00078000)) ] && [ $POOL_END -gt $((0x00060000)) ]; then
+    echo "⚠️  WARNING: PBUF pool overlaps the overlay slot (0x60000-0x78000)"
     echo ""
-    echo "Proceeding anyway, but verify this is intentional."
+    echo "Overlay uploads get a smaller slot; overlays linked for the full"
+    echo "slot would overwrite the pool."
     echo ""
 fi
 
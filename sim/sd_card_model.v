@@ -0,0 +1,444 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// sd_card_model.v - SD Card Behavioral Model (SPI mode) for ModelSim
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+// PURPOSE: An SDHC card on the SPI pins, with the access and busy times of a
+//          real one, so boot time and FatFS throughput can be measured before
+//          there is hardware. Same card as the rvsim / Verilator C++ model
+//          (tools/rvsim/sd_card.h), with the same parameter names:
+//
+//          - SPI mode 0: MOSI sampled on the rising SCK edge, MISO changed on
+//            the falling one. The byte to send is decided when CS goes low
+//            and after each completed byte.
+//          - CMD0/8/9/10/12/13/16/17/18/24/25/55/58/59, ACMD13/23/41. CRCs
+//            are not checked: read blocks carry a dummy CRC16.
+//          - READ_WAIT 0xFF bytes before a data token (NAC) and at least
+//            READ_NS after the command (after the previous block of a
+//            CMD18); busy (0x00) for WRITE_BUSY bytes and at least WRITE_NS
+//            after each written block. A host that polls slowly sees fewer
+//            busy bytes, not a shorter wait, as on a card.
+//          - IMAGE: $readmemh file, one byte per line
+//            (xxd -p -c1 sd.img > sd.hex); empty = a byte-address pattern.
+//            save(file) writes the contents back out.
+//
+//          report prints the command, sector and wait counts; VERBOSE=1
+//          logs every command.
+//==============================================================================
+
+`timescale 1ns/1ns
+
+module sd_card_model #(
+    parameter SECTORS     = 1024,       // Multiple of 1024 (CSD v2 counts 512 KB)
+    parameter IMAGE       = "",
+    parameter READ_WAIT   = 16,         // Bytes before a data token
+    parameter WRITE_BUSY  = 256,        // Busy bytes after a written block
+    parameter READ_NS     = 0,          // Access time to a data token
+    parameter WRITE_NS    = 0,          // Programming time per block
+    parameter VERBOSE     = 0
+) (
+    input  wire SPI_SCK,
+    input  wire SPI_MOSI,
+    input  wire SPI_CS,
+    output reg  SPI_MISO
+);
+
+    localparam IDLE       = 0;
+    localparam RX_TOKEN   = 1;
+    localparam RX_DATA    = 2;
+    localparam READ_MULTI = 3;
+
+    localparam OUT_DEPTH  = 4096;       // READ_WAIT + a 515-byte block, and then some
+
+    reg [7:0] mem [0:SECTORS*512-1];
+
+    // Bytes queued for MISO, token_at = index of a data token still to hold
+    reg [7:0] out_buf [0:OUT_DEPTH-1];
+    integer out_head, out_count;
+    integer token_at;
+    time    token_until;
+
+    integer state;
+    reg     idle_r1;                    // R1 in-idle bit until ACMD41 completes
+    reg     app_cmd;
+    integer acmd41_count;
+    reg [7:0] cmd [0:5];
+    integer cmd_len;
+    integer busy_bytes;
+    time    busy_until;
+    integer sector;
+    reg     multi;
+    integer block_len;
+    reg [7:0] block [0:511];
+
+    reg [7:0] rx, tx, last_tx;
+    integer bit_n, shown;
+
+    // Statistics
+    integer commands, sectors_read, sectors_written, token_waits, busy_polls;
+
+    integer i;
+
+    initial begin
+        if (IMAGE != "")
+            $readmemh(IMAGE, mem);
+        else
+            for (i = 0; i < SECTORS*512; i = i + 1)
+                mem[i] = i[7:0];
+
+        SPI_MISO = 1'b1;
+        out_head = 0;
+        out_count = 0;
+        token_at = -1;
+        token_until = 0;
+        state = IDLE;
+        idle_r1 = 1'b1;
+        app_cmd = 1'b0;
+        acmd41_count = 0;
+        cmd_len = 0;
+        busy_bytes = 0;
+        busy_until = 0;
+        tx = 8'hFF;
+        last_tx = 8'hFF;
+        rx = 8'h00;
+        bit_n = 0;
+        shown = 0;
+        commands = 0;
+        sectors_read = 0;
+        sectors_written = 0;
+        token_waits = 0;
+        busy_polls = 0;
+    end
+
+    //--------------------------------------------------------------------------
+    // Output queue
+    //--------------------------------------------------------------------------
+
+    task push(input [7:0] b);
+        begin
+            if (out_count < OUT_DEPTH) begin
+                out_buf[(out_head + out_count) % OUT_DEPTH] = b;
+                out_count = out_count + 1;
+            end
+        end
+    endtask
+
+    task clear_out;
+        begin
+            out_count = 0;
+            token_at = -1;
+        end
+    endtask
+
+    task r1(input [7:0] flags);
+        begin
+            push(8'hFF);                    // NCR: one byte
+            push(flags | (idle_r1 ? 8'h01 : 8'h00));
+        end
+    endtask
+
+    // Data token, n bytes of mem from addr, dummy CRC16
+    task queue_block(input integer addr, input integer n);
+        integer k;
+        begin
+            for (k = 0; k < READ_WAIT; k = k + 1)
+                push(8'hFF);
+            token_at = out_count;
+            token_until = $time + READ_NS;
+            push(8'hFE);
+            for (k = 0; k < n; k = k + 1)
+                push(mem[addr + k]);
+            push(8'hFF);
+            push(8'hFF);
+        end
+    endtask
+
+    // A register block (CSD, CID), 16 bytes
+    task queue_reg(input [127:0] r);
+        integer k;
+        begin
+            push(8'hFF);
+            push(8'hFE);
+            for (k = 15; k >= 0; k = k - 1)
+                push(r[k*8 +: 8]);
+            push(8'hFF);
+            push(8'hFF);
+        end
+    endtask
+
+    //--------------------------------------------------------------------------
+    // The byte the card drives next
+    //--------------------------------------------------------------------------
+
+    task shift_out(output [7:0] b);
+        begin
+            b = 8'hFF;
+            if (state == READ_MULTI && out_count == 0) begin
+                if (sector >= SECTORS)
+                    state = IDLE;
+                else begin
+                    queue_block(sector * 512, 512);
+                    sector = sector + 1;
+                    sectors_read = sectors_read + 1;
+                end
+            end
+
+            if (state == RX_DATA) begin
+                // Nothing to say while a block comes in
+            end else if (out_count != 0) begin
+                if (token_at == 0 && $time < token_until) begin
+                    token_waits = token_waits + 1;  // Access time not over yet
+                end else begin
+                    b = out_buf[out_head];
+                    out_head = (out_head + 1) % OUT_DEPTH;
+                    out_count = out_count - 1;
+                    if (token_at >= 0)
+                        token_at = token_at - 1;
+                    if (b == 8'hFF && token_at >= 0)
+                        token_waits = token_waits + 1;
+                end
+            end else if (busy_bytes != 0 || $time < busy_until) begin
+                if (busy_bytes != 0)
+                    busy_bytes = busy_bytes - 1;
+                busy_polls = busy_polls + 1;
+                b = 8'h00;
+            end
+            last_tx = b;
+        end
+    endtask
+
+    //--------------------------------------------------------------------------
+    // Commands
+    //--------------------------------------------------------------------------
+
+    task command;
+        reg [5:0] index;
+        reg [31:0] arg;
+        reg app;
+        reg [21:0] c_size;
+        begin
+            index = cmd[0][5:0];
+            arg = {cmd[1], cmd[2], cmd[3], cmd[4]};
+            app = app_cmd;
+            app_cmd = 1'b0;
+            commands = commands + 1;
+            clear_out;
+            busy_bytes = 0;
+            busy_until = 0;
+            c_size = SECTORS / 1024 - 1;
+
+            if (VERBOSE)
+                $display("[SD_CARD] @ %0t: %sCMD%0d arg=0x%08h", $time, app ? "A" : "", index, arg);
+
+            if (app && index == 41) begin           // SD_SEND_OP_COND: ready on the second try
+                acmd41_count = acmd41_count + 1;
+                if (acmd41_count >= 2)
+                    idle_r1 = 1'b0;
+                r1(8'h00);
+            end else if (app && index == 13) begin  // SD_STATUS (R2 + 64-byte block)
+                r1(8'h00);
+                push(8'h00);
+                push(8'hFE);
+                for (i = 0; i < 66; i = i + 1)
+                    push(8'h00);
+            end else if (app && index == 23) begin  // SET_WR_BLK_ERASE_COUNT
+                r1(8'h00);
+            end else begin
+                case (index)
+                    0: begin                        // GO_IDLE_STATE
+                        idle_r1 = 1'b1;
+                        acmd41_count = 0;
+                        r1(8'h00);
+                    end
+                    8: begin                        // SEND_IF_COND: echo voltage and pattern
+                        r1(8'h00);
+                        push(8'h00);
+                        push(8'h00);
+                        push({4'h0, arg[11:8]});
+                        push(arg[7:0]);
+                    end
+                    9: begin                        // SEND_CSD (v2.0)
+                        r1(8'h00);
+                        queue_reg({8'h40, 8'h0E, 8'h00, 8'h32, 8'h5B, 8'h59, 8'h00,
+                                   {2'b00, c_size[21:16]}, c_size[15:8], c_size[7:0],
+                                   8'h7F, 8'h80, 8'h0A, 8'h40, 8'h00, 8'h01});
+                    end
+                    10: begin                       // SEND_CID
+                        r1(8'h00);
+                        queue_reg({8'h52, "RVSIMSD", 8'h10, 32'h12345678, 8'h01, 8'h9A, 8'h01});
+                    end
+                    12, 16, 59: begin               // STOP_TRANSMISSION, SET_BLOCKLEN, CRC_ON_OFF
+                        r1((index == 16 && arg != 512) ? 8'h40 : 8'h00);
+                    end
+                    13: begin                       // SEND_STATUS (R2)
+                        r1(8'h00);
+                        push(8'h00);
+                    end
+                    17, 18: begin                   // READ_SINGLE_BLOCK / READ_MULTIPLE_BLOCK
+                        if (arg >= SECTORS)
+                            r1(8'h40);              // Parameter error
+                        else begin
+                            r1(8'h00);
+                            queue_block(arg * 512, 512);
+                            sectors_read = sectors_read + 1;
+                            if (index == 18) begin
+                                sector = arg + 1;
+                                state = READ_MULTI;
+                            end
+                        end
+                    end
+                    24, 25: begin                   // WRITE_BLOCK / WRITE_MULTIPLE_BLOCK
+                        if (arg >= SECTORS)
+                            r1(8'h40);
+                        else begin
+                            r1(8'h00);
+                            sector = arg;
+                            multi = (index == 25);
+                            state = RX_TOKEN;
+                        end
+                    end
+                    55: begin                       // APP_CMD
+                        app_cmd = 1'b1;
+                        r1(8'h00);
+                    end
+                    58: begin                       // READ_OCR: powered up, CCS (SDHC)
+                        r1(8'h00);
+                        push(8'hC0);
+                        push(8'hFF);
+                        push(8'h80);
+                        push(8'h00);
+                    end
+                    default:
+                        r1(8'h04);                  // Illegal command
+                endcase
+            end
+        end
+    endtask
+
+    task collect(input [7:0] b);
+        begin
+            // A command starts with 01xxxxxx; 0xFF fill bytes are ignored
+            if (cmd_len != 0 || b[7:6] == 2'b01) begin
+                cmd[cmd_len] = b;
+                cmd_len = cmd_len + 1;
+                if (cmd_len == 6) begin
+                    cmd_len = 0;
+                    if (state == READ_MULTI) begin
+                        // Only CMD12 ends a CMD18: stuff byte, R1, briefly busy
+                        if (cmd[0][5:0] == 12) begin
+                            commands = commands + 1;
+                            state = IDLE;
+                            clear_out;
+                            push(8'hFF);
+                            push(8'h00);
+                            busy_bytes = 2;
+                        end
+                    end else
+                        command;
+                end
+            end
+        end
+    endtask
+
+    // CMD24/25: data token (0xFE single, 0xFC multi, 0xFD stop), then the block
+    task shift_in(input [7:0] b);
+        begin
+            case (state)
+                RX_TOKEN: begin
+                    if (last_tx == 8'hFF) begin     // Not still answering or busy
+                        if (b == (multi ? 8'hFC : 8'hFE)) begin
+                            block_len = 0;
+                            state = RX_DATA;
+                        end else if (multi && b == 8'hFD) begin
+                            state = IDLE;
+                            busy_bytes = WRITE_BUSY;
+                            busy_until = $time + WRITE_NS;
+                            push(8'hFF);            // One byte before busy
+                        end
+                    end
+                end
+                RX_DATA: begin
+                    if (block_len < 512)
+                        block[block_len] = b;
+                    block_len = block_len + 1;
+                    if (block_len == 514) begin     // Data and CRC16
+                        for (i = 0; i < 512; i = i + 1)
+                            mem[sector * 512 + i] = block[i];
+                        sectors_written = sectors_written + 1;
+                        sector = sector + 1;
+                        push(8'h05);                // Data accepted
+                        busy_bytes = WRITE_BUSY;
+                        busy_until = $time + WRITE_NS;
+                        state = (multi && sector < SECTORS) ? RX_TOKEN : IDLE;
+                    end
+                end
+                default:
+                    collect(b);
+            endcase
+        end
+    endtask
+
+    //--------------------------------------------------------------------------
+    // SPI pins
+    //--------------------------------------------------------------------------
+
+    always @(negedge SPI_CS) begin
+        bit_n = 0;
+        shown = 0;
+        rx = 8'h00;
+        shift_out(tx);
+        SPI_MISO = tx[7];
+    end
+
+    // Deselected: the line is pulled up, a transfer in progress ends
+    always @(posedge SPI_CS) begin
+        SPI_MISO = 1'b1;
+        cmd_len = 0;
+        clear_out;
+        state = IDLE;
+    end
+
+    always @(posedge SPI_SCK) begin
+        if (!SPI_CS) begin
+            rx = {rx[6:0], SPI_MOSI};
+            bit_n = bit_n + 1;
+        end
+    end
+
+    always @(negedge SPI_SCK) begin
+        if (!SPI_CS) begin
+            if (bit_n == 8) begin
+                shift_in(rx);
+                bit_n = 0;
+                shown = 0;
+                rx = 8'h00;
+                shift_out(tx);
+            end else
+                shown = bit_n;
+            SPI_MISO = tx[7 - shown];
+        end
+    end
+
+    //--------------------------------------------------------------------------
+    // Testbench helpers
+    //--------------------------------------------------------------------------
+
+    task report;
+        begin
+            $display("[SD_CARD] %0d commands, %0d sectors read, %0d written, %0d bytes before data tokens, %0d busy polls",
+                     commands, sectors_read, sectors_written, token_waits, busy_polls);
+        end
+    endtask
+
+    task save(input [8*256-1:0] file);
+        begin
+            $writememh(file, mem);
+        end
+    endtask
+
+endmodule
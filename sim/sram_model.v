@@ -10,15 +10,64 @@
 // NOT FOR COMMERCIAL USE
 // Educational and research purposes only
 //==============================================================================
+//
+// Datasheet timing checks (TIMING_CHECKS), so a faster controller profile
+// (SRAM_TIMING 1-cycle / burst) fails here rather than on the board. The
+// defaults are the worse of the IS61WV51216BLL-10 and K6R4016V1D-10 limits.
+// The model sits at the FPGA pins; the board delays move the SRAM's view:
+//
+//   BOARD_CTRL_NS   FPGA clock-to-pad + trace, address and controls
+//   BOARD_DATA_NS   trace + pad-to-flip-flop setup, data (both ways)
+//   BOARD_SKEW_NS   worst address-to-WE skew, applied against tSA / tHA
+//
+// Their sum with tAA is the read window gen_config_vh.sh checks
+// (SRAM_TAA_NS + SRAM_IO_NS, 4 + 3 = the default 7 ns).
+//
+// Reads: the model drives X from OE/CS low, or tOHA after an address change,
+// until the address, CS and OE have been stable for tAA / tACE / tDOE plus
+// both board delays, so a capture that comes too early latches X. A read
+// window that closes before the data is valid is reported as tAA.
+//
+// Writes, at the end of the write (the first of WE and CS rising): WE
+// pulse width (tPWE1, tPWE2 with OE low), address setup to the end (tAW),
+// data setup to the end (tSD) and the written data being driven;
+// address setup to the start (tSA), address hold (tHA), data hold (tHD);
+// the address must not change during the pulse. A change in the same time
+// step as the WE edge counts as zero setup or hold.
+//
+// Each violation is printed (the first MAX_REPORTS) and counted;
+// timing_report prints the counts. Override with vsim, for example
+// vsim -g/tb_full_system/sram/BOARD_CTRL_NS=5.
+//
+//==============================================================================
 
-`timescale 1ns/1ns
+`timescale 1ns/100ps
 
 module sram_model #(
     parameter ADDR_WIDTH = 18,           // 18-bit address (256K words)
     parameter DATA_WIDTH = 16,           // 16-bit data
     parameter ACCESS_TIME_NS = 10,       // tAA - address to data valid
-    parameter WE_PULSE_MIN_NS = 7,       // tWP - write pulse width minimum
-    parameter VERBOSE = 1                // Enable debug messages
+    parameter WE_PULSE_MIN_NS = 8,       // tPWE1 - write pulse width minimum (OE high)
+    parameter VERBOSE = 1,               // Enable debug messages
+
+    // Datasheet limits, ns
+    parameter real T_ACE  = 10.0,        // CS low to data valid
+    parameter real T_DOE  = 5.0,         // OE low to data valid
+    parameter real T_OHA  = 2.5,         // Data hold after an address change
+    parameter real T_PWE2 = 10.0,        // WE pulse width with OE low
+    parameter real T_AW   = 8.0,         // Address setup to write end
+    parameter real T_SA   = 0.0,         // Address setup to write start
+    parameter real T_HA   = 0.0,         // Address hold from write end
+    parameter real T_SD   = 6.0,         // Data setup to write end
+    parameter real T_HD   = 0.0,         // Data hold from write end
+
+    // Board, ns
+    parameter real BOARD_CTRL_NS = 4.0,
+    parameter real BOARD_DATA_NS = 3.0,
+    parameter real BOARD_SKEW_NS = 0.0,
+
+    parameter TIMING_CHECKS = 1,
+    parameter MAX_REPORTS = 20
 ) (
     input wire [ADDR_WIDTH-1:0] addr,
     inout wire [DATA_WIDTH-1:0] data,
@@ -53,11 +102,71 @@ module sram_model #(
         end
     end
 
+    //==========================================================================
+    // Violation Reporting
+    //==========================================================================
+    localparam V_TAA = 0, V_PWE = 1, V_AW = 2, V_SA = 3, V_HA = 4,
+               V_SD = 5, V_HD = 6, V_ADDR = 7, V_UNDRIVEN = 8, V_CONTENTION = 9;
+    localparam V_KINDS = 10;
+
+    integer violations = 0;
+    integer violation_count [0:V_KINDS-1];
+
+    initial begin
+        for (i = 0; i < V_KINDS; i = i + 1)
+            violation_count[i] = 0;
+    end
+
+    function [8*12-1:0] violation_name(input integer kind);
+        case (kind)
+            V_TAA:        violation_name = "tAA";
+            V_PWE:        violation_name = "tPWE";
+            V_AW:         violation_name = "tAW";
+            V_SA:         violation_name = "tSA";
+            V_HA:         violation_name = "tHA";
+            V_SD:         violation_name = "tSD";
+            V_HD:         violation_name = "tHD";
+            V_ADDR:       violation_name = "addr/write";
+            V_UNDRIVEN:   violation_name = "write data";
+            default:      violation_name = "contention";
+        endcase
+    endfunction
+
+    // have < need: one violation of kind at address a
+    task violation(input integer kind, input [ADDR_WIDTH-1:0] a, input real have, input real need);
+        begin
+            violations = violations + 1;
+            violation_count[kind] = violation_count[kind] + 1;
+            if (violations <= MAX_REPORTS)
+                $display("[SRAM_MODEL] VIOLATION %0s: addr=0x%05x %.1fns, need %.1fns @ %0t",
+                         violation_name(kind), a, have, need, $time);
+            if (violations == MAX_REPORTS)
+                $display("[SRAM_MODEL] (further violations are only counted)");
+        end
+    endtask
+
+    task check(input integer kind, input [ADDR_WIDTH-1:0] a, input real have, input real need);
+        begin
+            if (TIMING_CHECKS && have < need)
+                violation(kind, a, have, need);
+        end
+    endtask
+
+    task timing_report;
+        begin
+            $display("[SRAM_MODEL] Timing violations: %0d (board %.1f/%.1f ns, skew %.1f ns)",
+                     violations, BOARD_CTRL_NS, BOARD_DATA_NS, BOARD_SKEW_NS);
+            for (i = 0; i < V_KINDS; i = i + 1)
+                if (violation_count[i] != 0)
+                    $display("[SRAM_MODEL]   %0s: %0d", violation_name(i), violation_count[i]);
+        end
+    endtask
+
     //==========================================================================
     // Read Operation
     //==========================================================================
     reg [DATA_WIDTH-1:0] data_out;
-    reg data_out_enable;
+    reg data_out_enable = 1'b0;
 
     // Tri-state output control
     assign data = data_out_enable ? data_out : {DATA_WIDTH{1'bz}};
@@ -65,19 +174,75 @@ module sram_model #(
     // Read: CS low, OE low, WE high
     wire read_enable = (!cs_n) && (!oe_n) && (we_n);
 
-    always @(*) begin
-        if (read_enable) begin
-            // Simulate access time delay
-            data_out <= #ACCESS_TIME_NS memory[addr];
+    reg reading = 1'b0;
+    reg [ADDR_WIDTH-1:0] read_addr, last_addr;
+    real t_last_addr = 0.0, t_read_addr = 0.0, t_read_cs = 0.0, t_read_oe = 0.0, t_valid = 0.0;
+    reg cs_n_seen = 1'b1, oe_n_seen = 1'b1;
+    integer read_gen = 0;
+
+    function real max3(input real a, input real b, input real c);
+        begin
+            max3 = (a > b) ? a : b;
+            max3 = (c > max3) ? c : max3;
+        end
+    endfunction
+
+    always @(addr or cs_n or oe_n or we_n) begin
+        if (addr !== last_addr) t_last_addr = $realtime;
+        last_addr = addr;
+        if (cs_n_seen && !cs_n) t_read_cs = $realtime;
+        if (oe_n_seen && !oe_n) t_read_oe = $realtime;
+        cs_n_seen = cs_n;
+        oe_n_seen = oe_n;
+
+        if (!read_enable) begin
+            if (reading && $realtime < t_valid)
+                check(V_TAA, read_addr, $realtime - t_read_addr, t_valid - t_read_addr);
+            reading = 1'b0;
+            read_gen = read_gen + 1;
+            data_out = {DATA_WIDTH{1'bz}};
+            data_out_enable = 1'b0;
+        end else if (!reading || addr !== read_addr) begin
+            if (reading) begin
+                // Address change: the old data stays tOHA, then X
+                if ($realtime < t_valid)
+                    check(V_TAA, read_addr, $realtime - t_read_addr, t_valid - t_read_addr);
+            end else begin
+                data_out = {DATA_WIDTH{1'bx}};
+            end
+            t_read_addr = t_last_addr;
+            reading = 1'b1;
+            read_addr = addr;
             data_out_enable = 1'b1;
+            t_valid = max3(t_read_addr + ACCESS_TIME_NS, t_read_cs + T_ACE, t_read_oe + T_DOE) +
+                      BOARD_CTRL_NS + BOARD_DATA_NS;
+            read_gen = read_gen + 1;
 
             if (VERBOSE) begin
                 $display("[SRAM_MODEL] READ  addr=0x%05x data=0x%04x @ %0t",
                          addr, memory[addr], $time);
             end
-        end else begin
-            data_out = {DATA_WIDTH{1'bz}};
-            data_out_enable = 1'b0;
+
+            fork
+                automatic integer gen = read_gen;
+                automatic real t_hold = $realtime + T_OHA;
+                automatic real t_data = t_valid;
+                begin
+                    if (TIMING_CHECKS) begin
+                        if (t_hold < t_data) begin
+                            #(t_hold - $realtime);
+                            if (gen == read_gen)
+                                data_out = {DATA_WIDTH{1'bx}};
+                        end
+                        if (gen == read_gen && t_data > $realtime)
+                            #(t_data - $realtime);
+                    end else begin
+                        #(ACCESS_TIME_NS);
+                    end
+                    if (gen == read_gen)
+                        data_out = memory[read_addr];
+                end
+            join_none
         end
     end
 
@@ -87,41 +252,98 @@ module sram_model #(
     // Write: CS low, WE low (OE should be high, but not critical)
     wire write_enable = (!cs_n) && (!we_n);
 
-    // Track write pulse timing
-    time we_fall_time;
-    time we_rise_time;
-    real we_pulse_width;
+    reg writing = 1'b0;
+    real t_write_start = 0.0, t_write_end = -1.0e9;
+    reg oe_low_in_pulse;                 // tPWE2 rather than tPWE1
+    reg addr_moved;                      // Address changed during the pulse
+    real t_addr_moved;
+
+    // Pin history: the value before the latest change, for changes in the
+    // same time step as a WE edge
+    reg [ADDR_WIDTH-1:0] addr_cur, addr_prev;
+    real t_addr = 0.0, t_addr_prev = 0.0;
+    reg [DATA_WIDTH-1:0] data_cur, data_prev;
+    real t_data = 0.0, t_data_prev = 0.0;
 
-    // Detect WE falling edge
-    always @(negedge we_n) begin
-        if (!cs_n) begin
-            we_fall_time = $time;
+    always @(addr) begin
+        addr_prev = addr_cur;
+        t_addr_prev = t_addr;
+        addr_cur = addr;
+        t_addr = $realtime;
+
+        if (writing) begin
+            if ($realtime == t_write_start)
+                check(V_SA, addr, -BOARD_SKEW_NS, T_SA);
+            else if (!addr_moved) begin
+                addr_moved = 1'b1;
+                t_addr_moved = $realtime;
+            end
+        end else begin
+            check(V_HA, addr_prev, $realtime - t_write_end - BOARD_SKEW_NS, T_HA);
         end
     end
 
-    // Perform write on WE rising edge
-    always @(posedge we_n) begin
-        if (!cs_n) begin
-            we_rise_time = $time;
-            we_pulse_width = (we_rise_time - we_fall_time) / 1000.0; // Convert to ns
-
-            // Check timing
-            if (we_pulse_width < WE_PULSE_MIN_NS) begin
-                $display("[SRAM_MODEL] WARNING: Write pulse too short! " +
-                         "Width=%.1fns, Min=%0dns @ %0t",
-                         we_pulse_width, WE_PULSE_MIN_NS, $time);
-            end
+    // The FPGA's data (not while the model drives it)
+    always @(data) begin
+        if (!data_out_enable) begin
+            data_prev = data_cur;
+            t_data_prev = t_data;
+            data_cur = data;
+            t_data = $realtime;
+            if (!writing)
+                check(V_HD, addr_cur, ($realtime + BOARD_DATA_NS) - (t_write_end + BOARD_CTRL_NS), T_HD);
+        end
+    end
+
+    always @(write_enable) begin
+        if (write_enable && !writing) begin
+            writing = 1'b1;
+            t_write_start = $realtime;
+            oe_low_in_pulse = !oe_n;
+            addr_moved = 1'b0;
+            check(V_SA, addr_cur, $realtime - t_addr - BOARD_SKEW_NS, T_SA);
+        end else if (!write_enable && writing) begin : write_end
+            reg [ADDR_WIDTH-1:0] a;
+            reg [DATA_WIDTH-1:0] d;
+            real ta, td;
+
+            writing = 1'b0;
+            t_write_end = $realtime;
+
+            // A change in this time step came after the edge
+            a  = (t_addr == $realtime) ? addr_prev : addr_cur;
+            ta = (t_addr == $realtime) ? t_addr_prev : t_addr;
+            d  = (t_data == $realtime) ? data_prev : data_cur;
+            td = (t_data == $realtime) ? t_data_prev : t_data;
+            if (t_addr == $realtime)
+                check(V_HA, a, -BOARD_SKEW_NS, T_HA);
+            if (t_data == $realtime)
+                check(V_HD, a, BOARD_DATA_NS - BOARD_CTRL_NS, T_HD);
+
+            check(V_PWE, a, $realtime - t_write_start,
+                  oe_low_in_pulse ? T_PWE2 : WE_PULSE_MIN_NS);
+            check(V_AW, a, $realtime - ta - BOARD_SKEW_NS, T_AW);
+            check(V_SD, a, ($realtime + BOARD_CTRL_NS) - (td + BOARD_DATA_NS), T_SD);
+            if (addr_moved && t_addr_moved < $realtime && TIMING_CHECKS)
+                violation(V_ADDR, a, 0.0, 0.0);
+            if (^d === 1'bx && TIMING_CHECKS)
+                violation(V_UNDRIVEN, a, 0.0, 0.0);
 
             // Perform the write
-            memory[addr] <= data;
+            memory[a] = d;
 
             if (VERBOSE) begin
                 $display("[SRAM_MODEL] WRITE addr=0x%05x data=0x%04x (pulse=%.1fns) @ %0t",
-                         addr, data, we_pulse_width, $time);
+                         a, d, $realtime - t_write_start, $time);
             end
         end
     end
 
+    always @(oe_n) begin
+        if (!oe_n && writing)
+            oe_low_in_pulse = 1'b1;      // tPWE1 applies only with OE high throughout
+    end
+
     //==========================================================================
     // Violation Checks
     //==========================================================================
@@ -130,6 +352,8 @@ module sram_model #(
         if (!cs_n && !we_n && !oe_n) begin
             $display("[SRAM_MODEL] ERROR: Bus contention! WE and OE both active @ %0t",
                      $time);
+            if (TIMING_CHECKS)
+                violation_count[V_CONTENTION] = violation_count[V_CONTENTION] + 1;
         end
     end
 
@@ -31,6 +31,10 @@ module tb_full_system;
     wire SPI_SCK, SPI_MOSI, SPI_CS;
     wire SPI_MISO = 1'b0;
 
+    // Configuration flash (not modelled; DO idles high, as erased)
+    wire FLASH_SCK, FLASH_CS_N, FLASH_IO0;
+    wire FLASH_IO1 = 1'b1;
+
     // SRAM signals
     wire [17:0] SA;
     wire [15:0] SD;
@@ -45,10 +49,20 @@ module tb_full_system;
         .LED2(LED2),
         .UART_RX(UART_RX),
         .UART_TX(UART_TX),
+        .UART1_RX(1'b1),
+        .UART1_TX(),
         .SPI_SCK(SPI_SCK),
         .SPI_MOSI(SPI_MOSI),
         .SPI_MISO(SPI_MISO),
         .SPI_CS(SPI_CS),
+        .SPI1_SCK(),
+        .SPI1_MOSI(),
+        .SPI1_MISO(1'b1),
+        .SPI1_CS(),
+        .FLASH_SCK(FLASH_SCK),
+        .FLASH_CS_N(FLASH_CS_N),
+        .FLASH_IO0(FLASH_IO0),
+        .FLASH_IO1(FLASH_IO1),
         .SA(SA),
         .SD(SD),
         .SRAM_CS_N(SRAM_CS_N),
@@ -112,6 +126,50 @@ module tb_full_system;
         end
     end
 
+    // Memory transaction statistics (CPU side of the memory system)
+    // Used for the Performance Analysis tables in MEMORY_ARCHITECTURE.md
+    integer stat_cycles = 0;
+    integer stat_ifetch = 0;
+    integer stat_loads = 0;
+    integer stat_stores = 0;
+    integer stat_wait = 0;
+
+    always @(posedge uut.clk) begin
+        if (uut.cpu_resetn) begin
+            stat_cycles = stat_cycles + 1;
+            if (uut.cpu_mem_valid && !uut.cpu_mem_ready)
+                stat_wait = stat_wait + 1;
+            if (uut.cpu_mem_valid && uut.cpu_mem_ready) begin
+                if (uut.cpu_mem_instr)
+                    stat_ifetch = stat_ifetch + 1;
+                else if (|uut.cpu_mem_wstrb)
+                    stat_stores = stat_stores + 1;
+                else
+                    stat_loads = stat_loads + 1;
+            end
+        end
+    end
+
+    task print_mem_stats;
+        integer total;
+        begin
+            total = stat_ifetch + stat_loads + stat_stores;
+            $display("");
+            $display("Memory statistics (50 MHz core cycles):");
+            $display("  Cycles:          %0d", stat_cycles);
+            $display("  Fetches:         %0d", stat_ifetch);
+            $display("  Loads:           %0d", stat_loads);
+            $display("  Stores:          %0d", stat_stores);
+            $display("  Wait cycles:     %0d", stat_wait);
+            if (total > 0)
+                $display("  Wait/transaction: %0d.%02d", stat_wait / total,
+                         ((stat_wait * 100) / total) % 100);
+            if (stat_ifetch > 0)
+                $display("  Cycles/fetch:     %0d.%02d", stat_cycles / stat_ifetch,
+                         ((stat_cycles * 100) / stat_ifetch) % 100);
+        end
+    endtask
+
     // Test control
     initial begin
         $dumpfile("tb_full_system.vcd");
@@ -128,6 +186,9 @@ module tb_full_system;
         // Wait for LED blinking to occur (need longer time for delay loops)
         #50000000;  // 50ms - enough for several LED transitions
 
+        print_mem_stats;
+        sram.timing_report;
+
         $display("");
         $display("========================================");
         $display("Test Complete");
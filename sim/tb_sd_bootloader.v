@@ -35,7 +35,11 @@ module tb_sd_bootloader;
 
     // SPI signals for SD card
     wire SPI_SCK, SPI_MOSI, SPI_CS;
-    reg SPI_MISO;
+    wire SPI_MISO;
+
+    // Configuration flash (not modelled; DO idles high, as erased)
+    wire FLASH_SCK, FLASH_CS_N, FLASH_IO0;
+    wire FLASH_IO1 = 1'b1;
 
     // SRAM signals
     wire [17:0] SA;
@@ -51,10 +55,20 @@ module tb_sd_bootloader;
         .LED2(LED2),
         .UART_RX(UART_RX),
         .UART_TX(UART_TX),
+        .UART1_RX(1'b1),
+        .UART1_TX(),
         .SPI_SCK(SPI_SCK),
         .SPI_MOSI(SPI_MOSI),
         .SPI_MISO(SPI_MISO),
         .SPI_CS(SPI_CS),
+        .SPI1_SCK(),
+        .SPI1_MOSI(),
+        .SPI1_MISO(1'b1),
+        .SPI1_CS(),
+        .FLASH_SCK(FLASH_SCK),
+        .FLASH_CS_N(FLASH_CS_N),
+        .FLASH_IO0(FLASH_IO0),
+        .FLASH_IO1(FLASH_IO1),
         .SA(SA),
         .SD(SD),
         .SRAM_CS_N(SRAM_CS_N),
@@ -72,164 +86,35 @@ module tb_sd_bootloader;
     );
 
     //==========================================================================
-    // SD Card SPI Model
+    // SD Card SPI Model (sd_card_model.v)
     //==========================================================================
-
-    // SD card memory (first 376 sectors = 192KB)
-    reg [7:0] sd_card_memory [0:(376*512)-1];
-
-    // SPI state machine
-    reg [7:0] spi_rx_byte;
-    reg [7:0] spi_tx_byte;
-    reg [2:0] spi_bit_count;
-    reg [7:0] spi_cmd_buffer [0:5];  // CMD + 4 byte arg + CRC
-    reg [2:0] spi_cmd_byte_count;
-    reg [3:0] sd_state;
-    reg [31:0] sd_read_addr;
-    reg [15:0] sd_byte_counter;
-
-    localparam SD_IDLE = 0;
-    localparam SD_CMD_RX = 1;
-    localparam SD_CMD_PROCESS = 2;
-    localparam SD_R1_RESPONSE = 3;
-    localparam SD_R3_RESPONSE = 4;
-    localparam SD_R7_RESPONSE = 5;
-    localparam SD_READ_START = 6;
-    localparam SD_READ_DATA = 7;
-    localparam SD_READ_CRC = 8;
+    // Access and busy times of a real card: vsim -gSD_READ_NS=500000
+    // -gSD_WRITE_NS=1000000 (0.5 ms to a data token, 1 ms per block written);
+    // the default 0 leaves only the byte latencies
+
+    parameter SD_READ_NS  = 0;
+    parameter SD_WRITE_NS = 0;
+
+    sd_card_model #(
+        .SECTORS(1024),
+        .READ_NS(SD_READ_NS),
+        .WRITE_NS(SD_WRITE_NS),
+        .VERBOSE(1)
+    ) sd_card (
+        .SPI_SCK(SPI_SCK),
+        .SPI_MOSI(SPI_MOSI),
+        .SPI_CS(SPI_CS),
+        .SPI_MISO(SPI_MISO)
+    );
 
     initial begin
-        // Initialize SD card with test pattern
-        integer i;
-        for (i = 0; i < (376*512); i = i + 1) begin
-            // Fill with pattern: byte address mod 256
-            sd_card_memory[i] = i[7:0];
-        end
-
-        // Put a recognizable signature at start of sector 1
-        sd_card_memory[512] = 8'hDE;
-        sd_card_memory[513] = 8'hAD;
-        sd_card_memory[514] = 8'hBE;
-        sd_card_memory[515] = 8'hEF;
-
-        SPI_MISO = 1'b1;
-        spi_bit_count = 0;
-        spi_cmd_byte_count = 0;
-        sd_state = SD_IDLE;
-    end
-
-    // SPI shift register on SCK
-    always @(posedge SPI_SCK or posedge SPI_CS) begin
-        if (SPI_CS) begin
-            // CS deasserted - reset
-            spi_bit_count <= 0;
-            spi_cmd_byte_count <= 0;
-        end else begin
-            // Shift in MOSI bit
-            spi_rx_byte <= {spi_rx_byte[6:0], SPI_MOSI};
-            spi_bit_count <= spi_bit_count + 1;
-
-            if (spi_bit_count == 7) begin
-                // Byte received
-                if (sd_state == SD_IDLE || sd_state == SD_CMD_RX) begin
-                    spi_cmd_buffer[spi_cmd_byte_count] <= {spi_rx_byte[6:0], SPI_MOSI};
-                    spi_cmd_byte_count <= spi_cmd_byte_count + 1;
-
-                    if (spi_cmd_byte_count == 5) begin
-                        // Full command received
-                        sd_state <= SD_CMD_PROCESS;
-                    end else begin
-                        sd_state <= SD_CMD_RX;
-                    end
-                end
-            end
-        end
-    end
-
-    // SD card command processing
-    always @(posedge EXTCLK) begin
-        case (sd_state)
-            SD_CMD_PROCESS: begin
-                // Process received command
-                case (spi_cmd_buffer[0][5:0])  // CMD index
-                    0: begin  // CMD0 - GO_IDLE_STATE
-                        spi_tx_byte <= 8'h01;  // R1: In idle state
-                        sd_state <= SD_R1_RESPONSE;
-                        $display("[SD_CARD] @ %0t: CMD0 GO_IDLE_STATE", $time);
-                    end
-
-                    8: begin  // CMD8 - SEND_IF_COND
-                        spi_tx_byte <= 8'h01;  // R1: In idle state
-                        sd_state <= SD_R7_RESPONSE;
-                        $display("[SD_CARD] @ %0t: CMD8 SEND_IF_COND", $time);
-                    end
-
-                    58: begin  // CMD58 - READ_OCR
-                        spi_tx_byte <= 8'h00;  // R1: Ready
-                        sd_state <= SD_R3_RESPONSE;
-                        $display("[SD_CARD] @ %0t: CMD58 READ_OCR", $time);
-                    end
-
-                    55: begin  // CMD55 - APP_CMD
-                        spi_tx_byte <= 8'h00;  // R1: Ready
-                        sd_state <= SD_R1_RESPONSE;
-                        $display("[SD_CARD] @ %0t: CMD55 APP_CMD", $time);
-                    end
-
-                    41: begin  // ACMD41 - SD_SEND_OP_COND
-                        spi_tx_byte <= 8'h00;  // R1: Initialization complete
-                        sd_state <= SD_R1_RESPONSE;
-                        $display("[SD_CARD] @ %0t: ACMD41 SD_SEND_OP_COND", $time);
-                    end
-
-                    17: begin  // CMD17 - READ_SINGLE_BLOCK
-                        sd_read_addr <= {spi_cmd_buffer[1], spi_cmd_buffer[2], spi_cmd_buffer[3], spi_cmd_buffer[4]};
-                        spi_tx_byte <= 8'h00;  // R1: OK
-                        sd_state <= SD_READ_START;
-                        $display("[SD_CARD] @ %0t: CMD17 READ_SINGLE_BLOCK addr=0x%08h", $time, {spi_cmd_buffer[1], spi_cmd_buffer[2], spi_cmd_buffer[3], spi_cmd_buffer[4]});
-                    end
-
-                    default: begin
-                        spi_tx_byte <= 8'hFF;  // Invalid command
-                        sd_state <= SD_R1_RESPONSE;
-                        $display("[SD_CARD] @ %0t: Unknown CMD%0d", $time, spi_cmd_buffer[0][5:0]);
-                    end
-                endcase
-
-                spi_cmd_byte_count <= 0;
-            end
-
-            SD_READ_START: begin
-                // Send data start token
-                spi_tx_byte <= 8'hFE;
-                sd_byte_counter <= 0;
-                sd_state <= SD_READ_DATA;
-            end
-
-            SD_READ_DATA: begin
-                // Send sector data
-                spi_tx_byte <= sd_card_memory[sd_read_addr + sd_byte_counter];
-                sd_byte_counter <= sd_byte_counter + 1;
-
-                if (sd_byte_counter == 511) begin
-                    sd_state <= SD_READ_CRC;
-                end
-            end
-
-            SD_READ_CRC: begin
-                // Send dummy CRC bytes
-                spi_tx_byte <= 8'hFF;
-                sd_state <= SD_IDLE;
-            end
-        endcase
-    end
-
-    // Shift out MISO bit
-    always @(negedge SPI_SCK) begin
-        if (!SPI_CS) begin
-            SPI_MISO <= spi_tx_byte[7];
-            spi_tx_byte <= {spi_tx_byte[6:0], 1'b1};
-        end
+        // Byte-address pattern from the model, and a recognizable
+        // signature at the start of sector 1
+        #1;
+        sd_card.mem[512] = 8'hDE;
+        sd_card.mem[513] = 8'hAD;
+        sd_card.mem[514] = 8'hBE;
+        sd_card.mem[515] = 8'hEF;
     end
 
     //==========================================================================
@@ -301,6 +186,23 @@ module tb_sd_bootloader;
         end
     end
 
+    // Boot time: from the first ROM access to the jump to the loaded image
+    time bootrom_start = 0;
+    reg boot_done = 0;
+
+    always @(posedge EXTCLK) begin
+        if (uut.cpu_mem_valid && uut.cpu_mem_addr >= 32'h00040000 && uut.cpu_mem_addr < 32'h00042000 &&
+            !bootrom_access_detected)
+            bootrom_start <= $time;
+        if (bootrom_access_detected && !boot_done && uut.cpu_mem_valid && uut.cpu_mem_instr &&
+            uut.cpu_mem_addr == 32'h00000000) begin
+            boot_done <= 1;
+            $display("[BOOT] @ %0t: Jump to 0x0, %0d us after the first ROM access", $time,
+                     ($time - bootrom_start) / 1000);
+            sd_card.report;
+        end
+    end
+
     //==========================================================================
     // CPU Instruction Fetch Monitor
     //==========================================================================
@@ -386,6 +288,8 @@ module tb_sd_bootloader;
         $display("========================================");
         $display("Test Complete");
         $display("UART bytes received: %0d", uart_byte_count);
+        sd_card.report;
+        sram.timing_report;
         $display("========================================");
 
         $finish;
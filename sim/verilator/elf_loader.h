@@ -0,0 +1,118 @@
+//==============================================================================
+// Firmware Loader for the Verilator Harness
+//
+// Copies an ELF32 RISC-V executable (PT_LOAD segments) or a raw .bin into
+// the SRAM model before reset, like fw_upload does on the board
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+//
+// Segments go to their physical address (p_paddr), which for this platform
+// is the SRAM offset (APP_SRAM_BASE = 0). The part of a segment past its
+// file size (.bss) is zeroed. Anything outside the 512KB SRAM is an error;
+// the CPU starts at 0x0 in SIMULATION builds, so the entry point is only
+// checked, not used.
+//
+//==============================================================================
+
+#ifndef SIM_ELF_LOADER_H
+#define SIM_ELF_LOADER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "sram_model.h"
+
+struct LoadInfo {
+    uint32_t entry = 0;
+    uint32_t bytes = 0;         // Bytes written to SRAM (file + zero fill)
+    uint32_t top = 0;           // Highest address written + 1
+};
+
+static inline uint32_t elf_rd16(const uint8_t *p) { return p[0] | (p[1] << 8); }
+static inline uint32_t elf_rd32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Returns an empty string on success, else what went wrong
+static std::string firmware_load(const char *path, SramModel &sram, LoadInfo &info) {
+    FILE *f = std::fopen(path, "rb");
+    if (!f)
+        return std::string("cannot open ") + path;
+
+    std::vector<uint8_t> img;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), f)) > 0)
+        img.insert(img.end(), chunk, chunk + n);
+    std::fclose(f);
+
+    // Raw binary: image of SRAM from address 0
+    if (img.size() < 4 || std::memcmp(img.data(), "\x7f" "ELF", 4) != 0) {
+        if (img.size() > SramModel::BYTES)
+            return "binary larger than SRAM";
+        for (size_t i = 0; i < img.size(); i++)
+            sram.write_byte((uint32_t)i, img[i]);
+        info.entry = 0;
+        info.bytes = info.top = (uint32_t)img.size();
+        return "";
+    }
+
+    // ELF32, little endian, EM_RISCV, executable
+    if (img.size() < 52 || img[4] != 1 || img[5] != 1)
+        return "not a 32-bit little-endian ELF";
+    if (elf_rd16(&img[18]) != 243)
+        return "not a RISC-V ELF";
+    if (elf_rd16(&img[16]) != 2)
+        return "not an executable ELF";
+
+    uint32_t phoff = elf_rd32(&img[28]);
+    uint32_t phentsize = elf_rd16(&img[42]);
+    uint32_t phnum = elf_rd16(&img[44]);
+    info.entry = elf_rd32(&img[24]);
+
+    for (uint32_t i = 0; i < phnum; i++) {
+        size_t ph = (size_t)phoff + (size_t)i * phentsize;
+        if (ph + 32 > img.size())
+            return "truncated program header table";
+
+        uint32_t type   = elf_rd32(&img[ph + 0]);
+        uint32_t offset = elf_rd32(&img[ph + 4]);
+        uint32_t paddr  = elf_rd32(&img[ph + 12]);
+        uint32_t filesz = elf_rd32(&img[ph + 16]);
+        uint32_t memsz  = elf_rd32(&img[ph + 20]);
+
+        if (type != 1 || memsz == 0)            // PT_LOAD only
+            continue;
+        if ((uint64_t)offset + filesz > img.size())
+            return "segment past end of file";
+        if ((uint64_t)paddr + memsz > SramModel::BYTES) {
+            if (filesz == 0)                    // .fastbss: scratchpad, start.S clears it
+                continue;
+            char msg[96];
+            std::snprintf(msg, sizeof(msg), "segment 0x%08x+0x%x outside SRAM", paddr, memsz);
+            return msg;
+        }
+
+        for (uint32_t j = 0; j < memsz; j++)
+            sram.write_byte(paddr + j, j < filesz ? img[offset + j] : 0);
+        info.bytes += memsz;
+        if (paddr + memsz > info.top)
+            info.top = paddr + memsz;
+    }
+
+    if (info.bytes == 0)
+        return "no loadable segments";
+    if (info.entry != 0)
+        std::fprintf(stderr, "[SIM] Warning: entry point 0x%08x, CPU starts at 0x0\n", info.entry);
+    return "";
+}
+
+#endif // SIM_ELF_LOADER_H
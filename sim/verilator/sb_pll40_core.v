@@ -0,0 +1,35 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// sb_pll40_core.v - SB_PLL40_CORE Stand-in for Verilator
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+// PURPOSE: Lets SYS_CLK_PLL configurations elaborate. The output is the
+//          reference clock itself: the harness counts system clock edges and
+//          times the UART from the baud divider in system clocks, so the
+//          nominal frequency never enters the simulation.
+//==============================================================================
+
+module SB_PLL40_CORE #(
+    parameter FEEDBACK_PATH = "SIMPLE",
+    parameter PLLOUT_SELECT = "GENCLK",
+    parameter [3:0] DIVR = 4'd0,
+    parameter [6:0] DIVF = 7'd0,
+    parameter [2:0] DIVQ = 3'd0,
+    parameter [2:0] FILTER_RANGE = 3'd0
+) (
+    input  wire REFERENCECLK,
+    output wire PLLOUTGLOBAL,
+    output wire LOCK,
+    input  wire RESETB,
+    input  wire BYPASS
+);
+
+    assign PLLOUTGLOBAL = REFERENCECLK;
+    assign LOCK = RESETB;
+
+endmodule
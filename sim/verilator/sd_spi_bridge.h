@@ -0,0 +1,91 @@
+//==============================================================================
+// SD Card Bridge for the Verilator Harness
+//
+// Connects the SPI pins of the design to the rvsim SD card model
+// (tools/rvsim/sd_card.h), so FatFS firmware runs against an image file
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+//
+// SPI mode 0, as sd_spi.c sets it: MOSI is sampled on the rising SCK edge,
+// MISO changes on the falling one (so a delayed MISO sample, SPI_CTRL
+// sample_delay, still sees the right bit). The card decides the byte it sends
+// (SdCard::shift_out) when CS goes low and after each completed byte, and
+// takes the received byte (SdCard::shift_in) after the eighth bit, so
+// responses line up with the same byte as on the byte-level rvsim bus.
+//
+// CS high deselects the card and ends any transfer in progress.
+//
+// tick() is called once per system clock rising edge, with the simulation
+// time for the card's access and busy times (SdCard::read_ns, write_ns).
+//
+//==============================================================================
+
+#ifndef SIM_SD_SPI_BRIDGE_H
+#define SIM_SD_SPI_BRIDGE_H
+
+#include <cstdint>
+
+#include "sd_card.h"
+
+class SdSpiBridge {
+public:
+    explicit SdSpiBridge(SdCard &card) : card_(card) {}
+
+    template <class Top>
+    void tick(Top *top, uint64_t now_ns) {
+        bool sck = top->SPI_SCK;
+
+        card_.set_time(now_ns);
+
+        if (top->SPI_CS) {
+            if (selected_)
+                card_.select(false);
+            selected_ = false;
+        } else if (!selected_) {
+            card_.select(true);
+            selected_ = true;
+            begin_byte();
+        } else if (sck && !sck_prev_) {
+            rx_ = (uint8_t)(rx_ << 1 | (top->SPI_MOSI ? 1 : 0));
+            bit_++;
+        } else if (!sck && sck_prev_) {
+            if (bit_ == 8) {
+                card_.shift_in(rx_);
+                bytes_++;
+                begin_byte();
+            } else {
+                shown_ = bit_;
+            }
+        }
+        sck_prev_ = sck;
+
+        // Bit 7 first; deselected: line pulled up
+        top->SPI_MISO = selected_ ? (tx_ >> (7 - shown_)) & 1 : 1;
+    }
+
+    uint64_t bytes() const { return bytes_; }
+
+private:
+    SdCard  &card_;
+    bool     selected_ = false;
+    bool     sck_prev_ = false;
+    int      bit_ = 0;                  // Bits of the current byte so far
+    int      shown_ = 0;                // Bit on MISO (7 - n)
+    uint8_t  tx_ = 0xFF;                // Card -> design
+    uint8_t  rx_ = 0;                   // Design -> card
+    uint64_t bytes_ = 0;
+
+    void begin_byte() {
+        tx_ = card_.shift_out();
+        rx_ = 0;
+        bit_ = 0;
+        shown_ = 0;
+    }
+};
+
+#endif // SIM_SD_SPI_BRIDGE_H
@@ -0,0 +1,380 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// sim_main.cpp - Verilator Cycle-Accurate System Simulation
+//
+// Runs ice40_picorv32_top with firmware preloaded into a C++ SRAM model and
+// the UART bridged to stdin/stdout, so a benchmark such as algo_test runs to
+// completion in seconds and every cycle count is exact and repeatable.
+//
+// The design is built with SIMULATION defined (CPU resets to 0x0 in SRAM,
+// no bootloader upload) and the same Kconfig options as the bitstream
+// (build/generated/config.vh), see the Makefile in this directory.
+//
+// UART output goes to stdout untouched; the harness reports on stderr.
+// Keys typed on a terminal (or piped in) go to UART_RX at the design's baud.
+// With -d an SD card image sits on the SPI pins (sd_spi_bridge.h).
+//
+// Usage: picorv32_sim [options] <firmware.elf|firmware.bin>
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "Vsim_top.h"
+#include "verilated.h"
+#if VM_TRACE
+#include "verilated_vcd_c.h"
+#endif
+
+#include "sram_model.h"
+#include "uart_bridge.h"
+#include "elf_loader.h"
+#include "sd_spi_bridge.h"
+
+// stdin is polled this often (system clocks); a key is ~500 clocks at 1 Mbaud
+#define STDIN_POLL_CYCLES   1024
+
+// Exit codes, for scripts
+#define EXIT_OK             0   // Ran to --until / --cycles / $finish
+#define EXIT_TIMEOUT        1   // --cycles reached before --until text
+#define EXIT_TRAP           2   // CPU trapped (illegal instruction, ebreak)
+#define EXIT_SETUP          3   // Bad arguments or firmware
+
+static volatile sig_atomic_t interrupted = 0;
+static struct termios saved_tty;
+static bool tty_raw = false;
+
+static void on_sigint(int) { interrupted = 1; }
+
+static void tty_restore(void) {
+    if (tty_raw)
+        tcsetattr(STDIN_FILENO, TCSANOW, &saved_tty);
+    tty_raw = false;
+}
+
+// Keys straight through (no line editing, no echo); Ctrl-C still stops
+static void tty_make_raw(void) {
+    if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &saved_tty) != 0)
+        return;
+    struct termios raw = saved_tty;
+    raw.c_lflag &= ~(ICANON | ECHO);
+    raw.c_iflag &= ~(ICRNL | IXON);
+    raw.c_cc[VMIN] = 1;
+    raw.c_cc[VTIME] = 0;
+    tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+    tty_raw = true;
+    atexit(tty_restore);
+}
+
+// -i text: \r \n \t \e \\ and \xHH escapes
+static std::string unescape(const char *s) {
+    std::string out;
+    for (; *s; s++) {
+        if (*s != '\\' || !s[1]) { out += *s; continue; }
+        switch (*++s) {
+            case 'r': out += '\r'; break;
+            case 'n': out += '\n'; break;
+            case 't': out += '\t'; break;
+            case 'e': out += '\x1b'; break;
+            case 'x': {
+                char hex[3] = { 0, 0, 0 };
+                for (int i = 0; i < 2 && isxdigit((unsigned char)s[1]); i++) hex[i] = *++s;
+                out += (char)strtoul(hex, NULL, 16);
+                break;
+            }
+            default: out += *s; break;
+        }
+    }
+    return out;
+}
+
+static void print_usage(const char *prog) {
+    fprintf(stderr, "PicoRV32 system simulation (Verilator)\n\n");
+    fprintf(stderr, "Usage: %s [options] <firmware.elf|firmware.bin>\n\n", prog);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "  -c, --cycles <n>      Stop after n CPU cycles (default: no limit)\n");
+    fprintf(stderr, "  -u, --until <text>    Stop once text has appeared on the UART\n");
+    fprintf(stderr, "  -i, --input <text>    Type text first (\\r \\n \\e \\xHH escapes)\n");
+    fprintf(stderr, "  -n, --no-stdin        Do not forward stdin to the UART\n");
+    fprintf(stderr, "  -q, --quiet           No statistics at exit\n");
+    fprintf(stderr, "  -d, --sdcard <image>  SD card image on the SPI pins (written back)\n");
+    fprintf(stderr, "      --sd-readonly     Keep the image unchanged (writes are dropped)\n");
+    fprintf(stderr, "      --sd-timing <r,w[,e]>  SD read access / write / erase times in us\n");
+#if VM_TRACE
+    fprintf(stderr, "  -t, --trace <file>    Write a VCD waveform\n");
+#endif
+    fprintf(stderr, "  -h, --help            Show this help\n\n");
+    fprintf(stderr, "Examples:\n");
+    fprintf(stderr, "  %s firmware/led_blink.elf\n", prog);
+    fprintf(stderr, "  %s -i ' 6' -u 'Combined stress test complete' firmware/algo_test.elf\n", prog);
+}
+
+int main(int argc, char **argv) {
+    const char *firmware = NULL;
+    const char *until = NULL;
+    const char *trace_file = NULL;
+    const char *sd_image = NULL;
+    bool sd_readonly = false;
+    const char *sd_timing = NULL;
+    std::string input;
+    uint64_t max_cycles = 0;
+    bool use_stdin = true;
+    bool quiet = false;
+
+    // Parse arguments
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--cycles") == 0) {
+            if (++i >= argc) { print_usage(argv[0]); return EXIT_SETUP; }
+            max_cycles = strtoull(argv[i], NULL, 0);
+        } else if (strcmp(argv[i], "-u") == 0 || strcmp(argv[i], "--until") == 0) {
+            if (++i >= argc) { print_usage(argv[0]); return EXIT_SETUP; }
+            until = argv[i];
+        } else if (strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "--input") == 0) {
+            if (++i >= argc) { print_usage(argv[0]); return EXIT_SETUP; }
+            input += unescape(argv[i]);
+        } else if (strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "--trace") == 0) {
+            if (++i >= argc) { print_usage(argv[0]); return EXIT_SETUP; }
+            trace_file = argv[i];
+        } else if (strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "--sdcard") == 0) {
+            if (++i >= argc) { print_usage(argv[0]); return EXIT_SETUP; }
+            sd_image = argv[i];
+        } else if (strcmp(argv[i], "--sd-readonly") == 0) {
+            sd_readonly = true;
+        } else if (strcmp(argv[i], "--sd-timing") == 0) {
+            if (++i >= argc) { print_usage(argv[0]); return EXIT_SETUP; }
+            sd_timing = argv[i];
+        } else if (strcmp(argv[i], "-n") == 0 || strcmp(argv[i], "--no-stdin") == 0) {
+            use_stdin = false;
+        } else if (strcmp(argv[i], "-q") == 0 || strcmp(argv[i], "--quiet") == 0) {
+            quiet = true;
+        } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            return EXIT_OK;
+        } else if (argv[i][0] == '+') {
+            // +verilator+... runtime options, read by Verilated::commandArgs
+        } else {
+            firmware = argv[i];
+        }
+    }
+
+    if (!firmware) {
+        print_usage(argv[0]);
+        return EXIT_SETUP;
+    }
+
+    SramModel sram;
+    LoadInfo info;
+    std::string err = firmware_load(firmware, sram, info);
+    if (!err.empty()) {
+        fprintf(stderr, "[SIM] ERROR: %s: %s\n", firmware, err.c_str());
+        return EXIT_SETUP;
+    }
+    if (!quiet)
+        fprintf(stderr, "[SIM] Loaded %s: %u bytes, 0x00000000-0x%08x\n",
+                firmware, info.bytes, info.top - 1);
+
+    SdCard card;
+    if (sd_timing && !card.set_timing(sd_timing)) {
+        fprintf(stderr, "[SIM] ERROR: --sd-timing %s: expected read,write[,erase] in us\n", sd_timing);
+        return EXIT_SETUP;
+    }
+    if (sd_image) {
+        if (!card.open(sd_image, sd_readonly, err)) {
+            fprintf(stderr, "[SIM] ERROR: %s: %s\n", sd_image, err.c_str());
+            return EXIT_SETUP;
+        }
+        if (!quiet)
+            fprintf(stderr, "[SIM] SD card %s: %u sectors%s\n", sd_image, card.sectors(),
+                    sd_readonly ? " (read-only)" : "");
+    }
+    SdSpiBridge sd(card);
+
+    Verilated::commandArgs(argc, argv);
+    Vsim_top *top = new Vsim_top;
+
+#if VM_TRACE
+    VerilatedVcdC *vcd = NULL;
+    if (trace_file) {
+        Verilated::traceEverOn(true);
+        vcd = new VerilatedVcdC;
+        top->trace(vcd, 99);
+        vcd->open(trace_file);
+    }
+#else
+    if (trace_file) {
+        fprintf(stderr, "[SIM] ERROR: built without tracing (make TRACE=1)\n");
+        return EXIT_SETUP;
+    }
+#endif
+
+    UartBridge uart;
+    uart.send(input);
+
+    if (use_stdin)
+        tty_make_raw();
+    signal(SIGINT, on_sigint);
+
+    // Idle inputs: buttons released (active low), UART line high, MISO pulled up
+    top->EXTCLK = 0;
+    top->BUT1 = 1;
+    top->BUT2 = 1;
+    top->UART_RX = 1;
+    top->SPI_MISO = 1;
+    top->sram_rdata = 0;
+    top->eval();
+
+    // Statistics (same as tb_full_system.v print_mem_stats)
+    uint64_t cycles = 0, ifetch = 0, loads = 0, stores = 0, wait = 0;
+    uint64_t sys_clocks = 0;
+    uint64_t sim_time = 0;          // EXTCLK half periods (5 ns)
+    bool clk_prev = top->sys_clk;
+    bool valid = false, ready = false, instr = false, wr = false, run = false;
+
+    size_t until_len = until ? strlen(until) : 0;
+    std::string tail;
+    bool until_seen = false;
+    bool trapped = false;
+    bool stdin_open = use_stdin;
+
+    auto wall_start = std::chrono::steady_clock::now();
+
+    while (!Verilated::gotFinish() && !interrupted) {
+        top->EXTCLK = !top->EXTCLK;
+        top->eval();
+        if (sram.eval(top))
+            top->eval();
+        sim_time++;
+#if VM_TRACE
+        if (vcd)
+            vcd->dump(sim_time * 5);
+#endif
+
+        bool clk = top->sys_clk;
+        if (clk && !clk_prev) {
+            sys_clocks++;
+
+            // Memory interface as it was just before this edge
+            if (run) {
+                cycles++;
+                if (valid && !ready)
+                    wait++;
+                if (valid && ready) {
+                    if (instr) ifetch++;
+                    else if (wr) stores++;
+                    else loads++;
+                }
+            }
+
+            uint8_t c;
+            if (uart.tick(top, sys_clocks, &c)) {
+                fputc(c, stdout);
+                fflush(stdout);
+                if (until_len) {
+                    tail += (char)c;
+                    if (tail.size() > until_len)
+                        tail.erase(0, tail.size() - until_len);
+                    if (tail == until) {
+                        until_seen = true;
+                        break;
+                    }
+                }
+            }
+
+            if (sd_image)
+                sd.tick(top, sim_time * 5);
+
+            if (stdin_open && (sys_clocks % STDIN_POLL_CYCLES) == 0 && uart.rx_idle()) {
+                struct pollfd pfd = { STDIN_FILENO, POLLIN, 0 };
+                if (poll(&pfd, 1, 0) > 0) {
+                    uint8_t buf[64];
+                    ssize_t n = read(STDIN_FILENO, buf, sizeof(buf));
+                    if (n > 0) {
+                        for (ssize_t i = 0; i < n; i++) uart.send(buf[i]);
+                    } else if (n == 0 || errno != EINTR) {
+                        stdin_open = false;     // EOF: keep running
+                    }
+                }
+            }
+
+            if (top->cpu_trap) {
+                trapped = true;
+                break;
+            }
+            if (max_cycles && cycles >= max_cycles)
+                break;
+        }
+        clk_prev = clk;
+
+        valid = top->mem_valid;
+        ready = top->mem_ready;
+        instr = top->mem_instr;
+        wr = top->mem_wstrb != 0;
+        run = top->cpu_resetn;
+    }
+
+    top->final();
+#if VM_TRACE
+    if (vcd) {
+        vcd->close();
+        delete vcd;
+    }
+#endif
+    tty_restore();
+
+    int rc = EXIT_OK;
+    const char *why = "stopped";
+    if (trapped) { rc = EXIT_TRAP; why = "CPU trap"; }
+    else if (until_seen) why = "--until text seen";
+    else if (interrupted) why = "interrupted";
+    else if (Verilated::gotFinish()) why = "$finish";
+    else if (max_cycles && cycles >= max_cycles) {
+        why = "cycle limit";
+        if (until) rc = EXIT_TIMEOUT;
+    }
+
+    if (!quiet) {
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+        uint64_t total = ifetch + loads + stores;
+        fprintf(stderr, "\n[SIM] %s after %llu cycles\n", why, (unsigned long long)cycles);
+        fprintf(stderr, "[SIM]   Fetches:      %llu\n", (unsigned long long)ifetch);
+        fprintf(stderr, "[SIM]   Loads:        %llu\n", (unsigned long long)loads);
+        fprintf(stderr, "[SIM]   Stores:       %llu\n", (unsigned long long)stores);
+        fprintf(stderr, "[SIM]   Wait cycles:  %llu\n", (unsigned long long)wait);
+        if (total)
+            fprintf(stderr, "[SIM]   Wait/transaction: %.2f\n", (double)wait / total);
+        if (ifetch)
+            fprintf(stderr, "[SIM]   Cycles/fetch:     %.2f\n", (double)cycles / ifetch);
+        if (uart.framing_errors())
+            fprintf(stderr, "[SIM]   UART framing errors: %llu\n",
+                    (unsigned long long)uart.framing_errors());
+        if (sd_image)
+            fprintf(stderr, "[SIM]   SD card: %llu commands, %llu sectors read, %llu written\n",
+                    (unsigned long long)card.commands, (unsigned long long)card.sectors_read,
+                    (unsigned long long)card.sectors_written);
+        if (sd_image && (card.token_waits || card.busy_polls))
+            fprintf(stderr, "[SIM]   SD waits: %llu bytes before data tokens, %llu busy polls\n",
+                    (unsigned long long)card.token_waits, (unsigned long long)card.busy_polls);
+        if (secs > 0)
+            fprintf(stderr, "[SIM]   %.1f s wall clock, %.2f MHz simulated\n",
+                    secs, sys_clocks / secs / 1e6);
+    }
+
+    delete top;
+    return rc;
+}
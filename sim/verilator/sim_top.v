@@ -0,0 +1,102 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// sim_top.v - Verilator Wrapper for ice40_picorv32_top
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+// PURPOSE: Splits the bidirectional SRAM data bus into the two directions the
+//          C++ SRAM model (sram_model.h) drives and samples, and brings out
+//          the internal signals the harness needs for UART timing, cycle
+//          counting and memory statistics (same taps as tb_full_system.v).
+//          The SPI pins go to the SD card bridge (sd_spi_bridge.h); the
+//          configuration flash is not modelled (IO1 idles high, as erased).
+//==============================================================================
+
+`default_nettype none
+
+module sim_top (
+    input  wire        EXTCLK,
+    input  wire        BUT1,
+    input  wire        BUT2,
+    output wire        LED1,
+    output wire        LED2,
+    input  wire        UART_RX,
+    output wire        UART_TX,
+    output wire        SPI_SCK,
+    output wire        SPI_MOSI,
+    input  wire        SPI_MISO,
+    output wire        SPI_CS,
+
+    // SRAM pins, data bus split by direction
+    output wire [17:0] sram_addr,
+    output wire        sram_cs_n,
+    output wire        sram_oe_n,
+    output wire        sram_we_n,
+    output wire [15:0] sram_wdata,      // SD as the controller drives it
+    input  wire [15:0] sram_rdata,      // Driven onto SD while the SRAM reads
+
+    // Internal taps
+    output wire        sys_clk,
+    output wire        cpu_resetn,
+    output wire        cpu_trap,
+    output wire        mem_valid,
+    output wire        mem_ready,
+    output wire        mem_instr,
+    output wire [ 3:0] mem_wstrb,
+    output wire [23:0] uart_baud_div,   // 16.8 clocks per oversampling tick
+    output wire [ 4:0] uart_os_rate     // Ticks per bit
+);
+
+    wire [15:0] SD;
+    wire        FLASH_IO0;
+
+    // Same drive condition as sim/sram_model.v: CS and OE low, WE high
+    assign SD = (!sram_cs_n && !sram_oe_n && sram_we_n) ? sram_rdata : 16'hzzzz;
+    assign sram_wdata = SD;
+
+    ice40_picorv32_top uut (
+        .EXTCLK(EXTCLK),
+        .BUT1(BUT1),
+        .BUT2(BUT2),
+        .LED1(LED1),
+        .LED2(LED2),
+        .UART_RX(UART_RX),
+        .UART_TX(UART_TX),
+        .UART1_RX(1'b1),
+        .UART1_TX(),
+        .SPI_SCK(SPI_SCK),
+        .SPI_MOSI(SPI_MOSI),
+        .SPI_MISO(SPI_MISO),
+        .SPI_CS(SPI_CS),
+        .SPI1_SCK(),
+        .SPI1_MOSI(),
+        .SPI1_MISO(1'b1),
+        .SPI1_CS(),
+        .FLASH_SCK(),
+        .FLASH_CS_N(),
+        .FLASH_IO0(FLASH_IO0),
+        .FLASH_IO1(1'b1),
+        .SA(sram_addr),
+        .SD(SD),
+        .SRAM_CS_N(sram_cs_n),
+        .SRAM_OE_N(sram_oe_n),
+        .SRAM_WE_N(sram_we_n)
+    );
+
+    assign sys_clk       = uut.clk;
+    assign cpu_resetn    = uut.cpu_resetn;
+    assign cpu_trap      = uut.cpu.trap;
+    assign mem_valid     = uut.cpu_mem_valid;
+    assign mem_ready     = uut.cpu_mem_ready;
+    assign mem_instr     = uut.cpu_mem_instr;
+    assign mem_wstrb     = uut.cpu_mem_wstrb;
+    assign uart_baud_div = uut.uart_core_baud_div;
+    assign uart_os_rate  = uut.uart_core_os_rate;
+
+endmodule
+
+`default_nettype wire
@@ -0,0 +1,85 @@
+//==============================================================================
+// SRAM Model for the Verilator Harness - IS61WV51216BLL-10TLI
+//
+// 512KB (256K x 16-bit) asynchronous SRAM, behaviour of sim/sram_model.v
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+//
+// Reads are combinational: with CS and OE low and WE high the word at the
+// address is on the bus as soon as the model is evaluated. The 10 ns access
+// time is shorter than the 20 ns cycle the controller waits before sampling,
+// so it is not modelled. A write latches address and data while CS and WE
+// are low and stores them when the pulse ends, like the chip.
+//
+// Byte addresses map the way sram_controller.v splits a word: the
+// low halfword of byte address A is SRAM word A[18:1], little endian.
+//
+//==============================================================================
+
+#ifndef SIM_SRAM_MODEL_H
+#define SIM_SRAM_MODEL_H
+
+#include <cstdint>
+#include <vector>
+
+class SramModel {
+public:
+    static const uint32_t WORDS = 1u << 18;         // 256K x 16-bit
+    static const uint32_t BYTES = WORDS * 2;        // 512KB
+
+    SramModel() : mem_(WORDS, 0) {}
+
+    // Loader access (byte address 0 .. BYTES-1)
+    void write_byte(uint32_t addr, uint8_t value) {
+        uint16_t &w = mem_[(addr >> 1) & (WORDS - 1)];
+        if (addr & 1)
+            w = (uint16_t)((w & 0x00FF) | (value << 8));
+        else
+            w = (uint16_t)((w & 0xFF00) | value);
+    }
+
+    uint8_t read_byte(uint32_t addr) const {
+        uint16_t w = mem_[(addr >> 1) & (WORDS - 1)];
+        return (addr & 1) ? (uint8_t)(w >> 8) : (uint8_t)w;
+    }
+
+    // Call after every eval() of the design. Returns true when the read
+    // data on the bus changed, so the caller has to evaluate again.
+    template <class Top>
+    bool eval(Top *top) {
+        bool cs = !top->sram_cs_n;
+        bool oe = !top->sram_oe_n;
+        bool we = !top->sram_we_n;
+
+        if (cs && we) {
+            wr_addr_ = top->sram_addr & (WORDS - 1);
+            wr_data_ = top->sram_wdata;
+        } else if (writing_) {
+            mem_[wr_addr_] = wr_data_;
+            writes_++;
+        }
+        writing_ = cs && we;
+
+        uint16_t rdata = (cs && oe && !we) ? mem_[top->sram_addr & (WORDS - 1)] : 0;
+        if (rdata == top->sram_rdata)
+            return false;
+        top->sram_rdata = rdata;
+        return true;
+    }
+
+    uint64_t writes() const { return writes_; }
+
+private:
+    std::vector<uint16_t> mem_;
+    bool     writing_ = false;
+    uint32_t wr_addr_ = 0;
+    uint16_t wr_data_ = 0;
+    uint64_t writes_ = 0;
+};
+
+#endif // SIM_SRAM_MODEL_H
@@ -0,0 +1,118 @@
+//==============================================================================
+// UART Bridge for the Verilator Harness
+//
+// Decodes UART_TX and drives UART_RX bit by bit, at whatever rate the
+// design's baud divider is set to
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+//
+// The bit time comes from the UART core's own divider (uart.v: baud_div is
+// clocks per oversampling tick in 16.8 fixed point, os_rate ticks per bit)
+// and is read again at every start bit, so firmware that raises the rate
+// after the lib/uart_baud.h handshake keeps working. Both directions are
+// 8N1, timed in system clocks, so the firmware sees the same RX FIFO
+// timing as on the board.
+//
+// tick() is called once per system clock rising edge.
+//
+//==============================================================================
+
+#ifndef SIM_UART_BRIDGE_H
+#define SIM_UART_BRIDGE_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+
+class UartBridge {
+public:
+    // Bytes to send to the design, in order
+    void send(uint8_t c) { rx_queue_.push_back(c); }
+    void send(const std::string &s) { for (char c : s) send((uint8_t)c); }
+    bool rx_idle() const { return rx_bit_ < 0 && rx_queue_.empty(); }
+
+    // One system clock: samples UART_TX and sets UART_RX. Returns true with
+    // the byte in *out when a character has finished on TX.
+    template <class Top>
+    bool tick(Top *top, uint64_t now, uint8_t *out) {
+        bool got = false;
+        double bit = bit_clocks(top);
+
+        // TX decode: start bit edge, then sample mid-bit
+        if (tx_bit_ < 0) {
+            if (tx_prev_ && !top->UART_TX) {
+                tx_bit_ = 0;
+                tx_bit_len_ = bit;
+                tx_start_ = now;
+                tx_shift_ = 0;
+            }
+        } else if ((double)(now - tx_start_) >= (tx_bit_ + 1.5) * tx_bit_len_) {
+            if (tx_bit_ < 8) {
+                tx_shift_ |= (uint8_t)(top->UART_TX ? 1 : 0) << tx_bit_;
+                tx_bit_++;
+            } else {
+                if (top->UART_TX) {         // Valid stop bit
+                    *out = tx_shift_;
+                    got = true;
+                } else {
+                    framing_errors_++;
+                }
+                tx_bit_ = -1;
+            }
+        }
+        tx_prev_ = top->UART_TX;
+
+        // RX drive: start bit, 8 data bits LSB first, stop bit
+        if (rx_bit_ < 0) {
+            if (!rx_queue_.empty()) {
+                rx_byte_ = rx_queue_.front();
+                rx_queue_.pop_front();
+                rx_bit_ = 0;
+                rx_bit_len_ = bit;
+                rx_start_ = now;
+            }
+        } else {
+            int n = (int)((double)(now - rx_start_) / rx_bit_len_);
+            rx_bit_ = (n > 9) ? -1 : n;
+        }
+        if (rx_bit_ == 0)
+            top->UART_RX = 0;
+        else if (rx_bit_ >= 1 && rx_bit_ <= 8)
+            top->UART_RX = (rx_byte_ >> (rx_bit_ - 1)) & 1;
+        else
+            top->UART_RX = 1;
+
+        return got;
+    }
+
+    uint64_t framing_errors() const { return framing_errors_; }
+
+    template <class Top>
+    static double bit_clocks(Top *top) {
+        double div = top->uart_baud_div / 256.0;
+        return div * (top->uart_os_rate ? top->uart_os_rate : 16);
+    }
+
+private:
+    // TX (design -> host)
+    bool     tx_prev_ = true;
+    int      tx_bit_ = -1;              // -1 idle, 0-7 data bits, 8 stop bit
+    double   tx_bit_len_ = 0;
+    uint64_t tx_start_ = 0;
+    uint8_t  tx_shift_ = 0;
+    uint64_t framing_errors_ = 0;
+
+    // RX (host -> design)
+    std::deque<uint8_t> rx_queue_;
+    int      rx_bit_ = -1;              // -1 idle, 0 start, 1-8 data, 9 stop
+    double   rx_bit_len_ = 0;
+    uint64_t rx_start_ = 0;
+    uint8_t  rx_byte_ = 0;
+};
+
+#endif // SIM_UART_BRIDGE_H
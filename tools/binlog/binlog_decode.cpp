@@ -0,0 +1,407 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// binlog_decode.cpp - Format lib/binlog Records from a UART Capture
+//
+// BLOG() sends a 16-bit format ID (the string's offset in the ELF's
+// non-loaded .binlog section), a timestamp and the raw argument words.
+// This looks the format up in the firmware ELF, formats the arguments the
+// way printf would and prints one timestamped line per record. Text the
+// firmware printed between records is passed through as is, so a plain
+// console capture works, and so does a live port:
+//
+//   stty -F /dev/ttyUSB0 1000000 raw && binlog_decode app.elf < /dev/ttyUSB0
+//
+// A 0x1E byte only starts a record if the ID names a format and the
+// argument count is possible; otherwise it is text.
+//
+// Usage: binlog_decode [options] <firmware.elf> [capture.log]   (stdin if none)
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../rvsim/elf_image.h"
+
+// lib/binlog/binlog.h
+#define BINLOG_SYNC         0x1E
+#define BINLOG_FLAG_CYCLES  0x80
+#define BINLOG_ID_DROPPED   0xFFFF
+#define BINLOG_MAX_ARGS     8
+
+#define SRAM_SIZE           0x80000     // %s is looked up in the SRAM image
+
+static void print_usage(const char *prog) {
+    fprintf(stderr, "lib/binlog record decoder\n\n");
+    fprintf(stderr, "Usage: %s [options] <firmware.elf> [capture.log]\n\n", prog);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "  -c, --clock <hz>        CPU clock for cycle timestamps (default 50000000)\n");
+    fprintf(stderr, "  -r, --relative          Time from the first record\n");
+    fprintf(stderr, "  -d, --delta             Also print the time since the previous record\n");
+    fprintf(stderr, "  -n, --no-text           Drop the text between records\n");
+    fprintf(stderr, "  -h, --help              Show this help\n\n");
+    fprintf(stderr, "The capture is read from stdin without a file. Example:\n");
+    fprintf(stderr, "  %s -d firmware/binlog_demo.elf capture.log\n", prog);
+}
+
+struct Image {
+    std::vector<uint8_t> fmt;           // .binlog section
+    std::vector<uint8_t> sram;          // Loaded segments, for %s
+    std::vector<bool> loaded;
+
+    // Segments outside SRAM (XIP flash, scratchpad) are skipped
+    bool poke(uint32_t addr, uint8_t v) {
+        if (addr >= sram.size())
+            return true;
+        sram[addr] = v;
+        loaded[addr] = true;
+        return true;
+    }
+};
+
+// Contents of the named section; false if there is none
+static bool elf_section(const std::vector<uint8_t> &img, const char *name, std::vector<uint8_t> &out) {
+    uint32_t shoff = elf_rd32(&img[32]);
+    uint32_t shentsize = elf_rd16(&img[46]);
+    uint32_t shnum = elf_rd16(&img[48]);
+    uint32_t shstrndx = elf_rd16(&img[50]);
+    if (shoff == 0 || shstrndx >= shnum || (uint64_t)shoff + (uint64_t)shnum * shentsize > img.size())
+        return false;
+
+    auto sh = [&](uint32_t i) { return &img[shoff + i * shentsize]; };
+    uint32_t stroff = elf_rd32(sh(shstrndx) + 16);
+    uint32_t strsize = elf_rd32(sh(shstrndx) + 20);
+
+    for (uint32_t i = 0; i < shnum; i++) {
+        uint32_t n = elf_rd32(sh(i));
+        if (n >= strsize || (uint64_t)stroff + strsize > img.size())
+            continue;
+        if (strncmp((const char *)&img[stroff + n], name, strsize - n) != 0)
+            continue;
+        uint32_t off = elf_rd32(sh(i) + 16);
+        uint32_t size = elf_rd32(sh(i) + 20);
+        if ((uint64_t)off + size > img.size())
+            return false;
+        out.assign(img.begin() + off, img.begin() + off + size);
+        return true;
+    }
+    return false;
+}
+
+// The format at id, or NULL if id is not the start of one
+static const char *format_at(const Image &im, uint32_t id) {
+    if (id >= im.fmt.size() || (id > 0 && im.fmt[id - 1] != 0))
+        return NULL;
+    if (!memchr(&im.fmt[id], 0, im.fmt.size() - id))
+        return NULL;
+    return (const char *)&im.fmt[id];
+}
+
+static std::string string_at(const Image &im, uint32_t addr) {
+    std::string s;
+    for (uint32_t a = addr; a < im.sram.size() && im.loaded[a]; a++) {
+        if (im.sram[a] == 0)
+            return s;
+        s += (char)im.sram[a];
+        if (s.size() > 256)
+            break;
+    }
+    char buf[24];
+    snprintf(buf, sizeof(buf), "<str@0x%08x>", addr);
+    return buf;
+}
+
+// printf() with 32-bit argument words; returns the number of arguments
+// the format wanted
+static size_t format_record(const Image &im, const char *fmt, const uint32_t *args, size_t nargs,
+                            std::string &out) {
+    size_t used = 0;
+    auto next = [&](bool &ok) -> uint32_t {
+        ok = used < nargs;
+        return used < nargs ? args[used++] : (used++, 0);
+    };
+
+    for (const char *p = fmt; *p; p++) {
+        if (*p != '%') {
+            out += *p;
+            continue;
+        }
+        if (p[1] == '%') {
+            out += '%';
+            p++;
+            continue;
+        }
+
+        // %[flags][width][.precision][length]conversion
+        std::string spec = "%";
+        bool ok = true;
+        const char *q = p + 1;
+        while (*q && strchr("-+ #0", *q))
+            spec += *q++;
+        for (int part = 0; part < 2; part++) {
+            if (part == 1) {
+                if (*q != '.')
+                    break;
+                spec += *q++;
+            }
+            if (*q == '*') {
+                bool have;
+                spec += std::to_string((int32_t)next(have));
+                ok &= have;
+                q++;
+            }
+            while (*q >= '0' && *q <= '9')
+                spec += *q++;
+        }
+        int longs = 0;
+        while (*q && strchr("hlLqjzt", *q)) {
+            if (*q == 'l' || *q == 'L' || *q == 'q' || *q == 'j')
+                longs++;
+            q++;
+        }
+        char conv = *q;
+        if (!conv)
+            break;
+        p = q;
+
+        bool have;
+        char buf[512];
+        buf[0] = 0;
+        if (strchr("diuxXoc", conv) && longs < 2) {
+            uint32_t v = next(have);
+            spec += conv;
+            if (conv == 'd' || conv == 'i')
+                snprintf(buf, sizeof(buf), spec.c_str(), (int)(int32_t)v);
+            else if (conv == 'c')
+                snprintf(buf, sizeof(buf), spec.c_str(), (int)(uint8_t)v);
+            else
+                snprintf(buf, sizeof(buf), spec.c_str(), (unsigned)v);
+        } else if (conv == 'p') {
+            snprintf(buf, sizeof(buf), "0x%08x", next(have));
+        } else if (conv == 's') {
+            uint32_t a = next(have);
+            spec += 's';
+            snprintf(buf, sizeof(buf), spec.c_str(), string_at(im, a).c_str());
+        } else {
+            // 64-bit, floating point, %n: not representable as one word
+            next(have);
+            snprintf(buf, sizeof(buf), "<%%%c?>", conv);
+        }
+        out += (ok && have) ? buf : "<?>";
+    }
+    return used;
+}
+
+struct Decoder {
+    const Image &im;
+    double clock_hz = 50e6;
+    bool relative = false;
+    bool delta = false;
+    bool text = true;
+
+    bool at_line_start = true;
+    bool have_time = false;
+    uint32_t last_ts = 0;
+    uint64_t base[2] = { 0, 0 };        // Unwrapped high part: us, cycles
+    double first_s = 0;
+    double prev_s = 0;
+
+    uint64_t records = 0;
+    uint64_t dropped = 0;
+
+    explicit Decoder(const Image &image) : im(image) {}
+
+    void put_text(char c) {
+        if (!text)
+            return;
+        fputc(c, stdout);
+        at_line_start = (c == '\n');
+        if (at_line_start)
+            fflush(stdout);
+    }
+
+    // Bytes of a whole record at the front of b (b[0] = sync), 0 if b
+    // holds only part of one, -1 if it is not a record
+    long record_length(const std::string &b) const {
+        if (b.size() < 4)
+            return 0;
+        uint32_t flags = (uint8_t)b[1];
+        uint32_t nargs = flags & 0x7F;
+        uint32_t id = (uint8_t)b[2] | ((uint8_t)b[3] << 8);
+        if (nargs > BINLOG_MAX_ARGS)
+            return -1;
+        if (id == BINLOG_ID_DROPPED ? nargs != 1 : !format_at(im, id))
+            return -1;
+        size_t len = 8 + 4 * nargs;
+        return b.size() >= len ? (long)len : 0;
+    }
+
+    double seconds(uint32_t ts, bool cycles) {
+        // Timestamps are 32 bits: count the wraps (records in ring order)
+        uint64_t &hi = base[cycles ? 1 : 0];
+        if (have_time && ts < last_ts)
+            hi += 1ull << 32;
+        last_ts = ts;
+        double s = cycles ? (double)(hi + ts) / clock_hz : (double)(hi + ts) / 1e6;
+        if (!have_time)
+            first_s = prev_s = s;
+        have_time = true;
+        return s;
+    }
+
+    void record(const std::string &b) {
+        auto word = [&](size_t i) { return elf_rd32((const uint8_t *)b.data() + 4 * i); };
+        uint32_t flags = (uint8_t)b[1];
+        uint32_t nargs = flags & 0x7F;
+        uint32_t id = word(0) >> 16;
+        uint32_t args[BINLOG_MAX_ARGS];
+        for (uint32_t i = 0; i < nargs; i++)
+            args[i] = word(2 + i);
+
+        double s = seconds(word(1), flags & BINLOG_FLAG_CYCLES);
+        double t = relative ? s - first_s : s;
+
+        std::string msg;
+        if (id == BINLOG_ID_DROPPED) {
+            msg = "*** " + std::to_string(args[0]) + " records dropped (ring full) ***";
+            dropped += args[0];
+        } else {
+            size_t want = format_record(im, format_at(im, id), args, nargs, msg);
+            for (size_t i = want; i < nargs; i++) {
+                char extra[16];
+                snprintf(extra, sizeof(extra), " 0x%08x", args[i]);
+                msg += extra;
+            }
+            records++;
+        }
+
+        if (!at_line_start)
+            fputc('\n', stdout);
+        if (delta)
+            printf("[%12.6f +%10.6f] %s\n", t, s - prev_s, msg.c_str());
+        else
+            printf("[%12.6f] %s\n", t, msg.c_str());
+        fflush(stdout);
+        at_line_start = true;
+        prev_s = s;
+    }
+
+    void run(FILE *in) {
+        std::string pend;               // pend[0] is a sync byte
+        int c;
+
+        while ((c = fgetc(in)) != EOF) {
+            if (pend.empty()) {
+                if (c == BINLOG_SYNC)
+                    pend += (char)c;
+                else
+                    put_text((char)c);
+                continue;
+            }
+            pend += (char)c;
+            scan(pend, false);
+        }
+        scan(pend, true);
+    }
+
+    // Take records off the front of pend; a sync byte that is not one
+    // goes out as text and the search restarts after it
+    void scan(std::string &pend, bool eof) {
+        while (!pend.empty()) {
+            long n = record_length(pend);
+            if (n > 0) {
+                record(pend.substr(0, n));
+                pend.erase(0, n);
+            } else if (n == 0 && !eof) {
+                return;
+            } else {
+                put_text(pend[0]);
+                pend.erase(0, 1);
+            }
+            size_t sync = pend.find((char)BINLOG_SYNC);
+            for (size_t i = 0; i < std::min(sync, pend.size()); i++)
+                put_text(pend[i]);
+            pend.erase(0, std::min(sync, pend.size()));
+        }
+    }
+};
+
+int main(int argc, char **argv) {
+    const char *firmware = NULL;
+    const char *capture = NULL;
+    double clock_hz = 50e6;
+    bool relative = false, delta = false, text = true;
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        bool has_arg = i + 1 < argc;
+        if (strcmp(a, "-c") == 0 || strcmp(a, "--clock") == 0) {
+            if (!has_arg) { print_usage(argv[0]); return 1; }
+            clock_hz = strtod(argv[++i], NULL);
+        } else if (strcmp(a, "-r") == 0 || strcmp(a, "--relative") == 0) {
+            relative = true;
+        } else if (strcmp(a, "-d") == 0 || strcmp(a, "--delta") == 0) {
+            delta = true;
+        } else if (strcmp(a, "-n") == 0 || strcmp(a, "--no-text") == 0) {
+            text = false;
+        } else if (strcmp(a, "-h") == 0 || strcmp(a, "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else if (!firmware) {
+            firmware = a;
+        } else {
+            capture = a;
+        }
+    }
+
+    if (!firmware || clock_hz <= 0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<uint8_t> elf;
+    std::string e = file_read(firmware, elf);
+    if (e.empty() && (!elf_is_elf(elf) || !elf_check(elf).empty()))
+        e = "not a RISC-V ELF";
+    Image im;
+    im.sram.assign(SRAM_SIZE, 0);
+    im.loaded.assign(SRAM_SIZE, false);
+    LoadInfo info;
+    if (e.empty())
+        e = firmware_load(elf, im, info);
+    if (e.empty() && !elf_section(elf, ".binlog", im.fmt))
+        e = "no .binlog section (no BLOG() calls, or not linked with the generated linker.ld)";
+    if (!e.empty()) {
+        fprintf(stderr, "[BINLOG] ERROR: %s: %s\n", firmware, e.c_str());
+        return 1;
+    }
+
+    FILE *in = stdin;
+    if (capture && !(in = fopen(capture, "rb"))) {
+        fprintf(stderr, "[BINLOG] ERROR: cannot open %s\n", capture);
+        return 1;
+    }
+
+    Decoder d(im);
+    d.clock_hz = clock_hz;
+    d.relative = relative;
+    d.delta = delta;
+    d.text = text;
+    d.run(in);
+    if (in != stdin)
+        fclose(in);
+
+    if (!d.at_line_start)
+        fputc('\n', stdout);
+    fprintf(stderr, "[BINLOG] %llu records, %llu dropped on the target\n",
+            (unsigned long long)d.records, (unsigned long long)d.dropped);
+    return 0;
+}
@@ -0,0 +1,280 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// crashdecode.cpp - Decode SD Card Crash Dumps (CRASH.DMP)
+//
+// Reads the binary dump the SD card manager writes when an overlay hangs
+// (watchdog pre-timeout) or traps (firmware/sd_fatfs/crash_sd.c), checks
+// its CRCs and prints it against the firmware's ELF symbols: the PC and
+// registers as function+offset, the code words around the PC and every
+// stack word that points into code, which is the likely call chain.
+// Overlays add symbols with -s elf@addr, as in pcprof and rvsim.
+//
+// Usage: crashdecode [options] <firmware.elf> <CRASH.DMP>
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../rvsim/elf_image.h"
+
+// crash_sd_header_t (firmware/sd_fatfs/crash_sd.h)
+static const uint32_t CRASH_SD_MAGIC = 0x44435652;     // "RVCD"
+static const uint32_t CRASH_SD_VERSION = 1;
+static const uint32_t MAX_REGIONS = 8;
+static const uint32_t OFF_X = 36;                      // x[32]
+static const uint32_t OFF_NUM_REGIONS = OFF_X + 128;
+static const uint32_t OFF_REGION = OFF_NUM_REGIONS + 4;
+static const uint32_t OFF_HEADER_CRC = OFF_REGION + MAX_REGIONS * 16;
+
+static const uint32_t CAUSE_WATCHDOG = 1;
+static const uint32_t CAUSE_TRAP = 2;
+static const uint32_t FLAG_SAVED_REGS = 1;
+
+struct Region {
+    uint32_t addr, size, offset, crc;
+    bool ok;
+};
+
+static const char *const abi[32] = {
+    "zero", "ra", "sp", "gp", "tp", "t0", "t1", "t2", "s0", "s1", "a0", "a1", "a2", "a3",
+    "a4", "a5", "a6", "a7", "s2", "s3", "s4", "s5", "s6", "s7", "s8", "s9", "s10", "s11",
+    "t3", "t4", "t5", "t6"
+};
+
+static void print_usage(const char *prog) {
+    fprintf(stderr, "Crash dump decoder (CRASH.DMP from the SD card manager)\n\n");
+    fprintf(stderr, "Usage: %s [options] <firmware.elf> <CRASH.DMP>\n\n", prog);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "  -s, --symbols <elf>[@addr]  More symbols, e.g. an overlay (at addr)\n");
+    fprintf(stderr, "  -x, --extract <prefix>  Write each region to <prefix>_<addr>.bin\n");
+    fprintf(stderr, "  -c, --code <n>          Code words shown around the PC (default 8)\n");
+    fprintf(stderr, "  -h, --help              Show this help\n\n");
+    fprintf(stderr, "Example:\n");
+    fprintf(stderr, "  %s -s overlays/mandel.elf firmware/sd_card_manager.elf CRASH.DMP\n", prog);
+}
+
+// zlib / lib/crc32.h CRC32
+static uint32_t crc32(const uint8_t *p, size_t len) {
+    uint32_t crc = 0xFFFFFFFF;
+    while (len--) {
+        crc ^= *p++;
+        for (int k = 0; k < 8; k++)
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+    return ~crc;
+}
+
+static bool load_symbols(const std::string &spec, bool first, SymbolTable &syms) {
+    std::string path = spec;
+    uint32_t base = 0;
+    bool rebase = false;
+    size_t at = spec.rfind('@');
+    if (!first && at != std::string::npos) {
+        path = spec.substr(0, at);
+        base = (uint32_t)strtoul(spec.c_str() + at + 1, NULL, 0);
+        rebase = true;
+    }
+    std::vector<uint8_t> elf;
+    std::string e = file_read(path.c_str(), elf);
+    if (e.empty() && (!elf_is_elf(elf) || !elf_check(elf).empty()))
+        e = "not a RISC-V ELF";
+    if (!e.empty()) {
+        fprintf(stderr, "[CRASHDECODE] ERROR: %s: %s\n", path.c_str(), e.c_str());
+        return false;
+    }
+    uint32_t offset = rebase ? base - elf_link_base(elf) : 0;
+    int n = elf_symbols(elf, offset, syms);
+    fprintf(stderr, "[CRASHDECODE] %d symbols from %s\n", n, path.c_str());
+    return true;
+}
+
+// "func+0x1c", or "" outside every symbol
+static std::string symbolize(const SymbolTable &syms, uint32_t addr) {
+    int s = syms.lookup(addr);
+    if (s < 0)
+        return "";
+    char off[16];
+    snprintf(off, sizeof(off), "+0x%x", addr - syms.at(s).addr);
+    return syms.at(s).name + off;
+}
+
+int main(int argc, char **argv) {
+    const char *firmware = NULL;
+    const char *dump = NULL;
+    const char *extract = NULL;
+    std::vector<std::string> extra_syms;
+    uint32_t code_words = 8;
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        bool has_arg = i + 1 < argc;
+        if (strcmp(a, "-s") == 0 || strcmp(a, "--symbols") == 0) {
+            if (!has_arg) { print_usage(argv[0]); return 1; }
+            extra_syms.push_back(argv[++i]);
+        } else if (strcmp(a, "-x") == 0 || strcmp(a, "--extract") == 0) {
+            if (!has_arg) { print_usage(argv[0]); return 1; }
+            extract = argv[++i];
+        } else if (strcmp(a, "-c") == 0 || strcmp(a, "--code") == 0) {
+            if (!has_arg) { print_usage(argv[0]); return 1; }
+            code_words = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(a, "-h") == 0 || strcmp(a, "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else if (!firmware) {
+            firmware = a;
+        } else {
+            dump = a;
+        }
+    }
+
+    if (!firmware || !dump) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    SymbolTable syms;
+    if (!load_symbols(firmware, true, syms))
+        return 1;
+    for (const std::string &spec : extra_syms)
+        if (!load_symbols(spec, false, syms))
+            return 1;
+    syms.finish();
+
+    std::vector<uint8_t> img;
+    std::string e = file_read(dump, img);
+    if (!e.empty()) {
+        fprintf(stderr, "[CRASHDECODE] ERROR: %s: %s\n", dump, e.c_str());
+        return 1;
+    }
+    if (img.size() < 512 || elf_rd32(&img[0]) != CRASH_SD_MAGIC) {
+        fprintf(stderr, "[CRASHDECODE] ERROR: %s: no crash dump (file empty or never written)\n", dump);
+        return 1;
+    }
+    const uint8_t *h = &img[0];
+    uint32_t version = elf_rd16(h + 4);
+    if (version != CRASH_SD_VERSION) {
+        fprintf(stderr, "[CRASHDECODE] ERROR: %s: format version %u, expected %u\n", dump,
+                version, CRASH_SD_VERSION);
+        return 1;
+    }
+    bool header_ok = crc32(h, OFF_HEADER_CRC) == elf_rd32(h + OFF_HEADER_CRC);
+
+    uint32_t seq = elf_rd32(h + 8);
+    uint32_t cause = elf_rd32(h + 12);
+    uint32_t flags = elf_rd32(h + 16);
+    uint32_t time_ms = elf_rd32(h + 20);
+    uint32_t wdt_cause = elf_rd32(h + 24);
+    uint32_t pc = elf_rd32(h + 28);
+    uint32_t irq_mask = elf_rd32(h + 32);
+    uint32_t x[32];
+    for (int r = 0; r < 32; r++)
+        x[r] = elf_rd32(h + OFF_X + r * 4);
+
+    std::vector<Region> regions;
+    uint32_t nreg = elf_rd32(h + OFF_NUM_REGIONS);
+    for (uint32_t i = 0; i < nreg && i < MAX_REGIONS; i++) {
+        const uint8_t *p = h + OFF_REGION + i * 16;
+        Region r = { elf_rd32(p), elf_rd32(p + 4), elf_rd32(p + 8), elf_rd32(p + 12), false };
+        if ((uint64_t)r.offset + r.size <= img.size())
+            r.ok = crc32(&img[r.offset], r.size) == r.crc;
+        regions.push_back(r);
+    }
+
+    // Word at addr from the saved regions
+    auto peek = [&](uint32_t addr, uint32_t &v) {
+        for (const Region &r : regions)
+            if (addr >= r.addr && addr - r.addr + 4 <= r.size && r.offset + (addr - r.addr) + 4 <= img.size()) {
+                v = elf_rd32(&img[r.offset + (addr - r.addr)]);
+                return true;
+            }
+        return false;
+    };
+
+    const char *what = cause == CAUSE_WATCHDOG ? "watchdog pre-timeout (overlay hung)" :
+                       cause == CAUSE_TRAP ? "illegal instruction / EBREAK" : "unknown";
+    printf("Crash #%u: %s, %u.%03u s after reset%s\n", seq, what, time_ms / 1000, time_ms % 1000,
+           header_ok ? "" : "  [HEADER CRC BAD]");
+    if (wdt_cause & 0x80000000u)
+        printf("Watchdog: last reset %s, %u watchdog resets since power-on\n",
+               (wdt_cause & 3) == 1 ? "by the watchdog" : (wdt_cause & 3) == 2 ? "by the hardware loader" : "at power-on",
+               (wdt_cause >> 8) & 0xFF);
+    printf("\n");
+
+    std::string pc_sym = symbolize(syms, pc);
+    printf("  pc  0x%08x  %s\n", pc, pc_sym.empty() ? "(no symbol)" : pc_sym.c_str());
+    printf("  irq 0x%08x\n\n", irq_mask);
+
+    for (int r = 1; r < 32; r++) {
+        bool saved = (r >= 8 && r <= 9) || (r >= 18 && r <= 27) || r == 3 || r == 4;
+        std::string s = symbolize(syms, x[r]);
+        printf("  %-4s (x%-2d) 0x%08x", abi[r], r, x[r]);
+        if (saved && !(flags & FLAG_SAVED_REGS))
+            printf("  (not captured)");
+        else if (!s.empty())
+            printf("  %s", s.c_str());
+        printf("\n");
+    }
+
+    if (code_words) {
+        printf("\nCode around the PC:\n");
+        uint32_t start = (pc & ~3u) - (code_words / 2) * 4;
+        for (uint32_t i = 0; i < code_words; i++) {
+            uint32_t a = start + i * 4, v;
+            if (!peek(a, v))
+                continue;
+            std::string s = symbolize(syms, a);
+            printf("  %s 0x%08x: %08x  %s\n", a == (pc & ~3u) ? "=>" : "  ", a, v, s.c_str());
+        }
+    }
+
+    // Return addresses left on the stack, innermost first
+    uint32_t sp = x[2];
+    printf("\nCode addresses on the stack (likely callers, innermost first):\n");
+    int found = 0;
+    for (const Region &r : regions) {
+        if (sp < r.addr || sp >= r.addr + r.size)
+            continue;
+        for (uint32_t a = sp & ~3u; a + 4 <= r.addr + r.size; a += 4) {
+            uint32_t v;
+            if (!peek(a, v))
+                break;
+            std::string s = symbolize(syms, v);
+            if (s.empty())
+                continue;
+            printf("  [sp+0x%03x] 0x%08x  %s\n", a - sp, v, s.c_str());
+            found++;
+        }
+        break;
+    }
+    if (!found)
+        printf("  (none)\n");
+
+    printf("\nRegions:\n");
+    for (const Region &r : regions) {
+        printf("  0x%08x - 0x%08x  %6u bytes  %s\n", r.addr, r.addr + r.size - 1, r.size,
+               r.ok ? "CRC ok" : "CRC BAD");
+        if (extract && (uint64_t)r.offset + r.size <= img.size()) {
+            char path[512];
+            snprintf(path, sizeof(path), "%s_%08x.bin", extract, r.addr);
+            FILE *f = fopen(path, "wb");
+            if (!f || fwrite(&img[r.offset], 1, r.size, f) != r.size) {
+                fprintf(stderr, "[CRASHDECODE] ERROR: cannot write %s\n", path);
+                if (f)
+                    fclose(f);
+                return 1;
+            }
+            fclose(f);
+        }
+    }
+
+    return header_ok ? 0 : 2;
+}
@@ -0,0 +1,388 @@
+//===============================================================================
+// HTTP Load Generator - Linux Host Application
+//
+// Requests/s and latency of the board's HTTP server (slip_http_server,
+// lwIP/port/static_httpd.c) with a new connection per request, with
+// keep-alive, and with pipelined requests on each connection. Several
+// connections run at once from one poll() loop; every response is read to
+// the end of its Content-Length, so a short or corrupt reply is an error.
+//
+// The latency of a request runs from writing it to the last byte of its
+// response: with pipelining that includes the requests queued before it.
+// A keep-alive connection the server closes (Connection: close, max=)
+// is opened again and the requests it had not answered are sent again.
+//
+// Usage:
+//   ./http_bench [options] <server_ip>
+//
+// Options:
+//   -p <port>      Server port (default: 80)
+//   -u <path>      Path to request (default: /)
+//   -n <count>     Requests in total (default: 100)
+//   -c <conns>     Connections at once (default: 1)
+//   -k             Keep-alive: reuse each connection (default: close)
+//   -P <depth>     Requests in flight per connection, implies -k (default: 1)
+//   -t <ms>        Timeout without progress on a connection (default: 5000)
+//
+// Example:
+//   ./http_bench 192.168.100.2 -n 200
+//   ./http_bench 192.168.100.2 -n 200 -k
+//   ./http_bench 192.168.100.2 -n 200 -c 2 -P 4
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+
+#define _POSIX_C_SOURCE 200809L     /* clock_gettime() under -std=c99 */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <time.h>
+#include <errno.h>
+#include <getopt.h>
+
+#define MAX_CONNS       16
+#define MAX_DEPTH       32
+#define RX_BUF          8192
+
+struct conn {
+    int fd;                         // -1: not open
+    int connecting;
+    int inflight;                   // Requests sent, response not complete
+    double sent_at[MAX_DEPTH];      // Send time of each, oldest first
+    int served;                     // Responses on this connection
+    int closing;                    // Server said Connection: close
+    long body_left;                 // Body bytes of the current response, -1: in header
+    double last;                    // Last progress
+    char rx[RX_BUF];
+    int rx_len;
+};
+
+static struct sockaddr_in server;
+static const char *path = "/";
+static int total = 100;
+static int nconns = 1;
+static int keep_alive = 0;
+static int depth = 1;
+static int timeout_ms = 5000;
+
+static struct conn conns[MAX_CONNS];
+static int issued, done, failed, opened;
+static long long body_bytes;
+static double *latency;
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+//==============================================================================
+// Connections
+//==============================================================================
+
+static void conn_close(struct conn *c) {
+    if (c->fd >= 0) {
+        close(c->fd);
+    }
+    c->fd = -1;
+}
+
+// The requests a closed connection had not answered go out again
+static void conn_drop(struct conn *c, int error) {
+    if (error) {
+        failed += c->inflight;
+    } else {
+        issued -= c->inflight;
+    }
+    c->inflight = 0;
+    conn_close(c);
+}
+
+static int conn_open(struct conn *c) {
+    int one = 1;
+
+    memset(c, 0, offsetof(struct conn, rx));
+    c->fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (c->fd < 0) {
+        perror("socket");
+        return -1;
+    }
+    setsockopt(c->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    fcntl(c->fd, F_SETFL, fcntl(c->fd, F_GETFL) | O_NONBLOCK);
+
+    if (connect(c->fd, (struct sockaddr *)&server, sizeof(server)) < 0 && errno != EINPROGRESS) {
+        perror("connect");
+        conn_close(c);
+        return -1;
+    }
+    c->connecting = 1;
+    c->body_left = -1;
+    c->rx_len = 0;
+    c->last = now_ms();
+    opened++;
+    return 0;
+}
+
+// Fill the pipeline; requests are small enough for one write each
+static int conn_send(struct conn *c) {
+    char req[256];
+    int n;
+
+    while (c->inflight < depth && issued < total && !c->closing) {
+        n = snprintf(req, sizeof(req),
+                     "GET %s HTTP/1.1\r\n"
+                     "Host: %s\r\n"
+                     "%s\r\n",
+                     path, inet_ntoa(server.sin_addr),
+                     keep_alive ? "" : "Connection: close\r\n");
+        if (write(c->fd, req, n) != n) {
+            return -1;
+        }
+        c->sent_at[c->inflight++] = now_ms();
+        issued++;
+        if (!keep_alive) {
+            break;
+        }
+    }
+    return 0;
+}
+
+//==============================================================================
+// Responses
+//==============================================================================
+
+// Value of a header line in hdr (header only, NUL terminated), or NULL
+static const char *header_value(const char *hdr, const char *name) {
+    size_t len = strlen(name);
+    const char *p;
+
+    for (p = strstr(hdr, "\r\n"); p != NULL; p = strstr(p + 2, "\r\n")) {
+        if (!strncasecmp(p + 2, name, len) && p[2 + len] == ':') {
+            p += 3 + len;
+            while (*p == ' ') p++;
+            return p;
+        }
+    }
+    return NULL;
+}
+
+// Complete responses at the front of rx; -1 on a bad response
+static int conn_parse(struct conn *c) {
+    for (;;) {
+        if (c->body_left < 0) {
+            char *end;
+            const char *v;
+            int status;
+
+            c->rx[c->rx_len] = '\0';
+            end = strstr(c->rx, "\r\n\r\n");
+            if (end == NULL) {
+                return (c->rx_len >= RX_BUF - 1) ? -1 : 0;
+            }
+            *end = '\0';
+            if (c->inflight == 0 || sscanf(c->rx, "HTTP/1.%*d %d", &status) != 1 || status != 200) {
+                fprintf(stderr, "Bad response: %.40s\n", c->rx);
+                return -1;
+            }
+            v = header_value(c->rx, "Content-Length");
+            if (v == NULL) {
+                fprintf(stderr, "Response without Content-Length\n");
+                return -1;
+            }
+            c->body_left = strtol(v, NULL, 10);
+            v = header_value(c->rx, "Connection");
+            if (v != NULL && !strncasecmp(v, "close", 5)) {
+                c->closing = 1;
+            }
+
+            end += 4;
+            c->rx_len -= end - c->rx;
+            memmove(c->rx, end, c->rx_len);
+        }
+
+        // Body: counted, not kept
+        if (c->rx_len > 0 && c->body_left > 0) {
+            int n = (c->rx_len < c->body_left) ? c->rx_len : (int)c->body_left;
+            body_bytes += n;
+            c->body_left -= n;
+            c->rx_len -= n;
+            memmove(c->rx, c->rx + n, c->rx_len);
+        }
+        if (c->body_left != 0) {
+            return 0;
+        }
+
+        latency[done++] = now_ms() - c->sent_at[0];
+        memmove(c->sent_at, c->sent_at + 1, (--c->inflight) * sizeof(double));
+        c->served++;
+        c->body_left = -1;
+    }
+}
+
+static void conn_read(struct conn *c) {
+    ssize_t n = read(c->fd, c->rx + c->rx_len, RX_BUF - 1 - c->rx_len);
+
+    if (n < 0 && (errno == EAGAIN || errno == EINTR)) {
+        return;
+    }
+    if (n <= 0) {
+        // Closed: fine after Connection: close, else what was in flight failed
+        conn_drop(c, !c->closing && (c->inflight > 0 || c->served == 0));
+        return;
+    }
+
+    c->rx_len += n;
+    c->last = now_ms();
+    if (conn_parse(c) < 0) {
+        conn_drop(c, 1);
+        return;
+    }
+
+    if (c->inflight == 0 && (c->closing || !keep_alive)) {
+        conn_close(c);
+    } else if (conn_send(c) < 0) {
+        conn_drop(c, 1);
+    }
+}
+
+//==============================================================================
+// Main
+//==============================================================================
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [-p port] [-u path] [-n count] [-c conns] [-k] [-P depth] [-t ms] <server_ip>\n", prog);
+}
+
+int main(int argc, char **argv) {
+    struct pollfd pfd[MAX_CONNS];
+    int port = 80;
+    int opt, i;
+    double t0, secs;
+
+    while ((opt = getopt(argc, argv, "p:u:n:c:kP:t:")) != -1) {
+        switch (opt) {
+            case 'p': port = atoi(optarg); break;
+            case 'u': path = optarg; break;
+            case 'n': total = atoi(optarg); break;
+            case 'c': nconns = atoi(optarg); break;
+            case 'k': keep_alive = 1; break;
+            case 'P': depth = atoi(optarg); keep_alive = 1; break;
+            case 't': timeout_ms = atoi(optarg); break;
+            default: usage(argv[0]); return 1;
+        }
+    }
+    if (optind != argc - 1 || total < 1 || nconns < 1 || nconns > MAX_CONNS ||
+        depth < 1 || depth > MAX_DEPTH) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    memset(&server, 0, sizeof(server));
+    server.sin_family = AF_INET;
+    server.sin_port = htons(port);
+    if (inet_pton(AF_INET, argv[optind], &server.sin_addr) != 1) {
+        fprintf(stderr, "Bad address: %s\n", argv[optind]);
+        return 1;
+    }
+
+    latency = calloc(total, sizeof(double));
+    if (latency == NULL) {
+        return 1;
+    }
+    for (i = 0; i < nconns; i++) {
+        conns[i].fd = -1;
+    }
+
+    printf("HTTP load: %d requests for %s, %d connection(s), %s, depth %d\n",
+           total, path, nconns, keep_alive ? "keep-alive" : "close", depth);
+    t0 = now_ms();
+
+    while (done + failed < total) {
+        double t = now_ms();
+
+        // (Re)open connections while requests are left to send
+        for (i = 0; i < nconns; i++) {
+            struct conn *c = &conns[i];
+
+            if (c->fd < 0 && issued < total) {
+                if (conn_open(c) < 0) {
+                    return 1;
+                }
+            } else if (c->fd >= 0 && (c->connecting || c->inflight) && t - c->last > timeout_ms) {
+                if (c->connecting) {
+                    fprintf(stderr, "connect: timeout\n");
+                    return 1;
+                }
+                fprintf(stderr, "Timeout on connection %d (%d in flight)\n", i, c->inflight);
+                conn_drop(c, 1);
+            }
+            pfd[i].fd = c->fd;
+            pfd[i].events = (c->fd >= 0) ? (c->connecting ? POLLOUT : POLLIN) : 0;
+            pfd[i].revents = 0;
+        }
+
+        if (poll(pfd, nconns, 100) < 0 && errno != EINTR) {
+            perror("poll");
+            return 1;
+        }
+
+        for (i = 0; i < nconns; i++) {
+            struct conn *c = &conns[i];
+
+            if (c->fd < 0 || pfd[i].revents == 0) {
+                continue;
+            }
+            if (c->connecting) {
+                int err = 0;
+                socklen_t len = sizeof(err);
+
+                getsockopt(c->fd, SOL_SOCKET, SO_ERROR, &err, &len);
+                if (err != 0) {
+                    fprintf(stderr, "connect: %s\n", strerror(err));
+                    return 1;
+                }
+                c->connecting = 0;
+                c->last = now_ms();
+                if (conn_send(c) < 0) {
+                    conn_drop(c, 1);
+                }
+            } else {
+                conn_read(c);
+            }
+        }
+    }
+
+    secs = (now_ms() - t0) / 1000.0;
+    for (i = 0; i < nconns; i++) {
+        conn_close(&conns[i]);
+    }
+
+    printf("Requests: %d ok, %d failed, %d connections\n", done, failed, opened);
+    printf("Time: %.2f s, %.2f req/s, %.2f KB/s\n", secs,
+           secs > 0 ? done / secs : 0.0, secs > 0 ? body_bytes / 1024.0 / secs : 0.0);
+    if (done > 0) {
+        qsort(latency, done, sizeof(double), cmp_double);
+        printf("Latency: min %.2f ms, p50 %.2f ms, p99 %.2f ms, max %.2f ms\n",
+               latency[0], latency[(done - 1) / 2], latency[(done * 99 - 1) / 100], latency[done - 1]);
+    }
+
+    free(latency);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,303 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// lz4boot.c - LZ4 Boot Image Packer for the SD Bootloader
+//
+// Compresses a binary into the .bin.lz4 format the SD card manager's
+// compressed bootloader upload accepts (firmware/sd_bootloader/boot_header.h):
+//
+//   uint32_t magic   "LZ4B" (BOOT_LZ4_FILE_MAGIC)
+//   uint32_t length  uncompressed bytes
+//   uint32_t crc32   CRC32 of the uncompressed image (zlib polynomial)
+//   LZ4 block        raw block format, no frame
+//
+// The SD bootloader decodes the block straight into SRAM while it reads
+// the card, so only the compressed sectors have to cross the SPI bus.
+// Matches are searched with hash chains (compression time on the host is
+// free; the decoder cost is the same for any match choice).
+//
+// Usage: lz4boot input.bin output.bin.lz4
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#define LZ4B_MAGIC      0x42345A4C  // "LZ4B", BOOT_LZ4_FILE_MAGIC
+
+// LZ4 block format limits
+#define MIN_MATCH       4
+#define LAST_LITERALS   5           // Block always ends with 5+ literals
+#define MF_LIMIT        12          // Last match starts 12+ bytes before the end
+#define MAX_OFFSET      65535
+
+#define HASH_BITS       16
+#define CHAIN_DEPTH     256
+
+//==============================================================================
+// CRC32 (same as lib/crc32.h)
+//==============================================================================
+
+static uint32_t crc32_buf(const uint8_t *p, size_t len) {
+    uint32_t crc = 0xFFFFFFFF;
+
+    while (len--) {
+        crc ^= *p++;
+        for (int k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
+
+//==============================================================================
+// Compressor
+//==============================================================================
+
+static int32_t *head;
+static int32_t *prev;
+
+static uint32_t hash4(const uint8_t *p) {
+    uint32_t v = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+    return (v * 2654435761u) >> (32 - HASH_BITS);
+}
+
+static void insert(const uint8_t *src, size_t pos) {
+    uint32_t h = hash4(src + pos);
+    prev[pos] = head[h];
+    head[h] = (int32_t)pos;
+}
+
+// Longest match for pos (ending by limit); 0 if shorter than MIN_MATCH
+static size_t find_match(const uint8_t *src, size_t pos, size_t limit, size_t *offset) {
+    size_t best = 0;
+    int32_t cand = head[hash4(src + pos)];
+
+    for (int depth = 0; cand >= 0 && depth < CHAIN_DEPTH; depth++) {
+        if (pos - (size_t)cand > MAX_OFFSET) {
+            break;
+        }
+        size_t len = 0;
+        while (pos + len < limit && src[cand + len] == src[pos + len]) {
+            len++;
+        }
+        if (len > best) {
+            best = len;
+            *offset = pos - (size_t)cand;
+        }
+        cand = prev[cand];
+    }
+
+    return best >= MIN_MATCH ? best : 0;
+}
+
+static uint8_t *put_length(uint8_t *op, size_t n) {
+    while (n >= 255) {
+        *op++ = 255;
+        n -= 255;
+    }
+    *op++ = (uint8_t)n;
+    return op;
+}
+
+static uint8_t *put_sequence(uint8_t *op, const uint8_t *lit, size_t lit_len,
+                             size_t offset, size_t match_len) {
+    uint8_t *token = op++;
+    size_t ml = match_len ? match_len - MIN_MATCH : 0;
+
+    *token = (uint8_t)(((lit_len < 15 ? lit_len : 15) << 4) | (ml < 15 ? ml : 15));
+    if (lit_len >= 15) {
+        op = put_length(op, lit_len - 15);
+    }
+    memcpy(op, lit, lit_len);
+    op += lit_len;
+
+    if (match_len) {
+        *op++ = offset & 0xFF;
+        *op++ = offset >> 8;
+        if (ml >= 15) {
+            op = put_length(op, ml - 15);
+        }
+    }
+    return op;
+}
+
+// Compress n bytes into dst (at least n + n/255 + 16 bytes); returns the
+// block size
+static size_t lz4_compress(const uint8_t *src, size_t n, uint8_t *dst) {
+    uint8_t *op = dst;
+    size_t anchor = 0;
+    size_t pos = 0;
+
+    if (n > MF_LIMIT) {
+        size_t mf_limit = n - MF_LIMIT;
+        size_t match_limit = n - LAST_LITERALS;
+
+        while (pos < mf_limit) {
+            size_t offset = 0;
+            size_t len = find_match(src, pos, match_limit, &offset);
+
+            // One step lazy: take a literal if the next byte matches longer
+            if (len && pos + 1 < mf_limit) {
+                size_t next_offset = 0;
+                insert(src, pos);
+                size_t next = find_match(src, pos + 1, match_limit, &next_offset);
+                if (next > len + 1) {
+                    pos++;
+                    len = next;
+                    offset = next_offset;
+                }
+            } else {
+                insert(src, pos);
+            }
+
+            if (!len) {
+                pos++;
+                continue;
+            }
+
+            op = put_sequence(op, src + anchor, pos - anchor, offset, len);
+            for (size_t i = pos + 1; i < pos + len && i + MIN_MATCH <= n; i++) {
+                insert(src, i);
+            }
+            pos += len;
+            anchor = pos;
+        }
+    }
+
+    // Last sequence: literals only
+    return put_sequence(op, src + anchor, n - anchor, 0, 0) - dst;
+}
+
+//==============================================================================
+// Decoder (same checks as the SD bootloader's), to verify the output
+//==============================================================================
+
+static int lz4_decode(const uint8_t *ip, size_t in_len, uint8_t *dst, size_t length) {
+    const uint8_t *in_end = ip + in_len;
+    uint8_t *out = dst;
+    uint8_t *end = dst + length;
+
+    while (ip < in_end) {
+        uint8_t token = *ip++;
+        size_t n = token >> 4;
+        if (n == 15) {
+            uint8_t b;
+            do {
+                if (ip >= in_end) return -1;
+                b = *ip++;
+                n += b;
+            } while (b == 255);
+        }
+        if (n > (size_t)(end - out) || n > (size_t)(in_end - ip)) return -1;
+        memcpy(out, ip, n);
+        out += n;
+        ip += n;
+
+        if (out == end) {
+            return ip == in_end ? 0 : -1;
+        }
+
+        if (in_end - ip < 2) return -1;
+        size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        n = token & 15;
+        if (n == 15) {
+            uint8_t b;
+            do {
+                if (ip >= in_end) return -1;
+                b = *ip++;
+                n += b;
+            } while (b == 255);
+        }
+        n += MIN_MATCH;
+        if (offset == 0 || offset > (size_t)(out - dst) || n > (size_t)(end - out)) return -1;
+        for (const uint8_t *src = out - offset; n--; ) {
+            *out++ = *src++;
+        }
+    }
+    return -1;
+}
+
+//==============================================================================
+// Main
+//==============================================================================
+
+static void put_le32(uint8_t *p, uint32_t v) {
+    p[0] = v;
+    p[1] = v >> 8;
+    p[2] = v >> 16;
+    p[3] = v >> 24;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s input.bin output.bin.lz4\n", argv[0]);
+        return 1;
+    }
+
+    FILE *f = fopen(argv[1], "rb");
+    if (!f) {
+        perror(argv[1]);
+        return 1;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (size <= 0) {
+        fprintf(stderr, "%s: empty file\n", argv[1]);
+        return 1;
+    }
+
+    size_t n = (size_t)size;
+    uint8_t *src = malloc(n);
+    uint8_t *dst = malloc(12 + n + n / 255 + 16);
+    uint8_t *check = malloc(n);
+    head = malloc(sizeof(int32_t) << HASH_BITS);
+    prev = malloc(sizeof(int32_t) * n);
+    if (!src || !dst || !check || !head || !prev) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    if (fread(src, 1, n, f) != n) {
+        perror(argv[1]);
+        return 1;
+    }
+    fclose(f);
+
+    memset(head, 0xFF, sizeof(int32_t) << HASH_BITS);
+    size_t block = lz4_compress(src, n, dst + 12);
+    uint32_t crc = crc32_buf(src, n);
+
+    put_le32(dst, LZ4B_MAGIC);
+    put_le32(dst + 4, (uint32_t)n);
+    put_le32(dst + 8, crc);
+
+    if (lz4_decode(dst + 12, block, check, n) != 0 || memcmp(check, src, n) != 0) {
+        fprintf(stderr, "Internal error: LZ4 block does not decode back to %s\n", argv[1]);
+        return 1;
+    }
+
+    f = fopen(argv[2], "wb");
+    if (!f || fwrite(dst, 1, 12 + block, f) != 12 + block || fclose(f) != 0) {
+        perror(argv[2]);
+        return 1;
+    }
+
+    printf("%s: %zu -> %zu bytes (%.1f%%), %zu -> %zu sectors, CRC32 0x%08X\n",
+           argv[2], n, 12 + block, 100.0 * block / n,
+           (n + 511) / 512, (block + 511) / 512, crc);
+
+    free(src);
+    free(dst);
+    free(check);
+    free(head);
+    free(prev);
+    return 0;
+}
@@ -0,0 +1,759 @@
+//===============================================================================
+// Mandelbrot Render Farm - Linux Host Application
+//
+// Renders one Mandelbrot frame on several boards running mandel_worker
+// (firmware/lwIP/demos/mandel_worker.c) and reports the speedup over one
+// board. The frame is cut into tiles and each board is dealt a contiguous
+// run of them; a board keeps up to -q tiles queued, taken from the front of
+// its own run first. When its run is used up it takes tiles from the back
+// of the longest run left, and once all runs are empty it steals tiles a
+// slower board has queued but not started (the STEAL operation), so the
+// boards that drew the inside of the set do not finish last on their own.
+//
+// Lost datagrams: a board that has tiles outstanding but has sent nothing
+// for the timeout is sent them again (the worker does not queue a tile it
+// already has); after -r silent timeouts its tiles go to the other boards.
+// RESULTs for tiles already drawn are dropped.
+//
+// The kernel is mandelbrot_fixed's BRUTE mode (fix16_mandel, Q16.16, same
+// default view and max_iter): "compute" is the time the boards spent in it,
+// for one board the number to hold against mandelbrot_fixed's 'b' timing at
+// the same size, e.g. -W 80 -H 22 for an 80x24 terminal.
+//
+// Usage:
+//   ./mandel_farm [options] <board_ip>...
+//
+// Options:
+//   -f <file>      Board addresses from a file, one per line (# comments)
+//   -W <width>     Frame width in pixels (default: 320)
+//   -H <height>    Frame height in pixels (default: 240)
+//   -x <w>         Tile width (default: 32)
+//   -y <h>         Tile height (default: 16; w * h at most 640)
+//   -i <iter>      Max iterations (default: 256)
+//   -v <x0,y0,x1,y1>  View (default: -2.5,-1,1,1)
+//   -q <depth>     Tiles queued per board (default: 4, at most 9)
+//   -s             Sweep: render with the first 1, 2, ... N boards
+//   -o <file>      Write the (last) frame as a PPM image
+//   -p <port>      Worker port (default: 7790)
+//   -t <ms>        Timeout without a reply from a busy board (default: 2000)
+//   -r <count>     Timeouts before a board is given up (default: 5)
+//
+// Example:
+//   ./mandel_farm -s -o mandel.ppm 192.168.100.2 192.168.101.2 192.168.102.2
+//   ./mandel_farm -W 80 -H 22 192.168.100.2
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <getopt.h>
+
+//==============================================================================
+// Protocol (must match firmware/lwIP/demos/mandel_worker.c)
+//==============================================================================
+
+#define DEFAULT_PORT            7790
+#define MANDEL_MAGIC            0x3146444Du
+#define MANDEL_HDR_LEN          8
+#define MANDEL_TILE_LEN         28
+#define MANDEL_RESULT_LEN       20
+#define MANDEL_MAX_PIXELS       640
+#define MANDEL_QUEUE            8
+
+#define MANDEL_TILE             1
+#define MANDEL_STEAL            2
+#define MANDEL_INFO             3
+#define MANDEL_RESULT           4
+#define MANDEL_REPLY            0x80
+
+#define MAX_BOARDS              64
+#define MAX_DEPTH               (MANDEL_QUEUE + 1)  // Queued + running
+#define MAX_PACKET              1536
+
+//==============================================================================
+// Frame and Board State
+//==============================================================================
+
+typedef struct {
+    int x, y, w, h;                     // Pixels
+    int owner;                          // Board it was sent to, -1: not sent
+    int done;
+} tile_t;
+
+typedef struct {
+    struct sockaddr_in sa;
+    const char *name;
+    int *run;                           // Tiles dealt to this board, head..tail
+    int head, tail;
+    int out[MAX_DEPTH];                 // Sent, no RESULT yet, oldest first
+    int nout;
+    int batch[MAX_DEPTH];               // Last TILE message, for its ACK
+    int nbatch;
+    uint16_t batch_seq;
+    int full;                           // Queue full: wait for a RESULT
+    int steal_from;                     // STEAL sent to this board, -1: none
+    uint16_t steal_seq;
+    uint64_t steal_at;
+    uint64_t last_rx;
+    int silent;                         // Timeouts in a row
+    int dead;
+    // Per frame
+    int tiles;
+    int taken;                          // Tiles taken from another board's run
+    int stolen;                         // Tiles stolen from a board's queue
+    uint64_t us, iters;
+} board_t;
+
+static board_t boards[MAX_BOARDS];
+static int num_boards, active_boards;
+
+static tile_t *tiles;
+static int num_tiles, tiles_done;
+static uint16_t *image;
+
+static int width = 320, height = 240;
+static int tile_w = 32, tile_h = 16;
+static int max_iter = 256;
+static double view[4] = { -2.5, -1.0, 1.0, 1.0 };
+static int32_t fx0, fy0, fdx, fdy;
+static int depth = 4;
+static int timeout_ms = 2000;
+static int max_silent = 5;
+static int port = DEFAULT_PORT;
+
+static int sock;
+static uint16_t seq;
+static uint16_t frame;
+
+//==============================================================================
+// Helpers
+//==============================================================================
+
+static void put16(uint8_t *p, uint16_t v) {
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+}
+
+static void put32(uint8_t *p, uint32_t v) {
+    put16(p, v & 0xFFFF);
+    put16(p + 2, v >> 16);
+}
+
+static uint16_t get16(const uint8_t *p) {
+    return p[0] | (p[1] << 8);
+}
+
+static uint32_t get32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t now_ms(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+// fix16_from_double() as lib/fixmath/fixmath.h has it (truncating)
+static int32_t to_fix16(double v) {
+    return (int32_t)(v * 65536.0);
+}
+
+static int add_board(const char *name) {
+    board_t *b;
+
+    if (num_boards == MAX_BOARDS) {
+        fprintf(stderr, "Too many boards (max %d)\n", MAX_BOARDS);
+        return -1;
+    }
+    b = &boards[num_boards];
+    memset(b, 0, sizeof(*b));
+    b->sa.sin_family = AF_INET;
+    if (inet_pton(AF_INET, name, &b->sa.sin_addr) != 1) {
+        fprintf(stderr, "Bad board address: %s\n", name);
+        return -1;
+    }
+    b->name = strdup(name);
+    num_boards++;
+    return 0;
+}
+
+static int read_board_file(const char *path) {
+    FILE *f = fopen(path, "r");
+    char line[128];
+
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+    while (fgets(line, sizeof(line), f)) {
+        char *p = line, *end;
+
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p == '#' || *p == '\n' || *p == '\0') continue;
+        for (end = p; *end && *end != '\n' && *end != ' ' && *end != '\t' && *end != '#'; end++);
+        *end = '\0';
+        if (add_board(p) < 0) {
+            fclose(f);
+            return -1;
+        }
+    }
+    fclose(f);
+    return 0;
+}
+
+static void send_to(board_t *b, const uint8_t *buf, int len) {
+    sendto(sock, buf, len, 0, (struct sockaddr *)&b->sa, sizeof(b->sa));
+}
+
+static int put_header(uint8_t *p, uint8_t op, uint8_t count) {
+    put32(p, MANDEL_MAGIC);
+    put16(p + 4, ++seq);
+    p[6] = op;
+    p[7] = count;
+    return MANDEL_HDR_LEN;
+}
+
+//==============================================================================
+// Work Distribution
+//==============================================================================
+
+static void out_remove(board_t *b, int t) {
+    int i;
+
+    for (i = 0; i < b->nout; i++) {
+        if (b->out[i] == t) {
+            memmove(&b->out[i], &b->out[i + 1], (--b->nout - i) * sizeof(int));
+            return;
+        }
+    }
+}
+
+// Back to the front of a board's run, to be sent again
+static void run_push_front(board_t *b, int t) {
+    if (b->head == 0) {
+        memmove(b->run + MAX_DEPTH, b->run, b->tail * sizeof(int));
+        b->head += MAX_DEPTH;
+        b->tail += MAX_DEPTH;
+    }
+    b->run[--b->head] = t;
+}
+
+// Next tile for b: its own run from the front, else the back of the longest
+// other run; -1 when every run is used up
+static int take_tile(board_t *b) {
+    while (b->head < b->tail) {
+        int t = b->run[b->head++];
+        if (!tiles[t].done) {
+            return t;
+        }
+    }
+    for (;;) {
+        board_t *victim = NULL;
+        int i, t;
+
+        for (i = 0; i < active_boards; i++) {
+            board_t *v = &boards[i];
+            if (v != b && v->tail > v->head &&
+                (victim == NULL || v->tail - v->head > victim->tail - victim->head)) {
+                victim = v;
+            }
+        }
+        if (victim == NULL) {
+            return -1;
+        }
+        t = victim->run[--victim->tail];
+        if (!tiles[t].done) {
+            b->taken++;
+            return t;
+        }
+    }
+}
+
+static void send_tiles(board_t *b, const int *list, int n) {
+    uint8_t buf[MAX_PACKET];
+    uint8_t *p = buf + put_header(buf, MANDEL_TILE, n);
+    int i;
+
+    for (i = 0; i < n; i++, p += MANDEL_TILE_LEN) {
+        const tile_t *t = &tiles[list[i]];
+
+        put16(p, list[i]);
+        put16(p + 2, frame);
+        put32(p + 4, fx0 + t->x * fdx);
+        put32(p + 8, fy0 + t->y * fdy);
+        put32(p + 12, fdx);
+        put32(p + 16, fdy);
+        put16(p + 20, t->w);
+        put16(p + 22, t->h);
+        put16(p + 24, max_iter);
+        put16(p + 26, 0);
+    }
+    send_to(b, buf, p - buf);
+
+    memcpy(b->batch, list, n * sizeof(int));
+    b->nbatch = n;
+    b->batch_seq = seq;
+}
+
+// Ask the board with the most tiles queued for half of them for idle b
+static void steal_for(board_t *b) {
+    board_t *victim = NULL;
+    uint8_t buf[MANDEL_HDR_LEN];
+    int i, j;
+
+    for (i = 0; i < active_boards; i++) {
+        board_t *v = &boards[i];
+
+        if (v == b || v->dead || v->nout < 2 || (victim != NULL && v->nout <= victim->nout)) {
+            continue;
+        }
+        for (j = 0; j < active_boards && boards[j].steal_from != i; j++);
+        if (j == active_boards) {
+            victim = v;             // One steal at a time per victim
+        }
+    }
+    if (victim == NULL) {
+        return;
+    }
+
+    put_header(buf, MANDEL_STEAL, victim->nout / 2);
+    send_to(victim, buf, sizeof(buf));
+    b->steal_from = victim - boards;
+    b->steal_seq = seq;
+    b->steal_at = now_ms();
+}
+
+// Keep b's queue at depth; steal when there is nothing left to deal
+static void refill(board_t *b) {
+    int list[MAX_DEPTH];
+    int n = 0, t;
+
+    if (b->dead || b->full || b->steal_from >= 0) {
+        return;
+    }
+    while (b->nout + n < depth && (t = take_tile(b)) >= 0) {
+        list[n++] = t;
+    }
+    if (n > 0) {
+        int i;
+
+        for (i = 0; i < n; i++) {
+            tiles[list[i]].owner = b - boards;
+            b->out[b->nout++] = list[i];
+        }
+        if (b->nout == n) {
+            b->last_rx = now_ms();  // Timeout runs from the first tile
+        }
+        send_tiles(b, list, n);
+    } else if (b->nout == 0) {
+        steal_for(b);
+    }
+}
+
+//==============================================================================
+// Replies
+//==============================================================================
+
+static void handle_result(board_t *b, const uint8_t *p, int len) {
+    int t = get16(p), w = get16(p + 4), h = get16(p + 6);
+    uint32_t us = get32(p + 8), iters = get32(p + 12);
+    tile_t *tile;
+    int i, j;
+
+    b->full = 0;
+    if (get16(p + 2) != frame || t >= num_tiles) {
+        return;
+    }
+    tile = &tiles[t];
+    if (w != tile->w || h != tile->h || len < MANDEL_RESULT_LEN + 2 * w * h) {
+        return;
+    }
+    out_remove(b, t);
+    if (tile->owner >= 0 && &boards[tile->owner] != b) {
+        out_remove(&boards[tile->owner], t);
+    }
+    if (tile->done) {
+        return;
+    }
+
+    p += MANDEL_RESULT_LEN;
+    for (j = 0; j < h; j++) {
+        for (i = 0; i < w; i++, p += 2) {
+            image[(tile->y + j) * width + tile->x + i] = get16(p);
+        }
+    }
+    tile->done = 1;
+    tiles_done++;
+
+    b->tiles++;
+    b->us += us;
+    b->iters += iters;
+}
+
+// Tiles the board did not take (queue full) go back to the front of its run
+static void handle_tile_ack(board_t *b, uint16_t ack_seq, int accepted) {
+    int i;
+
+    if (ack_seq != b->batch_seq || accepted >= b->nbatch) {
+        return;
+    }
+    for (i = b->nbatch - 1; i >= accepted; i--) {
+        int t = b->batch[i];
+
+        out_remove(b, t);
+        tiles[t].owner = -1;
+        if (!tiles[t].done) {
+            run_push_front(b, t);
+        }
+    }
+    b->nbatch = accepted;
+    b->full = 1;
+}
+
+// Stolen tiles move to the board that asked for them
+static void handle_steal_reply(board_t *victim, uint16_t reply_seq, const uint8_t *p, int count) {
+    board_t *thief = NULL;
+    int i;
+
+    for (i = 0; i < active_boards; i++) {
+        if (boards[i].steal_from == victim - boards && boards[i].steal_seq == reply_seq) {
+            thief = &boards[i];
+        }
+    }
+    if (thief == NULL) {
+        return;
+    }
+    thief->steal_from = -1;
+
+    for (i = 0; i < count; i++, p += 4) {
+        int t = get16(p);
+
+        if (get16(p + 2) != frame || t >= num_tiles || tiles[t].done) {
+            continue;
+        }
+        out_remove(victim, t);
+        tiles[t].owner = -1;
+        run_push_front(thief, t);
+        thief->stolen++;
+    }
+    refill(thief);
+}
+
+static void receive(void) {
+    uint8_t buf[MAX_PACKET];
+    struct sockaddr_in from;
+    socklen_t flen = sizeof(from);
+    board_t *b = NULL;
+    int len, i;
+
+    len = recvfrom(sock, buf, sizeof(buf), MSG_DONTWAIT, (struct sockaddr *)&from, &flen);
+    if (len < MANDEL_HDR_LEN || get32(buf) != MANDEL_MAGIC) {
+        return;
+    }
+    for (i = 0; i < active_boards; i++) {
+        if (boards[i].sa.sin_addr.s_addr == from.sin_addr.s_addr) {
+            b = &boards[i];
+        }
+    }
+    if (b == NULL || b->dead) {
+        return;
+    }
+    b->last_rx = now_ms();
+    b->silent = 0;
+
+    switch (buf[6]) {
+        case MANDEL_RESULT | MANDEL_REPLY:
+            if (len >= MANDEL_HDR_LEN + MANDEL_RESULT_LEN) {
+                handle_result(b, buf + MANDEL_HDR_LEN, len - MANDEL_HDR_LEN);
+            }
+            break;
+        case MANDEL_TILE | MANDEL_REPLY:
+            handle_tile_ack(b, get16(buf + 4), buf[7]);
+            break;
+        case MANDEL_STEAL | MANDEL_REPLY:
+            if (len >= MANDEL_HDR_LEN + 4 * buf[7]) {
+                handle_steal_reply(b, get16(buf + 4), buf + MANDEL_HDR_LEN, buf[7]);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+// Silent busy boards get their tiles again, then lose them to the others
+static void check_timeouts(void) {
+    uint64_t t = now_ms();
+    int i, j;
+
+    for (i = 0; i < active_boards; i++) {
+        board_t *b = &boards[i];
+
+        if (b->steal_from >= 0 && t - b->steal_at > (uint64_t)timeout_ms) {
+            b->steal_from = -1;     // Reply lost: the tiles stay where they were
+        }
+        if (b->dead || (b->nout == 0 && !b->full) || t - b->last_rx <= (uint64_t)timeout_ms) {
+            continue;
+        }
+        b->last_rx = t;
+        b->full = 0;
+        if (++b->silent < max_silent) {
+            if (b->nout > 0) {
+                send_tiles(b, b->out, b->nout);
+            }
+            continue;
+        }
+
+        fprintf(stderr, "Board %s not answering, its tiles go to the others\n", b->name);
+        b->dead = 1;
+        for (j = 0; j < b->nout; j++) {
+            tiles[b->out[j]].owner = -1;
+            run_push_front(b, b->out[j]);
+        }
+        b->nout = 0;
+        // Its run is taken from the back by the others
+    }
+}
+
+//==============================================================================
+// Frame
+//==============================================================================
+
+static void frame_init(void) {
+    int tx = (width + tile_w - 1) / tile_w;
+    int ty = (height + tile_h - 1) / tile_h;
+    int i;
+
+    num_tiles = tx * ty;
+    tiles = calloc(num_tiles, sizeof(tile_t));
+    image = calloc((size_t)width * height, sizeof(uint16_t));
+    for (i = 0; i < num_boards; i++) {
+        boards[i].run = calloc(num_tiles + 2 * MAX_DEPTH, sizeof(int));
+        if (boards[i].run == NULL) {
+            image = NULL;
+        }
+    }
+    if (tiles == NULL || image == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    for (i = 0; i < num_tiles; i++) {
+        tiles[i].x = (i % tx) * tile_w;
+        tiles[i].y = (i / tx) * tile_h;
+        tiles[i].w = (width - tiles[i].x < tile_w) ? width - tiles[i].x : tile_w;
+        tiles[i].h = (height - tiles[i].y < tile_h) ? height - tiles[i].y : tile_h;
+    }
+
+    // Steps as mandelbrot_fixed computes them: (max - min) / size in Q16.16
+    fx0 = to_fix16(view[0]);
+    fy0 = to_fix16(view[1]);
+    fdx = (to_fix16(view[2]) - fx0) / width;
+    fdy = (to_fix16(view[3]) - fy0) / height;
+}
+
+// Render the frame on the first n boards; wall time in ms, -1 if all failed
+static double render(int n) {
+    struct timeval t0, t1;
+    int i;
+
+    active_boards = n;
+    frame++;
+    tiles_done = 0;
+    for (i = 0; i < num_tiles; i++) {
+        tiles[i].owner = -1;
+        tiles[i].done = 0;
+    }
+
+    // Contiguous runs: neighbouring tiles cost about the same, so the
+    // imbalance shows up between runs and stealing evens it out
+    for (i = 0; i < n; i++) {
+        board_t *b = &boards[i];
+        int first = (int)((long)num_tiles * i / n);
+        int last = (int)((long)num_tiles * (i + 1) / n);
+
+        b->head = MAX_DEPTH;        // Room to push tiles back in front
+        b->tail = b->head;
+        while (first < last) {
+            b->run[b->tail++] = first++;
+        }
+        b->nout = b->nbatch = 0;
+        b->full = b->silent = b->dead = 0;
+        b->steal_from = -1;
+        b->tiles = b->taken = b->stolen = 0;
+        b->us = b->iters = 0;
+    }
+
+    gettimeofday(&t0, NULL);
+    for (i = 0; i < n; i++) {
+        refill(&boards[i]);
+    }
+
+    while (tiles_done < num_tiles) {
+        struct pollfd pfd = { sock, POLLIN, 0 };
+        int alive = 0;
+
+        if (poll(&pfd, 1, 20) > 0) {
+            receive();
+        }
+        check_timeouts();
+        for (i = 0; i < n; i++) {
+            refill(&boards[i]);
+            alive += !boards[i].dead;
+        }
+        if (alive == 0) {
+            fprintf(stderr, "No board left, %d of %d tiles drawn\n", tiles_done, num_tiles);
+            return -1;
+        }
+    }
+    gettimeofday(&t1, NULL);
+
+    return (t1.tv_sec - t0.tv_sec) * 1000.0 + (t1.tv_usec - t0.tv_usec) / 1000.0;
+}
+
+// Escape time to a colour; points in the set are black
+static int write_ppm(const char *path) {
+    FILE *f = fopen(path, "wb");
+    int i;
+
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+    fprintf(f, "P6\n%d %d\n255\n", width, height);
+    for (i = 0; i < width * height; i++) {
+        uint8_t rgb[3] = { 0, 0, 0 };
+
+        if (image[i] < max_iter) {
+            double s = sqrt((double)image[i] / max_iter);
+            rgb[0] = (uint8_t)(255 * s);
+            rgb[1] = (uint8_t)(255 * s * s);
+            rgb[2] = (uint8_t)(128 + 127 * (1 - s));
+        }
+        fwrite(rgb, 1, 3, f);
+    }
+    fclose(f);
+    return 0;
+}
+
+static void print_boards(int n) {
+    int i;
+
+    for (i = 0; i < n; i++) {
+        const board_t *b = &boards[i];
+
+        printf("  %-16s %4d tiles, %3d taken, %3d stolen, compute %8.1f ms, %6.2fM iter/s%s\n",
+               b->name, b->tiles, b->taken, b->stolen, b->us / 1000.0,
+               b->us ? (double)b->iters / b->us : 0.0, b->dead ? " (gave up)" : "");
+    }
+}
+
+//==============================================================================
+// Main
+//==============================================================================
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [-f boards.txt] [-W width] [-H height] [-x tile_w] [-y tile_h] [-i iter]\n"
+                    "       [-v x0,y0,x1,y1] [-q depth] [-s] [-o out.ppm] [-p port] [-t ms] [-r count]\n"
+                    "       <board_ip>...\n", prog);
+}
+
+int main(int argc, char **argv) {
+    const char *ppm = NULL;
+    double base_ms = 0;
+    int sweep = 0;
+    int opt, i, n;
+
+    while ((opt = getopt(argc, argv, "f:W:H:x:y:i:v:q:so:p:t:r:")) != -1) {
+        switch (opt) {
+            case 'f':
+                if (read_board_file(optarg) < 0) return 1;
+                break;
+            case 'W': width = atoi(optarg); break;
+            case 'H': height = atoi(optarg); break;
+            case 'x': tile_w = atoi(optarg); break;
+            case 'y': tile_h = atoi(optarg); break;
+            case 'i': max_iter = atoi(optarg); break;
+            case 'v':
+                if (sscanf(optarg, "%lf,%lf,%lf,%lf", &view[0], &view[1], &view[2], &view[3]) != 4) {
+                    fprintf(stderr, "Bad view: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'q': depth = atoi(optarg); break;
+            case 's': sweep = 1; break;
+            case 'o': ppm = optarg; break;
+            case 'p': port = atoi(optarg); break;
+            case 't': timeout_ms = atoi(optarg); break;
+            case 'r': max_silent = atoi(optarg); break;
+            default: usage(argv[0]); return 1;
+        }
+    }
+    for (; optind < argc; optind++) {
+        if (add_board(argv[optind]) < 0) {
+            return 1;
+        }
+    }
+    if (num_boards == 0 || width < 1 || height < 1 || tile_w < 1 || tile_h < 1 ||
+        tile_w * tile_h > MANDEL_MAX_PIXELS || max_iter < 1 || max_iter > 65535 ||
+        depth < 1 || depth > MAX_DEPTH || max_silent < 1 ||
+        (width + tile_w - 1) / tile_w * ((height + tile_h - 1) / tile_h) > 65535) {
+        usage(argv[0]);
+        return 1;
+    }
+    for (i = 0; i < num_boards; i++) {
+        boards[i].sa.sin_port = htons(port);
+    }
+
+    sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0) {
+        perror("socket");
+        return 1;
+    }
+    frame = (uint16_t)getpid();     // Not the frame a board has left from a last run
+    frame_init();
+
+    printf("Mandelbrot %dx%d, %d tiles of %dx%d, max_iter %d, view %g,%g..%g,%g, depth %d\n",
+           width, height, num_tiles, tile_w, tile_h, max_iter, view[0], view[1], view[2], view[3], depth);
+    printf("Boards   Wall ms  Speedup  Efficiency  Compute ms  Steals\n");
+
+    for (n = sweep ? 1 : num_boards; n <= num_boards; n++) {
+        double ms = render(n);
+        uint64_t us = 0;
+        int steals = 0;
+
+        if (ms < 0) {
+            return 1;
+        }
+        for (i = 0; i < n; i++) {
+            us += boards[i].us;
+            steals += boards[i].taken + boards[i].stolen;
+        }
+        if (n == 1) {
+            base_ms = ms;
+        }
+        if (base_ms > 0) {
+            printf("%6d  %8.1f  %7.2f  %9.0f%%  %10.1f  %6d\n",
+                   n, ms, base_ms / ms, 100.0 * base_ms / ms / n, us / 1000.0, steals);
+        } else {                    // Speedup needs a 1-board run (-s)
+            printf("%6d  %8.1f  %7s  %10s  %10.1f  %6d\n", n, ms, "-", "-", us / 1000.0, steals);
+        }
+        print_boards(n);
+    }
+
+    if (ppm != NULL && write_ppm(ppm) == 0) {
+        printf("Frame written to %s\n", ppm);
+    }
+    close(sock);
+    return 0;
+}
@@ -0,0 +1,661 @@
+//===============================================================================
+// Memory Service Client - Linux Host Application
+//
+// Reads and writes memory, PMU counters and stats objects on boards running
+// lwIP/port/mem_service.c, many boards at once: one request goes to every
+// board from a single UDP socket, replies are matched as they come in and
+// boards that have not answered are asked again. A batch that does not fit
+// in one reply is carried on in the next request.
+//
+// Usage:
+//   ./memsvc [options] <board_ip>... <command>...
+//
+// Commands (any number, run as one batch per board):
+//   list                    Objects a board offers (id, size, name)
+//   stat <name|id>          Object: cpu and pmu are decoded, others hex words
+//   read <addr> <len>       Bytes, hex dump
+//   read32 <addr> <count>   32-bit words
+//   write32 <addr> <value>  Store a word (needs -k)
+//   write <addr> <hex>      Store bytes, e.g. write 0x2A000 deadbeef (needs -k)
+//
+// Options:
+//   -p <port>      Service port (default: 7780)
+//   -f <file>      Board addresses from a file, one per line (# comments)
+//   -k <key>       Write key (memsvc_init() on the board)
+//   -t <ms>        Reply timeout per try (default: 200)
+//   -r <count>     Tries per board (default: 3)
+//   -i <ms>        Repeat every <ms>; cpu and pmu stats show the change
+//   -n <count>     Repeats with -i (default: until Ctrl-C)
+//   -c             CSV output: time_ms,board,name,value
+//
+// Example:
+//   ./memsvc 192.168.100.2 192.168.100.3 stat cpu stat pmu read32 0x2A000 4
+//   ./memsvc -f rack.txt -i 1000 -c stat cpu > cpu.csv
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <getopt.h>
+
+//==============================================================================
+// Protocol (must match firmware/lwIP/port/mem_service.h)
+//==============================================================================
+
+#define DEFAULT_PORT            7780
+#define MEMSVC_MAGIC            0x3156534Du
+#define MEMSVC_F_REPLY          0x01
+#define MEMSVC_HDR_LEN          12
+#define MEMSVC_OP_LEN           8
+#define MEMSVC_NAME_LEN         12
+#define MEMSVC_MAX_REQ          512
+#define MEMSVC_MAX_REPLY        1024
+
+#define MEMSVC_READ             1
+#define MEMSVC_WRITE            2
+#define MEMSVC_STAT             3
+#define MEMSVC_LIST             4
+
+#define MEMSVC_OK               0
+#define MEMSVC_E_FULL           4
+
+#define MEMSVC_OBJ_CPU          0
+#define MEMSVC_OBJ_PMU          1
+#define MEMSVC_OBJ_LWIP         2
+
+static const char *status_name(uint8_t status) {
+    switch (status) {
+        case 0: return "ok";
+        case 1: return "address not allowed";
+        case 2: return "write not allowed (region or key)";
+        case 3: return "no such object";
+        case 4: return "reply full";
+        case 5: return "bad request";
+        default: return "unknown status";
+    }
+}
+
+// PMU registers (hdl/perf_monitor.v), 0x80000080 + 4 * index
+static const char *const pmu_names[16] = {
+    "ctrl", "cycles", "sram_wait", "mmio_wait", "boot_wait", "fetches", "loads", "stores",
+    "ic_hit", "ic_miss", "dc_hit", "dc_miss", "spad", NULL, NULL, "cpu_info"
+};
+
+#define MAX_BOARDS              256
+#define MAX_OPS                 64
+#define MAX_WRITE               256
+
+//==============================================================================
+// Batch and Board State
+//==============================================================================
+
+typedef struct {
+    uint8_t op, id;
+    uint16_t len;
+    uint32_t addr;
+    uint8_t data[MAX_WRITE];            // WRITE payload
+    int words;                          // read32 / write32: print as words
+    const char *text;                   // Command as given, for messages
+} op_t;
+
+typedef struct {
+    struct sockaddr_in sa;
+    const char *name;
+    int next;                           // First op not answered yet
+    int tries;
+    uint16_t seq;
+    int done, failed;
+    uint32_t prev[2][16];               // Last cpu / pmu values, for -i
+    int have_prev[2];
+} board_t;
+
+static op_t ops[MAX_OPS];
+static int num_ops;
+static board_t boards[MAX_BOARDS];
+static int num_boards;
+
+static int csv_output;
+static int repeat_mode;
+static uint32_t write_key;
+static uint64_t run_start_ms;
+
+//==============================================================================
+// Helpers
+//==============================================================================
+
+static void put16(uint8_t *p, uint16_t v) {
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+}
+
+static void put32(uint8_t *p, uint32_t v) {
+    put16(p, v & 0xFFFF);
+    put16(p + 2, v >> 16);
+}
+
+static uint16_t get16(const uint8_t *p) {
+    return p[0] | (p[1] << 8);
+}
+
+static uint32_t get32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t now_ms(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+static int add_board(const char *name) {
+    board_t *b;
+
+    if (num_boards == MAX_BOARDS) {
+        fprintf(stderr, "Too many boards (max %d)\n", MAX_BOARDS);
+        return -1;
+    }
+    b = &boards[num_boards];
+    memset(b, 0, sizeof(*b));
+    b->sa.sin_family = AF_INET;
+    if (inet_pton(AF_INET, name, &b->sa.sin_addr) != 1) {
+        fprintf(stderr, "Bad board address: %s\n", name);
+        return -1;
+    }
+    b->name = strdup(name);
+    num_boards++;
+    return 0;
+}
+
+static int read_board_file(const char *path) {
+    FILE *f = fopen(path, "r");
+    char line[128];
+
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+    while (fgets(line, sizeof(line), f)) {
+        char *p = line, *end;
+
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p == '#' || *p == '\n' || *p == '\0') continue;
+        for (end = p; *end && *end != '\n' && *end != ' ' && *end != '\t' && *end != '#'; end++);
+        *end = '\0';
+        if (add_board(p) < 0) {
+            fclose(f);
+            return -1;
+        }
+    }
+    fclose(f);
+    return 0;
+}
+
+//==============================================================================
+// Command Line Batch
+//==============================================================================
+
+static int is_command(const char *s) {
+    return !strcmp(s, "list") || !strcmp(s, "stat") || !strcmp(s, "read") ||
+           !strcmp(s, "read32") || !strcmp(s, "write") || !strcmp(s, "write32");
+}
+
+static int parse_number(const char *s, uint32_t *v) {
+    char *end;
+    unsigned long n;
+
+    errno = 0;
+    n = strtoul(s, &end, 0);
+    if (errno || *s == '\0' || *end != '\0' || n > 0xFFFFFFFFul) {
+        fprintf(stderr, "Bad number: %s\n", s);
+        return -1;
+    }
+    *v = (uint32_t)n;
+    return 0;
+}
+
+// Parse one command at argv[0]; returns the words used, -1 on error
+static int parse_command(int argc, char **argv) {
+    op_t *o;
+    uint32_t a, b;
+
+    if (num_ops == MAX_OPS) {
+        fprintf(stderr, "Too many commands (max %d)\n", MAX_OPS);
+        return -1;
+    }
+    o = &ops[num_ops];
+    memset(o, 0, sizeof(*o));
+    o->text = argv[0];
+
+    if (!strcmp(argv[0], "list")) {
+        o->op = MEMSVC_LIST;
+        num_ops++;
+        return 1;
+    }
+    if (argc < 2) {
+        fprintf(stderr, "%s: missing argument\n", argv[0]);
+        return -1;
+    }
+    if (!strcmp(argv[0], "stat")) {
+        o->op = MEMSVC_STAT;
+        if (!strcmp(argv[1], "cpu")) {
+            o->id = MEMSVC_OBJ_CPU;
+        } else if (!strcmp(argv[1], "pmu")) {
+            o->id = MEMSVC_OBJ_PMU;
+        } else if (!strcmp(argv[1], "lwip")) {
+            o->id = MEMSVC_OBJ_LWIP;
+        } else if (parse_number(argv[1], &a) == 0 && a < 256) {
+            o->id = (uint8_t)a;
+        } else {
+            fprintf(stderr, "stat: use cpu, pmu, lwip or an id from list\n");
+            return -1;
+        }
+        num_ops++;
+        return 2;
+    }
+    if (argc < 3) {
+        fprintf(stderr, "%s: missing argument\n", argv[0]);
+        return -1;
+    }
+    if (parse_number(argv[1], &a) < 0) {
+        return -1;
+    }
+    o->addr = a;
+
+    if (!strcmp(argv[0], "read") || !strcmp(argv[0], "read32")) {
+        if (parse_number(argv[2], &b) < 0) {
+            return -1;
+        }
+        o->words = !strcmp(argv[0], "read32");
+        if (o->words) b *= 4;
+        if (b == 0 || b > MEMSVC_MAX_REPLY - MEMSVC_HDR_LEN - MEMSVC_OP_LEN) {
+            fprintf(stderr, "%s: at most %d bytes per read\n", argv[0],
+                    MEMSVC_MAX_REPLY - MEMSVC_HDR_LEN - MEMSVC_OP_LEN);
+            return -1;
+        }
+        o->op = MEMSVC_READ;
+        o->len = (uint16_t)b;
+    } else if (!strcmp(argv[0], "write32")) {
+        if (parse_number(argv[2], &b) < 0) {
+            return -1;
+        }
+        o->op = MEMSVC_WRITE;
+        o->words = 1;
+        o->len = 4;
+        put32(o->data, b);
+    } else {
+        const char *h = argv[2];
+        size_t n = strlen(h);
+
+        if (n == 0 || n % 2 || n / 2 > MAX_WRITE) {
+            fprintf(stderr, "write: give 1 to %d bytes as hex digits\n", MAX_WRITE);
+            return -1;
+        }
+        for (size_t i = 0; i < n / 2; i++) {
+            unsigned int v;
+            if (sscanf(h + 2 * i, "%2x", &v) != 1) {
+                fprintf(stderr, "write: bad hex: %s\n", h);
+                return -1;
+            }
+            o->data[i] = (uint8_t)v;
+        }
+        o->op = MEMSVC_WRITE;
+        o->len = (uint16_t)(n / 2);
+    }
+    num_ops++;
+    return 3;
+}
+
+//==============================================================================
+// Requests and Replies
+//==============================================================================
+
+// Request for ops[first..]: as many as fit; returns the length
+static int build_request(board_t *b, uint8_t *buf) {
+    int pos = MEMSVC_HDR_LEN, count = 0;
+
+    put32(buf, MEMSVC_MAGIC);
+    put16(buf + 4, b->seq);
+    buf[6] = 0;
+    put32(buf + 8, write_key);
+
+    for (int i = b->next; i < num_ops && count < 255; i++) {
+        const op_t *o = &ops[i];
+        int need = MEMSVC_OP_LEN + (o->op == MEMSVC_WRITE ? ((o->len + 3) & ~3) : 0);
+
+        if (pos + need > MEMSVC_MAX_REQ) {
+            break;
+        }
+        buf[pos] = o->op;
+        buf[pos + 1] = o->id;
+        put16(buf + pos + 2, o->len);
+        put32(buf + pos + 4, o->addr);
+        pos += MEMSVC_OP_LEN;
+        if (o->op == MEMSVC_WRITE) {
+            memset(buf + pos, 0, (o->len + 3) & ~3);
+            memcpy(buf + pos, o->data, o->len);
+            pos += (o->len + 3) & ~3;
+        }
+        count++;
+    }
+    buf[7] = (uint8_t)count;
+    return pos;
+}
+
+static void print_value(const board_t *b, const char *name, uint32_t v) {
+    if (csv_output) {
+        printf("%llu,%s,%s,%u\n", (unsigned long long)(now_ms() - run_start_ms), b->name, name, v);
+    } else {
+        printf("%s: %-12s %10u  (0x%08x)\n", b->name, name, v, v);
+    }
+}
+
+static void print_cpu(board_t *b, const uint8_t *d, uint16_t len) {
+    static const char *const names[5] = { "cycles", "instret", "uptime_ms", "requests", "dropped" };
+    uint32_t v[5] = { 0 };
+
+    for (int i = 0; i < 5 && (i + 1) * 4 <= len; i++) {
+        v[i] = get32(d + 4 * i);
+    }
+    if (repeat_mode && b->have_prev[0]) {
+        uint32_t dc = v[0] - b->prev[0][0], di = v[1] - b->prev[0][1];
+        uint32_t dt = v[2] - b->prev[0][2];
+
+        if (csv_output) {
+            print_value(b, "d_cycles", dc);
+            print_value(b, "d_instret", di);
+        } else {
+            printf("%s: %u cycles, %u instructions in %u ms, CPI %.2f\n", b->name, dc, di, dt,
+                   di ? (double)dc / di : 0.0);
+        }
+    } else {
+        for (int i = 0; i < 5; i++) {
+            print_value(b, names[i], v[i]);
+        }
+        if (!csv_output && v[1]) {
+            printf("%s: CPI %.2f (since reset, 32-bit counters)\n", b->name, (double)v[0] / v[1]);
+        }
+    }
+    memcpy(b->prev[0], v, sizeof(v));
+    b->have_prev[0] = 1;
+}
+
+static void print_pmu(board_t *b, const uint8_t *d, uint16_t len) {
+    for (int i = 0; i < 16 && (i + 1) * 4 <= len; i++) {
+        uint32_t v = get32(d + 4 * i);
+
+        if (pmu_names[i] == NULL) {
+            continue;
+        }
+        if (repeat_mode && b->have_prev[1] && i != 0 && i != 15) {
+            print_value(b, pmu_names[i], v - b->prev[1][i]);
+        } else {
+            print_value(b, pmu_names[i], v);
+        }
+        b->prev[1][i] = v;
+    }
+    b->have_prev[1] = 1;
+}
+
+static void print_hex(const board_t *b, uint32_t addr, const uint8_t *d, uint16_t len) {
+    for (uint16_t i = 0; i < len; i += 16) {
+        printf("%s: %08x ", b->name, addr + i);
+        for (uint16_t j = i; j < i + 16 && j < len; j++) {
+            printf(" %02x", d[j]);
+        }
+        printf("\n");
+    }
+}
+
+static void print_result(board_t *b, const op_t *o, uint8_t status, uint16_t len,
+                         uint32_t addr, const uint8_t *d) {
+    char name[32];
+
+    if (status != MEMSVC_OK) {
+        fprintf(stderr, "%s: %s 0x%x: %s\n", b->name, o->text, o->op == MEMSVC_STAT ? o->id : o->addr,
+                status_name(status));
+        return;
+    }
+
+    switch (o->op) {
+    case MEMSVC_LIST:
+        for (uint16_t i = 0; i + 4 + MEMSVC_NAME_LEN <= len; i += 4 + MEMSVC_NAME_LEN) {
+            printf("%s: object %3u  %5u bytes  %.*s\n", b->name, d[i], get16(d + i + 2),
+                   MEMSVC_NAME_LEN, (const char *)d + i + 4);
+        }
+        break;
+    case MEMSVC_STAT:
+        if (o->id == MEMSVC_OBJ_CPU) {
+            print_cpu(b, d, len);
+        } else if (o->id == MEMSVC_OBJ_PMU) {
+            print_pmu(b, d, len);
+        } else {
+            for (uint16_t i = 0; i + 4 <= len; i += 4) {
+                snprintf(name, sizeof(name), "obj%u+%u", o->id, i);
+                print_value(b, name, get32(d + i));
+            }
+        }
+        break;
+    case MEMSVC_READ:
+        if (o->words) {
+            for (uint16_t i = 0; i + 4 <= len; i += 4) {
+                snprintf(name, sizeof(name), "0x%08x", addr + i);
+                print_value(b, name, get32(d + i));
+            }
+        } else {
+            print_hex(b, addr, d, len);
+        }
+        break;
+    case MEMSVC_WRITE:
+        if (!csv_output) {
+            printf("%s: wrote %u bytes at 0x%08x\n", b->name, o->len, o->addr);
+        }
+        break;
+    }
+}
+
+// One reply: print the results, move b->next past the answered ops
+static void handle_reply(board_t *b, const uint8_t *buf, int len) {
+    int pos = MEMSVC_HDR_LEN;
+    int count = buf[7];
+    int i;
+
+    for (i = 0; i < count; i++) {
+        const op_t *o;
+        uint8_t status;
+        uint16_t dlen;
+
+        if (b->next >= num_ops || pos + MEMSVC_OP_LEN > len) {
+            break;
+        }
+        o = &ops[b->next];
+        status = buf[pos + 1];
+        dlen = get16(buf + pos + 2);
+        if (buf[pos] != o->op || pos + MEMSVC_OP_LEN + dlen > len) {
+            fprintf(stderr, "%s: malformed reply\n", b->name);
+            b->failed = b->done = 1;
+            return;
+        }
+        if (status == MEMSVC_E_FULL) {
+            break;                      // Sent again in the next request
+        }
+        print_result(b, o, status, dlen, get32(buf + pos + 4), buf + pos + MEMSVC_OP_LEN);
+        if (status != MEMSVC_OK) {
+            b->failed = 1;
+        }
+        pos += MEMSVC_OP_LEN + ((dlen + 3) & ~3);
+        b->next++;
+    }
+
+    if (i == 0 && b->next < num_ops) {
+        fprintf(stderr, "%s: %s does not fit in a reply\n", b->name, ops[b->next].text);
+        b->failed = 1;
+        b->next++;
+    }
+    b->tries = 0;
+    b->seq++;
+    if (b->next >= num_ops) {
+        b->done = 1;
+    }
+}
+
+// Run the batch on every board; returns the number of boards that failed
+static int run_batch(int fd, int port, int timeout_ms, int max_tries) {
+    uint8_t buf[2048];
+    int pending = num_boards, failed = 0;
+
+    for (int i = 0; i < num_boards; i++) {
+        boards[i].sa.sin_port = htons(port);
+        boards[i].next = 0;
+        boards[i].tries = 0;
+        boards[i].done = boards[i].failed = 0;
+    }
+
+    while (pending) {
+        uint64_t deadline;
+
+        // (Re)send to every board still waiting
+        for (int i = 0; i < num_boards; i++) {
+            board_t *b = &boards[i];
+            int n;
+
+            if (b->done) continue;
+            if (b->tries == max_tries) {
+                fprintf(stderr, "%s: no reply\n", b->name);
+                b->done = b->failed = 1;
+                pending--;
+                continue;
+            }
+            n = build_request(b, buf);
+            sendto(fd, buf, n, 0, (struct sockaddr *)&b->sa, sizeof(b->sa));
+            b->tries++;
+        }
+
+        deadline = now_ms() + timeout_ms;
+        while (pending) {
+            struct pollfd pfd = { fd, POLLIN, 0 };
+            struct sockaddr_in from;
+            socklen_t fromlen = sizeof(from);
+            int64_t left = (int64_t)(deadline - now_ms());
+            int n, resend = 0;
+
+            if (left <= 0 || poll(&pfd, 1, (int)left) <= 0) {
+                break;
+            }
+            n = recvfrom(fd, buf, sizeof(buf), 0, (struct sockaddr *)&from, &fromlen);
+            if (n < MEMSVC_HDR_LEN || get32(buf) != MEMSVC_MAGIC || !(buf[6] & MEMSVC_F_REPLY)) {
+                continue;
+            }
+            for (int i = 0; i < num_boards; i++) {
+                board_t *b = &boards[i];
+
+                if (b->done || b->sa.sin_addr.s_addr != from.sin_addr.s_addr ||
+                    get16(buf + 4) != b->seq) {
+                    continue;           // Stale (a retry's) or unknown
+                }
+                handle_reply(b, buf, n);
+                if (b->done) {
+                    pending--;
+                } else {
+                    resend = 1;         // Rest of the batch
+                }
+                break;
+            }
+            if (resend) {
+                break;
+            }
+        }
+    }
+
+    for (int i = 0; i < num_boards; i++) {
+        failed += boards[i].failed;
+    }
+    return failed;
+}
+
+//==============================================================================
+// Main
+//==============================================================================
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [-p port] [-f boards.txt] [-k key] [-t ms] [-r tries]\n"
+                    "          [-i ms [-n count]] [-c] <board_ip>... <command>...\n"
+                    "Commands: list | stat <cpu|pmu|lwip|id> | read <addr> <len> |\n"
+                    "          read32 <addr> <count> | write <addr> <hex> | write32 <addr> <value>\n",
+            prog);
+}
+
+int main(int argc, char **argv) {
+    int port = DEFAULT_PORT, timeout_ms = 200, tries = 3;
+    int interval_ms = 0, count = 0;
+    int opt, fd, failed = 0, i;
+    uint32_t v;
+
+    while ((opt = getopt(argc, argv, "p:f:k:t:r:i:n:ch")) != -1) {
+        switch (opt) {
+            case 'p': port = atoi(optarg); break;
+            case 'f': if (read_board_file(optarg) < 0) return 1; break;
+            case 'k':
+                if (parse_number(optarg, &v) < 0) return 1;
+                write_key = v;
+                break;
+            case 't': timeout_ms = atoi(optarg); break;
+            case 'r': tries = atoi(optarg); break;
+            case 'i': interval_ms = atoi(optarg); break;
+            case 'n': count = atoi(optarg); break;
+            case 'c': csv_output = 1; break;
+            default: usage(argv[0]); return 1;
+        }
+    }
+
+    for (i = optind; i < argc && !is_command(argv[i]); i++) {
+        if (add_board(argv[i]) < 0) return 1;
+    }
+    while (i < argc) {
+        int used = parse_command(argc - i, argv + i);
+        if (used < 0) return 1;
+        i += used;
+    }
+    if (num_boards == 0 || num_ops == 0 || timeout_ms <= 0 || tries <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        perror("socket");
+        return 1;
+    }
+
+    repeat_mode = interval_ms > 0;
+    run_start_ms = now_ms();
+    if (csv_output) {
+        printf("time_ms,board,name,value\n");
+    }
+
+    for (int run = 0; ; run++) {
+        uint64_t start = now_ms();
+
+        failed = run_batch(fd, port, timeout_ms, tries);
+        fflush(stdout);
+        if (!repeat_mode || (count && run + 1 >= count)) {
+            break;
+        }
+        while (now_ms() - start < (uint64_t)interval_ms) {
+            usleep(1000 * (interval_ms - (now_ms() - start) > 50 ? 50 : 1));
+        }
+    }
+
+    close(fd);
+    return failed ? 2 : 0;
+}
@@ -1,9 +1,20 @@
 /*
  * fast-xfr.c   FAST streaming file transfer for minicom
  *
- *              Built-in FAST streaming protocol implementation.
- *              NO chunking, NO per-chunk ACKs, continuous streaming.
- *              SILENT MODE: NO debug output, ONLY serial port communication.
+ *              Built-in upload protocols of the PicoRV32 targets, the
+ *              same ones tools/uploader/fw_upload_fast speaks:
+ *
+ *              - Compressed FAST ('Z', lib/lz4_stream.h on the target)
+ *              - Block protocol (lib/block_upload/block_upload.h):
+ *                windowed, per-block CRC, resumable
+ *              - FAST stream ('R'): NO chunking, NO per-chunk ACKs
+ *
+ *              Downloads pull a memory range with the block protocol
+ *              (lib/block_upload/block_download.c on the target).
+ *
+ *              SILENT MODE: NO console output, ONLY serial port
+ *              communication. A protocol trace is written only when
+ *              the protocol's program field asks for one.
  *
  * Copyright (c) 2025 Michael Wolak
  *
@@ -14,11 +25,13 @@
 
 #include <config.h>
 #include <errno.h>
+#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <unistd.h>
+#include <sys/select.h>
 #include <sys/time.h>
 #include <sys/types.h>
 #include <termios.h>
@@ -27,6 +40,7 @@
 #include "port.h"
 #include "minicom.h"
 #include "intl.h"
+#include "../../../lib/block_upload/block_upload.h"
 
 /*
  * FAST Protocol Steps:
@@ -34,419 +48,1156 @@
  * 2. Wait for 'A' (Ready acknowledgment)
  * 3. Send size (4 bytes, little-endian)
  * 4. Wait for 'B' (Size acknowledged)
- * 5. Send CRC32 (4 bytes, little-endian)
- * 6. Stream ALL data continuously (NO chunking, NO ACKs)
+ * 5. Stream ALL data continuously (NO chunking, NO ACKs)
+ * 6. Send 'C' + CRC32 (4 bytes, little-endian)
  * 7. Wait for 'C' (Data received acknowledgment)
  * 8. Receive CRC32 from FPGA (4 bytes, little-endian)
  * 9. Compare CRCs
  *
- * IMPORTANT: This function writes ONLY to the serial port (fd).
+ * Compressed FAST is the same with 'Z' for 'R', the LZ4 block size and
+ * the image size for the size, and the LZ4 block for the data.
+ *
+ * Block protocol sessions are keyed by image size and CRC32: a transfer
+ * that was interrupted (cable, Ctrl-C, timeout) and is started again with
+ * the same file skips the blocks the target already holds.
+ *
+ * Options, from the protocol's "Program" field (Ctrl-A O, File transfer
+ * protocols):
+ *   -z          LZ4-compress the image (a .bin.lz4 is always sent as is)
+ *   -s          FAST stream only, no block protocol probe
+ *   -l <file>   Append a protocol trace to <file>
+ *
+ * IMPORTANT: Transfers write ONLY to the serial port (fd).
  * NO debug output to stderr/stdout - completely silent operation.
  */
 
 #define TIMEOUT_MS 4000  /* 4 seconds - prevent app hang on errors */
+#define MAX_IMAGE_SIZE 524288
+#define PROBE_MS 300     /* Answer to 'Z' or the block probe, else fall back */
+#define BLOCK_STALL_MS 2000
+#define BLOCK_RESYNCS 3
+
+#define LZ4B_MAGIC 0x42345A4C  /* "LZ4B": .bin.lz4 from tools/lz4boot */
+
+/* Protocol trace (-l); NULL keeps every transfer free of file I/O */
+static FILE *trace;
+
+static void dbg(const char *fmt, ...)
+{
+    va_list ap;
+
+    if (!trace)
+        return;
+    va_start(ap, fmt);
+    vfprintf(trace, fmt, ap);
+    va_end(ap);
+}
+
+/* CRC32 (0xEDB88320 polynomial) */
+static uint32_t crc32_table[256];
 
-/* CRC32 calculation (0xEDB88320 polynomial) */
 static uint32_t calculate_crc32(const uint8_t *data, size_t length)
 {
     uint32_t crc = 0xFFFFFFFF;
-    for (size_t i = 0; i < length; i++) {
-        crc ^= data[i];
-        for (int j = 0; j < 8; j++) {
-            if (crc & 1)
-                crc = (crc >> 1) ^ 0xEDB88320;
-            else
-                crc >>= 1;
+
+    if (!crc32_table[1]) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int j = 0; j < 8; j++)
+                c = (c & 1) ? (c >> 1) ^ 0xEDB88320 : c >> 1;
+            crc32_table[i] = c;
         }
     }
+    for (size_t i = 0; i < length; i++)
+        crc = (crc >> 8) ^ crc32_table[(crc ^ data[i]) & 0xFF];
     return ~crc;
 }
 
-/* Wait for a character with timeout */
-static int wait_for_char(int fd, char expected, int timeout_ms)
+static long now_ms(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000L + tv.tv_usec / 1000;
+}
+
+static uint32_t get_le32(const uint8_t *p)
 {
-    struct timeval start, now;
-    unsigned char c;
-    int n;
-    FILE *debug = fopen("/tmp/minicom-fast-debug.log", "a");
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
 
-    gettimeofday(&start, NULL);
+static void put_le32(uint8_t *p, uint32_t v)
+{
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+    p[2] = (v >> 16) & 0xFF;
+    p[3] = v >> 24;
+}
+
+/* Read one byte, waiting up to timeout_ms; returns as soon as it arrives */
+static int read_byte(int fd, uint8_t *c, int timeout_ms)
+{
+    long deadline = now_ms() + timeout_ms;
 
     while (1) {
-        n = read(fd, &c, 1);
-        if (n == 1) {
-            if (debug) {
-                fprintf(debug, "  Received char: 0x%02X ('%c') expecting 0x%02X ('%c')\n",
-                        c, (c >= 32 && c < 127) ? c : '.', expected, expected);
-                fflush(debug);
-            }
-            if (c == expected) {
-                if (debug) fclose(debug);
-                return 0;  /* Success */
-            }
-        }
+        if (read(fd, c, 1) == 1)
+            return 0;
 
-        /* Check timeout */
-        gettimeofday(&now, NULL);
-        long elapsed_ms = (now.tv_sec - start.tv_sec) * 1000 +
-                         (now.tv_usec - start.tv_usec) / 1000;
-        if (elapsed_ms > timeout_ms) {
-            if (debug) {
-                fprintf(debug, "  Timeout after %ld ms\n", elapsed_ms);
-                fclose(debug);
-            }
+        long left = deadline - now_ms();
+        if (left <= 0)
             return -1;  /* Timeout */
-        }
 
-        usleep(1000);  /* Wait 1ms before retry */
+        fd_set rfds;
+        struct timeval tv = { left / 1000, (left % 1000) * 1000 };
+        FD_ZERO(&rfds);
+        FD_SET(fd, &rfds);
+        select(fd + 1, &rfds, NULL, NULL, &tv);
     }
 }
 
-/* Send 4 bytes as little-endian */
-static int send_uint32_le(int fd, uint32_t value)
+/* Wait for a character with timeout; other bytes are skipped */
+static int wait_for_char(int fd, char expected, int timeout_ms)
 {
-    uint8_t buf[4];
-    buf[0] = value & 0xFF;
-    buf[1] = (value >> 8) & 0xFF;
-    buf[2] = (value >> 16) & 0xFF;
-    buf[3] = (value >> 24) & 0xFF;
-
-    ssize_t written = write(fd, buf, 4);
-    if (written != 4)
-        return -1;
-    return 0;
+    long deadline = now_ms() + timeout_ms;
+    uint8_t c;
+
+    do {
+        if (read_byte(fd, &c, deadline - now_ms()) != 0)
+            break;
+        dbg("  Received char: 0x%02X ('%c') expecting 0x%02X ('%c')\n",
+            c, (c >= 32 && c < 127) ? c : '.', expected, expected);
+        if (c == (uint8_t)expected)
+            return 0;  /* Success */
+    } while (now_ms() < deadline);
+
+    dbg("  Timeout waiting for '%c'\n", expected);
+    return -1;  /* Timeout */
 }
 
 /* Read 4 bytes as little-endian with timeout */
 static int read_uint32_le(int fd, uint32_t *value, int timeout_ms)
 {
     uint8_t buf[4];
-    size_t total = 0;
-    struct timeval start, now;
-
-    gettimeofday(&start, NULL);
-
-    while (total < 4) {
-        int n = read(fd, buf + total, 4 - total);
-        if (n > 0)
-            total += n;
-        else
-            usleep(1000);
-
-        /* Check timeout */
-        gettimeofday(&now, NULL);
-        long elapsed_ms = (now.tv_sec - start.tv_sec) * 1000 +
-                         (now.tv_usec - start.tv_usec) / 1000;
-        if (elapsed_ms > timeout_ms) {
+
+    for (int i = 0; i < 4; i++) {
+        if (read_byte(fd, &buf[i], timeout_ms) != 0)
             return -1;  /* Timeout */
+    }
+    *value = get_le32(buf);
+    return 0;  /* Success */
+}
+
+/* Write everything; stops at an error or TIMEOUT_MS without progress */
+static int write_all(int fd, const uint8_t *buf, size_t len)
+{
+    long last = now_ms();
+
+    while (len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if (n > 0) {
+            buf += n;
+            len -= n;
+            last = now_ms();
+        } else if (n < 0 && errno != EAGAIN && errno != EINTR) {
+            return -1;
+        } else if (now_ms() - last > TIMEOUT_MS) {
+            return -1;
         }
     }
+    return 0;
+}
 
-    *value = buf[0] | (buf[1] << 8) | (buf[2] << 16) | (buf[3] << 24);
-    return 0;  /* Success */
+/* Line rate of the port, for the block protocol retry time */
+static int port_baud(int fd)
+{
+    struct termios tio;
+
+    if (tcgetattr(fd, &tio) != 0)
+        return 115200;
+    switch (cfgetospeed(&tio)) {
+        case B230400:  return 230400;
+        case B460800:  return 460800;
+        case B921600:  return 921600;
+#ifdef B1000000
+        case B1000000: return 1000000;
+#endif
+#ifdef B1500000
+        case B1500000: return 1500000;
+#endif
+#ifdef B2000000
+        case B2000000: return 2000000;
+#endif
+#ifdef B3000000
+        case B3000000: return 3000000;
+#endif
+#ifdef B4000000
+        case B4000000: return 4000000;
+#endif
+        default:       return 115200;
+    }
 }
 
 /*
- * FAST upload implementation
- * fd: serial port file descriptor (already configured by minicom)
- * filename: file to upload
- *
- * SILENT MODE: Writes ONLY to serial port, NO console output
+ * LZ4 (same block format and compressor as tools/lz4boot)
  */
-int fast_upload(int fd, const char *filename)
-{
-    FILE *fp;
-    uint8_t *data = NULL;
-    size_t file_size;
-    uint32_t crc32;
-    uint32_t fpga_crc32;
-    int ret = -1;
-    struct termios oldtio, newtio;
-    int port_configured = 0;
-    FILE *debug = fopen("/tmp/minicom-fast-debug.log", "a");
 
-    if (debug) {
-        fprintf(debug, "fast_upload() called with fd=%d, filename='%s'\n", fd, filename ? filename : "(null)");
-        fflush(debug);
-    }
+#define LZ4_MIN_MATCH     4
+#define LZ4_LAST_LITERALS 5   /* Block always ends with 5+ literals */
+#define LZ4_MF_LIMIT      12  /* Last match starts 12+ bytes before the end */
+#define LZ4_MAX_OFFSET    65535
+#define LZ4_HASH_BITS     16
+#define LZ4_CHAIN_DEPTH   256
 
-    /* Save current port settings and configure for raw mode */
-    tcgetattr(fd, &oldtio);
-    port_configured = 1;
-    newtio = oldtio;
+static int32_t *lz4_head;
+static int32_t *lz4_prev;
 
-    /* Raw mode - no processing */
-    newtio.c_lflag &= ~(ICANON | ECHO | ECHOE | ISIG);
-    newtio.c_iflag &= ~(IXON | IXOFF | IXANY | ICRNL | INLCR);
-    newtio.c_oflag &= ~OPOST;
+static uint32_t lz4_hash4(const uint8_t *p)
+{
+    return (get_le32(p) * 2654435761u) >> (32 - LZ4_HASH_BITS);
+}
 
-    /* Read settings - return immediately */
-    newtio.c_cc[VMIN] = 0;
-    newtio.c_cc[VTIME] = 0;
+static void lz4_insert(const uint8_t *src, size_t pos)
+{
+    uint32_t h = lz4_hash4(src + pos);
 
-    tcsetattr(fd, TCSANOW, &newtio);
+    lz4_prev[pos] = lz4_head[h];
+    lz4_head[h] = (int32_t)pos;
+}
 
-    if (debug) {
-        fprintf(debug, "Serial port configured for raw mode\n");
-        fflush(debug);
+/* Longest match for pos (ending by limit); 0 if shorter than LZ4_MIN_MATCH */
+static size_t lz4_find_match(const uint8_t *src, size_t pos, size_t limit, size_t *offset)
+{
+    size_t best = 0;
+    int32_t cand = lz4_head[lz4_hash4(src + pos)];
+
+    for (int depth = 0; cand >= 0 && depth < LZ4_CHAIN_DEPTH; depth++) {
+        if (pos - (size_t)cand > LZ4_MAX_OFFSET)
+            break;
+        size_t len = 0;
+        while (pos + len < limit && src[cand + len] == src[pos + len])
+            len++;
+        if (len > best) {
+            best = len;
+            *offset = pos - (size_t)cand;
+        }
+        cand = lz4_prev[cand];
     }
+    return best >= LZ4_MIN_MATCH ? best : 0;
+}
 
-    /* Open file */
-    fp = fopen(filename, "rb");
-    if (!fp) {
-        if (debug) {
-            fprintf(debug, "ERROR: fopen failed for '%s': %s\n", filename, strerror(errno));
-            fclose(debug);
-        }
-        return -1;
+static uint8_t *lz4_put_length(uint8_t *op, size_t n)
+{
+    while (n >= 255) {
+        *op++ = 255;
+        n -= 255;
     }
+    *op++ = (uint8_t)n;
+    return op;
+}
 
-    if (debug) {
-        fprintf(debug, "File opened successfully\n");
-        fflush(debug);
+static uint8_t *lz4_put_sequence(uint8_t *op, const uint8_t *lit, size_t lit_len,
+                                 size_t offset, size_t match_len)
+{
+    uint8_t *token = op++;
+    size_t ml = match_len ? match_len - LZ4_MIN_MATCH : 0;
+
+    *token = (uint8_t)(((lit_len < 15 ? lit_len : 15) << 4) | (ml < 15 ? ml : 15));
+    if (lit_len >= 15)
+        op = lz4_put_length(op, lit_len - 15);
+    memcpy(op, lit, lit_len);
+    op += lit_len;
+
+    if (match_len) {
+        *op++ = offset & 0xFF;
+        *op++ = offset >> 8;
+        if (ml >= 15)
+            op = lz4_put_length(op, ml - 15);
     }
+    return op;
+}
 
-    /* Get file size */
-    fseek(fp, 0, SEEK_END);
-    file_size = ftell(fp);
-    fseek(fp, 0, SEEK_SET);
+/* Compress n bytes into a new block; returns its size, 0 if out of memory */
+static size_t lz4_compress(const uint8_t *src, size_t n, uint8_t **block)
+{
+    uint8_t *dst = malloc(n + n / 255 + 16);
+    uint8_t *op = dst;
+    size_t anchor = 0, pos = 0;
+
+    lz4_head = malloc(sizeof(int32_t) << LZ4_HASH_BITS);
+    lz4_prev = malloc(sizeof(int32_t) * n);
+    if (!dst || !lz4_head || !lz4_prev) {
+        free(dst);
+        free(lz4_head);
+        free(lz4_prev);
+        return 0;
+    }
+    memset(lz4_head, 0xFF, sizeof(int32_t) << LZ4_HASH_BITS);
+
+    if (n > LZ4_MF_LIMIT) {
+        size_t mf_limit = n - LZ4_MF_LIMIT;
+        size_t match_limit = n - LZ4_LAST_LITERALS;
+
+        while (pos < mf_limit) {
+            size_t offset = 0;
+            size_t len = lz4_find_match(src, pos, match_limit, &offset);
+
+            /* One step lazy: take a literal if the next byte matches longer */
+            lz4_insert(src, pos);
+            if (len && pos + 1 < mf_limit) {
+                size_t next_offset = 0;
+                size_t next = lz4_find_match(src, pos + 1, match_limit, &next_offset);
+                if (next > len + 1) {
+                    pos++;
+                    len = next;
+                    offset = next_offset;
+                }
+            }
+            if (!len) {
+                pos++;
+                continue;
+            }
 
-    if (debug) {
-        fprintf(debug, "File size: %zu bytes\n", file_size);
-        fflush(debug);
+            op = lz4_put_sequence(op, src + anchor, pos - anchor, offset, len);
+            for (size_t i = pos + 1; i < pos + len && i + LZ4_MIN_MATCH <= n; i++)
+                lz4_insert(src, i);
+            pos += len;
+            anchor = pos;
+        }
     }
 
-    if (file_size == 0 || file_size > 524288) {
-        if (debug) {
-            fprintf(debug, "ERROR: Invalid file size %zu (must be 1-524288)\n", file_size);
-            fclose(debug);
+    /* Last sequence: literals only */
+    op = lz4_put_sequence(op, src + anchor, n - anchor, 0, 0);
+    free(lz4_head);
+    free(lz4_prev);
+    *block = dst;
+    return op - dst;
+}
+
+/* Decode a block to exactly length bytes; 0 if it is well formed */
+static int lz4_decode(const uint8_t *ip, size_t in_len, uint8_t *dst, size_t length)
+{
+    const uint8_t *in_end = ip + in_len;
+    uint8_t *out = dst;
+    uint8_t *end = dst + length;
+
+    while (ip < in_end) {
+        uint8_t token = *ip++;
+        size_t n = token >> 4;
+        if (n == 15) {
+            uint8_t b;
+            do {
+                if (ip >= in_end)
+                    return -1;
+                b = *ip++;
+                n += b;
+            } while (b == 255);
+        }
+        if (n > (size_t)(end - out) || n > (size_t)(in_end - ip))
+            return -1;
+        memcpy(out, ip, n);
+        out += n;
+        ip += n;
+
+        if (out == end)
+            return ip == in_end ? 0 : -1;
+
+        if (in_end - ip < 2)
+            return -1;
+        size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (size_t)(out - dst))
+            return -1;
+
+        n = token & 15;
+        if (n == 15) {
+            uint8_t b;
+            do {
+                if (ip >= in_end)
+                    return -1;
+                b = *ip++;
+                n += b;
+            } while (b == 255);
         }
-        goto cleanup;
+        n += LZ4_MIN_MATCH;
+        if (n > (size_t)(end - out))
+            return -1;
+        for (size_t i = 0; i < n; i++, out++)
+            *out = out[-(long)offset];
     }
+    return -1;
+}
 
-    /* Read entire file */
-    data = malloc(file_size);
-    if (!data)
-        goto cleanup;
+/*
+ * Compressed FAST transfer
+ * Returns 0 on success, -1 on failure, 1 if the target does not answer 'Z'
+ */
+static int upload_compressed(int fd, const uint8_t *data, size_t size,
+                             const uint8_t *block, size_t block_size)
+{
+    uint32_t crc32 = calculate_crc32(data, size);
+    uint32_t fpga_crc32;
+    uint8_t sizes[8];
+    uint8_t crc_packet[5] = { 'C' };
 
-    if (fread(data, 1, file_size, fp) != file_size)
-        goto cleanup;
+    dbg("Compressed: %zu bytes as %zu, CRC32 0x%08X\n", size, block_size, crc32);
+    if (write(fd, "Z", 1) != 1)
+        return -1;
+    if (wait_for_char(fd, 'A', PROBE_MS) != 0)
+        return 1;
 
-    /* Calculate CRC32 */
-    crc32 = calculate_crc32(data, file_size);
+    put_le32(sizes, (uint32_t)block_size);
+    put_le32(sizes + 4, (uint32_t)size);
+    if (write_all(fd, sizes, sizeof(sizes)) != 0 ||
+        wait_for_char(fd, 'B', TIMEOUT_MS) != 0)
+        return -1;
 
-    if (debug) {
-        fprintf(debug, "CRC32 calculated: 0x%08X\n", crc32);
-        fprintf(debug, "Starting protocol handshake...\n");
-        fflush(debug);
-    }
+    /* One write: the tty layer keeps the USB transfers full */
+    put_le32(crc_packet + 1, crc32);
+    if (write_all(fd, block, block_size) != 0 ||
+        write_all(fd, crc_packet, sizeof(crc_packet)) != 0)
+        return -1;
+    tcdrain(fd);
 
-    /* Step 1: Send 'R' to signal transfer is starting */
-    if (debug) {
-        fprintf(debug, "Step 1: Sending 'R' to fd=%d\n", fd);
-        fflush(debug);
-    }
+    if (wait_for_char(fd, 'C', TIMEOUT_MS) != 0 ||
+        read_uint32_le(fd, &fpga_crc32, TIMEOUT_MS) != 0)
+        return -1;
 
-    ssize_t written = write(fd, "R", 1);
-    if (debug) {
-        fprintf(debug, "write() returned %zd\n", written);
-        fflush(debug);
+    dbg("Received FPGA CRC32: 0x%08X\n", fpga_crc32);
+    return fpga_crc32 == crc32 ? 0 : -1;
+}
+
+/*
+ * Block protocol transfer
+ */
+
+enum { BLK_PENDING, BLK_IN_FLIGHT, BLK_ACKED };
+
+static int block_send_packet(int fd, uint8_t type, uint16_t arg,
+                             const uint8_t *payload, uint16_t len)
+{
+    uint8_t packet[BLOCK_UPLOAD_HEADER_SIZE + BLOCK_UPLOAD_BLOCK_SIZE + 4] = {
+        type, arg & 0xFF, arg >> 8, len & 0xFF, len >> 8,
+        block_upload_check(type, arg, len)
+    };
+
+    if (len)
+        memcpy(packet + BLOCK_UPLOAD_HEADER_SIZE, payload, len);
+    put_le32(packet + BLOCK_UPLOAD_HEADER_SIZE + len, len ? calculate_crc32(payload, len) : 0);
+    return write_all(fd, packet, BLOCK_UPLOAD_HEADER_SIZE + len + 4);
+}
+
+/*
+ * Next complete reply into rsp (type + up to 4 bytes), within timeout_ms.
+ * Bytes that start no known reply (shell echo, noise) are skipped.
+ */
+static int block_read_reply(int fd, uint8_t *rsp, int timeout_ms)
+{
+    static uint8_t buf[5];
+    static int have = 0;
+    long deadline = now_ms() + timeout_ms;
+
+    while (1) {
+        int need = 1;
+        if (have) {
+            switch (buf[0]) {
+                case BLOCK_RSP_ACK:
+                case BLOCK_RSP_NAK:    need = 3; break;
+                case BLOCK_RSP_INFO:
+                case BLOCK_RSP_RESUME:
+                case BLOCK_RSP_REJECT:
+                case BLOCK_RSP_DONE:   need = 5; break;
+                default:               have = 0; continue;
+            }
+            if (have == need) {
+                memcpy(rsp, buf, need);
+                have = 0;
+                return 0;
+            }
+        }
+        if (read_byte(fd, buf + have, deadline - now_ms()) != 0)
+            return -1;
+        have++;
     }
+}
 
-    if (written != 1) {
-        if (debug) {
-            fprintf(debug, "ERROR: write('R') failed\n");
-            fclose(debug);
+/* Start (or resync) the session; returns the resume offset, or -1 */
+static long block_session(int fd, size_t size, uint32_t crc32)
+{
+    uint8_t payload[8];
+    uint8_t rsp[5];
+
+    put_le32(payload, (uint32_t)size);
+    put_le32(payload + 4, crc32);
+
+    for (int attempt = 0; attempt < 3; attempt++) {
+        long start = now_ms();
+        block_send_packet(fd, BLOCK_PKT_SESSION, 0, payload, sizeof(payload));
+
+        /* Skip ACKs still on their way from before a resync */
+        while (now_ms() - start < 1000) {
+            if (block_read_reply(fd, rsp, 1000) != 0)
+                break;
+            if (rsp[0] == BLOCK_RSP_RESUME)
+                return get_le32(rsp + 1);
+            if (rsp[0] == BLOCK_RSP_REJECT) {
+                dbg("Target accepts at most %u bytes\n", get_le32(rsp + 1));
+                return -1;
+            }
         }
-        goto cleanup;
     }
+    dbg("No answer to the session packet\n");
+    return -1;
+}
 
-    /* Step 2: Wait for 'A' (Ready acknowledgment) */
-    if (debug) {
-        fprintf(debug, "Step 2: Waiting for 'A'...\n");
-        fflush(debug);
+/*
+ * Returns 0 on success, -1 on failure, 1 if the target does not know the
+ * block protocol (nothing was sent that it would act on)
+ */
+static int upload_blocks(int fd, const uint8_t *data, size_t size)
+{
+    uint32_t nblocks = (size + BLOCK_UPLOAD_BLOCK_SIZE - 1) / BLOCK_UPLOAD_BLOCK_SIZE;
+    uint8_t *state = calloc(nblocks, 1);
+    uint32_t *seq = calloc(nblocks, sizeof(uint32_t));
+    long *sent_at = calloc(nblocks, sizeof(long));
+    uint32_t next_seq = 0, acked = 0, in_flight = 0, cursor = 0;
+    uint32_t window = BLOCK_UPLOAD_WINDOW;
+    uint32_t crc32 = calculate_crc32(data, size);
+    int resyncs = 0, result = -1, finish_sent;
+    long finish_at = 0, last_ack, resume;
+    uint8_t rsp[5];
+
+    /* One window on the wire, plus USB latency, before a block counts as lost */
+    long retry_ms = 100 + 2000L * BLOCK_UPLOAD_WINDOW *
+                    (BLOCK_UPLOAD_BLOCK_SIZE + 10) * 10 / port_baud(fd);
+
+    if (!state || !seq || !sent_at)
+        goto out;
+
+    block_send_packet(fd, BLOCK_PKT_PROBE, BLOCK_UPLOAD_VERSION, NULL, 0);
+    if (block_read_reply(fd, rsp, PROBE_MS) != 0 || rsp[0] != BLOCK_RSP_INFO ||
+        (rsp[2] | (rsp[3] << 8)) != BLOCK_UPLOAD_BLOCK_SIZE) {
+        result = 1;
+        goto out;
+    }
+    if (rsp[4] && rsp[4] < window)
+        window = rsp[4];
+    dbg("Block protocol: %u x %d bytes, window %u, CRC32 0x%08X\n",
+        nblocks, BLOCK_UPLOAD_BLOCK_SIZE, window, crc32);
+
+resync:
+    if ((resume = block_session(fd, size, crc32)) < 0)
+        goto out;
+    in_flight = 0;
+    cursor = 0;
+    acked = 0;
+    for (uint32_t i = 0; i < nblocks; i++) {
+        state[i] = ((long)i * BLOCK_UPLOAD_BLOCK_SIZE < resume) ? BLK_ACKED : BLK_PENDING;
+        if (state[i] == BLK_ACKED)
+            acked++;
     }
+    if (resume > 0)
+        dbg("Resuming at offset %ld (%u blocks already on the target)\n", resume, acked);
+    finish_sent = 0;
+    last_ack = now_ms();
 
-    int wait_result = wait_for_char(fd, 'A', TIMEOUT_MS);
+    while (1) {
+        long now = now_ms();
+
+        /* Keep the window full, lowest pending block first */
+        while (in_flight < window && !finish_sent) {
+            while (cursor < nblocks && state[cursor] != BLK_PENDING)
+                cursor++;
+            if (cursor == nblocks)
+                break;
+
+            uint32_t len = size - (size_t)cursor * BLOCK_UPLOAD_BLOCK_SIZE;
+            if (len > BLOCK_UPLOAD_BLOCK_SIZE)
+                len = BLOCK_UPLOAD_BLOCK_SIZE;
+            if (block_send_packet(fd, BLOCK_PKT_DATA, cursor,
+                                  data + (size_t)cursor * BLOCK_UPLOAD_BLOCK_SIZE, len) != 0)
+                goto out;
+            state[cursor] = BLK_IN_FLIGHT;
+            seq[cursor] = next_seq++;
+            sent_at[cursor] = now;
+            in_flight++;
+        }
 
-    if (debug) {
-        fprintf(debug, "wait_for_char returned: %d (0=success, -1=timeout)\n", wait_result);
-        fflush(debug);
-    }
+        if (acked == nblocks && (!finish_sent || now - finish_at > 1000)) {
+            block_send_packet(fd, BLOCK_PKT_FINISH, 0, NULL, 0);
+            finish_sent = 1;
+            finish_at = now;
+        }
+
+        if (block_read_reply(fd, rsp, 5) == 0) {
+            uint32_t idx = rsp[1] | (rsp[2] << 8);
+
+            if (rsp[0] == BLOCK_RSP_DONE) {
+                dbg("Received FPGA CRC32: 0x%08X\n", get_le32(rsp + 1));
+                result = get_le32(rsp + 1) == crc32 ? 0 : -1;
+                goto out;
+            }
 
-    if (wait_result != 0) {
-        if (debug) {
-            fprintf(debug, "ERROR: Timeout waiting for 'A'\n");
-            fclose(debug);
+            if ((rsp[0] == BLOCK_RSP_ACK || rsp[0] == BLOCK_RSP_NAK) && idx < nblocks) {
+                /*
+                 * Replies come in send order: anything sent before this
+                 * block and still unanswered never arrived whole
+                 */
+                if (state[idx] == BLK_IN_FLIGHT) {
+                    for (uint32_t i = 0; i < nblocks; i++) {
+                        if (state[i] == BLK_IN_FLIGHT && seq[i] < seq[idx]) {
+                            state[i] = BLK_PENDING;
+                            in_flight--;
+                            if (i < cursor)
+                                cursor = i;
+                        }
+                    }
+                }
+
+                if (rsp[0] == BLOCK_RSP_ACK) {
+                    if (state[idx] == BLK_IN_FLIGHT)
+                        in_flight--;
+                    if (state[idx] != BLK_ACKED)
+                        acked++;
+                    state[idx] = BLK_ACKED;
+                    last_ack = now;
+                } else {
+                    /* Bad CRC, or the finish found this block missing */
+                    dbg("NAK block %u\n", idx);
+                    if (state[idx] == BLK_IN_FLIGHT)
+                        in_flight--;
+                    if (state[idx] == BLK_ACKED)
+                        acked--;
+                    state[idx] = BLK_PENDING;
+                    if (idx < cursor)
+                        cursor = idx;
+                    finish_sent = 0;
+                }
+            }
+            continue;
         }
-        goto cleanup;
-    }
 
-    /* Step 3: Send size (4 bytes little-endian) */
-    if (debug) {
-        fprintf(debug, "Step 3: Sending size %zu (0x%08zX)\n", file_size, file_size);
-        fflush(debug);
-    }
+        /* Silent losses: no reply at all within the retry time */
+        for (uint32_t i = 0; i < nblocks; i++) {
+            if (state[i] == BLK_IN_FLIGHT && now - sent_at[i] > retry_ms) {
+                state[i] = BLK_PENDING;
+                in_flight--;
+                if (i < cursor)
+                    cursor = i;
+            }
+        }
 
-    if (send_uint32_le(fd, file_size) != 0) {
-        if (debug) {
-            fprintf(debug, "ERROR: Failed to send size\n");
-            fclose(debug);
+        if (now - last_ack > BLOCK_STALL_MS && !finish_sent) {
+            if (++resyncs > BLOCK_RESYNCS) {
+                dbg("Target stopped acknowledging blocks at %u of %u\n", acked, nblocks);
+                goto out;
+            }
+            dbg("No ACKs for %d ms, resyncing (%d/%d)\n", BLOCK_STALL_MS, resyncs, BLOCK_RESYNCS);
+            goto resync;
+        }
+        if (finish_sent && now - finish_at > 1000 && now - last_ack > 5000) {
+            dbg("No answer to finish\n");
+            goto out;
         }
-        goto cleanup;
     }
 
-    /* Step 4: Wait for 'B' (Size acknowledgment) */
-    if (debug) {
-        fprintf(debug, "Step 4: Waiting for 'B'...\n");
-        fflush(debug);
-    }
+out:
+    free(state);
+    free(seq);
+    free(sent_at);
+    return result;
+}
+
+/*
+ * Block download (lib/block_upload/block_download.c on the target)
+ */
+
+enum { DL_PENDING, DL_IN_FLIGHT, DL_DONE };
+
+#define DL_UNREADABLE_LIMIT 3  /* Empty 'd' for the same block this often: give up */
+
+/*
+ * Next download reply: 'w', 'O', 'C' (type + 4 bytes) or a 'd' packet
+ * (header, payload, CRC32) into pkt. Returns the type, or 0 after
+ * timeout_ms. Bytes that start none of these are skipped.
+ */
+static int download_reply(int fd, uint8_t *pkt, int timeout_ms)
+{
+    static uint8_t buf[BLOCK_UPLOAD_HEADER_SIZE + BLOCK_UPLOAD_BLOCK_SIZE + 4];
+    static int have = 0;
+    long deadline = now_ms() + timeout_ms;
+
+    while (1) {
+        int need = 1;
+        if (have) {
+            switch (buf[0]) {
+                case BLOCK_RSP_INFO:
+                case BLOCK_RSP_SIZE:
+                case BLOCK_RSP_DONE:   need = 5; break;
+                case BLOCK_RSP_DATA:
+                    need = BLOCK_UPLOAD_HEADER_SIZE;
+                    if (have >= need) {
+                        uint16_t arg = buf[1] | (buf[2] << 8);
+                        uint16_t len = buf[3] | (buf[4] << 8);
+                        if (len > BLOCK_UPLOAD_BLOCK_SIZE ||
+                            buf[5] != block_upload_check(buf[0], arg, len))
+                            need = 0;
+                        else
+                            need += len + 4;
+                    }
+                    break;
+                default:               need = 0; break;
+            }
+            if (!need) {
+                /* Not a reply: hunt on from the next byte */
+                memmove(buf, buf + 1, --have);
+                continue;
+            }
+            if (have == need) {
+                memcpy(pkt, buf, need);
+                have = 0;
+                return pkt[0];
+            }
+        }
 
-    if (wait_for_char(fd, 'B', TIMEOUT_MS) != 0) {
-        if (debug) {
-            fprintf(debug, "ERROR: Timeout waiting for 'B'\n");
-            fclose(debug);
+        ssize_t n = read(fd, buf + have, need - have);
+        if (n > 0) {
+            have += n;
+            continue;
         }
-        goto cleanup;
+
+        long left = deadline - now_ms();
+        if (left <= 0)
+            return 0;
+
+        fd_set rfds;
+        struct timeval tv = { left / 1000, (left % 1000) * 1000 };
+        FD_ZERO(&rfds);
+        FD_SET(fd, &rfds);
+        select(fd + 1, &rfds, NULL, NULL, &tv);
     }
+}
 
-    /* Step 5: Stream ALL data continuously (no ACKs) */
-    if (debug) {
-        fprintf(debug, "Step 5: Streaming %zu bytes of data...\n", file_size);
-        fflush(debug);
+/*
+ * Pull the range the target serves ('down' in hexedit_fast, SRAM after a
+ * crash in sd_card_manager) into filename. Returns 0 once every block
+ * arrived with a good CRC and the file is written, -1 otherwise.
+ */
+static int download_blocks(int fd, const char *filename)
+{
+    static uint8_t pkt[BLOCK_UPLOAD_HEADER_SIZE + BLOCK_UPLOAD_BLOCK_SIZE + 4];
+    uint32_t window = BLOCK_UPLOAD_WINDOW;
+    uint32_t next_seq = 0, done = 0, in_flight = 0, cursor = 0, nblocks;
+    uint8_t *data = NULL, *state = NULL, *unreadable = NULL;
+    uint32_t *seq = NULL;
+    long *sent_at = NULL;
+    long size = -1, last_data;
+    int type = 0, result = -1;
+    FILE *f;
+
+    /* One window of blocks on the wire, plus USB latency */
+    long retry_ms = 100 + 2000L * BLOCK_UPLOAD_WINDOW *
+                    (BLOCK_UPLOAD_BLOCK_SIZE + BLOCK_UPLOAD_HEADER_SIZE + 4) * 10 / port_baud(fd);
+
+    for (int attempt = 0; attempt < 3 && type != BLOCK_RSP_INFO; attempt++) {
+        block_send_packet(fd, BLOCK_PKT_PROBE, BLOCK_UPLOAD_VERSION, NULL, 0);
+        do {
+            type = download_reply(fd, pkt, PROBE_MS);
+        } while (type && type != BLOCK_RSP_INFO);
+    }
+    if (type != BLOCK_RSP_INFO || (pkt[2] | (pkt[3] << 8)) != BLOCK_UPLOAD_BLOCK_SIZE) {
+        dbg("No block protocol sender on the target\n");
+        return -1;
+    }
+    if (pkt[4] && pkt[4] < window)
+        window = pkt[4];
+
+    for (int attempt = 0; attempt < 3 && size < 0; attempt++) {
+        block_send_packet(fd, BLOCK_PKT_QUERY, 0, NULL, 0);
+        do {
+            type = download_reply(fd, pkt, 1000);
+        } while (type && type != BLOCK_RSP_SIZE);
+        if (type == BLOCK_RSP_SIZE)
+            size = get_le32(pkt + 1);
     }
+    if (size <= 0) {
+        dbg("No answer to the size query\n");
+        goto abort;
+    }
+    nblocks = (size + BLOCK_UPLOAD_BLOCK_SIZE - 1) / BLOCK_UPLOAD_BLOCK_SIZE;
+    dbg("Block download: %ld bytes, %u x %d, window %u\n",
+        size, nblocks, BLOCK_UPLOAD_BLOCK_SIZE, window);
+
+    data = malloc(size);
+    state = calloc(nblocks, 1);
+    unreadable = calloc(nblocks, 1);
+    seq = calloc(nblocks, sizeof(uint32_t));
+    sent_at = calloc(nblocks, sizeof(long));
+    if (!data || !state || !unreadable || !seq || !sent_at)
+        goto abort;
+    last_data = now_ms();
+
+    while (done < nblocks) {
+        long now = now_ms();
+
+        /* Keep the window full, lowest missing block first */
+        while (in_flight < window) {
+            while (cursor < nblocks && state[cursor] != DL_PENDING)
+                cursor++;
+            if (cursor == nblocks)
+                break;
+            if (block_send_packet(fd, BLOCK_PKT_GET, cursor, NULL, 0) != 0)
+                goto abort;
+            state[cursor] = DL_IN_FLIGHT;
+            seq[cursor] = next_seq++;
+            sent_at[cursor] = now;
+            in_flight++;
+        }
 
-    size_t sent = 0;
-    struct timeval stream_start, stream_now;
-    gettimeofday(&stream_start, NULL);
+        if (download_reply(fd, pkt, 5) == BLOCK_RSP_DATA) {
+            uint32_t idx = pkt[1] | (pkt[2] << 8);
+            uint32_t len = pkt[3] | (pkt[4] << 8);
+            uint32_t want = size - (size_t)idx * BLOCK_UPLOAD_BLOCK_SIZE;
+            const uint8_t *payload = pkt + BLOCK_UPLOAD_HEADER_SIZE;
+
+            if (idx >= nblocks)
+                continue;
+
+            /*
+             * Answers come in request order: anything asked for before
+             * this block and still unanswered was lost on the way
+             */
+            if (state[idx] == DL_IN_FLIGHT) {
+                for (uint32_t i = 0; i < nblocks; i++) {
+                    if (state[i] == DL_IN_FLIGHT && seq[i] < seq[idx]) {
+                        state[i] = DL_PENDING;
+                        in_flight--;
+                        if (i < cursor)
+                            cursor = i;
+                    }
+                }
+                state[idx] = DL_PENDING;
+                in_flight--;
+                if (idx < cursor)
+                    cursor = idx;
+            }
+            if (state[idx] == DL_DONE)
+                continue;
+
+            if (want > BLOCK_UPLOAD_BLOCK_SIZE)
+                want = BLOCK_UPLOAD_BLOCK_SIZE;
+            if (len == 0 && get_le32(payload) == 0) {
+                /* Target could not read it (SD error): give up after a few */
+                if (++unreadable[idx] >= DL_UNREADABLE_LIMIT) {
+                    dbg("Target cannot read block %u\n", idx);
+                    goto abort;
+                }
+                continue;
+            }
+            if (len != want || get_le32(payload + len) != calculate_crc32(payload, len)) {
+                dbg("Bad CRC in block %u\n", idx);
+                continue;
+            }
 
-    while (sent < file_size) {
-        size_t to_send = file_size - sent;
-        if (to_send > 1024)
-            to_send = 1024;
+            memcpy(data + (size_t)idx * BLOCK_UPLOAD_BLOCK_SIZE, payload, len);
+            state[idx] = DL_DONE;
+            done++;
+            last_data = now;
+            continue;
+        }
 
-        ssize_t written = write(fd, data + sent, to_send);
-        if (written <= 0) {
-            if (debug) {
-                fprintf(debug, "ERROR: write() failed at byte %zu, returned %zd\n", sent, written);
-                fclose(debug);
+        /* Silent losses: no answer at all within the retry time */
+        for (uint32_t i = 0; i < nblocks; i++) {
+            if (state[i] == DL_IN_FLIGHT && now - sent_at[i] > retry_ms) {
+                state[i] = DL_PENDING;
+                in_flight--;
+                if (i < cursor)
+                    cursor = i;
             }
-            goto cleanup;
         }
 
-        sent += written;
-
-        /* Check timeout - abort if streaming takes longer than timeout */
-        gettimeofday(&stream_now, NULL);
-        long elapsed_ms = (stream_now.tv_sec - stream_start.tv_sec) * 1000 +
-                         (stream_now.tv_usec - stream_start.tv_usec) / 1000;
-        if (elapsed_ms > TIMEOUT_MS) {
-            if (debug) {
-                fprintf(debug, "ERROR: Data streaming timeout after %zu bytes\n", sent);
-                fclose(debug);
-            }
-            goto cleanup;
+        if (now - last_data > BLOCK_STALL_MS * (BLOCK_RESYNCS + 1)) {
+            dbg("Target stopped sending at block %u of %u\n", done, nblocks);
+            goto abort;
         }
     }
 
-    if (debug) {
-        fprintf(debug, "Step 5 complete: Sent %zu bytes\n", sent);
-        fprintf(debug, "Draining output buffer...\n");
-        fflush(debug);
+    /*
+     * Finish: the target re-reads the range for its CRC. A mismatch means
+     * the memory changed during the download (each block was good as sent)
+     */
+    type = 0;
+    for (int attempt = 0; attempt < 3 && type != BLOCK_RSP_DONE; attempt++) {
+        block_send_packet(fd, BLOCK_PKT_FINISH, 0, NULL, 0);
+        do {
+            type = download_reply(fd, pkt, 1000);
+        } while (type && type != BLOCK_RSP_DONE);
     }
+    dbg("CRC32 0x%08X, target 0x%08X%s\n", calculate_crc32(data, size),
+        type == BLOCK_RSP_DONE ? get_le32(pkt + 1) : 0,
+        type == BLOCK_RSP_DONE ? "" : " (no answer to finish)");
+
+    f = fopen(filename, "wb");
+    if (f && fwrite(data, 1, size, f) == (size_t)size)
+        result = 0;
+    if (f)
+        fclose(f);
+    goto out;
+
+abort:
+    /* Back to the target's prompt instead of leaving it serving */
+    block_send_packet(fd, BLOCK_PKT_ABORT, 0, NULL, 0);
+out:
+    free(data);
+    free(state);
+    free(unreadable);
+    free(seq);
+    free(sent_at);
+    return result;
+}
 
-    /* Wait for all data to be physically transmitted */
-    tcdrain(fd);
+/*
+ * FAST stream transfer
+ */
+static int upload_stream(int fd, const uint8_t *data, size_t size)
+{
+    uint32_t crc32 = calculate_crc32(data, size);
+    uint32_t fpga_crc32;
+    uint8_t size_bytes[4];
+    uint8_t crc_packet[5] = { 'C' };
 
-    if (debug) {
-        fprintf(debug, "Output drained.\n");
-        fprintf(debug, "Step 6: Sending 'C' + CRC32 (5 bytes total)\n");
-        fprintf(debug, "CRC32: 0x%08X\n", crc32);
-        fflush(debug);
-    }
-
-    /* Step 6: Send 'C' followed by CRC32 (5 bytes total) */
-    uint8_t crc_packet[5];
-    crc_packet[0] = 'C';
-    crc_packet[1] = (crc32 >> 0) & 0xFF;
-    crc_packet[2] = (crc32 >> 8) & 0xFF;
-    crc_packet[3] = (crc32 >> 16) & 0xFF;
-    crc_packet[4] = (crc32 >> 24) & 0xFF;
-
-    if (write(fd, crc_packet, 5) != 5) {
-        if (debug) {
-            fprintf(debug, "ERROR: Failed to send 'C' + CRC32\n");
-            fclose(debug);
-        }
-        goto cleanup;
+    /* Step 1: Send 'R' to signal transfer is starting */
+    dbg("FAST stream: %zu bytes, CRC32 0x%08X\n", size, crc32);
+    if (write(fd, "R", 1) != 1)
+        return -1;
+
+    /* Step 2: Wait for 'A' (Ready acknowledgment) */
+    if (wait_for_char(fd, 'A', TIMEOUT_MS) != 0)
+        return -1;
+
+    /* Step 3: Send size (4 bytes little-endian) */
+    put_le32(size_bytes, (uint32_t)size);
+    if (write_all(fd, size_bytes, 4) != 0)
+        return -1;
+
+    /* Step 4: Wait for 'B' (Size acknowledgment) */
+    if (wait_for_char(fd, 'B', TIMEOUT_MS) != 0)
+        return -1;
+
+    /* Step 5: Stream ALL data continuously (no ACKs), then 'C' + CRC32 */
+    put_le32(crc_packet + 1, crc32);
+    if (write_all(fd, data, size) != 0 ||
+        write_all(fd, crc_packet, sizeof(crc_packet)) != 0) {
+        dbg("ERROR: write() failed while streaming\n");
+        return -1;
     }
 
+    /* Wait for all data to be physically transmitted */
     tcdrain(fd);
 
-    if (debug) {
-        fprintf(debug, "Step 7: Waiting for FPGA response ('C' + calculated CRC)...\n");
-        fflush(debug);
+    /* Step 7: Wait for 'C' from FPGA (it calculates the CRC32 first) */
+    if (wait_for_char(fd, 'C', TIMEOUT_MS) != 0)
+        return -1;
+
+    /* Step 8: Receive FPGA's calculated CRC32 (4 bytes little-endian) */
+    if (read_uint32_le(fd, &fpga_crc32, TIMEOUT_MS) != 0) {
+        dbg("ERROR: Timeout reading FPGA CRC32\n");
+        return -1;
     }
 
-    /* Give FPGA time to calculate CRC32 */
-    usleep(100000);  /* 100ms */
+    /* Step 9: Verify CRC match */
+    dbg("Received FPGA CRC32: 0x%08X\n", fpga_crc32);
+    return fpga_crc32 == crc32 ? 0 : -1;
+}
 
-    /* Step 7: Wait for 'C' from FPGA */
-    if (wait_for_char(fd, 'C', TIMEOUT_MS) != 0) {
-        if (debug) {
-            fprintf(debug, "ERROR: Timeout waiting for 'C' response\n");
-            fclose(debug);
-        }
-        goto cleanup;
+/* Read the whole file; a .bin.lz4 is decoded and its block kept */
+static uint8_t *load_image(const char *filename, size_t *size,
+                           uint8_t **block, size_t *block_size)
+{
+    FILE *fp;
+    uint8_t *data = NULL;
+    long len;
+
+    *block = NULL;
+    *block_size = 0;
+
+    fp = fopen(filename, "rb");
+    if (!fp) {
+        dbg("ERROR: fopen failed for '%s': %s\n", filename, strerror(errno));
+        return NULL;
     }
+    fseek(fp, 0, SEEK_END);
+    len = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
 
-    /* Step 8: Receive FPGA's calculated CRC32 (4 bytes little-endian) */
-    if (read_uint32_le(fd, &fpga_crc32, TIMEOUT_MS) != 0) {
-        if (debug) {
-            fprintf(debug, "ERROR: Timeout reading FPGA CRC32\n");
-            fclose(debug);
+    if (len <= 0 || len > MAX_IMAGE_SIZE + MAX_IMAGE_SIZE / 255 + 28 ||
+        !(data = malloc(len)) || fread(data, 1, len, fp) != (size_t)len) {
+        dbg("ERROR: Cannot read '%s' (%ld bytes, max %d)\n", filename, len, MAX_IMAGE_SIZE);
+        free(data);
+        fclose(fp);
+        return NULL;
+    }
+    fclose(fp);
+    *size = len;
+
+    /* .bin.lz4: magic, length, CRC32, LZ4 block */
+    if (len >= 12 && get_le32(data) == LZ4B_MAGIC) {
+        size_t length = get_le32(data + 4);
+        uint8_t *image = (length && length <= MAX_IMAGE_SIZE) ? malloc(length) : NULL;
+
+        if (!image || lz4_decode(data + 12, len - 12, image, length) != 0 ||
+            calculate_crc32(image, length) != get_le32(data + 8) ||
+            !(*block = malloc(len - 12))) {
+            dbg("ERROR: '%s' is not a valid .bin.lz4 image\n", filename);
+            free(image);
+            free(data);
+            return NULL;
         }
-        goto cleanup;
+        *block_size = len - 12;
+        memcpy(*block, data + 12, *block_size);
+        free(data);
+        *size = length;
+        return image;
     }
 
-    if (debug) {
-        fprintf(debug, "Received FPGA CRC32: 0x%08X\n", fpga_crc32);
-        fprintf(debug, "Expected CRC32: 0x%08X\n", crc32);
-        fflush(debug);
+    if (len > MAX_IMAGE_SIZE) {
+        dbg("ERROR: Invalid file size %ld (must be 1-%d)\n", len, MAX_IMAGE_SIZE);
+        free(data);
+        return NULL;
     }
+    return data;
+}
 
-    /* Step 9: Verify CRC match */
-    if (fpga_crc32 == crc32)
-        ret = 0;  /* Success */
-    else
-        ret = -1;  /* CRC mismatch */
+/*
+ * FAST upload implementation
+ * fd: serial port file descriptor (already configured by minicom)
+ * filename: file to upload
+ * options: the protocol's program field (see the top of this file)
+ *
+ * SILENT MODE: Writes ONLY to serial port, NO console output
+ */
+int fast_upload(int fd, const char *filename, const char *options)
+{
+    uint8_t *data, *block;
+    size_t size, block_size;
+    int compress = 0, stream_only = 0;
+    int ret = 1;
+    struct termios oldtio, newtio;
+    char opts[256], *tok;
+
+    snprintf(opts, sizeof(opts), "%s", options ? options : "");
+    for (tok = strtok(opts, " \t"); tok; tok = strtok(NULL, " \t")) {
+        if (strcmp(tok, "-z") == 0)
+            compress = 1;
+        else if (strcmp(tok, "-s") == 0)
+            stream_only = 1;
+        else if (strcmp(tok, "-l") == 0 && (tok = strtok(NULL, " \t")) != NULL)
+            trace = fopen(tok, "a");
+    }
 
-cleanup:
-    if (debug) {
-        fprintf(debug, "Cleanup: ret=%d\n", ret);
-        fclose(debug);
+    dbg("fast_upload() called with fd=%d, filename='%s', options='%s'\n",
+        fd, filename ? filename : "(null)", options ? options : "");
+    long start = now_ms();
+
+    data = load_image(filename, &size, &block, &block_size);
+    if (!data)
+        goto out;
+    if (compress && !block) {
+        block_size = lz4_compress(data, size, &block);
+        if (!block_size)
+            goto done;
     }
 
-    /* Restore original port settings */
-    if (port_configured)
-        tcsetattr(fd, TCSANOW, &oldtio);
+    /* Save current port settings and configure for raw mode */
+    tcgetattr(fd, &oldtio);
+    newtio = oldtio;
 
-    if (data)
-        free(data);
-    if (fp)
-        fclose(fp);
+    /* Raw mode - no processing */
+    newtio.c_lflag &= ~(ICANON | ECHO | ECHOE | ISIG);
+    newtio.c_iflag &= ~(IXON | IXOFF | IXANY | ICRNL | INLCR);
+    newtio.c_oflag &= ~OPOST;
+
+    /* Read settings - return immediately (read_byte() waits in select()) */
+    newtio.c_cc[VMIN] = 0;
+    newtio.c_cc[VTIME] = 0;
+
+    tcsetattr(fd, TCSANOW, &newtio);
+
+    /* Compressed, then block protocol, then FAST stream: whatever answers */
+    if (block)
+        ret = upload_compressed(fd, data, size, block, block_size);
+    if (ret > 0 && !stream_only)
+        ret = upload_blocks(fd, data, size);
+    if (ret > 0)
+        ret = upload_stream(fd, data, size);
 
+    /* Restore original port settings */
+    tcsetattr(fd, TCSANOW, &oldtio);
+
+done:
+    free(data);
+    free(block);
+out:
+    if (ret > 0)
+        ret = -1;
+    dbg("Result: %d after %ld ms\n", ret, now_ms() - start);
+    if (trace) {
+        fclose(trace);
+        trace = NULL;
+    }
     return ret;
 }
 
 /*
  * FAST download implementation
- * fd: serial port file descriptor
+ * fd: serial port file descriptor (already configured by minicom)
  * filename: file to save
+ * options: the protocol's program field (-l <file> only)
+ *
+ * Block protocol only: start the sender on the target first ('down
+ * <addr> <len>' in hexedit_fast), then receive.
+ *
+ * SILENT MODE: Writes ONLY to serial port, NO console output
  */
-int fast_download(int fd, const char *filename)
+int fast_download(int fd, const char *filename, const char *options)
 {
-    (void)fd;
-    (void)filename;
-    return -1;  /* Not implemented */
+    struct termios oldtio, newtio;
+    char opts[256], *tok;
+    int ret;
+
+    snprintf(opts, sizeof(opts), "%s", options ? options : "");
+    for (tok = strtok(opts, " \t"); tok; tok = strtok(NULL, " \t")) {
+        if (strcmp(tok, "-l") == 0 && (tok = strtok(NULL, " \t")) != NULL)
+            trace = fopen(tok, "a");
+    }
+
+    dbg("fast_download() called with fd=%d, filename='%s', options='%s'\n",
+        fd, filename ? filename : "(null)", options ? options : "");
+    long start = now_ms();
+
+    if (!filename || !*filename) {
+        ret = -1;
+        goto out;
+    }
+
+    /* Raw mode, as for the upload */
+    tcgetattr(fd, &oldtio);
+    newtio = oldtio;
+    newtio.c_lflag &= ~(ICANON | ECHO | ECHOE | ISIG);
+    newtio.c_iflag &= ~(IXON | IXOFF | IXANY | ICRNL | INLCR);
+    newtio.c_oflag &= ~OPOST;
+    newtio.c_cc[VMIN] = 0;
+    newtio.c_cc[VTIME] = 0;
+    tcsetattr(fd, TCSANOW, &newtio);
+
+    ret = download_blocks(fd, filename);
+
+    tcsetattr(fd, TCSANOW, &oldtio);
+
+out:
+    dbg("Result: %d after %ld ms\n", ret, now_ms() - start);
+    if (trace) {
+        fclose(trace);
+        trace = NULL;
+    }
+    return ret;
 }
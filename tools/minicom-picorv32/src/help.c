@@ -64,7 +64,7 @@ int help(void)
   mc_wputs(w, _(" lineWrap on/off....W"));
   mc_wputs(w, _("  local Echo on/off..E | Help screen........Z\n"));
   mc_wputs(w, _(" Paste file.........Y  Timestamp toggle...N | scroll Back........B\n"));
-  mc_wputs(w, _(" Add Carriage Ret...U"));
+  mc_wputs(w, _(" Add Carriage Ret...U  Raw capture........V"));
 
   s = _("Select function or press Enter for none.");
   mc_wlocate(w, (x2 - x1) / 2 - strlen(s) / 2, 16);
@@ -1169,6 +1169,8 @@ int main(int argc, char **argv)
   char *s, *bufp;               /* Scratch pointers */
   int doinit = 1;               /* -o option */
   char capname[128];            /* Name of capture file */
+  char rawname[128];            /* Raw capture file, Ctrl-A V */
+  char rawelf[256];             /* Firmware ELF to decode binlog records */
   struct passwd *pwd;           /* To look up user name */
   char *use_port;               /* Name of initialization file */
   char *args[20];               /* New argv pointer */
@@ -1240,6 +1242,8 @@ int main(int argc, char **argv)
   display_hex = 0;
   local_echo = 0;
   strcpy(capname, "minicom.cap");
+  strcpy(rawname, "minicom.raw");
+  rawelf[0] = 0;
   lockfile_mode = Lockfile_mode_unset;
   tempst = 0;
   st = NULL;
@@ -1856,6 +1860,24 @@ dirty_goto:
       case 'y': /* Paste file */
         paste_file();
         break;
+      case 'v': /* Raw capture, no terminal emulation */
+        s = input(_("Raw capture to which file? "), rawname, sizeof(rawname));
+        if (s == NULL || *s == 0)
+          break;
+        s = input(_("Decode binlog with ELF (empty: no)? "), rawelf, sizeof(rawelf));
+        if (s == NULL)
+          break;
+        {
+          char msg[64];
+          long n = raw_capture(portfd, rawname, rawelf);
+
+          if (n >= 0) {
+            snprintf(msg, sizeof(msg), _("Raw capture: %ld bytes"), n);
+            status_set_display(msg, 0);
+          }
+        }
+        timer_update();
+        break;
       case EOF: /* Cannot read from stdin anymore, exit silently */
         quit = NORESET;
         break;
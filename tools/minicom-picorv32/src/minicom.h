@@ -291,8 +291,11 @@ void runscript(int ask, const char *s, const char *l, const char *p);
 int  paste_file(void);
 
 /* Prototypes from file: fast-xfr.c */
-int fast_upload(int fd, const char *filename);
-int fast_download(int fd, const char *filename);
+int fast_upload(int fd, const char *filename, const char *options);
+int fast_download(int fd, const char *filename, const char *options);
+
+/* Prototypes from file: raw-capture.c */
+long raw_capture(int fd, const char *filename, const char *elf);
 
 /* Prototypes from file: windiv.c */
 WIN *mc_tell(const char *, ...);
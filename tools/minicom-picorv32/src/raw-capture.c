@@ -0,0 +1,306 @@
+/*
+ * raw-capture.c   Raw capture mode for minicom
+ *
+ *              Ctrl-A V: everything the target sends goes straight
+ *              to a file, past the VT100 emulation and the screen.
+ *              The terminal path renders each byte and falls behind a
+ *              target streaming logs or binary data at 1 Mbaud; here
+ *              the port is read into a large buffer and written out
+ *              in 64 KB blocks, so the loop only has to keep up with
+ *              the kernel's tty buffer.
+ *
+ *              A window shows the byte count, the current, average
+ *              and peak rate against the line rate and, on Linux, the
+ *              UART overruns the driver counted. Any key ends it.
+ *
+ *              With a firmware ELF, the data is also piped through
+ *              tools/binlog/binlog_decode (lib/binlog records and the
+ *              text between them) into <file>.txt. $BINLOG_DECODE
+ *              names the decoder if it is not in the PATH.
+ *
+ * Copyright (c) 2025 Michael Wolak
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <config.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/select.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <termios.h>
+#include <stdint.h>
+#ifdef __linux__
+#include <linux/serial.h>
+#endif
+
+#include "port.h"
+#include "minicom.h"
+#include "intl.h"
+
+#define CAP_BUF       (256 * 1024)  /* 2.5 s at 1 Mbaud if the disk stalls */
+#define CAP_WRITE     (64 * 1024)   /* Write once this much is buffered */
+#define CAP_WRITE_MS  500           /* ... or this long after the last write */
+#define CAP_UPDATE_MS 250           /* Rate display */
+
+static long now_ms(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000L + tv.tv_usec / 1000;
+}
+
+/* Bytes per second the line can carry (8N1: 10 bits a byte) */
+static long line_rate(int fd)
+{
+    struct termios tio;
+    speed_t s;
+
+    if (tcgetattr(fd, &tio) != 0)
+        return 0;
+    s = cfgetispeed(&tio);
+    switch (s) {
+        case B9600:    return 960;
+        case B19200:   return 1920;
+        case B38400:   return 3840;
+        case B57600:   return 5760;
+        case B115200:  return 11520;
+        case B230400:  return 23040;
+        case B460800:  return 46080;
+        case B921600:  return 92160;
+#ifdef B1000000
+        case B1000000: return 100000;
+#endif
+#ifdef B1500000
+        case B1500000: return 150000;
+#endif
+#ifdef B2000000
+        case B2000000: return 200000;
+#endif
+#ifdef B3000000
+        case B3000000: return 300000;
+#endif
+        default:       return 0;
+    }
+}
+
+/* Receive errors the UART driver counted; -1 where it does not say */
+static long rx_errors(int fd)
+{
+#if defined(__linux__) && defined(TIOCGICOUNT)
+    struct serial_icounter_struct ic;
+
+    if (ioctl(fd, TIOCGICOUNT, &ic) == 0)
+        return (long)ic.overrun + ic.buf_overrun + ic.frame + ic.parity;
+#else
+    (void)fd;
+#endif
+    return -1;
+}
+
+/* Everything out; -1 on an error */
+static int write_all(int fd, const uint8_t *buf, size_t len)
+{
+    while (len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if (n > 0) {
+            buf += n;
+            len -= n;
+        } else if (n < 0 && errno != EINTR) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* s in single quotes for sh */
+static void shell_quote(char *out, size_t size, const char *s)
+{
+    size_t n = 0;
+
+    if (size < 3)
+        return;
+    out[n++] = '\'';
+    for (; *s && n + 5 < size; s++) {
+        if (*s == '\'') {
+            memcpy(out + n, "'\\''", 4);
+            n += 4;
+        } else {
+            out[n++] = *s;
+        }
+    }
+    out[n++] = '\'';
+    out[n] = 0;
+}
+
+/* binlog_decode <elf> reading the capture on stdin, into <file>.txt */
+static FILE *start_decoder(const char *filename, const char *elf, char *txt, size_t txt_size)
+{
+    const char *prog = getenv("BINLOG_DECODE");
+    char qprog[512], qelf[512], qtxt[512], cmd[1600];
+
+    if (!prog || !*prog)
+        prog = "binlog_decode";
+    snprintf(txt, txt_size, "%s.txt", filename);
+    shell_quote(qprog, sizeof(qprog), prog);
+    shell_quote(qelf, sizeof(qelf), elf);
+    shell_quote(qtxt, sizeof(qtxt), txt);
+    snprintf(cmd, sizeof(cmd), "exec %s %s > %s 2>&1", qprog, qelf, qtxt);
+    return popen(cmd, "w");
+}
+
+static void show_rate(WIN *w, long bytes, long ms, long rate, long peak,
+                      long line, long writes, long errors, FILE *dec, const char *txt)
+{
+    struct stat st;
+
+    mc_wlocate(w, 1, 1);
+    mc_wprintf(w, "%ld bytes in %ld.%ld s, %ld writes", bytes, ms / 1000, (ms % 1000) / 100, writes);
+    mc_wclreol(w);
+    mc_wlocate(w, 1, 2);
+    mc_wprintf(w, "Now %ld.%ld KB/s, average %ld.%ld KB/s, peak %ld.%ld KB/s",
+               rate / 1024, (rate % 1024) * 10 / 1024,
+               ms ? bytes * 1000 / ms / 1024 : 0, ms ? (bytes * 1000 / ms % 1024) * 10 / 1024 : 0,
+               peak / 1024, (peak % 1024) * 10 / 1024);
+    mc_wclreol(w);
+    mc_wlocate(w, 1, 3);
+    if (line > 0)
+        mc_wprintf(w, "Line %ld KB/s: %ld%% in use", line / 1024, rate * 100 / line);
+    if (errors >= 0)
+        mc_wprintf(w, ", %ld rx errors (overrun/frame/parity)", errors);
+    mc_wclreol(w);
+    mc_wlocate(w, 1, 4);
+    if (txt[0])
+        mc_wprintf(w, "binlog: %s, %ld bytes%s", txt,
+                   stat(txt, &st) == 0 ? (long)st.st_size : 0L, dec ? "" : _(" (decoder stopped)"));
+    mc_wclreol(w);
+    mc_wflush();
+}
+
+/*
+ * Raw capture
+ * fd: serial port file descriptor (already configured by minicom)
+ * filename: file to write (replaced)
+ * elf: firmware ELF for binlog decoding, NULL or empty for none
+ *
+ * Returns the number of bytes captured, -1 if the file cannot be opened.
+ */
+long raw_capture(int fd, const char *filename, const char *elf)
+{
+    struct termios oldtio, newtio;
+    uint8_t *buf;
+    size_t len = 0;
+    char txt[512] = "";
+    FILE *dec = NULL;
+    WIN *w;
+    int out, stop = 0;
+    long start, last_write, last_show, shown_bytes = 0;
+    long bytes = 0, writes = 0, rate = 0, peak = 0, line, errors0, errors;
+
+    out = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out < 0) {
+        werror(_("Cannot open capture file"));
+        return -1;
+    }
+    buf = malloc(CAP_BUF);
+    if (!buf) {
+        close(out);
+        werror(_("Out of memory"));
+        return -1;
+    }
+    if (elf && *elf) {
+        dec = start_decoder(filename, elf, txt, sizeof(txt));
+        if (!dec)
+            werror(_("Cannot start binlog_decode"));
+    }
+
+    /* Raw mode, as for the Fast transfers */
+    tcgetattr(fd, &oldtio);
+    newtio = oldtio;
+    newtio.c_lflag &= ~(ICANON | ECHO | ECHOE | ISIG);
+    newtio.c_iflag &= ~(IXON | IXOFF | IXANY | ICRNL | INLCR | ISTRIP);
+    newtio.c_oflag &= ~OPOST;
+    newtio.c_cc[VMIN] = 0;
+    newtio.c_cc[VTIME] = 0;
+    tcsetattr(fd, TCSANOW, &newtio);
+
+    line = line_rate(fd);
+    errors0 = rx_errors(fd);
+
+    w = mc_wopen(5, 5, 74, 11, BSINGLE, stdattr, mfcolor, mbcolor, 1, 0, 1);
+    mc_wtitle(w, TMID, _("Raw capture - any key to stop"));
+    mc_wlocate(w, 1, 0);
+    mc_wprintf(w, "%s", filename);
+
+    start = last_write = last_show = now_ms();
+    while (!stop) {
+        struct timeval tv = { 0, 50000 };
+        fd_set fds;
+        long t;
+
+        FD_ZERO(&fds);
+        FD_SET(fd, &fds);
+        FD_SET(STDIN_FILENO, &fds);
+        if (io_pending) {
+            wxgetch();                  /* A key read ahead */
+            stop = 1;
+        } else if (select((fd > STDIN_FILENO ? fd : STDIN_FILENO) + 1, &fds, NULL, NULL, &tv) > 0) {
+            if (FD_ISSET(fd, &fds)) {
+                ssize_t n = read(fd, buf + len, CAP_BUF - len);
+                if (n > 0) {
+                    len += n;
+                    bytes += n;
+                } else if (n == 0 || (errno != EAGAIN && errno != EINTR)) {
+                    stop = 1;           /* Port gone (USB unplugged) */
+                }
+            }
+            if (FD_ISSET(STDIN_FILENO, &fds)) {
+                wxgetch();
+                stop = 1;
+            }
+        }
+
+        t = now_ms();
+        if (len >= CAP_WRITE || (len > 0 && (stop || t - last_write >= CAP_WRITE_MS))) {
+            if (write_all(out, buf, len) < 0) {
+                werror(_("Cannot write capture file"));
+                stop = 1;
+            }
+            if (dec && (fwrite(buf, 1, len, dec) != len || fflush(dec) != 0)) {
+                pclose(dec);            /* Decoder exited (EPIPE) */
+                dec = NULL;
+            }
+            len = 0;
+            writes++;
+            last_write = t;
+        }
+        if (t - last_show >= CAP_UPDATE_MS || stop) {
+            if (t > last_show)
+                rate = (bytes - shown_bytes) * 1000 / (t - last_show);
+            if (rate > peak)
+                peak = rate;
+            errors = errors0 >= 0 ? rx_errors(fd) - errors0 : -1;
+            show_rate(w, bytes, t - start, rate, peak, line, writes, errors, dec, txt);
+            shown_bytes = bytes;
+            last_show = t;
+        }
+    }
+
+    tcsetattr(fd, TCSANOW, &oldtio);
+    if (dec)
+        pclose(dec);
+    close(out);
+    free(buf);
+    mc_wclose(w, 1);
+    return bytes;
+}
@@ -64,8 +64,8 @@ struct macs mmacs[] = {
 struct pars mpars[MPARS_MAX + 1] = {
   /* Protocols */
   /* Warning: minicom assumes the first 12 entries are these proto's ! */
-  { "YUNYNFast",	0,   "pname1" },  /* FAST streaming - only protocol */
-  { "",			0,   "pname2" },
+  { "YUNYNFast",	0,   "pname1" },  /* FAST streaming upload */
+  { "YDNYNFast",	0,   "pname2" },  /* FAST block download */
   { "",			0,   "pname3" },
   { "",			0,   "pname4" },
   { "",			0,   "pname5" },
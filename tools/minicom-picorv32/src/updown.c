@@ -305,32 +305,19 @@ void updown(int what, int nr)
   /* Check if this is the FAST protocol - handle it directly without forking */
   if (strcmp(P_PNAME(g), "Fast") == 0) {
     int result;
-    FILE *debug = fopen("/tmp/minicom-fast-debug.log", "a");
-    if (debug) {
-      fprintf(debug, "\n=== FAST protocol selected ===\n");
-      fprintf(debug, "Protocol: %s\n", P_PNAME(g));
-      fprintf(debug, "Filename: %s\n", s);
-      fprintf(debug, "Port FD: %d\n", portfd);
-      fflush(debug);
-      fclose(debug);
-    }
 
     /* Flush serial port before transfer */
     m_flush(portfd);
 
     /* Execute FAST transfer */
     if (what == 'U') {
-      result = fast_upload(portfd, (char *)s);
+      result = fast_upload(portfd, (char *)s, P_PPROG(g));
     } else {
-      result = fast_download(portfd, (char *)s);
+      result = fast_download(portfd, (char *)s, P_PPROG(g));
     }
 
-    debug = fopen("/tmp/minicom-fast-debug.log", "a");
-    if (debug) {
-      fprintf(debug, "Transfer result: %d (0=success, -1=failure)\n", result);
-      fflush(debug);
-      fclose(debug);
-    }
+    if (P_LOGXFER[0] == 'Y')
+      do_log("Fast %s: %s", s, result == 0 ? "OK" : _("failed"));
 
     if (cmdline)
       free(cmdline);
@@ -0,0 +1,365 @@
+//===============================================================================
+// Overlay TCP Upload - Linux Host Application
+//
+// Sends an overlay binary to boards running lwIP/port/overlay_tcp.c
+// (firmware/lwIP/demos/overlay_tcp_server.c) over the network: the image
+// lands in the overlay slot at 0x60000, is CRC32 checked on the board and
+// can be saved to /OVERLAYS on SD and run. Several boards can be given to
+// redeploy them one after another.
+//
+// Usage:
+//   ./overlay_tcp_upload [options] <file.bin> <board_ip> [board_ip...]
+//
+// Options:
+//   -p <port>      Server port (default: 8890)
+//   -s <name>      Save to /OVERLAYS/<name> on the board's SD card
+//   -x             Run the overlay after the upload
+//   -t <seconds>   Socket timeout (default: 60)
+//
+// Example:
+//   ./overlay_tcp_upload -s HEXEDIT.BIN -x hexedit.bin 192.168.100.2
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//===============================================================================
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <getopt.h>
+
+//==============================================================================
+// Configuration
+//==============================================================================
+
+#define DEFAULT_PORT            8890
+#define DEFAULT_TIMEOUT_SEC     60
+#define CHUNK_SIZE              (16 * 1024)     // DATA message size
+#define NAME_MAX_LEN            63
+
+//==============================================================================
+// Protocol (must match firmware/lwIP/port/overlay_tcp.h)
+//==============================================================================
+
+#define MSG_CAPS_REQ    0x01
+#define MSG_CAPS_RESP   0x02
+#define MSG_START       0x03
+#define MSG_ACK         0x04
+#define MSG_DATA        0x06
+#define MSG_DONE        0x07
+#define MSG_END         0x08
+#define MSG_EXEC        0x09
+#define MSG_ERROR       0xFF
+
+#define FLAG_SAVE       (1 << 0)
+#define CAN_SAVE        (1 << 0)
+
+static const char *error_name(uint32_t code) {
+    switch (code) {
+        case 1: return "image larger than the overlay slot";
+        case 2: return "out of sequence";
+        case 3: return "CRC mismatch";
+        case 4: return "bad message";
+        case 5: return "SD save failed";
+        case 6: return "upload incomplete";
+        case 7: return "overlay slot not reserved (heap too large)";
+        default: return "unknown error";
+    }
+}
+
+//==============================================================================
+// CRC32 (0xEDB88320, same as lib/crc32.h)
+//==============================================================================
+
+static uint32_t calculate_crc32(const uint8_t *data, uint32_t length) {
+    uint32_t crc = 0xFFFFFFFF;
+
+    for (uint32_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int j = 0; j < 8; j++) {
+            crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320 : 0);
+        }
+    }
+    return ~crc;
+}
+
+//==============================================================================
+// Messages
+//==============================================================================
+
+static void put32(uint8_t *p, uint32_t v) {
+    p[0] = (v >> 24) & 0xFF;
+    p[1] = (v >> 16) & 0xFF;
+    p[2] = (v >> 8) & 0xFF;
+    p[3] = v & 0xFF;
+}
+
+static uint32_t get32(const uint8_t *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+           ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static int send_all(int fd, const void *buf, size_t len) {
+    const uint8_t *p = (const uint8_t *)buf;
+
+    while (len > 0) {
+        ssize_t n = send(fd, p, len, 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static int recv_all(int fd, void *buf, size_t len) {
+    uint8_t *p = (uint8_t *)buf;
+
+    while (len > 0) {
+        ssize_t n = recv(fd, p, len, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static int send_message(int fd, uint32_t type, const void *payload, uint32_t length) {
+    uint8_t header[8];
+
+    put32(header, type);
+    put32(header + 4, length);
+    if (send_all(fd, header, 8) < 0) return -1;
+    if (length > 0 && send_all(fd, payload, length) < 0) return -1;
+    return 0;
+}
+
+// Receive one reply (payload up to 12 bytes); returns its type, 0 on error
+static uint32_t recv_reply(int fd, uint32_t value[3]) {
+    uint8_t header[8], payload[12];
+    uint32_t type, length;
+
+    if (recv_all(fd, header, 8) < 0) return 0;
+    type = get32(header);
+    length = get32(header + 4);
+    if (length > sizeof(payload)) return 0;
+    if (length > 0 && recv_all(fd, payload, length) < 0) return 0;
+
+    memset(value, 0, 3 * sizeof(uint32_t));
+    for (uint32_t i = 0; i + 4 <= length; i += 4) {
+        value[i / 4] = get32(payload + i);
+    }
+
+    if (type == MSG_ERROR) {
+        fprintf(stderr, "  Board error %u: %s (0x%08X, 0x%08X)\n",
+                value[0], error_name(value[0]), value[1], value[2]);
+    }
+    return type;
+}
+
+//==============================================================================
+// Upload
+//==============================================================================
+
+static int connect_board(const char *ip, int port, int timeout_sec) {
+    struct sockaddr_in addr;
+    struct timeval tv;
+    int fd;
+
+    fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        perror("socket");
+        return -1;
+    }
+
+    tv.tv_sec = timeout_sec;
+    tv.tv_usec = 0;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, ip, &addr.sin_addr) != 1) {
+        fprintf(stderr, "  Invalid address: %s\n", ip);
+        close(fd);
+        return -1;
+    }
+
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        perror("  connect");
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+static int upload(const char *ip, int port, int timeout_sec, const uint8_t *image,
+                  uint32_t size, uint32_t crc, const char *save_name, int execute) {
+    uint8_t start[12 + NAME_MAX_LEN];
+    uint32_t value[3], name_len = 0, sent;
+    struct timeval t0, t1;
+    double secs;
+    int fd;
+
+    printf("%s:\n", ip);
+
+    fd = connect_board(ip, port, timeout_sec);
+    if (fd < 0) return -1;
+
+    if (send_message(fd, MSG_CAPS_REQ, NULL, 0) < 0 ||
+        recv_reply(fd, value) != MSG_CAPS_RESP) {
+        fprintf(stderr, "  No capabilities reply\n");
+        goto fail;
+    }
+    printf("  Slot 0x%08X, %u KB max%s\n", value[0], value[1] / 1024,
+           (value[2] & CAN_SAVE) ? ", SD save available" : "");
+    if (size > value[1]) {
+        fprintf(stderr, "  Image (%u bytes) does not fit\n", size);
+        goto fail;
+    }
+    if (save_name && !(value[2] & CAN_SAVE)) {
+        fprintf(stderr, "  Board has no SD save (build with OVERLAY_TCP_SD=1)\n");
+        goto fail;
+    }
+
+    put32(start, size);
+    put32(start + 4, crc);
+    put32(start + 8, save_name ? FLAG_SAVE : 0);
+    if (save_name) {
+        name_len = (uint32_t)strlen(save_name);
+        memcpy(start + 12, save_name, name_len);
+    }
+    if (send_message(fd, MSG_START, start, 12 + name_len) < 0 ||
+        recv_reply(fd, value) != MSG_ACK) {
+        goto fail;
+    }
+
+    gettimeofday(&t0, NULL);
+    for (sent = 0; sent < size; ) {
+        uint32_t n = (size - sent) > CHUNK_SIZE ? CHUNK_SIZE : (size - sent);
+
+        if (send_message(fd, MSG_DATA, image + sent, n) < 0) {
+            perror("  send");
+            goto fail;
+        }
+        sent += n;
+        printf("\r  Sent %u / %u bytes", sent, size);
+        fflush(stdout);
+    }
+    printf("\n");
+
+    if (send_message(fd, MSG_END, NULL, 0) < 0 || recv_reply(fd, value) != MSG_DONE) {
+        goto fail;
+    }
+    gettimeofday(&t1, NULL);
+    secs = (t1.tv_sec - t0.tv_sec) + (t1.tv_usec - t0.tv_usec) / 1e6;
+
+    printf("  CRC32 0x%08X verified, %.1f KB/s%s\n", value[0],
+           secs > 0 ? size / 1024.0 / secs : 0.0,
+           value[2] ? ", saved to SD" : "");
+
+    if (execute) {
+        if (send_message(fd, MSG_EXEC, NULL, 0) < 0 || recv_reply(fd, value) != MSG_ACK) {
+            goto fail;
+        }
+        printf("  Overlay started\n");
+    }
+
+    close(fd);
+    return 0;
+
+fail:
+    close(fd);
+    return -1;
+}
+
+//==============================================================================
+// Main
+//==============================================================================
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [-p port] [-s name] [-x] [-t seconds] <file.bin> <board_ip> [board_ip...]\n", prog);
+    fprintf(stderr, "  -p <port>      Server port (default: %d)\n", DEFAULT_PORT);
+    fprintf(stderr, "  -s <name>      Save to /OVERLAYS/<name> on SD\n");
+    fprintf(stderr, "  -x             Run the overlay after the upload\n");
+    fprintf(stderr, "  -t <seconds>   Socket timeout (default: %d)\n", DEFAULT_TIMEOUT_SEC);
+}
+
+int main(int argc, char **argv) {
+    int port = DEFAULT_PORT, timeout_sec = DEFAULT_TIMEOUT_SEC, execute = 0;
+    const char *save_name = NULL;
+    uint8_t *image;
+    long size;
+    uint32_t crc;
+    FILE *f;
+    int opt, failed = 0;
+
+    while ((opt = getopt(argc, argv, "p:s:xt:h")) != -1) {
+        switch (opt) {
+            case 'p': port = atoi(optarg); break;
+            case 's': save_name = optarg; break;
+            case 'x': execute = 1; break;
+            case 't': timeout_sec = atoi(optarg); break;
+            default: usage(argv[0]); return 1;
+        }
+    }
+
+    if (argc - optind < 2) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (save_name && (strlen(save_name) > NAME_MAX_LEN || strchr(save_name, '/'))) {
+        fprintf(stderr, "Save name must be at most %d characters, without '/'\n", NAME_MAX_LEN);
+        return 1;
+    }
+
+    f = fopen(argv[optind], "rb");
+    if (!f) {
+        perror(argv[optind]);
+        return 1;
+    }
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (size <= 0) {
+        fprintf(stderr, "%s: empty file\n", argv[optind]);
+        fclose(f);
+        return 1;
+    }
+    image = malloc((size_t)size);
+    if (!image || fread(image, 1, (size_t)size, f) != (size_t)size) {
+        fprintf(stderr, "%s: read failed\n", argv[optind]);
+        fclose(f);
+        return 1;
+    }
+    fclose(f);
+
+    crc = calculate_crc32(image, (uint32_t)size);
+    printf("%s: %ld bytes, CRC32 0x%08X\n", argv[optind], size, crc);
+
+    for (int i = optind + 1; i < argc; i++) {
+        if (upload(argv[i], port, timeout_sec, image, (uint32_t)size, crc, save_name, execute) < 0) {
+            fprintf(stderr, "  FAILED\n");
+            failed++;
+        }
+    }
+
+    free(image);
+
+    if (argc - optind > 2) {
+        printf("%d of %d boards updated\n", argc - optind - 1 - failed, argc - optind - 1);
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,467 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// ovlpack.c - Relocatable Overlay Container Packer
+//
+// Converts an overlay ELF from the overlay SDK into the .ovl container the
+// SD card manager loads (firmware/overlay_sdk/common/overlay_format.h):
+// the loadable image as linked, minus its zero runs and .bss, plus the
+// offsets of every word that holds an address inside the image.
+//
+// Makefile.overlay links with -Wl,-q (--emit-relocs) so the ELF keeps its
+// relocations. Relocated words are:
+//   - R_RISCV_32 against a symbol inside the image (pointers in .data,
+//     .init_array, jump tables)
+//   - every .got entry that points inside the image (the linker fills the
+//     GOT itself, so it has no relocations of its own)
+// R_RISCV_HI20 against the image is absolute addressing (lui) that can't
+// be moved; it is reported and the overlay is rejected.
+//
+// Usage: ovlpack input.elf output.ovl
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "../../firmware/overlay_sdk/common/overlay_format.h"
+
+// A zero run this long ends a segment (shorter ones cost less stored than
+// a segment table entry)
+#define ZERO_RUN_MIN    16
+
+//==============================================================================
+// ELF32 (only what is needed here; <elf.h> is not on every host)
+//==============================================================================
+
+#define EM_RISCV        243
+#define PT_LOAD         1
+#define SHT_SYMTAB      2
+#define SHT_RELA        4
+#define SHT_NOBITS      8
+#define SHF_WRITE       0x1
+#define SHF_ALLOC       0x2
+#define R_RISCV_32      1
+#define R_RISCV_HI20    26
+
+static uint8_t *elf;
+static size_t elf_size;
+
+static uint32_t rd16(size_t off) {
+    return elf[off] | (elf[off + 1] << 8);
+}
+
+static uint32_t rd32(size_t off) {
+    return elf[off] | (elf[off + 1] << 8) | (elf[off + 2] << 16) | ((uint32_t)elf[off + 3] << 24);
+}
+
+typedef struct {
+    uint32_t name, type, flags, addr, offset, size, link, info, entsize;
+} section_t;
+
+typedef struct {
+    uint32_t type, offset, vaddr, paddr, filesz, memsz;
+} phdr_t;
+
+static section_t *sections;
+static uint32_t nsections;
+static phdr_t *phdrs;
+static uint32_t nphdrs;
+static uint32_t shstrtab;
+
+static const char *section_name(const section_t *s) {
+    return (const char *)elf + sections[shstrtab].offset + s->name;
+}
+
+//==============================================================================
+// CRC32 (same as lib/crc32.h)
+//==============================================================================
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t *p, size_t len) {
+    crc = ~crc;
+    while (len--) {
+        crc ^= *p++;
+        for (int k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
+
+//==============================================================================
+// Image
+//==============================================================================
+
+static uint8_t *image;
+static uint32_t base;           // Lowest load address
+static uint32_t file_end;       // End of the stored bytes (flat .bin size)
+static uint32_t mem_end;        // End of .bss
+static uint32_t data_offset;    // First writable byte run in place
+
+static uint32_t *relocs;
+static uint32_t nrelocs;
+
+static int in_image(uint32_t addr) {
+    return addr >= base && addr <= base + mem_end;
+}
+
+// Image offset of the word at run address vaddr (.fastcode/.fastdata run
+// from the scratchpad but are stored in the image); -1 if not stored
+static long vaddr_to_offset(uint32_t vaddr) {
+    for (uint32_t i = 0; i < nphdrs; i++) {
+        const phdr_t *p = &phdrs[i];
+        if (p->type == PT_LOAD && vaddr >= p->vaddr && vaddr + 4 <= p->vaddr + p->filesz) {
+            return (long)(p->paddr - base + (vaddr - p->vaddr));
+        }
+    }
+    return -1;
+}
+
+static void add_reloc(uint32_t off) {
+    for (uint32_t i = 0; i < nrelocs; i++) {
+        if (relocs[i] == off) {
+            return;                         // Also in .got, or listed twice
+        }
+    }
+    relocs[nrelocs++] = off;
+}
+
+static int cmp_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static int load_image(void) {
+    base = UINT32_MAX;
+    for (uint32_t i = 0; i < nphdrs; i++) {
+        if (phdrs[i].type == PT_LOAD && phdrs[i].memsz && phdrs[i].paddr < base) {
+            base = phdrs[i].paddr;
+        }
+    }
+    if (base == UINT32_MAX) {
+        fprintf(stderr, "No loadable segments\n");
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < nphdrs; i++) {
+        const phdr_t *p = &phdrs[i];
+        if (p->type != PT_LOAD || !p->memsz) {
+            continue;
+        }
+        if (p->filesz && p->paddr - base + p->filesz > file_end) {
+            file_end = p->paddr - base + p->filesz;
+        }
+        // .bss counts where it runs; scratchpad sections only where stored
+        uint32_t end = p->paddr - base + (p->vaddr == p->paddr ? p->memsz : p->filesz);
+        if (end > mem_end) {
+            mem_end = end;
+        }
+    }
+    mem_end = (mem_end + 3) & ~3u;
+
+    image = calloc(1, mem_end + 4);
+    relocs = malloc(sizeof(uint32_t) * (mem_end / 4 + 1));
+    if (!image || !relocs) {
+        fprintf(stderr, "Out of memory\n");
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < nphdrs; i++) {
+        const phdr_t *p = &phdrs[i];
+        if (p->type == PT_LOAD && p->filesz) {
+            if ((size_t)p->offset + p->filesz > elf_size) {
+                fprintf(stderr, "Segment past end of file\n");
+                return -1;
+            }
+            memcpy(image + (p->paddr - base), elf + p->offset, p->filesz);
+        }
+    }
+    return 0;
+}
+
+//==============================================================================
+// Relocations
+//==============================================================================
+
+static int scan_relocs(void) {
+    int errors = 0;
+
+    for (uint32_t i = 0; i < nsections; i++) {
+        const section_t *rs = &sections[i];
+        if (rs->type != SHT_RELA || rs->info >= nsections || rs->link >= nsections ||
+            !(sections[rs->info].flags & SHF_ALLOC)) {
+            continue;                       // Debug info and the like
+        }
+        const section_t *symtab = &sections[rs->link];
+
+        for (uint32_t r = 0; r + 12 <= rs->size; r += 12) {
+            uint32_t where = rd32(rs->offset + r);
+            uint32_t info = rd32(rs->offset + r + 4);
+            int32_t addend = (int32_t)rd32(rs->offset + r + 8);
+            uint32_t type = info & 0xFF;
+            uint32_t sym = info >> 8;
+
+            if (type != R_RISCV_32 && type != R_RISCV_HI20) {
+                continue;                   // PC-relative or assembler bookkeeping
+            }
+            if (symtab->type != SHT_SYMTAB || (size_t)sym * 16 + 16 > symtab->size) {
+                fprintf(stderr, "Bad symbol in relocation at 0x%08X\n", where);
+                errors++;
+                continue;
+            }
+            uint32_t value = rd32(symtab->offset + sym * 16 + 4) + addend;
+            if (!in_image(value)) {
+                continue;                   // Stack, heap, scratchpad, MMIO: fixed
+            }
+
+            if (type == R_RISCV_HI20) {
+                fprintf(stderr, "Absolute reference (lui) to 0x%08X at 0x%08X: not PIC\n",
+                        value, where);
+                errors++;
+                continue;
+            }
+
+            long off = vaddr_to_offset(where);
+            if (off < 0 || (off & 3)) {
+                fprintf(stderr, "R_RISCV_32 at 0x%08X outside the stored image\n", where);
+                errors++;
+                continue;
+            }
+            add_reloc((uint32_t)off);
+        }
+    }
+
+    // GOT entries: filled in by the linker, no relocations to find them by
+    for (uint32_t i = 0; i < nsections; i++) {
+        const section_t *s = &sections[i];
+        if (strcmp(section_name(s), ".got") != 0 || s->type == SHT_NOBITS) {
+            continue;
+        }
+        for (uint32_t a = 0; a + 4 <= s->size; a += 4) {
+            long off = vaddr_to_offset(s->addr + a);
+            if (off >= 0) {
+                uint32_t v = image[off] | (image[off + 1] << 8) | (image[off + 2] << 16) |
+                             ((uint32_t)image[off + 3] << 24);
+                if (in_image(v)) {
+                    add_reloc((uint32_t)off);
+                }
+            }
+        }
+    }
+
+    qsort(relocs, nrelocs, sizeof(uint32_t), cmp_u32);
+    return errors ? -1 : 0;
+}
+
+// Lowest stored section the overlay can write where it was loaded (.data,
+// .sdata, .got); .fastdata is written only in the scratchpad
+static void find_data(void) {
+    data_offset = file_end;
+    for (uint32_t i = 0; i < nsections; i++) {
+        const section_t *s = &sections[i];
+        if ((s->flags & (SHF_ALLOC | SHF_WRITE)) == (SHF_ALLOC | SHF_WRITE) &&
+            s->type != SHT_NOBITS && s->size && s->addr >= base &&
+            s->addr - base < data_offset) {
+            data_offset = (s->addr - base) & ~3u;
+        }
+    }
+}
+
+//==============================================================================
+// Segments
+//==============================================================================
+
+static ovl_segment_t segs[OVL_MAX_SEGMENTS];
+static uint32_t nsegs;
+
+// Non-zero runs of the stored image, split at zero runs of at least
+// min_gap bytes; -1 if that needs more than OVL_MAX_SEGMENTS
+static int split_segments(uint32_t min_gap) {
+    uint32_t pos = 0;
+
+    nsegs = 0;
+    while (pos < file_end) {
+        while (pos < file_end && image[pos] == 0) {
+            pos++;
+        }
+        if (pos >= file_end) {
+            break;
+        }
+
+        uint32_t start = pos & ~3u;
+        uint32_t end = pos;
+        uint32_t zeros = 0;
+        while (end + zeros < file_end && zeros < min_gap) {
+            if (image[end + zeros] == 0) {
+                zeros++;
+            } else {
+                end += zeros + 1;
+                zeros = 0;
+            }
+        }
+        end = (end + 3) & ~3u;
+
+        if (nsegs == OVL_MAX_SEGMENTS) {
+            return -1;
+        }
+        segs[nsegs].offset = start;
+        segs[nsegs].size = end - start;
+        nsegs++;
+        pos = end;
+    }
+    return 0;
+}
+
+//==============================================================================
+// Main
+//==============================================================================
+
+static void put_le32(uint8_t *p, uint32_t v) {
+    p[0] = v;
+    p[1] = v >> 8;
+    p[2] = v >> 16;
+    p[3] = v >> 24;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s input.elf output.ovl\n", argv[0]);
+        return 1;
+    }
+
+    FILE *f = fopen(argv[1], "rb");
+    if (!f) {
+        perror(argv[1]);
+        return 1;
+    }
+    fseek(f, 0, SEEK_END);
+    elf_size = (size_t)ftell(f);
+    fseek(f, 0, SEEK_SET);
+    elf = malloc(elf_size);
+    if (!elf || fread(elf, 1, elf_size, f) != elf_size) {
+        perror(argv[1]);
+        return 1;
+    }
+    fclose(f);
+
+    if (elf_size < 52 || memcmp(elf, "\177ELF", 4) != 0 || elf[4] != 1 || elf[5] != 1 ||
+        rd16(18) != EM_RISCV) {
+        fprintf(stderr, "%s: not a 32-bit little-endian RISC-V ELF\n", argv[1]);
+        return 1;
+    }
+
+    uint32_t entry = rd32(24);
+    uint32_t phoff = rd32(28);
+    uint32_t shoff = rd32(32);
+    nphdrs = rd16(44);
+    nsections = rd16(48);
+    shstrtab = rd16(50);
+    if ((size_t)phoff + nphdrs * 32 > elf_size || (size_t)shoff + nsections * 40 > elf_size ||
+        shstrtab >= nsections) {
+        fprintf(stderr, "%s: truncated ELF\n", argv[1]);
+        return 1;
+    }
+
+    phdrs = calloc(nphdrs + 1, sizeof(phdr_t));
+    sections = calloc(nsections + 1, sizeof(section_t));
+    for (uint32_t i = 0; i < nphdrs; i++) {
+        size_t o = phoff + i * 32;
+        phdrs[i] = (phdr_t){ rd32(o), rd32(o + 4), rd32(o + 8), rd32(o + 12),
+                             rd32(o + 16), rd32(o + 20) };
+    }
+    int have_relocs = 0;
+    for (uint32_t i = 0; i < nsections; i++) {
+        size_t o = shoff + i * 40;
+        sections[i] = (section_t){ rd32(o), rd32(o + 4), rd32(o + 8), rd32(o + 12), rd32(o + 16),
+                                   rd32(o + 20), rd32(o + 24), rd32(o + 28), rd32(o + 36) };
+        if (sections[i].type == SHT_RELA && sections[i].offset + sections[i].size > elf_size) {
+            fprintf(stderr, "%s: truncated ELF\n", argv[1]);
+            return 1;
+        }
+        if (sections[i].type == SHT_RELA) {
+            have_relocs = 1;
+        }
+    }
+
+    if (load_image() != 0) {
+        return 1;
+    }
+    if (!have_relocs) {
+        fprintf(stderr, "%s: no relocations (link with -Wl,-q)\n", argv[1]);
+        return 1;
+    }
+    if (scan_relocs() != 0) {
+        return 1;
+    }
+    find_data();
+
+    uint32_t gap = ZERO_RUN_MIN;
+    while (split_segments(gap) != 0) {
+        gap *= 2;
+    }
+
+    // Header, segment table, data, relocations
+    size_t data = 0;
+    for (uint32_t i = 0; i < nsegs; i++) {
+        data += segs[i].size;
+    }
+    size_t total = sizeof(ovl_header_t) + nsegs * sizeof(ovl_segment_t) + data + nrelocs * 4;
+    uint8_t *out = calloc(1, total);
+    if (!out) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    uint8_t *p = out + sizeof(ovl_header_t);
+    for (uint32_t i = 0; i < nsegs; i++, p += 8) {
+        put_le32(p, segs[i].offset);
+        put_le32(p + 4, segs[i].size);
+    }
+    for (uint32_t i = 0; i < nsegs; i++) {
+        memcpy(p, image + segs[i].offset, segs[i].size);
+        p += segs[i].size;
+    }
+    for (uint32_t i = 0; i < nrelocs; i++, p += 4) {
+        put_le32(p, relocs[i]);
+    }
+
+    put_le32(out + 0, OVL_MAGIC);
+    put_le32(out + 4, OVL_VERSION);
+    put_le32(out + 8, base);
+    put_le32(out + 12, mem_end);
+    put_le32(out + 16, entry - base);
+    put_le32(out + 20, nsegs);
+    put_le32(out + 24, nrelocs);
+    put_le32(out + 28, file_end);
+    put_le32(out + 32, data_offset);
+    put_le32(out + 36, crc32_update(0, out + sizeof(ovl_header_t), total - sizeof(ovl_header_t)));
+    put_le32(out + 40, crc32_update(0, out, 40));
+
+    f = fopen(argv[2], "wb");
+    if (!f || fwrite(out, 1, total, f) != total || fclose(f) != 0) {
+        perror(argv[2]);
+        return 1;
+    }
+
+    long saved = (long)file_end - (long)total;
+    printf("%s: flat %u -> %zu bytes (%s%ld, %.1f%%), %u segments, %u relocations, "
+           "%u bytes zero filled, %u writable\n",
+           argv[2], file_end, total, saved >= 0 ? "saved " : "grew ", labs(saved),
+           file_end ? 100.0 * saved / file_end : 0.0, nsegs, nrelocs, mem_end - (uint32_t)data,
+           file_end - data_offset);
+
+    free(out);
+    free(image);
+    free(relocs);
+    free(phdrs);
+    free(sections);
+    free(elf);
+    return 0;
+}
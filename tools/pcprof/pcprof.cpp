@@ -0,0 +1,225 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// pcprof.cpp - Statistical Profile from PC Sampler Captures
+//
+// Reads the "PCS <hex>" lines firmware prints after draining the hardware
+// PC sampler (hdl/pc_sampler.v, lib/pc_sampler.h) from a UART capture,
+// looks every address up in the firmware's ELF symbols and prints the
+// flat per-function histogram. The samples come from the real board, so
+// unlike the rvsim profile this includes the SD card, the UART and the
+// actual cache behaviour.
+//
+// Other lines of the capture are ignored. "PCS begin interval=<n>" (as
+// algo_test P prints it) gives the cycles per sample, for a cycle
+// estimate per function. Overlays add symbols with -s elf@addr, as in
+// rvsim.
+//
+// Usage: pcprof [options] <firmware.elf> [capture.log]   (stdin if none)
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../rvsim/elf_image.h"
+
+static void print_usage(const char *prog) {
+    fprintf(stderr, "PC sampler profile (hdl/pc_sampler.v captures)\n\n");
+    fprintf(stderr, "Usage: %s [options] <firmware.elf> [capture.log]\n\n", prog);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "  -s, --symbols <elf>[@addr]  More symbols, e.g. an overlay (at addr)\n");
+    fprintf(stderr, "  -N, --top <n>           Functions listed (default 40, 0: all)\n");
+    fprintf(stderr, "  -a, --addresses <n>     Also list the n hottest addresses\n");
+    fprintf(stderr, "  -i, --interval <n>      Cycles per sample (default: from the capture)\n");
+    fprintf(stderr, "  -h, --help              Show this help\n\n");
+    fprintf(stderr, "The capture is read from stdin without a file. Example:\n");
+    fprintf(stderr, "  %s -a 20 firmware/algo_test.elf algo_test.log\n", prog);
+}
+
+// "PCS xxxxxxxx" (exactly 8 hex digits); "PCS begin interval=<n>" sets interval
+static bool parse_line(const char *line, uint32_t &addr, uint64_t &interval) {
+    const char *p = strstr(line, "PCS ");
+    if (!p)
+        return false;
+    p += 4;
+
+    const char *iv = strstr(p, "interval=");
+    if (strncmp(p, "begin", 5) == 0 && iv) {
+        interval = strtoull(iv + 9, NULL, 10);
+        return false;
+    }
+
+    for (int i = 0; i < 8; i++)
+        if (!isxdigit((unsigned char)p[i]))
+            return false;
+    if (p[8] && !isspace((unsigned char)p[8]))
+        return false;
+    addr = (uint32_t)strtoul(std::string(p, 8).c_str(), NULL, 16);
+    return true;
+}
+
+static bool load_symbols(const std::string &spec, bool first, SymbolTable &syms) {
+    std::string path = spec;
+    uint32_t base = 0;
+    bool rebase = false;
+    size_t at = spec.rfind('@');
+    if (!first && at != std::string::npos) {
+        path = spec.substr(0, at);
+        base = (uint32_t)strtoul(spec.c_str() + at + 1, NULL, 0);
+        rebase = true;
+    }
+    std::vector<uint8_t> elf;
+    std::string e = file_read(path.c_str(), elf);
+    if (e.empty() && (!elf_is_elf(elf) || !elf_check(elf).empty()))
+        e = "not a RISC-V ELF";
+    if (!e.empty()) {
+        fprintf(stderr, "[PCPROF] ERROR: %s: %s\n", path.c_str(), e.c_str());
+        return false;
+    }
+    uint32_t offset = rebase ? base - elf_link_base(elf) : 0;
+    int n = elf_symbols(elf, offset, syms);
+    fprintf(stderr, "[PCPROF] %d symbols from %s\n", n, path.c_str());
+    return true;
+}
+
+int main(int argc, char **argv) {
+    const char *firmware = NULL;
+    const char *capture = NULL;
+    std::vector<std::string> extra_syms;
+    size_t top_n = 40;
+    size_t top_addr = 0;
+    uint64_t interval = 0;
+    bool interval_set = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        bool has_arg = i + 1 < argc;
+        if (strcmp(a, "-s") == 0 || strcmp(a, "--symbols") == 0) {
+            if (!has_arg) { print_usage(argv[0]); return 1; }
+            extra_syms.push_back(argv[++i]);
+        } else if (strcmp(a, "-N") == 0 || strcmp(a, "--top") == 0) {
+            if (!has_arg) { print_usage(argv[0]); return 1; }
+            top_n = strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(a, "-a") == 0 || strcmp(a, "--addresses") == 0) {
+            if (!has_arg) { print_usage(argv[0]); return 1; }
+            top_addr = strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(a, "-i") == 0 || strcmp(a, "--interval") == 0) {
+            if (!has_arg) { print_usage(argv[0]); return 1; }
+            interval = strtoull(argv[++i], NULL, 0);
+            interval_set = true;
+        } else if (strcmp(a, "-h") == 0 || strcmp(a, "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else if (!firmware) {
+            firmware = a;
+        } else {
+            capture = a;
+        }
+    }
+
+    if (!firmware) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    SymbolTable syms;
+    if (!load_symbols(firmware, true, syms))
+        return 1;
+    for (const std::string &spec : extra_syms)
+        if (!load_symbols(spec, false, syms))
+            return 1;
+    syms.finish();
+
+    FILE *in = stdin;
+    if (capture && strcmp(capture, "-") != 0) {
+        in = fopen(capture, "r");
+        if (!in) {
+            fprintf(stderr, "[PCPROF] ERROR: cannot open %s\n", capture);
+            return 1;
+        }
+    }
+
+    // Samples per address; a capture may hold several runs, all are summed
+    std::map<uint32_t, uint64_t> per_addr;
+    uint64_t total = 0;
+    char line[512];
+    while (fgets(line, sizeof(line), in)) {
+        uint32_t addr;
+        uint64_t iv = interval;
+        if (parse_line(line, addr, iv)) {
+            per_addr[addr]++;
+            total++;
+        } else if (!interval_set) {
+            interval = iv;
+        }
+    }
+    if (in != stdin)
+        fclose(in);
+
+    if (total == 0) {
+        fprintf(stderr, "[PCPROF] ERROR: no PCS samples in %s\n", capture ? capture : "stdin");
+        return 1;
+    }
+
+    // Per function (symbol index; -1: no symbol)
+    std::map<int, uint64_t> per_func;
+    for (const auto &kv : per_addr)
+        per_func[syms.lookup(kv.first)] += kv.second;
+
+    struct Row { int sym; uint64_t n; };
+    std::vector<Row> rows;
+    for (const auto &kv : per_func)
+        rows.push_back({ kv.first, kv.second });
+    std::stable_sort(rows.begin(), rows.end(), [](const Row &a, const Row &b) { return a.n > b.n; });
+
+    auto name = [&](int s) { return s < 0 ? std::string("(no symbol)") : syms.at(s).name; };
+
+    printf("%llu samples", (unsigned long long)total);
+    if (interval)
+        printf(", one per %llu cycles (~%llu cycles sampled)", (unsigned long long)interval,
+               (unsigned long long)(total * interval));
+    printf("\n\n");
+
+    printf("%9s %7s %7s %14s  %s\n", "Samples", "%", "Cum %", interval ? "~Cycles" : "", "Function");
+    uint64_t cum = 0;
+    for (size_t i = 0; i < rows.size() && (top_n == 0 || i < top_n); i++) {
+        cum += rows[i].n;
+        char cyc[24] = "";
+        if (interval)
+            snprintf(cyc, sizeof(cyc), "%llu", (unsigned long long)(rows[i].n * interval));
+        printf("%9llu %6.2f%% %6.2f%% %14s  %s\n", (unsigned long long)rows[i].n,
+               100.0 * rows[i].n / total, 100.0 * cum / total, cyc, name(rows[i].sym).c_str());
+    }
+    if (top_n && rows.size() > top_n)
+        printf("%9s  ... %zu more functions (-N 0 lists all)\n", "", rows.size() - top_n);
+
+    if (top_addr) {
+        std::vector<std::pair<uint32_t, uint64_t>> addrs(per_addr.begin(), per_addr.end());
+        std::stable_sort(addrs.begin(), addrs.end(),
+                         [](const std::pair<uint32_t, uint64_t> &a, const std::pair<uint32_t, uint64_t> &b) {
+                             return a.second > b.second;
+                         });
+        printf("\n%9s %7s  %-10s  %s\n", "Samples", "%", "Address", "Function+offset");
+        for (size_t i = 0; i < addrs.size() && i < top_addr; i++) {
+            int s = syms.lookup(addrs[i].first);
+            printf("%9llu %6.2f%%  0x%08x  %s", (unsigned long long)addrs[i].second,
+                   100.0 * addrs[i].second / total, addrs[i].first, name(s).c_str());
+            if (s >= 0)
+                printf("+0x%x", addrs[i].first - syms.at(s).addr);
+            printf("\n");
+        }
+    }
+
+    return 0;
+}
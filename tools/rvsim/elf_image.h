@@ -0,0 +1,266 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// elf_image.h - rvsim Firmware Loader and Symbol Table
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+//
+// Loads the PT_LOAD segments of an ELF32 RISC-V executable at their
+// physical address (p_paddr), as sim/verilator/elf_loader.h does:
+// .fastcode/.fastdata land at their SRAM load address and start.S copies
+// them to the scratchpad, .fastbss (no file data) is left to start.S.
+// A file without the ELF magic is a raw image of SRAM from 0x0.
+//
+// Function symbols (STT_FUNC, plus assembly labels in code sections) feed
+// the profiler. Overlays add theirs with a base: an overlay linked for
+// 0x60000 and relocated elsewhere is profiled with -s overlay.elf@<addr>.
+//
+//==============================================================================
+
+#ifndef RVSIM_ELF_IMAGE_H
+#define RVSIM_ELF_IMAGE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct LoadInfo {
+    uint32_t entry = 0;
+    uint32_t bytes = 0;         // Bytes written (file data + zero fill)
+    uint32_t top = 0;           // Highest address written + 1
+};
+
+struct Symbol {
+    uint32_t    addr;
+    uint32_t    size;           // 0: up to the next symbol
+    uint32_t    limit;          // End of the symbol's section
+    std::string name;
+};
+
+class SymbolTable {
+public:
+    void add(uint32_t addr, uint32_t size, uint32_t limit, const std::string &name) {
+        syms_.push_back({ addr, size, limit, name });
+    }
+
+    // Sort, drop duplicates at one address (first name wins) and give
+    // sizeless labels the room up to the next symbol or their section end
+    void finish() {
+        std::stable_sort(syms_.begin(), syms_.end(),
+                         [](const Symbol &a, const Symbol &b) { return a.addr < b.addr; });
+        std::vector<Symbol> out;
+        for (const Symbol &s : syms_) {
+            if (!out.empty() && out.back().addr == s.addr) {
+                if (out.back().size == 0)
+                    out.back().size = s.size;
+                continue;
+            }
+            out.push_back(s);
+        }
+        for (size_t i = 0; i < out.size(); i++) {
+            if (out[i].size == 0) {
+                uint32_t end = out[i].limit;
+                if (i + 1 < out.size() && out[i + 1].addr < end)
+                    end = out[i + 1].addr;
+                out[i].size = end > out[i].addr ? end - out[i].addr : 4;
+            }
+        }
+        syms_.swap(out);
+    }
+
+    // Index of the symbol containing addr, or -1
+    int lookup(uint32_t addr) const {
+        auto it = std::upper_bound(syms_.begin(), syms_.end(), addr,
+                                   [](uint32_t a, const Symbol &s) { return a < s.addr; });
+        if (it == syms_.begin())
+            return -1;
+        --it;
+        if (addr - it->addr >= it->size)
+            return -1;
+        return (int)(it - syms_.begin());
+    }
+
+    int find(const std::string &name) const {
+        for (size_t i = 0; i < syms_.size(); i++)
+            if (syms_[i].name == name)
+                return (int)i;
+        return -1;
+    }
+
+    const Symbol &at(int i) const { return syms_[i]; }
+    size_t size() const { return syms_.size(); }
+
+private:
+    std::vector<Symbol> syms_;
+};
+
+static inline uint32_t elf_rd16(const uint8_t *p) { return p[0] | (p[1] << 8); }
+static inline uint32_t elf_rd32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline std::string file_read(const char *path, std::vector<uint8_t> &img) {
+    FILE *f = std::fopen(path, "rb");
+    if (!f)
+        return std::string("cannot open ") + path;
+    uint8_t chunk[65536];
+    size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), f)) > 0)
+        img.insert(img.end(), chunk, chunk + n);
+    std::fclose(f);
+    return "";
+}
+
+static inline bool elf_is_elf(const std::vector<uint8_t> &img) {
+    return img.size() >= 4 && std::memcmp(img.data(), "\x7f" "ELF", 4) == 0;
+}
+
+static inline std::string elf_check(const std::vector<uint8_t> &img) {
+    if (img.size() < 52 || img[4] != 1 || img[5] != 1)
+        return "not a 32-bit little-endian ELF";
+    if (elf_rd16(&img[18]) != 243)
+        return "not a RISC-V ELF";
+    return "";
+}
+
+// Mem needs bool poke(uint32_t addr, uint8_t value): false when unmapped.
+// Returns an empty string on success, else what went wrong.
+template <class Mem>
+static std::string firmware_load(const std::vector<uint8_t> &img, Mem &mem, LoadInfo &info) {
+    // Raw binary: image of SRAM from address 0
+    if (!elf_is_elf(img)) {
+        for (size_t i = 0; i < img.size(); i++)
+            if (!mem.poke((uint32_t)i, img[i]))
+                return "binary larger than SRAM";
+        info.entry = 0;
+        info.bytes = info.top = (uint32_t)img.size();
+        return "";
+    }
+
+    std::string err = elf_check(img);
+    if (!err.empty())
+        return err;
+    if (elf_rd16(&img[16]) != 2)
+        return "not an executable ELF";
+
+    uint32_t phoff = elf_rd32(&img[28]);
+    uint32_t phentsize = elf_rd16(&img[42]);
+    uint32_t phnum = elf_rd16(&img[44]);
+    info.entry = elf_rd32(&img[24]);
+
+    for (uint32_t i = 0; i < phnum; i++) {
+        size_t ph = (size_t)phoff + (size_t)i * phentsize;
+        if (ph + 32 > img.size())
+            return "truncated program header table";
+
+        uint32_t type   = elf_rd32(&img[ph + 0]);
+        uint32_t offset = elf_rd32(&img[ph + 4]);
+        uint32_t paddr  = elf_rd32(&img[ph + 12]);
+        uint32_t filesz = elf_rd32(&img[ph + 16]);
+        uint32_t memsz  = elf_rd32(&img[ph + 20]);
+
+        if (type != 1 || memsz == 0)            // PT_LOAD only
+            continue;
+        if (filesz == 0)                        // .bss/.fastbss: start.S clears it
+            continue;
+        if ((uint64_t)offset + filesz > img.size())
+            return "segment past end of file";
+
+        for (uint32_t j = 0; j < memsz; j++) {
+            if (!mem.poke(paddr + j, j < filesz ? img[offset + j] : 0)) {
+                char msg[96];
+                std::snprintf(msg, sizeof(msg), "segment 0x%08x+0x%x outside memory", paddr, memsz);
+                return msg;
+            }
+        }
+        info.bytes += memsz;
+        if (paddr + memsz > info.top)
+            info.top = paddr + memsz;
+    }
+
+    if (info.bytes == 0)
+        return "no loadable segments";
+    return "";
+}
+
+// Lowest virtual address of an executable PT_LOAD segment (link base)
+static inline uint32_t elf_link_base(const std::vector<uint8_t> &img) {
+    uint32_t phoff = elf_rd32(&img[28]);
+    uint32_t phentsize = elf_rd16(&img[42]);
+    uint32_t phnum = elf_rd16(&img[44]);
+    uint32_t base = 0xFFFFFFFF;
+
+    for (uint32_t i = 0; i < phnum; i++) {
+        size_t ph = (size_t)phoff + (size_t)i * phentsize;
+        if (ph + 32 > img.size())
+            break;
+        if (elf_rd32(&img[ph]) == 1 && (elf_rd32(&img[ph + 24]) & 1))  // PF_X
+            base = std::min(base, elf_rd32(&img[ph + 8]));
+    }
+    return base == 0xFFFFFFFF ? 0 : base;
+}
+
+// Function symbols of .symtab, shifted by offset. Returns how many.
+static inline int elf_symbols(const std::vector<uint8_t> &img, uint32_t offset, SymbolTable &table) {
+    if (!elf_is_elf(img) || !elf_check(img).empty())
+        return 0;
+
+    uint32_t shoff = elf_rd32(&img[32]);
+    uint32_t shentsize = elf_rd16(&img[46]);
+    uint32_t shnum = elf_rd16(&img[48]);
+    if (shoff == 0 || (uint64_t)shoff + (uint64_t)shnum * shentsize > img.size())
+        return 0;
+
+    auto sh = [&](uint32_t i) { return &img[shoff + i * shentsize]; };
+    int count = 0;
+
+    for (uint32_t i = 0; i < shnum; i++) {
+        if (elf_rd32(sh(i) + 4) != 2)           // SHT_SYMTAB
+            continue;
+        uint32_t off = elf_rd32(sh(i) + 16);
+        uint32_t size = elf_rd32(sh(i) + 20);
+        uint32_t link = elf_rd32(sh(i) + 24);
+        uint32_t entsize = elf_rd32(sh(i) + 36);
+        if (link >= shnum || entsize < 16 || (uint64_t)off + size > img.size())
+            continue;
+        uint32_t stroff = elf_rd32(sh(link) + 16);
+        uint32_t strsize = elf_rd32(sh(link) + 20);
+
+        for (uint32_t s = off; s + 16 <= off + size; s += entsize) {
+            uint32_t name = elf_rd32(&img[s + 0]);
+            uint32_t value = elf_rd32(&img[s + 4]);
+            uint32_t ssize = elf_rd32(&img[s + 8]);
+            uint8_t info = img[s + 12];
+            uint32_t shndx = elf_rd16(&img[s + 14]);
+            uint8_t type = info & 0xF;
+            uint8_t bind = info >> 4;
+
+            if (shndx == 0 || shndx >= shnum || name >= strsize)
+                continue;
+            // Code sections only (SHF_EXECINSTR)
+            if (!(elf_rd32(sh(shndx) + 8) & 0x4))
+                continue;
+
+            const char *str = (const char *)&img[stroff + name];
+            size_t len = strnlen(str, strsize - name);
+            std::string n(str, len);
+
+            // Functions, and global assembly labels (irq_vec, _start)
+            if (type == 2 || (type == 0 && bind != 0 && !n.empty() && n[0] != '$')) {
+                uint32_t sec_end = elf_rd32(sh(shndx) + 12) + elf_rd32(sh(shndx) + 20);
+                table.add(value + offset, ssize, sec_end + offset, n);
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+#endif // RVSIM_ELF_IMAGE_H
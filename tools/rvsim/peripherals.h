@@ -0,0 +1,851 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// peripherals.h - rvsim MMIO Peripheral Models
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+//
+// Register-level models of the hdl/ peripherals firmware touches, timed in
+// system clocks:
+//
+//   UartModel    uart_peripheral.v: TX FIFO draining at the baud rate set
+//                in BAUD (stores stall when it is full), RX bytes arriving
+//                one character time apart, IRQ[4]/IRQ[5] levels
+//   TimerModel   timer_peripheral.v: PSC/ARR down-counter, CCR compare,
+//                IRQ pulse on underflow (channel 0 IRQ[0], 1-3 IRQ[7])
+//   SpiModel     spi_master.v + spi_dma.v: byte mode, FIFO burst mode,
+//                SPI_RX_REPEAT, hardware CRC16/CRC7, DMA to SRAM; every
+//                byte goes through the SdCard model
+//   MemDmaModel  mem_dma.v copy / fill / checksum
+//   Crc32Model   crc32_accel.v
+//   AtomicModel  atomic_unit.v (Kconfig ATOMIC_UNIT)
+//   IrqcModel    irq_controller.v ENABLE/PENDING/PRIORITY/CLAIM
+//
+// Nothing runs per clock: each model keeps the time its state was last
+// brought up to date and catches up when it is accessed, and next_event()
+// tells the SoC when it next raises an interrupt. Data moves at the start
+// of a transfer (SPI and DMA write SRAM at once), only the busy flags and
+// FIFO levels follow the clock.
+//
+//==============================================================================
+
+#ifndef RVSIM_PERIPHERALS_H
+#define RVSIM_PERIPHERALS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "sd_card.h"
+
+static const uint64_t NEVER = ~0ull;
+
+//==============================================================================
+// UART (0x80000000-0x8000000F, IRQ 0x80000120-0x8000012F, baud 0x80000130)
+//==============================================================================
+
+class UartModel {
+public:
+    UartModel(uint32_t clk_hz, uint32_t rx_depth)
+        : clk_hz_(clk_hz), rx_depth_(rx_depth) {
+        // Reset rate: 1 Mbaud, 16x oversampling (ice40_picorv32_top.v)
+        baud_div_ = (uint32_t)(((uint64_t)clk_hz / 1000 * 256) / (1000 * 16));
+        os_rate_ = 16;
+        idle_timeout_ = 1000;                   // IDLE_CYCLES
+        rx_watermark_ = rx_depth / 2;
+        tx_watermark_ = TX_DEPTH / 4;
+    }
+
+    // Host side
+    void send(uint8_t c, uint64_t now) {
+        uint64_t t = std::max(now, rx_last_arrival_) + char_clocks();
+        rx_line_.push_back({ t, c });
+        rx_last_arrival_ = t;
+    }
+    bool rx_line_idle() const { return rx_line_.empty(); }
+    std::string tx_out;                         // Characters sent, for the caller to drain
+
+    uint32_t read(uint32_t addr, uint64_t now) {
+        update(now);
+        switch (addr) {
+            case 0x80000004: {                  // TX_STATUS
+                uint32_t level = tx_level(now);
+                return 0x80000000u | ((TX_DEPTH - level) << 16) |
+                       ((level != 0) ? 2 : 0) | ((level >= TX_DEPTH) ? 1 : 0);
+            }
+            case 0x80000008: {                  // RX_DATA
+                if (rx_fifo_.empty())
+                    return 0;
+                uint8_t c = rx_fifo_.front();
+                rx_fifo_.pop_front();
+                if (rx_fifo_.empty())
+                    rx_idle_ = false;
+                return c;
+            }
+            case 0x8000000C:                    // RX_STATUS
+                return (uint32_t)rx_ovf_cnt_ << 8 | (rx_ovf_cnt_ ? 2 : 0) |
+                       (rx_fifo_.empty() ? 0 : 1);
+            case 0x80000120: return irq_en_;
+            case 0x80000124: return (uint32_t)rx_fifo_.size() << 16 | irq_stat(now);
+            case 0x80000128: return tx_watermark_ << 16 | rx_watermark_;
+            case 0x8000012C: return idle_timeout_;
+            case 0x80000130: return (uint32_t)os_rate_ << 24 | baud_div_;
+            case 0x80000134: return clk_hz_;
+            default:         return 0;
+        }
+    }
+
+    // Returns the clocks the store stalled for (TX FIFO full)
+    uint64_t write(uint32_t addr, uint32_t data, uint32_t wstrb, uint64_t now) {
+        update(now);
+        uint64_t t = now;
+        switch (addr) {
+            case 0x80000000:                    // TX_DATA: one byte
+                if (wstrb & 1)
+                    t = tx_push((uint8_t)data, t);
+                break;
+            case 0x80000004:                    // TX_WORD: every enabled lane, lane 0 first
+                for (int lane = 0; lane < 4; lane++)
+                    if (wstrb & (1u << lane))
+                        t = tx_push((uint8_t)(data >> (8 * lane)), t);
+                break;
+            case 0x8000000C:                    // RX_STATUS: clear the counters
+                rx_ovf_cnt_ = 0;
+                break;
+            case 0x80000120:
+                if (wstrb & 1) irq_en_ = data & 0xF;
+                break;
+            case 0x80000124:
+                if ((wstrb & 1) && (data & 4)) rx_idle_ = false;
+                break;
+            case 0x80000128:
+                if (wstrb == 0xF) {
+                    rx_watermark_ = data & 0x3FF;
+                    tx_watermark_ = (data >> 16) & 0x3FF;
+                }
+                break;
+            case 0x8000012C:
+                if (wstrb == 0xF) idle_timeout_ = data & 0xFFFFFF;
+                break;
+            case 0x80000130: {                  // BAUD: ignored unless div >= 2.0, os 4-16
+                uint32_t div = data & 0xFFFFFF, os = (data >> 24) & 0x1F;
+                if (wstrb == 0xF && div >= 512 && os >= 4 && os <= 16) {
+                    baud_div_ = div;
+                    os_rate_ = os;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+        return t - now;
+    }
+
+    // IRQ[4] (RX) and IRQ[5] (TX) levels
+    uint32_t irq_levels(uint64_t now) {
+        update(now);
+        uint32_t stat = irq_stat(now);
+        return ((stat & irq_en_ & 7) ? 0x10 : 0) | ((stat & irq_en_ & 8) ? 0x20 : 0);
+    }
+
+    uint64_t next_event(uint64_t now) const {
+        uint64_t t = rx_line_.empty() ? NEVER : rx_line_.front().first;
+        if ((irq_en_ & 4) && !rx_idle_ && !rx_fifo_.empty() && idle_timeout_)
+            t = std::min(t, rx_last_rx_ + idle_timeout_);
+        if ((irq_en_ & 8) && tx_level(now) > tx_watermark_)
+            t = std::min(t, tx_end_ - (uint64_t)tx_watermark_ * char_clocks());
+        return t;
+    }
+
+    uint64_t stall_clocks = 0;
+
+private:
+    static const uint32_t TX_DEPTH = 512;       // UART_TX_FIFO_BITS = 9
+
+    uint32_t clk_hz_;
+    uint32_t rx_depth_;
+    uint32_t baud_div_;                         // Clocks per oversampling tick, 16.8
+    uint32_t os_rate_;
+
+    uint64_t tx_end_ = 0;                       // Last queued character leaves the wire
+    std::deque<std::pair<uint64_t, uint8_t>> rx_line_;
+    uint64_t rx_last_arrival_ = 0;
+    uint64_t rx_last_rx_ = 0;
+    std::deque<uint8_t> rx_fifo_;
+    uint32_t rx_ovf_cnt_ = 0;
+    bool rx_idle_ = false;
+
+    uint32_t irq_en_ = 0;
+    uint32_t rx_watermark_, tx_watermark_;
+    uint32_t idle_timeout_;
+
+    uint64_t char_clocks() const {              // Start + 8 data + stop
+        return (uint64_t)baud_div_ * os_rate_ * 10 / 256;
+    }
+
+    uint32_t tx_level(uint64_t now) const {
+        if (tx_end_ <= now)
+            return 0;
+        uint64_t c = char_clocks();
+        return (uint32_t)((tx_end_ - now + c - 1) / c);
+    }
+
+    uint64_t tx_push(uint8_t c, uint64_t t) {
+        // Full FIFO: the store waits until a character has left
+        if (tx_level(t) >= TX_DEPTH) {
+            uint64_t until = tx_end_ - (uint64_t)(TX_DEPTH - 1) * char_clocks();
+            stall_clocks += until - t;
+            t = until;
+        }
+        tx_end_ = std::max(tx_end_, t) + char_clocks();
+        tx_out += (char)c;
+        return t;
+    }
+
+    void update(uint64_t now) {
+        while (!rx_line_.empty() && rx_line_.front().first <= now) {
+            if (rx_fifo_.size() < rx_depth_)
+                rx_fifo_.push_back(rx_line_.front().second);
+            else if (rx_ovf_cnt_ < 0xFFF)
+                rx_ovf_cnt_++;
+            rx_last_rx_ = rx_line_.front().first;
+            rx_line_.pop_front();
+        }
+        if (!rx_fifo_.empty() && idle_timeout_ && now - rx_last_rx_ >= idle_timeout_)
+            rx_idle_ = true;
+    }
+
+    uint32_t irq_stat(uint64_t now) const {
+        return (tx_level(now) <= tx_watermark_ ? 8 : 0) | (rx_idle_ ? 4 : 0) |
+               (rx_fifo_.size() >= rx_watermark_ ? 2 : 0) | (rx_fifo_.empty() ? 0 : 1);
+    }
+};
+
+//==============================================================================
+// Timer channel (0x80000020; channels 1-3 at 0x80000160/0x180/0x1A0)
+//==============================================================================
+
+class TimerModel {
+public:
+    uint32_t read(uint32_t off, uint64_t now) {
+        update(now);
+        switch (off & 0x1C) {
+            case 0x00: return (capture_ ? 0x20 : 0) | (ccie_ ? 0x10 : 0) |
+                              (one_shot_ ? 2 : 0) | (enable_ ? 1 : 0);
+            case 0x04: return (ccif_ ? 2 : 0) | (uif_ ? 1 : 0);
+            case 0x08: return psc_;
+            case 0x0C: return arr_;
+            case 0x10: return cnt_;
+            case 0x14: return ccr_;
+            default:   return 0;
+        }
+    }
+
+    void write(uint32_t off, uint32_t data, uint32_t wstrb, uint64_t now) {
+        update(now);
+        uint32_t mask = lane_mask(wstrb);
+        switch (off & 0x1C) {
+            case 0x00:
+                if (wstrb & 1) {
+                    // Enabling loads the counter with ARR
+                    if ((data & 1) && !enable_) {
+                        cnt_ = arr_;
+                        psc_cnt_ = psc_;
+                    }
+                    enable_ = data & 1;
+                    one_shot_ = data & 2;
+                    ccie_ = data & 0x10;
+                    capture_ = data & 0x20;
+                }
+                break;
+            case 0x04:                          // Write 1 to clear
+                if (wstrb & 1) {
+                    if (data & 1) uif_ = false;
+                    if (data & 2) ccif_ = false;
+                }
+                break;
+            case 0x08: psc_ = (psc_ & ~mask & 0xFFFF) | (data & mask & 0xFFFF); break;
+            case 0x0C: arr_ = (arr_ & ~mask) | (data & mask); break;
+            case 0x14: ccr_ = (ccr_ & ~mask) | (data & mask); break;
+            default:   break;
+        }
+    }
+
+    // Catch up to now; returns true when an IRQ pulse happened on the way
+    bool update(uint64_t now) {
+        bool irq = false;
+        if (!enable_) {
+            last_ = now;
+            return false;
+        }
+        const uint64_t period = (uint64_t)psc_ + 1;
+
+        while (enable_ && last_ < now) {
+            uint64_t elapsed = now - last_;
+            if (elapsed <= psc_cnt_) {
+                psc_cnt_ -= (uint32_t)elapsed;
+                last_ = now;
+                break;
+            }
+
+            // Prescaler tick
+            last_ += (uint64_t)psc_cnt_ + 1;
+            psc_cnt_ = psc_;
+            if (!capture_ && cnt_ == ccr_) {
+                ccif_ = true;
+                if (ccie_) irq = true;
+            }
+            if (cnt_ == 0) {
+                irq = true;
+                uif_ = true;
+                cnt_ = arr_;
+                if (one_shot_)
+                    enable_ = false;
+                continue;
+            }
+            cnt_--;
+
+            // Skip whole ticks up to the next compare or underflow
+            uint64_t quiet = (!capture_ && ccr_ <= cnt_) ? cnt_ - ccr_ : cnt_;
+            uint64_t skip = std::min(quiet, (now - last_) / period);
+            last_ += skip * period;
+            cnt_ -= (uint32_t)skip;
+        }
+        return irq;
+    }
+
+    uint64_t next_event() const {
+        if (!enable_)
+            return NEVER;
+        uint64_t period = (uint64_t)psc_ + 1;
+        uint64_t first = last_ + psc_cnt_ + 1;   // Next prescaler tick
+        uint64_t t = first + (uint64_t)cnt_ * period;
+        if (ccie_ && !capture_ && ccr_ <= cnt_)
+            t = std::min(t, first + (uint64_t)(cnt_ - ccr_) * period);
+        return t;
+    }
+
+private:
+    bool     enable_ = false, one_shot_ = false, ccie_ = false, capture_ = false;
+    bool     uif_ = false, ccif_ = false;
+    uint32_t psc_ = 0, arr_ = 0, cnt_ = 0, ccr_ = 0;
+    uint32_t psc_cnt_ = 0;
+    uint64_t last_ = 0;                         // Clock the state above belongs to
+
+    static uint32_t lane_mask(uint32_t wstrb) {
+        return ((wstrb & 1) ? 0x000000FFu : 0) | ((wstrb & 2) ? 0x0000FF00u : 0) |
+               ((wstrb & 4) ? 0x00FF0000u : 0) | ((wstrb & 8) ? 0xFF000000u : 0);
+    }
+};
+
+//==============================================================================
+// SPI master (0x80000050), FIFO (0xC0), DMA (0xD0), CRC (0xE0)
+//==============================================================================
+
+class SpiModel {
+public:
+    SpiModel(SdCard &card, std::vector<uint8_t> &sram, uint32_t clk_hz, uint32_t fifo_words, bool hw_crc)
+        : card_(card), sram_(sram), clk_hz_(clk_hz), fifo_words_(fifo_words), hw_crc_(hw_crc) {}
+
+    uint32_t read(uint32_t addr, uint64_t &now) {
+        switch (addr) {
+            case 0x80000050: return ctrl_;
+            case 0x80000054: return rx_data_;
+            case 0x80000058: return busy(now) ? 1 : 2;
+            case 0x8000005C: return cs_;
+            case 0x800000C0: {                  // FIFO_DATA: stalls until the word is in
+                if (rx_fifo_.empty())
+                    return 0;
+                if (rx_fifo_.front().first > now) {
+                    stall_clocks += rx_fifo_.front().first - now;
+                    now = rx_fifo_.front().first;
+                }
+                uint32_t w = rx_fifo_.front().second;
+                rx_fifo_.pop_front();
+                return w;
+            }
+            case 0x800000C4: return capture_ ? 1 : 0;
+            case 0x800000C8: {
+                uint32_t rx = 0;
+                for (auto &e : rx_fifo_)
+                    if (e.first <= now) rx++;
+                uint64_t left = busy_until_ > now ? busy_until_ - now : 0;
+                uint32_t tx = (uint32_t)std::min<uint64_t>(left / (4 * byte_clocks()), fifo_words_);
+                return rx << 16 | tx;
+            }
+            case 0x800000D0: return dma_addr_;
+            case 0x800000D4: return dma_len_;
+            case 0x800000D8: {
+                bool run = dma_end_ > now;
+                return (run ? 1 : 0) | (dma_tx_ ? 2 : 0) | (dma_irq_ ? 4 : 0) |
+                       (!run && dma_done_ ? 8 : 0);
+            }
+            case 0x800000E0: return (hw_crc_ ? 0x80000000u : 0) | (crc_en_ ? 1 : 0);
+            case 0x800000E4: return crc16_rx_;
+            case 0x800000E8: return crc16_tx_;
+            case 0x800000EC: return (uint32_t)(crc7_ << 1 | 1);
+            default:         return 0;
+        }
+    }
+
+    void write(uint32_t addr, uint32_t data, uint32_t wstrb, uint64_t &now) {
+        switch (addr) {
+            case 0x80000050: ctrl_ = data & 0x000FFF3F; break;
+            case 0x80000054:                    // Not acknowledged while busy
+                if (!(wstrb & 1))
+                    break;
+                if (busy(now)) {
+                    stall_clocks += busy_until_ - now;
+                    now = busy_until_;
+                }
+                rx_data_ = wire(now, (uint8_t)data);
+                busy_until_ = now + byte_clocks();
+                irq_at_ = busy_until_;
+                break;
+            case 0x8000005C:
+                cs_ = data & 1;
+                card_.select(!cs_);
+                break;
+            case 0x800000C0: {                  // FIFO_DATA: four bytes out, bits [7:0] first
+                uint64_t bc = byte_clocks();
+                uint64_t room = (uint64_t)fifo_words_ * 4 * bc;
+                if (busy_until_ > now + room) {
+                    stall_clocks += busy_until_ - room - now;
+                    now = busy_until_ - room;
+                }
+                uint64_t t = std::max(now, busy_until_);
+                for (int i = 0; i < 4; i++) {
+                    uint8_t miso = wire(t, (uint8_t)(data >> (8 * i)));
+                    t += bc;
+                    if (capture_)
+                        rx_pack(miso, t);
+                }
+                rx_flush(t);
+                busy_until_ = t;
+                irq_at_ = t;
+                break;
+            }
+            case 0x800000C4:
+                capture_ = data & 1;
+                if (data & 2) {
+                    rx_fifo_.clear();
+                    rx_word_ = 0;
+                    rx_n_ = 0;
+                }
+                break;
+            case 0x800000CC: {                  // RX_REPEAT: N fill bytes into the RX FIFO
+                uint32_t n = data & 0xFFFF;
+                uint64_t t = std::max(now, busy_until_);
+                uint64_t bc = byte_clocks();
+                for (uint32_t i = 0; i < n; i++) {
+                    uint8_t miso = wire(t, 0xFF);
+                    t += bc;
+                    rx_pack(miso, t);
+                }
+                rx_flush(t);
+                busy_until_ = t;
+                irq_at_ = t;
+                break;
+            }
+            case 0x800000D0: if (dma_end_ <= now) dma_addr_ = data; break;
+            case 0x800000D4: if (dma_end_ <= now) dma_len_ = data & 0xFFFF; break;
+            case 0x800000D8:
+                if ((data & 1) && dma_end_ <= now)
+                    dma_start(data, now);
+                break;
+            case 0x800000E0:
+                if (data & 2) {
+                    crc16_rx_ = crc16_tx_ = 0;
+                    crc7_ = 0;
+                }
+                crc_en_ = data & 1;
+                break;
+            default:
+                break;
+        }
+    }
+
+    // IRQ[2]: pulse when the transfer queue drains or a DMA with IRQ_EN ends
+    bool take_irq(uint64_t now) {
+        bool irq = false;
+        if (irq_at_ && irq_at_ <= now) {
+            irq = true;
+            irq_at_ = 0;
+        }
+        if (dma_irq_at_ && dma_irq_at_ <= now) {
+            irq = true;
+            dma_irq_at_ = 0;
+        }
+        return irq;
+    }
+
+    uint64_t next_event() const {
+        uint64_t t = irq_at_ ? irq_at_ : NEVER;
+        if (dma_irq_at_)
+            t = std::min(t, dma_irq_at_);
+        return t;
+    }
+
+    // Clocks per byte: 16 SCK half periods of threshold + 1 clocks, plus
+    // the IDLE and FINISH states of spi_master.v
+    uint64_t byte_clocks() const {
+        uint32_t threshold = (ctrl_ & 0x20) ? (ctrl_ >> 8) & 0xFF : (1u << ((ctrl_ >> 2) & 7)) - 1;
+        return 16ull * (threshold + 1) + 2;
+    }
+
+    uint64_t stall_clocks = 0;
+    uint64_t bytes = 0;
+    uint64_t dma_bytes = 0;
+
+private:
+    SdCard &card_;
+    std::vector<uint8_t> &sram_;
+    uint32_t clk_hz_;
+    uint32_t fifo_words_;
+    bool hw_crc_;
+
+    uint32_t ctrl_ = 0;
+    uint32_t cs_ = 1;
+    uint32_t rx_data_ = 0;
+    uint64_t busy_until_ = 0;
+    uint64_t irq_at_ = 0;
+
+    bool capture_ = false;
+    std::deque<std::pair<uint64_t, uint32_t>> rx_fifo_;    // (ready at, word)
+    uint32_t rx_word_ = 0;
+    int rx_n_ = 0;
+
+    uint32_t dma_addr_ = 0, dma_len_ = 0;
+    bool dma_tx_ = false, dma_irq_ = false, dma_done_ = false;
+    uint64_t dma_end_ = 0, dma_irq_at_ = 0;
+
+    bool crc_en_ = false;
+    uint16_t crc16_rx_ = 0, crc16_tx_ = 0;
+    uint8_t crc7_ = 0;
+
+    bool busy(uint64_t now) const { return busy_until_ > now; }
+
+    static uint16_t crc16_byte(uint16_t crc, uint8_t b) {
+        crc ^= (uint16_t)b << 8;
+        for (int i = 0; i < 8; i++)
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        return crc;
+    }
+
+    static uint8_t crc7_byte(uint8_t crc, uint8_t b) {
+        for (int i = 0; i < 8; i++) {
+            uint8_t fb = ((crc >> 6) ^ (b >> 7)) & 1;
+            crc = (uint8_t)((crc << 1) & 0x7F);
+            if (fb) crc ^= 0x09;
+            b <<= 1;
+        }
+        return crc;
+    }
+
+    // One byte on the wire at time t (clocks); the card's clock follows
+    uint8_t wire(uint64_t t, uint8_t mosi) {
+        card_.set_time(t * 1000000000ull / clk_hz_);
+        uint8_t miso = card_.xfer(mosi);
+        bytes++;
+        if (hw_crc_ && crc_en_) {
+            crc16_rx_ = crc16_byte(crc16_rx_, miso);
+            crc16_tx_ = crc16_byte(crc16_tx_, mosi);
+            crc7_ = crc7_byte(crc7_, mosi);
+        }
+        return miso;
+    }
+
+    void rx_pack(uint8_t b, uint64_t t) {
+        rx_word_ |= (uint32_t)b << (8 * rx_n_);
+        if (++rx_n_ == 4) {
+            rx_fifo_.push_back({ t, rx_word_ });
+            rx_word_ = 0;
+            rx_n_ = 0;
+        }
+    }
+
+    // Transfer ended mid-word: the partial word follows one clock later
+    void rx_flush(uint64_t t) {
+        if (rx_n_) {
+            rx_fifo_.push_back({ t + 1, rx_word_ });
+            rx_word_ = 0;
+            rx_n_ = 0;
+        }
+    }
+
+    void dma_start(uint32_t ctrl, uint64_t now) {
+        dma_tx_ = ctrl & 2;
+        dma_irq_ = ctrl & 4;
+        dma_done_ = true;
+        uint64_t t = std::max(now, busy_until_);
+        uint64_t bc = byte_clocks();
+
+        for (uint32_t i = 0; i < dma_len_; i++) {
+            uint32_t a = dma_addr_ + i;
+            if (dma_tx_) {
+                wire(t, a < sram_.size() ? sram_[a] : 0);
+            } else {
+                uint8_t miso = wire(t, 0xFF);
+                if (a < sram_.size())
+                    sram_[a] = miso;
+            }
+            t += bc;
+        }
+        dma_bytes += dma_len_;
+        busy_until_ = t;
+        dma_end_ = t + 2;                       // Last word through the FIFO
+        irq_at_ = t;
+        if (dma_irq_)
+            dma_irq_at_ = dma_end_;
+    }
+};
+
+//==============================================================================
+// Memory DMA (0x80000100): copy / fill / checksum, SRAM only
+//==============================================================================
+
+class MemDmaModel {
+public:
+    explicit MemDmaModel(std::vector<uint8_t> &sram) : sram_(sram) {}
+
+    uint32_t read(uint32_t off, uint64_t now) const {
+        bool run = end_ > now;
+        switch (off & 0x1C) {
+            case 0x00: return src_;
+            case 0x04: return dst_;
+            case 0x08: return len_;
+            case 0x0C: return (sum_mode_ ? 0x10 : 0) | (!run && done_ ? 8 : 0) |
+                              (irq_en_ ? 4 : 0) | (fill_mode_ ? 2 : 0) | (run ? 1 : 0);
+            case 0x10: return fill_;
+            case 0x14: return sum_;
+            default:   return 0;
+        }
+    }
+
+    void write(uint32_t off, uint32_t data, uint64_t now) {
+        if (end_ > now)                         // Registers ignore writes while busy
+            return;
+        switch (off & 0x1C) {
+            case 0x00: src_ = data & ~3u; break;
+            case 0x04: dst_ = data & ~3u; break;
+            case 0x08: len_ = data & 0x000FFFFC; break;
+            case 0x0C:
+                fill_mode_ = data & 2;
+                irq_en_ = data & 4;
+                sum_mode_ = data & 8;
+                if (data & 1)
+                    start(now);
+                break;
+            case 0x10: fill_ = data; break;
+            case 0x14: sum_ = data; break;
+            default:   break;
+        }
+    }
+
+    bool take_irq(uint64_t now) {
+        if (irq_at_ && irq_at_ <= now) {
+            irq_at_ = 0;
+            return true;
+        }
+        return false;
+    }
+
+    uint64_t next_event() const { return irq_at_ ? irq_at_ : NEVER; }
+
+    uint64_t bytes = 0;
+
+private:
+    // Clocks per word (estimates from the mem_dma.v state sequence: burst
+    // reads, one SRAM write request per word)
+    static const uint32_t COPY_CLOCKS = 14;
+    static const uint32_t FILL_CLOCKS = 12;
+    static const uint32_t SUM_CLOCKS  = 2;
+
+    std::vector<uint8_t> &sram_;
+    uint32_t src_ = 0, dst_ = 0, len_ = 0, fill_ = 0, sum_ = 0;
+    bool fill_mode_ = false, irq_en_ = false, sum_mode_ = false, done_ = false;
+    uint64_t end_ = 0, irq_at_ = 0;
+
+    uint32_t rd32(uint32_t a) const {
+        if (a + 4 > sram_.size()) return 0;
+        return sram_[a] | sram_[a + 1] << 8 | sram_[a + 2] << 16 | (uint32_t)sram_[a + 3] << 24;
+    }
+
+    void wr32(uint32_t a, uint32_t v) {
+        if (a + 4 > sram_.size()) return;
+        for (int i = 0; i < 4; i++) sram_[a + i] = (uint8_t)(v >> (8 * i));
+    }
+
+    void start(uint64_t now) {
+        uint32_t words = len_ / 4;
+        uint32_t per = COPY_CLOCKS;
+        for (uint32_t i = 0; i < words; i++) {
+            if (sum_mode_) {
+                uint32_t w = rd32(src_ + 4 * i);
+                uint64_t s = (uint64_t)sum_ + (w & 0xFFFF) + (w >> 16);
+                sum_ = (uint32_t)s + (uint32_t)(s >> 32);
+                per = SUM_CLOCKS;
+            } else if (fill_mode_) {
+                wr32(dst_ + 4 * i, fill_);
+                per = FILL_CLOCKS;
+            } else {
+                wr32(dst_ + 4 * i, rd32(src_ + 4 * i));
+            }
+        }
+        bytes += len_;
+        done_ = true;
+        end_ = now + (uint64_t)words * per + 2;
+        if (irq_en_)
+            irq_at_ = end_;
+    }
+};
+
+//==============================================================================
+// CRC32 accelerator (0x800000F0)
+//==============================================================================
+
+class Crc32Model {
+public:
+    uint32_t read(uint32_t off) const {
+        switch (off & 0xC) {
+            case 0x0: return 0x80000000u;
+            case 0x8: return ~crc_;
+            default:  return 0;
+        }
+    }
+
+    void write(uint32_t off, uint32_t data, uint32_t wstrb) {
+        switch (off & 0xC) {
+            case 0x0:
+                if (data & 1) crc_ = 0xFFFFFFFF;
+                break;
+            case 0x4:                           // Enabled lanes, lane 0 first
+                for (int lane = 0; lane < 4; lane++)
+                    if (wstrb & (1u << lane))
+                        crc_ = byte(crc_, (uint8_t)(data >> (8 * lane)));
+                break;
+            case 0x8:
+                crc_ = ~data;
+                break;
+            default:
+                break;
+        }
+    }
+
+private:
+    uint32_t crc_ = 0xFFFFFFFF;
+
+    static uint32_t byte(uint32_t crc, uint8_t b) {
+        crc ^= b;
+        for (int i = 0; i < 8; i++)
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+        return crc;
+    }
+};
+
+//==============================================================================
+// Atomic words (0x80000300): operation window addr[7:5], word addr[4:2]
+//==============================================================================
+
+class AtomicModel {
+public:
+    explicit AtomicModel(bool present) : present_(present) {}
+
+    uint32_t read(uint32_t off) {
+        if (!present_)
+            return 0;
+        uint32_t op = (off >> 5) & 7, n = (off >> 2) & 7;
+        uint32_t old = word_[n];
+        switch (op) {
+            case 1: word_[n] = 1; break;                // TAS
+            case 2: word_[n] = old + 1; break;          // INC
+            case 3: word_[n] = old - 1; break;          // DEC
+            case 5: word_[n] = 0; break;                // BITS: fetch-and-clear
+            case 7: return 0x80000000u | 8;             // ID
+            default: break;
+        }
+        return old;
+    }
+
+    void write(uint32_t off, uint32_t data, uint32_t wstrb) {
+        if (!present_ || wstrb != 0xF)
+            return;
+        uint32_t op = (off >> 5) & 7, n = (off >> 2) & 7;
+        switch (op) {
+            case 0: case 1: word_[n] = data; break;     // WORD, TAS
+            case 4: word_[n] += data; break;            // ADD
+            case 5: word_[n] |= data; break;            // BITS
+            case 6: word_[n] &= ~data; break;           // CLR
+            default: break;
+        }
+    }
+
+private:
+    bool present_;
+    uint32_t word_[8] = {};
+};
+
+//==============================================================================
+// Interrupt controller (0x80000140)
+//==============================================================================
+
+class IrqcModel {
+public:
+    static const uint32_t LEVEL_MASK = 0x30;    // UART RX/TX
+
+    // Sources this instruction; returns what reaches the CPU IRQ inputs
+    uint32_t gate(uint32_t src) {
+        latched_ |= src & enable_;
+        levels_ = src & LEVEL_MASK;
+        return src & enable_;
+    }
+
+    uint32_t read(uint32_t off) const {
+        switch (off & 0xC) {
+            case 0x0: return enable_;
+            case 0x4: return pending();
+            case 0x8: return prio_;
+            case 0xC: {
+                uint32_t active = pending() & enable_;
+                int best = -1;
+                uint32_t best_prio = 0;
+                for (int i = 7; i >= 0; i--) {
+                    uint32_t p = (prio_ >> (4 * i)) & 0xF;
+                    if ((active >> i) & 1 && (best < 0 || p >= best_prio)) {
+                        best = i;
+                        best_prio = p;
+                    }
+                }
+                return (best >= 0 ? 0x80000000u : 0) | 0x40000000u | best_prio << 8 |
+                       (best >= 0 ? (uint32_t)best : 0);
+            }
+            default:  return 0;
+        }
+    }
+
+    void write(uint32_t off, uint32_t data, uint32_t wstrb) {
+        switch (off & 0xC) {
+            case 0x0: if (wstrb & 1) enable_ = data & 0xFF; break;
+            case 0x4: if (wstrb & 1) latched_ &= ~data; break;
+            case 0x8: if (wstrb == 0xF) prio_ = data; break;
+            case 0xC: if (wstrb & 1) latched_ &= ~(1u << (data & 7)); break;
+            default:  break;
+        }
+    }
+
+private:
+    uint32_t enable_ = 0xBF;                    // All but the button
+    uint32_t latched_ = 0;
+    uint32_t levels_ = 0;
+    uint32_t prio_ = 0;
+
+    uint32_t pending() const { return (latched_ & ~LEVEL_MASK) | levels_; }
+};
+
+#endif // RVSIM_PERIPHERALS_H
@@ -0,0 +1,245 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// profiler.h - rvsim Call-Graph Cycle Profiler
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+//
+// Builds a calling-context tree from the instruction stream: a jal/jalr
+// that links ra or t0 is a call, a jalr x0 through ra or t0 back to a
+// return address on the shadow stack is a return, and interrupt entry
+// opens a frame that retirq closes. Every instruction's cycles (execute
+// plus bus waits) go to the node it ran in; when the pc walks into another
+// function without a call (tail call, fall-through, longjmp) the frame
+// becomes a sibling under the same caller.
+//
+// Output:
+//   flat profile   self and inclusive cycles per function, calls, CPI
+//   folded stacks  "main;f_read;disk_read 1234" lines for flamegraph.pl
+//                  (https://github.com/brendangregg/FlameGraph)
+//
+// Functions come from the ELF symbol tables (elf_image.h); code without a
+// symbol is "[unknown]".
+//
+//==============================================================================
+
+#ifndef RVSIM_PROFILER_H
+#define RVSIM_PROFILER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "elf_image.h"
+#include "rv32_cpu.h"
+
+class Profiler : public CallObserver {
+public:
+    static const size_t MAX_DEPTH = 256;
+
+    explicit Profiler(const SymbolTable &syms) : syms_(syms) {
+        nodes_.push_back(Node { -1, -2, 0, 0, 0, {} });     // Root
+        stack_.push_back(Frame { 0, 0, false });
+    }
+
+    // CallObserver
+    void retire(uint32_t pc, uint32_t cycles) override {
+        int sym = symbol(pc);
+        Frame &top = stack_.back();
+        if (nodes_[top.node].sym != sym) {
+            int parent = top.node ? nodes_[top.node].parent : 0;
+            top.node = child(parent, sym);
+        }
+        Node &n = nodes_[top.node];
+        n.self += cycles;
+        n.instrs++;
+        total_cycles_ += cycles;
+        total_instrs_++;
+    }
+
+    void call(uint32_t target, uint32_t ret) override {
+        if (stack_.size() >= MAX_DEPTH)
+            return;
+        int n = child(stack_.back().node, symbol(target));
+        nodes_[n].calls++;
+        stack_.push_back(Frame { n, ret, false });
+    }
+
+    void ret(uint32_t target) override {
+        // Unwind to the frame that returns here (skips frames left by
+        // longjmp or code that returned without a matching call)
+        for (size_t i = stack_.size(); i-- > 1;) {
+            if (stack_[i].irq)
+                return;
+            if (stack_[i].ret == target) {
+                stack_.resize(i);
+                return;
+            }
+        }
+    }
+
+    void irq_enter(uint32_t vector, uint32_t ret) override {
+        if (stack_.size() >= MAX_DEPTH)
+            stack_.resize(1);
+        int n = child(stack_.back().node, symbol(vector));
+        nodes_[n].calls++;
+        stack_.push_back(Frame { n, ret, true });
+    }
+
+    void irq_exit(uint32_t) override {
+        for (size_t i = stack_.size(); i-- > 1;) {
+            if (stack_[i].irq) {
+                stack_.resize(i);
+                return;
+            }
+        }
+        stack_.resize(1);
+    }
+
+    // Flat profile, functions by self cycles (top 0: all)
+    void write_flat(FILE *f, size_t top) const {
+        std::vector<Flat> flat = flatten();
+        std::sort(flat.begin(), flat.end(),
+                  [](const Flat &a, const Flat &b) { return a.self > b.self; });
+        if (top && flat.size() > top)
+            flat.resize(top);
+
+        fprintf(f, "rvsim profile: %llu cycles, %llu instructions",
+                (unsigned long long)total_cycles_, (unsigned long long)total_instrs_);
+        if (total_instrs_)
+            fprintf(f, ", CPI %.2f", (double)total_cycles_ / total_instrs_);
+        fprintf(f, "\n\n");
+        fprintf(f, "%14s %6s %14s %6s %10s %12s %6s  %s\n",
+                "Self cycles", "%", "Inclusive", "%", "Calls", "Instrs", "CPI", "Function");
+
+        double pct = total_cycles_ ? 100.0 / total_cycles_ : 0;
+        for (const Flat &e : flat) {
+            fprintf(f, "%14llu %5.1f%% %14llu %5.1f%% %10llu %12llu %6.2f  %s\n",
+                    (unsigned long long)e.self, e.self * pct,
+                    (unsigned long long)e.incl, e.incl * pct,
+                    (unsigned long long)e.calls, (unsigned long long)e.instrs,
+                    e.instrs ? (double)e.self / e.instrs : 0.0, name(e.sym).c_str());
+        }
+    }
+
+    // One "caller;callee count" line per context with self cycles
+    void write_folded(FILE *f) const {
+        std::vector<int> path;
+        for (size_t i = 1; i < nodes_.size(); i++) {
+            if (!nodes_[i].self)
+                continue;
+            path.clear();
+            for (int n = (int)i; n > 0; n = nodes_[n].parent)
+                path.push_back(n);
+            std::string line;
+            for (size_t j = path.size(); j-- > 0;) {
+                line += name(nodes_[path[j]].sym);
+                if (j) line += ';';
+            }
+            fprintf(f, "%s %llu\n", line.c_str(), (unsigned long long)nodes_[i].self);
+        }
+    }
+
+    uint64_t total_cycles() const { return total_cycles_; }
+
+private:
+    struct Node {
+        int parent;
+        int sym;                                // Symbol index, -1 unknown, -2 root
+        uint64_t self, calls, instrs;
+        std::vector<std::pair<int, int>> children;      // (sym, node)
+    };
+
+    struct Frame {
+        int node;
+        uint32_t ret;                           // Return address (irq: interrupted pc)
+        bool irq;
+    };
+
+    struct Flat {
+        int sym;
+        uint64_t self = 0, incl = 0, calls = 0, instrs = 0;
+    };
+
+    const SymbolTable &syms_;
+    std::vector<Node> nodes_;
+    std::vector<Frame> stack_;
+    uint64_t total_cycles_ = 0, total_instrs_ = 0;
+
+    // Last symbol hit: most instructions stay in the same function
+    uint32_t cache_lo_ = 1, cache_hi_ = 0;
+    int cache_sym_ = -1;
+
+    int symbol(uint32_t pc) {
+        if (pc >= cache_lo_ && pc < cache_hi_)
+            return cache_sym_;
+        int s = syms_.lookup(pc);
+        if (s >= 0) {
+            cache_lo_ = syms_.at(s).addr;
+            cache_hi_ = cache_lo_ + syms_.at(s).size;
+            cache_sym_ = s;
+        }
+        return s;
+    }
+
+    int child(int parent, int sym) {
+        for (auto &c : nodes_[parent].children)
+            if (c.first == sym)
+                return c.second;
+        int n = (int)nodes_.size();
+        nodes_.push_back(Node { parent, sym, 0, 0, 0, {} });
+        nodes_[parent].children.push_back({ sym, n });
+        return n;
+    }
+
+    std::string name(int sym) const {
+        return sym >= 0 ? syms_.at(sym).name : "[unknown]";
+    }
+
+    uint64_t subtree(int n, std::vector<uint64_t> &incl) const {
+        uint64_t t = nodes_[n].self;
+        for (auto &c : nodes_[n].children)
+            t += subtree(c.second, incl);
+        incl[n] = t;
+        return t;
+    }
+
+    // Per function: inclusive counts each outermost activation once
+    // (recursion does not double count)
+    std::vector<Flat> flatten() const {
+        std::vector<uint64_t> incl(nodes_.size(), 0);
+        subtree(0, incl);
+
+        std::vector<Flat> by_sym(syms_.size() + 1);
+        for (size_t s = 0; s < by_sym.size(); s++)
+            by_sym[s].sym = (int)s - 1;
+
+        for (size_t i = 1; i < nodes_.size(); i++) {
+            const Node &n = nodes_[i];
+            Flat &e = by_sym[n.sym + 1];
+            e.self += n.self;
+            e.calls += n.calls;
+            e.instrs += n.instrs;
+
+            bool outer = true;
+            for (int p = n.parent; p > 0; p = nodes_[p].parent)
+                if (nodes_[p].sym == n.sym) { outer = false; break; }
+            if (outer)
+                e.incl += incl[i];
+        }
+
+        std::vector<Flat> out;
+        for (const Flat &e : by_sym)
+            if (e.incl)
+                out.push_back(e);
+        return out;
+    }
+};
+
+#endif // RVSIM_PROFILER_H
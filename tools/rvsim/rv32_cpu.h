@@ -0,0 +1,591 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// rv32_cpu.h - rvsim RV32IM(C) Core with PicoRV32 Interrupts
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+//
+// Executes one instruction per step() the way the PicoRV32 instance in
+// ice40_picorv32_top.v does:
+//
+//   - RV32I + M (ENABLE_MUL/ENABLE_DIV), C expanded to its 32-bit form
+//     (COMPRESSED_ISA), rdcycle/rdtime/rdinstret and their high halves
+//   - IRQ vector at PROGADDR_IRQ, q0-q3, getq/setq/retirq/maskirq/
+//     waitirq/timer (opcode 0x0B), LATCHED_IRQ: every input is latched
+//     until the handler is entered
+//   - ebreak/ecall/unknown opcodes raise IRQ 1 when it is unmasked and no
+//     handler is running, else the CPU traps (CATCH_ILLINSN=0 would let
+//     unknown opcodes through; stopping on them is more useful here)
+//   - CATCH_MISALIGN=0: misaligned loads/stores drop the low address bits
+//
+// With RVC a fetch returns a word and PicoRV32 keeps its upper halfword,
+// so a compressed instruction in the upper half costs no fetch and a
+// 32-bit instruction straddling two words costs one or two.
+//
+// Calls, returns and interrupt entry/exit are reported to a CallObserver
+// (the profiler) along with every instruction's cycles.
+//
+//==============================================================================
+
+#ifndef RVSIM_RV32_CPU_H
+#define RVSIM_RV32_CPU_H
+
+#include <cstdint>
+
+#include "soc.h"
+#include "timing.h"
+
+class CallObserver {
+public:
+    virtual ~CallObserver() {}
+    virtual void retire(uint32_t pc, uint32_t cycles) = 0;
+    virtual void call(uint32_t target, uint32_t ret) = 0;
+    virtual void ret(uint32_t target) = 0;
+    virtual void irq_enter(uint32_t vector, uint32_t ret) = 0;
+    virtual void irq_exit(uint32_t target) = 0;
+};
+
+class Rv32Cpu {
+public:
+    enum Status { RUNNING, WAITING, TRAPPED };
+
+    Rv32Cpu(const SimConfig &cfg, Soc &soc) : cfg_(cfg), t_(cfg), soc_(soc) {}
+
+    uint32_t pc = 0;
+    uint32_t x[32] = {};
+    uint32_t q[4] = {};
+    uint64_t instret = 0;
+
+    CallObserver *observer = nullptr;
+
+    // Trap report
+    uint32_t trap_pc = 0;
+    uint32_t trap_insn = 0;
+    const char *trap_why = "";
+
+    // Execute one instruction (or take an interrupt)
+    Status step() {
+        latch_irqs();
+        if (waiting_) {
+            // waitirq completes on any pending bit, masked or not, before
+            // an interrupt is taken; the time asleep is its cost
+            if (!irq_pending_)
+                return WAITING;
+            waiting_ = false;
+            set_rd(wait_rd_, irq_pending_);
+            attribute(wait_pc_);
+        }
+
+        // Entry cycles go to the handler's first instruction
+        if (!irq_active_ && (irq_pending_ & ~irq_mask_)) {
+            enter_irq();
+            soc_.now += t_.irq_entry;
+            return RUNNING;
+        }
+
+        uint32_t at = pc;
+        bool compr = false;
+        uint32_t insn = fetch(at, compr);
+        uint32_t len = compr ? 2 : 4;
+        next_pc_ = at + len;
+        last_compr_ = compr;
+
+        uint32_t cycles = execute(insn, at, len);
+        if (cycles == 0) {
+            trap_pc = at;
+            trap_insn = insn;
+            return TRAPPED;
+        }
+        soc_.now += cycles;
+        instret++;
+        pc = next_pc_;
+
+        if (waiting_) {
+            wait_pc_ = at;
+            return WAITING;
+        }
+        attribute(at);
+        report_flow();
+        return RUNNING;
+    }
+
+    // Clock the PicoRV32 timer raises IRQ 0, for waitirq fast-forward
+    uint64_t next_event() const {
+        return timer_ ? timer_last_ + timer_ : NEVER;
+    }
+
+private:
+    const SimConfig &cfg_;
+    CpuTiming t_;
+    Soc &soc_;
+
+    uint32_t next_pc_ = 0;
+    bool last_compr_ = false;
+
+    uint32_t irq_pending_ = 0;
+    uint32_t irq_mask_ = ~0u;
+    bool irq_active_ = false;
+    bool waiting_ = false;
+    uint32_t wait_rd_ = 0;
+    uint32_t wait_pc_ = 0;
+    uint64_t mark_ = 0;                         // Cycles up to here are attributed
+
+    uint32_t timer_ = 0;
+    uint64_t timer_last_ = 0;
+
+    // Upper halfword PicoRV32 kept from the last fetch (RVC only)
+    uint32_t hi_addr_ = 1;                      // Odd: nothing buffered
+    uint32_t hi_half_ = 0;
+
+    void set_rd(uint32_t rd, uint32_t v) {
+        if (rd) x[rd] = v;
+    }
+
+    static int32_t sext(uint32_t v, int bits) {
+        return (int32_t)(v << (32 - bits)) >> (32 - bits);
+    }
+
+    // Control transfer of the instruction executing, reported once its
+    // own cycles have gone to the frame it ran in
+    enum Flow { FLOW_NONE, FLOW_CALL, FLOW_RET, FLOW_IRET };
+    Flow flow_ = FLOW_NONE;
+    uint32_t flow_target_ = 0, flow_ret_ = 0;
+
+    void attribute(uint32_t at) {
+        if (observer)
+            observer->retire(at, (uint32_t)(soc_.now - mark_));
+        mark_ = soc_.now;
+    }
+
+    void report_flow() {
+        if (!observer || flow_ == FLOW_NONE)
+            return;
+        switch (flow_) {
+            case FLOW_CALL: observer->call(flow_target_, flow_ret_); break;
+            case FLOW_RET:  observer->ret(flow_target_); break;
+            default:        observer->irq_exit(flow_target_); break;
+        }
+        flow_ = FLOW_NONE;
+    }
+
+    void flow(Flow kind, uint32_t target, uint32_t ret = 0) {
+        flow_ = kind;
+        flow_target_ = target;
+        flow_ret_ = ret;
+    }
+
+    //--------------------------------------------------------------------------
+    // Interrupts
+    //--------------------------------------------------------------------------
+
+    void latch_irqs() {
+        // PicoRV32 timer: counts down every clock, IRQ 0 on reaching zero
+        if (timer_) {
+            uint64_t elapsed = soc_.now - timer_last_;
+            if (elapsed >= timer_) {
+                timer_ = 0;
+                irq_pending_ |= 1;
+            } else {
+                timer_ -= (uint32_t)elapsed;
+            }
+        }
+        timer_last_ = soc_.now;
+        irq_pending_ |= soc_.irq_lines();
+    }
+
+    void enter_irq() {
+        q[0] = pc | (last_compr_ ? 1 : 0);
+        q[1] = irq_pending_ & ~irq_mask_;
+        irq_pending_ &= irq_mask_;
+        irq_active_ = true;
+        if (observer)
+            observer->irq_enter(cfg_.irq_addr, pc);
+        pc = cfg_.irq_addr;
+        hi_addr_ = 1;
+    }
+
+    // ebreak/ecall/illegal: IRQ 1 when allowed, else trap (returns 0)
+    uint32_t raise_ebreak(const char *why) {
+        trap_why = why;
+        if (!(irq_mask_ & 2) && !irq_active_) {
+            irq_pending_ |= 2;
+            return t_.alu;
+        }
+        return 0;
+    }
+
+    //--------------------------------------------------------------------------
+    // Fetch
+    //--------------------------------------------------------------------------
+
+    uint32_t fetch(uint32_t at, bool &compr) {
+        if (!cfg_.compressed) {
+            compr = false;
+            return soc_.fetch(at);
+        }
+
+        uint32_t lo;
+        if (at & 2) {
+            if (hi_addr_ == at) {
+                lo = hi_half_;
+            } else {
+                lo = soc_.fetch(at - 2) >> 16;
+            }
+            hi_addr_ = 1;
+            if ((lo & 3) != 3) {
+                compr = true;
+                return expand(lo);
+            }
+            uint32_t w = soc_.fetch(at + 2);
+            hi_addr_ = at + 4;
+            hi_half_ = w >> 16;
+            compr = false;
+            return lo | (w << 16);
+        }
+
+        uint32_t w = soc_.fetch(at);
+        hi_addr_ = at + 2;
+        hi_half_ = w >> 16;
+        if ((w & 3) != 3) {
+            compr = true;
+            return expand(w & 0xFFFF);
+        }
+        hi_addr_ = 1;
+        compr = false;
+        return w;
+    }
+
+    // RV32C to RV32I; 0 for the illegal / unsupported (F, D) encodings
+    static uint32_t expand(uint32_t c) {
+        uint32_t op = c & 3, f3 = (c >> 13) & 7;
+        uint32_t rd = (c >> 7) & 31, rs2 = (c >> 2) & 31;
+        uint32_t rdp = 8 + ((c >> 2) & 7), rs1p = 8 + ((c >> 7) & 7);
+
+        auto i_type = [](int32_t imm, uint32_t rs1, uint32_t f3, uint32_t rd, uint32_t opc) {
+            return ((uint32_t)imm << 20) | rs1 << 15 | f3 << 12 | rd << 7 | opc;
+        };
+        auto r_type = [](uint32_t f7, uint32_t rs2, uint32_t rs1, uint32_t f3, uint32_t rd, uint32_t opc) {
+            return f7 << 25 | rs2 << 20 | rs1 << 15 | f3 << 12 | rd << 7 | opc;
+        };
+        auto s_type = [](int32_t imm, uint32_t rs2, uint32_t rs1, uint32_t f3) {
+            uint32_t u = (uint32_t)imm;
+            return ((u >> 5) & 0x7F) << 25 | rs2 << 20 | rs1 << 15 | f3 << 12 | (u & 31) << 7 | 0x23;
+        };
+        auto b_type = [](int32_t imm, uint32_t rs2, uint32_t rs1, uint32_t f3) {
+            uint32_t u = (uint32_t)imm;
+            return ((u >> 12) & 1) << 31 | ((u >> 5) & 0x3F) << 25 | rs2 << 20 | rs1 << 15 |
+                   f3 << 12 | ((u >> 1) & 0xF) << 8 | ((u >> 11) & 1) << 7 | 0x63;
+        };
+        auto j_type = [](int32_t imm, uint32_t rd) {
+            uint32_t u = (uint32_t)imm;
+            return ((u >> 20) & 1) << 31 | ((u >> 1) & 0x3FF) << 21 | ((u >> 11) & 1) << 20 |
+                   ((u >> 12) & 0xFF) << 12 | rd << 7 | 0x6F;
+        };
+        auto bit = [c](int b) { return (c >> b) & 1; };
+
+        if (op == 0) {
+            switch (f3) {
+                case 0: {                       // c.addi4spn
+                    uint32_t imm = ((c >> 7) & 0xF) << 6 | ((c >> 11) & 3) << 4 | bit(5) << 3 | bit(6) << 2;
+                    return imm ? i_type((int32_t)imm, 2, 0, rdp, 0x13) : 0;
+                }
+                case 2: {                       // c.lw
+                    uint32_t imm = bit(5) << 6 | ((c >> 10) & 7) << 3 | bit(6) << 2;
+                    return i_type((int32_t)imm, rs1p, 2, rdp, 0x03);
+                }
+                case 6: {                       // c.sw
+                    uint32_t imm = bit(5) << 6 | ((c >> 10) & 7) << 3 | bit(6) << 2;
+                    return s_type((int32_t)imm, rdp, rs1p, 2);
+                }
+                default: return 0;
+            }
+        }
+
+        if (op == 1) {
+            int32_t imm6 = sext(bit(12) << 5 | rs2, 6);
+            switch (f3) {
+                case 0: return i_type(imm6, rd, 0, rd, 0x13);          // c.addi / c.nop
+                case 1:                                                 // c.jal
+                case 5: {                                               // c.j
+                    uint32_t u = bit(12) << 11 | bit(8) << 10 | ((c >> 9) & 3) << 8 | bit(6) << 7 |
+                                 bit(7) << 6 | bit(2) << 5 | bit(11) << 4 | ((c >> 3) & 7) << 1;
+                    return j_type(sext(u, 12), f3 == 1 ? 1 : 0);
+                }
+                case 2: return i_type(imm6, 0, 0, rd, 0x13);           // c.li
+                case 3:
+                    if (rd == 2) {                                      // c.addi16sp
+                        uint32_t u = bit(12) << 9 | bit(4) << 8 | bit(3) << 7 | bit(5) << 6 |
+                                     bit(2) << 5 | bit(6) << 4;
+                        return u ? i_type(sext(u, 10), 2, 0, 2, 0x13) : 0;
+                    }
+                    if (imm6 == 0)
+                        return 0;
+                    return ((uint32_t)imm6 << 12) | rd << 7 | 0x37;    // c.lui
+                case 4: {
+                    uint32_t shamt = bit(12) << 5 | rs2;
+                    switch ((c >> 10) & 3) {
+                        case 0: return shamt & 32 ? 0 : i_type((int32_t)shamt, rs1p, 5, rs1p, 0x13);
+                        case 1: return shamt & 32 ? 0 : i_type((int32_t)(shamt | 0x400), rs1p, 5, rs1p, 0x13);
+                        case 2: return i_type(imm6, rs1p, 7, rs1p, 0x13);   // c.andi
+                        default: {
+                            if (bit(12))
+                                return 0;
+                            uint32_t r2 = 8 + ((c >> 2) & 7);
+                            switch ((c >> 5) & 3) {
+                                case 0: return r_type(0x20, r2, rs1p, 0, rs1p, 0x33);  // c.sub
+                                case 1: return r_type(0, r2, rs1p, 4, rs1p, 0x33);     // c.xor
+                                case 2: return r_type(0, r2, rs1p, 6, rs1p, 0x33);     // c.or
+                                default: return r_type(0, r2, rs1p, 7, rs1p, 0x33);    // c.and
+                            }
+                        }
+                    }
+                }
+                case 6:                                                 // c.beqz
+                case 7: {                                               // c.bnez
+                    uint32_t u = bit(12) << 8 | bit(6) << 7 | bit(5) << 6 | bit(2) << 5 |
+                                 ((c >> 10) & 3) << 3 | ((c >> 3) & 3) << 1;
+                    return b_type(sext(u, 9), 0, rs1p, f3 == 6 ? 0 : 1);
+                }
+            }
+        }
+
+        if (op == 2) {
+            switch (f3) {
+                case 0: {                                               // c.slli
+                    uint32_t shamt = bit(12) << 5 | rs2;
+                    return shamt & 32 ? 0 : i_type((int32_t)shamt, rd, 1, rd, 0x13);
+                }
+                case 2: {                                               // c.lwsp
+                    uint32_t u = ((c >> 2) & 3) << 6 | bit(12) << 5 | ((c >> 4) & 7) << 2;
+                    return rd ? i_type((int32_t)u, 2, 2, rd, 0x03) : 0;
+                }
+                case 4:
+                    if (!bit(12)) {
+                        if (rs2 == 0)                                   // c.jr
+                            return rd ? i_type(0, rd, 0, 0, 0x67) : 0;
+                        return r_type(0, rs2, 0, 0, rd, 0x33);          // c.mv
+                    }
+                    if (rs2 == 0)
+                        return rd ? i_type(0, rd, 0, 1, 0x67) : 0x00100073;  // c.jalr / c.ebreak
+                    return r_type(0, rs2, rd, 0, rd, 0x33);             // c.add
+                case 6: {                                               // c.swsp
+                    uint32_t u = ((c >> 7) & 3) << 6 | ((c >> 9) & 0xF) << 2;
+                    return s_type((int32_t)u, rs2, 2, 2);
+                }
+                default: return 0;
+            }
+        }
+        return 0;
+    }
+
+    //--------------------------------------------------------------------------
+    // Execute: returns the instruction's cycles, 0 to trap
+    //--------------------------------------------------------------------------
+
+    uint32_t execute(uint32_t insn, uint32_t at, uint32_t len) {
+        uint32_t opc = insn & 0x7F;
+        uint32_t rd = (insn >> 7) & 31, f3 = (insn >> 12) & 7;
+        uint32_t rs1 = (insn >> 15) & 31, rs2 = (insn >> 20) & 31;
+        uint32_t f7 = insn >> 25;
+        uint32_t a = x[rs1], b = x[rs2];
+        int32_t imm_i = (int32_t)insn >> 20;
+
+        switch (opc) {
+            case 0x37: set_rd(rd, insn & 0xFFFFF000); return t_.alu;            // lui
+            case 0x17: set_rd(rd, at + (insn & 0xFFFFF000)); return t_.alu;     // auipc
+
+            case 0x6F: {                                                        // jal
+                uint32_t target = at + sext((insn >> 31) << 20 | ((insn >> 21) & 0x3FF) << 1 |
+                                            ((insn >> 20) & 1) << 11 | ((insn >> 12) & 0xFF) << 12, 21);
+                set_rd(rd, at + len);
+                jump(target);
+                if (rd == 1 || rd == 5)
+                    flow(FLOW_CALL, target, at + len);
+                return t_.jal;
+            }
+
+            case 0x67: {                                                        // jalr
+                if (f3 != 0)
+                    return raise_ebreak("illegal instruction");
+                uint32_t target = (a + imm_i) & ~1u;
+                set_rd(rd, at + len);
+                jump(target);
+                if (rd == 1 || rd == 5)
+                    flow(FLOW_CALL, target, at + len);
+                else if (rd == 0 && (rs1 == 1 || rs1 == 5))
+                    flow(FLOW_RET, target);
+                return t_.jalr;
+            }
+
+            case 0x63: {                                                        // branches
+                bool take;
+                switch (f3) {
+                    case 0: take = a == b; break;
+                    case 1: take = a != b; break;
+                    case 4: take = (int32_t)a < (int32_t)b; break;
+                    case 5: take = (int32_t)a >= (int32_t)b; break;
+                    case 6: take = a < b; break;
+                    case 7: take = a >= b; break;
+                    default: return raise_ebreak("illegal instruction");
+                }
+                if (!take)
+                    return t_.branch;
+                jump(at + sext((insn >> 31) << 12 | ((insn >> 7) & 1) << 11 |
+                               ((insn >> 25) & 0x3F) << 5 | ((insn >> 8) & 0xF) << 1, 13));
+                return t_.branch_taken;
+            }
+
+            case 0x03: {                                                        // loads
+                uint32_t addr = a + imm_i;
+                uint32_t w = soc_.load(addr);
+                uint32_t v;
+                switch (f3) {
+                    case 0: v = (uint32_t)(int32_t)(int8_t)(w >> (8 * (addr & 3))); break;
+                    case 1: v = (uint32_t)(int32_t)(int16_t)(w >> (addr & 2 ? 16 : 0)); break;
+                    case 2: v = w; break;
+                    case 4: v = (uint8_t)(w >> (8 * (addr & 3))); break;
+                    case 5: v = (uint16_t)(w >> (addr & 2 ? 16 : 0)); break;
+                    default: return raise_ebreak("illegal instruction");
+                }
+                set_rd(rd, v);
+                return t_.load;
+            }
+
+            case 0x23: {                                                        // stores
+                uint32_t addr = a + sext(f7 << 5 | rd, 12);
+                switch (f3) {
+                    case 0: soc_.store(addr, (b & 0xFF) * 0x01010101u, 1u << (addr & 3)); break;
+                    case 1: soc_.store(addr, (b & 0xFFFF) * 0x00010001u, addr & 2 ? 0xC : 0x3); break;
+                    case 2: soc_.store(addr, b, 0xF); break;
+                    default: return raise_ebreak("illegal instruction");
+                }
+                if (cfg_.compressed && (addr & ~3u) == ((hi_addr_ - 2) & ~3u))
+                    hi_addr_ = 1;                       // Stale buffered halfword
+                return t_.store;
+            }
+
+            case 0x13: {                                                        // reg + imm
+                uint32_t shamt = rs2;
+                switch (f3) {
+                    case 0: set_rd(rd, a + imm_i); break;
+                    case 1: set_rd(rd, a << shamt); return t_.shift(cfg_, shamt);
+                    case 2: set_rd(rd, (int32_t)a < imm_i ? 1 : 0); break;
+                    case 3: set_rd(rd, a < (uint32_t)imm_i ? 1 : 0); break;
+                    case 4: set_rd(rd, a ^ imm_i); break;
+                    case 5:
+                        set_rd(rd, (f7 & 0x20) ? (uint32_t)((int32_t)a >> shamt) : a >> shamt);
+                        return t_.shift(cfg_, shamt);
+                    case 6: set_rd(rd, a | imm_i); break;
+                    case 7: set_rd(rd, a & imm_i); break;
+                }
+                return t_.alu;
+            }
+
+            case 0x33: {                                                        // reg + reg
+                if (f7 == 1)
+                    return muldiv(f3, rd, a, b);
+                uint32_t shamt = b & 31;
+                switch (f3) {
+                    case 0: set_rd(rd, (f7 & 0x20) ? a - b : a + b); break;
+                    case 1: set_rd(rd, a << shamt); return t_.shift(cfg_, shamt) + t_.rs2;
+                    case 2: set_rd(rd, (int32_t)a < (int32_t)b ? 1 : 0); break;
+                    case 3: set_rd(rd, a < b ? 1 : 0); break;
+                    case 4: set_rd(rd, a ^ b); break;
+                    case 5:
+                        set_rd(rd, (f7 & 0x20) ? (uint32_t)((int32_t)a >> shamt) : a >> shamt);
+                        return t_.shift(cfg_, shamt) + t_.rs2;
+                    case 6: set_rd(rd, a | b); break;
+                    case 7: set_rd(rd, a & b); break;
+                }
+                return t_.alu + t_.rs2;
+            }
+
+            case 0x0F:                                                          // fence: no-op
+                return t_.alu;
+
+            case 0x73: {                                                        // system
+                if (f3 == 0) {
+                    if (insn == 0x00100073) return raise_ebreak("ebreak");
+                    if (insn == 0x00000073) return raise_ebreak("ecall");
+                    return raise_ebreak("illegal instruction");
+                }
+                if (f3 != 2 || rs1 != 0)
+                    return raise_ebreak("unsupported CSR access");
+                uint64_t cycle = soc_.now;
+                switch (insn >> 20) {
+                    case 0xC00: case 0xC01: set_rd(rd, (uint32_t)cycle); break;
+                    case 0xC80: case 0xC81: set_rd(rd, (uint32_t)(cycle >> 32)); break;
+                    case 0xC02: set_rd(rd, (uint32_t)instret); break;
+                    case 0xC82: set_rd(rd, (uint32_t)(instret >> 32)); break;
+                    default: return raise_ebreak("unsupported CSR");
+                }
+                return t_.alu;
+            }
+
+            case 0x0B:                                                          // PicoRV32 IRQ
+                return custom(f7, rd, rs1, a);
+
+            default:
+                return raise_ebreak("illegal instruction");
+        }
+    }
+
+    uint32_t muldiv(uint32_t f3, uint32_t rd, uint32_t a, uint32_t b) {
+        int32_t sa = (int32_t)a, sb = (int32_t)b;
+        if (f3 < 4) {
+            if (!cfg_.mul)
+                return raise_ebreak("mul without ENABLE_MUL");
+            switch (f3) {
+                case 0: set_rd(rd, a * b); break;
+                case 1: set_rd(rd, (uint32_t)(((int64_t)sa * sb) >> 32)); break;
+                case 2: set_rd(rd, (uint32_t)(((int64_t)sa * (uint64_t)b) >> 32)); break;
+                case 3: set_rd(rd, (uint32_t)(((uint64_t)a * b) >> 32)); break;
+            }
+            return t_.mul;
+        }
+        if (!cfg_.div)
+            return raise_ebreak("div without ENABLE_DIV");
+        switch (f3) {
+            case 4: set_rd(rd, b == 0 ? ~0u : (sa == INT32_MIN && sb == -1) ? a : (uint32_t)(sa / sb)); break;
+            case 5: set_rd(rd, b == 0 ? ~0u : a / b); break;
+            case 6: set_rd(rd, b == 0 ? a : (sa == INT32_MIN && sb == -1) ? 0 : (uint32_t)(sa % sb)); break;
+            case 7: set_rd(rd, b == 0 ? a : a % b); break;
+        }
+        return t_.div;
+    }
+
+    uint32_t custom(uint32_t f7, uint32_t rd, uint32_t rs1, uint32_t a) {
+        switch (f7) {
+            case 0: set_rd(rd, q[rs1 & 3]); break;                      // getq rd, qs
+            case 1: q[rd & 3] = a; break;                               // setq qd, rs
+            case 2:                                                     // retirq
+                irq_active_ = false;
+                jump(q[0] & ~1u);
+                flow(FLOW_IRET, next_pc_);
+                break;
+            case 3: set_rd(rd, irq_mask_); irq_mask_ = a; break;        // maskirq
+            case 4:                                                     // waitirq
+                if (irq_pending_) {
+                    set_rd(rd, irq_pending_);
+                } else {
+                    waiting_ = true;
+                    wait_rd_ = rd;
+                }
+                break;
+            case 5: set_rd(rd, timer_); timer_ = a; timer_last_ = soc_.now; break;   // timer
+            default: return raise_ebreak("illegal instruction");
+        }
+        return t_.alu;
+    }
+
+    void jump(uint32_t target) {
+        next_pc_ = target;
+        hi_addr_ = 1;
+    }
+};
+
+#endif // RVSIM_RV32_CPU_H
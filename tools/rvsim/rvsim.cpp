@@ -0,0 +1,565 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// rvsim.cpp - Instruction-Level Platform Simulator and Cycle Profiler
+//
+// Runs firmware built for the board (ELF or raw .bin) on a functional
+// model of the SoC: PicoRV32 RV32IM(C) with its interrupt extension, the
+// 512 KB SRAM, boot ROM, scratchpad and the MMIO peripherals, with an SD
+// card backed by an image file on the SPI bus. Cycles come from timing.h
+// (PicoRV32 CPI plus the mem_controller.v region latencies), so the
+// numbers are estimates - sim/verilator is the cycle-exact reference - but
+// rvsim runs tens of millions of instructions a second and can profile
+// every function of sd_card_manager or an overlay with a flame graph.
+//
+// UART output goes to stdout, keys on stdin go to UART RX at the current
+// baud rate, the simulator reports on stderr. Options and exit codes are
+// those of sim/verilator/picorv32_sim.
+//
+// Usage: rvsim [options] <firmware.elf|firmware.bin>
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "timing.h"
+#include "elf_image.h"
+#include "sd_card.h"
+#include "soc.h"
+#include "rv32_cpu.h"
+#include "profiler.h"
+
+// stdin is polled this often (system clocks); a key is ~500 clocks at 1 Mbaud
+#define STDIN_POLL_CYCLES   1024
+
+// Exit codes, for scripts (same as picorv32_sim)
+#define EXIT_OK             0   // Ran to --until / --cycles / idle
+#define EXIT_TIMEOUT        1   // --cycles reached before --until text
+#define EXIT_TRAP           2   // CPU trapped (illegal instruction, ebreak)
+#define EXIT_SETUP          3   // Bad arguments or firmware
+
+static volatile sig_atomic_t interrupted = 0;
+static struct termios saved_tty;
+static bool tty_raw = false;
+
+static void on_sigint(int) { interrupted = 1; }
+
+static void tty_restore(void) {
+    if (tty_raw)
+        tcsetattr(STDIN_FILENO, TCSANOW, &saved_tty);
+    tty_raw = false;
+}
+
+// Keys straight through (no line editing, no echo); Ctrl-C still stops
+static void tty_make_raw(void) {
+    if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &saved_tty) != 0)
+        return;
+    struct termios raw = saved_tty;
+    raw.c_lflag &= ~(ICANON | ECHO);
+    raw.c_iflag &= ~(ICRNL | IXON);
+    raw.c_cc[VMIN] = 1;
+    raw.c_cc[VTIME] = 0;
+    tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+    tty_raw = true;
+    atexit(tty_restore);
+}
+
+// -i text: \r \n \t \e \\ and \xHH escapes
+static std::string unescape(const char *s) {
+    std::string out;
+    for (; *s; s++) {
+        if (*s != '\\' || !s[1]) { out += *s; continue; }
+        switch (*++s) {
+            case 'r': out += '\r'; break;
+            case 'n': out += '\n'; break;
+            case 't': out += '\t'; break;
+            case 'e': out += '\x1b'; break;
+            case 'x': {
+                char hex[3] = { 0, 0, 0 };
+                for (int i = 0; i < 2 && isxdigit((unsigned char)s[1]); i++) hex[i] = *++s;
+                out += (char)strtoul(hex, NULL, 16);
+                break;
+            }
+            default: out += *s; break;
+        }
+    }
+    return out;
+}
+
+// .config: the options that change the ISA or the timing
+static bool read_config(const char *path, SimConfig &cfg) {
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return false;
+
+    // Kconfig bools are absent or "# CONFIG_X is not set" when off
+    cfg.compressed = cfg.mul = cfg.div = cfg.fast_mul = false;
+    cfg.barrel = cfg.two_stage = cfg.lookahead = cfg.spi_crc = false;
+    cfg.sram_fast = cfg.dualport = false;
+
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        if (strncmp(line, "CONFIG_", 7) != 0)
+            continue;
+        char *eq = strchr(line, '=');
+        if (!eq)
+            continue;
+        *eq = 0;
+        const char *key = line + 7;
+        const char *val = eq + 1;
+        bool y = val[0] == 'y';
+        uint32_t num = (uint32_t)strtoul(val, NULL, 0);
+
+        if      (strcmp(key, "COMPRESSED_ISA") == 0)   cfg.compressed = y;
+        else if (strcmp(key, "ENABLE_MUL") == 0)       cfg.mul = y;
+        else if (strcmp(key, "ENABLE_DIV") == 0)       cfg.div = y;
+        else if (strcmp(key, "ENABLE_FAST_MUL") == 0)  { cfg.fast_mul = y; cfg.mul |= y; }
+        else if (strcmp(key, "BARREL_SHIFTER") == 0)   cfg.barrel = y;
+        else if (strcmp(key, "TWO_STAGE_SHIFT") == 0)  cfg.two_stage = y;
+        else if (strcmp(key, "REGS_DUALPORT") == 0)    cfg.dualport = y;
+        else if (strcmp(key, "MEM_LOOKAHEAD") == 0)    cfg.lookahead = y;
+        else if (strcmp(key, "SRAM_TIMING_1CYCLE") == 0 ||
+                 strcmp(key, "SRAM_TIMING_BURST") == 0) cfg.sram_fast |= y;
+        else if (strcmp(key, "SPI_HW_CRC") == 0)       cfg.spi_crc = y;
+        else if (strcmp(key, "ATOMIC_UNIT") == 0)      cfg.atomic = y;
+        else if (strcmp(key, "SYS_CLK_HZ") == 0)       cfg.clk_hz = num;
+        else if (strcmp(key, "PROGADDR_IRQ") == 0)     cfg.irq_addr = num;
+        else if (strcmp(key, "SCRATCHPAD_SIZE") == 0)  cfg.spad_size = num;
+        else if (strcmp(key, "TIMER_CHANNELS") == 0)   cfg.timer_chans = num;
+        else if (strcmp(key, "SPI_FIFO_DEPTH") == 0)   cfg.spi_fifo = num;
+        else if (strcmp(key, "UART_RX_BUF_SIZE") == 0) cfg.uart_rx_buf = num;
+        else if (strcmp(key, "ICACHE") == 0 || strcmp(key, "DCACHE") == 0) cfg.caches |= y;
+        else if (strcmp(key, "PCPI_FPU") == 0 && y)
+            fprintf(stderr, "[RVSIM] WARNING: PCPI_FPU is not modelled, FPU instructions trap\n");
+    }
+    fclose(f);
+    if (cfg.caches)
+        fprintf(stderr, "[RVSIM] WARNING: caches are not modelled, every access pays the SRAM latency\n");
+    return true;
+}
+
+static void print_usage(const char *prog) {
+    fprintf(stderr, "PicoRV32 platform simulator and profiler\n\n");
+    fprintf(stderr, "Usage: %s [options] <firmware.elf|firmware.bin>\n\n", prog);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "  -c, --cycles <n>        Stop after n CPU cycles (default: no limit)\n");
+    fprintf(stderr, "  -u, --until <text>      Stop once text has appeared on the UART\n");
+    fprintf(stderr, "  -i, --input <text>      Type text first (\\r \\n \\e \\xHH escapes)\n");
+    fprintf(stderr, "  -w, --when <text> <in>  Type in once text has appeared (repeatable, in order)\n");
+    fprintf(stderr, "  -n, --no-stdin          Do not forward stdin to the UART\n");
+    fprintf(stderr, "  -q, --quiet             No statistics at exit\n");
+    fprintf(stderr, "  -d, --sdcard <img>      SD card image on the SPI bus (written back)\n");
+    fprintf(stderr, "      --sd-readonly       Do not write the SD card image\n");
+    fprintf(stderr, "      --sd-latency <n>    Bytes before an SD read data token (default 16)\n");
+    fprintf(stderr, "      --sd-timing <r,w[,e]>  SD read access / write / erase times in us\n");
+    fprintf(stderr, "  -s, --symbols <elf>[@addr]  More symbols, e.g. an overlay (at addr)\n");
+    fprintf(stderr, "  -p, --profile <file>    Write the flat profile ('-': stderr)\n");
+    fprintf(stderr, "  -f, --folded <file>     Write folded stacks for flamegraph.pl\n");
+    fprintf(stderr, "  -N, --top <n>           Functions in the flat profile (default 40, 0: all)\n");
+    fprintf(stderr, "  -k, --config <file>     Kconfig .config for the CPU options (default ./.config)\n");
+    fprintf(stderr, "      --rom <hex>         Boot ROM image ($readmemh) at 0x40000\n");
+    fprintf(stderr, "      --rvc               COMPRESSED_ISA\n");
+    fprintf(stderr, "      --fast-mul          ENABLE_FAST_MUL\n");
+    fprintf(stderr, "      --no-barrel         No BARREL_SHIFTER\n");
+    fprintf(stderr, "      --dualport          REGS_DUALPORT\n");
+    fprintf(stderr, "      --lookahead         MEM_LOOKAHEAD latencies\n");
+    fprintf(stderr, "  -h, --help              Show this help\n\n");
+    fprintf(stderr, "Examples:\n");
+    fprintf(stderr, "  %s -u 'test complete' -p - firmware/algo_test.elf\n", prog);
+    fprintf(stderr, "  %s -d sd.img -w 'Detect Card' '\\r' -f sd.folded firmware/sd_card_manager.elf\n", prog);
+    fprintf(stderr, "  flamegraph.pl sd.folded > sd.svg\n");
+}
+
+int main(int argc, char **argv) {
+    const char *firmware = NULL;
+    const char *until = NULL;
+    const char *sd_image = NULL;
+    const char *rom_file = NULL;
+    const char *config_file = NULL;
+    const char *profile_file = NULL;
+    const char *folded_file = NULL;
+    std::vector<std::string> extra_syms;
+    std::vector<std::pair<std::string, std::string>> when;
+    std::string input;
+    uint64_t max_cycles = 0;
+    size_t top_n = 40;
+    int sd_latency = -1;
+    const char *sd_timing = NULL;
+    bool sd_readonly = false;
+    bool use_stdin = true;
+    bool quiet = false;
+    bool rvc = false, fast_mul = false, no_barrel = false, lookahead = false, dualport = false;
+
+    // Parse arguments
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        bool has_arg = i + 1 < argc;
+        if (strcmp(a, "-c") == 0 || strcmp(a, "--cycles") == 0) {
+            if (!has_arg) { print_usage(argv[0]); return EXIT_SETUP; }
+            max_cycles = strtoull(argv[++i], NULL, 0);
+        } else if (strcmp(a, "-u") == 0 || strcmp(a, "--until") == 0) {
+            if (!has_arg) { print_usage(argv[0]); return EXIT_SETUP; }
+            until = argv[++i];
+        } else if (strcmp(a, "-i") == 0 || strcmp(a, "--input") == 0) {
+            if (!has_arg) { print_usage(argv[0]); return EXIT_SETUP; }
+            input += unescape(argv[++i]);
+        } else if (strcmp(a, "-w") == 0 || strcmp(a, "--when") == 0) {
+            if (i + 2 >= argc) { print_usage(argv[0]); return EXIT_SETUP; }
+            when.push_back({ argv[i + 1], unescape(argv[i + 2]) });
+            i += 2;
+        } else if (strcmp(a, "-n") == 0 || strcmp(a, "--no-stdin") == 0) {
+            use_stdin = false;
+        } else if (strcmp(a, "-q") == 0 || strcmp(a, "--quiet") == 0) {
+            quiet = true;
+        } else if (strcmp(a, "-d") == 0 || strcmp(a, "--sdcard") == 0) {
+            if (!has_arg) { print_usage(argv[0]); return EXIT_SETUP; }
+            sd_image = argv[++i];
+        } else if (strcmp(a, "--sd-readonly") == 0) {
+            sd_readonly = true;
+        } else if (strcmp(a, "--sd-latency") == 0) {
+            if (!has_arg) { print_usage(argv[0]); return EXIT_SETUP; }
+            sd_latency = atoi(argv[++i]);
+        } else if (strcmp(a, "--sd-timing") == 0) {
+            if (!has_arg) { print_usage(argv[0]); return EXIT_SETUP; }
+            sd_timing = argv[++i];
+        } else if (strcmp(a, "-s") == 0 || strcmp(a, "--symbols") == 0) {
+            if (!has_arg) { print_usage(argv[0]); return EXIT_SETUP; }
+            extra_syms.push_back(argv[++i]);
+        } else if (strcmp(a, "-p") == 0 || strcmp(a, "--profile") == 0) {
+            if (!has_arg) { print_usage(argv[0]); return EXIT_SETUP; }
+            profile_file = argv[++i];
+        } else if (strcmp(a, "-f") == 0 || strcmp(a, "--folded") == 0) {
+            if (!has_arg) { print_usage(argv[0]); return EXIT_SETUP; }
+            folded_file = argv[++i];
+        } else if (strcmp(a, "-N") == 0 || strcmp(a, "--top") == 0) {
+            if (!has_arg) { print_usage(argv[0]); return EXIT_SETUP; }
+            top_n = strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(a, "-k") == 0 || strcmp(a, "--config") == 0) {
+            if (!has_arg) { print_usage(argv[0]); return EXIT_SETUP; }
+            config_file = argv[++i];
+        } else if (strcmp(a, "--rom") == 0) {
+            if (!has_arg) { print_usage(argv[0]); return EXIT_SETUP; }
+            rom_file = argv[++i];
+        } else if (strcmp(a, "--rvc") == 0) {
+            rvc = true;
+        } else if (strcmp(a, "--fast-mul") == 0) {
+            fast_mul = true;
+        } else if (strcmp(a, "--no-barrel") == 0) {
+            no_barrel = true;
+        } else if (strcmp(a, "--lookahead") == 0) {
+            lookahead = true;
+        } else if (strcmp(a, "--dualport") == 0) {
+            dualport = true;
+        } else if (strcmp(a, "-h") == 0 || strcmp(a, "--help") == 0) {
+            print_usage(argv[0]);
+            return EXIT_OK;
+        } else {
+            firmware = a;
+        }
+    }
+
+    if (!firmware) {
+        print_usage(argv[0]);
+        return EXIT_SETUP;
+    }
+
+    // CPU options: .config first, then the command line
+    SimConfig cfg;
+    if (config_file) {
+        if (!read_config(config_file, cfg)) {
+            fprintf(stderr, "[RVSIM] ERROR: cannot read %s\n", config_file);
+            return EXIT_SETUP;
+        }
+    } else if (read_config(".config", cfg)) {
+        config_file = ".config";
+    }
+    if (rvc) cfg.compressed = true;
+    if (fast_mul) cfg.fast_mul = cfg.mul = true;
+    if (no_barrel) cfg.barrel = false;
+    if (lookahead) cfg.lookahead = true;
+    if (dualport) cfg.dualport = true;
+
+    SdCard card;
+    if (sd_latency >= 0)
+        card.read_wait = (uint32_t)sd_latency;
+    if (sd_timing && !card.set_timing(sd_timing)) {
+        fprintf(stderr, "[RVSIM] ERROR: --sd-timing %s: expected read,write[,erase] in us\n", sd_timing);
+        return EXIT_SETUP;
+    }
+    if (sd_image) {
+        std::string err;
+        if (!card.open(sd_image, sd_readonly, err)) {
+            fprintf(stderr, "[RVSIM] ERROR: %s: %s\n", sd_image, err.c_str());
+            return EXIT_SETUP;
+        }
+    }
+
+    Soc soc(cfg, card);
+    if (rom_file) {
+        std::string err = soc.load_rom(rom_file);
+        if (!err.empty()) {
+            fprintf(stderr, "[RVSIM] ERROR: %s\n", err.c_str());
+            return EXIT_SETUP;
+        }
+    }
+
+    std::vector<uint8_t> image;
+    LoadInfo info;
+    std::string err = file_read(firmware, image);
+    if (err.empty())
+        err = firmware_load(image, soc, info);
+    if (!err.empty()) {
+        fprintf(stderr, "[RVSIM] ERROR: %s: %s\n", firmware, err.c_str());
+        return EXIT_SETUP;
+    }
+
+    // Symbols: the firmware, then -s files (overlays) at their own base
+    SymbolTable syms;
+    elf_symbols(image, 0, syms);
+    for (const std::string &spec : extra_syms) {
+        std::string path = spec;
+        uint32_t base = 0;
+        bool rebase = false;
+        size_t at = spec.rfind('@');
+        if (at != std::string::npos) {
+            path = spec.substr(0, at);
+            base = (uint32_t)strtoul(spec.c_str() + at + 1, NULL, 0);
+            rebase = true;
+        }
+        std::vector<uint8_t> elf;
+        std::string e = file_read(path.c_str(), elf);
+        if (e.empty() && (!elf_is_elf(elf) || !elf_check(elf).empty()))
+            e = "not a RISC-V ELF";
+        if (!e.empty()) {
+            fprintf(stderr, "[RVSIM] ERROR: %s: %s\n", path.c_str(), e.c_str());
+            return EXIT_SETUP;
+        }
+        uint32_t offset = rebase ? base - elf_link_base(elf) : 0;
+        int n = elf_symbols(elf, offset, syms);
+        if (!quiet)
+            fprintf(stderr, "[RVSIM] %d symbols from %s\n", n, path.c_str());
+    }
+    syms.finish();
+
+    if (!quiet) {
+        fprintf(stderr, "[RVSIM] Loaded %s: %u bytes, entry 0x%08x\n", firmware, info.bytes, info.entry);
+        fprintf(stderr, "[RVSIM] RV32I%s%s%s%s, %s shifter, %s%s latencies%s%s\n",
+                cfg.mul ? "M" : "", cfg.compressed ? "C" : "", cfg.fast_mul ? " fast-mul" : "",
+                cfg.dualport ? " dual-port regs" : "",
+                cfg.barrel ? "barrel" : "serial", cfg.lookahead ? "look-ahead" : "baseline",
+                cfg.sram_fast ? " 1-cycle SRAM" : "",
+                config_file ? ", from " : "", config_file ? config_file : "");
+        if (card.present())
+            fprintf(stderr, "[RVSIM] SD card %s: %u sectors%s\n", sd_image, card.sectors(),
+                    sd_readonly ? " (read-only)" : "");
+    }
+
+    // Reset: SIMULATION build, CPU starts in SRAM at 0x0 (or the ELF entry)
+    Rv32Cpu cpu(cfg, soc);
+    cpu.pc = elf_is_elf(image) ? info.entry : 0;
+
+    Profiler *prof = NULL;
+    if (profile_file || folded_file) {
+        prof = new Profiler(syms);
+        cpu.observer = prof;
+    }
+
+    for (char c : input)
+        soc.uart_rx((uint8_t)c);
+
+    if (use_stdin)
+        tty_make_raw();
+    signal(SIGINT, on_sigint);
+
+    size_t until_len = until ? strlen(until) : 0;
+    std::string tail;
+    size_t when_next = 0;
+    std::string when_tail;
+    bool until_seen = false;
+    bool trapped = false;
+    bool idle = false;
+    bool stdin_open = use_stdin;
+    uint64_t next_poll = STDIN_POLL_CYCLES;
+
+    auto wall_start = std::chrono::steady_clock::now();
+
+    while (!interrupted) {
+        Rv32Cpu::Status st = cpu.step();
+        if (st == Rv32Cpu::TRAPPED) {
+            trapped = true;
+            break;
+        }
+
+        // waitirq: skip to the next interrupt, or wait for the host
+        if (st == Rv32Cpu::WAITING) {
+            uint64_t t = std::min(soc.next_event(), cpu.next_event());
+            if (t == NEVER) {
+                if (!stdin_open) {
+                    idle = true;
+                    break;
+                }
+                struct pollfd pfd = { STDIN_FILENO, POLLIN, 0 };
+                if (poll(&pfd, 1, 100) > 0)
+                    next_poll = soc.now;
+            } else if (max_cycles && t >= max_cycles) {
+                soc.now = max_cycles;
+            } else if (t > soc.now) {
+                soc.now = t;
+            }
+        }
+
+        if (!soc.uart.tx_out.empty()) {
+            const std::string &out = soc.uart.tx_out;
+            fwrite(out.data(), 1, out.size(), stdout);
+            for (char c : out) {
+                if (until_len) {
+                    tail += c;
+                    if (tail.size() > until_len)
+                        tail.erase(0, tail.size() - until_len);
+                    if (tail == until)
+                        until_seen = true;
+                }
+                if (when_next < when.size()) {
+                    const std::string &w = when[when_next].first;
+                    when_tail += c;
+                    if (when_tail.size() > w.size())
+                        when_tail.erase(0, when_tail.size() - w.size());
+                    if (when_tail == w) {
+                        for (char k : when[when_next].second)
+                            soc.uart_rx((uint8_t)k);
+                        when_next++;
+                        when_tail.clear();
+                    }
+                }
+            }
+            soc.uart.tx_out.clear();
+            if (until_seen)
+                break;
+        }
+
+        if (soc.now >= next_poll) {
+            next_poll = soc.now + STDIN_POLL_CYCLES;
+            fflush(stdout);
+            if (stdin_open && soc.uart.rx_line_idle()) {
+                struct pollfd pfd = { STDIN_FILENO, POLLIN, 0 };
+                if (poll(&pfd, 1, 0) > 0) {
+                    uint8_t buf[64];
+                    ssize_t n = read(STDIN_FILENO, buf, sizeof(buf));
+                    if (n > 0) {
+                        for (ssize_t i = 0; i < n; i++) soc.uart_rx(buf[i]);
+                    } else if (n == 0 || errno != EINTR) {
+                        stdin_open = false;     // EOF: keep running
+                    }
+                }
+            }
+        }
+
+        if (max_cycles && soc.now >= max_cycles)
+            break;
+    }
+    fflush(stdout);
+    tty_restore();
+
+    int rc = EXIT_OK;
+    const char *why = "stopped";
+    if (trapped) { rc = EXIT_TRAP; why = "CPU trap"; }
+    else if (until_seen) why = "--until text seen";
+    else if (interrupted) why = "interrupted";
+    else if (idle) why = "idle (waitirq, nothing pending)";
+    else if (max_cycles && soc.now >= max_cycles) {
+        why = "cycle limit";
+        if (until) rc = EXIT_TIMEOUT;
+    }
+
+    if (trapped)
+        fprintf(stderr, "\n[RVSIM] %s at 0x%08x: insn 0x%08x (%s)\n",
+                cpu.trap_why, cpu.trap_pc, cpu.trap_insn,
+                syms.lookup(cpu.trap_pc) >= 0 ? syms.at(syms.lookup(cpu.trap_pc)).name.c_str() : "?");
+
+    if (!quiet) {
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+        uint64_t fetches = 0, loads = 0, stores = 0, wait = 0;
+        for (int r = 0; r < Soc::R_COUNT; r++) {
+            fetches += soc.stats[r].fetches;
+            loads += soc.stats[r].loads;
+            stores += soc.stats[r].stores;
+            wait += soc.stats[r].wait;
+        }
+        uint64_t total = fetches + loads + stores;
+        fprintf(stderr, "\n[RVSIM] %s after %llu cycles, %llu instructions\n", why,
+                (unsigned long long)soc.now, (unsigned long long)cpu.instret);
+        fprintf(stderr, "[RVSIM]   Fetches:      %llu\n", (unsigned long long)fetches);
+        fprintf(stderr, "[RVSIM]   Loads:        %llu\n", (unsigned long long)loads);
+        fprintf(stderr, "[RVSIM]   Stores:       %llu\n", (unsigned long long)stores);
+        fprintf(stderr, "[RVSIM]   Wait cycles:  %llu\n", (unsigned long long)wait);
+        if (total)
+            fprintf(stderr, "[RVSIM]   Wait/transaction: %.2f\n", (double)wait / total);
+        if (fetches)
+            fprintf(stderr, "[RVSIM]   Cycles/fetch:     %.2f\n", (double)soc.now / fetches);
+        for (int r = 0; r < Soc::R_COUNT; r++) {
+            const Soc::RegionStats &s = soc.stats[r];
+            if (s.fetches + s.loads + s.stores)
+                fprintf(stderr, "[RVSIM]   %-10s  %10llu fetch %10llu load %10llu store %12llu wait\n",
+                        Soc::region_name(r), (unsigned long long)s.fetches,
+                        (unsigned long long)s.loads, (unsigned long long)s.stores,
+                        (unsigned long long)s.wait);
+        }
+        if (soc.uart.stall_clocks)
+            fprintf(stderr, "[RVSIM]   UART TX full: %llu cycles\n", (unsigned long long)soc.uart.stall_clocks);
+        if (soc.spi.bytes)
+            fprintf(stderr, "[RVSIM]   SPI: %llu bytes (%llu by DMA), %llu cycles stalled\n",
+                    (unsigned long long)soc.spi.bytes, (unsigned long long)soc.spi.dma_bytes,
+                    (unsigned long long)soc.spi.stall_clocks);
+        if (card.present())
+            fprintf(stderr, "[RVSIM]   SD: %llu commands, %llu sectors read, %llu written, %llu CRC errors\n",
+                    (unsigned long long)card.commands, (unsigned long long)card.sectors_read,
+                    (unsigned long long)card.sectors_written, (unsigned long long)card.crc_errors);
+        if (card.present() && (card.token_waits || card.busy_polls))
+            fprintf(stderr, "[RVSIM]   SD waits: %llu bytes before data tokens, %llu busy polls\n",
+                    (unsigned long long)card.token_waits, (unsigned long long)card.busy_polls);
+        if (secs > 0)
+            fprintf(stderr, "[RVSIM]   %.1f s wall clock, %.1f MIPS, %.2f MHz simulated\n",
+                    secs, cpu.instret / secs / 1e6, soc.now / secs / 1e6);
+    }
+
+    if (prof) {
+        if (profile_file) {
+            FILE *f = strcmp(profile_file, "-") == 0 ? stderr : fopen(profile_file, "w");
+            if (!f) {
+                fprintf(stderr, "[RVSIM] ERROR: cannot write %s\n", profile_file);
+            } else {
+                if (f == stderr) fputc('\n', f);
+                prof->write_flat(f, top_n);
+                if (f != stderr) fclose(f);
+            }
+        }
+        if (folded_file) {
+            FILE *f = fopen(folded_file, "w");
+            if (!f) {
+                fprintf(stderr, "[RVSIM] ERROR: cannot write %s\n", folded_file);
+            } else {
+                prof->write_folded(f);
+                fclose(f);
+            }
+        }
+        delete prof;
+    }
+
+    return rc;
+}
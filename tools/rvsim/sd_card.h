@@ -0,0 +1,516 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// sd_card.h - rvsim SD Card Model (SPI mode, backed by an image file)
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+//
+// Byte-level model of an SDHC card on the SPI bus: xfer() takes the MOSI
+// byte of one SPI transfer and returns the MISO byte, so byte mode, burst
+// mode (SPI_RX_REPEAT) and SPI DMA all reach it the same way. A bit-level
+// bus (sim/verilator/sd_spi_bridge.h) calls the two halves, shift_out() at
+// the first SCK edge of a byte and shift_in() after the eighth. Covers what
+// firmware/sd_fatfs/sd_spi.c sends: CMD0/8/9/10/12/13/16/17/18/24/25/
+// 32/33/38/55/58/59 and ACMD13/23/41, CMD59 CRC mode included (command
+// CRC7 and write CRC16 are checked, read blocks always carry a CRC16).
+//
+// Timing is in bytes on the bus, since the card only sees SCK: read_wait
+// 0xFF bytes before a data token (NAC), write_busy busy bytes after a data
+// block, erase_busy after CMD38. At 12.5 MHz one byte is 0.64 us.
+//
+// A real card's access and programming times are times, not bytes: a host
+// that polls slowly sees fewer busy bytes, not a longer wait. read_ns,
+// write_ns and erase_ns add that on top, when the bus owner keeps the
+// card's clock (set_time(): rvsim from the CPU cycle count, the Verilator
+// bridge from the simulation time). The data token then waits until read_ns
+// after the command (or after the previous block of a CMD18), and the card
+// stays busy until write_ns after each data response, however many polls
+// that takes. sim/sd_card_model.v models the same card for ModelSim.
+//
+// The image is read into memory at open() and written back sector by
+// sector, so an image built with mkfs.vfat / the sd_card_manager format
+// command stays usable on the host afterwards.
+//
+//==============================================================================
+
+#ifndef RVSIM_SD_CARD_H
+#define RVSIM_SD_CARD_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <vector>
+
+class SdCard {
+public:
+    uint32_t read_wait = 16;        // 0xFF bytes before a read data token
+    uint32_t write_busy = 256;      // Busy bytes after a written block
+    uint32_t erase_busy = 1024;     // Busy bytes after CMD38
+    uint64_t read_ns = 0;           // Access time to a data token, 0 = bytes only
+    uint64_t write_ns = 0;          // Programming time per written block
+    uint64_t erase_ns = 0;          // Busy time after CMD38
+
+    // Simulated time, for the *_ns settings
+    void set_time(uint64_t ns) { now_ns_ = ns; }
+
+    // "read,write[,erase]" in microseconds (--sd-timing)
+    bool set_timing(const char *spec) {
+        double r = 0, w = 0, e = 0;
+        int n = std::sscanf(spec, "%lf,%lf,%lf", &r, &w, &e);
+        if (n < 2 || r < 0 || w < 0 || e < 0)
+            return false;
+        read_ns = (uint64_t)(r * 1000);
+        write_ns = (uint64_t)(w * 1000);
+        erase_ns = n == 3 ? (uint64_t)(e * 1000) : write_ns * 4;
+        return true;
+    }
+
+    ~SdCard() {
+        if (file_)
+            std::fclose(file_);
+    }
+
+    bool open(const char *path, bool read_only, std::string &err) {
+        file_ = std::fopen(path, read_only ? "rb" : "r+b");
+        if (!file_) {
+            err = std::string("cannot open ") + path;
+            return false;
+        }
+        read_only_ = read_only;
+        std::fseek(file_, 0, SEEK_END);
+        long size = std::ftell(file_);
+        std::fseek(file_, 0, SEEK_SET);
+
+        // CSD v2 counts capacity in 512 KB units
+        sectors_ = (uint32_t)(size / 512) & ~1023u;
+        if (sectors_ == 0) {
+            err = "image smaller than 512 KB";
+            return false;
+        }
+        data_.resize((size_t)sectors_ * 512);
+        if (std::fread(data_.data(), 1, data_.size(), file_) != data_.size()) {
+            err = "cannot read image";
+            return false;
+        }
+        if ((uint64_t)size != (uint64_t)sectors_ * 512)
+            std::fprintf(stderr, "[RVSIM] SD image: using the first %u sectors (512 KB multiple)\n",
+                         sectors_);
+        build_registers();
+        return true;
+    }
+
+    bool present() const { return !data_.empty(); }
+    uint32_t sectors() const { return sectors_; }
+
+    // CS low = selected. Deselecting ends a data transfer in progress.
+    void select(bool selected) {
+        if (selected == selected_)
+            return;
+        selected_ = selected;
+        if (!selected) {
+            cmd_len_ = 0;
+            clear_out();
+            state_ = IDLE;
+        }
+    }
+
+    // One byte on the bus
+    uint8_t xfer(uint8_t mosi) {
+        uint8_t miso = shift_out();
+        shift_in(mosi);
+        return miso;
+    }
+
+    // First half of a byte: what the card drives on MISO. Depends only on
+    // the bytes received before, as on a real card.
+    uint8_t shift_out() {
+        miso_ = 0xFF;
+        if (!selected_ || !present())
+            return miso_;
+
+        switch (state_) {
+            case RX_DATA:
+                break;
+            case READ_MULTI:
+                if (out_.empty()) {
+                    if (sector_ >= sectors_) {
+                        state_ = IDLE;
+                        break;
+                    }
+                    queue_block(&data_[(size_t)sector_ * 512], 512, read_wait);
+                    sector_++;
+                    sectors_read++;
+                }
+                miso_ = pop();
+                break;
+            default:
+                if (!out_.empty())
+                    miso_ = pop();
+                else if (busy_ || now_ns_ < busy_until_) {
+                    if (busy_)
+                        busy_--;
+                    busy_polls++;
+                    miso_ = 0x00;
+                }
+                break;
+        }
+        return miso_;
+    }
+
+    // Second half: the byte the host sent
+    void shift_in(uint8_t mosi) {
+        if (!selected_ || !present())
+            return;
+
+        switch (state_) {
+            case RX_TOKEN:   rx_token(mosi); break;
+            case RX_DATA:    rx_data(mosi); break;
+            case READ_MULTI: read_multi(mosi); break;
+            default:         collect(mosi); break;
+        }
+    }
+
+    // Statistics
+    uint64_t commands = 0;
+    uint64_t sectors_read = 0;
+    uint64_t sectors_written = 0;
+    uint64_t crc_errors = 0;
+    uint64_t token_waits = 0;       // 0xFF bytes sent before data tokens
+    uint64_t busy_polls = 0;        // Busy bytes sent
+
+private:
+    enum State { IDLE, RX_TOKEN, RX_DATA, READ_MULTI };
+
+    FILE *file_ = nullptr;
+    bool read_only_ = false;
+    std::vector<uint8_t> data_;
+    uint32_t sectors_ = 0;
+
+    bool selected_ = false;
+    State state_ = IDLE;
+    bool idle_ = true;              // R1 in-idle bit until ACMD41 completes
+    bool app_cmd_ = false;
+    bool crc_on_ = false;
+    int acmd41_count_ = 0;
+
+    uint8_t cmd_[6];
+    int cmd_len_ = 0;
+    std::deque<uint8_t> out_;
+    uint8_t miso_ = 0xFF;           // Byte of the transfer in progress
+    uint32_t busy_ = 0;             // Busy (0x00) bytes still to send
+    uint64_t now_ns_ = 0;
+    uint64_t busy_until_ = 0;       // Busy until then as well (write_ns, erase_ns)
+    long token_at_ = -1;            // Index of a data token in out_, -1: none
+    uint64_t token_until_ = 0;      // Held back until then (read_ns)
+
+    uint32_t sector_ = 0;           // Next sector of a multi-block transfer
+    bool multi_ = false;
+    uint8_t block_[514];
+    uint32_t block_len_ = 0;
+
+    uint32_t erase_start_ = 0, erase_end_ = 0;
+
+    uint8_t csd_[16], cid_[16];
+
+    uint8_t pop() {
+        if (token_at_ == 0 && now_ns_ < token_until_) {
+            token_waits++;
+            return 0xFF;                        // Access time not over yet
+        }
+        uint8_t b = out_.front();
+        out_.pop_front();
+        if (token_at_ >= 0)
+            token_at_--;
+        if (b == 0xFF && token_at_ >= 0)
+            token_waits++;
+        return b;
+    }
+
+    void clear_out() {
+        out_.clear();
+        token_at_ = -1;
+    }
+
+    static uint8_t crc7(const uint8_t *p, int n) {
+        uint8_t crc = 0;
+        for (int i = 0; i < n; i++) {
+            uint8_t b = p[i];
+            for (int j = 0; j < 8; j++) {
+                crc <<= 1;
+                if ((b ^ crc) & 0x80)
+                    crc ^= 0x09;
+                b <<= 1;
+            }
+        }
+        return crc & 0x7F;
+    }
+
+    static uint16_t crc16(const uint8_t *p, int n) {
+        uint16_t crc = 0;
+        for (int i = 0; i < n; i++) {
+            crc ^= (uint16_t)p[i] << 8;
+            for (int j = 0; j < 8; j++)
+                crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+        return crc;
+    }
+
+    void build_registers() {
+        // CSD v2.0: TRAN_SPEED 25 MHz, CCC with class 5 (erase), 512-byte blocks
+        uint32_t c_size = sectors_ / 1024 - 1;
+        const uint8_t csd[15] = { 0x40, 0x0E, 0x00, 0x32, 0x5B, 0x59, 0x00,
+                                  (uint8_t)((c_size >> 16) & 0x3F), (uint8_t)(c_size >> 8),
+                                  (uint8_t)c_size, 0x7F, 0x80, 0x0A, 0x40, 0x00 };
+        for (int i = 0; i < 15; i++)
+            csd_[i] = csd[i];
+        csd_[15] = (uint8_t)(crc7(csd_, 15) << 1 | 1);
+
+        const uint8_t cid[15] = { 0x52, 'R', 'V', 'S', 'I', 'M', 'S', 'D', 0x10,
+                                  0x12, 0x34, 0x56, 0x78, 0x01, 0x9A };
+        for (int i = 0; i < 15; i++)
+            cid_[i] = cid[i];
+        cid_[15] = (uint8_t)(crc7(cid_, 15) << 1 | 1);
+    }
+
+    void queue_block(const uint8_t *p, uint32_t n, uint32_t wait) {
+        for (uint32_t i = 0; i < wait; i++)
+            out_.push_back(0xFF);
+        token_at_ = (long)out_.size();
+        token_until_ = now_ns_ + read_ns;
+        out_.push_back(0xFE);
+        out_.insert(out_.end(), p, p + n);
+        uint16_t crc = crc16(p, (int)n);
+        out_.push_back((uint8_t)(crc >> 8));
+        out_.push_back((uint8_t)crc);
+    }
+
+    void collect(uint8_t mosi) {
+        // A command starts with 01xxxxxx; 0xFF fill bytes are ignored
+        if (cmd_len_ == 0 && (mosi & 0xC0) != 0x40)
+            return;
+        cmd_[cmd_len_++] = mosi;
+        if (cmd_len_ == 6) {
+            cmd_len_ = 0;
+            command();
+        }
+    }
+
+    void r1(uint8_t flags) {
+        out_.push_back(0xFF);                   // NCR: one byte
+        out_.push_back((uint8_t)(flags | (idle_ ? 0x01 : 0x00)));
+    }
+
+    void command() {
+        uint8_t cmd = cmd_[0] & 0x3F;
+        uint32_t arg = (uint32_t)cmd_[1] << 24 | cmd_[2] << 16 | cmd_[3] << 8 | cmd_[4];
+        bool app = app_cmd_;
+        app_cmd_ = false;
+        commands++;
+        clear_out();
+        busy_ = 0;
+        busy_until_ = 0;
+
+        // CMD0 and CMD8 always carry a valid CRC, everything else in CRC mode
+        if ((crc_on_ || cmd == 0 || cmd == 8) && (cmd_[5] >> 1) != crc7(cmd_, 5)) {
+            crc_errors++;
+            r1(0x08);                           // Command CRC error
+            return;
+        }
+
+        if (app) {
+            switch (cmd) {
+                case 41:                        // SD_SEND_OP_COND: ready on the second try
+                    if (++acmd41_count_ >= 2)
+                        idle_ = false;
+                    r1(0);
+                    return;
+                case 13:                        // SD_STATUS (R2 + 64-byte block)
+                    r1(0);
+                    out_.push_back(0x00);
+                    {
+                        uint8_t status[64] = { 0 };
+                        queue_block(status, 64, read_wait);
+                    }
+                    return;
+                case 23:                        // SET_WR_BLK_ERASE_COUNT
+                    r1(0);
+                    return;
+                default:
+                    break;
+            }
+        }
+
+        switch (cmd) {
+            case 0:                             // GO_IDLE_STATE
+                idle_ = true;
+                crc_on_ = false;
+                acmd41_count_ = 0;
+                r1(0);
+                break;
+            case 8:                             // SEND_IF_COND: echo voltage and pattern
+                r1(0);
+                out_.push_back(0x00);
+                out_.push_back(0x00);
+                out_.push_back((uint8_t)((arg >> 8) & 0x0F));
+                out_.push_back((uint8_t)arg);
+                break;
+            case 9:                             // SEND_CSD
+                r1(0);
+                queue_block(csd_, 16, 1);
+                break;
+            case 10:                            // SEND_CID
+                r1(0);
+                queue_block(cid_, 16, 1);
+                break;
+            case 12:                            // STOP_TRANSMISSION (outside a read)
+                r1(0);
+                break;
+            case 13:                            // SEND_STATUS (R2)
+                r1(0);
+                out_.push_back(0x00);
+                break;
+            case 16:                            // SET_BLOCKLEN: SDHC is fixed at 512
+                r1(arg == 512 ? 0 : 0x40);
+                break;
+            case 17:                            // READ_SINGLE_BLOCK
+            case 18:                            // READ_MULTIPLE_BLOCK
+                if (arg >= sectors_) {
+                    r1(0x40);                   // Parameter error
+                    break;
+                }
+                r1(0);
+                queue_block(&data_[(size_t)arg * 512], 512, read_wait);
+                sectors_read++;
+                if (cmd == 18) {
+                    sector_ = arg + 1;
+                    state_ = READ_MULTI;
+                }
+                break;
+            case 24:                            // WRITE_BLOCK
+            case 25:                            // WRITE_MULTIPLE_BLOCK
+                if (arg >= sectors_) {
+                    r1(0x40);
+                    break;
+                }
+                r1(0);
+                sector_ = arg;
+                multi_ = (cmd == 25);
+                state_ = RX_TOKEN;
+                break;
+            case 32:                            // ERASE_WR_BLK_START_ADDR
+                erase_start_ = arg;
+                r1(0);
+                break;
+            case 33:                            // ERASE_WR_BLK_END_ADDR
+                erase_end_ = arg;
+                r1(0);
+                break;
+            case 38:                            // ERASE: contents read back as 0
+                if (erase_end_ < erase_start_ || erase_end_ >= sectors_) {
+                    r1(0x20);                   // Erase sequence error
+                    break;
+                }
+                r1(0);
+                for (uint32_t s = erase_start_; s <= erase_end_; s++) {
+                    std::fill(&data_[(size_t)s * 512], &data_[(size_t)s * 512] + 512, 0);
+                    write_back(s);
+                }
+                busy_ = erase_busy;
+                busy_until_ = now_ns_ + erase_ns;
+                break;
+            case 55:                            // APP_CMD
+                app_cmd_ = true;
+                r1(0);
+                break;
+            case 58:                            // READ_OCR: powered up, CCS (SDHC)
+                r1(0);
+                out_.push_back(0xC0);
+                out_.push_back(0xFF);
+                out_.push_back(0x80);
+                out_.push_back(0x00);
+                break;
+            case 59:                            // CRC_ON_OFF
+                crc_on_ = arg & 1;
+                r1(0);
+                break;
+            default:
+                r1(0x04);                       // Illegal command
+                break;
+        }
+    }
+
+    // CMD18: blocks follow each other (shift_out) until CMD12
+    void read_multi(uint8_t mosi) {
+        if (cmd_len_ == 0 && (mosi & 0xC0) != 0x40)
+            return;
+        cmd_[cmd_len_++] = mosi;
+        if (cmd_len_ < 6)
+            return;
+        cmd_len_ = 0;
+        if ((cmd_[0] & 0x3F) == 12) {
+            commands++;
+            // Stuff byte, R1, then briefly busy
+            state_ = IDLE;
+            clear_out();
+            out_.push_back(0xFF);
+            out_.push_back(0x00);
+            busy_ = 2;
+        }
+    }
+
+    // CMD24/25: wait for a data token (0xFE single, 0xFC multi, 0xFD stop)
+    void rx_token(uint8_t mosi) {
+        if (miso_ != 0xFF)
+            return;                             // Still answering or busy
+        if (mosi == (multi_ ? 0xFC : 0xFE)) {
+            block_len_ = 0;
+            state_ = RX_DATA;
+        } else if (multi_ && mosi == 0xFD) {
+            state_ = IDLE;
+            busy_ = write_busy;
+            busy_until_ = now_ns_ + write_ns;
+            out_.push_back(0xFF);               // One byte before busy
+        }
+    }
+
+    void rx_data(uint8_t mosi) {
+        block_[block_len_++] = mosi;
+        if (block_len_ < 514)
+            return;
+
+        uint16_t crc = (uint16_t)(block_[512] << 8 | block_[513]);
+        if (crc_on_ && crc != crc16(block_, 512)) {
+            crc_errors++;
+            out_.push_back(0x0B);               // Data rejected: CRC error
+            state_ = multi_ ? RX_TOKEN : IDLE;
+            return;
+        }
+
+        if (!read_only_) {
+            std::copy(block_, block_ + 512, &data_[(size_t)sector_ * 512]);
+            write_back(sector_);
+        }
+        sectors_written++;
+        sector_++;
+        out_.push_back(0x05);                   // Data accepted
+        busy_ = write_busy;
+        busy_until_ = now_ns_ + write_ns;
+        state_ = (multi_ && sector_ < sectors_) ? RX_TOKEN : IDLE;
+    }
+
+    void write_back(uint32_t sector) {
+        if (read_only_ || !file_)
+            return;
+        std::fseek(file_, (long)sector * 512, SEEK_SET);
+        std::fwrite(&data_[(size_t)sector * 512], 1, 512, file_);
+        std::fflush(file_);
+    }
+};
+
+#endif // RVSIM_SD_CARD_H
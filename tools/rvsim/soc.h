@@ -0,0 +1,333 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// soc.h - rvsim Memory Map, Bus Timing and Interrupt Sources
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+//
+// The mem_controller.v address decode:
+//
+//   0x00000000-0x0007FFFF  SRAM (512 KB)
+//   0x00040000-0x00041FFF  Boot ROM for reads and fetches, writes go to SRAM
+//   0x00080000-           Scratchpad (SCRATCHPAD_SIZE bytes)
+//   0x80000000-0x800003FF  MMIO
+//   anything else          Reads 0, writes ignored
+//
+// Every transaction adds its region's wait cycles to `now` (timing.h) and
+// is counted per region for the statistics. Loads and fetches are word
+// reads, as PicoRV32 issues them; stores carry PicoRV32's byte strobes.
+//
+//==============================================================================
+
+#ifndef RVSIM_SOC_H
+#define RVSIM_SOC_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "peripherals.h"
+#include "timing.h"
+
+class Soc {
+public:
+    static const uint32_t SRAM_SIZE  = 0x80000;
+    static const uint32_t ROM_BASE   = 0x40000;
+    static const uint32_t ROM_SIZE   = 0x2000;
+    static const uint32_t SPAD_BASE  = 0x80000;
+    static const uint32_t MMIO_BASE  = 0x80000000;
+
+    enum Region { R_SRAM, R_ROM, R_SPAD, R_MMIO, R_INVALID, R_COUNT };
+
+    struct RegionStats {
+        uint64_t fetches = 0, loads = 0, stores = 0, wait = 0;
+    };
+
+    Soc(const SimConfig &cfg, SdCard &card)
+        : sram(SRAM_SIZE, 0), rom(ROM_SIZE, 0), spad(std::min<uint32_t>(cfg.spad_size, 0x2000), 0),
+          uart(cfg.clk_hz, cfg.uart_rx_buf), spi(card, sram, cfg.clk_hz, cfg.spi_fifo, cfg.spi_crc),
+          mem_dma(sram), atomic(cfg.atomic), timers(1 + cfg.timer_chans), cfg_(cfg),
+          lat_(cfg.lookahead, cfg.sram_fast) {}
+
+    uint64_t now = 0;
+
+    std::vector<uint8_t> sram;
+    std::vector<uint8_t> rom;
+    std::vector<uint8_t> spad;
+
+    UartModel   uart;
+    SpiModel    spi;
+    MemDmaModel mem_dma;
+    Crc32Model  crc32;
+    AtomicModel atomic;
+    IrqcModel   irqc;
+    std::vector<TimerModel> timers;
+
+    uint32_t leds = 0;
+    uint32_t buttons = 0;
+    RegionStats stats[R_COUNT];
+
+    // Loader access: SRAM (including under the ROM) and scratchpad
+    bool poke(uint32_t addr, uint8_t v) {
+        if (addr < SRAM_SIZE) {
+            sram[addr] = v;
+            return true;
+        }
+        if (addr - SPAD_BASE < spad.size()) {
+            spad[addr - SPAD_BASE] = v;
+            return true;
+        }
+        return false;
+    }
+
+    // $readmemh image of bootloader_rom.v (one 32-bit word per line)
+    std::string load_rom(const char *path) {
+        FILE *f = std::fopen(path, "r");
+        if (!f)
+            return std::string("cannot open ") + path;
+        char line[128];
+        uint32_t i = 0;
+        while (std::fgets(line, sizeof(line), f) && i + 4 <= ROM_SIZE) {
+            char *end;
+            unsigned long w = std::strtoul(line, &end, 16);
+            if (end == line)
+                continue;
+            for (int b = 0; b < 4; b++)
+                rom[i + b] = (uint8_t)(w >> (8 * b));
+            i += 4;
+        }
+        std::fclose(f);
+        return "";
+    }
+
+    uint32_t fetch(uint32_t addr) {
+        Region r = region(addr, false);
+        stats[r].fetches++;
+        wait(r, lat_read(r));
+        return mem_rd(r, addr & ~3u);
+    }
+
+    uint32_t load(uint32_t addr) {
+        Region r = region(addr, false);
+        stats[r].loads++;
+        wait(r, lat_read(r));
+        if (r == R_MMIO) {
+            quiet_until_ = 0;
+            return mmio_read(addr & ~3u);
+        }
+        return mem_rd(r, addr & ~3u);
+    }
+
+    void store(uint32_t addr, uint32_t wdata, uint32_t wstrb) {
+        Region r = region(addr, true);
+        stats[r].stores++;
+        uint32_t lat = lat_.mmio;
+        switch (r) {
+            case R_SRAM:    lat = (wstrb == 0xF || wstrb == 0x3 || wstrb == 0xC) ?
+                                  lat_.sram_write : lat_.sram_byte_write; break;
+            case R_SPAD:    lat = lat_.spad; break;
+            case R_INVALID: lat = lat_.invalid; break;
+            default:        break;
+        }
+        wait(r, lat);
+        addr &= ~3u;
+
+        switch (r) {
+            case R_SRAM:
+                for (int b = 0; b < 4; b++)
+                    if (wstrb & (1u << b)) sram[addr + b] = (uint8_t)(wdata >> (8 * b));
+                break;
+            case R_SPAD:
+                for (int b = 0; b < 4; b++)
+                    if ((wstrb & (1u << b)) && addr - SPAD_BASE + b < spad.size())
+                        spad[addr - SPAD_BASE + b] = (uint8_t)(wdata >> (8 * b));
+                break;
+            case R_MMIO:
+                quiet_until_ = 0;
+                mmio_write(addr, wdata, wstrb);
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Host keyboard / --input into UART RX
+    void uart_rx(uint8_t c) {
+        uart.send(c, now);
+        quiet_until_ = 0;
+    }
+
+    // CPU IRQ inputs: sources gated by the controller's ENABLE. Nothing
+    // changes before the next peripheral event or MMIO access, so between
+    // those only the (level) result of the last evaluation is returned.
+    uint32_t irq_lines() {
+        if (now < quiet_until_)
+            return levels_;
+        uint32_t src = pulses_ | uart.irq_levels(now);
+        pulses_ = 0;
+        if (timers[0].update(now)) src |= 1u << 0;
+        for (size_t i = 1; i < timers.size(); i++)
+            if (timers[i].update(now)) src |= 1u << 7;
+        if (spi.take_irq(now)) src |= 1u << 2;
+        if (mem_dma.take_irq(now)) src |= 1u << 3;
+        uint32_t lines = irqc.gate(src);
+        levels_ = lines & IrqcModel::LEVEL_MASK;
+        quiet_until_ = next_event();
+        return lines;
+    }
+
+    // Earliest clock a peripheral raises an interrupt (waitirq fast-forward)
+    uint64_t next_event() const {
+        uint64_t t = uart.next_event(now);
+        for (const TimerModel &tm : timers)
+            t = std::min(t, tm.next_event());
+        t = std::min(t, spi.next_event());
+        t = std::min(t, mem_dma.next_event());
+        return t;
+    }
+
+    static const char *region_name(int r) {
+        static const char *names[R_COUNT] = { "SRAM", "Boot ROM", "Scratchpad", "MMIO", "Unmapped" };
+        return names[r];
+    }
+
+private:
+    const SimConfig &cfg_;
+    MemLatency lat_;
+    uint32_t pulses_ = 0;                       // IRQ pulses raised by MMIO writes
+    uint32_t levels_ = 0;                       // Level inputs at the last evaluation
+    uint64_t quiet_until_ = 0;
+    uint32_t us_hi_latch_ = 0;
+
+    Region region(uint32_t addr, bool write) const {
+        if (addr >= MMIO_BASE)
+            return addr < MMIO_BASE + 0x400 ? R_MMIO : R_INVALID;
+        if (addr < SRAM_SIZE)
+            return (!write && addr - ROM_BASE < ROM_SIZE) ? R_ROM : R_SRAM;
+        if (addr - SPAD_BASE < spad.size())
+            return R_SPAD;
+        return R_INVALID;
+    }
+
+    uint32_t lat_read(Region r) const {
+        switch (r) {
+            case R_SRAM: return lat_.sram_read;
+            case R_ROM:  return lat_.boot_read;
+            case R_SPAD: return lat_.spad;
+            case R_MMIO: return lat_.mmio;
+            default:     return lat_.invalid;
+        }
+    }
+
+    void wait(Region r, uint32_t latency) {
+        uint32_t w = latency ? latency - 1 : 0;
+        now += w;
+        stats[r].wait += w;
+    }
+
+    static uint32_t rd32(const std::vector<uint8_t> &m, uint32_t off) {
+        if (off + 4 > m.size())
+            return 0;
+        return m[off] | m[off + 1] << 8 | m[off + 2] << 16 | (uint32_t)m[off + 3] << 24;
+    }
+
+    uint32_t mem_rd(Region r, uint32_t addr) const {
+        switch (r) {
+            case R_SRAM: return rd32(sram, addr);
+            case R_ROM:  return rd32(rom, addr - ROM_BASE);
+            case R_SPAD: return rd32(spad, addr - SPAD_BASE);
+            default:     return 0;
+        }
+    }
+
+    // Timer channel for an address, or -1 (channel 0 at 0x20, n at 0x140 + n*0x20)
+    int timer_index(uint32_t off) const {
+        if (off >= 0x20 && off < 0x38)
+            return 0;
+        if (off >= 0x160) {
+            uint32_t n = (off - 0x140) / 0x20;
+            if (n < timers.size() && (off & 0x1F) < 0x18)
+                return (int)n;
+        }
+        return -1;
+    }
+
+    uint32_t mmio_read(uint32_t addr) {
+        uint32_t off = addr - MMIO_BASE;
+        int t = timer_index(off);
+        if (t >= 0)
+            return timers[t].read(off, now);
+
+        if (off < 0x10 || (off >= 0x120 && off < 0x138))
+            return uart.read(addr, now);
+        if ((off >= 0x50 && off < 0x60) || (off >= 0xC0 && off < 0xF0)) {
+            uint64_t before = now;
+            uint32_t v = spi.read(addr, now);
+            stats[R_MMIO].wait += now - before;
+            return v;
+        }
+        if (off >= 0xF0 && off < 0x100)
+            return crc32.read(off);
+        if (off >= 0x100 && off < 0x118)
+            return mem_dma.read(off, now);
+        if (off >= 0x140 && off < 0x150)
+            return irqc.read(off);
+        if (off >= 0x300)
+            return atomic.read(off);
+
+        uint64_t per_us = cfg_.clk_hz / 1000000;
+        switch (off) {
+            case 0x10: return leds;
+            case 0x18: return buttons;
+            case 0x150: {                       // Reading US_LO latches US_HI
+                uint64_t us = now / per_us;
+                us_hi_latch_ = (uint32_t)(us >> 32);
+                return (uint32_t)us;
+            }
+            case 0x154: return us_hi_latch_;
+            case 0x158: return (uint32_t)(now / (per_us * 1000));
+            case 0x15C: return 0x80000000u | (cfg_.clk_hz / 1000);
+            default:    return 0;               // Cache control, PMU: not present
+        }
+    }
+
+    void mmio_write(uint32_t addr, uint32_t data, uint32_t wstrb) {
+        uint32_t off = addr - MMIO_BASE;
+        int t = timer_index(off);
+        if (t >= 0) {
+            timers[t].write(off, data, wstrb, now);
+            return;
+        }
+
+        if (off < 0x10 || (off >= 0x120 && off < 0x138)) {
+            uint64_t stall = uart.write(addr, data, wstrb, now);
+            now += stall;
+            stats[R_MMIO].wait += stall;
+        } else if ((off >= 0x50 && off < 0x60) || (off >= 0xC0 && off < 0xF0)) {
+            uint64_t before = now;
+            spi.write(addr, data, wstrb, now);
+            stats[R_MMIO].wait += now - before;
+        } else if (off >= 0xF0 && off < 0x100) {
+            crc32.write(off, data, wstrb);
+        } else if (off >= 0x100 && off < 0x118) {
+            mem_dma.write(off, data, now);
+        } else if (off >= 0x140 && off < 0x150) {
+            irqc.write(off, data, wstrb);
+        } else if (off >= 0x300) {
+            atomic.write(off, data, wstrb);
+        } else if (off == 0x10) {
+            if (wstrb & 1) leds = data & 3;
+        } else if (off == 0x40) {
+            pulses_ |= 1u << 1;                 // Software IRQ
+        }
+    }
+};
+
+#endif // RVSIM_SOC_H
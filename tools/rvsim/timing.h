@@ -0,0 +1,117 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// timing.h - rvsim Cycle Costs (PicoRV32 CPI + mem_controller latencies)
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+//
+// An instruction costs its PicoRV32 execute CPI plus the wait cycles of
+// every bus transaction it makes (fetch, load, store). The CPI figures are
+// PicoRV32's own (README, ENABLE_REGS_DUALPORT) and assume a memory that
+// answers one cycle after mem_valid; without REGS_DUALPORT an instruction
+// with a second source register pays the ld_rs2 cycle on top. The latencies are the CPU-visible ones
+// from MEMORY_ARCHITECTURE.md (Look-Ahead Interface table: mem_valid to
+// mem_ready through mem_controller and sram_controller), so a transaction
+// waits latency - 1 cycles on top. The 1-cycle SRAM timing profiles take
+// the controller's savings off the SRAM figures; the burst profile's
+// sequential reads are not modelled (it counts as 1-cycle).
+//
+// Not modelled: the I/D-caches (every access pays the SRAM latency) and
+// DMA engines competing with the CPU for SRAM.
+//
+//==============================================================================
+
+#ifndef RVSIM_TIMING_H
+#define RVSIM_TIMING_H
+
+#include <cstdint>
+
+// Kconfig options that change the timing or the ISA (.config names)
+struct SimConfig {
+    bool     compressed  = false;       // COMPRESSED_ISA
+    bool     mul         = true;        // ENABLE_MUL
+    bool     div         = true;        // ENABLE_DIV
+    bool     fast_mul    = false;       // ENABLE_FAST_MUL
+    bool     barrel      = true;        // BARREL_SHIFTER
+    bool     two_stage   = true;        // TWO_STAGE_SHIFT (without barrel shifter)
+    bool     dualport    = false;       // REGS_DUALPORT
+    bool     lookahead   = false;       // MEM_LOOKAHEAD
+    bool     sram_fast   = false;       // SRAM_TIMING_1CYCLE or SRAM_TIMING_BURST
+    uint32_t clk_hz      = 50000000;    // SYS_CLK_HZ
+    uint32_t irq_addr    = 0x00000010;  // PROGADDR_IRQ
+    uint32_t spad_size   = 4096;        // SCRATCHPAD_SIZE
+    uint32_t timer_chans = 3;           // TIMER_CHANNELS
+    uint32_t spi_fifo    = 128;         // SPI_FIFO_DEPTH (words)
+    bool     spi_crc     = true;        // SPI_HW_CRC
+    bool     atomic      = false;       // ATOMIC_UNIT
+    uint32_t uart_rx_buf = 512;         // UART_RX_BUF_SIZE
+    bool     caches      = false;       // ICACHE or DCACHE (warned about, not modelled)
+};
+
+// CPU-visible latency per region, cycles from mem_valid to mem_ready
+struct MemLatency {
+    uint32_t sram_read;
+    uint32_t sram_write;                // Word, or aligned halfword
+    uint32_t sram_byte_write;           // Read-modify-write
+    uint32_t boot_read;
+    uint32_t mmio;
+    uint32_t spad;
+    uint32_t invalid;
+
+    MemLatency(bool lookahead, bool sram_fast) {
+        // MEMORY_ARCHITECTURE.md: baseline / look-ahead, 2-cycle SRAM timing
+        sram_read       = lookahead ?  8 :  9;
+        sram_write      = lookahead ? 10 : 11;
+        sram_byte_write = lookahead ? 13 : 14;
+        if (sram_fast) {
+            // SRAM Timing Profiles table: 1-cycle controller savings
+            sram_read       -= 1;
+            sram_write      -= 2;
+            sram_byte_write -= 2;
+        }
+        boot_read       = lookahead ?  2 :  3;
+        mmio            = lookahead ?  1 :  2;
+        spad            = 1;
+        invalid         = 1;    // 0 with look-ahead: no wait either way
+    }
+};
+
+// PicoRV32 execute cycles with single-cycle memory
+struct CpuTiming {
+    uint32_t alu          = 3;          // LUI/AUIPC, reg+imm, reg+reg, CSR, custom
+    uint32_t branch       = 3;          // Not taken
+    uint32_t branch_taken = 5;
+    uint32_t jal          = 3;
+    uint32_t jalr         = 6;
+    uint32_t load         = 5;
+    uint32_t store        = 5;
+    uint32_t mul;                       // pcpi_mul sequential / pcpi_fast_mul
+    uint32_t div          = 40;         // pcpi_div
+    uint32_t irq_entry    = 3;          // q0/q1 writes before the vector fetch
+    uint32_t rs2;                       // ld_rs2: reg+reg ALU op, branch, store, MUL/DIV
+
+    explicit CpuTiming(const SimConfig &cfg) {
+        mul = cfg.fast_mul ? 7 : 40;
+        rs2 = cfg.dualport ? 0 : 1;
+        branch       += rs2;
+        branch_taken += rs2;
+        store        += rs2;
+        mul          += rs2;
+        div          += rs2;
+    }
+
+    // Shifts: one cycle with the barrel shifter, else 4 (or 1) bits per cycle
+    uint32_t shift(const SimConfig &cfg, uint32_t amount) const {
+        if (cfg.barrel)
+            return alu;
+        if (cfg.two_stage)
+            return alu + 1 + amount / 4 + amount % 4;
+        return alu + 1 + amount;
+    }
+};
+
+#endif // RVSIM_TIMING_H
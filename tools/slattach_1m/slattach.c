@@ -4,7 +4,22 @@
  * Simplified version with high-speed baud rate support (up to 4 Mbaud)
  * Based on net-tools slattach 2.10
  *
- * Usage: slattach [-p protocol] [-s speed] [-L] [-d] tty
+ * Usage: slattach [-p protocol] [-s speed] [-n max-speed] [-l] [-i secs] [-L] [-d] tty
+ *
+ * -n raises the line rate with the FPGA auto-baud handshake
+ * (lib/uart_baud.h) before the SLIP discipline is attached. Rates
+ * outside the Bxxx table are set with termios2 (BOTHER), since the
+ * FPGA's fractional divider takes any rate.
+ *
+ * -p cslip turns on VJ header compression (RFC 1144) in the kernel's
+ * SLIP driver, -p adaptive only once the FPGA sends compressed frames.
+ * Both are the N_SLIP line discipline with an encapsulation mode
+ * (SIOCSIFENCAP); the lwIP port (firmware/lwIP/port/slip_vj.c) answers
+ * CSLIP in kind.
+ *
+ * -l sets ASYNC_LOW_LATENCY and a 1 ms USB latency timer. The link
+ * statistics add the UART's own counters (TIOCGICOUNT) to the
+ * interface's, which gives wire bytes, SLIP overhead and line errors.
  *
  * Author: Fred N. van Kempen, <waltje@uWalt.NL.Mugnet.ORG>
  *         Modified for high-speed support by Michael Wolak, 2025
@@ -27,9 +42,33 @@
 #include <linux/if_slip.h>
 #include <linux/serial.h>
 #include <time.h>
+#include <sys/select.h>
+#include "../../lib/uart_baud.h"
 
 #define VERSION "slattach 1M (high-speed SLIP - up to 4 Mbaud)"
 
+#define NEGOTIATE_WAIT_S 10     /* -n: keep asking this long for an answer */
+
+/*
+ * termios2 for rates outside the table. Declared here: <asm/termbits.h>
+ * clashes with glibc's <termios.h>. Same layout as the kernel's.
+ */
+#ifndef BOTHER
+#define BOTHER 0010000
+#endif
+struct tty_termios2 {
+    tcflag_t c_iflag;
+    tcflag_t c_oflag;
+    tcflag_t c_cflag;
+    tcflag_t c_lflag;
+    cc_t c_line;
+    cc_t c_cc[19];
+    speed_t c_ispeed;
+    speed_t c_ospeed;
+};
+#define TTY_TCGETS2 _IOR('T', 0x2A, struct tty_termios2)
+#define TTY_TCSETS2 _IOW('T', 0x2B, struct tty_termios2)
+
 /* Baud rate table - includes high-speed rates */
 struct {
     const char *speed;
@@ -97,13 +136,10 @@ struct {
     { NULL,       0        }
 };
 
-/* Line disciplines */
+/* Line discipline; CSLIP is an encapsulation mode of it */
 #ifndef N_SLIP
 #define N_SLIP 1
 #endif
-#ifndef N_CSLIP
-#define N_CSLIP 2
-#endif
 
 /* Global state */
 struct termios tty_saved, tty_current;
@@ -114,8 +150,14 @@ int opt_d = 0;  /* debug */
 int opt_v = 1;  /* verbose (default ON) */
 int opt_s = 1;  /* show statistics (default ON) */
 int opt_q = 0;  /* quiet mode */
+int opt_l = 0;  /* low latency */
+int opt_i = 0;  /* statistics: one timestamped line every opt_i s (0: live line) */
+
+static int tty_custom_baud = 0;  /* Rate set with BOTHER, 0 if from the table */
+static int line_baud = 0;        /* Rate in use, 0 if left as it was */
+static char tty_path[PATH_MAX];
 
-/* Statistics */
+/* Statistics: interface (/proc/net/dev) and UART (TIOCGICOUNT) */
 struct slip_stats {
     unsigned long rx_bytes;
     unsigned long tx_bytes;
@@ -123,7 +165,18 @@ struct slip_stats {
     unsigned long tx_packets;
     unsigned long rx_errors;
     unsigned long tx_errors;
-} stats, last_stats;
+    unsigned long rx_dropped;
+    unsigned long tx_dropped;
+    unsigned long rx_over;      /* SLIP frame longer than the MTU */
+    unsigned long rx_frame;
+    int uart;                   /* The driver has TIOCGICOUNT */
+    unsigned long wire_rx;      /* Bytes on the line */
+    unsigned long wire_tx;
+    unsigned long uart_frame;
+    unsigned long uart_overrun; /* UART FIFO and tty buffer overruns */
+    unsigned long uart_parity;
+} stats, last_stats, first_stats;
+static time_t stats_start;
 
 static char interface_name[32] = {0};
 
@@ -145,9 +198,17 @@ static int tty_set_speed(struct termios *tty, const char *speed) {
     if (opt_d) printf("Setting speed: %s\n", speed);
 
     code = tty_find_speed(speed);
+    tty_custom_baud = 0;
     if (code < 0) {
-        fprintf(stderr, "slattach: unknown speed: %s\n", speed);
-        return -1;
+        /* Any other rate: B38400 here, the real one in tty_set_state() */
+        char *end;
+        long baud = strtol(speed, &end, 10);
+        if (*end || baud <= 0 || baud > 12000000) {
+            fprintf(stderr, "slattach: unknown speed: %s\n", speed);
+            return -1;
+        }
+        tty_custom_baud = baud;
+        code = B38400;
     }
 
     cfsetispeed(tty, code);
@@ -209,6 +270,27 @@ static int tty_set_state(struct termios *tty) {
         fprintf(stderr, "slattach: tcsetattr: %s\n", strerror(errno));
         return -1;
     }
+
+    /* Not for the hangup (B0) */
+    if (tty_custom_baud && cfgetospeed(tty) != B0) {
+        struct tty_termios2 t2;
+
+        if (ioctl(tty_fd, TTY_TCGETS2, &t2) < 0) {
+            fprintf(stderr, "slattach: TCGETS2: %s\n", strerror(errno));
+            return -1;
+        }
+        t2.c_cflag &= ~CBAUD;
+        t2.c_cflag |= BOTHER;
+        t2.c_ispeed = tty_custom_baud;
+        t2.c_ospeed = tty_custom_baud;
+        if (ioctl(tty_fd, TTY_TCSETS2, &t2) < 0) {
+            fprintf(stderr, "slattach: %d baud: %s\n", tty_custom_baud, strerror(errno));
+            return -1;
+        }
+        if (opt_d && ioctl(tty_fd, TTY_TCGETS2, &t2) == 0)
+            printf("  Custom rate: %d baud requested, %u set\n",
+                   tty_custom_baud, t2.c_ospeed);
+    }
     return 0;
 }
 
@@ -230,6 +312,15 @@ static int tty_set_disc(int disc) {
     return 0;
 }
 
+/* SLIP encapsulation: SL_MODE_SLIP, SL_MODE_CSLIP, SL_OPT_ADAPTIVE */
+static int tty_set_encap(int mode) {
+    if (ioctl(tty_fd, SIOCSIFENCAP, &mode) < 0) {
+        fprintf(stderr, "slattach: SIOCSIFENCAP(%d): %s\n", mode, strerror(errno));
+        return -1;
+    }
+    return 0;
+}
+
 /* Get interface name */
 static int tty_get_name(char *name) {
     if (ioctl(tty_fd, SIOCGIFNAME, name) < 0) {
@@ -239,6 +330,150 @@ static int tty_get_name(char *name) {
     return 0;
 }
 
+/* Read one byte, -1 after timeout_ms */
+static int tty_read_byte(int timeout_ms) {
+    struct timeval tv = { timeout_ms / 1000, (timeout_ms % 1000) * 1000 };
+    fd_set fds;
+    uint8_t c;
+
+    FD_ZERO(&fds);
+    FD_SET(tty_fd, &fds);
+    if (select(tty_fd + 1, &fds, NULL, NULL, &tv) <= 0)
+        return -1;
+    if (read(tty_fd, &c, 1) != 1)
+        return -1;
+    return c;
+}
+
+static int tty_write_bytes(const uint8_t *buf, int len) {
+    int done = 0;
+
+    while (done < len) {
+        int n = write(tty_fd, buf + done, len - done);
+        if (n < 0) {
+            if (errno == EAGAIN) {
+                usleep(100);
+                continue;
+            }
+            return -1;
+        }
+        done += n;
+    }
+    return 0;
+}
+
+/* Switch the open line to a speed given as a number */
+static int tty_switch_speed(int baud) {
+    char buf[16];
+
+    snprintf(buf, sizeof(buf), "%d", baud);
+    tcdrain(tty_fd);
+    if (tty_set_speed(&tty_current, buf) < 0)
+        return -1;
+    return tty_set_state(&tty_current);
+}
+
+/*
+ * One auto-baud attempt at rate: 1 if both ends now run at it, 0 if it
+ * failed (both back at baud), -1 if nothing answered the request.
+ */
+static int baud_try(int baud, int rate) {
+    uint8_t req[6] = { UART_BAUD_CMD };
+    int c, i;
+    uint32_t echo = 0;
+
+    for (i = 0; i < 4; i++)
+        req[1 + i] = (rate >> (i * 8)) & 0xFF;
+    req[5] = uart_baud_check(rate);
+    tcflush(tty_fd, TCIFLUSH);
+    if (tty_write_bytes(req, sizeof(req)) < 0)
+        return -1;
+
+    c = tty_read_byte(100);
+    if (c == UART_BAUD_NAK)
+        return 0;
+    if (c != UART_BAUD_ACK)
+        return -1;
+    for (i = 0; i < 4; i++) {
+        if ((c = tty_read_byte(100)) < 0)
+            break;
+        echo |= (uint32_t)c << (i * 8);
+    }
+    if (i < 4 || echo != (uint32_t)rate || tty_switch_speed(rate) < 0)
+        goto fail;
+
+    usleep(UART_BAUD_SETTLE_MS * 1000);
+    tcflush(tty_fd, TCIFLUSH);
+    for (i = 0; i < UART_BAUD_PATTERN_LEN; i++) {
+        uint8_t b = uart_baud_pattern(i);
+        if (tty_write_bytes(&b, 1) < 0)
+            goto fail;
+    }
+    for (i = 0; i < UART_BAUD_PATTERN_LEN; i++) {
+        if (tty_read_byte(UART_BAUD_TIMEOUT_MS) != uart_baud_pattern(i)) {
+            if (opt_d) printf("  %d baud: test pattern failed at byte %d\n", rate, i);
+            goto fail;
+        }
+    }
+
+    /* A lost 'K' answer is retried: the FPGA ignores a repeated commit */
+    for (i = 0; i < 3; i++) {
+        uint8_t k = UART_BAUD_COMMIT;
+        tty_write_bytes(&k, 1);
+        if (tty_read_byte(100) == UART_BAUD_COMMIT)
+            return 1;
+    }
+
+fail:
+    tty_switch_speed(baud);
+    usleep((UART_BAUD_TIMEOUT_MS + 50) * 1000);
+    tcflush(tty_fd, TCIFLUSH);
+    return 0;
+}
+
+/*
+ * Negotiate the fastest rate up to max_speed. The firmware only listens
+ * for a moment before it starts SLIP, so the request is repeated for
+ * wait_s seconds (start slattach_1m, then reset the board). Returns the
+ * rate in use.
+ */
+static int tty_negotiate(int baud, int max_speed, int wait_s) {
+    static const int steps[] = { 4000000, 3000000, 2000000, 1500000 };
+    int rates[5], n = 0, i, r;
+    time_t until = time(NULL) + wait_s;
+
+    rates[n++] = max_speed;
+    for (i = 0; i < 4; i++) {
+        if (steps[i] < max_speed)
+            rates[n++] = steps[i];
+    }
+
+    if (opt_v) printf("Negotiating up to %d baud (waiting %d s for the FPGA)...\n",
+                      max_speed, wait_s);
+
+    /* Wait for any answer at the first rate */
+    while ((r = baud_try(baud, rates[0])) < 0 && time(NULL) < until)
+        usleep(100000);
+    if (r < 0) {
+        fprintf(stderr, "slattach: no auto-baud answer, staying at %d baud\n", baud);
+        return baud;
+    }
+
+    for (i = 0; i < n && rates[i] > baud; i++) {
+        if (i > 0)
+            r = baud_try(baud, rates[i]);
+        if (r > 0) {
+            if (opt_v) printf("  Line rate: %d baud\n", rates[i]);
+            return rates[i];
+        }
+        if (r < 0)
+            break;
+        if (opt_v) printf("  %d baud failed\n", rates[i]);
+    }
+    fprintf(stderr, "slattach: no faster rate passed the line test, staying at %d baud\n", baud);
+    return baud;
+}
+
 /* Hangup line */
 static int tty_hangup(void) {
     struct termios tty;
@@ -269,6 +504,44 @@ static int tty_close(void) {
     return 0;
 }
 
+/*
+ * USB serial adapters hold received bytes until a USB packet fills or the
+ * latency timer runs out (16 ms on FTDI), which every SLIP frame from the
+ * FPGA waits for. ASYNC_LOW_LATENCY has ftdi_sio use 1 ms; the sysfs
+ * latency_timer is the fallback. Returns the latency timer in ms, 0 if
+ * there is none but the flag was taken, -1 if the driver has neither.
+ */
+static int tty_low_latency(void) {
+    struct serial_struct ss;
+    char real[PATH_MAX], path[PATH_MAX + 64];
+    const char *name;
+    FILE *f;
+    int ms = -1, flag = 0;
+
+    if (ioctl(tty_fd, TIOCGSERIAL, &ss) == 0) {
+        ss.flags |= ASYNC_LOW_LATENCY;
+        flag = ioctl(tty_fd, TIOCSSERIAL, &ss) == 0;
+    }
+
+    /* /dev/serial/by-id/... links to the ttyUSBn the sysfs entry is named after */
+    if (!realpath(tty_path, real))
+        return flag - 1;
+    name = strrchr(real, '/');
+    snprintf(path, sizeof(path), "/sys/class/tty/%s/device/latency_timer",
+             name ? name + 1 : real);
+
+    if ((f = fopen(path, "r+")) != NULL) {
+        fprintf(f, "1\n");
+        fclose(f);
+    }
+    if ((f = fopen(path, "r")) != NULL) {
+        if (fscanf(f, "%d", &ms) != 1)
+            ms = -1;
+        fclose(f);
+    }
+    return ms < 0 ? flag - 1 : ms;
+}
+
 /* Open and configure terminal */
 static int tty_open(char *name, const char *speed) {
     char pathbuf[PATH_MAX];
@@ -283,6 +556,7 @@ static int tty_open(char *name, const char *speed) {
         path = name;
     }
 
+    snprintf(tty_path, sizeof(tty_path), "%s", path);
     if (opt_d || opt_v) printf("Opening UART: %s\n", path);
 
     /* Open device */
@@ -384,9 +658,13 @@ static int read_interface_stats(const char *ifname, struct slip_stats *s) {
                 s->rx_bytes = rx_bytes;
                 s->rx_packets = rx_packets;
                 s->rx_errors = rx_errs;
+                s->rx_dropped = rx_drop;
+                s->rx_over = rx_fifo;
+                s->rx_frame = rx_frame;
                 s->tx_bytes = tx_bytes;
                 s->tx_packets = tx_packets;
                 s->tx_errors = tx_errs;
+                s->tx_dropped = tx_drop;
                 found = 1;
                 break;
             }
@@ -394,7 +672,65 @@ static int read_interface_stats(const char *ifname, struct slip_stats *s) {
     }
 
     fclose(fp);
-    return found ? 0 : -1;
+    if (!found)
+        return -1;
+
+    /* Bytes and line errors as the UART driver counts them */
+    struct serial_icounter_struct ic;
+    if (ioctl(tty_fd, TIOCGICOUNT, &ic) == 0) {
+        s->uart = 1;
+        s->wire_rx = ic.rx;
+        s->wire_tx = ic.tx;
+        s->uart_frame = ic.frame;
+        s->uart_overrun = ic.overrun + ic.buf_overrun;
+        s->uart_parity = ic.parity;
+    }
+    return 0;
+}
+
+/*
+ * Wire bytes beyond the IP bytes, in percent: SLIP END framing and
+ * escapes (CSLIP header compression counts against it)
+ */
+static double slip_overhead(unsigned long wire, unsigned long bytes) {
+    return bytes ? 100.0 * ((double)wire - (double)bytes) / bytes : 0.0;
+}
+
+static unsigned long link_errors(const struct slip_stats *s) {
+    return s->rx_errors + s->tx_errors + s->rx_dropped + s->tx_dropped +
+           s->uart_frame + s->uart_overrun + s->uart_parity;
+}
+
+/* One report over the change from a to b */
+static void print_link_stats(const struct slip_stats *a, const struct slip_stats *b,
+                             double elapsed) {
+    unsigned long rx_bytes = b->rx_bytes - a->rx_bytes;
+    unsigned long tx_bytes = b->tx_bytes - a->tx_bytes;
+
+    printf("RX %lu frames %lu B (%.1f KB/s) | TX %lu frames %lu B (%.1f KB/s)\n",
+           b->rx_packets - a->rx_packets, rx_bytes, rx_bytes / elapsed / 1024.0,
+           b->tx_packets - a->tx_packets, tx_bytes, tx_bytes / elapsed / 1024.0);
+    if (b->uart) {
+        unsigned long wire_rx = b->wire_rx - a->wire_rx;
+        unsigned long wire_tx = b->wire_tx - a->wire_tx;
+        printf("  wire   RX %lu B (%+.1f%%) | TX %lu B (%+.1f%%)",
+               wire_rx, slip_overhead(wire_rx, rx_bytes),
+               wire_tx, slip_overhead(wire_tx, tx_bytes));
+        if (line_baud)
+            printf(" | line busy RX %.0f%% TX %.0f%% of %d baud",
+                   100.0 * wire_rx * 10 / elapsed / line_baud,
+                   100.0 * wire_tx * 10 / elapsed / line_baud, line_baud);
+        printf("\n");
+    }
+    printf("  errors RX %lu err, %lu drop, %lu over, %lu frame | TX %lu err, %lu drop",
+           b->rx_errors - a->rx_errors, b->rx_dropped - a->rx_dropped,
+           b->rx_over - a->rx_over, b->rx_frame - a->rx_frame,
+           b->tx_errors - a->tx_errors, b->tx_dropped - a->tx_dropped);
+    if (b->uart)
+        printf(" | UART %lu framing, %lu overrun, %lu parity",
+               b->uart_frame - a->uart_frame, b->uart_overrun - a->uart_overrun,
+               b->uart_parity - a->uart_parity);
+    printf("\n");
 }
 
 /* Get remote IP address from interface */
@@ -452,13 +788,19 @@ static void show_statistics(const char *ifname) {
     if (last_time == 0) {
         /* First time - just save baseline */
         last_stats = current;
+        first_stats = current;
+        stats = current;
         last_time = now;
+        stats_start = now;
         printf("\n[Monitoring %s - press Ctrl-C to stop]\n\n", ifname);
+        if (!current.uart)
+            printf("(no UART counters from this driver: wire bytes and line errors not shown)\n\n");
         return;
     }
+    stats = current;
 
     /* Detect first incoming data (connection established) */
-    if (!connection_detected && current.rx_packets > 0) {
+    if (!connection_detected && current.rx_packets > first_stats.rx_packets) {
         char remote_ip[32];
         connection_detected = 1;
 
@@ -470,7 +812,19 @@ static void show_statistics(const char *ifname) {
     }
 
     elapsed = difftime(now, last_time);
-    if (elapsed < 1.0) {
+    if (elapsed < (opt_i ? opt_i : 1)) {
+        return;
+    }
+
+    if (opt_i) {
+        /* Scrolling, timestamped: lines up with slip_perf_client's [STATUS] */
+        char stamp[16];
+        strftime(stamp, sizeof(stamp), "%H:%M:%S", localtime(&now));
+        printf("[%s] ", stamp);
+        print_link_stats(&last_stats, &current, elapsed);
+        fflush(stdout);
+        last_stats = current;
+        last_time = now;
         return;
     }
 
@@ -493,6 +847,13 @@ static void show_statistics(const char *ifname) {
            tx_rate / 1024.0,
            current.rx_bytes / 1024,
            current.tx_bytes / 1024);
+    if (current.uart)
+        printf(" | SLIP %+.1f%%/%+.1f%%",
+               slip_overhead(current.wire_rx - first_stats.wire_rx,
+                             current.rx_bytes - first_stats.rx_bytes),
+               slip_overhead(current.wire_tx - first_stats.wire_tx,
+                             current.tx_bytes - first_stats.tx_bytes));
+    printf(" | Errors: %lu", link_errors(&current) - link_errors(&first_stats));
     fflush(stdout);
 
     last_stats = current;
@@ -502,6 +863,10 @@ static void show_statistics(const char *ifname) {
 /* Signal handler */
 static void sig_catch(int sig) {
     (void)sig;  /* Unused - same handler for all signals */
+    if (stats_start && difftime(time(NULL), stats_start) > 0) {
+        printf("\n\nLink totals over %.0f s:\n", difftime(time(NULL), stats_start));
+        print_link_stats(&first_stats, &stats, difftime(time(NULL), stats_start));
+    }
     printf("\n\nStopping SLIP interface...\n");
     tty_close();
     exit(0);
@@ -510,18 +875,25 @@ static void sig_catch(int sig) {
 /* Usage */
 static void usage(int rc) {
     FILE *fp = rc ? stderr : stdout;
-    fprintf(fp, "Usage: slattach_1m [-p protocol] [-s speed] [-L] [-d] [-q] tty\n");
+    fprintf(fp, "Usage: slattach_1m [-p protocol] [-s speed] [-n max-speed] [-l] [-i secs] [-L] [-d] [-q] tty\n");
     fprintf(fp, "       slattach_1m -V (version)\n");
     fprintf(fp, "\n");
     fprintf(fp, "Options:\n");
-    fprintf(fp, "  -p protocol  Protocol: slip, cslip (default: cslip)\n");
+    fprintf(fp, "  -p protocol  Protocol: slip, cslip, adaptive (default: cslip)\n");
+    fprintf(fp, "               cslip: VJ header compression; adaptive: once the peer uses it\n");
     fprintf(fp, "  -s speed     Baud rate (e.g., 115200, 1000000)\n");
+    fprintf(fp, "  -n max-speed Auto-baud: raise the rate up to max-speed with the FPGA\n");
+    fprintf(fp, "               handshake (needs -s; tried for %d s, then stays at -s)\n",
+            NEGOTIATE_WAIT_S);
+    fprintf(fp, "  -l           Low latency: ASYNC_LOW_LATENCY, USB latency timer 1 ms\n");
+    fprintf(fp, "  -i secs      Link statistics as a timestamped report every secs\n");
+    fprintf(fp, "               (frames, wire bytes, SLIP overhead, errors)\n");
     fprintf(fp, "  -L           3-wire mode (no flow control)\n");
     fprintf(fp, "  -d           Debug mode (show UART details)\n");
     fprintf(fp, "  -q, --quiet  Quiet mode (suppress statistics and verbose output)\n");
     fprintf(fp, "  -V           Show version\n");
     fprintf(fp, "\n");
-    fprintf(fp, "Supported baud rates: 9600 - 4000000\n");
+    fprintf(fp, "Supported baud rates: 9600 - 4000000, others via termios2\n");
     fprintf(fp, "Recommended for FPGA: 1000000 (1 Mbaud)\n");
     fprintf(fp, "\n");
     fprintf(fp, "By default, shows connection status and live statistics.\n");
@@ -530,6 +902,12 @@ static void usage(int rc) {
     fprintf(fp, "Example:\n");
     fprintf(fp, "  sudo slattach_1m -p slip -s 1000000 -L /dev/ttyUSB0\n");
     fprintf(fp, "\n");
+    fprintf(fp, "Negotiated rate (start this, then reset the board):\n");
+    fprintf(fp, "  sudo slattach_1m -p slip -s 1000000 -n 4000000 -l -L /dev/ttyUSB0\n");
+    fprintf(fp, "\n");
+    fprintf(fp, "Link report every 5 s next to slip_perf_client:\n");
+    fprintf(fp, "  sudo slattach_1m -p slip -s 1000000 -l -i 5 -L /dev/ttyUSB0\n");
+    fprintf(fp, "\n");
     fprintf(fp, "Quiet mode for scripts:\n");
     fprintf(fp, "  sudo slattach_1m -p slip -s 1000000 -L -q /dev/ttyUSB0 &\n");
     exit(rc);
@@ -539,13 +917,15 @@ static void usage(int rc) {
 int main(int argc, char *argv[]) {
     const char *proto = "cslip";
     const char *speed = NULL;
+    const char *max_speed = NULL;
+    static char speed_buf[16];
     char *tty_name;
     char ifname[128];
-    int ldisc;
+    int encap;
     int opt;
 
     /* Parse options */
-    while ((opt = getopt(argc, argv, "p:s:LdqVh")) != -1) {
+    while ((opt = getopt(argc, argv, "p:s:n:li:LdqVh")) != -1) {
         switch (opt) {
             case 'p':
                 proto = optarg;
@@ -553,6 +933,17 @@ int main(int argc, char *argv[]) {
             case 's':
                 speed = optarg;
                 break;
+            case 'n':
+                max_speed = optarg;
+                break;
+            case 'l':
+                opt_l = 1;
+                break;
+            case 'i':
+                opt_i = atoi(optarg);
+                if (opt_i < 1)
+                    usage(1);
+                break;
             case 'L':
                 opt_L = 1;
                 break;
@@ -592,18 +983,50 @@ int main(int argc, char *argv[]) {
     if (tty_open(tty_name, speed) < 0)
         exit(1);
 
-    /* Determine line discipline */
+    /* Auto-baud before the line becomes a network interface */
+    if (max_speed != NULL) {
+        int baud, rate;
+
+        if (speed == NULL) {
+            fprintf(stderr, "slattach: -n needs -s (the rate the FPGA starts at)\n");
+            exit(1);
+        }
+        baud = atoi(speed);
+        if (atoi(max_speed) > baud) {
+            rate = tty_negotiate(baud, atoi(max_speed), NEGOTIATE_WAIT_S);
+            snprintf(speed_buf, sizeof(speed_buf), "%d", rate);
+            speed = speed_buf;
+        }
+    }
+
+    if (speed != NULL)
+        line_baud = atoi(speed);
+
+    /* Before SLIP: every frame from the FPGA would wait for the USB latency timer */
+    if (opt_l) {
+        int ms = tty_low_latency();
+        if (ms < 0)
+            fprintf(stderr, "slattach: this driver has no low-latency setting\n");
+        else if (ms > 1)
+            fprintf(stderr, "slattach: latency timer still %d ms (sysfs latency_timer not writable)\n", ms);
+        else if (opt_v)
+            printf("  Low latency: %s\n", ms == 1 ? "latency timer 1 ms" : "ASYNC_LOW_LATENCY");
+    }
+
+    /* Determine encapsulation */
     if (!strcmp(proto, "slip")) {
-        ldisc = N_SLIP;
+        encap = SL_MODE_SLIP;
     } else if (!strcmp(proto, "cslip")) {
-        ldisc = N_CSLIP;
+        encap = SL_MODE_CSLIP;
+    } else if (!strcmp(proto, "adaptive")) {
+        encap = SL_MODE_SLIP | SL_OPT_ADAPTIVE;
     } else {
         fprintf(stderr, "slattach: unknown protocol: %s\n", proto);
         exit(1);
     }
 
-    /* Set line discipline */
-    if (tty_set_disc(ldisc) < 0) {
+    /* Set line discipline, then the mode (the kernel needs CONFIG_SLIP_COMPRESSED for CSLIP) */
+    if (tty_set_disc(N_SLIP) < 0 || tty_set_encap(encap) < 0) {
         fprintf(stderr, "slattach: cannot set %s line discipline\n", proto);
         exit(1);
     }
@@ -624,7 +1047,11 @@ int main(int argc, char *argv[]) {
             printf("Interface:  %s\n", ifname);
             printf("Speed:      %s baud\n", speed ? speed : "default");
             printf("Mode:       %s\n", opt_L ? "3-wire (no flow control)" : "hardware flow control");
-            printf("Statistics: %s\n", opt_s ? "enabled" : "disabled");
+            printf("Latency:    %s\n", opt_l ? "low (ASYNC_LOW_LATENCY)" : "driver default");
+            if (opt_s && opt_i)
+                printf("Statistics: every %d s\n", opt_i);
+            else
+                printf("Statistics: %s\n", opt_s ? "enabled" : "disabled");
             printf("========================================\n");
             printf("\n");
             printf("Next steps:\n");
@@ -647,7 +1074,7 @@ int main(int argc, char *argv[]) {
     /* Main loop */
     while (1) {
         if (opt_s && interface_name[0]) {
-            /* Show statistics every second */
+            /* Show statistics every second (every opt_i s when scrolling) */
             sleep(1);
             show_statistics(interface_name);
         } else {
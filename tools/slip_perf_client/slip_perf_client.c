@@ -13,6 +13,9 @@
 // - Professional ncurses UI with progress bars
 // - Configurable test duration and timeout
 // - Clean shutdown signaling
+// - UDP streaming mode: paced, sequence numbered datagrams with loss,
+//   reorder and duplicate accounting on the server
+// - Round-trip latency histogram (p50/p90/p99) for every mode
 //
 // Usage:
 //   ./slip_perf_client <server_ip> [options]
@@ -21,14 +24,20 @@
 //   -d <seconds>   Test duration (default: 2)
 //   -t <seconds>   Timeout (default: 30)
 //   -b             Bidirectional mode (default: unidirectional)
+//   -u             UDP streaming mode
+//   -r <KB/s>      UDP send rate, 0 = as fast as possible (default: 80)
+//   -l <bytes>     UDP datagram size (default: 512)
 //
 // Example:
 //   ./slip_perf_client 192.168.100.2 -d 2 -t 30 -b
+//   ./slip_perf_client 192.168.100.2 -u -r 60 -l 1024 -d 10
 //
 // Copyright (c) October 2025 Michael Wolak
 // Email: mikewolak@gmail.com, mike@epromfoundry.com
 //===============================================================================
 
+#define _POSIX_C_SOURCE 200809L     /* clock_gettime() under -std=c99 */
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -37,6 +46,7 @@
 #include <sys/socket.h>
 #include <sys/time.h>
 #include <sys/select.h>
+#include <poll.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #ifndef DEBUG_MODE
@@ -61,6 +71,10 @@
 #define DEFAULT_TIMEOUT_SEC     1800  // 30 minutes
 #define DEFAULT_DURATION_SEC    2
 #define MAX_BUFFER_SIZE         (32 * 1024)  // Match server limit
+#define DEFAULT_UDP_RATE_KBPS   80           // Just under 1 Mbaud SLIP
+#define DEFAULT_UDP_SIZE        512
+#define UDP_MAX_SIZE            1472         // SLIP MTU 1500 - IP/UDP headers
+#define UDP_DRAIN_MS            1000         // Wait for late echoes after the run
 
 //==============================================================================
 // Protocol Message Types (must match firmware)
@@ -76,6 +90,15 @@
 #define MSG_TEST_STOP   0x08
 #define MSG_ERROR       0xFF
 
+/* UDP stream datagrams: [Type:4][Seq:4][Timestamp:4][Payload:N] */
+#define UDP_DATA        0x10
+#define UDP_ECHO        0x11
+#define UDP_STATS_REQ   0x12
+#define UDP_STATS_RESP  0x13
+#define UDP_RESET       0x14
+
+#define UDP_HEADER_LEN  12
+
 //==============================================================================
 // CRC32 Implementation (matches firmware polynomial 0xEDB88320)
 //==============================================================================
@@ -111,16 +134,47 @@ static uint32_t calculate_crc32(const uint8_t *data, uint32_t length) {
 // Global State
 //==============================================================================
 
+enum test_mode {
+    MODE_UNIDIRECTIONAL,
+    MODE_BIDIRECTIONAL,
+    MODE_UDP
+};
+
+/* Server side of a UDP stream (UDP_STATS_RESP) */
+struct udp_server_stats {
+    int valid;
+    uint32_t received;
+    uint32_t bytes;
+    uint32_t highest_seq;
+    uint32_t reordered;
+    uint32_t duplicates;
+};
+
+/* Round trip samples (microseconds) plus a log2 histogram */
+#define RTT_BUCKETS     32
+
+struct rtt_stats {
+    uint32_t *samples;
+    size_t count;
+    size_t capacity;
+    uint64_t buckets[RTT_BUCKETS];     /* [i]: 2^i <= rtt < 2^(i+1) us */
+};
+
 struct test_stats {
     uint64_t bytes_tx;
     uint64_t bytes_rx;
     uint64_t packets_tx;
     uint64_t packets_rx;
     uint64_t errors;
+    uint32_t uart_dropped;      /* Server UART RX bytes dropped (FIFO full) */
+    uint32_t uart_framing;      /* Server UART RX framing errors */
     time_t start_time;
     time_t current_time;
     double tx_rate_kbps;
     double rx_rate_kbps;
+    uint64_t send_drops;        /* UDP datagrams the host could not send */
+    double udp_seconds;         /* UDP send phase, without the echo drain */
+    struct udp_server_stats udp;
 };
 
 static int sockfd = -1;
@@ -130,6 +184,7 @@ static uint32_t server_max_buffer = 0;
 static uint32_t block_size = 0;
 static uint8_t *tx_buffer = NULL;
 static uint8_t *rx_buffer = NULL;
+static struct rtt_stats rtt;
 
 //==============================================================================
 // Signal Handler
@@ -140,6 +195,82 @@ static void signal_handler(int sig) {
     running = 0;
 }
 
+//==============================================================================
+// Latency Statistics
+//==============================================================================
+
+static uint64_t now_us(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void rtt_record(uint32_t usec) {
+    int bucket = 0;
+
+    if (rtt.count == rtt.capacity) {
+        size_t capacity = rtt.capacity ? rtt.capacity * 2 : 4096;
+        uint32_t *samples = realloc(rtt.samples, capacity * sizeof(uint32_t));
+        if (!samples) {
+            return;
+        }
+        rtt.samples = samples;
+        rtt.capacity = capacity;
+    }
+    rtt.samples[rtt.count++] = usec;
+
+    while (bucket < RTT_BUCKETS - 1 && (usec >> (bucket + 1)) != 0) {
+        bucket++;
+    }
+    rtt.buckets[bucket]++;
+}
+
+static int compare_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* Sorts the samples in place; percent in 0..100 */
+static uint32_t rtt_percentile(double percent) {
+    size_t index;
+
+    if (rtt.count == 0) {
+        return 0;
+    }
+    qsort(rtt.samples, rtt.count, sizeof(uint32_t), compare_u32);
+    index = (size_t)(percent / 100.0 * (rtt.count - 1) + 0.5);
+    return rtt.samples[index];
+}
+
+static void print_rtt_report(const char *title) {
+    uint64_t peak = 0;
+
+    if (rtt.count == 0) {
+        printf("%s none measured\n", title);
+        return;
+    }
+
+    printf("%s %zu samples\n", title, rtt.count);
+    printf("            min %.2f ms, p50 %.2f ms, p90 %.2f ms, p99 %.2f ms, max %.2f ms\n",
+           rtt_percentile(0) / 1000.0, rtt_percentile(50) / 1000.0,
+           rtt_percentile(90) / 1000.0, rtt_percentile(99) / 1000.0,
+           rtt_percentile(100) / 1000.0);
+
+    for (int i = 0; i < RTT_BUCKETS; i++) {
+        if (rtt.buckets[i] > peak) peak = rtt.buckets[i];
+    }
+    for (int i = 0; i < RTT_BUCKETS; i++) {
+        int width;
+
+        if (rtt.buckets[i] == 0) continue;
+        width = (int)((rtt.buckets[i] * 40 + peak - 1) / peak);
+        printf("  >= %8.2f ms  %8llu  %.*s\n", (1u << i) / 1000.0,
+               (unsigned long long)rtt.buckets[i], width,
+               "########################################");
+    }
+}
+
 //==============================================================================
 // Network Helper Functions
 //==============================================================================
@@ -438,6 +569,17 @@ static int recv_data_block(uint8_t *data, uint32_t *length, uint32_t max_length)
     if (msg_type == MSG_ERROR) {
         DEBUG_PRINT("recv_data_block: server returned ERROR\n");
         stats.errors++;
+
+        /* Error code 3 = CRC mismatch, with the server's UART RX counters
+         * (cumulative since TEST_START) */
+        if (msg_length >= 12 && data[3] == 3) {
+            stats.uart_dropped = ((uint32_t)data[4] << 24) | ((uint32_t)data[5] << 16) |
+                                 ((uint32_t)data[6] << 8) | (uint32_t)data[7];
+            stats.uart_framing = ((uint32_t)data[8] << 24) | ((uint32_t)data[9] << 16) |
+                                 ((uint32_t)data[10] << 8) | (uint32_t)data[11];
+            DEBUG_PRINT("recv_data_block: server CRC mismatch (UART dropped=%u, framing=%u)\n",
+                        stats.uart_dropped, stats.uart_framing);
+        }
         return -1;
     }
 
@@ -472,9 +614,11 @@ static int recv_data_block(uint8_t *data, uint32_t *length, uint32_t max_length)
 //==============================================================================
 
 #ifdef DEBUG_MODE
-static void update_display(int duration_sec, int bidirectional) {
+static void update_display(int duration_sec, enum test_mode mode) {
     time_t elapsed = stats.current_time - stats.start_time;
 
+    (void)mode;
+
     /* Calculate rates */
     if (elapsed > 0) {
         stats.tx_rate_kbps = (stats.bytes_tx / 1024.0) / elapsed;
@@ -493,6 +637,14 @@ static void update_display(int duration_sec, int bidirectional) {
     fflush(stdout);
 }
 #else
+static const char *mode_name(enum test_mode mode) {
+    switch (mode) {
+        case MODE_BIDIRECTIONAL: return "Bidirectional";
+        case MODE_UDP:           return "UDP Stream";
+        default:                 return "Unidirectional";
+    }
+}
+
 static void draw_progress_bar(int y, int x, int width, double percent) {
     int filled = (int)(width * (percent / 100.0));
 
@@ -503,7 +655,7 @@ static void draw_progress_bar(int y, int x, int width, double percent) {
     mvaddch(y, x + width + 1, ']');
 }
 
-static void update_display(int duration_sec, int bidirectional) {
+static void update_display(int duration_sec, enum test_mode mode) {
     time_t elapsed = stats.current_time - stats.start_time;
     double progress = (elapsed * 100.0) / duration_sec;
     if (progress > 100.0) progress = 100.0;
@@ -519,14 +671,19 @@ static void update_display(int duration_sec, int bidirectional) {
     /* Title */
     attron(A_BOLD);
     mvprintw(0, 0, "╔════════════════════════════════════════════════════════════════════════╗");
-    mvprintw(1, 0, "║           SLIP Performance Test - %s Mode                  ║",
-             bidirectional ? "Bidirectional" : "Unidirectional ");
+    mvprintw(1, 0, "║           SLIP Performance Test - %-15s Mode                  ║",
+             mode_name(mode));
     mvprintw(2, 0, "╚════════════════════════════════════════════════════════════════════════╝");
     attroff(A_BOLD);
 
     /* Connection info */
-    mvprintw(4, 2, "Server Buffer:  %u KB", server_max_buffer / 1024);
-    mvprintw(5, 2, "Block Size:     %u KB", block_size / 1024);
+    if (mode == MODE_UDP) {
+        mvprintw(4, 2, "Datagram Size:  %u bytes", block_size);
+        mvprintw(5, 2, "Send Drops:     %llu", (unsigned long long)stats.send_drops);
+    } else {
+        mvprintw(4, 2, "Server Buffer:  %u KB", server_max_buffer / 1024);
+        mvprintw(5, 2, "Block Size:     %u KB", block_size / 1024);
+    }
     mvprintw(6, 2, "Test Duration:  %d seconds", duration_sec);
 
     /* Progress */
@@ -546,18 +703,23 @@ static void update_display(int duration_sec, int bidirectional) {
 
     /* RX Statistics */
     attron(A_BOLD);
-    mvprintw(16, 2, "RECEIVE (Server → Client)");
+    mvprintw(16, 2, mode == MODE_UDP ? "ECHOED (Server → Client)" : "RECEIVE (Server → Client)");
     attroff(A_BOLD);
     mvprintw(17, 4, "Packets:    %10llu", (unsigned long long)stats.packets_rx);
     mvprintw(18, 4, "Bytes:      %10llu  (%7.2f KB)",
              (unsigned long long)stats.bytes_rx,
              stats.bytes_rx / 1024.0);
     mvprintw(19, 4, "Rate:       %10.2f KB/s", stats.rx_rate_kbps);
+    if (rtt.count > 0) {
+        mvprintw(20, 4, "RTT:        p50 %.2f ms, p99 %.2f ms",
+                 rtt_percentile(50) / 1000.0, rtt_percentile(99) / 1000.0);
+    }
 
     /* Errors */
     if (stats.errors > 0) {
         attron(A_BOLD | COLOR_PAIR(1));
         mvprintw(21, 2, "ERRORS:         %10llu", (unsigned long long)stats.errors);
+        mvprintw(22, 4, "UART RX:    %10u dropped, %u framing", stats.uart_dropped, stats.uart_framing);
         attroff(A_BOLD | COLOR_PAIR(1));
     } else {
         mvprintw(21, 2, "ERRORS:         %10llu", (unsigned long long)stats.errors);
@@ -577,6 +739,7 @@ static void update_display(int duration_sec, int bidirectional) {
 
 static void run_unidirectional_test(int duration_sec) {
     time_t end_time = stats.start_time + duration_sec;
+    uint64_t sent_at;
 
     while (running && time(NULL) < end_time) {
         stats.current_time = time(NULL);
@@ -587,6 +750,7 @@ static void run_unidirectional_test(int duration_sec) {
         }
 
         /* Send to server */
+        sent_at = now_us();
         if (send_data_block(tx_buffer, block_size) < 0) {
             stats.errors++;
             continue;
@@ -598,9 +762,10 @@ static void run_unidirectional_test(int duration_sec) {
             stats.errors++;
             continue;
         }
+        rtt_record((uint32_t)(now_us() - sent_at));
 
         /* Update display */
-        update_display(duration_sec, 0);
+        update_display(duration_sec, MODE_UNIDIRECTIONAL);
     }
 }
 
@@ -611,6 +776,215 @@ static void run_bidirectional_test(int duration_sec) {
     run_unidirectional_test(duration_sec);
 }
 
+//==============================================================================
+// UDP Stream Test
+//==============================================================================
+
+static int udp_send(uint32_t type, uint32_t seq, uint8_t *buf, uint32_t length) {
+    uint32_t ts = (uint32_t)now_us();
+
+    for (int i = 0; i < 4; i++) {
+        buf[i] = (type >> (24 - 8 * i)) & 0xFF;
+        buf[4 + i] = (seq >> (24 - 8 * i)) & 0xFF;
+        buf[8 + i] = (ts >> (24 - 8 * i)) & 0xFF;
+    }
+
+    return send(sockfd, buf, length, 0) == (ssize_t)length ? 0 : -1;
+}
+
+/* Wait up to timeout_ms for datagrams and account for all that arrived.
+ * Returns the type of the last one (0 if none) */
+static uint32_t udp_receive(int timeout_ms, uint32_t payload_size) {
+    struct pollfd pfd = { .fd = sockfd, .events = POLLIN };
+    uint8_t buf[64];
+    uint32_t type, last = 0;
+    ssize_t n;
+
+    if (poll(&pfd, 1, timeout_ms) <= 0) {
+        return 0;
+    }
+
+    while ((n = recv(sockfd, buf, sizeof(buf), MSG_DONTWAIT)) >= UDP_HEADER_LEN) {
+        uint32_t word[10] = { 0 };
+
+        for (ssize_t i = 0; i + 4 <= n && i < 40; i += 4) {
+            word[i / 4] = ((uint32_t)buf[i] << 24) | ((uint32_t)buf[i + 1] << 16) |
+                          ((uint32_t)buf[i + 2] << 8) | (uint32_t)buf[i + 3];
+        }
+        type = word[0];
+
+        if (type == UDP_ECHO) {
+            /* The server echoes our timestamp: 32-bit wrap is harmless */
+            rtt_record((uint32_t)now_us() - word[2]);
+            stats.packets_rx++;
+            stats.bytes_rx += payload_size;
+        } else if (type == UDP_STATS_RESP && n >= UDP_HEADER_LEN + 28) {
+            stats.udp.valid = 1;
+            stats.udp.received = word[3];
+            stats.udp.bytes = word[4];
+            stats.udp.highest_seq = word[5];
+            stats.udp.reordered = word[6];
+            stats.udp.duplicates = word[7];
+            stats.uart_dropped = word[8];
+            stats.uart_framing = word[9];
+        }
+        last = type;
+    }
+
+    return last;
+}
+
+/* Send a control datagram until its reply arrives */
+static int udp_request(uint32_t type, uint32_t reply, uint8_t *buf) {
+    for (int tries = 0; tries < 3; tries++) {
+        uint64_t deadline = now_us() + 500000;
+
+        if (udp_send(type, 0, buf, UDP_HEADER_LEN) < 0) {
+            return -1;
+        }
+        while (now_us() < deadline) {
+            if (udp_receive(100, 0) == reply) {
+                return 0;
+            }
+        }
+    }
+    return -1;
+}
+
+static void run_udp_stream_test(int duration_sec, int rate_kbps) {
+    uint64_t start = now_us();
+    uint64_t end = start + (uint64_t)duration_sec * 1000000;
+    uint64_t interval = rate_kbps > 0 ? (uint64_t)block_size * 1000000 / ((uint64_t)rate_kbps * 1024) : 0;
+    uint64_t next_send = start, next_display = start, now;
+    uint32_t seq = 0;
+
+    while (running && (now = now_us()) < end) {
+        if (now >= next_send) {
+            if (udp_send(UDP_DATA, seq, tx_buffer, block_size) < 0) {
+                /* Host queue full (ENOBUFS/EAGAIN): the datagram never left */
+                stats.send_drops++;
+            } else {
+                stats.bytes_tx += block_size;
+                stats.packets_tx++;
+            }
+            seq++;
+
+            /* Keep the rate, but don't burst to catch up after a stall */
+            next_send += interval;
+            if (next_send + 100000 < now) {
+                next_send = now;
+            }
+        }
+
+        now = now_us();
+        udp_receive(next_send > now ? (int)((next_send - now) / 1000) : 0, block_size);
+
+        if (now >= next_display) {
+            stats.current_time = time(NULL);
+            update_display(duration_sec, MODE_UDP);
+            next_display = now + 250000;
+        }
+    }
+
+    stats.udp_seconds = (now_us() - start) / 1e6;
+    stats.current_time = time(NULL);
+
+    /* Let late echoes in, then fetch the server's view of the stream */
+    end = now_us() + UDP_DRAIN_MS * 1000;
+    while ((now = now_us()) < end) {
+        udp_receive((int)((end - now) / 1000), block_size);
+    }
+    if (udp_request(UDP_STATS_REQ, UDP_STATS_RESP, tx_buffer) < 0) {
+        DEBUG_PRINT("run_udp_stream_test: no UDP_STATS_RESP\n");
+    }
+}
+
+static int run_udp_main(int duration_sec, int rate_kbps, uint32_t size) {
+    uint64_t lost;
+
+    block_size = size;
+    tx_buffer = malloc(UDP_MAX_SIZE);
+    if (!tx_buffer) {
+        fprintf(stderr, "Failed to allocate buffer\n");
+        close(sockfd);
+        return 1;
+    }
+    for (uint32_t i = 0; i < UDP_MAX_SIZE; i++) {
+        tx_buffer[i] = (uint8_t)(rand() & 0xFF);
+    }
+
+    printf("Starting UDP stream: %u byte datagrams, ", size);
+    if (rate_kbps > 0) {
+        printf("paced at %d KB/s\n", rate_kbps);
+    } else {
+        printf("unpaced\n");
+    }
+    if (udp_request(UDP_RESET, UDP_RESET, tx_buffer) < 0) {
+        fprintf(stderr, "No reply from server on UDP port %d\n", DEFAULT_PORT);
+        free(tx_buffer);
+        close(sockfd);
+        return 1;
+    }
+
+#ifndef DEBUG_MODE
+    initscr();
+    cbreak();
+    noecho();
+    curs_set(0);
+    start_color();
+    init_pair(1, COLOR_RED, COLOR_BLACK);
+#endif
+
+    memset(&stats, 0, sizeof(stats));
+    stats.start_time = time(NULL);
+    stats.current_time = stats.start_time;
+
+    run_udp_stream_test(duration_sec, rate_kbps);
+    update_display(duration_sec, MODE_UDP);
+
+#ifndef DEBUG_MODE
+    sleep(2);
+    endwin();
+#endif
+
+    printf("\n========================================\n");
+    printf("  SLIP UDP Stream Test Complete\n");
+    printf("========================================\n\n");
+    printf("Duration:   %.2f seconds\n", stats.udp_seconds);
+    printf("Sent:       %llu datagrams, %llu bytes (%.2f KB/s)",
+           (unsigned long long)stats.packets_tx, (unsigned long long)stats.bytes_tx,
+           stats.udp_seconds > 0 ? stats.bytes_tx / 1024.0 / stats.udp_seconds : 0.0);
+    if (stats.send_drops) {
+        printf(", %llu not sent (host queue full)", (unsigned long long)stats.send_drops);
+    }
+    printf("\n");
+
+    if (stats.udp.valid) {
+        lost = stats.packets_tx > stats.udp.received ? stats.packets_tx - stats.udp.received : 0;
+        printf("Delivered:  %u datagrams, %u bytes (%.2f KB/s)\n",
+               stats.udp.received, stats.udp.bytes,
+               stats.udp_seconds > 0 ? stats.udp.bytes / 1024.0 / stats.udp_seconds : 0.0);
+        printf("Lost:       %llu (%.2f%%)\n", (unsigned long long)lost,
+               stats.packets_tx ? lost * 100.0 / stats.packets_tx : 0.0);
+        printf("Reordered:  %u\n", stats.udp.reordered);
+        printf("Duplicates: %u\n", stats.udp.duplicates);
+        printf("UART RX:    %u bytes dropped, %u framing errors (server)\n",
+               stats.uart_dropped, stats.uart_framing);
+    } else {
+        printf("Delivered:  unknown (no stats reply from server)\n");
+    }
+    printf("Echoed:     %llu datagrams (return path included)\n",
+           (unsigned long long)stats.packets_rx);
+    print_rtt_report("RTT:       ");
+    printf("\n");
+
+    free(tx_buffer);
+    free(rtt.samples);
+    close(sockfd);
+
+    return 0;
+}
+
 //==============================================================================
 // Main
 //==============================================================================
@@ -622,9 +996,14 @@ static void usage(const char *prog) {
     fprintf(stderr, "  -d <seconds>   Test duration (default: %d)\n", DEFAULT_DURATION_SEC);
     fprintf(stderr, "  -t <seconds>   Socket timeout (default: %d)\n", DEFAULT_TIMEOUT_SEC);
     fprintf(stderr, "  -b             Bidirectional mode (default: unidirectional)\n");
+    fprintf(stderr, "  -u             UDP streaming mode\n");
+    fprintf(stderr, "  -r <KB/s>      UDP send rate, 0 = unpaced (default: %d)\n", DEFAULT_UDP_RATE_KBPS);
+    fprintf(stderr, "  -l <bytes>     UDP datagram size, %d-%d (default: %d)\n",
+            UDP_HEADER_LEN, UDP_MAX_SIZE, DEFAULT_UDP_SIZE);
     fprintf(stderr, "\n");
     fprintf(stderr, "Example:\n");
     fprintf(stderr, "  %s 192.168.100.2 -d 2 -t 30 -b\n", prog);
+    fprintf(stderr, "  %s 192.168.100.2 -u -r 60 -l 1024 -d 10\n", prog);
     fprintf(stderr, "\n");
     exit(1);
 }
@@ -634,6 +1013,9 @@ int main(int argc, char *argv[]) {
     int duration_sec = DEFAULT_DURATION_SEC;
     int timeout_sec = DEFAULT_TIMEOUT_SEC;
     int bidirectional = 0;
+    int udp_rate_kbps = DEFAULT_UDP_RATE_KBPS;
+    uint32_t udp_size = DEFAULT_UDP_SIZE;
+    enum test_mode mode = MODE_UNIDIRECTIONAL;
     struct sockaddr_in server_addr;
     struct timeval tv;
     int opt;
@@ -645,7 +1027,7 @@ int main(int argc, char *argv[]) {
 
     server_ip = argv[1];
 
-    while ((opt = getopt(argc - 1, argv + 1, "d:t:b")) != -1) {
+    while ((opt = getopt(argc - 1, argv + 1, "d:t:bur:l:")) != -1) {
         switch (opt) {
             case 'd':
                 duration_sec = atoi(optarg);
@@ -656,11 +1038,27 @@ int main(int argc, char *argv[]) {
             case 'b':
                 bidirectional = 1;
                 break;
+            case 'u':
+                mode = MODE_UDP;
+                break;
+            case 'r':
+                udp_rate_kbps = atoi(optarg);
+                break;
+            case 'l':
+                udp_size = (uint32_t)atoi(optarg);
+                break;
             default:
                 usage(argv[0]);
         }
     }
 
+    if (mode != MODE_UDP && bidirectional) {
+        mode = MODE_BIDIRECTIONAL;
+    }
+    if (udp_size < UDP_HEADER_LEN || udp_size > UDP_MAX_SIZE || udp_rate_kbps < 0) {
+        usage(argv[0]);
+    }
+
     /* Initialize CRC32 */
     crc32_init();
 
@@ -668,7 +1066,7 @@ int main(int argc, char *argv[]) {
     signal(SIGINT, signal_handler);
 
     /* Create socket */
-    sockfd = socket(AF_INET, SOCK_STREAM, 0);
+    sockfd = socket(AF_INET, mode == MODE_UDP ? SOCK_DGRAM : SOCK_STREAM, 0);
     if (sockfd < 0) {
         perror("socket");
         return 1;
@@ -705,6 +1103,10 @@ int main(int argc, char *argv[]) {
 
     printf("Connected!\n");
 
+    if (mode == MODE_UDP) {
+        return run_udp_main(duration_sec, udp_rate_kbps, udp_size);
+    }
+
     /* Request server capabilities */
     printf("Requesting server capabilities...\n");
     if (request_capabilities() < 0) {
@@ -767,7 +1169,7 @@ int main(int argc, char *argv[]) {
 
     /* Final display update */
     stats.current_time = time(NULL);
-    update_display(duration_sec, bidirectional);
+    update_display(duration_sec, mode);
 
 #ifndef DEBUG_MODE
     /* Wait a moment to let user see final display */
@@ -794,11 +1196,17 @@ int main(int argc, char *argv[]) {
            (unsigned long long)stats.packets_rx,
            stats.rx_rate_kbps);
     printf("Errors:     %llu\n", (unsigned long long)stats.errors);
+    if (stats.uart_dropped || stats.uart_framing) {
+        printf("UART RX:    %u bytes dropped, %u framing errors (server)\n",
+               stats.uart_dropped, stats.uart_framing);
+    }
+    print_rtt_report("Block RTT: ");
     printf("\n");
 
     /* Cleanup */
     free(tx_buffer);
     free(rx_buffer);
+    free(rtt.samples);
     close(sockfd);
 
     return 0;
@@ -21,6 +21,11 @@
 //   # In another terminal:
 //   tools/slip_perf_client/slip_perf_client 127.0.0.1
 //
+// Load generator: the same protocol from the client side, many concurrent
+// TCP sessions and UDP streams on one epoll loop, for soak testing the
+// board's lwIP stack:
+//   ./slip_perf_server_linux -c 192.168.100.2 -n 6 -u 2 -d 60
+//
 // Copyright (c) October 2025 Michael Wolak
 // Email: mikewolak@gmail.com, mike@epromfoundry.com
 //===============================================================================
@@ -34,6 +39,10 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/epoll.h>
 
 //==============================================================================
 // Configuration
@@ -446,16 +455,804 @@ static void handle_client(int client_sock) {
     printf("========================================\n");
 }
 
+//==============================================================================
+// Load Generator (-c <target>)
+//
+// Runs many sessions at once against a server (the board's lwIP stack or
+// another instance of this program) from one epoll loop: TCP sessions go
+// through CAPS_REQ/TEST_START and then exchange CRC checked blocks back to
+// back, UDP streams send paced UDP_DATA datagrams and time the echoes.
+//
+// All UDP streams draw their sequence numbers from one counter, so the
+// server's single stream accounting (loss, reorder, duplicates) stays valid
+// for the aggregate.
+//==============================================================================
+
+#define LOAD_MAX_SESSIONS   64
+#define LOAD_DEFAULT_TCP    4
+#define LOAD_DEFAULT_BLOCK  1024
+#define LOAD_DEFAULT_SECS   10
+#define LOAD_DEFAULT_RATE   10          // KB/s per UDP stream
+#define LOAD_DEFAULT_UDP_SIZE 512
+#define LOAD_UDP_MAX_SIZE   1472        // SLIP MTU 1500 - IP/UDP headers
+#define LOAD_GRACE_SECS     10          // For the last round trips after the run
+#define LOAD_DRAIN_MS       1000        // Late UDP echoes
+
+/* UDP stream datagrams: [Type:4][Seq:4][Timestamp:4][Payload:N] */
+#define UDP_DATA        0x10
+#define UDP_ECHO        0x11
+#define UDP_STATS_REQ   0x12
+#define UDP_STATS_RESP  0x13
+#define UDP_RESET       0x14
+
+#define UDP_HEADER_LEN  12
+
+enum load_phase {
+    LOAD_CONNECTING,
+    LOAD_CAPS,          // CAPS_REQ sent
+    LOAD_START,         // TEST_START sent
+    LOAD_RUN,           // Block sent, waiting for DATA_CRC + DATA_BLOCK
+    LOAD_STREAM,        // UDP
+    LOAD_DONE,
+    LOAD_FAILED
+};
+
+struct load_session {
+    int id;
+    int fd;
+    int udp;
+    enum load_phase phase;
+    const char *failure;
+
+    /* TCP: pending output and the message being received */
+    uint8_t *out;
+    uint32_t out_len;
+    uint32_t out_pos;
+    uint8_t header[8];
+    uint32_t hdr_pos;
+    uint8_t *in;
+    uint32_t in_len;
+    uint32_t in_pos;
+    uint32_t block_size;
+    uint32_t expected_crc;
+    uint64_t sent_at;
+
+    /* UDP */
+    uint64_t next_send;
+
+    /* Statistics */
+    uint64_t bytes_tx;
+    uint64_t bytes_rx;
+    uint64_t packets_tx;
+    uint64_t packets_rx;
+    uint64_t errors;
+    uint64_t send_drops;
+    uint32_t *rtt;              // Round trips in microseconds
+    size_t rtt_count;
+    size_t rtt_capacity;
+};
+
+struct load_config {
+    struct sockaddr_in target;
+    int tcp_sessions;
+    int udp_streams;
+    int duration_sec;
+    uint32_t block_size;
+    int udp_rate_kbps;
+    uint32_t udp_size;
+};
+
+static struct load_session g_load[LOAD_MAX_SESSIONS];
+static int g_load_count = 0;
+static int g_load_epoll = -1;
+static uint32_t g_udp_seq = 0;
+static volatile sig_atomic_t g_load_running = 1;
+
+static void load_signal(int sig) {
+    (void)sig;
+    g_load_running = 0;
+}
+
+static uint64_t now_us(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void put_u32(uint8_t *p, uint32_t v) {
+    p[0] = (v >> 24) & 0xFF;
+    p[1] = (v >> 16) & 0xFF;
+    p[2] = (v >> 8) & 0xFF;
+    p[3] = v & 0xFF;
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+           ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static void load_rtt_record(struct load_session *s, uint32_t usec) {
+    if (s->rtt_count == s->rtt_capacity) {
+        size_t capacity = s->rtt_capacity ? s->rtt_capacity * 2 : 1024;
+        uint32_t *samples = realloc(s->rtt, capacity * sizeof(uint32_t));
+        if (!samples) {
+            return;
+        }
+        s->rtt = samples;
+        s->rtt_capacity = capacity;
+    }
+    s->rtt[s->rtt_count++] = usec;
+}
+
+static int compare_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* samples must be sorted; percent in 0..100 */
+static double percentile_ms(const uint32_t *samples, size_t count, double percent) {
+    if (count == 0) {
+        return 0.0;
+    }
+    return samples[(size_t)(percent / 100.0 * (count - 1) + 0.5)] / 1000.0;
+}
+
+static void load_fail(struct load_session *s, const char *why) {
+    if (s->phase == LOAD_DONE || s->phase == LOAD_FAILED) {
+        return;
+    }
+    s->phase = LOAD_FAILED;
+    s->failure = why;
+    epoll_ctl(g_load_epoll, EPOLL_CTL_DEL, s->fd, NULL);
+    close(s->fd);
+    s->fd = -1;
+}
+
+static void load_finish(struct load_session *s) {
+    s->phase = LOAD_DONE;
+    epoll_ctl(g_load_epoll, EPOLL_CTL_DEL, s->fd, NULL);
+    close(s->fd);
+    s->fd = -1;
+}
+
+static void load_want_write(struct load_session *s, int on) {
+    struct epoll_event ev = { .events = EPOLLIN | (on ? EPOLLOUT : 0), .data.ptr = s };
+    epoll_ctl(g_load_epoll, EPOLL_CTL_MOD, s->fd, &ev);
+}
+
+/* Write as much of the pending output as the socket takes */
+static void load_flush(struct load_session *s) {
+    while (s->out_pos < s->out_len) {
+        ssize_t n = send(s->fd, s->out + s->out_pos, s->out_len - s->out_pos, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                load_want_write(s, 1);
+                return;
+            }
+            load_fail(s, "send failed");
+            return;
+        }
+        s->out_pos += n;
+    }
+    s->out_len = s->out_pos = 0;
+    load_want_write(s, 0);
+}
+
+static void load_queue(struct load_session *s, uint32_t type, const void *payload, uint32_t length) {
+    put_u32(s->out + s->out_len, type);
+    put_u32(s->out + s->out_len + 4, length);
+    if (length > 0) {
+        memcpy(s->out + s->out_len + 8, payload, length);
+    }
+    s->out_len += 8 + length;
+}
+
+/* DATA_CRC + DATA_BLOCK of fresh random data, built in place */
+static void load_send_block(struct load_session *s) {
+    uint8_t *data = s->out + s->out_len + 20;     // After 12 + 8 header bytes
+    uint8_t crc[4];
+
+    for (uint32_t i = 0; i < s->block_size; i++) {
+        data[i] = (uint8_t)(rand() & 0xFF);
+    }
+    put_u32(crc, calculate_crc32(data, s->block_size));
+    load_queue(s, MSG_DATA_CRC, crc, 4);
+    put_u32(s->out + s->out_len, MSG_DATA_BLOCK);
+    put_u32(s->out + s->out_len + 4, s->block_size);
+    s->out_len += 8 + s->block_size;
+
+    s->sent_at = now_us();
+    s->bytes_tx += s->block_size;
+    s->packets_tx++;
+    s->phase = LOAD_RUN;
+    load_flush(s);
+}
+
+/* One complete message from the server */
+static void load_message(struct load_session *s, uint32_t type, uint32_t length, uint64_t end) {
+    uint8_t payload[4];
+
+    switch (s->phase) {
+    case LOAD_CAPS:
+        if (type != MSG_CAPS_RESP || length != 4) {
+            load_fail(s, "bad CAPS_RESP");
+            return;
+        }
+        if (get_u32(s->in) < s->block_size) {
+            s->block_size = get_u32(s->in);
+        }
+        put_u32(payload, s->block_size);
+        load_queue(s, MSG_TEST_START, payload, 4);
+        s->phase = LOAD_START;
+        load_flush(s);
+        break;
+
+    case LOAD_START:
+        if (type != MSG_TEST_ACK) {
+            load_fail(s, "TEST_START rejected");
+            return;
+        }
+        load_send_block(s);
+        break;
+
+    case LOAD_RUN:
+        if (type == MSG_DATA_CRC && length == 4) {
+            s->expected_crc = get_u32(s->in);
+            return;
+        }
+        if (type == MSG_DATA_BLOCK) {
+            if (calculate_crc32(s->in, length) != s->expected_crc) {
+                s->errors++;
+            } else {
+                s->bytes_rx += length;
+                s->packets_rx++;
+                load_rtt_record(s, (uint32_t)(now_us() - s->sent_at));
+            }
+        } else {
+            /* MSG_ERROR: the server saw a CRC mismatch and sends no block */
+            s->errors++;
+        }
+
+        if (g_load_running && now_us() < end) {
+            load_send_block(s);
+        } else {
+            load_queue(s, MSG_TEST_STOP, NULL, 0);
+            load_flush(s);
+            if (s->phase == LOAD_RUN) {
+                load_finish(s);
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void load_tcp_read(struct load_session *s, uint64_t end) {
+    for (;;) {
+        ssize_t n;
+
+        if (s->hdr_pos < 8) {
+            n = recv(s->fd, s->header + s->hdr_pos, 8 - s->hdr_pos, 0);
+        } else {
+            n = recv(s->fd, s->in + s->in_pos, s->in_len - s->in_pos, 0);
+        }
+        if (n == 0) {
+            load_fail(s, "closed by server");
+            return;
+        }
+        if (n < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                load_fail(s, "recv failed");
+            }
+            return;
+        }
+
+        if (s->hdr_pos < 8) {
+            s->hdr_pos += n;
+            if (s->hdr_pos < 8) {
+                continue;
+            }
+            s->in_len = get_u32(s->header + 4);
+            s->in_pos = 0;
+            if (s->in_len > s->block_size + 16) {
+                load_fail(s, "oversized message");
+                return;
+            }
+        } else {
+            s->in_pos += n;
+        }
+
+        if (s->in_pos == s->in_len) {
+            s->hdr_pos = 0;
+            load_message(s, get_u32(s->header), s->in_len, end);
+            if (s->phase == LOAD_DONE || s->phase == LOAD_FAILED) {
+                return;
+            }
+        }
+    }
+}
+
+static void load_tcp_event(struct load_session *s, uint32_t events, uint64_t end) {
+    if (s->phase == LOAD_CONNECTING) {
+        int err = 0;
+        socklen_t len = sizeof(err);
+
+        getsockopt(s->fd, SOL_SOCKET, SO_ERROR, &err, &len);
+        if (err != 0) {
+            load_fail(s, strerror(err));
+            return;
+        }
+        s->phase = LOAD_CAPS;
+        load_queue(s, MSG_CAPS_REQ, NULL, 0);
+        load_flush(s);
+        return;
+    }
+
+    if (events & (EPOLLERR | EPOLLHUP)) {
+        load_fail(s, "connection reset");
+        return;
+    }
+    if (events & EPOLLOUT) {
+        load_flush(s);
+    }
+    if ((events & EPOLLIN) && s->phase != LOAD_FAILED) {
+        load_tcp_read(s, end);
+    }
+}
+
+static int udp_datagram(int fd, uint32_t type, uint32_t seq, uint8_t *buf, uint32_t length) {
+    put_u32(buf, type);
+    put_u32(buf + 4, seq);
+    put_u32(buf + 8, (uint32_t)now_us());
+    return send(fd, buf, length, 0) == (ssize_t)length ? 0 : -1;
+}
+
+/* Account for every datagram waiting on a stream; returns the last type */
+static uint32_t load_udp_read(struct load_session *s, uint32_t *words, int count) {
+    uint8_t buf[64];
+    uint32_t last = 0;
+    ssize_t n;
+
+    while ((n = recv(s->fd, buf, sizeof(buf), MSG_DONTWAIT)) >= UDP_HEADER_LEN) {
+        last = get_u32(buf);
+        if (last == UDP_ECHO) {
+            /* The server echoes our timestamp: 32-bit wrap is harmless */
+            load_rtt_record(s, (uint32_t)now_us() - get_u32(buf + 8));
+            s->packets_rx++;
+            s->bytes_rx += s->block_size;
+        } else if (last == UDP_STATS_RESP && words && n >= UDP_HEADER_LEN + 4 * count) {
+            for (int i = 0; i < count; i++) {
+                words[i] = get_u32(buf + UDP_HEADER_LEN + 4 * i);
+            }
+        }
+    }
+    return last;
+}
+
+/* Send a control datagram on a stream until its reply arrives */
+static int load_udp_request(struct load_session *s, uint32_t type, uint32_t reply,
+                            uint32_t *words, int count) {
+    struct pollfd pfd = { .fd = s->fd, .events = POLLIN };
+    uint8_t buf[UDP_HEADER_LEN];
+
+    for (int tries = 0; tries < 3; tries++) {
+        uint64_t deadline = now_us() + 500000;
+
+        if (udp_datagram(s->fd, type, 0, buf, UDP_HEADER_LEN) < 0) {
+            return -1;
+        }
+        while (now_us() < deadline) {
+            if (poll(&pfd, 1, 100) > 0 && load_udp_read(s, words, count) == reply) {
+                return 0;
+            }
+        }
+    }
+    return -1;
+}
+
+static void load_udp_send(struct load_session *s, uint8_t *buf, uint64_t interval, uint64_t now) {
+    if (udp_datagram(s->fd, UDP_DATA, g_udp_seq++, buf, s->block_size) < 0) {
+        /* Host queue full (ENOBUFS/EAGAIN): the datagram never left */
+        s->send_drops++;
+    } else {
+        s->bytes_tx += s->block_size;
+        s->packets_tx++;
+    }
+
+    /* Keep the rate, but don't burst to catch up after a stall */
+    s->next_send += interval;
+    if (s->next_send + 100000 < now) {
+        s->next_send = now;
+    }
+}
+
+static int load_open(struct load_session *s, const struct load_config *cfg) {
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = s };
+
+    s->fd = socket(AF_INET, (s->udp ? SOCK_DGRAM : SOCK_STREAM) | SOCK_NONBLOCK, 0);
+    if (s->fd < 0) {
+        perror("socket");
+        return -1;
+    }
+    if (connect(s->fd, (const struct sockaddr *)&cfg->target, sizeof(cfg->target)) < 0 &&
+        errno != EINPROGRESS) {
+        perror("connect");
+        close(s->fd);
+        s->fd = -1;
+        return -1;
+    }
+
+    if (s->udp) {
+        s->phase = LOAD_STREAM;
+        s->block_size = cfg->udp_size;
+    } else {
+        s->phase = LOAD_CONNECTING;
+        s->block_size = cfg->block_size;
+        s->out = malloc(s->block_size + 64);
+        s->in = malloc(s->block_size + 16);
+        if (!s->out || !s->in) {
+            fprintf(stderr, "Failed to allocate session buffers\n");
+            return -1;
+        }
+        ev.events |= EPOLLOUT;      // Connect completion
+    }
+    return epoll_ctl(g_load_epoll, EPOLL_CTL_ADD, s->fd, &ev);
+}
+
+static void load_progress(uint64_t start, uint64_t now) {
+    uint64_t tx = 0, rx = 0, errors = 0;
+    int active = 0;
+    double secs = (now - start) / 1e6;
+
+    for (int i = 0; i < g_load_count; i++) {
+        tx += g_load[i].bytes_tx;
+        rx += g_load[i].bytes_rx;
+        errors += g_load[i].errors;
+        if (g_load[i].phase != LOAD_DONE && g_load[i].phase != LOAD_FAILED) {
+            active++;
+        }
+    }
+    printf("\r[%5.1fs] %d/%d sessions active  TX %8.2f KB/s  RX %8.2f KB/s  errors %llu ",
+           secs, active, g_load_count,
+           secs > 0 ? tx / 1024.0 / secs : 0.0, secs > 0 ? rx / 1024.0 / secs : 0.0,
+           (unsigned long long)errors);
+    fflush(stdout);
+}
+
+static void load_report(double secs, const uint32_t *server, int server_valid) {
+    uint64_t udp_tx = 0;
+    int proto;
+
+    printf("\n\n==========================================\n");
+    printf("Load Test Complete (%.2f seconds)\n", secs);
+    printf("==========================================\n\n");
+    printf("Session Proto      Sent  Received    TX KB/s    RX KB/s  Errors   p50 ms   p99 ms   max ms\n");
+
+    for (int i = 0; i < g_load_count; i++) {
+        struct load_session *s = &g_load[i];
+
+        qsort(s->rtt, s->rtt_count, sizeof(uint32_t), compare_u32);
+        printf("%7d %-5s %9llu %9llu %10.2f %10.2f %7llu %8.2f %8.2f %8.2f",
+               s->id, s->udp ? "UDP" : "TCP",
+               (unsigned long long)s->packets_tx, (unsigned long long)s->packets_rx,
+               s->bytes_tx / 1024.0 / secs, s->bytes_rx / 1024.0 / secs,
+               (unsigned long long)s->errors,
+               percentile_ms(s->rtt, s->rtt_count, 50),
+               percentile_ms(s->rtt, s->rtt_count, 99),
+               percentile_ms(s->rtt, s->rtt_count, 100));
+        if (s->phase == LOAD_FAILED) {
+            printf("  FAILED: %s", s->failure);
+        } else if (s->send_drops) {
+            printf("  %llu not sent", (unsigned long long)s->send_drops);
+        }
+        printf("\n");
+        if (s->udp) {
+            udp_tx += s->packets_tx;
+        }
+    }
+
+    /* Aggregate per protocol: sum of throughput, RTT over all samples */
+    printf("\n");
+    for (proto = 0; proto < 2; proto++) {
+        uint64_t sent = 0, received = 0, tx = 0, rx = 0, errors = 0;
+        size_t count = 0, n = 0;
+        uint32_t *all;
+        int sessions = 0;
+
+        for (int i = 0; i < g_load_count; i++) {
+            if (g_load[i].udp == proto) {
+                count += g_load[i].rtt_count;
+                sessions++;
+            }
+        }
+        if (sessions == 0) {
+            continue;
+        }
+
+        all = malloc((count ? count : 1) * sizeof(uint32_t));
+        for (int i = 0; i < g_load_count; i++) {
+            struct load_session *s = &g_load[i];
+
+            if (s->udp != proto) continue;
+            sent += s->packets_tx;
+            received += s->packets_rx;
+            tx += s->bytes_tx;
+            rx += s->bytes_rx;
+            errors += s->errors;
+            if (all && s->rtt_count) {
+                memcpy(all + n, s->rtt, s->rtt_count * sizeof(uint32_t));
+                n += s->rtt_count;
+            }
+        }
+        if (all) {
+            qsort(all, n, sizeof(uint32_t), compare_u32);
+        }
+
+        printf("%s total (%d %s):\n", proto ? "UDP" : "TCP", sessions,
+               proto ? "streams" : "sessions");
+        printf("  %s %llu, %s %llu, errors %llu\n",
+               proto ? "Datagrams" : "Blocks", (unsigned long long)sent,
+               proto ? "echoed" : "returned", (unsigned long long)received,
+               (unsigned long long)errors);
+        printf("  TX %.2f KB/s, RX %.2f KB/s\n", tx / 1024.0 / secs, rx / 1024.0 / secs);
+        if (all && n) {
+            printf("  RTT %zu samples: min %.2f ms, p50 %.2f ms, p90 %.2f ms, p99 %.2f ms, max %.2f ms\n",
+                   n, percentile_ms(all, n, 0), percentile_ms(all, n, 50),
+                   percentile_ms(all, n, 90), percentile_ms(all, n, 99),
+                   percentile_ms(all, n, 100));
+        } else {
+            printf("  RTT none measured\n");
+        }
+        free(all);
+    }
+
+    if (udp_tx == 0) {
+        return;
+    }
+    if (server_valid) {
+        uint64_t lost = udp_tx > server[0] ? udp_tx - server[0] : 0;
+
+        printf("  Server:  %u received, %llu lost (%.2f%%), %u reordered, %u duplicates\n",
+               server[0], (unsigned long long)lost, lost * 100.0 / udp_tx,
+               server[3], server[4]);
+        printf("  UART RX: %u bytes dropped, %u framing errors (server)\n",
+               server[5], server[6]);
+    } else {
+        printf("  Server:  no UDP_STATS_RESP\n");
+    }
+}
+
+static int run_load(const struct load_config *cfg) {
+    struct epoll_event events[LOAD_MAX_SESSIONS];
+    uint8_t udp_buf[LOAD_UDP_MAX_SIZE];
+    uint64_t interval, start, end, drain, next_progress, now;
+    uint32_t server[7] = { 0 };
+    int server_valid = 0, status = 0;
+    struct load_session *first_udp = NULL;
+
+    interval = cfg->udp_rate_kbps > 0 ?
+               (uint64_t)cfg->udp_size * 1000000 / ((uint64_t)cfg->udp_rate_kbps * 1024) : 0;
+    for (uint32_t i = 0; i < sizeof(udp_buf); i++) {
+        udp_buf[i] = (uint8_t)(rand() & 0xFF);
+    }
+
+    g_load_epoll = epoll_create1(0);
+    if (g_load_epoll < 0) {
+        perror("epoll_create1");
+        return 1;
+    }
+
+    g_load_count = cfg->tcp_sessions + cfg->udp_streams;
+    for (int i = 0; i < g_load_count; i++) {
+        struct load_session *s = &g_load[i];
+
+        s->id = i;
+        s->udp = i >= cfg->tcp_sessions;
+        if (load_open(s, cfg) < 0) {
+            return 1;
+        }
+        if (s->udp && !first_udp) {
+            first_udp = s;
+        }
+    }
+
+    printf("Load test against %s:%d\n", inet_ntoa(cfg->target.sin_addr),
+           ntohs(cfg->target.sin_port));
+    printf("  TCP: %d sessions, %u byte blocks\n", cfg->tcp_sessions, cfg->block_size);
+    printf("  UDP: %d streams, %u byte datagrams, ", cfg->udp_streams, cfg->udp_size);
+    if (cfg->udp_rate_kbps > 0) {
+        printf("%d KB/s each\n", cfg->udp_rate_kbps);
+    } else {
+        printf("unpaced\n");
+    }
+    printf("  Duration: %d seconds\n\n", cfg->duration_sec);
+
+    if (first_udp && load_udp_request(first_udp, UDP_RESET, UDP_RESET, NULL, 0) < 0) {
+        fprintf(stderr, "No reply from server on UDP port %d\n", ntohs(cfg->target.sin_port));
+        return 1;
+    }
+
+    signal(SIGINT, load_signal);
+    start = now_us();
+    end = start + (uint64_t)cfg->duration_sec * 1000000;
+    drain = end + LOAD_DRAIN_MS * 1000;
+    next_progress = start;
+    for (int i = cfg->tcp_sessions; i < g_load_count; i++) {
+        g_load[i].next_send = start;
+    }
+
+    for (;;) {
+        uint64_t wake;
+        int active = 0, n, timeout;
+
+        now = now_us();
+        if (!g_load_running && end > now) {
+            end = now;
+            drain = now + LOAD_DRAIN_MS * 1000;
+        }
+
+        /* UDP: paced sends until the end, then only the drain */
+        wake = next_progress;
+        for (int i = cfg->tcp_sessions; i < g_load_count; i++) {
+            struct load_session *s = &g_load[i];
+
+            if (now < end) {
+                while (s->next_send <= now) {
+                    load_udp_send(s, udp_buf, interval, now);
+                    if (interval == 0) break;
+                }
+                if (s->next_send < wake) wake = s->next_send;
+            }
+        }
+        for (int i = 0; i < cfg->tcp_sessions; i++) {
+            if (g_load[i].phase != LOAD_DONE && g_load[i].phase != LOAD_FAILED) {
+                active++;
+            }
+        }
+        if (now < end || (first_udp && now < drain)) {
+            active++;
+        }
+        if (active == 0) {
+            break;
+        }
+        if (now > end + (uint64_t)LOAD_GRACE_SECS * 1000000) {
+            for (int i = 0; i < cfg->tcp_sessions; i++) {
+                load_fail(&g_load[i], "no reply after the run");
+            }
+            break;
+        }
+
+        if (now >= next_progress) {
+            load_progress(start, now < end ? now : end);
+            next_progress = now + 1000000;
+        }
+
+        timeout = wake > now ? (int)((wake - now + 999) / 1000) : 0;
+        if (first_udp && now < end && interval == 0) {
+            timeout = 0;
+        }
+        n = epoll_wait(g_load_epoll, events, LOAD_MAX_SESSIONS, timeout);
+        if (n < 0 && errno != EINTR) {
+            perror("epoll_wait");
+            status = 1;
+            break;
+        }
+        for (int i = 0; i < n; i++) {
+            struct load_session *s = events[i].data.ptr;
+
+            if (s->udp) {
+                load_udp_read(s, NULL, 0);
+            } else {
+                load_tcp_event(s, events[i].events, end);
+            }
+        }
+    }
+
+    now = now_us();
+    load_progress(start, end < now ? end : now);
+    if (first_udp) {
+        server_valid = load_udp_request(first_udp, UDP_STATS_REQ, UDP_STATS_RESP, server, 7) == 0;
+    }
+    load_report((end - start) / 1e6, server, server_valid);
+
+    for (int i = 0; i < g_load_count; i++) {
+        if (g_load[i].fd >= 0) {
+            close(g_load[i].fd);
+        }
+        if (g_load[i].phase == LOAD_FAILED) {
+            status = 1;
+        }
+        free(g_load[i].out);
+        free(g_load[i].in);
+        free(g_load[i].rtt);
+    }
+    close(g_load_epoll);
+
+    return status;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s                  Serve on port %d\n", prog, PERF_PORT);
+    fprintf(stderr, "       %s -c <ip> [options] Load test a server\n", prog);
+    fprintf(stderr, "\n");
+    fprintf(stderr, "Load test options:\n");
+    fprintf(stderr, "  -n <sessions>  Concurrent TCP sessions (default: %d)\n", LOAD_DEFAULT_TCP);
+    fprintf(stderr, "  -u <streams>   Concurrent UDP streams (default: 0)\n");
+    fprintf(stderr, "  -d <seconds>   Test duration (default: %d)\n", LOAD_DEFAULT_SECS);
+    fprintf(stderr, "  -s <bytes>     TCP block size, capped by the server (default: %d)\n",
+            LOAD_DEFAULT_BLOCK);
+    fprintf(stderr, "  -r <KB/s>      Rate per UDP stream, 0 = unpaced (default: %d)\n",
+            LOAD_DEFAULT_RATE);
+    fprintf(stderr, "  -l <bytes>     UDP datagram size, %d-%d (default: %d)\n",
+            UDP_HEADER_LEN, LOAD_UDP_MAX_SIZE, LOAD_DEFAULT_UDP_SIZE);
+    fprintf(stderr, "\n");
+    fprintf(stderr, "Example:\n");
+    fprintf(stderr, "  %s -c 192.168.100.2 -n 6 -u 2 -r 5 -d 60\n", prog);
+    exit(1);
+}
+
+static int load_main(int argc, char *argv[]) {
+    struct load_config cfg;
+    const char *target = NULL;
+    int opt;
+
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.tcp_sessions = LOAD_DEFAULT_TCP;
+    cfg.duration_sec = LOAD_DEFAULT_SECS;
+    cfg.block_size = LOAD_DEFAULT_BLOCK;
+    cfg.udp_rate_kbps = LOAD_DEFAULT_RATE;
+    cfg.udp_size = LOAD_DEFAULT_UDP_SIZE;
+
+    while ((opt = getopt(argc, argv, "c:n:u:d:s:r:l:")) != -1) {
+        switch (opt) {
+            case 'c': target = optarg; break;
+            case 'n': cfg.tcp_sessions = atoi(optarg); break;
+            case 'u': cfg.udp_streams = atoi(optarg); break;
+            case 'd': cfg.duration_sec = atoi(optarg); break;
+            case 's': cfg.block_size = (uint32_t)atoi(optarg); break;
+            case 'r': cfg.udp_rate_kbps = atoi(optarg); break;
+            case 'l': cfg.udp_size = (uint32_t)atoi(optarg); break;
+            default:  usage(argv[0]);
+        }
+    }
+
+    if (!target || optind < argc || cfg.tcp_sessions < 0 || cfg.udp_streams < 0 ||
+        cfg.tcp_sessions + cfg.udp_streams == 0 ||
+        cfg.tcp_sessions + cfg.udp_streams > LOAD_MAX_SESSIONS ||
+        cfg.duration_sec <= 0 || cfg.block_size == 0 || cfg.block_size > MAX_BUFFER_SIZE ||
+        cfg.udp_size < UDP_HEADER_LEN || cfg.udp_size > LOAD_UDP_MAX_SIZE ||
+        cfg.udp_rate_kbps < 0) {
+        usage(argv[0]);
+    }
+
+    cfg.target.sin_family = AF_INET;
+    cfg.target.sin_port = htons(PERF_PORT);
+    if (inet_pton(AF_INET, target, &cfg.target.sin_addr) <= 0) {
+        fprintf(stderr, "Invalid target IP address: %s\n", target);
+        return 1;
+    }
+
+    crc32_init();
+    return run_load(&cfg);
+}
+
 //==============================================================================
 // Main
 //==============================================================================
 
-int main(void) {
+int main(int argc, char *argv[]) {
     int server_sock, client_sock;
     struct sockaddr_in server_addr, client_addr;
     socklen_t client_len = sizeof(client_addr);
     int reuse = 1;
 
+    if (argc > 1) {
+        return load_main(argc, argv);
+    }
+
     printf("\n==========================================\n");
     printf("SLIP Performance Test Server - Linux\n");
     printf("==========================================\n");
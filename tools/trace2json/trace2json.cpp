@@ -0,0 +1,389 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// trace2json.cpp - lib/trace Event Dump to Chrome Trace JSON
+//
+// Reads the TRC1 blocks trace_dump() and trace_stream_poll() write - a
+// TRACE.BIN from the SD card, or a UART capture with console text around
+// the blocks - and writes the events in the Chrome trace event format, for
+// chrome://tracing or ui.perfetto.dev:
+//
+//   Interrupts    one span per ISR (per source, or irq_handler's mask)
+//   <task name>   a span per time slice, ready / create / delay points
+//   SPI           one span per block transfer, with direction and size
+//   UART          stream driver RX drains and TX refills, with byte counts
+//   Marks         TRACE_MARK_BEGIN / END spans and TRACE_MARK points
+//
+// Cycle stamps are 32 bits and unwrapped in event order, so gaps of more
+// than 2^32 cycles without an event (86 s at 50 MHz) are lost.
+//
+// Usage: trace2json [options] [trace.bin]   (stdin if none)
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// lib/trace/trace.h
+#define TRACE_EV_ISR_ENTER   1
+#define TRACE_EV_ISR_EXIT    2
+#define TRACE_EV_TASK_SWITCH 3
+#define TRACE_EV_TASK_READY  4
+#define TRACE_EV_TASK_CREATE 5
+#define TRACE_EV_TASK_DELAY  6
+#define TRACE_EV_SPI_BEGIN   7
+#define TRACE_EV_SPI_END     8
+#define TRACE_EV_UART_RX     9
+#define TRACE_EV_UART_TX     10
+#define TRACE_EV_MARK_BEGIN  11
+#define TRACE_EV_MARK_END    12
+#define TRACE_EV_MARK        13
+
+#define TRACE_ID_IRQS        0xFF
+#define TRACE_SPI_WRITE      1
+#define TRACE_MAX_NAMES      32
+#define TRACE_NAME_LEN       15
+
+#define HEADER_BYTES         16
+#define NAME_BYTES           16
+#define RECORD_BYTES         8
+
+// Thread IDs in the JSON
+#define TID_IRQ              1
+#define TID_SPI              2
+#define TID_UART             3
+#define TID_MARKS            4
+#define TID_TASKS            100
+
+static const char *const irq_names[8] = {
+    "timer", "soft", "spi", "dma", "uart_rx", "uart_tx", "button", "timers"
+};
+
+static void print_usage(const char *prog) {
+    fprintf(stderr, "lib/trace dump to Chrome trace JSON\n\n");
+    fprintf(stderr, "Usage: %s [options] [trace.bin]\n\n", prog);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "  -o, --output <file>     JSON output (default stdout)\n");
+    fprintf(stderr, "  -c, --clock <hz>        CPU clock, instead of the one in the dump\n");
+    fprintf(stderr, "  -h, --help              Show this help\n\n");
+    fprintf(stderr, "The dump is read from stdin without a file. Example:\n");
+    fprintf(stderr, "  %s -o trace.json TRACE.BIN\n", prog);
+}
+
+static uint32_t rd32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static std::string json_string(const std::string &s) {
+    std::string out = "\"";
+    for (unsigned char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += (char)c;
+        } else if (c < 0x20) {
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        } else {
+            out += (char)c;
+        }
+    }
+    return out + "\"";
+}
+
+struct Record {
+    uint32_t cycles;
+    uint32_t info;
+};
+
+struct Dump {
+    std::vector<Record> records;
+    std::map<uint32_t, std::string> names;
+    uint32_t clock_hz = 0;
+    uint32_t dropped = 0;
+    uint32_t blocks = 0;
+    bool wrapped = false;
+
+    // A block at p (n bytes left): its length, or 0 if it is not one
+    size_t block(const uint8_t *p, size_t n) {
+        if (n < HEADER_BYTES || memcmp(p, "TRC1", 4) != 0)
+            return 0;
+        uint32_t clock = rd32(p + 4);
+        uint32_t w = rd32(p + 8);
+        uint32_t nrec = w & 0xFFFF;
+        uint32_t nnames = (w >> 16) & 0xFF;
+        uint32_t flags = w >> 24;
+        size_t len = HEADER_BYTES + nnames * NAME_BYTES + nrec * RECORD_BYTES;
+        if (clock == 0 || nnames > TRACE_MAX_NAMES || (flags & ~3u) || len > n)
+            return 0;
+
+        clock_hz = clock;
+        dropped = rd32(p + 12);
+        wrapped |= (flags & 2) != 0;
+        blocks++;
+
+        const uint8_t *q = p + HEADER_BYTES;
+        for (uint32_t i = 0; i < nnames; i++, q += NAME_BYTES) {
+            std::string s((const char *)q + 1, strnlen((const char *)q + 1, TRACE_NAME_LEN));
+            names[q[0]] = s;
+        }
+        for (uint32_t i = 0; i < nrec; i++, q += RECORD_BYTES)
+            records.push_back({ rd32(q), rd32(q + 4) });
+        return len;
+    }
+
+    void scan(const std::vector<uint8_t> &in) {
+        for (size_t i = 0; i + HEADER_BYTES <= in.size(); ) {
+            size_t n = block(&in[i], in.size() - i);
+            i += n ? n : 1;
+        }
+    }
+};
+
+struct Writer {
+    FILE *out;
+    double cycles_per_us;
+    bool first = true;
+    std::set<uint32_t> tids;
+
+    void event(const char *ph, uint32_t tid, double us, const std::string &name,
+               const std::string &args = "", const char *extra = NULL) {
+        fprintf(out, "%s\n  {\"ph\":\"%s\",\"pid\":1,\"tid\":%u,\"ts\":%.3f", first ? "" : ",",
+                ph, tid, us);
+        if (!name.empty())
+            fprintf(out, ",\"name\":%s", json_string(name).c_str());
+        if (extra)
+            fprintf(out, ",%s", extra);
+        if (!args.empty())
+            fprintf(out, ",\"args\":{%s}", args.c_str());
+        fputc('}', out);
+        first = false;
+        tids.insert(tid);
+    }
+
+    void begin(uint32_t tid, double us, const std::string &name, const std::string &args = "") {
+        event("B", tid, us, name, args);
+    }
+
+    void end(uint32_t tid, double us) {
+        event("E", tid, us, "");
+    }
+
+    void instant(uint32_t tid, double us, const std::string &name, const std::string &args = "") {
+        event("i", tid, us, name, args, "\"s\":\"t\"");
+    }
+
+    void thread_name(uint32_t tid, const std::string &name) {
+        std::string args = "\"name\":" + json_string(name);
+        fprintf(out, ",\n  {\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{%s}}",
+                tid, args.c_str());
+        fprintf(out, ",\n  {\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_sort_index\","
+                "\"args\":{\"sort_index\":%u}}", tid, tid);
+    }
+};
+
+static std::string task_name(const Dump &d, uint32_t id) {
+    auto it = d.names.find(id);
+    return it != d.names.end() ? it->second : "task " + std::to_string(id);
+}
+
+static std::string irq_name(uint32_t id, uint32_t arg) {
+    if (id == TRACE_ID_IRQS) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "irq_handler 0x%02x", arg & 0xFF);
+        return buf;
+    }
+    return id < 8 ? std::string("IRQ ") + irq_names[id] : "IRQ " + std::to_string(id);
+}
+
+// Events to JSON; B and E pair up per thread, unmatched ends are skipped
+// and spans still open at the end are closed at the last event
+static void convert(const Dump &d, Writer &w) {
+    uint64_t hi = 0;
+    uint32_t last = 0;
+    double t0 = 0, us = 0;
+    uint32_t open_irq = 0, open_spi = 0, open_mark = 0;
+    int task = -1;
+
+    fprintf(w.out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+
+    for (size_t i = 0; i < d.records.size(); i++) {
+        const Record &r = d.records[i];
+        if (i > 0 && r.cycles < last)
+            hi += 1ull << 32;
+        last = r.cycles;
+        us = (double)(hi + r.cycles) / w.cycles_per_us;
+        if (i == 0)
+            t0 = us;
+        us -= t0;
+
+        uint32_t type = r.info & 0xFF;
+        uint32_t id = (r.info >> 8) & 0xFF;
+        uint32_t arg = r.info >> 16;
+        std::string bytes = "\"bytes\":" + std::to_string(arg);
+
+        switch (type) {
+        case TRACE_EV_ISR_ENTER:
+            w.begin(TID_IRQ, us, irq_name(id, arg));
+            open_irq++;
+            break;
+        case TRACE_EV_ISR_EXIT:
+            if (open_irq) {
+                w.end(TID_IRQ, us);
+                open_irq--;
+            }
+            break;
+        case TRACE_EV_TASK_SWITCH:
+            if ((int)id == task)
+                break;
+            if (task >= 0)
+                w.end(TID_TASKS + task, us);
+            task = id;
+            w.begin(TID_TASKS + task, us, task_name(d, task));
+            break;
+        case TRACE_EV_TASK_READY:
+            w.instant(TID_TASKS + id, us, "ready");
+            break;
+        case TRACE_EV_TASK_CREATE:
+            w.instant(TID_TASKS + id, us, "create", "\"priority\":" + std::to_string(arg));
+            break;
+        case TRACE_EV_TASK_DELAY:
+            w.instant(TID_TASKS + id, us, "delay");
+            break;
+        case TRACE_EV_SPI_BEGIN:
+            w.begin(TID_SPI, us, id == TRACE_SPI_WRITE ? "SPI write" : "SPI read", bytes);
+            open_spi++;
+            break;
+        case TRACE_EV_SPI_END:
+            if (open_spi) {
+                w.end(TID_SPI, us);
+                open_spi--;
+            }
+            break;
+        case TRACE_EV_UART_RX:
+            w.instant(TID_UART, us, "UART RX", bytes);
+            break;
+        case TRACE_EV_UART_TX:
+            w.instant(TID_UART, us, "UART TX", bytes);
+            break;
+        case TRACE_EV_MARK_BEGIN:
+            w.begin(TID_MARKS, us, "mark " + std::to_string(id));
+            open_mark++;
+            break;
+        case TRACE_EV_MARK_END:
+            if (open_mark) {
+                w.end(TID_MARKS, us);
+                open_mark--;
+            }
+            break;
+        case TRACE_EV_MARK:
+            w.instant(TID_MARKS, us, "mark " + std::to_string(id), "\"value\":" + std::to_string(arg));
+            break;
+        default:
+            break;
+        }
+    }
+
+    for (; open_irq; open_irq--)
+        w.end(TID_IRQ, us);
+    for (; open_spi; open_spi--)
+        w.end(TID_SPI, us);
+    for (; open_mark; open_mark--)
+        w.end(TID_MARKS, us);
+    if (task >= 0)
+        w.end(TID_TASKS + task, us);
+
+    if (!w.first) {
+        std::set<uint32_t> tids = w.tids;
+        for (uint32_t tid : tids) {
+            if (tid == TID_IRQ)
+                w.thread_name(tid, "Interrupts");
+            else if (tid == TID_SPI)
+                w.thread_name(tid, "SPI");
+            else if (tid == TID_UART)
+                w.thread_name(tid, "UART");
+            else if (tid == TID_MARKS)
+                w.thread_name(tid, "Marks");
+            else
+                w.thread_name(tid, task_name(d, tid - TID_TASKS));
+        }
+    }
+
+    fprintf(w.out, "\n],\"otherData\":{\"clock_hz\":%u,\"events\":%zu,\"dropped\":%u,\"wrapped\":%s}}\n",
+            d.clock_hz, d.records.size(), d.dropped, d.wrapped ? "true" : "false");
+}
+
+int main(int argc, char **argv) {
+    const char *input = NULL;
+    const char *output = NULL;
+    double clock_hz = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        bool has_arg = i + 1 < argc;
+        if (strcmp(a, "-o") == 0 || strcmp(a, "--output") == 0) {
+            if (!has_arg) { print_usage(argv[0]); return 1; }
+            output = argv[++i];
+        } else if (strcmp(a, "-c") == 0 || strcmp(a, "--clock") == 0) {
+            if (!has_arg) { print_usage(argv[0]); return 1; }
+            clock_hz = strtod(argv[++i], NULL);
+            if (clock_hz <= 0) { print_usage(argv[0]); return 1; }
+        } else if (strcmp(a, "-h") == 0 || strcmp(a, "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else if (!input) {
+            input = a;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    FILE *in = stdin;
+    if (input && !(in = fopen(input, "rb"))) {
+        fprintf(stderr, "[TRACE] ERROR: cannot open %s\n", input);
+        return 1;
+    }
+    std::vector<uint8_t> data;
+    uint8_t buf[65536];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), in)) > 0)
+        data.insert(data.end(), buf, buf + n);
+    if (in != stdin)
+        fclose(in);
+
+    Dump d;
+    d.scan(data);
+    if (d.blocks == 0) {
+        fprintf(stderr, "[TRACE] ERROR: no TRC1 blocks in %s\n", input ? input : "stdin");
+        return 1;
+    }
+
+    FILE *out = stdout;
+    if (output && !(out = fopen(output, "w"))) {
+        fprintf(stderr, "[TRACE] ERROR: cannot create %s\n", output);
+        return 1;
+    }
+
+    Writer w;
+    w.out = out;
+    w.cycles_per_us = (clock_hz > 0 ? clock_hz : d.clock_hz) / 1e6;
+    convert(d, w);
+    if (out != stdout)
+        fclose(out);
+
+    fprintf(stderr, "[TRACE] %zu events in %u block%s, %zu task names, %u dropped%s\n",
+            d.records.size(), d.blocks, d.blocks == 1 ? "" : "s", d.names.size(), d.dropped,
+            d.wrapped ? ", oldest overwritten" : "");
+    return 0;
+}
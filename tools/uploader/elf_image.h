@@ -0,0 +1,121 @@
+//==============================================================================
+// Olimex iCE40HX8K-EVB RISC-V Platform
+// elf_image.h - ELF32 Load Segments to an Upload Image (fw_upload, fw_upload_fast)
+//
+// Copyright (c) October 2025 Michael Wolak
+// Email: mikewolak@gmail.com, mike@epromfoundry.com
+//
+// NOT FOR COMMERCIAL USE
+// Educational and research purposes only
+//==============================================================================
+
+/*
+ * The uploaders take a firmware .elf as well as a .bin. The PT_LOAD
+ * segments are placed at their load addresses (p_paddr: .fastcode and
+ * .fastdata load from SRAM and start.S copies them), giving the same image
+ * objcopy -O binary writes, without the file having to exist:
+ *   - image[0, file_end): the flat binary, for the FAST, block and LZ4
+ *     uploads and for fw_upload's chunked protocol
+ *   - image[file_end, image_end): .bss, which a sparse upload
+ *     (lib/sparse_upload.h) has the target zero instead
+ * Segments with no file data (.fastbss, the lwIP pool, the stack) are left
+ * out: start.S and the libraries initialise them. Hand-written parser, no
+ * <elf.h>, so it builds on Windows and macOS too.
+ */
+
+#ifndef ELF_IMAGE_H
+#define ELF_IMAGE_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ELF_IMAGE_EM_RISCV  243
+#define ELF_IMAGE_PT_LOAD   1
+
+typedef struct {
+    uint8_t* image;         // Zero-filled, image_end bytes
+    size_t file_end;        // End of the last byte from the file
+    size_t image_end;       // End including .bss
+    int segments;           // PT_LOAD segments used
+} elf_image_t;
+
+static inline uint32_t elf_image_le32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint16_t elf_image_le16(const uint8_t* p) {
+    return p[0] | (p[1] << 8);
+}
+
+static inline int elf_image_check(const uint8_t* file, size_t size) {
+    return size >= 52 && memcmp(file, "\x7F" "ELF", 4) == 0;
+}
+
+// Returns NULL, or why the ELF cannot be uploaded
+static inline const char* elf_image_load(const uint8_t* file, size_t size, size_t max,
+                                         elf_image_t* out) {
+    memset(out, 0, sizeof(*out));
+    if (!elf_image_check(file, size)) return "not an ELF file";
+    if (file[4] != 1 || file[5] != 1) return "not a 32-bit little-endian ELF";
+    if (elf_image_le16(file + 18) != ELF_IMAGE_EM_RISCV) return "not a RISC-V ELF";
+
+    uint32_t phoff = elf_image_le32(file + 28);
+    uint16_t phentsize = elf_image_le16(file + 42);
+    uint16_t phnum = elf_image_le16(file + 44);
+    if (phentsize < 32 || phoff > size || (size_t)phnum * phentsize > size - phoff) {
+        return "truncated program headers";
+    }
+
+    // First pass: the extent, so the image is allocated once
+    for (int pass = 0; pass < 2; pass++) {
+        for (uint16_t i = 0; i < phnum; i++) {
+            const uint8_t* ph = file + phoff + (size_t)i * phentsize;
+            uint32_t offset = elf_image_le32(ph + 4);
+            uint32_t paddr = elf_image_le32(ph + 12);
+            uint32_t filesz = elf_image_le32(ph + 16);
+            uint32_t memsz = elf_image_le32(ph + 20);
+
+            if (elf_image_le32(ph) != ELF_IMAGE_PT_LOAD || filesz == 0) continue;
+            if (offset > size || filesz > size - offset) return "segment past the end of the file";
+            if (paddr >= max || filesz > max - paddr) {
+                return "segment outside the upload range (an XIP or overlay image?)";
+            }
+            if (memsz < filesz || memsz > max - paddr) memsz = filesz;
+
+            if (pass == 0) {
+                if (paddr + filesz > out->file_end) out->file_end = paddr + filesz;
+                if (paddr + memsz > out->image_end) out->image_end = paddr + memsz;
+                out->segments++;
+            } else {
+                memcpy(out->image + paddr, file + offset, filesz);
+            }
+        }
+        if (pass == 0) {
+            if (out->segments == 0) return "no loadable segments";
+            out->image = calloc(1, out->image_end);
+            if (!out->image) return "out of memory";
+        }
+    }
+    return NULL;
+}
+
+// Next non-zero run of image[pos, end) for a sparse upload: zero runs of
+// at least min_gap bytes are skipped (the target zeroed them). Returns the
+// run length at *pos, 0 at the end.
+static inline size_t elf_image_next_run(const uint8_t* image, size_t end, size_t* pos, size_t min_gap) {
+    size_t p = *pos;
+
+    while (p < end && image[p] == 0) p++;
+    *pos = p;
+    if (p == end) return 0;
+
+    size_t q = p, zeros = 0;
+    while (q < end && zeros < min_gap) {
+        zeros = image[q] ? 0 : zeros + 1;
+        q++;
+    }
+    return q - p - zeros;
+}
+
+#endif // ELF_IMAGE_H
@@ -15,7 +15,9 @@
 #include <string.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdarg.h>
 #include <time.h>
+#include "elf_image.h"
 
 // Platform-specific includes
 #ifdef _WIN32
@@ -30,6 +32,8 @@
     #include <fcntl.h>
     #include <sys/ioctl.h>
     #include <sys/time.h>
+    #include <poll.h>
+    #include <errno.h>
     #ifndef FIONREAD
         #include <sys/socket.h>  // Try to get FIONREAD from socket.h
     #endif
@@ -52,6 +56,8 @@
 #define CHUNK_SIZE 64
 #define MAX_PACKET_SIZE 524288  // 512KB to match SRAM size
 #define TIMEOUT_MS 2000
+#define MAX_BOARDS 32           // Ports in one multi-board run
+#define PORT_NAME_LEN 64
 
 // Color codes for terminal
 #ifdef _WIN32
@@ -207,18 +213,32 @@ void serial_flush(serial_t h) {
     PurgeComm(h, PURGE_RXCLEAR | PURGE_TXCLEAR);
 }
 
-void list_serial_ports(void) {
-    printf("Available serial ports:\n");
-    for (int i = 1; i < 256; i++) {
-        char port[16];
+// Reads return at once with whatever has arrived
+void serial_set_nonblock(serial_t h) {
+    COMMTIMEOUTS timeouts = {0};
+    timeouts.ReadIntervalTimeout = MAXDWORD;
+    SetCommTimeouts(h, &timeouts);
+}
+
+// COM ports that open; ftdi_only keeps those of the FTDI VCP driver
+// (device object \Device\VCPn)
+int find_serial_ports(char ports[][PORT_NAME_LEN], int max, bool ftdi_only) {
+    int n = 0;
+    for (int i = 1; i < 256 && n < max; i++) {
+        char port[16], target[256];
         snprintf(port, sizeof(port), "COM%d", i);
+        if (ftdi_only && (!QueryDosDeviceA(port, target, sizeof(target)) ||
+                          strncmp(target, "\\Device\\VCP", 11) != 0)) {
+            continue;
+        }
         HANDLE h = CreateFileA(port, GENERIC_READ | GENERIC_WRITE, 0, NULL,
                               OPEN_EXISTING, 0, NULL);
         if (h != INVALID_HANDLE_VALUE) {
-            printf("  %s\n", port);
+            snprintf(ports[n++], PORT_NAME_LEN, "%s", port);
             CloseHandle(h);
         }
     }
+    return n;
 }
 
 #else  // Unix (Mac/Linux)
@@ -300,40 +320,78 @@ void serial_flush(serial_t fd) {
     tcflush(fd, TCIOFLUSH);
 }
 
-void list_serial_ports(void) {
-    printf("Available serial ports:\n");
+// Reads return at once with whatever has arrived
+void serial_set_nonblock(serial_t fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+#ifndef __APPLE__
+// ttyUSBn bound to ftdi_sio (any ttyUSB if sysfs is not there)
+static bool is_ftdi_tty(const char* name) {
+    char path[PORT_NAME_LEN + 32], link[256];
+    snprintf(path, sizeof(path), "/sys/class/tty/%s/device/driver", name);
+    ssize_t len = readlink(path, link, sizeof(link) - 1);
+    if (len < 0) return true;
+    link[len] = '\0';
+    const char* driver = strrchr(link, '/');
+    return strcmp(driver ? driver + 1 : link, "ftdi_sio") == 0;
+}
+#endif
 
-#ifdef __APPLE__
-    // macOS: Look for /dev/cu.* devices
+static int compare_ports(const void* a, const void* b) {
+    const char* pa = a;
+    const char* pb = b;
+    // ttyUSB2 before ttyUSB10
+    if (strlen(pa) != strlen(pb)) return strlen(pa) < strlen(pb) ? -1 : 1;
+    return strcmp(pa, pb);
+}
+
+// Serial devices in /dev, sorted; ftdi_only keeps the FTDI adapters
+int find_serial_ports(char ports[][PORT_NAME_LEN], int max, bool ftdi_only) {
+    int n = 0;
     DIR* dir = opendir("/dev");
-    if (dir) {
-        struct dirent* entry;
-        while ((entry = readdir(dir)) != NULL) {
-            if (strncmp(entry->d_name, "cu.", 3) == 0) {
-                printf("  /dev/%s\n", entry->d_name);
-            }
+    if (!dir) return 0;
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL && n < max) {
+        const char* name = entry->d_name;
+        bool match;
+    #ifdef __APPLE__
+        // macOS: /dev/cu.* devices, FTDI as cu.usbserial-<serial number>
+        match = ftdi_only ? strncmp(name, "cu.usbserial", 12) == 0
+                          : strncmp(name, "cu.", 3) == 0;
+    #else
+        // Linux: /dev/ttyUSB*, /dev/ttyACM*, /dev/ttyS*
+        if (ftdi_only) {
+            match = strncmp(name, "ttyUSB", 6) == 0 && is_ftdi_tty(name);
+        } else {
+            match = strncmp(name, "ttyUSB", 6) == 0 ||
+                    strncmp(name, "ttyACM", 6) == 0 ||
+                    strncmp(name, "ttyS", 4) == 0;
         }
-        closedir(dir);
-    }
-#else
-    // Linux: Look for /dev/ttyUSB*, /dev/ttyACM*, /dev/ttyS*
-    DIR* dir = opendir("/dev");
-    if (dir) {
-        struct dirent* entry;
-        while ((entry = readdir(dir)) != NULL) {
-            if (strncmp(entry->d_name, "ttyUSB", 6) == 0 ||
-                strncmp(entry->d_name, "ttyACM", 6) == 0 ||
-                strncmp(entry->d_name, "ttyS", 4) == 0) {
-                printf("  /dev/%s\n", entry->d_name);
-            }
+    #endif
+        if (match && strlen(name) + 5 < PORT_NAME_LEN) {
+            snprintf(ports[n++], PORT_NAME_LEN, "/dev/%s", name);
         }
-        closedir(dir);
     }
-#endif
+    closedir(dir);
+
+    qsort(ports, n, PORT_NAME_LEN, compare_ports);
+    return n;
 }
 
 #endif
 
+void list_serial_ports(void) {
+    static char ports[256][PORT_NAME_LEN];
+    int n = find_serial_ports(ports, 256, false);
+
+    printf("Available serial ports:\n");
+    for (int i = 0; i < n; i++) {
+        printf("  %s\n", ports[i]);
+    }
+}
+
 // Upload protocol
 bool send_byte(serial_t s, uint8_t byte, bool verbose) {
     if (serial_write(s, &byte, 1) != 1) return false;
@@ -546,38 +604,371 @@ bool upload_firmware(serial_t s, const uint8_t* data, size_t size, bool verbose)
     }
 }
 
+//==============================================================================
+// Multi-Board Upload
+//
+// The same protocol as upload_firmware() on every port at once. Each board
+// is a small state machine that a reply byte (or its timeout) moves on by
+// one step; one event loop waits on all ports, so a slow or dead board
+// holds up no other.
+//==============================================================================
+
+typedef enum {
+    BOARD_ECHO,         // 'upload' sent, discarding the shell echo
+    BOARD_READY,        // 'R' sent
+    BOARD_SIZE,         // Size sent
+    BOARD_DATA,         // Chunk sent
+    BOARD_CRC,          // CRC sent, collecting ACK + 4 CRC bytes
+    BOARD_OK,
+    BOARD_FAIL
+} board_state_t;
+
+typedef struct {
+    const char* port;
+    serial_t s;
+    board_state_t state;
+    uint8_t expected_ack;
+    size_t offset;          // Data bytes sent
+    size_t acked;           // Data bytes acknowledged
+    uint8_t response[5];
+    int response_len;
+    double start_time;
+    double end_time;
+    double deadline;        // Current step times out here
+    char error[64];
+} board_t;
+
+static const char* const board_step[] = {
+    "echo", "ready", "size", "data", "CRC"
+};
+
+static void board_fail(board_t* b, const char* fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+static void board_fail(board_t* b, const char* fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(b->error, sizeof(b->error), fmt, ap);
+    va_end(ap);
+    b->state = BOARD_FAIL;
+    b->end_time = get_time();
+}
+
+static void board_send(board_t* b, board_state_t next, const uint8_t* buf, size_t len) {
+    // Lockstep with the ACKs: never more than a chunk in the TX buffer
+    if (serial_write(b->s, buf, len) != (int)len) {
+        board_fail(b, "Write failed in %s step", board_step[next]);
+        return;
+    }
+    b->state = next;
+    b->deadline = get_time() + TIMEOUT_MS / 1000.0;
+}
+
+static void board_next_chunk(board_t* b, const uint8_t* data, size_t size, uint32_t crc) {
+    if (b->offset < size) {
+        size_t chunk_size = (b->offset + CHUNK_SIZE > size) ? (size - b->offset) : CHUNK_SIZE;
+        board_send(b, BOARD_DATA, data + b->offset, chunk_size);
+        b->offset += chunk_size;
+    } else {
+        uint8_t crc_packet[5] = {
+            'C', crc & 0xFF, (crc >> 8) & 0xFF, (crc >> 16) & 0xFF, (crc >> 24) & 0xFF
+        };
+        board_send(b, BOARD_CRC, crc_packet, sizeof(crc_packet));
+    }
+}
+
+static void board_input(board_t* b, const uint8_t* buf, int len,
+                        const uint8_t* data, size_t size, uint32_t crc) {
+    for (int i = 0; i < len && b->state < BOARD_OK; i++) {
+        uint8_t byte = buf[i];
+
+        if (b->state == BOARD_ECHO) continue;
+
+        if (b->state == BOARD_CRC) {
+            b->response[b->response_len++] = byte;
+            if (b->response_len < 5) continue;
+
+            uint32_t fpga_crc = b->response[1] | (b->response[2] << 8) |
+                                (b->response[3] << 16) | ((uint32_t)b->response[4] << 24);
+            b->end_time = get_time();
+            if (b->response[0] != b->expected_ack) {
+                board_fail(b, "Wrong ACK: got '%c', expected '%c'",
+                           b->response[0], b->expected_ack);
+            } else if (fpga_crc != crc) {
+                board_fail(b, "CRC mismatch: 0x%08X", fpga_crc);
+            } else {
+                b->state = BOARD_OK;
+            }
+            continue;
+        }
+
+        // READY, SIZE, DATA: one rotating ACK per step
+        if (byte != b->expected_ack) {
+            if (byte == 'N') {
+                board_fail(b, "NAK in %s step", board_step[b->state]);
+            } else {
+                board_fail(b, "Wrong ACK 0x%02X, expected '%c'", byte, b->expected_ack);
+            }
+            continue;
+        }
+        if (++b->expected_ack > 'Z') b->expected_ack = 'A';
+
+        if (b->state == BOARD_READY) {
+            uint8_t size_bytes[4] = {
+                size & 0xFF, (size >> 8) & 0xFF, (size >> 16) & 0xFF, (size >> 24) & 0xFF
+            };
+            board_send(b, BOARD_SIZE, size_bytes, sizeof(size_bytes));
+        } else {
+            if (b->state == BOARD_DATA) b->acked = b->offset;
+            board_next_chunk(b, data, size, crc);
+        }
+    }
+}
+
+static void board_read(board_t* b, const uint8_t* data, size_t size, uint32_t crc) {
+    uint8_t buf[256];
+    int got = serial_read(b->s, buf, sizeof(buf));
+
+    if (got > 0) {
+        board_input(b, buf, got, data, size, crc);
+    }
+#ifndef _WIN32
+    else if (got == 0 || (errno != EAGAIN && errno != EINTR)) {
+        board_fail(b, "Port closed (board unplugged?)");
+    }
+#else
+    else if (got < 0) {
+        board_fail(b, "Read failed");
+    }
+#endif
+}
+
+#ifdef _WIN32
+// Reads return at once (serial_set_nonblock): visit every port until one
+// of them has data or the timeout passes
+static void multi_wait(board_t* boards, int n, int timeout_ms,
+                       const uint8_t* data, size_t size, uint32_t crc) {
+    double until = get_time() + timeout_ms / 1000.0;
+
+    do {
+        bool any = false;
+        for (int i = 0; i < n; i++) {
+            COMSTAT stat;
+            DWORD errors;
+            if (boards[i].state >= BOARD_OK) continue;
+            if (ClearCommError(boards[i].s, &errors, &stat) && stat.cbInQue > 0) {
+                board_read(&boards[i], data, size, crc);
+                any = true;
+            }
+        }
+        if (any) return;
+        Sleep(1);
+    } while (get_time() < until);
+}
+#else
+// One poll() over every port still in progress
+static void multi_wait(board_t* boards, int n, int timeout_ms,
+                       const uint8_t* data, size_t size, uint32_t crc) {
+    struct pollfd fds[MAX_BOARDS];
+    int index[MAX_BOARDS];
+    int nfds = 0;
+
+    for (int i = 0; i < n; i++) {
+        if (boards[i].state >= BOARD_OK) continue;
+        fds[nfds].fd = boards[i].s;
+        fds[nfds].events = POLLIN;
+        index[nfds++] = i;
+    }
+    if (nfds == 0 || poll(fds, nfds, timeout_ms) <= 0) return;
+
+    for (int i = 0; i < nfds; i++) {
+        board_t* b = &boards[index[i]];
+        if (fds[i].revents & POLLIN) {
+            board_read(b, data, size, crc);
+        } else if (fds[i].revents & (POLLERR | POLLHUP | POLLNVAL)) {
+            board_fail(b, "Port closed (board unplugged?)");
+        }
+    }
+}
+#endif
+
+static void show_multi_progress(const board_t* boards, int n, size_t size, double start_time) {
+    size_t total = 0, sent = 0;
+    int done = 0, failed = 0;
+
+    // A failed board counts with the bytes it got
+    for (int i = 0; i < n; i++) {
+        total += (boards[i].state == BOARD_FAIL) ? boards[i].acked : size;
+        sent += boards[i].acked;
+        if (boards[i].state == BOARD_OK) {
+            done++;
+        } else if (boards[i].state == BOARD_FAIL) {
+            failed++;
+        }
+    }
+
+    double elapsed = get_time() - start_time;
+    double rate = elapsed > 0 ? sent / elapsed : 0;
+    int percent = total ? (int)(100.0 * sent / total) : 100;
+
+    char bar[42];
+    for (int i = 0; i < 40; i++) {
+        bar[i] = (i < percent * 40 / 100) ? '=' : ' ';
+    }
+    bar[40] = '\0';
+
+    printf("\r" COLOR_CYAN "[%s] %3d%% | %d boards: %d done, %d failed | %.1f KB/s" COLOR_RESET,
+           bar, percent, n, done, failed, rate / 1024.0);
+    fflush(stdout);
+}
+
+static void show_multi_results(const board_t* boards, int n, size_t size, uint32_t crc) {
+    int ok = 0;
+
+    printf("\n\n%-28s %8s %8s %8s  %s\n", "Port", "Bytes", "Time", "KB/s", "Result");
+    for (int i = 0; i < n; i++) {
+        const board_t* b = &boards[i];
+        double elapsed = b->start_time ? b->end_time - b->start_time : 0;
+
+        printf("%-28s %8zu %7.2fs ", b->port, b->acked, elapsed);
+        if (elapsed > 0) {
+            printf("%8.1f  ", b->acked / elapsed / 1024.0);
+        } else {
+            printf("%8s  ", "-");
+        }
+        if (b->state == BOARD_OK) {
+            printf(COLOR_GREEN "%s OK" COLOR_RESET "\n", CHECK_MARK);
+            ok++;
+        } else {
+            printf(COLOR_RED "%s %s" COLOR_RESET "\n", CROSS_MARK, b->error);
+        }
+    }
+
+    printf("\n%s%d of %d boards flashed" COLOR_RESET " (%zu bytes, CRC: 0x%08X)\n",
+           ok == n ? COLOR_GREEN : COLOR_RED, ok, n, size, crc);
+}
+
+bool upload_multi(const char* const* ports, int n, int baud,
+                  const uint8_t* data, size_t size) {
+    board_t boards[MAX_BOARDS];
+    int active = 0;
+
+    init_crc32();
+    uint32_t crc = calculate_crc32(data, size);
+
+    printf("\nUploading firmware (%zu bytes, CRC: 0x%08X) to %d boards at %d baud...\n",
+           size, crc, n, baud);
+
+    // Step 1 on every board: 'upload', then 300ms of echo to discard
+    for (int i = 0; i < n; i++) {
+        board_t* b = &boards[i];
+        memset(b, 0, sizeof(*b));
+        b->port = ports[i];
+        b->expected_ack = 'A';
+        b->s = serial_open(ports[i], baud);
+        if (b->s == INVALID_SERIAL) {
+            snprintf(b->error, sizeof(b->error), "Cannot open port");
+            b->state = BOARD_FAIL;
+            continue;
+        }
+        serial_set_nonblock(b->s);
+        b->start_time = get_time();
+        board_send(b, BOARD_ECHO, (const uint8_t*)"upload\r", 7);
+        b->deadline = b->start_time + 0.3;
+        active++;
+    }
+
+    double start_time = get_time();
+    double last_shown = 0;
+
+    while (active > 0) {
+        double now = get_time();
+        double next = now + 0.1;    // Progress refresh
+
+        active = 0;
+        for (int i = 0; i < n; i++) {
+            board_t* b = &boards[i];
+            if (b->state >= BOARD_OK) continue;
+            if (now >= b->deadline) {
+                if (b->state == BOARD_ECHO) {
+                    // Step 2: Send 'R' (Ready)
+                    board_send(b, BOARD_READY, (const uint8_t*)"R", 1);
+                } else {
+                    board_fail(b, "Timeout in %s step", board_step[b->state]);
+                    continue;
+                }
+            }
+            if (b->state >= BOARD_OK) continue;
+            if (b->deadline < next) next = b->deadline;
+            active++;
+        }
+        if (active == 0) break;
+
+        multi_wait(boards, n, (int)((next - now) * 1000.0) + 1, data, size, crc);
+
+        if (now - last_shown >= 0.1) {
+            show_multi_progress(boards, n, size, start_time);
+            last_shown = now;
+        }
+    }
+    show_multi_progress(boards, n, size, start_time);
+    show_multi_results(boards, n, size, crc);
+
+    bool success = true;
+    for (int i = 0; i < n; i++) {
+        if (boards[i].start_time) serial_close(boards[i].s);
+        if (boards[i].state != BOARD_OK) success = false;
+    }
+    return success;
+}
+
 // Main
 void print_usage(const char* prog) {
     printf("Firmware Uploader (%s)\n\n", PLATFORM);
-    printf("Usage: %s [options] <firmware.bin>\n\n", prog);
+    printf("Usage: %s [options] <firmware.bin|firmware.elf>\n\n", prog);
     printf("Options:\n");
-    printf("  -p, --port <port>     Serial port (required)\n");
+    printf("  -p, --port <port>     Serial port (required); repeat for several boards\n");
+    printf("  -a, --all             Every FTDI port found (see --list), all at once\n");
     printf("  -b, --baud <rate>     Baud rate (default: %d)\n", DEFAULT_BAUD);
-    printf("  -v, --verbose         Verbose output (show all ACKs)\n");
+    printf("  -v, --verbose         Verbose output (show all ACKs, single board only)\n");
     printf("  -l, --list            List available serial ports\n");
     printf("  -h, --help            Show this help\n\n");
+    printf("With more than one port the boards are flashed concurrently (up to %d)\n", MAX_BOARDS);
+    printf("and a result table is printed at the end.\n\n");
     printf("Examples:\n");
 #ifdef _WIN32
     printf("  %s -p COM8 firmware.bin\n", prog);
+    printf("  %s -p COM8 -p COM9 firmware.bin\n", prog);
     printf("  %s --list\n", prog);
 #else
     printf("  %s -p /dev/cu.usbserial-XXXXX firmware.bin\n", prog);
+    printf("  %s -p /dev/ttyUSB0 -p /dev/ttyUSB2 firmware.bin\n", prog);
     printf("  %s --list\n", prog);
 #endif
+    printf("  %s --all firmware.bin\n", prog);
 }
 
 int main(int argc, char** argv) {
-    const char* port = NULL;
+    static char found[MAX_BOARDS][PORT_NAME_LEN];
+    const char* ports[MAX_BOARDS];
+    int nports = 0;
     const char* firmware = NULL;
     int baud = DEFAULT_BAUD;
     bool verbose = false;
     bool list_ports = false;
+    bool all_ports = false;
 
     // Parse arguments
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "-p") == 0 || strcmp(argv[i], "--port") == 0) {
             if (++i >= argc) { print_usage(argv[0]); return 1; }
-            port = argv[i];
+            if (nports == MAX_BOARDS) {
+                printf(COLOR_RED "ERROR: At most %d ports" COLOR_RESET "\n", MAX_BOARDS);
+                return 1;
+            }
+            ports[nports++] = argv[i];
+        } else if (strcmp(argv[i], "-a") == 0 || strcmp(argv[i], "--all") == 0) {
+            all_ports = true;
         } else if (strcmp(argv[i], "-b") == 0 || strcmp(argv[i], "--baud") == 0) {
             if (++i >= argc) { print_usage(argv[0]); return 1; }
             baud = atoi(argv[i]);
@@ -598,7 +989,18 @@ int main(int argc, char** argv) {
         return 0;
     }
 
-    if (!port || !firmware) {
+    if (all_ports) {
+        int n = find_serial_ports(found, MAX_BOARDS - nports, true);
+        if (n == 0 && nports == 0) {
+            printf(COLOR_RED "ERROR: No FTDI serial ports found" COLOR_RESET "\n");
+            return 1;
+        }
+        for (int i = 0; i < n; i++) {
+            ports[nports++] = found[i];
+        }
+    }
+
+    if (nports == 0 || !firmware) {
         print_usage(argv[0]);
         return 1;
     }
@@ -610,11 +1012,14 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    // An ELF carries symbols and debug info: only its segments count
+    uint8_t magic[4] = { 0 };
+    bool is_elf = fread(magic, 1, 4, f) == 4 && memcmp(magic, "\x7F" "ELF", 4) == 0;
     fseek(f, 0, SEEK_END);
     size_t size = ftell(f);
     fseek(f, 0, SEEK_SET);
 
-    if (size > MAX_PACKET_SIZE) {
+    if (!is_elf && size > MAX_PACKET_SIZE) {
         printf(COLOR_RED "ERROR: Firmware too large (%zu bytes, max %d)" COLOR_RESET "\n",
                size, MAX_PACKET_SIZE);
         fclose(f);
@@ -636,7 +1041,30 @@ int main(int argc, char** argv) {
     }
     fclose(f);
 
+    // The chunked protocol has no sparse mode: send the segments flat
+    if (is_elf) {
+        elf_image_t elf;
+        const char* err = elf_image_load(data, size, MAX_PACKET_SIZE, &elf);
+
+        free(data);
+        if (err) {
+            printf(COLOR_RED "ERROR: %s: %s" COLOR_RESET "\n", firmware, err);
+            free(elf.image);
+            return 1;
+        }
+        printf("ELF: %d load segments, %zu byte image\n", elf.segments, elf.file_end);
+        data = elf.image;
+        size = elf.file_end;
+    }
+
+    if (nports > 1 || all_ports) {
+        bool success = upload_multi(ports, nports, baud, data, size);
+        free(data);
+        return success ? 0 : 1;
+    }
+
     // Open serial port
+    const char* port = ports[0];
     printf("Connecting to %s at %d baud...\n", port, baud);
     serial_t s = serial_open(port, baud);
     if (s == INVALID_SERIAL) {
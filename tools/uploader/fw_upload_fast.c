@@ -15,6 +15,25 @@
  * standard bootloader protocol. Use the correct pairing:
  *   fw_upload_fast <-> hexedit_fast.elf (FAST streaming, NO chunking)
  *   fw_upload      <-> bootloader/hexedit.elf (standard chunked protocol)
+ *
+ * The bootloaders also take the windowed block protocol
+ * (lib/block_upload/block_upload.h): 1 KB blocks with a CRC32 each, up to
+ * a window of them in flight, bad or lost blocks resent alone. It is tried
+ * first; targets that do not answer the probe get the FAST stream. Run the
+ * same upload again after an interruption and it resumes at the first
+ * block the target is missing.
+ *
+ * -H sends the block protocol's hold packet first: on bitstreams with the
+ * hardware loader (Kconfig HW_LOADER) the FPGA holds the CPU in reset and
+ * takes the upload itself, whatever the CPU was running.
+ *
+ * An .elf is sent sparse (lib/sparse_upload.h): only the non-zero parts
+ * of its load segments, the target zeroes .bss and the gaps. Targets that
+ * do not answer 'S' get the flat image the ELF describes.
+ *
+ * -d sends a delta against the image the target still holds (lib/
+ * delta_upload.h): it returns the sums of its blocks, and only moves and
+ * changed data go back. Targets that do not answer 'D' get the full upload.
  */
 
 #include <stdio.h>
@@ -23,6 +42,12 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <time.h>
+#include "../../lib/block_upload/block_upload.h"
+#include "../../lib/uart_baud.h"
+#include "../../lib/sparse_upload.h"
+#define DELTA_UPLOAD_HOST
+#include "../../lib/delta_upload.h"
+#include "elf_image.h"
 
 // Platform-specific includes
 #ifdef _WIN32
@@ -37,6 +62,11 @@
     #include <fcntl.h>
     #include <sys/ioctl.h>
     #include <sys/time.h>
+    #include <sys/select.h>
+    #include <limits.h>
+    #ifdef __linux__
+        #include <linux/serial.h>   // ASYNC_LOW_LATENCY
+    #endif
     #ifndef FIONREAD
         #include <sys/socket.h>  // Try to get FIONREAD from socket.h
     #endif
@@ -59,6 +89,11 @@
 #define CHUNK_SIZE 64
 #define MAX_PACKET_SIZE 524288  // 512KB to match SRAM size
 #define TIMEOUT_MS 5000  // 5 seconds - enough for 512KB CRC calculation
+#define BLOCK_PROBE_S 0.3  // Block protocol probe answer, else FAST stream
+#define BLOCK_STALL_S 2.0  // No ACK for this long: resync with a new session
+#define BLOCK_RESYNCS 3
+#define SPARSE_MIN_GAP 32  // Zero runs this long are not sent (8 bytes per segment header)
+#define DELTA_BLOCK 256    // Delta upload block: 8 bytes of sums each come back
 
 // Color codes for terminal
 #ifdef _WIN32
@@ -163,6 +198,32 @@ void show_progress(progress_t* prog) {
     fflush(stdout);
 }
 
+// Handshake round trips: last write to the first reply byte read
+static struct {
+    double last_write;
+    bool pending;
+    int count;
+    double total;
+    double max;
+} rtt;
+
+static void rtt_sent(void) {
+    rtt.last_write = get_time();
+    rtt.pending = true;
+}
+
+static void rtt_reply(void) {
+    if (!rtt.pending) return;
+    double t = get_time() - rtt.last_write;
+    rtt.pending = false;
+    rtt.count++;
+    rtt.total += t;
+    if (t > rtt.max) rtt.max = t;
+}
+
+// Skip tcdrain() before a reply is read (-L): the reply needs the bytes out anyway
+static bool low_latency = false;
+
 // Serial port functions
 #ifdef _WIN32
 
@@ -200,6 +261,7 @@ void serial_close(serial_t h) {
 
 int serial_write(serial_t h, const uint8_t* data, size_t len) {
     DWORD written;
+    rtt_sent();
     if (!WriteFile(h, data, (DWORD)len, &written, NULL)) return -1;
     return written;
 }
@@ -214,6 +276,38 @@ void serial_flush(serial_t h) {
     PurgeComm(h, PURGE_RXCLEAR | PURGE_TXCLEAR);
 }
 
+int serial_available(serial_t h) {
+    COMSTAT stat;
+    DWORD errors;
+    return ClearCommError(h, &errors, &stat) ? (int)stat.cbInQue : 0;
+}
+
+bool serial_set_baud(serial_t h, int baud) {
+    DCB dcb = {0};
+    dcb.DCBlength = sizeof(DCB);
+    if (!GetCommState(h, &dcb)) return false;
+    dcb.BaudRate = baud;
+    return SetCommState(h, &dcb) != 0;
+}
+
+// Wait up to timeout seconds for input
+bool serial_wait(serial_t h, double timeout) {
+    double start = get_time();
+    while (serial_available(h) == 0) {
+        if (get_time() - start >= timeout) return false;
+        Sleep(1);
+    }
+    return true;
+}
+
+// The FTDI latency timer is a driver setting here (Device Manager, Port
+// Settings, Advanced)
+int serial_low_latency(serial_t h, const char* port) {
+    (void)h;
+    (void)port;
+    return -1;
+}
+
 void list_serial_ports(void) {
     printf("Available serial ports:\n");
     for (int i = 1; i < 256; i++) {
@@ -296,6 +390,7 @@ void serial_close(serial_t fd) {
 }
 
 int serial_write(serial_t fd, const uint8_t* data, size_t len) {
+    rtt_sent();
     return write(fd, data, len);
 }
 
@@ -307,6 +402,98 @@ void serial_flush(serial_t fd) {
     tcflush(fd, TCIOFLUSH);
 }
 
+int serial_available(serial_t fd) {
+    int n = 0;
+    ioctl(fd, FIONREAD, &n);
+    return n;
+}
+
+// Change the rate of an open port (pending output is sent first)
+bool serial_set_baud(serial_t fd, int baud) {
+    tcdrain(fd);
+#ifdef __APPLE__
+    speed_t custom_speed = baud;
+    return ioctl(fd, IOSSIOSPEED, &custom_speed) != -1;
+#else
+    struct termios options;
+    speed_t speed;
+
+    switch (baud) {
+        case 115200:  speed = B115200; break;
+        case 230400:  speed = B230400; break;
+        case 460800:  speed = B460800; break;
+        case 921600:  speed = B921600; break;
+        case 1000000: speed = B1000000; break;
+        case 1500000: speed = B1500000; break;
+        case 2000000: speed = B2000000; break;
+        case 2500000: speed = B2500000; break;
+        case 3000000: speed = B3000000; break;
+        case 3500000: speed = B3500000; break;
+        case 4000000: speed = B4000000; break;
+        default:      return false;
+    }
+    if (tcgetattr(fd, &options) != 0) return false;
+    cfsetispeed(&options, speed);
+    cfsetospeed(&options, speed);
+    return tcsetattr(fd, TCSANOW, &options) == 0;
+#endif
+}
+
+// Wait up to timeout seconds for input; returns as soon as a byte is there
+bool serial_wait(serial_t fd, double timeout) {
+    if (timeout <= 0) return false;
+
+    fd_set rfds;
+    struct timeval tv = {
+        .tv_sec = (long)timeout,
+        .tv_usec = (long)((timeout - (long)timeout) * 1000000.0)
+    };
+    FD_ZERO(&rfds);
+    FD_SET(fd, &rfds);
+    return select(fd + 1, &rfds, NULL, NULL, &tv) > 0;
+}
+
+// USB serial adapters hold received bytes until a USB packet fills or the
+// latency timer runs out (16 ms on FTDI), so every handshake waits that
+// long. ASYNC_LOW_LATENCY has ftdi_sio set 1 ms; the sysfs latency_timer
+// is the fallback (writable as root or with a udev rule). Returns the
+// latency timer in ms, or -1 if there is none to read.
+int serial_low_latency(serial_t fd, const char* port) {
+#ifdef __linux__
+    struct serial_struct ss;
+    char real[PATH_MAX], path[PATH_MAX + 64];
+    int ms = -1;
+
+    if (ioctl(fd, TIOCGSERIAL, &ss) == 0) {
+        ss.flags |= ASYNC_LOW_LATENCY;
+        ioctl(fd, TIOCSSERIAL, &ss);
+    }
+
+    // /dev/serial/by-id/... links to the ttyUSBn the sysfs entry is named after
+    if (!realpath(port, real)) return -1;
+    const char* name = strrchr(real, '/');
+    snprintf(path, sizeof(path), "/sys/class/tty/%s/device/latency_timer",
+             name ? name + 1 : real);
+
+    FILE* f = fopen(path, "r+");
+    if (f) {
+        fprintf(f, "1\n");
+        fclose(f);
+    }
+    f = fopen(path, "r");
+    if (f) {
+        if (fscanf(f, "%d", &ms) != 1) ms = -1;
+        fclose(f);
+    }
+    return ms;
+#else
+    // macOS: the FTDI VCP driver takes its latency from the kext's plist
+    (void)fd;
+    (void)port;
+    return -1;
+#endif
+}
+
 void list_serial_ports(void) {
     printf("Available serial ports:\n");
 
@@ -344,11 +531,13 @@ void list_serial_ports(void) {
 // Upload protocol
 bool send_byte(serial_t s, uint8_t byte, bool verbose) {
     if (serial_write(s, &byte, 1) != 1) return false;
+    if (!low_latency) {
     #ifdef _WIN32
         FlushFileBuffers(s);
     #else
         tcdrain(s);  // Wait for output to be transmitted (like Python's flush())
     #endif
+    }
     if (verbose) {
         printf("TX: 0x%02X ('%c')\n", byte, (byte >= 32 && byte < 127) ? byte : '.');
     }
@@ -363,6 +552,7 @@ bool wait_for_ack(serial_t s, uint8_t expected_ack, bool verbose) {
         if (verbose) printf("ERROR: Timeout waiting for ACK\n");
         return false;
     }
+    rtt_reply();
 
     if (verbose) {
         printf("RX: 0x%02X ('%c') - Expected: 0x%02X ('%c')\n",
@@ -385,21 +575,1116 @@ bool wait_for_ack(serial_t s, uint8_t expected_ack, bool verbose) {
     return false;
 }
 
-bool upload_firmware(serial_t s, const uint8_t* data, size_t size, bool verbose) {
-    init_crc32();
+// bootloader_fast follows a CRC mismatch with 'E' + dropped and framing
+// error counts (2 bytes each, little-endian); older bootloaders and
+// hexedit_fast send nothing
+static void read_rx_report(serial_t s) {
+    uint8_t report[5];
+    int report_read = 0;
+    double report_start = get_time();
+    while (report_read < 5 && (get_time() - report_start) < 0.5) {
+        int ret = serial_read(s, report + report_read, 5 - report_read);
+        if (ret > 0) {
+            report_read += ret;
+        }
+    }
+    if (report_read == 5 && report[0] == 'E') {
+        unsigned dropped = report[1] | (report[2] << 8);
+        unsigned frames = report[3] | (report[4] << 8);
+        printf("  UART RX: %u bytes dropped (RX buffer full), %u framing errors\n",
+               dropped, frames);
+        if (dropped) {
+            printf("  Try a lower baud rate or a larger UART_RX_BUF_SIZE\n");
+        }
+    }
+}
+
+//==============================================================================
+// Block Protocol (lib/block_upload/block_upload.h)
+//==============================================================================
+
+enum { BLK_PENDING, BLK_IN_FLIGHT, BLK_ACKED };
+
+static void block_send_packet(serial_t s, uint8_t type, uint16_t arg,
+                              const uint8_t* payload, uint16_t len) {
+    uint8_t hdr[BLOCK_UPLOAD_HEADER_SIZE] = {
+        type, arg & 0xFF, arg >> 8, len & 0xFF, len >> 8,
+        block_upload_check(type, arg, len)
+    };
+    uint32_t crc = len ? calculate_crc32(payload, len) : 0;
+    uint8_t packet[BLOCK_UPLOAD_HEADER_SIZE + BLOCK_UPLOAD_BLOCK_SIZE + 4];
+
+    // One write per packet: a USB transfer rather than three
+    memcpy(packet, hdr, sizeof(hdr));
+    if (len) memcpy(packet + sizeof(hdr), payload, len);
+    packet[sizeof(hdr) + len + 0] = crc & 0xFF;
+    packet[sizeof(hdr) + len + 1] = (crc >> 8) & 0xFF;
+    packet[sizeof(hdr) + len + 2] = (crc >> 16) & 0xFF;
+    packet[sizeof(hdr) + len + 3] = crc >> 24;
+    serial_write(s, packet, sizeof(hdr) + len + 4);
+}
+
+// Next complete reply into rsp (type + up to 4 bytes), within timeout seconds.
+// Bytes that start no known reply (shell echo, noise) are skipped.
+static bool block_read_reply(serial_t s, uint8_t* rsp, double timeout) {
+    static uint8_t buf[5];
+    static int have = 0;
+    double start = get_time();
+
+    while (1) {
+        int need = 1;
+        if (have) {
+            switch (buf[0]) {
+                case BLOCK_RSP_ACK:
+                case BLOCK_RSP_NAK:    need = 3; break;
+                case BLOCK_RSP_INFO:
+                case BLOCK_RSP_RESUME:
+                case BLOCK_RSP_REJECT:
+                case BLOCK_RSP_DONE:   need = 5; break;
+                default:               have = 0; continue;
+            }
+            if (have == need) {
+                memcpy(rsp, buf, need);
+                have = 0;
+                return true;
+            }
+        }
+
+        if (serial_available(s) > 0) {
+            if (serial_read(s, buf + have, 1) == 1) have++;
+        } else if (!serial_wait(s, timeout - (get_time() - start))) {
+            return false;
+        }
+    }
+}
+
+static uint32_t get_le32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Start (or resync) the session; returns the resume offset, or -1
+static long block_session(serial_t s, const uint8_t* data, size_t size) {
+    uint32_t crc = calculate_crc32(data, size);
+    uint8_t payload[8] = {
+        size & 0xFF, (size >> 8) & 0xFF, (size >> 16) & 0xFF, (size >> 24) & 0xFF,
+        crc & 0xFF, (crc >> 8) & 0xFF, (crc >> 16) & 0xFF, crc >> 24
+    };
+    uint8_t rsp[5];
+
+    for (int attempt = 0; attempt < 3; attempt++) {
+        double start = get_time();
+        block_send_packet(s, BLOCK_PKT_SESSION, 0, payload, sizeof(payload));
+
+        // Skip ACKs still on their way from before a resync
+        while (get_time() - start < 1.0) {
+            if (!block_read_reply(s, rsp, 1.0)) break;
+            if (rsp[0] == BLOCK_RSP_RESUME) return get_le32(rsp + 1);
+            if (rsp[0] == BLOCK_RSP_REJECT) {
+                printf(COLOR_RED "ERROR: Target accepts at most %u bytes" COLOR_RESET "\n",
+                       get_le32(rsp + 1));
+                return -1;
+            }
+        }
+    }
+    printf(COLOR_RED "ERROR: No answer to the session packet" COLOR_RESET "\n");
+    return -1;
+}
+
+// Returns 1 on success, 0 on failure, -1 if the target does not know the
+// block protocol (nothing was sent that it would act on)
+int upload_blocks(serial_t s, const uint8_t* data, size_t size, int baud, bool verbose) {
+    uint32_t nblocks = (size + BLOCK_UPLOAD_BLOCK_SIZE - 1) / BLOCK_UPLOAD_BLOCK_SIZE;
+    uint8_t* state = calloc(nblocks, 1);
+    uint32_t* seq = calloc(nblocks, sizeof(uint32_t));
+    double* sent_at = calloc(nblocks, sizeof(double));
+    uint32_t next_seq = 0, acked = 0, in_flight = 0, cursor = 0;
+    uint32_t sends = 0, naks = 0, window = BLOCK_UPLOAD_WINDOW;
+    uint32_t crc = calculate_crc32(data, size);
+    int resyncs = 0, result = 0;
+    bool finish_sent = false;
+    double finish_at = 0, last_ack;
+    uint8_t rsp[5];
+    long resume;
+
+    // One window on the wire, plus USB latency, before a block counts as lost
+    double retry_s = 0.1 + 2.0 * BLOCK_UPLOAD_WINDOW *
+                     (BLOCK_UPLOAD_BLOCK_SIZE + 10) * 10.0 / baud;
 
     progress_t prog = {
-        .total_bytes = size + 5 + 5,  // Data + size + CRC
+        .total_bytes = size,
+        .bytes_sent = 0,
+        .verbose = verbose
+    };
+
+    if (!state || !seq || !sent_at) {
+        free(state); free(seq); free(sent_at);
+        return 0;
+    }
+
+    block_send_packet(s, BLOCK_PKT_PROBE, BLOCK_UPLOAD_VERSION, NULL, 0);
+    if (!block_read_reply(s, rsp, BLOCK_PROBE_S) || rsp[0] != BLOCK_RSP_INFO ||
+        (rsp[2] | (rsp[3] << 8)) != BLOCK_UPLOAD_BLOCK_SIZE) {
+        free(state); free(seq); free(sent_at);
+        return -1;
+    }
+    if (rsp[4] && rsp[4] < window) window = rsp[4];
+
+    printf("\n=== Block Upload (%u x %d bytes, window %u) ===\n",
+           nblocks, BLOCK_UPLOAD_BLOCK_SIZE, window);
+    printf("Uploading firmware (%zu bytes, CRC: 0x%08X)...\n\n", size, crc);
+
+resync:
+    if ((resume = block_session(s, data, size)) < 0) {
+        if (resyncs) printf("Run the upload again to resume where it stopped.\n");
+        goto out;
+    }
+    in_flight = 0;
+    cursor = 0;
+    acked = 0;
+    for (uint32_t i = 0; i < nblocks; i++) {
+        state[i] = ((long)i * BLOCK_UPLOAD_BLOCK_SIZE < resume) ? BLK_ACKED : BLK_PENDING;
+        if (state[i] == BLK_ACKED) acked++;
+    }
+    if (resume > 0) {
+        printf("Resuming at offset %ld (%u blocks already on the target)\n", resume, acked);
+    }
+    finish_sent = false;
+    prog.start_time = get_time();
+    last_ack = get_time();
+
+    while (1) {
+        double now = get_time();
+
+        // Keep the window full, lowest pending block first
+        while (in_flight < window && !finish_sent) {
+            while (cursor < nblocks && state[cursor] != BLK_PENDING) cursor++;
+            if (cursor == nblocks) break;
+
+            uint32_t len = size - (size_t)cursor * BLOCK_UPLOAD_BLOCK_SIZE;
+            if (len > BLOCK_UPLOAD_BLOCK_SIZE) len = BLOCK_UPLOAD_BLOCK_SIZE;
+            block_send_packet(s, BLOCK_PKT_DATA, cursor,
+                              data + (size_t)cursor * BLOCK_UPLOAD_BLOCK_SIZE, len);
+            state[cursor] = BLK_IN_FLIGHT;
+            seq[cursor] = next_seq++;
+            sent_at[cursor] = now;
+            in_flight++;
+            sends++;
+        }
+
+        if (acked == nblocks && (!finish_sent || now - finish_at > 1.0)) {
+            if (verbose) printf("TX: finish\n");
+            block_send_packet(s, BLOCK_PKT_FINISH, 0, NULL, 0);
+            finish_sent = true;
+            finish_at = now;
+        }
+
+        if (block_read_reply(s, rsp, 0.005)) {
+            uint32_t idx = rsp[1] | (rsp[2] << 8);
+
+            if (rsp[0] == BLOCK_RSP_DONE) {
+                uint32_t fpga_crc = get_le32(rsp + 1);
+                if (!verbose) {
+                    show_progress(&prog);
+                    printf("\n");
+                }
+                printf("\n%u blocks sent for %u (%u NAKed)\n", sends, nblocks, naks);
+                printf("FPGA CRC:     0x%08X\n", fpga_crc);
+                printf("Expected CRC: 0x%08X\n", crc);
+                if (fpga_crc == crc) {
+                    printf(COLOR_GREEN "%s SUCCESS - CRC Match!" COLOR_RESET "\n", CHECK_MARK);
+                    result = 1;
+                } else {
+                    printf(COLOR_RED "%s FAILURE" COLOR_RESET "\n", CROSS_MARK);
+                    printf("  CRC Mismatch: XOR=0x%08X\n", fpga_crc ^ crc);
+                    read_rx_report(s);
+                }
+                goto out;
+            }
+
+            if ((rsp[0] == BLOCK_RSP_ACK || rsp[0] == BLOCK_RSP_NAK) && idx < nblocks) {
+                // Replies come in send order: anything sent before this
+                // block and still unanswered never arrived whole
+                if (state[idx] == BLK_IN_FLIGHT) {
+                    for (uint32_t i = 0; i < nblocks; i++) {
+                        if (state[i] == BLK_IN_FLIGHT && seq[i] < seq[idx]) {
+                            if (verbose) printf("Block %u lost, resending\n", i);
+                            state[i] = BLK_PENDING;
+                            in_flight--;
+                            if (i < cursor) cursor = i;
+                        }
+                    }
+                }
+
+                if (rsp[0] == BLOCK_RSP_ACK) {
+                    if (state[idx] == BLK_IN_FLIGHT) in_flight--;
+                    if (state[idx] != BLK_ACKED) acked++;
+                    state[idx] = BLK_ACKED;
+                    last_ack = now;
+                    prog.bytes_sent = (size_t)acked * BLOCK_UPLOAD_BLOCK_SIZE;
+                    if (prog.bytes_sent > size) prog.bytes_sent = size;
+                    if (!verbose && (acked % 8 == 0 || acked == nblocks)) show_progress(&prog);
+                } else {
+                    // Bad CRC, or the finish found this block missing
+                    if (verbose) printf("RX: NAK block %u\n", idx);
+                    naks++;
+                    if (state[idx] == BLK_IN_FLIGHT) in_flight--;
+                    if (state[idx] == BLK_ACKED) acked--;
+                    state[idx] = BLK_PENDING;
+                    if (idx < cursor) cursor = idx;
+                    finish_sent = false;
+                }
+            }
+            continue;
+        }
+
+        // Silent losses: no reply at all within the retry time
+        for (uint32_t i = 0; i < nblocks; i++) {
+            if (state[i] == BLK_IN_FLIGHT && now - sent_at[i] > retry_s) {
+                if (verbose) printf("Block %u timed out, resending\n", i);
+                state[i] = BLK_PENDING;
+                in_flight--;
+                if (i < cursor) cursor = i;
+            }
+        }
+
+        if (now - last_ack > BLOCK_STALL_S && !finish_sent) {
+            if (++resyncs > BLOCK_RESYNCS) {
+                printf(COLOR_RED "\nERROR: Target stopped acknowledging blocks" COLOR_RESET "\n");
+                printf("Run the upload again to resume where it stopped.\n");
+                goto out;
+            }
+            printf(COLOR_YELLOW "\nNo ACKs for %.0fs, resyncing (%d/%d)" COLOR_RESET "\n",
+                   BLOCK_STALL_S, resyncs, BLOCK_RESYNCS);
+            goto resync;
+        }
+        if (finish_sent && now - finish_at > 1.0 && now - last_ack > 5.0) {
+            printf(COLOR_RED "\nERROR: No answer to finish" COLOR_RESET "\n");
+            goto out;
+        }
+    }
+
+out:
+    free(state);
+    free(seq);
+    free(sent_at);
+    return result;
+}
+
+//==============================================================================
+// LZ4 (same block format and compressor as tools/lz4boot)
+//==============================================================================
+
+#define LZ4B_MAGIC      0x42345A4C  // "LZ4B": .bin.lz4 from tools/lz4boot
+#define LZ4_MIN_MATCH   4
+#define LZ4_LAST_LITERALS 5         // Block always ends with 5+ literals
+#define LZ4_MF_LIMIT    12          // Last match starts 12+ bytes before the end
+#define LZ4_MAX_OFFSET  65535
+#define LZ4_HASH_BITS   16
+#define LZ4_CHAIN_DEPTH 256
+
+static int32_t* lz4_head;
+static int32_t* lz4_prev;
+
+static uint32_t lz4_hash4(const uint8_t* p) {
+    uint32_t v = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+    return (v * 2654435761u) >> (32 - LZ4_HASH_BITS);
+}
+
+static void lz4_insert(const uint8_t* src, size_t pos) {
+    uint32_t h = lz4_hash4(src + pos);
+    lz4_prev[pos] = lz4_head[h];
+    lz4_head[h] = (int32_t)pos;
+}
+
+// Longest match for pos (ending by limit); 0 if shorter than LZ4_MIN_MATCH
+static size_t lz4_find_match(const uint8_t* src, size_t pos, size_t limit, size_t* offset) {
+    size_t best = 0;
+    int32_t cand = lz4_head[lz4_hash4(src + pos)];
+
+    for (int depth = 0; cand >= 0 && depth < LZ4_CHAIN_DEPTH; depth++) {
+        if (pos - (size_t)cand > LZ4_MAX_OFFSET) break;
+        size_t len = 0;
+        while (pos + len < limit && src[cand + len] == src[pos + len]) len++;
+        if (len > best) {
+            best = len;
+            *offset = pos - (size_t)cand;
+        }
+        cand = lz4_prev[cand];
+    }
+    return best >= LZ4_MIN_MATCH ? best : 0;
+}
+
+static uint8_t* lz4_put_length(uint8_t* op, size_t n) {
+    while (n >= 255) {
+        *op++ = 255;
+        n -= 255;
+    }
+    *op++ = (uint8_t)n;
+    return op;
+}
+
+static uint8_t* lz4_put_sequence(uint8_t* op, const uint8_t* lit, size_t lit_len,
+                                 size_t offset, size_t match_len) {
+    uint8_t* token = op++;
+    size_t ml = match_len ? match_len - LZ4_MIN_MATCH : 0;
+
+    *token = (uint8_t)(((lit_len < 15 ? lit_len : 15) << 4) | (ml < 15 ? ml : 15));
+    if (lit_len >= 15) op = lz4_put_length(op, lit_len - 15);
+    memcpy(op, lit, lit_len);
+    op += lit_len;
+
+    if (match_len) {
+        *op++ = offset & 0xFF;
+        *op++ = offset >> 8;
+        if (ml >= 15) op = lz4_put_length(op, ml - 15);
+    }
+    return op;
+}
+
+// Compress n bytes into a new block; returns its size, 0 if out of memory
+static size_t lz4_compress(const uint8_t* src, size_t n, uint8_t** block) {
+    uint8_t* dst = malloc(n + n / 255 + 16);
+    uint8_t* op = dst;
+    size_t anchor = 0, pos = 0;
+
+    lz4_head = malloc(sizeof(int32_t) << LZ4_HASH_BITS);
+    lz4_prev = malloc(sizeof(int32_t) * n);
+    if (!dst || !lz4_head || !lz4_prev) {
+        free(dst); free(lz4_head); free(lz4_prev);
+        return 0;
+    }
+    memset(lz4_head, 0xFF, sizeof(int32_t) << LZ4_HASH_BITS);
+
+    if (n > LZ4_MF_LIMIT) {
+        size_t mf_limit = n - LZ4_MF_LIMIT;
+        size_t match_limit = n - LZ4_LAST_LITERALS;
+
+        while (pos < mf_limit) {
+            size_t offset = 0;
+            size_t len = lz4_find_match(src, pos, match_limit, &offset);
+
+            // One step lazy: take a literal if the next byte matches longer
+            lz4_insert(src, pos);
+            if (len && pos + 1 < mf_limit) {
+                size_t next_offset = 0;
+                size_t next = lz4_find_match(src, pos + 1, match_limit, &next_offset);
+                if (next > len + 1) {
+                    pos++;
+                    len = next;
+                    offset = next_offset;
+                }
+            }
+            if (!len) {
+                pos++;
+                continue;
+            }
+
+            op = lz4_put_sequence(op, src + anchor, pos - anchor, offset, len);
+            for (size_t i = pos + 1; i < pos + len && i + LZ4_MIN_MATCH <= n; i++) {
+                lz4_insert(src, i);
+            }
+            pos += len;
+            anchor = pos;
+        }
+    }
+
+    // Last sequence: literals only
+    op = lz4_put_sequence(op, src + anchor, n - anchor, 0, 0);
+    free(lz4_head);
+    free(lz4_prev);
+    *block = dst;
+    return op - dst;
+}
+
+// Decode a block to exactly length bytes; 0 if it is well formed
+static int lz4_decode(const uint8_t* ip, size_t in_len, uint8_t* dst, size_t length) {
+    const uint8_t* in_end = ip + in_len;
+    uint8_t* out = dst;
+    uint8_t* end = dst + length;
+
+    while (ip < in_end) {
+        uint8_t token = *ip++;
+        size_t n = token >> 4;
+        if (n == 15) {
+            uint8_t b;
+            do {
+                if (ip >= in_end) return -1;
+                b = *ip++;
+                n += b;
+            } while (b == 255);
+        }
+        if (n > (size_t)(end - out) || n > (size_t)(in_end - ip)) return -1;
+        memcpy(out, ip, n);
+        out += n;
+        ip += n;
+
+        if (out == end) return ip == in_end ? 0 : -1;
+
+        if (in_end - ip < 2) return -1;
+        size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        n = token & 15;
+        if (n == 15) {
+            uint8_t b;
+            do {
+                if (ip >= in_end) return -1;
+                b = *ip++;
+                n += b;
+            } while (b == 255);
+        }
+        n += LZ4_MIN_MATCH;
+        if (offset == 0 || offset > (size_t)(out - dst) || n > (size_t)(end - out)) return -1;
+        for (const uint8_t* src = out - offset; n--; ) *out++ = *src++;
+    }
+    return -1;
+}
+
+//==============================================================================
+// Compressed FAST Protocol (lib/lz4_stream.h)
+//==============================================================================
+
+static bool read_byte_timeout(serial_t s, uint8_t* b, double timeout) {
+    double start = get_time();
+    do {
+        if (serial_available(s) > 0 && serial_read(s, b, 1) == 1) {
+            rtt_reply();
+            return true;
+        }
+    } while (serial_wait(s, timeout - (get_time() - start)));
+    return false;
+}
+
+static void put_le32(uint8_t* p, uint32_t v) {
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+    p[2] = (v >> 16) & 0xFF;
+    p[3] = v >> 24;
+}
+
+// Returns 1 on success, 0 on failure, -1 if the target does not answer 'Z'
+int upload_compressed(serial_t s, const uint8_t* data, size_t size,
+                      const uint8_t* block, size_t block_size, bool verbose) {
+    uint32_t crc = calculate_crc32(data, size);
+    uint8_t sizes[8], b, response[5];
+    double t0;
+
+    if (!send_byte(s, 'Z', verbose)) return 0;
+    if (!read_byte_timeout(s, &b, BLOCK_PROBE_S) || b != 'A') return -1;
+
+    printf("\n=== Compressed FAST Upload (LZ4) ===\n");
+    printf("Uploading firmware (%zu bytes as %zu, %.1f%%, CRC: 0x%08X)...\n\n",
+           size, block_size, 100.0 * block_size / size, crc);
+
+    put_le32(sizes, (uint32_t)block_size);
+    put_le32(sizes + 4, (uint32_t)size);
+    if (serial_write(s, sizes, sizeof(sizes)) != sizeof(sizes)) return 0;
+    if (!read_byte_timeout(s, &b, 1.0) || b != 'B') {
+        printf(COLOR_RED "ERROR: Target refused a %zu byte image" COLOR_RESET "\n", size);
+        return 0;
+    }
+
+    progress_t prog = {
+        .total_bytes = block_size,
+        .bytes_sent = 0,
+        .start_time = get_time(),
+        .verbose = verbose
+    };
+    t0 = prog.start_time;
+
+    for (size_t off = 0; off < block_size; off += 1024) {
+        size_t n = block_size - off < 1024 ? block_size - off : 1024;
+        if (serial_write(s, block + off, n) != (int)n) {
+            printf(COLOR_RED "\nERROR: Failed to send data at offset %zu" COLOR_RESET "\n", off);
+            return 0;
+        }
+        prog.bytes_sent += n;
+        if (!verbose) show_progress(&prog);
+    }
+
+    uint8_t crc_packet[5] = { 'C' };
+    put_le32(crc_packet + 1, crc);
+    if (serial_write(s, crc_packet, 5) != 5) return 0;
+    #ifdef _WIN32
+        FlushFileBuffers(s);
+    #else
+        tcdrain(s);
+    #endif
+
+    int total_read = 0;
+    while (total_read < 5 && read_byte_timeout(s, response + total_read, 5.0)) {
+        total_read++;
+    }
+    double elapsed = get_time() - t0;
+    if (!verbose) printf("\n");
+    if (total_read < 5) {
+        printf(COLOR_RED "\nERROR: Timeout waiting for CRC response (5s)" COLOR_RESET "\n");
+        return 0;
+    }
+
+    uint32_t fpga_crc = get_le32(response + 1);
+    printf("\nSent %zu bytes in %.2fs: %.1f KB/s on the wire, %.1f KB/s effective (%.2fx)\n",
+           block_size, elapsed, block_size / elapsed / 1024.0, size / elapsed / 1024.0,
+           (double)size / block_size);
+    printf("FPGA CRC:     0x%08X\n", fpga_crc);
+    printf("Expected CRC: 0x%08X\n", crc);
+
+    if (response[0] == 'C' && fpga_crc == crc) {
+        printf(COLOR_GREEN "%s SUCCESS - CRC Match!" COLOR_RESET "\n", CHECK_MARK);
+        return 1;
+    }
+    printf(COLOR_RED "%s FAILURE" COLOR_RESET "\n", CROSS_MARK);
+    printf("  CRC Mismatch: XOR=0x%08X\n", fpga_crc ^ crc);
+    read_rx_report(s);
+    return 0;
+}
+
+//==============================================================================
+// Sparse FAST Protocol (lib/sparse_upload.h)
+//==============================================================================
+
+// Returns 1 on success, 0 on failure, -1 if the target does not answer 'S'
+int upload_sparse(serial_t s, const uint8_t* image, size_t size, bool verbose) {
+    uint32_t crc = calculate_crc32(image, size);
+    uint8_t hdr[8], b, response[5];
+    size_t wire = 8, pos, n;
+    int segments = 0;
+    double t0;
+
+    for (pos = 0; (n = elf_image_next_run(image, size, &pos, SPARSE_MIN_GAP)) != 0; pos += n) {
+        wire += 8 + n;
+        segments++;
+    }
+
+    if (!send_byte(s, SPARSE_UPLOAD_CMD, verbose)) return 0;
+    if (!read_byte_timeout(s, &b, BLOCK_PROBE_S) || b != 'A') return -1;
+
+    printf("\n=== Sparse FAST Upload (ELF) ===\n");
+    printf("Uploading firmware (%zu bytes as %d segments, %zu bytes, %.1f%%, CRC: 0x%08X)...\n\n",
+           size, segments, wire, 100.0 * wire / size, crc);
+
+    put_le32(hdr, (uint32_t)size);
+    if (serial_write(s, hdr, 4) != 4) return 0;
+    if (!read_byte_timeout(s, &b, 1.0) || b != 'B') {
+        printf(COLOR_RED "ERROR: Target refused a %zu byte image" COLOR_RESET "\n", size);
+        return 0;
+    }
+
+    progress_t prog = {
+        .total_bytes = wire,
         .bytes_sent = 0,
         .start_time = get_time(),
         .verbose = verbose
     };
+    t0 = prog.start_time;
+
+    for (pos = 0; (n = elf_image_next_run(image, size, &pos, SPARSE_MIN_GAP)) != 0; pos += n) {
+        if (verbose) printf("Segment 0x%05zX, %zu bytes\n", pos, n);
+        put_le32(hdr, (uint32_t)pos);
+        put_le32(hdr + 4, (uint32_t)n);
+        if (serial_write(s, hdr, 8) != 8) return 0;
+        prog.bytes_sent += 8;
+        for (size_t off = 0; off < n; off += 1024) {
+            size_t len = n - off < 1024 ? n - off : 1024;
+            if (serial_write(s, image + pos + off, len) != (int)len) {
+                printf(COLOR_RED "\nERROR: Failed to send data at 0x%05zX" COLOR_RESET "\n", pos + off);
+                return 0;
+            }
+            prog.bytes_sent += len;
+            if (!verbose) show_progress(&prog);
+        }
+    }
+    memset(hdr, 0, sizeof(hdr));
+    if (serial_write(s, hdr, 8) != 8) return 0;
+
+    uint8_t crc_packet[5] = { 'C' };
+    put_le32(crc_packet + 1, crc);
+    if (serial_write(s, crc_packet, 5) != 5) return 0;
+    #ifdef _WIN32
+        FlushFileBuffers(s);
+    #else
+        tcdrain(s);
+    #endif
+
+    int total_read = 0;
+    while (total_read < 5 && read_byte_timeout(s, response + total_read, 5.0)) {
+        total_read++;
+    }
+    double elapsed = get_time() - t0;
+    if (!verbose) printf("\n");
+    if (total_read < 5) {
+        printf(COLOR_RED "\nERROR: Timeout waiting for CRC response (5s)" COLOR_RESET "\n");
+        return 0;
+    }
+
+    uint32_t fpga_crc = get_le32(response + 1);
+    printf("\nSent %zu bytes in %.2fs: %.1f KB/s on the wire, %.1f KB/s effective (%.2fx)\n",
+           wire, elapsed, wire / elapsed / 1024.0, size / elapsed / 1024.0,
+           (double)size / wire);
+    printf("FPGA CRC:     0x%08X\n", fpga_crc);
+    printf("Expected CRC: 0x%08X\n", crc);
+
+    if (response[0] == 'C' && fpga_crc == crc) {
+        printf(COLOR_GREEN "%s SUCCESS - CRC Match!" COLOR_RESET "\n", CHECK_MARK);
+        return 1;
+    }
+    printf(COLOR_RED "%s FAILURE" COLOR_RESET "\n", CROSS_MARK);
+    printf("  CRC Mismatch: XOR=0x%08X\n", fpga_crc ^ crc);
+    read_rx_report(s);
+    return 0;
+}
+
+//==============================================================================
+// Delta Upload (lib/delta_upload.h)
+//==============================================================================
+
+typedef struct {
+    uint32_t dst;
+    uint32_t src;
+    uint32_t len;
+} delta_op_t;
+
+static uint32_t delta_key(uint32_t weak) {
+    return (weak ^ (weak >> 16)) & 0xFFFF;
+}
 
+// The target's blocks found in the new image, in dst order: the rolling weak
+// sum at every offset, a hit confirmed by the CRC32. Of equal blocks (zero
+// fill) the one at its old offset wins, since it costs nothing, then the
+// one that extends the previous move.
+static size_t delta_match(const uint8_t* data, size_t size, const uint8_t* sums,
+                          size_t block, delta_op_t* match) {
+    size_t nfull = size / block, n = 0, pos = 0;
+    int32_t* head = malloc(65536 * sizeof(int32_t));
+    int32_t* next = malloc((nfull + 1) * sizeof(int32_t));
+    uint32_t a = 0, b = 0;
+    bool fresh = true;
+
+    if (!head || !next) {
+        free(head);
+        free(next);
+        return 0;
+    }
+    memset(head, 0xFF, 65536 * sizeof(int32_t));
+    for (size_t k = nfull; k-- > 0; ) {
+        uint32_t key = delta_key(get_le32(sums + 8 * k));
+        next[k] = head[key];
+        head[key] = (int32_t)k;
+    }
+
+    while (pos + block <= size) {
+        if (fresh) {
+            uint32_t w = delta_upload_weak(data + pos, (uint32_t)block);
+            a = w & 0xFFFF;
+            b = w >> 16;
+            fresh = false;
+        }
+        uint32_t weak = (a & 0xFFFF) | (b << 16), crc = 0;
+        size_t follow = (n > 0 && match[n - 1].dst + match[n - 1].len == pos)
+                        ? match[n - 1].src + match[n - 1].len : SIZE_MAX;
+        bool have_crc = false;
+        long hit = -1;
+
+        for (int32_t k = head[delta_key(weak)]; k >= 0; k = next[k]) {
+            if (get_le32(sums + 8 * k) != weak) continue;
+            if (!have_crc) {
+                crc = calculate_crc32(data + pos, block);
+                have_crc = true;
+            }
+            if (get_le32(sums + 8 * k + 4) != crc) continue;
+            if (hit < 0 || (size_t)k * block == follow) hit = k;
+            if ((size_t)k * block == pos) {
+                hit = k;
+                break;
+            }
+        }
+        if (hit >= 0) {
+            match[n].dst = (uint32_t)pos;
+            match[n].src = (uint32_t)(hit * block);
+            match[n].len = (uint32_t)block;
+            n++;
+            pos += block;
+            fresh = true;
+            continue;
+        }
+
+        // Roll one byte: drop data[pos], take data[pos + block]
+        if (pos + block < size) {
+            a = a - data[pos] + data[pos + block];
+            b = b - (uint32_t)block * data[pos] + a;
+        }
+        pos++;
+    }
+
+    // The short last block can only have stayed where it was
+    size_t tail = nfull * block;
+    if (tail < size && (n == 0 || match[n - 1].dst + match[n - 1].len <= tail) &&
+        get_le32(sums + 8 * nfull) == delta_upload_weak(data + tail, (uint32_t)(size - tail)) &&
+        get_le32(sums + 8 * nfull + 4) == calculate_crc32(data + tail, size - tail)) {
+        match[n].dst = match[n].src = (uint32_t)tail;
+        match[n].len = (uint32_t)(size - tail);
+        n++;
+    }
+
+    free(head);
+    free(next);
+    return n;
+}
+
+// Moves first, then the data: blocks that shifted down in ascending order,
+// those that shifted up in descending order. A move whose source an earlier
+// move overwrote is sent as data instead. Returns the op count, moves in
+// [0, *moves); *kept is the bytes already in place.
+static size_t delta_plan(const uint8_t* data, size_t size, const uint8_t* sums,
+                         size_t block, delta_op_t** out, size_t* moves, size_t* kept) {
+    delta_op_t* match = malloc((size / block + 1) * sizeof(delta_op_t));
+    delta_op_t* ops = malloc((size / block + 1) * 2 * sizeof(delta_op_t));
+    uint8_t* literal = malloc(size);
+    uint8_t* written = calloc(1, size);
+    size_t n = 0, m = 0, nops = 0;
+
+    *out = NULL;
+    *moves = *kept = 0;
+    if (!match || !ops || !literal || !written) {
+        free(match); free(ops); free(literal); free(written);
+        return 0;
+    }
+    memset(literal, 1, size);
+
+    // Runs of blocks that moved together become one op
+    n = delta_match(data, size, sums, block, match);
+    for (size_t i = 0; i < n; i++) {
+        if (m > 0 && match[i].dst == match[m - 1].dst + match[m - 1].len &&
+            match[i].src == match[m - 1].src + match[m - 1].len) {
+            match[m - 1].len += match[i].len;
+        } else {
+            match[m++] = match[i];
+        }
+    }
+
+    for (size_t i = 0; i < m; i++) {
+        if (match[i].src == match[i].dst) {
+            memset(literal + match[i].dst, 0, match[i].len);
+            *kept += match[i].len;
+        }
+    }
+    for (int pass = 0; pass < 2; pass++) {
+        for (size_t j = 0; j < m; j++) {
+            delta_op_t* op = &match[pass == 0 ? j : m - 1 - j];
+
+            if (pass == 0 ? op->src <= op->dst : op->src >= op->dst) continue;
+            if (memchr(written + op->src, 1, op->len)) continue;
+            memset(written + op->dst, 1, op->len);
+            memset(literal + op->dst, 0, op->len);
+            ops[nops++] = *op;
+        }
+    }
+    *moves = nops;
+
+    for (size_t pos = 0; pos < size; ) {
+        if (!literal[pos]) {
+            pos++;
+            continue;
+        }
+        size_t end = pos;
+        while (end < size && literal[end]) end++;
+        ops[nops].dst = (uint32_t)pos;
+        ops[nops].src = 0;
+        ops[nops].len = (uint32_t)(end - pos);
+        nops++;
+        pos = end;
+    }
+
+    free(match);
+    free(literal);
+    free(written);
+    *out = ops;
+    return nops;
+}
+
+// 1 on success, 0 on failure, -1 if the target does not answer 'D'
+int upload_delta(serial_t s, const uint8_t* data, size_t size, bool verbose) {
+    size_t nblocks = (size + DELTA_BLOCK - 1) / DELTA_BLOCK;
     uint32_t crc = calculate_crc32(data, size);
+    uint8_t hdr[13], b, response[5];
+    size_t wire = 0, moves, kept, nops, moved = 0;
+    delta_op_t* ops;
+    double t0;
+
+    if (!send_byte(s, DELTA_UPLOAD_CMD, verbose)) return 0;
+    if (!read_byte_timeout(s, &b, BLOCK_PROBE_S) || b != 'A') return -1;
+
+    printf("\n=== Delta FAST Upload ===\n");
+    t0 = get_time();
+
+    put_le32(hdr, (uint32_t)size);
+    put_le32(hdr + 4, DELTA_BLOCK);
+    if (serial_write(s, hdr, 8) != 8) return 0;
+    if (!read_byte_timeout(s, &b, 1.0) || b != 'B') {
+        printf(COLOR_RED "ERROR: Target refused a %zu byte image" COLOR_RESET "\n", size);
+        return 0;
+    }
 
-    if (!verbose) {
-        printf("\n=== FAST Streaming Upload (NO chunking) ===\n");
-        printf("Uploading firmware (%zu bytes, CRC: 0x%08X)...\n\n", size, crc);
+    // The target sums its current content: 8 bytes per block
+    uint8_t* sums = malloc(nblocks * 8);
+    if (!sums) return 0;
+    for (size_t i = 0; i < nblocks * 8; i++) {
+        if (!read_byte_timeout(s, sums + i, 5.0)) {
+            printf(COLOR_RED "ERROR: Timeout reading block sums (%zu of %zu)" COLOR_RESET "\n",
+                   i / 8, nblocks);
+            free(sums);
+            return 0;
+        }
+    }
+    double t_sums = get_time() - t0;
+
+    nops = delta_plan(data, size, sums, DELTA_BLOCK, &ops, &moves, &kept);
+    free(sums);
+    if (!ops) {
+        printf(COLOR_RED "ERROR: Out of memory" COLOR_RESET "\n");
+        return 0;
+    }
+    for (size_t i = 0; i < nops; i++) {
+        if (i < moves) {
+            moved += ops[i].len;
+            wire += 13;
+        } else {
+            wire += 9 + ops[i].len;
+        }
+    }
+    wire += 1 + 5;
+
+    printf("Image %zu bytes (CRC: 0x%08X), %d byte blocks: %zu unchanged, %zu moved (%zu ops),\n"
+           "%zu sent as data; %zu bytes to send, %.1f%% (block sums %.2fs)\n\n",
+           size, crc, DELTA_BLOCK, kept, moved, moves, size - kept - moved, wire,
+           100.0 * wire / size, t_sums);
+
+    progress_t prog = {
+        .total_bytes = wire,
+        .bytes_sent = 0,
+        .start_time = get_time(),
+        .verbose = verbose
+    };
+
+    for (size_t i = 0; i < nops; i++) {
+        const delta_op_t* op = &ops[i];
+
+        if (i < moves) {
+            // Acknowledged: a long move would overrun the target's RX FIFO
+            if (verbose) printf("Move 0x%05X <- 0x%05X, %u bytes\n", op->dst, op->src, op->len);
+            hdr[0] = DELTA_UPLOAD_MOVE;
+            put_le32(hdr + 1, op->dst);
+            put_le32(hdr + 5, op->src);
+            put_le32(hdr + 9, op->len);
+            if (serial_write(s, hdr, 13) != 13) goto fail;
+            if (!read_byte_timeout(s, &b, 5.0) || b != DELTA_UPLOAD_MOVED) {
+                printf(COLOR_RED "\nERROR: No reply to the move to 0x%05X" COLOR_RESET "\n", op->dst);
+                goto fail;
+            }
+            prog.bytes_sent += 13;
+            if (!verbose) show_progress(&prog);
+            continue;
+        }
+
+        if (verbose) printf("Data 0x%05X, %u bytes\n", op->dst, op->len);
+        hdr[0] = DELTA_UPLOAD_WRITE;
+        put_le32(hdr + 1, op->dst);
+        put_le32(hdr + 5, op->len);
+        if (serial_write(s, hdr, 9) != 9) goto fail;
+        prog.bytes_sent += 9;
+        for (size_t off = 0; off < op->len; off += 1024) {
+            size_t len = op->len - off < 1024 ? op->len - off : 1024;
+            if (serial_write(s, data + op->dst + off, len) != (int)len) {
+                printf(COLOR_RED "\nERROR: Failed to send data at 0x%05zX" COLOR_RESET "\n",
+                       op->dst + off);
+                goto fail;
+            }
+            prog.bytes_sent += len;
+            if (!verbose) show_progress(&prog);
+        }
+    }
+    free(ops);
+
+    uint8_t crc_packet[6] = { DELTA_UPLOAD_END, 'C' };
+    put_le32(crc_packet + 2, crc);
+    if (serial_write(s, crc_packet, 6) != 6) return 0;
+    #ifdef _WIN32
+        FlushFileBuffers(s);
+    #else
+        tcdrain(s);
+    #endif
+
+    int total_read = 0;
+    while (total_read < 5 && read_byte_timeout(s, response + total_read, 5.0)) {
+        total_read++;
+    }
+    double elapsed = get_time() - t0;
+    if (!verbose) printf("\n");
+    if (total_read < 5) {
+        printf(COLOR_RED "\nERROR: Timeout waiting for CRC response (5s)" COLOR_RESET "\n");
+        return 0;
+    }
+
+    uint32_t fpga_crc = get_le32(response + 1);
+    printf("\nSent %zu bytes in %.2fs: %.1f KB/s effective (%.2fx)\n",
+           wire, elapsed, size / elapsed / 1024.0, (double)size / wire);
+    printf("FPGA CRC:     0x%08X\n", fpga_crc);
+    printf("Expected CRC: 0x%08X\n", crc);
+
+    if (response[0] == 'C' && fpga_crc == crc) {
+        printf(COLOR_GREEN "%s SUCCESS - CRC Match!" COLOR_RESET "\n", CHECK_MARK);
+        return 1;
+    }
+    printf(COLOR_RED "%s FAILURE" COLOR_RESET "\n", CROSS_MARK);
+    printf("  CRC Mismatch: XOR=0x%08X\n", fpga_crc ^ crc);
+    read_rx_report(s);
+    return 0;
+
+fail:
+    free(ops);
+    return 0;
+}
+
+//==============================================================================
+// Auto-Baud (lib/uart_baud.h)
+//==============================================================================
+
+// Tried from the top down, after --max-baud itself
+static const int baud_steps[] = { 4000000, 3000000, 2000000, 1500000 };
+
+static void sleep_ms(int ms) {
+    #ifdef _WIN32
+        Sleep(ms);
+    #else
+        usleep(ms * 1000);
+    #endif
+}
+
+// Returns 1 once rate is in use on both ends, 0 if it failed (both back at
+// baud), -1 if the target does not take the handshake at all
+static int baud_try(serial_t s, int baud, int rate, bool verbose) {
+    uint8_t req[6] = { UART_BAUD_CMD }, reply[5], b;
+    int i;
+
+    put_le32(req + 1, (uint32_t)rate);
+    req[5] = uart_baud_check((uint32_t)rate);
+    serial_flush(s);
+    if (serial_write(s, req, sizeof(req)) != sizeof(req)) return -1;
+
+    if (!read_byte_timeout(s, reply, BLOCK_PROBE_S)) return -1;
+    if (reply[0] == UART_BAUD_NAK) return 0;
+    if (reply[0] != UART_BAUD_ACK) return -1;
+    for (i = 1; i < 5; i++) {
+        if (!read_byte_timeout(s, reply + i, 0.1)) break;
+    }
+    if (i < 5 || get_le32(reply + 1) != (uint32_t)rate) goto fail;
+
+    if (!serial_set_baud(s, rate)) {
+        if (verbose) printf("  This port cannot run at %d baud\n", rate);
+        goto fail;                  // Target times out and drops back
+    }
+    sleep_ms(UART_BAUD_SETTLE_MS);
+    serial_flush(s);
+
+    for (i = 0; i < UART_BAUD_PATTERN_LEN; i++) {
+        req[0] = uart_baud_pattern(i);
+        if (serial_write(s, req, 1) != 1) goto fail;
+    }
+    for (i = 0; i < UART_BAUD_PATTERN_LEN; i++) {
+        if (!read_byte_timeout(s, &b, UART_BAUD_TIMEOUT_MS / 1000.0) ||
+            b != uart_baud_pattern(i)) {
+            if (verbose) printf("  %d baud: test pattern failed at byte %d\n", rate, i);
+            goto fail;
+        }
+    }
+
+    // The commit answer can be lost too: the target ignores a repeated 'K'
+    for (int tries = 0; tries < 3; tries++) {
+        req[0] = UART_BAUD_COMMIT;
+        serial_write(s, req, 1);
+        if (read_byte_timeout(s, &b, 0.1) && b == UART_BAUD_COMMIT) return 1;
+    }
+
+fail:
+    serial_set_baud(s, baud);
+    sleep_ms(UART_BAUD_TIMEOUT_MS + 50);
+    serial_flush(s);
+    return 0;
+}
+
+// Fastest rate up to max_baud that passes the handshake, or baud
+int negotiate_baud(serial_t s, int baud, int max_baud, bool verbose) {
+    int rates[1 + sizeof(baud_steps) / sizeof(baud_steps[0])];
+    int n = 0;
+
+    rates[n++] = max_baud;
+    for (size_t i = 0; i < sizeof(baud_steps) / sizeof(baud_steps[0]); i++) {
+        if (baud_steps[i] < max_baud) rates[n++] = baud_steps[i];
+    }
+
+    for (int i = 0; i < n && rates[i] > baud; i++) {
+        if (verbose) printf("Auto-baud: trying %d baud\n", rates[i]);
+        int r = baud_try(s, baud, rates[i], verbose);
+        if (r > 0) {
+            printf(COLOR_GREEN "UART at %d baud" COLOR_RESET "\n", rates[i]);
+            return rates[i];
+        }
+        if (r < 0) {
+            printf(COLOR_YELLOW "Target does not negotiate the baud rate, staying at %d" COLOR_RESET "\n", baud);
+            return baud;
+        }
+    }
+    printf(COLOR_YELLOW "No faster rate passed the line test, staying at %d baud" COLOR_RESET "\n", baud);
+    return baud;
+}
+
+// Hardware loader: the hold packet puts the CPU in reset and the FPGA
+// answers the block protocol itself (hdl/firmware_loader.v)
+static bool hold_cpu(serial_t s, bool verbose) {
+    uint8_t rsp[5];
+
+    for (int attempt = 0; attempt < 3; attempt++) {
+        if (verbose) printf("TX: hold\n");
+        serial_flush(s);
+        block_send_packet(s, BLOCK_PKT_HOLD, BLOCK_HOLD_MAGIC, NULL, 0);
+        if (block_read_reply(s, rsp, BLOCK_PROBE_S) && rsp[0] == BLOCK_RSP_INFO &&
+            (rsp[2] | (rsp[3] << 8)) == BLOCK_UPLOAD_BLOCK_SIZE) {
+            printf(COLOR_GREEN "CPU held in reset, hardware loader ready" COLOR_RESET "\n");
+            return true;
+        }
+    }
+    printf(COLOR_RED "ERROR: No answer to the hold packet (bitstream without HW_LOADER?)" COLOR_RESET "\n");
+    return false;
+}
+
+static bool upload_image(serial_t s, const uint8_t* data, size_t size,
+                         const uint8_t* block, size_t block_size, size_t sparse_size,
+                         bool delta, int baud, bool stream_only, bool verbose);
+
+// sparse_size: an ELF's image with .bss (data is its first size bytes), 0 for a .bin
+// delta: against the image the target holds, if it answers 'D'
+bool upload_firmware(serial_t s, const uint8_t* data, size_t size,
+                     const uint8_t* block, size_t block_size, size_t sparse_size,
+                     bool delta, int baud, int max_baud, bool stream_only, bool hold, bool verbose) {
+    init_crc32();
+
+    if (hold) {
+        if (!hold_cpu(s, verbose)) return false;
+
+        // Block protocol only; the loader lets the CPU run once the image checks out
+        int rate = max_baud > baud ? negotiate_baud(s, baud, max_baud, verbose) : baud;
+        bool ok = upload_blocks(s, data, size, rate, verbose) == 1;
+        if (ok) printf("CPU released, bootloader starts the image\n");
+        if (rate != baud) {
+            #ifdef _WIN32
+                FlushFileBuffers(s);
+                Sleep(UART_BAUD_SETTLE_MS);
+            #else
+                tcdrain(s);
+                usleep(UART_BAUD_SETTLE_MS * 1000);
+            #endif
+            serial_set_baud(s, baud);
+        }
+        return ok;
     }
 
     // Step 1: Send 'upload' command
@@ -428,6 +1713,65 @@ bool upload_firmware(serial_t s, const uint8_t* data, size_t size, bool verbose)
         if (verbose) printf("Discarded %d bytes of echo\n", bytes_available);
     }
 
+    // Raise the rate for the transfer; the target drops back once it is done
+    int rate = max_baud > baud ? negotiate_baud(s, baud, max_baud, verbose) : baud;
+    bool ok = upload_image(s, data, size, block, block_size, sparse_size, delta, rate,
+                           stream_only, verbose);
+    if (rate != baud) {
+        #ifdef _WIN32
+            FlushFileBuffers(s);
+            Sleep(UART_BAUD_SETTLE_MS);
+        #else
+            tcdrain(s);
+            usleep(UART_BAUD_SETTLE_MS * 1000);
+        #endif
+        serial_set_baud(s, baud);
+    }
+    return ok;
+}
+
+static bool upload_image(serial_t s, const uint8_t* data, size_t size,
+                         const uint8_t* block, size_t block_size, size_t sparse_size,
+                         bool delta, int baud, bool stream_only, bool verbose) {
+    progress_t prog = {
+        .total_bytes = size + 5 + 5,  // Data + size + CRC
+        .bytes_sent = 0,
+        .start_time = get_time(),
+        .verbose = verbose
+    };
+
+    uint32_t crc = calculate_crc32(data, size);
+
+    // Delta against the image still in the target's RAM, if asked for
+    if (delta) {
+        int r = upload_delta(s, data, size, verbose);
+        if (r >= 0) return r == 1;
+        printf(COLOR_YELLOW "Target does not take delta uploads, sending the whole image" COLOR_RESET "\n");
+    }
+
+    // Compressed stream, if asked for and the target answers 'Z'
+    if (block) {
+        int r = upload_compressed(s, data, size, block, block_size, verbose);
+        if (r >= 0) return r == 1;
+        printf(COLOR_YELLOW "Target does not take compressed uploads, sending uncompressed" COLOR_RESET "\n");
+    } else if (sparse_size) {
+        int r = upload_sparse(s, data, sparse_size, verbose);
+        if (r >= 0) return r == 1;
+        printf(COLOR_YELLOW "Target does not take sparse uploads, sending the flat image" COLOR_RESET "\n");
+    }
+
+    // Block protocol if the target answers the probe
+    if (!stream_only) {
+        int r = upload_blocks(s, data, size, baud, verbose);
+        if (r >= 0) return r == 1;
+        if (verbose) printf("No block protocol probe answer: FAST stream\n");
+    }
+
+    if (!verbose) {
+        printf("\n=== FAST Streaming Upload (NO chunking) ===\n");
+        printf("Uploading firmware (%zu bytes, CRC: 0x%08X)...\n\n", size, crc);
+    }
+
     // Step 2: Send 'R' (Ready)
     if (verbose) printf("\n[2] Ready Handshake\n");
     else printf("Handshake: ");
@@ -538,6 +1882,7 @@ bool upload_firmware(serial_t s, const uint8_t* data, size_t size, bool verbose)
     while (total_read < 5) {
         int ret = serial_read(s, response + total_read, 5 - total_read);
         if (ret > 0) {
+            rtt_reply();
             total_read += ret;
         }
         // Check for overall timeout (5 seconds - enough for 512KB)
@@ -576,18 +1921,298 @@ bool upload_firmware(serial_t s, const uint8_t* data, size_t size, bool verbose)
         }
         if (fpga_crc != crc) {
             printf("  CRC Mismatch: XOR=0x%08X\n", fpga_crc ^ crc);
+            read_rx_report(s);
         }
         return false;
     }
 }
 
+//==============================================================================
+// Block Download (lib/block_upload/block_download.c on the target)
+//==============================================================================
+
+enum { DL_PENDING, DL_IN_FLIGHT, DL_DONE };
+
+#define DL_UNREADABLE_LIMIT 3     // Empty 'd' for the same block this often: give up
+
+// Next download reply: 'w', 'O', 'C' (type + 4 bytes) or a 'd' packet
+// (header, payload, CRC32) into pkt. Returns the type, or
+// 0 after timeout seconds. Bytes that start none of these are skipped.
+static int download_reply(serial_t s, uint8_t* pkt, double timeout) {
+    static uint8_t buf[BLOCK_UPLOAD_HEADER_SIZE + BLOCK_UPLOAD_BLOCK_SIZE + 4];
+    static int have = 0;
+    double start = get_time();
+
+    while (1) {
+        int need = 1;
+        if (have) {
+            switch (buf[0]) {
+                case BLOCK_RSP_INFO:
+                case BLOCK_RSP_SIZE:
+                case BLOCK_RSP_DONE:   need = 5; break;
+                case BLOCK_RSP_DATA:
+                    need = BLOCK_UPLOAD_HEADER_SIZE;
+                    if (have >= need) {
+                        uint16_t arg = buf[1] | (buf[2] << 8);
+                        uint16_t len = buf[3] | (buf[4] << 8);
+                        if (len > BLOCK_UPLOAD_BLOCK_SIZE ||
+                            buf[5] != block_upload_check(buf[0], arg, len)) {
+                            need = 0;
+                        } else {
+                            need += len + 4;
+                        }
+                    }
+                    break;
+                default:               need = 0; break;
+            }
+            if (!need) {
+                // Not a reply: hunt on from the next byte
+                memmove(buf, buf + 1, --have);
+                continue;
+            }
+            if (have == need) {
+                memcpy(pkt, buf, need);
+                have = 0;
+                return pkt[0];
+            }
+        }
+
+        int avail = serial_available(s);
+        if (avail > 0) {
+            int n = serial_read(s, buf + have, avail < need - have ? avail : need - have);
+            if (n > 0) have += n;
+        } else if (!serial_wait(s, timeout - (get_time() - start))) {
+            return 0;
+        }
+    }
+}
+
+// Ask for the range size ('Q'); returns it, or -1
+static long download_size(serial_t s, uint8_t* pkt) {
+    for (int attempt = 0; attempt < 3; attempt++) {
+        block_send_packet(s, BLOCK_PKT_QUERY, 0, NULL, 0);
+        double start = get_time();
+        while (get_time() - start < 1.0) {
+            int type = download_reply(s, pkt, 1.0);
+            if (type == BLOCK_RSP_SIZE) return get_le32(pkt + 1);
+            if (!type) break;
+        }
+    }
+    return -1;
+}
+
+// Pull the range the target serves ('down' in hexedit_fast, or SRAM after
+// a crash in sd_card_manager) into out. Returns true once every block
+// arrived with a good CRC and the file is written.
+bool download_blocks(serial_t s, const char* out, int baud, bool verbose) {
+    static uint8_t pkt[BLOCK_UPLOAD_HEADER_SIZE + BLOCK_UPLOAD_BLOCK_SIZE + 4];
+    uint32_t window = BLOCK_UPLOAD_WINDOW;
+    uint32_t next_seq = 0, done = 0, in_flight = 0, cursor = 0;
+    uint32_t gets = 0, bad = 0;
+    uint8_t* data = NULL;
+    uint8_t* state = NULL;
+    uint8_t* unreadable = NULL;
+    uint32_t* seq = NULL;
+    double* sent_at = NULL;
+    bool result = false;
+    int type = 0;
+
+    // One window of blocks on the wire, plus USB latency
+    double retry_s = 0.1 + 2.0 * BLOCK_UPLOAD_WINDOW *
+                     (BLOCK_UPLOAD_BLOCK_SIZE + BLOCK_UPLOAD_HEADER_SIZE + 4) * 10.0 / baud;
+
+    for (int attempt = 0; attempt < 3 && type != BLOCK_RSP_INFO; attempt++) {
+        block_send_packet(s, BLOCK_PKT_PROBE, BLOCK_UPLOAD_VERSION, NULL, 0);
+        do {
+            type = download_reply(s, pkt, BLOCK_PROBE_S);
+        } while (type && type != BLOCK_RSP_INFO);
+    }
+    if (type != BLOCK_RSP_INFO || (pkt[2] | (pkt[3] << 8)) != BLOCK_UPLOAD_BLOCK_SIZE) {
+        printf(COLOR_RED "ERROR: No block protocol sender on the target" COLOR_RESET "\n");
+        printf("Run 'down <addr> <len>' in hexedit_fast first.\n");
+        return false;
+    }
+    if (pkt[4] && pkt[4] < window) window = pkt[4];
+
+    long size = download_size(s, pkt);
+    if (size <= 0) {
+        printf(COLOR_RED "ERROR: No answer to the size query" COLOR_RESET "\n");
+        return false;
+    }
+    uint32_t nblocks = (size + BLOCK_UPLOAD_BLOCK_SIZE - 1) / BLOCK_UPLOAD_BLOCK_SIZE;
+
+    data = malloc(size);
+    state = calloc(nblocks, 1);
+    unreadable = calloc(nblocks, 1);
+    seq = calloc(nblocks, sizeof(uint32_t));
+    sent_at = calloc(nblocks, sizeof(double));
+    if (!data || !state || !unreadable || !seq || !sent_at) {
+        printf(COLOR_RED "ERROR: Out of memory" COLOR_RESET "\n");
+        goto abort;
+    }
+
+    printf("\n=== Block Download (%u x %d bytes, window %u) ===\n",
+           nblocks, BLOCK_UPLOAD_BLOCK_SIZE, window);
+    printf("Downloading %ld bytes to %s...\n\n", size, out);
+
+    progress_t prog = {
+        .total_bytes = size,
+        .bytes_sent = 0,
+        .start_time = get_time(),
+        .verbose = verbose
+    };
+    double last_data = get_time();
+
+    while (done < nblocks) {
+        double now = get_time();
+
+        // Keep the window full, lowest missing block first
+        while (in_flight < window) {
+            while (cursor < nblocks && state[cursor] != DL_PENDING) cursor++;
+            if (cursor == nblocks) break;
+
+            block_send_packet(s, BLOCK_PKT_GET, cursor, NULL, 0);
+            state[cursor] = DL_IN_FLIGHT;
+            seq[cursor] = next_seq++;
+            sent_at[cursor] = now;
+            in_flight++;
+            gets++;
+        }
+
+        type = download_reply(s, pkt, 0.005);
+        if (type == BLOCK_RSP_DATA) {
+            uint32_t idx = pkt[1] | (pkt[2] << 8);
+            if (idx >= nblocks) continue;
+
+            // Answers come in request order: anything asked for before this
+            // block and still unanswered was lost on the way
+            if (state[idx] == DL_IN_FLIGHT) {
+                for (uint32_t i = 0; i < nblocks; i++) {
+                    if (state[i] == DL_IN_FLIGHT && seq[i] < seq[idx]) {
+                        if (verbose) printf("Block %u lost, asking again\n", i);
+                        state[i] = DL_PENDING;
+                        in_flight--;
+                        if (i < cursor) cursor = i;
+                    }
+                }
+                state[idx] = DL_PENDING;
+                in_flight--;
+                if (idx < cursor) cursor = idx;
+            }
+            if (state[idx] == DL_DONE) continue;
+
+            uint32_t len = pkt[3] | (pkt[4] << 8);
+            uint32_t want = size - (size_t)idx * BLOCK_UPLOAD_BLOCK_SIZE;
+            const uint8_t* payload = pkt + BLOCK_UPLOAD_HEADER_SIZE;
+            if (want > BLOCK_UPLOAD_BLOCK_SIZE) want = BLOCK_UPLOAD_BLOCK_SIZE;
+            if (len == 0 && get_le32(payload) == 0) {
+                // Target could not read it (SD error): give up after a few
+                if (++unreadable[idx] >= DL_UNREADABLE_LIMIT) {
+                    printf(COLOR_RED "\nERROR: Target cannot read block %u" COLOR_RESET "\n", idx);
+                    goto abort;
+                }
+                continue;
+            }
+            if (len != want || get_le32(payload + len) != calculate_crc32(payload, len)) {
+                if (verbose) printf("RX: bad CRC in block %u\n", idx);
+                bad++;
+                continue;
+            }
+
+            memcpy(data + (size_t)idx * BLOCK_UPLOAD_BLOCK_SIZE, payload, len);
+            state[idx] = DL_DONE;
+            done++;
+            last_data = now;
+            prog.bytes_sent += len;
+            if (!verbose && (done % 8 == 0 || done == nblocks)) show_progress(&prog);
+            continue;
+        }
+
+        // Silent losses: no answer at all within the retry time
+        for (uint32_t i = 0; i < nblocks; i++) {
+            if (state[i] == DL_IN_FLIGHT && now - sent_at[i] > retry_s) {
+                if (verbose) printf("Block %u timed out, asking again\n", i);
+                state[i] = DL_PENDING;
+                in_flight--;
+                if (i < cursor) cursor = i;
+            }
+        }
+
+        if (now - last_data > BLOCK_STALL_S * (BLOCK_RESYNCS + 1)) {
+            printf(COLOR_RED "\nERROR: Target stopped sending at block %u of %u" COLOR_RESET "\n",
+                   done, nblocks);
+            goto abort;
+        }
+    }
+    if (!verbose) printf("\n");
+
+    // Finish: the target re-reads the range for its CRC. A mismatch means
+    // the memory changed during the download (each block was good as sent)
+    uint32_t crc = calculate_crc32(data, size);
+    type = 0;
+    for (int attempt = 0; attempt < 3 && type != BLOCK_RSP_DONE; attempt++) {
+        if (verbose) printf("TX: finish\n");
+        block_send_packet(s, BLOCK_PKT_FINISH, 0, NULL, 0);
+        do {
+            type = download_reply(s, pkt, 1.0);
+        } while (type && type != BLOCK_RSP_DONE);
+    }
+
+    printf("\n%u blocks requested for %u (%u bad CRC)\n", gets, nblocks, bad);
+    printf("CRC32:        0x%08X\n", crc);
+    if (type != BLOCK_RSP_DONE) {
+        printf(COLOR_YELLOW "No answer to finish: target CRC not compared" COLOR_RESET "\n");
+    } else if (get_le32(pkt + 1) != crc) {
+        printf("Target CRC:   0x%08X\n", get_le32(pkt + 1));
+        printf(COLOR_YELLOW "Memory changed during the download" COLOR_RESET "\n");
+    }
+
+    FILE* f = fopen(out, "wb");
+    if (!f || fwrite(data, 1, size, f) != (size_t)size) {
+        printf(COLOR_RED "ERROR: Cannot write %s" COLOR_RESET "\n", out);
+        if (f) fclose(f);
+        goto out;
+    }
+    fclose(f);
+    printf(COLOR_GREEN "%s Saved %ld bytes to %s" COLOR_RESET "\n", CHECK_MARK, size, out);
+    result = true;
+    goto out;
+
+abort:
+    // Back to the target's prompt instead of leaving it serving
+    block_send_packet(s, BLOCK_PKT_ABORT, 0, NULL, 0);
+out:
+    free(data);
+    free(state);
+    free(unreadable);
+    free(seq);
+    free(sent_at);
+    return result;
+}
+
 // Main
 void print_usage(const char* prog) {
     printf("FAST Streaming Firmware Uploader - NO Chunking (%s)\n\n", PLATFORM);
-    printf("Usage: %s [options] <firmware.bin>\n\n", prog);
+    printf("Usage: %s [options] <firmware.bin|firmware.elf>\n", prog);
+    printf("       %s [options] -D <dump.bin>\n\n", prog);
     printf("Options:\n");
     printf("  -p, --port <port>     Serial port (required)\n");
     printf("  -b, --baud <rate>     Baud rate (default: %d)\n", DEFAULT_BAUD);
+    printf("  -m, --max-baud <rate> Raise the UART rate for the transfer: tries <rate>,\n");
+    printf("                        then 4M/3M/2M/1.5M below it, else stays at -b\n");
+    printf("  -s, --stream          FAST stream only (no block protocol probe)\n");
+    printf("  -z, --lz4             Compress (LZ4); the target decodes as it receives.\n");
+    printf("                        A .bin.lz4 from tools/lz4boot is sent compressed as is\n");
+    printf("                        An .elf is sent sparse (no .bss or zero runs) unless -z\n");
+    printf("  -d, --delta           Only what changed: the target sums the blocks of the\n");
+    printf("                        image it still holds (same overlay or firmware slot)\n");
+    printf("  -H, --hold            Hardware loader (Kconfig HW_LOADER): hold the CPU in\n");
+    printf("                        reset and write SRAM from the FPGA, block protocol only\n");
+    printf("  -L, --low-latency     USB serial latency timer to 1 ms (Linux: ASYNC_LOW_LATENCY,\n");
+    printf("                        sysfs latency_timer) and no drain before each reply\n");
+    printf("  -D, --dump <file>     Download instead: save the range the target serves\n");
+    printf("                        (hexedit_fast 'down <addr> <len>', SRAM after a crash)\n");
+    printf("  -x, --exec <cmd>      Send <cmd> and Enter first, e.g. -x \"down 0 80000\"\n");
     printf("  -v, --verbose         Verbose output (show protocol details)\n");
     printf("  -l, --list            List available serial ports\n");
     printf("  -h, --help            Show this help\n\n");
@@ -595,19 +2220,72 @@ void print_usage(const char* prog) {
     printf("Examples:\n");
 #ifdef _WIN32
     printf("  %s -p COM8 firmware.bin\n", prog);
+    printf("  %s -p COM8 -x \"down 0 80000\" -D sram.bin\n", prog);
     printf("  %s --list\n", prog);
 #else
     printf("  %s -p /dev/cu.usbserial-XXXXX firmware.bin\n", prog);
+    printf("  %s -p /dev/cu.usbserial-XXXXX -x \"down 0 80000\" -D sram.bin\n", prog);
     printf("  %s --list\n", prog);
 #endif
 }
 
+static void report_low_latency(serial_t s, const char* port) {
+    int ms = serial_low_latency(s, port);
+    if (ms > 1) {
+        printf(COLOR_YELLOW "Latency timer still %d ms (sysfs latency_timer not writable)" COLOR_RESET "\n", ms);
+    } else if (ms == 1) {
+        printf("Low latency: latency timer 1 ms\n");
+    } else {
+        printf("Low latency: no tcdrain() before replies (latency timer not adjustable here)\n");
+    }
+}
+
+// -D: pull a range from the target into a file
+static bool download(const char* port, int baud, const char* out,
+                     const char* exec, bool verbose) {
+    printf("Connecting to %s at %d baud...\n", port, baud);
+    serial_t s = serial_open(port, baud);
+    if (s == INVALID_SERIAL) {
+        printf(COLOR_RED "ERROR: Cannot open %s" COLOR_RESET "\n", port);
+        return false;
+    }
+    printf(COLOR_GREEN "Connected." COLOR_RESET "\n");
+
+    if (low_latency) {
+        report_low_latency(s, port);
+    }
+    init_crc32();
+
+    if (exec) {
+        // Start the sender, then drop its echo and banner
+        if (verbose) printf("TX: %s\n", exec);
+        serial_write(s, (const uint8_t*)exec, strlen(exec));
+        serial_write(s, (const uint8_t*)"\r", 1);
+        sleep_ms(500);
+        serial_flush(s);
+    }
+
+    double t0 = get_time();
+    bool success = download_blocks(s, out, baud, verbose);
+    printf("\nTotal %.3fs\n", get_time() - t0);
+
+    serial_close(s);
+    return success;
+}
+
 int main(int argc, char** argv) {
     const char* port = NULL;
     const char* firmware = NULL;
+    const char* dump = NULL;
+    const char* exec = NULL;
     int baud = DEFAULT_BAUD;
     bool verbose = false;
+    bool stream_only = false;
+    bool compress = false;
+    bool delta = false;
+    bool hold = false;
     bool list_ports = false;
+    int max_baud = 0;
 
     // Parse arguments
     for (int i = 1; i < argc; i++) {
@@ -617,6 +2295,25 @@ int main(int argc, char** argv) {
         } else if (strcmp(argv[i], "-b") == 0 || strcmp(argv[i], "--baud") == 0) {
             if (++i >= argc) { print_usage(argv[0]); return 1; }
             baud = atoi(argv[i]);
+        } else if (strcmp(argv[i], "-m") == 0 || strcmp(argv[i], "--max-baud") == 0) {
+            if (++i >= argc) { print_usage(argv[0]); return 1; }
+            max_baud = atoi(argv[i]);
+        } else if (strcmp(argv[i], "-z") == 0 || strcmp(argv[i], "--lz4") == 0) {
+            compress = true;
+        } else if (strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "--delta") == 0) {
+            delta = true;
+        } else if (strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--stream") == 0) {
+            stream_only = true;
+        } else if (strcmp(argv[i], "-H") == 0 || strcmp(argv[i], "--hold") == 0) {
+            hold = true;
+        } else if (strcmp(argv[i], "-L") == 0 || strcmp(argv[i], "--low-latency") == 0) {
+            low_latency = true;
+        } else if (strcmp(argv[i], "-D") == 0 || strcmp(argv[i], "--dump") == 0) {
+            if (++i >= argc) { print_usage(argv[0]); return 1; }
+            dump = argv[i];
+        } else if (strcmp(argv[i], "-x") == 0 || strcmp(argv[i], "--exec") == 0) {
+            if (++i >= argc) { print_usage(argv[0]); return 1; }
+            exec = argv[i];
         } else if (strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "--verbose") == 0) {
             verbose = true;
         } else if (strcmp(argv[i], "-l") == 0 || strcmp(argv[i], "--list") == 0) {
@@ -634,11 +2331,15 @@ int main(int argc, char** argv) {
         return 0;
     }
 
-    if (!port || !firmware) {
+    if (!port || (!firmware && !dump)) {
         print_usage(argv[0]);
         return 1;
     }
 
+    if (dump) {
+        return download(port, baud, dump, exec, verbose) ? 0 : 1;
+    }
+
     // Read firmware file
     FILE* f = fopen(firmware, "rb");
     if (!f) {
@@ -646,11 +2347,14 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    // An ELF carries symbols and debug info: only its segments count
+    uint8_t magic[4] = { 0 };
+    bool is_elf = fread(magic, 1, 4, f) == 4 && memcmp(magic, "\x7F" "ELF", 4) == 0;
     fseek(f, 0, SEEK_END);
     size_t size = ftell(f);
     fseek(f, 0, SEEK_SET);
 
-    if (size > MAX_PACKET_SIZE) {
+    if (!is_elf && size > MAX_PACKET_SIZE + MAX_PACKET_SIZE / 255 + 28) {
         printf(COLOR_RED "ERROR: Firmware too large (%zu bytes, max %d)" COLOR_RESET "\n",
                size, MAX_PACKET_SIZE);
         fclose(f);
@@ -672,23 +2376,100 @@ int main(int argc, char** argv) {
     }
     fclose(f);
 
+    // .bin.lz4 (magic, length, CRC32, LZ4 block): decoded here as well,
+    // for the CRC and in case the target only takes uncompressed uploads
+    uint8_t* block = NULL;
+    size_t block_size = 0;
+    size_t sparse_size = 0;
+    init_crc32();
+    if (elf_image_check(data, size)) {
+        elf_image_t elf;
+        const char* err = elf_image_load(data, size, MAX_PACKET_SIZE, &elf);
+
+        free(data);
+        if (err) {
+            printf(COLOR_RED "ERROR: %s: %s" COLOR_RESET "\n", firmware, err);
+            free(elf.image);
+            return 1;
+        }
+        printf("ELF: %d load segments, %zu byte image, %zu with .bss\n",
+               elf.segments, elf.file_end, elf.image_end);
+        data = elf.image;
+        size = elf.file_end;
+        if (compress) {
+            block_size = lz4_compress(data, size, &block);
+            if (!block_size) {
+                printf(COLOR_RED "ERROR: Out of memory" COLOR_RESET "\n");
+                free(data);
+                return 1;
+            }
+        } else {
+            sparse_size = elf.image_end;
+        }
+    } else if (size >= 12 && get_le32(data) == LZ4B_MAGIC) {
+        size_t length = get_le32(data + 4);
+        uint8_t* image = length <= MAX_PACKET_SIZE ? malloc(length ? length : 1) : NULL;
+
+        if (!image || lz4_decode(data + 12, size - 12, image, length) != 0 ||
+            calculate_crc32(image, length) != get_le32(data + 8)) {
+            printf(COLOR_RED "ERROR: %s is not a valid .bin.lz4 image" COLOR_RESET "\n", firmware);
+            free(image);
+            free(data);
+            return 1;
+        }
+        block_size = size - 12;
+        block = malloc(block_size);
+        memcpy(block, data + 12, block_size);
+        free(data);
+        data = image;
+        size = length;
+    } else if (size > MAX_PACKET_SIZE) {
+        printf(COLOR_RED "ERROR: Firmware too large (%zu bytes, max %d)" COLOR_RESET "\n",
+               size, MAX_PACKET_SIZE);
+        free(data);
+        return 1;
+    } else if (compress) {
+        block_size = lz4_compress(data, size, &block);
+        if (!block_size) {
+            printf(COLOR_RED "ERROR: Out of memory" COLOR_RESET "\n");
+            free(data);
+            return 1;
+        }
+    }
+
     // Open serial port
     printf("Connecting to %s at %d baud...\n", port, baud);
     serial_t s = serial_open(port, baud);
     if (s == INVALID_SERIAL) {
         printf(COLOR_RED "ERROR: Cannot open %s" COLOR_RESET "\n", port);
         free(data);
+        free(block);
         return 1;
     }
 
     printf(COLOR_GREEN "Connected." COLOR_RESET "\n");
 
+    if (low_latency) {
+        report_low_latency(s, port);
+    }
+
     // Upload
-    bool success = upload_firmware(s, data, size, verbose);
+    double t0 = get_time();
+    bool success = upload_firmware(s, data, size, block, block_size, sparse_size,
+                                   delta, baud, max_baud, stream_only, hold, verbose);
+    double elapsed = get_time() - t0;
+
+    printf("\nTotal %.3fs", elapsed);
+    if (rtt.count) {
+        printf(", handshake round trip %.2f ms avg, %.2f ms max (%d)",
+               rtt.total / rtt.count * 1000.0, rtt.max * 1000.0, rtt.count);
+    }
+    printf("%s\n", low_latency ? " [low latency]" : "");
 
     // Cleanup
     serial_close(s);
     free(data);
+    free(block);
 
     return success ? 0 : 1;
 }